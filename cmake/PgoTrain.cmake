@@ -0,0 +1,58 @@
+# PGO training run, invoked by the vibenes_pgo_train target as
+#   cmake -DBENCH=... -DMICROBENCH=... -DROMS=a.nes|b.nes -DINPUT=...
+#         -DPROFILE_DIR=... [-DPROFDATA=llvm-profdata] -P PgoTrain.cmake
+#
+# Old counts are cleared first so the profile matches the binaries just
+# built. Every ROM runs through VibeNES_Bench with the scripted input (one
+# unprofiled run: the cycle-profiling path is not the one to optimize for),
+# then the micro-benchmarks run once at a short batch time. With Clang the
+# raw profiles are merged into vibenes.profdata for the USE build.
+
+foreach(var BENCH MICROBENCH INPUT PROFILE_DIR)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "PgoTrain.cmake: ${var} is not set")
+    endif()
+endforeach()
+if(NOT DEFINED FRAMES)
+    set(FRAMES 3600)
+endif()
+
+file(GLOB_RECURSE stale_profiles
+    ${PROFILE_DIR}/*.gcda ${PROFILE_DIR}/*.profraw ${PROFILE_DIR}/*.profdata ${PROFILE_DIR}/*.pgc)
+if(stale_profiles)
+    file(REMOVE ${stale_profiles})
+endif()
+
+string(REPLACE "|" ";" ROMS "${ROMS}")
+if(NOT ROMS)
+    message(WARNING "No training ROMs; the profile comes from the micro-benchmarks alone")
+endif()
+foreach(rom IN LISTS ROMS)
+    message(STATUS "Training: ${rom}")
+    execute_process(
+        COMMAND ${BENCH} ${rom} --frames ${FRAMES} --runs 1 --input ${INPUT} --no-profile
+            --output ${PROFILE_DIR}/training_bench.json
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "VibeNES_Bench failed on ${rom}")
+    endif()
+endforeach()
+
+message(STATUS "Training: micro-benchmarks")
+execute_process(
+    COMMAND ${MICROBENCH} --min-ms 20 --runs 1 --output ${PROFILE_DIR}/training_microbench.json
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "VibeNES_MicroBench failed")
+endif()
+
+if(PROFDATA)
+    file(GLOB raw_profiles ${PROFILE_DIR}/*.profraw)
+    execute_process(
+        COMMAND ${PROFDATA} merge -output=${PROFILE_DIR}/vibenes.profdata ${raw_profiles}
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "llvm-profdata merge failed")
+    endif()
+endif()
+message(STATUS "PGO profile written to ${PROFILE_DIR}")
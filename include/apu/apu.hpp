@@ -1,11 +1,17 @@
 #pragma once
 
-#include "audio/audio_backend.hpp"
+#include "apu/expansion_audio.hpp"
+#include "audio/audio_output.hpp"
+#include "audio/audio_recorder.hpp"
+#include "audio/blip_buffer.hpp"
 #include "audio/sample_rate_converter.hpp"
+#include "audio/sinc_resampler.hpp"
 #include "core/component.hpp"
+#include "core/region.hpp"
 #include "core/types.hpp"
 #include <array>
 #include <memory>
+#include <vector>
 
 namespace nes {
 
@@ -63,6 +69,20 @@ class APU final : public Component {
 	/// Called by the CPU after it performs the DMA read.  Delivers the
 	/// fetched byte into the DMC sample buffer.
 	void complete_dmc_dma(uint8_t data);
+	// APU cycles alternate "put" (odd, when the timers and frame counter
+	// clock) and "get" (even); DMA reads only happen on get cycles
+	[[nodiscard]] bool next_cycle_is_get() const noexcept {
+		return (cycle_count_ & 1) == 1;
+	}
+
+	// Conservative (never late) count of CPU cycles that can elapse before
+	// the APU could raise an IRQ or request DMC DMA; 0 while a request is
+	// pending or a $4017 write is settling, NO_APU_EVENT when neither can
+	// happen. A playing sample's next fetch is computed from the DMC timer
+	// and the bits left in its shift register, so the bus posts it as one
+	// scheduler deadline and idle loops can skip up to it.
+	static constexpr uint32_t NO_APU_EVENT = 0xFFFFFFFF;
+	[[nodiscard]] uint32_t cycles_until_irq_or_dma() const noexcept;
 
 	// Audio output (future implementation)
 	float get_audio_sample();
@@ -74,23 +94,102 @@ class APU final : public Component {
 	void connect_bus(SystemBus *bus) {
 		bus_ = bus;
 	}
-	void connect_audio_backend(AudioBackend *audio_backend) {
-		audio_backend_ = audio_backend;
+	void connect_audio_output(AudioOutput *audio_output) {
+		audio_output_ = audio_output;
+		output_frame_count_ = 0;
+		update_parking(cycle_count_);
 	}
 
+	// Also hand every output frame to a recorder (nullptr stops). With a
+	// recorder audio is produced even without an output device. Per-channel
+	// stems are only synthesized in band-limited mode and leave out cartridge
+	// expansion audio; the mix track has everything.
+	void set_recorder(AudioRecorder *recorder);
+
 	// Audio control
 	void enable_audio(bool enabled) {
 		audio_enabled_ = enabled;
+		output_frame_count_ = 0;
+		update_parking(cycle_count_);
 	}
 	bool is_audio_enabled() const {
 		return audio_enabled_;
 	}
 
+	// Run-ahead: while gated the APU emulates as usual but queues no samples.
+	// A state restored before ungating picks the output up where gating began,
+	// so speculative frames never reach the speakers.
+	void set_output_gated(bool gated);
+	[[nodiscard]] bool is_output_gated() const noexcept {
+		return output_gated_;
+	}
+
+	// Dynamic rate control: once per output frame the resampling ratio is
+	// nudged (up to ±0.5%) to hold the device buffer at its target. Turned
+	// off when the device's demand paces emulation itself; the ratio then
+	// returns to nominal at the next output frame.
+	void set_rate_control(bool enabled) noexcept {
+		rate_control_ = enabled;
+	}
+	[[nodiscard]] bool is_rate_control_enabled() const noexcept {
+		return rate_control_;
+	}
+
+	// How the audio path turns channel state into output samples. Emulated
+	// state (timers, counters, IRQs, DMC DMA) is identical in both modes.
+	enum class SynthesisMode : uint8_t {
+		PerCycle,	 // Mix, filter and resample every CPU cycle
+		BandLimited, // Advance channels lazily, record amplitude steps into a BlipBuffer, resample per frame
+	};
+	void set_synthesis_mode(SynthesisMode mode);
+	[[nodiscard]] SynthesisMode get_synthesis_mode() const noexcept {
+		return synthesis_mode_;
+	}
+
+	// Downsampler for per-cycle synthesis (band-limited mode has its own)
+	enum class Resampler : uint8_t {
+		BoxAverage,	  // SampleRateConverter
+		WindowedSinc, // SincResampler: better alias rejection
+	};
+	void set_resampler(Resampler resampler);
+	[[nodiscard]] Resampler get_resampler() const noexcept {
+		return resampler_;
+	}
+
+	// Band-limited mode advances pulse/triangle/noise timers only at sync
+	// points, per-cycle mode skips channels nobody can hear; bring them up to
+	// the current cycle (save states call this)
+	void sync_channels();
+
+	// Cartridge sound chip mixed with the five channels (nullptr for none).
+	// The bus brackets every cartridge write with begin/end_expansion_write()
+	// so, in band-limited mode, the chip's steps up to the write are recorded
+	// before it changes and its new level is recorded at the write's cycle.
+	void set_expansion_audio(std::shared_ptr<ExpansionAudio> audio);
+	[[nodiscard]] bool has_expansion_audio() const noexcept {
+		return expansion_ != nullptr;
+	}
+	void begin_expansion_write();
+	void end_expansion_write();
+	[[nodiscard]] const ExpansionAudio *get_expansion_audio() const noexcept {
+		return expansion_;
+	}
+	// The chip's mix level (ExpansionAudio::set_gain); ignored without a chip
+	void set_expansion_gain(float gain);
+	[[nodiscard]] float get_expansion_gain() const noexcept {
+		return expansion_ ? expansion_->gain() : 1.0f;
+	}
+
 	// Update sample rate converter output rate (called when audio backend initializes)
-	void set_output_sample_rate(float sample_rate) {
-		sample_rate_converter_ = SampleRateConverter(static_cast<float>(CPU_CLOCK_NTSC), sample_rate);
+	void set_output_sample_rate(float sample_rate);
+	[[nodiscard]] float get_output_sample_rate() const noexcept {
+		return output_sample_rate_;
 	}
 
+	// Timing region: frame counter step lengths, noise and DMC periods and
+	// the CPU clock the resamplers run from. Defaults to NTSC.
+	void set_region(const RegionTiming &timing);
+
 	// Save state serialization
 	void serialize_state(std::vector<uint8_t> &buffer) const;
 	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset);
@@ -103,12 +202,16 @@ class APU final : public Component {
 		bool mode;			 // 0 = 4-step, 1 = 5-step
 		bool irq_inhibit;	 // IRQ disable flag
 		uint8_t reset_delay; // Delay after $4017 write
-
-		// Frame counter timing constants
-		static constexpr uint16_t STEP_CYCLES_4[4] = {7457, 7456, 7458, 7457};
-		static constexpr uint16_t STEP_CYCLES_5[5] = {7457, 7456, 7458, 7457, 7452};
 	};
 
+	// Region timing (see set_region()). The step lengths are copied so the
+	// per-cycle frame counter reads them off the APU like the old constants.
+	std::array<uint16_t, 4> frame_steps_4_ = NTSC_TIMING.frame_steps_4;
+	std::array<uint16_t, 5> frame_steps_5_ = NTSC_TIMING.frame_steps_5;
+	const std::array<uint16_t, 16> *noise_periods_ = &NTSC_TIMING.noise_periods;
+	const std::array<uint16_t, 16> *dmc_rates_ = &NTSC_TIMING.dmc_rates;
+	double cpu_clock_hz_ = static_cast<double>(CPU_CLOCK_NTSC);
+
 	// Pulse Channel (2 instances)
 	struct PulseChannel {
 		// Timer
@@ -243,35 +346,68 @@ class APU final : public Component {
 	// External connections
 	CPU6502 *cpu_;
 	SystemBus *bus_;
-	AudioBackend *audio_backend_;
+	AudioOutput *audio_output_;
+	AudioRecorder *recorder_ = nullptr;
 
-	// Audio output
+	// Audio output. Per-cycle samples are collected into resample_block_ and
+	// handed to the resampler a block at a time.
+	static constexpr std::size_t RESAMPLE_BLOCK_SIZE = 256;
 	SampleRateConverter sample_rate_converter_;
+	SincResampler sinc_resampler_;
+	Resampler resampler_ = Resampler::BoxAverage;
+	std::array<float, RESAMPLE_BLOCK_SIZE> resample_block_{};
+	std::size_t resample_block_count_ = 0;
 	bool audio_enabled_;
+	bool output_gated_ = false;
+	bool rate_control_ = true;
+	uint64_t gated_at_cycle_ = 0;
+	[[nodiscard]] bool producing_output() const noexcept {
+		return audio_enabled_ && (audio_output_ || recorder_) && !output_gated_;
+	}
 
-	// Mixer memoization: channel outputs change far less often than every CPU
-	// cycle, so cache the last input tuple and its mixed result. Keyed purely
-	// on inputs — no invalidation needed (formula is deterministic).
-	uint8_t mix_last_p1_ = 0xFF, mix_last_p2_ = 0xFF, mix_last_tri_ = 0xFF, mix_last_noise_ = 0xFF,
-			mix_last_dmc_ = 0xFF;
-	float mix_last_out_ = 0.0f;
-
-	// Dynamic rate control: periodically nudge the resampling ratio based on
-	// audio buffer fill level.  Keeps the buffer near a target level, preventing
-	// drift between emulation clock and audio device clock (which causes
-	// underrun/overflow clicks).
-	int rate_adjust_counter_ = 0;
-	static constexpr int RATE_ADJUST_INTERVAL = 512;		// check every 512 output samples (~11.6 ms)
-	static constexpr std::size_t RATE_ADJUST_TARGET = 3072; // target buffer fill (stereo sample pairs)
+	// The cartridge owns the chip's state (and saves it); expansion_ caches
+	// the pointer for the per-cycle and synthesis loops
+	std::shared_ptr<ExpansionAudio> expansion_owner_;
+	ExpansionAudio *expansion_ = nullptr;
+	// The chip's output() * gain() as of its last run; the mixer reads this
+	float expansion_level_ = 0.0f;
+	[[nodiscard]] float expansion_level() const noexcept {
+		return expansion_level_;
+	}
+	// Per-cycle mode: the chip is clocked through expansion_cycle_ and next
+	// needs running at expansion_next_step_ (NO_EXPANSION_STEP without one)
+	static constexpr uint64_t NO_EXPANSION_STEP = ~uint64_t{0};
+	uint64_t expansion_cycle_ = 0;
+	uint64_t expansion_next_step_ = NO_EXPANSION_STEP;
+	void run_expansion(uint64_t cycles) noexcept;
+	void catch_up_expansion(uint64_t cycle) noexcept;
+	// The chip changed outside its own schedule (attached, state loaded, mode
+	// switched): take its level now and, in per-cycle mode, run it through
+	// the next cycle to find its next step
+	void restart_expansion() noexcept;
+
+	// Output samples are collected for one APU output frame (29781 CPU
+	// cycles, ~735 samples at 44.1 kHz) and handed to the AudioOutput in a
+	// single queue_samples() call at its end, so the backend's per-call cost
+	// and the buffer fill query are paid 60 times a second. Dynamic rate
+	// control runs at the same point: the resampling ratio is nudged to keep
+	// the device buffer near the output's get_target_buffer_size(), preventing
+	// drift between the emulation clock and the audio device clock
+	// (underrun/overflow clicks).
+	static constexpr std::size_t OUTPUT_FRAME_CAPACITY = 2048; // > one frame at 96 kHz, PAL included
+	std::array<float, OUTPUT_FRAME_CAPACITY> output_frame_{};
+	std::size_t output_frame_count_ = 0;
+	uint64_t output_frame_start_ = 0; // Per-cycle mode: cycle the current output frame began
 
 	// NES hardware analog output filter chain.
 	// Models the analog circuitry between the DAC and the audio output jack:
 	//   1. First-order high-pass ~90 Hz  (mixer DC removal)
 	//   2. First-order high-pass ~440 Hz (amplifier AC coupling capacitor)
 	//   3. First-order low-pass  ~14 kHz (DAC output impedance + capacitance)
-	// Applied at the full CPU rate (1.789773 MHz) before downsampling.
-	// The low-pass filter is critical for the characteristic warm NES sound
-	// and also serves as an anti-aliasing pre-filter.
+	// The low-pass filter is critical for the characteristic warm NES sound.
+	// In per-cycle mode it alone runs at the CPU rate, as the anti-aliasing
+	// pre-filter ahead of the decimator; the other (linear, far-below-Nyquist)
+	// stages commute with decimation and run at the output rate.
 	struct OutputFilter {
 		// High-pass: y[n] = α * (y[n-1] + x[n] - x[n-1])
 		// α = RC / (RC + dt), RC = 1/(2π·fc), dt = 1/1789773
@@ -327,9 +463,10 @@ class APU final : public Component {
 		LowPass lp_bass;		// ~200 Hz low-pass for shelf extraction
 		float bass_gain = 1.0f; // Shelf gain (1.0 ≈ +6 dB boost)
 
-		void initialize() {
-			// Coefficients for filters running at CPU clock rate (1,789,773 Hz)
-			constexpr float dt = 1.0f / 1789773.0f;
+		void initialize(float sample_rate = 1789773.0f) {
+			// Coefficients for filters running at sample_rate (CPU clock rate,
+			// 1,789,773 Hz, by default; band-limited mode runs at output rate)
+			const float dt = 1.0f / sample_rate;
 
 			// HP 90 Hz: RC = 1/(2π×90) ≈ 0.001768
 			constexpr float rc_90 = 1.0f / (6.2831853f * 90.0f);
@@ -368,6 +505,17 @@ class APU final : public Component {
 			return sample;
 		}
 
+		// The chain without lp_14k, for samples that already went through it
+		// at the CPU rate
+		float apply_shaping(float sample) {
+			sample = hp_90.apply(sample);
+			sample = hp_440.apply(sample);
+			sample = lp_6k.apply(sample);
+			float bass = lp_bass.apply(sample);
+			sample += bass_gain * bass;
+			return sample;
+		}
+
 		void reset() {
 			hp_90.reset();
 			hp_440.reset();
@@ -376,9 +524,77 @@ class APU final : public Component {
 			lp_bass.reset();
 		}
 	};
+	// Tuned for the CPU rate; per-cycle mode only runs its lp_14k stage
+	OutputFilter anti_alias_filter_;
+
+	// Band-limited synthesis state. synth_cycle_ trails cycle_count_: pulse,
+	// triangle and noise timers have been applied through synth_cycle_ and
+	// are caught up (emitting one delta per waveform step) before anything
+	// reads or changes them.  The DMC, frame counter and IRQ logic stay
+	// per-cycle because their timing is CPU-visible.
+	static constexpr uint32_t BLIP_FRAME_CYCLES = 29781; // resample once per video frame
+	SynthesisMode synthesis_mode_ = SynthesisMode::PerCycle;
+	uint64_t synth_cycle_ = 0;
+	uint64_t blip_frame_start_ = 0;
+	float blip_last_amp_ = 0.0f; // Mixer level at the last recorded delta
+	float output_sample_rate_ = 44100.0f;
+	BlipBuffer blip_;
+	// Tuned for the output rate: the whole chain on band-limited samples,
+	// apply_shaping() on the per-cycle decimator's output
 	OutputFilter output_filter_;
 
+	// Band-limited per-channel outputs for a recorder taking stems, in
+	// AudioRecorder::Track order after Mix. Each channel is mixed solo so a
+	// stem sounds as the channel would alone.
+	static constexpr std::size_t STEM_COUNT = AudioRecorder::TRACK_COUNT - 1;
+	struct Stems {
+		std::array<BlipBuffer, STEM_COUNT> blips;
+		std::array<OutputFilter, STEM_COUNT> filters;
+		std::array<float, STEM_COUNT> last_levels{};
+	};
+	std::unique_ptr<Stems> stems_;
+	// Per-cycle mode parks the pulse, triangle and noise timers while their
+	// output can't change (silenced by length, volume, period or $4015, or
+	// no audio being produced at all): the tick loop skips them and they are
+	// fast-forwarded arithmetically from parked_at_, the last cycle they were
+	// clocked through, at register writes, frame counter clocks and whenever
+	// the audio path changes. Emulated state is unaffected.
+	// (Band-limited mode needs none of this: it only ever advances lazily.)
+	enum ParkedChannel : uint8_t {
+		PARKED_PULSE1 = 1 << 0,
+		PARKED_PULSE2 = 1 << 1,
+		PARKED_TRIANGLE = 1 << 2,
+		PARKED_NOISE = 1 << 3,
+	};
+	uint8_t parked_ = 0;
+	std::array<uint64_t, 4> parked_at_{};
+	void update_parking(uint64_t clocked_through);
+	void catch_up_parked(uint64_t clocked_through);
+	static void fast_forward(PulseChannel &pulse, uint64_t from, uint64_t to) noexcept;
+	static void fast_forward(TriangleChannel &triangle, uint64_t from, uint64_t to) noexcept;
+	static void fast_forward(NoiseChannel &noise, uint64_t from, uint64_t to) noexcept;
+
+	void record_stems(uint32_t time);
+	void end_stem_frame(uint32_t clocks);
+	void clear_stems();
+	void set_blip_rates(double clock_rate);
+
 	// Internal methods
+	void step_band_limited(int cycle_count);
+	// Request a DMC fetch if the sample buffer is empty and bytes remain
+	void request_dmc_fetch() noexcept;
+	// Cycles that can elapse before the next DMC fetch request (see
+	// cycles_until_irq_or_dma)
+	[[nodiscard]] uint32_t cycles_until_dmc_fetch() const noexcept;
+	void run_channels_until(uint64_t cycle);
+	void record_amplitude(uint64_t cycle);
+	void end_blip_frame();
+	void restart_band_limited_output();
+	void flush_resample_block();
+	void push_output_sample(float sample);
+	void hand_off_output_frame();
+	void end_output_frame();
+	void adjust_output_rate();
 	void clock_frame_counter();
 	void clock_quarter_frame();
 	void clock_half_frame();
@@ -387,8 +603,6 @@ class APU final : public Component {
 	// Lookup tables
 	static const uint8_t LENGTH_TABLE[32];
 	static const uint8_t DUTY_TABLE[4][8];
-	static const uint16_t NOISE_PERIOD_TABLE[16];
-	static const uint16_t DMC_RATE_TABLE[16];
 	static const uint8_t TRIANGLE_SEQUENCE[32];
 };
 
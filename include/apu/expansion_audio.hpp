@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nes {
+
+/**
+ * ExpansionAudio - A sound chip on the cartridge (VRC6, Sunsoft 5B, MMC5)
+ *
+ * The mapper that carries the chip owns it and forwards its register writes;
+ * the APU clocks it and adds output() to the 2A03 mix. In band-limited mode
+ * the APU runs the chip in spans, stopping at cycles_until_step() so each
+ * waveform step becomes one amplitude delta - a chip costs a call per step,
+ * not per CPU cycle. run() must therefore cost about the same for any span.
+ *
+ * Per-cycle mode drives the chip the same way: the APU only calls run()
+ * once cycles_until_step() cycles have passed (or at a register write or
+ * save state), and caches output() * gain() in between, so no virtual call
+ * happens per CPU cycle in either mode.
+ *
+ * Register writes land between spans: the bus brackets CPU writes to the
+ * cartridge with APU::begin_expansion_write()/end_expansion_write().
+ */
+class ExpansionAudio {
+  public:
+	virtual ~ExpansionAudio() = default;
+
+	// Chip name for the front end ("VRC6", ...)
+	[[nodiscard]] virtual const char *get_name() const noexcept = 0;
+
+	// Advance the chip by cycles CPU cycles
+	virtual void run(std::uint32_t cycles) noexcept = 0;
+	// CPU cycles until the output can next change (at least 1); a span of up
+	// to this many cycles steps nothing audible
+	[[nodiscard]] virtual std::uint32_t cycles_until_step() const noexcept = 0;
+	// Current level, on the scale of the APU mixer output (a 2A03 pulse
+	// channel at full volume is about 0.15)
+	[[nodiscard]] virtual float output() const noexcept = 0;
+
+	virtual void reset() noexcept = 0;
+	virtual void serialize_state(std::vector<std::uint8_t> &buffer) const = 0;
+	virtual void deserialize_state(const std::vector<std::uint8_t> &buffer, std::size_t &offset) = 0;
+
+	// Mix level of this chip against the 2A03 (1 = the chip's own scale).
+	// A listening preference, so not part of the saved state; change it
+	// through APU::set_expansion_gain() to have the mix pick it up.
+	void set_gain(float gain) noexcept {
+		gain_ = gain;
+	}
+	[[nodiscard]] float gain() const noexcept {
+		return gain_;
+	}
+
+  private:
+	float gain_ = 1.0f;
+};
+
+/**
+ * StepTimer - Divider that steps a waveform every `period` CPU cycles
+ *
+ * Expansion chips keep their channel timers in CPU cycles so a whole span
+ * can be applied with one division instead of a loop per cycle.
+ */
+struct StepTimer {
+	std::uint32_t left = 1;	  // CPU cycles to the next step (1..period)
+	std::uint32_t period = 1; // Applies from the next step on
+
+	// Advance by cycles; returns the number of steps taken
+	std::uint64_t run(std::uint64_t cycles) noexcept {
+		if (cycles < left) {
+			left -= static_cast<std::uint32_t>(cycles);
+			return 0;
+		}
+		cycles -= left;
+		left = period - static_cast<std::uint32_t>(cycles % period);
+		return 1 + cycles / period;
+	}
+};
+
+} // namespace nes
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "apu/expansion_audio.hpp"
+#include "core/types.hpp"
+#include <array>
+
+namespace nes {
+
+/**
+ * MMC5 sound: two pulse channels and a raw 8-bit PCM output
+ *
+ *   $5000-$5003, $5004-$5007: pulses, laid out as the 2A03's $4000-$4003
+ *                             (no sweep unit; $5001/$5005 do nothing)
+ *   $5010: PCM mode (only write mode is emulated; read mode stays silent)
+ *   $5011: PCM level (a 0 write is ignored)
+ *   $5015: length counter enables (bits 0-1); reads return length status
+ *
+ * Pulse timers step the 8-step duty sequence every 2 * (period + 1) CPU
+ * cycles; envelopes and length counters are clocked together at a fixed
+ * 240 Hz, every 7457 CPU cycles, rather than by the APU's frame counter.
+ */
+class Mmc5Audio final : public ExpansionAudio {
+  public:
+	Mmc5Audio();
+
+	void write(Address address, Byte value);
+	[[nodiscard]] Byte read_status() const noexcept;
+
+	[[nodiscard]] const char *get_name() const noexcept override {
+		return "MMC5";
+	}
+	void run(std::uint32_t cycles) noexcept override;
+	[[nodiscard]] std::uint32_t cycles_until_step() const noexcept override;
+	[[nodiscard]] float output() const noexcept override;
+
+	void reset() noexcept override;
+	void serialize_state(std::vector<std::uint8_t> &buffer) const override;
+	void deserialize_state(const std::vector<std::uint8_t> &buffer, std::size_t &offset) override;
+
+  private:
+	struct Pulse {
+		StepTimer timer;
+		std::uint16_t period = 0; // 11 bits
+		Byte duty = 0;
+		Byte sequence_pos = 0;
+		Byte length_counter = 0;
+		bool length_halt = false; // Also the envelope loop flag
+		bool constant_volume = false;
+		Byte volume = 0; // Constant volume, or the envelope period
+		bool envelope_start = false;
+		Byte envelope_divider = 0;
+		Byte envelope_decay = 0;
+		bool enabled = false;
+
+		[[nodiscard]] Byte level() const noexcept;
+		void clock_envelope() noexcept;
+	};
+
+	static constexpr std::uint32_t FRAME_CYCLES = 7457;
+
+	std::array<Pulse, 2> pulses_;
+	StepTimer frame_timer_;
+	Byte pcm_level_ = 0;
+	bool pcm_read_mode_ = false;
+
+	void clock_frame() noexcept;
+};
+
+} // namespace nes
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "apu/expansion_audio.hpp"
+#include "core/types.hpp"
+#include <array>
+
+namespace nes {
+
+/**
+ * Sunsoft 5B sound (the FME-7 variant with a YM2149-style PSG)
+ *
+ * $C000 selects one of 16 registers and $E000 writes it:
+ *   0-5:   tone periods for channels A-C (12 bits, low/high pairs)
+ *   6:     noise period (5 bits)
+ *   7:     mixer, active low (bits 0-2 tone A-C, bits 3-5 noise A-C)
+ *   8-10:  channel volume (bits 0-3), or the envelope when bit 4 is set
+ *   11-12: envelope period (16 bits)
+ *   13:    envelope shape (continue, attack, alternate, hold); restarts it
+ *
+ * Tones toggle every 16 * period CPU cycles, the 17-bit noise LFSR steps
+ * every 32 * period and the envelope every 16 * period. Volume steps are
+ * logarithmic, 3 dB apart.
+ */
+class Sunsoft5bAudio final : public ExpansionAudio {
+  public:
+	Sunsoft5bAudio();
+
+	void select(Byte value) noexcept {
+		selected_ = value & 0x0F;
+	}
+	void write(Byte value);
+
+	[[nodiscard]] const char *get_name() const noexcept override {
+		return "Sunsoft 5B";
+	}
+	void run(std::uint32_t cycles) noexcept override;
+	[[nodiscard]] std::uint32_t cycles_until_step() const noexcept override;
+	[[nodiscard]] float output() const noexcept override;
+
+	void reset() noexcept override;
+	void serialize_state(std::vector<std::uint8_t> &buffer) const override;
+	void deserialize_state(const std::vector<std::uint8_t> &buffer, std::size_t &offset) override;
+
+  private:
+	std::array<Byte, 16> registers_{};
+	Byte selected_ = 0;
+
+	std::array<StepTimer, 3> tone_timers_;
+	std::array<bool, 3> tone_high_{};
+	StepTimer noise_timer_;
+	std::uint32_t noise_lfsr_ = 1;
+	StepTimer envelope_timer_;
+	Byte envelope_step_ = 0; // 0-15 within the current ramp
+	bool envelope_attack_ = false;
+	bool envelope_holding_ = false;
+
+	[[nodiscard]] bool uses_envelope(int channel) const noexcept {
+		return (registers_[8 + channel] & 0x10) != 0;
+	}
+	[[nodiscard]] bool tone_enabled(int channel) const noexcept {
+		return (registers_[7] & (1 << channel)) == 0;
+	}
+	[[nodiscard]] bool noise_enabled(int channel) const noexcept {
+		return (registers_[7] & (8 << channel)) == 0;
+	}
+	[[nodiscard]] Byte envelope_level() const noexcept {
+		return envelope_attack_ ? envelope_step_ : static_cast<Byte>(15 - envelope_step_);
+	}
+	[[nodiscard]] Byte channel_volume(int channel) const noexcept {
+		return uses_envelope(channel) ? envelope_level() : static_cast<Byte>(registers_[8 + channel] & 0x0F);
+	}
+	void update_periods() noexcept;
+	void restart_envelope() noexcept;
+	void step_envelope() noexcept;
+};
+
+} // namespace nes
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "apu/expansion_audio.hpp"
+#include "core/types.hpp"
+#include <array>
+
+namespace nes {
+
+/**
+ * Konami VRC6 sound: two pulse channels and a sawtooth
+ *
+ * Registers (as seen by the mapper, address lines already normalized):
+ *   $9000/$A000: pulse mode (bit 7: constant), duty (bits 4-6), volume (0-3)
+ *   $9001/$A001: pulse period low 8 bits
+ *   $9002/$A002: pulse enable (bit 7), period high 4 bits
+ *   $9003:       frequency control (bit 0 halt, bit 1 period >> 4, bit 2 >> 8)
+ *   $B000:       saw accumulator rate (bits 0-5)
+ *   $B001/$B002: saw period low / enable + period high, as for the pulses
+ *
+ * Channel timers count CPU cycles. A pulse steps its 16-step duty sequence
+ * once per period; the saw adds its rate to the accumulator every second
+ * step and resets on the fourteenth, outputting the accumulator's top 5 bits.
+ */
+class Vrc6Audio final : public ExpansionAudio {
+  public:
+	Vrc6Audio();
+
+	void write(Address address, Byte value);
+
+	[[nodiscard]] const char *get_name() const noexcept override {
+		return "VRC6";
+	}
+	void run(std::uint32_t cycles) noexcept override;
+	[[nodiscard]] std::uint32_t cycles_until_step() const noexcept override;
+	[[nodiscard]] float output() const noexcept override;
+
+	void reset() noexcept override;
+	void serialize_state(std::vector<std::uint8_t> &buffer) const override;
+	void deserialize_state(const std::vector<std::uint8_t> &buffer, std::size_t &offset) override;
+
+  private:
+	struct Pulse {
+		StepTimer timer;
+		std::uint16_t period = 0; // 12 bits, before frequency control
+		Byte volume = 0;
+		Byte duty = 0;
+		Byte step = 15; // Counts down; high while step <= duty
+		bool constant = false;
+		bool enabled = false;
+
+		[[nodiscard]] Byte level() const noexcept {
+			return (enabled && (constant || step <= duty)) ? volume : 0;
+		}
+	};
+	struct Saw {
+		StepTimer timer;
+		std::uint16_t period = 0;
+		Byte rate = 0;
+		Byte step = 0; // 0-13
+		Byte accumulator = 0;
+		bool enabled = false;
+
+		[[nodiscard]] Byte level() const noexcept {
+			return enabled ? static_cast<Byte>(accumulator >> 3) : 0;
+		}
+	};
+
+	std::array<Pulse, 2> pulses_;
+	Saw saw_;
+	bool halted_ = false;
+	Byte period_shift_ = 0; // From $9003: 0, 4 or 8
+
+	// Full-volume pulse matches a full-volume 2A03 pulse
+	static constexpr float LEVEL_SCALE = 0.00995f;
+
+	void update_timers() noexcept;
+};
+
+} // namespace nes
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "audio/audio_output.hpp"
+#include "audio/latency_controller.hpp"
+#include "audio/spsc_ring_buffer.hpp"
 #include <SDL3/SDL.h>
 #include <atomic>
 #include <cstddef>
-#include <mutex>
-#include <vector>
+#include <span>
 
 namespace nes {
 
@@ -14,15 +16,19 @@ namespace nes {
  * Manages audio device initialization, sample buffering, and playback.
  * Operates at 44.1kHz stereo output with a fixed-size ring buffer.
  *
- * Thread-safe: Audio stream callback runs on SDL's audio thread, so all
- * ring buffer operations use a lightweight mutex.  The ring buffer avoids
- * any allocations or O(N) erases on the audio thread, preventing
- * micro-stutters and clicks.
+ * Thread-safe: the emulation thread is the ring's only producer and SDL's
+ * audio thread its only consumer, so samples flow through a wait-free SPSC
+ * ring with no mutex handoff per sample.  The ring avoids any allocations or
+ * O(N) erases on the audio thread, preventing micro-stutters and clicks.
+ *
+ * Every device pull is reported to a LatencyController, which measures the
+ * callback cadence and clock drift and, when made adaptive, lowers the fill
+ * the APU aims for (get_target_buffer_size) toward what the device needs.
  */
-class AudioBackend {
+class AudioBackend final : public AudioOutput {
   public:
 	AudioBackend();
-	~AudioBackend();
+	~AudioBackend() override;
 
 	// Disable copying (owns SDL audio device)
 	AudioBackend(const AudioBackend &) = delete;
@@ -34,17 +40,17 @@ class AudioBackend {
 	 * @param buffer_size Audio buffer size in samples (default 1024)
 	 * @return true if initialization successful
 	 */
-	bool initialize(int sample_rate = 44100, int buffer_size = 1024);
+	bool initialize(int sample_rate = 44100, int buffer_size = 1024) override;
 
 	/**
 	 * Start audio playback
 	 */
-	void start();
+	void start() override;
 
 	/**
 	 * Stop audio playback
 	 */
-	void stop();
+	void stop() override;
 
 	/**
 	 * Pause audio playback
@@ -61,52 +67,76 @@ class AudioBackend {
 	 * Will be automatically converted to stereo
 	 * @param sample Audio sample in range [-1.0, 1.0]
 	 */
-	void queue_sample(float sample);
+	void queue_sample(float sample) override;
+
+	/**
+	 * Queue a block of mono audio samples
+	 * Converted to stereo and published to the ring in chunks
+	 * @param samples Audio samples in range [-1.0, 1.0]
+	 */
+	void queue_samples(std::span<const float> samples) override;
 
 	/**
 	 * Queue a stereo audio sample
 	 * @param left Left channel sample in range [-1.0, 1.0]
 	 * @param right Right channel sample in range [-1.0, 1.0]
 	 */
-	void queue_sample_stereo(float left, float right);
+	void queue_sample_stereo(float left, float right) override;
 
 	/**
 	 * Set master volume
 	 * @param volume Volume level [0.0 = mute, 1.0 = full]
 	 */
-	void set_volume(float volume);
+	void set_volume(float volume) override;
 
 	/**
 	 * Get current master volume
 	 * @return Volume level [0.0, 1.0]
 	 */
-	float get_volume() const {
+	float get_volume() const override {
 		return volume_.load();
 	}
 
 	/**
 	 * Check if audio is playing
 	 */
-	bool is_playing() const {
+	bool is_playing() const override {
 		return is_playing_.load();
 	}
 
 	/**
 	 * Get number of samples currently in buffer
 	 */
-	std::size_t get_buffer_size() const;
+	std::size_t get_buffer_size() const override;
+
+	/**
+	 * Get the fill the latency controller currently aims for
+	 */
+	std::size_t get_target_buffer_size() const override {
+		return latency_.target();
+	}
+
+	/**
+	 * Latency measurement and adaptation (stats are safe to read from any thread)
+	 */
+	[[nodiscard]] LatencyController &latency() noexcept {
+		return latency_;
+	}
+	[[nodiscard]] const LatencyController &latency() const noexcept {
+		return latency_;
+	}
 
 	/**
 	 * Get sample rate
 	 */
-	int get_sample_rate() const {
+	int get_sample_rate() const override {
 		return sample_rate_;
 	}
 
 	/**
 	 * Clear all buffered audio
 	 */
-	void clear_buffer();
+	void clear_buffer() override;
 
   private:
 	SDL_AudioDeviceID device_id_;
@@ -122,14 +152,14 @@ class AudioBackend {
 	static constexpr std::size_t RING_CAPACITY = 32768; // ~372ms at 44.1kHz stereo
 
 	// Pre-buffer threshold: don't start SDL playback until we have this many
-	// stereo floats queued.  Prevents startup clicks from empty-buffer underruns.
+	// stereo floats queued (or the whole target, if lower).  Prevents startup
+	// clicks from empty-buffer underruns.
 	static constexpr std::size_t PRE_BUFFER_THRESHOLD = 4096; // ~46ms at 44.1kHz stereo
 
-	std::vector<float> ring_buffer_;
-	std::size_t ring_read_;
-	std::size_t ring_write_;
-	std::size_t ring_count_;
-	std::mutex ring_mutex_;
+	SpscRingBuffer<float, RING_CAPACITY> ring_;
+	static_assert(LatencyController::MAX_TARGET * 2 <= RING_CAPACITY / 2);
+
+	LatencyController latency_;
 
 	// Underrun fade state — when the ring runs dry, we exponentially decay
 	// the last output sample instead of hard-cutting to silence.
@@ -139,6 +169,10 @@ class AudioBackend {
 	// Pre-buffer flag: true after start() but before we have enough samples
 	bool want_playing_ = false;
 
+	// Producer side: resume the device once the pre-buffer has filled
+	void check_pre_buffer();
+	[[nodiscard]] std::size_t pre_buffer_threshold() const;
+
 	// Audio parameters
 	int sample_rate_;
 	int buffer_size_;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace nes {
+
+/**
+ * AudioOutput - Abstract audio sink used by the APU and SystemBus
+ *
+ * Keeps the emulation core free of any audio device dependency.  The SDL
+ * front end plugs in AudioBackend; headless builds simply leave the bus
+ * without an output, in which case the APU still runs but produces nothing.
+ */
+class AudioOutput {
+  public:
+	virtual ~AudioOutput() = default;
+
+	/**
+	 * Open the output device
+	 * @param sample_rate Target sample rate in Hz
+	 * @param buffer_size Device buffer size in samples
+	 * @return true if initialization successful
+	 */
+	virtual bool initialize(int sample_rate, int buffer_size) = 0;
+
+	virtual void start() = 0;
+	virtual void stop() = 0;
+
+	/**
+	 * Queue a single mono audio sample
+	 * @param sample Audio sample in range [-1.0, 1.0]
+	 */
+	virtual void queue_sample(float sample) = 0;
+
+	/**
+	 * Queue a block of mono audio samples
+	 * Backends should override this to pay their per-call overhead once per block.
+	 * @param samples Audio samples in range [-1.0, 1.0]
+	 */
+	virtual void queue_samples(std::span<const float> samples) {
+		for (float sample : samples) {
+			queue_sample(sample);
+		}
+	}
+
+	/**
+	 * Queue a stereo audio sample
+	 * @param left Left channel sample in range [-1.0, 1.0]
+	 * @param right Right channel sample in range [-1.0, 1.0]
+	 */
+	virtual void queue_sample_stereo(float left, float right) = 0;
+
+	virtual void set_volume(float volume) = 0;
+	[[nodiscard]] virtual float get_volume() const = 0;
+	[[nodiscard]] virtual bool is_playing() const = 0;
+
+	/**
+	 * Get number of samples currently buffered (drives APU rate control)
+	 */
+	[[nodiscard]] virtual std::size_t get_buffer_size() const = 0;
+
+	/**
+	 * Get the fill, in samples, the APU's rate control should keep buffered.
+	 * Backends that measure their device (AudioBackend) may lower it.
+	 */
+	[[nodiscard]] virtual std::size_t get_target_buffer_size() const {
+		return DEFAULT_TARGET_BUFFER_SIZE;
+	}
+	static constexpr std::size_t DEFAULT_TARGET_BUFFER_SIZE = 3072; // ~70 ms at 44.1 kHz
+
+	/**
+	 * Get the actual output sample rate in Hz
+	 */
+	[[nodiscard]] virtual int get_sample_rate() const = 0;
+
+	virtual void clear_buffer() = 0;
+};
+
+} // namespace nes
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "audio/spsc_ring_buffer.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <thread>
+
+namespace nes {
+
+/**
+ * AudioRecorder - Streams the APU's output, and optionally per-channel
+ * stems, to 32-bit float WAV or raw files from a writer thread
+ *
+ * The APU (APU::set_recorder) writes each track's samples once per output
+ * frame; write() only copies them into that track's wait-free SPSC ring, so
+ * the emulation thread never waits on the disk. If the writer falls a ring
+ * behind (about three seconds at 44.1 kHz) samples are dropped and counted
+ * rather than stalling emulation.
+ *
+ * The mixed output goes to the path given to open(); stems go next to it
+ * with the channel name before the extension (song.wav -> song.pulse1.wav).
+ * WAV headers are written with zero lengths and patched by close().
+ */
+class AudioRecorder {
+  public:
+	enum class Format : std::uint8_t {
+		Wav,	  // IEEE float WAV, mono
+		RawFloat, // Bare host-order 32-bit floats
+	};
+	enum class Track : std::uint8_t { Mix, Pulse1, Pulse2, Triangle, Noise, Dmc };
+	static constexpr std::size_t TRACK_COUNT = 6;
+
+	AudioRecorder() = default;
+	// Closes the files if still open
+	~AudioRecorder();
+	AudioRecorder(const AudioRecorder &) = delete;
+	AudioRecorder &operator=(const AudioRecorder &) = delete;
+
+	/// Create the files and start the writer thread
+	bool open(const std::filesystem::path &path, int sample_rate, Format format = Format::Wav, bool stems = false);
+	/// Write out everything queued, finish the headers and close the files.
+	/// Returns false if any write failed.
+	bool close();
+
+	[[nodiscard]] bool is_open() const noexcept {
+		return thread_.joinable();
+	}
+	[[nodiscard]] bool records_stems() const noexcept {
+		return stems_;
+	}
+
+	/// Producer side (emulation thread). Tracks that aren't recorded ignore it.
+	void write(Track track, std::span<const float> samples) noexcept;
+
+	// Samples written to the track's file so far (writer side, exact after close)
+	[[nodiscard]] std::uint64_t samples_written(Track track) const noexcept;
+	[[nodiscard]] std::uint64_t dropped_samples() const noexcept {
+		return dropped_.load(std::memory_order_relaxed);
+	}
+
+	/// Where a track is (or would be) written for the recording at `path`
+	[[nodiscard]] static std::filesystem::path track_path(const std::filesystem::path &path, Track track);
+
+  private:
+	static constexpr std::size_t RING_SIZE = 1 << 17;
+
+	struct Stream {
+		std::ofstream file;
+		SpscRingBuffer<float, RING_SIZE> ring;
+		std::atomic<std::uint64_t> written{0};
+	};
+
+	std::array<std::unique_ptr<Stream>, TRACK_COUNT> streams_;
+	Format format_ = Format::Wav;
+	int sample_rate_ = 44100;
+	bool stems_ = false;
+	std::thread thread_;
+	std::atomic<bool> stop_{false};
+	std::atomic<bool> failed_{false};
+	std::atomic<std::uint64_t> dropped_{0};
+
+	void writer_main();
+	bool drain(Stream &stream);
+	void write_wav_header(std::ofstream &file, std::uint64_t samples) const;
+};
+
+} // namespace nes
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * BlipBuffer - Band-limited step synthesis buffer
+ *
+ * Instead of sampling a waveform at its source clock and downsampling, the
+ * producer records amplitude changes ("deltas") with the source clock time at
+ * which they happen.  Each delta is drawn into the output-rate buffer as a
+ * windowed-sinc band-limited impulse at its exact fractional position; reading
+ * integrates those impulses back into steps.  The result is alias-free up to
+ * the kernel cutoff and costs nothing for clocks where the waveform is flat.
+ *
+ * Usage per frame: add_delta() any number of times with clock times relative
+ * to the frame start, end_frame(clocks) to commit them, then read_samples()
+ * until samples_available() is zero.  Rates may only change between frames.
+ *
+ * Output lags input by HALF_WIDTH - 1 samples (the kernel's leading taps).
+ */
+class BlipBuffer {
+  public:
+	static constexpr int HALF_WIDTH = 8; // kernel spans 2 * HALF_WIDTH output samples
+	static constexpr int PHASES = 64;	 // fractional positions tabulated per output sample
+
+	/**
+	 * @param clock_rate Source clock in Hz (NES CPU clock)
+	 * @param sample_rate Output sample rate in Hz
+	 * @param max_frame_clocks Longest frame end_frame() will be called with
+	 */
+	BlipBuffer(double clock_rate = 1789773.0, double sample_rate = 44100.0, std::uint32_t max_frame_clocks = 29781);
+
+	/**
+	 * Change the clock/sample ratio (effective from the next add_delta; call between frames)
+	 */
+	void set_rates(double clock_rate, double sample_rate);
+
+	/**
+	 * Add an amplitude change at a clock time within the current frame
+	 */
+	void add_delta(std::uint32_t clock_time, float delta);
+
+	/**
+	 * Commit clocks worth of input; the deltas become readable output samples
+	 */
+	void end_frame(std::uint32_t clocks);
+
+	[[nodiscard]] std::size_t samples_available() const noexcept {
+		return static_cast<std::size_t>(offset_ >> FRAC_BITS);
+	}
+
+	/**
+	 * Read up to out.size() finished samples
+	 * @return Number of samples written
+	 */
+	std::size_t read_samples(std::span<float> out);
+
+	/**
+	 * Discard all buffered input and output and return the output level to zero
+	 */
+	void clear();
+
+  private:
+	static constexpr int FRAC_BITS = 32;
+	static constexpr int PHASE_BITS = 6; // log2(PHASES)
+	static_assert((1 << PHASE_BITS) == PHASES);
+
+	std::uint64_t factor_; // output samples per clock, FRAC_BITS fixed point
+	std::uint64_t offset_; // start of the current frame in output samples, fixed point
+	float integrator_;	   // running sum of impulses = current output level
+	std::size_t max_frame_clocks_;
+	std::vector<float> buffer_;
+
+	void resize_for_rates();
+};
+
+} // namespace nes
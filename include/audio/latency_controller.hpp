@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace nes {
+
+/**
+ * LatencyController - Picks the audio buffer fill the APU's rate control aims for
+ *
+ * The device thread reports every pull (on_pull): when it came, how many
+ * frames it asked for and how many were queued. From those it measures the
+ * callback cadence and jitter, the device's real sample rate against the
+ * host clock (drift), and the lowest fill between the producer's
+ * once-per-frame handoffs.
+ *
+ * With adaptation enabled the target then follows what the hardware needs.
+ * At the end of every WINDOW_SECONDS window in which the fill has settled,
+ * the target drops by whatever the lowest fill kept beyond the largest pull
+ * and a jitter margin: at most 10% a window, never below twice the largest
+ * pull. An underrun raises it by half plus one pull and holds it there for
+ * HOLD_WINDOWS windows. Disabled, the target stays at DEFAULT_TARGET (~70 ms
+ * at 44.1 kHz).
+ *
+ * Frames are stereo pairs. on_pull() must only be called from one thread;
+ * the getters are safe from any thread.
+ */
+class LatencyController {
+  public:
+	static constexpr std::size_t DEFAULT_TARGET = 3072;
+	static constexpr std::size_t MIN_TARGET = 256;
+	static constexpr std::size_t MAX_TARGET = 8192; // Half of AudioBackend's ring
+	static constexpr double WINDOW_SECONDS = 2.0;
+	static constexpr int HOLD_WINDOWS = 5;
+
+	struct Stats {
+		double callback_interval_ms = 0.0; // Mean time between pulls
+		double callback_jitter_ms = 0.0;   // Mean deviation from that
+		std::size_t largest_pull = 0;	   // Frames, this window or the last
+		double device_rate_hz = 0.0;	   // Measured consumption rate (0 until measured)
+		double drift_ppm = 0.0;			   // Device rate against the nominal rate
+		std::size_t target = 0;			   // Frames the producer aims to keep queued
+		std::size_t fill = 0;			   // Frames queued at the last pull
+		std::uint64_t underruns = 0;	   // Pulls that got less than they asked for
+	};
+
+	explicit LatencyController(int sample_rate = 44100) noexcept;
+
+	/**
+	 * Device thread: one pull
+	 * @param now_ns Monotonic time of the pull in nanoseconds
+	 * @param requested Frames the device asked for
+	 * @param available Frames queued when it asked
+	 */
+	void on_pull(std::uint64_t now_ns, std::size_t requested, std::size_t available) noexcept;
+
+	/// Nominal device rate; set before the first pull
+	void set_sample_rate(int sample_rate) noexcept {
+		sample_rate_ = sample_rate > 0 ? sample_rate : 44100;
+	}
+
+	/// Forget all measurements (at the next pull) and go back to the default target
+	void reset() noexcept;
+
+	void set_adaptive(bool adaptive) noexcept;
+	[[nodiscard]] bool is_adaptive() const noexcept {
+		return adaptive_.load(std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] std::size_t target() const noexcept {
+		return target_.load(std::memory_order_relaxed);
+	}
+	[[nodiscard]] int sample_rate() const noexcept {
+		return sample_rate_;
+	}
+	[[nodiscard]] Stats stats() const noexcept;
+
+	// Frames to milliseconds at the nominal rate
+	[[nodiscard]] double to_ms(std::size_t frames) const noexcept {
+		return static_cast<double>(frames) * 1000.0 / sample_rate_;
+	}
+
+  private:
+	int sample_rate_;
+	std::atomic<bool> adaptive_{false};
+	std::atomic<bool> reset_pending_{false};
+	std::atomic<std::size_t> target_{DEFAULT_TARGET};
+
+	// Device thread only
+	bool started_ = false;
+	std::uint64_t last_ns_ = 0;
+	std::uint64_t first_ns_ = 0;
+	std::uint64_t frames_since_first_ = 0;
+	double interval_ns_ = 0.0;
+	double jitter_ns_ = 0.0;
+	std::uint64_t window_start_ns_ = 0;
+	std::size_t window_pulls_ = 0;
+	double window_fill_sum_ = 0.0;
+	std::size_t window_fill_min_ = 0;
+	std::size_t window_largest_pull_ = 0;
+	bool window_underrun_ = false;
+	double last_window_mean_ = -1.0; // Mean fill of the previous window
+	int hold_windows_ = 0;
+
+	// Published for stats()
+	std::atomic<double> published_interval_ns_{0.0};
+	std::atomic<double> published_jitter_ns_{0.0};
+	std::atomic<double> published_rate_hz_{0.0};
+	std::atomic<std::size_t> published_largest_pull_{0};
+	std::atomic<std::size_t> published_fill_{0};
+	std::atomic<std::uint64_t> underruns_{0};
+
+	void restart() noexcept;
+	void end_window(std::uint64_t now_ns) noexcept;
+};
+
+} // namespace nes
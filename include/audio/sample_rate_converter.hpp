@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <span>
 
 namespace nes {
 
@@ -35,6 +36,13 @@ class SampleRateConverter {
 	 */
 	void input_sample(float sample);
 
+	/**
+	 * Feed a block of input samples (same result as input_sample() on each)
+	 * @param output Needs room for input.size() samples
+	 * @return Number of output samples written
+	 */
+	std::size_t process(std::span<const float> input, std::span<float> output);
+
 	/**
 	 * Check if an output sample is ready
 	 * @return true if output sample available
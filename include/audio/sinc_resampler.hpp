@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * SincResampler - Polyphase windowed-sinc downsampler working on blocks
+ *
+ * Drop-in alternative to SampleRateConverter with far better alias
+ * rejection. Two stages:
+ *   1. Box-average by an integer factor down to about four times the output
+ *      rate (~179 kHz for 44.1 kHz). Its nulls fall on multiples of that
+ *      rate, so what folds into the audible band was attenuated by the
+ *      APU's 14 kHz pre-filter and the box response together.
+ *   2. A TAPS-tap Blackman-windowed sinc, cut off just below the output
+ *      Nyquist, at PHASES tabulated fractional positions; each output is one
+ *      SIMD dot product over the newest TAPS intermediate samples.
+ *
+ * process() consumes a whole block per call, so the per-cycle producer
+ * just fills an array. Any output rate below the input rate works (44.1,
+ * 48 and 96 kHz included). Output lags input by TAPS / 2 intermediate
+ * samples (~0.36 ms at 44.1 kHz).
+ */
+class SincResampler {
+  public:
+	static constexpr int TAPS = 128;
+	static constexpr int PHASES = 128;
+
+	explicit SincResampler(float input_rate = 1789773.0f, float output_rate = 44100.0f);
+
+	/**
+	 * Resample a block of input
+	 * @param output Needs room for input.size() + 1 samples (the most a block
+	 *               can yield while the output rate is below the input rate)
+	 * @return Number of output samples written
+	 */
+	std::size_t process(std::span<const float> input, std::span<float> output);
+
+	void reset();
+
+	// Input samples per output sample
+	[[nodiscard]] float get_ratio() const noexcept {
+		return static_cast<float>(decimation_ * base_step_);
+	}
+	[[nodiscard]] int get_decimation() const noexcept {
+		return decimation_;
+	}
+
+	/// Same contract as SampleRateConverter::set_rate_adjustment()
+	void set_rate_adjustment(float factor);
+
+  private:
+	using Row = std::array<float, TAPS>;
+
+	int decimation_ = 1;	  // Stage 1 factor
+	double base_step_ = 1.0;  // Intermediate samples per output sample
+	double step_ = 1.0;		  // base_step_ with the rate adjustment applied
+	double until_output_ = 0; // Intermediate samples left before the next output
+	float box_sum_ = 0.0f;
+	int box_count_ = 0;
+
+	// The newest TAPS intermediate samples, written twice (at i and i + TAPS)
+	// so the window ending at any position is contiguous
+	std::array<float, TAPS * 2> history_{};
+	std::size_t head_ = 0;
+
+	std::vector<Row> kernel_; // PHASES + 1 rows, taps oldest first
+
+	[[nodiscard]] float convolve(double fraction) const noexcept;
+};
+
+} // namespace nes
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+namespace nes {
+
+/**
+ * SpscRingBuffer - Wait-free single-producer/single-consumer ring
+ *
+ * The emulation thread pushes, the audio device thread pops.  Each side owns
+ * one monotonically increasing index and only reads the other's, so neither
+ * ever blocks: head_ is published with release after the slots are written,
+ * tail_ with release after the slots are read, and each side acquires the
+ * other's index before touching the storage.
+ *
+ * Capacity must be a power of two so indices wrap with a mask and the
+ * (head - tail) distance stays correct across size_t overflow.
+ */
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer {
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  public:
+	[[nodiscard]] static constexpr std::size_t capacity() noexcept {
+		return Capacity;
+	}
+
+	/**
+	 * Producer: append as many items as fit
+	 * @return Number of items written (a prefix of items)
+	 */
+	std::size_t push(std::span<const T> items) noexcept {
+		const std::size_t head = head_.load(std::memory_order_relaxed);
+		const std::size_t tail = tail_.load(std::memory_order_acquire);
+		const std::size_t count = std::min(items.size(), Capacity - (head - tail));
+
+		const std::size_t start = head & MASK;
+		const std::size_t first = std::min(count, Capacity - start);
+		std::copy_n(items.data(), first, storage_.data() + start);
+		std::copy_n(items.data() + first, count - first, storage_.data());
+
+		head_.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	/**
+	 * Producer: free slots (a lower bound; the consumer may free more)
+	 */
+	[[nodiscard]] std::size_t write_available() const noexcept {
+		return Capacity - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+	}
+
+	/**
+	 * Consumer: remove up to out.size() items
+	 * @return Number of items copied into out
+	 */
+	std::size_t pop(std::span<T> out) noexcept {
+		const std::size_t tail = tail_.load(std::memory_order_relaxed);
+		const std::size_t head = head_.load(std::memory_order_acquire);
+		const std::size_t count = std::min(out.size(), head - tail);
+
+		const std::size_t start = tail & MASK;
+		const std::size_t first = std::min(count, Capacity - start);
+		std::copy_n(storage_.data() + start, first, out.data());
+		std::copy_n(storage_.data(), count - first, out.data() + first);
+
+		tail_.store(tail + count, std::memory_order_release);
+		return count;
+	}
+
+	/**
+	 * Items currently queued (exact from either side when the other is idle)
+	 */
+	[[nodiscard]] std::size_t size() const noexcept {
+		return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Drop everything queued.  Not wait-free: the caller must guarantee the
+	 * consumer is not inside pop() (AudioBackend holds the SDL stream lock).
+	 */
+	void reset() noexcept {
+		tail_.store(head_.load(std::memory_order_relaxed), std::memory_order_release);
+	}
+
+  private:
+	static constexpr std::size_t MASK = Capacity - 1;
+
+	// Separate cache lines so the two threads don't false-share their indices
+	alignas(64) std::atomic<std::size_t> head_{0};
+	alignas(64) std::atomic<std::size_t> tail_{0};
+	alignas(64) std::array<T, Capacity> storage_{};
+};
+
+} // namespace nes
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "cartridge/code_data_logger.hpp"
 #include "cartridge/mappers/mapper.hpp"
+#include "cartridge/rom_image.hpp"
 #include "cartridge/rom_loader.hpp"
 #include "core/component.hpp"
+#include "core/region.hpp"
 #include <functional>
 #include <memory>
 #include <span>
@@ -10,6 +13,8 @@
 
 namespace nes {
 
+class APU;
+
 /**
  * NES Cartridge - Manages ROM data and mapper hardware
  * Handles loading ROM files and provides CPU/PPU memory access
@@ -28,6 +33,10 @@ class Cartridge final : public Component {
 	// Cartridge operations
 	bool load_rom(const std::string &filepath);
 	bool load_from_rom_data(const RomData &rom_data); // For testing with synthetic ROM data
+	// Run an image other cartridges may be running too (only RAM is per cartridge)
+	bool load_rom_image(std::shared_ptr<const RomImage> image);
+	// Run a mapper built by hand, with no ROM image behind it (test doubles)
+	bool load_mapper(std::unique_ptr<Mapper> mapper);
 	void unload_rom();
 	bool is_loaded() const noexcept {
 		return mapper_ != nullptr;
@@ -36,12 +45,76 @@ class Cartridge final : public Component {
 	// Memory access (called by SystemBus)
 	Byte cpu_read(Address address) const;
 	void cpu_write(Address address, Byte value);
-	Byte ppu_read(Address address) const;
+	// Bus writes carry the CPU cycle they land on (see Mapper::cpu_write_at)
+	void cpu_write_at(Address address, Byte value, std::uint64_t cpu_cycle);
+	// cdl_flags: how the Code/Data Logger records the access (PPUDATA reads
+	// pass CHR_READ)
+	Byte ppu_read(Address address, Byte cdl_flags = CodeDataLogger::CHR_RENDERED) const;
 	void ppu_write(Address address, Byte value);
 
 	// Mapper notifications (for MMC3 scanline counter, etc.)
 	void ppu_a12_toggle() const;
 
+	// Mapper PRG page table for $8000-$FFFF, or nullptr when no ROM is loaded
+	// or the mapper needs cpu_read() for PRG (cached at load)
+	const Mapper::PrgPageTable *prg_page_table() const noexcept {
+		return prg_page_table_;
+	}
+
+	// The PRG ROM prg_page_table() entries point into (empty without a table)
+	std::span<const Byte> prg_rom_data() const noexcept {
+		return prg_page_table_ ? mapper_->prg_rom_data() : std::span<const Byte>{};
+	}
+
+	// Console nametable RAM (2KB) the mapper maps its nametable pages onto;
+	// set by PPUMemory and kept across ROM loads
+	void attach_ciram(Byte *ciram);
+	// Mapper nametable page table for $2000-$2FFF, or nullptr when no ROM is
+	// loaded or no CIRAM is attached
+	const Mapper::NametablePageTable *nametable_pages() const noexcept {
+		return mapper_ && ciram_ ? &mapper_->nametable_pages() : nullptr;
+	}
+
+	// Pre-decoded CHR tiles for the current bank mapping, or nullptr when no
+	// ROM is loaded
+	const ChrTileCache *chr_tile_cache() const noexcept {
+		return mapper_ ? &mapper_->chr_tile_cache() : nullptr;
+	}
+
+	// Filtered A12 edges before the mapper can raise an IRQ (see Mapper)
+	std::uint32_t a12_edges_until_irq() const noexcept {
+		return mapper_ ? mapper_->a12_edges_until_irq() : Mapper::NO_A12_IRQ;
+	}
+
+	// Mapper CPU-cycle IRQ counter (see Mapper::has_cpu_cycle_timer()); the
+	// bus runs it in spans and posts its deadline
+	bool has_cpu_cycle_timer() const noexcept {
+		return mapper_has_cycle_timer_;
+	}
+	void run_cpu_cycle_timer(std::uint32_t cycles) const noexcept {
+		if (mapper_has_cycle_timer_) {
+			mapper_->run_cpu_cycle_timer(cycles);
+		}
+	}
+	std::uint32_t cpu_cycles_until_irq() const noexcept {
+		return mapper_has_cycle_timer_ ? mapper_->cpu_cycles_until_irq() : Mapper::NO_CYCLE_IRQ;
+	}
+
+	// PPU frame notifications (see Mapper::wants_ppu_notifications()); the
+	// PPU checks the cached flag before each call
+	bool wants_ppu_notifications() const noexcept {
+		return mapper_wants_ppu_notify_;
+	}
+	void ppu_scanline_start(int scanline, bool rendering) const;
+	void ppu_fetch_phase(bool sprites, bool tall_sprites) const;
+	bool scanline_irq_armed() const noexcept {
+		return mapper_wants_ppu_notify_ && mapper_->scanline_irq_armed();
+	}
+
+	// APU that mixes the mapper's expansion audio; the cartridge hands it each
+	// new mapper's chip (or none) as ROMs come and go
+	void connect_apu(APU *apu);
+
 	// IRQ support (for MMC3, MMC5, etc.). Inline + non-virtual: polled every
 	// CPU cycle by the bus, so this must collapse to a couple of loads.
 	bool is_irq_pending() const noexcept {
@@ -53,30 +126,49 @@ class Cartridge final : public Component {
 		}
 	}
 
-	// Per-cycle mapper notification, inline with cached early-out (only MMC1
-	// opts in). Called from the bus hot path instead of the virtual tick().
-	void notify_cpu_cycles(int count) noexcept {
-		if (mapper_wants_cycle_notify_) {
-			for (int i = 0; i < count; ++i) {
-				mapper_->notify_cpu_cycle();
-			}
-		}
-	}
-
-	// ROM information
-	const RomData &get_rom_data() const noexcept {
-		return rom_data_;
+	// ROM information. get_rom_data() has the header fields and filename only;
+	// the ROM bytes are in get_rom_image()
+	const RomData &get_rom_data() const noexcept;
+	const std::shared_ptr<const RomImage> &get_rom_image() const noexcept {
+		return image_;
 	}
 	std::uint8_t get_mapper_id() const noexcept;
 	const char *get_mapper_name() const noexcept;
 	Mapper::Mirroring get_mirroring() const noexcept;
+	// Timing region from the header; multi-region carts run as NTSC
+	Region get_region() const noexcept;
 
 	// Save state serialization
 	void serialize_state(std::vector<uint8_t> &buffer) const;
 	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset);
 
+	// serialize_state() split in two for snapshots and clones: the cartridge
+	// RAM, moved page-wise (see Mapper::RamPageMark), and everything after it
+	// (mapper registers, four-screen VRAM)
+	std::size_t tracked_ram_size() const noexcept {
+		return mapper_ ? mapper_->tracked_ram_size() : 0;
+	}
+	void save_ram_pages(Byte *ram, Mapper::RamPageMark &mark) const {
+		if (mapper_) {
+			mapper_->save_ram_pages(ram, mark);
+		}
+	}
+	void load_ram_pages(const Byte *ram, const Mapper::RamPageMark &mark) {
+		if (mapper_) {
+			mapper_->load_ram_pages(ram, mark);
+		}
+	}
+	// Both cartridges must hold the same ROM image
+	void copy_ram_from(const Cartridge &source) {
+		if (mapper_ && source.mapper_) {
+			mapper_->copy_ram_from(*source.mapper_);
+		}
+	}
+	void serialize_registers(std::vector<uint8_t> &buffer) const;
+	void deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset);
+
 	// --- Battery-backed PRG-RAM (persistent .sav files) ---
-	// Delegates to the mapper; only battery-flagged MMC1/MMC3 carts have it.
+	// Delegates to the mapper; only battery-flagged carts with PRG-RAM have it.
 	bool has_battery_ram() const noexcept {
 		return mapper_ && mapper_->has_battery_ram();
 	}
@@ -96,6 +188,43 @@ class Cartridge final : public Component {
 			mapper_->clear_battery_ram_dirty();
 		}
 	}
+	// What changed since the last clear, page by page (Mapper::RamRange)
+	std::vector<Mapper::RamRange> battery_ram_dirty_ranges() const {
+		return mapper_ ? mapper_->battery_ram_dirty_ranges() : std::vector<Mapper::RamRange>{};
+	}
+	bool battery_ram_written_since(Mapper::RamPageMark &mark) const noexcept {
+		return mapper_ && mapper_->battery_ram_written_since(mark);
+	}
+	// Back battery RAM with a file mapping (Mapper::map_battery_ram); close
+	// the mapping only after an empty span, or once this mapper is replaced
+	bool map_battery_ram(std::span<Byte> backing) {
+		return mapper_ && mapper_->map_battery_ram(backing);
+	}
+
+	// --- Code/Data Logger (.cdl) ---
+	// Off by default. While on, the bus logs PRG ROM fetches and reads and
+	// the PPU logs CHR ROM accesses into the logger; a ROM load re-sizes and
+	// clears the log. code_data_logger() is nullptr while off.
+	void set_cdl_enabled(bool enabled);
+	bool is_cdl_enabled() const noexcept {
+		return cdl_active_ != nullptr;
+	}
+	CodeDataLogger *code_data_logger() const noexcept {
+		return cdl_active_;
+	}
+	CodeDataLogger &get_cdl() noexcept {
+		return cdl_;
+	}
+	const CodeDataLogger &get_cdl() const noexcept {
+		return cdl_;
+	}
+	// Rendered pattern fetch served from the CHR tile cache (no ppu_read())
+	void log_chr_rendered(Address address) const noexcept {
+		if (cdl_active_) [[unlikely]] {
+			cdl_active_->log_chr(mapper_->chr_tile_cache().slot_source((address >> 10) & 0x07), address,
+								 CodeDataLogger::CHR_RENDERED);
+		}
+	}
 
 	// Hook invoked just before the current mapper is discarded (ROM change or
 	// unload), while the outgoing ROM's filename and PRG-RAM are still valid, so
@@ -105,21 +234,52 @@ class Cartridge final : public Component {
 	}
 
 	// Additional getters needed for save state
-	const std::vector<uint8_t> &get_prg_rom() const {
-		return rom_data_.prg_rom;
+	std::span<const Byte> get_prg_rom() const noexcept {
+		return image_ ? image_->prg_rom() : std::span<const Byte>{};
+	}
+	// CRC-32 of PRG ROM (0 without a ROM), computed once when the ROM loads
+	std::uint32_t get_prg_rom_crc32() const noexcept {
+		return image_ ? image_->prg_crc32() : 0;
+	}
+	const std::string &get_rom_filename() const noexcept {
+		return get_rom_data().filename;
 	}
-	const std::string &get_rom_filename() const {
-		return rom_data_.filename;
+	// Changes whenever the ROM is replaced or unloaded, so state derived from
+	// ROM contents (snapshot layout) can be cached against it
+	std::uint32_t get_load_id() const noexcept {
+		return load_id_;
 	}
 
   private:
+	// Declared first so the mapper, which reads it in place, goes first
+	std::shared_ptr<const RomImage> image_;
 	std::unique_ptr<Mapper> mapper_;
-	RomData rom_data_;
-	// Cached at load: whether mapper_ needs per-cycle notify_cpu_cycle() calls
-	// (only MMC1). Lets tick() early-out instead of a virtual call per CPU cycle.
-	bool mapper_wants_cycle_notify_ = false;
+	std::uint32_t load_id_ = 0;
+	// Cached at load so the per-cycle paths skip the virtual queries
+	bool mapper_has_cycle_timer_ = false;
+	bool mapper_wants_ppu_notify_ = false;
+	// Cached at load: &mapper_->prg_page_table() when the mapper opts in
+	const Mapper::PrgPageTable *prg_page_table_ = nullptr;
+	// Cached at load: which built-in mapper class mapper_ is, for
+	// with_mapper() (VIBENES_DEVIRTUALIZED_MAPPERS builds)
+	enum class MapperKind : std::uint8_t { Other, Nrom, Mmc1, Uxrom, Cnrom, Mmc3 };
+	MapperKind mapper_kind_ = MapperKind::Other;
+	Byte *ciram_ = nullptr; // See attach_ciram()
+	APU *apu_ = nullptr;	// See connect_apu()
 	// Called before an already-loaded mapper is replaced/destroyed (see above).
 	std::function<void()> pre_swap_hook_;
+	// Code/Data Logger; cdl_active_ points at cdl_ while logging is on
+	CodeDataLogger cdl_;
+	CodeDataLogger *cdl_active_ = nullptr;
+	bool cdl_enabled_ = false;
+	void attach_cdl();
+	void cache_mapper_traits();
+	// Replace the mapper (null unloads) and the image it reads
+	bool install_mapper(std::unique_ptr<Mapper> mapper, std::shared_ptr<const RomImage> image);
+	void serialize_vram(std::vector<uint8_t> &buffer) const;
+	void deserialize_vram(const std::vector<uint8_t> &buffer, size_t &offset);
+	static MapperKind classify_mapper(const Mapper *mapper) noexcept;
+	template <typename Fn> decltype(auto) with_mapper(Fn &&fn) const;
 };
 
 } // namespace nes
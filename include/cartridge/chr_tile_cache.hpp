@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * Pre-decoded CHR pattern cache
+ *
+ * Stores every 8x8 tile row of CHR memory as eight 2-bit pixel values, plus a
+ * horizontally flipped copy, so the PPU can produce pixels with table lookups
+ * instead of interleaving bitplanes by hand.
+ *
+ * Decoded data is kept per physical 1KB CHR page and looked up through the
+ * eight 1KB slots the mapper currently exposes at $0000-$1FFF. Pages are
+ * decoded lazily the first time a bank switch maps them in, so re-selecting
+ * a bank costs only a pointer update.
+ *
+ * Owning mappers must keep the cache in sync:
+ *   - attach() once CHR memory has its final size
+ *   - map_slots() from update_bank_maps() (bank switches)
+ *   - invalidate() after every CHR-RAM write, invalidate_all() after bulk
+ *     restores (save states)
+ */
+class ChrTileCache {
+  public:
+	// One decoded row: pixel i (0 = leftmost) in bits 8i..8i+1 (value 0-3)
+	using Row = std::uint64_t;
+
+	static constexpr std::size_t PAGE_SIZE = 1024;
+	static constexpr std::size_t SLOT_COUNT = 8;
+	static constexpr std::size_t ROWS_PER_PAGE = (PAGE_SIZE / 16) * 8; // 64 tiles x 8 rows
+
+	ChrTileCache();
+
+	void attach(std::span<const Byte> chr_memory);
+	void map_slots(const std::array<const Byte *, SLOT_COUNT> &slots);
+	void invalidate(std::size_t chr_offset) noexcept;
+	void invalidate_all();
+
+	// Decoded row for a pattern address ($0000-$1FFF); the plane bit (bit 3)
+	// is ignored since both planes are folded into one row
+	[[nodiscard]] Row row(Address address) const noexcept {
+		return slot_pages_[(address >> 10) & 0x07]->rows[row_index(address)];
+	}
+	[[nodiscard]] Row row_flipped(Address address) const noexcept {
+		return slot_pages_[(address >> 10) & 0x07]->flipped[row_index(address)];
+	}
+
+	// CHR memory given to attach(), and what a 1KB slot currently maps (lets
+	// callers turn a pattern address back into a CHR offset)
+	[[nodiscard]] std::span<const Byte> chr_memory() const noexcept {
+		return {chr_, chr_size_};
+	}
+	[[nodiscard]] const Byte *slot_source(std::size_t slot) const noexcept {
+		return slot_sources_[slot];
+	}
+
+	[[nodiscard]] static Row decode_row(Byte low, Byte high) noexcept;
+	[[nodiscard]] static Row decode_row_flipped(Byte low, Byte high) noexcept;
+
+	[[nodiscard]] static constexpr std::uint8_t pixel(Row row, int x) noexcept {
+		return static_cast<std::uint8_t>((row >> (x * 8)) & 0x03);
+	}
+
+  private:
+	struct Page {
+		std::array<Row, ROWS_PER_PAGE> rows{};
+		std::array<Row, ROWS_PER_PAGE> flipped{};
+		bool valid = false;
+	};
+
+	static constexpr std::size_t row_index(Address address) noexcept {
+		// tile (bits 4-9) * 8 + fine Y (bits 0-2)
+		return ((address & 0x03F0) >> 1) | (address & 0x0007);
+	}
+	static void decode_page(Page &page, const Byte *source) noexcept;
+
+	const Byte *chr_ = nullptr;
+	std::size_t chr_size_ = 0;
+	std::vector<std::unique_ptr<Page>> pages_; // Indexed by physical 1KB page
+
+	// Slots mapped to memory outside chr_ (e.g. the shared open-bus page) get
+	// a private decode; rebuilt whenever such a slot is remapped
+	std::array<std::unique_ptr<Page>, SLOT_COUNT> foreign_pages_;
+
+	std::array<const Page *, SLOT_COUNT> slot_pages_{};
+	std::array<const Byte *, SLOT_COUNT> slot_sources_{};
+};
+
+} // namespace nes
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * CodeDataLogger - Per-byte access log for PRG and CHR ROM (.cdl)
+ *
+ * One flag byte per ROM byte, in the layout FCEUX/Mesen read and write: the
+ * PRG log followed by the CHR log (empty for CHR RAM carts).
+ *
+ * PRG byte: bit 0 code (opcode or operand fetch), bit 1 data, bits 2-3 the
+ * CPU 8KB window it was last mapped at ($8000/$A000/$C000/$E000), bit 6
+ * DMC sample (PCM) fetch. CHR byte: bit 0 rendered, bit 1 read through
+ * PPUDATA. Bits 4-5 (indirect code/data) are not tracked.
+ *
+ * Recording is one OR per access into arrays sized at attach(); the bus and
+ * PPU only call in while the cartridge has the logger enabled.
+ */
+class CodeDataLogger {
+  public:
+	static constexpr Byte PRG_CODE = 0x01;
+	static constexpr Byte PRG_DATA = 0x02;
+	static constexpr Byte PRG_PCM = 0x40;
+	static constexpr Byte CHR_RENDERED = 0x01;
+	static constexpr Byte CHR_READ = 0x02;
+
+	struct Coverage {
+		std::size_t prg_size = 0;
+		std::size_t prg_logged = 0; // Any flag set
+		std::size_t prg_code = 0;
+		std::size_t prg_data = 0;
+		std::size_t prg_pcm = 0;
+		std::size_t chr_size = 0;
+		std::size_t chr_logged = 0;
+		std::size_t chr_rendered = 0;
+		std::size_t chr_read = 0;
+	};
+
+	/// Size the logs for a ROM and clear them. `prg`/`chr` are the memories
+	/// the mapper's PRG page table and CHR slots point into; pass an empty
+	/// `chr` for CHR RAM.
+	void attach(std::span<const Byte> prg, std::span<const Byte> chr);
+	void clear();
+
+	/// Log a PRG ROM access through an 8KB page-table entry
+	void log_prg(const Byte *page, Address address, Byte flags) noexcept {
+		const std::size_t offset =
+			static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(page) - prg_base_) + (address & 0x1FFF);
+		if (offset < prg_log_.size()) {
+			prg_log_[offset] |= static_cast<Byte>(flags | ((address >> 11) & 0x0C));
+		}
+	}
+	/// Log a CHR access through a 1KB CHR slot
+	void log_chr(const Byte *slot, Address address, Byte flags) noexcept {
+		const std::size_t offset =
+			static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(slot) - chr_base_) + (address & 0x03FF);
+		if (offset < chr_log_.size()) {
+			chr_log_[offset] |= flags;
+		}
+	}
+
+	[[nodiscard]] std::span<const Byte> prg_log() const noexcept {
+		return prg_log_;
+	}
+	[[nodiscard]] std::span<const Byte> chr_log() const noexcept {
+		return chr_log_;
+	}
+	[[nodiscard]] Coverage coverage() const noexcept;
+
+	/// Write the .cdl file (PRG log, then CHR log)
+	bool save(const std::filesystem::path &path) const;
+	/// Merge a .cdl file recorded earlier for the same ROM into the logs.
+	/// Fails (and leaves the logs alone) if its size does not match.
+	bool load(const std::filesystem::path &path);
+
+  private:
+	std::uintptr_t prg_base_ = 0;
+	std::uintptr_t chr_base_ = 0;
+	std::vector<Byte> prg_log_;
+	std::vector<Byte> chr_log_;
+};
+
+} // namespace nes
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cartridge/mappers/mapper.hpp"
+#include "cartridge/rom_image.hpp"
 #include "cartridge/rom_loader.hpp"
 #include <memory>
 
@@ -16,16 +17,21 @@ namespace nes {
 class MapperFactory {
   public:
 	/**
-	 * Create a mapper instance based on ROM data
+	 * Create a mapper instance for a ROM image
 	 *
-	 * @param rom_data The ROM data containing mapper ID and other info
+	 * @param image The ROM; the mapper reads its PRG/CHR ROM in place, so the
+	 *              image must outlive the mapper
 	 * @return Unique pointer to the created mapper, or nullptr if unsupported
 	 */
-	static std::unique_ptr<Mapper> create_mapper(const RomData &rom_data);
+	static std::unique_ptr<Mapper> create_mapper(const RomImage &image);
 
   private:
 	// Helper to determine mirroring mode from ROM data
 	static Mapper::Mirroring get_mirroring_mode(const RomData &rom_data);
+
+	// RAM the cart carries: exactly what a NES 2.0 header declares, else
+	// the board's usual PRG-RAM size and 8KB of CHR RAM
+	static Mapper::RamSizes get_ram_sizes(const RomData &rom_data, std::size_t ines_prg_ram);
 };
 
 } // namespace nes
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "apu/expansion_audio.hpp"
+#include "cartridge/chr_tile_cache.hpp"
 #include "core/types.hpp"
 #include <array>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -11,10 +16,16 @@ namespace nes {
 /**
  * Base class for all NES mappers
  * Mappers control how ROM/RAM is mapped into CPU and PPU address spaces
+ *
+ * PRG and CHR ROM are passed in as spans into the cartridge's shared
+ * RomImage, which outlives the mapper; only RAM is owned per instance.
  */
 class Mapper {
   public:
+	Mapper();
 	virtual ~Mapper() = default;
+	Mapper(const Mapper &) = delete;
+	Mapper &operator=(const Mapper &) = delete;
 
 	// CPU memory access (PRG ROM/RAM)
 	virtual Byte cpu_read(Address address) const = 0;
@@ -35,12 +46,27 @@ class Mapper {
 	enum class Mirroring { Horizontal, Vertical, SingleScreenLow, SingleScreenHigh, FourScreen };
 	virtual Mirroring get_mirroring() const noexcept = 0;
 
+	// On-cart RAM to allocate, in bytes. MapperFactory fills it from NES 2.0
+	// headers, or with each board's usual sizes for iNES 1 ROMs.
+	struct RamSizes {
+		std::size_t prg_ram = 0x2000; // $6000-$7FFF, volatile plus battery-backed; 0 = none
+		std::size_t chr_ram = 0x2000; // Used only when the cart has no CHR ROM
+	};
+
 	// PPU A12 line toggle notification (for MMC3 scanline counting)
 	virtual void ppu_a12_toggle() {
 		// Default implementation does nothing
 		// Override in mappers that need A12 monitoring (like MMC3)
 	}
 
+	// Minimum number of filtered A12 rising edges before this mapper can raise
+	// a new IRQ, or NO_A12_IRQ if none can occur without a CPU register write
+	// first. Lets the bus defer PPU work under catch-up synchronization.
+	static constexpr std::uint32_t NO_A12_IRQ = 0xFFFFFFFFu;
+	virtual std::uint32_t a12_edges_until_irq() const noexcept {
+		return NO_A12_IRQ;
+	}
+
 	// IRQ line status (for MMC3, MMC5, etc.). Non-virtual: the bus polls this
 	// every CPU cycle, so it must be a plain bool load, not a virtual call.
 	// Mappers with IRQ support set/clear the protected irq_pending_ member.
@@ -53,21 +79,127 @@ class Mapper {
 		irq_pending_ = false;
 	}
 
-	// Notify mapper of CPU cycles elapsed (for timing-sensitive behavior)
-	virtual void notify_cpu_cycle() {
-		// Default implementation does nothing
-		// Override in mappers that need cycle tracking (like MMC1)
+	// CPU write stamped with the bus's CPU cycle count, for mappers whose
+	// register writes depend on timing (MMC1 ignores writes on back-to-back
+	// cycles). The bus writes through here; the default drops the stamp.
+	virtual void cpu_write_at(Address address, Byte value, std::uint64_t cpu_cycle) {
+		(void)cpu_cycle;
+		cpu_write(address, value);
 	}
 
-	// Whether this mapper needs per-cycle notify_cpu_cycle() calls.
-	// Queried once at ROM load so the hot path can skip the call entirely.
-	virtual bool wants_cpu_cycle_notifications() const noexcept {
+	// CPU-cycle IRQ counter (VRC4/6/7, FME-7). Not clocked per cycle: the bus
+	// runs it forward in one span before each write to the mapper and when
+	// the deadline it posts from cpu_cycles_until_irq() comes due, which is
+	// exactly the cycle the IRQ rises on. cpu_cycles_until_irq() returns
+	// NO_CYCLE_IRQ while no IRQ can occur without a register write first.
+	// has_cpu_cycle_timer() is queried once at ROM load.
+	static constexpr std::uint32_t NO_CYCLE_IRQ = 0xFFFFFFFFu;
+	virtual bool has_cpu_cycle_timer() const noexcept {
 		return false;
 	}
+	virtual void run_cpu_cycle_timer(std::uint32_t /*cycles*/) noexcept {
+	}
+	virtual std::uint32_t cpu_cycles_until_irq() const noexcept {
+		return NO_CYCLE_IRQ;
+	}
 
-	// Save state serialization
-	virtual void serialize_state(std::vector<uint8_t> &buffer) const = 0;
-	virtual void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset) = 0;
+	// PPU frame notifications (MMC5). The PPU reports the start of every
+	// scanline (dot 0, with whether rendering is on) and, on rendering lines,
+	// the switch to sprite pattern fetches (dot 257) and back to background
+	// fetches (dot 320). While scanline_irq_armed() the PPU stops at every
+	// scanline start so an IRQ raised there is seen on time.
+	// wants_ppu_notifications() is queried once at ROM load.
+	virtual bool wants_ppu_notifications() const noexcept {
+		return false;
+	}
+	virtual void ppu_scanline_start(int /*scanline*/, bool /*rendering*/) {
+	}
+	virtual void ppu_fetch_phase(bool /*sprites*/, bool /*tall_sprites*/) {
+	}
+	virtual bool scanline_irq_armed() const noexcept {
+		return false;
+	}
+
+	// Sound chip on the cartridge, mixed in by the APU (nullptr for none)
+	virtual std::shared_ptr<ExpansionAudio> expansion_audio() const noexcept {
+		return nullptr;
+	}
+
+	// Pre-decoded CHR tiles for the current bank mapping. Mappers keep it in
+	// sync from update_bank_maps() and their CHR-RAM write path.
+	const ChrTileCache &chr_tile_cache() const noexcept {
+		return chr_cache_;
+	}
+
+	// 8KB PRG page table covering $8000-$FFFF. Mappers whose PRG ROM reads are
+	// plain lookups (no read side effects) opt in and keep prg_map_ current
+	// from update_bank_maps(); the bus then indexes it directly per opcode
+	// fetch instead of calling cpu_read(). Queried once at ROM load.
+	using PrgPageTable = std::array<const Byte *, 4>;
+	virtual bool has_prg_page_table() const noexcept {
+		return false;
+	}
+	const PrgPageTable &prg_page_table() const noexcept {
+		return prg_map_;
+	}
+	// PRG ROM the page table points into, so a table entry can be turned back
+	// into a ROM offset (debugger/profiler bank attribution)
+	virtual std::span<const Byte> prg_rom_data() const noexcept {
+		return {};
+	}
+
+	// 1KB nametable page table covering $2000-$2FFF (and its $3000-$3EFF
+	// mirror). Entries point into the console's 2KB CIRAM, given by
+	// attach_ciram(), or into cartridge VRAM: four-screen boards get 2KB of
+	// their own here, and mappers with more can point entries at theirs.
+	// Mappers re-map from wherever their mirroring changes; PPUMemory indexes
+	// the table directly on every nametable fetch. All null until attached.
+	using NametablePageTable = std::array<Byte *, 4>;
+	const NametablePageTable &nametable_pages() const noexcept {
+		return nametable_map_;
+	}
+	void attach_ciram(Byte *ciram) {
+		ciram_ = ciram;
+		remap_nametables();
+	}
+	// Cartridge-side nametable RAM (empty unless the board has some)
+	std::span<Byte> cartridge_vram() noexcept {
+		return cartridge_vram_;
+	}
+	std::span<const Byte> cartridge_vram() const noexcept {
+		return cartridge_vram_;
+	}
+
+	// Save state serialization: the tracked cartridge RAM (see track_ram()),
+	// then whatever serialize_registers() writes. Snapshots take the RAM
+	// page by page instead and only the registers through the stream.
+	void serialize_state(std::vector<uint8_t> &buffer) const;
+	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset);
+	virtual void serialize_registers(std::vector<uint8_t> &buffer) const = 0;
+	virtual void deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset) = 0;
+
+	// --- Cartridge RAM pages (snapshots and clones) ---
+	// Every PRG-RAM and CHR-RAM write stamps its 256-byte page with the
+	// current epoch. A snapshot keeps a RamPageMark of the mapper and epoch
+	// its RAM was last synced at, so capturing into it again or restoring
+	// from it copies only the pages written since; a mark from another
+	// mapper (or none) copies them all. The RAM is laid out as in
+	// serialize_state(), tracked_ram_size() bytes.
+	static constexpr std::size_t RAM_PAGE_SIZE = 256;
+	struct RamPageMark {
+		std::uint64_t mapper = 0; // ram_owner_ it was synced with, 0 = never
+		std::uint32_t epoch = 0;
+	};
+	std::size_t tracked_ram_size() const noexcept {
+		return ram_blocks_[0].size() + ram_blocks_[1].size();
+	}
+	void save_ram_pages(Byte *ram, RamPageMark &mark) const;
+	void load_ram_pages(const Byte *ram, const RamPageMark &mark);
+	// Make this mapper's RAM equal to source's (same ROM image), copying
+	// only pages either side has written since the last copy between the
+	// two. Advances source's epoch, so one source must not be copied from on
+	// two threads at once.
+	void copy_ram_from(const Mapper &source);
 
 	// --- Battery-backed PRG-RAM (persistent .sav files) ---
 	// Only cartridges with BOTH the iNES battery flag and PRG-RAM override these.
@@ -82,17 +214,102 @@ class Mapper {
 	virtual void load_battery_ram(std::span<const Byte> /*data*/) {
 		// Default: no battery RAM to restore
 	}
-	virtual bool is_battery_ram_dirty() const noexcept {
-		return false;
+	// Battery RAM is the PRG block given to track_ram(), so what the game
+	// changed since the last flush comes from the same page stamps as
+	// snapshots: the pages written since clear_battery_ram_dirty() (or a
+	// load), as byte ranges into get_battery_ram(), adjacent pages merged
+	struct RamRange {
+		std::size_t offset = 0;
+		std::size_t size = 0;
+	};
+	bool is_battery_ram_dirty() const noexcept;
+	std::vector<RamRange> battery_ram_dirty_ranges() const;
+	void clear_battery_ram_dirty() noexcept {
+		battery_epoch_ = ram_epoch_++;
 	}
-	virtual void clear_battery_ram_dirty() noexcept {
-		// Default: nothing to clear
+	// Whether battery RAM has been written since mark was taken (a mark of
+	// another mapper, or none: yes), then move mark to now; for telling when
+	// a game has stopped writing
+	bool battery_ram_written_since(RamPageMark &mark) const noexcept;
+	// Make backing (get_battery_ram().size() bytes, a MappedFile of the .sav)
+	// the battery RAM itself, taking its contents, so every game write lands
+	// straight in it; an empty span copies the RAM back into the mapper's own
+	// memory and goes back to that. False if this mapper keeps its own.
+	virtual bool map_battery_ram(std::span<Byte> /*backing*/) {
+		return false;
 	}
 
   protected:
+	// Cartridge RAM the base serializes and dirty-tracks, in state order
+	enum class RamKind : std::uint8_t { Prg, Chr };
+	// Register a RAM block once it has its final size (constructor)
+	void track_ram(RamKind kind, std::span<Byte> ram);
+	// Stamp the page of a write at offset into that block
+	void ram_written(RamKind kind, std::size_t offset) noexcept {
+		ram_pages_[ram_first_page_[static_cast<std::size_t>(kind)] + offset / RAM_PAGE_SIZE] = ram_epoch_;
+	}
+	// Stamp every page, after the RAM changed wholesale (battery load, reset)
+	void ram_rewritten() noexcept;
+	// map_battery_ram() for a mapper whose PRG block is ram: a view of
+	// storage, or of backing once mapped (same size as storage)
+	bool rebind_battery_ram(std::span<Byte> &ram, std::vector<Byte> &storage, std::span<Byte> backing);
+
 	// IRQ pending flag (read by the non-virtual is_irq_pending() above).
-	// Only IRQ-capable mappers (MMC3) ever set this.
-	bool irq_pending_ = false;
+	// Only IRQ-capable mappers (MMC3, MMC5, VRC4/6/7, FME-7) ever set this.
+	// Mutable: reading a status register acknowledges it on MMC5 ($5204).
+	mutable bool irq_pending_ = false;
+
+	// Decoded view of CHR memory (see chr_tile_cache() above)
+	ChrTileCache chr_cache_;
+
+	// PRG page table (see prg_page_table() above)
+	PrgPageTable prg_map_{};
+
+	// Nametable page table (see nametable_pages() above)
+	NametablePageTable nametable_map_{};
+	Byte *ciram_ = nullptr;
+	std::vector<Byte> cartridge_vram_;
+
+	// Rebuild the nametable table once CIRAM is attached. Mappers that map
+	// nametables beyond the fixed mirroring modes (MMC5) override this.
+	virtual void remap_nametables() {
+		map_nametables(get_mirroring());
+	}
+
+	// Point the nametable table at the CIRAM pages (or cartridge VRAM) for a
+	// mirroring mode; a no-op until CIRAM is attached
+	void map_nametables(Mirroring mirroring) {
+		if (!ciram_) {
+			return;
+		}
+		Byte *const low = ciram_;
+		Byte *const high = ciram_ + 0x400;
+		switch (mirroring) {
+		case Mirroring::Horizontal:
+			nametable_map_ = {low, low, high, high};
+			break;
+		case Mirroring::Vertical:
+			nametable_map_ = {low, high, low, high};
+			break;
+		case Mirroring::SingleScreenLow:
+			nametable_map_ = {low, low, low, low};
+			break;
+		case Mirroring::SingleScreenHigh:
+			nametable_map_ = {high, high, high, high};
+			break;
+		case Mirroring::FourScreen:
+			// CIRAM holds $2000-$27FF and the board's own 2KB $2800-$2FFF
+			cartridge_vram_.resize(0x800, 0x00);
+			nametable_map_ = {low, high, cartridge_vram_.data(), cartridge_vram_.data() + 0x400};
+			break;
+		}
+	}
+
+	// Mask for $6000-$7FFF offsets into PRG-RAM: chips under 8KB mirror
+	// across the window, larger ones show 8KB at a time
+	static constexpr std::size_t prg_ram_window_mask(std::size_t size) noexcept {
+		return size == 0 ? 0 : (size >= 0x2000 ? 0x2000 : std::bit_floor(size)) - 1;
+	}
 
 	// Helper to check if address is in PRG ROM range
 	static constexpr bool is_prg_rom_address(Address address) noexcept {
@@ -112,6 +329,21 @@ class Mapper {
 		page.fill(0xFF);
 		return page;
 	}();
+
+  private:
+	// RAM page tracking (see RamPageMark above)
+	std::array<std::span<Byte>, 2> ram_blocks_{}; // By RamKind
+	std::array<std::size_t, 2> ram_first_page_{};
+	std::vector<std::uint32_t> ram_pages_;	// Epoch of each page's last write
+	mutable std::uint32_t ram_epoch_ = 1;	// Advanced by every sync
+	const std::uint64_t ram_owner_;			// Unique across mapper instances
+	std::uint64_t copied_from_ = 0;			// copy_ram_from(): source's ram_owner_,
+	std::uint32_t copied_source_epoch_ = 0; // its epoch then,
+	std::uint32_t copied_epoch_ = 0;		// and ours
+	std::uint32_t battery_epoch_ = 0;		// Of the last clear_battery_ram_dirty()
+
+	// The battery pages stamped after epoch
+	template <typename Visit> void for_each_battery_page_after(std::uint32_t epoch, Visit &&visit) const;
 };
 
 } // namespace nes
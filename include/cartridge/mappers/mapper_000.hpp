@@ -2,6 +2,7 @@
 
 #include "cartridge/mappers/mapper.hpp"
 #include <array>
+#include <span>
 #include <vector>
 
 namespace nes {
@@ -17,7 +18,7 @@ namespace nes {
  */
 class Mapper000 final : public Mapper {
   public:
-	Mapper000(std::vector<Byte> prg_rom, std::vector<Byte> chr_rom, Mirroring mirroring);
+	Mapper000(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring);
 
 	// CPU memory access
 	Byte cpu_read(Address address) const override;
@@ -40,19 +41,27 @@ class Mapper000 final : public Mapper {
 		return mirroring_;
 	}
 
+	// PRG ROM reads are pure lookups into prg_map_
+	bool has_prg_page_table() const noexcept override {
+		return true;
+	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
+
 	// Save state serialization
-	void serialize_state(std::vector<uint8_t> &buffer) const override;
-	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset) override;
+	void serialize_registers(std::vector<uint8_t> &buffer) const override;
+	void deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset) override;
 
   private:
-	std::vector<Byte> prg_rom_; // Program ROM (16KB or 32KB)
-	std::vector<Byte> chr_rom_; // Character ROM (8KB)
+	std::span<const Byte> prg_rom_; // Program ROM (16KB or 32KB)
+	std::span<const Byte> chr_rom_; // Character ROM (8KB)
 	Mirroring mirroring_;		// Nametable mirroring mode
 
-	// Cached bank pointers: PRG in 8KB slots ($8000-$FFFF), CHR in 1KB slots
-	// ($0000-$1FFF). Rebuilt only when banking state changes; reads become a
-	// single pointer lookup with no per-byte offset math or bounds checks.
-	std::array<const Byte *, 4> prg_map_{};
+	// Cached bank pointers: CHR in 1KB slots ($0000-$1FFF), PRG in the base
+	// prg_map_ (8KB slots, $8000-$FFFF). Rebuilt only when banking state
+	// changes; reads become a single pointer lookup with no per-byte offset
+	// math or bounds checks.
 	std::array<const Byte *, 8> chr_map_{};
 	void update_bank_maps();
 
@@ -24,12 +24,13 @@ namespace nes {
  */
 class Mapper001 final : public Mapper {
   public:
-	Mapper001(std::vector<Byte> prg_rom, std::vector<Byte> chr_mem, Mirroring mirroring, bool has_prg_ram = true,
-			  bool chr_is_ram = false, bool battery_backed = false);
+	Mapper001(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring,
+			  bool has_prg_ram = true, bool chr_is_ram = false, bool battery_backed = false, RamSizes ram = {});
 
 	// CPU memory access
 	Byte cpu_read(Address address) const override;
 	void cpu_write(Address address, Byte value) override;
+	void cpu_write_at(Address address, Byte value, std::uint64_t cpu_cycle) override;
 
 	// PPU memory access
 	Byte ppu_read(Address address) const override;
@@ -46,17 +47,17 @@ class Mapper001 final : public Mapper {
 	void reset() override;
 	Mirroring get_mirroring() const noexcept override;
 
-	// Cycle tracking for consecutive-write filter
-	void notify_cpu_cycle() override {
-		++cpu_cycle_counter_;
-	}
-	bool wants_cpu_cycle_notifications() const noexcept override {
+	// PRG ROM reads are pure lookups into prg_map_
+	bool has_prg_page_table() const noexcept override {
 		return true;
 	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
 
 	// Save state serialization
-	void serialize_state(std::vector<uint8_t> &buffer) const override;
-	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset) override;
+	void serialize_registers(std::vector<uint8_t> &buffer) const override;
+	void deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset) override;
 
 	// Battery-backed PRG-RAM persistence (.sav). Active only when the cart has
 	// PRG-RAM and the iNES battery flag is set.
@@ -71,24 +72,24 @@ class Mapper001 final : public Mapper {
 		for (std::size_t i = 0; i < n; ++i) {
 			prg_ram_[i] = data[i];
 		}
-		prg_ram_dirty_ = false;
-	}
-	bool is_battery_ram_dirty() const noexcept override {
-		return prg_ram_dirty_;
+		ram_rewritten();
+		clear_battery_ram_dirty();
 	}
-	void clear_battery_ram_dirty() noexcept override {
-		prg_ram_dirty_ = false;
+	bool map_battery_ram(std::span<Byte> backing) override {
+		return rebind_battery_ram(prg_ram_, prg_ram_storage_, backing);
 	}
 
   private:
-	std::vector<Byte> prg_rom_;	  // Program ROM (up to 512KB)
-	std::vector<Byte> prg_ram_;	  // Program RAM (8KB at $6000-$7FFF)
-	std::vector<Byte> chr_mem_;	  // Character ROM or RAM (up to 128KB)
+	std::span<const Byte> prg_rom_; // Program ROM (up to 512KB)
+	std::span<Byte> prg_ram_;		// Program RAM (8-32KB, 8KB at a time at $6000-$7FFF)
+	std::vector<Byte> prg_ram_storage_; // Behind prg_ram_ unless map_battery_ram() gave it a file
+	std::size_t prg_ram_mask_ = 0;	// prg_ram_window_mask() of its size
+	std::vector<Byte> chr_ram_;		// Character RAM (CHR-RAM carts only)
+	std::span<const Byte> chr_mem_; // CHR ROM (up to 128KB) or chr_ram_
 	Mirroring initial_mirroring_; // Initial mirroring from iNES header
 	bool has_prg_ram_;			  // Does cartridge have PRG RAM?
 	bool chr_is_ram_;			  // Is CHR memory writable RAM?
 	bool battery_backed_;		  // iNES battery flag: persist PRG RAM to .sav
-	bool prg_ram_dirty_ = false;  // PRG RAM written since last flush/restore
 
 	// MMC1 Registers
 	Byte shift_register_; // 5-bit shift register for serial writes
@@ -104,8 +105,9 @@ class Mapper001 final : public Mapper {
 	// Consecutive-write filter: real MMC1 ignores writes on consecutive CPU cycles.
 	// RMW instructions (INC, DEC, ASL, etc.) write the old value then the new value
 	// on back-to-back cycles; only the first (old value) should be processed.
-	uint64_t cpu_cycle_counter_; // Running CPU cycle count
-	uint64_t last_write_cycle_;	 // Cycle of last $8000+ write
+	// Compared against the bus's cycle stamp on each write.
+	static constexpr uint64_t NO_WRITE_CYCLE = UINT64_MAX;
+	uint64_t last_write_cycle_; // CPU cycle of the last timed $8000+ write
 
 	// Helper functions
 	void write_shift_register(Address address, Byte value);
@@ -114,9 +116,19 @@ class Mapper001 final : public Mapper {
 	std::size_t get_prg_bank_offset(Address address) const;
 	std::size_t get_chr_bank_offset(Address address) const;
 
-	// Cached bank pointers: PRG in 8KB slots ($8000-$FFFF), CHR in 1KB slots
-	// ($0000-$1FFF). Rebuilt only when banking registers change.
-	std::array<const Byte *, 4> prg_map_{};
+	// SOROM (16KB) picks the 8KB PRG-RAM bank with CHR bank 0 bit 3, SXROM
+	// (32KB) with bits 2-3; smaller RAM mirrors across the window
+	[[nodiscard]] std::size_t prg_ram_offset(Address address) const noexcept {
+		const std::size_t window = (address - 0x6000) & prg_ram_mask_;
+		if (prg_ram_.size() <= 0x2000) {
+			return window;
+		}
+		const std::size_t bank = prg_ram_.size() >= 0x8000 ? (chr_bank_0_ >> 2) & 0x03 : (chr_bank_0_ >> 3) & 0x01;
+		return (bank % (prg_ram_.size() / 0x2000)) * 0x2000 + window;
+	}
+
+	// Cached bank pointers: CHR in 1KB slots ($0000-$1FFF), PRG in the base
+	// prg_map_. Rebuilt only when banking registers change.
 	std::array<const Byte *, 8> chr_map_{};
 	void update_bank_maps();
 
@@ -2,6 +2,7 @@
 
 #include "cartridge/mappers/mapper.hpp"
 #include <array>
+#include <span>
 #include <vector>
 
 namespace nes {
@@ -20,7 +21,7 @@ namespace nes {
  */
 class Mapper003 final : public Mapper {
   public:
-	Mapper003(std::vector<Byte> prg_rom, std::vector<Byte> chr_rom, Mirroring mirroring);
+	Mapper003(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring);
 
 	// CPU memory access
 	Byte cpu_read(Address address) const override;
@@ -43,20 +44,27 @@ class Mapper003 final : public Mapper {
 		return mirroring_;
 	}
 
+	// PRG ROM reads are pure lookups into prg_map_
+	bool has_prg_page_table() const noexcept override {
+		return true;
+	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
+
 	// Save state serialization
-	void serialize_state(std::vector<uint8_t> &buffer) const override;
-	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset) override;
+	void serialize_registers(std::vector<uint8_t> &buffer) const override;
+	void deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset) override;
 
   private:
-	std::vector<Byte> prg_rom_;		 // Program ROM (16KB or 32KB)
-	std::vector<Byte> chr_rom_;		 // Character ROM (multiple 8KB banks)
+	std::span<const Byte> prg_rom_;	 // Program ROM (16KB or 32KB)
+	std::span<const Byte> chr_rom_;	 // Character ROM (multiple 8KB banks)
 	Mirroring mirroring_;			 // Nametable mirroring mode
 	std::uint8_t selected_chr_bank_; // Currently selected CHR bank
 	std::uint8_t num_chr_banks_;	 // Total number of 8KB CHR banks
 
-	// Cached bank pointers: PRG in 8KB slots ($8000-$FFFF), CHR in 1KB slots.
+	// Cached bank pointers: CHR in 1KB slots, PRG in the base prg_map_.
 	// Rebuilt only on bank select writes.
-	std::array<const Byte *, 4> prg_map_{};
 	std::array<const Byte *, 8> chr_map_{};
 	void update_bank_maps();
 
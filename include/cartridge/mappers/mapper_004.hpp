@@ -49,8 +49,8 @@ namespace nes {
  */
 class Mapper004 final : public Mapper {
   public:
-	Mapper004(std::vector<Byte> prg_rom, std::vector<Byte> chr_mem, Mirroring mirroring, bool has_prg_ram = true,
-			  bool chr_is_ram = false, bool battery_backed = false);
+	Mapper004(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring,
+			  bool has_prg_ram = true, bool chr_is_ram = false, bool battery_backed = false, RamSizes ram = {});
 
 	// CPU memory access
 	Byte cpu_read(Address address) const override;
@@ -71,15 +71,24 @@ class Mapper004 final : public Mapper {
 	void reset() override;
 	Mirroring get_mirroring() const noexcept override;
 
+	// PRG ROM reads are pure lookups into prg_map_
+	bool has_prg_page_table() const noexcept override {
+		return true;
+	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
+
 	// PPU A12 line monitoring for IRQ timing
 	void ppu_a12_toggle() override;
+	std::uint32_t a12_edges_until_irq() const noexcept override;
 
 	// IRQ support: uses the non-virtual is_irq_pending()/clear_irq() from the
 	// Mapper base, which read/clear the shared irq_pending_ member.
 
 	// Save state support
-	void serialize_state(std::vector<Byte> &buffer) const override;
-	void deserialize_state(const std::vector<Byte> &buffer, size_t &offset) override;
+	void serialize_registers(std::vector<Byte> &buffer) const override;
+	void deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) override;
 
 	// Battery-backed PRG-RAM persistence (.sav). Active only when the cart has
 	// PRG-RAM and the iNES battery flag is set.
@@ -94,24 +103,24 @@ class Mapper004 final : public Mapper {
 		for (std::size_t i = 0; i < n; ++i) {
 			prg_ram_[i] = data[i];
 		}
-		prg_ram_dirty_ = false;
-	}
-	bool is_battery_ram_dirty() const noexcept override {
-		return prg_ram_dirty_;
+		ram_rewritten();
+		clear_battery_ram_dirty();
 	}
-	void clear_battery_ram_dirty() noexcept override {
-		prg_ram_dirty_ = false;
+	bool map_battery_ram(std::span<Byte> backing) override {
+		return rebind_battery_ram(prg_ram_, prg_ram_storage_, backing);
 	}
 
   private:
-	std::vector<Byte> prg_rom_;	  // Program ROM (up to 512KB)
-	std::vector<Byte> prg_ram_;	  // Program RAM (8KB at $6000-$7FFF)
-	std::vector<Byte> chr_mem_;	  // Character ROM or RAM (up to 256KB)
+	std::span<const Byte> prg_rom_; // Program ROM (up to 512KB)
+	std::span<Byte> prg_ram_;		// Program RAM (8KB at $6000-$7FFF)
+	std::vector<Byte> prg_ram_storage_; // Behind prg_ram_ unless map_battery_ram() gave it a file
+	std::size_t prg_ram_mask_ = 0;	// prg_ram_window_mask() of its size
+	std::vector<Byte> chr_ram_;		// Character RAM (CHR-RAM carts only)
+	std::span<const Byte> chr_mem_; // CHR ROM (up to 256KB) or chr_ram_
 	Mirroring initial_mirroring_; // Initial mirroring from iNES header
 	bool has_prg_ram_;			  // Does cartridge have PRG RAM?
 	bool chr_is_ram_;			  // Is CHR memory writable RAM?
 	bool battery_backed_;		  // iNES battery flag: persist PRG RAM to .sav
-	bool prg_ram_dirty_ = false;  // PRG RAM written since last flush/restore
 
 	// MMC3 Registers
 	Byte bank_select_;			// $8000: Bank select and mode control
@@ -130,9 +139,8 @@ class Mapper004 final : public Mapper {
 	std::size_t get_prg_bank_offset(Address address) const;
 	std::size_t get_chr_bank_offset(Address address) const;
 
-	// Cached bank pointers: PRG in 8KB slots ($8000-$FFFF), CHR in 1KB slots
-	// ($0000-$1FFF). Rebuilt only when bank select/data registers change.
-	std::array<const Byte *, 4> prg_map_{};
+	// Cached bank pointers: CHR in 1KB slots ($0000-$1FFF), PRG in the base
+	// prg_map_. Rebuilt only when bank select/data registers change.
 	std::array<const Byte *, 8> chr_map_{};
 	void update_bank_maps();
 
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "apu/mmc5_audio.hpp"
+#include "cartridge/mappers/mapper.hpp"
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * Mapper 5 (MMC5) - Nintendo's largest mapper
+ *
+ * PRG ($5100 mode, $5113-$5117 banks): 8KB RAM bank at $6000 and, by mode,
+ *   one 32KB, two 16KB, 16KB + 2 x 8KB or four 8KB windows at $8000-$FFFF.
+ *   Bank bit 7 picks ROM (1) or RAM (0) for $8000-$DFFF; $E000 is always
+ *   ROM. RAM writes need $5102 = 2 and $5103 = 1.
+ * CHR ($5101 mode, $5120-$512B banks, $5130 upper bits): 8KB, 4KB, 2KB or
+ *   1KB banks from two register sets. With 8x16 sprites, sprite fetches use
+ *   set A ($5120-$5127) and background fetches set B ($5128-$512B);
+ *   otherwise the set written last applies to everything.
+ * Nametables ($5105): each quarter from CIRAM page 0/1, ExRAM or the fill
+ *   tile/attribute ($5106/$5107).
+ * ExRAM ($5C00-$5FFF, mode $5104): nametable (0/1), CPU RAM (2) or
+ *   read-only (3).
+ * IRQ ($5203 compare, $5204 enable / status): the scanline counter counts
+ *   rendered lines from the PPU's frame notifications; reading $5204
+ *   returns pending (bit 7) and in-frame (bit 6) and acknowledges.
+ * Multiplier ($5205/$5206): unsigned 8 x 8 product, read back low/high.
+ * Sound ($5000-$5015): see Mmc5Audio.
+ *
+ * Not emulated: vertical split mode ($5200-$5202) and extended attributes
+ * (ExRAM mode 1 draws as mode 0).
+ *
+ * Used by: Castlevania III, Just Breed, Uncharted Waters, Metal Slader Glory
+ */
+class Mapper005 final : public Mapper {
+  public:
+	Mapper005(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, bool battery_backed = false,
+			  RamSizes ram = {PRG_RAM_SIZE, 0x2000});
+
+	// CPU memory access
+	Byte cpu_read(Address address) const override;
+	void cpu_write(Address address, Byte value) override;
+
+	// PPU memory access
+	Byte ppu_read(Address address) const override;
+	void ppu_write(Address address, Byte value) override;
+
+	// Mapper info
+	std::uint8_t get_mapper_id() const noexcept override {
+		return 5;
+	}
+	const char *get_name() const noexcept override {
+		return "MMC5";
+	}
+
+	void reset() override;
+	Mirroring get_mirroring() const noexcept override;
+
+	// $8000-$FFFF reads are pure lookups into prg_map_ (ROM or PRG-RAM pages)
+	bool has_prg_page_table() const noexcept override {
+		return true;
+	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
+
+	// Scanline counter and 8x16 CHR set switching follow the PPU
+	bool wants_ppu_notifications() const noexcept override {
+		return true;
+	}
+	void ppu_scanline_start(int scanline, bool rendering) override;
+	void ppu_fetch_phase(bool sprites, bool tall_sprites) override;
+	bool scanline_irq_armed() const noexcept override {
+		return irq_enabled_ && irq_compare_ != 0 && !irq_status_;
+	}
+
+	std::shared_ptr<ExpansionAudio> expansion_audio() const noexcept override {
+		return audio_;
+	}
+
+	// Save state support
+	void serialize_registers(std::vector<Byte> &buffer) const override;
+	void deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) override;
+
+	// Battery-backed PRG-RAM persistence (.sav)
+	bool has_battery_ram() const noexcept override {
+		return battery_backed_;
+	}
+	std::span<const Byte> get_battery_ram() const noexcept override {
+		return {prg_ram_.data(), prg_ram_.size()};
+	}
+	void load_battery_ram(std::span<const Byte> data) override {
+		const std::size_t n = data.size() < prg_ram_.size() ? data.size() : prg_ram_.size();
+		for (std::size_t i = 0; i < n; ++i) {
+			prg_ram_[i] = data[i];
+		}
+		ram_rewritten();
+		clear_battery_ram_dirty();
+	}
+
+  protected:
+	void remap_nametables() override;
+
+  private:
+	static constexpr std::size_t PRG_RAM_SIZE = 0x10000; // 64KB, the most any board carries
+	static constexpr std::size_t MAX_PRG_RAM_BANKS = PRG_RAM_SIZE / 0x2000;
+
+	std::span<const Byte> prg_rom_; // Program ROM (up to 1MB)
+	std::vector<Byte> prg_ram_;		// PRG-RAM in 8KB banks (up to 64KB), banked at $6000-$DFFF
+	std::vector<Byte> chr_ram_;		// Character RAM (CHR-RAM carts only)
+	std::span<const Byte> chr_mem_; // CHR ROM or chr_ram_
+	bool chr_is_ram_ = false;
+	bool battery_backed_;
+	std::shared_ptr<Mmc5Audio> audio_;
+
+	std::array<Byte, 0x400> exram_{};
+	// Nametable pages for fill mode and for ExRAM while it isn't a nametable.
+	// PPU writes land in them harmlessly and are undone on the next remap.
+	std::array<Byte, 0x400> fill_page_{};
+	std::array<Byte, 0x400> blank_page_{};
+
+	// Registers
+	Byte prg_mode_ = 3;						   // $5100
+	Byte chr_mode_ = 0;						   // $5101
+	std::array<Byte, 2> prg_ram_protect_{};	   // $5102, $5103
+	Byte exram_mode_ = 0;					   // $5104
+	Byte nametable_mapping_ = 0;			   // $5105
+	Byte fill_tile_ = 0;					   // $5106
+	Byte fill_attribute_ = 0;				   // $5107
+	std::array<Byte, 5> prg_banks_{};		   // $5113-$5117
+	std::array<std::uint16_t, 12> chr_banks_{}; // $5120-$512B, with $5130 bits 8-9
+	Byte chr_upper_ = 0;					   // $5130
+	bool last_set_b_ = false;				   // Last CHR write was to $5128-$512B
+	Byte irq_compare_ = 0;					   // $5203
+	bool irq_enabled_ = false;				   // $5204 bit 7
+	Byte multiplicand_ = 0xFF;				   // $5205
+	Byte multiplier_ = 0xFF;				   // $5206
+
+	// Frame tracking. irq_status_ is cleared by $5204 reads, hence mutable.
+	bool in_frame_ = false;
+	Byte scanline_counter_ = 0;
+	mutable bool irq_status_ = false;
+	bool sprite_fetches_ = false; // PPU is in the sprite pattern fetch phase
+	bool tall_sprites_ = false;	  // As of the last fetch phase notification
+
+	std::array<const Byte *, 8> chr_map_{};
+	std::array<Byte *, 4> prg_ram_pages_{}; // $8000-$FFFF slots that map PRG-RAM, else null
+	Byte *low_ram_page_ = nullptr;			// $6000-$7FFF
+	void update_prg_map();
+	void update_chr_map();
+	void rebuild_fill_page();
+
+	[[nodiscard]] bool prg_ram_writable() const noexcept {
+		return prg_ram_protect_[0] == 0x02 && prg_ram_protect_[1] == 0x01;
+	}
+	[[nodiscard]] bool use_set_b() const noexcept {
+		return (tall_sprites_ && in_frame_) ? !sprite_fetches_ : last_set_b_;
+	}
+	[[nodiscard]] std::size_t chr_offset(Address address) const noexcept;
+};
+
+} // namespace nes
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "cartridge/mappers/mapper.hpp"
+#include "cartridge/mappers/vrc_irq.hpp"
+#include <array>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * Mappers 21, 22, 23, 25 (Konami VRC2 / VRC4)
+ *
+ * One chip family wired four ways: the boards connect different CPU address
+ * lines to the chip's two register-select pins, so each iNES number only
+ * changes how an address is decoded. Registers below are after decoding:
+ *
+ *   $8000:       8KB PRG bank at $8000 (or $C000 in swapped mode)
+ *   $9000-$9001: mirroring (VRC4: 0 vertical, 1 horizontal, 2/3 one-screen;
+ *                VRC2: bit 0 only)
+ *   $9002-$9003: VRC4 PRG mode (bit 1: swap $8000/$C000)
+ *   $A000:       8KB PRG bank at $A000
+ *   $B000-$E003: 1KB CHR banks 0-7, written a nibble at a time (even
+ *                register low nibble, odd register high bits)
+ *   $F000-$F003: VRC4 IRQ latch low/high nibble, control, acknowledge
+ *
+ * $E000-$FFFF is fixed to the last 8KB bank. Mapper 22 (VRC2a) drops the
+ * low bit of each CHR bank. The IRQ counter is a CPU-cycle timer (see
+ * VrcIrqCounter), run by the bus in spans rather than per cycle.
+ *
+ * Used by: Gradius II, Ganbare Goemon 2, Akumajou Special, Contra (J)
+ */
+class Mapper021 final : public Mapper {
+  public:
+	Mapper021(std::uint16_t mapper_id, std::span<const Byte> prg_rom, std::span<const Byte> chr_rom,
+			  Mirroring mirroring, bool battery_backed = false, RamSizes ram = {});
+
+	// CPU memory access
+	Byte cpu_read(Address address) const override;
+	void cpu_write(Address address, Byte value) override;
+
+	// PPU memory access
+	Byte ppu_read(Address address) const override;
+	void ppu_write(Address address, Byte value) override;
+
+	// Mapper info
+	std::uint8_t get_mapper_id() const noexcept override {
+		return static_cast<std::uint8_t>(mapper_id_);
+	}
+	const char *get_name() const noexcept override {
+		return is_vrc2() ? "VRC2" : "VRC4";
+	}
+
+	void reset() override;
+	Mirroring get_mirroring() const noexcept override;
+
+	// PRG ROM reads are pure lookups into prg_map_
+	bool has_prg_page_table() const noexcept override {
+		return true;
+	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
+
+	// VRC4 IRQ counter
+	bool has_cpu_cycle_timer() const noexcept override {
+		return !is_vrc2();
+	}
+	void run_cpu_cycle_timer(std::uint32_t cycles) noexcept override;
+	std::uint32_t cpu_cycles_until_irq() const noexcept override;
+
+	// Save state support
+	void serialize_registers(std::vector<Byte> &buffer) const override;
+	void deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) override;
+
+	// Battery-backed PRG-RAM persistence (.sav)
+	bool has_battery_ram() const noexcept override {
+		return battery_backed_;
+	}
+	std::span<const Byte> get_battery_ram() const noexcept override {
+		return {prg_ram_.data(), prg_ram_.size()};
+	}
+	void load_battery_ram(std::span<const Byte> data) override {
+		const std::size_t n = data.size() < prg_ram_.size() ? data.size() : prg_ram_.size();
+		for (std::size_t i = 0; i < n; ++i) {
+			prg_ram_[i] = data[i];
+		}
+		ram_rewritten();
+		clear_battery_ram_dirty();
+	}
+
+  private:
+	std::uint16_t mapper_id_;		// 21, 22, 23 or 25: selects the address decoding
+	std::span<const Byte> prg_rom_; // Program ROM (up to 256KB)
+	std::vector<Byte> prg_ram_;		// Program RAM (8KB at $6000-$7FFF)
+	std::size_t prg_ram_mask_ = 0;	// prg_ram_window_mask() of its size
+	std::vector<Byte> chr_ram_;		// Character RAM (CHR-RAM carts only)
+	std::span<const Byte> chr_mem_; // CHR ROM or chr_ram_
+	Mirroring initial_mirroring_;
+	bool chr_is_ram_ = false;
+	bool battery_backed_;
+
+	// Registers
+	std::array<Byte, 2> prg_banks_{};		   // $8000, $A000
+	bool prg_swap_ = false;					   // $9002 bit 1
+	Byte mirroring_ = 0;					   // $9000
+	std::array<std::uint16_t, 8> chr_banks_{}; // $B000-$E003, 9 bits
+	VrcIrqCounter irq_;
+
+	std::array<const Byte *, 8> chr_map_{};
+	void update_bank_maps();
+
+	[[nodiscard]] bool is_vrc2() const noexcept {
+		return mapper_id_ == 22;
+	}
+	// Register number (0-3) within a $1000 block from the board's wiring
+	[[nodiscard]] Byte decode_register(Address address) const noexcept;
+	[[nodiscard]] std::size_t chr_offset(Address address) const noexcept;
+};
+
+} // namespace nes
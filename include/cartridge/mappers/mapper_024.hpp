@@ -0,0 +1,122 @@
+#pragma once
+
+#include "apu/vrc6_audio.hpp"
+#include "cartridge/mappers/mapper.hpp"
+#include "cartridge/mappers/vrc_irq.hpp"
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * Mappers 24, 26 (Konami VRC6a / VRC6b)
+ *
+ * Mapper 26 swaps the A0 and A1 register-select lines; registers below are
+ * as mapper 24 sees them:
+ *
+ *   $8000-$8003: 16KB PRG bank at $8000
+ *   $9000-$B002: VRC6 sound (see Vrc6Audio)
+ *   $B003:       PPU banking style: bits 2-3 mirroring (vertical,
+ *                horizontal, one-screen low/high), bit 7 PRG-RAM enable
+ *   $C000-$C003: 8KB PRG bank at $C000
+ *   $D000-$E003: 1KB CHR banks 0-7
+ *   $F000-$F002: IRQ latch, control, acknowledge (see VrcIrqCounter)
+ *
+ * $E000-$FFFF is fixed to the last 8KB bank. Only the banking style every
+ * VRC6 game uses (style 0: eight 1KB CHR banks, nametables from CIRAM) is
+ * emulated.
+ *
+ * Used by: Akumajou Densetsu, Esper Dream 2, Madara
+ */
+class Mapper024 final : public Mapper {
+  public:
+	Mapper024(std::uint16_t mapper_id, std::span<const Byte> prg_rom, std::span<const Byte> chr_rom,
+			  Mirroring mirroring, bool battery_backed = false, RamSizes ram = {});
+
+	// CPU memory access
+	Byte cpu_read(Address address) const override;
+	void cpu_write(Address address, Byte value) override;
+
+	// PPU memory access
+	Byte ppu_read(Address address) const override;
+	void ppu_write(Address address, Byte value) override;
+
+	// Mapper info
+	std::uint8_t get_mapper_id() const noexcept override {
+		return static_cast<std::uint8_t>(mapper_id_);
+	}
+	const char *get_name() const noexcept override {
+		return "VRC6";
+	}
+
+	void reset() override;
+	Mirroring get_mirroring() const noexcept override;
+
+	// PRG ROM reads are pure lookups into prg_map_
+	bool has_prg_page_table() const noexcept override {
+		return true;
+	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
+
+	// IRQ counter
+	bool has_cpu_cycle_timer() const noexcept override {
+		return true;
+	}
+	void run_cpu_cycle_timer(std::uint32_t cycles) noexcept override;
+	std::uint32_t cpu_cycles_until_irq() const noexcept override;
+
+	std::shared_ptr<ExpansionAudio> expansion_audio() const noexcept override {
+		return audio_;
+	}
+
+	// Save state support
+	void serialize_registers(std::vector<Byte> &buffer) const override;
+	void deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) override;
+
+	// Battery-backed PRG-RAM persistence (.sav)
+	bool has_battery_ram() const noexcept override {
+		return battery_backed_;
+	}
+	std::span<const Byte> get_battery_ram() const noexcept override {
+		return {prg_ram_.data(), prg_ram_.size()};
+	}
+	void load_battery_ram(std::span<const Byte> data) override {
+		const std::size_t n = data.size() < prg_ram_.size() ? data.size() : prg_ram_.size();
+		for (std::size_t i = 0; i < n; ++i) {
+			prg_ram_[i] = data[i];
+		}
+		ram_rewritten();
+		clear_battery_ram_dirty();
+	}
+
+  private:
+	std::uint16_t mapper_id_;		// 24 or 26: selects the address decoding
+	std::span<const Byte> prg_rom_; // Program ROM (up to 256KB)
+	std::vector<Byte> prg_ram_;		// Program RAM (8KB at $6000-$7FFF)
+	std::size_t prg_ram_mask_ = 0;	// prg_ram_window_mask() of its size
+	std::vector<Byte> chr_ram_;		// Character RAM (CHR-RAM carts only)
+	std::span<const Byte> chr_mem_; // CHR ROM or chr_ram_
+	bool chr_is_ram_ = false;
+	bool battery_backed_;
+	std::shared_ptr<Vrc6Audio> audio_;
+
+	// Registers
+	Byte prg_bank_16k_ = 0;		   // $8000
+	Byte prg_bank_8k_ = 0;		   // $C000
+	Byte banking_style_ = 0;	   // $B003
+	std::array<Byte, 8> chr_banks_{}; // $D000-$E003
+	VrcIrqCounter irq_;
+
+	std::array<const Byte *, 8> chr_map_{};
+	void update_bank_maps();
+
+	[[nodiscard]] bool is_prg_ram_enabled() const noexcept {
+		return (banking_style_ & 0x80) != 0;
+	}
+};
+
+} // namespace nes
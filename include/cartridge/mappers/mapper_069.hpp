@@ -0,0 +1,121 @@
+#pragma once
+
+#include "apu/sunsoft_5b_audio.hpp"
+#include "cartridge/mappers/mapper.hpp"
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * Mapper 69 (Sunsoft FME-7 / 5A / 5B)
+ *
+ * Command Register ($8000-$9FFF): selects the register below
+ * Parameter Register ($A000-$BFFF): writes it
+ *   $0-$7: 1KB CHR banks 0-7
+ *   $8:    $6000-$7FFF: bits 0-5 bank, bit 6 RAM (1) or ROM (0), bit 7 RAM enable
+ *   $9-$B: 8KB PRG banks at $8000, $A000, $C000 ($E000 is fixed to the last)
+ *   $C:    mirroring (vertical, horizontal, one-screen low/high)
+ *   $D:    IRQ control: bit 0 IRQ enable, bit 7 counter enable; acknowledges
+ *   $E/$F: IRQ counter low/high byte
+ * Audio ($C000 select, $E000 write): Sunsoft 5B sound (see Sunsoft5bAudio)
+ *
+ * The IRQ counter is a 16-bit CPU-cycle down-counter that raises the IRQ as
+ * it wraps from $0000 to $FFFF; the bus runs it in spans rather than per
+ * cycle.
+ *
+ * Used by: Batman: Return of the Joker, Gimmick!, Hebereke
+ */
+class Mapper069 final : public Mapper {
+  public:
+	Mapper069(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring,
+			  bool battery_backed = false, RamSizes ram = {});
+
+	// CPU memory access
+	Byte cpu_read(Address address) const override;
+	void cpu_write(Address address, Byte value) override;
+
+	// PPU memory access
+	Byte ppu_read(Address address) const override;
+	void ppu_write(Address address, Byte value) override;
+
+	// Mapper info
+	std::uint8_t get_mapper_id() const noexcept override {
+		return 69;
+	}
+	const char *get_name() const noexcept override {
+		return "FME-7";
+	}
+
+	void reset() override;
+	Mirroring get_mirroring() const noexcept override;
+
+	// PRG ROM reads are pure lookups into prg_map_
+	bool has_prg_page_table() const noexcept override {
+		return true;
+	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
+
+	// IRQ counter
+	bool has_cpu_cycle_timer() const noexcept override {
+		return true;
+	}
+	void run_cpu_cycle_timer(std::uint32_t cycles) noexcept override;
+	std::uint32_t cpu_cycles_until_irq() const noexcept override;
+
+	std::shared_ptr<ExpansionAudio> expansion_audio() const noexcept override {
+		return audio_;
+	}
+
+	// Save state support
+	void serialize_registers(std::vector<Byte> &buffer) const override;
+	void deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) override;
+
+	// Battery-backed PRG-RAM persistence (.sav)
+	bool has_battery_ram() const noexcept override {
+		return battery_backed_;
+	}
+	std::span<const Byte> get_battery_ram() const noexcept override {
+		return {prg_ram_.data(), prg_ram_.size()};
+	}
+	void load_battery_ram(std::span<const Byte> data) override {
+		const std::size_t n = data.size() < prg_ram_.size() ? data.size() : prg_ram_.size();
+		for (std::size_t i = 0; i < n; ++i) {
+			prg_ram_[i] = data[i];
+		}
+		ram_rewritten();
+		clear_battery_ram_dirty();
+	}
+
+  private:
+	std::span<const Byte> prg_rom_; // Program ROM (up to 512KB)
+	std::vector<Byte> prg_ram_;		// Program RAM (8KB at $6000-$7FFF)
+	std::size_t prg_ram_mask_ = 0;	// prg_ram_window_mask() of its size
+	std::vector<Byte> chr_ram_;		// Character RAM (CHR-RAM carts only)
+	std::span<const Byte> chr_mem_; // CHR ROM or chr_ram_
+	Mirroring initial_mirroring_;
+	bool chr_is_ram_ = false;
+	bool battery_backed_;
+	std::shared_ptr<Sunsoft5bAudio> audio_;
+
+	// Registers
+	Byte command_ = 0;				  // $8000
+	std::array<Byte, 8> chr_banks_{}; // Commands $0-$7
+	Byte low_bank_ = 0;				  // Command $8
+	std::array<Byte, 3> prg_banks_{}; // Commands $9-$B
+	Byte mirroring_ = 0;			  // Command $C
+	bool irq_enabled_ = false;		  // Command $D bit 0
+	bool counter_enabled_ = false;	  // Command $D bit 7
+	std::uint16_t irq_counter_ = 0;	  // Commands $E/$F
+
+	std::array<const Byte *, 8> chr_map_{};
+	const Byte *low_rom_page_ = nullptr; // ROM mapped at $6000 (bit 6 clear)
+	void update_bank_maps();
+	void write_parameter(Byte value);
+};
+
+} // namespace nes
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "cartridge/mappers/mapper.hpp"
+#include "cartridge/mappers/vrc_irq.hpp"
+#include <array>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * Mapper 85 (Konami VRC7)
+ *
+ * Register pairs are told apart by A4 (VRC7a) or A3 (VRC7b); both are
+ * decoded, so $x008 and $x010 address the same register:
+ *
+ *   $8000 / $8010: 8KB PRG banks at $8000 / $A000
+ *   $9000:         8KB PRG bank at $C000
+ *   $9010 / $9030: FM sound register select / data (not synthesized)
+ *   $A000-$D010:   1KB CHR banks 0-7
+ *   $E000:         bits 0-1 mirroring (vertical, horizontal, one-screen
+ *                  low/high), bit 7 PRG-RAM enable
+ *   $E010:         IRQ latch
+ *   $F000 / $F010: IRQ control / acknowledge (see VrcIrqCounter)
+ *
+ * $E000-$FFFF is fixed to the last 8KB bank.
+ *
+ * Used by: Lagrange Point, Tiny Toon Adventures 2 (J)
+ */
+class Mapper085 final : public Mapper {
+  public:
+	Mapper085(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring,
+			  bool battery_backed = false, RamSizes ram = {});
+
+	// CPU memory access
+	Byte cpu_read(Address address) const override;
+	void cpu_write(Address address, Byte value) override;
+
+	// PPU memory access
+	Byte ppu_read(Address address) const override;
+	void ppu_write(Address address, Byte value) override;
+
+	// Mapper info
+	std::uint8_t get_mapper_id() const noexcept override {
+		return 85;
+	}
+	const char *get_name() const noexcept override {
+		return "VRC7";
+	}
+
+	void reset() override;
+	Mirroring get_mirroring() const noexcept override;
+
+	// PRG ROM reads are pure lookups into prg_map_
+	bool has_prg_page_table() const noexcept override {
+		return true;
+	}
+	std::span<const Byte> prg_rom_data() const noexcept override {
+		return prg_rom_;
+	}
+
+	// IRQ counter
+	bool has_cpu_cycle_timer() const noexcept override {
+		return true;
+	}
+	void run_cpu_cycle_timer(std::uint32_t cycles) noexcept override;
+	std::uint32_t cpu_cycles_until_irq() const noexcept override;
+
+	// Save state support
+	void serialize_registers(std::vector<Byte> &buffer) const override;
+	void deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) override;
+
+	// Battery-backed PRG-RAM persistence (.sav)
+	bool has_battery_ram() const noexcept override {
+		return battery_backed_;
+	}
+	std::span<const Byte> get_battery_ram() const noexcept override {
+		return {prg_ram_.data(), prg_ram_.size()};
+	}
+	void load_battery_ram(std::span<const Byte> data) override {
+		const std::size_t n = data.size() < prg_ram_.size() ? data.size() : prg_ram_.size();
+		for (std::size_t i = 0; i < n; ++i) {
+			prg_ram_[i] = data[i];
+		}
+		ram_rewritten();
+		clear_battery_ram_dirty();
+	}
+
+  private:
+	std::span<const Byte> prg_rom_; // Program ROM (up to 512KB)
+	std::vector<Byte> prg_ram_;		// Program RAM (8KB at $6000-$7FFF)
+	std::size_t prg_ram_mask_ = 0;	// prg_ram_window_mask() of its size
+	std::vector<Byte> chr_ram_;		// Character RAM (CHR-RAM carts only)
+	std::span<const Byte> chr_mem_; // CHR ROM or chr_ram_
+	Mirroring initial_mirroring_;
+	bool chr_is_ram_ = false;
+	bool battery_backed_;
+
+	// Registers
+	std::array<Byte, 3> prg_banks_{}; // $8000, $8010, $9000
+	std::array<Byte, 8> chr_banks_{}; // $A000-$D010
+	Byte control_ = 0;				  // $E000
+	VrcIrqCounter irq_;
+
+	std::array<const Byte *, 8> chr_map_{};
+	void update_bank_maps();
+
+	[[nodiscard]] bool is_prg_ram_enabled() const noexcept {
+		return (control_ & 0x80) != 0;
+	}
+};
+
+} // namespace nes
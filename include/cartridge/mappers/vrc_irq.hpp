@@ -0,0 +1,111 @@
+#pragma once
+
+#include "cartridge/mappers/mapper.hpp"
+#include "core/types.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace nes {
+
+/**
+ * VrcIrqCounter - The CPU-cycle IRQ counter shared by Konami's VRC4, VRC6
+ * and VRC7
+ *
+ * An 8-bit up-counter reloaded from the latch when it overflows from $FF,
+ * raising the IRQ. In cycle mode it counts every CPU cycle; in scanline mode
+ * a prescaler starting at 341 loses 3 per CPU cycle and clocks the counter
+ * each time it reaches zero (adding 341 back), i.e. once per 113.67 cycles.
+ *
+ * run() applies any number of cycles arithmetically and
+ * cycles_until_overflow() says when the next IRQ is due, so the owning
+ * mapper never needs per-cycle notifications.
+ */
+struct VrcIrqCounter {
+	Byte latch = 0;
+	Byte counter = 0;
+	std::int16_t prescaler = PRESCALER_RELOAD;
+	bool enabled = false;
+	bool enable_after_ack = false; // Control bit 0, copied into enabled on acknowledge
+	bool cycle_mode = false;
+
+	static constexpr std::int16_t PRESCALER_RELOAD = 341;
+
+	// Control register: also acknowledges the IRQ (caller clears its line)
+	void write_control(Byte value) noexcept {
+		enable_after_ack = (value & 0x01) != 0;
+		enabled = (value & 0x02) != 0;
+		cycle_mode = (value & 0x04) != 0;
+		if (enabled) {
+			counter = latch;
+			prescaler = PRESCALER_RELOAD;
+		}
+	}
+	void acknowledge() noexcept {
+		enabled = enable_after_ack;
+	}
+
+	// Run cycles CPU cycles; true if the counter overflowed (IRQ)
+	bool run(std::uint64_t cycles) noexcept {
+		if (!enabled || cycles == 0) {
+			return false;
+		}
+		std::uint64_t clocks = cycles;
+		if (!cycle_mode) {
+			const std::int64_t balance = static_cast<std::int64_t>(prescaler) - 3 * static_cast<std::int64_t>(cycles);
+			if (balance > 0) {
+				prescaler = static_cast<std::int16_t>(balance);
+				return false;
+			}
+			clocks = static_cast<std::uint64_t>(-balance) / PRESCALER_RELOAD + 1;
+			prescaler = static_cast<std::int16_t>(balance + static_cast<std::int64_t>(clocks) * PRESCALER_RELOAD);
+		}
+		const std::uint64_t to_overflow = 0x100u - counter;
+		if (clocks < to_overflow) {
+			counter = static_cast<Byte>(counter + clocks);
+			return false;
+		}
+		const std::uint64_t period = 0x100u - latch;
+		counter = static_cast<Byte>(latch + (clocks - to_overflow) % period);
+		return true;
+	}
+
+	// CPU cycles until run() next returns true, or Mapper::NO_CYCLE_IRQ
+	[[nodiscard]] std::uint32_t cycles_until_overflow() const noexcept {
+		if (!enabled) {
+			return Mapper::NO_CYCLE_IRQ;
+		}
+		const std::uint32_t clocks = 0x100u - counter;
+		if (cycle_mode) {
+			return clocks;
+		}
+		// The k-th clock lands on the first cycle where 3n >= prescaler + 341 (k - 1)
+		return (static_cast<std::uint32_t>(prescaler) + PRESCALER_RELOAD * (clocks - 1) + 2) / 3;
+	}
+
+	void serialize(std::vector<Byte> &buffer) const {
+		buffer.push_back(latch);
+		buffer.push_back(counter);
+		buffer.push_back(static_cast<Byte>(prescaler & 0xFF));
+		buffer.push_back(static_cast<Byte>((prescaler >> 8) & 0xFF));
+		buffer.push_back(static_cast<Byte>((enabled ? 0x02 : 0) | (enable_after_ack ? 0x01 : 0) | (cycle_mode ? 0x04 : 0)));
+	}
+	void deserialize(const std::vector<Byte> &buffer, std::size_t &offset) {
+		if (offset + 5 > buffer.size()) {
+			throw std::runtime_error("save state: unexpected end of buffer (VRC IRQ)");
+		}
+		latch = buffer[offset++];
+		counter = buffer[offset++];
+		prescaler = static_cast<std::int16_t>(buffer[offset] | (buffer[offset + 1] << 8));
+		offset += 2;
+		if (prescaler <= 0 || prescaler > PRESCALER_RELOAD) {
+			prescaler = PRESCALER_RELOAD;
+		}
+		const Byte flags = buffer[offset++];
+		enabled = (flags & 0x02) != 0;
+		enable_after_ack = (flags & 0x01) != 0;
+		cycle_mode = (flags & 0x04) != 0;
+	}
+};
+
+} // namespace nes
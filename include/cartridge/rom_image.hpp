@@ -0,0 +1,88 @@
+#pragma once
+
+#include "cartridge/rom_loader.hpp"
+#include "core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace nes {
+
+/**
+ * RomImage - Immutable ROM contents shared by every cartridge running them
+ *
+ * load() memory-maps the .nes file read-only, so PRG and CHR ROM are paged in
+ * on demand and shared by every instance (and process) running the game;
+ * where mapping is unavailable the file is read into one buffer instead.
+ * from_rom_data() copies ROM data built in memory (tests, synthetic ROMs).
+ *
+ * Images are handed around as shared_ptr<const RomImage>: cartridges and
+ * their mappers only read through the spans, and the image lives as long as
+ * the last cartridge holding it. Everything a game can write - PRG-RAM,
+ * CHR-RAM, mapper registers - stays in each instance's mapper.
+ *
+ * The CRC-32 of PRG ROM, which save states and movies are checked against,
+ * is computed once when the image is created.
+ */
+class RomImage {
+  public:
+	/**
+	 * Map (or read) an iNES file
+	 * @return nullptr if the file cannot be read or is not a complete iNES ROM
+	 */
+	static std::shared_ptr<const RomImage> load(const std::string &filepath);
+
+	/**
+	 * Copy in-memory ROM data
+	 * @return nullptr if rom_data is not valid
+	 */
+	static std::shared_ptr<const RomImage> from_rom_data(const RomData &rom_data);
+
+	~RomImage();
+	RomImage(const RomImage &) = delete;
+	RomImage &operator=(const RomImage &) = delete;
+
+	// Header fields and filename; the section vectors are left empty, the
+	// bytes are prg_rom()/chr_rom()/trainer()
+	[[nodiscard]] const RomData &header() const noexcept {
+		return header_;
+	}
+	[[nodiscard]] std::span<const Byte> prg_rom() const noexcept {
+		return prg_rom_;
+	}
+	[[nodiscard]] std::span<const Byte> chr_rom() const noexcept {
+		return chr_rom_;
+	}
+	[[nodiscard]] std::span<const Byte> trainer() const noexcept {
+		return trainer_;
+	}
+
+	[[nodiscard]] std::uint32_t prg_crc32() const noexcept {
+		return prg_crc32_;
+	}
+
+	// Whether the bytes are a file mapping rather than a private copy
+	[[nodiscard]] bool is_mapped() const noexcept {
+		return mapping_ != nullptr;
+	}
+
+  private:
+	RomImage() = default;
+
+	RomData header_{};
+	std::vector<Byte> owned_; // The bytes, when not mapped
+	const Byte *mapping_ = nullptr;
+	std::size_t mapping_size_ = 0;
+	std::span<const Byte> prg_rom_;
+	std::span<const Byte> chr_rom_;
+	std::span<const Byte> trainer_;
+	std::uint32_t prg_crc32_ = 0;
+
+	bool map_file(const std::string &filepath);
+	void unmap_file() noexcept;
+};
+
+} // namespace nes
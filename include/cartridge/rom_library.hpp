@@ -0,0 +1,131 @@
+#pragma once
+
+#include "core/checksum.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+/**
+ * RomLibrary - Persistent index of the .nes files under a ROM directory
+ *
+ * Every ROM is listed with its size and modification time, the header fields
+ * the browser shows and the CRC-32 and SHA-1 of its PRG+CHR data (header and
+ * trainer excluded, as ROM databases hash them). The index is kept in one
+ * binary file (.vnidx) so a library of thousands of ROMs on slow storage is
+ * listed and searched without opening any of them.
+ *
+ * start_scan() walks the directory on a background thread. A file whose size
+ * and mtime match its entry is kept as it is; only new and changed files are
+ * opened and hashed, and entries for files that are gone are dropped. The
+ * entries are republished as the scan goes and the index file is rewritten
+ * when it finishes, if anything changed.
+ *
+ * search() and entries() copy out of the current entries under a shared
+ * lock and can be called from any thread while a scan runs.
+ */
+class RomLibrary {
+  public:
+	struct Entry {
+		std::string path; // Relative to the root, '/'-separated
+		std::uint64_t size = 0;
+		std::int64_t mtime = 0; // file_time_type ticks, compared for equality only
+
+		bool valid = false; // A complete iNES/NES 2.0 ROM; the fields below are zero otherwise
+		bool nes2_0 = false;
+		bool vertical_mirroring = false;
+		bool four_screen_vram = false;
+		bool battery_backed_ram = false;
+		std::uint16_t mapper_id = 0;
+		std::uint8_t submapper = 0;
+		std::uint16_t prg_rom_pages = 0;
+		std::uint16_t chr_rom_pages = 0;
+		std::uint32_t crc32 = 0;
+		Sha1::Digest sha1{};
+	};
+
+	// What the last scan did
+	struct ScanStats {
+		std::size_t files = 0;	 // ROM files found
+		std::size_t hashed = 0;	 // Opened and hashed (new or changed)
+		std::size_t removed = 0; // Entries dropped for files that are gone
+	};
+
+	/**
+	 * @param root Directory scanned (recursively) for .nes files
+	 * @param index_file Where the index is loaded from and saved to
+	 */
+	RomLibrary(std::filesystem::path root, std::filesystem::path index_file);
+	~RomLibrary();
+	RomLibrary(const RomLibrary &) = delete;
+	RomLibrary &operator=(const RomLibrary &) = delete;
+
+	/// Replace the entries with the index file's; false if it is missing or not an index
+	bool load_index();
+	bool save_index() const;
+
+	/// Rescan on a background thread (no-op while one is running)
+	void start_scan();
+	/// Ask a running scan to stop and wait for it
+	void cancel_scan();
+	/// Wait for a running scan to finish
+	void wait_for_scan();
+	[[nodiscard]] bool is_scanning() const noexcept {
+		return scanning_.load(std::memory_order_acquire);
+	}
+	/// Rescan on the calling thread
+	ScanStats scan();
+
+	/**
+	 * Entries whose path contains query (case-insensitive), or whose CRC-32
+	 * is query as 8 hex digits; all entries for an empty query
+	 * @param limit Most entries returned (0 = all)
+	 */
+	[[nodiscard]] std::vector<Entry> search(std::string_view query, std::size_t limit = 0) const;
+	[[nodiscard]] std::vector<Entry> entries() const;
+	[[nodiscard]] std::size_t size() const;
+
+	// Bumped whenever the entries change, so a view can re-run its search
+	// only then
+	[[nodiscard]] std::uint64_t get_generation() const noexcept {
+		return generation_.load(std::memory_order_acquire);
+	}
+	[[nodiscard]] ScanStats get_last_scan_stats() const;
+
+	[[nodiscard]] const std::filesystem::path &get_root() const noexcept {
+		return root_;
+	}
+	[[nodiscard]] std::filesystem::path full_path(const Entry &entry) const {
+		return root_ / std::filesystem::path(entry.path);
+	}
+
+	// Header and hashes of one file (what an index entry holds for it)
+	static Entry read_entry(const std::filesystem::path &file);
+
+  private:
+	std::filesystem::path root_;
+	std::filesystem::path index_file_;
+
+	mutable std::shared_mutex mutex_;
+	std::vector<Entry> entries_;	  // Sorted by path
+	std::vector<std::string> names_; // Lower-cased paths for search(), parallel to entries_
+	ScanStats last_stats_;
+	std::atomic<std::uint64_t> generation_{0};
+
+	std::mutex scan_mutex_; // One scan at a time
+	std::thread scan_thread_;
+	std::atomic<bool> scanning_{false};
+	std::atomic<bool> cancel_{false};
+
+	void publish(std::vector<Entry> entries);
+};
+
+} // namespace nes
@@ -2,24 +2,48 @@
 
 #include "core/types.hpp"
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace nes {
 
+// CPU/PPU timing the cart was made for (NES 2.0 byte 12; iNES 1 says NTSC)
+enum class TimingRegion : std::uint8_t { Ntsc, Pal, MultiRegion, Dendy };
+
+// What the cart plugs into (byte 7 bits 0-1)
+enum class ConsoleType : std::uint8_t { Nes, VsSystem, Playchoice10, Extended };
+
 /**
  * Structure representing an iNES ROM file header and data
  */
 struct RomData {
 	// Header information
-	std::uint8_t mapper_id;
-	std::uint8_t prg_rom_pages; // 16KB pages
-	std::uint8_t chr_rom_pages; // 8KB pages
+	std::uint16_t mapper_id;	 // 12 bits in NES 2.0 headers, 8 in iNES
+	std::uint16_t prg_rom_pages; // 16KB pages
+	std::uint16_t chr_rom_pages; // 8KB pages
 	bool vertical_mirroring;
 	bool battery_backed_ram;
 	bool trainer_present;
 	bool four_screen_vram;
+	bool nes2_0;			// NES 2.0 header (byte 7 bits 2-3 = 10b)
+	std::uint8_t submapper; // NES 2.0 only
+	ConsoleType console_type;
+	TimingRegion timing;
+
+	// On-cart RAM in bytes (NES 2.0 bytes 10-11; all 0 in iNES 1 headers,
+	// which leave RAM to each board's usual size). NVRAM is battery-backed.
+	std::uint32_t prg_ram_size;
+	std::uint32_t prg_nvram_size;
+	std::uint32_t chr_ram_size;
+	std::uint32_t chr_nvram_size;
+
+	// NES 2.0 byte 15: the default expansion device (0 = unspecified, 1 =
+	// standard pads, 2 = Four Score, 8 = Zapper, ...), see
+	// input_setup_for_expansion_device()
+	std::uint8_t expansion_device;
 
 	// ROM data
 	std::vector<Byte> prg_rom; // Program ROM
@@ -36,6 +60,16 @@ struct RomData {
  */
 class RomLoader {
   public:
+	// Where each section of an iNES image starts, and how long it is
+	struct Layout {
+		std::size_t trainer_offset = 0;
+		std::size_t trainer_size = 0; // 0 without a trainer
+		std::size_t prg_offset = 0;
+		std::size_t prg_size = 0;
+		std::size_t chr_offset = 0;
+		std::size_t chr_size = 0;
+	};
+
 	/**
 	 * Load a ROM file from disk
 	 * @param filepath Path to the .nes file
@@ -50,6 +84,23 @@ class RomLoader {
 	 */
 	static bool is_valid_nes_file(const std::string &filepath);
 
+	/**
+	 * Read and parse just the 16-byte header of a file (for listing ROM
+	 * directories without reading whole ROMs)
+	 * @param rom_data Receives the header fields and filename (no section data)
+	 * @return false if the file cannot be read or has no iNES/NES 2.0 header
+	 */
+	static bool read_header(const std::string &filepath, RomData &rom_data);
+
+	/**
+	 * Validate an iNES image already in memory and locate its sections
+	 * @param filepath Only used for the filename and error messages
+	 * @param rom_data Receives the header fields and filename (no section data)
+	 * @return false if the image is not a complete iNES ROM
+	 */
+	static bool parse_image(std::span<const Byte> image, const std::string &filepath, RomData &rom_data,
+							Layout &layout);
+
   private:
 	// iNES header constants
 	static constexpr std::size_t INES_HEADER_SIZE = 16;
@@ -61,8 +112,9 @@ class RomLoader {
 	static constexpr std::array<Byte, 4> INES_MAGIC = {0x4E, 0x45, 0x53, 0x1A};
 
 	// Helper functions
-	static bool validate_header(const std::vector<Byte> &header);
-	static RomData parse_header(const std::vector<Byte> &header);
+	static bool validate_header(std::span<const Byte> header);
+	static RomData parse_header(std::span<const Byte> header);
+	static std::uint32_t ram_shift_size(Byte shift) noexcept;
 	static std::vector<Byte> read_file(const std::string &filepath);
 };
 
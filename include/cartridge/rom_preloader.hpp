@@ -0,0 +1,111 @@
+#pragma once
+
+#include "cartridge/rom_image.hpp"
+#include "core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nes {
+
+// A ROM read ahead of the swap: what Cartridge::load_rom_image() and the
+// battery-save restore need, with no file I/O left to do
+struct PreloadedRom {
+	std::string path;
+	std::shared_ptr<const RomImage> image; // Null: not a loadable ROM
+	bool save_read = false;				   // The save file was looked for
+	std::optional<std::vector<Byte>> save; // Its contents, if it exists
+	bool resident = false;				   // The image was already in memory
+};
+
+/**
+ * RomPreloader - Reads a ROM and its save file off the calling thread
+ *
+ * prefetch() starts loading on a worker: the image is mapped and its PRG
+ * CRC-32 taken (RomImage::load), CHR ROM is paged in too, and the save file
+ * (the .sav, for BatterySaveManager::restore()) is read. take() waits for
+ * that and hands it over, so a caller that prefetches as soon as it knows
+ * the path - the launch ROM before the window and audio device are set up,
+ * a file as soon as the browser selects it - finds the work done when it
+ * swaps the cartridge. take() on a path that was not prefetched loads it
+ * right there.
+ *
+ * The images of the last few ROMs taken stay resident (set_resident_limit),
+ * so relaunching one whose file has not changed (same size and mtime) skips
+ * the disk for everything but the save file, which always comes fresh.
+ *
+ * Not thread-safe: prefetch() and take() come from one thread, the worker
+ * only touches what it was handed.
+ */
+class RomPreloader {
+  public:
+	static constexpr std::size_t DEFAULT_RESIDENT_LIMIT = 2; // The running game and the one before it
+
+	RomPreloader() = default;
+	~RomPreloader();
+	RomPreloader(const RomPreloader &) = delete;
+	RomPreloader &operator=(const RomPreloader &) = delete;
+
+	/// Start loading rom_path (and save_path, unless empty); replaces any
+	/// prefetch not yet taken. A no-op if that exact request is in flight.
+	void prefetch(const std::string &rom_path, const std::filesystem::path &save_path = {});
+
+	/// The prefetched ROM, waiting for it if need be, or rom_path loaded now
+	[[nodiscard]] PreloadedRom take(const std::string &rom_path, const std::filesystem::path &save_path = {});
+
+	/// Whether a prefetch is in flight
+	[[nodiscard]] bool is_pending() const noexcept {
+		return pending_.result.valid();
+	}
+
+	/// Images kept for instant relaunch, most recently taken first; 0 keeps none
+	void set_resident_limit(std::size_t limit);
+	[[nodiscard]] std::size_t resident_count() const noexcept {
+		return resident_.size();
+	}
+
+  private:
+	// The file an image was loaded from, to tell whether it changed since
+	struct FileStamp {
+		std::uintmax_t size = 0;
+		std::int64_t mtime = 0;
+		bool valid = false;
+
+		bool operator==(const FileStamp &) const = default;
+	};
+
+	struct ResidentImage {
+		std::string path;
+		FileStamp stamp;
+		std::shared_ptr<const RomImage> image;
+	};
+
+	struct Loaded {
+		PreloadedRom rom;
+		FileStamp stamp; // Taken before reading, so a change while loading shows next time
+	};
+
+	struct Request {
+		std::string rom_path;
+		std::filesystem::path save_path;
+		std::future<Loaded> result;
+	};
+
+	Request pending_;
+	std::vector<ResidentImage> resident_; // Most recent first
+	std::size_t resident_limit_ = DEFAULT_RESIDENT_LIMIT;
+
+	[[nodiscard]] static FileStamp stamp_of(const std::string &path);
+	// Runs on the worker; `cached` is a resident image to reuse if unchanged
+	[[nodiscard]] static Loaded load(const std::string &rom_path, const std::filesystem::path &save_path,
+									 const std::optional<ResidentImage> &cached);
+	[[nodiscard]] std::optional<ResidentImage> find_resident(const std::string &path) const;
+	void keep_resident(const Loaded &loaded);
+};
+
+} // namespace nes
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+
+namespace nes {
+
+/**
+ * Accuracy - How closely the PPU times its rarely-hit hardware quirks
+ *
+ * Strict checks each quirk on every dot, at the dot hardware acts on it.
+ * Fast folds them into checks the dot loop makes anyway: the odd-frame skip
+ * and VBlank set/clear are only looked for on VBlank and pre-render lines
+ * (exact), while the sprite-0 hit flag goes up on the hit dot instead of two
+ * dots later and a pending VRAM address corruption lands at the end of the
+ * scanline instead of the next dot. That leaves nothing to do per dot on
+ * the post-render and VBlank lines, which Fast then crosses in one step. A
+ * game that polls $2002 to the dot for sprite 0 can tell the difference;
+ * nothing else can.
+ *
+ * The PPU instantiates its dot step per profile (PPU::set_accuracy()).
+ * Runs that must agree with each other (netplay peers, movie playback,
+ * golden traces) must use the same profile.
+ */
+enum class Accuracy : std::uint8_t { Strict, Fast };
+
+[[nodiscard]] constexpr const char *accuracy_name(Accuracy accuracy) noexcept {
+	return accuracy == Accuracy::Fast ? "fast" : "strict";
+}
+
+/**
+ * AccuracyDatabase - Which games are known to run right with Accuracy::Fast
+ *
+ * Keyed by the CRC-32 of the PRG ROM (Cartridge::get_prg_rom_crc32()), so a
+ * batch or netplay runner can pick the profile per ROM. The file format is
+ * one game per line, "<crc32 in hex> strict|fast", with '#' starting a
+ * comment; games not listed run Strict.
+ */
+class AccuracyDatabase {
+  public:
+	/// Add the file's entries; false (and nothing added) if it cannot be read or a line is malformed
+	bool load(const std::filesystem::path &path);
+	/// Add the entries in text, in the file format
+	bool parse(std::string_view text);
+
+	void set(std::uint32_t prg_crc32, Accuracy accuracy) {
+		entries_[prg_crc32] = accuracy;
+	}
+	[[nodiscard]] Accuracy lookup(std::uint32_t prg_crc32) const noexcept {
+		const auto it = entries_.find(prg_crc32);
+		return it != entries_.end() ? it->second : Accuracy::Strict;
+	}
+	[[nodiscard]] std::size_t size() const noexcept {
+		return entries_.size();
+	}
+
+  private:
+	std::unordered_map<std::uint32_t, Accuracy> entries_;
+};
+
+} // namespace nes
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nes {
+
+class CPU6502;
+class SystemBus;
+
+/**
+ * BreakCondition - Compiled breakpoint condition expression
+ *
+ * C-style integer expressions over the machine state at the access:
+ *   registers   a x y sp p pc (pc has moved past the bytes fetched so far)
+ *   the access  addr value (the byte read or written; the opcode for execute)
+ *   the PPU     scanline dot frame
+ *   memory      [expr] (side-effect free CPU bus peek)
+ *   literals    $1F 0x1F %00011111 31
+ *   operators   || && | ^ & == != < <= > >= << >> + - * and unary ! ~ -
+ * Names are case-insensitive. compile() turns the text into postfix code
+ * once; evaluate() runs it on a fixed stack without allocating.
+ */
+class BreakCondition {
+  public:
+	/// nullopt (and a message in `error`) if the text does not parse
+	[[nodiscard]] static std::optional<BreakCondition> compile(std::string_view text, std::string *error = nullptr);
+
+	[[nodiscard]] std::int32_t evaluate(const CPU6502 *cpu, const SystemBus *bus, Address address,
+										Byte value) const noexcept;
+	[[nodiscard]] const std::string &text() const noexcept {
+		return text_;
+	}
+
+  private:
+	static constexpr std::size_t MAX_STACK = 16;
+
+	enum class Op : std::uint8_t {
+		Literal,
+		A,
+		X,
+		Y,
+		Sp,
+		P,
+		Pc,
+		Addr,
+		Value,
+		Scanline,
+		Dot,
+		Frame,
+		Peek,
+		Not,
+		Negate,
+		Complement,
+		Or,
+		And,
+		BitOr,
+		BitXor,
+		BitAnd,
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		ShiftLeft,
+		ShiftRight,
+		Add,
+		Subtract,
+		Multiply,
+	};
+	struct Instruction {
+		Op op;
+		std::int32_t literal = 0;
+	};
+	class Parser;
+
+	std::vector<Instruction> code_;
+	std::string text_;
+};
+
+/// Why a run stopped at a breakpoint. id 0 is a plain CPU6502::set_breakpoint().
+struct BreakpointHit {
+	int id = 0;
+	std::uint8_t kind = 0; // One of the Breakpoints kind flags
+	Address address = 0;   // CPU address, or PPU address for PPU kinds
+	Byte value = 0;
+};
+
+/**
+ * Breakpoints - PC breakpoints and CPU/PPU watchpoints with conditions
+ *
+ * Each entry watches an inclusive address range for any mix of kinds:
+ * instruction execution, CPU bus reads and writes (data, operand and DMA
+ * accesses, RAM through the zero-page fast path included), and PPU VRAM
+ * reads and writes through PPUDATA ($2007), at the VRAM address before the
+ * access. An entry fires when its optional condition evaluates non-zero.
+ *
+ * The bus and CPU see a 256-byte page bitmap per address space. While no
+ * watchpoint is enabled is_watching() is false and every bus access pays
+ * exactly that one predictable branch. Hits are latched until taken; the
+ * CPU run loops stop on them (see CPU6502::RunStop).
+ *
+ * Hooks are read/write entries that call back instead of stopping the run
+ * (scripting, see ScriptHost). They run inside the bus access, so they may
+ * peek but must not access the bus, throw, or add or remove entries.
+ */
+class Breakpoints {
+  public:
+	static constexpr std::uint8_t EXECUTE = 0x01;
+	static constexpr std::uint8_t CPU_READ = 0x02;
+	static constexpr std::uint8_t CPU_WRITE = 0x04;
+	static constexpr std::uint8_t PPU_READ = 0x08;
+	static constexpr std::uint8_t PPU_WRITE = 0x10;
+	static constexpr std::uint8_t CPU_KINDS = EXECUTE | CPU_READ | CPU_WRITE;
+	static constexpr std::uint8_t PPU_KINDS = PPU_READ | PPU_WRITE;
+
+	using Hook = std::function<void(const BreakpointHit &)>;
+
+	struct Entry {
+		int id = 0;
+		std::uint8_t kinds = 0;
+		Address first = 0;
+		Address last = 0;
+		bool enabled = true;
+		std::uint64_t hits = 0;
+		std::optional<BreakCondition> condition;
+		Hook hook; // Set for hooks, which never stop a run
+	};
+
+	/// Conditions read registers from `cpu` and memory/PPU state from `bus`
+	void attach(const CPU6502 *cpu, const SystemBus *bus) noexcept {
+		cpu_ = cpu;
+		bus_ = bus;
+	}
+
+	/// Watch [first, last] for `kinds`; returns the new entry's id (> 0), or
+	/// 0 if the kinds mix CPU and PPU spaces, the range is reversed or the
+	/// condition does not compile (message in `error`)
+	int add(std::uint8_t kinds, Address first, Address last, std::string_view condition = {},
+			std::string *error = nullptr);
+	/// Like add(), but `hook` is called on each matching access and the run
+	/// goes on; execute hooks are refused (0)
+	int add_hook(std::uint8_t kinds, Address first, Address last, Hook hook, std::string_view condition = {},
+				 std::string *error = nullptr);
+	bool remove(int id);
+	bool set_enabled(int id, bool enabled);
+	void clear();
+	[[nodiscard]] const std::vector<Entry> &entries() const noexcept {
+		return entries_;
+	}
+
+	/// Any enabled entry at all
+	[[nodiscard]] bool is_armed() const noexcept {
+		return armed_;
+	}
+	/// Any enabled read/write watchpoint: the bus's single hot-path test
+	[[nodiscard]] bool is_watching() const noexcept {
+		return watching_;
+	}
+	[[nodiscard]] bool watches(std::uint8_t kind, Address address) const noexcept {
+		return (kind & PPU_KINDS) ? (ppu_pages_[(address & 0x3FFF) >> 8] & kind) != 0
+								  : (cpu_pages_[address >> 8] & kind) != 0;
+	}
+
+	/// Record an access; evaluates the entries covering it on a watched page
+	/// and calls the hooks among them. True if a breakpoint fired (the first
+	/// hit is latched until take_hit()).
+	bool check(std::uint8_t kind, Address address, Byte value) noexcept {
+		return watches(kind, address) && evaluate(kind, address, value);
+	}
+
+	[[nodiscard]] bool has_hit() const noexcept {
+		return hit_.has_value();
+	}
+	[[nodiscard]] const std::optional<BreakpointHit> &get_hit() const noexcept {
+		return hit_;
+	}
+	std::optional<BreakpointHit> take_hit() noexcept {
+		std::optional<BreakpointHit> hit = hit_;
+		hit_.reset();
+		return hit;
+	}
+
+  private:
+	std::vector<Entry> entries_;
+	int next_id_ = 1;
+	bool armed_ = false;
+	bool watching_ = false;
+	std::array<std::uint8_t, 0x100> cpu_pages_{};
+	std::array<std::uint8_t, 0x40> ppu_pages_{};
+	std::optional<BreakpointHit> hit_;
+	const CPU6502 *cpu_ = nullptr;
+	const SystemBus *bus_ = nullptr;
+
+	int add_entry(Entry entry, std::string_view condition, std::string *error);
+	bool evaluate(std::uint8_t kind, Address address, Byte value) noexcept;
+	void rebuild_pages();
+};
+
+} // namespace nes
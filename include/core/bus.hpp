@@ -1,21 +1,41 @@
 #pragma once
 
-#include "audio/audio_backend.hpp"
+#include "audio/audio_output.hpp"
+#include "core/breakpoints.hpp"
+#include "core/bus_stats.hpp"
 #include "core/component.hpp"
+#include "core/event_scheduler.hpp"
+#include "core/region.hpp"
 #include "core/types.hpp"
 #include <array>
 #include <memory>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace nes {
 
 // Forward declarations
+class AudioRecorder;
 class Ram;
 class PPU;
+class PpuWriteLog;
 class APU;
 class Controller;
 class Cartridge;
 class CPU6502;
 
+/// Per-component time accumulated by SystemBus::tick_single_cpu_cycle while
+/// cycle profiling is enabled (used by VibeNES_Bench). CPU time is whatever
+/// the caller measured in total minus tick_ns.
+struct CycleProfile {
+	uint64_t cycles = 0;	   // tick_single_cpu_cycle calls sampled
+	uint64_t tick_ns = 0;	   // Total time spent inside tick_single_cpu_cycle
+	uint64_t ppu_ns = 0;	   // PPU::tick_dots
+	uint64_t apu_ns = 0;	   // APU::step_cpu_cycles
+	uint64_t cartridge_ns = 0; // Scheduled events (catch-up, mapper IRQs, IRQ line)
+};
+
 /// System Bus - Central memory and I/O interconnect
 /// Handles address decoding and routes memory accesses to appropriate components
 class SystemBus final : public Component {
@@ -33,8 +53,61 @@ class SystemBus final : public Component {
 	[[nodiscard]] Byte read(Address address) const;
 	void write(Address address, Byte value);
 
+	// Opcode/operand fetch: a read() that the Code/Data Logger records as code
+	[[nodiscard]] Byte fetch(Address address) const;
+
+	// The PRG page a fetch at address would read (the 8 KB containing it),
+	// for the CPU to take an instruction's bytes from directly; null when
+	// fetches must go through fetch(): below $8000, a mapper without a page
+	// table, the Code/Data Logger on or watchpoints armed
+	[[nodiscard]] const Byte *prg_fetch_page(Address address) const noexcept;
+	// A fetch the CPU read from a prg_fetch_page(): latched as fetch() would
+	Byte latch_fetch(Address address, Byte value) const noexcept {
+		VIBENES_BUS_STAT((bus_stats_.count_read(address), ++bus_stats_.prg_page_reads));
+		(void)address;
+		last_bus_value_ = value;
+		return value;
+	}
+
 	// Non-intrusive memory peek (no side effects) for debugging
 	[[nodiscard]] Byte peek(Address address) const;
+	// Bulk peek of out.size() bytes starting at `first` (wrapping past $FFFF),
+	// byte-for-byte what peek() returns. RAM and PRG pages behind the mapper's
+	// page table are copied directly; everything else goes through peek().
+	void peek_range(Address first, std::span<Byte> out) const;
+
+	// Fast path for $0000-$01FF (zero page and stack). Those addresses always
+	// decode to work RAM and have no side effects, so the CPU skips the decode
+	// in read()/write(); the open-bus latch is still updated the same way.
+	[[nodiscard]] Byte read_low_ram(Address address) const noexcept {
+		VIBENES_BUS_STAT((bus_stats_.count_read(address), ++bus_stats_.low_ram_reads));
+		if (ram_memory_) {
+			last_bus_value_ = ram_memory_[address & 0x01FF];
+		}
+		if (breakpoints_.is_watching()) [[unlikely]] {
+			breakpoints_.check(Breakpoints::CPU_READ, address, last_bus_value_);
+		}
+		return last_bus_value_;
+	}
+	void write_low_ram(Address address, Byte value) noexcept {
+		VIBENES_BUS_STAT((bus_stats_.count_write(address), ++bus_stats_.low_ram_writes));
+		last_bus_value_ = value;
+		if (ram_memory_) {
+			ram_memory_[address & 0x01FF] = value;
+		}
+		if (breakpoints_.is_watching()) [[unlikely]] {
+			breakpoints_.check(Breakpoints::CPU_WRITE, address, value);
+		}
+	}
+
+	// Breakpoints and watchpoints (see Breakpoints). The CPU run loops stop
+	// on their hits; with none enabled every access pays one branch.
+	[[nodiscard]] Breakpoints &breakpoints() noexcept {
+		return breakpoints_;
+	}
+	[[nodiscard]] const Breakpoints &breakpoints() const noexcept {
+		return breakpoints_;
+	}
 
 	// Component management
 	void connect_ram(std::shared_ptr<Ram> ram);
@@ -46,11 +119,113 @@ class SystemBus final : public Component {
 
 	// Debug interface
 	void debug_print_memory_map() const;
+	[[nodiscard]] const Cartridge *get_cartridge() const noexcept {
+		return cartridge_raw_;
+	}
+	[[nodiscard]] const PPU *get_ppu() const noexcept {
+		return ppu_raw_;
+	}
 
 	// Cycle-accurate synchronization: advance PPU (3 dots), APU (1 cycle),
 	// and check mapper IRQs for a single CPU cycle. Called from CPU's
 	// consume_cycle() for per-cycle interleaving.
 	void tick_single_cpu_cycle();
+	// The same for `cycles` cycles in one step, when none of them would reach
+	// a scheduled event, no DMC DMA is waiting and the PPU is banking dots
+	// (catch-up, integer dot ratio); otherwise false and nothing advances.
+	// For CPU cycles with no bus access, whose per-cycle ticks would only
+	// bank dots and step the APU.
+	[[nodiscard]] bool try_tick_cpu_cycles(uint32_t cycles);
+	// Whether try_tick_cpu_cycles(cycles) would succeed now
+	[[nodiscard]] bool can_tick_cpu_cycles(uint32_t cycles) const noexcept;
+	// The most cycles try_tick_cpu_cycles() could take right now: those that
+	// end short of the next scheduled event
+	[[nodiscard]] uint32_t cycles_before_next_event() const noexcept;
+
+	// Event scheduling. IRQ sources, DMC DMA and the catch-up PPU post their
+	// next possible state change on a master-clock timeline (12 clocks per CPU
+	// cycle, 4 per PPU dot); the per-cycle tick only compares the clock with
+	// the earliest deadline and re-polls sources when one is reached. Code
+	// that changes APU/PPU/mapper state behind the bus's back (tests, state
+	// loads) must call reschedule_events() afterwards.
+	[[nodiscard]] uint64_t get_master_clock() const noexcept {
+		return master_clock_;
+	}
+	[[nodiscard]] const EventScheduler &get_event_scheduler() const noexcept {
+		return scheduler_;
+	}
+	void reschedule_events() const noexcept {
+		scheduler_.schedule_all(master_clock_);
+	}
+	// Put this bus on another's timeline ahead of loading that machine's
+	// state (NesSystem::clone_into); save states leave the clock alone
+	void set_master_clock(uint64_t clock) noexcept {
+		master_clock_ = clock;
+	}
+
+	// PPU scanline and dot as of the current CPU cycle (first brings a
+	// catch-up PPU current), for tracing and debug views
+	[[nodiscard]] std::pair<uint16_t, uint16_t> get_ppu_position() const;
+
+	// Idle-loop fast-forward (see CPU6502::set_idle_loop_skipping). The
+	// first call is a conservative count of CPU cycles in which no NMI,
+	// VBlank flag change, frame end, IRQ or DMA can happen (0 if it cannot
+	// tell); the second advances PPU, APU and mapper by up to that many
+	// cycles at once, with the same result as ticking them one by one.
+	[[nodiscard]] uint32_t idle_cycles_available() const;
+	void advance_idle_cycles(uint32_t cycles);
+
+	// Catch-up PPU synchronization (off by default). Instead of 3 dots per CPU
+	// cycle, the bus records the dots the PPU is owed and runs it forward only
+	// when the CPU touches $2000-$3FFF, OAM DMA or mapper registers, or when
+	// PPU::dots_until_sync_point() says an NMI/frame-end/mapper-IRQ deadline
+	// has arrived. The observable result is identical to lockstep; callers
+	// inspecting the PPU directly must call sync_ppu() first.
+	void set_ppu_catch_up(bool enabled);
+	[[nodiscard]] bool is_ppu_catch_up() const noexcept {
+		return ppu_catch_up_;
+	}
+	void sync_ppu() const;
+	// Record what the CPU does to the PPU's inputs into log (see
+	// PpuWriteLog) until set back to null
+	void set_ppu_log(PpuWriteLog *log) noexcept {
+		ppu_log_ = log;
+	}
+
+	// Timing region (NTSC by default), normally the loaded ROM's. Sets the
+	// connected PPU and APU too; connect them first. The master clock keeps 12
+	// units per CPU cycle everywhere. NTSC and Dendy run 3 dots per CPU cycle
+	// on the fast path; PAL's 3.2 (3, 3, 3, 3, 4) takes a separate step.
+	void set_region(Region region);
+	[[nodiscard]] Region get_region() const noexcept {
+		return timing_->region;
+	}
+
+	// Cycle profiling (off by default). While enabled every CPU cycle is
+	// timed per component, which slows emulation noticeably — use only for
+	// relative splits, never for absolute throughput numbers.
+	void set_cycle_profiling(bool enabled) noexcept {
+		cycle_profiling_ = enabled;
+		slow_cycle_path_ = cycle_profiling_ || fractional_dots_;
+	}
+	[[nodiscard]] bool is_cycle_profiling() const noexcept {
+		return cycle_profiling_;
+	}
+	[[nodiscard]] const CycleProfile &get_cycle_profile() const noexcept {
+		return cycle_profile_;
+	}
+	void reset_cycle_profile() noexcept {
+		cycle_profile_ = CycleProfile{};
+	}
+
+	// CPU traffic by region since the last reset_bus_stats(); all zero unless
+	// built with VIBENES_BUS_STATS (see BusStats)
+	[[nodiscard]] const BusStats &get_bus_stats() const noexcept {
+		return bus_stats_;
+	}
+	void reset_bus_stats() noexcept {
+		bus_stats_ = BusStats{};
+	}
 
 	// DMA interface
 	[[nodiscard]] bool is_dma_active() const noexcept;
@@ -58,18 +233,48 @@ class SystemBus final : public Component {
 	[[nodiscard]] Byte get_oam_dma_page() const noexcept;
 	void clear_oam_dma_pending() noexcept;
 	void write_oam_direct(uint8_t offset, uint8_t value);
+	// OAM DMA in one copy: the whole source page into OAM from OAMADDR on,
+	// when reading it has no side effects (work RAM, or PRG behind the
+	// mapper's page table, with no watchpoint or code/data logger) and the
+	// PPU will not look at OAM for the next `dots` dots. Otherwise false and
+	// nothing is written; the transfer then goes byte by byte.
+	[[nodiscard]] bool copy_page_to_oam(Byte page, uint32_t dots);
 
-	// DMC DMA cycle stealing interface
-	[[nodiscard]] bool is_dmc_dma_pending() const noexcept;
+	// DMC DMA cycle stealing interface (polled by the CPU every cycle; the
+	// APU's request is sampled whenever its event comes due)
+	[[nodiscard]] bool is_dmc_dma_pending() const noexcept {
+		return dmc_dma_pending_;
+	}
 	void service_dmc_dma();
+	// Whether the next CPU cycle is an APU "get" cycle, the only kind a DMA
+	// read can happen on
+	[[nodiscard]] bool is_dma_get_cycle() const noexcept;
 
 	// Audio control
+	// The bus owns the output device but never creates one itself, so the core
+	// stays device-agnostic.  Without an output the APU runs silently.
+	void connect_audio_output(std::unique_ptr<AudioOutput> audio_output);
+	[[nodiscard]] AudioOutput *get_audio_output() const noexcept {
+		return audio_output_.get();
+	}
 	bool initialize_audio(int sample_rate = 44100, int buffer_size = 1024);
 	void start_audio();
 	void stop_audio();
 	void set_audio_volume(float volume);
 	[[nodiscard]] float get_audio_volume() const;
 	[[nodiscard]] bool is_audio_playing() const;
+	// Emulate without queueing samples (run-ahead frames), see APU::set_output_gated()
+	void set_audio_gated(bool gated);
+	// Off while audio demand paces emulation, see APU::set_rate_control()
+	void set_audio_rate_control(bool enabled);
+	// Record the APU's output while audio is enabled (nullptr stops), see APU::set_recorder()
+	void set_audio_recorder(AudioRecorder *recorder);
+	[[nodiscard]] int get_audio_sample_rate() const;
+	// The cartridge's sound chip, if it has one (nullptr otherwise), and its
+	// level in the mix, see APU::set_expansion_gain()
+	[[nodiscard]] const char *get_expansion_audio_name() const;
+	void set_expansion_audio_gain(float gain);
+	[[nodiscard]] float get_expansion_audio_gain() const;
 
 	// Save state serialization
 	void serialize_state(std::vector<uint8_t> &buffer) const;
@@ -90,14 +295,94 @@ class SystemBus final : public Component {
 	APU *apu_raw_ = nullptr;
 	Cartridge *cartridge_raw_ = nullptr;
 	CPU6502 *cpu_raw_ = nullptr;
+	Byte *ram_memory_ = nullptr; // Ram storage, for read_low_ram()/write_low_ram()
 
 	// Last combined IRQ level pushed to the CPU (-1 = unknown, force sync).
 	// CPU line calls happen only on transitions instead of every cycle.
 	mutable int8_t last_irq_line_ = -1;
 	void update_irq_line();
 
-	// Audio backend
-	std::unique_ptr<AudioBackend> audio_backend_;
+	// Master clock (advances 12 per CPU cycle) and the deadlines posted on it
+	uint64_t master_clock_ = 0;
+	mutable EventScheduler scheduler_;
+	bool dmc_dma_pending_ = false; // APU DMC DMA request as of the last Apu event
+	void service_events();
+	// An access the CPU just made may have changed a source's next deadline
+	void reschedule(ScheduledEvent event) const noexcept {
+		scheduler_.schedule(event, master_clock_);
+	}
+
+	void configure_apu_sample_rate();
+
+	// Mapper CPU-cycle IRQ counter: run in spans at its posted deadline and
+	// before accesses instead of being notified every cycle. It has been run
+	// through mapper_timer_clock_; a new cartridge load id starts it afresh.
+	mutable uint64_t mapper_timer_clock_ = 0;
+	mutable uint32_t mapper_timer_load_id_ = 0;
+	void sync_mapper_timer() const;
+
+	// Catch-up state: dots owed to the PPU. The next forced sync is the
+	// PpuSync deadline, posted by each flush.
+	bool ppu_catch_up_ = false;
+	mutable uint32_t ppu_owed_dots_ = 0;
+	PpuWriteLog *ppu_log_ = nullptr;
+	void flush_owed_ppu_dots() const;
+	// Bring the PPU current before the CPU observes or changes its state. The
+	// access may move the next sync point and toggle A12 for the mapper.
+	void catch_up_ppu() const {
+		if (ppu_catch_up_) {
+			flush_owed_ppu_dots();
+			reschedule(ScheduledEvent::PpuSync);
+		}
+		reschedule(ScheduledEvent::MapperIrq);
+	}
+
+	// Region profile. A fractional CPU:PPU ratio runs PPU dot counts off the
+	// master clock, D(c) = c * 16 / 5 dots by the end of CPU cycle c.
+	const RegionTiming *timing_ = &NTSC_TIMING;
+	bool fractional_dots_ = false;
+	[[nodiscard]] uint32_t dots_for_cycles(uint64_t cycles) const noexcept {
+		if (!fractional_dots_) [[likely]] {
+			return static_cast<uint32_t>(cycles * 3);
+		}
+		const uint64_t cycle = master_clock_ / EventScheduler::CLOCKS_PER_CPU_CYCLE;
+		return static_cast<uint32_t>(timing_->dots_through(cycle + cycles) - timing_->dots_through(cycle));
+	}
+	// Master clocks until the CPU cycle that runs `dots` more dots
+	[[nodiscard]] uint64_t dots_to_clocks(uint64_t dots) const noexcept {
+		if (!fractional_dots_) [[likely]] {
+			return dots * EventScheduler::CLOCKS_PER_PPU_DOT;
+		}
+		const uint64_t num = timing_->dots_numerator();
+		const uint64_t den = timing_->dots_denominator();
+		return (dots * den + num - 1) / num * EventScheduler::CLOCKS_PER_CPU_CYCLE;
+	}
+	// CPU cycles that are sure to run no more than `dots` dots
+	[[nodiscard]] uint32_t cycles_within_dots(uint32_t dots) const noexcept {
+		if (!fractional_dots_) [[likely]] {
+			return dots / 3;
+		}
+		return static_cast<uint32_t>(static_cast<uint64_t>(dots) * timing_->dots_denominator() /
+									 timing_->dots_numerator());
+	}
+
+	// fractional_dots_ or cycle_profiling_: the per-cycle tick leaves the
+	// fixed 3-dot path on one predicted branch
+	bool slow_cycle_path_ = false;
+	bool cycle_profiling_ = false;
+	CycleProfile cycle_profile_;
+	mutable BusStats bus_stats_; // Counted from the const read paths
+	void tick_single_cpu_cycle_profiled();
+	void tick_single_cpu_cycle_fractional();
+
+	// Audio output (optional; supplied by the front end)
+	std::unique_ptr<AudioOutput> audio_output_;
+
+	// Watchpoint checks happen inside const reads, hence mutable
+	mutable Breakpoints breakpoints_;
+	[[nodiscard]] Byte decode_read(Address address) const;
+	[[nodiscard]] Byte read_watched(Address address) const;
+	void note_watched_write(Address address, Byte value);
 
 	// Address decoding helpers
 	[[nodiscard]] bool is_ram_address(Address address) const noexcept;
@@ -107,16 +392,19 @@ class SystemBus final : public Component {
 	[[nodiscard]] bool is_controller_address(Address address) const noexcept;
 	[[nodiscard]] bool is_cartridge_address(Address address) const noexcept;
 
+	// $4020-$FFFF reads that can't use the cartridge PRG page table
+	// (expansion/SRAM, mappers without a table, test high-memory mirrors)
+	[[nodiscard]] Byte read_cartridge_space(Address address) const;
+
+	// read() with the PRG access recorded under the given CodeDataLogger flags
+	// while the cartridge has the logger on
+	[[nodiscard]] Byte read_as(Address address, Byte cdl_flags) const;
+
 	// DMA implementation
 	void perform_oam_dma(Byte page);
 	bool oam_dma_pending_ = false;
 	Byte oam_dma_page_ = 0;
 
-	// Test memory for high addresses (temporary solution for testing)
-	// TODO: Replace with proper cartridge ROM when implemented
-	mutable std::array<Byte, 0x8000> test_high_memory_{};
-	mutable std::array<bool, 0x8000> test_high_memory_valid_{};
-
 	// Open bus simulation
 	mutable Byte last_bus_value_ = 0xFF;
 };
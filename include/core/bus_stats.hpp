@@ -0,0 +1,146 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace nes {
+
+/**
+ * BusStats - CPU bus traffic by address region
+ *
+ * In builds configured with -DVIBENES_BUS_STATS=ON the bus counts every CPU
+ * read and write (instruction fetches, DMA and the zero-page fast path
+ * included; debugger peeks excluded) into the region it decodes to. The
+ * fast-path fields say how much of that traffic skipped the decode: the
+ * $0000-$01FF RAM path and PRG-ROM reads served straight from the mapper's
+ * page table. Otherwise VIBENES_BUS_STAT() compiles to nothing and every
+ * count stays 0. The types are always built so front ends can show them
+ * unconditionally; ENABLED tells whether they will ever move.
+ */
+struct BusStats {
+#ifdef VIBENES_BUS_STATS
+	static constexpr bool ENABLED = true;
+#else
+	static constexpr bool ENABLED = false;
+#endif
+
+	enum class Region : std::uint8_t {
+		Ram,		  // $0000-$1FFF
+		PpuRegisters, // $2000-$3FFF
+		Apu,		  // $4000-$4015 and $4017 writes (OAM DMA included)
+		Controllers,  // $4016, and $4017 reads
+		Expansion,	  // $4018-$5FFF: test mode and mapper registers
+		PrgRam,		  // $6000-$7FFF
+		PrgRom,		  // $8000-$FFFF (mapper registers on write)
+	};
+	static constexpr std::size_t REGION_COUNT = 7;
+
+	std::array<std::uint64_t, REGION_COUNT> reads{};
+	std::array<std::uint64_t, REGION_COUNT> writes{};
+	std::uint64_t low_ram_reads = 0;  // Of the RAM reads: through read_low_ram()
+	std::uint64_t low_ram_writes = 0; // Of the RAM writes: through write_low_ram()
+	std::uint64_t prg_page_reads = 0; // Of the PRG-ROM reads: from the mapper's page table
+
+	[[nodiscard]] static constexpr Region region_of(Address address, bool write) noexcept {
+		if (address < 0x2000) {
+			return Region::Ram;
+		}
+		if (address < 0x4000) {
+			return Region::PpuRegisters;
+		}
+		if (address <= 0x4015 || (address == 0x4017 && write)) {
+			return Region::Apu;
+		}
+		if (address <= 0x4017) {
+			return Region::Controllers;
+		}
+		if (address < 0x6000) {
+			return Region::Expansion;
+		}
+		return address < 0x8000 ? Region::PrgRam : Region::PrgRom;
+	}
+
+	[[nodiscard]] static constexpr const char *region_name(Region region) noexcept {
+		switch (region) {
+		case Region::Ram:
+			return "RAM";
+		case Region::PpuRegisters:
+			return "PPU registers";
+		case Region::Apu:
+			return "APU";
+		case Region::Controllers:
+			return "Controllers";
+		case Region::Expansion:
+			return "Expansion";
+		case Region::PrgRam:
+			return "PRG-RAM";
+		case Region::PrgRom:
+			return "PRG-ROM";
+		}
+		return "?";
+	}
+
+	void count_read(Address address) noexcept {
+		++reads[static_cast<std::size_t>(region_of(address, false))];
+	}
+	void count_write(Address address) noexcept {
+		++writes[static_cast<std::size_t>(region_of(address, true))];
+	}
+
+	[[nodiscard]] std::uint64_t reads_in(Region region) const noexcept {
+		return reads[static_cast<std::size_t>(region)];
+	}
+	[[nodiscard]] std::uint64_t writes_in(Region region) const noexcept {
+		return writes[static_cast<std::size_t>(region)];
+	}
+	[[nodiscard]] std::uint64_t total_reads() const noexcept {
+		std::uint64_t total = 0;
+		for (const std::uint64_t count : reads) {
+			total += count;
+		}
+		return total;
+	}
+	[[nodiscard]] std::uint64_t total_writes() const noexcept {
+		std::uint64_t total = 0;
+		for (const std::uint64_t count : writes) {
+			total += count;
+		}
+		return total;
+	}
+};
+
+/**
+ * PpuFetchStats - PPU memory fetches, counted like BusStats
+ *
+ * Nametable covers attribute bytes too. Pattern counts bytes read through
+ * the cartridge; pattern_cached counts the bytes the batched scanline path
+ * took from the mapper's CHR tile cache instead. Palette counts lookups: one
+ * per composed pixel plus PPUDATA reads, with palette_rebuilds the times the
+ * folded palette table had to be rebuilt after a palette or mask change.
+ */
+struct PpuFetchStats {
+	std::uint64_t nametable = 0;
+	std::uint64_t pattern = 0;
+	std::uint64_t pattern_cached = 0;
+	std::uint64_t palette = 0;
+	std::uint64_t palette_rebuilds = 0;
+
+	PpuFetchStats &operator+=(const PpuFetchStats &other) noexcept {
+		nametable += other.nametable;
+		pattern += other.pattern;
+		pattern_cached += other.pattern_cached;
+		palette += other.palette;
+		palette_rebuilds += other.palette_rebuilds;
+		return *this;
+	}
+};
+
+} // namespace nes
+
+#ifdef VIBENES_BUS_STATS
+#define VIBENES_BUS_STAT(statement) statement
+#else
+#define VIBENES_BUS_STAT(statement) static_cast<void>(0)
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nes {
+
+/**
+ * CRC-32 (IEEE 802.3, the one zip and the ROM databases use)
+ *
+ * Chain calls over consecutive pieces by passing the previous result as crc:
+ * crc32(b, nb, crc32(a, na)) == crc32 of a followed by b.
+ */
+[[nodiscard]] std::uint32_t crc32(const std::uint8_t *data, std::size_t length, std::uint32_t crc = 0);
+
+/**
+ * XXH64 (xxHash, 64-bit): a fast non-cryptographic hash for comparing
+ * large buffers, such as every frame of a regression run. Four independent
+ * accumulator lanes keep the multipliers busy; output matches the reference
+ * implementation on little-endian hosts.
+ */
+[[nodiscard]] std::uint64_t xxhash64(const void *data, std::size_t length, std::uint64_t seed = 0);
+
+/**
+ * Sha1 - Incremental SHA-1, for matching ROMs against No-Intro style databases
+ */
+class Sha1 {
+  public:
+	using Digest = std::array<std::uint8_t, 20>;
+
+	void update(const std::uint8_t *data, std::size_t length);
+	// Pad and return the digest; the object starts over afterwards
+	[[nodiscard]] Digest finish();
+
+	// Lower-case hex, as the databases list it
+	[[nodiscard]] static std::string to_hex(const Digest &digest);
+
+  private:
+	std::array<std::uint32_t, 5> state_ = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+	std::array<std::uint8_t, 64> block_{};
+	std::size_t block_size_ = 0;
+	std::uint64_t length_ = 0; // Bytes hashed
+
+	void process_block(const std::uint8_t *block);
+};
+
+} // namespace nes
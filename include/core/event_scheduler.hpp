@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace nes {
+
+/// Sources that post deadlines on the bus's master-clock timeline
+enum class ScheduledEvent : std::uint8_t {
+	PpuSync,   ///< Catch-up PPU must run: VBlank/NMI, frame end, MMC3 A12 IRQ
+	Apu,	   ///< APU frame IRQ, DMC DMA request or DMC IRQ may change
+	MapperIrq, ///< Mapper IRQ line may change (lockstep PPU A12 edges, writes)
+	MapperTimer, ///< Mapper CPU-cycle IRQ counter (VRC, FME-7) reaches its IRQ
+	Count
+};
+
+/**
+ * EventScheduler - Fixed-slot deadline table on a 64-bit master-clock timeline
+ *
+ * Each source owns one slot holding the earliest master clock at which its
+ * state may change (NEVER if it cannot without a CPU access). The bus only
+ * compares its clock against next_event() each cycle and services the due
+ * slots when it is reached; everything in between runs without polling.
+ *
+ * Deadlines must never be late — posting one early only costs a spurious
+ * service. Anything that can move a deadline outside the owner's own
+ * schedule (register writes, save-state loads) posts "now" to have it
+ * recomputed on the next cycle.
+ */
+class EventScheduler {
+  public:
+	static constexpr std::uint64_t NEVER = std::numeric_limits<std::uint64_t>::max();
+
+	/// Master clocks per CPU cycle and per PPU dot (NTSC: 21.477 MHz / 12, / 4)
+	static constexpr std::uint64_t CLOCKS_PER_CPU_CYCLE = MASTER_CLOCK_NTSC / CPU_CLOCK_NTSC;
+	static constexpr std::uint64_t CLOCKS_PER_PPU_DOT = MASTER_CLOCK_NTSC / PPU_CLOCK_NTSC;
+
+	/// Post (or move) a source's deadline
+	void schedule(ScheduledEvent event, std::uint64_t clock) noexcept {
+		const auto slot = static_cast<std::size_t>(event);
+		const std::uint64_t previous = deadlines_[slot];
+		deadlines_[slot] = clock;
+		if (clock <= next_) {
+			next_ = clock;
+		} else if (previous == next_) {
+			// The earliest deadline moved later; another slot may lead now
+			next_ = *std::min_element(deadlines_.begin(), deadlines_.end());
+		}
+	}
+
+	/// Drop a source's deadline
+	void cancel(ScheduledEvent event) noexcept {
+		schedule(event, NEVER);
+	}
+
+	/// Make every source due at `clock` (reset, state load, reconnection)
+	void schedule_all(std::uint64_t clock) noexcept {
+		deadlines_.fill(clock);
+		next_ = clock;
+	}
+
+	[[nodiscard]] std::uint64_t next_event() const noexcept {
+		return next_;
+	}
+	[[nodiscard]] std::uint64_t deadline(ScheduledEvent event) const noexcept {
+		return deadlines_[static_cast<std::size_t>(event)];
+	}
+	[[nodiscard]] bool is_due(ScheduledEvent event, std::uint64_t clock) const noexcept {
+		return deadlines_[static_cast<std::size_t>(event)] <= clock;
+	}
+
+  private:
+	std::array<std::uint64_t, static_cast<std::size_t>(ScheduledEvent::Count)> deadlines_{};
+	std::uint64_t next_ = 0;
+};
+
+} // namespace nes
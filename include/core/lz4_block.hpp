@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nes {
+
+// LZ4 block format (the raw blocks inside .lz4 frames): a fast byte-oriented
+// LZ77 whose output any LZ4 block decoder reads. Used for save-state sections,
+// which are mostly zeroed RAM and repeated tiles.
+
+// Largest output lz4_compress() can produce for size input bytes
+[[nodiscard]] constexpr std::size_t lz4_compress_bound(std::size_t size) {
+	return size + size / 255 + 16;
+}
+
+// Most bytes a block of block_size bytes can decode to: every match adds at
+// most 255 bytes per length byte, so a larger claimed size is a damaged block
+[[nodiscard]] constexpr std::size_t lz4_decompress_bound(std::size_t block_size) {
+	return block_size * 255 + 16;
+}
+
+// Append the compressed form of data to out
+void lz4_compress(const std::uint8_t *data, std::size_t size, std::vector<std::uint8_t> &out);
+
+/**
+ * Decompress a whole block into out
+ * @return false unless the block is well formed and decodes to exactly
+ *         out_size bytes (never reads or writes out of bounds)
+ */
+[[nodiscard]] bool lz4_decompress(const std::uint8_t *block, std::size_t block_size, std::uint8_t *out,
+								  std::size_t out_size);
+
+} // namespace nes
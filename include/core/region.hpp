@@ -0,0 +1,132 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <array>
+#include <cstdint>
+#include <numeric>
+
+namespace nes {
+
+/// Console timing region, selected per ROM (NES 2.0 timing field)
+enum class Region : std::uint8_t { Ntsc, Pal, Dendy };
+
+/**
+ * RegionTiming - Compile-time clock and table profile of one region
+ *
+ * NTSC: 21.477 MHz master / 12 CPU, / 4 PPU, 262 lines, odd-frame dot skip.
+ * PAL: 26.602 MHz / 16 CPU, / 5 PPU (3.2 dots per CPU cycle), 312 lines,
+ *   no skip, longer APU frame steps and its own noise/DMC periods.
+ * Dendy: 26.602 MHz / 15 CPU, / 5 PPU (3 dots per CPU cycle), 312 lines
+ *   with VBlank held back to line 291, NTSC frame counter, PAL periods.
+ *
+ * The bus instantiates its per-cycle step per profile; the PPU and APU copy
+ * what they need when the region changes.
+ */
+struct RegionTiming {
+	Region region;
+	std::uint64_t master_clock_hz;
+	std::uint32_t cpu_divider; // Master clocks per CPU cycle
+	std::uint32_t ppu_divider; // Master clocks per PPU dot
+
+	std::uint16_t scanlines_per_frame;
+	std::uint16_t vblank_start_scanline; // VBlank sets on dot 1 of this line
+	bool odd_frame_skip;				 // Odd rendering frames drop pre-render dot 339
+
+	// APU frame counter step lengths in CPU cycles (the last one of each
+	// sequence two short, as the frame counter counts them), noise timer
+	// periods and DMC rates
+	std::array<std::uint16_t, 4> frame_steps_4;
+	std::array<std::uint16_t, 5> frame_steps_5;
+	std::array<std::uint16_t, 16> noise_periods;
+	std::array<std::uint16_t, 16> dmc_rates;
+
+	[[nodiscard]] constexpr std::uint64_t cpu_clock_hz() const noexcept {
+		return master_clock_hz / cpu_divider;
+	}
+	[[nodiscard]] constexpr std::uint16_t pre_render_scanline() const noexcept {
+		return static_cast<std::uint16_t>(scanlines_per_frame - 1);
+	}
+
+	// PPU dots per CPU cycle as a reduced fraction: 3/1, or 16/5 on PAL
+	[[nodiscard]] constexpr std::uint32_t dots_numerator() const noexcept {
+		return cpu_divider / std::gcd(cpu_divider, ppu_divider);
+	}
+	[[nodiscard]] constexpr std::uint32_t dots_denominator() const noexcept {
+		return ppu_divider / std::gcd(cpu_divider, ppu_divider);
+	}
+	// PPU dots run by the end of CPU cycle `cycle`, counted from cycle 0
+	[[nodiscard]] constexpr std::uint64_t dots_through(std::uint64_t cycle) const noexcept {
+		return cycle * dots_numerator() / dots_denominator();
+	}
+
+	// CPU cycles per frame with rendering off, rounded down (29780 on NTSC)
+	[[nodiscard]] constexpr std::uint32_t cpu_cycles_per_frame() const noexcept {
+		return static_cast<std::uint32_t>(341u * scanlines_per_frame * dots_denominator() / dots_numerator());
+	}
+	[[nodiscard]] constexpr double frames_per_second() const noexcept {
+		return static_cast<double>(master_clock_hz) / ppu_divider / (341.0 * scanlines_per_frame);
+	}
+};
+
+inline constexpr std::array<std::uint16_t, 16> NTSC_NOISE_PERIODS = {4,	  8,   16,	32,	 64,  96,	128,  160,
+																	 202, 254, 380, 508, 762, 1016, 2034, 4068};
+inline constexpr std::array<std::uint16_t, 16> PAL_NOISE_PERIODS = {4,	 8,	  14,  30,	60,	 88,  118,	148,
+																	188, 236, 354, 472, 708, 944, 1890, 3778};
+inline constexpr std::array<std::uint16_t, 16> NTSC_DMC_RATES = {428, 380, 340, 320, 286, 254, 226, 214,
+																 190, 160, 142, 128, 106, 84,  72,	54};
+inline constexpr std::array<std::uint16_t, 16> PAL_DMC_RATES = {398, 354, 316, 298, 276, 236, 210, 198,
+																176, 148, 132, 118, 98,	 78,  66,  50};
+
+inline constexpr RegionTiming NTSC_TIMING{Region::Ntsc,
+										  MASTER_CLOCK_NTSC,
+										  12,
+										  4,
+										  262,
+										  241,
+										  true,
+										  {7457, 7456, 7458, 7457},
+										  {7457, 7456, 7458, 7457, 7452},
+										  NTSC_NOISE_PERIODS,
+										  NTSC_DMC_RATES};
+
+inline constexpr RegionTiming PAL_TIMING{Region::Pal,
+										 26'601'712,
+										 16,
+										 5,
+										 312,
+										 241,
+										 false,
+										 {8313, 8314, 8312, 8313},
+										 {8313, 8314, 8312, 8313, 8312},
+										 PAL_NOISE_PERIODS,
+										 PAL_DMC_RATES};
+
+inline constexpr RegionTiming DENDY_TIMING{Region::Dendy,
+										   26'601'712,
+										   15,
+										   5,
+										   312,
+										   291,
+										   false,
+										   {7457, 7456, 7458, 7457},
+										   {7457, 7456, 7458, 7457, 7452},
+										   PAL_NOISE_PERIODS,
+										   PAL_DMC_RATES};
+
+[[nodiscard]] constexpr const RegionTiming &region_timing(Region region) noexcept {
+	switch (region) {
+	case Region::Pal:
+		return PAL_TIMING;
+	case Region::Dendy:
+		return DENDY_TIMING;
+	default:
+		return NTSC_TIMING;
+	}
+}
+
+static_assert(NTSC_TIMING.cpu_clock_hz() == CPU_CLOCK_NTSC);
+static_assert(NTSC_TIMING.dots_numerator() == 3 && NTSC_TIMING.dots_denominator() == 1);
+static_assert(PAL_TIMING.dots_numerator() == 16 && PAL_TIMING.dots_denominator() == 5);
+static_assert(DENDY_TIMING.dots_numerator() == 3 && DENDY_TIMING.dots_denominator() == 1);
+
+} // namespace nes
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace nes {
+
+/**
+ * Runtime SIMD dispatch
+ *
+ * The CPU's vector extensions are detected once, at first use, and the
+ * kernels below are bound to the widest variant both the CPU and the build
+ * support. The kernel variants are compiled with per-function target
+ * attributes, so one portable binary (baseline x86-64 or AArch64 flags)
+ * still runs AVX2/AVX-512 code on hardware that has it.
+ *
+ * set_simd_level() narrows the choice for benchmarking (VibeNES_Headless,
+ * VibeNES_Bench and VibeNES_MicroBench take --simd LEVEL); call it before
+ * emulation starts. Every level gives bit-identical emulation output; only
+ * the scalar resampler adds its taps in a different order, so audio can
+ * differ from the vector levels in the last float bit.
+ */
+enum class SimdLevel : std::uint8_t {
+	Scalar,
+	SSE2,
+	SSE42,
+	AVX2,
+	AVX512, // F + BW
+	NEON,
+};
+
+struct CpuFeatures {
+	bool sse2 = false;
+	bool sse42 = false;
+	bool avx2 = false;	 // With OS support for the YMM state
+	bool avx512 = false; // F and BW, with OS support for the ZMM state
+	bool neon = false;
+};
+
+[[nodiscard]] const CpuFeatures &cpu_features() noexcept;
+[[nodiscard]] bool is_simd_level_supported(SimdLevel level) noexcept;
+// The widest supported level: what dispatch picks unless told otherwise
+[[nodiscard]] SimdLevel best_simd_level() noexcept;
+[[nodiscard]] SimdLevel simd_level() noexcept;
+// Rebind the kernels to `level`; false (and no change) if unsupported
+bool set_simd_level(SimdLevel level) noexcept;
+
+[[nodiscard]] const char *simd_level_name(SimdLevel level) noexcept;
+// "scalar", "sse2", "sse4.2", "avx2", "avx512", "neon", or "auto" for the best
+[[nodiscard]] std::optional<SimdLevel> parse_simd_level(std::string_view name) noexcept;
+
+/**
+ * The dispatched kernels. A level without its own variant of a kernel uses
+ * the next narrower one.
+ */
+struct SimdKernels {
+	// out[i] = lut[indices[i] & 0x1FF]; the PPU's index-to-RGBA resolve
+	void (*palette_lookup)(const std::uint16_t *indices, const std::uint32_t *lut, std::uint32_t *out,
+						   std::size_t count) noexcept;
+	// Bit n set when sprite n (Y at y_positions[n], 64 of them) covers the
+	// line after `line`: y <= line && line - y < height
+	std::uint64_t (*sprites_in_range)(const std::uint8_t *y_positions, std::uint8_t line,
+									  std::uint8_t height) noexcept;
+	// The PPU's background/sprite multiplexer over count pixels. bg[i] is a
+	// background pixel (0 transparent); sprite[i] a sprite pixel in bits 0-4
+	// (0 transparent), bit 5 set if it goes behind the background, bit 6 on
+	// sprite 0. out[i] gets the sprite's bits 0-4 where it is opaque and
+	// either in front or over a transparent background, else bg[i]. Returns
+	// the first i where opaque sprite 0 meets opaque background, or count.
+	std::size_t (*multiplex_pixels)(const std::uint8_t *bg, const std::uint8_t *sprite, std::uint8_t *out,
+									std::size_t count) noexcept;
+	// Sum of a[i] * b[i]; count is a multiple of 8
+	float (*dot_product)(const float *a, const float *b, std::size_t count) noexcept;
+};
+
+[[nodiscard]] const SimdKernels &simd_kernels() noexcept;
+
+} // namespace nes
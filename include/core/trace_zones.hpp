@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+
+namespace nes {
+
+/**
+ * TraceZones - Captures scoped timing zones as a Chrome trace_event file
+ *
+ * VIBENES_TRACE_ZONE("name") times the rest of the enclosing scope. In builds
+ * configured with -DVIBENES_TRACE_ZONES=ON every zone that starts while a
+ * capture is running becomes one complete ("X") event on its thread's
+ * track; otherwise the macro expands to nothing. write_json() produces the
+ * JSON Object Format that chrome://tracing, Perfetto and Speedscope open.
+ *
+ * Each thread records into its own buffer (an uncontended lock per event),
+ * and events stay in memory until the next start(). Zone names must be
+ * string literals: only the pointer is kept. A capture holds at most
+ * MAX_EVENTS events; later ones are counted as dropped.
+ *
+ * The writer is always built so the front ends can offer captures
+ * unconditionally; without the zones compiled in they are simply empty.
+ */
+class TraceZones {
+  public:
+	static constexpr std::size_t MAX_EVENTS = std::size_t{1} << 22; // ~100 MB
+
+	/// Begin a capture, discarding the previous one
+	static void start();
+	/// Stop recording; the capture stays available to write_json()
+	static void stop();
+	[[nodiscard]] static bool is_recording() noexcept {
+		return recording_.load(std::memory_order_relaxed);
+	}
+
+	/// Label the calling thread's track (once per thread, before or during a capture)
+	static void set_thread_name(const char *name);
+
+	/// Write the stopped capture. Returns false if the stream failed.
+	static bool write_json(std::ostream &out);
+	static bool save(const std::filesystem::path &path);
+
+	[[nodiscard]] static std::size_t event_count() noexcept {
+		return events_.load(std::memory_order_relaxed);
+	}
+	[[nodiscard]] static std::uint64_t dropped_events() noexcept {
+		return dropped_.load(std::memory_order_relaxed);
+	}
+
+	// TraceZone's side: the clock, and one finished zone
+	[[nodiscard]] static std::int64_t now_ns() noexcept;
+	static void record(const char *name, std::int64_t begin_ns, std::int64_t end_ns) noexcept;
+
+  private:
+	static std::atomic<bool> recording_;
+	static std::atomic<std::size_t> events_;
+	static std::atomic<std::uint64_t> dropped_;
+};
+
+/// One zone: records from construction to destruction if a capture was running when it began
+class TraceZone {
+  public:
+	explicit TraceZone(const char *name) noexcept
+		: name_(TraceZones::is_recording() ? name : nullptr), begin_ns_(name_ ? TraceZones::now_ns() : 0) {
+	}
+	~TraceZone() {
+		if (name_) {
+			TraceZones::record(name_, begin_ns_, TraceZones::now_ns());
+		}
+	}
+	TraceZone(const TraceZone &) = delete;
+	TraceZone &operator=(const TraceZone &) = delete;
+
+  private:
+	const char *name_;
+	std::int64_t begin_ns_;
+};
+
+} // namespace nes
+
+#ifdef VIBENES_TRACE_ZONES
+#define VIBENES_TRACE_ZONE_JOIN_(a, b) a##b
+#define VIBENES_TRACE_ZONE_JOIN(a, b) VIBENES_TRACE_ZONE_JOIN_(a, b)
+#define VIBENES_TRACE_ZONE(name) const ::nes::TraceZone VIBENES_TRACE_ZONE_JOIN(trace_zone_, __LINE__)(name)
+#else
+#define VIBENES_TRACE_ZONE(name) static_cast<void>(0)
+#endif
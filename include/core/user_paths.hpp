@@ -125,6 +125,27 @@ inline std::filesystem::path get_battery_directory() {
 	return get_saves_directory() / "battery";
 }
 
+// ROM library index (see RomLibrary), kept beside the saves directory:
+//   Portable : <exe_dir>/rom_library.vnidx
+//   Installed: SDL_GetPrefPath("VibeNES","VibeNES")/rom_library.vnidx
+inline std::filesystem::path get_rom_library_index_path() {
+	return get_saves_directory().parent_path() / "rom_library.vnidx";
+}
+
+// Compiled GUI shader programs (see CRTFilter::set_program_cache_directory):
+//   Portable : <exe_dir>/shader_cache
+//   Installed: SDL_GetPrefPath("VibeNES","VibeNES")/shader_cache
+inline std::filesystem::path get_shader_cache_directory() {
+	return get_saves_directory().parent_path() / "shader_cache";
+}
+
+// Screenshots and frame recordings (File > Screenshot / Record Frames):
+//   Portable : <exe_dir>/captures
+//   Installed: SDL_GetPrefPath("VibeNES","VibeNES")/captures
+inline std::filesystem::path get_captures_directory() {
+	return get_saves_directory().parent_path() / "captures";
+}
+
 inline bool copy_directory_tree(const std::filesystem::path &source, const std::filesystem::path &destination) {
 	if (!std::filesystem::exists(source) || !std::filesystem::is_directory(source)) {
 		return true;
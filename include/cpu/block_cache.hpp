@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * CpuBlockCache - Hot straight-line PRG ROM code, decoded once
+ *
+ * The CPU's block tier (CPU6502::set_block_execution()). A block is a run of
+ * instructions that touch nothing but registers, flags and zero page:
+ * implied and immediate operations, zero-page loads, stores, ALU and
+ * read-modify-write operations, optionally closed by a conditional branch.
+ * None of them can reach a register with side effects, switch a bank or
+ * change the interrupt disable flag, so the CPU can run a whole block and
+ * then advance the bus once by its cycle count, as long as no scheduled
+ * event falls inside it.
+ *
+ * Blocks start where a jump or taken branch lands and are compiled the
+ * HOT_THRESHOLD-th time execution arrives there. They are keyed by PRG ROM
+ * offset, so every bank keeps its own blocks across bank switches; ROM
+ * cannot be written, so a block never goes stale. Code in RAM or PRG-RAM is
+ * never compiled.
+ */
+class CpuBlockCache {
+  public:
+	static constexpr std::size_t MAX_INSTRUCTIONS = 32;
+	static constexpr std::uint16_t HOT_THRESHOLD = 8;
+
+	struct Instruction {
+		Byte opcode;
+		Byte operand; // Immediate value, zero-page address or branch offset
+	};
+	struct Block {
+		std::uint32_t first = 0;	 // Index of the first instruction in code()
+		std::uint8_t count = 0;		 // Instructions, the branch included
+		std::uint8_t length = 0;	 // Bytes
+		std::uint16_t cycles = 0;	 // With the closing branch not taken
+		bool ends_in_branch = false; // A taken branch adds 1 cycle, 2 across a page
+	};
+
+	/// Whether opcode may appear in a block (conditional branches only last)
+	[[nodiscard]] static bool is_block_opcode(Byte opcode) noexcept;
+
+	/// Forget every block (new ROM loaded, reset)
+	void clear();
+
+	/**
+	 * The block starting offset bytes into rom, with code the bytes from there
+	 * to the end of its 8 KB page. Null while the location is cold, or if
+	 * fewer than two block instructions start there.
+	 */
+	[[nodiscard]] const Block *lookup(std::span<const Byte> rom, std::size_t offset, std::span<const Byte> code);
+
+	[[nodiscard]] const Instruction *code(const Block &block) const noexcept {
+		return code_.data() + block.first;
+	}
+
+  private:
+	static constexpr std::size_t SLOT_COUNT = 4096; // Direct mapped by ROM offset
+	static constexpr std::size_t MAX_CODE = 65536;	// Instructions kept before starting over
+	static constexpr std::int32_t COLD = -1;
+	static constexpr std::int32_t REJECTED = -2;
+
+	struct Slot {
+		std::uint32_t offset = ~std::uint32_t{0};
+		std::uint16_t hits = 0;
+		std::int32_t block = COLD; // Index into blocks_, COLD or REJECTED
+	};
+
+	const Byte *rom_ = nullptr;
+	std::size_t rom_size_ = 0;
+	std::array<Slot, SLOT_COUNT> slots_{};
+	std::vector<Block> blocks_;
+	std::vector<Instruction> code_;
+
+	[[nodiscard]] std::int32_t compile(std::span<const Byte> code);
+};
+
+} // namespace nes
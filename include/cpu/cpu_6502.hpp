@@ -1,8 +1,19 @@
 #pragma once
 
+#include "core/breakpoints.hpp"
 #include "core/component.hpp"
 #include "core/types.hpp"
+#include "cpu/block_cache.hpp"
 #include "cpu/interrupts.hpp"
+#ifdef VIBENES_CPU_PROFILER
+#include "cpu/cpu_profiler.hpp"
+#endif
+#ifdef VIBENES_CPU_TRACE
+#include "cpu/cpu_trace.hpp"
+#endif
+#include <array>
+#include <memory>
+#include <vector>
 
 namespace nes {
 
@@ -33,6 +44,40 @@ class CPU6502 final : public Component {
 	// CPU execution
 	[[nodiscard]] int execute_instruction(); // Returns number of cycles consumed
 
+	// Run loops: execute whole instructions until a stop condition, in place
+	// of a caller-side loop over execute_instruction(). Both stop before
+	// running an instruction at a breakpoint, except the first one, so a
+	// run can resume from the breakpoint it stopped at. Watchpoints (the
+	// bus's Breakpoints) stop them after the instruction that made the access.
+	enum class RunStop : std::uint8_t {
+		Target,		///< Cycle target or budget reached
+		FrameReady, ///< The PPU completed a frame (run_frame only)
+		Breakpoint, ///< The next instruction is at a breakpoint
+		Watchpoint, ///< The last instruction made a watched access
+		Halted,		///< An instruction consumed no cycles
+	};
+	struct RunResult {
+		std::uint64_t cycles = 0; ///< CPU cycles executed
+		RunStop stop = RunStop::Target;
+		BreakpointHit hit{}; ///< What stopped a Breakpoint or Watchpoint run
+	};
+	/// CPU cycles elapsed on the bus timeline (master clock / 12)
+	[[nodiscard]] std::uint64_t get_cycle_count() const noexcept;
+	/// Run until get_cycle_count() reaches target_cycle; the last instruction
+	/// may overshoot it
+	RunResult run_until(std::uint64_t target_cycle);
+	/// Run until the PPU completes its current frame, at most max_cycles
+	RunResult run_frame(std::uint64_t max_cycles);
+
+	// Breakpoints seen by run_until()/run_frame() (execute_instruction()
+	// ignores them)
+	void set_breakpoint(Address address);
+	void clear_breakpoint(Address address);
+	void clear_breakpoints();
+	[[nodiscard]] bool has_breakpoint(Address address) const noexcept {
+		return breakpoint_count_ != 0 && breakpoints_[address];
+	}
+
 	// Interrupt handling
 	void trigger_nmi() noexcept;	///< Trigger Non-Maskable Interrupt (PPU VBlank, etc.)
 	void clear_nmi_line() noexcept; ///< Clear NMI line (when VBlank flag is cleared by reading $2002)
@@ -141,6 +186,63 @@ class CPU6502 final : public Component {
 		cycles_remaining_ = CpuCycle{0};
 	}
 
+	// Idle-loop skipping (off by default). When the CPU closes a loop that
+	// only an interrupt or VBlank can end — JMP to itself, a branch to itself,
+	// or a RAM/PPUSTATUS poll (load, optional immediate compare, branch back)
+	// — whole iterations are skipped by advancing PPU, APU and mapper straight
+	// to the next such event. The result is cycle-identical to running the
+	// loop, but one execute_instruction() call may then return thousands of
+	// cycles.
+	void set_idle_loop_skipping(bool enabled) noexcept {
+		idle_loop_skipping_ = enabled;
+		idle_loop_armed_ = false;
+	}
+	[[nodiscard]] bool is_idle_loop_skipping() const noexcept {
+		return idle_loop_skipping_;
+	}
+	[[nodiscard]] std::uint64_t get_idle_cycles_skipped() const noexcept {
+		return idle_cycles_skipped_;
+	}
+
+	// Block execution (off by default). Straight-line PRG ROM code that only
+	// touches registers, flags and zero page, and that execution keeps
+	// arriving at, is decoded once into a CpuBlockCache block; from then on
+	// the whole block runs in one go and the bus is advanced once by its
+	// cycle count. Blocks only run when no event, interrupt or DMA can fall
+	// inside them and nothing observes single accesses (breakpoints,
+	// watchpoints, the Code/Data Logger, a tracer or profiler), so the result
+	// is cycle-identical to interpreting them.
+	void set_block_execution(bool enabled);
+	[[nodiscard]] bool is_block_execution() const noexcept {
+		return block_cache_ != nullptr;
+	}
+	[[nodiscard]] std::uint64_t get_block_instructions() const noexcept {
+		return block_instructions_;
+	}
+
+#ifdef VIBENES_CPU_PROFILER
+	// Execution profiler fed after every instruction, interrupt entry, DMA
+	// and idle-loop skip (not owned; nullptr detaches)
+	void set_profiler(CpuProfiler *profiler) noexcept {
+		profiler_ = profiler;
+	}
+	[[nodiscard]] CpuProfiler *get_profiler() const noexcept {
+		return profiler_;
+	}
+#endif
+
+#ifdef VIBENES_CPU_TRACE
+	// Trace writer fed one record before every instruction (not owned;
+	// nullptr detaches). Idle-loop skipping fast-forwards whole loop
+	// iterations without executing them: turn it off for complete traces.
+	void set_tracer(CpuTraceWriter *tracer) noexcept {
+		tracer_ = tracer;
+	}
+	[[nodiscard]] CpuTraceWriter *get_tracer() const noexcept {
+		return tracer_;
+	}
+#endif
+
 	// Save state serialization
 	void serialize_state(std::vector<uint8_t> &buffer) const;
 	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset);
@@ -174,6 +276,11 @@ class CPU6502 final : public Component {
 	// Cycle tracking
 	CpuCycle cycles_remaining_;
 	int cycles_consumed_ = 0; // Tracks cycles used by current instruction (for fat consume_cycle)
+	// VIBENES_CPU_BATCHED_CYCLES builds read the current instruction's length
+	// off the master clock instead (both members are always declared so the
+	// option, which only the core is compiled with, keeps the class layout)
+	std::uint64_t instruction_start_clock_ = 0;
+	bool in_oam_dma_ = false; // Inside execute_oam_dma (DMC fetches overlap it)
 
 	// Interrupt state
 	InterruptState interrupt_state_;
@@ -194,10 +301,54 @@ class CPU6502 final : public Component {
 	bool curr_irq_signal_ = false;	// IRQ line asserted AND I flag clear this cycle
 	bool prev_irq_signal_ = false;	// IRQ line asserted AND I flag clear previous cycle
 
+	// Idle-loop skipping. A JMP or taken branch that just completed an
+	// iteration of a recognised idle loop arms the loop head; the next
+	// execute_instruction() disarms it and, if it starts there, skips ahead.
+	bool idle_loop_skipping_ = false;
+	bool idle_loop_armed_ = false;
+	Address idle_loop_head_ = 0;
+	std::uint32_t idle_loop_cycles_ = 0;   // CPU cycles per iteration
+	bool idle_loop_polls_status_ = false; // Loop waits on PPUSTATUS bit 7
+	Address idle_loop_rejected_ = 0xFFFF; // Last branch found not to close an idle loop
+	bool idle_loop_interrupted_ = false;  // Interrupt taken since the last backward branch
+	std::uint64_t idle_cycles_skipped_ = 0;
+
+	// Block execution. A jump or taken branch marks its target as a block
+	// head candidate for the next execute_instruction()
+	std::unique_ptr<CpuBlockCache> block_cache_;
+	bool block_head_ = false;
+	std::uint64_t block_instructions_ = 0;
+
+	// Breakpoint flag per address, allocated by the first set_breakpoint()
+	std::vector<std::uint8_t> breakpoints_;
+	std::size_t breakpoint_count_ = 0;
+	template <bool StopAtFrameEnd> RunResult run_loop(std::uint64_t budget);
+
+#ifdef VIBENES_CPU_PROFILER
+	CpuProfiler *profiler_ = nullptr;
+#endif
+#ifdef VIBENES_CPU_TRACE
+	CpuTraceWriter *tracer_ = nullptr;
+	void trace_instruction();
+#endif
+
 	// Memory access methods
 	[[nodiscard]] Byte read_byte(Address address);
 	void write_byte(Address address, Byte value);
+	// Opcode and operand bytes at PC: read_byte timing, logged as code by the
+	// Code/Data Logger (see SystemBus::fetch). fetch_opcode() resolves the
+	// PRG page holding the instruction once (SystemBus::prg_fetch_page), and
+	// the instruction's fetches from that page index it directly instead of
+	// decoding each address on the bus
+	[[nodiscard]] Byte fetch_opcode();
+	[[nodiscard]] Byte fetch_byte(Address address);
+	const Byte *fetch_page_ = nullptr; // Null: fetch through the bus
+	Address fetch_page_base_ = 0;
 	[[nodiscard]] Address read_word(Address address); // Little-endian 16-bit read
+	// Zero page and stack ($0000-$01FF): same timing as read_byte/write_byte,
+	// without the bus address decode (see SystemBus::read_low_ram)
+	[[nodiscard]] Byte read_low_ram(Address address);
+	void write_low_ram(Address address, Byte value);
 
 	// Stack operations
 	void push_byte(Byte value);
@@ -219,20 +370,69 @@ class CPU6502 final : public Component {
 	// "Fat" consume_cycle: advances PPU (3 dots), APU (1 cycle), and checks
 	// mapper IRQs via bus_->tick_single_cpu_cycle() for per-cycle interleaving.
 	void consume_cycle();
+	// Internal (non-bus) cycles; VIBENES_CPU_BATCHED_CYCLES builds tick them
+	// in one step when no scheduled event falls inside them
 	void consume_cycles(int count);
+	// A write cycle: same, except DMC DMA cannot halt the CPU on it
+	void consume_write_cycle();
+	void advance_cycle();
+	// `count` cycles with no bus access or DMC stall in one step, if the bus
+	// can take them at once (SystemBus::try_tick_cpu_cycles); no sampling
+	[[nodiscard]] bool try_advance_cycles(int count);
+	// CPU cycles the current instruction has taken so far
+	[[nodiscard]] int instruction_cycles() const noexcept;
+	void sample_interrupt_lines() noexcept;
+	// DMC DMA stall: 3-4 cycles by get/put alignment, 2 inside OAM DMA
+	void stall_for_dmc_dma();
 
 	// Interrupt handling
 	void handle_nmi();	 ///< Handle Non-Maskable Interrupt
 	void handle_irq();	 ///< Handle Maskable Interrupt (IRQ/BRK)
 	void handle_reset(); ///< Handle Reset interrupt
 
+	// Idle-loop detection and fast-forward
+	void arm_idle_loop(Address head, std::uint32_t iteration_cycles, bool polls_status = false) noexcept;
+	void detect_poll_loop(Address branch_address, Address target, std::uint32_t branch_cycles);
+	bool skip_idle_loop();
+	bool run_block();
+
+	// Shared body of the eight conditional branches
+	void branch(bool condition);
+
 	// OAM DMA — CPU halts for 513-514 cycles while DMA controller
 	// reads from CPU bus and writes to PPU OAM.
 	int execute_oam_dma();
+	// The transfer cycles of a DMA whose bytes already went over in one copy
+	void run_copied_oam_dma(Address last_source);
+
+	// Opcode dispatch: OPCODE_TABLE[opcode] is the handler to run (generated
+	// from cpu/opcode_table.hpp; unused when built with VIBENES_CPU_COMPUTED_GOTO)
+	using OpcodeHandler = void (CPU6502::*)();
+	static const std::array<OpcodeHandler, 256> OPCODE_TABLE;
 
 	// Addressing mode helpers
 	[[nodiscard]] bool crosses_page_boundary(Address base_address, Byte offset) const noexcept;
 
+	// Addressing mode policies. Each fetches the operand bytes, spends the
+	// addressing cycles and returns the effective address; the handler then
+	// does its own final read, write or read-modify-write. IsWrite selects
+	// store/RMW timing for indexed modes (the indexing cycle is always taken)
+	// over read timing (taken only when the index crosses a page).
+	enum class IndexRegister : std::uint8_t { X, Y };
+	template <IndexRegister Reg>
+	[[nodiscard]] Byte index_register() const noexcept;
+	template <bool IsWrite>
+	[[nodiscard]] Address index_address(Address base_address, Byte offset);
+	[[nodiscard]] Address address_zero_page();
+	template <IndexRegister Reg>
+	[[nodiscard]] Address address_zero_page_indexed();
+	[[nodiscard]] Address address_absolute();
+	template <IndexRegister Reg, bool IsWrite>
+	[[nodiscard]] Address address_absolute_indexed();
+	[[nodiscard]] Address address_indexed_indirect();
+	template <bool IsWrite>
+	[[nodiscard]] Address address_indirect_indexed();
+
 	// Instruction implementations - Start with immediate mode instructions
 	void LDA_immediate(); // Load Accumulator with immediate value
 	void LDX_immediate(); // Load X Register with immediate value
@@ -529,6 +729,7 @@ class CPU6502 final : public Component {
 
 	// Highly unstable opcodes - these will crash/halt the CPU
 	void CRASH(); // For highly unstable opcodes that should halt execution
+	void UNKNOWN(); // Opcode with no implementation (decoder bug); flags is_halted()
 };
 
 } // namespace nes
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "cartridge/mappers/mapper.hpp"
+#include "core/types.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace nes {
+
+class Cartridge;
+
+/**
+ * CpuProfiler - Instructions and cycles spent under each PC
+ *
+ * Code in PRG ROM is keyed by its ROM offset, so the same CPU address in two
+ * banks is profiled separately and each entry reports the 8KB bank it lives
+ * in. Code running from RAM, PRG-RAM or through mappers without a PRG page
+ * table is keyed by CPU address (bank NO_BANK).
+ *
+ * A shadow call stack built from JSR/RTS, interrupts and RTI attributes
+ * cycles to routines (identified by their entry point) for the call graph.
+ * Frames are unwound by stack pointer, so routines that discard their
+ * return address (PLA PLA; JMP) are closed by the next return to an outer
+ * frame. Inclusive cycles double count under recursion.
+ *
+ * The CPU only feeds the profiler when built with VIBENES_CPU_PROFILER and a
+ * profiler is attached (CPU6502::set_profiler); otherwise the hooks compile
+ * away entirely.
+ */
+class CpuProfiler {
+  public:
+	static constexpr int32_t NO_BANK = -1;
+	static constexpr uint32_t PRG_BANK_SIZE = 0x2000;
+
+	struct Counters {
+		uint64_t instructions = 0;
+		uint64_t cycles = 0;	  // Includes DMA stalls and skipped idle-loop cycles
+		uint64_t idle_cycles = 0; // Cycles fast-forwarded by idle-loop skipping
+	};
+
+	struct FlatEntry {
+		int32_t bank = NO_BANK;
+		Address pc = 0;
+		Counters counters;
+	};
+
+	struct Routine {
+		int32_t bank = NO_BANK;
+		Address pc = 0;
+		uint64_t calls = 0;
+		uint64_t self_cycles = 0;
+		uint64_t inclusive_cycles = 0;
+	};
+
+	struct CallEdge {
+		Routine caller; // bank/pc of the calling routine (ROOT_PC for top level)
+		Routine callee; // bank/pc of the called routine
+		uint64_t calls = 0;
+		uint64_t inclusive_cycles = 0;
+	};
+
+	/// Entry point reported for code outside any call (reset code, main loop)
+	static constexpr Address ROOT_PC = 0xFFFF;
+
+	explicit CpuProfiler(const Cartridge *cartridge = nullptr);
+
+	/**
+	 * Profile against a cartridge's PRG ROM. Call again after every ROM load;
+	 * also clears all counters, since ROM offsets from another cartridge are
+	 * meaningless
+	 */
+	void attach_cartridge(const Cartridge *cartridge);
+	void reset();
+
+	// Hooks (called by CPU6502 after the event completed). sp_before is S when
+	// the instruction or interrupt started.
+	void record_instruction(Address pc, Byte opcode, int cycles, Address next_pc, Byte sp_before, Byte sp_after);
+	void record_interrupt(Address handler_pc, int cycles, Byte sp_before);
+	void record_idle_cycles(Address pc, uint64_t cycles);
+	void record_stall_cycles(Address pc, uint64_t cycles); // OAM DMA, reset sequence
+
+	/// Counters for the code currently mapped at a CPU address (nullptr if
+	/// nothing ran there)
+	[[nodiscard]] const Counters *counters_at(Address pc) const;
+
+	[[nodiscard]] uint64_t get_total_cycles() const noexcept {
+		return total_cycles_;
+	}
+	[[nodiscard]] uint64_t get_total_instructions() const noexcept {
+		return total_instructions_;
+	}
+
+	/// Every location that ran, hottest (by cycles) first
+	[[nodiscard]] std::vector<FlatEntry> flat_profile() const;
+	/// Routines (including the open frames of the shadow stack), hottest
+	/// inclusive first
+	[[nodiscard]] std::vector<Routine> routines() const;
+	/// Caller -> callee edges, hottest inclusive first
+	[[nodiscard]] std::vector<CallEdge> call_graph() const;
+
+	/// Text reports: one line per location / routine with percentages of the
+	/// total cycle count
+	void write_flat_profile(std::ostream &out, std::size_t limit = 0) const;
+	void write_call_graph(std::ostream &out, std::size_t limit = 0) const;
+
+  private:
+	// Location key: PRG ROM offset below rom_size_, else rom_size_ + CPU address
+	using Key = uint32_t;
+	static constexpr Key ROOT_KEY = 0xFFFFFFFF;
+
+	struct Frame {
+		Key routine;
+		Byte sp_at_call; // S before the call pushed anything
+		uint64_t entry_cycles;
+		uint64_t self_cycles = 0;
+	};
+
+	struct RoutineTotals {
+		uint64_t calls = 0;
+		uint64_t self_cycles = 0;
+		uint64_t inclusive_cycles = 0;
+	};
+
+	struct EdgeTotals {
+		uint64_t calls = 0;
+		uint64_t inclusive_cycles = 0;
+	};
+
+	const Mapper::PrgPageTable *page_table_ = nullptr;
+	const Byte *prg_rom_ = nullptr;
+	uint32_t rom_size_ = 0;
+
+	// Indexed by Key; ROM part first, then the 64KB CPU address space
+	std::vector<Counters> counters_;
+	std::vector<Address> key_pcs_; // CPU address each ROM key last ran at
+
+	uint64_t total_cycles_ = 0;
+	uint64_t total_instructions_ = 0;
+
+	std::vector<Frame> stack_;
+	uint64_t root_self_cycles_ = 0;
+	std::map<Key, RoutineTotals> routines_;
+	std::map<std::pair<Key, Key>, EdgeTotals> edges_;
+
+	[[nodiscard]] Key key_for(Address pc) const noexcept;
+	[[nodiscard]] int32_t bank_of(Key key) const noexcept;
+	[[nodiscard]] Address pc_of(Key key) const noexcept;
+	[[nodiscard]] Routine describe(Key key) const noexcept;
+
+	void add_cycles(Key key, uint64_t cycles);
+	void push_frame(Key routine, Byte sp_at_call);
+	void unwind_to(Byte sp);
+};
+
+} // namespace nes
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+/**
+ * TraceRecord - One executed instruction, as stored in a .vntrace file
+ *
+ * CPU state before the instruction runs, the PPU position and CPU cycle at
+ * its opcode fetch and the instruction bytes (`length` of `bytes` are
+ * valid). Fixed size and host byte order (little-endian on every target
+ * the emulator builds for).
+ */
+struct TraceRecord {
+	std::uint64_t cycle = 0;
+	std::uint16_t pc = 0;
+	std::uint16_t scanline = 0;
+	std::uint16_t dot = 0;
+	std::uint8_t bytes[3] = {};
+	std::uint8_t length = 0;
+	std::uint8_t a = 0;
+	std::uint8_t x = 0;
+	std::uint8_t y = 0;
+	std::uint8_t p = 0;
+	std::uint8_t sp = 0;
+	std::uint8_t reserved = 0;
+};
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord is an on-disk format");
+
+/// .vntrace header: magic, format version, record size
+struct TraceFileHeader {
+	char magic[8] = {'V', 'N', 'T', 'R', 'A', 'C', 'E', '\0'};
+	std::uint32_t version = 1;
+	std::uint32_t record_size = sizeof(TraceRecord);
+};
+static_assert(sizeof(TraceFileHeader) == 16, "TraceFileHeader is an on-disk format");
+
+/**
+ * CpuTraceWriter - Streams TraceRecords to disk from a writer thread
+ *
+ * record() only copies into the current buffer; a full buffer is handed to
+ * the writer thread and recording continues into the other one, so the
+ * emulation thread stalls only when it fills a buffer before the previous
+ * one reached the disk. No text is formatted here: convert traces with
+ * VibeNES_TraceDump (format_trace_line).
+ *
+ * The CPU feeds the writer when built with VIBENES_CPU_TRACE and a writer is
+ * attached (CPU6502::set_tracer).
+ */
+class CpuTraceWriter {
+  public:
+	explicit CpuTraceWriter(std::size_t records_per_buffer = 1 << 16);
+	~CpuTraceWriter();
+	CpuTraceWriter(const CpuTraceWriter &) = delete;
+	CpuTraceWriter &operator=(const CpuTraceWriter &) = delete;
+
+	/// Create the trace file, write its header and start the writer thread
+	bool open(const std::filesystem::path &path);
+	/// Write out what is buffered, stop the thread and close the file.
+	/// Returns false if any write failed.
+	bool close();
+	[[nodiscard]] bool is_open() const noexcept {
+		return thread_.joinable();
+	}
+
+	void record(const TraceRecord &record) {
+		buffers_[fill_][fill_count_] = record;
+		if (++fill_count_ == capacity_) {
+			hand_off();
+		}
+		++records_;
+	}
+
+	[[nodiscard]] std::uint64_t records_recorded() const noexcept {
+		return records_;
+	}
+
+  private:
+	std::size_t capacity_;
+	std::vector<TraceRecord> buffers_[2];
+	int fill_ = 0; // Buffer record() writes into
+	std::size_t fill_count_ = 0;
+	std::uint64_t records_ = 0;
+
+	// Shared with the writer thread
+	std::ofstream file_;
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::size_t pending_count_ = 0; // Records queued in the buffer not being filled
+	bool pending_ = false;
+	bool stop_ = false;
+	bool failed_ = false;
+
+	void hand_off();
+	void writer_main();
+};
+
+/**
+ * Read a .vntrace file record by record. Fails (read() returns false) on a
+ * missing file, a bad header or a truncated record.
+ */
+class CpuTraceReader {
+  public:
+	explicit CpuTraceReader(std::istream &input);
+	[[nodiscard]] bool valid() const noexcept {
+		return valid_;
+	}
+	bool read(TraceRecord &record);
+
+  private:
+	std::istream &input_;
+	bool valid_ = false;
+};
+
+/// nestest.log-style line for a record, e.g.
+/// "C000  4C F5 C5  JMP $C5F5                       A:00 X:00 Y:00 P:24 SP:FD PPU:  0, 21 CYC:7"
+/// (without nestest's "= value" effective-address annotations)
+[[nodiscard]] std::string format_trace_line(const TraceRecord &record);
+
+} // namespace nes
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "cpu/opcode_table.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace nes {
+
+/**
+ * Instruction - One decoded 6502 instruction
+ *
+ * Mnemonics and addressing modes come from the CPU's own dispatch table
+ * (VIBENES_CPU_OPCODES), so the debugger, the trace dump and the static
+ * disassembler read code exactly as CPU6502 runs it. Opcodes the CPU does
+ * not model decode as "???" with the length the hardware would fetch.
+ */
+struct Instruction {
+	Address pc = 0;
+	std::array<Byte, 3> bytes{}; // Opcode and operand; `length` of them are used
+	std::uint8_t length = 1;
+	std::string_view mnemonic; // "LDA", "SLO", "???"
+	AddressingMode mode = AddressingMode::Implied;
+	InstructionFlow flow = InstructionFlow::Next;
+	bool unofficial = false; // Undocumented opcode (nestest's '*')
+
+	[[nodiscard]] Byte opcode() const noexcept {
+		return bytes[0];
+	}
+	// Whether the operand names a memory address (a target for branches,
+	// jumps and calls); false for implied, accumulator and immediate
+	[[nodiscard]] bool has_address() const noexcept {
+		return mode != AddressingMode::Implied && mode != AddressingMode::Accumulator &&
+			   mode != AddressingMode::Immediate;
+	}
+	// That address: the branch target for relative mode, else the operand
+	// (the pointer's address for the indirect modes)
+	[[nodiscard]] Address address() const noexcept;
+};
+
+/// Bytes taken by an opcode and its operand (1-3)
+[[nodiscard]] std::uint8_t instruction_length(Byte opcode) noexcept;
+
+/// Decode the instruction at `pc` from its opcode and the two bytes after
+/// it (ignored past the instruction's length)
+[[nodiscard]] Instruction decode_instruction(Address pc, Byte opcode, Byte operand1 = 0, Byte operand2 = 0) noexcept;
+
+/// The operand as assembly text ("#$10", "$0300,X", "($20),Y", "A"); with a
+/// label, the label stands in for the address
+[[nodiscard]] std::string format_operand(const Instruction &instruction, std::string_view label = {});
+
+/// Mnemonic and operand, e.g. "LDA $2002"
+[[nodiscard]] std::string format_instruction(const Instruction &instruction, std::string_view label = {});
+
+} // namespace nes
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "cartridge/mappers/mapper.hpp"
+#include "core/types.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace nes {
+
+class SystemBus;
+
+/**
+ * DisassemblyCache - Persistent map of known instruction starts
+ *
+ * A code log for the disassembler: every PC the debugger sees executing is
+ * marked, and the straight-line code after it is decoded once and marked
+ * too, so later views walk backwards and forwards over known boundaries
+ * instead of re-guessing the alignment around the PC.
+ *
+ * Code in PRG ROM is keyed by its ROM offset, so each bank keeps its own
+ * entries across bank switches and the CPU address is resolved through the
+ * bus's current PRG page table on every lookup. Code anywhere else (RAM,
+ * PRG-RAM, mappers without a page table) is keyed by CPU address and stores
+ * the opcode it was logged with; an entry whose byte has since been
+ * rewritten is dropped when next looked at.
+ *
+ * Only the map lives here; the bus passed to each call may change between
+ * calls (e.g. the live system and a debugger shadow of the same ROM).
+ */
+class DisassemblyCache {
+  public:
+	/// Bytes taken by an opcode and its operand (1-3)
+	[[nodiscard]] static std::uint8_t instruction_size(Byte opcode) noexcept;
+
+	/// Forget everything (new ROM loaded)
+	void clear();
+
+	/// Record an instruction start the CPU executed, then decode forward
+	/// from it to the next unconditional jump or return
+	void log_executed(const SystemBus &bus, Address pc);
+
+	/**
+	 * Instruction addresses around pc: up to `before` starts preceding it,
+	 * pc itself, then `after` starts following it. Stretches before pc that
+	 * were never logged are aligned heuristically once and remembered.
+	 */
+	[[nodiscard]] std::vector<Address> window(const SystemBus &bus, Address pc, int before, int after);
+
+	/// Whether the code log has an instruction starting at this CPU address
+	[[nodiscard]] bool is_instruction_start(const SystemBus &bus, Address address);
+	[[nodiscard]] bool was_executed(const SystemBus &bus, Address address);
+
+  private:
+	enum Flag : std::uint8_t {
+		EXECUTED = 0x01, // The CPU was seen at this address
+		DECODED = 0x02,	 // Reached by decoding forward, or aligned heuristically
+	};
+
+	// Location key: PRG ROM offset below rom_size_, else rom_size_ + CPU address
+	using Key = std::uint32_t;
+
+	std::uint32_t rom_size_ = 0;
+	std::vector<std::uint8_t> flags_;  // Indexed by Key
+	std::vector<Byte> logged_opcodes_; // Per CPU address, for CPU-address keys
+
+	// Resolved against the bus of the current call
+	const Byte *prg_rom_ = nullptr;
+	const Mapper::PrgPageTable *page_table_ = nullptr;
+
+	void bind(const SystemBus &bus);
+	[[nodiscard]] Key key_for(Address address) const noexcept;
+	[[nodiscard]] std::uint8_t flags_at(const SystemBus &bus, Address address);
+	void mark(const SystemBus &bus, Address address, std::uint8_t flag);
+	void unmark(Address address, std::uint8_t flag);
+	[[nodiscard]] bool heuristic_align(const SystemBus &bus, Address pc);
+};
+
+} // namespace nes
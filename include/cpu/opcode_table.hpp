@@ -0,0 +1,498 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+// Opcode -> handler map for CPU6502, one X(opcode, handler) entry per opcode in
+// ascending order.  Expanded by cpu_6502.cpp into the 256-entry dispatch table
+// (and, with VIBENES_CPU_COMPUTED_GOTO, the computed-goto label table), so the
+// two dispatch paths can never disagree, and read back at compile time into
+// OPCODE_INFO below.  UNKNOWN marks opcodes the decoder does not implement
+// (JAM/KIL and a few unstable immediates).
+#define VIBENES_CPU_OPCODES(X) \
+	/* 0x00 */ \
+	X(0x00, BRK) \
+	X(0x01, ORA_indexed_indirect) \
+	X(0x02, UNKNOWN) \
+	X(0x03, SLO_indexed_indirect) \
+	X(0x04, NOP_zero_page) \
+	X(0x05, ORA_zero_page) \
+	X(0x06, ASL_zero_page) \
+	X(0x07, SLO_zero_page) \
+	X(0x08, PHP) \
+	X(0x09, ORA_immediate) \
+	X(0x0A, ASL_accumulator) \
+	X(0x0B, UNKNOWN) \
+	X(0x0C, NOP_absolute) \
+	X(0x0D, ORA_absolute) \
+	X(0x0E, ASL_absolute) \
+	X(0x0F, SLO_absolute) \
+	/* 0x10 */ \
+	X(0x10, BPL_relative) \
+	X(0x11, ORA_indirect_indexed) \
+	X(0x12, UNKNOWN) \
+	X(0x13, SLO_indirect_indexed) \
+	X(0x14, NOP_zero_page_X) \
+	X(0x15, ORA_zero_page_X) \
+	X(0x16, ASL_zero_page_X) \
+	X(0x17, SLO_zero_page_X) \
+	X(0x18, CLC) \
+	X(0x19, ORA_absolute_Y) \
+	X(0x1A, NOP) \
+	X(0x1B, SLO_absolute_Y) \
+	X(0x1C, NOP_absolute_X) \
+	X(0x1D, ORA_absolute_X) \
+	X(0x1E, ASL_absolute_X) \
+	X(0x1F, SLO_absolute_X) \
+	/* 0x20 */ \
+	X(0x20, JSR) \
+	X(0x21, AND_indexed_indirect) \
+	X(0x22, UNKNOWN) \
+	X(0x23, RLA_indexed_indirect) \
+	X(0x24, BIT_zero_page) \
+	X(0x25, AND_zero_page) \
+	X(0x26, ROL_zero_page) \
+	X(0x27, RLA_zero_page) \
+	X(0x28, PLP) \
+	X(0x29, AND_immediate) \
+	X(0x2A, ROL_accumulator) \
+	X(0x2B, UNKNOWN) \
+	X(0x2C, BIT_absolute) \
+	X(0x2D, AND_absolute) \
+	X(0x2E, ROL_absolute) \
+	X(0x2F, RLA_absolute) \
+	/* 0x30 */ \
+	X(0x30, BMI_relative) \
+	X(0x31, AND_indirect_indexed) \
+	X(0x32, UNKNOWN) \
+	X(0x33, RLA_indirect_indexed) \
+	X(0x34, NOP_zero_page_X) \
+	X(0x35, AND_zero_page_X) \
+	X(0x36, ROL_zero_page_X) \
+	X(0x37, RLA_zero_page_X) \
+	X(0x38, SEC) \
+	X(0x39, AND_absolute_Y) \
+	X(0x3A, NOP) \
+	X(0x3B, RLA_absolute_Y) \
+	X(0x3C, NOP_absolute_X) \
+	X(0x3D, AND_absolute_X) \
+	X(0x3E, ROL_absolute_X) \
+	X(0x3F, RLA_absolute_X) \
+	/* 0x40 */ \
+	X(0x40, RTI) \
+	X(0x41, EOR_indexed_indirect) \
+	X(0x42, UNKNOWN) \
+	X(0x43, SRE_indexed_indirect) \
+	X(0x44, NOP_zero_page) \
+	X(0x45, EOR_zero_page) \
+	X(0x46, LSR_zero_page) \
+	X(0x47, SRE_zero_page) \
+	X(0x48, PHA) \
+	X(0x49, EOR_immediate) \
+	X(0x4A, LSR_accumulator) \
+	X(0x4B, UNKNOWN) \
+	X(0x4C, JMP_absolute) \
+	X(0x4D, EOR_absolute) \
+	X(0x4E, LSR_absolute) \
+	X(0x4F, SRE_absolute) \
+	/* 0x50 */ \
+	X(0x50, BVC_relative) \
+	X(0x51, EOR_indirect_indexed) \
+	X(0x52, UNKNOWN) \
+	X(0x53, SRE_indirect_indexed) \
+	X(0x54, NOP_zero_page_X) \
+	X(0x55, EOR_zero_page_X) \
+	X(0x56, LSR_zero_page_X) \
+	X(0x57, SRE_zero_page_X) \
+	X(0x58, CLI) \
+	X(0x59, EOR_absolute_Y) \
+	X(0x5A, NOP) \
+	X(0x5B, SRE_absolute_Y) \
+	X(0x5C, NOP_absolute_X) \
+	X(0x5D, EOR_absolute_X) \
+	X(0x5E, LSR_absolute_X) \
+	X(0x5F, SRE_absolute_X) \
+	/* 0x60 */ \
+	X(0x60, RTS) \
+	X(0x61, ADC_indexed_indirect) \
+	X(0x62, UNKNOWN) \
+	X(0x63, RRA_indexed_indirect) \
+	X(0x64, NOP_zero_page) \
+	X(0x65, ADC_zero_page) \
+	X(0x66, ROR_zero_page) \
+	X(0x67, RRA_zero_page) \
+	X(0x68, PLA) \
+	X(0x69, ADC_immediate) \
+	X(0x6A, ROR_accumulator) \
+	X(0x6B, UNKNOWN) \
+	X(0x6C, JMP_indirect) \
+	X(0x6D, ADC_absolute) \
+	X(0x6E, ROR_absolute) \
+	X(0x6F, RRA_absolute) \
+	/* 0x70 */ \
+	X(0x70, BVS_relative) \
+	X(0x71, ADC_indirect_indexed) \
+	X(0x72, UNKNOWN) \
+	X(0x73, RRA_indirect_indexed) \
+	X(0x74, NOP_zero_page_X) \
+	X(0x75, ADC_zero_page_X) \
+	X(0x76, ROR_zero_page_X) \
+	X(0x77, RRA_zero_page_X) \
+	X(0x78, SEI) \
+	X(0x79, ADC_absolute_Y) \
+	X(0x7A, NOP) \
+	X(0x7B, RRA_absolute_Y) \
+	X(0x7C, NOP_absolute_X) \
+	X(0x7D, ADC_absolute_X) \
+	X(0x7E, ROR_absolute_X) \
+	X(0x7F, RRA_absolute_X) \
+	/* 0x80 */ \
+	X(0x80, NOP_immediate) \
+	X(0x81, STA_indexed_indirect) \
+	X(0x82, NOP_immediate) \
+	X(0x83, SAX_indexed_indirect) \
+	X(0x84, STY_zero_page) \
+	X(0x85, STA_zero_page) \
+	X(0x86, STX_zero_page) \
+	X(0x87, SAX_zero_page) \
+	X(0x88, DEY) \
+	X(0x89, NOP_immediate) \
+	X(0x8A, TXA) \
+	X(0x8B, CRASH) \
+	X(0x8C, STY_absolute) \
+	X(0x8D, STA_absolute) \
+	X(0x8E, STX_absolute) \
+	X(0x8F, SAX_absolute) \
+	/* 0x90 */ \
+	X(0x90, BCC_relative) \
+	X(0x91, STA_indirect_indexed) \
+	X(0x92, UNKNOWN) \
+	X(0x93, CRASH) \
+	X(0x94, STY_zero_page_X) \
+	X(0x95, STA_zero_page_X) \
+	X(0x96, STX_zero_page_Y) \
+	X(0x97, SAX_zero_page_Y) \
+	X(0x98, TYA) \
+	X(0x99, STA_absolute_Y) \
+	X(0x9A, TXS) \
+	X(0x9B, CRASH) \
+	X(0x9C, CRASH) \
+	X(0x9D, STA_absolute_X) \
+	X(0x9E, CRASH) \
+	X(0x9F, CRASH) \
+	/* 0xA0 */ \
+	X(0xA0, LDY_immediate) \
+	X(0xA1, LDA_indexed_indirect) \
+	X(0xA2, LDX_immediate) \
+	X(0xA3, LAX_indexed_indirect) \
+	X(0xA4, LDY_zero_page) \
+	X(0xA5, LDA_zero_page) \
+	X(0xA6, LDX_zero_page) \
+	X(0xA7, LAX_zero_page) \
+	X(0xA8, TAY) \
+	X(0xA9, LDA_immediate) \
+	X(0xAA, TAX) \
+	X(0xAB, CRASH) \
+	X(0xAC, LDY_absolute) \
+	X(0xAD, LDA_absolute) \
+	X(0xAE, LDX_absolute) \
+	X(0xAF, LAX_absolute) \
+	/* 0xB0 */ \
+	X(0xB0, BCS_relative) \
+	X(0xB1, LDA_indirect_indexed) \
+	X(0xB2, UNKNOWN) \
+	X(0xB3, LAX_indirect_indexed) \
+	X(0xB4, LDY_zero_page_X) \
+	X(0xB5, LDA_zero_page_X) \
+	X(0xB6, LDX_zero_page_Y) \
+	X(0xB7, LAX_zero_page_Y) \
+	X(0xB8, CLV) \
+	X(0xB9, LDA_absolute_Y) \
+	X(0xBA, TSX) \
+	X(0xBB, CRASH) \
+	X(0xBC, LDY_absolute_X) \
+	X(0xBD, LDA_absolute_X) \
+	X(0xBE, LDX_absolute_Y) \
+	X(0xBF, LAX_absolute_Y) \
+	/* 0xC0 */ \
+	X(0xC0, CPY_immediate) \
+	X(0xC1, CMP_indexed_indirect) \
+	X(0xC2, NOP_immediate) \
+	X(0xC3, DCP_indexed_indirect) \
+	X(0xC4, CPY_zero_page) \
+	X(0xC5, CMP_zero_page) \
+	X(0xC6, DEC_zero_page) \
+	X(0xC7, DCP_zero_page) \
+	X(0xC8, INY) \
+	X(0xC9, CMP_immediate) \
+	X(0xCA, DEX) \
+	X(0xCB, UNKNOWN) \
+	X(0xCC, CPY_absolute) \
+	X(0xCD, CMP_absolute) \
+	X(0xCE, DEC_absolute) \
+	X(0xCF, DCP_absolute) \
+	/* 0xD0 */ \
+	X(0xD0, BNE_relative) \
+	X(0xD1, CMP_indirect_indexed) \
+	X(0xD2, UNKNOWN) \
+	X(0xD3, DCP_indirect_indexed) \
+	X(0xD4, NOP_zero_page_X) \
+	X(0xD5, CMP_zero_page_X) \
+	X(0xD6, DEC_zero_page_X) \
+	X(0xD7, DCP_zero_page_X) \
+	X(0xD8, CLD) \
+	X(0xD9, CMP_absolute_Y) \
+	X(0xDA, NOP) \
+	X(0xDB, DCP_absolute_Y) \
+	X(0xDC, NOP_absolute_X) \
+	X(0xDD, CMP_absolute_X) \
+	X(0xDE, DEC_absolute_X) \
+	X(0xDF, DCP_absolute_X) \
+	/* 0xE0 */ \
+	X(0xE0, CPX_immediate) \
+	X(0xE1, SBC_indexed_indirect) \
+	X(0xE2, NOP_immediate) \
+	X(0xE3, ISC_indexed_indirect) \
+	X(0xE4, CPX_zero_page) \
+	X(0xE5, SBC_zero_page) \
+	X(0xE6, INC_zero_page) \
+	X(0xE7, ISC_zero_page) \
+	X(0xE8, INX) \
+	X(0xE9, SBC_immediate) \
+	X(0xEA, NOP) \
+	X(0xEB, SBC_immediate) \
+	X(0xEC, CPX_absolute) \
+	X(0xED, SBC_absolute) \
+	X(0xEE, INC_absolute) \
+	X(0xEF, ISC_absolute) \
+	/* 0xF0 */ \
+	X(0xF0, BEQ_relative) \
+	X(0xF1, SBC_indirect_indexed) \
+	X(0xF2, UNKNOWN) \
+	X(0xF3, ISC_indirect_indexed) \
+	X(0xF4, NOP_zero_page_X) \
+	X(0xF5, SBC_zero_page_X) \
+	X(0xF6, INC_zero_page_X) \
+	X(0xF7, ISC_zero_page_X) \
+	X(0xF8, SED) \
+	X(0xF9, SBC_absolute_Y) \
+	X(0xFA, NOP) \
+	X(0xFB, ISC_absolute_Y) \
+	X(0xFC, NOP_absolute_X) \
+	X(0xFD, SBC_absolute_X) \
+	X(0xFE, INC_absolute_X) \
+	X(0xFF, ISC_absolute_X)
+
+
+namespace nes {
+
+// Base CPU cycles per opcode, fetch included: operands on one page, branch
+// not taken, no DMA stall. A page crossing or taken branch adds one cycle, a
+// taken branch to another page two. 0 marks the opcodes CPU6502 does not
+// model (JAM/KIL, and the unstable ones it treats as UNKNOWN or CRASH).
+// The handlers spend their cycles one bus access at a time; tests hold them
+// to this table.
+inline constexpr std::array<std::uint8_t, 256> OPCODE_BASE_CYCLES = {
+	7, 6, 0, 8, 3, 3, 5, 5, 3, 2, 2, 0, 4, 4, 6, 6, // 0x00
+	2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7, // 0x10
+	6, 6, 0, 8, 3, 3, 5, 5, 4, 2, 2, 0, 4, 4, 6, 6, // 0x20
+	2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7, // 0x30
+	6, 6, 0, 8, 3, 3, 5, 5, 3, 2, 2, 0, 3, 4, 6, 6, // 0x40
+	2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7, // 0x50
+	6, 6, 0, 8, 3, 3, 5, 5, 4, 2, 2, 0, 5, 4, 6, 6, // 0x60
+	2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7, // 0x70
+	2, 6, 2, 6, 3, 3, 3, 3, 2, 2, 2, 0, 4, 4, 4, 4, // 0x80
+	2, 6, 0, 0, 4, 4, 4, 4, 2, 5, 2, 0, 0, 5, 0, 0, // 0x90
+	2, 6, 2, 6, 3, 3, 3, 3, 2, 2, 2, 0, 4, 4, 4, 4, // 0xA0
+	2, 5, 0, 5, 4, 4, 4, 4, 2, 4, 2, 0, 4, 4, 4, 4, // 0xB0
+	2, 6, 2, 8, 3, 3, 5, 5, 2, 2, 2, 0, 4, 4, 6, 6, // 0xC0
+	2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7, // 0xD0
+	2, 6, 2, 8, 3, 3, 5, 5, 2, 2, 2, 2, 4, 4, 6, 6, // 0xE0
+	2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7, // 0xF0
+};
+
+// Bytes each opcode fetches, operand included; also for the opcodes
+// CPU6502 does not model, so code after them still lines up
+inline constexpr std::array<std::uint8_t, 256> OPCODE_LENGTHS = {
+	1, 2, 1, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3, // 0x00
+	2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3, // 0x10
+	3, 2, 1, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3, // 0x20
+	2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3, // 0x30
+	1, 2, 1, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3, // 0x40
+	2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3, // 0x50
+	1, 2, 1, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3, // 0x60
+	2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3, // 0x70
+	2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3, // 0x80
+	2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3, // 0x90
+	2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3, // 0xA0
+	2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3, // 0xB0
+	2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3, // 0xC0
+	2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3, // 0xD0
+	2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3, // 0xE0
+	2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3, // 0xF0
+};
+
+enum class AddressingMode : std::uint8_t {
+	Implied,
+	Accumulator,
+	Immediate,
+	ZeroPage,
+	ZeroPageX,
+	ZeroPageY,
+	Absolute,
+	AbsoluteX,
+	AbsoluteY,
+	Indirect,		 // JMP ($nnnn)
+	IndexedIndirect, // ($nn,X)
+	IndirectIndexed, // ($nn),Y
+	Relative,		 // Branches
+};
+
+// Where control goes after an instruction
+enum class InstructionFlow : std::uint8_t {
+	Next,		  // Falls through to the following instruction
+	Branch,		  // Conditional: the target or the next instruction
+	Jump,		  // JMP $nnnn
+	IndirectJump, // JMP ($nnnn): the target is only known at run time
+	Call,		  // JSR: the target, normally back to the next instruction
+	Return,		  // RTS, RTI
+	Break,		  // BRK
+	Halt,		  // JAM, and the unstable opcodes CPU6502 does not model
+};
+
+/**
+ * OpcodeInfo - Everything known about an opcode without running it
+ *
+ * OPCODE_INFO is built at compile time from the handler names in
+ * VIBENES_CPU_OPCODES ("LDA_absolute_X" is LDA, absolute,X), the length
+ * table and the cycle table, so the dispatch table, the disassembler, the
+ * trace dump and the profiler cannot disagree about an opcode. Decoding is
+ * one lookup.
+ */
+struct OpcodeInfo {
+	std::string_view mnemonic; // "LDA", "SLO"; "???" for the opcodes CPU6502 does not model
+	AddressingMode mode = AddressingMode::Implied;
+	InstructionFlow flow = InstructionFlow::Next;
+	std::uint8_t length = 1;
+	std::uint8_t base_cycles = 0; // OPCODE_BASE_CYCLES
+	bool unofficial = false;	  // Undocumented opcode (nestest's '*')
+};
+
+namespace opcode_table_detail {
+
+inline constexpr std::string_view HANDLER_NAMES[256] = {
+#define VIBENES_OPCODE_HANDLER_NAME(opcode, handler) #handler,
+	VIBENES_CPU_OPCODES(VIBENES_OPCODE_HANDLER_NAME)
+#undef VIBENES_OPCODE_HANDLER_NAME
+};
+
+constexpr AddressingMode mode_from_suffix(std::string_view suffix) noexcept {
+	constexpr std::pair<std::string_view, AddressingMode> SUFFIXES[] = {
+		{"accumulator", AddressingMode::Accumulator},
+		{"immediate", AddressingMode::Immediate},
+		{"zero_page", AddressingMode::ZeroPage},
+		{"zero_page_X", AddressingMode::ZeroPageX},
+		{"zero_page_Y", AddressingMode::ZeroPageY},
+		{"absolute", AddressingMode::Absolute},
+		{"absolute_X", AddressingMode::AbsoluteX},
+		{"absolute_Y", AddressingMode::AbsoluteY},
+		{"indirect", AddressingMode::Indirect},
+		{"indexed_indirect", AddressingMode::IndexedIndirect},
+		{"indirect_indexed", AddressingMode::IndirectIndexed},
+		{"relative", AddressingMode::Relative},
+	};
+	for (const auto &[name, mode] : SUFFIXES) {
+		if (name == suffix) {
+			return mode;
+		}
+	}
+	return AddressingMode::Implied;
+}
+
+// Opcodes nestest.log marks with '*'
+constexpr bool is_unofficial(std::size_t opcode, std::string_view mnemonic) noexcept {
+	if (mnemonic == "NOP") {
+		return opcode != 0xEA;
+	}
+	if (mnemonic == "SBC") {
+		return opcode == 0xEB;
+	}
+	return mnemonic == "DCP" || mnemonic == "ISC" || mnemonic == "LAX" || mnemonic == "RLA" || mnemonic == "RRA" ||
+		   mnemonic == "SAX" || mnemonic == "SLO" || mnemonic == "SRE";
+}
+
+constexpr OpcodeInfo make_info(std::size_t opcode) noexcept {
+	const std::string_view handler = HANDLER_NAMES[opcode];
+	const std::size_t split = handler.find('_');
+	OpcodeInfo info;
+	info.mnemonic = handler.substr(0, split);
+	info.mode = split == std::string_view::npos ? AddressingMode::Implied : mode_from_suffix(handler.substr(split + 1));
+	info.length = OPCODE_LENGTHS[opcode];
+	info.base_cycles = OPCODE_BASE_CYCLES[opcode];
+	info.unofficial = is_unofficial(opcode, info.mnemonic);
+
+	if (info.mnemonic == "UNKNOWN" || info.mnemonic == "CRASH") {
+		info.mnemonic = "???";
+		info.flow = InstructionFlow::Halt;
+		info.unofficial = true;
+	} else if (info.mnemonic == "JSR") {
+		info.mode = AddressingMode::Absolute; // No mode suffix on the handler
+		info.flow = InstructionFlow::Call;
+	} else if (info.mnemonic == "JMP") {
+		info.flow = info.mode == AddressingMode::Indirect ? InstructionFlow::IndirectJump : InstructionFlow::Jump;
+	} else if (info.mnemonic == "RTS" || info.mnemonic == "RTI") {
+		info.flow = InstructionFlow::Return;
+	} else if (info.mnemonic == "BRK") {
+		info.flow = InstructionFlow::Break;
+	} else if (info.mode == AddressingMode::Relative) {
+		info.flow = InstructionFlow::Branch;
+	}
+	return info;
+}
+
+// The operand bytes an addressing mode takes
+constexpr std::uint8_t mode_length(AddressingMode mode) noexcept {
+	switch (mode) {
+	case AddressingMode::Implied:
+	case AddressingMode::Accumulator:
+		return 1;
+	case AddressingMode::Absolute:
+	case AddressingMode::AbsoluteX:
+	case AddressingMode::AbsoluteY:
+	case AddressingMode::Indirect:
+		return 3;
+	default:
+		return 2;
+	}
+}
+
+} // namespace opcode_table_detail
+
+inline constexpr std::array<OpcodeInfo, 256> OPCODE_INFO = [] {
+	std::array<OpcodeInfo, 256> table{};
+	for (std::size_t opcode = 0; opcode < table.size(); ++opcode) {
+		table[opcode] = opcode_table_detail::make_info(opcode);
+	}
+	return table;
+}();
+
+// The length table, the handler names and the cycle table describe the same
+// opcodes: every modelled opcode's length matches its addressing mode (BRK
+// aside, which skips its padding byte in the handler) and costs cycles
+static_assert([] {
+	for (std::size_t opcode = 0; opcode < OPCODE_INFO.size(); ++opcode) {
+		const OpcodeInfo &info = OPCODE_INFO[opcode];
+		if (info.flow == InstructionFlow::Halt || info.flow == InstructionFlow::Break) {
+			continue;
+		}
+		if (info.length != opcode_table_detail::mode_length(info.mode) || info.base_cycles == 0) {
+			return false;
+		}
+	}
+	return true;
+}());
+
+} // namespace nes
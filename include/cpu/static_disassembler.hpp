@@ -0,0 +1,151 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "cpu/disassembler.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace nes {
+
+/**
+ * StaticDisassembler - Whole-ROM disassembly of PRG, one 8KB bank at a time
+ *
+ * Works on the ROM image alone, without running it: code is found by
+ * following control flow (recursive descent) from the entry points a Code/
+ * Data Log gives (every run of logged code, see CodeDataLogger) and from the
+ * vectors, and everything not reached is listed as data. Logged code is
+ * traced before guesses from untaken branches, so a guess can never claim
+ * bytes the CPU was seen to execute, and bytes logged only as data are never
+ * decoded.
+ *
+ * Each bank's CPU window comes from the log (the window most of its logged
+ * bytes were seen at); unlogged banks are guessed: 32KB and smaller ROMs
+ * map straight through (16KB ones at $C000), larger ones keep their last
+ * 16KB at $C000-$FFFF and switch 16KB at $8000.
+ *
+ * Passes:
+ * 1. trace_bank() for every bank. Banks are independent, so each may be
+ *    traced on its own thread.
+ * 2. link() hands every bank the entry points the others found in it (a JSR
+ *    into the fixed bank); trace the banks it returns and link again until
+ *    it returns none. Targets whose window several banks share are not
+ *    followed.
+ * 3. resolve_symbols(), then listing() per bank (again from any thread) and
+ *    symbols_json().
+ * run() does all of it on the calling thread.
+ */
+class StaticDisassembler {
+  public:
+	static constexpr std::size_t BANK_SIZE = 0x2000;
+
+	enum class SymbolKind : std::uint8_t {
+		Vector,		// NMI, reset or IRQ handler
+		Subroutine, // JSR target
+		Label,		// Jump or branch target
+	};
+
+	struct Symbol {
+		std::string name;
+		SymbolKind kind = SymbolKind::Label;
+		std::size_t bank = 0;
+		Address address = 0; // In the bank's CPU window
+		std::uint32_t prg_offset = 0;
+		std::uint32_t references = 0; // Instructions that name it
+	};
+
+	struct Bank {
+		std::uint32_t prg_offset = 0;
+		Address cpu_base = 0x8000;
+		bool base_from_cdl = false; // Else guessed
+		std::size_t code_bytes = 0; // Taken by traced instructions
+	};
+
+	/**
+	 * @param prg PRG ROM (a whole number of 8KB banks; a short tail is padded)
+	 * @param cdl The ROM's PRG code/data log (CodeDataLogger::prg_log()), or
+	 *            empty to trace from the vectors alone
+	 */
+	explicit StaticDisassembler(std::span<const Byte> prg, std::span<const Byte> cdl = {});
+
+	[[nodiscard]] std::size_t bank_count() const noexcept {
+		return banks_.size();
+	}
+	[[nodiscard]] const Bank &bank(std::size_t index) const noexcept {
+		return banks_[index].info;
+	}
+
+	/// Follow code from the bank's pending entry points (pass 1)
+	void trace_bank(std::size_t index);
+	/// Seed banks with the entry points other banks found in them; returns
+	/// the banks to trace again (pass 2). No trace_bank() may be running.
+	[[nodiscard]] std::vector<std::size_t> link();
+	/// Name every traced instruction something jumps to, calls or vectors at
+	void resolve_symbols();
+
+	/// The bank as assembly (ca65 syntax), labels and register names in place
+	[[nodiscard]] std::string listing(std::size_t index) const;
+	/// Register equates and the CPU setting the listings assume
+	[[nodiscard]] std::string listing_header() const;
+	[[nodiscard]] const std::vector<Symbol> &symbols() const noexcept {
+		return symbols_;
+	}
+	/// Banks and symbols as a JSON document
+	[[nodiscard]] std::string symbols_json(std::string_view rom_name) const;
+
+	/// Every pass, on this thread
+	void run();
+
+	/// Whether a traced instruction starts at this PRG offset
+	[[nodiscard]] bool is_instruction_start(std::uint32_t prg_offset) const noexcept;
+	/// The symbol at this PRG offset, or null
+	[[nodiscard]] const Symbol *symbol_at(std::uint32_t prg_offset) const noexcept;
+
+	/// Name of the PPU/APU/controller register at this address, or empty
+	[[nodiscard]] static std::string_view register_name(Address address) noexcept;
+
+  private:
+	enum Mark : std::uint8_t {
+		START = 0x01,	// An instruction starts here
+		OPERAND = 0x02, // Inside an instruction
+		SEEDED = 0x04,	// Handed in by link(), tried once
+	};
+
+	struct Reference {
+		Address target = 0;
+		InstructionFlow flow = InstructionFlow::Next;
+	};
+
+	struct BankState {
+		Bank info;
+		std::vector<std::uint8_t> marks; // Per byte
+		std::vector<std::uint16_t> pending; // Entry points still to trace (bank offsets)
+		std::vector<Reference> references;	// Branch, jump and call targets found
+		std::size_t linked = 0;				// References link() has seen
+	};
+
+	std::vector<Byte> prg_; // Padded to whole banks
+	std::span<const Byte> cdl_;
+	std::vector<BankState> banks_;
+	std::size_t vector_banks_ = 0; // Banks at $E000, whose vectors are entry points
+	std::vector<Symbol> symbols_;  // In PRG order
+	std::unordered_map<std::uint32_t, std::size_t> symbol_index_;
+
+	[[nodiscard]] Byte cdl_at(std::uint32_t prg_offset) const noexcept {
+		return prg_offset < cdl_.size() ? cdl_[prg_offset] : Byte{0};
+	}
+	void place_banks();
+	void seed_bank(BankState &bank);
+	// Operand bytes past the bank's end read as 0
+	[[nodiscard]] Instruction decode_at(const BankState &bank, std::uint32_t offset) const noexcept;
+	// The PRG offset a CPU address means from `bank`: its own window, or the
+	// one bank mapped there; -1 if neither
+	[[nodiscard]] std::int64_t resolve(std::size_t bank, Address address) const noexcept;
+	[[nodiscard]] std::string operand_label(std::size_t bank, const Instruction &instruction) const;
+};
+
+} // namespace nes
@@ -6,6 +6,11 @@
 #include <windows.h>
 #endif
 #include <GL/gl.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
 
 namespace nes::gui {
 
@@ -17,8 +22,15 @@ class CRTFilter {
 	~CRTFilter();
 
 	/// Initialize GL resources. Call after the GL context is created.
+	/// Optional: apply() and resolve_indexed_frame() initialize on first use.
 	bool initialize();
 
+	/// Keep linked shader programs (glGetProgramBinary) in this directory so
+	/// later starts load them instead of compiling. Empty disables the cache.
+	void set_program_cache_directory(std::filesystem::path directory) {
+		program_cache_directory_ = std::move(directory);
+	}
+
 	/// Release all GL resources.
 	void shutdown();
 
@@ -27,8 +39,28 @@ class CRTFilter {
 	/// @param output_width   Desired output width in pixels
 	/// @param output_height  Desired output height in pixels
 	/// @return Filtered texture ID, or input_texture if disabled/failed
+	/// The pass is skipped, and the last output returned, when nothing has
+	/// changed since the previous call (see invalidate()). On a reduced
+	/// quality preset the texture is smaller than the output: draw it at
+	/// the output size with bilinear filtering.
 	GLuint apply(GLuint input_texture, int output_width, int output_height);
 
+	/// Mark the input texture's contents as changed, so the next apply()
+	/// renders the pass again. Call after every upload into that texture.
+	void invalidate() {
+		applied_.valid = false;
+	}
+
+	/// Upload a 256x240 index frame (PPU::get_index_buffer() entries) and
+	/// render it through the palette into target_texture (256x240 RGBA).
+	/// Works whether or not the CRT effect is enabled.
+	/// @return false if the GL resources are unavailable; upload RGBA instead
+	bool resolve_indexed_frame(const uint16_t *indices, GLuint target_texture);
+
+	/// Replace the 512-entry palette (color + emphasis * 64) the index frame is
+	/// looked up in. Defaults to PPU::rgba_palette().
+	void set_palette(const std::array<uint32_t, 512> &palette);
+
 	/// Calculate display dimensions accounting for PAR correction.
 	void get_display_size(float base_width, float base_height, float scale, float &out_width, float &out_height) const;
 
@@ -45,13 +77,93 @@ class CRTFilter {
 	float brightness = 1.15f;		  ///< Brightness boost (compensates for dimming)
 	float mask_intensity = 0.06f;	  ///< Phosphor shadow mask strength
 
+	/// Quality presets, costliest first. Below full scale the pass renders
+	/// into a smaller target that the display's bilinear draw stretches back
+	/// up; the mask is dropped there, since its 3-pixel pattern would be
+	/// stretched with it.
+	struct QualityPreset {
+		const char *name;
+		float resolution_scale; ///< Of the output size (never under 480 lines, for the scanlines)
+		bool mask;
+		bool curvature;
+	};
+	static constexpr std::array<QualityPreset, 4> QUALITY_PRESETS = {{
+		{"Full", 1.0f, true, true},
+		{"No Mask", 1.0f, false, true},
+		{"Balanced", 0.75f, false, true},
+		{"Low", 0.5f, false, false},
+	}};
+	static constexpr int AUTO_QUALITY = -1;
+
+	int quality = AUTO_QUALITY; ///< Preset index, or AUTO_QUALITY to follow the GPU time
+	float gpu_budget_ms = 2.0f; ///< Auto steps down while the pass takes longer than this
+
+	/// Preset of the last pass rendered
+	[[nodiscard]] int active_quality() const noexcept {
+		return active_quality_;
+	}
+	/// Smoothed GPU time of the pass at a preset and the current output
+	/// size; 0 until measured (always, without timer queries)
+	[[nodiscard]] float measured_gpu_ms(int preset) const noexcept {
+		return gpu_ms_[static_cast<std::size_t>(preset)];
+	}
+	/// GL_TIME_ELAPSED queries are available (Auto stays on Full otherwise)
+	[[nodiscard]] bool has_gpu_timer() const noexcept {
+		return timer_supported_;
+	}
+
   private:
+	bool ensure_initialized();
 	bool load_gl_functions();
 	bool create_shader_program();
+	unsigned int load_or_build_program(std::string_view name, const char *vertex_source,
+									   const char *fragment_source) const;
 	bool ensure_framebuffer(int width, int height);
 
+	// GPU time of the pass: a few GL_TIME_ELAPSED queries in flight, read
+	// back once the driver has the result so the CPU never waits on them
+	static constexpr std::size_t TIMER_QUERIES = 3;
+	void create_timer_queries();
+	void collect_gpu_times();
+	void record_gpu_time(int preset, float ms);
+	int select_quality(int output_width, int output_height);
+
+	// Index frame uploads go through a pixel buffer object when the driver
+	// allows: persistent-mapped with per-slot fences (ARB_buffer_storage),
+	// else orphaned and remapped each frame, else plain glTexSubImage2D
+	enum class UploadMode { Direct, Orphaned, Persistent };
+	static constexpr std::size_t INDEX_FRAME_BYTES = 256 * 240 * sizeof(uint16_t);
+	static constexpr std::size_t UPLOAD_SLOTS = 3;
+	void create_upload_stream();
+	void destroy_upload_stream();
+	void upload_indices(const uint16_t *indices);
+
+	// What output_texture_ was last rendered from, so apply() can reuse it
+	// while the same frame is shown again (high refresh rates, pause)
+	struct AppliedPass {
+		bool valid = false;
+		GLuint input_texture = 0;
+		int width = 0;
+		int height = 0;
+		int quality = 0;
+		std::array<float, 5> settings{};
+		bool operator==(const AppliedPass &) const = default;
+	};
+	[[nodiscard]] AppliedPass describe_pass(GLuint input_texture, int output_width, int output_height,
+											int preset) const;
+	AppliedPass applied_;
+
 	// GL resource IDs
 	unsigned int shader_program_ = 0;
+	unsigned int palette_program_ = 0;
+	unsigned int index_texture_ = 0;   // 256x240 R16UI
+	unsigned int palette_texture_ = 0; // 64x8 RGBA: x = color, y = emphasis
+	unsigned int palette_fbo_ = 0;
+	unsigned int upload_pbo_ = 0;
+	void *upload_map_ = nullptr; // Persistent mapping of all UPLOAD_SLOTS
+	std::array<void *, UPLOAD_SLOTS> upload_fences_{};
+	std::size_t upload_slot_ = 0;
+	UploadMode upload_mode_ = UploadMode::Direct;
 	unsigned int fbo_ = 0;
 	unsigned int output_texture_ = 0;
 	unsigned int vao_ = 0;
@@ -66,11 +178,29 @@ class CRTFilter {
 	int loc_vignette_ = -1;
 	int loc_brightness_ = -1;
 	int loc_mask_ = -1;
+	int loc_indices_ = -1;
+	int loc_palette_ = -1;
+
+	std::array<unsigned int, TIMER_QUERIES> timer_queries_{};
+	std::array<int, TIMER_QUERIES> timer_presets_{}; // Preset each query timed, -1 = idle
+	std::size_t timer_next_ = 0;					 // Oldest query; the next one issued
+	bool timer_supported_ = false;
+
+	// Auto quality (see select_quality())
+	std::array<float, QUALITY_PRESETS.size()> gpu_ms_{};
+	int active_quality_ = 0;
+	int over_budget_passes_ = 0;
+	int under_budget_passes_ = 0;
+	int timed_width_ = 0; // Output size gpu_ms_ was measured at
+	int timed_height_ = 0;
 
 	int fbo_width_ = 0;
 	int fbo_height_ = 0;
 	bool initialized_ = false;
+	bool initialize_failed_ = false; // Don't retry every frame
 	bool gl_loaded_ = false;
+	bool program_binary_supported_ = false; // glGetProgramBinary/glProgramBinary loaded
+	std::filesystem::path program_cache_directory_;
 };
 
 } // namespace nes::gui
@@ -2,15 +2,26 @@
 
 #include "core/types.hpp"
 #include "gui/crt_filter.hpp"
+#include "ppu/scanline_timeline.hpp"
+#include "system/async_file_writer.hpp"
+#include "system/late_input.hpp"
+#include "system/triple_buffer.hpp"
 #include <SDL3/SDL.h>
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
 #include <memory>
+#include <string>
 
 struct ImGuiIO;
 
 // Forward declarations
 namespace nes {
 class CPU6502;
+class CpuProfiler;
 class SystemBus;
 class Cartridge;
 class PPU;
@@ -19,6 +30,17 @@ class GamepadManager;
 class Controller;
 class SaveStateManager;
 class BatterySaveManager;
+class EmulationThread;
+class FrameCapture;
+class FrameLatency;
+class HeadlessSystem;
+class LatchedInputSource;
+class NesSystem;
+class NtscFilter;
+class PerfCounters;
+class RewindBuffer;
+class RomPreloader;
+struct PreloadedRom;
 } // namespace nes
 
 namespace nes::gui {
@@ -31,13 +53,26 @@ class RomLoaderPanel;
 class PPUViewerPanel;
 class TimingPanel;
 
+/**
+ * How the front end starts (from VibeNES_GUI's command line)
+ */
+struct LaunchOptions {
+	std::string rom_path;	 // Loaded and run as soon as the loop starts, when set
+	bool fullscreen = false; // Start in borderless fullscreen
+	bool debug_ui = true;	 // false: game-only layout, debugger panels never built
+	std::string latency_report_path; // Frame latency percentiles written here on exit, when set
+	nes::LateInputScheduler::Mode late_input = nes::LateInputScheduler::Mode::Off; // Emulation > Late Input Polling
+	int late_input_lead_ms = 2; // Poll this long before the swap (Fixed) or before the measured cost (Adaptive)
+	bool mapped_saves = false; // Battery RAM is the memory-mapped .sav (BatterySaveManager::set_memory_mapped)
+};
+
 /**
  * Main GUI application class that manages the SDL2 window and ImGui context
  * Provides the debugging interface for the NES emulator
  */
 class GuiApplication {
   public:
-	GuiApplication();
+	explicit GuiApplication(LaunchOptions options = {});
 	~GuiApplication();
 
 	// Initialize SDL2 and ImGui
@@ -63,6 +98,7 @@ class GuiApplication {
 	ImGuiIO *io_;
 
 	// Application state
+	LaunchOptions launch_options_;
 	bool running_;
 
 	// Fullscreen state
@@ -75,23 +111,69 @@ class GuiApplication {
 
 	// CRT display filter
 	std::unique_ptr<CRTFilter> crt_filter_;
+	std::unique_ptr<nes::NtscFilter> ntsc_filter_; // Created while View > NTSC Filter is on
 	unsigned int fullscreen_filtered_texture_ = 0; // Pre-computed CRT texture for fullscreen
 
 	// Emulation state
 	bool emulation_running_;
 	bool emulation_paused_;
 	float emulation_speed_; // Speed multiplier (1.0 = normal speed)
-	double cycle_accumulator_;
-	std::uint64_t last_frame_counter_;
-	bool frame_timer_initialized_;
-
-	// Emulator references
-	std::shared_ptr<nes::CPU6502> cpu_;
-	std::shared_ptr<nes::SystemBus> bus_;
-	std::shared_ptr<nes::Cartridge> cartridge_;
-	std::shared_ptr<nes::PPU> ppu_;
+
+	// Fast-forward (turbo) state
+	bool fast_forward_;			   // Requested by the user (Tab held or menu toggle)
+	bool fast_forward_active_;	   // Currently applied: thread uncapped, audio muted
+	bool fast_forward_muted_audio_; // Audio was playing when fast-forward began
+	int run_ahead_frames_ = 0;		// Emulation > Run-Ahead (0 = off)
+	bool audio_pacing_ = false;		// Emulation > Pace From Audio
+	// Emulation > Late Input Polling: frames are emulated on request right
+	// after a gamepad poll timed to finish just before the next swap
+	nes::LateInputScheduler late_input_;
+	std::chrono::steady_clock::time_point late_input_polled_at_{}; // This loop's late poll, if any
+	bool rewinding_ = false;		// Backspace held (with Emulation > Rewind on)
+
+	// Emulation thread. While it owns the components the GUI only posts
+	// commands, shows its published frames and points the debug panels at
+	// debug_view_, a shadow system restored from per-frame state snapshots.
+	std::unique_ptr<nes::EmulationThread> emulation_thread_;
+	std::unique_ptr<nes::SaveStateManager> snapshot_state_manager_; // Used on the emulation thread
+	std::unique_ptr<nes::RewindBuffer> rewind_buffer_;				// Created while Emulation > Rewind is on
+	std::shared_ptr<nes::LatchedInputSource> input_latch_; // What the Controller reads
+	std::array<nes::Byte, 2> posted_buttons_;			   // Last masks sent to the thread
+	bool emulation_thread_running_;						   // Last run/pause state posted
+	bool debug_view_active_;							   // Thread busy: panels read the shadow
+	bool new_frame_;									   // A new frame arrived this GUI frame
+	int idle_redraw_frames_ = 0; // Frames still to draw before an idle loop may block on events
+	std::unique_ptr<nes::HeadlessSystem> debug_view_;
+	// The live PPU's last scanline timeline, published each frame: debug_view_
+	// is restored, never run, so its own timeline stays empty
+	nes::TripleBuffer<nes::ScanlineTimeline::Frame> scanline_timelines_;
+	std::unique_ptr<nes::SaveStateManager> debug_view_state_;
+
+	// Per-frame timing for View > Performance (fed by the emulation thread
+	// and by render_frame's own timing of this GUI frame)
+	std::unique_ptr<nes::PerfCounters> perf_counters_;
+	bool show_performance_ = false;
+	std::uint64_t texture_upload_ns_ = 0; // This GUI frame's display texture update
+	std::uint64_t gui_ns_ = 0;			  // The rest of render_frame, up to the buffer swap
+
+	// Frame pacing and input-to-present latency: each step a frame takes to
+	// the screen is stamped and present_frame() files the swap with them
+	std::unique_ptr<nes::FrameLatency> frame_latency_;
+	std::array<std::chrono::steady_clock::time_point, 8> input_polls_{}; // Recent gamepad polls, ring
+	std::size_t next_input_poll_ = 0;
+	std::chrono::steady_clock::time_point upload_done_at_{};
+
+	// The console, and shortcuts into it (null until initialized)
+	std::unique_ptr<nes::NesSystem> system_;
+	nes::CPU6502 *cpu_;
+#ifdef VIBENES_CPU_PROFILER
+	std::unique_ptr<nes::CpuProfiler> cpu_profiler_; // Fed by cpu_; heat column when paused
+#endif
+	nes::SystemBus *bus_;
+	nes::Cartridge *cartridge_;
+	nes::PPU *ppu_;
 	std::shared_ptr<nes::GamepadManager> gamepad_manager_;
-	std::shared_ptr<nes::Controller> controllers_;
+	nes::Controller *controllers_ = nullptr;
 
 	// GUI panels
 	std::unique_ptr<CPUStatePanel> cpu_panel_;
@@ -107,12 +189,31 @@ class GuiApplication {
 	std::string save_state_status_message_;
 	float save_state_status_timer_;
 
+	// Save-state and battery-save files are written here, off the emulation
+	// and UI threads; the status line reports a save once its write is done
+	std::unique_ptr<nes::AsyncFileWriter> file_writer_;
+	std::future<nes::FileWriteResult> pending_save_;
+	std::string pending_save_message_; // Shown when pending_save_ succeeds
+
+	// Screenshots are encoded and written off the GUI thread; recordings
+	// go through a FrameCapture fed by the emulation thread's frame
+	// callback (set and cleared only inside run_exclusive)
+	std::future<nes::FileWriteResult> pending_screenshot_;
+	std::string pending_screenshot_name_;
+	std::unique_ptr<nes::FrameCapture> frame_recording_;
+	unsigned int slot_thumbnail_texture_ = 0; // GL texture for the Load State menu's hover preview
+
 	// Battery-backed PRG-RAM (.sav) persistence — emulates the cartridge battery.
 	std::unique_ptr<nes::BatterySaveManager> battery_save_manager_;
+	// Reads ROMs and their .sav off this thread ahead of the swap, and keeps
+	// the last ones played mapped for instant relaunch
+	std::unique_ptr<nes::RomPreloader> rom_preloader_;
 
 	// Layout constants - Optimized for 1080p displays (1920x1080)
 	static constexpr int WINDOW_WIDTH = 1256; // widened so CRT mode (256*8/7*2≈585px) fits without clipping
 	static constexpr int WINDOW_HEIGHT = 1000;
+	static constexpr int GAME_WINDOW_WIDTH = 878; // 3x the NTSC-PAR picture (256*8/7*3)
+	static constexpr int GAME_WINDOW_HEIGHT = 720;
 	static constexpr float HEADER_HEIGHT = 25.0f;
 	static constexpr float LEFT_WIDTH = 310.0f;
 	static constexpr float CENTER_WIDTH = 610.0f;  // must hold 256*(8/7)*2≈585px + padding
@@ -126,6 +227,8 @@ class GuiApplication {
 	void handle_events();
 	void render_frame();
 	void render_main_menu_bar();
+	void render_crt_quality_menu();
+	void render_performance_window();
 	void cleanup();
 
 	// Fullscreen mode
@@ -139,18 +242,63 @@ class GuiApplication {
 	void start_emulation();
 	void pause_emulation();
 	void toggle_run_pause();
-	void process_continuous_emulation(double delta_seconds);
+	void update_fast_forward_state();
+	void set_rewind_enabled(bool enabled);
+	void set_rewinding(bool rewinding);
+	void update_emulation_thread();
+	void sync_emulation_run_state();
+	void run_exclusive(const std::function<void()> &fn);
 	bool can_run_emulation() const;
 	bool is_emulation_active() const;
+	// Pace From Audio, Late Input Polling or the clock, posted to the thread
+	void apply_pacing();
+	bool is_late_input_active() const;
+
+	// Idle (paused) redraw control: the loop blocks on SDL events unless a
+	// redraw was requested or something on screen is still changing
+	bool is_ui_animating() const;
+	void request_redraw();
+
+	// Components the debug panels should read this frame (live or shadow)
+	nes::CPU6502 *view_cpu() const;
+	nes::PPU *view_ppu() const;
+	nes::SystemBus *view_bus() const;
+	nes::Cartridge *view_cartridge() const;
 
 	// System reset
 	void reset_system();
 
+	// Swap buffers and record the presentation's latency
+	void present_frame();
+	std::chrono::steady_clock::time_point input_poll_before(std::chrono::steady_clock::time_point time) const;
+
+	// ROM loading: on_rom_loaded() re-syncs the system after any ROM swap
+	// (restoring the .sav from preloaded, if given, else from disk);
+	// load_launch_rom() loads the command-line ROM and starts it running
+	void on_rom_loaded(const nes::PreloadedRom *preloaded = nullptr);
+	bool load_launch_rom();
+	// Where the .sav for a ROM lives (BatterySaveManager's naming)
+	std::filesystem::path battery_save_path(const std::string &rom_path) const;
+	bool is_game_only_layout() const;
+
+	// Code/Data Logger: <battery dir>/<rom-stem>.cdl, merged on ROM load and
+	// written when the ROM is swapped, logging is turned off, or on exit
+	void set_code_data_logging(bool enabled);
+	void load_code_data_log();
+	void save_code_data_log();
+
 	// Save state operations
 	void save_state_to_slot(int slot);
 	void load_state_from_slot(int slot);
 	void quick_save();
 	void quick_load();
+	void check_pending_save();
+
+	// Captures (File menu, F12)
+	void take_screenshot();
+	void toggle_frame_recording();
+	bool is_recording_frames() const;
+	void render_slot_thumbnail(int slot);
 	void show_save_state_status(const std::string &message, bool success);
 };
 
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "audio/audio_recorder.hpp"
 #include "core/bus.hpp"
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <string>
 
 namespace nes {
 
@@ -11,8 +15,11 @@ namespace nes {
  * Provides GUI controls for audio settings:
  * - Enable/disable audio
  * - Volume control
+ * - Mix level of the cartridge's sound chip
  * - Visual audio level meter
  * - Sample rate and buffer info
+ * - Adaptive latency control and device timing stats
+ * - Recording the output (and per-channel stems) to WAV
  */
 class AudioPanel {
   public:
@@ -24,6 +31,9 @@ class AudioPanel {
 	 */
 	void render(SystemBus *bus);
 
+	/// Finish any recording in progress (emulation must be stopped or paused)
+	void stop_recording(SystemBus *bus);
+
   private:
 	float volume_slider_;	// Volume slider value [0.0, 1.0]
 	bool audio_enabled_;	// Audio enable checkbox
@@ -31,10 +41,19 @@ class AudioPanel {
 	int peak_hold_counter_; // Peak hold for level meter
 	bool first_render_;		// Track first render to sync state
 
+	// Recording
+	std::unique_ptr<AudioRecorder> recorder_;
+	std::array<char, 256> record_path_{"recording.wav"};
+	bool record_stems_ = false;
+	std::string record_status_;
+
 	// Render sub-components
 	void render_controls(SystemBus *bus);
+	void render_expansion(SystemBus *bus);
 	void render_level_meter(SystemBus *bus);
 	void render_info(SystemBus *bus);
+	void render_latency(SystemBus *bus);
+	void render_recording(SystemBus *bus);
 };
 
 } // namespace nes
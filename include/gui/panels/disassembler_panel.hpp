@@ -1,10 +1,12 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "cpu/disassembly_cache.hpp"
 
 // Forward declarations
 namespace nes {
 class CPU6502;
+class CpuProfiler;
 class SystemBus;
 } // namespace nes
 
@@ -30,23 +32,26 @@ class DisassemblerPanel {
 		return visible_;
 	}
 
+	// Drop the code log (call when a different ROM is loaded)
+	void reset_code_log() {
+		code_log_.clear();
+	}
+
   private:
 	bool visible_;
 	uint16_t follow_pc_;	 // Whether to follow program counter
 	uint16_t start_address_; // Starting address for disassembly
 
-	// Instruction alignment tracking to maintain consistency
-	uint16_t last_pc_;								  // Last PC we computed alignment for
-	size_t last_pc_index_;							  // Index of last_pc_ in cached_instruction_stream_
-	std::vector<uint16_t> cached_instruction_stream_; // Cached instruction addresses
-	bool alignment_valid_;							  // Whether our cached alignment is still valid
+	// Instruction starts seen executing (and decoded from there), per PRG
+	// bank; the listing walks these instead of re-aligning around the PC
+	nes::DisassemblyCache code_log_;
 
 	// Helper methods
 	void render_controls();
 	void render_instruction_list(const nes::CPU6502 *cpu, const nes::SystemBus *bus);
-	void render_single_instruction(uint16_t addr, uint16_t current_pc, const nes::SystemBus *bus);
-	std::vector<uint16_t> find_instructions_before_pc(uint16_t pc, const nes::SystemBus *bus, int count);
-	void update_instruction_stream(uint16_t pc, const nes::SystemBus *bus);
+	void render_single_instruction(uint16_t addr, uint16_t current_pc, const nes::SystemBus *bus,
+								   const nes::CpuProfiler *profiler);
+	void render_heat(uint16_t addr, const nes::CpuProfiler *profiler);
 };
 
 } // namespace nes::gui
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/types.hpp"
+#include <array>
+#include <bitset>
 
 // Forward declarations
 namespace nes {
@@ -12,6 +14,10 @@ namespace nes::gui {
 /**
  * Panel for viewing memory contents in hex format
  * Allows browsing different memory regions
+ *
+ * The visible rows are snapshotted once per frame with SystemBus::peek_range
+ * and drawn from the copy; bytes that differ from the previous frame's
+ * snapshot are highlighted.
  */
 class MemoryViewerPanel {
   public:
@@ -36,10 +42,22 @@ class MemoryViewerPanel {
 	uint16_t rows_to_show_;
 	bool scroll_to_address_; // Flag to trigger scroll jump
 
+	// Snapshot of the CPU address space. Only the rows on screen are
+	// refreshed; sampled_ marks what this frame read, was_sampled_ what the
+	// previous one did (previous_ holds those values).
+	std::array<uint8_t, 0x10000> current_{};
+	std::array<uint8_t, 0x10000> previous_{};
+	std::bitset<0x10000> sampled_;
+	std::bitset<0x10000> was_sampled_;
+
 	// Helper methods
 	void render_controls();
 	void render_memory_grid(const nes::SystemBus *bus);
-	void render_ascii_column(const nes::SystemBus *bus, uint16_t start_addr, uint16_t count);
+	void render_ascii_column(uint16_t start_addr, uint16_t count);
+	void take_snapshot(const nes::SystemBus *bus, uint32_t first, uint32_t count);
+	[[nodiscard]] bool changed(uint16_t address) const {
+		return was_sampled_[address] && previous_[address] != current_[address];
+	}
 };
 
 } // namespace nes::gui
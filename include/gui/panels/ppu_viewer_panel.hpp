@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "ppu/ppu_memory.hpp"
+#include "ppu/scanline_timeline.hpp"
 #ifdef _WIN32
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
@@ -8,12 +10,14 @@
 #endif
 #include <GL/gl.h>
 #include <SDL3/SDL.h>
+#include <array>
 #include <memory>
 
 // Forward declarations
 namespace nes {
 class PPU;
 class Cartridge;
+class NtscFilter;
 } // namespace nes
 
 namespace nes::gui {
@@ -52,6 +56,10 @@ class PPUViewerPanel {
 
 	// Render the main NES display
 	void render_main_display(nes::PPU *ppu);
+	// Same, from a frame handed over by the emulation thread. With indices
+	// (and an initialized CRT filter) the palette lookup runs on the GPU.
+	// The texture is only uploaded when frame_ready says the frame is new.
+	void render_main_display(const uint32_t *frame_buffer, bool frame_ready, const uint16_t *indices = nullptr);
 
 	// Show/hide panel
 	void set_visible(bool visible) {
@@ -81,6 +89,7 @@ class PPUViewerPanel {
 
 	// Update texture without rendering UI (for fullscreen mode)
 	void update_display_texture_only(nes::PPU *ppu);
+	void update_display_texture_only(const uint32_t *frame_buffer, bool frame_ready, const uint16_t *indices = nullptr);
 
 	// Vertical overscan crop (hide top/bottom 8 scanlines, like a CRT).
 	// NTSC active image is 256x224. Horizontal width is left FULL on purpose:
@@ -112,16 +121,30 @@ class PPUViewerPanel {
 		crt_filter_ = filter;
 	}
 
+	// Set NTSC composite filter for the main display (non-owning, nullptr = off)
+	void set_ntsc_filter(nes::NtscFilter *filter) {
+		if (filter != ntsc_filter_) {
+			display_stale_ = true; // Feed the new filter the frame on screen
+		}
+		ntsc_filter_ = filter;
+	}
+
+	// Per-scanline state for the scroll overlay, the background table and
+	// the scanline inspector (non-owning; null = the inspected PPU's own)
+	void set_scanline_timeline(const nes::ScanlineTimeline::Frame *frame) {
+		scanline_timeline_ = frame;
+	}
+
   private:
 	bool visible_;
 	PPUDisplayMode display_mode_;
 
 	// OpenGL textures for visualization
-	GLuint main_display_texture_;  // 256x240 NES output
+	GLuint main_display_texture_;  // 256x240 NES output (512x240 when NTSC filtered)
 	GLuint pattern_table_texture_; // Pattern tables visualization
 	GLuint nametable_texture_;	   // Nametables visualization
 
-	// Texture data buffers
+	// Texture data buffers (allocated with their textures)
 	std::unique_ptr<uint32_t[]> pattern_table_buffer_;
 	std::unique_ptr<uint32_t[]> nametable_buffer_;
 
@@ -131,28 +154,80 @@ class PPUViewerPanel {
 	int selected_palette_;				 // 0-7
 	float display_scale_;				 // Display scaling factor
 	bool pattern_table_dirty_;			 // Flag to track when to regenerate pattern table
+	bool nametable_dirty_ = true;		 // Redraw all four nametables on the next refresh
 	bool crop_vertical_overscan_ = true; // Hide top/bottom 8 scanlines (CRT overscan)
+	bool show_scroll_overlay_ = true;	 // Outline what each line showed on the nametables
+	int inspected_scanline_ = 0;
+	const nes::ScanlineTimeline::Frame *scanline_timeline_ = nullptr;
 	static constexpr int VERTICAL_OVERSCAN_CROP_LINES = 8;
 
 	// Rendering methods
 	void render_display_controls();
 	void render_ppu_registers(nes::PPU *ppu);
 	void render_timing_info(nes::PPU *ppu);
+	void render_scanline_inspector(const nes::PPU *ppu);
+	void draw_scroll_overlay(const nes::PPU *ppu, float left, float top, float scale) const;
+	[[nodiscard]] const nes::ScanlineTimeline::Frame &timeline_of(const nes::PPU *ppu) const;
+	[[nodiscard]] uint16_t background_table_of(const nes::PPU *ppu) const;
 
 	// Helper methods
-	void initialize_textures();
+	// Each texture is created the first time a view shows it; the 512x480
+	// nametable texture only exists once the nametable view is opened
+	static GLuint create_view_texture(int width, int height);
+	void ensure_main_display_texture();
+	void ensure_pattern_table_texture();
+	void ensure_nametable_texture();
 	void cleanup_textures();
-	void update_main_display_texture(const uint32_t *frame_buffer);
+	bool take_display_change(const nes::PPU *ppu);
+	void upload_main_display(const uint32_t *frame_buffer, bool frame_changed, const uint16_t *indices);
+	void update_main_display_texture(const uint32_t *frame_buffer, const uint16_t *indices);
+	void main_display_written();
+	void present_ntsc_frame(const uint32_t *frame_buffer);
+	void resize_main_display_texture(int width);
 	void update_pattern_table_texture();
 	void generate_pattern_table_visualization(nes::PPU *ppu, nes::Cartridge *cartridge);
 	void generate_nametable_visualization(nes::PPU *ppu);
 	uint32_t get_pattern_pixel_color(uint8_t pixel_value, uint8_t palette_index, nes::PPU *ppu);
 
-	// Texture management
-	bool textures_initialized_;
+	// Dirty-region refresh: changes taken from PPUMemory once per frame and
+	// kept per view, so a view that is not shown catches up when it is
+	void collect_dirty_regions(nes::PPU *ppu);
+	void refresh_pattern_table(nes::PPU *ppu, nes::Cartridge *cartridge, bool full_redraw);
+	void refresh_nametables(nes::PPU *ppu);
+	void draw_pattern_tile(nes::PPU *ppu, int tile_x, int tile_y);
+	void draw_nametable_tile(nes::PPU *ppu, int nametable, int tile_x, int tile_y);
+	static void upload_texture_tile(GLuint texture, const uint32_t *buffer, int buffer_width, int x, int y);
+
+	const nes::PPU *tracked_ppu_ = nullptr;
+	nes::PPUMemory::PatternTileMask pattern_view_tiles_{};	 // Changed since the pattern view last drew
+	nes::PPUMemory::PatternTileMask nametable_view_tiles_{}; // Changed since the nametable view last drew
+	nes::PPUMemory::VramByteMask nametable_view_vram_{};
+	// What the textures were last drawn with
+	int drawn_pattern_table_ = -1;
+	int drawn_palette_ = -1;
+	uint32_t drawn_pattern_palette_generation_ = 0;
+	uint32_t drawn_nametable_palette_generation_ = 0;
+	uint16_t drawn_background_table_ = 0;
+	std::array<uint16_t, 4> drawn_nametable_pages_{};
 
 	// CRT display filter (non-owning, set by GuiApplication)
 	CRTFilter *crt_filter_ = nullptr;
+
+	// NTSC composite filter (non-owning, set by GuiApplication). Frames are
+	// submitted as they arrive and shown once the workers finish them.
+	nes::NtscFilter *ntsc_filter_ = nullptr;
+	unsigned ntsc_burst_phase_ = 0;
+	bool ntsc_frame_shown_ = false; // Texture holds a filtered frame
+	int main_display_width_ = 256;
+
+	// What the main display texture last took from a live PPU: its frame
+	// generation and, outside Frame Complete mode, the beam position. A GUI
+	// frame that finds both unchanged (paused, or a refresh rate above the
+	// PPU's) uploads nothing.
+	uint64_t uploaded_generation_ = 0;
+	uint32_t uploaded_beam_ = 0;
+	PPUDisplayMode uploaded_mode_ = PPUDisplayMode::FRAME_COMPLETE;
+	bool display_stale_ = true; // Upload on the next render whatever the PPU says
 };
 
 } // namespace nes::gui
@@ -1,12 +1,20 @@
 #pragma once
 
+#include "cartridge/rom_library.hpp"
+#include "cartridge/rom_loader.hpp"
+#include <cstdint>
+#include <filesystem>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 // Forward declarations
 namespace nes {
 class Cartridge;
-}
+class RomPreloader;
+struct PreloadedRom;
+} // namespace nes
 
 namespace nes::gui {
 
@@ -23,11 +31,19 @@ class RomLoaderPanel {
 	void render(nes::Cartridge *cartridge);
 	void reset_to_default_directory();
 
-	// Set callback for when ROM is successfully loaded
-	void set_rom_loaded_callback(std::function<void()> callback) {
+	// Set callback for when ROM is successfully loaded; it is handed the
+	// preloaded ROM (with its .sav) when there is a preloader, else null
+	void set_rom_loaded_callback(std::function<void(const nes::PreloadedRom *)> callback) {
 		rom_loaded_callback_ = std::move(callback);
 	}
 
+	// Start reading a file (and its .sav in save_directory) as soon as it is
+	// selected, so loading it only swaps the cartridge
+	void set_rom_preloader(nes::RomPreloader *preloader, std::filesystem::path save_directory) {
+		preloader_ = preloader;
+		save_directory_ = std::move(save_directory);
+	}
+
 	// Panel visibility
 	void set_visible(bool visible) {
 		visible_ = visible;
@@ -44,11 +60,29 @@ class RomLoaderPanel {
 	std::string current_directory_;
 	std::string filter_extension_ = ".nes";
 
+	// Header of selected_file_, read (16 bytes only) when the selection changes
+	std::string header_file_;
+	nes::RomData selected_header_{};
+	bool selected_header_valid_ = false;
+
+	// Index of the default ROM directory, rescanned in the background when
+	// the panel is created; search results are redone only when the query or
+	// the library changes
+	std::unique_ptr<nes::RomLibrary> library_;
+	char library_query_[128] = {};
+	std::string results_query_;
+	std::uint64_t results_generation_ = ~0ull;
+	std::vector<nes::RomLibrary::Entry> library_results_;
+
 	// Callback for ROM loading events
-	std::function<void()> rom_loaded_callback_;
+	std::function<void(const nes::PreloadedRom *)> rom_loaded_callback_;
+
+	nes::RomPreloader *preloader_ = nullptr;
+	std::filesystem::path save_directory_;
 
 	// ROM info display
 	void render_file_browser(nes::Cartridge *cartridge);
+	void render_library(nes::Cartridge *cartridge);
 	void render_rom_info(nes::Cartridge *cartridge);
 	void render_load_button(nes::Cartridge *cartridge);
 
@@ -56,6 +90,8 @@ class RomLoaderPanel {
 	bool is_nes_file(const std::string &filename) const;
 	std::string get_file_extension(const std::string &filename) const;
 	void find_default_rom_directory();
+	void select(const std::string &path);
+	void load_selected(nes::Cartridge *cartridge);
 };
 
 } // namespace nes::gui
@@ -1,11 +1,16 @@
 #pragma once
 
+#include "core/bus_stats.hpp"
 #include "core/types.hpp"
+#include <array>
 #include <memory>
+#include <string>
 
 // Forward declarations
 namespace nes {
 class CPU6502;
+class FrameLatency;
+class PerfCounters;
 class PPU;
 class SystemBus;
 } // namespace nes
@@ -14,7 +19,12 @@ namespace nes::gui {
 
 /**
  * Panel for displaying timing information for CPU and PPU
- * Shows cycle counts, frequencies, and synchronization status
+ * Shows cycle counts, frequencies, and synchronization status, plus rolling
+ * graphs of where each frame's time went (PerfCounters) with CSV export and,
+ * in builds with VIBENES_TRACE_ZONES, Chrome trace captures. Builds with
+ * VIBENES_BUS_STATS add the CPU bus and PPU fetch counters (BusStats).
+ * Frame pacing and input-to-present latency percentiles come from
+ * FrameLatency.
  */
 class TimingPanel {
   public:
@@ -31,26 +41,36 @@ class TimingPanel {
 	 * Render the timing panel
 	 * @param cpu Pointer to CPU instance (can be nullptr)
 	 * @param ppu Pointer to PPU instance (can be nullptr)
-	 * @param bus Pointer to system bus (can be nullptr)
+	 * @param counters Per-frame performance counters (can be nullptr)
+	 * @param bus Pointer to the system bus, for its traffic counters (can be nullptr)
+	 * @param latency Presentation latency histograms (can be nullptr)
 	 */
-	void render(nes::CPU6502 *cpu, nes::PPU *ppu, nes::SystemBus *bus);
+	void render(nes::CPU6502 *cpu, nes::PPU *ppu, nes::PerfCounters *counters, const nes::SystemBus *bus,
+				nes::FrameLatency *latency);
 
   private:
-	// Timing tracking
-	std::uint64_t last_cpu_cycles_;
-	std::uint64_t last_ppu_cycles_;
-	std::uint64_t frame_count_;
+	// CSV export, and Chrome trace captures in builds with trace zones
+	std::array<char, 256> csv_path_{"performance.csv"};
+	std::string csv_status_;
+	std::array<char, 256> trace_path_{"trace.json"};
+	std::string trace_status_;
+	std::array<char, 256> latency_path_{"latency.csv"};
+	std::string latency_status_;
 
-	// Performance tracking
-	float cpu_frequency_hz_;
-	float ppu_frequency_hz_;
-	float frame_rate_fps_;
+	// Bus traffic is shown relative to these; "Reset" moves them to now
+	nes::BusStats bus_baseline_;
+	nes::PpuFetchStats fetch_baseline_;
+	std::uint64_t baseline_frame_ = 0;
 
 	// Helper methods
 	void render_cpu_timing(nes::CPU6502 *cpu);
 	void render_ppu_timing(nes::PPU *ppu);
-	void render_synchronization_info(nes::CPU6502 *cpu, nes::PPU *ppu);
-	void render_performance_metrics();
+	void render_synchronization_info(nes::PPU *ppu, const nes::PerfCounters *counters);
+	void render_performance_metrics(nes::PerfCounters *counters);
+	void render_export(const nes::PerfCounters &counters);
+	void render_trace_capture();
+	void render_latency(nes::FrameLatency *latency);
+	void render_bus_traffic(const nes::SystemBus *bus, const nes::PPU *ppu);
 
 	// Format helpers
 	std::string format_cycles(std::uint64_t cycles) const;
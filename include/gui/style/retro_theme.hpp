@@ -42,6 +42,9 @@ class RetroTheme {
 
 	/// Get color for general values
 	static ImVec4 get_value_color();
+
+	/// Get color for values that changed since the last frame
+	static ImVec4 get_changed_value_color();
 };
 
 } // namespace nes::gui
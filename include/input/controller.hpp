@@ -2,26 +2,36 @@
 
 #include "core/component.hpp"
 #include "core/types.hpp"
-#include "input/gamepad_manager.hpp"
+#include "input/input_source.hpp"
+#include <array>
 #include <memory>
 
 namespace nes {
 
+class PPU;
+
+// What is plugged into a controller port
+enum class PortDevice : std::uint8_t {
+	StandardPad,
+	Zapper,			// Light gun: $4016/$4017 D3 = no light, D4 = trigger
+	ArkanoidPaddle, // Vaus controller: D3 = button, D4 = knob position (serial)
+	None,
+};
+
+// Both ports, and whether a Four Score multitap sits in front of them
+struct InputSetup {
+	PortDevice port1 = PortDevice::StandardPad;
+	PortDevice port2 = PortDevice::StandardPad;
+	bool four_score = false; // Players 3 and 4 on the pads' ports
+};
+
 /**
- * NES Controller button bits
- * Standard NES controller has 8 buttons read in this order:
- * A, B, Select, Start, Up, Down, Left, Right
+ * The setup an NES 2.0 header's default expansion device asks for (byte 15):
+ * the Four Score (2), Zapper in port 2 (8) or both ports (9), Arkanoid
+ * paddle in port 2 (15). Anything else, including the Famicom devices, gets
+ * two standard pads.
  */
-enum class NESButton : uint8_t {
-	A = 0,		// Bit 0
-	B = 1,		// Bit 1
-	SELECT = 2, // Bit 2
-	START = 3,	// Bit 3
-	UP = 4,		// Bit 4
-	DOWN = 5,	// Bit 5
-	LEFT = 6,	// Bit 6
-	RIGHT = 7	// Bit 7
-};
+[[nodiscard]] InputSetup input_setup_for_expansion_device(std::uint8_t device) noexcept;
 
 /**
  * Controller - NES controller input handling
@@ -39,14 +49,35 @@ enum class NESButton : uint8_t {
  * 1. Write $01 to $4016 (strobe high - start reading)
  * 2. Write $00 to $4016 (strobe low - latch button states)
  * 3. Read $4016 8 times to get button states in order: A, B, Select, Start, Up, Down, Left, Right
+ *
+ * When the input source publishes a button snapshot (LatchedInputSource),
+ * latching the ports is one atomic load; other sources are asked through
+ * InputSource::read_buttons().
+ *
+ * Other devices (configure()):
+ * - Four Score: each port shifts out 24 bits, its own pad, then player 3's
+ *   (or 4's), then a signature ($10 on $4016, $20 on $4017). Same path as a
+ *   plain pad, only longer.
+ * - Zapper: reads the PPU's output around the pixel it aims at (connect_ppu()).
+ *   Light is seen when that pixel is bright and the beam drew it within the
+ *   last ZAPPER_LIGHT_LINES lines, as the photodiode's afterglow allows.
+ * - Arkanoid paddle: the knob position, latched on the strobe like a pad and
+ *   shifted out inverted, most significant bit first.
+ * Pads on both ports, with or without the Four Score, take none of the
+ * device checks: every read that is not a pad's is behind one branch.
  */
 class Controller final : public Component {
   public:
+	// Sensor sensitivity: luma (0-255) that reads as light
+	static constexpr int ZAPPER_LIGHT_LUMA = 0x80;
+	// How long after the beam passes the sensor still sees light, in lines
+	static constexpr int ZAPPER_LIGHT_LINES = 20;
+
 	/**
 	 * Constructor
-	 * @param gamepad_manager Shared gamepad manager for reading input
+	 * @param input_source Shared button state provider (may be null for no input)
 	 */
-	explicit Controller(std::shared_ptr<GamepadManager> gamepad_manager);
+	explicit Controller(std::shared_ptr<InputSource> input_source);
 
 	// Component interface
 	void tick(CpuCycle cycles) override;
@@ -71,28 +102,51 @@ class Controller final : public Component {
 
 	/**
 	 * Get current button states for debugging
-	 * @param controller_index 0 for controller 1, 1 for controller 2
+	 * @param controller_index 0 for controller 1, 1 for controller 2 (2-3 for
+	 *                         the Four Score's players)
 	 * @return 8-bit button state mask
 	 */
 	[[nodiscard]] Byte get_button_states(int controller_index) const noexcept;
 
+	// Plug devices in; takes effect at the next strobe
+	void configure(const InputSetup &setup) noexcept;
+	[[nodiscard]] const InputSetup &setup() const noexcept {
+		return setup_;
+	}
+
+	// The PPU a Zapper looks at
+	void connect_ppu(const PPU *ppu) noexcept {
+		ppu_ = ppu;
+	}
+	// Whether reads depend on the PPU's progress (a Zapper is plugged in), so
+	// the bus must bring the PPU up to date before them
+	[[nodiscard]] bool reads_ppu() const noexcept {
+		return reads_ppu_;
+	}
+
   private:
-	std::shared_ptr<GamepadManager> gamepad_manager_;
+	std::shared_ptr<InputSource> input_source_;
+	const std::atomic<std::uint32_t> *button_snapshot_ = nullptr; // input_source_'s, if it has one
+	const PPU *ppu_ = nullptr;
+
+	InputSetup setup_;
+	bool pads_only_ = true;	 // Both ports hold standard pads
+	bool reads_ppu_ = false; // A Zapper is plugged in
+	int shift_length_ = 8;	 // Bits a pad port shifts out (24 with the Four Score)
 
 	// Controller state
-	bool strobe_ = false;				   // Strobe latch signal
-	mutable Byte shift_register_1_ = 0x00; // Controller 1 shift register
-	mutable Byte shift_register_2_ = 0x00; // Controller 2 shift register
-	mutable int shift_count_1_ = 0;		   // Current bit position for controller 1
-	mutable int shift_count_2_ = 0;		   // Current bit position for controller 2
+	bool strobe_ = false;								 // Strobe latch signal
+	mutable std::array<std::uint32_t, 2> shift_registers_{}; // Per port
+	mutable std::array<int, 2> shift_counts_{};			 // Current bit position per port
 
-	// Latched button states
-	Byte button_states_1_ = 0x00; // Controller 1 button states
-	Byte button_states_2_ = 0x00; // Controller 2 button states
+	// Latched button states, players 1-4
+	std::array<Byte, 4> button_states_{};
 
 	// Helper methods
 	void latch_button_states();
 	[[nodiscard]] Byte read_gamepad_state(int player_index) const noexcept;
+	[[nodiscard]] Byte read_device(int port) const noexcept;
+	[[nodiscard]] bool zapper_sees_light(const PointerState &aim) const noexcept;
 };
 
 } // namespace nes
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "input/input_source.hpp"
 #include <SDL3/SDL.h>
 #include <cstdint>
 #include <vector>
@@ -14,11 +15,12 @@ namespace nes {
  * - Hot-plugging support (connect/disconnect at runtime)
  * - Button state reading
  * - Multiple controller support (Player 1 and Player 2)
+ * - Mapping modern gamepad buttons onto the NES button layout (InputSource)
  */
-class GamepadManager {
+class GamepadManager : public InputSource {
   public:
 	GamepadManager();
-	virtual ~GamepadManager();
+	~GamepadManager() override;
 
 	// Delete copy/move to prevent double-free of SDL resources
 	GamepadManager(const GamepadManager &) = delete;
@@ -72,6 +74,13 @@ class GamepadManager {
 	 */
 	virtual bool is_button_pressed(int player_index, SDL_GamepadButton button) const;
 
+	/**
+	 * Read the NES button mask for a player (InputSource interface)
+	 * @param player_index 0 for Player 1, 1 for Player 2
+	 * @return 8-bit mask using NESButton bit positions
+	 */
+	[[nodiscard]] Byte read_buttons(int player_index) const override;
+
 	/**
 	 * Get number of connected controllers
 	 */
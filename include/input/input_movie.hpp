@@ -0,0 +1,132 @@
+#pragma once
+
+#include "input/input_source.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace nes {
+
+/**
+ * Input movies (.vnmovie) - per-frame controller input for bit-exact replays
+ *
+ * Recording and playback both advance one frame at a time: the owner calls
+ * next_frame() before running each frame, and the masks it selects are what
+ * read_buttons() returns for the whole frame. The Controller reads its
+ * source only when it latches (strobe falling edge) or while strobed, so
+ * wherever in the frame the game latches it sees exactly the recorded
+ * masks, and a replay from the same start state is bit-exact.
+ *
+ * A file is a MovieHeader, start_state_size bytes of save state
+ * (SaveStateManager::serialize_state(); none = the movie starts at
+ * power-on) and then the input as runs of identical frames:
+ *
+ *   [player 1 mask][player 2 mask][frame count, LEB128] ...
+ *
+ * All fields little-endian.
+ */
+struct MovieHeader {
+	char magic[8] = {'V', 'N', 'M', 'O', 'V', 'I', 'E', '\0'};
+	std::uint32_t version = 1;
+	std::uint32_t rom_crc32 = 0;		// SaveStateManager::calculate_rom_crc32()
+	std::uint64_t frame_count = 0;		// Written when the recorder closes
+	std::uint32_t start_state_size = 0; // Bytes of save state after the header
+	std::uint32_t reserved = 0;
+};
+static_assert(sizeof(MovieHeader) == 32, "MovieHeader is an on-disk format");
+
+/**
+ * MovieRecorder - Records another input source into a .vnmovie file
+ *
+ * Installed as the Controller's input source in place of the one it wraps;
+ * next_frame() samples the wrapped source once for the coming frame and
+ * streams it out. Runs are written as they end, so memory use does not grow
+ * with the movie's length.
+ */
+class MovieRecorder final : public InputSource {
+  public:
+	explicit MovieRecorder(std::shared_ptr<InputSource> source);
+	~MovieRecorder() override;
+	MovieRecorder(const MovieRecorder &) = delete;
+	MovieRecorder &operator=(const MovieRecorder &) = delete;
+
+	/**
+	 * Create the movie file and write its header
+	 * @param start_state Save state the movie starts from (empty = power-on)
+	 */
+	bool open(const std::filesystem::path &path, std::uint32_t rom_crc32,
+			  const std::vector<std::uint8_t> &start_state = {});
+	/// Write the last run and the frame count. Returns false if any write failed.
+	bool close();
+	[[nodiscard]] bool is_open() const noexcept {
+		return file_.is_open();
+	}
+
+	// Sample the wrapped source for the coming frame and record it
+	void next_frame();
+
+	[[nodiscard]] Byte read_buttons(int player_index) const override;
+
+	[[nodiscard]] std::uint64_t get_frames_recorded() const noexcept {
+		return frames_;
+	}
+
+  private:
+	std::shared_ptr<InputSource> source_;
+	std::ofstream file_;
+	std::array<Byte, 2> current_{};
+	std::uint64_t run_length_ = 0; // Frames of current_ not written yet
+	std::uint64_t frames_ = 0;
+
+	void write_run();
+};
+
+/**
+ * MoviePlayer - Plays a .vnmovie file back as an input source
+ *
+ * Reads runs from the file as playback reaches them. Past the end of the
+ * movie no buttons are pressed.
+ */
+class MoviePlayer final : public InputSource {
+  public:
+	/**
+	 * Open a movie and read its header and start state
+	 * @return false if the file cannot be read or is not a movie
+	 */
+	bool open(const std::filesystem::path &path);
+
+	[[nodiscard]] const MovieHeader &get_header() const noexcept {
+		return header_;
+	}
+	// Save state to load before the first frame (empty = power-on)
+	[[nodiscard]] const std::vector<std::uint8_t> &get_start_state() const noexcept {
+		return start_state_;
+	}
+
+	/**
+	 * Select the next frame's masks
+	 * @return false once the movie has run out (buttons then read as released)
+	 */
+	bool next_frame();
+
+	[[nodiscard]] Byte read_buttons(int player_index) const override;
+
+	[[nodiscard]] std::uint64_t get_frames_played() const noexcept {
+		return frames_;
+	}
+
+  private:
+	std::ifstream file_;
+	MovieHeader header_;
+	std::vector<std::uint8_t> start_state_;
+	std::array<Byte, 2> current_{};
+	std::uint64_t run_remaining_ = 0;
+	std::uint64_t frames_ = 0;
+
+	bool read_run();
+};
+
+} // namespace nes
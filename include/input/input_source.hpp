@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace nes {
+
+/**
+ * NES Controller button bits
+ * Standard NES controller has 8 buttons read in this order:
+ * A, B, Select, Start, Up, Down, Left, Right
+ */
+enum class NESButton : uint8_t {
+	A = 0,		// Bit 0
+	B = 1,		// Bit 1
+	SELECT = 2, // Bit 2
+	START = 3,	// Bit 3
+	UP = 4,		// Bit 4
+	DOWN = 5,	// Bit 5
+	LEFT = 6,	// Bit 6
+	RIGHT = 7	// Bit 7
+};
+
+/**
+ * Where a light gun points, or a paddle's knob stands, for one controller port
+ */
+struct PointerState {
+	// Zapper: the NES pixel aimed at, -1 when off screen. Arkanoid paddle: x
+	// is the knob position (0-255; the game reads about $62-$F2), y unused.
+	std::int16_t x = -1;
+	std::int16_t y = -1;
+	bool fire = false; // Zapper trigger, paddle button
+};
+
+/**
+ * InputSource - Abstract provider of NES button states
+ *
+ * Decouples the Controller shift registers from any particular input device.
+ * The SDL front end implements this with GamepadManager; headless builds can
+ * supply scripted or recorded input without pulling in SDL.
+ */
+class InputSource {
+  public:
+	virtual ~InputSource() = default;
+
+	/**
+	 * Read the current button states for a player
+	 * @param player_index 0 for Player 1, 1 for Player 2, 2-3 for the Four
+	 *                     Score's players 3 and 4
+	 * @return 8-bit mask using NESButton bit positions (0 if disconnected)
+	 */
+	[[nodiscard]] virtual Byte read_buttons(int player_index) const = 0;
+
+	/**
+	 * Aim and trigger of a Zapper, or an Arkanoid paddle, on a port
+	 * @param port_index 0 for $4016, 1 for $4017
+	 */
+	[[nodiscard]] virtual PointerState read_pointer(int port_index) const {
+		(void)port_index;
+		return {};
+	}
+
+	/**
+	 * Sources that publish their masks ahead of time can expose them as one
+	 * word, player 1 in the low byte up to player 4 in the high byte. The
+	 * Controller then latches its ports with a single atomic load instead
+	 * of calling read_buttons(). The word must outlive the source.
+	 * @return null (the default) to be read through read_buttons()
+	 */
+	[[nodiscard]] virtual const std::atomic<std::uint32_t> *button_snapshot() const noexcept {
+		return nullptr;
+	}
+};
+
+} // namespace nes
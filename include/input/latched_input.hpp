@@ -0,0 +1,83 @@
+#pragma once
+
+#include "input/input_source.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace nes {
+
+/**
+ * LatchedInputSource - Button masks set explicitly by the owner
+ *
+ * Used when the device that produces input lives on another thread: the
+ * front end polls its gamepads and forwards the masks (EmulationThread does
+ * it through its command queue), and the Controller only ever reads the
+ * latched copy on the emulation thread.
+ *
+ * All four players live in one atomic word that the Controller loads
+ * directly on every $4016 strobe (see button_snapshot()), so a game that
+ * strobes several times a frame costs no virtual calls, and set_all() can
+ * publish a frame's input from any thread. Pointer states (Zapper, paddle)
+ * are atomic too: a light gun's aim can be moved from the front end at any
+ * time, as a real one is.
+ */
+class LatchedInputSource final : public InputSource {
+  public:
+	static constexpr int PLAYERS = 4;
+
+	// Replace one player's mask; single writer (the other bytes are kept)
+	void set_buttons(int player_index, Byte buttons) noexcept {
+		if (player_index < 0 || player_index >= PLAYERS) {
+			return;
+		}
+		const int shift = player_index * 8;
+		const std::uint32_t others = buttons_.load(std::memory_order_relaxed) & ~(0xFFu << shift);
+		buttons_.store(others | (static_cast<std::uint32_t>(buttons) << shift), std::memory_order_release);
+	}
+
+	// Players 1 and 2 in one store (3 and 4 released)
+	void set_all(Byte player1, Byte player2) noexcept {
+		buttons_.store(static_cast<std::uint32_t>(player1 | (player2 << 8)), std::memory_order_release);
+	}
+
+	[[nodiscard]] Byte read_buttons(int player_index) const override {
+		if (player_index < 0 || player_index >= PLAYERS) {
+			return 0;
+		}
+		return static_cast<Byte>(buttons_.load(std::memory_order_acquire) >> (player_index * 8));
+	}
+
+	[[nodiscard]] const std::atomic<std::uint32_t> *button_snapshot() const noexcept override {
+		return &buttons_;
+	}
+
+	void set_pointer(int port_index, PointerState state) noexcept {
+		if (port_index < 0 || port_index >= static_cast<int>(pointers_.size())) {
+			return;
+		}
+		const std::uint64_t packed = static_cast<std::uint16_t>(state.x) |
+									 (static_cast<std::uint64_t>(static_cast<std::uint16_t>(state.y)) << 16) |
+									 (static_cast<std::uint64_t>(state.fire) << 32);
+		pointers_[static_cast<std::size_t>(port_index)].store(packed, std::memory_order_release);
+	}
+
+	[[nodiscard]] PointerState read_pointer(int port_index) const override {
+		if (port_index < 0 || port_index >= static_cast<int>(pointers_.size())) {
+			return {};
+		}
+		const std::uint64_t packed = pointers_[static_cast<std::size_t>(port_index)].load(std::memory_order_acquire);
+		PointerState state;
+		state.x = static_cast<std::int16_t>(packed & 0xFFFF);
+		state.y = static_cast<std::int16_t>((packed >> 16) & 0xFFFF);
+		state.fire = ((packed >> 32) & 1) != 0;
+		return state;
+	}
+
+  private:
+	std::atomic<std::uint32_t> buttons_{0};
+	// x and y as 16-bit fields, fire in bit 32; starts off screen
+	std::array<std::atomic<std::uint64_t>, 2> pointers_{0xFFFFFFFFull, 0xFFFFFFFFull};
+};
+
+} // namespace nes
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "input/input_source.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace nes {
+
+/**
+ * ReplayInputSource - Plays back recorded button states frame by frame
+ *
+ * Input files are plain text, one change per line:
+ *
+ *     # frame  p1  [p2]        (hex masks in NESButton bit order)
+ *     0        00
+ *     120      08              # Start pressed on frame 120
+ *     126      00
+ *
+ * A mask stays held until the next line. The owner calls set_frame() before
+ * running each frame so playback stays locked to emulated time, which keeps
+ * benchmark and regression runs deterministic.
+ */
+class ReplayInputSource final : public InputSource {
+  public:
+	/**
+	 * Load a replay file, replacing any previous events
+	 * @return false if the file cannot be read or a line fails to parse
+	 */
+	bool load_from_file(const std::filesystem::path &path);
+
+	// Select the frame whose inputs read_buttons() reports
+	void set_frame(uint64_t frame) noexcept;
+
+	[[nodiscard]] Byte read_buttons(int player_index) const override;
+
+	[[nodiscard]] std::size_t get_event_count() const noexcept {
+		return events_.size();
+	}
+
+  private:
+	struct Event {
+		uint64_t frame = 0;
+		std::array<Byte, 2> buttons{};
+	};
+
+	std::vector<Event> events_; // Sorted by frame
+	std::array<Byte, 2> current_{};
+};
+
+} // namespace nes
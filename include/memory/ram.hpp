@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <vector>
 
 namespace nes {
 
@@ -86,6 +87,12 @@ class Ram final : public Component {
 		memory_[mirrored_addr] = value;
 	}
 
+	/// Raw RAM storage for the bus's zero page/stack fast path; stable for the
+	/// lifetime of this object (unmirrored, RAM_SIZE bytes)
+	[[nodiscard]] Byte *data() noexcept {
+		return memory_.data();
+	}
+
 	/// Get direct access to RAM for debugging
 	[[nodiscard]] const std::array<Byte, RAM_SIZE> &get_memory() const noexcept {
 		return memory_;
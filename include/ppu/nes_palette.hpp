@@ -3,9 +3,6 @@
 #include "core/types.hpp"
 #include <array>
 
-// Forward declaration for ImGui
-struct ImVec4;
-
 namespace nes {
 
 /// NES Master Palette - The 64 possible colors the NES can display
@@ -18,9 +15,6 @@ class NESPalette {
 	/// Get RGBA color for ImGui/OpenGL display
 	static uint32_t get_rgba_color(uint8_t nes_color_index);
 
-	/// Convert NES color to ImVec4 for ImGui
-	static ImVec4 get_imgui_color(uint8_t nes_color_index);
-
   private:
 	/// The complete NES color palette (64 colors, RGB format)
 	static constexpr std::array<uint32_t, 64> NES_COLORS = {
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "system/triple_buffer.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+/**
+ * NtscFilter - Composite video artifacts from the PPU's palette index frame
+ *
+ * Each index entry (color | emphasis << 6, see PPU::get_index_buffer()) is
+ * turned into the 2C02's composite signal, 8 samples per pixel on a
+ * 12-sample color subcarrier, and decoded back to RGB with box filters
+ * (luma over 12 samples, chroma over 24), as in the nesdev "NTSC video"
+ * reference. Decoding is linear, so the contribution of one input pixel to
+ * the output row depends only on its entry and subcarrier phase: those are
+ * precomputed into 512 x 3 kernels of 8 output pixels each, and filtering a
+ * row is one table-driven accumulation per input pixel. The output is
+ * 512x240 ABGR (two samples per NES pixel horizontally).
+ *
+ * submit()/take_finished_frame() run the filter on a worker pool, each
+ * worker taking a horizontal strip. Neither call waits: a frame submitted
+ * while the previous one is still being filtered is dropped, and the reader
+ * always gets the newest finished frame. Single submitting thread and single
+ * reading thread (they may be the same one).
+ */
+class NtscFilter {
+  public:
+	static constexpr int INPUT_WIDTH = 256;
+	static constexpr int HEIGHT = 240;
+	static constexpr int OUTPUT_WIDTH = INPUT_WIDTH * 2;
+	using OutputFrame = std::array<uint32_t, OUTPUT_WIDTH * HEIGHT>;
+
+	/// @param workers Worker threads (0 = leave two cores for emulation and
+	///                rendering, between 1 and 4)
+	explicit NtscFilter(unsigned workers = 0);
+	~NtscFilter();
+	NtscFilter(const NtscFilter &) = delete;
+	NtscFilter &operator=(const NtscFilter &) = delete;
+
+	/**
+	 * Start filtering a 256x240 index frame on the workers
+	 * @param burst_phase Color burst phase of the frame's first line (0-2);
+	 *                    alternating it per frame lets the artifacts average out
+	 * @return false if the previous frame is still in progress (frame dropped)
+	 */
+	bool submit(const uint16_t *indices, unsigned burst_phase);
+
+	/// Newest finished frame (OUTPUT_WIDTH x HEIGHT) if one finished since the
+	/// last call, else nullptr. Valid until the next call.
+	[[nodiscard]] const uint32_t *take_finished_frame();
+
+	/// Filter a whole frame on the calling thread
+	void filter_frame(const uint16_t *indices, unsigned burst_phase, uint32_t *output) const;
+
+	[[nodiscard]] unsigned worker_count() const noexcept {
+		return static_cast<unsigned>(workers_.size());
+	}
+
+  private:
+	// One output pixel's RGB contribution (pad lane keeps taps SIMD-sized)
+	struct alignas(16) Tap {
+		int32_t r, g, b, pad;
+	};
+	static constexpr int TAPS = 8;		   // Output pixels one input pixel reaches
+	static constexpr int TAP_OFFSET = -3; // First tap relative to output pixel 2x
+	static constexpr int PHASES = 3;	   // Pixel start phase (0, 4 or 8 samples)
+	static constexpr int ENTRIES = 512;	   // Color (6 bits) + emphasis (3 bits)
+	static constexpr int FRACTION_BITS = 8;
+
+	std::vector<Tap> kernels_; // [phase][entry][tap]
+
+	void build_kernels();
+	void filter_rows(const uint16_t *indices, unsigned burst_phase, int first_row, int row_count,
+					 uint32_t *output) const;
+	const Tap *kernel(int phase, uint16_t entry) const noexcept {
+		return &kernels_[(static_cast<size_t>(phase) * ENTRIES + (entry & (ENTRIES - 1))) * TAPS];
+	}
+
+	// Worker pool: submit() bumps generation_, every worker filters its strip
+	// of input_ into the frames_ write slot and the last one to finish
+	// publishes it
+	void worker_main(unsigned index, unsigned count);
+	std::vector<std::thread> workers_;
+	std::array<uint16_t, INPUT_WIDTH * HEIGHT> input_{};
+	unsigned input_phase_ = 0;
+	std::unique_ptr<TripleBuffer<OutputFrame>> frames_;
+	std::atomic<uint32_t> generation_{0};
+	std::atomic<unsigned> strips_remaining_{0};
+	std::atomic<bool> busy_{false};
+	std::atomic<bool> stop_{false};
+};
+
+} // namespace nes
@@ -1,11 +1,18 @@
 #pragma once
 
+#include "core/accuracy.hpp"
+#include "core/bus_stats.hpp"
 #include "core/component.hpp"
+#include "core/region.hpp"
 #include "core/types.hpp"
 #include "ppu/ppu_memory.hpp"
 #include "ppu/ppu_registers.hpp"
+#include "ppu/scanline_timeline.hpp"
 #include <array>
 #include <memory>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace nes {
 
@@ -15,7 +22,7 @@ class Cartridge;
 class CPU6502;
 
 /// Scanline phases for PPU timing
-enum class ScanlinePhase {
+enum class ScanlinePhase : uint8_t {
 	VISIBLE,	 // Scanlines 0-239: Visible scanlines
 	POST_RENDER, // Scanline 240: Post-render scanline
 	VBLANK,		 // Scanlines 241-260: Vertical blank
@@ -34,6 +41,78 @@ class PPU final : public Component {
 	void tick(CpuCycle cycles) override;
 	void tick_single_dot();	  // Advance PPU by exactly 1 dot - for testing
 	void tick_dots(int dots); // Non-virtual hot path: advance exactly N dots
+
+	// Catch-up synchronization support: a conservative (never late) count of
+	// dots that can run without the CPU needing to see the result — until the
+	// VBlank/NMI dot, the frame wrap, or the earliest possible mapper A12 IRQ.
+	// Always >= 1. Register accesses are handled by the bus syncing first.
+	[[nodiscard]] uint32_t dots_until_sync_point() const noexcept;
+
+	// Scanline batching: when a tick_dots() call covers dots 1-256 of a
+	// visible scanline, render the whole segment in one pass instead of
+	// per-dot fetch/shift/mux. Output is identical to the dot path; a batch
+	// is never split by a CPU access, so mid-scanline register writes simply
+	// end up on the dot path. On by default; off forces the dot path.
+	void set_scanline_batching(bool enabled) noexcept {
+		scanline_batching_ = enabled;
+	}
+	[[nodiscard]] bool is_scanline_batching() const noexcept {
+		return scanline_batching_;
+	}
+
+	// Accuracy profile (see Accuracy): the dot step is instantiated per
+	// profile and picked once per tick_dots() call. Strict by default;
+	// switching to Fast latches a sprite-0 hit still counting down.
+	void set_accuracy(Accuracy accuracy) noexcept;
+	[[nodiscard]] Accuracy get_accuracy() const noexcept {
+		return accuracy_;
+	}
+
+	// Timing region: PAL and Dendy run 312 lines per frame with no odd-frame
+	// skip, and Dendy sets VBlank 50 lines late (291). The line boundaries
+	// are copied from the profile, so the per-dot path compares against
+	// members exactly where NTSC compared against constants. Defaults to NTSC.
+	void set_region(const RegionTiming &timing) noexcept;
+	[[nodiscard]] Region get_region() const noexcept {
+		return region_;
+	}
+
+	// A12 prediction: with 8x8 sprites and the background and sprite pattern
+	// tables on opposite halves, the filtered A12 rises that clock an MMC3
+	// land on fixed dots of each rendering line (dot 261 with sprites at
+	// $1000; dot 325, plus dot 5 of the pre-render line, with the background
+	// there). The PPU then skips per-fetch edge tracking and
+	// dots_until_sync_point() names the exact dot of the mapper's IRQ. Any
+	// other PPUCTRL/PPUMASK setup falls back to edge tracking. On by default;
+	// off always tracks edges.
+	void set_a12_prediction(bool enabled) noexcept;
+	[[nodiscard]] bool is_a12_prediction() const noexcept {
+		return a12_prediction_;
+	}
+	/// Whether A12 edges are currently predicted rather than tracked
+	[[nodiscard]] bool is_predicting_a12() const noexcept {
+		return a12_predicting_;
+	}
+
+	// Frame skipping: with an interval N > 1 only every Nth frame (the one
+	// completing frame count N, 2N, ...) composes pixels. The others keep
+	// exact timing, fetches, A12 edges and status flags (sprite-0 hit,
+	// overflow) but write nothing to the index or frame buffer, which hold
+	// the last composed frame. 0 or 1 composes every frame.
+	void set_frame_skip(uint32_t interval) noexcept;
+	[[nodiscard]] uint32_t get_frame_skip() const noexcept {
+		return frame_skip_;
+	}
+	/// Compose no frames at all until turned off again, whatever the frame
+	/// skip (frames re-run for a rollback are never shown)
+	void set_compose_suppressed(bool suppressed) noexcept {
+		compose_suppressed_ = suppressed;
+		update_compose_frame();
+	}
+	/// Whether the frame being drawn will be composed
+	[[nodiscard]] bool is_composing_frame() const noexcept {
+		return compose_frame_;
+	}
 	void reset() override;
 	void power_on() override;
 	const char *get_name() const noexcept override {
@@ -50,6 +129,12 @@ class PPU final : public Component {
 	// OAM DMA interface ($4014)
 	void write_oam_dma(uint8_t page);
 	void write_oam_direct(uint8_t offset, uint8_t value);
+	// All 256 DMA bytes at once, from OAMADDR on (wrapping)
+	void write_oam_page(std::span<const uint8_t, 256> data) noexcept;
+	// True if nothing reads or moves OAM in the next `dots` dots: rendering
+	// is off (and the CPU is halted, so it stays off), or they all fall
+	// between the last visible line and the pre-render line
+	[[nodiscard]] bool is_oam_idle_for(uint32_t dots) const noexcept;
 	bool is_oam_dma_active() const {
 		return oam_dma_active_ || oam_dma_pending_;
 	}
@@ -67,12 +152,40 @@ class PPU final : public Component {
 	bool is_frame_ready() const {
 		return frame_ready_;
 	}
-	const uint32_t *get_frame_buffer() const {
-		return frame_buffer_.data();
+	/// RGBA frame, converted from the index buffer (see resolve_scanline)
+	const uint32_t *get_frame_buffer() const;
+	/// Per-pixel NES color (bits 0-5) and PPUMASK emphasis (bits 6-8)
+	const uint16_t *get_index_buffer() const {
+		return index_buffer_;
+	}
+	/// Render the index buffer into buffer (256x240 entries the caller keeps
+	/// alive, e.g. memory shared with another process) instead of the PPU's
+	/// own; null goes back to that. The frame so far is carried over.
+	void set_index_buffer(uint16_t *buffer);
+	/// RGBA for every index buffer entry (entry = color + emphasis * 64)
+	static const std::array<uint32_t, 512> &rgba_palette();
+	/// Whether the beam has output pixel (x, y) of the frame in progress yet
+	/// (every visible pixel once the frame's last line is done). For light
+	/// guns: nothing is resolved to RGBA, so asking costs a few compares.
+	/// False on frames set_frame_skip() leaves undrawn.
+	[[nodiscard]] bool is_pixel_drawn(uint8_t x, uint8_t y) const noexcept;
+	/// RGBA of pixel (x, y) as last drawn (this frame's if is_pixel_drawn())
+	[[nodiscard]] uint32_t get_pixel_rgba(uint8_t x, uint8_t y) const noexcept {
+		return rgba_palette()[index_buffer_[y * 256 + x] & 0x1FF];
 	}
 	void clear_frame_ready() {
 		frame_ready_ = false;
 	}
+	/// Bumped each time a frame completes, and on reset, power-on and state
+	/// load. Unlike frame_ready_ nobody clears it, so any number of readers
+	/// can tell whether the frame buffer changed since they last looked.
+	[[nodiscard]] uint64_t get_frame_generation() const noexcept {
+		return frame_generation_;
+	}
+	/// Dots run since power-on or reset, wrapping; saved with the state
+	[[nodiscard]] uint32_t get_dot_counter() const noexcept {
+		return ppu_dot_counter_;
+	}
 
 	// Connect to system bus for NMI generation
 	void connect_bus(SystemBus *bus) {
@@ -99,6 +212,25 @@ class PPU final : public Component {
 	}
 	ScanlinePhase get_current_phase() const;
 
+	// Fetch counts (see PpuFetchStats) for the last completed frame and for
+	// all frames completed since reset_fetch_stats(); all zero unless built
+	// with VIBENES_BUS_STATS
+	[[nodiscard]] const PpuFetchStats &get_frame_fetch_stats() const noexcept {
+		return last_frame_fetches_;
+	}
+	[[nodiscard]] const PpuFetchStats &get_total_fetch_stats() const noexcept {
+		return total_fetches_;
+	}
+	void reset_fetch_stats() noexcept {
+		frame_fetches_ = last_frame_fetches_ = total_fetches_ = PpuFetchStats{};
+	}
+
+	// v, t, fine X, PPUCTRL/PPUMASK and CHR banks as each line began, for
+	// this frame and the last (see ScanlineTimeline)
+	[[nodiscard]] const ScanlineTimeline &get_scanline_timeline() const noexcept {
+		return scanline_timeline_;
+	}
+
 	// Register inspection (for debugging)
 	uint8_t get_control_register() const {
 		return control_register_;
@@ -109,11 +241,18 @@ class PPU final : public Component {
 	uint8_t get_status_register() const {
 		return status_register_;
 	}
+	/// Current VRAM address (v), where the next PPUDATA access lands
+	[[nodiscard]] uint16_t get_vram_address() const noexcept {
+		return vram_address_ & 0x3FFF;
+	}
 
 	// Memory access for debugging
 	const PPUMemory &get_memory() const {
 		return memory_;
 	}
+	PPUMemory &get_memory() {
+		return memory_;
+	}
 
 	// CHR ROM access (for pattern table visualization)
 	uint8_t read_chr_rom(uint16_t address) const;
@@ -148,76 +287,29 @@ class PPU final : public Component {
 	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset);
 
   private:
-	// Timing state
-	uint16_t current_cycle_;	// Current PPU cycle (0-340)
-	uint16_t current_scanline_; // Current scanline (0-261)
-	uint64_t frame_counter_;	// Total frames rendered
-	bool frame_ready_;			// Flag indicating new frame is ready
-
-	// Cached scanline phase — recomputed only when current_scanline_ changes
-	// instead of a compare chain every dot in tick_internal()
-	ScanlinePhase cached_phase_ = ScanlinePhase::VISIBLE;
-
-	// PPU registers ($2000-$2007)
-	uint8_t control_register_; // $2000 PPUCTRL
-	uint8_t mask_register_;	   // $2001 PPUMASK
-	uint8_t status_register_;  // $2002 PPUSTATUS
-	uint8_t oam_address_;	   // $2003 OAMADDR
-
-	// Internal latches and state
-	uint16_t vram_address_;				// Current VRAM address (v)
-	uint16_t temp_vram_address_;		// Temporary VRAM address (t)
-	uint8_t fine_x_scroll_;				// Fine X scroll (3 bits)
-	bool write_toggle_;					// First/second write toggle (w)
-	uint8_t read_buffer_;				// PPU data read buffer
-	bool vram_wrap_read_pending_;		// Pending wrapped-read override flag
-	uint16_t vram_wrap_target_address_; // Address that should return the latched value after wrap
-	uint8_t vram_wrap_latched_value_;	// Latched value to expose on first read after wrap
-
-	// OAM (Object Attribute Memory) Management
-	std::array<uint8_t, 256> oam_memory_;		  // Primary OAM (64 sprites × 4 bytes)
-	std::array<uint8_t, 32> secondary_oam_;		  // Secondary OAM for scanline sprites (8 sprites × 4 bytes)
-	std::array<uint8_t, 8> secondary_oam_source_; // Which OAM sprite (0-63) filled each secondary OAM slot
-	bool oam_dma_active_;						  // OAM DMA in progress ($4014)
-	uint16_t oam_dma_address_;					  // OAM DMA source address
-	uint16_t oam_dma_cycle_;					  // OAM DMA cycle counter (0-513)
-	uint8_t oam_dma_subcycle_;					  // PPU subcycle counter for CPU timing (0-2)
-	bool oam_dma_pending_;						  // OAM DMA requested but not started
-	uint8_t oam_dma_data_latch_;				  // Latch holding data between DMA read/write phases
-
-	// Hardware Timing State
-	bool odd_frame_;					   // Tracks odd/even frames for cycle skip
-	uint8_t nmi_delay_;					   // NMI generation delay cycles
-	bool suppress_vbl_;					   // VBlank suppression flag
-	bool rendering_disabled_mid_scanline_; // Track rendering disable timing
-	bool was_rendering_enabled_;		   // Previous frame's rendering state (for mid-scanline disable detection)
-
-	// Bus State and Open Bus Behavior
-	uint8_t ppu_data_bus_;				   // PPU data bus for open bus behavior
-	uint8_t io_db_;						   // I/O data bus latch
-	bool vram_address_corruption_pending_; // VRAM address corruption flag
-
+	// Types used by the state below
+
+	// A12 prediction (see set_a12_prediction()). A window is a run of pattern
+	// fetches from $1000 - pairs of high fetches 8 dots apart, 2 dots per
+	// pair - of which only the first can pass the low-time filter. While
+	// predicting, the filter state is only written at window starts, to what
+	// it will be once the window has ended; a12_filter_state() recovers the
+	// per-fetch view.
+	struct A12Window {
+		uint16_t start; // Dot of the first high fetch
+		uint16_t span;	// Dots from the first to the last high fetch
+	};
+	enum class A12Pattern : uint8_t {
+		None,			// Track edges
+		SpritesHigh,	// One window at 257-320
+		BackgroundHigh, // Windows at 1-256 and 321-336
+	};
+	static constexpr uint16_t NO_A12_WINDOW = 0xFFFF;
 	// MMC3 A12 line tracking for IRQ counter
 	// Real hardware clocks the IRQ counter on a rising edge of A12 only
 	// when A12 has been low for at least ~15 PPU cycles (low-time filter).
-	bool last_a12_state_;								 // Previous state of A12 line (for edge detection)
-	uint32_t ppu_dot_counter_;							 // Monotonic PPU dot counter (wraps, used for deltas)
-	uint32_t a12_last_high_dot_;						 // ppu_dot_counter_ value when A12 was last high
 	static constexpr uint32_t A12_FILTER_THRESHOLD = 15; // PPU cycles A12 must be low
 
-	// Memory management
-	PPUMemory memory_;
-
-	// Frame buffer (256x240 pixels, 32-bit RGBA)
-	std::array<uint32_t, 256 * 240> frame_buffer_;
-
-	// Palette → final RGBA lookup table. Folds palette RAM contents, grayscale
-	// mode, and color emphasis into one indexed load per pixel. Rebuilt lazily
-	// when palette RAM or PPUMASK changes (dirty flag).
-	std::array<uint32_t, 32> palette_rgba_lut_{};
-	bool palette_lut_dirty_ = true;
-	void rebuild_palette_lut();
-
 	// Background shift registers (2-tile lookahead like real hardware)
 	struct BackgroundShiftRegisters {
 		uint16_t pattern_low_shift;	   // Low bit plane shift register
@@ -230,7 +322,7 @@ class PPU final : public Component {
 		uint8_t next_tile_attribute;
 		uint8_t next_tile_pattern_low;
 		uint8_t next_tile_pattern_high;
-	} bg_shift_registers_;
+	};
 
 	// Current tile fetching state (matches hardware timing)
 	struct TileFetchState {
@@ -239,7 +331,7 @@ class PPU final : public Component {
 		uint8_t current_attribute;
 		uint8_t current_pattern_low;
 		uint8_t current_pattern_high;
-	} tile_fetch_state_;
+	};
 
 	// Sprite evaluation state (for current scanline)
 	struct ScanlineSprite {
@@ -249,24 +341,6 @@ class PPU final : public Component {
 		uint8_t pattern_data_high; // High bit plane for current row
 		bool is_sprite_0;		   // True if this is sprite 0
 	};
-	std::array<ScanlineSprite, 8> scanline_sprites_current_; // Sprites rendering on current scanline
-	std::array<ScanlineSprite, 8> scanline_sprites_next_;	 // Sprites prepared for next scanline
-	uint8_t sprite_count_current_scanline_;					 // Number of sprites rendering on current scanline
-	uint8_t sprite_count_next_scanline_;					 // Number of sprites evaluated for next scanline
-	bool sprite_0_on_scanline_;								 // True if sprite 0 is on current scanline (rendering)
-	bool sprite_0_on_next_scanline_;						 // True if sprite 0 is on next scanline (evaluation)
-	bool sprite_0_hit_detected_;							 // Prevents multiple sprite 0 hits per frame
-	uint8_t sprite_0_hit_delay_;							 // Delay counter before latching sprite 0 flag
-
-	// Pre-rasterized sprite pixels for the current scanline, rebuilt once at
-	// each scanline boundary. Replaces the per-pixel scan over all 8 sprite
-	// slots (up to ~29M iterations/sec) with a single byte lookup.
-	// Entry layout: bits 0-4 = sprite palette index (0 = transparent),
-	// bit 5 = priority (behind background), bit 6 = sprite 0.
-	static constexpr uint8_t SPRITE_LINE_PALETTE_MASK = 0x1F;
-	static constexpr uint8_t SPRITE_LINE_PRIORITY_BIT = 0x20;
-	static constexpr uint8_t SPRITE_LINE_SPRITE0_BIT = 0x40;
-	std::array<uint8_t, 256> sprite_line_buffer_{};
 
 	// Hardware-accurate sprite evaluation state machine
 	enum class SpriteEvalState : uint8_t {
@@ -277,6 +351,74 @@ class PPU final : public Component {
 		OverflowBug,   // Emulating sprite overflow hardware bug
 		Done		   // Evaluation complete, waiting for cycle 256
 	};
+
+	// Rendering writes 9-bit entries (NES color + emphasis) to the index
+	// buffer; each finished visible scanline is converted to RGBA in one pass,
+	// and get_frame_buffer() also converts the scanline in progress. Both
+	// live on the heap, away from the per-dot state.
+	struct FrameBuffers {
+		std::array<uint16_t, 256 * 240> indices;
+		std::array<uint32_t, 256 * 240> pixels;
+	};
+
+	// Pre-rasterized sprite pixels for the current scanline, rebuilt once at
+	// each scanline boundary. Replaces the per-pixel scan over all 8 sprite
+	// slots (up to ~29M iterations/sec) with a single byte lookup.
+	// Entry layout: bits 0-4 = sprite palette index (0 = transparent),
+	// bit 5 = priority (behind background), bit 6 = sprite 0.
+	static constexpr uint8_t SPRITE_LINE_PALETTE_MASK = 0x1F;
+	static constexpr uint8_t SPRITE_LINE_PRIORITY_BIT = 0x20;
+	static constexpr uint8_t SPRITE_LINE_SPRITE0_BIT = 0x40;
+
+	// State is declared in three groups by access rate, so the dots
+	// tick_internal() runs 5.4 million times a second touch as few cache
+	// lines as possible. Keep each field in the group matching how often it
+	// is used.
+
+	// ─── Hot: read or written on every dot (two cache lines) ────────────────
+	alignas(64) uint16_t current_cycle_; // Current PPU cycle (0-340)
+	uint16_t current_scanline_;			 // Current scanline (0-261, 0-311 on PAL/Dendy)
+
+	// Region line boundaries (see set_region()); NTSC values by default.
+	// odd_frame_skip_cycle_ is out of reach of any dot where there is no skip.
+	uint16_t vblank_start_scanline_ = 241;
+	uint16_t pre_render_scanline_ = 261;
+	uint16_t odd_frame_skip_cycle_ = 339;
+
+	uint16_t vram_address_;		 // Current VRAM address (v)
+	uint16_t temp_vram_address_; // Temporary VRAM address (t)
+
+	// Cached scanline phase — recomputed only when current_scanline_ changes
+	// instead of a compare chain every dot in tick_internal()
+	ScanlinePhase cached_phase_ = ScanlinePhase::VISIBLE;
+
+	uint8_t control_register_; // $2000 PPUCTRL
+	uint8_t mask_register_;	   // $2001 PPUMASK
+	uint8_t status_register_;  // $2002 PPUSTATUS
+	uint8_t fine_x_scroll_;	   // Fine X scroll (3 bits)
+
+	uint8_t sprite_0_hit_delay_;		   // Delay counter before latching sprite 0 flag
+	uint8_t nmi_delay_;					   // NMI generation delay cycles
+	bool odd_frame_;					   // Tracks odd/even frames for cycle skip
+	bool suppress_vbl_;					   // VBlank suppression flag
+	bool vram_address_corruption_pending_; // VRAM address corruption flag
+
+	// Frame skipping (see set_frame_skip()); compose_frame_ is refreshed at
+	// each frame wrap
+	bool compose_frame_ = true;
+	// Scanline-batched rendering (see set_scanline_batching())
+	bool scanline_batching_ = true;
+	Accuracy accuracy_ = Accuracy::Strict;
+
+	bool last_a12_state_;	  // Previous state of A12 line (for edge detection)
+	bool a12_predicting_ = false;
+	std::array<uint16_t, 2> a12_window_dots_{NO_A12_WINDOW, NO_A12_WINDOW}; // Window starts for a12_pattern_
+	uint32_t ppu_dot_counter_;	 // Monotonic PPU dot counter (wraps, used for deltas)
+	uint32_t a12_last_high_dot_; // ppu_dot_counter_ value when A12 was last high
+
+	BackgroundShiftRegisters bg_shift_registers_;
+	TileFetchState tile_fetch_state_;
+
 	SpriteEvalState sprite_eval_state_; // Current state in evaluation state machine
 	uint8_t sprite_eval_n_;				// Current OAM sprite index being evaluated (0-63)
 	uint8_t sprite_eval_m_;				// Current byte within sprite (0-3: Y, Tile, Attr, X)
@@ -284,16 +426,108 @@ class PPU final : public Component {
 	uint8_t secondary_oam_index_;		// Write position in secondary OAM (0-31)
 	bool sprite_overflow_detected_;		// Hardware sprite overflow flag state
 
-	// External connections
-	SystemBus *bus_;					   // For NMI generation
-	CPU6502 *cpu_;						   // For triggering NMI interrupts
+	uint16_t *index_buffer_;			   // frame_buffers_->indices
 	std::shared_ptr<Cartridge> cartridge_; // For CHR ROM/RAM access
 
+	// ─── Warm: once per pixel or per scanline ───────────────────────────────
+	std::array<uint8_t, 256> sprite_line_buffer_{};
+
+	// Palette → index buffer entry. Folds palette RAM contents, grayscale
+	// mode, and color emphasis into one indexed load per pixel. Rebuilt lazily
+	// when palette RAM or PPUMASK changes (dirty flag).
+	std::array<uint16_t, 32> palette_index_lut_{};
+	bool palette_lut_dirty_ = true;
+
+	uint8_t sprite_count_current_scanline_; // Number of sprites rendering on current scanline
+	uint8_t sprite_count_next_scanline_;	// Number of sprites evaluated for next scanline
+	bool sprite_0_on_scanline_;				// True if sprite 0 is on current scanline (rendering)
+	bool sprite_0_on_next_scanline_;		// True if sprite 0 is on next scanline (evaluation)
+	bool sprite_0_hit_detected_;			// Prevents multiple sprite 0 hits per frame
+
+	A12Pattern a12_pattern_ = A12Pattern::None;
+	uint8_t a12_window_index_ = 0;		 // Window last entered
+	bool a12_window_pre_render_ = false; // ... and whether on the pre-render line
+
+	uint16_t scanlines_per_frame_ = 262;
+	bool frame_ready_;		 // Flag indicating new frame is ready
+	uint64_t frame_counter_; // Total frames rendered
+	uint32_t frame_skip_ = 1;
+	bool compose_suppressed_ = false;
+
+	std::array<ScanlineSprite, 8> scanline_sprites_current_{}; // Sprites rendering on current scanline
+	std::array<ScanlineSprite, 8> scanline_sprites_next_{};	   // Sprites prepared for next scanline
+
+	// OAM (Object Attribute Memory) Management
+	std::array<uint8_t, 32> secondary_oam_;		  // Secondary OAM for scanline sprites (8 sprites × 4 bytes)
+	std::array<uint8_t, 8> secondary_oam_source_; // Which OAM sprite (0-63) filled each secondary OAM slot
+	std::array<uint8_t, 256> oam_memory_;		  // Primary OAM (64 sprites × 4 bytes)
+
+	// Memory management
+	PPUMemory memory_;
+
+	// ─── Cold: register accesses, DMA, debugging, configuration ─────────────
+	std::unique_ptr<FrameBuffers> frame_buffers_;
+	uint32_t *frame_buffer_; // frame_buffers_->pixels
+	void resolve_scanline(uint16_t scanline) const;
+
+	uint64_t frame_generation_ = 0; // See get_frame_generation(); not saved
+	Region region_ = Region::Ntsc;
+
+	uint8_t oam_address_; // $2003 OAMADDR
+
+	// Internal latches and state
+	bool write_toggle_;					// First/second write toggle (w)
+	uint8_t read_buffer_;				// PPU data read buffer
+	bool vram_wrap_read_pending_;		// Pending wrapped-read override flag
+	uint16_t vram_wrap_target_address_; // Address that should return the latched value after wrap
+	uint8_t vram_wrap_latched_value_;	// Latched value to expose on first read after wrap
+
+	bool oam_dma_active_;		 // OAM DMA in progress ($4014)
+	uint16_t oam_dma_address_;	 // OAM DMA source address
+	uint16_t oam_dma_cycle_;	 // OAM DMA cycle counter (0-513)
+	uint8_t oam_dma_subcycle_;	 // PPU subcycle counter for CPU timing (0-2)
+	bool oam_dma_pending_;		 // OAM DMA requested but not started
+	uint8_t oam_dma_data_latch_; // Latch holding data between DMA read/write phases
+
+	bool rendering_disabled_mid_scanline_; // Track rendering disable timing
+	bool was_rendering_enabled_;		   // Previous frame's rendering state (for mid-scanline disable detection)
+
+	// Bus State and Open Bus Behavior
+	uint8_t ppu_data_bus_; // PPU data bus for open bus behavior
+	uint8_t io_db_;		   // I/O data bus latch
+
+	bool a12_prediction_ = true;
+
+	// VIBENES_BUS_STATS: the frame in progress, latched when it completes
+	PpuFetchStats frame_fetches_;
+	PpuFetchStats last_frame_fetches_;
+	PpuFetchStats total_fetches_;
+
+	ScanlineTimeline scanline_timeline_;
+	void record_scanline_state() noexcept;
+
+	void rebuild_palette_lut();
+
+	void update_compose_frame() noexcept {
+		compose_frame_ = !compose_suppressed_ && (frame_skip_ <= 1 || (frame_counter_ + 1) % frame_skip_ == 0);
+	}
+
+	// External connections
+	SystemBus *bus_; // For NMI generation
+	CPU6502 *cpu_;	 // For triggering NMI interrupts
+
 	// Internal tick function - called once per PPU cycle
-	void tick_internal();
+	template <Accuracy Profile> void tick_internal();
+	template <Accuracy Profile> void run_dots(int dots);
+	void tick_dot(); // tick_internal() in the current profile
+	// Tell a mapper that watches fetches (MMC5) that the sprite (dot 257) or
+	// background (dot 320) pattern fetches begin
+	void notify_fetch_phase(bool sprites);
 
 	// Scanline processing
 	void process_visible_scanline();
+	bool can_batch_visible_scanline() const;
+	void render_visible_scanline_batched(); // Dots 1-256 of a visible scanline in one pass
 	void process_post_render_scanline();
 	void process_vblank_scanline();
 	void process_pre_render_scanline();
@@ -314,6 +548,7 @@ class PPU final : public Component {
 	// OAM operations
 	void clear_secondary_oam();
 	void perform_sprite_evaluation_cycle();
+	void evaluate_sprites_batched(); // Dots 65-256 of the state machine in one call
 	void prepare_scanline_sprites();	 // Convert secondary OAM to scanline sprites with pattern data
 	void perform_sprite_fetch_cycle();	 // Per-cycle sprite pattern fetch during cycles 257-320
 	void rasterize_sprite_line_buffer(); // Rasterize current scanline sprites into sprite_line_buffer_
@@ -346,7 +581,7 @@ class PPU final : public Component {
 
 	// Pixel multiplexer and priority resolution
 	uint8_t multiplex_background_sprite_pixels(uint8_t bg_pixel, uint8_t sprite_pixel, bool sprite_priority);
-	uint32_t apply_color_emphasis(uint32_t color);
+	static uint32_t apply_color_emphasis(uint32_t color, uint8_t emphasis);
 	bool is_transparent_color(uint8_t palette_index);
 	// Note: resolve_pixel_priority functionality merged into multiplex_background_sprite_pixels
 
@@ -357,7 +592,7 @@ class PPU final : public Component {
 	uint8_t fetch_attribute_byte(uint16_t nametable_addr);
 	uint16_t fetch_pattern_data(uint8_t tile_index, uint8_t fine_y, bool background_table);
 	uint8_t get_background_palette_index(uint16_t pattern_data, uint8_t attribute, uint8_t fine_x);
-	uint32_t get_palette_color(uint8_t palette_index);
+	uint16_t get_palette_entry(uint8_t palette_index);
 
 	// Hardware-accurate background tile fetching
 	void shift_background_registers();
@@ -374,6 +609,11 @@ class PPU final : public Component {
 
 	// MMC3 A12 tracking for IRQ counter
 	void track_a12_line(uint16_t address);
+	void update_a12_prediction(); // After PPUCTRL/PPUMASK changes
+	[[nodiscard]] static A12Window a12_window(A12Pattern pattern, uint8_t index) noexcept;
+	void enter_a12_window(uint32_t dot, uint8_t index);
+	[[nodiscard]] std::pair<bool, uint32_t> a12_filter_state() const noexcept; // {last_a12_state_, a12_last_high_dot_}
+	[[nodiscard]] uint32_t dots_until_predicted_a12_irq(uint32_t edges) const noexcept;
 
 	// Advanced scrolling (Phase 4)
 	void increment_vram_address(); // Consolidated VRAM increment logic
@@ -399,7 +639,7 @@ class PPU final : public Component {
 	bool is_oam_access_restricted() const; // Check if OAM access should return 0xFF
 };
 
-/// PPU timing constants
+/// PPU timing constants (NTSC; PAL and Dendy line counts come from region.hpp)
 namespace PPUTiming {
 constexpr uint16_t CYCLES_PER_SCANLINE = 341;
 constexpr uint16_t VISIBLE_SCANLINES = 240;
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "cartridge/mappers/mapper.hpp"
 #include "core/types.hpp"
 #include "ppu/ppu_registers.hpp"
 #include <array>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 namespace nes {
 
@@ -40,12 +43,32 @@ class PPUMemory {
 	uint8_t read_pattern_table(uint16_t address) const;
 	void write_pattern_table(uint16_t address, uint8_t value);
 
-	// Nametable mirroring support (deprecated - mirroring now read from cartridge)
+	// Mirroring used while no ROM is loaded (tests); a loaded cartridge's
+	// mapper maps the nametables itself
 	void set_mirroring_mode(bool vertical_mirroring);
 
 	// Connect to cartridge for dynamic mirroring
 	void connect_cartridge(std::shared_ptr<Cartridge> cartridge);
 
+	// Change tracking for the debug viewers. Writes mark 16-byte pattern
+	// tiles and VRAM bytes; CHR bank switches are picked up when the tiles
+	// are taken. Each take_* returns what changed since the previous call
+	// and clears it; the GUI may take while the emulation thread writes.
+	using PatternTileMask = std::array<uint64_t, 8>; // 512 tiles, $0000-$1FFF
+	using VramByteMask = std::array<uint64_t, 32>;	 // 2048 physical VRAM bytes
+	void mark_pattern_dirty(uint16_t address);
+	void mark_all_dirty();
+	PatternTileMask take_dirty_pattern_tiles();
+	VramByteMask take_dirty_vram();
+	/// Bumped on every palette write
+	uint32_t get_palette_generation() const {
+		return palette_generation_.load(std::memory_order_relaxed);
+	}
+	/// Physical VRAM offset a $2000-$3EFF address maps to under the current
+	/// mirroring. Nametables in cartridge VRAM (four-screen) report the CIRAM
+	/// page they would mirror on a two-screen board.
+	uint16_t nametable_vram_offset(uint16_t address) const;
+
 	// Save state serialization
 	void serialize_state(std::vector<uint8_t> &buffer) const;
 	void deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset);
@@ -58,16 +81,21 @@ class PPUMemory {
 
 	// Mirroring state (fallback for when no cartridge is connected)
 	bool vertical_mirroring_;
+	Mapper::NametablePageTable fallback_nametables_{}; // Pages of vram_ under vertical_mirroring_
 
 	// Cartridge connection for dynamic mirroring
 	std::shared_ptr<Cartridge> cartridge_;
 
-	// Address mapping helpers
-	uint16_t map_nametable_address(uint16_t address);
-	uint8_t map_palette_address(uint8_t address);
+	// Viewer change tracking (not saved)
+	std::array<std::atomic<uint64_t>, 8> dirty_pattern_tiles_{};
+	std::array<std::atomic<uint64_t>, 32> dirty_vram_{};
+	std::atomic<uint32_t> palette_generation_{0};
+	std::array<const uint8_t *, 8> last_chr_slots_{}; // CHR bank sources at the last take
 
-	// Get current mirroring mode from cartridge (or fallback)
-	bool get_vertical_mirroring() const;
+	// The cartridge mapper's nametable pages, or the fallback ones
+	const Mapper::NametablePageTable &nametable_pages() const;
+	void update_fallback_nametables();
+	uint8_t map_palette_address(uint8_t address);
 };
 
 /// PPU Address space constants
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+/**
+ * PpuWriteLog - Everything the CPU did to the PPU's inputs during a run
+ *
+ * Filled by the bus while attached (SystemBus::set_ppu_log()): PPU register
+ * accesses with side effects, OAM DMA bytes and pages, and cartridge writes
+ * (bank switches, mirroring, IRQ setup), each stamped with the PPU's dot
+ * counter when it happened. A copy of the PPU that ticks to each stamp and
+ * then applies the entry goes through the same states the original did, so
+ * it draws the same pixels (RenderPipeline).
+ */
+class PpuWriteLog {
+  public:
+	enum class Kind : std::uint8_t {
+		RegisterRead,	// $2002, $2004 or $2007
+		RegisterWrite,	// $2000-$3FFF
+		OamWrite,		// One OAM DMA byte; address is the OAM offset
+		OamPage,		// A whole DMA page at once; address indexes page()
+		CartridgeWrite, // $4020-$FFFF
+	};
+	struct Entry {
+		std::uint64_t cycle; // CPU cycle of a cartridge write (MMC1 drops back-to-back ones)
+		std::uint32_t dot;	 // PPU::get_dot_counter() at the access
+		std::uint16_t address;
+		std::uint8_t value;
+		Kind kind;
+	};
+	static_assert(sizeof(Entry) == 16);
+
+	void record(Kind kind, std::uint32_t dot, std::uint16_t address, std::uint8_t value, std::uint64_t cycle = 0) {
+		entries_.push_back({cycle, dot, address, value, kind});
+	}
+	void record_oam_page(std::uint32_t dot, std::span<const std::uint8_t, 256> data) {
+		entries_.push_back({0, dot, static_cast<std::uint16_t>(pages_.size()), 0, Kind::OamPage});
+		std::array<std::uint8_t, 256> &page = pages_.emplace_back();
+		std::copy(data.begin(), data.end(), page.begin());
+	}
+	// Keeps the storage for the next run
+	void clear() noexcept {
+		entries_.clear();
+		pages_.clear();
+	}
+
+	[[nodiscard]] std::span<const Entry> entries() const noexcept {
+		return entries_;
+	}
+	[[nodiscard]] std::span<const std::uint8_t, 256> page(std::size_t index) const noexcept {
+		return pages_[index];
+	}
+
+  private:
+	std::vector<Entry> entries_;
+	std::vector<std::array<std::uint8_t, 256>> pages_;
+};
+
+} // namespace nes
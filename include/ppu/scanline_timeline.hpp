@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace nes {
+
+/**
+ * ScanlineState - The PPU's scroll and bank state as a scanline begins
+ *
+ * 16 bytes, taken at dot 0 of every line: enough to redraw where each line
+ * of the picture came from (split scrolls, mid-frame bank and pattern table
+ * switches) without single-stepping.
+ */
+struct ScanlineState {
+	static constexpr std::uint8_t RECORDED = 0x01;	   // The entry holds a sample
+	static constexpr std::uint8_t WRITE_TOGGLE = 0x02; // w was set (half a $2005/$2006 pair)
+
+	std::uint16_t v = 0; // Current VRAM address
+	std::uint16_t t = 0; // Temporary VRAM address
+	std::uint8_t fine_x = 0;
+	std::uint8_t ctrl = 0; // PPUCTRL
+	std::uint8_t mask = 0; // PPUMASK
+	std::uint8_t flags = 0;
+	// The CHR page (1KB, low 8 bits) each $0400 slot of $0000-$1FFF maps
+	std::array<std::uint8_t, 8> chr_banks{};
+
+	[[nodiscard]] bool rendering() const noexcept {
+		return (mask & 0x18) != 0;
+	}
+	// Where the line's first pixel comes from on the 512x480 map of the four
+	// nametables. With rendering on, the previous line's prefetch (dots
+	// 321-336) has already moved v two tiles on.
+	[[nodiscard]] int map_x() const noexcept {
+		const int x = ((v & 0x001F) << 3 | fine_x) + ((v & 0x0400) ? 256 : 0);
+		return (rendering() ? x - 16 : x) & 511;
+	}
+	// -1 for coarse Y 30-31, rows that fetch attribute bytes as tiles
+	[[nodiscard]] int map_y() const noexcept {
+		const int coarse_y = (v >> 5) & 0x1F;
+		return coarse_y >= 30 ? -1 : (coarse_y << 3 | ((v >> 12) & 0x07)) + ((v & 0x0800) ? 240 : 0);
+	}
+};
+static_assert(sizeof(ScanlineState) == 16);
+
+/**
+ * ScanlineTimeline - Per-scanline PPU state for the last two frames
+ *
+ * The PPU records one ScanlineState per line into the frame in progress and
+ * flips to the other one when a frame ends, so last_frame() always holds a
+ * whole, finished frame for debugger views (about 4KB per NTSC frame).
+ *
+ * Recording is on unless the core is configured with
+ * -DVIBENES_SCANLINE_TIMELINE=OFF, which defines VIBENES_NO_SCANLINE_TIMELINE
+ * and compiles the PPU's recording out; the type is always built, and
+ * ENABLED says whether it will ever fill.
+ */
+class ScanlineTimeline {
+  public:
+#ifdef VIBENES_NO_SCANLINE_TIMELINE
+	static constexpr bool ENABLED = false;
+#else
+	static constexpr bool ENABLED = true;
+#endif
+
+	// Lines per frame on PAL and Dendy, the longest region
+	static constexpr std::size_t MAX_SCANLINES = 312;
+	using Frame = std::array<ScanlineState, MAX_SCANLINES>;
+
+	void record(std::uint16_t scanline, const ScanlineState &state) noexcept {
+		if (scanline < MAX_SCANLINES) {
+			frames_[current_][scanline] = state;
+		}
+	}
+	void end_frame() noexcept {
+		current_ ^= 1;
+		frames_[current_].fill({});
+	}
+	void clear() noexcept {
+		frames_[0].fill({});
+		frames_[1].fill({});
+	}
+
+	// The frame being recorded (lines past the current one are empty)
+	[[nodiscard]] const Frame &current_frame() const noexcept {
+		return frames_[current_];
+	}
+	// The last completed frame
+	[[nodiscard]] const Frame &last_frame() const noexcept {
+		return frames_[current_ ^ 1];
+	}
+
+  private:
+	std::array<Frame, 2> frames_{};
+	std::size_t current_ = 0;
+};
+
+} // namespace nes
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+// How a file write went; error is empty on success
+struct FileWriteResult {
+	bool ok = false;
+	std::string error;
+};
+
+// Bytes of a file a patch rewrites
+struct FileRange {
+	std::size_t offset = 0;
+	std::size_t size = 0;
+};
+
+/**
+ * AsyncFileWriter - Writes finished buffers to disk on a worker thread
+ *
+ * For save states and battery saves, which are produced in a fraction of a
+ * millisecond on the emulation thread but can take tens of milliseconds to
+ * reach slow storage. write() takes the bytes and returns at once; the
+ * worker writes them to "<path>.tmp", flushes that to the device and renames
+ * it over path, so a crash never leaves a torn file - only the old one or
+ * the new one. The returned future reports the outcome (poll it with
+ * wait_for(0) from a UI thread).
+ *
+ * patch() is for files rewritten often in small pieces (battery saves): only
+ * the given ranges of the new contents are written, in place, into a file
+ * that already holds data.size() bytes - on flash, a few pages instead of
+ * the whole file plus a rename. Without such a file it is a write(). A patch
+ * that dies part-way can leave some ranges old and some new.
+ *
+ * Writes run in the order queued. A write to a path that already has one
+ * waiting replaces the waiting one's bytes (both futures report the write
+ * that happens), so a burst of saves to one file costs one write; a patch
+ * joining a waiting patch adds its ranges to it.
+ */
+class AsyncFileWriter {
+  public:
+	AsyncFileWriter();
+	// Finishes every queued write first
+	~AsyncFileWriter();
+	AsyncFileWriter(const AsyncFileWriter &) = delete;
+	AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+	std::future<FileWriteResult> write(std::filesystem::path path, std::vector<std::uint8_t> data);
+	// data is the whole new file; ranges say which parts of it changed
+	std::future<FileWriteResult> patch(std::filesystem::path path, std::vector<std::uint8_t> data,
+									   std::vector<FileRange> ranges);
+
+	/// Block until every write queued so far is done (before reading one back)
+	void wait_idle();
+	[[nodiscard]] bool is_idle() const;
+
+	/**
+	 * The same write on the calling thread: temp file, flush to the device,
+	 * rename over path (copy where rename fails, e.g. across filesystems)
+	 */
+	static FileWriteResult write_file(const std::filesystem::path &path, std::span<const std::uint8_t> data);
+	/**
+	 * The same patch on the calling thread: the ranges written in place and
+	 * flushed to the device, or write_file() if path is missing or another size
+	 */
+	static FileWriteResult patch_file(const std::filesystem::path &path, std::span<const std::uint8_t> data,
+									  std::span<const FileRange> ranges);
+
+  private:
+	struct Job {
+		std::filesystem::path path;
+		std::vector<std::uint8_t> data;
+		std::vector<std::promise<FileWriteResult>> promises;
+		bool patch = false;
+		std::vector<FileRange> ranges; // Of a patch
+	};
+
+	mutable std::mutex mutex_;
+	std::condition_variable work_ready_;
+	std::condition_variable idle_;
+	std::deque<Job> queue_;
+	bool busy_ = false; // Worker is writing a job it took off the queue
+	bool stopping_ = false;
+	std::thread worker_;
+
+	std::future<FileWriteResult> queue(Job job);
+	void run();
+};
+
+} // namespace nes
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nes {
+
+/**
+ * BatchRunner - Runs independent jobs across a work-stealing thread pool
+ *
+ * Meant for many whole-emulator runs (one HeadlessSystem per job): the jobs
+ * are dealt round-robin into one queue per worker, each worker takes from
+ * the front of its own queue, and a worker whose queue is empty steals from
+ * the back of another's. Queues are only touched between jobs, so with jobs
+ * lasting frames rather than microseconds the locks are never contended and
+ * throughput scales with the number of cores; stealing evens out runs of
+ * very different lengths (a short movie next to a long one).
+ *
+ * Jobs must not throw and must not share mutable state with each other;
+ * each writes its own result slot. run() returns once every job has
+ * finished.
+ */
+class BatchRunner {
+  public:
+	using Job = std::function<void()>;
+
+	/// @param threads Worker threads (0 = one per hardware thread)
+	explicit BatchRunner(unsigned threads = 0);
+
+	/// Run every job once, in no particular order, and wait for all of them
+	void run(std::vector<Job> jobs);
+
+	[[nodiscard]] unsigned thread_count() const noexcept {
+		return threads_;
+	}
+	// Jobs taken from another worker's queue during the last run()
+	[[nodiscard]] std::uint64_t get_steal_count() const noexcept {
+		return steals_;
+	}
+
+  private:
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	unsigned threads_;
+	std::uint64_t steals_ = 0;
+
+	static bool pop_front(WorkQueue &queue, Job &job);
+	static bool pop_back(WorkQueue &queue, Job &job);
+	static std::uint64_t work(std::vector<std::unique_ptr<WorkQueue>> &queues, std::size_t self);
+};
+
+} // namespace nes
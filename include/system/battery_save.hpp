@@ -1,7 +1,14 @@
 #pragma once
 
+#include "cartridge/mappers/mapper.hpp"
+#include "core/types.hpp"
+#include "system/async_file_writer.hpp"
+#include "system/mapped_file.hpp"
 #include <filesystem>
+#include <future>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace nes {
 
@@ -14,41 +21,99 @@ class Cartridge;
  * the .vns save-state system.
  *
  * Only cartridges whose iNES header sets the battery flag (and that actually
- * have PRG-RAM, i.e. MMC1/MMC3) participate; everything else is a no-op.
+ * have PRG-RAM) participate; everything else is a no-op.
  */
 class BatterySaveManager {
   public:
 	explicit BatterySaveManager(Cartridge *cartridge);
+	~BatterySaveManager();
+	BatterySaveManager(const BatterySaveManager &) = delete;
+	BatterySaveManager &operator=(const BatterySaveManager &) = delete;
 
 	void set_directory(std::filesystem::path dir);
+
+	// Hand flushed saves to writer instead of writing them on the calling
+	// (emulation) thread; null writes synchronously. Wait for the writer
+	// before exiting so the last flush lands.
+	void set_file_writer(AsyncFileWriter *writer) noexcept {
+		writer_ = writer;
+	}
 	const std::filesystem::path &get_directory() const noexcept {
 		return directory_;
 	}
 
+	// Memory-mapped mode: the .sav itself (a MappedFile, created on load if
+	// missing) becomes the mapper's battery RAM, so every save write the game
+	// makes is already in the file and the OS page cache writes it back; there
+	// is nothing for update() to flush, and a crash loses nothing. Takes
+	// effect at the next load_for_current_rom()/restore(); a mapper that
+	// keeps its own RAM (Mapper::map_battery_ram) stays on the flushed path.
+	void set_memory_mapped(bool enabled) noexcept {
+		memory_mapped_ = enabled;
+	}
+	// Whether the current ROM's battery RAM is the mapped .sav
+	bool is_mapped() const noexcept {
+		return mapped_file_.is_open();
+	}
+
 	// Restore the .sav file (if present) into the currently loaded cartridge's
 	// PRG-RAM. Call after the ROM is loaded AND the system has been reset, so
 	// the mapper's power-on clear doesn't wipe the restored contents.
 	void load_for_current_rom();
+	// The same, from a .sav already read elsewhere (RomPreloader, which reads
+	// it from path_for_rom() off the UI thread); nullopt means there is none.
+	// Memory-mapped, both map the file instead. When the ROM is the one it
+	// replaced, data was read before the swap's flush(true) and may be older
+	// than that RAM: the file is read again once the flush has landed.
+	void restore(const std::optional<std::vector<Byte>> &data);
 
-	// Write the .sav if the loaded cart has battery RAM that changed since the
-	// last flush. With force=true, writes regardless of the dirty flag.
-	// Returns true if a file was written.
+	// Write the pages of battery RAM that changed since the last flush into
+	// the .sav in place (AsyncFileWriter::patch; the first save writes it
+	// whole). With force=true, rewrites the whole file regardless.
+	// Returns true if a file was written (queued, with a file writer).
+	// Memory-mapped, an unforced flush has nothing to do; a forced one (the
+	// cartridge is going away) syncs the file, hands the RAM back to the
+	// mapper and unmaps it.
 	bool flush(bool force = false);
 
-	// Per-frame tick: flushes dirty battery RAM at most every
-	// kFlushIntervalSeconds so an unexpected crash loses at most a few seconds.
-	// (Power-off persistence proper happens via flush() on reset/unload/exit.)
+	// Per-frame tick, on the thread that runs the cartridge: flushes changed
+	// battery RAM once the game has stopped writing it for kQuietSeconds, or
+	// after kFlushIntervalSeconds of changes, so a burst of save writes costs
+	// one write and an unexpected crash loses at most a few seconds. (Power-off
+	// persistence proper happens via flush() on reset/unload/exit.)
 	void update(double delta_seconds);
 
+	// <directory_>/<rom-stem><extension> for the currently loaded ROM, or
+	// empty; used for files kept next to the .sav (e.g. the ".cdl" code log).
+	std::filesystem::path companion_path(const std::string &extension) const;
+	// <directory>/<rom-stem><extension>, for a ROM not loaded yet
+	static std::filesystem::path path_for_rom(const std::filesystem::path &directory, const std::string &rom_filename,
+											  const std::string &extension);
+
   private:
 	Cartridge *cartridge_;
 	std::filesystem::path directory_;
-	double seconds_since_flush_ = 0.0;
+	double seconds_dirty_ = 0.0; // Since battery RAM changed after the last flush
+	double quiet_seconds_ = 0.0; // Since the game last wrote it
+	Mapper::RamPageMark activity_mark_;
+	AsyncFileWriter *writer_ = nullptr;
+	std::future<FileWriteResult> pending_write_; // Last queued write
+	bool retry_ = false;						 // It failed: write again at the next update
+	bool memory_mapped_ = false;
+	MappedFile mapped_file_; // The current ROM's .sav, while it is its battery RAM
+	std::filesystem::path restored_path_; // The .sav the battery RAM last came from
 
+	static constexpr double kQuietSeconds = 1.0;
 	static constexpr double kFlushIntervalSeconds = 5.0;
 
-	// <directory_>/<rom-stem>.sav for the currently loaded ROM, or empty.
+	// companion_path(".sav")
 	std::filesystem::path file_path_for_current_rom() const;
+	// Copy a .sav's contents into the battery RAM (restore() without the checks)
+	void apply(const std::optional<std::vector<Byte>> &data);
+	// Memory-mapped mode: make the .sav the battery RAM; false to fall back
+	bool map_current_rom();
+	// Sync and unmap the .sav, the RAM back in the mapper's own memory
+	void unmap();
 };
 
 } // namespace nes
@@ -0,0 +1,319 @@
+#pragma once
+
+#include "audio/spsc_ring_buffer.hpp"
+#include "core/types.hpp"
+#include "system/save_state.hpp"
+#include "system/triple_buffer.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+class CPU6502;
+class LatchedInputSource;
+class PerfCounters;
+class PPU;
+class RewindBuffer;
+class SystemBus;
+
+/**
+ * EmulationThread - Runs CPU/PPU/APU on a dedicated thread at NTSC frame rate
+ *
+ * The front end never touches the emulated components while this thread is
+ * running them.  Instead:
+ *
+ *  - Control (run/pause, speed, fast-forward) and controller input go through
+ *    a lock-free command queue drained once per frame (and while sleeping).
+ *  - Every completed frame is copied into a triple buffer; the reader picks up
+ *    the newest one whenever it presents, without blocking the emulator.
+ *  - Debugger views request an opaque state snapshot (produced by the snapshot
+ *    callback, e.g. SaveStateManager::serialize_state) which is published the
+ *    same way at the next frame boundary.
+ *  - Anything that must mutate live state (ROM load, reset, stepping, save
+ *    states, audio device control) runs inside exclusive(): the thread parks
+ *    at an instruction boundary (within EXCLUSIVE_POLL_CYCLES) with the PPU
+ *    synced, the caller's
+ *    function runs, and emulation resumes.
+ *
+ *  - With run-ahead set, each frame is followed by up to MAX_RUN_AHEAD_FRAMES
+ *    speculative ones using the current input: the real state is captured
+ *    into a reused StateSnapshot, the last speculative frame is what gets
+ *    published and the state is restored.  Audio is gated meanwhile, so only
+ *    the real timeline is heard.
+ *
+ *  - With a rewind buffer attached, every real frame's state is pushed into
+ *    it.  While rewinding, each frame instead pops the newest snapshot,
+ *    restores it and shows the frame that followed it (audio gated), so
+ *    holding rewind plays history backwards at the normal frame rate.
+ *
+ * Pacing is deadline-based on the steady clock (one NTSC frame per
+ * 1 / 60.0988 s, PAL and Dendy per 1 / 50.007 s, divided by the speed
+ * multiplier), so how long the front end
+ * takes to draw never stretches or compresses emulated time.
+ *
+ * With perf counters attached every frame's emulation time (and, with their
+ * component breakdown on, the bus's per-component profile) is reported to
+ * them after the frame is published.
+ *
+ * With Pacing::Audio the audio device is the clock instead: a frame is
+ * emulated whenever the output buffer falls below its target fill, and the
+ * APU's resampler runs at its nominal ratio. The device then never drifts
+ * against emulation, whatever the display's refresh rate. Without a playing
+ * device (or while fast-forwarding, at other speeds or rewinding) pacing
+ * falls back to the clock.
+ *
+ * With Pacing::Host the front end is the clock: a frame is emulated for each
+ * request_frame(), with whatever input was posted before it. A front end
+ * polling its gamepads late in the display frame (LateInputScheduler) uses
+ * this to emulate right after the poll and present the result at the next
+ * swap. Fast-forward still runs uncapped.
+ */
+class EmulationThread {
+  public:
+	static constexpr int FRAME_WIDTH = 256;
+	static constexpr int FRAME_HEIGHT = 240;
+	using FrameBuffer = std::array<std::uint32_t, FRAME_WIDTH * FRAME_HEIGHT>;
+	// PPU::get_index_buffer() entries, for palette lookup on the GPU
+	using IndexBuffer = std::array<std::uint16_t, FRAME_WIDTH * FRAME_HEIGHT>;
+
+	// 341 * 262 - 0.5 PPU dots per NTSC frame (odd-frame skip) / 3 dots per CPU cycle
+	static constexpr double CPU_CYCLES_PER_FRAME = 29780.5;
+	// A frame that takes this long never completes (jammed CPU, PPU not wrapping)
+	static constexpr std::uint64_t MAX_FRAME_CYCLES = 29781 * 4;
+	// The CPU runs in slices of this many cycles between checks for pending
+	// exclusive() requests
+	static constexpr std::uint64_t EXCLUSIVE_POLL_CYCLES = 1024;
+	static constexpr int MAX_RUN_AHEAD_FRAMES = 4;
+
+	enum class Pacing : std::uint8_t {
+		Clock, // Frame deadlines on the steady clock
+		Audio, // Audio buffer demand
+		Host,  // request_frame() calls
+	};
+
+	EmulationThread(CPU6502 &cpu, PPU &ppu, SystemBus &bus, std::shared_ptr<LatchedInputSource> input);
+	~EmulationThread();
+
+	EmulationThread(const EmulationThread &) = delete;
+	EmulationThread &operator=(const EmulationThread &) = delete;
+
+	// Called on the emulation thread with a buffer to fill
+	void set_snapshot_callback(std::function<void(std::vector<std::uint8_t> &)> callback);
+	// Called on the emulation thread to capture and restore the real state
+	// for run-ahead and rewind (e.g. SaveStateManager::capture/restore)
+	void set_state_callbacks(std::function<void(StateSnapshot &)> capture,
+							 std::function<void(const StateSnapshot &)> restore);
+	// History for rewind (nullptr = none); not owned. Needs the state
+	// callbacks. Set before start() or from inside exclusive().
+	void set_rewind_buffer(RewindBuffer *buffer) noexcept {
+		rewind_buffer_ = buffer;
+	}
+	// Reports every frame's timing (nullptr = none); not owned. Set before
+	// start() or from inside exclusive().
+	void set_perf_counters(PerfCounters *counters) noexcept {
+		perf_counters_ = counters;
+	}
+	// Called on the emulation thread after every emulated frame
+	void set_frame_callback(std::function<void()> callback);
+
+	/**
+	 * Start the thread (paused).  Callbacks must be set before this.
+	 */
+	void start();
+
+	/**
+	 * Stop and join the thread; components are safe to touch afterwards
+	 */
+	void stop();
+
+	[[nodiscard]] bool is_started() const noexcept {
+		return thread_.joinable();
+	}
+
+	// Commands (front end thread only; applied at the next frame boundary)
+	void run();
+	void pause();
+	void set_speed(float multiplier);
+	void set_fast_forward(bool enabled);
+	void set_buttons(int player_index, Byte buttons);
+	// Frames to run ahead of the real one (0 = off); needs the run-ahead
+	// callbacks, and is skipped while fast-forwarding
+	void set_run_ahead(int frames);
+	// Step back through the rewind buffer instead of emulating, one frame per
+	// frame period, until turned off (holds on the oldest frame)
+	void set_rewinding(bool enabled);
+	void set_pacing(Pacing pacing);
+	// Pacing::Host: emulate one more frame (up to MAX_LAG_FRAMES queued)
+	void request_frame();
+
+	/**
+	 * Block until at least `count` frames have been emulated since start()
+	 * (get_frames_emulated()), or until deadline
+	 * @return false on timeout
+	 */
+	bool wait_for_frames(std::uint64_t count, std::chrono::steady_clock::time_point deadline);
+
+	/**
+	 * Run fn on the calling thread while emulation is parked at an instruction
+	 * boundary.  Runs fn directly if the thread has not been started.
+	 */
+	void exclusive(const std::function<void()> &fn);
+
+	/**
+	 * True when the thread is paused, idle and has no queued commands — the
+	 * components may then be read directly until the next run() is posted
+	 */
+	[[nodiscard]] bool is_idle() const;
+
+	/**
+	 * True once if emulation stopped itself because a frame never completed
+	 * (the thread pauses; post run() to retry)
+	 */
+	[[nodiscard]] bool take_fault() noexcept {
+		return fault_.exchange(false, std::memory_order_acq_rel);
+	}
+
+	/**
+	 * True once if emulation paused itself at a CPU breakpoint or watchpoint
+	 * (CPU6502::set_breakpoint, SystemBus::breakpoints(); post run() to
+	 * continue past it)
+	 */
+	[[nodiscard]] bool take_breakpoint_hit() noexcept {
+		return breakpoint_hit_.exchange(false, std::memory_order_acq_rel);
+	}
+
+	// Frames emulated since start()
+	[[nodiscard]] std::uint64_t get_frames_emulated() const noexcept {
+		return frames_emulated_.load(std::memory_order_relaxed);
+	}
+
+	// Reader side of the frame triple buffer (front end thread only)
+	bool update_frame() noexcept {
+		return frames_.update();
+	}
+	[[nodiscard]] const std::uint32_t *get_frame() const noexcept {
+		return frames_.read_buffer().pixels.data();
+	}
+	[[nodiscard]] const std::uint16_t *get_frame_indices() const noexcept {
+		return frames_.read_buffer().indices.data();
+	}
+	// When the frame began (input posted before this was applied to it) and
+	// when it was published
+	[[nodiscard]] std::chrono::steady_clock::time_point get_frame_started_at() const noexcept {
+		return frames_.read_buffer().started_at;
+	}
+	[[nodiscard]] std::chrono::steady_clock::time_point get_frame_completed_at() const noexcept {
+		return frames_.read_buffer().completed_at;
+	}
+
+	// Reader side of the snapshot triple buffer (front end thread only)
+	void request_snapshot() noexcept {
+		snapshot_requested_.store(true, std::memory_order_release);
+	}
+	bool update_snapshot() noexcept {
+		return snapshots_.update();
+	}
+	[[nodiscard]] const std::vector<std::uint8_t> &get_snapshot() const noexcept {
+		return snapshots_.read_buffer();
+	}
+
+  private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Command {
+		enum class Type : std::uint8_t {
+			Run,
+			Pause,
+			SetSpeed,
+			SetFastForward,
+			SetButtons,
+			SetRunAhead,
+			SetRewinding,
+			SetPacing,
+			RequestFrame
+		};
+		Type type = Type::Pause;
+		std::uint8_t player = 0;
+		Byte buttons = 0;
+		float value = 0.0f;
+	};
+
+	CPU6502 &cpu_;
+	PPU &ppu_;
+	SystemBus &bus_;
+	std::shared_ptr<LatchedInputSource> input_;
+
+	std::function<void(std::vector<std::uint8_t> &)> snapshot_callback_;
+	std::function<void(StateSnapshot &)> state_capture_;
+	std::function<void(const StateSnapshot &)> state_restore_;
+	std::function<void()> frame_callback_;
+
+	std::thread thread_;
+	mutable std::mutex mutex_;
+	std::condition_variable cv_;
+	std::atomic<bool> quit_{false};
+
+	// Command queue: front end pushes, emulation thread pops
+	SpscRingBuffer<Command, 256> commands_;
+
+	// exclusive() handshake (guarded by mutex_ except the pending count, which
+	// the emulation loop polls once per instruction)
+	std::atomic<int> exclusive_pending_{0};
+	bool parked_ = false;
+	bool idle_ = false;
+
+	// Emulation-thread state, changed only by commands
+	bool paused_ = true;
+	bool fast_forward_ = false;
+	float speed_ = 1.0f;
+	int run_ahead_ = 0;
+	StateSnapshot run_ahead_state_; // Real state while running ahead
+	bool rewinding_ = false;
+	Pacing pacing_ = Pacing::Clock;
+	int frame_requests_ = 0; // Pacing::Host frames requested and not run yet
+	RewindBuffer *rewind_buffer_ = nullptr;
+	StateSnapshot rewind_state_; // Pushed into / popped from rewind_buffer_
+	PerfCounters *perf_counters_ = nullptr;
+
+	std::atomic<bool> fault_{false};
+	std::atomic<bool> breakpoint_hit_{false};
+	std::atomic<std::uint64_t> frames_emulated_{0};
+	std::atomic<bool> snapshot_requested_{false};
+
+	struct Frame {
+		FrameBuffer pixels;
+		IndexBuffer indices;
+		Clock::time_point started_at;
+		Clock::time_point completed_at;
+	};
+	Clock::time_point frame_started_at_; // The real frame being emulated
+	TripleBuffer<Frame> frames_;
+	TripleBuffer<std::vector<std::uint8_t>> snapshots_;
+
+	void post(const Command &command);
+	void thread_main();
+	void drain_commands();
+	void park();
+	bool wake_pending() const;
+	void sleep_until(Clock::time_point deadline);
+	bool audio_paced() const;
+	void wait_for_audio_demand(Clock::duration period);
+	enum class FrameResult { Completed, Breakpoint, Fault, Interrupted };
+	// speculative: give up (Interrupted) rather than park for exclusive()
+	FrameResult run_frame(bool speculative = false);
+	void run_ahead();
+	void rewind_step();
+	void publish_pixels();
+	void finish_frame();
+	void report_frame(Clock::time_point start, std::uint64_t start_cycles);
+};
+
+} // namespace nes
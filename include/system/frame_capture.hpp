@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+/**
+ * FrameCapture - Records every submitted frame as PNG files or a raw video
+ * stream, encoding on worker threads
+ *
+ * submit() copies the 256x240 frame (PPU::get_frame_buffer() layout) into a
+ * buffer from a pool allocated by open() and queues it; the workers encode
+ * and write it. The emulating thread therefore pays one 240 KB copy per
+ * frame and never waits on compression or the disk.
+ *
+ * When every pool buffer is still queued, WhenFull decides: Drop skips the
+ * frame (counted in dropped_frames(); a live session keeps its frame rate),
+ * Wait blocks until a buffer frees up (a regression run keeps every frame
+ * and only slows down if the encoder really cannot keep up).
+ *
+ *  - PngSequence: <dir>/frame_000000.png, numbered from 0 in submit order;
+ *    frames are independent, so several workers encode in parallel
+ *  - RawVideo: packed RGB24 frames back to back, to a file or to the stdin
+ *    of an encoder started with open_pipe() (e.g. ffmpeg -f rawvideo
+ *    -pix_fmt rgb24 -s 256x240 -r 60.0988 -i - out.mp4); one worker keeps
+ *    them in order
+ *
+ * submit() must only be called from one thread at a time.
+ */
+class FrameCapture {
+  public:
+	static constexpr int FRAME_WIDTH = 256;
+	static constexpr int FRAME_HEIGHT = 240;
+	static constexpr std::size_t DEFAULT_POOL_FRAMES = 8;
+
+	enum class Format : std::uint8_t { PngSequence, RawVideo };
+	enum class WhenFull : std::uint8_t { Drop, Wait };
+
+	struct Options {
+		WhenFull when_full = WhenFull::Drop;
+		std::size_t pool_frames = DEFAULT_POOL_FRAMES;
+		unsigned workers = 1; // PngSequence only (0 = one per hardware thread)
+	};
+
+	FrameCapture() = default;
+	// Finishes the queued frames and closes the output
+	~FrameCapture();
+	FrameCapture(const FrameCapture &) = delete;
+	FrameCapture &operator=(const FrameCapture &) = delete;
+
+	/// PngSequence: path is the directory (created if missing); RawVideo: the file
+	bool open(const std::filesystem::path &path, Format format, const Options &options);
+	bool open(const std::filesystem::path &path, Format format) {
+		return open(path, format, Options{});
+	}
+	/// RawVideo into the standard input of a shell command
+	bool open_pipe(const std::string &command, const Options &options);
+	bool open_pipe(const std::string &command) {
+		return open_pipe(command, Options{});
+	}
+	/// Encode everything queued and close the output. Returns false if any
+	/// write failed (or the encoder command exited with an error).
+	bool close();
+
+	[[nodiscard]] bool is_open() const noexcept {
+		return !workers_.empty();
+	}
+
+	/// Queue a copy of the frame. False when it was dropped, or not open.
+	bool submit(const std::uint32_t *pixels);
+
+	// Frames queued so far / written out so far (exact after close) / dropped
+	[[nodiscard]] std::uint64_t frames_submitted() const noexcept {
+		return submitted_;
+	}
+	[[nodiscard]] std::uint64_t frames_written() const noexcept {
+		return written_.load(std::memory_order_relaxed);
+	}
+	[[nodiscard]] std::uint64_t dropped_frames() const noexcept {
+		return dropped_.load(std::memory_order_relaxed);
+	}
+
+	/// Where a PngSequence in dir puts frame n
+	[[nodiscard]] static std::filesystem::path sequence_path(const std::filesystem::path &dir, std::uint64_t frame);
+
+  private:
+	using Pixels = std::array<std::uint32_t, FRAME_WIDTH * FRAME_HEIGHT>;
+
+	struct Job {
+		std::uint64_t frame = 0;
+		std::size_t buffer = 0;
+	};
+
+	Format format_ = Format::PngSequence;
+	WhenFull when_full_ = WhenFull::Drop;
+	std::filesystem::path directory_;
+	std::ofstream file_;
+	std::FILE *pipe_ = nullptr;
+
+	std::vector<std::unique_ptr<Pixels>> pool_;
+	std::mutex mutex_;
+	std::condition_variable work_ready_;
+	std::condition_variable buffer_free_;
+	std::vector<std::size_t> free_buffers_;
+	std::deque<Job> queue_;
+	bool stopping_ = false;
+	bool failed_ = false;
+	std::vector<std::thread> workers_;
+
+	std::uint64_t submitted_ = 0;
+	std::atomic<std::uint64_t> written_{0};
+	std::atomic<std::uint64_t> dropped_{0};
+
+	bool start(const Options &options, unsigned workers);
+	void run();
+	bool encode(const Job &job, std::vector<std::uint8_t> &scratch);
+};
+
+} // namespace nes
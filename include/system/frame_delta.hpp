@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nes {
+
+/**
+ * FrameDeltaEncoder - Encodes index frames as tile deltas for streaming
+ *
+ * Frames are the PPU's index buffer (PPU::get_index_buffer(): 256x240
+ * entries, NES color in bits 0-5 and emphasis in bits 6-8). Each one is
+ * encoded against a frame the receiver already holds, named by the caller
+ * (the newest one the receiver acknowledged): only the 8x8 tiles that
+ * differ from it are sent, so a frame that scrolls a status bar or moves a
+ * few sprites costs a few hundred bytes. A base the encoder no longer holds
+ * (older than HISTORY frames, or NO_FRAME) gets a keyframe, every tile sent.
+ * Since the base is always one the receiver confirmed, a lost frame costs
+ * nothing but the frames after it growing until the next acknowledgement.
+ *
+ * An encoded frame: base frame number (u32, NO_FRAME for a keyframe), raw
+ * size (u32), then the LZ4 block of the raw bytes: a bitmap of the tiles
+ * sent (bit t of byte t / 8, tiles in row order), the low 8 bits of every
+ * sent tile's 64 entries, then bit 8 of them (one byte per tile row, left
+ * pixel in bit 7). The bit-8 planes are almost always zero and cost LZ4
+ * next to nothing.
+ */
+class FrameDeltaEncoder {
+  public:
+	static constexpr int WIDTH = 256;
+	static constexpr int HEIGHT = 240;
+	static constexpr int TILE_SIZE = 8;
+	static constexpr int TILES_X = WIDTH / TILE_SIZE;
+	static constexpr int TILES_Y = HEIGHT / TILE_SIZE;
+	static constexpr int TILE_COUNT = TILES_X * TILES_Y;
+	static constexpr std::size_t PIXELS = static_cast<std::size_t>(WIDTH) * HEIGHT;
+	static constexpr std::size_t BITMAP_BYTES = TILE_COUNT / 8;
+	static constexpr std::size_t TILE_BYTES = TILE_SIZE * TILE_SIZE + TILE_SIZE; // Low bytes + bit-8 rows
+	static constexpr std::size_t MAX_RAW_BYTES = BITMAP_BYTES + TILE_COUNT * TILE_BYTES;
+	static constexpr std::size_t HEADER_BYTES = 8;
+	/// Frames kept as bases: 133 ms of round trip at 60 fps
+	static constexpr std::size_t HISTORY = 8;
+	static constexpr std::uint32_t NO_FRAME = 0xFFFFFFFFu;
+
+	/**
+	 * Encode frame as number number into out (replacing its contents), as a
+	 * delta against acked if that frame is still held
+	 * @return true if it is a keyframe
+	 */
+	bool encode(std::uint32_t number, const std::uint16_t *frame, std::uint32_t acked, std::vector<std::uint8_t> &out);
+
+	/// Forget every held frame (a new receiver): the next frame is a keyframe
+	void reset() noexcept;
+
+  private:
+	struct Held {
+		std::uint32_t number = NO_FRAME;
+		std::vector<std::uint16_t> pixels;
+	};
+	std::array<Held, HISTORY> history_;
+	std::size_t next_ = 0; // Slot the next frame replaces
+	std::vector<std::uint8_t> raw_;
+};
+
+/**
+ * FrameDeltaDecoder - The receiving side of FrameDeltaEncoder
+ *
+ * Holds the last HISTORY decoded frames, which is what the encoder may
+ * send deltas against.
+ */
+class FrameDeltaDecoder {
+  public:
+	/**
+	 * Decode encoded frame number; false (and nothing changed) if it is not
+	 * newer than latest(), is malformed or its base is not held
+	 */
+	bool decode(std::uint32_t number, const std::uint8_t *data, std::size_t size);
+
+	/// Newest frame decoded (NO_FRAME before the first)
+	[[nodiscard]] std::uint32_t latest() const noexcept {
+		return latest_;
+	}
+	/// Its 256x240 entries; null before the first
+	[[nodiscard]] const std::uint16_t *frame() const noexcept {
+		return latest_ == FrameDeltaEncoder::NO_FRAME ? nullptr : history_[latest_slot_].pixels.data();
+	}
+
+	void reset() noexcept;
+
+  private:
+	struct Held {
+		std::uint32_t number = FrameDeltaEncoder::NO_FRAME;
+		std::vector<std::uint16_t> pixels;
+	};
+	std::array<Held, FrameDeltaEncoder::HISTORY> history_;
+	std::size_t next_ = 0;
+	std::size_t latest_slot_ = 0;
+	std::uint32_t latest_ = FrameDeltaEncoder::NO_FRAME;
+	std::vector<std::uint8_t> raw_;
+};
+
+} // namespace nes
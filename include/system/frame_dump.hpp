@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nes {
+
+// Output helpers shared by the headless tools; frames are 256x240 ABGR
+// (R in the low byte), as PPU::get_frame_buffer() returns them
+
+// FNV-1a over the frame's pixels, the hash the tools print as frame_hash
+[[nodiscard]] std::uint64_t hash_frame_buffer(const std::uint32_t *pixels);
+
+// Per-frame regression hashes, taken from PPU::get_index_buffer() (palette
+// index plus emphasis per pixel) so they skip the RGBA conversion and do not
+// depend on the palette in use
+struct FrameHashes {
+	std::uint64_t exact = 0;	  // XXH64 of the index buffer
+	std::uint64_t perceptual = 0; // Average hash: 8x8 blocks brighter than the frame's mean
+
+	bool operator==(const FrameHashes &) const = default;
+};
+[[nodiscard]] FrameHashes hash_frame_indices(const std::uint16_t *indices);
+// Bits that differ between two perceptual hashes (0 = looks the same,
+// a few = small change such as a moved sprite, 32 ~ unrelated pictures)
+[[nodiscard]] int perceptual_distance(std::uint64_t a, std::uint64_t b);
+
+// Golden traces: one "exact perceptual" hex pair per frame, in frame order
+bool write_frame_hash_trace(const std::string &path, const std::vector<FrameHashes> &frames);
+bool read_frame_hash_trace(const std::string &path, std::vector<FrameHashes> &frames);
+
+// Write the frame as a binary PPM (P6)
+bool write_frame_ppm(const std::string &path, const std::uint32_t *pixels);
+
+// The frame as a 24-bit RGB PNG. Compressed with fixed-code deflate and a
+// greedy LZ77 matcher, no zlib needed: NES frames are mostly flat runs, so
+// typical screens still come out at a few KB (zlib would do ~2x better).
+[[nodiscard]] std::vector<std::uint8_t> encode_frame_png(const std::uint32_t *pixels);
+bool write_frame_png(const std::string &path, const std::uint32_t *pixels);
+
+// Packed RGB24, top row first: one raw video frame (ffmpeg -f rawvideo -pix_fmt rgb24)
+void pack_frame_rgb(const std::uint32_t *pixels, std::uint8_t *rgb);
+
+} // namespace nes
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace nes {
+
+/**
+ * LatencyHistogram - Fixed-bucket distribution of durations
+ *
+ * Samples land in 0.1 ms buckets up to MAX_MS; anything longer is counted in
+ * the last one. Percentiles are read back as the upper edge of the bucket
+ * they fall in, so they are exact to a bucket width whatever the sample
+ * count, and recording never allocates.
+ */
+class LatencyHistogram {
+  public:
+	static constexpr double BUCKET_MS = 0.1;
+	static constexpr double MAX_MS = 250.0;
+	static constexpr std::size_t BUCKETS = static_cast<std::size_t>(MAX_MS / BUCKET_MS);
+
+	void record(double ms) noexcept;
+	void reset() noexcept;
+
+	[[nodiscard]] std::uint64_t count() const noexcept {
+		return count_;
+	}
+	// 0 when empty
+	[[nodiscard]] double mean() const noexcept;
+	[[nodiscard]] double max() const noexcept {
+		return max_ms_;
+	}
+	/// Smallest bucket edge with at least fraction (0..1] of the samples at
+	/// or below it; 0 when empty
+	[[nodiscard]] double percentile(double fraction) const noexcept;
+	[[nodiscard]] std::uint32_t bucket(std::size_t i) const noexcept {
+		return buckets_[i];
+	}
+
+  private:
+	std::array<std::uint32_t, BUCKETS> buckets_{};
+	std::uint64_t count_ = 0;
+	double sum_ms_ = 0.0;
+	double max_ms_ = 0.0;
+};
+
+/**
+ * FrameLatency - Frame pacing and input-to-present latency, per presented frame
+ *
+ * The front end stamps each step a frame goes through on its way to the
+ * screen: the gamepad poll, the emulation thread finishing the frame, the
+ * texture upload and SDL_GL_SwapWindow returning. Every swap that shows a
+ * newly emulated frame is one presentation, and record() files its
+ * intervals in one histogram per metric:
+ *
+ *  - FrameTime: swap to swap, between presentations
+ *  - InputLatency: the last input poll the emulated frame could see to swap
+ *  - EmulationLatency: frame completed on the emulation thread to swap
+ *  - SwapWait: texture uploaded to swap return (VSync and driver queueing)
+ *
+ * Swap return is the closest the front end gets to photons; the display's
+ * own scan-out and processing come on top and are not measured.
+ *
+ * Front end thread only.
+ */
+class FrameLatency {
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	enum class Metric : std::uint8_t { FrameTime, InputLatency, EmulationLatency, SwapWait };
+	static constexpr std::size_t METRIC_COUNT = 4;
+
+	/// One presented frame. A default time_point means the step was not seen
+	/// (no poll yet, say) and the metrics that need it are skipped.
+	struct Presentation {
+		Clock::time_point input_poll;
+		Clock::time_point frame_completed;
+		Clock::time_point upload_done;
+		Clock::time_point swap_done;
+	};
+
+	[[nodiscard]] static const char *metric_name(Metric metric) noexcept;
+
+	void record(const Presentation &presentation) noexcept;
+	/// Clear every histogram; the next presentation starts a new frame time
+	void reset() noexcept;
+
+	[[nodiscard]] const LatencyHistogram &histogram(Metric metric) const noexcept {
+		return histograms_[static_cast<std::size_t>(metric)];
+	}
+	[[nodiscard]] std::uint64_t presentations() const noexcept {
+		return presentations_;
+	}
+
+	/// CSV: count, mean, p50/p95/p99 and max of every metric, one row each
+	void write_report(std::ostream &out) const;
+
+  private:
+	std::array<LatencyHistogram, METRIC_COUNT> histograms_{};
+	Clock::time_point last_swap_{};
+	std::uint64_t presentations_ = 0;
+};
+
+} // namespace nes
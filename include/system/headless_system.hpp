@@ -0,0 +1,148 @@
+#pragma once
+
+#include "core/accuracy.hpp"
+#include "core/bus_stats.hpp"
+#include "core/types.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nes {
+
+class APU;
+class Cartridge;
+class CPU6502;
+class InputSource;
+class NesSystem;
+class PPU;
+class Ram;
+class RenderPipeline;
+class RomImage;
+class SystemBus;
+struct RomData;
+
+/**
+ * HeadlessSystem - Fully wired NES with no display, audio or input device
+ *
+ * Owns a NesSystem, the same console GuiApplication runs, but never touches
+ * SDL, so many instances can run in
+ * one process for ROM regression runs, bots and benchmarks.  Audio output is
+ * left unattached (the APU still clocks, it just queues nothing).
+ *
+ * The bus runs in PPU catch-up mode; every run_* call returns with the PPU
+ * synced, so frame buffer and component state are current afterwards.
+ */
+class HeadlessSystem {
+  public:
+	/**
+	 * @param input_source Optional button state provider (null = no buttons pressed)
+	 */
+	explicit HeadlessSystem(std::shared_ptr<InputSource> input_source = nullptr);
+	~HeadlessSystem();
+
+	HeadlessSystem(const HeadlessSystem &) = delete;
+	HeadlessSystem &operator=(const HeadlessSystem &) = delete;
+
+	/**
+	 * Load an iNES ROM and reset the system
+	 * @return true if the ROM loaded successfully
+	 */
+	bool load_rom(const std::string &filepath);
+
+	/**
+	 * Load synthetic ROM data (tests) and reset the system
+	 * @return true if the cartridge accepted the data
+	 */
+	bool load_rom_data(const RomData &rom_data);
+
+	/**
+	 * Load a ROM image shared with other systems and reset the system; only
+	 * the cartridge's RAM is this system's own
+	 * @return true if the cartridge accepted the image
+	 */
+	bool load_rom_image(std::shared_ptr<const RomImage> image);
+
+	/**
+	 * Run until the PPU completes the current frame
+	 * @return CPU cycles executed (0 if the CPU stalled)
+	 */
+	std::uint64_t run_frame();
+
+	/**
+	 * Run a fixed number of CPU cycles (instruction-granular, may overshoot)
+	 * @return CPU cycles actually executed
+	 */
+	std::uint64_t run_cycles(std::uint64_t cycles);
+
+	void reset();
+
+	/**
+	 * A second headless system in this one's exact state (same run policy,
+	 * shared ROM image); see NesSystem::clone()
+	 * @return null if no ROM is loaded
+	 */
+	[[nodiscard]] std::unique_ptr<HeadlessSystem> clone(std::shared_ptr<InputSource> input_source = nullptr);
+	// Put target in this system's state, reusing it; see NesSystem::clone_into()
+	bool clone_into(HeadlessSystem &target);
+
+	/**
+	 * Compose only every Nth frame's pixels (0 or 1 = every frame). Timing,
+	 * flags and mapper IRQs are unaffected; see PPU::set_frame_skip().
+	 * Running a multiple of N frames ends on a composed frame.
+	 */
+	void set_frame_skip(uint32_t interval);
+
+	/**
+	 * PPU accuracy profile (see Accuracy); pick one per ROM with
+	 * AccuracyDatabase. Clones and the rendering pipeline's copy follow it.
+	 */
+	void set_accuracy(Accuracy accuracy);
+
+	/**
+	 * Draw the pixels on a second thread (see RenderPipeline). This system's
+	 * PPU then only keeps what the CPU can observe, and get_frame_buffer()
+	 * shows the frame as of the end of the run before the last one, or of
+	 * the last one after sync_rendering(). Off by default.
+	 */
+	void set_pipelined_rendering(bool enabled);
+	[[nodiscard]] bool is_pipelined_rendering() const noexcept {
+		return pipeline_ != nullptr;
+	}
+	// Wait for the second thread to draw the last run
+	void sync_rendering();
+	[[nodiscard]] const RenderPipeline *render_pipeline() const noexcept {
+		return pipeline_.get();
+	}
+
+	// 256x240 RGBA frame buffer of the most recently rendered frame
+	[[nodiscard]] const uint32_t *get_frame_buffer() const;
+	[[nodiscard]] uint64_t get_frame_count() const;
+
+	// Traffic counters (see BusStats): CPU accesses by region and PPU fetches
+	// over the frames completed since reset_bus_stats(). All zero unless
+	// BusStats::ENABLED.
+	[[nodiscard]] const BusStats &get_bus_stats() const;
+	[[nodiscard]] const PpuFetchStats &get_ppu_fetch_stats() const;
+	void reset_bus_stats();
+
+	// Component access for tools and tests
+	[[nodiscard]] NesSystem &system() noexcept {
+		return *system_;
+	}
+	[[nodiscard]] SystemBus &bus() noexcept;
+	[[nodiscard]] CPU6502 &cpu() noexcept;
+	[[nodiscard]] PPU &ppu() noexcept;
+	[[nodiscard]] APU &apu() noexcept;
+	[[nodiscard]] Cartridge &cartridge() noexcept;
+	[[nodiscard]] Ram &ram() noexcept;
+
+  private:
+	explicit HeadlessSystem(std::unique_ptr<NesSystem> system);
+
+	std::unique_ptr<NesSystem> system_;
+	std::unique_ptr<RenderPipeline> pipeline_; // Destroyed first, it points into system_
+
+	void apply_run_policy();
+};
+
+} // namespace nes
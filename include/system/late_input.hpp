@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace nes {
+
+/**
+ * LateInputScheduler - When to poll input so the next swap still makes it
+ *
+ * Polling the gamepads right after a buffer swap and emulating straight
+ * away leaves the new frame waiting most of a refresh for the next swap, and
+ * the input it saw is that much older when it shows. This schedules the poll
+ * as late as possible instead: the expected next swap minus the time the
+ * emulated frame and the front end's own drawing take, minus a margin. The
+ * front end sleeps until poll_time(), polls, requests the frames_due()
+ * (EmulationThread::Pacing::Host), waits for them and draws.
+ *
+ *  - Fixed: poll `lead` before the expected swap
+ *  - Adaptive: poll the slowest of the last COST_WINDOW frames' cost plus
+ *    `lead` before it, so the poll moves later on a fast machine and earlier
+ *    when a heavy mapper or the debugger slows frames down
+ *
+ * The refresh period is measured from the swaps themselves; swaps that miss
+ * or repeat a vsync (more than half a period off) are left out of it. Until
+ * there is a measurement, the poll is right after the swap.
+ *
+ * Front end thread only.
+ */
+class LateInputScheduler {
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	enum class Mode : std::uint8_t { Off, Fixed, Adaptive };
+
+	static constexpr std::size_t COST_WINDOW = 60;
+	// Frames emulated per poll at most; the rest of a backlog is dropped
+	static constexpr int MAX_FRAMES_PER_POLL = 2;
+
+	void set_mode(Mode mode) noexcept;
+	[[nodiscard]] Mode mode() const noexcept {
+		return mode_;
+	}
+	void set_lead(Clock::duration lead) noexcept {
+		lead_ = lead;
+	}
+	[[nodiscard]] Clock::duration lead() const noexcept {
+		return lead_;
+	}
+	// One emulated frame at the current speed (region and speed multiplier)
+	void set_frame_period(Clock::duration period) noexcept {
+		frame_period_ = period;
+	}
+
+	// A buffer swap returned at `time`
+	void on_swap(Clock::time_point time) noexcept;
+	// What one presented frame cost between poll and swap: emulating it plus
+	// the front end's upload and drawing (not the swap's vsync wait)
+	void record_cost(Clock::duration cost) noexcept;
+
+	// When to poll for the next swap (the last swap itself with Off)
+	[[nodiscard]] Clock::time_point poll_time() const noexcept;
+	// Emulated frames owed at a poll at `time`, 0..MAX_FRAMES_PER_POLL; each
+	// call settles the time since the previous one
+	int frames_due(Clock::time_point time) noexcept;
+
+	[[nodiscard]] Clock::duration refresh_period() const noexcept {
+		return refresh_period_;
+	}
+	// Slowest cost in the window (zero before any frame)
+	[[nodiscard]] Clock::duration cost() const noexcept;
+
+	// Forget measurements and owed time (after a pause, say)
+	void reset() noexcept;
+
+  private:
+	Mode mode_ = Mode::Off;
+	Clock::duration lead_ = std::chrono::milliseconds(2);
+	Clock::duration frame_period_{};
+
+	Clock::time_point last_swap_{};
+	Clock::duration refresh_period_{};
+
+	std::array<Clock::duration, COST_WINDOW> costs_{};
+	std::size_t next_cost_ = 0;
+
+	Clock::time_point last_poll_{};
+	Clock::duration owed_{};
+};
+
+} // namespace nes
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace nes {
+
+/**
+ * MappedFile - A file mapped shared and writable
+ *
+ * open() maps the first `size` bytes of a file, creating it, or extending a
+ * shorter one, first. Stores into bytes() are then the file's contents: the
+ * OS writes them back from its page cache without any write call, and they
+ * survive the process dying (not the machine losing power; sync() waits for
+ * the disk). How long the file was before open() extended it is kept, since
+ * the bytes past that have no meaning yet.
+ *
+ * Not copyable or movable: whatever points into bytes() keeps the mapping
+ * where it is. close() (or the destructor) unmaps.
+ */
+class MappedFile {
+  public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	/// Map path (closing any file mapped now); false if it cannot be opened
+	/// for writing, is not a regular file, or size is 0
+	bool open(const std::filesystem::path &path, std::size_t size);
+	void close() noexcept;
+	/// Wait for the stores made so far to reach the disk
+	bool sync() noexcept;
+
+	[[nodiscard]] bool is_open() const noexcept {
+		return view_ != nullptr;
+	}
+	[[nodiscard]] std::span<Byte> bytes() const noexcept {
+		return {view_, size_};
+	}
+	/// The file's size before open(), capped at the mapped size
+	[[nodiscard]] std::size_t original_size() const noexcept {
+		return original_size_;
+	}
+
+  private:
+	Byte *view_ = nullptr;
+	std::size_t size_ = 0;
+	std::size_t original_size_ = 0;
+#if defined(_WIN32)
+	void *file_ = nullptr; // HANDLE, kept for FlushFileBuffers
+#endif
+};
+
+} // namespace nes
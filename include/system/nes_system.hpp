@@ -0,0 +1,131 @@
+#pragma once
+
+#include "apu/apu.hpp"
+#include "cartridge/cartridge.hpp"
+#include "core/bus.hpp"
+#include "cpu/cpu_6502.hpp"
+#include "input/controller.hpp"
+#include "memory/ram.hpp"
+#include "ppu/ppu.hpp"
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nes {
+
+class InputSource;
+class RomImage;
+struct RomData;
+
+/**
+ * NesSystem - The console: every component in one object
+ *
+ * Owns the bus, RAM, APU, controllers, cartridge, PPU and CPU as plain
+ * members, so a whole machine is one allocation with its hot state close
+ * together and no reference counts between the parts. The components are
+ * still wired through their connect_* calls, but with non-owning handles:
+ * each part lives exactly as long as the NesSystem around it.
+ *
+ * Only wiring lives here; power_on() and run policy (PPU catch-up, synthesis
+ * mode, idle-loop skipping, audio output) are left to the owner — see HeadlessSystem and
+ * GuiApplication. Not copyable or movable, since the components point at
+ * each other; use clone() to fork a running machine.
+ */
+class NesSystem {
+  public:
+	/**
+	 * @param input_source Optional button state provider (null = no buttons pressed)
+	 */
+	explicit NesSystem(std::shared_ptr<InputSource> input_source = nullptr);
+	~NesSystem() = default;
+
+	NesSystem(const NesSystem &) = delete;
+	NesSystem &operator=(const NesSystem &) = delete;
+	NesSystem(NesSystem &&) = delete;
+	NesSystem &operator=(NesSystem &&) = delete;
+
+	// Load into the cartridge, pick up its mirroring and region, then reset
+	bool load_rom(const std::string &filepath);
+	bool load_rom_data(const RomData &rom_data);
+	bool load_rom_image(std::shared_ptr<const RomImage> image);
+
+	// After loading straight into cartridge(): take over its mirroring,
+	// region and the input devices its header asks for (no reset)
+	void refresh_cartridge();
+
+	void reset();
+
+	/**
+	 * A new machine in this one's exact state, sharing its ROM image. Run
+	 * policy is not copied, and the copy reads its buttons from input_source.
+	 * Null if no ROM is loaded.
+	 */
+	[[nodiscard]] std::unique_ptr<NesSystem> clone(std::shared_ptr<InputSource> input_source = nullptr);
+
+	/**
+	 * Put target in this machine's exact state: registers, RAM, VRAM, OAM,
+	 * palette, APU, mapper registers and cartridge RAM. The ROM image is
+	 * shared, so only the first copy into a target loads it; after that a
+	 * copy is a few microseconds and allocates nothing, which is what search
+	 * and rollout bots forking a position thousands of times want. The frame
+	 * buffer is not copied (the target's next frame redraws it), nor are run
+	 * policy or input wiring.
+	 * @return false if no ROM is loaded
+	 */
+	bool clone_into(NesSystem &target);
+
+	/**
+	 * Append everything clone_into() carries across, cartridge RAM included,
+	 * plus the master clock: two machines that write the same bytes run on
+	 * identically given the same input
+	 */
+	void serialize_machine(std::vector<std::uint8_t> &buffer);
+
+	[[nodiscard]] SystemBus &bus() noexcept {
+		return bus_;
+	}
+	[[nodiscard]] const SystemBus &bus() const noexcept {
+		return bus_;
+	}
+	[[nodiscard]] CPU6502 &cpu() noexcept {
+		return cpu_;
+	}
+	[[nodiscard]] PPU &ppu() noexcept {
+		return ppu_;
+	}
+	[[nodiscard]] const PPU &ppu() const noexcept {
+		return ppu_;
+	}
+	[[nodiscard]] APU &apu() noexcept {
+		return apu_;
+	}
+	[[nodiscard]] Cartridge &cartridge() noexcept {
+		return cartridge_;
+	}
+	[[nodiscard]] const Cartridge &cartridge() const noexcept {
+		return cartridge_;
+	}
+	[[nodiscard]] Ram &ram() noexcept {
+		return ram_;
+	}
+	[[nodiscard]] Controller &controllers() noexcept {
+		return controllers_;
+	}
+
+  private:
+	// Declaration order is construction order: the CPU takes the bus
+	SystemBus bus_;
+	Ram ram_;
+	APU apu_;
+	Controller controllers_;
+	Cartridge cartridge_;
+	PPU ppu_;
+	CPU6502 cpu_;
+
+	std::vector<std::uint8_t> clone_state_; // clone_into() scratch, kept between calls
+
+	bool on_cartridge_loaded();
+};
+
+} // namespace nes
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "audio/spsc_ring_buffer.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace nes {
+
+/**
+ * PerfCounters - Where each emulated frame's time goes, frame by frame
+ *
+ * The emulation thread reports every frame it emulates (record_frame): the
+ * wall time spent emulating it, the CPU cycles it ran and the audio queued
+ * when it finished. With the component breakdown enabled it also passes the
+ * frame's share of the bus's CycleProfile, which splits that time into
+ * PPU, APU and mapper/IRQ work, CPU being the remainder. The breakdown
+ * costs three clock reads per CPU cycle, so it is off by default; the frame
+ * totals cost a few per frame.
+ *
+ * The front end times its own work (texture upload, building and drawing
+ * the UI) and hands both over with collect(), which moves every reported
+ * frame into a HISTORY-frame ring tagged with the last presentation's
+ * times. The ring feeds rolling graphs and write_csv().
+ *
+ * record_frame() must only be called from one thread (the emulation thread)
+ * and everything else from one other (the front end).
+ */
+class PerfCounters {
+  public:
+	static constexpr std::size_t HISTORY = 512; // ~8.5 s at 60 fps
+
+	enum class Counter : std::uint8_t {
+		Emulation,	   // Wall time emulating the frame (run-ahead included)
+		Cpu,		   // Emulation minus the components below
+		Ppu,		   // PPU dots
+		Apu,		   // APU cycles (and expansion audio)
+		Mapper,		   // Scheduled events: catch-up, mapper IRQs, IRQ line
+		AudioQueue,	   // Audio queued for the device after the frame
+		TextureUpload, // Front end: frame to GPU
+		Gui,		   // Front end: panels, ImGui render and draw
+	};
+	static constexpr std::size_t COUNTER_COUNT = 8;
+
+	/// One emulated frame, as the emulation thread saw it
+	struct FrameReport {
+		std::uint64_t emulation_ns = 0;
+		std::uint64_t cpu_cycles = 0;
+		double audio_queue_ms = 0.0;
+		bool components = false; // The three below were measured
+		std::uint64_t ppu_ns = 0;
+		std::uint64_t apu_ns = 0;
+		std::uint64_t mapper_ns = 0;
+	};
+
+	/// One history row; values in milliseconds
+	struct Frame {
+		std::uint64_t index = 0; // Frames reported since reset()
+		std::uint64_t cpu_cycles = 0;
+		bool components = false; // Cpu/Ppu/Apu/Mapper hold measurements
+		std::array<float, COUNTER_COUNT> ms{};
+
+		[[nodiscard]] float operator[](Counter counter) const noexcept {
+			return ms[static_cast<std::size_t>(counter)];
+		}
+	};
+
+	[[nodiscard]] static const char *counter_name(Counter counter) noexcept;
+	// Cpu, Ppu, Apu and Mapper: only measured with the component breakdown
+	[[nodiscard]] static constexpr bool is_component(Counter counter) noexcept {
+		return counter == Counter::Cpu || counter == Counter::Ppu || counter == Counter::Apu ||
+			   counter == Counter::Mapper;
+	}
+
+	// Emulation thread. Frames reported while the front end falls a queue
+	// behind are dropped.
+	void record_frame(const FrameReport &report) noexcept;
+
+	/// Whether the emulation thread should measure the component breakdown
+	void set_component_breakdown(bool enabled) noexcept {
+		component_breakdown_.store(enabled, std::memory_order_relaxed);
+	}
+	[[nodiscard]] bool is_component_breakdown() const noexcept {
+		return component_breakdown_.load(std::memory_order_relaxed);
+	}
+
+	// Front end thread
+	/// Move reported frames into the history, with this presentation's times
+	void collect(std::uint64_t texture_upload_ns, std::uint64_t gui_ns) noexcept;
+	/// Clear the history and drop frames not collected yet
+	void reset() noexcept;
+
+	[[nodiscard]] std::size_t size() const noexcept {
+		return count_;
+	}
+	// i = 0 is the oldest frame held
+	[[nodiscard]] const Frame &frame(std::size_t i) const noexcept {
+		return history_[(next_ + HISTORY - count_ + i) % HISTORY];
+	}
+	// Mean and maximum of one counter over the history (0 when empty)
+	[[nodiscard]] float average(Counter counter) const noexcept;
+	[[nodiscard]] float peak(Counter counter) const noexcept;
+
+	/// The history, oldest first, one row per frame. Breakdown columns are
+	/// left empty for frames measured without it.
+	void write_csv(std::ostream &out) const;
+
+  private:
+	SpscRingBuffer<FrameReport, 256> reports_;
+	std::atomic<bool> component_breakdown_{false};
+
+	// Front end only
+	std::array<Frame, HISTORY> history_{};
+	std::size_t next_ = 0;
+	std::size_t count_ = 0;
+	std::uint64_t frames_collected_ = 0;
+};
+
+} // namespace nes
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "ppu/ppu_write_log.hpp"
+#include "ppu/scanline_timeline.hpp"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+class NesSystem;
+
+/**
+ * RenderPipeline - The pixels of a system's frames, drawn on another thread
+ *
+ * Behind HeadlessSystem::set_pipelined_rendering(). The system's own PPU
+ * keeps exact timing and everything the CPU can observe (status flags,
+ * sprite-0 hit and overflow, A12 edges for mapper IRQs) but composes no
+ * pixels, while its bus logs what the CPU does to the PPU's inputs
+ * (PpuWriteLog). After each run the log goes to a worker thread, which
+ * replays it on a copy of the machine whose PPU does compose. Composition is
+ * about a third of the PPU's time with rendering on; it moves to the
+ * worker, and the frames come out one run behind.
+ *
+ * The copy is seeded with NesSystem::clone_into() and from then on kept in
+ * step by the log alone. Anything else that moves the system (reset, state
+ * load, being cloned onto) shows up at the next begin_run() as a jump in the
+ * PPU's frame generation or dot counter, and the worker compares every
+ * frame it completes with the system's ScanlineTimeline; either way the copy
+ * is seeded again and publishing resumes with the first frame drawn whole
+ * after that. Mapper state that CPU reads change is not logged, so a game
+ * relying on it reseeds every frame. Light guns look at the system's own
+ * pixels and see none.
+ */
+class RenderPipeline {
+  public:
+	/// Starts logging system's bus and stops its PPU composing
+	explicit RenderPipeline(NesSystem &system);
+	/// Waits for the worker, then restores both
+	~RenderPipeline();
+	RenderPipeline(const RenderPipeline &) = delete;
+	RenderPipeline &operator=(const RenderPipeline &) = delete;
+
+	/// Before the system runs: reseeds the copy if the system moved since end_run()
+	void begin_run();
+	/// After the run, with the PPU synced: hands the run's log to the worker
+	/// and publishes the frame it drew for the run before
+	void end_run();
+	/// Wait until the worker has replayed every run and publish its frame
+	void sync();
+
+	/// Palette indices of the published frame (see PPU::get_index_buffer());
+	/// changes only in end_run() and sync()
+	[[nodiscard]] const std::uint16_t *index_buffer() const noexcept {
+		return shown_.data();
+	}
+	/// The published frame in RGBA, resolved on each call
+	[[nodiscard]] const std::uint32_t *frame_buffer();
+	/// PPU frame count when the published frame was taken (0 = none yet)
+	[[nodiscard]] std::uint64_t frame_count() const noexcept {
+		return shown_frame_;
+	}
+
+	struct Stats {
+		std::uint64_t runs = 0;		   // Logs replayed
+		std::uint64_t entries = 0;	   // Log entries replayed
+		std::uint64_t reseeds = 0;	   // Copies seeded, the first included
+		std::uint64_t divergences = 0; // Reseeds because a replay went astray
+	};
+	/// Consistent after sync()
+	[[nodiscard]] const Stats &stats() const noexcept {
+		return stats_;
+	}
+
+  private:
+	static constexpr std::size_t PIXELS = 256 * 240;
+
+	struct Job {
+		PpuWriteLog log;
+		std::uint32_t end_dot = 0;
+		std::uint64_t frame_count = 0;
+		std::uint32_t frame_skip = 0;
+		bool check = false; // A frame completed: compare it with expected
+		ScanlineTimeline::Frame expected{};
+	};
+
+	NesSystem &system_;
+	std::unique_ptr<NesSystem> copy_; // The worker's, except while it is idle
+	bool seeded_ = false;
+	std::uint64_t generation_ = 0; // The system's PPU after end_run()
+	std::uint32_t dot_ = 0;
+
+	std::array<Job, 2> jobs_;
+	std::size_t logging_ = 0; // The job the bus fills
+
+	std::vector<std::uint16_t> shown_;
+	std::vector<std::uint32_t> shown_rgba_;
+	std::uint64_t shown_frame_ = 0;
+
+	// Shared with the worker
+	mutable std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable idle_;
+	Job *pending_ = nullptr;
+	bool busy_ = false;
+	bool quit_ = false;
+	bool diverged_ = false;
+	std::vector<std::uint16_t> drawn_;
+	std::uint64_t drawn_frame_ = 0;
+	bool drawn_new_ = false;
+	Stats stats_;
+
+	// The worker's own
+	std::uint64_t publish_from_ = 0; // First frame count drawn whole since the seeding
+
+	std::thread worker_;
+
+	void reseed();
+	void wait_idle(std::unique_lock<std::mutex> &lock);
+	void take_drawn();
+	void work();
+	void replay(const Job &job);
+};
+
+} // namespace nes
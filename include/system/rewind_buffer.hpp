@@ -0,0 +1,97 @@
+#pragma once
+
+#include "system/save_state.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace nes {
+
+/**
+ * RewindBuffer - Bounded history of per-frame StateSnapshots
+ *
+ * Every pushed snapshot is stored compressed in one fixed-size arena (the
+ * memory budget). Every keyframe_interval-th one is a keyframe, stored on
+ * its own; the others are XORed against the newest keyframe first, which
+ * leaves almost nothing but zeros since a frame changes little of the state.
+ * Both are run-length encoded as alternating zero runs and literal runs:
+ *
+ *   [zero count][literal count][literal bytes] ...  (counts as LEB128)
+ *
+ * When the arena is full the oldest keyframe is dropped together with the
+ * deltas that need it. pop() hands back the newest snapshot and forgets it,
+ * so history can be stepped backwards one frame at a time and resumed from
+ * anywhere. A snapshot of another ROM, or of one reloaded since, starts the
+ * history over.
+ *
+ * Buffers are allocated with the first push (and when the state size
+ * changes); pushing and popping after that only touch the entry queue.
+ */
+class RewindBuffer {
+  public:
+	static constexpr size_t DEFAULT_BUDGET = 16u << 20;
+	static constexpr unsigned DEFAULT_KEYFRAME_INTERVAL = 120;
+
+	explicit RewindBuffer(size_t memory_budget = DEFAULT_BUDGET,
+						  unsigned keyframe_interval = DEFAULT_KEYFRAME_INTERVAL);
+
+	/// Append a snapshot as the newest frame (invalid snapshots are ignored)
+	void push(const StateSnapshot &snapshot);
+	/// Move the newest frame into snapshot; false when there is none
+	bool pop(StateSnapshot &snapshot);
+	void clear();
+
+	// Frames stored
+	[[nodiscard]] size_t frame_count() const noexcept {
+		return entries_.size();
+	}
+	[[nodiscard]] bool empty() const noexcept {
+		return entries_.empty();
+	}
+	// Compressed bytes held, out of memory_budget()
+	[[nodiscard]] size_t memory_used() const noexcept {
+		return used_;
+	}
+	[[nodiscard]] size_t memory_budget() const noexcept {
+		return budget_;
+	}
+	[[nodiscard]] unsigned keyframe_interval() const noexcept {
+		return keyframe_interval_;
+	}
+
+  private:
+	struct Entry {
+		size_t offset; // Into arena_
+		size_t size;
+		bool keyframe;
+	};
+
+	size_t budget_;
+	unsigned keyframe_interval_;
+
+	// Encoded entries, written back to back and wrapping to the start when
+	// the next one does not fit before the end
+	std::vector<uint8_t> arena_;
+	std::deque<Entry> entries_;
+	size_t head_ = 0; // End of the newest entry
+	size_t used_ = 0;
+	unsigned deltas_since_keyframe_ = 0;
+
+	// Layout of the snapshots stored (all alike, from one ROM load)
+	size_t state_size_ = 0;
+	std::array<uint32_t, StateSnapshot::SECTION_COUNT + 1> offsets_{};
+	uint32_t load_id_ = 0;
+
+	std::vector<uint8_t> keyframe_; // Decoded newest keyframe, the deltas' reference
+	std::vector<uint8_t> scratch_;	// Encoder output
+
+	void encode(const uint8_t *state, const uint8_t *reference);
+	bool store(bool keyframe);
+	bool make_room(size_t size, size_t &offset);
+	void evict_oldest();
+	void decode(const Entry &entry, uint8_t *out, const uint8_t *reference) const;
+};
+
+} // namespace nes
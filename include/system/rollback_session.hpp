@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "system/save_state.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace nes {
+
+class HeadlessSystem;
+class LatchedInputSource;
+
+/**
+ * RollbackSession - GGPO-style rollback for two-player sessions
+ *
+ * Each peer runs its own system and never waits for the other's input: a
+ * frame is emulated as soon as the local input for it is known, with the
+ * remote player's input predicted to be whatever they last confirmed. The
+ * transport is the caller's: send (get_frame(), buttons) for every
+ * advance_frame() to the peer and hand what arrives to add_remote_input(),
+ * in any order.
+ *
+ * When a remote input turns out to differ from the prediction used for its
+ * frame, the next advance_frame() restores the snapshot taken at the start
+ * of that frame and re-runs every frame since with the corrected inputs,
+ * composing no pixels and with audio gated, before running the new frame
+ * normally. Snapshots are taken every frame into a ring of reused
+ * StateSnapshots, so none of this allocates once the first round has been
+ * captured. Both peers end up in the same state for every frame whose inputs
+ * both have confirmed.
+ *
+ * A peer may run at most MAX_ROLLBACK_FRAMES past the remote input it has
+ * confirmed; advance_frame() refuses (the caller stalls a frame) beyond that.
+ */
+class RollbackSession {
+  public:
+	static constexpr int MAX_ROLLBACK_FRAMES = 8;
+
+	/**
+	 * @param input The system's input source (what its Controller reads)
+	 * @param local_player Controller port of the local player (0 or 1); the
+	 *                     peer plays the other one
+	 */
+	RollbackSession(HeadlessSystem &system, std::shared_ptr<LatchedInputSource> input, int local_player);
+
+	/**
+	 * Emulate the next frame with the local player's buttons, rolling back
+	 * first if remote input has contradicted a prediction
+	 * @return false (nothing emulated) when too far ahead of the peer
+	 */
+	bool advance_frame(Byte local_buttons);
+
+	/**
+	 * Remote player's buttons for a frame
+	 * @return false for a frame already confirmed or further ahead than the
+	 *         peer can be
+	 */
+	bool add_remote_input(std::uint64_t frame, Byte buttons);
+
+	[[nodiscard]] bool can_advance() const noexcept {
+		return frame_ < confirmed_ + MAX_ROLLBACK_FRAMES;
+	}
+	// Next frame advance_frame() emulates (the number to send its input with)
+	[[nodiscard]] std::uint64_t get_frame() const noexcept {
+		return frame_;
+	}
+	// Frames before this have confirmed remote input
+	[[nodiscard]] std::uint64_t get_confirmed_frame() const noexcept {
+		return confirmed_;
+	}
+
+	// Rollbacks so far and the frames they re-ran
+	[[nodiscard]] std::uint64_t get_rollback_count() const noexcept {
+		return rollbacks_;
+	}
+	[[nodiscard]] std::uint64_t get_resimulated_frames() const noexcept {
+		return resimulated_frames_;
+	}
+
+  private:
+	// Inputs are needed from MAX_ROLLBACK_FRAMES + 1 behind frame_ (the
+	// oldest frame a rollback can re-run) to MAX_ROLLBACK_FRAMES ahead of it
+	// (the furthest the peer can be ahead of us)
+	static constexpr std::size_t INPUT_WINDOW = 4 * MAX_ROLLBACK_FRAMES;
+	static constexpr std::uint64_t NO_FRAME = std::numeric_limits<std::uint64_t>::max();
+
+	struct FrameInput {
+		std::uint64_t frame = NO_FRAME; // Frame this slot holds
+		Byte local = 0;
+		Byte remote = 0;	  // Confirmed, or what arrived out of order
+		Byte remote_used = 0; // What the frame was last emulated with
+		bool confirmed = false;
+	};
+
+	HeadlessSystem &system_;
+	SaveStateManager states_;
+	std::shared_ptr<LatchedInputSource> input_;
+	int local_player_;
+
+	std::array<FrameInput, INPUT_WINDOW> inputs_{};
+	std::array<StateSnapshot, MAX_ROLLBACK_FRAMES + 1> snapshots_; // Start of frame % size
+	std::uint64_t frame_ = 0;
+	std::uint64_t confirmed_ = 0;
+	Byte last_confirmed_remote_ = 0; // Prediction for frames not confirmed yet
+	std::uint64_t rollback_to_ = NO_FRAME; // Earliest frame emulated with a wrong prediction
+	std::uint64_t rollbacks_ = 0;
+	std::uint64_t resimulated_frames_ = 0;
+
+	FrameInput &slot(std::uint64_t frame);
+	void run_frame(std::uint64_t frame);
+	void roll_back();
+};
+
+} // namespace nes
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "cartridge/mappers/mapper.hpp"
+#include "core/lz4_block.hpp"
+#include "system/async_file_writer.hpp"
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <filesystem>
+#include <future>
 #include <optional>
 #include <string>
 #include <vector>
@@ -16,8 +21,9 @@ class APU;
 class SystemBus;
 class Cartridge;
 
-// Save state file format version
-constexpr uint32_t SAVE_STATE_VERSION = 2;
+// Save state file format version (2: one raw blob after the header, still
+// loaded; 3: per-component chunks)
+constexpr uint32_t SAVE_STATE_VERSION = 3;
 constexpr char SAVE_STATE_MAGIC[8] = "VIBENES";
 
 // Save state header structure
@@ -33,19 +39,144 @@ struct SaveStateHeader {
 	bool is_valid() const;
 };
 
+/**
+ * Version 3 files follow the header with one chunk per component, in
+ * StateSnapshot::Section order:
+ *
+ *   [SaveStateChunk][stored_size bytes] ...
+ *
+ * A chunk is stored as an LZ4 block when that is smaller. Readers skip chunks
+ * with tags they do not know, so sections can be added without breaking
+ * older builds, and can restore a subset of sections. All fields
+ * little-endian.
+ */
+struct SaveStateChunk {
+	char tag[4];		  // "CPU ", "PPU ", "APU ", "BUS " (RAM, PRG/CHR RAM), "CART" (mapper)
+	uint32_t flags;		  // SAVE_CHUNK_LZ4
+	uint32_t size;		  // Bytes of component state
+	uint32_t stored_size; // Bytes that follow in the file
+};
+static_assert(sizeof(SaveStateChunk) == 16, "SaveStateChunk is an on-disk format");
+constexpr uint32_t SAVE_CHUNK_LZ4 = 0x01;
+// Largest component state a chunk may claim; the biggest real section (the
+// bus, with all the RAM an NES 2.0 header can declare) stays under 8 MB
+constexpr uint32_t SAVE_CHUNK_MAX_SIZE = 16u << 20;
+
+// Whether a chunk's sizes can belong to a real section. Readers check this
+// before allocating size bytes, so a damaged or hostile header cannot make
+// them reserve gigabytes.
+[[nodiscard]] constexpr bool save_chunk_size_plausible(uint32_t size, uint32_t stored_size, bool lz4) noexcept {
+	return size <= SAVE_CHUNK_MAX_SIZE && (lz4 ? size <= lz4_decompress_bound(stored_size) : size == stored_size);
+}
+
+// Save files (not in-memory states) start with a "THMB" chunk: the frame on
+// screen when saved, scaled down 4x, in the PPU frame buffer's pixel format.
+// It comes first so a slot menu can show it after reading a few hundred bytes.
+constexpr int SAVE_THUMBNAIL_WIDTH = 64;
+constexpr int SAVE_THUMBNAIL_HEIGHT = 60;
+
+// What a slot menu shows about a save file
+struct SaveSlotInfo {
+	bool exists = false;
+	std::optional<std::chrono::system_clock::time_point> timestamp; // When saved (unset if unreadable)
+	std::vector<uint32_t> thumbnail; // SAVE_THUMBNAIL_WIDTH x HEIGHT, empty if the file has none
+};
+
+/**
+ * StateSnapshot - Caller-owned buffer for in-memory snapshots
+ *
+ * For run-ahead, rewind and rollback, which snapshot every frame. The state
+ * of a given ROM always serializes to the same size, so once a snapshot has
+ * been captured for it (or reserved from SaveStateManager::snapshot_size())
+ * capturing into it and restoring from it never touch the heap. There is no
+ * header, CRC or timestamp: a snapshot restores only into the session and ROM
+ * that captured it. Each component's bytes start at a fixed offset.
+ */
+class StateSnapshot {
+  public:
+	enum class Section : uint8_t { Cpu, Ppu, Apu, Bus, Cartridge };
+	static constexpr size_t SECTION_COUNT = 5;
+
+	void reserve(size_t bytes) {
+		bytes_.reserve(bytes);
+	}
+	[[nodiscard]] bool empty() const noexcept {
+		return bytes_.empty();
+	}
+	[[nodiscard]] size_t size() const noexcept {
+		return bytes_.size();
+	}
+	[[nodiscard]] const uint8_t *data() const noexcept {
+		return bytes_.data();
+	}
+	[[nodiscard]] size_t section_offset(Section section) const noexcept {
+		return offsets_[static_cast<size_t>(section)];
+	}
+	[[nodiscard]] size_t section_size(Section section) const noexcept {
+		return offsets_[static_cast<size_t>(section) + 1] - offsets_[static_cast<size_t>(section)];
+	}
+
+  private:
+	friend class SaveStateManager;
+	friend class RewindBuffer;
+	std::vector<uint8_t> bytes_;
+	std::array<uint32_t, SECTION_COUNT + 1> offsets_{}; // Section starts, then the end
+	uint32_t load_id_ = 0;								// Cartridge::get_load_id() when captured
+	bool valid_ = false;
+	// Which cartridge RAM pages bytes_ is current for: capturing into a
+	// snapshot again, or restoring it, moves only the pages written since
+	Mapper::RamPageMark ram_mark_;
+};
+
 // Main save state manager class
 class SaveStateManager {
   public:
 	SaveStateManager(CPU6502 *cpu, PPU *ppu, APU *apu, SystemBus *bus, Cartridge *cartridge);
 	~SaveStateManager() = default;
 
-	// Save/load from file
+	// Save/load from file (saves go through a temp file, flushed and renamed
+	// into place)
 	bool save_to_file(const std::filesystem::path &path);
 	bool load_from_file(const std::filesystem::path &path);
 
+	// Serialize now and leave the file write to writer, so the caller only
+	// waits for the serialization; the future reports how the write went.
+	// Wait for writer before loading a state saved this way.
+	std::future<FileWriteResult> save_to_file_async(const std::filesystem::path &path, AsyncFileWriter &writer);
+	std::future<FileWriteResult> save_to_slot_async(int slot, AsyncFileWriter &writer);
+	std::future<FileWriteResult> quick_save_async(AsyncFileWriter &writer);
+
 	// Save/load to/from memory buffer
 	std::vector<uint8_t> serialize_state();
-	bool deserialize_state(const std::vector<uint8_t> &data);
+	// Same, into a caller-owned buffer (no allocation once it has the capacity)
+	void serialize_state(std::vector<uint8_t> &buffer);
+	/**
+	 * Restore a save state
+	 * @param sections Section bits (section_bit()) to restore; the others keep
+	 *                 their current state. Version 2 states only load whole.
+	 */
+	bool deserialize_state(const std::vector<uint8_t> &data, uint32_t sections = ALL_SECTIONS);
+
+	static constexpr uint32_t ALL_SECTIONS = (1u << StateSnapshot::SECTION_COUNT) - 1;
+	[[nodiscard]] static constexpr uint32_t section_bit(StateSnapshot::Section section) noexcept {
+		return 1u << static_cast<uint32_t>(section);
+	}
+
+	// LZ4-compress the chunks of save states (on by default)
+	void set_compression(bool enabled) noexcept {
+		compress_ = enabled;
+	}
+
+	// Fast in-memory snapshots (see StateSnapshot); restore() fails only for
+	// a snapshot of another ROM or an empty one
+	void capture(StateSnapshot &snapshot);
+	bool restore(const StateSnapshot &snapshot);
+	// Bytes a snapshot of the loaded ROM takes, for preallocating
+	[[nodiscard]] size_t snapshot_size();
+
+	// CRC32 of the loaded PRG ROM (0 if none): what save states and input
+	// movies are checked against
+	[[nodiscard]] uint32_t calculate_rom_crc32() const;
 
 	// Slot-based save/load (1-9)
 	bool save_to_slot(int slot);
@@ -54,6 +185,21 @@ class SaveStateManager {
 	bool slot_exists(int slot) const;
 	std::optional<std::chrono::system_clock::time_point> get_slot_timestamp(int slot) const;
 
+	/**
+	 * Slot 1-9, or QUICK_SAVE_SLOT for the quick save. Served from a cache
+	 * read from disk once per ROM and save directory and kept up to date by
+	 * this manager's own saves and loads, so menus can ask every frame. The
+	 * reference stays valid until the next save, load or refresh.
+	 */
+	[[nodiscard]] const SaveSlotInfo &get_slot_info(int slot) const;
+	static constexpr int QUICK_SAVE_SLOT = 0;
+	// Re-read the slot files, for changes made behind this manager's back
+	// (another instance, a file manager, a failed background write)
+	void refresh_slot_cache();
+
+	// Header and thumbnail of a save file, reading only the start of it
+	static SaveSlotInfo read_slot_info(const std::filesystem::path &path);
+
 	// Quick save/load
 	bool quick_save();
 	bool quick_load();
@@ -62,6 +208,9 @@ class SaveStateManager {
 	void set_save_directory(const std::filesystem::path &dir);
 	std::filesystem::path get_save_directory() const;
 
+	// Path of the quick-save file
+	std::filesystem::path get_quick_save_path() const;
+
 	// Get last error message
 	const std::string &get_last_error() const {
 		return last_error_;
@@ -79,8 +228,39 @@ class SaveStateManager {
 	std::filesystem::path save_directory_;
 	std::string last_error_;
 
+	// Computed once per loaded ROM (keyed by Cartridge::get_load_id())
+	size_t snapshot_size_ = 0;
+	uint32_t snapshot_size_load_id_ = 0;
+
+	bool compress_ = true;
+	// Reused so saving and loading stop allocating after the first time
+	std::vector<uint8_t> raw_state_; // Uncompressed sections, saving
+	std::vector<uint8_t> snapshot_head_; // capture(): every section but the cartridge RAM
+	std::array<std::vector<uint8_t>, StateSnapshot::SECTION_COUNT> loaded_sections_;
+
+	// Slot menu cache: index 0 is the quick save, 1-9 the slots
+	struct CachedSlot {
+		std::filesystem::path path;
+		SaveSlotInfo info;
+	};
+	mutable std::array<CachedSlot, 10> slot_cache_;
+	mutable bool slot_cache_valid_ = false;
+	mutable uint32_t slot_cache_load_id_ = 0;
+
 	// Helper methods
-	uint32_t calculate_rom_crc32() const;
+	[[nodiscard]] uint32_t current_load_id() const;
+	void serialize_file(std::vector<uint8_t> &buffer, bool with_thumbnail);
+	void append_thumbnail(std::vector<uint8_t> &buffer);
+	[[nodiscard]] std::filesystem::path resolve_slot_path(int slot) const;
+	void ensure_slot_cache() const;
+	// Record that path now holds data (a state file), if it is a cached slot
+	void update_slot_cache(const std::filesystem::path &path, const std::vector<uint8_t> *data);
+	// Without cartridge_ram the cartridge section skips the mapper's tracked
+	// RAM (capture() fills it in page-wise)
+	void serialize_components(std::vector<uint8_t> &buffer, uint32_t *offsets, bool cartridge_ram = true);
+	void deserialize_components(const std::vector<uint8_t> &buffer, size_t offset);
+	void deserialize_section(StateSnapshot::Section section, const std::vector<uint8_t> &buffer, size_t &offset);
+	bool deserialize_chunks(const std::vector<uint8_t> &data, uint32_t sections);
 	bool write_header(std::vector<uint8_t> &buffer, const SaveStateHeader &header);
 	bool read_header(const std::vector<uint8_t> &buffer, SaveStateHeader &header);
 
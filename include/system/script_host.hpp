@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nes {
+
+class HeadlessSystem;
+class LatchedInputSource;
+
+/**
+ * ScriptHost - Embedding API for bots and scripts driving a HeadlessSystem
+ *
+ * Scripts run between frames: run_frame() emulates one frame and then calls
+ * every on_frame() hook, which can read memory in bulk and set the buttons
+ * the next frame sees. Memory hooks (on_read()/on_write()) are Breakpoints
+ * hooks, so with none registered the bus pays nothing beyond its disabled
+ * watchpoint branch; they fire inside the access and may only look
+ * (peek()/read_memory()), never run frames or register hooks.
+ *
+ * A binding for an interpreter (Lua or otherwise) wraps these calls one to
+ * one; the host itself carries no interpreter.
+ */
+class ScriptHost {
+  public:
+	using FrameHook = std::function<void(ScriptHost &)>;
+	using MemoryHook = std::function<void(Address address, Byte value)>;
+
+	/**
+	 * @param input The system's input source (what its Controller reads);
+	 *              null leaves set_buttons() without effect
+	 */
+	ScriptHost(HeadlessSystem &system, std::shared_ptr<LatchedInputSource> input);
+	~ScriptHost();
+
+	ScriptHost(const ScriptHost &) = delete;
+	ScriptHost &operator=(const ScriptHost &) = delete;
+
+	/**
+	 * Emulate one frame, then call the frame hooks (not when a breakpoint
+	 * stopped the frame short)
+	 * @return CPU cycles executed
+	 */
+	std::uint64_t run_frame();
+
+	/// Called after every completed run_frame(); returns an id for remove()
+	int on_frame(FrameHook hook);
+	/**
+	 * Called on each CPU write (or read) in [first, last] whose optional
+	 * breakpoint condition holds
+	 * @return id for remove(), or 0 with a message in `error`
+	 */
+	int on_write(Address first, Address last, MemoryHook hook, std::string_view condition = {},
+				 std::string *error = nullptr);
+	int on_read(Address first, Address last, MemoryHook hook, std::string_view condition = {},
+				std::string *error = nullptr);
+	bool remove(int id);
+	// Unregister every hook this host added
+	void clear();
+
+	// Side-effect free reads of the CPU address space
+	[[nodiscard]] Byte peek(Address address) const;
+	void read_memory(Address first, std::span<Byte> out) const;
+
+	// Buttons (NESButton bit mask) the Controller reports from now on
+	void set_buttons(int player_index, Byte buttons);
+
+	[[nodiscard]] std::uint64_t get_frame_count() const;
+	[[nodiscard]] HeadlessSystem &system() noexcept {
+		return system_;
+	}
+
+  private:
+	struct FrameEntry {
+		int id;
+		FrameHook hook;
+	};
+
+	HeadlessSystem &system_;
+	std::shared_ptr<LatchedInputSource> input_;
+	std::vector<FrameEntry> frame_hooks_;
+	std::vector<int> memory_hooks_; // Breakpoints ids
+	int next_frame_id_ = -1;		// Frame hooks count down so ids never clash
+
+	int add_memory_hook(std::uint8_t kind, Address first, Address last, MemoryHook hook, std::string_view condition,
+						std::string *error);
+};
+
+} // namespace nes
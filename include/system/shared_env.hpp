@@ -0,0 +1,158 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace nes {
+
+class HeadlessSystem;
+class LatchedInputSource;
+
+/**
+ * SharedEnvRegion - The shared-memory block between an emulator and a trainer
+ *
+ * Laid out for readers in other languages (a Python trainer maps it with
+ * mmap and views it with numpy): fixed offsets, native byte order, no
+ * padding the offsets below do not show.
+ *
+ *   0     magic "VNSENV1\0"      16  request (u32, futex word)
+ *   8     version (u32)          20  done (u32, futex word)
+ *   12    size (u32)             24  command (u32, SharedEnvCommand)
+ *   28    frames (u32)           32  buttons[4] (u8, players 1-4)
+ *   36    status (u32)           40  frame_count (u64)
+ *   48    cpu_cycles (u64)       64  ram[2048]
+ *   2112  frame[256 * 240] (u16: NES color bits 0-5, emphasis bits 6-8)
+ *
+ * The trainer fills command, frames and buttons, then increments request
+ * and wakes it. The emulator carries the command out, publishes ram,
+ * frame_count, cpu_cycles and status, then sets done to that request value
+ * and wakes done. Nothing but the trainer writes the inputs, nothing but the
+ * emulator the outputs, and neither touches the other's half mid-step.
+ *
+ * Waking: a futex on Linux (FUTEX_WAIT/FUTEX_WAKE on request and done, not
+ * process-private); named auto-reset events "<name>.request" and
+ * "<name>.done" on Windows; elsewhere both sides poll.
+ */
+enum class SharedEnvCommand : std::uint32_t {
+	Step = 0,  // Hold buttons and run frames frames
+	Reset = 1, // Reset the console, then publish
+	Quit = 2,  // Stop serving
+};
+
+struct SharedEnvRegion {
+	static constexpr char MAGIC[8] = "VNSENV1";
+	static constexpr std::uint32_t VERSION = 1;
+	static constexpr int FRAME_WIDTH = 256;
+	static constexpr int FRAME_HEIGHT = 240;
+
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t size; // sizeof(SharedEnvRegion)
+	std::atomic<std::uint32_t> request;
+	std::atomic<std::uint32_t> done;
+	std::uint32_t command;
+	std::uint32_t frames;
+	std::uint8_t buttons[4];
+	std::uint32_t status; // 0 ok, 1 the command failed or was not known
+	std::uint64_t frame_count;
+	std::uint64_t cpu_cycles; // Run by the last step
+	std::uint8_t reserved[8];
+	std::uint8_t ram[RAM_SIZE];
+	std::uint16_t frame[FRAME_WIDTH * FRAME_HEIGHT];
+};
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "futex words must be plain 32-bit words");
+static_assert(std::is_standard_layout_v<SharedEnvRegion>, "SharedEnvRegion is a cross-process format");
+static_assert(offsetof(SharedEnvRegion, request) == 16 && offsetof(SharedEnvRegion, frames) == 28 &&
+				  offsetof(SharedEnvRegion, frame_count) == 40 && offsetof(SharedEnvRegion, ram) == 64 &&
+				  offsetof(SharedEnvRegion, frame) == 2112,
+			  "SharedEnvRegion offsets are documented above");
+
+class SharedMemory;
+
+/**
+ * SharedMemoryEnv - Serves one HeadlessSystem to a trainer through shared memory
+ *
+ * create() makes the named region (POSIX shm_open("/name"), Win32
+ * "Local\\name") and points the PPU's index buffer into it, so frames are
+ * rendered where the trainer reads them; work RAM (2 KB) is copied in after
+ * each command. serve() then waits for commands until Quit.
+ *
+ * The system must have been built with input (a LatchedInputSource) as its
+ * input source; steps set its buttons.
+ */
+class SharedMemoryEnv {
+  public:
+	SharedMemoryEnv(HeadlessSystem &system, std::shared_ptr<LatchedInputSource> input);
+	// Gives the PPU its own index buffer back and removes the region
+	~SharedMemoryEnv();
+	SharedMemoryEnv(const SharedMemoryEnv &) = delete;
+	SharedMemoryEnv &operator=(const SharedMemoryEnv &) = delete;
+
+	/// Create the region (replacing a stale one of that name) and publish the
+	/// current state; false if it cannot be created
+	bool create(const std::string &name);
+
+	enum class Served : std::uint8_t { Idle, Command, Quit };
+	/// Carry out the next command, waiting up to timeout for one
+	Served serve_one(std::chrono::milliseconds timeout);
+	/// Serve commands until Quit
+	void serve();
+
+	[[nodiscard]] SharedEnvRegion *region() noexcept {
+		return region_;
+	}
+
+  private:
+	HeadlessSystem &system_;
+	std::shared_ptr<LatchedInputSource> input_;
+	std::unique_ptr<SharedMemory> memory_;
+	SharedEnvRegion *region_ = nullptr;
+	std::uint32_t served_ = 0; // Last request carried out
+
+	void publish(std::uint64_t cpu_cycles, bool ok);
+};
+
+/**
+ * SharedMemoryEnvClient - The trainer's side, for C++ trainers and tests
+ *
+ * Each call writes the command, wakes the emulator and waits for it to
+ * finish; the observation is then in region().
+ */
+class SharedMemoryEnvClient {
+  public:
+	SharedMemoryEnvClient();
+	~SharedMemoryEnvClient();
+	SharedMemoryEnvClient(const SharedMemoryEnvClient &) = delete;
+	SharedMemoryEnvClient &operator=(const SharedMemoryEnvClient &) = delete;
+
+	/// Open a region a SharedMemoryEnv created; false if there is none
+	bool open(const std::string &name);
+
+	/// Run frames frames with buttons held; false if the emulator did not
+	/// answer within timeout or the step failed
+	bool step(std::uint32_t frames, const std::array<std::uint8_t, 4> &buttons,
+			  std::chrono::milliseconds timeout = std::chrono::seconds(10));
+	bool reset(std::chrono::milliseconds timeout = std::chrono::seconds(10));
+	/// Ask the emulator to stop serving (does not wait)
+	void quit();
+
+	[[nodiscard]] const SharedEnvRegion &region() const noexcept {
+		return *region_;
+	}
+
+  private:
+	std::unique_ptr<SharedMemory> memory_;
+	SharedEnvRegion *region_ = nullptr;
+
+	std::uint32_t send(SharedEnvCommand command);
+	bool wait_done(std::uint32_t request, std::chrono::milliseconds timeout);
+};
+
+} // namespace nes
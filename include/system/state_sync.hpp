@@ -0,0 +1,179 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+/**
+ * StateStore - Named blobs StateSync keeps a player's states in
+ *
+ * Keys are '/'-separated paths. put() replaces an object whole: a reader
+ * sees the old bytes or the new ones, never a mix. Implementations are
+ * called from StateSync's worker thread only.
+ */
+class StateStore {
+  public:
+	virtual ~StateStore() = default;
+	virtual bool put(const std::string &key, std::span<const std::uint8_t> bytes) = 0;
+	virtual std::optional<std::vector<std::uint8_t>> get(const std::string &key) = 0;
+	virtual bool remove(const std::string &key) = 0;
+};
+
+// A store in a directory, each key a file under it (written as
+// AsyncFileWriter::write_file() does): a share every cabinet mounts, or a
+// cabinet's own cache of what it last synced
+class DirectoryStateStore final : public StateStore {
+  public:
+	explicit DirectoryStateStore(std::filesystem::path root) : root_(std::move(root)) {
+	}
+	bool put(const std::string &key, std::span<const std::uint8_t> bytes) override;
+	std::optional<std::vector<std::uint8_t>> get(const std::string &key) override;
+	bool remove(const std::string &key) override;
+
+  private:
+	std::filesystem::path root_;
+};
+
+/**
+ * StateSync - Streams save states to a remote StateStore section by section
+ *
+ * A player's latest state for a ROM (key_for()) lives remotely as a base
+ * object, every section of one state LZ4-compressed, followed by deltas:
+ * each holds only the sections (SaveStateChunk tags) that changed since the
+ * state before it, XORed against that state, which leaves mostly zeros for
+ * LZ4 to remove. A small manifest names the base generation and the number
+ * of deltas, and is written last, so a reader never follows it to an object
+ * that is not there yet. After max_deltas() deltas, or once they add up to
+ * more than the base, the next upload starts a new generation with a fresh
+ * base and drops the old objects.
+ *
+ * upload() takes a state from SaveStateManager::serialize_state() and
+ * returns at once; the worker thread diffs it against the last state synced
+ * for that key and sends what changed. A newer upload for a key still
+ * waiting replaces it. prefetch() (a player logs in) fetches the latest
+ * state on the worker and take() hands it over, as a version 3 state file
+ * SaveStateManager::deserialize_state() loads; with a cache store, what was
+ * synced last is kept locally, so a cabinet that has seen the player's
+ * current base downloads only the deltas since.
+ *
+ * One cabinet writes a player's state at a time: two uploading the same key
+ * at once each start a new base, and the last manifest written wins.
+ */
+class StateSync {
+  public:
+	static constexpr unsigned DEFAULT_MAX_DELTAS = 32;
+
+	// Neither store is owned; both must outlive this object
+	explicit StateSync(StateStore &remote, StateStore *cache = nullptr);
+	// Finishes every queued upload and fetch first
+	~StateSync();
+	StateSync(const StateSync &) = delete;
+	StateSync &operator=(const StateSync &) = delete;
+
+	/// "<player>/<ROM CRC-32 as 8 hex digits>"
+	[[nodiscard]] static std::string key_for(const std::string &player, std::uint32_t rom_crc32);
+
+	/// Send state as key's latest; the future is false if it was not sent
+	std::future<bool> upload(std::string key, std::vector<std::uint8_t> state);
+	/// Start fetching key's latest state; a no-op if one is already on its way
+	void prefetch(const std::string &key);
+	/// key's latest state, waiting for its prefetch or fetching it now;
+	/// nullopt if there is none or it could not be fetched
+	[[nodiscard]] std::optional<std::vector<std::uint8_t>> take(const std::string &key);
+
+	/// Block until every queued upload and fetch is done
+	void wait_idle();
+
+	void set_max_deltas(unsigned deltas) noexcept {
+		max_deltas_ = deltas;
+	}
+	[[nodiscard]] unsigned max_deltas() const noexcept {
+		return max_deltas_;
+	}
+
+	// Traffic with the remote store so far
+	struct Stats {
+		std::uint64_t bytes_sent = 0;
+		std::uint64_t bytes_received = 0;
+		unsigned bases_sent = 0;
+		unsigned deltas_sent = 0;
+	};
+	[[nodiscard]] Stats stats() const;
+
+  private:
+	struct Section {
+		char tag[4];
+		std::vector<std::uint8_t> bytes;
+	};
+	// The last state synced for a key, as the remote store has it
+	struct Track {
+		std::uint32_t generation = 0;
+		std::uint32_t sequence = 0; // Deltas after the base
+		std::uint32_t base_bytes = 0;
+		std::uint32_t delta_bytes = 0;
+		std::vector<std::uint8_t> header; // SaveStateHeader of the newest state
+		std::vector<Section> sections;
+	};
+	struct Manifest {
+		std::uint32_t generation = 0;
+		std::uint32_t sequence = 0;
+		std::uint32_t base_bytes = 0;
+		std::uint32_t delta_bytes = 0;
+	};
+	using FetchResult = std::optional<std::vector<std::uint8_t>>;
+
+	struct Job {
+		std::string key;
+		bool fetch = false;
+		std::vector<std::uint8_t> state; // Of an upload
+		std::vector<std::promise<bool>> uploaded;
+		std::promise<FetchResult> fetched;
+	};
+
+	StateStore &remote_;
+	StateStore *cache_;
+	unsigned max_deltas_ = DEFAULT_MAX_DELTAS;
+
+	mutable std::mutex mutex_;
+	std::condition_variable work_ready_;
+	std::condition_variable idle_;
+	std::deque<Job> queue_;
+	std::map<std::string, std::shared_future<FetchResult>> prefetched_;
+	Stats stats_;
+	bool busy_ = false;
+	bool stopping_ = false;
+
+	std::map<std::string, Track> tracks_; // Worker thread only
+	std::thread worker_;
+
+	void run();
+	bool send(const std::string &key, const std::vector<std::uint8_t> &state);
+	FetchResult fetch(const std::string &key);
+
+	// Remote access, counted in stats_
+	std::optional<std::vector<std::uint8_t>> get_remote(const std::string &key);
+	bool put_remote(const std::string &key, const std::vector<std::uint8_t> &bytes);
+	std::optional<Manifest> read_manifest(const std::string &key);
+
+	[[nodiscard]] static bool split_state(const std::vector<std::uint8_t> &state, Track &track);
+	[[nodiscard]] static std::vector<std::uint8_t> join_state(const Track &track);
+	// A base (previous null) or a delta against previous
+	[[nodiscard]] static std::vector<std::uint8_t> encode(const Track &track, const Track *previous);
+	// Apply a base or delta object to track
+	[[nodiscard]] static bool decode(const std::vector<std::uint8_t> &object, Track &track);
+	[[nodiscard]] static bool same_layout(const Track &a, const Track &b);
+};
+
+} // namespace nes
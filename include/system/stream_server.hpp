@@ -0,0 +1,224 @@
+#pragma once
+
+#include "system/frame_delta.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nes {
+
+class HeadlessSystem;
+class LatchedInputSource;
+class UdpSocket;
+struct StreamAddress;
+
+/**
+ * StreamPacket - The datagrams between a StreamServer and its players
+ *
+ * UDP over IPv4, native (little-endian) byte order.
+ *
+ *   Hello (player to server), to join a session:
+ *     0  magic "VNSH"   4  session (u16)   6  reserved (u16)   8  reserved (u32)
+ *   Welcome (server to player), the reply while the session has no live
+ *   player other than this address:
+ *     0  magic "VNSW"   4  session (u16)   6  reserved (u16)   8  token (u32)
+ *   Frame (server to player), one FrameDeltaEncoder frame in pieces:
+ *     0  magic "VNSF"   4  session (u16)   6  piece (u8)   7  pieces (u8)
+ *     8  frame (u32)    12 the piece: MAX_PIECE bytes of the encoded frame,
+ *                          fewer in the last piece
+ *   Input (player to server), at least once per frame:
+ *     0  magic "VNSI"   4  session (u16)   6  reserved (u16)
+ *     8  token (u32), from the Welcome
+ *     12 sequence (u32, counts up per datagram)
+ *     16 acked (u32): newest frame decoded, FrameDeltaEncoder::NO_FRAME if none
+ *     20 buttons[4] (players 1-4, Controller bit order)
+ *
+ * The token is derived from the player's address, the session and a secret
+ * drawn when the server starts, so only that address ever sees it. Frames
+ * are sent only to an address whose input echoed it: a forged source
+ * address gets at most a Welcome, no larger than the Hello that asked.
+ *
+ * A frame whose pieces do not all arrive is dropped by the player; as it
+ * is never acknowledged, the frames after it are deltas against an older
+ * one (see FrameDeltaEncoder).
+ */
+struct StreamPacket {
+	static constexpr char FRAME_MAGIC[4] = {'V', 'N', 'S', 'F'};
+	static constexpr char INPUT_MAGIC[4] = {'V', 'N', 'S', 'I'};
+	static constexpr char HELLO_MAGIC[4] = {'V', 'N', 'S', 'H'};
+	static constexpr char WELCOME_MAGIC[4] = {'V', 'N', 'S', 'W'};
+	static constexpr std::size_t FRAME_HEADER = 12;
+	static constexpr std::size_t INPUT_SIZE = 24;
+	static constexpr std::size_t HELLO_SIZE = 12;
+	static constexpr std::size_t WELCOME_SIZE = 12;
+	/// Piece payload; keeps every datagram inside a 1280-byte IPv6-safe MTU
+	static constexpr std::size_t MAX_PIECE = 1200;
+};
+
+/**
+ * StreamServer - Serves headless sessions to remote players over UDP
+ *
+ * Each session is a HeadlessSystem the caller built with a
+ * LatchedInputSource. A player joins a session with a Hello and then sends
+ * input carrying the token of the Welcome; the session runs at its region's
+ * frame rate while input keeps coming (it pauses once the player has been
+ * silent for CLIENT_TIMEOUT, and only then can another address join). After
+ * every frame the PPU's index buffer is encoded as a tile delta against the
+ * newest frame the player acknowledged and sent back in pieces. Input
+ * datagrams set the buttons in the session's LatchedInputSource, whose
+ * single atomic word the Controller reads on the next strobe; stale ones
+ * (lower sequence) are dropped, as is input without the address's token.
+ * The token only proves the player receives at its address: there is no
+ * authentication, so serve on a trusted network.
+ *
+ * start() runs the sessions on worker threads (session i on worker
+ * i % threads), each emulating, encoding and sending its sessions' frames
+ * in deadline order; any worker reads input for any session. Encoding a
+ * frame takes tens of microseconds (a keyframe about a hundred), so the
+ * emulation itself is what limits the sessions one thread can hold.
+ *
+ * Sessions must be added before start(); their systems must outlive the
+ * server and are only touched by its workers until stop().
+ */
+class StreamServer {
+  public:
+	static constexpr std::chrono::seconds CLIENT_TIMEOUT{5};
+	/// A session this many frames behind drops them instead of running to catch up
+	static constexpr int MAX_FRAMES_BEHIND = 4;
+
+	/**
+	 * Whether a session whose next frame was due at deadline has fallen too
+	 * far behind now to run the missed frames back to back (the worker was
+	 * stalled): it then skips them and restarts its schedule from now
+	 */
+	[[nodiscard]] static bool too_far_behind(std::chrono::steady_clock::time_point deadline,
+											 std::chrono::steady_clock::time_point now,
+											 std::chrono::steady_clock::duration period) noexcept {
+		return deadline + MAX_FRAMES_BEHIND * period < now;
+	}
+
+	StreamServer();
+	// Stops the workers
+	~StreamServer();
+	StreamServer(const StreamServer &) = delete;
+	StreamServer &operator=(const StreamServer &) = delete;
+
+	/// Add a session (before start()); returns its number
+	int add_session(HeadlessSystem &system, std::shared_ptr<LatchedInputSource> input);
+
+	/**
+	 * Bind the UDP port (0 = any free one, see port()) and start serving on
+	 * threads workers (at least 1); false if the port cannot be bound
+	 */
+	bool start(std::uint16_t port, unsigned threads = 1);
+	void stop();
+	[[nodiscard]] bool is_running() const noexcept {
+		return !workers_.empty();
+	}
+	[[nodiscard]] std::uint16_t port() const noexcept {
+		return port_;
+	}
+
+	struct Stats {
+		std::uint64_t frames_sent = 0;
+		std::uint64_t keyframes_sent = 0;
+		std::uint64_t bytes_sent = 0; // Datagram payloads
+		std::uint64_t inputs_received = 0; // With a valid token
+		std::uint64_t frames_dropped = 0;  // Skipped by sessions too_far_behind()
+		std::uint64_t encode_ns = 0; // Total time in FrameDeltaEncoder::encode()
+	};
+	[[nodiscard]] Stats stats() const noexcept;
+
+  private:
+	struct Session;
+	struct Worker;
+
+	std::vector<std::unique_ptr<Session>> sessions_;
+	std::unique_ptr<UdpSocket> socket_;
+	std::vector<std::thread> workers_;
+	std::atomic<bool> running_{false};
+	std::uint16_t port_ = 0;
+	std::uint64_t secret_ = 0; // Keys the tokens, drawn by start()
+
+	std::atomic<std::uint64_t> frames_sent_{0};
+	std::atomic<std::uint64_t> keyframes_sent_{0};
+	std::atomic<std::uint64_t> bytes_sent_{0};
+	std::atomic<std::uint64_t> inputs_received_{0};
+	std::atomic<std::uint64_t> frames_dropped_{0};
+	std::atomic<std::uint64_t> encode_ns_{0};
+
+	void run(unsigned worker, unsigned threads);
+	void receive_datagram(const std::uint8_t *data, std::size_t size, const StreamAddress &from);
+	void receive_hello(Session &session, const StreamAddress &from);
+	void receive_input(Session &session, const std::uint8_t *data, const StreamAddress &from);
+	[[nodiscard]] std::uint32_t token_for(const StreamAddress &player, std::uint16_t session) const noexcept;
+	void serve_frame(Session &session, Worker &worker);
+};
+
+/**
+ * StreamClient - A player's side, for tools and tests
+ *
+ * Joins a session with connect(), sends input with send_input() and
+ * collects frames with receive(); the newest complete frame is in frame().
+ */
+class StreamClient {
+  public:
+	StreamClient();
+	~StreamClient();
+	StreamClient(const StreamClient &) = delete;
+	StreamClient &operator=(const StreamClient &) = delete;
+
+	/**
+	 * Join a server's session (IPv4 host name or address), sending Hellos
+	 * until it welcomes this player; false if the host cannot be resolved, no
+	 * socket can be made or no Welcome came within timeout (the session has
+	 * a live player, or there is no server)
+	 */
+	bool connect(const std::string &host, std::uint16_t port, std::uint16_t session,
+				 std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+	/// Send buttons for players 1-4 and acknowledge the newest frame
+	bool send_input(const std::array<std::uint8_t, 4> &buttons);
+
+	/// Read datagrams for up to timeout; true as soon as a new frame is decoded
+	bool receive(std::chrono::milliseconds timeout);
+
+	/// Newest decoded frame (256x240 index entries), null before the first
+	[[nodiscard]] const std::uint16_t *frame() const noexcept {
+		return decoder_.frame();
+	}
+	[[nodiscard]] std::uint32_t frame_number() const noexcept {
+		return decoder_.latest();
+	}
+	/// Frames that could not be decoded (a base not held or a malformed body)
+	[[nodiscard]] std::uint64_t frames_failed() const noexcept {
+		return frames_failed_;
+	}
+
+  private:
+	std::unique_ptr<UdpSocket> socket_;
+	std::unique_ptr<StreamAddress> server_;
+	std::uint16_t session_ = 0;
+	std::uint32_t token_ = 0;
+	std::uint32_t sequence_ = 0;
+	FrameDeltaDecoder decoder_;
+	std::uint64_t frames_failed_ = 0;
+
+	// The frame being put together from its pieces
+	std::uint32_t assembling_ = FrameDeltaEncoder::NO_FRAME;
+	unsigned pieces_ = 0;
+	unsigned pieces_seen_ = 0;
+	std::size_t body_size_ = 0;
+	std::vector<std::uint8_t> body_;
+	std::array<bool, 256> have_piece_{};
+
+	bool add_piece(const std::uint8_t *data, std::size_t size);
+};
+
+} // namespace nes
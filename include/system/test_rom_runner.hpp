@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace nes {
+
+class HeadlessSystem;
+
+/**
+ * TestRomRunner - Runs accuracy test ROMs headlessly and decides pass/fail
+ *
+ * Two ways a ROM can report:
+ *  - The blargg/kevtris $6000 protocol: once $6001-$6003 hold DE B0 61,
+ *    $6000 is the status ($80 running, $81 "press reset" after at least
+ *    100 ms, anything lower the final result, 0 = passed) and $6004 holds a
+ *    NUL-terminated message. The runner presses reset itself.
+ *  - A screen hash: a sidecar file next to the ROM (game.nes.hash) holding
+ *    "<frames> <frame_hash hex>", the frame_hash VibeNES_Headless prints
+ *    after that many frames. Used for ROMs that only draw their result.
+ *
+ * The protocol wins when a ROM speaks it. A ROM with no sidecar that has not
+ * written the signature within signature_frames gets NoVerdict rather than
+ * running to the timeout.
+ *
+ * run_suite() spreads the ROMs over a BatchRunner, one HeadlessSystem each.
+ */
+class TestRomRunner {
+  public:
+	enum class Verdict : std::uint8_t { Passed, Failed, TimedOut, NoVerdict, LoadError };
+
+	struct Options {
+		std::uint64_t timeout_frames = 60 * 60; // A minute of emulated time
+		std::uint64_t signature_frames = 120;
+		unsigned threads = 0; // run_suite(): 0 = one per hardware thread
+		// run(path): ignore sidecars and stop after this many frames, so the
+		// resulting frame_hash can be written as a new one
+		std::uint64_t record_frames = 0;
+	};
+
+	struct Expectation {
+		std::uint64_t frames = 0; // 0 = no screen hash to compare
+		std::uint64_t frame_hash = 0;
+	};
+
+	struct Result {
+		std::string rom;
+		Verdict verdict = Verdict::NoVerdict;
+		bool used_protocol = false;
+		int status = -1;	 // Final $6000 value (protocol only)
+		std::string message; // $6004 text, or what went wrong
+		std::uint64_t frames = 0;
+		std::uint64_t resets = 0;
+		std::uint64_t frame_hash = 0; // hash_frame_buffer() of the last frame
+	};
+
+	/// Run the ROM already loaded in system from its current state
+	[[nodiscard]] static Result run(HeadlessSystem &system, const Expectation &expected, const Options &options);
+	/// Load rom_path (and its sidecar, if any) into a fresh system and run it
+	[[nodiscard]] static Result run(const std::filesystem::path &rom_path, const Options &options);
+	/// Run every ROM in parallel; results come back in the order given
+	[[nodiscard]] static std::vector<Result> run_suite(const std::vector<std::filesystem::path> &roms,
+													  const Options &options);
+
+	/// Every .nes under each path (directories recursively), sorted
+	[[nodiscard]] static std::vector<std::filesystem::path>
+	find_roms(const std::vector<std::filesystem::path> &paths);
+
+	// The game.nes.hash sidecar of a ROM
+	[[nodiscard]] static std::filesystem::path sidecar_path(const std::filesystem::path &rom_path);
+	static bool read_expectation(const std::filesystem::path &rom_path, Expectation &expected);
+	static bool write_expectation(const std::filesystem::path &rom_path, const Expectation &expected);
+
+	[[nodiscard]] static const char *verdict_name(Verdict verdict) noexcept;
+};
+
+} // namespace nes
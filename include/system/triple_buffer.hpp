@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace nes {
+
+/**
+ * TripleBuffer - Lock-free latest-value handoff between two threads
+ *
+ * The writer fills write_buffer() and publish()es it; the reader update()s
+ * and then reads read_buffer().  Three slots mean neither side ever waits:
+ * the writer always has a private slot, the reader keeps its slot until it
+ * asks for a newer one, and the third ("middle") slot holds the most recent
+ * publication.  Publications the reader never picks up are overwritten, so
+ * the reader always sees the newest complete value and never a torn one.
+ *
+ * Single writer thread and single reader thread only.
+ */
+template <typename T>
+class TripleBuffer {
+  public:
+	/**
+	 * Writer: the slot to fill for the next publish()
+	 */
+	[[nodiscard]] T &write_buffer() noexcept {
+		return slots_[write_];
+	}
+
+	/**
+	 * Writer: hand the filled slot to the reader and take the stale one back
+	 */
+	void publish() noexcept {
+		write_ = middle_.exchange(static_cast<std::uint8_t>(write_ | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	/**
+	 * Reader: swap in the newest publication, if any
+	 * @return true if read_buffer() now refers to a value not seen before
+	 */
+	bool update() noexcept {
+		if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+			return false;
+		}
+		read_ = middle_.exchange(read_, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	/**
+	 * Reader: the value picked up by the last successful update()
+	 */
+	[[nodiscard]] const T &read_buffer() const noexcept {
+		return slots_[read_];
+	}
+
+  private:
+	static constexpr std::uint8_t INDEX_MASK = 0x03;
+	static constexpr std::uint8_t FRESH = 0x04; // middle slot holds an unread publication
+
+	std::array<T, 3> slots_{};
+	alignas(64) std::atomic<std::uint8_t> middle_{1};
+	alignas(64) std::uint8_t write_ = 0; // writer-owned
+	alignas(64) std::uint8_t read_ = 2;	 // reader-owned
+};
+
+} // namespace nes
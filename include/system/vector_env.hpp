@@ -0,0 +1,146 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace nes {
+
+class HeadlessSystem;
+class LatchedInputSource;
+class RomImage;
+
+/**
+ * VectorEnv - Many copies of one game stepped in lockstep on one thread
+ *
+ * For reinforcement learning at scale: K instances of the same ROM image,
+ * each with its own player 1 buttons, advanced together by step().
+ * Instances in the same state given the same buttons are the same
+ * computation, so they share one machine (a group) and it runs once for all
+ * of them. A group whose members are given different buttons splits: each
+ * further button set gets a machine of its own, cloned from the group's
+ * (NesSystem::clone_into(), microseconds against a frame's run). After a
+ * step, machines that ended in the same state (NesSystem::serialize_machine(),
+ * compared by hash and then byte for byte) merge back into one group. Menus,
+ * cutscenes and transitions ignore most input, so there a handful of machines
+ * carry every instance; play that reacts to the input diverges towards one
+ * machine per instance, each run by the ordinary CPU6502 core.
+ *
+ * After each step the state a trainer observes is published as structure of
+ * arrays: one array over instances per register, and one block of work RAM
+ * with instance i's 2 KB at ram(i). As for clone_into(), controller shift
+ * registers are not machine state (games strobe before reading).
+ */
+class VectorEnv {
+  public:
+	explicit VectorEnv(std::size_t instances);
+	~VectorEnv();
+	VectorEnv(const VectorEnv &) = delete;
+	VectorEnv &operator=(const VectorEnv &) = delete;
+
+	/// Load image and put every instance in its power-on state, as one group
+	bool load(std::shared_ptr<const RomImage> image);
+	/// Every instance back to the state load() left it in
+	void reset();
+
+	/**
+	 * Run frames frames on every instance, instance i holding buttons[i]
+	 * @return false if no ROM is loaded or buttons has not size() entries
+	 */
+	bool step(std::span<const Byte> buttons, unsigned frames = 1);
+
+	/// Off, groups only ever split: every instance keeps the machine it
+	/// diverged onto (to measure what merging saves)
+	void set_merging(bool enabled) noexcept {
+		merging_ = enabled;
+	}
+	/// See HeadlessSystem::set_frame_skip()
+	void set_frame_skip(std::uint32_t interval);
+
+	[[nodiscard]] std::size_t size() const noexcept {
+		return machine_of_.size();
+	}
+	/// Machines the instances currently run on
+	[[nodiscard]] std::size_t group_count() const noexcept {
+		return active_.size();
+	}
+
+	// Registers and frame counts after the last step, one entry per instance
+	[[nodiscard]] std::span<const Address> program_counter() const noexcept {
+		return program_counter_;
+	}
+	[[nodiscard]] std::span<const Byte> accumulator() const noexcept {
+		return accumulator_;
+	}
+	[[nodiscard]] std::span<const Byte> x_register() const noexcept {
+		return x_register_;
+	}
+	[[nodiscard]] std::span<const Byte> y_register() const noexcept {
+		return y_register_;
+	}
+	[[nodiscard]] std::span<const Byte> stack_pointer() const noexcept {
+		return stack_pointer_;
+	}
+	[[nodiscard]] std::span<const Byte> status_register() const noexcept {
+		return status_register_;
+	}
+	[[nodiscard]] std::span<const std::uint64_t> frame_count() const noexcept {
+		return frame_count_;
+	}
+	// Work RAM of every instance, size() * RAM_SIZE bytes
+	[[nodiscard]] std::span<const Byte> ram() const noexcept {
+		return ram_;
+	}
+	[[nodiscard]] std::span<const Byte> ram(std::size_t instance) const noexcept {
+		return std::span<const Byte>(ram_).subspan(instance * RAM_SIZE, RAM_SIZE);
+	}
+	/// Palette indices of instance's last frame (see PPU::get_index_buffer())
+	[[nodiscard]] const std::uint16_t *frame(std::size_t instance) const;
+
+	/// The machine instance runs on, shared with the rest of its group:
+	/// changing it changes every member
+	[[nodiscard]] HeadlessSystem &machine(std::size_t instance);
+
+	struct Stats {
+		std::uint64_t instance_frames = 0; // Frames the instances advanced
+		std::uint64_t machine_frames = 0;  // Frames actually emulated
+		std::uint64_t splits = 0;
+		std::uint64_t merges = 0;
+	};
+	[[nodiscard]] const Stats &stats() const noexcept {
+		return stats_;
+	}
+
+  private:
+	struct Machine;
+
+	std::shared_ptr<const RomImage> image_;
+	std::vector<std::unique_ptr<Machine>> machines_; // Created as groups split
+	std::vector<std::size_t> active_;				 // Machines with members, ascending
+	std::vector<std::size_t> free_;
+	std::vector<std::size_t> machine_of_; // Per instance
+	std::uint32_t frame_skip_ = 0;
+	bool merging_ = true;
+	Stats stats_;
+
+	std::vector<Address> program_counter_;
+	std::vector<Byte> accumulator_;
+	std::vector<Byte> x_register_;
+	std::vector<Byte> y_register_;
+	std::vector<Byte> stack_pointer_;
+	std::vector<Byte> status_register_;
+	std::vector<std::uint64_t> frame_count_;
+	std::vector<Byte> ram_;
+
+	// Every instance onto machine 0
+	void gather();
+	std::size_t acquire_machine();
+	void split(std::span<const Byte> buttons);
+	void merge();
+	void publish();
+};
+
+} // namespace nes
@@ -1,5 +1,6 @@
 #include "apu/apu.hpp"
 #include "core/bus.hpp"
+#include "core/trace_zones.hpp"
 #include "cpu/cpu_6502.hpp"
 #include <algorithm>
 #include <cstring>
@@ -24,20 +25,40 @@ const uint8_t APU::DUTY_TABLE[4][8] = {
 const uint8_t APU::TRIANGLE_SEQUENCE[32] = {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5,	4,	3,	2,	1,	0,
 											0,	1,	2,	3,	4,	5,	6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
 
-// Noise period table (NTSC)
-const uint16_t APU::NOISE_PERIOD_TABLE[16] = {4,   8,	16,	 32,  64,  96,	 128,  160,
-											  202, 254, 380, 508, 762, 1016, 2034, 4068};
+namespace {
 
-// DMC rate table (NTSC)
-const uint16_t APU::DMC_RATE_TABLE[16] = {428, 380, 340, 320, 286, 254, 226, 214, 190, 160, 142, 128, 106, 84, 72, 54};
+// Non-linear mixer (https://www.nesdev.org/wiki/APU_Mixer), tabulated at
+// compile time. Pulse: indexed by pulse1 + pulse2 (0-30). TND: the
+// standard single table indexed by 3 * triangle + 2 * noise + dmc (0-202),
+// within 5% (0.013 of full scale) of the three-input formula.
+constexpr std::array<float, 31> PULSE_MIX_TABLE = [] {
+	std::array<float, 31> table{};
+	for (std::size_t n = 1; n < table.size(); ++n) {
+		table[n] = 95.88f / ((8128.0f / static_cast<float>(n)) + 100.0f);
+	}
+	return table;
+}();
+
+constexpr std::array<float, 203> TND_MIX_TABLE = [] {
+	std::array<float, 203> table{};
+	for (std::size_t n = 1; n < table.size(); ++n) {
+		table[n] = 163.67f / ((24329.0f / static_cast<float>(n)) + 100.0f);
+	}
+	return table;
+}();
+
+} // namespace
 
 APU::APU()
 	: frame_counter_{}, pulse1_{}, pulse2_{}, triangle_{}, noise_{}, dmc_{}, frame_irq_flag_(false),
 	  dmc_irq_flag_(false), irq_line_asserted_(false), dmc_dma_pending_(false), dmc_dma_address_(0), cycle_count_(0),
-	  cpu_(nullptr), bus_(nullptr), audio_backend_(nullptr),
-	  sample_rate_converter_(static_cast<float>(CPU_CLOCK_NTSC), 44100.0f), audio_enabled_(false),
-	  rate_adjust_counter_(0), output_filter_{} {
-	output_filter_.initialize();
+	  cpu_(nullptr), bus_(nullptr), audio_output_(nullptr),
+	  sample_rate_converter_(static_cast<float>(CPU_CLOCK_NTSC), 44100.0f),
+	  sinc_resampler_(static_cast<float>(CPU_CLOCK_NTSC), 44100.0f), audio_enabled_(false),
+	  anti_alias_filter_{},
+	  blip_(static_cast<double>(CPU_CLOCK_NTSC), 44100.0, BLIP_FRAME_CYCLES), output_filter_{} {
+	anti_alias_filter_.initialize();
+	output_filter_.initialize(output_sample_rate_);
 }
 
 void APU::power_on() {
@@ -55,6 +76,7 @@ void APU::reset() {
 	triangle_ = {};
 	noise_ = {};
 	dmc_ = {};
+	dmc_.sample_buffer_empty = true;
 
 	// Initialize noise shift register
 	noise_.shift_register = 1;
@@ -68,10 +90,18 @@ void APU::reset() {
 	cycle_count_ = 0;
 
 	// Reset hardware output filter chain
+	anti_alias_filter_.reset();
 	output_filter_.reset();
 
-	// Reset rate control
-	rate_adjust_counter_ = 0;
+	// Drop pending output
+	output_frame_count_ = 0;
+	output_frame_start_ = 0;
+	resample_block_count_ = 0;
+
+	restart_band_limited_output();
+	parked_ = 0;
+	update_parking(cycle_count_);
+	restart_expansion();
 }
 
 void APU::tick(CpuCycle cycles) {
@@ -79,6 +109,11 @@ void APU::tick(CpuCycle cycles) {
 }
 
 void APU::step_cpu_cycles(int cycle_count) {
+	if (synthesis_mode_ == SynthesisMode::BandLimited) {
+		step_band_limited(cycle_count);
+		return;
+	}
+
 	for (int i = 0; i < cycle_count; i++) {
 		cycle_count_++;
 
@@ -90,63 +125,54 @@ void APU::step_cpu_cycles(int cycle_count) {
 
 		// Triangle timer runs at CPU rate (ultrasonic range)
 		// Output freq = CPU / (32 * (t + 1))
-		triangle_.clock_timer();
+		// Parked channels are skipped and fast-forwarded later
+		if (!(parked_ & PARKED_TRIANGLE)) {
+			triangle_.clock_timer();
+		}
 
 		// Pulse and noise timers run at APU rate (every other CPU cycle)
 		// Output freq = fCPU / (16 * (t + 1)) for pulse
 		// Clock on ODD cycles (1, 3, 5, 7, ...)
 		if ((cycle_count_ & 1) == 1) {
-			pulse1_.clock_timer();
-			pulse2_.clock_timer();
-			noise_.clock_timer();
+			if (!(parked_ & PARKED_PULSE1)) {
+				pulse1_.clock_timer();
+			}
+			if (!(parked_ & PARKED_PULSE2)) {
+				pulse2_.clock_timer();
+			}
+			if (!(parked_ & PARKED_NOISE)) {
+				noise_.clock_timer();
+			}
 		}
 
-		// DMC clocks at CPU rate when enabled
+		// DMC clocks at CPU rate when enabled. Its buffer only empties on a
+		// timer reload, so that is the only cycle it can request a fetch.
 		if (dmc_.enabled) {
+			const bool reload = dmc_.timer == 0;
 			dmc_.clock_timer();
+			if (reload) {
+				request_dmc_fetch();
+			}
 		}
 
-		// After clocking the DMC, check if it needs a new sample byte.
-		// If the sample buffer is empty and there are bytes remaining to
-		// read, request a DMA fetch.  The CPU will stall and deliver the
-		// byte via complete_dmc_dma() on a subsequent cycle.
-		if (dmc_.enabled && dmc_.sample_buffer_empty && dmc_.bytes_remaining > 0 && !dmc_dma_pending_) {
-			dmc_dma_pending_ = true;
-			dmc_dma_address_ = dmc_.current_address;
+		// Expansion chips only run when their output can step
+		if (cycle_count_ >= expansion_next_step_) [[unlikely]] {
+			catch_up_expansion(cycle_count_);
 		}
 
 		// Generate audio sample every CPU cycle
-		if (audio_enabled_ && audio_backend_) {
-			float sample = get_audio_sample();
-
-			// Apply NES hardware analog output filter chain:
-			// HP 90Hz (DC removal) → HP 440Hz (AC coupling) → LP 14kHz (smoothing)
-			// This runs at the full CPU rate before downsampling, matching
-			// real hardware and serving as an anti-aliasing pre-filter.
-			sample = output_filter_.apply(sample);
-
-			sample_rate_converter_.input_sample(sample);
-
-			if (sample_rate_converter_.has_output()) {
-				float output_sample = sample_rate_converter_.get_output();
-				audio_backend_->queue_sample(output_sample);
-
-				// Dynamic rate control: every RATE_ADJUST_INTERVAL output samples,
-				// check the audio buffer fill level and nudge the resampling ratio.
-				// If the buffer is below target, lower the ratio (produce more
-				// output samples). If above target, raise it (produce fewer).
-				// The ±0.5% clamp in set_rate_adjustment() keeps pitch shift
-				// well below the audible threshold (~8.6 cents).
-				if (++rate_adjust_counter_ >= RATE_ADJUST_INTERVAL) {
-					rate_adjust_counter_ = 0;
-					std::size_t fill = audio_backend_->get_buffer_size();
-					// Proportional control: error is normalized to [-1, +1]
-					float error = (static_cast<float>(fill) - static_cast<float>(RATE_ADJUST_TARGET)) /
-								  static_cast<float>(RATE_ADJUST_TARGET);
-					// Gain of 0.003: gentle adjustment, avoids oscillation
-					float adjustment = 1.0f + error * 0.003f;
-					sample_rate_converter_.set_rate_adjustment(adjustment);
-				}
+		if (producing_output()) {
+			// Only the 14 kHz low-pass runs at the CPU rate (anti-aliasing
+			// ahead of the decimator); the rest of the analog chain runs on
+			// the resampled output
+			resample_block_[resample_block_count_++] = anti_alias_filter_.lp_14k.apply(get_audio_sample());
+			if (resample_block_count_ == RESAMPLE_BLOCK_SIZE) {
+				flush_resample_block();
+			}
+			if (cycle_count_ - output_frame_start_ >= BLIP_FRAME_CYCLES) {
+				output_frame_start_ = cycle_count_;
+				flush_resample_block();
+				end_output_frame();
 			}
 		}
 
@@ -155,6 +181,590 @@ void APU::step_cpu_cycles(int cycle_count) {
 	}
 }
 
+namespace {
+
+// Advance a divider that counts down once per tick and reloads to period
+// after reaching zero.  Returns how many reloads happened.
+uint64_t advance_divider(uint16_t &timer, uint16_t period, uint64_t ticks) {
+	if (ticks <= timer) {
+		timer = static_cast<uint16_t>(timer - ticks);
+		return 0;
+	}
+	ticks -= static_cast<uint64_t>(timer) + 1;
+	const uint64_t span = static_cast<uint64_t>(period) + 1;
+	timer = static_cast<uint16_t>(period - ticks % span);
+	return 1 + ticks / span;
+}
+
+// Odd CPU cycles in [1, cycle]; pulse and noise timers clock on each of them
+constexpr uint64_t odd_cycles_through(uint64_t cycle) {
+	return (cycle + 1) >> 1;
+}
+
+} // namespace
+
+void APU::step_band_limited(int cycle_count) {
+	for (int i = 0; i < cycle_count; i++) {
+		cycle_count_++;
+
+		// Frame counter stays per-cycle (IRQ timing); it catches the
+		// channels up itself before clocking envelopes/length/sweep
+		if ((cycle_count_ & 1) == 1) {
+			clock_frame_counter();
+		}
+
+		// DMC stays per-cycle too (DMA timing). Its output only moves on a
+		// timer reload, so that is the only cycle it needs a sync point.
+		if (dmc_.enabled) {
+			if (dmc_.timer == 0) {
+				run_channels_until(cycle_count_ - 1);
+				dmc_.clock_timer();
+				record_amplitude(cycle_count_);
+				request_dmc_fetch();
+			} else {
+				dmc_.timer--;
+			}
+		}
+
+		// While gated the blip frame stays open; nothing is recorded into it
+		if (cycle_count_ - blip_frame_start_ >= BLIP_FRAME_CYCLES && !output_gated_) {
+			end_blip_frame();
+		}
+
+		update_irq_line();
+	}
+}
+
+void APU::request_dmc_fetch() noexcept {
+	// The CPU stalls and delivers the byte via complete_dmc_dma()
+	if (dmc_.enabled && dmc_.sample_buffer_empty && dmc_.bytes_remaining > 0 && !dmc_dma_pending_) {
+		dmc_dma_pending_ = true;
+		dmc_dma_address_ = dmc_.current_address;
+	}
+}
+
+uint32_t APU::cycles_until_dmc_fetch() const noexcept {
+	if (dmc_dma_pending_) {
+		return 0;
+	}
+	// A stopped sample fetches nothing more; its IRQ is raised by the last
+	// fetch itself (complete_dmc_dma), which the bus reschedules after
+	if (!dmc_.enabled || dmc_.bytes_remaining == 0) {
+		return NO_APU_EVENT;
+	}
+	if (dmc_.sample_buffer_empty) {
+		return 0;
+	}
+	// The full buffer empties on the reload that shifts out the last bit:
+	// the first reload is timer + 1 cycles away, the rest one period apart.
+	// bits_remaining is 0 only before the first output cycle after reset,
+	// where the counter wraps and takes 256 reloads.
+	const uint32_t reloads = static_cast<uint8_t>(dmc_.bits_remaining - 1) + 1u;
+	const uint32_t cycles = dmc_.timer + 1u + (reloads - 1) * (dmc_.timer_period + 1u);
+	return cycles - 1;
+}
+
+uint32_t APU::cycles_until_irq_or_dma() const noexcept {
+	const uint32_t dmc_cycles = cycles_until_dmc_fetch();
+	if (dmc_cycles == 0 || frame_counter_.reset_delay > 0) {
+		return 0;
+	}
+	// Only the last step of the 4-step sequence sets the frame IRQ flag
+	if (frame_counter_.mode != 0 || frame_counter_.irq_inhibit || frame_irq_flag_) {
+		return dmc_cycles;
+	}
+
+	const uint16_t target = frame_steps_4_[frame_counter_.step];
+	uint32_t clocks = frame_counter_.divider < target ? target - frame_counter_.divider : 1;
+	for (uint8_t step = frame_counter_.step + 1; step < 4; ++step) {
+		clocks += frame_steps_4_[step];
+	}
+	// The frame counter clocks on odd CPU cycles, so its k-th clock is at
+	// least 2k - 1 cycles away
+	return std::min(2 * clocks - 2, dmc_cycles);
+}
+
+void APU::run_channels_until(uint64_t cycle) {
+	// Nothing listens while audio is off, so every channel can take the
+	// arithmetic fast path; otherwise stop at each audible waveform step.
+	const bool audible = producing_output();
+
+	// Muting conditions only change at sync points, never inside this loop
+	const uint8_t pulse1_volume = pulse1_.constant_volume ? pulse1_.envelope_volume : pulse1_.envelope_decay_level;
+	const uint8_t pulse2_volume = pulse2_.constant_volume ? pulse2_.envelope_volume : pulse2_.envelope_decay_level;
+	const uint8_t noise_volume = noise_.constant_volume ? noise_.envelope_volume : noise_.envelope_decay_level;
+	const bool pulse1_live = audible && pulse1_.enabled && pulse1_.length_counter > 0 && pulse1_.timer_period >= 8 &&
+							 pulse1_.timer_period < 0x800 && pulse1_volume > 0;
+	const bool pulse2_live = audible && pulse2_.enabled && pulse2_.length_counter > 0 && pulse2_.timer_period >= 8 &&
+							 pulse2_.timer_period < 0x800 && pulse2_volume > 0;
+	const bool triangle_steps = triangle_.length_counter > 0 && triangle_.linear_counter > 0;
+	const bool triangle_live = audible && triangle_steps;
+	const bool noise_live = audible && noise_.enabled && noise_.length_counter > 0 && noise_volume > 0;
+	const bool expansion_live = audible && expansion_;
+
+	while (synth_cycle_ < cycle) {
+		const uint64_t from = synth_cycle_;
+
+		// Cycle of each live channel's next reload: pulse/noise need timer+1
+		// odd cycles, the triangle timer+1 cycles
+		const uint64_t first_odd = from + 1 + (from & 1);
+		uint64_t next = cycle;
+		if (pulse1_live) {
+			next = std::min(next, first_odd + 2 * static_cast<uint64_t>(pulse1_.timer));
+		}
+		if (pulse2_live) {
+			next = std::min(next, first_odd + 2 * static_cast<uint64_t>(pulse2_.timer));
+		}
+		if (noise_live) {
+			next = std::min(next, first_odd + 2 * static_cast<uint64_t>(noise_.timer));
+		}
+		if (triangle_live) {
+			next = std::min(next, from + 1 + static_cast<uint64_t>(triangle_.timer));
+		}
+		if (expansion_live) {
+			next = std::min(next, from + expansion_->cycles_until_step());
+		}
+		const uint64_t apu_ticks = odd_cycles_through(next) - odd_cycles_through(from);
+		const uint64_t pulse1_steps = advance_divider(pulse1_.timer, pulse1_.timer_period, apu_ticks);
+		pulse1_.duty_sequence_pos = static_cast<uint8_t>((pulse1_.duty_sequence_pos + pulse1_steps) & 7);
+		const uint64_t pulse2_steps = advance_divider(pulse2_.timer, pulse2_.timer_period, apu_ticks);
+		pulse2_.duty_sequence_pos = static_cast<uint8_t>((pulse2_.duty_sequence_pos + pulse2_steps) & 7);
+		for (uint64_t steps = advance_divider(noise_.timer, noise_.timer_period, apu_ticks); steps > 0; --steps) {
+			// Same LFSR step as NoiseChannel::clock_timer()
+			uint16_t feedback = noise_.shift_register & 1;
+			feedback ^= (noise_.shift_register >> (noise_.mode ? 6 : 1)) & 1;
+			noise_.shift_register = static_cast<uint16_t>((noise_.shift_register >> 1) | (feedback << 14));
+		}
+		const uint64_t triangle_reloads = advance_divider(triangle_.timer, triangle_.timer_period, next - from);
+		if (triangle_steps) {
+			triangle_.sequence_pos = static_cast<uint8_t>((triangle_.sequence_pos + triangle_reloads) & 31);
+		}
+		run_expansion(next - from);
+
+		synth_cycle_ = next;
+		record_amplitude(next);
+	}
+}
+
+void APU::run_expansion(uint64_t cycles) noexcept {
+	if (!expansion_) {
+		return;
+	}
+	while (cycles > 0) {
+		const uint32_t span = static_cast<uint32_t>(std::min<uint64_t>(cycles, 0xFFFFFFFFu));
+		expansion_->run(span);
+		cycles -= span;
+	}
+	expansion_level_ = expansion_->output() * expansion_->gain();
+}
+
+void APU::catch_up_expansion(uint64_t cycle) noexcept {
+	if (!expansion_) {
+		expansion_next_step_ = NO_EXPANSION_STEP;
+		return;
+	}
+	run_expansion(cycle - expansion_cycle_);
+	expansion_cycle_ = cycle;
+	expansion_next_step_ = cycle + expansion_->cycles_until_step();
+}
+
+void APU::restart_expansion() noexcept {
+	expansion_level_ = expansion_ ? expansion_->output() * expansion_->gain() : 0.0f;
+	expansion_cycle_ = cycle_count_;
+	// A state load restores the chip after the APU, so look again next cycle
+	// rather than trusting its step horizon now
+	expansion_next_step_ = expansion_ && synthesis_mode_ == SynthesisMode::PerCycle ? cycle_count_ : NO_EXPANSION_STEP;
+}
+
+void APU::set_expansion_audio(std::shared_ptr<ExpansionAudio> audio) {
+	// The outgoing chip's steps so far still belong in the output
+	sync_channels();
+	expansion_owner_ = std::move(audio);
+	expansion_ = expansion_owner_.get();
+	restart_expansion();
+	if (synthesis_mode_ == SynthesisMode::BandLimited) {
+		record_amplitude(cycle_count_);
+	}
+}
+
+void APU::set_expansion_gain(float gain) {
+	if (!expansion_) {
+		return;
+	}
+	sync_channels();
+	expansion_->set_gain(gain);
+	end_expansion_write();
+}
+
+void APU::begin_expansion_write() {
+	// Same bracketing as write() gives the 2A03 registers
+	sync_channels();
+}
+
+void APU::end_expansion_write() {
+	if (synthesis_mode_ == SynthesisMode::BandLimited) {
+		run_expansion(0); // Takes the new level
+		record_amplitude(cycle_count_);
+	} else {
+		catch_up_expansion(cycle_count_);
+	}
+}
+
+void APU::record_amplitude(uint64_t cycle) {
+	if (!producing_output()) {
+		return;
+	}
+	const float amplitude = get_audio_sample();
+	const auto time = static_cast<uint32_t>(cycle - blip_frame_start_);
+	if (amplitude != blip_last_amp_) {
+		blip_.add_delta(time, amplitude - blip_last_amp_);
+		blip_last_amp_ = amplitude;
+	}
+	if (stems_) {
+		record_stems(time);
+	}
+}
+
+void APU::record_stems(uint32_t time) {
+	// Each channel through the mixer tables with the others silent
+	const std::array<float, STEM_COUNT> levels = {
+		PULSE_MIX_TABLE[pulse1_.get_output()],
+		PULSE_MIX_TABLE[pulse2_.get_output()],
+		TND_MIX_TABLE[3 * triangle_.get_output()],
+		TND_MIX_TABLE[2 * noise_.get_output()],
+		TND_MIX_TABLE[dmc_.get_output()],
+	};
+	for (std::size_t i = 0; i < STEM_COUNT; ++i) {
+		if (levels[i] != stems_->last_levels[i]) {
+			stems_->blips[i].add_delta(time, levels[i] - stems_->last_levels[i]);
+			stems_->last_levels[i] = levels[i];
+		}
+	}
+}
+
+void APU::end_stem_frame(uint32_t clocks) {
+	std::array<float, 256> block;
+	for (std::size_t i = 0; i < STEM_COUNT; ++i) {
+		const auto track = static_cast<AudioRecorder::Track>(i + 1);
+		stems_->blips[i].end_frame(clocks);
+		while (std::size_t count = stems_->blips[i].read_samples(block)) {
+			for (std::size_t j = 0; j < count; ++j) {
+				block[j] = stems_->filters[i].apply(block[j]);
+			}
+			recorder_->write(track, {block.data(), count});
+		}
+	}
+}
+
+void APU::end_blip_frame() {
+	run_channels_until(cycle_count_);
+	const auto clocks = static_cast<uint32_t>(cycle_count_ - blip_frame_start_);
+	blip_frame_start_ = cycle_count_;
+
+	if (!producing_output()) {
+		blip_.clear();
+		blip_last_amp_ = 0.0f;
+		clear_stems();
+		return;
+	}
+
+	blip_.end_frame(clocks);
+	std::array<float, 256> block;
+	while (std::size_t count = blip_.read_samples(block)) {
+		for (std::size_t i = 0; i < count; ++i) {
+			push_output_sample(output_filter_.apply(block[i]));
+		}
+	}
+	if (stems_) {
+		end_stem_frame(clocks);
+	}
+	end_output_frame();
+}
+
+void APU::restart_band_limited_output() {
+	synth_cycle_ = cycle_count_;
+	blip_frame_start_ = cycle_count_;
+	blip_.clear();
+	blip_last_amp_ = 0.0f;
+	output_filter_.reset();
+	clear_stems();
+}
+
+void APU::clear_stems() {
+	if (!stems_) {
+		return;
+	}
+	for (std::size_t i = 0; i < STEM_COUNT; ++i) {
+		stems_->blips[i].clear();
+		stems_->filters[i].reset();
+		stems_->last_levels[i] = 0.0f;
+	}
+}
+
+void APU::set_blip_rates(double clock_rate) {
+	blip_.set_rates(clock_rate, output_sample_rate_);
+	if (stems_) {
+		for (BlipBuffer &blip : stems_->blips) {
+			blip.set_rates(clock_rate, output_sample_rate_);
+		}
+	}
+}
+
+void APU::set_recorder(AudioRecorder *recorder) {
+	// Steps so far go out (or not) under the old configuration
+	sync_channels();
+	recorder_ = recorder;
+	output_frame_count_ = 0;
+	if (recorder && recorder->records_stems()) {
+		if (!stems_) {
+			stems_ = std::make_unique<Stems>();
+		}
+		for (OutputFilter &filter : stems_->filters) {
+			filter.initialize(output_sample_rate_);
+		}
+	} else {
+		stems_.reset();
+	}
+	// Mix and stems restart together at the unadjusted rate so they line up
+	set_blip_rates(cpu_clock_hz_);
+	restart_band_limited_output();
+	update_parking(cycle_count_);
+}
+
+void APU::set_output_gated(bool gated) {
+	if (gated == output_gated_) {
+		return;
+	}
+	// Record every step up to here; the open blip frame then waits for the
+	// restore to bring the cycle count back to this point
+	sync_channels();
+	output_gated_ = gated;
+	if (gated) {
+		gated_at_cycle_ = cycle_count_;
+	} else if (cycle_count_ != gated_at_cycle_) {
+		// Ungated without restoring: the output just resumes from here
+		restart_band_limited_output();
+	}
+	update_parking(cycle_count_);
+}
+
+void APU::sync_channels() {
+	if (synthesis_mode_ == SynthesisMode::BandLimited) {
+		run_channels_until(cycle_count_);
+	} else {
+		catch_up_parked(cycle_count_);
+		if (expansion_) {
+			catch_up_expansion(cycle_count_);
+		}
+	}
+}
+
+void APU::set_synthesis_mode(SynthesisMode mode) {
+	if (mode == synthesis_mode_) {
+		return;
+	}
+	sync_channels();
+	synthesis_mode_ = mode;
+	parked_ = 0;
+	update_parking(cycle_count_);
+	restart_expansion();
+	restart_band_limited_output();
+}
+
+void APU::update_parking(uint64_t clocked_through) {
+	if (synthesis_mode_ != SynthesisMode::PerCycle) {
+		return;
+	}
+	// Same conditions as run_channels_until()'s live channels: outside them
+	// the channel's output is constant whatever its timer does
+	const bool audible = producing_output();
+	const uint8_t pulse1_volume = pulse1_.constant_volume ? pulse1_.envelope_volume : pulse1_.envelope_decay_level;
+	const uint8_t pulse2_volume = pulse2_.constant_volume ? pulse2_.envelope_volume : pulse2_.envelope_decay_level;
+	const uint8_t noise_volume = noise_.constant_volume ? noise_.envelope_volume : noise_.envelope_decay_level;
+	const bool live[4] = {
+		audible && pulse1_.enabled && pulse1_.length_counter > 0 && pulse1_.timer_period >= 8 &&
+			pulse1_.timer_period < 0x800 && pulse1_volume > 0,
+		audible && pulse2_.enabled && pulse2_.length_counter > 0 && pulse2_.timer_period >= 8 &&
+			pulse2_.timer_period < 0x800 && pulse2_volume > 0,
+		audible && triangle_.length_counter > 0 && triangle_.linear_counter > 0,
+		audible && noise_.enabled && noise_.length_counter > 0 && noise_volume > 0,
+	};
+
+	for (int i = 0; i < 4; ++i) {
+		const auto bit = static_cast<uint8_t>(1 << i);
+		if (!live[i] && !(parked_ & bit)) {
+			parked_ |= bit;
+			parked_at_[i] = clocked_through;
+		} else if (live[i] && (parked_ & bit)) {
+			parked_ &= static_cast<uint8_t>(~bit);
+			switch (i) {
+			case 0:
+				fast_forward(pulse1_, parked_at_[i], clocked_through);
+				break;
+			case 1:
+				fast_forward(pulse2_, parked_at_[i], clocked_through);
+				break;
+			case 2:
+				fast_forward(triangle_, parked_at_[i], clocked_through);
+				break;
+			default:
+				fast_forward(noise_, parked_at_[i], clocked_through);
+				break;
+			}
+		}
+	}
+}
+
+void APU::catch_up_parked(uint64_t clocked_through) {
+	// Bring parked timers up to date and keep them parked from there. Run
+	// before anything changes a parked channel's period or gating, so each
+	// fast-forward covers a stretch where those held still.
+	if (parked_ & PARKED_PULSE1) {
+		fast_forward(pulse1_, parked_at_[0], clocked_through);
+	}
+	if (parked_ & PARKED_PULSE2) {
+		fast_forward(pulse2_, parked_at_[1], clocked_through);
+	}
+	if (parked_ & PARKED_TRIANGLE) {
+		fast_forward(triangle_, parked_at_[2], clocked_through);
+	}
+	if (parked_ & PARKED_NOISE) {
+		fast_forward(noise_, parked_at_[3], clocked_through);
+	}
+	parked_at_.fill(clocked_through);
+}
+
+void APU::fast_forward(PulseChannel &pulse, uint64_t from, uint64_t to) noexcept {
+	// Pulse timers clock on odd CPU cycles
+	const uint64_t steps =
+		advance_divider(pulse.timer, pulse.timer_period, odd_cycles_through(to) - odd_cycles_through(from));
+	pulse.duty_sequence_pos = static_cast<uint8_t>((pulse.duty_sequence_pos + steps) & 7);
+}
+
+void APU::fast_forward(TriangleChannel &triangle, uint64_t from, uint64_t to) noexcept {
+	const uint64_t reloads = advance_divider(triangle.timer, triangle.timer_period, to - from);
+	if (triangle.length_counter > 0 && triangle.linear_counter > 0) {
+		triangle.sequence_pos = static_cast<uint8_t>((triangle.sequence_pos + reloads) & 31);
+	}
+}
+
+void APU::fast_forward(NoiseChannel &noise, uint64_t from, uint64_t to) noexcept {
+	uint64_t steps = advance_divider(noise.timer, noise.timer_period, odd_cycles_through(to) - odd_cycles_through(from));
+	// Every cycle of the 15-bit LFSR divides 32767 steps (93 in short mode),
+	// so a long park costs at most that many steps
+	steps %= noise.mode ? 93 : 32767;
+	for (; steps > 0; --steps) {
+		uint16_t feedback = noise.shift_register & 1;
+		feedback ^= (noise.shift_register >> (noise.mode ? 6 : 1)) & 1;
+		noise.shift_register = static_cast<uint16_t>((noise.shift_register >> 1) | (feedback << 14));
+	}
+}
+
+void APU::set_region(const RegionTiming &timing) {
+	frame_steps_4_ = timing.frame_steps_4;
+	frame_steps_5_ = timing.frame_steps_5;
+	noise_periods_ = &timing.noise_periods;
+	dmc_rates_ = &timing.dmc_rates;
+	cpu_clock_hz_ = static_cast<double>(timing.cpu_clock_hz());
+	anti_alias_filter_.initialize(static_cast<float>(cpu_clock_hz_));
+	set_output_sample_rate(output_sample_rate_);
+}
+
+void APU::set_output_sample_rate(float sample_rate) {
+	output_sample_rate_ = sample_rate;
+	sample_rate_converter_ = SampleRateConverter(static_cast<float>(cpu_clock_hz_), sample_rate);
+	sinc_resampler_ = SincResampler(static_cast<float>(cpu_clock_hz_), sample_rate);
+	resample_block_count_ = 0;
+	sync_channels();
+	set_blip_rates(cpu_clock_hz_);
+	output_filter_.initialize(sample_rate);
+	if (stems_) {
+		for (OutputFilter &filter : stems_->filters) {
+			filter.initialize(sample_rate);
+		}
+	}
+	restart_band_limited_output();
+}
+
+void APU::flush_resample_block() {
+	VIBENES_TRACE_ZONE("APU::flush_resample_block");
+	// Either resampler yields at most one output per input below 1:1
+	std::array<float, RESAMPLE_BLOCK_SIZE + 1> resampled;
+	const std::span<const float> block(resample_block_.data(), resample_block_count_);
+	resample_block_count_ = 0;
+	const std::size_t count = resampler_ == Resampler::WindowedSinc ? sinc_resampler_.process(block, resampled)
+																	: sample_rate_converter_.process(block, resampled);
+	for (std::size_t i = 0; i < count; ++i) {
+		push_output_sample(output_filter_.apply_shaping(resampled[i]));
+	}
+}
+
+void APU::set_resampler(Resampler resampler) {
+	if (resampler == resampler_) {
+		return;
+	}
+	// The new converter starts clean; the pending block (< 0.2 ms) is dropped
+	resampler_ = resampler;
+	resample_block_count_ = 0;
+	sample_rate_converter_.reset();
+	sinc_resampler_.reset();
+}
+
+void APU::push_output_sample(float sample) {
+	output_frame_[output_frame_count_++] = sample;
+	if (output_frame_count_ == OUTPUT_FRAME_CAPACITY) {
+		// Only reached when the output rate is far above 96 kHz
+		hand_off_output_frame();
+	}
+}
+
+void APU::hand_off_output_frame() {
+	const std::span<const float> frame(output_frame_.data(), output_frame_count_);
+	output_frame_count_ = 0;
+	if (audio_output_) {
+		audio_output_->queue_samples(frame);
+	}
+	if (recorder_) {
+		recorder_->write(AudioRecorder::Track::Mix, frame);
+	}
+}
+
+void APU::end_output_frame() {
+	VIBENES_TRACE_ZONE("APU::end_output_frame");
+	if (output_frame_count_ != 0) {
+		hand_off_output_frame();
+	}
+	// A recorder alone has no device clock to follow
+	if (audio_output_) {
+		adjust_output_rate();
+	}
+}
+
+void APU::adjust_output_rate() {
+	// Dynamic rate control, once per output frame: check the audio buffer
+	// fill level and nudge the resampling ratio. If the buffer is below
+	// target, lower the ratio (produce more output samples). If above
+	// target, raise it (produce fewer). The ±0.5% clamp keeps pitch shift
+	// well below the audible threshold (~8.6 cents).
+	float adjustment = 1.0f;
+	if (rate_control_) {
+		const std::size_t fill = audio_output_->get_buffer_size();
+		const auto target = static_cast<float>(std::max<std::size_t>(audio_output_->get_target_buffer_size(), 1));
+		// Proportional control: error is normalized to [-1, +1]
+		const float error = (static_cast<float>(fill) - target) / target;
+		// Gain of 0.003: gentle adjustment, avoids oscillation
+		adjustment = 1.0f + error * 0.003f;
+	}
+	if (synthesis_mode_ == SynthesisMode::PerCycle) {
+		sample_rate_converter_.set_rate_adjustment(adjustment);
+		sinc_resampler_.set_rate_adjustment(adjustment);
+	} else {
+		// Called between blip frames (from end_blip_frame)
+		adjustment = std::clamp(adjustment, 0.995f, 1.005f);
+		set_blip_rates(cpu_clock_hz_ * adjustment);
+	}
+}
+
 void APU::clock_frame_counter() {
 	// Handle reset delay
 	if (frame_counter_.reset_delay > 0) {
@@ -170,14 +780,22 @@ void APU::clock_frame_counter() {
 
 	uint16_t target_cycles;
 	if (frame_counter_.mode == 0) {
-		target_cycles = FrameCounter::STEP_CYCLES_4[frame_counter_.step];
+		target_cycles = frame_steps_4_[frame_counter_.step];
 	} else {
-		target_cycles = FrameCounter::STEP_CYCLES_5[frame_counter_.step];
+		target_cycles = frame_steps_5_[frame_counter_.step];
 	}
 
 	if (frame_counter_.divider >= target_cycles) {
 		frame_counter_.divider = 0;
 
+		// Envelope/length/sweep changes land before this cycle's timer clocks
+		const bool band_limited = synthesis_mode_ == SynthesisMode::BandLimited;
+		if (band_limited) {
+			run_channels_until(cycle_count_ - 1);
+		} else {
+			catch_up_parked(cycle_count_ - 1);
+		}
+
 		if (frame_counter_.mode == 0) { // 4-step mode
 			switch (frame_counter_.step) {
 			case 0:
@@ -217,6 +835,13 @@ void APU::clock_frame_counter() {
 			}
 			frame_counter_.step = (frame_counter_.step + 1) % 5;
 		}
+
+		if (band_limited) {
+			record_amplitude(cycle_count_);
+		} else {
+			// This cycle's timer clocks are still to come
+			update_parking(cycle_count_ - 1);
+		}
 	}
 }
 
@@ -256,6 +881,8 @@ void APU::update_irq_line() {
 
 // Register access implementation
 void APU::write(uint16_t address, uint8_t value) {
+	sync_channels();
+
 	switch (address) {
 	// Pulse 1
 	case 0x4000:
@@ -333,7 +960,7 @@ void APU::write(uint16_t address, uint8_t value) {
 		break;
 	case 0x400E:
 		noise_.mode = (value & 0x80) != 0;
-		noise_.timer_period = NOISE_PERIOD_TABLE[value & 0x0F];
+		noise_.timer_period = (*noise_periods_)[value & 0x0F];
 		break;
 	case 0x400F:
 		if (noise_.enabled) {
@@ -346,7 +973,7 @@ void APU::write(uint16_t address, uint8_t value) {
 	case 0x4010:
 		dmc_.irq_enabled = (value & 0x80) != 0;
 		dmc_.loop_flag = (value & 0x40) != 0;
-		dmc_.timer_period = DMC_RATE_TABLE[value & 0x0F];
+		dmc_.timer_period = (*dmc_rates_)[value & 0x0F];
 		break;
 	case 0x4011:
 		dmc_.output_level = value & 0x7F;
@@ -382,10 +1009,7 @@ void APU::write(uint16_t address, uint8_t value) {
 			dmc_.start_sample();
 			// Request DMA fetch for the first byte of the restarted sample.
 			// The CPU will fulfil this on a subsequent cycle.
-			if (dmc_.bytes_remaining > 0 && !dmc_dma_pending_) {
-				dmc_dma_pending_ = true;
-				dmc_dma_address_ = dmc_.current_address;
-			}
+			request_dmc_fetch();
 		}
 
 		// Clear DMC IRQ
@@ -412,6 +1036,12 @@ void APU::write(uint16_t address, uint8_t value) {
 		}
 		break;
 	}
+
+	if (synthesis_mode_ == SynthesisMode::BandLimited) {
+		record_amplitude(cycle_count_);
+	} else {
+		update_parking(cycle_count_);
+	}
 }
 
 uint8_t APU::read(uint16_t address) {
@@ -435,62 +1065,22 @@ uint8_t APU::read(uint16_t address) {
 }
 
 float APU::get_audio_sample() {
-	// Get raw output from each channel
-	uint8_t pulse1_out = pulse1_.get_output();
-	uint8_t pulse2_out = pulse2_.get_output();
-	uint8_t triangle_out = triangle_.get_output();
-	uint8_t noise_out = noise_.get_output();
-	uint8_t dmc_out = dmc_.get_output();
-
-	// Memoized mixing: channel outputs hold steady for many CPU cycles
-	// between waveform steps, so skip the divisions when unchanged.
-	// Identical float math when recomputed — bit-exact results.
-	if (pulse1_out == mix_last_p1_ && pulse2_out == mix_last_p2_ && triangle_out == mix_last_tri_ &&
-		noise_out == mix_last_noise_ && dmc_out == mix_last_dmc_) {
-		return mix_last_out_;
-	}
-
-	// NES APU uses non-linear mixing to prevent overflow
-	// Formula from NESDev wiki: https://www.nesdev.org/wiki/APU_Mixer
+	// NES APU uses non-linear mixing to prevent overflow; both halves are
+	// table lookups (see PULSE_MIX_TABLE / TND_MIX_TABLE)
 	//
 	// Output ranges:
 	//   Pulse 1/2: 0-15 (4-bit volume from envelope)
 	//   Triangle:  0-15 (4-bit from 32-step sequence, but 16 unique levels)
 	//   Noise:     0-15 (4-bit volume from envelope)
 	//   DMC:       0-127 (7-bit PCM sample)
-
-	// Pulse channel mixing
-	// pulse_out = 95.88 / ((8128 / (pulse1 + pulse2)) + 100)
-	float pulse_output = 0.0f;
-	float pulse_sum = static_cast<float>(pulse1_out + pulse2_out);
-	if (pulse_sum > 0.0f) {
-		pulse_output = 95.88f / ((8128.0f / pulse_sum) + 100.0f);
-	}
-
-	// TND channel mixing (Triangle + Noise + DMC)
-	// tnd_out = 159.79 / ((1 / (triangle/8227 + noise/12241 + dmc/22638)) + 100)
-	float tnd_output = 0.0f;
-	float tnd_sum = (static_cast<float>(triangle_out) / 8227.0f) + (static_cast<float>(noise_out) / 12241.0f) +
-					(static_cast<float>(dmc_out) / 22638.0f);
-	if (tnd_sum > 0.0f) {
-		tnd_output = 159.79f / ((1.0f / tnd_sum) + 100.0f);
-	}
-
-	// Combine both outputs
-	float mixed = pulse_output + tnd_output;
-
-	// Update memoization cache
-	mix_last_p1_ = pulse1_out;
-	mix_last_p2_ = pulse2_out;
-	mix_last_tri_ = triangle_out;
-	mix_last_noise_ = noise_out;
-	mix_last_dmc_ = dmc_out;
-	mix_last_out_ = mixed;
+	const float pulse_output = PULSE_MIX_TABLE[pulse1_.get_output() + pulse2_.get_output()];
+	const float tnd_output = TND_MIX_TABLE[3 * triangle_.get_output() + 2 * noise_.get_output() + dmc_.get_output()];
 
 	// NES DAC non-linear mixing naturally produces output in [0, ~1.0] range.
 	// The hardware filter chain (applied in tick()) removes DC bias and
 	// centers the signal around 0, so no additional scaling is needed here.
-	return mixed;
+	// Cartridge audio sums linearly on top, as it does on the expansion pin.
+	return pulse_output + tnd_output + expansion_level();
 }
 
 // Pulse Channel methods
@@ -791,9 +1381,10 @@ void APU::DMCChannel::clock_timer() {
 }
 
 void APU::DMCChannel::start_sample() {
+	// The buffer is left alone: a byte fetched just before a loop restart
+	// still plays, and a restart with a full buffer fetches nothing yet
 	current_address = sample_address;
 	bytes_remaining = sample_length;
-	sample_buffer_empty = true;
 }
 
 // Called by the CPU after it performs the DMA read on behalf of the DMC.
@@ -809,6 +1400,10 @@ void APU::complete_dmc_dma(uint8_t data) {
 		dmc_.current_address = 0x8000;
 	}
 
+	// A $4015 write may have stopped the sample while the fetch was in flight
+	if (dmc_.bytes_remaining == 0) {
+		return;
+	}
 	dmc_.bytes_remaining--;
 
 	// Handle loop or IRQ when sample completes
@@ -835,6 +1430,24 @@ uint8_t APU::DMCChannel::get_output() {
 // =============================================================================
 
 void APU::serialize_state(std::vector<uint8_t> &buffer) const {
+	// Parked channels are saved as if they had been clocked all along
+	PulseChannel pulse1 = pulse1_;
+	PulseChannel pulse2 = pulse2_;
+	TriangleChannel triangle = triangle_;
+	NoiseChannel noise = noise_;
+	if (parked_ & PARKED_PULSE1) {
+		fast_forward(pulse1, parked_at_[0], cycle_count_);
+	}
+	if (parked_ & PARKED_PULSE2) {
+		fast_forward(pulse2, parked_at_[1], cycle_count_);
+	}
+	if (parked_ & PARKED_TRIANGLE) {
+		fast_forward(triangle, parked_at_[2], cycle_count_);
+	}
+	if (parked_ & PARKED_NOISE) {
+		fast_forward(noise, parked_at_[3], cycle_count_);
+	}
+
 	// Frame counter
 	buffer.push_back(static_cast<uint8_t>(frame_counter_.divider & 0xFF));
 	buffer.push_back(static_cast<uint8_t>((frame_counter_.divider >> 8) & 0xFF));
@@ -844,83 +1457,83 @@ void APU::serialize_state(std::vector<uint8_t> &buffer) const {
 	buffer.push_back(frame_counter_.reset_delay);
 
 	// Pulse 1
-	buffer.push_back(static_cast<uint8_t>(pulse1_.timer & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((pulse1_.timer >> 8) & 0xFF));
-	buffer.push_back(static_cast<uint8_t>(pulse1_.timer_period & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((pulse1_.timer_period >> 8) & 0xFF));
-	buffer.push_back(pulse1_.timer_sequence_pos);
-	buffer.push_back(pulse1_.sequencer_trigger ? 1 : 0);
-	buffer.push_back(pulse1_.length_counter);
-	buffer.push_back(pulse1_.length_enabled ? 1 : 0);
-	buffer.push_back(pulse1_.envelope_volume);
-	buffer.push_back(pulse1_.envelope_divider);
-	buffer.push_back(pulse1_.envelope_decay_level);
-	buffer.push_back(pulse1_.envelope_start ? 1 : 0);
-	buffer.push_back(pulse1_.constant_volume ? 1 : 0);
-	buffer.push_back(pulse1_.sweep_enabled ? 1 : 0);
-	buffer.push_back(pulse1_.sweep_divider);
-	buffer.push_back(pulse1_.sweep_period);
-	buffer.push_back(pulse1_.sweep_negate ? 1 : 0);
-	buffer.push_back(pulse1_.sweep_shift);
-	buffer.push_back(pulse1_.sweep_reload ? 1 : 0);
-	buffer.push_back(pulse1_.duty);
-	buffer.push_back(pulse1_.duty_sequence_pos);
-	buffer.push_back(pulse1_.enabled ? 1 : 0);
+	buffer.push_back(static_cast<uint8_t>(pulse1.timer & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((pulse1.timer >> 8) & 0xFF));
+	buffer.push_back(static_cast<uint8_t>(pulse1.timer_period & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((pulse1.timer_period >> 8) & 0xFF));
+	buffer.push_back(pulse1.timer_sequence_pos);
+	buffer.push_back(pulse1.sequencer_trigger ? 1 : 0);
+	buffer.push_back(pulse1.length_counter);
+	buffer.push_back(pulse1.length_enabled ? 1 : 0);
+	buffer.push_back(pulse1.envelope_volume);
+	buffer.push_back(pulse1.envelope_divider);
+	buffer.push_back(pulse1.envelope_decay_level);
+	buffer.push_back(pulse1.envelope_start ? 1 : 0);
+	buffer.push_back(pulse1.constant_volume ? 1 : 0);
+	buffer.push_back(pulse1.sweep_enabled ? 1 : 0);
+	buffer.push_back(pulse1.sweep_divider);
+	buffer.push_back(pulse1.sweep_period);
+	buffer.push_back(pulse1.sweep_negate ? 1 : 0);
+	buffer.push_back(pulse1.sweep_shift);
+	buffer.push_back(pulse1.sweep_reload ? 1 : 0);
+	buffer.push_back(pulse1.duty);
+	buffer.push_back(pulse1.duty_sequence_pos);
+	buffer.push_back(pulse1.enabled ? 1 : 0);
 
 	// Pulse 2 (same structure)
-	buffer.push_back(static_cast<uint8_t>(pulse2_.timer & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((pulse2_.timer >> 8) & 0xFF));
-	buffer.push_back(static_cast<uint8_t>(pulse2_.timer_period & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((pulse2_.timer_period >> 8) & 0xFF));
-	buffer.push_back(pulse2_.timer_sequence_pos);
-	buffer.push_back(pulse2_.sequencer_trigger ? 1 : 0);
-	buffer.push_back(pulse2_.length_counter);
-	buffer.push_back(pulse2_.length_enabled ? 1 : 0);
-	buffer.push_back(pulse2_.envelope_volume);
-	buffer.push_back(pulse2_.envelope_divider);
-	buffer.push_back(pulse2_.envelope_decay_level);
-	buffer.push_back(pulse2_.envelope_start ? 1 : 0);
-	buffer.push_back(pulse2_.constant_volume ? 1 : 0);
-	buffer.push_back(pulse2_.sweep_enabled ? 1 : 0);
-	buffer.push_back(pulse2_.sweep_divider);
-	buffer.push_back(pulse2_.sweep_period);
-	buffer.push_back(pulse2_.sweep_negate ? 1 : 0);
-	buffer.push_back(pulse2_.sweep_shift);
-	buffer.push_back(pulse2_.sweep_reload ? 1 : 0);
-	buffer.push_back(pulse2_.duty);
-	buffer.push_back(pulse2_.duty_sequence_pos);
-	buffer.push_back(pulse2_.enabled ? 1 : 0);
+	buffer.push_back(static_cast<uint8_t>(pulse2.timer & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((pulse2.timer >> 8) & 0xFF));
+	buffer.push_back(static_cast<uint8_t>(pulse2.timer_period & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((pulse2.timer_period >> 8) & 0xFF));
+	buffer.push_back(pulse2.timer_sequence_pos);
+	buffer.push_back(pulse2.sequencer_trigger ? 1 : 0);
+	buffer.push_back(pulse2.length_counter);
+	buffer.push_back(pulse2.length_enabled ? 1 : 0);
+	buffer.push_back(pulse2.envelope_volume);
+	buffer.push_back(pulse2.envelope_divider);
+	buffer.push_back(pulse2.envelope_decay_level);
+	buffer.push_back(pulse2.envelope_start ? 1 : 0);
+	buffer.push_back(pulse2.constant_volume ? 1 : 0);
+	buffer.push_back(pulse2.sweep_enabled ? 1 : 0);
+	buffer.push_back(pulse2.sweep_divider);
+	buffer.push_back(pulse2.sweep_period);
+	buffer.push_back(pulse2.sweep_negate ? 1 : 0);
+	buffer.push_back(pulse2.sweep_shift);
+	buffer.push_back(pulse2.sweep_reload ? 1 : 0);
+	buffer.push_back(pulse2.duty);
+	buffer.push_back(pulse2.duty_sequence_pos);
+	buffer.push_back(pulse2.enabled ? 1 : 0);
 
 	// Triangle
-	buffer.push_back(static_cast<uint8_t>(triangle_.timer & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((triangle_.timer >> 8) & 0xFF));
-	buffer.push_back(static_cast<uint8_t>(triangle_.timer_period & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((triangle_.timer_period >> 8) & 0xFF));
-	buffer.push_back(triangle_.sequence_pos);
-	buffer.push_back(triangle_.length_counter);
-	buffer.push_back(triangle_.linear_counter);
-	buffer.push_back(triangle_.linear_counter_period);
-	buffer.push_back(triangle_.linear_counter_reload ? 1 : 0);
-	buffer.push_back(triangle_.control_flag ? 1 : 0);
-	buffer.push_back(triangle_.enabled ? 1 : 0);
+	buffer.push_back(static_cast<uint8_t>(triangle.timer & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((triangle.timer >> 8) & 0xFF));
+	buffer.push_back(static_cast<uint8_t>(triangle.timer_period & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((triangle.timer_period >> 8) & 0xFF));
+	buffer.push_back(triangle.sequence_pos);
+	buffer.push_back(triangle.length_counter);
+	buffer.push_back(triangle.linear_counter);
+	buffer.push_back(triangle.linear_counter_period);
+	buffer.push_back(triangle.linear_counter_reload ? 1 : 0);
+	buffer.push_back(triangle.control_flag ? 1 : 0);
+	buffer.push_back(triangle.enabled ? 1 : 0);
 
 	// Noise
-	buffer.push_back(static_cast<uint8_t>(noise_.timer & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((noise_.timer >> 8) & 0xFF));
-	buffer.push_back(static_cast<uint8_t>(noise_.timer_period & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((noise_.timer_period >> 8) & 0xFF));
-	buffer.push_back(noise_.sequencer_trigger ? 1 : 0);
-	buffer.push_back(noise_.length_counter);
-	buffer.push_back(noise_.length_enabled ? 1 : 0);
-	buffer.push_back(noise_.envelope_volume);
-	buffer.push_back(noise_.envelope_divider);
-	buffer.push_back(noise_.envelope_decay_level);
-	buffer.push_back(noise_.envelope_start ? 1 : 0);
-	buffer.push_back(noise_.constant_volume ? 1 : 0);
-	buffer.push_back(noise_.mode ? 1 : 0);
-	buffer.push_back(static_cast<uint8_t>(noise_.shift_register & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((noise_.shift_register >> 8) & 0xFF));
-	buffer.push_back(noise_.enabled ? 1 : 0);
+	buffer.push_back(static_cast<uint8_t>(noise.timer & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((noise.timer >> 8) & 0xFF));
+	buffer.push_back(static_cast<uint8_t>(noise.timer_period & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((noise.timer_period >> 8) & 0xFF));
+	buffer.push_back(noise.sequencer_trigger ? 1 : 0);
+	buffer.push_back(noise.length_counter);
+	buffer.push_back(noise.length_enabled ? 1 : 0);
+	buffer.push_back(noise.envelope_volume);
+	buffer.push_back(noise.envelope_divider);
+	buffer.push_back(noise.envelope_decay_level);
+	buffer.push_back(noise.envelope_start ? 1 : 0);
+	buffer.push_back(noise.constant_volume ? 1 : 0);
+	buffer.push_back(noise.mode ? 1 : 0);
+	buffer.push_back(static_cast<uint8_t>(noise.shift_register & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((noise.shift_register >> 8) & 0xFF));
+	buffer.push_back(noise.enabled ? 1 : 0);
 
 	// DMC
 	buffer.push_back(static_cast<uint8_t>(dmc_.timer & 0xFF));
@@ -1081,12 +1694,24 @@ void APU::deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset)
 	dmc_dma_pending_ = buffer[offset++] != 0;
 	dmc_dma_address_ = buffer[offset++];
 	dmc_dma_address_ |= static_cast<uint16_t>(buffer[offset++]) << 8;
+	request_dmc_fetch(); // States saved before the request moved to timer reloads
 
 	// Cycle counter (64-bit)
 	cycle_count_ = 0;
 	for (int i = 0; i < 8; ++i) {
 		cycle_count_ |= static_cast<uint64_t>(buffer[offset++]) << (i * 8);
 	}
+
+	// Lazily advanced channels were serialized fully caught up. A run-ahead
+	// restore (output gated) keeps the audio path where it was instead.
+	if (output_gated_) {
+		synth_cycle_ = cycle_count_;
+	} else {
+		restart_band_limited_output();
+	}
+	parked_ = 0;
+	update_parking(cycle_count_);
+	restart_expansion();
 }
 
 } // namespace nes
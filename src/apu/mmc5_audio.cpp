@@ -0,0 +1,221 @@
+#include "apu/mmc5_audio.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nes {
+
+namespace {
+
+// The 2A03's length and duty tables, which the MMC5 pulses share
+constexpr std::array<Byte, 32> LENGTH_TABLE = {10, 254, 20, 2,  40, 4,  80, 6,  160, 8,  60, 10, 14, 12, 26, 14,
+											   12, 16,  24, 18, 48, 20, 96, 22, 192, 24, 72, 26, 16, 28, 32, 30};
+constexpr Byte DUTY_TABLE[4][8] = {
+	{0, 1, 0, 0, 0, 0, 0, 0},
+	{0, 1, 1, 0, 0, 0, 0, 0},
+	{0, 1, 1, 1, 1, 0, 0, 0},
+	{1, 0, 0, 1, 1, 1, 1, 1},
+};
+
+// Raw PCM at full scale is about as loud as the DMC at full scale
+constexpr float PCM_SCALE = 0.0013f;
+
+} // namespace
+
+Byte Mmc5Audio::Pulse::level() const noexcept {
+	if (!enabled || length_counter == 0 || DUTY_TABLE[duty][sequence_pos] == 0) {
+		return 0;
+	}
+	return constant_volume ? volume : envelope_decay;
+}
+
+void Mmc5Audio::Pulse::clock_envelope() noexcept {
+	if (envelope_start) {
+		envelope_start = false;
+		envelope_decay = 15;
+		envelope_divider = volume;
+	} else if (envelope_divider == 0) {
+		envelope_divider = volume;
+		if (envelope_decay > 0) {
+			envelope_decay--;
+		} else if (length_halt) {
+			envelope_decay = 15;
+		}
+	} else {
+		envelope_divider--;
+	}
+}
+
+Mmc5Audio::Mmc5Audio() {
+	reset();
+}
+
+void Mmc5Audio::reset() noexcept {
+	pulses_ = {};
+	for (Pulse &pulse : pulses_) {
+		pulse.timer.period = 2;
+		pulse.timer.left = 2;
+	}
+	frame_timer_.period = FRAME_CYCLES;
+	frame_timer_.left = FRAME_CYCLES;
+	pcm_level_ = 0;
+	pcm_read_mode_ = false;
+}
+
+void Mmc5Audio::write(Address address, Byte value) {
+	if (address <= 0x5007) {
+		Pulse &pulse = pulses_[(address >> 2) & 1];
+		switch (address & 0x03) {
+		case 0:
+			pulse.duty = (value >> 6) & 0x03;
+			pulse.length_halt = (value & 0x20) != 0;
+			pulse.constant_volume = (value & 0x10) != 0;
+			pulse.volume = value & 0x0F;
+			break;
+		case 2:
+			pulse.period = static_cast<std::uint16_t>((pulse.period & 0x0700) | value);
+			break;
+		case 3:
+			pulse.period = static_cast<std::uint16_t>((pulse.period & 0x00FF) | ((value & 0x07) << 8));
+			if (pulse.enabled) {
+				pulse.length_counter = LENGTH_TABLE[value >> 3];
+			}
+			pulse.envelope_start = true;
+			pulse.sequence_pos = 0;
+			break;
+		default:
+			break; // No sweep unit
+		}
+		pulse.timer.period = 2u * (pulse.period + 1u);
+		return;
+	}
+	switch (address) {
+	case 0x5010:
+		pcm_read_mode_ = (value & 0x01) != 0;
+		break;
+	case 0x5011:
+		if (!pcm_read_mode_ && value != 0) {
+			pcm_level_ = value;
+		}
+		break;
+	case 0x5015:
+		for (int i = 0; i < 2; ++i) {
+			pulses_[i].enabled = (value & (1 << i)) != 0;
+			if (!pulses_[i].enabled) {
+				pulses_[i].length_counter = 0;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+Byte Mmc5Audio::read_status() const noexcept {
+	return static_cast<Byte>((pulses_[0].length_counter > 0 ? 0x01 : 0) | (pulses_[1].length_counter > 0 ? 0x02 : 0));
+}
+
+void Mmc5Audio::clock_frame() noexcept {
+	for (Pulse &pulse : pulses_) {
+		pulse.clock_envelope();
+		if (!pulse.length_halt && pulse.length_counter > 0) {
+			pulse.length_counter--;
+		}
+	}
+}
+
+void Mmc5Audio::run(std::uint32_t cycles) noexcept {
+	while (cycles > 0) {
+		// Up to and including the next 240 Hz clock, if it falls in the span
+		const std::uint32_t span = std::min(cycles, frame_timer_.left);
+		for (Pulse &pulse : pulses_) {
+			const std::uint64_t steps = pulse.timer.run(span);
+			pulse.sequence_pos = static_cast<Byte>((pulse.sequence_pos + steps) & 7);
+		}
+		if (frame_timer_.run(span) > 0) {
+			clock_frame();
+		}
+		cycles -= span;
+	}
+}
+
+std::uint32_t Mmc5Audio::cycles_until_step() const noexcept {
+	std::uint32_t cycles = frame_timer_.left;
+	for (const Pulse &pulse : pulses_) {
+		if (pulse.enabled && pulse.length_counter > 0) {
+			cycles = std::min(cycles, pulse.timer.left);
+		}
+	}
+	return cycles;
+}
+
+float Mmc5Audio::output() const noexcept {
+	// Same non-linear curve as the 2A03 pulse pair
+	float level = 0.0f;
+	const float pulse_sum = static_cast<float>(pulses_[0].level() + pulses_[1].level());
+	if (pulse_sum > 0.0f) {
+		level = 95.88f / ((8128.0f / pulse_sum) + 100.0f);
+	}
+	return level + static_cast<float>(pcm_level_) * PCM_SCALE;
+}
+
+void Mmc5Audio::serialize_state(std::vector<std::uint8_t> &buffer) const {
+	const auto put_u32 = [&buffer](std::uint32_t value) {
+		for (int shift = 0; shift < 32; shift += 8) {
+			buffer.push_back(static_cast<std::uint8_t>(value >> shift));
+		}
+	};
+	for (const Pulse &pulse : pulses_) {
+		put_u32(pulse.timer.left);
+		buffer.push_back(static_cast<std::uint8_t>(pulse.period & 0xFF));
+		buffer.push_back(static_cast<std::uint8_t>(pulse.period >> 8));
+		buffer.push_back(pulse.duty);
+		buffer.push_back(pulse.sequence_pos);
+		buffer.push_back(pulse.length_counter);
+		buffer.push_back(pulse.length_halt ? 1 : 0);
+		buffer.push_back(pulse.constant_volume ? 1 : 0);
+		buffer.push_back(pulse.volume);
+		buffer.push_back(pulse.envelope_start ? 1 : 0);
+		buffer.push_back(pulse.envelope_divider);
+		buffer.push_back(pulse.envelope_decay);
+		buffer.push_back(pulse.enabled ? 1 : 0);
+	}
+	put_u32(frame_timer_.left);
+	buffer.push_back(pcm_level_);
+	buffer.push_back(pcm_read_mode_ ? 1 : 0);
+}
+
+void Mmc5Audio::deserialize_state(const std::vector<std::uint8_t> &buffer, std::size_t &offset) {
+	// 2 pulses x 16 bytes + frame timer + PCM level and mode
+	constexpr std::size_t STATE_SIZE = 2 * 16 + 4 + 2;
+	if (offset + STATE_SIZE > buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (MMC5 audio)");
+	}
+	const auto get_u32 = [&]() {
+		std::uint32_t value = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			value |= static_cast<std::uint32_t>(buffer[offset++]) << shift;
+		}
+		return value;
+	};
+	for (Pulse &pulse : pulses_) {
+		pulse.timer.left = std::max<std::uint32_t>(get_u32(), 1);
+		pulse.period = static_cast<std::uint16_t>((buffer[offset] | (buffer[offset + 1] << 8)) & 0x07FF);
+		offset += 2;
+		pulse.timer.period = 2u * (pulse.period + 1u);
+		pulse.duty = buffer[offset++] & 0x03;
+		pulse.sequence_pos = buffer[offset++] & 0x07;
+		pulse.length_counter = buffer[offset++];
+		pulse.length_halt = buffer[offset++] != 0;
+		pulse.constant_volume = buffer[offset++] != 0;
+		pulse.volume = buffer[offset++] & 0x0F;
+		pulse.envelope_start = buffer[offset++] != 0;
+		pulse.envelope_divider = buffer[offset++];
+		pulse.envelope_decay = buffer[offset++] & 0x0F;
+		pulse.enabled = buffer[offset++] != 0;
+	}
+	frame_timer_.left = std::clamp<std::uint32_t>(get_u32(), 1, FRAME_CYCLES);
+	pcm_level_ = buffer[offset++];
+	pcm_read_mode_ = buffer[offset++] != 0;
+}
+
+} // namespace nes
@@ -0,0 +1,210 @@
+#include "apu/sunsoft_5b_audio.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace nes {
+
+namespace {
+
+// Channel level per 4-bit volume: 3 dB per step, full volume about one
+// 2A03 pulse channel at full volume
+const std::array<float, 16> VOLUME_LEVELS = [] {
+	std::array<float, 16> levels{};
+	for (int volume = 1; volume < 16; ++volume) {
+		levels[volume] = 0.15f * std::pow(10.0f, static_cast<float>(volume - 15) * 3.0f / 20.0f);
+	}
+	return levels;
+}();
+
+constexpr std::uint32_t NOISE_LFSR_PERIOD = (1u << 17) - 1;
+
+} // namespace
+
+Sunsoft5bAudio::Sunsoft5bAudio() {
+	reset();
+}
+
+void Sunsoft5bAudio::reset() noexcept {
+	registers_.fill(0);
+	selected_ = 0;
+	tone_high_.fill(false);
+	noise_lfsr_ = 1;
+	update_periods();
+	for (StepTimer &timer : tone_timers_) {
+		timer.left = timer.period;
+	}
+	noise_timer_.left = noise_timer_.period;
+	restart_envelope();
+}
+
+void Sunsoft5bAudio::update_periods() noexcept {
+	for (int channel = 0; channel < 3; ++channel) {
+		const unsigned period = registers_[channel * 2] | ((registers_[channel * 2 + 1] & 0x0F) << 8);
+		tone_timers_[channel].period = 16u * std::max(period, 1u);
+	}
+	noise_timer_.period = 32u * std::max<unsigned>(registers_[6] & 0x1F, 1u);
+	const unsigned envelope = registers_[11] | (registers_[12] << 8);
+	envelope_timer_.period = 16u * std::max(envelope, 1u);
+}
+
+void Sunsoft5bAudio::restart_envelope() noexcept {
+	envelope_step_ = 0;
+	envelope_attack_ = (registers_[13] & 0x04) != 0;
+	envelope_holding_ = false;
+	envelope_timer_.left = envelope_timer_.period;
+}
+
+void Sunsoft5bAudio::write(Byte value) {
+	registers_[selected_] = value;
+	update_periods();
+	if (selected_ == 13) {
+		restart_envelope();
+	}
+}
+
+void Sunsoft5bAudio::step_envelope() noexcept {
+	if (envelope_holding_) {
+		return;
+	}
+	if (envelope_step_ < 15) {
+		++envelope_step_;
+		return;
+	}
+	const Byte shape = registers_[13];
+	if ((shape & 0x08) == 0) {
+		// One ramp, then silence
+		envelope_holding_ = true;
+		envelope_attack_ = false;
+	} else if (shape & 0x01) {
+		// Hold at the end of the ramp, or at the other end when alternating
+		envelope_holding_ = true;
+		if (shape & 0x02) {
+			envelope_attack_ = !envelope_attack_;
+		}
+	} else {
+		if (shape & 0x02) {
+			envelope_attack_ = !envelope_attack_;
+		}
+		envelope_step_ = 0;
+	}
+}
+
+void Sunsoft5bAudio::run(std::uint32_t cycles) noexcept {
+	for (int channel = 0; channel < 3; ++channel) {
+		if (tone_timers_[channel].run(cycles) & 1) {
+			tone_high_[channel] = !tone_high_[channel];
+		}
+	}
+
+	for (std::uint64_t steps = noise_timer_.run(cycles) % NOISE_LFSR_PERIOD; steps > 0; --steps) {
+		const std::uint32_t feedback = (noise_lfsr_ ^ (noise_lfsr_ >> 3)) & 1;
+		noise_lfsr_ = (noise_lfsr_ >> 1) | (feedback << 16);
+	}
+
+	std::uint64_t envelope_steps = envelope_timer_.run(cycles);
+	if (!envelope_holding_ && envelope_steps > 0) {
+		const Byte shape = registers_[13];
+		if ((shape & 0x09) == 0x08) {
+			// Repeating shapes come back to the same state every 32 steps
+			envelope_steps %= 32;
+		} else {
+			// Others hold within one ramp
+			envelope_steps = std::min<std::uint64_t>(envelope_steps, 16);
+		}
+		for (; envelope_steps > 0; --envelope_steps) {
+			step_envelope();
+		}
+	}
+}
+
+std::uint32_t Sunsoft5bAudio::cycles_until_step() const noexcept {
+	std::uint32_t cycles = 0xFFFFFFFFu;
+	bool noise_audible = false;
+	bool envelope_audible = false;
+	for (int channel = 0; channel < 3; ++channel) {
+		const bool enveloped = uses_envelope(channel);
+		if (!enveloped && (registers_[8 + channel] & 0x0F) == 0) {
+			continue;
+		}
+		if (tone_enabled(channel)) {
+			cycles = std::min(cycles, tone_timers_[channel].left);
+		}
+		noise_audible |= noise_enabled(channel);
+		envelope_audible |= enveloped;
+	}
+	if (noise_audible) {
+		cycles = std::min(cycles, noise_timer_.left);
+	}
+	if (envelope_audible && !envelope_holding_) {
+		cycles = std::min(cycles, envelope_timer_.left);
+	}
+	return cycles;
+}
+
+float Sunsoft5bAudio::output() const noexcept {
+	const bool noise_high = (noise_lfsr_ & 1) != 0;
+	float level = 0.0f;
+	for (int channel = 0; channel < 3; ++channel) {
+		const bool tone = !tone_enabled(channel) || tone_high_[channel];
+		const bool noise = !noise_enabled(channel) || noise_high;
+		if (tone && noise) {
+			level += VOLUME_LEVELS[channel_volume(channel)];
+		}
+	}
+	return level;
+}
+
+void Sunsoft5bAudio::serialize_state(std::vector<std::uint8_t> &buffer) const {
+	const auto put_u32 = [&buffer](std::uint32_t value) {
+		for (int shift = 0; shift < 32; shift += 8) {
+			buffer.push_back(static_cast<std::uint8_t>(value >> shift));
+		}
+	};
+	buffer.insert(buffer.end(), registers_.begin(), registers_.end());
+	buffer.push_back(selected_);
+	for (int channel = 0; channel < 3; ++channel) {
+		put_u32(tone_timers_[channel].left);
+		buffer.push_back(tone_high_[channel] ? 1 : 0);
+	}
+	put_u32(noise_timer_.left);
+	put_u32(noise_lfsr_);
+	put_u32(envelope_timer_.left);
+	buffer.push_back(envelope_step_);
+	buffer.push_back(envelope_attack_ ? 1 : 0);
+	buffer.push_back(envelope_holding_ ? 1 : 0);
+}
+
+void Sunsoft5bAudio::deserialize_state(const std::vector<std::uint8_t> &buffer, std::size_t &offset) {
+	// 16 registers + select + 3 x (timer + flag) + noise timer/LFSR, envelope
+	constexpr std::size_t STATE_SIZE = 16 + 1 + 3 * 5 + 4 + 4 + 4 + 3;
+	if (offset + STATE_SIZE > buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (Sunsoft 5B audio)");
+	}
+	const auto get_u32 = [&]() {
+		std::uint32_t value = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			value |= static_cast<std::uint32_t>(buffer[offset++]) << shift;
+		}
+		return value;
+	};
+	std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), registers_.size(), registers_.begin());
+	offset += registers_.size();
+	selected_ = buffer[offset++] & 0x0F;
+	update_periods();
+	for (int channel = 0; channel < 3; ++channel) {
+		tone_timers_[channel].left = std::max<std::uint32_t>(get_u32(), 1);
+		tone_high_[channel] = buffer[offset++] != 0;
+	}
+	noise_timer_.left = std::max<std::uint32_t>(get_u32(), 1);
+	noise_lfsr_ = get_u32() & NOISE_LFSR_PERIOD;
+	if (noise_lfsr_ == 0) {
+		noise_lfsr_ = 1;
+	}
+	envelope_timer_.left = std::max<std::uint32_t>(get_u32(), 1);
+	envelope_step_ = buffer[offset++] & 0x0F;
+	envelope_attack_ = buffer[offset++] != 0;
+	envelope_holding_ = buffer[offset++] != 0;
+}
+
+} // namespace nes
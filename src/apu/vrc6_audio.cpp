@@ -0,0 +1,186 @@
+#include "apu/vrc6_audio.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nes {
+
+Vrc6Audio::Vrc6Audio() {
+	reset();
+}
+
+void Vrc6Audio::reset() noexcept {
+	pulses_ = {};
+	saw_ = {};
+	halted_ = false;
+	period_shift_ = 0;
+	update_timers();
+}
+
+void Vrc6Audio::update_timers() noexcept {
+	for (Pulse &pulse : pulses_) {
+		pulse.timer.period = static_cast<std::uint32_t>(pulse.period >> period_shift_) + 1;
+	}
+	saw_.timer.period = static_cast<std::uint32_t>(saw_.period >> period_shift_) + 1;
+}
+
+void Vrc6Audio::write(Address address, Byte value) {
+	const unsigned reg = address & 0x0003;
+	switch (address & 0xF000) {
+	case 0x9000:
+	case 0xA000: {
+		if ((address & 0xF000) == 0x9000 && reg == 3) {
+			halted_ = (value & 0x01) != 0;
+			period_shift_ = (value & 0x04) ? 8 : (value & 0x02) ? 4 : 0;
+			update_timers();
+			break;
+		}
+		Pulse &pulse = pulses_[(address & 0xF000) == 0x9000 ? 0 : 1];
+		if (reg == 0) {
+			pulse.constant = (value & 0x80) != 0;
+			pulse.duty = (value >> 4) & 0x07;
+			pulse.volume = value & 0x0F;
+		} else if (reg == 1) {
+			pulse.period = static_cast<std::uint16_t>((pulse.period & 0x0F00) | value);
+		} else if (reg == 2) {
+			pulse.period = static_cast<std::uint16_t>((pulse.period & 0x00FF) | ((value & 0x0F) << 8));
+			pulse.enabled = (value & 0x80) != 0;
+			if (!pulse.enabled) {
+				pulse.step = 15; // Duty sequence restarts on enable
+			}
+		}
+		update_timers();
+		break;
+	}
+	case 0xB000:
+		if (reg == 0) {
+			saw_.rate = value & 0x3F;
+		} else if (reg == 1) {
+			saw_.period = static_cast<std::uint16_t>((saw_.period & 0x0F00) | value);
+		} else if (reg == 2) {
+			saw_.period = static_cast<std::uint16_t>((saw_.period & 0x00FF) | ((value & 0x0F) << 8));
+			saw_.enabled = (value & 0x80) != 0;
+			if (!saw_.enabled) {
+				saw_.step = 0;
+				saw_.accumulator = 0;
+			}
+		}
+		update_timers();
+		break;
+	default:
+		break;
+	}
+}
+
+void Vrc6Audio::run(std::uint32_t cycles) noexcept {
+	if (halted_) {
+		return;
+	}
+	for (Pulse &pulse : pulses_) {
+		if (pulse.enabled) {
+			const std::uint64_t steps = pulse.timer.run(cycles);
+			pulse.step = static_cast<Byte>((pulse.step - steps) & 0x0F);
+		}
+	}
+	if (saw_.enabled) {
+		std::uint64_t steps = saw_.timer.run(cycles);
+		if (steps >= 14u - saw_.step) {
+			// Through at least one reset: only the steps after the last count
+			steps = (steps - (14u - saw_.step)) % 14u;
+			saw_.step = 0;
+			saw_.accumulator = 0;
+		}
+		// The rate is added on each even step reached
+		const unsigned to = saw_.step + static_cast<unsigned>(steps);
+		const unsigned adds = to / 2 - saw_.step / 2;
+		saw_.accumulator = static_cast<Byte>(saw_.accumulator + adds * saw_.rate);
+		saw_.step = static_cast<Byte>(to);
+	}
+}
+
+std::uint32_t Vrc6Audio::cycles_until_step() const noexcept {
+	std::uint32_t cycles = 0xFFFFFFFFu;
+	if (halted_) {
+		return cycles;
+	}
+	for (const Pulse &pulse : pulses_) {
+		if (pulse.enabled && pulse.volume > 0) {
+			cycles = std::min(cycles, pulse.timer.left);
+		}
+	}
+	if (saw_.enabled) {
+		cycles = std::min(cycles, saw_.timer.left);
+	}
+	return cycles;
+}
+
+float Vrc6Audio::output() const noexcept {
+	const unsigned sum = pulses_[0].level() + pulses_[1].level() + saw_.level();
+	return static_cast<float>(sum) * LEVEL_SCALE;
+}
+
+void Vrc6Audio::serialize_state(std::vector<std::uint8_t> &buffer) const {
+	const auto put_timer = [&buffer](const StepTimer &timer) {
+		for (int shift = 0; shift < 32; shift += 8) {
+			buffer.push_back(static_cast<std::uint8_t>(timer.left >> shift));
+		}
+	};
+	for (const Pulse &pulse : pulses_) {
+		put_timer(pulse.timer);
+		buffer.push_back(static_cast<std::uint8_t>(pulse.period & 0xFF));
+		buffer.push_back(static_cast<std::uint8_t>(pulse.period >> 8));
+		buffer.push_back(pulse.volume);
+		buffer.push_back(pulse.duty);
+		buffer.push_back(pulse.step);
+		buffer.push_back(pulse.constant ? 1 : 0);
+		buffer.push_back(pulse.enabled ? 1 : 0);
+	}
+	put_timer(saw_.timer);
+	buffer.push_back(static_cast<std::uint8_t>(saw_.period & 0xFF));
+	buffer.push_back(static_cast<std::uint8_t>(saw_.period >> 8));
+	buffer.push_back(saw_.rate);
+	buffer.push_back(saw_.step);
+	buffer.push_back(saw_.accumulator);
+	buffer.push_back(saw_.enabled ? 1 : 0);
+	buffer.push_back(halted_ ? 1 : 0);
+	buffer.push_back(period_shift_);
+}
+
+void Vrc6Audio::deserialize_state(const std::vector<std::uint8_t> &buffer, std::size_t &offset) {
+	// 2 pulses x 11 bytes + saw 10 bytes + 2 control bytes
+	constexpr std::size_t STATE_SIZE = 2 * 11 + 10 + 2;
+	if (offset + STATE_SIZE > buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (VRC6 audio)");
+	}
+	const auto get_timer = [&](StepTimer &timer) {
+		timer.left = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			timer.left |= static_cast<std::uint32_t>(buffer[offset++]) << shift;
+		}
+	};
+	for (Pulse &pulse : pulses_) {
+		get_timer(pulse.timer);
+		pulse.period = static_cast<std::uint16_t>(buffer[offset] | (buffer[offset + 1] << 8));
+		offset += 2;
+		pulse.volume = buffer[offset++];
+		pulse.duty = buffer[offset++];
+		pulse.step = buffer[offset++];
+		pulse.constant = buffer[offset++] != 0;
+		pulse.enabled = buffer[offset++] != 0;
+	}
+	get_timer(saw_.timer);
+	saw_.period = static_cast<std::uint16_t>(buffer[offset] | (buffer[offset + 1] << 8));
+	offset += 2;
+	saw_.rate = buffer[offset++];
+	saw_.step = buffer[offset++];
+	saw_.accumulator = buffer[offset++];
+	saw_.enabled = buffer[offset++] != 0;
+	halted_ = buffer[offset++] != 0;
+	period_shift_ = buffer[offset++];
+	update_timers();
+	for (Pulse &pulse : pulses_) {
+		pulse.timer.left = std::max<std::uint32_t>(pulse.timer.left, 1);
+	}
+	saw_.timer.left = std::max<std::uint32_t>(saw_.timer.left, 1);
+}
+
+} // namespace nes
@@ -7,8 +7,7 @@ namespace nes {
 
 AudioBackend::AudioBackend()
 	: device_id_(0), stream_(nullptr), is_initialized_(false), is_playing_(false), volume_(1.0f),
-	  ring_buffer_(RING_CAPACITY, 0.0f), ring_read_(0), ring_write_(0), ring_count_(0), last_left_(0.0f),
-	  last_right_(0.0f), want_playing_(false), sample_rate_(44100), buffer_size_(1024) {
+	  last_left_(0.0f), last_right_(0.0f), want_playing_(false), sample_rate_(44100), buffer_size_(1024) {
 }
 
 AudioBackend::~AudioBackend() {
@@ -77,6 +76,7 @@ bool AudioBackend::initialize(int sample_rate, int buffer_size) {
 
 	// Store the actual sample rate
 	sample_rate_ = sample_rate;
+	latency_.set_sample_rate(sample_rate);
 
 	std::cout << "AudioBackend: Initialized successfully" << std::endl;
 	std::cout << "  Sample rate: " << sample_rate << " Hz" << std::endl;
@@ -98,7 +98,7 @@ void AudioBackend::start() {
 	// PRE_BUFFER_THRESHOLD.  queue_sample_stereo() will resume once enough
 	// samples are queued, eliminating startup clicks from empty-buffer underruns.
 	want_playing_ = true;
-	std::cout << "AudioBackend: Pre-buffering (" << (PRE_BUFFER_THRESHOLD / 2 * 1000 / sample_rate_) << " ms)..."
+	std::cout << "AudioBackend: Pre-buffering (" << (pre_buffer_threshold() / 2 * 1000 / sample_rate_) << " ms)..."
 			  << std::endl;
 }
 
@@ -111,6 +111,8 @@ void AudioBackend::stop() {
 	is_playing_.store(false);
 	want_playing_ = false;
 	clear_buffer();
+	// The next run may be on another device, or after a long pause
+	latency_.reset();
 	std::cout << "AudioBackend: Stopped" << std::endl;
 }
 
@@ -133,6 +135,36 @@ void AudioBackend::queue_sample(float sample) {
 	queue_sample_stereo(sample, sample);
 }
 
+void AudioBackend::queue_samples(std::span<const float> samples) {
+	if (!is_initialized_.load()) {
+		return;
+	}
+
+	const float vol = volume_.load();
+
+	// Interleave into a stack chunk so each ring publish covers many samples
+	constexpr std::size_t CHUNK_FRAMES = 256;
+	float chunk[CHUNK_FRAMES * 2];
+	while (!samples.empty()) {
+		const std::size_t frames = std::min(samples.size(), CHUNK_FRAMES);
+		for (std::size_t i = 0; i < frames; ++i) {
+			const float sample = std::clamp(samples[i], -1.0f, 1.0f) * vol;
+			chunk[i * 2] = sample;
+			chunk[i * 2 + 1] = sample;
+		}
+		samples = samples.subspan(frames);
+
+		// Drop whole stereo pairs if ring buffer is full (prevents unbounded growth)
+		const std::size_t floats = std::min(frames * 2, ring_.write_available() & ~std::size_t{1});
+		ring_.push(std::span<const float>(chunk, floats));
+		if (floats < frames * 2) {
+			break;
+		}
+	}
+
+	check_pre_buffer();
+}
+
 void AudioBackend::queue_sample_stereo(float left, float right) {
 	if (!is_initialized_.load()) {
 		return;
@@ -147,43 +179,49 @@ void AudioBackend::queue_sample_stereo(float left, float right) {
 	left *= vol;
 	right *= vol;
 
-	// Write to ring buffer (thread-safe)
-	std::lock_guard<std::mutex> lock(ring_mutex_);
-
 	// Drop sample if ring buffer is full (prevents unbounded growth)
-	if (ring_count_ + 2 > RING_CAPACITY) {
+	if (ring_.write_available() < 2) {
 		return;
 	}
 
-	ring_buffer_[ring_write_] = left;
-	ring_write_ = (ring_write_ + 1) % RING_CAPACITY;
-	ring_buffer_[ring_write_] = right;
-	ring_write_ = (ring_write_ + 1) % RING_CAPACITY;
-	ring_count_ += 2;
+	// Wait-free publish; the audio thread never sees half a pair
+	const float pair[2] = {left, right};
+	ring_.push(pair);
 
+	check_pre_buffer();
+}
+
+void AudioBackend::check_pre_buffer() {
 	// Pre-buffer: once we accumulate enough samples, start the SDL device.
 	// This ensures the first SDL callback has a comfortable cushion of data.
-	if (want_playing_ && !is_playing_.load() && ring_count_ >= PRE_BUFFER_THRESHOLD) {
+	if (want_playing_ && !is_playing_.load() && ring_.size() >= pre_buffer_threshold()) {
 		SDL_ResumeAudioDevice(device_id_);
 		is_playing_.store(true);
-		// (cout omitted — we're under a lock, keep it fast)
 	}
 }
 
+std::size_t AudioBackend::pre_buffer_threshold() const {
+	return std::min(PRE_BUFFER_THRESHOLD, latency_.target() * 2);
+}
+
 void AudioBackend::set_volume(float volume) {
 	volume_.store(std::clamp(volume, 0.0f, 1.0f));
 }
 
 std::size_t AudioBackend::get_buffer_size() const {
-	std::lock_guard<std::mutex> lock(const_cast<std::mutex &>(ring_mutex_));
-	return ring_count_ / 2; // Divide by 2 for stereo → sample pairs
+	return ring_.size() / 2; // Divide by 2 for stereo → sample pairs
 }
 
 void AudioBackend::clear_buffer() {
-	std::lock_guard<std::mutex> lock(ring_mutex_);
-	ring_read_ = 0;
-	ring_write_ = 0;
-	ring_count_ = 0;
+	// Resetting moves the consumer's index, so keep the audio thread out of
+	// fill_audio_buffer(): SDL holds the stream lock around the get callback.
+	if (stream_) {
+		SDL_LockAudioStream(stream_);
+	}
+	ring_.reset();
+	if (stream_) {
+		SDL_UnlockAudioStream(stream_);
+	}
 }
 
 void AudioBackend::audio_stream_callback(void *userdata, SDL_AudioStream *stream, int additional_amount,
@@ -209,16 +247,11 @@ void AudioBackend::audio_stream_callback(void *userdata, SDL_AudioStream *stream
 }
 
 void AudioBackend::fill_audio_buffer(float *stream, int sample_count) {
-	std::lock_guard<std::mutex> lock(ring_mutex_);
+	latency_.on_pull(SDL_GetTicksNS(), static_cast<std::size_t>(sample_count) / 2, ring_.size() / 2);
 
-	int samples_to_copy = std::min(sample_count, static_cast<int>(ring_count_));
-
-	// Copy samples from ring buffer to output — O(1) per sample, no erases.
-	for (int i = 0; i < samples_to_copy; i++) {
-		stream[i] = ring_buffer_[ring_read_];
-		ring_read_ = (ring_read_ + 1) % RING_CAPACITY;
-	}
-	ring_count_ -= samples_to_copy;
+	// Copy samples from ring buffer to output — wait-free, no erases.
+	int samples_to_copy =
+		static_cast<int>(ring_.pop(std::span<float>(stream, static_cast<std::size_t>(sample_count))));
 
 	// Track the last stereo pair for smooth underrun handling
 	if (samples_to_copy >= 2) {
@@ -0,0 +1,175 @@
+#include "audio/audio_recorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace nes {
+
+namespace {
+
+constexpr const char *TRACK_NAMES[AudioRecorder::TRACK_COUNT] = {"mix", "pulse1", "pulse2", "triangle", "noise", "dmc"};
+
+void put_u16(std::vector<char> &out, std::uint16_t value) {
+	out.push_back(static_cast<char>(value & 0xFF));
+	out.push_back(static_cast<char>(value >> 8));
+}
+
+void put_u32(std::vector<char> &out, std::uint32_t value) {
+	for (int shift = 0; shift < 32; shift += 8) {
+		out.push_back(static_cast<char>((value >> shift) & 0xFF));
+	}
+}
+
+void put_tag(std::vector<char> &out, const char (&tag)[5]) {
+	out.insert(out.end(), tag, tag + 4);
+}
+
+} // namespace
+
+AudioRecorder::~AudioRecorder() {
+	close();
+}
+
+std::filesystem::path AudioRecorder::track_path(const std::filesystem::path &path, Track track) {
+	if (track == Track::Mix) {
+		return path;
+	}
+	std::filesystem::path stem_path = path;
+	stem_path.replace_filename(path.stem().string() + "." + TRACK_NAMES[static_cast<std::size_t>(track)] +
+							   path.extension().string());
+	return stem_path;
+}
+
+bool AudioRecorder::open(const std::filesystem::path &path, int sample_rate, Format format, bool stems) {
+	if (is_open() || sample_rate <= 0) {
+		return false;
+	}
+	format_ = format;
+	sample_rate_ = sample_rate;
+	stems_ = stems;
+	failed_ = false;
+	stop_ = false;
+	dropped_ = 0;
+
+	const std::size_t tracks = stems ? TRACK_COUNT : 1;
+	for (std::size_t i = 0; i < tracks; ++i) {
+		auto stream = std::make_unique<Stream>();
+		stream->file.open(track_path(path, static_cast<Track>(i)), std::ios::binary | std::ios::trunc);
+		if (!stream->file) {
+			for (auto &opened : streams_) {
+				opened.reset();
+			}
+			return false;
+		}
+		if (format_ == Format::Wav) {
+			write_wav_header(stream->file, 0);
+		}
+		streams_[i] = std::move(stream);
+	}
+	thread_ = std::thread(&AudioRecorder::writer_main, this);
+	return true;
+}
+
+bool AudioRecorder::close() {
+	if (!is_open()) {
+		return !failed_;
+	}
+	stop_.store(true, std::memory_order_release);
+	thread_.join();
+
+	for (auto &stream : streams_) {
+		if (!stream) {
+			continue;
+		}
+		if (format_ == Format::Wav) {
+			stream->file.seekp(0);
+			write_wav_header(stream->file, stream->written.load(std::memory_order_relaxed));
+		}
+		stream->file.close();
+		if (!stream->file) {
+			failed_ = true;
+		}
+	}
+	return !failed_;
+}
+
+void AudioRecorder::write(Track track, std::span<const float> samples) noexcept {
+	Stream *stream = streams_[static_cast<std::size_t>(track)].get();
+	if (!stream || !is_open()) {
+		return;
+	}
+	const std::size_t pushed = stream->ring.push(samples);
+	if (pushed != samples.size()) {
+		dropped_.fetch_add(samples.size() - pushed, std::memory_order_relaxed);
+	}
+}
+
+std::uint64_t AudioRecorder::samples_written(Track track) const noexcept {
+	const Stream *stream = streams_[static_cast<std::size_t>(track)].get();
+	return stream ? stream->written.load(std::memory_order_relaxed) : 0;
+}
+
+void AudioRecorder::writer_main() {
+	for (;;) {
+		// Read the flag before draining: whatever was pushed before close()
+		// set it is then guaranteed to be written by this last pass
+		const bool stopping = stop_.load(std::memory_order_acquire);
+		bool wrote = false;
+		for (auto &stream : streams_) {
+			if (stream) {
+				wrote |= drain(*stream);
+			}
+		}
+		if (stopping) {
+			return;
+		}
+		if (!wrote) {
+			// A ring holds seconds of audio even when headless runs emulate
+			// far faster than real time, so a short nap costs nothing
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+}
+
+bool AudioRecorder::drain(Stream &stream) {
+	std::array<float, 4096> chunk;
+	bool wrote = false;
+	while (const std::size_t count = stream.ring.pop(chunk)) {
+		stream.file.write(reinterpret_cast<const char *>(chunk.data()),
+						  static_cast<std::streamsize>(count * sizeof(float)));
+		if (!stream.file) {
+			failed_ = true;
+		}
+		stream.written.fetch_add(count, std::memory_order_relaxed);
+		wrote = true;
+	}
+	return wrote;
+}
+
+void AudioRecorder::write_wav_header(std::ofstream &file, std::uint64_t samples) const {
+	// IEEE float (format 3) mono: RIFF, an 18-byte fmt chunk, the fact chunk
+	// non-PCM formats carry, then the data chunk header
+	const auto data_bytes = static_cast<std::uint32_t>(std::min<std::uint64_t>(samples * sizeof(float), 0xFFFFFFC0u));
+	std::vector<char> header;
+	put_tag(header, "RIFF");
+	put_u32(header, 4 + (8 + 18) + (8 + 4) + 8 + data_bytes);
+	put_tag(header, "WAVE");
+	put_tag(header, "fmt ");
+	put_u32(header, 18);
+	put_u16(header, 3); // WAVE_FORMAT_IEEE_FLOAT
+	put_u16(header, 1); // Mono
+	put_u32(header, static_cast<std::uint32_t>(sample_rate_));
+	put_u32(header, static_cast<std::uint32_t>(sample_rate_) * sizeof(float));
+	put_u16(header, sizeof(float)); // Block align
+	put_u16(header, 32);			// Bits per sample
+	put_u16(header, 0);				// No extension
+	put_tag(header, "fact");
+	put_u32(header, 4);
+	put_u32(header, data_bytes / sizeof(float));
+	put_tag(header, "data");
+	put_u32(header, data_bytes);
+	file.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+} // namespace nes
@@ -0,0 +1,126 @@
+#include "audio/blip_buffer.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace nes {
+
+namespace {
+
+constexpr int KERNEL_TAPS = BlipBuffer::HALF_WIDTH * 2;
+
+// Band-limited impulse for every tabulated fractional position (PHASES + 1
+// rows so the last row can be interpolated against).  Windowed sinc with the
+// cutoff at 45% of the output rate (a little under Nyquist to leave room for
+// the Blackman window's transition band); each row is normalized to unit sum
+// so an integrated delta settles at exactly its amplitude.
+using Kernel = std::array<std::array<float, KERNEL_TAPS>, BlipBuffer::PHASES + 1>;
+
+Kernel build_kernel() {
+	constexpr double PI = 3.14159265358979323846;
+	constexpr double CUTOFF = 0.45; // cycles per output sample
+	Kernel kernel{};
+	for (int phase = 0; phase <= BlipBuffer::PHASES; ++phase) {
+		const double center = BlipBuffer::HALF_WIDTH - 1 + static_cast<double>(phase) / BlipBuffer::PHASES;
+		double sum = 0.0;
+		std::array<double, KERNEL_TAPS> row{};
+		for (int tap = 0; tap < KERNEL_TAPS; ++tap) {
+			const double x = tap - center;
+			const double sinc = (x == 0.0) ? 1.0 : std::sin(2.0 * PI * CUTOFF * x) / (2.0 * PI * CUTOFF * x);
+			const double w = x / BlipBuffer::HALF_WIDTH; // [-1, 1] across the kernel
+			const double window =
+				(std::abs(w) >= 1.0) ? 0.0 : 0.42 + 0.5 * std::cos(PI * w) + 0.08 * std::cos(2.0 * PI * w);
+			row[tap] = sinc * window;
+			sum += row[tap];
+		}
+		for (int tap = 0; tap < KERNEL_TAPS; ++tap) {
+			kernel[phase][tap] = static_cast<float>(row[tap] / sum);
+		}
+	}
+	return kernel;
+}
+
+const Kernel &kernel() {
+	static const Kernel table = build_kernel();
+	return table;
+}
+
+} // namespace
+
+BlipBuffer::BlipBuffer(double clock_rate, double sample_rate, std::uint32_t max_frame_clocks)
+	: factor_(0), offset_(0), integrator_(0.0f), max_frame_clocks_(max_frame_clocks) {
+	set_rates(clock_rate, sample_rate);
+}
+
+void BlipBuffer::set_rates(double clock_rate, double sample_rate) {
+	// Guard against non-positive rates (same fallback as SampleRateConverter)
+	const double ratio = (clock_rate > 0.0 && sample_rate > 0.0) ? sample_rate / clock_rate : 1.0;
+	factor_ = static_cast<std::uint64_t>(std::ceil(ratio * static_cast<double>(std::uint64_t{1} << FRAC_BITS)));
+	resize_for_rates();
+}
+
+void BlipBuffer::resize_for_rates() {
+	// One frame of output plus unread leftovers (< 1 frame) plus kernel tail
+	const std::uint64_t frame_samples = ((static_cast<std::uint64_t>(max_frame_clocks_) * factor_) >> FRAC_BITS) + 1;
+	const std::size_t needed = static_cast<std::size_t>(frame_samples * 2) + KERNEL_TAPS + 1;
+	if (buffer_.size() < needed) {
+		buffer_.resize(needed, 0.0f);
+	}
+}
+
+void BlipBuffer::add_delta(std::uint32_t clock_time, float delta) {
+	const std::uint64_t position = offset_ + static_cast<std::uint64_t>(clock_time) * factor_;
+	const std::size_t index = static_cast<std::size_t>(position >> FRAC_BITS);
+	if (index + KERNEL_TAPS > buffer_.size()) {
+		return; // beyond max_frame_clocks; caller violated the frame contract
+	}
+
+	// Top PHASE_BITS of the fraction pick the kernel row, the next 16 bits
+	// interpolate between it and the following row
+	const auto fraction = static_cast<std::uint32_t>(position);
+	const auto phase = static_cast<int>(fraction >> (FRAC_BITS - PHASE_BITS));
+	const float interp =
+		static_cast<float>((fraction >> (FRAC_BITS - PHASE_BITS - 16)) & 0xFFFF) * (1.0f / 65536.0f);
+
+	const auto &lo = kernel()[phase];
+	const auto &hi = kernel()[phase + 1];
+	float *out = buffer_.data() + index;
+	const float delta_hi = delta * interp;
+	const float delta_lo = delta - delta_hi;
+	for (int tap = 0; tap < KERNEL_TAPS; ++tap) {
+		out[tap] += lo[tap] * delta_lo + hi[tap] * delta_hi;
+	}
+}
+
+void BlipBuffer::end_frame(std::uint32_t clocks) {
+	offset_ += static_cast<std::uint64_t>(clocks) * factor_;
+}
+
+std::size_t BlipBuffer::read_samples(std::span<float> out) {
+	const std::size_t count = std::min(out.size(), samples_available());
+	if (count == 0) {
+		return 0;
+	}
+
+	float level = integrator_;
+	for (std::size_t i = 0; i < count; ++i) {
+		level += buffer_[i];
+		out[i] = level;
+	}
+	integrator_ = level;
+
+	// Shift the unread samples and the pending kernel tails to the front
+	const std::size_t remaining = samples_available() - count + KERNEL_TAPS;
+	std::copy_n(buffer_.begin() + static_cast<std::ptrdiff_t>(count), remaining, buffer_.begin());
+	std::fill_n(buffer_.begin() + static_cast<std::ptrdiff_t>(remaining), count, 0.0f);
+	offset_ -= static_cast<std::uint64_t>(count) << FRAC_BITS;
+	return count;
+}
+
+void BlipBuffer::clear() {
+	std::fill(buffer_.begin(), buffer_.end(), 0.0f);
+	offset_ = 0;
+	integrator_ = 0.0f;
+}
+
+} // namespace nes
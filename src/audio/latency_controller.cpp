@@ -0,0 +1,149 @@
+#include "audio/latency_controller.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace nes {
+
+namespace {
+
+constexpr double NS_PER_SECOND = 1e9;
+
+} // namespace
+
+LatencyController::LatencyController(int sample_rate) noexcept {
+	set_sample_rate(sample_rate);
+}
+
+void LatencyController::reset() noexcept {
+	target_.store(DEFAULT_TARGET, std::memory_order_relaxed);
+	reset_pending_.store(true, std::memory_order_release);
+}
+
+void LatencyController::set_adaptive(bool adaptive) noexcept {
+	adaptive_.store(adaptive, std::memory_order_relaxed);
+	if (!adaptive) {
+		target_.store(DEFAULT_TARGET, std::memory_order_relaxed);
+	}
+}
+
+void LatencyController::restart() noexcept {
+	started_ = false;
+	frames_since_first_ = 0;
+	interval_ns_ = 0.0;
+	jitter_ns_ = 0.0;
+	window_pulls_ = 0;
+	window_fill_sum_ = 0.0;
+	window_largest_pull_ = 0;
+	window_underrun_ = false;
+	last_window_mean_ = -1.0;
+	hold_windows_ = 0;
+	published_interval_ns_.store(0.0, std::memory_order_relaxed);
+	published_jitter_ns_.store(0.0, std::memory_order_relaxed);
+	published_rate_hz_.store(0.0, std::memory_order_relaxed);
+	published_largest_pull_.store(0, std::memory_order_relaxed);
+	underruns_.store(0, std::memory_order_relaxed);
+}
+
+void LatencyController::on_pull(std::uint64_t now_ns, std::size_t requested, std::size_t available) noexcept {
+	if (reset_pending_.exchange(false, std::memory_order_acq_rel)) {
+		restart();
+	}
+	published_fill_.store(available, std::memory_order_relaxed);
+	if (available < requested) {
+		underruns_.fetch_add(1, std::memory_order_relaxed);
+		window_underrun_ = true;
+	}
+
+	if (!started_) {
+		started_ = true;
+		first_ns_ = now_ns;
+		window_start_ns_ = now_ns;
+	} else {
+		// Cadence: exponential averages of the interval and its deviation
+		const double interval = static_cast<double>(now_ns - last_ns_);
+		if (interval_ns_ == 0.0) {
+			interval_ns_ = interval;
+		} else {
+			jitter_ns_ += (std::abs(interval - interval_ns_) - jitter_ns_) / 16.0;
+			interval_ns_ += (interval - interval_ns_) / 16.0;
+		}
+		published_interval_ns_.store(interval_ns_, std::memory_order_relaxed);
+		published_jitter_ns_.store(jitter_ns_, std::memory_order_relaxed);
+
+		// Drift: everything consumed before this pull over the time since the
+		// first. The error is about one pull over the whole run, so the
+		// estimate keeps sharpening for as long as the device runs.
+		const double elapsed = static_cast<double>(now_ns - first_ns_);
+		if (elapsed >= WINDOW_SECONDS * NS_PER_SECOND) {
+			published_rate_hz_.store(static_cast<double>(frames_since_first_) * NS_PER_SECOND / elapsed,
+									 std::memory_order_relaxed);
+		}
+	}
+	last_ns_ = now_ns;
+	frames_since_first_ += requested;
+
+	window_fill_min_ = window_pulls_ == 0 ? available : std::min(window_fill_min_, available);
+	window_fill_sum_ += static_cast<double>(available);
+	window_largest_pull_ = std::max(window_largest_pull_, requested);
+	++window_pulls_;
+	if (static_cast<double>(now_ns - window_start_ns_) >= WINDOW_SECONDS * NS_PER_SECOND) {
+		end_window(now_ns);
+	}
+}
+
+void LatencyController::end_window(std::uint64_t now_ns) noexcept {
+	const std::size_t largest = window_largest_pull_;
+	published_largest_pull_.store(largest, std::memory_order_relaxed);
+
+	// Only a fill that has stopped moving says what a target needs: while it
+	// still drains toward a lower one its lows are too high
+	const double mean = window_fill_sum_ / static_cast<double>(window_pulls_);
+	const bool settled = last_window_mean_ >= 0.0 &&
+						 std::abs(mean - last_window_mean_) <= std::max(16.0, static_cast<double>(largest) / 16.0);
+	last_window_mean_ = mean;
+
+	if (adaptive_.load(std::memory_order_relaxed)) {
+		std::size_t target = target_.load(std::memory_order_relaxed);
+		if (window_underrun_) {
+			target = std::min(MAX_TARGET, target + target / 2 + largest);
+			hold_windows_ = HOLD_WINDOWS;
+		} else if (hold_windows_ > 0) {
+			--hold_windows_;
+		} else if (settled) {
+			// The fill follows the target, so the lowest fill seen could drop
+			// by whatever it kept beyond one pull and a margin
+			const double jitter_frames = jitter_ns_ * sample_rate_ / NS_PER_SECOND;
+			const double margin = std::max(static_cast<double>(largest) / 2.0, 3.0 * jitter_frames);
+			const double spare = static_cast<double>(window_fill_min_) - static_cast<double>(largest) - margin;
+			const double needed = std::max({static_cast<double>(target) - spare, static_cast<double>(largest) * 2.0,
+											static_cast<double>(MIN_TARGET)});
+			if (needed < static_cast<double>(target)) {
+				target = static_cast<std::size_t>(std::max(needed, static_cast<double>(target) * 0.9));
+			}
+		}
+		target_.store(target, std::memory_order_relaxed);
+	}
+
+	window_start_ns_ = now_ns;
+	window_pulls_ = 0;
+	window_fill_sum_ = 0.0;
+	window_largest_pull_ = 0;
+	window_underrun_ = false;
+}
+
+LatencyController::Stats LatencyController::stats() const noexcept {
+	Stats stats;
+	stats.callback_interval_ms = published_interval_ns_.load(std::memory_order_relaxed) / 1e6;
+	stats.callback_jitter_ms = published_jitter_ns_.load(std::memory_order_relaxed) / 1e6;
+	stats.largest_pull = published_largest_pull_.load(std::memory_order_relaxed);
+	stats.device_rate_hz = published_rate_hz_.load(std::memory_order_relaxed);
+	if (stats.device_rate_hz > 0.0) {
+		stats.drift_ppm = (stats.device_rate_hz / sample_rate_ - 1.0) * 1e6;
+	}
+	stats.target = target_.load(std::memory_order_relaxed);
+	stats.fill = published_fill_.load(std::memory_order_relaxed);
+	stats.underruns = underruns_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+} // namespace nes
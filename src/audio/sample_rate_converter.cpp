@@ -40,6 +40,17 @@ void SampleRateConverter::input_sample(float sample) {
 	}
 }
 
+std::size_t SampleRateConverter::process(std::span<const float> input, std::span<float> output) {
+	std::size_t written = 0;
+	for (const float sample : input) {
+		input_sample(sample);
+		if (has_output_ && written < output.size()) {
+			output[written++] = get_output();
+		}
+	}
+	return written;
+}
+
 float SampleRateConverter::get_output() {
 	has_output_ = false;
 	return output_sample_;
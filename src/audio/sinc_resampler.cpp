@@ -0,0 +1,93 @@
+#include "audio/sinc_resampler.hpp"
+#include "core/simd.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace nes {
+
+SincResampler::SincResampler(float input_rate, float output_rate) {
+	// Same fallback as SampleRateConverter: 1:1 for invalid rates, and this
+	// converter never upsamples
+	double ratio = 1.0;
+	if (input_rate > 0.0f && output_rate > 0.0f && output_rate < input_rate) {
+		ratio = static_cast<double>(input_rate) / static_cast<double>(output_rate);
+	}
+	decimation_ = std::max(1, static_cast<int>(ratio / 4.0));
+	base_step_ = ratio / decimation_;
+	step_ = base_step_;
+
+	// Row p is the kernel for an output p / PHASES intermediate samples older
+	// than TAPS / 2 (PHASES + 1 rows so rounding up never wraps). Cutoff
+	// at 45% of the output rate, as BlipBuffer's, and each row normalized
+	// to unit sum so DC passes unchanged.
+	constexpr double PI = 3.14159265358979323846;
+	constexpr int HALF = TAPS / 2;
+	const double cutoff = 0.45 / base_step_; // Cycles per intermediate sample
+	kernel_.resize(PHASES + 1);
+	for (int phase = 0; phase <= PHASES; ++phase) {
+		const double center = HALF + static_cast<double>(phase) / PHASES;
+		std::array<double, TAPS> row{};
+		double sum = 0.0;
+		for (int tap = 0; tap < TAPS; ++tap) {
+			const double x = (TAPS - 1 - tap) - center; // Age of the tap relative to the output
+			const double sinc = (x == 0.0) ? 1.0 : std::sin(2.0 * PI * cutoff * x) / (2.0 * PI * cutoff * x);
+			const double w = x / (HALF + 1); // [-1, 1] across the kernel
+			const double window =
+				(std::abs(w) >= 1.0) ? 0.0 : 0.42 + 0.5 * std::cos(PI * w) + 0.08 * std::cos(2.0 * PI * w);
+			row[tap] = sinc * window;
+			sum += row[tap];
+		}
+		for (int tap = 0; tap < TAPS; ++tap) {
+			kernel_[phase][tap] = static_cast<float>(row[tap] / sum);
+		}
+	}
+}
+
+std::size_t SincResampler::process(std::span<const float> input, std::span<float> output) {
+	std::size_t written = 0;
+	const float box_scale = 1.0f / static_cast<float>(decimation_);
+	for (const float sample : input) {
+		box_sum_ += sample;
+		if (++box_count_ < decimation_) {
+			continue;
+		}
+		const float intermediate = box_sum_ * box_scale;
+		box_sum_ = 0.0f;
+		box_count_ = 0;
+
+		history_[head_] = intermediate;
+		history_[head_ + TAPS] = intermediate;
+		head_ = (head_ + 1) % TAPS;
+
+		until_output_ -= 1.0;
+		while (until_output_ <= 0.0 && written < output.size()) {
+			output[written++] = convolve(-until_output_);
+			until_output_ += step_;
+		}
+	}
+	return written;
+}
+
+float SincResampler::convolve(double fraction) const noexcept {
+	const auto phase = static_cast<std::size_t>(std::lround(std::min(fraction, 1.0) * PHASES));
+	const float *taps = kernel_[phase].data();
+	const float *window = history_.data() + head_; // Oldest first
+
+	return simd_kernels().dot_product(window, taps, TAPS);
+}
+
+void SincResampler::set_rate_adjustment(float factor) {
+	factor = std::clamp(factor, 0.995f, 1.005f);
+	step_ = base_step_ * static_cast<double>(factor);
+}
+
+void SincResampler::reset() {
+	history_.fill(0.0f);
+	head_ = 0;
+	box_sum_ = 0.0f;
+	box_count_ = 0;
+	until_output_ = 0.0;
+	step_ = base_step_;
+}
+
+} // namespace nes
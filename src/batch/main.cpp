@@ -0,0 +1,356 @@
+// VibeNES_Batch - many independent headless runs across all cores.
+//
+// Usage: VibeNES_Batch <rom.nes> [--frames N] [--instances K] [--threads T]
+//                      [--movie FILE]... [--input replay.txt]...
+//                      [--ram-dir DIR] [--screenshot-dir DIR] [--capture-dir DIR]
+//                      [--frame-hashes DIR] [--golden DIR] [--accuracy-db FILE]
+//
+// Every --movie and --input names one run (none = a single run with no
+// buttons pressed), and each run is repeated K times. Each job gets its own
+// HeadlessSystem - bus, CPU, PPU, APU and cartridge - all sharing one
+// read-only RomImage mapped up front, and the jobs are spread over T worker
+// threads (by default one per hardware thread) that steal from each other
+// when they run dry. Movies play from their start state for as many frames
+// as they hold unless --frames is given; everything else runs N frames
+// (default 600).
+//
+// One line per job is printed in job order, with the same frame/cycle/hash
+// fields as VibeNES_Headless, then the batch totals. --ram-dir writes each
+// job's 2 KB work RAM to DIR/job_<n>.ram and --screenshot-dir its final frame
+// to DIR/job_<n>.ppm. --capture-dir writes every frame of every job to
+// DIR/job_<n>/frame_NNNNNN.png; each job encodes on its own writer thread
+// while it emulates, waiting only if the encoder falls a pool behind.
+//
+// --frame-hashes writes a golden trace per job, DIR/job_<n>.hashes: for
+// every frame an XXH64 of the palette-index frame buffer and a 64-bit
+// perceptual hash. --golden compares each job against DIR/job_<n>.hashes
+// from an earlier build run with the same arguments and reports the first
+// frame that differs and how far the picture moved (perceptual distance,
+// 0-64 bits), failing the job on any difference.
+//
+// --accuracy-db looks the ROM up in an AccuracyDatabase file and runs every
+// job with the PPU accuracy profile listed for it (strict if not listed).
+// Golden traces only match runs made with the same profile.
+
+#include "cartridge/cartridge.hpp"
+#include "cartridge/rom_image.hpp"
+#include "core/accuracy.hpp"
+#include "input/input_movie.hpp"
+#include "input/replay_input.hpp"
+#include "memory/ram.hpp"
+#include "ppu/ppu.hpp"
+#include "system/batch_runner.hpp"
+#include "system/frame_capture.hpp"
+#include "system/frame_dump.hpp"
+#include "system/headless_system.hpp"
+#include "system/save_state.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RunSource {
+	enum class Kind { PowerOn, Movie, Replay };
+	Kind kind = Kind::PowerOn;
+	std::string path;
+};
+
+struct JobResult {
+	bool ok = false;
+	std::string error;
+	uint64_t frames = 0;
+	uint64_t cpu_cycles = 0;
+	uint64_t frame_hash = 0;
+	// Against the golden trace (--golden)
+	uint64_t mismatched_frames = 0;
+	long first_mismatch = -1;
+	int max_perceptual_distance = 0;
+};
+
+struct BatchOptions {
+	long frames = 600;
+	bool frames_given = false;
+	std::string ram_dir;
+	std::string screenshot_dir;
+	std::string capture_dir;
+	std::string hash_dir;
+	std::string golden_dir;
+	nes::Accuracy accuracy = nes::Accuracy::Strict;
+};
+
+void print_usage(const char *program) {
+	std::cerr << "Usage: " << program
+			  << " <rom.nes> [--frames N] [--instances K] [--threads T] [--movie FILE]... [--input replay.txt]..."
+			  << " [--ram-dir DIR] [--screenshot-dir DIR] [--capture-dir DIR] [--frame-hashes DIR] [--golden DIR]"
+			  << " [--accuracy-db FILE]\n";
+}
+
+std::string job_file(const std::string &dir, std::size_t job, const char *extension) {
+	return (std::filesystem::path(dir) / ("job_" + std::to_string(job) + extension)).string();
+}
+
+void run_job(const std::shared_ptr<const nes::RomImage> &rom, const RunSource &source, const BatchOptions &options,
+			 std::size_t job, JobResult &result) {
+	std::shared_ptr<nes::MoviePlayer> player;
+	std::shared_ptr<nes::ReplayInputSource> replay;
+	std::shared_ptr<nes::InputSource> input;
+	if (source.kind == RunSource::Kind::Movie) {
+		player = std::make_shared<nes::MoviePlayer>();
+		if (!player->open(source.path)) {
+			result.error = "cannot read movie " + source.path;
+			return;
+		}
+		input = player;
+	} else if (source.kind == RunSource::Kind::Replay) {
+		replay = std::make_shared<nes::ReplayInputSource>();
+		if (!replay->load_from_file(source.path)) {
+			result.error = "cannot read input script " + source.path;
+			return;
+		}
+		input = replay;
+	}
+
+	nes::HeadlessSystem system(input);
+	if (!system.load_rom_image(rom)) {
+		result.error = "ROM rejected";
+		return;
+	}
+	system.set_accuracy(options.accuracy);
+
+	long frames = options.frames;
+	if (player) {
+		nes::SaveStateManager states(&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge());
+		if (player->get_header().rom_crc32 != states.calculate_rom_crc32()) {
+			result.error = "movie " + source.path + " was recorded with a different ROM";
+			return;
+		}
+		if (!player->get_start_state().empty() && !states.deserialize_state(player->get_start_state())) {
+			result.error = "movie start state does not load: " + states.get_last_error();
+			return;
+		}
+		if (!options.frames_given && player->get_header().frame_count > 0) {
+			frames = static_cast<long>(player->get_header().frame_count);
+		}
+	}
+
+	nes::FrameCapture capture;
+	if (!options.capture_dir.empty()) {
+		nes::FrameCapture::Options capture_options;
+		capture_options.when_full = nes::FrameCapture::WhenFull::Wait;
+		const auto dir = std::filesystem::path(options.capture_dir) / ("job_" + std::to_string(job));
+		if (!capture.open(dir, nes::FrameCapture::Format::PngSequence, capture_options)) {
+			result.error = "cannot create " + dir.string();
+			return;
+		}
+	}
+
+	const bool hashing = !options.hash_dir.empty() || !options.golden_dir.empty();
+	std::vector<nes::FrameHashes> hashes;
+	if (hashing) {
+		hashes.reserve(static_cast<std::size_t>(frames));
+	}
+
+	for (long frame = 0; frame < frames; ++frame) {
+		if (player) {
+			player->next_frame();
+		}
+		if (replay) {
+			replay->set_frame(static_cast<uint64_t>(frame));
+		}
+		const uint64_t cycles = system.run_frame();
+		if (cycles == 0) {
+			result.error = "CPU stalled at frame " + std::to_string(frame);
+			return;
+		}
+		result.cpu_cycles += cycles;
+		++result.frames;
+		if (capture.is_open()) {
+			capture.submit(system.get_frame_buffer());
+		}
+		if (hashing) {
+			hashes.push_back(nes::hash_frame_indices(system.ppu().get_index_buffer()));
+		}
+	}
+	if (capture.is_open() && !capture.close()) {
+		result.error = "cannot write frames to " + options.capture_dir;
+		return;
+	}
+
+	const uint32_t *pixels = system.get_frame_buffer();
+	result.frame_hash = nes::hash_frame_buffer(pixels);
+	if (!options.ram_dir.empty()) {
+		const auto &ram = system.ram().get_memory();
+		const std::string path = job_file(options.ram_dir, job, ".ram");
+		std::ofstream file(path, std::ios::binary);
+		if (!file.write(reinterpret_cast<const char *>(ram.data()), static_cast<std::streamsize>(ram.size()))) {
+			result.error = "cannot write " + path;
+			return;
+		}
+	}
+	if (!options.screenshot_dir.empty()) {
+		const std::string path = job_file(options.screenshot_dir, job, ".ppm");
+		if (!nes::write_frame_ppm(path, pixels)) {
+			result.error = "cannot write " + path;
+			return;
+		}
+	}
+	if (!options.hash_dir.empty()) {
+		const std::string path = job_file(options.hash_dir, job, ".hashes");
+		if (!nes::write_frame_hash_trace(path, hashes)) {
+			result.error = "cannot write " + path;
+			return;
+		}
+	}
+	if (!options.golden_dir.empty()) {
+		const std::string path = job_file(options.golden_dir, job, ".hashes");
+		std::vector<nes::FrameHashes> golden;
+		if (!nes::read_frame_hash_trace(path, golden)) {
+			result.error = "cannot read golden trace " + path;
+			return;
+		}
+		for (std::size_t frame = 0; frame < std::max(hashes.size(), golden.size()); ++frame) {
+			if (frame < hashes.size() && frame < golden.size() && hashes[frame].exact == golden[frame].exact) {
+				continue;
+			}
+			++result.mismatched_frames;
+			if (result.first_mismatch < 0) {
+				result.first_mismatch = static_cast<long>(frame);
+			}
+			if (frame < hashes.size() && frame < golden.size()) {
+				result.max_perceptual_distance =
+					std::max(result.max_perceptual_distance,
+							 nes::perceptual_distance(hashes[frame].perceptual, golden[frame].perceptual));
+			}
+		}
+	}
+	result.ok = true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	std::string rom_path;
+	std::vector<RunSource> sources;
+	BatchOptions options;
+	long instances = 1;
+	long threads = 0;
+	std::string accuracy_db_path;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--frames" && i + 1 < argc) {
+			options.frames = std::strtol(argv[++i], nullptr, 10);
+			options.frames_given = true;
+		} else if (arg == "--instances" && i + 1 < argc) {
+			instances = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--threads" && i + 1 < argc) {
+			threads = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--movie" && i + 1 < argc) {
+			sources.push_back({RunSource::Kind::Movie, argv[++i]});
+		} else if (arg == "--input" && i + 1 < argc) {
+			sources.push_back({RunSource::Kind::Replay, argv[++i]});
+		} else if (arg == "--ram-dir" && i + 1 < argc) {
+			options.ram_dir = argv[++i];
+		} else if (arg == "--screenshot-dir" && i + 1 < argc) {
+			options.screenshot_dir = argv[++i];
+		} else if (arg == "--capture-dir" && i + 1 < argc) {
+			options.capture_dir = argv[++i];
+		} else if (arg == "--frame-hashes" && i + 1 < argc) {
+			options.hash_dir = argv[++i];
+		} else if (arg == "--golden" && i + 1 < argc) {
+			options.golden_dir = argv[++i];
+		} else if (arg == "--accuracy-db" && i + 1 < argc) {
+			accuracy_db_path = argv[++i];
+		} else if (arg == "--help" || arg == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else if (rom_path.empty() && !arg.starts_with("--")) {
+			rom_path = arg;
+		} else {
+			print_usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (rom_path.empty() || options.frames < 0 || instances <= 0 || threads < 0) {
+		print_usage(argv[0]);
+		return 2;
+	}
+	if (sources.empty()) {
+		sources.push_back({});
+	}
+
+	// Mapped once and shared read-only by every job's cartridge
+	const std::shared_ptr<const nes::RomImage> rom = nes::RomImage::load(rom_path);
+	if (!rom) {
+		std::cerr << "Failed to load ROM: " << rom_path << "\n";
+		return 1;
+	}
+	if (!accuracy_db_path.empty()) {
+		nes::AccuracyDatabase database;
+		if (!database.load(accuracy_db_path)) {
+			std::cerr << "Failed to load accuracy database: " << accuracy_db_path << "\n";
+			return 1;
+		}
+		options.accuracy = database.lookup(rom->prg_crc32());
+	}
+
+	const std::size_t job_count = sources.size() * static_cast<std::size_t>(instances);
+	std::vector<JobResult> results(job_count);
+	std::vector<nes::BatchRunner::Job> jobs;
+	jobs.reserve(job_count);
+	for (std::size_t job = 0; job < job_count; ++job) {
+		const RunSource &source = sources[job / static_cast<std::size_t>(instances)];
+		jobs.push_back([&rom, &source, &options, &results, job] { run_job(rom, source, options, job, results[job]); });
+	}
+
+	nes::BatchRunner runner(static_cast<unsigned>(threads));
+	const auto start = Clock::now();
+	runner.run(std::move(jobs));
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	int status = 0;
+	uint64_t total_frames = 0;
+	std::size_t golden_failures = 0;
+	for (std::size_t job = 0; job < job_count; ++job) {
+		const JobResult &result = results[job];
+		const RunSource &source = sources[job / static_cast<std::size_t>(instances)];
+		std::cout << "job " << job << " (" << (source.path.empty() ? "power-on" : source.path) << ")";
+		if (!result.ok) {
+			std::cout << " failed: " << result.error << "\n";
+			status = 1;
+			continue;
+		}
+		std::cout << " frames: " << result.frames << " cpu_cycles: " << result.cpu_cycles << " frame_hash: " << std::hex
+				  << result.frame_hash << std::dec;
+		total_frames += result.frames;
+		if (result.mismatched_frames != 0) {
+			std::cout << " golden_mismatch: " << result.mismatched_frames << " frames from frame "
+					  << result.first_mismatch << " (perceptual distance up to " << result.max_perceptual_distance
+					  << ")";
+			status = 1;
+			++golden_failures;
+		}
+		std::cout << "\n";
+	}
+	std::cout << "jobs: " << job_count << "\n";
+	std::cout << "accuracy: " << nes::accuracy_name(options.accuracy) << "\n";
+	if (!options.golden_dir.empty()) {
+		std::cout << "golden_failures: " << golden_failures << "\n";
+	}
+	std::cout << "threads: " << std::min<std::size_t>(runner.thread_count(), job_count) << "\n";
+	std::cout << "steals: " << runner.get_steal_count() << "\n";
+	std::cout << "seconds: " << seconds << "\n";
+	std::cout << "frames_per_second: " << (seconds > 0.0 ? static_cast<double>(total_frames) / seconds : 0.0) << "\n";
+	return status;
+}
@@ -0,0 +1,215 @@
+// VibeNES_Bench - reproducible emulation throughput numbers.
+//
+// Usage: VibeNES_Bench <rom.nes> [--frames N] [--runs R] [--input replay.txt]
+//                      [--no-profile] [--output result.json] [--simd LEVEL]
+//
+// Each run reloads the ROM and executes N frames back to back with no frame
+// pacing (the GUI's process_continuous_emulation throttle is not involved).
+// The fastest run is reported. A final profiled run times every
+// SystemBus::tick_single_cpu_cycle per component; that run is slower, so only
+// its relative split is meaningful. Results are written as JSON, including
+// the SIMD level the kernels ran at (--simd pins it, as in VibeNES_Headless).
+
+#include "core/bus.hpp"
+#include "core/simd.hpp"
+#include "input/replay_input.hpp"
+#include "system/headless_system.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RunResult {
+	uint64_t frames = 0;
+	uint64_t cpu_cycles = 0;
+	double seconds = 0.0;
+	nes::CycleProfile profile{};
+};
+
+void print_usage(const char *program) {
+	std::cerr << "Usage: " << program
+			  << " <rom.nes> [--frames N] [--runs R] [--input replay.txt] [--no-profile] [--output result.json]"
+			  << " [--simd LEVEL]\n";
+}
+
+bool run_once(const std::string &rom_path, const std::string &input_path, long frames, bool profile,
+			  RunResult &result) {
+	auto replay = std::make_shared<nes::ReplayInputSource>();
+	if (!input_path.empty() && !replay->load_from_file(input_path)) {
+		return false;
+	}
+
+	nes::HeadlessSystem system(replay);
+	if (!system.load_rom(rom_path)) {
+		std::cerr << "Failed to load ROM: " << rom_path << "\n";
+		return false;
+	}
+	system.bus().set_cycle_profiling(profile);
+
+	result = RunResult{};
+	const auto start = Clock::now();
+	for (long frame = 0; frame < frames; ++frame) {
+		replay->set_frame(static_cast<uint64_t>(frame));
+		const uint64_t cycles = system.run_frame();
+		if (cycles == 0) {
+			std::cerr << "CPU stalled at frame " << frame << "\n";
+			break;
+		}
+		result.cpu_cycles += cycles;
+		result.frames++;
+	}
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	result.profile = system.bus().get_cycle_profile();
+	return true;
+}
+
+double share(uint64_t part_ns, double total_seconds) {
+	return total_seconds > 0.0 ? static_cast<double>(part_ns) / (total_seconds * 1e9) : 0.0;
+}
+
+std::string to_json(const std::string &rom_path, const std::vector<RunResult> &runs, const RunResult &best,
+					const RunResult *profiled) {
+	std::ostringstream json;
+	json << std::fixed << std::setprecision(3);
+
+	const double fps = best.seconds > 0.0 ? static_cast<double>(best.frames) / best.seconds : 0.0;
+	const double cps = best.seconds > 0.0 ? static_cast<double>(best.cpu_cycles) / best.seconds : 0.0;
+	const double ns_per_cycle = best.cpu_cycles > 0 ? best.seconds * 1e9 / static_cast<double>(best.cpu_cycles) : 0.0;
+
+	std::string escaped;
+	for (char c : rom_path) {
+		if (c == '"' || c == '\\') {
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+
+	json << "{\n";
+	json << "  \"rom\": \"" << escaped << "\",\n";
+	json << "  \"simd\": \"" << nes::simd_level_name(nes::simd_level()) << "\",\n";
+	json << "  \"frames\": " << best.frames << ",\n";
+	json << "  \"cpu_cycles\": " << best.cpu_cycles << ",\n";
+	json << "  \"seconds\": " << best.seconds << ",\n";
+	json << "  \"frames_per_second\": " << fps << ",\n";
+	json << "  \"cpu_cycles_per_second\": " << cps << ",\n";
+	json << "  \"ns_per_cpu_cycle\": " << ns_per_cycle << ",\n";
+	json << "  \"runs_fps\": [";
+	for (std::size_t i = 0; i < runs.size(); ++i) {
+		const double run_fps = runs[i].seconds > 0.0 ? static_cast<double>(runs[i].frames) / runs[i].seconds : 0.0;
+		json << (i ? ", " : "") << run_fps;
+	}
+	json << "]";
+
+	if (profiled) {
+		// CPU share is everything outside tick_single_cpu_cycle
+		const nes::CycleProfile &p = profiled->profile;
+		const double tick_ns = p.cycles > 0 ? static_cast<double>(p.tick_ns) / static_cast<double>(p.cycles) : 0.0;
+		const double cpu_share = std::max(0.0, 1.0 - share(p.tick_ns, profiled->seconds));
+		json << ",\n  \"profile\": {\n";
+		json << "    \"seconds\": " << profiled->seconds << ",\n";
+		json << "    \"ns_per_tick_single_cpu_cycle\": " << tick_ns << ",\n";
+		json << "    \"share\": {\n";
+		json << "      \"cpu\": " << cpu_share << ",\n";
+		json << "      \"ppu_tick_dots\": " << share(p.ppu_ns, profiled->seconds) << ",\n";
+		json << "      \"apu_step_cpu_cycles\": " << share(p.apu_ns, profiled->seconds) << ",\n";
+		json << "      \"cartridge_and_irq\": " << share(p.cartridge_ns, profiled->seconds) << "\n";
+		json << "    }\n";
+		json << "  }";
+	}
+	json << "\n}\n";
+	return json.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	std::string rom_path;
+	std::string input_path;
+	std::string output_path;
+	long frames = 600;
+	long runs = 3;
+	bool profile = true;
+	std::string simd;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--frames" && i + 1 < argc) {
+			frames = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--runs" && i + 1 < argc) {
+			runs = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--input" && i + 1 < argc) {
+			input_path = argv[++i];
+		} else if (arg == "--output" && i + 1 < argc) {
+			output_path = argv[++i];
+		} else if (arg == "--simd" && i + 1 < argc) {
+			simd = argv[++i];
+		} else if (arg.starts_with("--simd=")) {
+			simd = arg.substr(7);
+		} else if (arg == "--no-profile") {
+			profile = false;
+		} else if (arg == "--help" || arg == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else if (rom_path.empty() && !arg.starts_with("--")) {
+			rom_path = arg;
+		} else {
+			print_usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (rom_path.empty() || frames <= 0 || runs <= 0) {
+		print_usage(argv[0]);
+		return 2;
+	}
+
+	if (!simd.empty()) {
+		const std::optional<nes::SimdLevel> level = nes::parse_simd_level(simd);
+		if (!level || !nes::set_simd_level(*level)) {
+			std::cerr << "SIMD level not available: " << simd << " (best: "
+					  << nes::simd_level_name(nes::best_simd_level()) << ")\n";
+			return 2;
+		}
+	}
+
+	std::vector<RunResult> results;
+	for (long run = 0; run < runs; ++run) {
+		RunResult result;
+		if (!run_once(rom_path, input_path, frames, false, result)) {
+			return 1;
+		}
+		results.push_back(result);
+	}
+	const RunResult best =
+		*std::min_element(results.begin(), results.end(), [](const RunResult &a, const RunResult &b) {
+			return a.seconds * static_cast<double>(b.frames) < b.seconds * static_cast<double>(a.frames);
+		});
+
+	RunResult profiled;
+	if (profile && !run_once(rom_path, input_path, frames, true, profiled)) {
+		return 1;
+	}
+
+	const std::string json = to_json(rom_path, results, best, profile ? &profiled : nullptr);
+	std::cout << json;
+	if (!output_path.empty()) {
+		std::ofstream out(output_path);
+		if (!out || !(out << json)) {
+			std::cerr << "Failed to write " << output_path << "\n";
+			return 1;
+		}
+	}
+	return 0;
+}
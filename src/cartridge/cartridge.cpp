@@ -1,13 +1,64 @@
 #include "cartridge/cartridge.hpp"
+#include "apu/apu.hpp"
 #include "cartridge/mapper_factory.hpp"
+#include "cartridge/mappers/mapper_000.hpp"
+#include "cartridge/mappers/mapper_001.hpp"
+#include "cartridge/mappers/mapper_002.hpp"
+#include "cartridge/mappers/mapper_003.hpp"
+#include "cartridge/mappers/mapper_004.hpp"
+#include <algorithm>
 #include <iostream>
 
 namespace nes {
 
+// Calls fn with the mapper. In VIBENES_DEVIRTUALIZED_MAPPERS builds a built-in
+// mapper is passed as its own (final) class, so the calls fn makes bind
+// directly - and inline into it under LTO - instead of going through the
+// vtable; one predictable switch replaces an indirect call per access.
+// Mappers added without a case here keep working through the base class.
+template <typename Fn> decltype(auto) Cartridge::with_mapper(Fn &&fn) const {
+#ifdef VIBENES_DEVIRTUALIZED_MAPPERS
+	switch (mapper_kind_) {
+	case MapperKind::Nrom:
+		return fn(static_cast<Mapper000 &>(*mapper_));
+	case MapperKind::Mmc1:
+		return fn(static_cast<Mapper001 &>(*mapper_));
+	case MapperKind::Uxrom:
+		return fn(static_cast<Mapper002 &>(*mapper_));
+	case MapperKind::Cnrom:
+		return fn(static_cast<Mapper003 &>(*mapper_));
+	case MapperKind::Mmc3:
+		return fn(static_cast<Mapper004 &>(*mapper_));
+	case MapperKind::Other:
+		break;
+	}
+#endif
+	return fn(static_cast<Mapper &>(*mapper_));
+}
+
+Cartridge::MapperKind Cartridge::classify_mapper(const Mapper *mapper) noexcept {
+	if (dynamic_cast<const Mapper000 *>(mapper)) {
+		return MapperKind::Nrom;
+	}
+	if (dynamic_cast<const Mapper001 *>(mapper)) {
+		return MapperKind::Mmc1;
+	}
+	if (dynamic_cast<const Mapper002 *>(mapper)) {
+		return MapperKind::Uxrom;
+	}
+	if (dynamic_cast<const Mapper003 *>(mapper)) {
+		return MapperKind::Cnrom;
+	}
+	if (dynamic_cast<const Mapper004 *>(mapper)) {
+		return MapperKind::Mmc3;
+	}
+	return MapperKind::Other;
+}
+
 void Cartridge::tick(CpuCycle cycles) {
-	// Per-cycle mapper notification — inline early-out version shared with
-	// the bus hot path.
-	notify_cpu_cycles(static_cast<int>(cycles.count()));
+	// Nothing to step: timing-sensitive mappers get the CPU cycle with each
+	// write (cpu_write_at) and cycle IRQ counters run in spans from the bus
+	(void)cycles;
 }
 
 void Cartridge::reset() {
@@ -26,55 +77,80 @@ const char *Cartridge::get_name() const noexcept {
 	return "Cartridge";
 }
 
-bool Cartridge::load_rom(const std::string &filepath) {
-	// Flush battery RAM for the outgoing cartridge (filename + mapper still valid)
-	// before its RomData/mapper are replaced below.
-	if (pre_swap_hook_ && mapper_) {
-		pre_swap_hook_();
+const RomData &Cartridge::get_rom_data() const noexcept {
+	static const RomData no_rom{};
+	return image_ ? image_->header() : no_rom;
+}
+
+Region Cartridge::get_region() const noexcept {
+	switch (get_rom_data().timing) {
+	case TimingRegion::Pal:
+		return Region::Pal;
+	case TimingRegion::Dendy:
+		return Region::Dendy;
+	default:
+		return Region::Ntsc;
 	}
+}
 
-	// Load ROM data using RomLoader
-	rom_data_ = RomLoader::load_rom(filepath);
-	if (!rom_data_.valid) {
+bool Cartridge::load_rom(const std::string &filepath) {
+	std::shared_ptr<const RomImage> image = RomImage::load(filepath);
+	if (!image) {
 		std::cerr << "Failed to load ROM: " << filepath << std::endl;
 		return false;
 	}
+	return load_rom_image(std::move(image));
+}
 
-	// Create appropriate mapper using MapperFactory
-	mapper_ = MapperFactory::create_mapper(rom_data_);
-	if (!mapper_) {
-		std::cerr << "Unsupported mapper: " << static_cast<int>(rom_data_.mapper_id) << std::endl;
-		rom_data_ = {}; // Clear invalid data
+bool Cartridge::load_from_rom_data(const RomData &rom_data) {
+	std::shared_ptr<const RomImage> image = RomImage::from_rom_data(rom_data);
+	if (!image) {
+		std::cerr << "Invalid ROM data provided" << std::endl;
 		return false;
 	}
-	mapper_wants_cycle_notify_ = mapper_->wants_cpu_cycle_notifications();
+	return load_rom_image(std::move(image));
+}
 
-	return true;
+bool Cartridge::load_rom_image(std::shared_ptr<const RomImage> image) {
+	if (!image) {
+		return false;
+	}
+	// Create appropriate mapper using MapperFactory; it reads the image's ROM
+	// in place, so the image is kept for as long as the mapper
+	std::unique_ptr<Mapper> mapper = MapperFactory::create_mapper(*image);
+	if (!mapper) {
+		std::cerr << "Unsupported mapper: " << static_cast<int>(image->header().mapper_id) << std::endl;
+	}
+	return install_mapper(std::move(mapper), std::move(image));
 }
 
-bool Cartridge::load_from_rom_data(const RomData &rom_data) {
-	// Flush battery RAM for the outgoing cartridge before replacing it.
+bool Cartridge::load_mapper(std::unique_ptr<Mapper> mapper) {
+	return mapper && install_mapper(std::move(mapper), nullptr);
+}
+
+bool Cartridge::install_mapper(std::unique_ptr<Mapper> mapper, std::shared_ptr<const RomImage> image) {
+	// Flush battery RAM for the outgoing cartridge (filename + mapper still valid)
+	// before its image/mapper are replaced below.
 	if (pre_swap_hook_ && mapper_) {
 		pre_swap_hook_();
 	}
 
-	// Validate ROM data
-	if (!rom_data.valid) {
-		std::cerr << "Invalid ROM data provided" << std::endl;
-		return false;
-	}
-
-	// Store ROM data
-	rom_data_ = rom_data;
-
-	// Create appropriate mapper using MapperFactory
-	mapper_ = MapperFactory::create_mapper(rom_data_);
+	++load_id_;
+	mapper_ = std::move(mapper);
+	mapper_kind_ = classify_mapper(mapper_.get());
+	prg_page_table_ = (mapper_ && mapper_->has_prg_page_table()) ? &mapper_->prg_page_table() : nullptr;
 	if (!mapper_) {
-		std::cerr << "Unsupported mapper: " << static_cast<int>(rom_data_.mapper_id) << std::endl;
-		rom_data_ = {}; // Clear invalid data
+		image_.reset();
+		cache_mapper_traits();
+		attach_cdl();
 		return false;
 	}
-	mapper_wants_cycle_notify_ = mapper_->wants_cpu_cycle_notifications();
+	image_ = std::move(image);
+	cache_mapper_traits();
+	if (ciram_) {
+		mapper_->attach_ciram(ciram_);
+	}
+	attach_cdl();
 
 	return true;
 }
@@ -85,37 +161,99 @@ void Cartridge::unload_rom() {
 		pre_swap_hook_();
 	}
 
+	++load_id_;
 	mapper_.reset();
-	rom_data_ = {};
-	mapper_wants_cycle_notify_ = false;
+	mapper_kind_ = MapperKind::Other;
+	image_.reset();
+	prg_page_table_ = nullptr;
+	cache_mapper_traits();
+	attach_cdl();
+}
+
+void Cartridge::cache_mapper_traits() {
+	mapper_has_cycle_timer_ = mapper_ && mapper_->has_cpu_cycle_timer();
+	mapper_wants_ppu_notify_ = mapper_ && mapper_->wants_ppu_notifications();
+	if (apu_) {
+		apu_->set_expansion_audio(mapper_ ? mapper_->expansion_audio() : nullptr);
+	}
+}
+
+void Cartridge::connect_apu(APU *apu) {
+	if (apu_ && apu_ != apu) {
+		apu_->set_expansion_audio(nullptr);
+	}
+	apu_ = apu;
+	if (apu_) {
+		apu_->set_expansion_audio(mapper_ ? mapper_->expansion_audio() : nullptr);
+	}
 }
 
 Byte Cartridge::cpu_read(Address address) const {
 	if (!mapper_) {
 		return 0xFF; // No ROM loaded
 	}
-	return mapper_->cpu_read(address);
+	return with_mapper([address](auto &mapper) { return mapper.cpu_read(address); });
 }
 
 void Cartridge::cpu_write(Address address, Byte value) {
 	if (!mapper_) {
 		return; // No ROM loaded
 	}
-	mapper_->cpu_write(address, value);
+	with_mapper([address, value](auto &mapper) { mapper.cpu_write(address, value); });
 }
 
-Byte Cartridge::ppu_read(Address address) const {
+void Cartridge::cpu_write_at(Address address, Byte value, std::uint64_t cpu_cycle) {
+	if (!mapper_) {
+		return;
+	}
+	with_mapper([address, value, cpu_cycle](auto &mapper) { mapper.cpu_write_at(address, value, cpu_cycle); });
+}
+
+Byte Cartridge::ppu_read(Address address, Byte cdl_flags) const {
 	if (!mapper_) {
 		return 0xFF; // No ROM loaded
 	}
-	return mapper_->ppu_read(address);
+	if (cdl_active_) [[unlikely]] {
+		cdl_active_->log_chr(mapper_->chr_tile_cache().slot_source((address >> 10) & 0x07), address, cdl_flags);
+	}
+	return with_mapper([address](auto &mapper) { return mapper.ppu_read(address); });
+}
+
+void Cartridge::attach_ciram(Byte *ciram) {
+	ciram_ = ciram;
+	if (mapper_) {
+		mapper_->attach_ciram(ciram_);
+	}
+}
+
+void Cartridge::set_cdl_enabled(bool enabled) {
+	if (enabled == cdl_enabled_) {
+		return;
+	}
+	cdl_enabled_ = enabled;
+	if (enabled) {
+		attach_cdl();
+	} else {
+		cdl_active_ = nullptr; // Keeps what was logged so far
+	}
+}
+
+void Cartridge::attach_cdl() {
+	if (!cdl_enabled_) {
+		return;
+	}
+	// Only ROM is logged: CHR RAM carts get an empty CHR section
+	const bool chr_rom = mapper_ && image_ && image_->header().chr_rom_pages > 0;
+	cdl_.attach(mapper_ ? mapper_->prg_rom_data() : std::span<const Byte>{},
+				chr_rom ? mapper_->chr_tile_cache().chr_memory() : std::span<const Byte>{});
+	cdl_active_ = mapper_ ? &cdl_ : nullptr;
 }
 
 void Cartridge::ppu_write(Address address, Byte value) {
 	if (!mapper_) {
 		return; // No ROM loaded
 	}
-	mapper_->ppu_write(address, value);
+	with_mapper([address, value](auto &mapper) { mapper.ppu_write(address, value); });
 }
 
 std::uint8_t Cartridge::get_mapper_id() const noexcept {
@@ -141,10 +279,18 @@ Mapper::Mirroring Cartridge::get_mirroring() const noexcept {
 
 void Cartridge::ppu_a12_toggle() const {
 	if (mapper_) {
-		mapper_->ppu_a12_toggle();
+		with_mapper([](auto &mapper) { mapper.ppu_a12_toggle(); });
 	}
 }
 
+void Cartridge::ppu_scanline_start(int scanline, bool rendering) const {
+	mapper_->ppu_scanline_start(scanline, rendering);
+}
+
+void Cartridge::ppu_fetch_phase(bool sprites, bool tall_sprites) const {
+	mapper_->ppu_fetch_phase(sprites, tall_sprites);
+}
+
 // is_irq_pending() / clear_irq() are inline in the header (per-cycle hot path)
 
 // Save state serialization
@@ -152,6 +298,7 @@ void Cartridge::serialize_state(std::vector<uint8_t> &buffer) const {
 	// Serialize mapper state (includes PRG RAM, CHR RAM, and mapper registers)
 	if (mapper_) {
 		mapper_->serialize_state(buffer);
+		serialize_vram(buffer);
 	}
 }
 
@@ -159,6 +306,35 @@ void Cartridge::deserialize_state(const std::vector<uint8_t> &buffer, size_t &of
 	// Deserialize mapper state
 	if (mapper_) {
 		mapper_->deserialize_state(buffer, offset);
+		deserialize_vram(buffer, offset);
+	}
+}
+
+void Cartridge::serialize_registers(std::vector<uint8_t> &buffer) const {
+	if (mapper_) {
+		mapper_->serialize_registers(buffer);
+		serialize_vram(buffer);
+	}
+}
+
+void Cartridge::deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset) {
+	if (mapper_) {
+		mapper_->deserialize_registers(buffer, offset);
+		deserialize_vram(buffer, offset);
+	}
+}
+
+void Cartridge::serialize_vram(std::vector<uint8_t> &buffer) const {
+	// Four-screen nametable RAM last, so states without it still load
+	const std::span<const Byte> vram = mapper_->cartridge_vram();
+	buffer.insert(buffer.end(), vram.begin(), vram.end());
+}
+
+void Cartridge::deserialize_vram(const std::vector<uint8_t> &buffer, size_t &offset) {
+	const std::span<Byte> vram = mapper_->cartridge_vram();
+	if (!vram.empty() && buffer.size() - offset >= vram.size()) {
+		std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), vram.size(), vram.begin());
+		offset += vram.size();
 	}
 }
 
@@ -0,0 +1,126 @@
+#include "cartridge/chr_tile_cache.hpp"
+#include <functional>
+
+namespace nes {
+
+namespace {
+
+// Spread the 8 bits of a bitplane byte into the low bit of 8 bytes. MSB is
+// the leftmost pixel; the reversed table gives the horizontally flipped row.
+constexpr std::array<std::uint64_t, 256> make_spread_table(bool reversed) {
+	std::array<std::uint64_t, 256> table{};
+	for (int value = 0; value < 256; ++value) {
+		std::uint64_t spread = 0;
+		for (int x = 0; x < 8; ++x) {
+			const int bit = reversed ? x : 7 - x;
+			if ((value >> bit) & 1) {
+				spread |= std::uint64_t{1} << (x * 8);
+			}
+		}
+		table[value] = spread;
+	}
+	return table;
+}
+
+constexpr auto SPREAD = make_spread_table(false);
+constexpr auto SPREAD_FLIPPED = make_spread_table(true);
+
+} // namespace
+
+ChrTileCache::ChrTileCache() {
+	// Until a mapper maps real memory, every slot reads as blank tiles
+	static const Page blank_page{};
+	slot_pages_.fill(&blank_page);
+}
+
+ChrTileCache::Row ChrTileCache::decode_row(Byte low, Byte high) noexcept {
+	return SPREAD[low] | (SPREAD[high] << 1);
+}
+
+ChrTileCache::Row ChrTileCache::decode_row_flipped(Byte low, Byte high) noexcept {
+	return SPREAD_FLIPPED[low] | (SPREAD_FLIPPED[high] << 1);
+}
+
+void ChrTileCache::decode_page(Page &page, const Byte *source) noexcept {
+	for (std::size_t tile = 0; tile < PAGE_SIZE / 16; ++tile) {
+		const Byte *tile_data = source + tile * 16;
+		for (std::size_t y = 0; y < 8; ++y) {
+			page.rows[tile * 8 + y] = decode_row(tile_data[y], tile_data[y + 8]);
+			page.flipped[tile * 8 + y] = decode_row_flipped(tile_data[y], tile_data[y + 8]);
+		}
+	}
+	page.valid = true;
+}
+
+void ChrTileCache::attach(std::span<const Byte> chr_memory) {
+	chr_ = chr_memory.data();
+	chr_size_ = chr_memory.size();
+	pages_.clear();
+	pages_.resize(chr_size_ / PAGE_SIZE);
+	slot_sources_.fill(nullptr);
+}
+
+void ChrTileCache::map_slots(const std::array<const Byte *, SLOT_COUNT> &slots) {
+	for (std::size_t slot = 0; slot < SLOT_COUNT; ++slot) {
+		const Byte *source = slots[slot];
+		if (source == slot_sources_[slot]) {
+			continue; // Bank unchanged
+		}
+		slot_sources_[slot] = source;
+
+		// std::less gives a total order even for pointers into other objects
+		const bool inside = chr_ != nullptr && !std::less<const Byte *>{}(source, chr_) &&
+							std::less<const Byte *>{}(source, chr_ + chr_size_);
+		if (inside) {
+			const std::size_t offset = static_cast<std::size_t>(source - chr_);
+			if (offset % PAGE_SIZE == 0 && offset / PAGE_SIZE < pages_.size()) {
+				auto &page = pages_[offset / PAGE_SIZE];
+				if (!page) {
+					page = std::make_unique<Page>();
+				}
+				if (!page->valid) {
+					decode_page(*page, source);
+				}
+				slot_pages_[slot] = page.get();
+				continue;
+			}
+		}
+
+		auto &page = foreign_pages_[slot];
+		if (!page) {
+			page = std::make_unique<Page>();
+		}
+		decode_page(*page, source);
+		slot_pages_[slot] = page.get();
+	}
+}
+
+void ChrTileCache::invalidate(std::size_t chr_offset) noexcept {
+	const std::size_t index = chr_offset / PAGE_SIZE;
+	if (chr_offset >= chr_size_ || index >= pages_.size() || !pages_[index] || !pages_[index]->valid) {
+		return; // Not decoded yet — picked up when the page is first mapped
+	}
+
+	// Re-decode just the row the byte belongs to (either bitplane)
+	const std::size_t row_start = (chr_offset & ~std::size_t{0x0F}) | (chr_offset & 0x07);
+	const Byte low = chr_[row_start];
+	const Byte high = chr_[row_start + 8];
+	Page &page = *pages_[index];
+	const std::size_t row = row_index(static_cast<Address>(chr_offset & 0x03FF));
+	page.rows[row] = decode_row(low, high);
+	page.flipped[row] = decode_row_flipped(low, high);
+}
+
+void ChrTileCache::invalidate_all() {
+	for (auto &page : pages_) {
+		if (page) {
+			page->valid = false;
+		}
+	}
+	// Force the current mapping to re-decode
+	const auto sources = slot_sources_;
+	slot_sources_.fill(nullptr);
+	map_slots(sources);
+}
+
+} // namespace nes
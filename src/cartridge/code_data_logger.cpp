@@ -0,0 +1,79 @@
+#include "cartridge/code_data_logger.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace nes {
+
+void CodeDataLogger::attach(std::span<const Byte> prg, std::span<const Byte> chr) {
+	prg_base_ = reinterpret_cast<std::uintptr_t>(prg.data());
+	chr_base_ = reinterpret_cast<std::uintptr_t>(chr.data());
+	prg_log_.assign(prg.size(), 0);
+	chr_log_.assign(chr.size(), 0);
+}
+
+void CodeDataLogger::clear() {
+	std::fill(prg_log_.begin(), prg_log_.end(), Byte{0});
+	std::fill(chr_log_.begin(), chr_log_.end(), Byte{0});
+}
+
+CodeDataLogger::Coverage CodeDataLogger::coverage() const noexcept {
+	Coverage coverage;
+	coverage.prg_size = prg_log_.size();
+	for (const Byte flags : prg_log_) {
+		coverage.prg_logged += flags != 0;
+		coverage.prg_code += (flags & PRG_CODE) != 0;
+		coverage.prg_data += (flags & PRG_DATA) != 0;
+		coverage.prg_pcm += (flags & PRG_PCM) != 0;
+	}
+	coverage.chr_size = chr_log_.size();
+	for (const Byte flags : chr_log_) {
+		coverage.chr_logged += flags != 0;
+		coverage.chr_rendered += (flags & CHR_RENDERED) != 0;
+		coverage.chr_read += (flags & CHR_READ) != 0;
+	}
+	return coverage;
+}
+
+bool CodeDataLogger::save(const std::filesystem::path &path) const {
+	std::error_code ec;
+	if (path.has_parent_path()) {
+		std::filesystem::create_directories(path.parent_path(), ec);
+	}
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		std::cerr << "CDL: cannot write " << path.string() << std::endl;
+		return false;
+	}
+	file.write(reinterpret_cast<const char *>(prg_log_.data()), static_cast<std::streamsize>(prg_log_.size()));
+	file.write(reinterpret_cast<const char *>(chr_log_.data()), static_cast<std::streamsize>(chr_log_.size()));
+	return static_cast<bool>(file);
+}
+
+bool CodeDataLogger::load(const std::filesystem::path &path) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	const auto size = static_cast<std::size_t>(file.tellg());
+	if (size != prg_log_.size() + chr_log_.size()) {
+		std::cerr << "CDL: " << path.string() << " does not match the loaded ROM" << std::endl;
+		return false;
+	}
+	std::vector<Byte> logged(size);
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char *>(logged.data()), static_cast<std::streamsize>(size))) {
+		std::cerr << "CDL: failed to read " << path.string() << std::endl;
+		return false;
+	}
+	for (std::size_t i = 0; i < prg_log_.size(); ++i) {
+		prg_log_[i] |= logged[i];
+	}
+	for (std::size_t i = 0; i < chr_log_.size(); ++i) {
+		chr_log_[i] |= logged[prg_log_.size() + i];
+	}
+	return true;
+}
+
+} // namespace nes
@@ -4,20 +4,27 @@
 #include "cartridge/mappers/mapper_002.hpp"
 #include "cartridge/mappers/mapper_003.hpp"
 #include "cartridge/mappers/mapper_004.hpp"
+#include "cartridge/mappers/mapper_005.hpp"
+#include "cartridge/mappers/mapper_021.hpp"
+#include "cartridge/mappers/mapper_024.hpp"
+#include "cartridge/mappers/mapper_069.hpp"
+#include "cartridge/mappers/mapper_085.hpp"
 #include <iostream>
 
 namespace nes {
 
-std::unique_ptr<Mapper> MapperFactory::create_mapper(const RomData &rom_data) {
+std::unique_ptr<Mapper> MapperFactory::create_mapper(const RomImage &image) {
+	const RomData &rom_data = image.header();
 	// Get mirroring mode from ROM data
 	Mapper::Mirroring mirroring = get_mirroring_mode(rom_data);
+	const Mapper::RamSizes ram = get_ram_sizes(rom_data, 0x2000);
 
 	// Create mapper based on ID
 	switch (rom_data.mapper_id) {
 	case 0:
 		// Mapper 0 - NROM (No mapper)
 		// Used by: Super Mario Bros, Donkey Kong, Ice Climber, etc.
-		return std::make_unique<Mapper000>(rom_data.prg_rom, rom_data.chr_rom, mirroring);
+		return std::make_unique<Mapper000>(image.prg_rom(), image.chr_rom(), mirroring);
 
 	case 1: {
 		// Mapper 1 - MMC1 (SxROM)
@@ -25,21 +32,21 @@ std::unique_ptr<Mapper> MapperFactory::create_mapper(const RomData &rom_data) {
 		// Detect if CHR is RAM (no CHR ROM pages)
 		bool chr_is_ram = (rom_data.chr_rom_pages == 0);
 		// Most MMC1 games have PRG RAM; the iNES battery flag marks it as save RAM.
-		bool has_prg_ram = true; // MMC1 standard has 8KB PRG RAM
+		bool has_prg_ram = ram.prg_ram > 0; // 8KB unless a NES 2.0 header says otherwise
 
-		return std::make_unique<Mapper001>(rom_data.prg_rom, rom_data.chr_rom, mirroring, has_prg_ram, chr_is_ram,
-										   rom_data.battery_backed_ram);
+		return std::make_unique<Mapper001>(image.prg_rom(), image.chr_rom(), mirroring, has_prg_ram, chr_is_ram,
+										   rom_data.battery_backed_ram, ram);
 	}
 
 	case 2:
 		// Mapper 2 - UxROM
 		// Used by: Mega Man, Castlevania, Contra, The Guardian Legend, etc.
-		return std::make_unique<Mapper002>(rom_data.prg_rom, rom_data.chr_rom, mirroring);
+		return std::make_unique<Mapper002>(image.prg_rom(), image.chr_rom(), mirroring);
 
 	case 3:
 		// Mapper 3 - CNROM
 		// Used by: Arkanoid, Solomon's Key, Gradius, Paperboy, Q*bert, etc.
-		return std::make_unique<Mapper003>(rom_data.prg_rom, rom_data.chr_rom, mirroring);
+		return std::make_unique<Mapper003>(image.prg_rom(), image.chr_rom(), mirroring);
 
 	case 4: {
 		// Mapper 4 - MMC3 (TxROM)
@@ -47,15 +54,52 @@ std::unique_ptr<Mapper> MapperFactory::create_mapper(const RomData &rom_data) {
 		// Detect if CHR is RAM (no CHR ROM pages)
 		bool chr_is_ram = (rom_data.chr_rom_pages == 0);
 		// Most MMC3 games have PRG RAM; the iNES battery flag marks it as save RAM.
-		bool has_prg_ram = true; // MMC3 standard has 8KB PRG RAM
+		bool has_prg_ram = ram.prg_ram > 0; // 8KB unless a NES 2.0 header says otherwise
 
-		return std::make_unique<Mapper004>(rom_data.prg_rom, rom_data.chr_rom, mirroring, has_prg_ram, chr_is_ram,
-										   rom_data.battery_backed_ram);
+		return std::make_unique<Mapper004>(image.prg_rom(), image.chr_rom(), mirroring, has_prg_ram, chr_is_ram,
+										   rom_data.battery_backed_ram, ram);
 	}
 
+	case 5:
+		// Mapper 5 - MMC5 (ExROM)
+		// Used by: Castlevania III, Just Breed, Uncharted Waters, etc.
+		// iNES 1 doesn't say how much PRG-RAM is fitted; assume the full 64KB
+		return std::make_unique<Mapper005>(image.prg_rom(), image.chr_rom(), rom_data.battery_backed_ram,
+										   get_ram_sizes(rom_data, 0x10000));
+
+	case 21:
+	case 22:
+	case 23:
+	case 25:
+		// Mappers 21/22/23/25 - Konami VRC2/VRC4 (differ only in register address wiring)
+		// Used by: Gradius II, Ganbare Goemon 2, Contra (J), etc.
+		return std::make_unique<Mapper021>(rom_data.mapper_id, image.prg_rom(), image.chr_rom(), mirroring,
+										   rom_data.battery_backed_ram, ram);
+
+	case 24:
+	case 26:
+		// Mappers 24/26 - Konami VRC6a/VRC6b
+		// Used by: Akumajou Densetsu, Esper Dream 2, Madara
+		return std::make_unique<Mapper024>(rom_data.mapper_id, image.prg_rom(), image.chr_rom(), mirroring,
+										   rom_data.battery_backed_ram, ram);
+
+	case 69:
+		// Mapper 69 - Sunsoft FME-7 / 5B
+		// Used by: Batman: Return of the Joker, Gimmick!, etc.
+		return std::make_unique<Mapper069>(image.prg_rom(), image.chr_rom(), mirroring, rom_data.battery_backed_ram,
+										   ram);
+
+	case 85:
+		// Mapper 85 - Konami VRC7
+		// Used by: Lagrange Point, Tiny Toon Adventures 2 (J)
+		return std::make_unique<Mapper085>(image.prg_rom(), image.chr_rom(), mirroring, rom_data.battery_backed_ram,
+										   ram);
+
 	default:
 		std::cerr << "Unsupported mapper ID: " << static_cast<int>(rom_data.mapper_id) << std::endl;
-		std::cerr << "Currently supported mappers: 0 (NROM), 1 (MMC1), 2 (UxROM), 3 (CNROM), 4 (MMC3)" << std::endl;
+		std::cerr << "Currently supported mappers: 0 (NROM), 1 (MMC1), 2 (UxROM), 3 (CNROM), 4 (MMC3), 5 (MMC5), "
+					 "21-23/25 (VRC2/VRC4), 24/26 (VRC6), 69 (FME-7), 85 (VRC7)"
+				  << std::endl;
 		std::cerr << "To add support, implement the mapper class and add it to MapperFactory." << std::endl;
 		return nullptr;
 	}
@@ -71,4 +115,16 @@ Mapper::Mirroring MapperFactory::get_mirroring_mode(const RomData &rom_data) {
 	}
 }
 
+Mapper::RamSizes MapperFactory::get_ram_sizes(const RomData &rom_data, std::size_t ines_prg_ram) {
+	if (!rom_data.nes2_0) {
+		return {ines_prg_ram, 0x2000};
+	}
+	Mapper::RamSizes ram{};
+	ram.prg_ram = std::size_t{rom_data.prg_ram_size} + rom_data.prg_nvram_size;
+	// A CHR-RAM cart whose header declares none still needs its pattern tables
+	const std::size_t chr_ram = std::size_t{rom_data.chr_ram_size} + rom_data.chr_nvram_size;
+	ram.chr_ram = chr_ram > 0 ? chr_ram : 0x2000;
+	return ram;
+}
+
 } // namespace nes
@@ -0,0 +1,176 @@
+#include "cartridge/mappers/mapper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+namespace nes {
+
+namespace {
+
+std::uint64_t next_ram_owner() noexcept {
+	static std::atomic<std::uint64_t> next{1};
+	return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+Mapper::Mapper() : ram_owner_(next_ram_owner()) {
+}
+
+void Mapper::track_ram(RamKind kind, std::span<Byte> ram) {
+	ram_blocks_[static_cast<std::size_t>(kind)] = ram;
+	std::size_t pages = 0;
+	for (std::size_t block = 0; block < ram_blocks_.size(); ++block) {
+		ram_first_page_[block] = pages;
+		pages += (ram_blocks_[block].size() + RAM_PAGE_SIZE - 1) / RAM_PAGE_SIZE;
+	}
+	ram_pages_.assign(pages, ram_epoch_);
+	clear_battery_ram_dirty();
+}
+
+void Mapper::ram_rewritten() noexcept {
+	std::fill(ram_pages_.begin(), ram_pages_.end(), ram_epoch_);
+}
+
+bool Mapper::rebind_battery_ram(std::span<Byte> &ram, std::vector<Byte> &storage, std::span<Byte> backing) {
+	if (!has_battery_ram()) {
+		return false;
+	}
+	if (backing.empty()) {
+		if (ram.data() != storage.data()) {
+			std::copy(ram.begin(), ram.end(), storage.begin());
+		}
+		ram = storage;
+	} else {
+		if (backing.size() != storage.size()) {
+			return false;
+		}
+		ram = backing;
+	}
+	// Every page changed as far as snapshots can tell
+	track_ram(RamKind::Prg, ram);
+	return true;
+}
+
+void Mapper::serialize_state(std::vector<uint8_t> &buffer) const {
+	for (const std::span<Byte> block : ram_blocks_) {
+		buffer.insert(buffer.end(), block.begin(), block.end());
+	}
+	serialize_registers(buffer);
+}
+
+void Mapper::deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset) {
+	// Save files are untrusted input: check the RAM fits before copying it
+	if (offset > buffer.size() || buffer.size() - offset < tracked_ram_size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (cartridge RAM)");
+	}
+	for (const std::span<Byte> block : ram_blocks_) {
+		std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), block.size(), block.begin());
+		offset += block.size();
+	}
+	ram_rewritten();
+	deserialize_registers(buffer, offset);
+}
+
+// Both directions walk the pages of each block; the flat buffer has the
+// blocks back to back, the last page of a block may be short
+
+void Mapper::save_ram_pages(Byte *ram, RamPageMark &mark) const {
+	const bool synced = mark.mapper == ram_owner_;
+	std::size_t page = 0;
+	for (const std::span<Byte> block : ram_blocks_) {
+		for (std::size_t at = 0; at < block.size(); at += RAM_PAGE_SIZE, ++page) {
+			if (!synced || ram_pages_[page] > mark.epoch) {
+				std::memcpy(ram + at, block.data() + at, std::min(RAM_PAGE_SIZE, block.size() - at));
+			}
+		}
+		ram += block.size();
+	}
+	// Writes from here on stamp a later epoch than the mark
+	mark = {ram_owner_, ram_epoch_++};
+}
+
+void Mapper::load_ram_pages(const Byte *ram, const RamPageMark &mark) {
+	const bool synced = mark.mapper == ram_owner_;
+	std::size_t page = 0;
+	for (const std::span<Byte> block : ram_blocks_) {
+		for (std::size_t at = 0; at < block.size(); at += RAM_PAGE_SIZE, ++page) {
+			if (!synced || ram_pages_[page] > mark.epoch) {
+				std::memcpy(block.data() + at, ram + at, std::min(RAM_PAGE_SIZE, block.size() - at));
+				ram_pages_[page] = ram_epoch_; // Differs from snapshots synced before now
+			}
+		}
+		ram += block.size();
+	}
+}
+
+void Mapper::copy_ram_from(const Mapper &source) {
+	const bool synced = copied_from_ == source.ram_owner_ && ram_pages_.size() == source.ram_pages_.size();
+	std::size_t page = 0;
+	for (std::size_t kind = 0; kind < ram_blocks_.size(); ++kind) {
+		const std::span<Byte> to = ram_blocks_[kind];
+		const std::span<Byte> from = source.ram_blocks_[kind];
+		if (to.size() != from.size()) {
+			throw std::logic_error("copy_ram_from: cartridge RAM layouts differ");
+		}
+		for (std::size_t at = 0; at < to.size(); at += RAM_PAGE_SIZE, ++page) {
+			if (!synced || source.ram_pages_[page] > copied_source_epoch_ || ram_pages_[page] > copied_epoch_) {
+				std::memcpy(to.data() + at, from.data() + at, std::min(RAM_PAGE_SIZE, to.size() - at));
+				ram_pages_[page] = ram_epoch_;
+			}
+		}
+	}
+	copied_from_ = source.ram_owner_;
+	copied_source_epoch_ = source.ram_epoch_++;
+	copied_epoch_ = ram_epoch_++;
+}
+
+template <typename Visit> void Mapper::for_each_battery_page_after(std::uint32_t epoch, Visit &&visit) const {
+	if (!has_battery_ram()) {
+		return;
+	}
+	const std::size_t size = ram_blocks_[static_cast<std::size_t>(RamKind::Prg)].size();
+	const std::uint32_t *pages = ram_pages_.data() + ram_first_page_[static_cast<std::size_t>(RamKind::Prg)];
+	for (std::size_t at = 0, page = 0; at < size; at += RAM_PAGE_SIZE, ++page) {
+		if (pages[page] > epoch && !visit(RamRange{at, std::min(RAM_PAGE_SIZE, size - at)})) {
+			return;
+		}
+	}
+}
+
+bool Mapper::is_battery_ram_dirty() const noexcept {
+	bool dirty = false;
+	for_each_battery_page_after(battery_epoch_, [&](RamRange) {
+		dirty = true;
+		return false;
+	});
+	return dirty;
+}
+
+std::vector<Mapper::RamRange> Mapper::battery_ram_dirty_ranges() const {
+	std::vector<RamRange> ranges;
+	for_each_battery_page_after(battery_epoch_, [&](RamRange page) {
+		if (!ranges.empty() && ranges.back().offset + ranges.back().size == page.offset) {
+			ranges.back().size += page.size;
+		} else {
+			ranges.push_back(page);
+		}
+		return true;
+	});
+	return ranges;
+}
+
+bool Mapper::battery_ram_written_since(RamPageMark &mark) const noexcept {
+	bool written = mark.mapper != ram_owner_;
+	if (!written) {
+		for_each_battery_page_after(mark.epoch, [&](RamRange) {
+			written = true;
+			return false;
+		});
+	}
+	mark = {ram_owner_, ram_epoch_++};
+	return written;
+}
+
+} // namespace nes
@@ -3,8 +3,9 @@
 
 namespace nes {
 
-Mapper000::Mapper000(std::vector<Byte> prg_rom, std::vector<Byte> chr_rom, Mirroring mirroring)
-	: prg_rom_(std::move(prg_rom)), chr_rom_(std::move(chr_rom)), mirroring_(mirroring) {
+Mapper000::Mapper000(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring)
+	: prg_rom_(prg_rom), chr_rom_(chr_rom), mirroring_(mirroring) {
+	chr_cache_.attach(chr_rom_);
 	update_bank_maps();
 }
 
@@ -24,6 +25,7 @@ void Mapper000::update_bank_maps() {
 		std::size_t offset = slot * 1024;
 		chr_map_[slot] = (offset + 1024 <= chr_rom_.size()) ? chr_rom_.data() + offset : OPEN_BUS_PAGE.data();
 	}
+	chr_cache_.map_slots(chr_map_);
 }
 
 Byte Mapper000::cpu_read(Address address) const {
@@ -61,14 +63,14 @@ void Mapper000::reset() {
 }
 
 // Save state serialization
-void Mapper000::serialize_state(std::vector<uint8_t> &buffer) const {
+void Mapper000::serialize_registers(std::vector<uint8_t> &buffer) const {
 	// NROM has no mapper state (no registers, no RAM)
 	// CHR ROM is read-only, so we don't need to save it
 	// Nothing to serialize!
 	(void)buffer;
 }
 
-void Mapper000::deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset) {
+void Mapper000::deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset) {
 	// NROM has no mapper state to restore
 	// Nothing to deserialize!
 	(void)buffer;
@@ -4,30 +4,44 @@
 
 namespace nes {
 
-Mapper001::Mapper001(std::vector<Byte> prg_rom, std::vector<Byte> chr_mem, Mirroring mirroring, bool has_prg_ram,
-					 bool chr_is_ram, bool battery_backed)
-	: prg_rom_(std::move(prg_rom)), chr_mem_(std::move(chr_mem)), initial_mirroring_(mirroring),
-	  has_prg_ram_(has_prg_ram), chr_is_ram_(chr_is_ram), battery_backed_(battery_backed),
+Mapper001::Mapper001(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring,
+					 bool has_prg_ram, bool chr_is_ram, bool battery_backed, RamSizes ram)
+	: prg_rom_(prg_rom), initial_mirroring_(mirroring),
+	  has_prg_ram_(has_prg_ram && ram.prg_ram > 0), chr_is_ram_(chr_is_ram), battery_backed_(battery_backed),
 	  shift_register_(0x10),					// Initialize with bit 4 set
 	  shift_count_(0), control_register_(0x0C), // Default: last bank fixed, 8KB CHR
-	  chr_bank_0_(0), chr_bank_1_(0), prg_bank_(0), prg_ram_enabled_(true), cpu_cycle_counter_(0),
-	  last_write_cycle_(0) {
+	  chr_bank_0_(0), chr_bank_1_(0), prg_bank_(0), prg_ram_enabled_(true),
+	  last_write_cycle_(NO_WRITE_CYCLE) {
 
-	// Initialize PRG RAM if needed (8KB)
+	// Initialize PRG RAM if needed (8KB on most boards, 16KB SOROM, 32KB SXROM)
 	if (has_prg_ram_) {
-		prg_ram_.resize(8192, 0x00);
+		prg_ram_storage_.resize(ram.prg_ram, 0x00);
+		prg_ram_ = prg_ram_storage_;
+		prg_ram_mask_ = prg_ram_window_mask(ram.prg_ram);
 	}
 
-	// If CHR is RAM and the vector is empty, allocate 8KB CHR RAM.
+	// CHR ROM is read in place; CHR RAM is this instance's own copy. If CHR
+	// is RAM and nothing was provided, allocate the board's CHR RAM.
 	// Also guard against a malformed ROM declaring CHR ROM but providing no
-	// data: an empty CHR vector makes the 4KB bank count 0, and the
+	// data: an empty CHR region makes the 4KB bank count 0, and the
 	// `(bank_count - 1)` masks below would wrap to SIZE_MAX. Allocate a
 	// minimal 8KB region so bank math stays well-defined.
-	if (chr_mem_.empty()) {
-		chr_mem_.resize(8192, 0x00);
+	if (chr_rom.empty()) {
 		chr_is_ram_ = true;
 	}
+	if (chr_is_ram_) {
+		chr_ram_.assign(chr_rom.begin(), chr_rom.end());
+		if (chr_ram_.empty()) {
+			chr_ram_.resize(std::max<std::size_t>(ram.chr_ram, 8192), 0x00);
+		}
+		chr_mem_ = chr_ram_;
+	} else {
+		chr_mem_ = chr_rom;
+	}
+	track_ram(RamKind::Prg, prg_ram_);
+	track_ram(RamKind::Chr, chr_ram_);
 
+	chr_cache_.attach(chr_mem_);
 	update_bank_maps();
 }
 
@@ -40,8 +54,7 @@ void Mapper001::reset() {
 	chr_bank_1_ = 0;
 	prg_bank_ = 0;
 	prg_ram_enabled_ = true;
-	cpu_cycle_counter_ = 0;
-	last_write_cycle_ = 0;
+	last_write_cycle_ = NO_WRITE_CYCLE;
 
 	// NOTE: Battery-backed PRG-RAM is intentionally NOT cleared on reset. On real
 	// hardware the reset button only pulses the CPU reset line; cartridge save RAM
@@ -63,13 +76,16 @@ void Mapper001::update_bank_maps() {
 		std::size_t offset = get_chr_bank_offset(static_cast<Address>(slot * 1024));
 		chr_map_[slot] = (offset + 1024 <= chr_mem_.size()) ? chr_mem_.data() + offset : OPEN_BUS_PAGE.data();
 	}
+	chr_cache_.map_slots(chr_map_);
+	// Mirroring lives in the control register too
+	map_nametables(get_mirroring());
 }
 
 Byte Mapper001::cpu_read(Address address) const {
-	// PRG RAM: $6000-$7FFF (8KB)
+	// PRG RAM: $6000-$7FFF
 	if (address >= 0x6000 && address < 0x8000) {
 		if (has_prg_ram_ && prg_ram_enabled_) {
-			return prg_ram_[address - 0x6000];
+			return prg_ram_[prg_ram_offset(address)];
 		}
 		return 0xFF; // Open bus if RAM disabled or not present
 	}
@@ -84,28 +100,35 @@ Byte Mapper001::cpu_read(Address address) const {
 }
 
 void Mapper001::cpu_write(Address address, Byte value) {
-	// PRG RAM: $6000-$7FFF (8KB)
+	// PRG RAM: $6000-$7FFF
 	if (address >= 0x6000 && address < 0x8000) {
 		if (has_prg_ram_ && prg_ram_enabled_) {
-			prg_ram_[address - 0x6000] = value;
-			prg_ram_dirty_ = true;
+			const std::size_t offset = prg_ram_offset(address);
+			prg_ram_[offset] = value;
+			ram_written(RamKind::Prg, offset);
 		}
 		return;
 	}
 
 	// MMC1 Register writes: $8000-$FFFF
+	if (address >= 0x8000) {
+		write_shift_register(address, value);
+		return;
+	}
+}
+
+void Mapper001::cpu_write_at(Address address, Byte value, std::uint64_t cpu_cycle) {
 	if (address >= 0x8000) {
 		// Consecutive-write filter: ignore writes on back-to-back CPU cycles.
 		// RMW instructions write the old value then new value on consecutive
 		// cycles; real MMC1 hardware only processes the first write.
-		if (cpu_cycle_counter_ == last_write_cycle_ + 1 && last_write_cycle_ != 0) {
-			last_write_cycle_ = cpu_cycle_counter_;
+		const bool consecutive = last_write_cycle_ != NO_WRITE_CYCLE && cpu_cycle == last_write_cycle_ + 1;
+		last_write_cycle_ = cpu_cycle;
+		if (consecutive) {
 			return; // Ignore this consecutive write
 		}
-		last_write_cycle_ = cpu_cycle_counter_;
-		write_shift_register(address, value);
-		return;
 	}
+	cpu_write(address, value);
 }
 
 Byte Mapper001::ppu_read(Address address) const {
@@ -126,7 +149,9 @@ void Mapper001::ppu_write(Address address, Byte value) {
 	if (chr_is_ram_) {
 		std::size_t chr_offset = get_chr_bank_offset(address);
 		if (chr_offset < chr_mem_.size()) {
-			chr_mem_[chr_offset] = value;
+			chr_ram_[chr_offset] = value;
+			ram_written(RamKind::Chr, chr_offset);
+			chr_cache_.invalidate(chr_offset);
 		}
 	}
 }
@@ -244,18 +269,8 @@ Mapper::Mirroring Mapper001::get_mirroring() const noexcept {
 	}
 }
 
-// Save state serialization
-void Mapper001::serialize_state(std::vector<uint8_t> &buffer) const {
-	// PRG RAM (8KB if present)
-	if (has_prg_ram_) {
-		buffer.insert(buffer.end(), prg_ram_.begin(), prg_ram_.end());
-	}
-
-	// CHR RAM (if CHR is RAM, not ROM)
-	if (chr_is_ram_) {
-		buffer.insert(buffer.end(), chr_mem_.begin(), chr_mem_.end());
-	}
-
+// Save state serialization (PRG RAM and CHR RAM go first, from the base)
+void Mapper001::serialize_registers(std::vector<uint8_t> &buffer) const {
 	// MMC1 registers
 	buffer.push_back(shift_register_);
 	buffer.push_back(shift_count_);
@@ -266,28 +281,15 @@ void Mapper001::serialize_state(std::vector<uint8_t> &buffer) const {
 	buffer.push_back(prg_ram_enabled_ ? 1 : 0);
 }
 
-void Mapper001::deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset) {
+void Mapper001::deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset) {
 	// Compute the total size this routine will consume and bounds-check it up
 	// front. Save files are untrusted input, so a truncated/malicious state
 	// must not cause out-of-bounds reads.
-	const std::size_t required =
-		(has_prg_ram_ ? prg_ram_.size() : 0) + (chr_is_ram_ ? chr_mem_.size() : 0) + 7; // 7 single-byte registers below
+	const std::size_t required = 7; // 7 single-byte registers below
 	if (offset + required > buffer.size()) {
 		throw std::runtime_error("save state: unexpected end of buffer (MMC1)");
 	}
 
-	// PRG RAM (8KB if present)
-	if (has_prg_ram_) {
-		std::copy(buffer.begin() + offset, buffer.begin() + offset + prg_ram_.size(), prg_ram_.begin());
-		offset += prg_ram_.size();
-	}
-
-	// CHR RAM (if CHR is RAM, not ROM)
-	if (chr_is_ram_) {
-		std::copy(buffer.begin() + offset, buffer.begin() + offset + chr_mem_.size(), chr_mem_.begin());
-		offset += chr_mem_.size();
-	}
-
 	// MMC1 registers
 	shift_register_ = buffer[offset++];
 	shift_count_ = buffer[offset++];
@@ -296,8 +298,10 @@ void Mapper001::deserialize_state(const std::vector<uint8_t> &buffer, size_t &of
 	chr_bank_1_ = buffer[offset++];
 	prg_bank_ = buffer[offset++];
 	prg_ram_enabled_ = buffer[offset++] != 0;
+	last_write_cycle_ = NO_WRITE_CYCLE;
 
 	update_bank_maps();
+	chr_cache_.invalidate_all(); // CHR RAM contents were restored wholesale
 }
 
 } // namespace nes
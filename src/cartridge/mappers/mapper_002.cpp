@@ -3,8 +3,8 @@
 
 namespace nes {
 
-Mapper002::Mapper002(std::vector<Byte> prg_rom, std::vector<Byte> chr_rom, Mirroring mirroring)
-	: prg_rom_(std::move(prg_rom)), mirroring_(mirroring), selected_bank_(0) {
+Mapper002::Mapper002(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring)
+	: prg_rom_(prg_rom), mirroring_(mirroring), selected_bank_(0) {
 
 	// Calculate number of 16KB banks
 	num_banks_ = static_cast<std::uint8_t>(prg_rom_.size() / 16384);
@@ -27,13 +27,15 @@ Mapper002::Mapper002(std::vector<Byte> prg_rom, std::vector<Byte> chr_rom, Mirro
 		std::cout << "[Mapper002] Using 8KB CHR RAM" << std::endl;
 	} else {
 		// Some variants may have CHR ROM, copy it to RAM
-		chr_ram_ = std::move(chr_rom);
+		chr_ram_.assign(chr_rom.begin(), chr_rom.end());
 		if (chr_ram_.size() < 8192) {
 			chr_ram_.resize(8192, 0);
 		}
 		std::cout << "[Mapper002] Using CHR RAM initialized from ROM" << std::endl;
 	}
 
+	track_ram(RamKind::Chr, chr_ram_);
+	chr_cache_.attach(chr_ram_);
 	update_bank_maps();
 }
 
@@ -53,6 +55,7 @@ void Mapper002::update_bank_maps() {
 		std::size_t offset = slot * 1024;
 		chr_map_[slot] = (offset + 1024 <= chr_ram_.size()) ? chr_ram_.data() + offset : OPEN_BUS_PAGE.data();
 	}
+	chr_cache_.map_slots(chr_map_);
 }
 
 Byte Mapper002::cpu_read(Address address) const {
@@ -105,6 +108,8 @@ void Mapper002::ppu_write(Address address, Byte value) {
 
 	// CHR RAM is writable
 	chr_ram_[address] = value;
+	ram_written(RamKind::Chr, address);
+	chr_cache_.invalidate(address);
 }
 
 void Mapper002::reset() {
@@ -113,23 +118,14 @@ void Mapper002::reset() {
 	update_bank_maps();
 }
 
-void Mapper002::serialize_state(std::vector<Byte> &buffer) const {
-	// Serialize CHR RAM (8KB)
-	buffer.insert(buffer.end(), chr_ram_.begin(), chr_ram_.end());
-
-	// Serialize selected bank
+void Mapper002::serialize_registers(std::vector<Byte> &buffer) const {
 	buffer.push_back(selected_bank_);
 }
 
-void Mapper002::deserialize_state(const std::vector<Byte> &buffer, size_t &offset) {
-	// Deserialize CHR RAM (8KB)
-	for (size_t i = 0; i < chr_ram_.size() && offset < buffer.size(); ++i) {
-		chr_ram_[i] = buffer[offset++];
-	}
-
-	// Deserialize selected bank
+void Mapper002::deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) {
 	selected_bank_ = buffer[offset++];
 	update_bank_maps();
+	chr_cache_.invalidate_all(); // CHR RAM contents were restored wholesale
 }
 
 } // namespace nes
@@ -3,8 +3,8 @@
 
 namespace nes {
 
-Mapper003::Mapper003(std::vector<Byte> prg_rom, std::vector<Byte> chr_rom, Mirroring mirroring)
-	: prg_rom_(std::move(prg_rom)), chr_rom_(std::move(chr_rom)), mirroring_(mirroring), selected_chr_bank_(0) {
+Mapper003::Mapper003(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring)
+	: prg_rom_(prg_rom), chr_rom_(chr_rom), mirroring_(mirroring), selected_chr_bank_(0) {
 
 	// Calculate number of 8KB CHR banks
 	num_chr_banks_ = static_cast<std::uint8_t>(chr_rom_.size() / 8192);
@@ -16,6 +16,7 @@ Mapper003::Mapper003(std::vector<Byte> prg_rom, std::vector<Byte> chr_rom, Mirro
 			  << (is_16kb_prg() ? "16KB mirrored" : "32KB") << "), CHR=" << chr_rom_.size() << " bytes ("
 			  << static_cast<int>(num_chr_banks_) << " banks)" << std::endl;
 
+	chr_cache_.attach(chr_rom_);
 	update_bank_maps();
 }
 
@@ -36,6 +37,7 @@ void Mapper003::update_bank_maps() {
 		std::size_t offset = bank_base + slot * 1024;
 		chr_map_[slot] = (offset + 1024 <= chr_rom_.size()) ? chr_rom_.data() + offset : OPEN_BUS_PAGE.data();
 	}
+	chr_cache_.map_slots(chr_map_);
 }
 
 Byte Mapper003::cpu_read(Address address) const {
@@ -91,12 +93,12 @@ void Mapper003::reset() {
 	update_bank_maps();
 }
 
-void Mapper003::serialize_state(std::vector<uint8_t> &buffer) const {
+void Mapper003::serialize_registers(std::vector<uint8_t> &buffer) const {
 	// Serialize selected CHR bank
 	buffer.push_back(selected_chr_bank_);
 }
 
-void Mapper003::deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset) {
+void Mapper003::deserialize_registers(const std::vector<uint8_t> &buffer, size_t &offset) {
 	// Deserialize selected CHR bank
 	if (offset < buffer.size()) {
 		selected_chr_bank_ = buffer[offset++];
@@ -5,27 +5,40 @@
 
 namespace nes {
 
-Mapper004::Mapper004(std::vector<Byte> prg_rom, std::vector<Byte> chr_mem, Mirroring mirroring, bool has_prg_ram,
-					 bool chr_is_ram, bool battery_backed)
-	: prg_rom_(std::move(prg_rom)), chr_mem_(std::move(chr_mem)), initial_mirroring_(mirroring),
-	  has_prg_ram_(has_prg_ram), chr_is_ram_(chr_is_ram), battery_backed_(battery_backed), bank_select_(0), banks_{},
+Mapper004::Mapper004(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring,
+					 bool has_prg_ram, bool chr_is_ram, bool battery_backed, RamSizes ram)
+	: prg_rom_(prg_rom), initial_mirroring_(mirroring),
+	  has_prg_ram_(has_prg_ram && ram.prg_ram > 0), chr_is_ram_(chr_is_ram), battery_backed_(battery_backed), bank_select_(0), banks_{},
 	  mirroring_(false), prg_ram_protect_(0x80), // PRG RAM enabled by default
 	  irq_latch_(0), irq_counter_(0), irq_reload_(false), irq_enabled_(false) {
 
-	// Initialize PRG RAM if needed (8KB)
+	// Initialize PRG RAM if needed (8KB on most boards; the MMC6's 1KB mirrors)
 	if (has_prg_ram_) {
-		prg_ram_.resize(8192, 0x00);
+		prg_ram_storage_.resize(ram.prg_ram, 0x00);
+		prg_ram_ = prg_ram_storage_;
+		prg_ram_mask_ = prg_ram_window_mask(ram.prg_ram);
 	}
 
-	// If CHR is RAM and the vector is empty, allocate 8KB CHR RAM.
+	// CHR ROM is read in place; CHR RAM is this instance's own copy. If CHR
+	// is RAM and nothing was provided, allocate the board's CHR RAM.
 	// Also guard against a malformed ROM declaring CHR ROM but providing no
-	// data: an empty CHR vector makes the 1KB bank count 0, and the
+	// data: an empty CHR region makes the 1KB bank count 0, and the
 	// `(bank_count - 1)` masks below would wrap to SIZE_MAX. Allocate a
 	// minimal 8KB region so bank math stays well-defined.
-	if (chr_mem_.empty()) {
-		chr_mem_.resize(8192, 0x00);
+	if (chr_rom.empty()) {
 		chr_is_ram_ = true;
 	}
+	if (chr_is_ram_) {
+		chr_ram_.assign(chr_rom.begin(), chr_rom.end());
+		if (chr_ram_.empty()) {
+			chr_ram_.resize(std::max<std::size_t>(ram.chr_ram, 8192), 0x00);
+		}
+		chr_mem_ = chr_ram_;
+	} else {
+		chr_mem_ = chr_rom;
+	}
+	track_ram(RamKind::Prg, prg_ram_);
+	track_ram(RamKind::Chr, chr_ram_);
 
 	// Initialize bank registers to power-on state
 	// R0-R5: CHR banks (set to 0-5)
@@ -36,6 +49,7 @@ Mapper004::Mapper004(std::vector<Byte> prg_rom, std::vector<Byte> chr_mem, Mirro
 	banks_[6] = 0; // First 8KB PRG bank
 	banks_[7] = 1; // Second 8KB PRG bank
 
+	chr_cache_.attach(chr_mem_);
 	update_bank_maps();
 }
 
@@ -80,13 +94,15 @@ void Mapper004::update_bank_maps() {
 		std::size_t offset = get_chr_bank_offset(static_cast<Address>(slot * 1024));
 		chr_map_[slot] = (offset + 1024 <= chr_mem_.size()) ? chr_mem_.data() + offset : OPEN_BUS_PAGE.data();
 	}
+	chr_cache_.map_slots(chr_map_);
+	map_nametables(get_mirroring());
 }
 
 Byte Mapper004::cpu_read(Address address) const {
-	// PRG RAM: $6000-$7FFF (8KB)
+	// PRG RAM: $6000-$7FFF
 	if (address >= 0x6000 && address < 0x8000) {
 		if (has_prg_ram_ && is_prg_ram_enabled()) {
-			return prg_ram_[address - 0x6000];
+			return prg_ram_[(address - 0x6000) & prg_ram_mask_];
 		}
 		return 0xFF; // Open bus if RAM disabled or not present
 	}
@@ -101,11 +117,12 @@ Byte Mapper004::cpu_read(Address address) const {
 }
 
 void Mapper004::cpu_write(Address address, Byte value) {
-	// PRG RAM: $6000-$7FFF (8KB)
+	// PRG RAM: $6000-$7FFF
 	if (address >= 0x6000 && address < 0x8000) {
 		if (has_prg_ram_ && is_prg_ram_enabled() && is_prg_ram_writable()) {
-			prg_ram_[address - 0x6000] = value;
-			prg_ram_dirty_ = true;
+			const std::size_t offset = (address - 0x6000) & prg_ram_mask_;
+			prg_ram_[offset] = value;
+			ram_written(RamKind::Prg, offset);
 		}
 		return;
 	}
@@ -130,6 +147,7 @@ void Mapper004::cpu_write(Address address, Byte value) {
 			if ((address & 0x0001) == 0) {
 				// Even addresses: Mirroring ($A000)
 				mirroring_ = (value & 0x01) != 0;
+				map_nametables(get_mirroring());
 			} else {
 				// Odd addresses: PRG RAM Protect ($A001)
 				prg_ram_protect_ = value;
@@ -179,7 +197,9 @@ void Mapper004::ppu_write(Address address, Byte value) {
 	if (chr_is_ram_) {
 		std::size_t chr_offset = get_chr_bank_offset(address);
 		if (chr_offset < chr_mem_.size()) {
-			chr_mem_[chr_offset] = value;
+			chr_ram_[chr_offset] = value;
+			ram_written(RamKind::Chr, chr_offset);
+			chr_cache_.invalidate(chr_offset);
 		}
 	}
 }
@@ -190,6 +210,18 @@ void Mapper004::ppu_a12_toggle() {
 	clock_irq_counter();
 }
 
+std::uint32_t Mapper004::a12_edges_until_irq() const noexcept {
+	// Mirrors clock_irq_counter(): no new IRQ while disabled or still pending
+	if (!irq_enabled_ || irq_pending_) {
+		return NO_A12_IRQ;
+	}
+	if (irq_counter_ == 0 || irq_reload_) {
+		// Next clock reloads from the latch; a zero latch fires immediately
+		return irq_latch_ == 0 ? 1u : static_cast<std::uint32_t>(irq_latch_) + 1u;
+	}
+	return irq_counter_;
+}
+
 std::size_t Mapper004::get_prg_bank_offset(Address address) const {
 	std::size_t bank_8kb_count = get_prg_8kb_bank_count();
 	bool prg_mode = get_prg_bank_mode();
@@ -282,7 +314,11 @@ std::size_t Mapper004::get_chr_bank_offset(Address address) const {
 }
 
 Mapper::Mirroring Mapper004::get_mirroring() const noexcept {
-	// MMC3 can override mirroring dynamically
+	// MMC3 can override mirroring dynamically, except on four-screen boards
+	// (which ignore $A000)
+	if (initial_mirroring_ == Mirroring::FourScreen) {
+		return Mirroring::FourScreen;
+	}
 	return mirroring_ ? Mirroring::Horizontal : Mirroring::Vertical;
 }
 
@@ -321,18 +357,8 @@ void Mapper004::update_irq_line() {
 	}
 }
 
-void Mapper004::serialize_state(std::vector<Byte> &buffer) const {
-	// Serialize PRG RAM if present (8KB)
-	if (has_prg_ram_) {
-		buffer.insert(buffer.end(), prg_ram_.begin(), prg_ram_.end());
-	}
-
-	// Serialize CHR memory if it's RAM
-	if (chr_is_ram_) {
-		buffer.insert(buffer.end(), chr_mem_.begin(), chr_mem_.end());
-	}
-
-	// Serialize MMC3 registers
+void Mapper004::serialize_registers(std::vector<Byte> &buffer) const {
+	// Serialize MMC3 registers (PRG RAM and CHR RAM precede them, from the base)
 	buffer.push_back(bank_select_);
 
 	// Serialize all 8 bank registers
@@ -351,21 +377,7 @@ void Mapper004::serialize_state(std::vector<Byte> &buffer) const {
 	buffer.push_back(irq_pending_ ? 1 : 0);
 }
 
-void Mapper004::deserialize_state(const std::vector<Byte> &buffer, size_t &offset) {
-	// Deserialize PRG RAM if present (8KB)
-	if (has_prg_ram_) {
-		for (size_t i = 0; i < prg_ram_.size() && offset < buffer.size(); ++i) {
-			prg_ram_[i] = buffer[offset++];
-		}
-	}
-
-	// Deserialize CHR memory if it's RAM
-	if (chr_is_ram_) {
-		for (size_t i = 0; i < chr_mem_.size() && offset < buffer.size(); ++i) {
-			chr_mem_[i] = buffer[offset++];
-		}
-	}
-
+void Mapper004::deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) {
 	// Deserialize MMC3 registers
 	// Remaining fixed-size fields: bank_select (1) + 8 bank registers +
 	// mirroring (1) + prg_ram_protect (1) + 5 IRQ fields = 16 bytes.
@@ -390,6 +402,7 @@ void Mapper004::deserialize_state(const std::vector<Byte> &buffer, size_t &offse
 	irq_pending_ = buffer[offset++] != 0;
 
 	update_bank_maps();
+	chr_cache_.invalidate_all(); // CHR RAM contents were restored wholesale
 }
 
 } // namespace nes
@@ -0,0 +1,425 @@
+#include "cartridge/mappers/mapper_005.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nes {
+
+Mapper005::Mapper005(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, bool battery_backed,
+					 RamSizes ram)
+	: prg_rom_(prg_rom), battery_backed_(battery_backed), audio_(std::make_shared<Mmc5Audio>()) {
+	// Whole 8KB banks, up to the 64KB the bank registers reach
+	const std::size_t ram_banks = std::min<std::size_t>((ram.prg_ram + 0x1FFF) / 0x2000, MAX_PRG_RAM_BANKS);
+	prg_ram_.resize(ram_banks * 0x2000, 0x00);
+
+	chr_is_ram_ = chr_rom.empty();
+	if (chr_is_ram_) {
+		chr_ram_.resize(std::max<std::size_t>(ram.chr_ram, 8192), 0x00);
+		chr_mem_ = chr_ram_;
+	} else {
+		chr_mem_ = chr_rom;
+	}
+
+	track_ram(RamKind::Prg, prg_ram_);
+	track_ram(RamKind::Chr, chr_ram_);
+	chr_cache_.attach(chr_mem_);
+	reset();
+}
+
+void Mapper005::reset() {
+	prg_mode_ = 3;
+	chr_mode_ = 0;
+	prg_ram_protect_ = {0, 0};
+	exram_mode_ = 0;
+	nametable_mapping_ = 0;
+	fill_tile_ = 0;
+	fill_attribute_ = 0;
+	prg_banks_ = {0, 0, 0, 0, 0xFF}; // $5117 starts at the last bank
+	chr_banks_.fill(0);
+	chr_upper_ = 0;
+	last_set_b_ = false;
+	irq_compare_ = 0;
+	irq_enabled_ = false;
+	multiplicand_ = 0xFF;
+	multiplier_ = 0xFF;
+	in_frame_ = false;
+	scanline_counter_ = 0;
+	irq_status_ = false;
+	irq_pending_ = false;
+	sprite_fetches_ = false;
+	tall_sprites_ = false;
+	audio_->reset();
+
+	rebuild_fill_page();
+	update_prg_map();
+	update_chr_map();
+	remap_nametables();
+}
+
+void Mapper005::update_prg_map() {
+	const std::size_t rom_banks = std::max<std::size_t>(prg_rom_.size() / 0x2000, 1);
+	const auto rom_page = [&](std::size_t bank) {
+		const std::size_t offset = (bank % rom_banks) * 0x2000;
+		return (offset + 0x2000 <= prg_rom_.size()) ? prg_rom_.data() + offset : OPEN_BUS_PAGE.data();
+	};
+	// Null without PRG-RAM: reads see open bus, writes are dropped
+	const std::size_t ram_banks = prg_ram_.size() / 0x2000;
+	const auto ram_page = [&](std::size_t bank) -> Byte * {
+		return ram_banks == 0 ? nullptr : prg_ram_.data() + ((bank & 0x07) % ram_banks) * 0x2000;
+	};
+
+	// Per 8KB slot: the register that banks it and the slot's offset inside
+	// that register's (possibly larger) window
+	std::array<Byte, 4> regs{};
+	std::array<Byte, 4> sub{};
+	switch (prg_mode_) {
+	case 0:
+		regs = {4, 4, 4, 4};
+		sub = {0, 1, 2, 3};
+		break;
+	case 1:
+		regs = {2, 2, 4, 4};
+		sub = {0, 1, 0, 1};
+		break;
+	case 2:
+		regs = {2, 2, 3, 4};
+		sub = {0, 1, 0, 0};
+		break;
+	default:
+		regs = {1, 2, 3, 4};
+		sub = {0, 0, 0, 0};
+		break;
+	}
+	const Byte window_mask = prg_mode_ == 0 ? 0x03 : (prg_mode_ == 3 ? 0x00 : 0x01);
+
+	for (std::size_t slot = 0; slot < prg_map_.size(); ++slot) {
+		const Byte value = prg_banks_[regs[slot]];
+		// Mode 2 mixes one 16KB window with two 8KB ones
+		const Byte mask = (prg_mode_ == 2 && slot >= 2) ? 0x00 : window_mask;
+		const std::size_t bank = static_cast<std::size_t>((value & 0x7F & ~mask) | sub[slot]);
+		const bool rom = regs[slot] == 4 || prg_mode_ == 0 || (value & 0x80) != 0;
+		if (rom) {
+			prg_map_[slot] = rom_page(bank);
+			prg_ram_pages_[slot] = nullptr;
+		} else {
+			prg_ram_pages_[slot] = ram_page(bank);
+			prg_map_[slot] = prg_ram_pages_[slot] ? prg_ram_pages_[slot] : OPEN_BUS_PAGE.data();
+		}
+	}
+	low_ram_page_ = ram_page(prg_banks_[0]);
+}
+
+std::size_t Mapper005::chr_offset(Address address) const noexcept {
+	const bool set_b = use_set_b();
+	const std::size_t slot = (address >> 10) & 0x07;
+	std::size_t reg = 0;
+	std::size_t unit = 0; // Bank size in 1KB pages
+	switch (chr_mode_) {
+	case 0:
+		reg = set_b ? 11 : 7;
+		unit = 8;
+		break;
+	case 1:
+		reg = set_b ? 11 : (slot < 4 ? 3 : 7);
+		unit = 4;
+		break;
+	case 2:
+		reg = set_b ? (slot & 2 ? 11 : 9) : (slot | 1);
+		unit = 2;
+		break;
+	default:
+		reg = set_b ? 8 + (slot & 3) : slot;
+		unit = 1;
+		break;
+	}
+	const std::size_t page = chr_banks_[reg] * unit + (slot % unit);
+	const std::size_t page_count = std::max<std::size_t>(chr_mem_.size() / 0x400, 1);
+	return (page % page_count) * 0x400 + (address & 0x03FF);
+}
+
+void Mapper005::update_chr_map() {
+	for (std::size_t slot = 0; slot < chr_map_.size(); ++slot) {
+		const std::size_t offset = chr_offset(static_cast<Address>(slot * 0x400)) & ~std::size_t{0x3FF};
+		chr_map_[slot] = (offset + 0x400 <= chr_mem_.size()) ? chr_mem_.data() + offset : OPEN_BUS_PAGE.data();
+	}
+	chr_cache_.map_slots(chr_map_);
+}
+
+void Mapper005::rebuild_fill_page() {
+	std::fill(fill_page_.begin(), fill_page_.begin() + 0x3C0, fill_tile_);
+	const Byte attribute = static_cast<Byte>((fill_attribute_ & 0x03) * 0x55);
+	std::fill(fill_page_.begin() + 0x3C0, fill_page_.end(), attribute);
+	blank_page_.fill(0);
+}
+
+void Mapper005::remap_nametables() {
+	if (!ciram_) {
+		return;
+	}
+	for (std::size_t quarter = 0; quarter < nametable_map_.size(); ++quarter) {
+		switch ((nametable_mapping_ >> (quarter * 2)) & 0x03) {
+		case 0:
+			nametable_map_[quarter] = ciram_;
+			break;
+		case 1:
+			nametable_map_[quarter] = ciram_ + 0x400;
+			break;
+		case 2:
+			// ExRAM only reads back as a nametable in modes 0 and 1
+			nametable_map_[quarter] = exram_mode_ < 2 ? exram_.data() : blank_page_.data();
+			break;
+		default:
+			nametable_map_[quarter] = fill_page_.data();
+			break;
+		}
+	}
+}
+
+Mapper::Mirroring Mapper005::get_mirroring() const noexcept {
+	switch (nametable_mapping_) {
+	case 0x44:
+		return Mirroring::Vertical;
+	case 0x50:
+		return Mirroring::Horizontal;
+	case 0x00:
+		return Mirroring::SingleScreenLow;
+	case 0x55:
+		return Mirroring::SingleScreenHigh;
+	default:
+		return Mirroring::FourScreen; // Some other per-quarter mapping
+	}
+}
+
+Byte Mapper005::cpu_read(Address address) const {
+	if (address >= 0x8000) {
+		return prg_map_[(address >> 13) & 0x03][address & 0x1FFF];
+	}
+	if (address >= 0x6000) {
+		return low_ram_page_ ? low_ram_page_[address & 0x1FFF] : 0xFF;
+	}
+	if (address >= 0x5C00) {
+		return exram_mode_ >= 2 ? exram_[address - 0x5C00] : 0xFF;
+	}
+	switch (address) {
+	case 0x5015:
+		return audio_->read_status();
+	case 0x5204: {
+		const Byte status = static_cast<Byte>((irq_status_ ? 0x80 : 0) | (in_frame_ ? 0x40 : 0));
+		irq_status_ = false;
+		irq_pending_ = false;
+		return status;
+	}
+	case 0x5205:
+		return static_cast<Byte>((multiplicand_ * multiplier_) & 0xFF);
+	case 0x5206:
+		return static_cast<Byte>((multiplicand_ * multiplier_) >> 8);
+	default:
+		return 0xFF; // Open bus
+	}
+}
+
+void Mapper005::cpu_write(Address address, Byte value) {
+	if (address >= 0x6000) {
+		Byte *page = address >= 0x8000 ? prg_ram_pages_[(address >> 13) & 0x03] : low_ram_page_;
+		if (page && prg_ram_writable()) {
+			page[address & 0x1FFF] = value;
+			ram_written(RamKind::Prg, static_cast<std::size_t>(page - prg_ram_.data()) + (address & 0x1FFF));
+		}
+		return;
+	}
+	if (address >= 0x5C00) {
+		if (exram_mode_ != 3) {
+			exram_[address - 0x5C00] = value;
+		}
+		return;
+	}
+	if (address >= 0x5000 && address <= 0x5015) {
+		audio_->write(address, value);
+		return;
+	}
+
+	switch (address) {
+	case 0x5100:
+		prg_mode_ = value & 0x03;
+		update_prg_map();
+		break;
+	case 0x5101:
+		chr_mode_ = value & 0x03;
+		update_chr_map();
+		break;
+	case 0x5102:
+	case 0x5103:
+		prg_ram_protect_[address - 0x5102] = value & 0x03;
+		break;
+	case 0x5104:
+		exram_mode_ = value & 0x03;
+		remap_nametables();
+		break;
+	case 0x5105:
+		nametable_mapping_ = value;
+		remap_nametables();
+		break;
+	case 0x5106:
+		fill_tile_ = value;
+		rebuild_fill_page();
+		break;
+	case 0x5107:
+		fill_attribute_ = value & 0x03;
+		rebuild_fill_page();
+		break;
+	case 0x5113:
+	case 0x5114:
+	case 0x5115:
+	case 0x5116:
+	case 0x5117:
+		prg_banks_[address - 0x5113] = value;
+		update_prg_map();
+		break;
+	case 0x5130:
+		chr_upper_ = value & 0x03;
+		break;
+	case 0x5203:
+		irq_compare_ = value;
+		break;
+	case 0x5204:
+		irq_enabled_ = (value & 0x80) != 0;
+		irq_pending_ = irq_enabled_ && irq_status_;
+		break;
+	case 0x5205:
+		multiplicand_ = value;
+		break;
+	case 0x5206:
+		multiplier_ = value;
+		break;
+	default:
+		if (address >= 0x5120 && address <= 0x512B) {
+			chr_banks_[address - 0x5120] = static_cast<std::uint16_t>(value | (chr_upper_ << 8));
+			last_set_b_ = address >= 0x5128;
+			update_chr_map();
+		}
+		break;
+	}
+}
+
+void Mapper005::ppu_scanline_start(int scanline, bool rendering) {
+	if (!rendering || scanline >= 240) {
+		if (in_frame_) {
+			in_frame_ = false;
+			update_chr_map(); // Outside the frame the last-written set applies
+		}
+		return;
+	}
+	if (!in_frame_) {
+		// First rendered line of the frame
+		in_frame_ = true;
+		scanline_counter_ = 0;
+		irq_status_ = false;
+		irq_pending_ = false;
+		update_chr_map();
+		return;
+	}
+	++scanline_counter_;
+	if (scanline_counter_ == irq_compare_) {
+		irq_status_ = true;
+		irq_pending_ = irq_enabled_;
+	}
+}
+
+void Mapper005::ppu_fetch_phase(bool sprites, bool tall_sprites) {
+	const bool before = use_set_b();
+	sprite_fetches_ = sprites;
+	tall_sprites_ = tall_sprites;
+	if (use_set_b() != before) {
+		update_chr_map();
+	}
+}
+
+Byte Mapper005::ppu_read(Address address) const {
+	if (!is_chr_address(address)) {
+		return 0xFF;
+	}
+	return chr_map_[address >> 10][address & 0x03FF];
+}
+
+void Mapper005::ppu_write(Address address, Byte value) {
+	if (!is_chr_address(address) || !chr_is_ram_) {
+		return;
+	}
+	const std::size_t offset = chr_offset(address);
+	chr_ram_[offset] = value;
+	ram_written(RamKind::Chr, offset);
+	chr_cache_.invalidate(offset);
+}
+
+void Mapper005::serialize_registers(std::vector<Byte> &buffer) const {
+	buffer.insert(buffer.end(), exram_.begin(), exram_.end());
+	buffer.push_back(prg_mode_);
+	buffer.push_back(chr_mode_);
+	buffer.push_back(prg_ram_protect_[0]);
+	buffer.push_back(prg_ram_protect_[1]);
+	buffer.push_back(exram_mode_);
+	buffer.push_back(nametable_mapping_);
+	buffer.push_back(fill_tile_);
+	buffer.push_back(fill_attribute_);
+	buffer.insert(buffer.end(), prg_banks_.begin(), prg_banks_.end());
+	for (std::uint16_t bank : chr_banks_) {
+		buffer.push_back(static_cast<Byte>(bank & 0xFF));
+		buffer.push_back(static_cast<Byte>(bank >> 8));
+	}
+	buffer.push_back(chr_upper_);
+	buffer.push_back(static_cast<Byte>((last_set_b_ ? 0x01 : 0) | (irq_enabled_ ? 0x02 : 0) | (in_frame_ ? 0x04 : 0) |
+									   (irq_status_ ? 0x08 : 0) | (irq_pending_ ? 0x10 : 0) |
+									   (sprite_fetches_ ? 0x20 : 0) | (tall_sprites_ ? 0x40 : 0)));
+	buffer.push_back(irq_compare_);
+	buffer.push_back(scanline_counter_);
+	buffer.push_back(multiplicand_);
+	buffer.push_back(multiplier_);
+	audio_->serialize_state(buffer);
+}
+
+void Mapper005::deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) {
+	// ExRAM, then 8 control registers + 5 PRG banks + 12 CHR banks x 2
+	// + $5130 + flags + compare + counter + multiplier pair
+	if (offset + exram_.size() + 8 + 5 + 24 + 6 > buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (MMC5)");
+	}
+	const auto take = [&](auto first, std::size_t count) {
+		std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), count, first);
+		offset += count;
+	};
+	take(exram_.begin(), exram_.size());
+	prg_mode_ = buffer[offset++] & 0x03;
+	chr_mode_ = buffer[offset++] & 0x03;
+	prg_ram_protect_[0] = buffer[offset++] & 0x03;
+	prg_ram_protect_[1] = buffer[offset++] & 0x03;
+	exram_mode_ = buffer[offset++] & 0x03;
+	nametable_mapping_ = buffer[offset++];
+	fill_tile_ = buffer[offset++];
+	fill_attribute_ = buffer[offset++] & 0x03;
+	take(prg_banks_.begin(), prg_banks_.size());
+	for (std::uint16_t &bank : chr_banks_) {
+		bank = static_cast<std::uint16_t>((buffer[offset] | (buffer[offset + 1] << 8)) & 0x3FF);
+		offset += 2;
+	}
+	chr_upper_ = buffer[offset++] & 0x03;
+	const Byte flags = buffer[offset++];
+	last_set_b_ = (flags & 0x01) != 0;
+	irq_enabled_ = (flags & 0x02) != 0;
+	in_frame_ = (flags & 0x04) != 0;
+	irq_status_ = (flags & 0x08) != 0;
+	irq_pending_ = (flags & 0x10) != 0;
+	sprite_fetches_ = (flags & 0x20) != 0;
+	tall_sprites_ = (flags & 0x40) != 0;
+	irq_compare_ = buffer[offset++];
+	scanline_counter_ = buffer[offset++];
+	multiplicand_ = buffer[offset++];
+	multiplier_ = buffer[offset++];
+	audio_->deserialize_state(buffer, offset);
+
+	rebuild_fill_page();
+	update_prg_map();
+	update_chr_map();
+	remap_nametables();
+	chr_cache_.invalidate_all(); // CHR RAM contents were restored wholesale
+}
+
+} // namespace nes
@@ -0,0 +1,238 @@
+#include "cartridge/mappers/mapper_021.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nes {
+
+Mapper021::Mapper021(std::uint16_t mapper_id, std::span<const Byte> prg_rom, std::span<const Byte> chr_rom,
+					 Mirroring mirroring, bool battery_backed, RamSizes ram)
+	: mapper_id_(mapper_id), prg_rom_(prg_rom), initial_mirroring_(mirroring), battery_backed_(battery_backed) {
+	prg_ram_.resize(ram.prg_ram, 0x00);
+	prg_ram_mask_ = prg_ram_window_mask(ram.prg_ram);
+
+	// CHR ROM is read in place; CHR-RAM boards (or a ROM with no CHR data)
+	// get 8KB of their own
+	chr_is_ram_ = chr_rom.empty();
+	if (chr_is_ram_) {
+		chr_ram_.resize(std::max<std::size_t>(ram.chr_ram, 8192), 0x00);
+		chr_mem_ = chr_ram_;
+	} else {
+		chr_mem_ = chr_rom;
+	}
+
+	track_ram(RamKind::Prg, prg_ram_);
+	track_ram(RamKind::Chr, chr_ram_);
+	chr_cache_.attach(chr_mem_);
+	reset();
+}
+
+void Mapper021::reset() {
+	prg_banks_ = {0, 1};
+	prg_swap_ = false;
+	mirroring_ = initial_mirroring_ == Mirroring::Horizontal ? 1 : 0;
+	chr_banks_.fill(0);
+	irq_ = VrcIrqCounter{};
+	irq_pending_ = false;
+	update_bank_maps();
+}
+
+Byte Mapper021::decode_register(Address address) const noexcept {
+	unsigned a0 = 0;
+	unsigned a1 = 0;
+	switch (mapper_id_) {
+	case 21: // VRC4a (A1, A2) / VRC4c (A6, A7)
+		a0 = ((address >> 1) | (address >> 6)) & 1;
+		a1 = ((address >> 2) | (address >> 7)) & 1;
+		break;
+	case 22: // VRC2a: A1, A0
+		a0 = (address >> 1) & 1;
+		a1 = address & 1;
+		break;
+	case 23: // VRC2b / VRC4f (A0, A1) / VRC4e (A2, A3)
+		a0 = (address | (address >> 2)) & 1;
+		a1 = ((address >> 1) | (address >> 3)) & 1;
+		break;
+	default: // 25 - VRC2c / VRC4b (A1, A0) / VRC4d (A3, A2)
+		a0 = ((address >> 1) | (address >> 3)) & 1;
+		a1 = (address | (address >> 2)) & 1;
+		break;
+	}
+	return static_cast<Byte>((a1 << 1) | a0);
+}
+
+void Mapper021::update_bank_maps() {
+	const std::size_t bank_count = std::max<std::size_t>(prg_rom_.size() / 0x2000, 1);
+	const std::size_t second_last = bank_count >= 2 ? bank_count - 2 : 0;
+	const std::array<std::size_t, 4> banks = {prg_swap_ ? second_last : prg_banks_[0], prg_banks_[1],
+											  prg_swap_ ? prg_banks_[0] : second_last, bank_count - 1};
+	for (std::size_t slot = 0; slot < prg_map_.size(); ++slot) {
+		const std::size_t offset = (banks[slot] % bank_count) * 0x2000;
+		prg_map_[slot] = (offset + 0x2000 <= prg_rom_.size()) ? prg_rom_.data() + offset : OPEN_BUS_PAGE.data();
+	}
+	for (std::size_t slot = 0; slot < chr_map_.size(); ++slot) {
+		const std::size_t offset = chr_offset(static_cast<Address>(slot * 0x400));
+		chr_map_[slot] = (offset + 0x400 <= chr_mem_.size()) ? chr_mem_.data() + offset : OPEN_BUS_PAGE.data();
+	}
+	chr_cache_.map_slots(chr_map_);
+	map_nametables(get_mirroring());
+}
+
+std::size_t Mapper021::chr_offset(Address address) const noexcept {
+	std::size_t bank = chr_banks_[(address >> 10) & 0x07];
+	if (is_vrc2()) {
+		bank >>= 1; // VRC2a ignores the low bank bit
+	}
+	const std::size_t bank_count = std::max<std::size_t>(chr_mem_.size() / 0x400, 1);
+	return (bank % bank_count) * 0x400 + (address & 0x03FF);
+}
+
+Byte Mapper021::cpu_read(Address address) const {
+	if (address >= 0x6000 && address < 0x8000) {
+		return prg_ram_.empty() ? 0xFF : prg_ram_[(address - 0x6000) & prg_ram_mask_];
+	}
+	if (address >= 0x8000) {
+		return prg_map_[(address >> 13) & 0x03][address & 0x1FFF];
+	}
+	return 0xFF; // Open bus
+}
+
+void Mapper021::cpu_write(Address address, Byte value) {
+	if (address >= 0x6000 && address < 0x8000) {
+		if (!prg_ram_.empty()) {
+			prg_ram_[(address - 0x6000) & prg_ram_mask_] = value;
+			ram_written(RamKind::Prg, (address - 0x6000) & prg_ram_mask_);
+		}
+		return;
+	}
+	if (address < 0x8000) {
+		return;
+	}
+
+	const Byte reg = decode_register(address);
+	switch (address & 0xF000) {
+	case 0x8000:
+		prg_banks_[0] = value & 0x1F;
+		break;
+	case 0x9000:
+		if (reg < 2 || is_vrc2()) {
+			mirroring_ = is_vrc2() ? (value & 0x01) : (value & 0x03);
+		} else {
+			prg_swap_ = (value & 0x02) != 0;
+		}
+		break;
+	case 0xA000:
+		prg_banks_[1] = value & 0x1F;
+		break;
+	case 0xF000:
+		if (is_vrc2()) {
+			return;
+		}
+		switch (reg) {
+		case 0:
+			irq_.latch = static_cast<Byte>((irq_.latch & 0xF0) | (value & 0x0F));
+			break;
+		case 1:
+			irq_.latch = static_cast<Byte>((irq_.latch & 0x0F) | ((value & 0x0F) << 4));
+			break;
+		case 2:
+			irq_.write_control(value);
+			irq_pending_ = false;
+			break;
+		default:
+			irq_.acknowledge();
+			irq_pending_ = false;
+			break;
+		}
+		return;
+	default: {
+		// $B000-$E003: two registers per CHR bank, low nibble then high bits
+		const std::size_t bank = static_cast<std::size_t>(((address >> 12) - 0x0B) * 2 + (reg >> 1));
+		if (reg & 1) {
+			chr_banks_[bank] = static_cast<std::uint16_t>((chr_banks_[bank] & 0x0F) | ((value & 0x1F) << 4));
+		} else {
+			chr_banks_[bank] = static_cast<std::uint16_t>((chr_banks_[bank] & 0x1F0) | (value & 0x0F));
+		}
+		break;
+	}
+	}
+	update_bank_maps();
+}
+
+Byte Mapper021::ppu_read(Address address) const {
+	if (!is_chr_address(address)) {
+		return 0xFF;
+	}
+	return chr_map_[address >> 10][address & 0x03FF];
+}
+
+void Mapper021::ppu_write(Address address, Byte value) {
+	if (!is_chr_address(address) || !chr_is_ram_) {
+		return;
+	}
+	const std::size_t offset = chr_offset(address);
+	chr_ram_[offset] = value;
+	ram_written(RamKind::Chr, offset);
+	chr_cache_.invalidate(offset);
+}
+
+Mapper::Mirroring Mapper021::get_mirroring() const noexcept {
+	switch (mirroring_) {
+	case 0:
+		return Mirroring::Vertical;
+	case 1:
+		return Mirroring::Horizontal;
+	case 2:
+		return Mirroring::SingleScreenLow;
+	default:
+		return Mirroring::SingleScreenHigh;
+	}
+}
+
+void Mapper021::run_cpu_cycle_timer(std::uint32_t cycles) noexcept {
+	if (irq_.run(cycles)) {
+		irq_pending_ = true;
+	}
+}
+
+std::uint32_t Mapper021::cpu_cycles_until_irq() const noexcept {
+	// A raised IRQ stays raised until acknowledged; the counter catches up lazily
+	return irq_pending_ ? NO_CYCLE_IRQ : irq_.cycles_until_overflow();
+}
+
+void Mapper021::serialize_registers(std::vector<Byte> &buffer) const {
+	buffer.push_back(prg_banks_[0]);
+	buffer.push_back(prg_banks_[1]);
+	buffer.push_back(prg_swap_ ? 1 : 0);
+	buffer.push_back(mirroring_);
+	for (std::uint16_t bank : chr_banks_) {
+		buffer.push_back(static_cast<Byte>(bank & 0xFF));
+		buffer.push_back(static_cast<Byte>(bank >> 8));
+	}
+	irq_.serialize(buffer);
+	buffer.push_back(irq_pending_ ? 1 : 0);
+}
+
+void Mapper021::deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) {
+	// 2 PRG banks + mode + mirroring + 8 CHR banks x 2
+	if (offset + 4 + 16 > buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (VRC2/VRC4)");
+	}
+	prg_banks_[0] = buffer[offset++] & 0x1F;
+	prg_banks_[1] = buffer[offset++] & 0x1F;
+	prg_swap_ = buffer[offset++] != 0;
+	mirroring_ = buffer[offset++] & 0x03;
+	for (std::uint16_t &bank : chr_banks_) {
+		bank = static_cast<std::uint16_t>((buffer[offset] | (buffer[offset + 1] << 8)) & 0x1FF);
+		offset += 2;
+	}
+	irq_.deserialize(buffer, offset);
+	if (offset >= buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (VRC2/VRC4)");
+	}
+	irq_pending_ = buffer[offset++] != 0;
+
+	update_bank_maps();
+	chr_cache_.invalidate_all(); // CHR RAM contents were restored wholesale
+}
+
+} // namespace nes
@@ -0,0 +1,202 @@
+#include "cartridge/mappers/mapper_024.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nes {
+
+Mapper024::Mapper024(std::uint16_t mapper_id, std::span<const Byte> prg_rom, std::span<const Byte> chr_rom,
+					 Mirroring mirroring, bool battery_backed, RamSizes ram)
+	: mapper_id_(mapper_id), prg_rom_(prg_rom), battery_backed_(battery_backed),
+	  audio_(std::make_shared<Vrc6Audio>()) {
+	prg_ram_.resize(ram.prg_ram, 0x00);
+	prg_ram_mask_ = prg_ram_window_mask(ram.prg_ram);
+
+	chr_is_ram_ = chr_rom.empty();
+	if (chr_is_ram_) {
+		chr_ram_.resize(std::max<std::size_t>(ram.chr_ram, 8192), 0x00);
+		chr_mem_ = chr_ram_;
+	} else {
+		chr_mem_ = chr_rom;
+	}
+
+	// The header's mirroring stands until the game writes $B003
+	banking_style_ = mirroring == Mirroring::Horizontal ? 0x04 : 0x00;
+	track_ram(RamKind::Prg, prg_ram_);
+	track_ram(RamKind::Chr, chr_ram_);
+	chr_cache_.attach(chr_mem_);
+	reset();
+}
+
+void Mapper024::reset() {
+	prg_bank_16k_ = 0;
+	prg_bank_8k_ = 0;
+	for (std::size_t i = 0; i < chr_banks_.size(); ++i) {
+		chr_banks_[i] = static_cast<Byte>(i);
+	}
+	irq_ = VrcIrqCounter{};
+	irq_pending_ = false;
+	audio_->reset();
+	update_bank_maps();
+}
+
+void Mapper024::update_bank_maps() {
+	const std::size_t bank_count = std::max<std::size_t>(prg_rom_.size() / 0x2000, 1);
+	const std::array<std::size_t, 4> banks = {prg_bank_16k_ * 2u, prg_bank_16k_ * 2u + 1, prg_bank_8k_,
+											  bank_count - 1};
+	for (std::size_t slot = 0; slot < prg_map_.size(); ++slot) {
+		const std::size_t offset = (banks[slot] % bank_count) * 0x2000;
+		prg_map_[slot] = (offset + 0x2000 <= prg_rom_.size()) ? prg_rom_.data() + offset : OPEN_BUS_PAGE.data();
+	}
+	const std::size_t chr_count = std::max<std::size_t>(chr_mem_.size() / 0x400, 1);
+	for (std::size_t slot = 0; slot < chr_map_.size(); ++slot) {
+		const std::size_t offset = (chr_banks_[slot] % chr_count) * 0x400;
+		chr_map_[slot] = (offset + 0x400 <= chr_mem_.size()) ? chr_mem_.data() + offset : OPEN_BUS_PAGE.data();
+	}
+	chr_cache_.map_slots(chr_map_);
+	map_nametables(get_mirroring());
+}
+
+Byte Mapper024::cpu_read(Address address) const {
+	if (address >= 0x6000 && address < 0x8000) {
+		return is_prg_ram_enabled() && !prg_ram_.empty() ? prg_ram_[(address - 0x6000) & prg_ram_mask_] : 0xFF;
+	}
+	if (address >= 0x8000) {
+		return prg_map_[(address >> 13) & 0x03][address & 0x1FFF];
+	}
+	return 0xFF; // Open bus
+}
+
+void Mapper024::cpu_write(Address address, Byte value) {
+	if (address >= 0x6000 && address < 0x8000) {
+		if (is_prg_ram_enabled() && !prg_ram_.empty()) {
+			prg_ram_[(address - 0x6000) & prg_ram_mask_] = value;
+			ram_written(RamKind::Prg, (address - 0x6000) & prg_ram_mask_);
+		}
+		return;
+	}
+	if (address < 0x8000) {
+		return;
+	}
+
+	// VRC6b (26) has A0 and A1 swapped
+	Address reg = address & 0xF003;
+	if (mapper_id_ == 26) {
+		reg = static_cast<Address>((reg & 0xF000) | ((reg & 0x01) << 1) | ((reg & 0x02) >> 1));
+	}
+
+	switch (reg & 0xF000) {
+	case 0x8000:
+		prg_bank_16k_ = value & 0x0F;
+		break;
+	case 0x9000:
+	case 0xA000:
+		audio_->write(reg, value);
+		return;
+	case 0xB000:
+		if (reg != 0xB003) {
+			audio_->write(reg, value);
+			return;
+		}
+		banking_style_ = value;
+		break;
+	case 0xC000:
+		prg_bank_8k_ = value & 0x1F;
+		break;
+	case 0xD000:
+	case 0xE000:
+		chr_banks_[((reg >> 12) - 0x0D) * 4 + (reg & 0x03)] = value;
+		break;
+	default: // $F000
+		switch (reg & 0x03) {
+		case 0:
+			irq_.latch = value;
+			break;
+		case 1:
+			irq_.write_control(value);
+			irq_pending_ = false;
+			break;
+		case 2:
+			irq_.acknowledge();
+			irq_pending_ = false;
+			break;
+		default:
+			break;
+		}
+		return;
+	}
+	update_bank_maps();
+}
+
+Byte Mapper024::ppu_read(Address address) const {
+	if (!is_chr_address(address)) {
+		return 0xFF;
+	}
+	return chr_map_[address >> 10][address & 0x03FF];
+}
+
+void Mapper024::ppu_write(Address address, Byte value) {
+	if (!is_chr_address(address) || !chr_is_ram_) {
+		return;
+	}
+	const std::size_t chr_count = chr_ram_.size() / 0x400;
+	const std::size_t offset = (chr_banks_[address >> 10] % chr_count) * 0x400 + (address & 0x03FF);
+	chr_ram_[offset] = value;
+	ram_written(RamKind::Chr, offset);
+	chr_cache_.invalidate(offset);
+}
+
+Mapper::Mirroring Mapper024::get_mirroring() const noexcept {
+	switch ((banking_style_ >> 2) & 0x03) {
+	case 0:
+		return Mirroring::Vertical;
+	case 1:
+		return Mirroring::Horizontal;
+	case 2:
+		return Mirroring::SingleScreenLow;
+	default:
+		return Mirroring::SingleScreenHigh;
+	}
+}
+
+void Mapper024::run_cpu_cycle_timer(std::uint32_t cycles) noexcept {
+	if (irq_.run(cycles)) {
+		irq_pending_ = true;
+	}
+}
+
+std::uint32_t Mapper024::cpu_cycles_until_irq() const noexcept {
+	return irq_pending_ ? NO_CYCLE_IRQ : irq_.cycles_until_overflow();
+}
+
+void Mapper024::serialize_registers(std::vector<Byte> &buffer) const {
+	buffer.push_back(prg_bank_16k_);
+	buffer.push_back(prg_bank_8k_);
+	buffer.push_back(banking_style_);
+	buffer.insert(buffer.end(), chr_banks_.begin(), chr_banks_.end());
+	irq_.serialize(buffer);
+	buffer.push_back(irq_pending_ ? 1 : 0);
+	audio_->serialize_state(buffer);
+}
+
+void Mapper024::deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) {
+	// 2 PRG banks + banking style + 8 CHR banks
+	if (offset + 3 + 8 > buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (VRC6)");
+	}
+	prg_bank_16k_ = buffer[offset++] & 0x0F;
+	prg_bank_8k_ = buffer[offset++] & 0x1F;
+	banking_style_ = buffer[offset++];
+	std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), chr_banks_.size(), chr_banks_.begin());
+	offset += chr_banks_.size();
+	irq_.deserialize(buffer, offset);
+	if (offset >= buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (VRC6)");
+	}
+	irq_pending_ = buffer[offset++] != 0;
+	audio_->deserialize_state(buffer, offset);
+
+	update_bank_maps();
+	chr_cache_.invalidate_all(); // CHR RAM contents were restored wholesale
+}
+
+} // namespace nes
@@ -0,0 +1,225 @@
+#include "cartridge/mappers/mapper_069.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nes {
+
+Mapper069::Mapper069(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring,
+					 bool battery_backed, RamSizes ram)
+	: prg_rom_(prg_rom), initial_mirroring_(mirroring), battery_backed_(battery_backed),
+	  audio_(std::make_shared<Sunsoft5bAudio>()) {
+	prg_ram_.resize(ram.prg_ram, 0x00);
+	prg_ram_mask_ = prg_ram_window_mask(ram.prg_ram);
+
+	chr_is_ram_ = chr_rom.empty();
+	if (chr_is_ram_) {
+		chr_ram_.resize(std::max<std::size_t>(ram.chr_ram, 8192), 0x00);
+		chr_mem_ = chr_ram_;
+	} else {
+		chr_mem_ = chr_rom;
+	}
+
+	track_ram(RamKind::Prg, prg_ram_);
+	track_ram(RamKind::Chr, chr_ram_);
+	chr_cache_.attach(chr_mem_);
+	reset();
+}
+
+void Mapper069::reset() {
+	command_ = 0;
+	for (std::size_t i = 0; i < chr_banks_.size(); ++i) {
+		chr_banks_[i] = static_cast<Byte>(i);
+	}
+	low_bank_ = 0;
+	prg_banks_ = {0, 1, 2};
+	mirroring_ = initial_mirroring_ == Mirroring::Horizontal ? 1 : 0;
+	irq_enabled_ = false;
+	counter_enabled_ = false;
+	irq_counter_ = 0;
+	irq_pending_ = false;
+	audio_->reset();
+	update_bank_maps();
+}
+
+void Mapper069::update_bank_maps() {
+	const std::size_t bank_count = std::max<std::size_t>(prg_rom_.size() / 0x2000, 1);
+	const auto prg_page = [&](std::size_t bank) {
+		const std::size_t offset = (bank % bank_count) * 0x2000;
+		return (offset + 0x2000 <= prg_rom_.size()) ? prg_rom_.data() + offset : OPEN_BUS_PAGE.data();
+	};
+	for (std::size_t slot = 0; slot < 3; ++slot) {
+		prg_map_[slot] = prg_page(prg_banks_[slot]);
+	}
+	prg_map_[3] = prg_page(bank_count - 1);
+	low_rom_page_ = prg_page(low_bank_ & 0x3F);
+
+	const std::size_t chr_count = std::max<std::size_t>(chr_mem_.size() / 0x400, 1);
+	for (std::size_t slot = 0; slot < chr_map_.size(); ++slot) {
+		const std::size_t offset = (chr_banks_[slot] % chr_count) * 0x400;
+		chr_map_[slot] = (offset + 0x400 <= chr_mem_.size()) ? chr_mem_.data() + offset : OPEN_BUS_PAGE.data();
+	}
+	chr_cache_.map_slots(chr_map_);
+	map_nametables(get_mirroring());
+}
+
+Byte Mapper069::cpu_read(Address address) const {
+	if (address >= 0x8000) {
+		return prg_map_[(address >> 13) & 0x03][address & 0x1FFF];
+	}
+	if (address >= 0x6000) {
+		if ((low_bank_ & 0x40) == 0) {
+			return low_rom_page_[address & 0x1FFF];
+		}
+		return (low_bank_ & 0x80) && !prg_ram_.empty() ? prg_ram_[(address - 0x6000) & prg_ram_mask_] : 0xFF;
+	}
+	return 0xFF; // Open bus
+}
+
+void Mapper069::cpu_write(Address address, Byte value) {
+	if (address < 0x6000) {
+		return;
+	}
+	if (address < 0x8000) {
+		if ((low_bank_ & 0xC0) == 0xC0 && !prg_ram_.empty()) {
+			prg_ram_[(address - 0x6000) & prg_ram_mask_] = value;
+			ram_written(RamKind::Prg, (address - 0x6000) & prg_ram_mask_);
+		}
+		return;
+	}
+
+	switch (address & 0xE000) {
+	case 0x8000:
+		command_ = value & 0x0F;
+		break;
+	case 0xA000:
+		write_parameter(value);
+		break;
+	case 0xC000:
+		audio_->select(value);
+		break;
+	default: // $E000
+		audio_->write(value);
+		break;
+	}
+}
+
+void Mapper069::write_parameter(Byte value) {
+	switch (command_) {
+	case 0x8:
+		low_bank_ = value;
+		break;
+	case 0x9:
+	case 0xA:
+	case 0xB:
+		prg_banks_[command_ - 0x9] = value & 0x3F;
+		break;
+	case 0xC:
+		mirroring_ = value & 0x03;
+		break;
+	case 0xD:
+		irq_enabled_ = (value & 0x01) != 0;
+		counter_enabled_ = (value & 0x80) != 0;
+		irq_pending_ = false;
+		return;
+	case 0xE:
+		irq_counter_ = static_cast<std::uint16_t>((irq_counter_ & 0xFF00) | value);
+		return;
+	case 0xF:
+		irq_counter_ = static_cast<std::uint16_t>((irq_counter_ & 0x00FF) | (value << 8));
+		return;
+	default: // $0-$7
+		chr_banks_[command_] = value;
+		break;
+	}
+	update_bank_maps();
+}
+
+Byte Mapper069::ppu_read(Address address) const {
+	if (!is_chr_address(address)) {
+		return 0xFF;
+	}
+	return chr_map_[address >> 10][address & 0x03FF];
+}
+
+void Mapper069::ppu_write(Address address, Byte value) {
+	if (!is_chr_address(address) || !chr_is_ram_) {
+		return;
+	}
+	const std::size_t chr_count = chr_ram_.size() / 0x400;
+	const std::size_t offset = (chr_banks_[address >> 10] % chr_count) * 0x400 + (address & 0x03FF);
+	chr_ram_[offset] = value;
+	ram_written(RamKind::Chr, offset);
+	chr_cache_.invalidate(offset);
+}
+
+Mapper::Mirroring Mapper069::get_mirroring() const noexcept {
+	switch (mirroring_) {
+	case 0:
+		return Mirroring::Vertical;
+	case 1:
+		return Mirroring::Horizontal;
+	case 2:
+		return Mirroring::SingleScreenLow;
+	default:
+		return Mirroring::SingleScreenHigh;
+	}
+}
+
+void Mapper069::run_cpu_cycle_timer(std::uint32_t cycles) noexcept {
+	if (!counter_enabled_ || cycles == 0) {
+		return;
+	}
+	// The IRQ rises on the decrement from $0000, counter + 1 cycles away
+	if (irq_enabled_ && cycles > irq_counter_) {
+		irq_pending_ = true;
+	}
+	irq_counter_ = static_cast<std::uint16_t>(irq_counter_ - cycles);
+}
+
+std::uint32_t Mapper069::cpu_cycles_until_irq() const noexcept {
+	if (!counter_enabled_ || !irq_enabled_ || irq_pending_) {
+		return NO_CYCLE_IRQ;
+	}
+	return static_cast<std::uint32_t>(irq_counter_) + 1;
+}
+
+void Mapper069::serialize_registers(std::vector<Byte> &buffer) const {
+	buffer.push_back(command_);
+	buffer.insert(buffer.end(), chr_banks_.begin(), chr_banks_.end());
+	buffer.push_back(low_bank_);
+	buffer.insert(buffer.end(), prg_banks_.begin(), prg_banks_.end());
+	buffer.push_back(mirroring_);
+	buffer.push_back(static_cast<Byte>((irq_enabled_ ? 0x01 : 0) | (counter_enabled_ ? 0x80 : 0)));
+	buffer.push_back(static_cast<Byte>(irq_counter_ & 0xFF));
+	buffer.push_back(static_cast<Byte>(irq_counter_ >> 8));
+	buffer.push_back(irq_pending_ ? 1 : 0);
+	audio_->serialize_state(buffer);
+}
+
+void Mapper069::deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) {
+	// command + 8 CHR banks + $6000 bank + 3 PRG banks
+	// + mirroring + IRQ control + counter (2) + pending
+	if (offset + 18 > buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (FME-7)");
+	}
+	command_ = buffer[offset++] & 0x0F;
+	std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), chr_banks_.size(), chr_banks_.begin());
+	offset += chr_banks_.size();
+	low_bank_ = buffer[offset++];
+	for (Byte &bank : prg_banks_) {
+		bank = buffer[offset++] & 0x3F;
+	}
+	mirroring_ = buffer[offset++] & 0x03;
+	const Byte control = buffer[offset++];
+	irq_enabled_ = (control & 0x01) != 0;
+	counter_enabled_ = (control & 0x80) != 0;
+	irq_counter_ = static_cast<std::uint16_t>(buffer[offset] | (buffer[offset + 1] << 8));
+	offset += 2;
+	irq_pending_ = buffer[offset++] != 0;
+	audio_->deserialize_state(buffer, offset);
+
+	update_bank_maps();
+	chr_cache_.invalidate_all(); // CHR RAM contents were restored wholesale
+}
+
+} // namespace nes
@@ -0,0 +1,183 @@
+#include "cartridge/mappers/mapper_085.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nes {
+
+Mapper085::Mapper085(std::span<const Byte> prg_rom, std::span<const Byte> chr_rom, Mirroring mirroring,
+					 bool battery_backed, RamSizes ram)
+	: prg_rom_(prg_rom), initial_mirroring_(mirroring), battery_backed_(battery_backed) {
+	prg_ram_.resize(ram.prg_ram, 0x00);
+	prg_ram_mask_ = prg_ram_window_mask(ram.prg_ram);
+
+	chr_is_ram_ = chr_rom.empty();
+	if (chr_is_ram_) {
+		chr_ram_.resize(std::max<std::size_t>(ram.chr_ram, 8192), 0x00);
+		chr_mem_ = chr_ram_;
+	} else {
+		chr_mem_ = chr_rom;
+	}
+
+	track_ram(RamKind::Prg, prg_ram_);
+	track_ram(RamKind::Chr, chr_ram_);
+	chr_cache_.attach(chr_mem_);
+	reset();
+}
+
+void Mapper085::reset() {
+	prg_banks_ = {0, 1, 2};
+	for (std::size_t i = 0; i < chr_banks_.size(); ++i) {
+		chr_banks_[i] = static_cast<Byte>(i);
+	}
+	control_ = initial_mirroring_ == Mirroring::Horizontal ? 0x01 : 0x00;
+	irq_ = VrcIrqCounter{};
+	irq_pending_ = false;
+	update_bank_maps();
+}
+
+void Mapper085::update_bank_maps() {
+	const std::size_t bank_count = std::max<std::size_t>(prg_rom_.size() / 0x2000, 1);
+	const std::array<std::size_t, 4> banks = {prg_banks_[0], prg_banks_[1], prg_banks_[2], bank_count - 1};
+	for (std::size_t slot = 0; slot < prg_map_.size(); ++slot) {
+		const std::size_t offset = (banks[slot] % bank_count) * 0x2000;
+		prg_map_[slot] = (offset + 0x2000 <= prg_rom_.size()) ? prg_rom_.data() + offset : OPEN_BUS_PAGE.data();
+	}
+	const std::size_t chr_count = std::max<std::size_t>(chr_mem_.size() / 0x400, 1);
+	for (std::size_t slot = 0; slot < chr_map_.size(); ++slot) {
+		const std::size_t offset = (chr_banks_[slot] % chr_count) * 0x400;
+		chr_map_[slot] = (offset + 0x400 <= chr_mem_.size()) ? chr_mem_.data() + offset : OPEN_BUS_PAGE.data();
+	}
+	chr_cache_.map_slots(chr_map_);
+	map_nametables(get_mirroring());
+}
+
+Byte Mapper085::cpu_read(Address address) const {
+	if (address >= 0x6000 && address < 0x8000) {
+		return is_prg_ram_enabled() && !prg_ram_.empty() ? prg_ram_[(address - 0x6000) & prg_ram_mask_] : 0xFF;
+	}
+	if (address >= 0x8000) {
+		return prg_map_[(address >> 13) & 0x03][address & 0x1FFF];
+	}
+	return 0xFF; // Open bus
+}
+
+void Mapper085::cpu_write(Address address, Byte value) {
+	if (address >= 0x6000 && address < 0x8000) {
+		if (is_prg_ram_enabled() && !prg_ram_.empty()) {
+			prg_ram_[(address - 0x6000) & prg_ram_mask_] = value;
+			ram_written(RamKind::Prg, (address - 0x6000) & prg_ram_mask_);
+		}
+		return;
+	}
+	if (address < 0x8000) {
+		return;
+	}
+
+	// Second register of the pair when A4 (VRC7a) or A3 (VRC7b) is set
+	const bool odd = (address & 0x0018) != 0;
+	switch (address & 0xF000) {
+	case 0x8000:
+		prg_banks_[odd ? 1 : 0] = value & 0x3F;
+		break;
+	case 0x9000:
+		if (odd || (address & 0x0020) != 0) {
+			return; // FM sound registers
+		}
+		prg_banks_[2] = value & 0x3F;
+		break;
+	case 0xA000:
+	case 0xB000:
+	case 0xC000:
+	case 0xD000:
+		chr_banks_[((address >> 12) - 0x0A) * 2 + (odd ? 1 : 0)] = value;
+		break;
+	case 0xE000:
+		if (odd) {
+			irq_.latch = value;
+			return;
+		}
+		control_ = value;
+		break;
+	default: // $F000
+		if (odd) {
+			irq_.acknowledge();
+		} else {
+			irq_.write_control(value);
+		}
+		irq_pending_ = false;
+		return;
+	}
+	update_bank_maps();
+}
+
+Byte Mapper085::ppu_read(Address address) const {
+	if (!is_chr_address(address)) {
+		return 0xFF;
+	}
+	return chr_map_[address >> 10][address & 0x03FF];
+}
+
+void Mapper085::ppu_write(Address address, Byte value) {
+	if (!is_chr_address(address) || !chr_is_ram_) {
+		return;
+	}
+	const std::size_t chr_count = chr_ram_.size() / 0x400;
+	const std::size_t offset = (chr_banks_[address >> 10] % chr_count) * 0x400 + (address & 0x03FF);
+	chr_ram_[offset] = value;
+	ram_written(RamKind::Chr, offset);
+	chr_cache_.invalidate(offset);
+}
+
+Mapper::Mirroring Mapper085::get_mirroring() const noexcept {
+	switch (control_ & 0x03) {
+	case 0:
+		return Mirroring::Vertical;
+	case 1:
+		return Mirroring::Horizontal;
+	case 2:
+		return Mirroring::SingleScreenLow;
+	default:
+		return Mirroring::SingleScreenHigh;
+	}
+}
+
+void Mapper085::run_cpu_cycle_timer(std::uint32_t cycles) noexcept {
+	if (irq_.run(cycles)) {
+		irq_pending_ = true;
+	}
+}
+
+std::uint32_t Mapper085::cpu_cycles_until_irq() const noexcept {
+	return irq_pending_ ? NO_CYCLE_IRQ : irq_.cycles_until_overflow();
+}
+
+void Mapper085::serialize_registers(std::vector<Byte> &buffer) const {
+	buffer.insert(buffer.end(), prg_banks_.begin(), prg_banks_.end());
+	buffer.insert(buffer.end(), chr_banks_.begin(), chr_banks_.end());
+	buffer.push_back(control_);
+	irq_.serialize(buffer);
+	buffer.push_back(irq_pending_ ? 1 : 0);
+}
+
+void Mapper085::deserialize_registers(const std::vector<Byte> &buffer, size_t &offset) {
+	// 3 PRG banks + 8 CHR banks + control
+	if (offset + 12 > buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (VRC7)");
+	}
+	for (Byte &bank : prg_banks_) {
+		bank = buffer[offset++] & 0x3F;
+	}
+	std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), chr_banks_.size(), chr_banks_.begin());
+	offset += chr_banks_.size();
+	control_ = buffer[offset++];
+	irq_.deserialize(buffer, offset);
+	if (offset >= buffer.size()) {
+		throw std::runtime_error("save state: unexpected end of buffer (VRC7)");
+	}
+	irq_pending_ = buffer[offset++] != 0;
+
+	update_bank_maps();
+	chr_cache_.invalidate_all(); // CHR RAM contents were restored wholesale
+}
+
+} // namespace nes
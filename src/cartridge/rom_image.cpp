@@ -0,0 +1,146 @@
+#include "cartridge/rom_image.hpp"
+#include "core/checksum.hpp"
+#include <fstream>
+#include <iostream>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nes {
+
+std::shared_ptr<const RomImage> RomImage::load(const std::string &filepath) {
+	std::shared_ptr<RomImage> image(new RomImage());
+	std::span<const Byte> file;
+	if (image->map_file(filepath)) {
+		file = {image->mapping_, image->mapping_size_};
+	} else {
+		// No mapping (empty file, special file, platform without mmap): one
+		// private copy, still shared by every cartridge given this image
+		std::ifstream in(filepath, std::ios::binary | std::ios::ate);
+		if (!in) {
+			std::cerr << "Failed to read ROM file: " << filepath << std::endl;
+			return nullptr;
+		}
+		image->owned_.resize(static_cast<std::size_t>(in.tellg()));
+		in.seekg(0);
+		in.read(reinterpret_cast<char *>(image->owned_.data()), static_cast<std::streamsize>(image->owned_.size()));
+		if (!in) {
+			std::cerr << "Failed to read ROM file: " << filepath << std::endl;
+			return nullptr;
+		}
+		file = image->owned_;
+	}
+
+	RomLoader::Layout layout;
+	if (!RomLoader::parse_image(file, filepath, image->header_, layout)) {
+		return nullptr;
+	}
+	image->trainer_ = file.subspan(layout.trainer_offset, layout.trainer_size);
+	image->prg_rom_ = file.subspan(layout.prg_offset, layout.prg_size);
+	image->chr_rom_ = file.subspan(layout.chr_offset, layout.chr_size);
+	image->prg_crc32_ = crc32(image->prg_rom_.data(), image->prg_rom_.size());
+	return image;
+}
+
+std::shared_ptr<const RomImage> RomImage::from_rom_data(const RomData &rom_data) {
+	if (!rom_data.valid) {
+		return nullptr;
+	}
+	std::shared_ptr<RomImage> image(new RomImage());
+	image->header_ = rom_data;
+	image->header_.prg_rom.clear();
+	image->header_.chr_rom.clear();
+	image->header_.trainer.clear();
+
+	std::vector<Byte> &bytes = image->owned_;
+	bytes.reserve(rom_data.trainer.size() + rom_data.prg_rom.size() + rom_data.chr_rom.size());
+	bytes.insert(bytes.end(), rom_data.trainer.begin(), rom_data.trainer.end());
+	bytes.insert(bytes.end(), rom_data.prg_rom.begin(), rom_data.prg_rom.end());
+	bytes.insert(bytes.end(), rom_data.chr_rom.begin(), rom_data.chr_rom.end());
+	const std::span<const Byte> all = bytes;
+	image->trainer_ = all.first(rom_data.trainer.size());
+	image->prg_rom_ = all.subspan(rom_data.trainer.size(), rom_data.prg_rom.size());
+	image->chr_rom_ = all.subspan(rom_data.trainer.size() + rom_data.prg_rom.size(), rom_data.chr_rom.size());
+	image->prg_crc32_ = crc32(image->prg_rom_.data(), image->prg_rom_.size());
+	return image;
+}
+
+RomImage::~RomImage() {
+	unmap_file();
+}
+
+#if defined(_WIN32)
+
+bool RomImage::map_file(const std::string &filepath) {
+	HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+							  FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER size{};
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+	CloseHandle(file);
+	if (!mapping) {
+		return false;
+	}
+	// The view keeps the mapping alive on its own
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view) {
+		return false;
+	}
+	mapping_ = static_cast<const Byte *>(view);
+	mapping_size_ = static_cast<std::size_t>(size.QuadPart);
+	return true;
+}
+
+void RomImage::unmap_file() noexcept {
+	if (mapping_) {
+		UnmapViewOfFile(mapping_);
+		mapping_ = nullptr;
+	}
+}
+
+#else
+
+bool RomImage::map_file(const std::string &filepath) {
+	const int fd = ::open(filepath.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info {};
+	void *view = MAP_FAILED;
+	if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+		view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	// The mapping keeps the file alive on its own
+	::close(fd);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+	mapping_ = static_cast<const Byte *>(view);
+	mapping_size_ = static_cast<std::size_t>(info.st_size);
+	return true;
+}
+
+void RomImage::unmap_file() noexcept {
+	if (mapping_) {
+		::munmap(const_cast<Byte *>(mapping_), mapping_size_);
+		mapping_ = nullptr;
+	}
+}
+
+#endif
+
+} // namespace nes
@@ -0,0 +1,381 @@
+#include "cartridge/rom_library.hpp"
+#include "cartridge/rom_image.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace nes {
+
+namespace {
+
+// Index file: "VNROMIDX", version, entry count, then per entry
+//   [path length u16][path][size u64][mtime i64][flags u8][mapper u16][submapper u8]
+//   [PRG pages u16][CHR pages u16][CRC-32 u32][SHA-1, 20 bytes]
+// All fields little-endian.
+constexpr char INDEX_MAGIC[8] = {'V', 'N', 'R', 'O', 'M', 'I', 'D', 'X'};
+constexpr std::uint32_t INDEX_VERSION = 1;
+
+enum EntryFlags : std::uint8_t {
+	FLAG_VALID = 0x01,
+	FLAG_NES2_0 = 0x02,
+	FLAG_VERTICAL = 0x04,
+	FLAG_FOUR_SCREEN = 0x08,
+	FLAG_BATTERY = 0x10,
+};
+
+// Hashed files between republishing the entries during a scan
+constexpr std::size_t PUBLISH_INTERVAL = 32;
+
+template <typename T>
+void put(std::vector<std::uint8_t> &out, T value) {
+	const auto *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+class IndexReader {
+  public:
+	explicit IndexReader(const std::vector<std::uint8_t> &data) : data_(data) {
+	}
+
+	template <typename T>
+	bool get(T &value) {
+		return get_bytes(&value, sizeof(T));
+	}
+	bool get_bytes(void *out, std::size_t size) {
+		if (data_.size() - offset_ < size) {
+			return false;
+		}
+		std::memcpy(out, data_.data() + offset_, size);
+		offset_ += size;
+		return true;
+	}
+
+  private:
+	const std::vector<std::uint8_t> &data_;
+	std::size_t offset_ = 0;
+};
+
+std::string to_lower(std::string_view text) {
+	std::string lower(text);
+	std::transform(lower.begin(), lower.end(), lower.begin(),
+				   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return lower;
+}
+
+bool is_nes_extension(const std::filesystem::path &path) {
+	return to_lower(path.extension().string()) == ".nes";
+}
+
+auto find_path(std::vector<RomLibrary::Entry> &entries, const std::string &path) {
+	return std::lower_bound(entries.begin(), entries.end(), path,
+							[](const RomLibrary::Entry &entry, const std::string &p) { return entry.path < p; });
+}
+
+} // namespace
+
+RomLibrary::RomLibrary(std::filesystem::path root, std::filesystem::path index_file)
+	: root_(std::move(root)), index_file_(std::move(index_file)) {
+}
+
+RomLibrary::~RomLibrary() {
+	cancel_scan();
+}
+
+bool RomLibrary::load_index() {
+	std::ifstream file(index_file_, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	const std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	IndexReader reader(data);
+
+	char magic[sizeof(INDEX_MAGIC)];
+	std::uint32_t version = 0;
+	std::uint32_t count = 0;
+	if (!reader.get_bytes(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+		!reader.get(version) || version != INDEX_VERSION || !reader.get(count)) {
+		std::cerr << "RomLibrary: " << index_file_.string() << " is not a ROM index" << std::endl;
+		return false;
+	}
+
+	std::vector<Entry> entries;
+	entries.reserve(std::min<std::size_t>(count, data.size() / 64));
+	for (std::uint32_t i = 0; i < count; ++i) {
+		Entry entry;
+		std::uint16_t path_length = 0;
+		std::uint8_t flags = 0;
+		if (!reader.get(path_length)) {
+			break;
+		}
+		entry.path.resize(path_length);
+		if (!reader.get_bytes(entry.path.data(), path_length) || !reader.get(entry.size) || !reader.get(entry.mtime) ||
+			!reader.get(flags) || !reader.get(entry.mapper_id) || !reader.get(entry.submapper) ||
+			!reader.get(entry.prg_rom_pages) || !reader.get(entry.chr_rom_pages) || !reader.get(entry.crc32) ||
+			!reader.get_bytes(entry.sha1.data(), entry.sha1.size())) {
+			break;
+		}
+		entry.valid = (flags & FLAG_VALID) != 0;
+		entry.nes2_0 = (flags & FLAG_NES2_0) != 0;
+		entry.vertical_mirroring = (flags & FLAG_VERTICAL) != 0;
+		entry.four_screen_vram = (flags & FLAG_FOUR_SCREEN) != 0;
+		entry.battery_backed_ram = (flags & FLAG_BATTERY) != 0;
+		entries.push_back(std::move(entry));
+	}
+	if (entries.size() != count) {
+		std::cerr << "RomLibrary: " << index_file_.string() << " is truncated" << std::endl;
+		return false;
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.path < b.path; });
+	publish(std::move(entries));
+	return true;
+}
+
+bool RomLibrary::save_index() const {
+	std::vector<std::uint8_t> data;
+	{
+		std::shared_lock lock(mutex_);
+		data.reserve(16 + entries_.size() * 96);
+		data.insert(data.end(), std::begin(INDEX_MAGIC), std::end(INDEX_MAGIC));
+		put(data, INDEX_VERSION);
+		put(data, static_cast<std::uint32_t>(entries_.size()));
+		for (const Entry &entry : entries_) {
+			const std::uint8_t flags = (entry.valid ? FLAG_VALID : 0) | (entry.nes2_0 ? FLAG_NES2_0 : 0) |
+									   (entry.vertical_mirroring ? FLAG_VERTICAL : 0) |
+									   (entry.four_screen_vram ? FLAG_FOUR_SCREEN : 0) |
+									   (entry.battery_backed_ram ? FLAG_BATTERY : 0);
+			const auto path_length = static_cast<std::uint16_t>(std::min<std::size_t>(entry.path.size(), 0xFFFF));
+			put(data, path_length);
+			data.insert(data.end(), entry.path.begin(), entry.path.begin() + path_length);
+			put(data, entry.size);
+			put(data, entry.mtime);
+			put(data, flags);
+			put(data, entry.mapper_id);
+			put(data, entry.submapper);
+			put(data, entry.prg_rom_pages);
+			put(data, entry.chr_rom_pages);
+			put(data, entry.crc32);
+			data.insert(data.end(), entry.sha1.begin(), entry.sha1.end());
+		}
+	}
+
+	// Written beside the index and renamed over it, so a crash never leaves
+	// half an index behind
+	std::error_code ec;
+	if (index_file_.has_parent_path()) {
+		std::filesystem::create_directories(index_file_.parent_path(), ec);
+	}
+	std::filesystem::path temp = index_file_;
+	temp += ".tmp";
+	{
+		std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+		if (!file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()))) {
+			std::cerr << "RomLibrary: cannot write " << temp.string() << std::endl;
+			return false;
+		}
+	}
+	std::filesystem::rename(temp, index_file_, ec);
+	if (ec) {
+		std::cerr << "RomLibrary: cannot replace " << index_file_.string() << ": " << ec.message() << std::endl;
+		std::filesystem::remove(temp, ec);
+		return false;
+	}
+	return true;
+}
+
+void RomLibrary::start_scan() {
+	if (scanning_.exchange(true, std::memory_order_acq_rel)) {
+		return;
+	}
+	if (scan_thread_.joinable()) {
+		scan_thread_.join();
+	}
+	cancel_.store(false, std::memory_order_relaxed);
+	scan_thread_ = std::thread([this] {
+		scan();
+		scanning_.store(false, std::memory_order_release);
+	});
+}
+
+void RomLibrary::cancel_scan() {
+	cancel_.store(true, std::memory_order_relaxed);
+	wait_for_scan();
+	cancel_.store(false, std::memory_order_relaxed);
+}
+
+void RomLibrary::wait_for_scan() {
+	if (scan_thread_.joinable()) {
+		scan_thread_.join();
+	}
+}
+
+RomLibrary::ScanStats RomLibrary::scan() {
+	std::lock_guard scan_lock(scan_mutex_);
+	ScanStats stats;
+
+	std::error_code ec;
+	if (!std::filesystem::is_directory(root_, ec)) {
+		// Storage not there (card out, share offline): keep what is indexed
+		// rather than dropping it all
+		std::lock_guard lock(mutex_);
+		last_stats_ = stats;
+		return stats;
+	}
+
+	// working starts as the current entries and gets new/changed entries
+	// merged in as they are hashed, which is what is published mid-scan;
+	// found is what the finished scan will leave
+	std::vector<Entry> working = entries();
+	const std::size_t previous_count = working.size();
+	std::vector<Entry> found;
+	found.reserve(previous_count);
+	std::size_t added = 0;
+	bool complete = true;
+
+	auto it = std::filesystem::recursive_directory_iterator(
+		root_, std::filesystem::directory_options::skip_permission_denied, ec);
+	for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+		if (cancel_.load(std::memory_order_relaxed)) {
+			complete = false;
+			break;
+		}
+		const std::filesystem::directory_entry &file = *it;
+		std::error_code file_ec;
+		if (!file.is_regular_file(file_ec) || !is_nes_extension(file.path())) {
+			continue;
+		}
+		const std::uint64_t size = file.file_size(file_ec);
+		const std::int64_t mtime = file.last_write_time(file_ec).time_since_epoch().count();
+		if (file_ec) {
+			continue;
+		}
+		++stats.files;
+
+		std::string path = file.path().lexically_relative(root_).generic_string();
+		auto known = find_path(working, path);
+		const bool exists = known != working.end() && known->path == path;
+		if (exists && known->size == size && known->mtime == mtime) {
+			found.push_back(*known);
+			continue;
+		}
+
+		Entry entry = read_entry(file.path());
+		entry.path = std::move(path);
+		entry.size = size;
+		entry.mtime = mtime;
+		found.push_back(entry);
+		if (exists) {
+			*known = std::move(entry);
+		} else {
+			working.insert(known, std::move(entry));
+			++added;
+		}
+		if (++stats.hashed % PUBLISH_INTERVAL == 0) {
+			publish(working);
+		}
+	}
+	if (ec) {
+		std::cerr << "RomLibrary: error listing " << root_.string() << ": " << ec.message() << std::endl;
+		complete = false;
+	}
+
+	// A cut-short scan has not seen every file, so it cannot tell which are gone
+	if (complete) {
+		stats.removed = previous_count + added - found.size();
+		if (stats.hashed != 0 || stats.removed != 0) {
+			std::sort(found.begin(), found.end(), [](const Entry &a, const Entry &b) { return a.path < b.path; });
+			publish(std::move(found));
+		}
+	} else if (stats.hashed != 0) {
+		publish(std::move(working));
+	}
+	{
+		std::lock_guard lock(mutex_);
+		last_stats_ = stats;
+	}
+	if (stats.hashed != 0 || stats.removed != 0) {
+		save_index();
+	}
+	return stats;
+}
+
+std::vector<RomLibrary::Entry> RomLibrary::search(std::string_view query, std::size_t limit) const {
+	const std::string needle = to_lower(query);
+	std::uint32_t crc = 0;
+	const bool crc_query = needle.size() == 8 &&
+						   std::from_chars(needle.data(), needle.data() + needle.size(), crc, 16).ptr ==
+							   needle.data() + needle.size();
+
+	std::vector<Entry> results;
+	std::shared_lock lock(mutex_);
+	for (std::size_t i = 0; i < entries_.size(); ++i) {
+		if (limit != 0 && results.size() == limit) {
+			break;
+		}
+		const Entry &entry = entries_[i];
+		if (names_[i].find(needle) != std::string::npos || (crc_query && entry.valid && entry.crc32 == crc)) {
+			results.push_back(entry);
+		}
+	}
+	return results;
+}
+
+std::vector<RomLibrary::Entry> RomLibrary::entries() const {
+	std::shared_lock lock(mutex_);
+	return entries_;
+}
+
+std::size_t RomLibrary::size() const {
+	std::shared_lock lock(mutex_);
+	return entries_.size();
+}
+
+RomLibrary::ScanStats RomLibrary::get_last_scan_stats() const {
+	std::shared_lock lock(mutex_);
+	return last_stats_;
+}
+
+RomLibrary::Entry RomLibrary::read_entry(const std::filesystem::path &file) {
+	Entry entry;
+	const auto image = RomImage::load(file.string());
+	if (!image) {
+		return entry;
+	}
+	const RomData &header = image->header();
+	entry.valid = true;
+	entry.nes2_0 = header.nes2_0;
+	entry.vertical_mirroring = header.vertical_mirroring;
+	entry.four_screen_vram = header.four_screen_vram;
+	entry.battery_backed_ram = header.battery_backed_ram;
+	entry.mapper_id = header.mapper_id;
+	entry.submapper = header.submapper;
+	entry.prg_rom_pages = header.prg_rom_pages;
+	entry.chr_rom_pages = header.chr_rom_pages;
+
+	Sha1 sha1;
+	entry.crc32 = crc32(image->chr_rom().data(), image->chr_rom().size(), image->prg_crc32());
+	sha1.update(image->prg_rom().data(), image->prg_rom().size());
+	sha1.update(image->chr_rom().data(), image->chr_rom().size());
+	entry.sha1 = sha1.finish();
+	return entry;
+}
+
+void RomLibrary::publish(std::vector<Entry> entries) {
+	std::vector<std::string> names;
+	names.reserve(entries.size());
+	for (const Entry &entry : entries) {
+		names.push_back(to_lower(entry.path));
+	}
+	{
+		std::unique_lock lock(mutex_);
+		entries_ = std::move(entries);
+		names_ = std::move(names);
+	}
+	generation_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+} // namespace nes
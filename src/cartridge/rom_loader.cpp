@@ -16,71 +16,88 @@ RomData RomLoader::load_rom(const std::string &filepath) {
 		return rom_data;
 	}
 
+	Layout layout;
+	if (!parse_image(file_data, filepath, rom_data, layout)) {
+		rom_data.valid = false;
+		return rom_data;
+	}
+
+	const auto section = [&file_data](std::size_t offset, std::size_t size) {
+		return std::vector<Byte>(file_data.begin() + static_cast<std::ptrdiff_t>(offset),
+								 file_data.begin() + static_cast<std::ptrdiff_t>(offset + size));
+	};
+	rom_data.trainer = section(layout.trainer_offset, layout.trainer_size);
+	rom_data.prg_rom = section(layout.prg_offset, layout.prg_size);
+	rom_data.chr_rom = section(layout.chr_offset, layout.chr_size);
+	return rom_data;
+}
+
+bool RomLoader::parse_image(std::span<const Byte> image, const std::string &filepath, RomData &rom_data,
+							Layout &layout) {
 	// Validate minimum size
-	if (file_data.size() < INES_HEADER_SIZE) {
+	if (image.size() < INES_HEADER_SIZE) {
 		std::cerr << "File too small to be valid iNES ROM: " << filepath << std::endl;
-		return rom_data;
+		return false;
 	}
 
 	// Extract and validate header
-	std::vector<Byte> header(file_data.begin(), file_data.begin() + INES_HEADER_SIZE);
+	const std::span<const Byte> header = image.first(INES_HEADER_SIZE);
 	if (!validate_header(header)) {
 		std::cerr << "Invalid iNES header: " << filepath << std::endl;
-		return rom_data;
+		return false;
 	}
 
 	// Parse header
 	rom_data = parse_header(header);
 	rom_data.filename = filepath;
 
+	// NES 2.0 exponent-multiplier sizes (MSB nibble $F) describe ROMs that
+	// are not a whole number of pages; no supported mapper uses them
+	if (rom_data.nes2_0 && ((image[9] & 0x0F) == 0x0F || (image[9] & 0xF0) == 0xF0)) {
+		std::cerr << "NES 2.0 exponent ROM sizes are not supported: " << filepath << std::endl;
+		return false;
+	}
+
 	// Calculate expected sizes
 	std::size_t expected_prg_size = rom_data.prg_rom_pages * PRG_ROM_PAGE_SIZE;
 	std::size_t expected_chr_size = rom_data.chr_rom_pages * CHR_ROM_PAGE_SIZE;
 	std::size_t trainer_size = rom_data.trainer_present ? TRAINER_SIZE : 0;
 	std::size_t expected_total = INES_HEADER_SIZE + trainer_size + expected_prg_size + expected_chr_size;
 
-	if (file_data.size() < expected_total) {
+	if (image.size() < expected_total) {
 		std::cerr << "ROM file smaller than expected: " << filepath << std::endl;
-		std::cerr << "Expected: " << expected_total << " bytes, got: " << file_data.size() << std::endl;
-		return rom_data;
-	}
-
-	// Extract data sections
-	std::size_t offset = INES_HEADER_SIZE;
-
-	// Trainer (if present)
-	if (rom_data.trainer_present) {
-		rom_data.trainer.assign(file_data.begin() + offset, file_data.begin() + offset + TRAINER_SIZE);
-		offset += TRAINER_SIZE;
-	}
-
-	// PRG ROM
-	if (expected_prg_size > 0) {
-		rom_data.prg_rom.assign(file_data.begin() + offset, file_data.begin() + offset + expected_prg_size);
-		offset += expected_prg_size;
-	}
-
-	// CHR ROM
-	if (expected_chr_size > 0) {
-		rom_data.chr_rom.assign(file_data.begin() + offset, file_data.begin() + offset + expected_chr_size);
+		std::cerr << "Expected: " << expected_total << " bytes, got: " << image.size() << std::endl;
+		return false;
 	}
 
-	rom_data.valid = true;
-
-	return rom_data;
+	// Sections follow the header: trainer (if present), PRG ROM, CHR ROM
+	layout.trainer_offset = INES_HEADER_SIZE;
+	layout.trainer_size = trainer_size;
+	layout.prg_offset = INES_HEADER_SIZE + trainer_size;
+	layout.prg_size = expected_prg_size;
+	layout.chr_offset = layout.prg_offset + expected_prg_size;
+	layout.chr_size = expected_chr_size;
+	return true;
 }
 
 bool RomLoader::is_valid_nes_file(const std::string &filepath) {
-	std::vector<Byte> file_data = read_file(filepath);
-	if (file_data.size() < INES_HEADER_SIZE) {
+	RomData header;
+	return read_header(filepath, header);
+}
+
+bool RomLoader::read_header(const std::string &filepath, RomData &rom_data) {
+	std::array<Byte, INES_HEADER_SIZE> header{};
+	std::ifstream file(filepath, std::ios::binary);
+	if (!file.read(reinterpret_cast<char *>(header.data()), static_cast<std::streamsize>(header.size())) ||
+		!validate_header(header)) {
 		return false;
 	}
-
-	std::vector<Byte> header(file_data.begin(), file_data.begin() + INES_HEADER_SIZE);
-	return validate_header(header);
+	rom_data = parse_header(header);
+	rom_data.filename = filepath;
+	return true;
 }
 
-bool RomLoader::validate_header(const std::vector<Byte> &header) {
+bool RomLoader::validate_header(std::span<const Byte> header) {
 	if (header.size() < INES_HEADER_SIZE) {
 		return false;
 	}
@@ -95,7 +112,7 @@ bool RomLoader::validate_header(const std::vector<Byte> &header) {
 	return true;
 }
 
-RomData RomLoader::parse_header(const std::vector<Byte> &header) {
+RomData RomLoader::parse_header(std::span<const Byte> header) {
 	RomData rom_data{};
 
 	// Bytes 4-5: ROM sizes
@@ -114,11 +131,42 @@ RomData RomLoader::parse_header(const std::vector<Byte> &header) {
 
 	// Mapper ID: combine lower and upper nibbles
 	rom_data.mapper_id = (flags6 >> 4) | (flags7 & 0xF0);
+	rom_data.console_type = static_cast<ConsoleType>(flags7 & 0x03);
+	rom_data.timing = TimingRegion::Ntsc;
+
+	if ((flags7 & 0x0C) == 0x08) {
+		// NES 2.0: byte 8 holds mapper bits 8-11 and the submapper, byte 9
+		// the high nibbles of the PRG/CHR page counts
+		rom_data.nes2_0 = true;
+		rom_data.mapper_id |= static_cast<std::uint16_t>((header[8] & 0x0F) << 8);
+		rom_data.submapper = static_cast<std::uint8_t>(header[8] >> 4);
+		rom_data.prg_rom_pages |= static_cast<std::uint16_t>((header[9] & 0x0F) << 8);
+		rom_data.chr_rom_pages |= static_cast<std::uint16_t>((header[9] & 0xF0) << 4);
+
+		// Bytes 10-11: volatile (low nibble) and battery-backed (high nibble)
+		// RAM as shift counts, byte 12: CPU/PPU timing
+		rom_data.prg_ram_size = ram_shift_size(header[10] & 0x0F);
+		rom_data.prg_nvram_size = ram_shift_size(header[10] >> 4);
+		rom_data.chr_ram_size = ram_shift_size(header[11] & 0x0F);
+		rom_data.chr_nvram_size = ram_shift_size(header[11] >> 4);
+		rom_data.timing = static_cast<TimingRegion>(header[12] & 0x03);
+		rom_data.expansion_device = static_cast<std::uint8_t>(header[15] & 0x3F);
+	} else if ((header[12] | header[13] | header[14] | header[15]) != 0) {
+		// Archaic iNES with junk in bytes 7-15 (e.g. "DiskDude!"): byte 7's
+		// mapper nibble is part of the junk
+		rom_data.mapper_id = flags6 >> 4;
+		rom_data.console_type = ConsoleType::Nes;
+	}
 
 	rom_data.valid = true;
 	return rom_data;
 }
 
+std::uint32_t RomLoader::ram_shift_size(Byte shift) noexcept {
+	// 0 means none; otherwise 64 << shift bytes (shift 15 is reserved)
+	return shift == 0 ? 0 : 64u << shift;
+}
+
 std::vector<Byte> RomLoader::read_file(const std::string &filepath) {
 	std::ifstream file(filepath, std::ios::binary);
 	if (!file.is_open()) {
@@ -0,0 +1,137 @@
+#include "cartridge/rom_preloader.hpp"
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+namespace nes {
+
+namespace {
+
+constexpr std::size_t PAGE_SIZE = 4096;
+
+// Read every page of a mapped section so the first frames do not fault it in
+// (PRG is already read whole by the CRC)
+void touch_pages(std::span<const Byte> bytes) {
+	Byte sum = 0;
+	for (std::size_t offset = 0; offset < bytes.size(); offset += PAGE_SIZE) {
+		sum ^= bytes[offset];
+	}
+	[[maybe_unused]] volatile Byte sink = sum;
+}
+
+std::optional<std::vector<Byte>> read_save_file(const std::filesystem::path &path) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return std::nullopt;
+	}
+	const std::streamsize size = file.tellg();
+	if (size <= 0) {
+		return std::nullopt;
+	}
+	std::vector<Byte> data(static_cast<std::size_t>(size));
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char *>(data.data()), size)) {
+		return std::nullopt;
+	}
+	return data;
+}
+
+} // namespace
+
+RomPreloader::~RomPreloader() {
+	if (pending_.result.valid()) {
+		pending_.result.wait();
+	}
+}
+
+void RomPreloader::prefetch(const std::string &rom_path, const std::filesystem::path &save_path) {
+	if (pending_.result.valid() && pending_.rom_path == rom_path && pending_.save_path == save_path) {
+		return;
+	}
+	if (pending_.result.valid()) {
+		pending_.result.wait(); // Dropped, but not while the worker still runs
+	}
+	pending_.rom_path = rom_path;
+	pending_.save_path = save_path;
+	pending_.result = std::async(std::launch::async, [rom_path, save_path, cached = find_resident(rom_path)] {
+		return load(rom_path, save_path, cached);
+	});
+}
+
+PreloadedRom RomPreloader::take(const std::string &rom_path, const std::filesystem::path &save_path) {
+	Loaded loaded;
+	if (pending_.result.valid() && pending_.rom_path == rom_path && pending_.save_path == save_path) {
+		loaded = pending_.result.get();
+	} else {
+		if (pending_.result.valid()) {
+			pending_.result.wait();
+			pending_.result = {};
+		}
+		loaded = load(rom_path, save_path, find_resident(rom_path));
+	}
+	keep_resident(loaded);
+	return std::move(loaded.rom);
+}
+
+void RomPreloader::set_resident_limit(std::size_t limit) {
+	resident_limit_ = limit;
+	if (resident_.size() > limit) {
+		resident_.resize(limit);
+	}
+}
+
+RomPreloader::FileStamp RomPreloader::stamp_of(const std::string &path) {
+	std::error_code error;
+	FileStamp stamp;
+	stamp.size = std::filesystem::file_size(path, error);
+	if (error) {
+		return {};
+	}
+	stamp.mtime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+	stamp.valid = !error;
+	return stamp;
+}
+
+RomPreloader::Loaded RomPreloader::load(const std::string &rom_path, const std::filesystem::path &save_path,
+										const std::optional<ResidentImage> &cached) {
+	Loaded loaded;
+	loaded.rom.path = rom_path;
+	loaded.stamp = stamp_of(rom_path);
+	if (cached && loaded.stamp.valid && cached->stamp == loaded.stamp) {
+		loaded.rom.image = cached->image;
+		loaded.rom.resident = true;
+	} else {
+		loaded.rom.image = RomImage::load(rom_path);
+		if (loaded.rom.image) {
+			touch_pages(loaded.rom.image->chr_rom());
+		}
+	}
+	if (!save_path.empty()) {
+		loaded.rom.save_read = true;
+		loaded.rom.save = read_save_file(save_path);
+	}
+	return loaded;
+}
+
+std::optional<RomPreloader::ResidentImage> RomPreloader::find_resident(const std::string &path) const {
+	const auto found =
+		std::find_if(resident_.begin(), resident_.end(), [&](const ResidentImage &image) { return image.path == path; });
+	if (found == resident_.end()) {
+		return std::nullopt;
+	}
+	return *found;
+}
+
+void RomPreloader::keep_resident(const Loaded &loaded) {
+	std::erase_if(resident_, [&](const ResidentImage &image) { return image.path == loaded.rom.path; });
+	if (!loaded.rom.image || !loaded.stamp.valid || resident_limit_ == 0) {
+		return;
+	}
+	resident_.insert(resident_.begin(), ResidentImage{loaded.rom.path, loaded.stamp, loaded.rom.image});
+	if (resident_.size() > resident_limit_) {
+		resident_.resize(resident_limit_);
+	}
+}
+
+} // namespace nes
@@ -0,0 +1,71 @@
+#include "core/accuracy.hpp"
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nes {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+	const std::size_t first = text.find_first_not_of(" \t\r");
+	if (first == std::string_view::npos) {
+		return {};
+	}
+	const std::size_t last = text.find_last_not_of(" \t\r");
+	return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+bool AccuracyDatabase::load(const std::filesystem::path &path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return parse(text);
+}
+
+bool AccuracyDatabase::parse(std::string_view text) {
+	// Parsed whole before anything is added, so a bad file changes nothing
+	std::vector<std::pair<std::uint32_t, Accuracy>> parsed;
+	while (!text.empty()) {
+		const std::size_t end = text.find('\n');
+		std::string_view line = text.substr(0, end);
+		text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+
+		line = trim(line.substr(0, line.find('#')));
+		if (line.empty()) {
+			continue;
+		}
+		const std::size_t gap = line.find_first_of(" \t");
+		if (gap == std::string_view::npos) {
+			return false;
+		}
+		const std::string_view crc_text = line.substr(0, gap);
+		const std::string_view profile = trim(line.substr(gap));
+
+		std::uint32_t crc = 0;
+		const auto [next, error] = std::from_chars(crc_text.data(), crc_text.data() + crc_text.size(), crc, 16);
+		if (error != std::errc{} || next != crc_text.data() + crc_text.size()) {
+			return false;
+		}
+		if (profile == "strict") {
+			parsed.emplace_back(crc, Accuracy::Strict);
+		} else if (profile == "fast") {
+			parsed.emplace_back(crc, Accuracy::Fast);
+		} else {
+			return false;
+		}
+	}
+	for (const auto &[crc, accuracy] : parsed) {
+		set(crc, accuracy);
+	}
+	return true;
+}
+
+} // namespace nes
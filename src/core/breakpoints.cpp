@@ -0,0 +1,501 @@
+#include "core/breakpoints.hpp"
+#include "core/bus.hpp"
+#include "cpu/cpu_6502.hpp"
+#include "ppu/ppu.hpp"
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <utility>
+
+namespace nes {
+
+// =============================================================================
+// Condition compiler
+// =============================================================================
+
+// Recursive descent with precedence climbing for the binary operators.
+// Emitting tracks the stack depth the code will need, so evaluate() can run
+// on a fixed array.
+class BreakCondition::Parser {
+  public:
+	Parser(std::string_view text, std::vector<Instruction> &code) : text_(text), code_(code) {
+	}
+
+	bool run(std::string &error) {
+		if (!parse_binary(0)) {
+			error = error_;
+			return false;
+		}
+		skip_space();
+		if (pos_ != text_.size()) {
+			error = std::format("unexpected '{}' at column {}", text_[pos_], pos_ + 1);
+			return false;
+		}
+		if (max_depth_ > MAX_STACK) {
+			error = "expression nests too deeply";
+			return false;
+		}
+		return true;
+	}
+
+  private:
+	struct BinaryOperator {
+		std::string_view token;
+		int precedence;
+		Op op;
+	};
+	// Two-character tokens first so "<=" never matches as "<"
+	static constexpr BinaryOperator BINARY_OPERATORS[] = {
+		{"||", 1, Op::Or},		  {"&&", 2, Op::And},		 {"==", 6, Op::Equal},		{"!=", 6, Op::NotEqual},
+		{"<=", 7, Op::LessEqual}, {">=", 7, Op::GreaterEqual}, {"<<", 8, Op::ShiftLeft}, {">>", 8, Op::ShiftRight},
+		{"|", 3, Op::BitOr},	  {"^", 4, Op::BitXor},		 {"&", 5, Op::BitAnd},		{"<", 7, Op::Less},
+		{">", 7, Op::Greater},	  {"+", 9, Op::Add},		 {"-", 9, Op::Subtract},	{"*", 10, Op::Multiply},
+	};
+
+	struct Name {
+		std::string_view name;
+		Op op;
+	};
+	static constexpr Name NAMES[] = {
+		{"a", Op::A},		{"x", Op::X},		  {"y", Op::Y},			  {"sp", Op::Sp},	{"s", Op::Sp},
+		{"p", Op::P},		{"pc", Op::Pc},		  {"addr", Op::Addr},	  {"value", Op::Value},
+		{"scanline", Op::Scanline}, {"dot", Op::Dot}, {"frame", Op::Frame},
+	};
+
+	std::string_view text_;
+	std::vector<Instruction> &code_;
+	std::size_t pos_ = 0;
+	std::size_t depth_ = 0;
+	std::size_t max_depth_ = 0;
+	std::string error_;
+
+	void emit(Op op, std::int32_t literal = 0) {
+		code_.push_back({op, literal});
+		switch (op) {
+		case Op::Literal:
+		case Op::A:
+		case Op::X:
+		case Op::Y:
+		case Op::Sp:
+		case Op::P:
+		case Op::Pc:
+		case Op::Addr:
+		case Op::Value:
+		case Op::Scanline:
+		case Op::Dot:
+		case Op::Frame:
+			max_depth_ = std::max(max_depth_, ++depth_);
+			break;
+		case Op::Peek:
+		case Op::Not:
+		case Op::Negate:
+		case Op::Complement:
+			break;
+		default: // Binary: two operands in, one out
+			--depth_;
+			break;
+		}
+	}
+
+	bool fail(std::string message) {
+		if (error_.empty()) {
+			error_ = std::move(message);
+		}
+		return false;
+	}
+
+	void skip_space() {
+		while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+			++pos_;
+		}
+	}
+
+	bool expect(char c) {
+		skip_space();
+		if (pos_ >= text_.size() || text_[pos_] != c) {
+			return fail(std::format("expected '{}' at column {}", c, pos_ + 1));
+		}
+		++pos_;
+		return true;
+	}
+
+	bool parse_binary(int min_precedence) {
+		if (!parse_unary()) {
+			return false;
+		}
+		for (;;) {
+			skip_space();
+			const BinaryOperator *match = nullptr;
+			for (const BinaryOperator &candidate : BINARY_OPERATORS) {
+				if (text_.substr(pos_).starts_with(candidate.token)) {
+					match = &candidate;
+					break;
+				}
+			}
+			if (!match || match->precedence < min_precedence) {
+				return true;
+			}
+			pos_ += match->token.size();
+			if (!parse_binary(match->precedence + 1)) {
+				return false;
+			}
+			emit(match->op);
+		}
+	}
+
+	bool parse_unary() {
+		skip_space();
+		if (pos_ < text_.size()) {
+			const char c = text_[pos_];
+			const Op op = c == '!' ? Op::Not : c == '~' ? Op::Complement : Op::Negate;
+			if (c == '!' || c == '~' || c == '-') {
+				++pos_;
+				if (!parse_unary()) {
+					return false;
+				}
+				emit(op);
+				return true;
+			}
+		}
+		return parse_primary();
+	}
+
+	bool parse_number(int base) {
+		const std::size_t start = pos_;
+		std::int64_t number = 0;
+		while (pos_ < text_.size()) {
+			const char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text_[pos_])));
+			const int digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : base;
+			if (digit >= base) {
+				break;
+			}
+			number = number * base + digit;
+			if (number > INT32_MAX) {
+				return fail(std::format("number too large at column {}", start + 1));
+			}
+			++pos_;
+		}
+		if (pos_ == start) {
+			return fail(std::format("expected digits at column {}", start + 1));
+		}
+		emit(Op::Literal, static_cast<std::int32_t>(number));
+		return true;
+	}
+
+	bool parse_primary() {
+		skip_space();
+		if (pos_ >= text_.size()) {
+			return fail("unexpected end of expression");
+		}
+		const char c = text_[pos_];
+		if (c == '(' || c == '[') {
+			++pos_;
+			if (!parse_binary(0) || !expect(c == '(' ? ')' : ']')) {
+				return false;
+			}
+			if (c == '[') {
+				emit(Op::Peek);
+			}
+			return true;
+		}
+		if (c == '$' || c == '%') {
+			++pos_;
+			return parse_number(c == '$' ? 16 : 2);
+		}
+		if (std::isdigit(static_cast<unsigned char>(c))) {
+			if (c == '0' && pos_ + 1 < text_.size() && (text_[pos_ + 1] == 'x' || text_[pos_ + 1] == 'X')) {
+				pos_ += 2;
+				return parse_number(16);
+			}
+			return parse_number(10);
+		}
+		if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+			const std::size_t start = pos_;
+			std::string name;
+			while (pos_ < text_.size() &&
+				   (std::isalnum(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_')) {
+				name += static_cast<char>(std::tolower(static_cast<unsigned char>(text_[pos_])));
+				++pos_;
+			}
+			for (const Name &known : NAMES) {
+				if (known.name == name) {
+					emit(known.op);
+					return true;
+				}
+			}
+			return fail(std::format("unknown name '{}' at column {}", name, start + 1));
+		}
+		return fail(std::format("unexpected '{}' at column {}", c, pos_ + 1));
+	}
+};
+
+std::optional<BreakCondition> BreakCondition::compile(std::string_view text, std::string *error) {
+	BreakCondition condition;
+	condition.text_ = std::string(text);
+	std::string message;
+	Parser parser(text, condition.code_);
+	if (!parser.run(message)) {
+		if (error) {
+			*error = std::move(message);
+		}
+		return std::nullopt;
+	}
+	return condition;
+}
+
+std::int32_t BreakCondition::evaluate(const CPU6502 *cpu, const SystemBus *bus, Address address,
+									  Byte value) const noexcept {
+	// Arithmetic wraps as unsigned to keep overflow defined
+	auto wrap = [](std::uint32_t result) { return static_cast<std::int32_t>(result); };
+	auto ppu_position = [bus]() -> std::pair<uint16_t, uint16_t> {
+		return bus ? bus->get_ppu_position() : std::pair<uint16_t, uint16_t>{0, 0};
+	};
+
+	std::array<std::int32_t, MAX_STACK> stack{};
+	std::size_t top = 0;
+	for (const Instruction &instruction : code_) {
+		switch (instruction.op) {
+		case Op::Literal:
+			stack[top++] = instruction.literal;
+			continue;
+		case Op::A:
+			stack[top++] = cpu ? cpu->get_accumulator() : 0;
+			continue;
+		case Op::X:
+			stack[top++] = cpu ? cpu->get_x_register() : 0;
+			continue;
+		case Op::Y:
+			stack[top++] = cpu ? cpu->get_y_register() : 0;
+			continue;
+		case Op::Sp:
+			stack[top++] = cpu ? cpu->get_stack_pointer() : 0;
+			continue;
+		case Op::P:
+			stack[top++] = cpu ? cpu->get_status_register() : 0;
+			continue;
+		case Op::Pc:
+			stack[top++] = cpu ? cpu->get_program_counter() : 0;
+			continue;
+		case Op::Addr:
+			stack[top++] = address;
+			continue;
+		case Op::Value:
+			stack[top++] = value;
+			continue;
+		case Op::Scanline:
+			stack[top++] = ppu_position().first;
+			continue;
+		case Op::Dot:
+			stack[top++] = ppu_position().second;
+			continue;
+		case Op::Frame:
+			stack[top++] = bus && bus->get_ppu() ? wrap(static_cast<std::uint32_t>(bus->get_ppu()->get_frame_count())) : 0;
+			continue;
+		case Op::Peek:
+			stack[top - 1] = bus ? bus->peek(static_cast<Address>(stack[top - 1])) : 0;
+			continue;
+		case Op::Not:
+			stack[top - 1] = !stack[top - 1];
+			continue;
+		case Op::Negate:
+			stack[top - 1] = wrap(0u - static_cast<std::uint32_t>(stack[top - 1]));
+			continue;
+		case Op::Complement:
+			stack[top - 1] = ~stack[top - 1];
+			continue;
+		default:
+			break;
+		}
+
+		const std::int32_t rhs = stack[--top];
+		std::int32_t &lhs = stack[top - 1];
+		const std::uint32_t ul = static_cast<std::uint32_t>(lhs);
+		const std::uint32_t ur = static_cast<std::uint32_t>(rhs);
+		switch (instruction.op) {
+		case Op::Or:
+			lhs = lhs || rhs;
+			break;
+		case Op::And:
+			lhs = lhs && rhs;
+			break;
+		case Op::BitOr:
+			lhs |= rhs;
+			break;
+		case Op::BitXor:
+			lhs ^= rhs;
+			break;
+		case Op::BitAnd:
+			lhs &= rhs;
+			break;
+		case Op::Equal:
+			lhs = lhs == rhs;
+			break;
+		case Op::NotEqual:
+			lhs = lhs != rhs;
+			break;
+		case Op::Less:
+			lhs = lhs < rhs;
+			break;
+		case Op::LessEqual:
+			lhs = lhs <= rhs;
+			break;
+		case Op::Greater:
+			lhs = lhs > rhs;
+			break;
+		case Op::GreaterEqual:
+			lhs = lhs >= rhs;
+			break;
+		case Op::ShiftLeft:
+			lhs = wrap(ul << (ur & 31));
+			break;
+		case Op::ShiftRight:
+			lhs = wrap(ul >> (ur & 31));
+			break;
+		case Op::Add:
+			lhs = wrap(ul + ur);
+			break;
+		case Op::Subtract:
+			lhs = wrap(ul - ur);
+			break;
+		case Op::Multiply:
+			lhs = wrap(ul * ur);
+			break;
+		default:
+			break;
+		}
+	}
+	return top ? stack[top - 1] : 0;
+}
+
+// =============================================================================
+// Breakpoint set
+// =============================================================================
+
+int Breakpoints::add(std::uint8_t kinds, Address first, Address last, std::string_view condition,
+					 std::string *error) {
+	Entry entry;
+	entry.kinds = kinds;
+	entry.first = first;
+	entry.last = last;
+	return add_entry(std::move(entry), condition, error);
+}
+
+int Breakpoints::add_hook(std::uint8_t kinds, Address first, Address last, Hook hook, std::string_view condition,
+						  std::string *error) {
+	if ((kinds & EXECUTE) || !hook) {
+		if (error) {
+			*error = "hooks watch reads and writes";
+		}
+		return 0;
+	}
+	Entry entry;
+	entry.kinds = kinds;
+	entry.first = first;
+	entry.last = last;
+	entry.hook = std::move(hook);
+	return add_entry(std::move(entry), condition, error);
+}
+
+int Breakpoints::add_entry(Entry entry, std::string_view condition, std::string *error) {
+	const bool cpu_kinds = (entry.kinds & CPU_KINDS) != 0;
+	const bool ppu_kinds = (entry.kinds & PPU_KINDS) != 0;
+	if (cpu_kinds == ppu_kinds || (entry.kinds & ~(CPU_KINDS | PPU_KINDS)) != 0) {
+		if (error) {
+			*error = "a breakpoint watches CPU or PPU accesses, not both";
+		}
+		return 0;
+	}
+	if (entry.first > entry.last || (ppu_kinds && entry.last > 0x3FFF)) {
+		if (error) {
+			*error = "bad address range";
+		}
+		return 0;
+	}
+
+	const bool blank = std::all_of(condition.begin(), condition.end(),
+								   [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; });
+	if (!blank) {
+		entry.condition = BreakCondition::compile(condition, error);
+		if (!entry.condition) {
+			return 0;
+		}
+	}
+	entry.id = next_id_++;
+	entries_.push_back(std::move(entry));
+	rebuild_pages();
+	return entries_.back().id;
+}
+
+bool Breakpoints::remove(int id) {
+	const auto it = std::find_if(entries_.begin(), entries_.end(), [id](const Entry &e) { return e.id == id; });
+	if (it == entries_.end()) {
+		return false;
+	}
+	entries_.erase(it);
+	rebuild_pages();
+	return true;
+}
+
+bool Breakpoints::set_enabled(int id, bool enabled) {
+	const auto it = std::find_if(entries_.begin(), entries_.end(), [id](const Entry &e) { return e.id == id; });
+	if (it == entries_.end()) {
+		return false;
+	}
+	it->enabled = enabled;
+	rebuild_pages();
+	return true;
+}
+
+void Breakpoints::clear() {
+	entries_.clear();
+	hit_.reset();
+	rebuild_pages();
+}
+
+void Breakpoints::rebuild_pages() {
+	cpu_pages_.fill(0);
+	ppu_pages_.fill(0);
+	armed_ = false;
+	watching_ = false;
+	for (const Entry &entry : entries_) {
+		if (!entry.enabled) {
+			continue;
+		}
+		for (std::size_t page = entry.first >> 8; page <= static_cast<std::size_t>(entry.last >> 8); ++page) {
+			if (entry.kinds & PPU_KINDS) {
+				ppu_pages_[page] |= entry.kinds;
+			} else {
+				cpu_pages_[page] |= entry.kinds;
+			}
+		}
+		armed_ = true;
+		watching_ = watching_ || (entry.kinds & ~EXECUTE) != 0;
+	}
+}
+
+bool Breakpoints::evaluate(std::uint8_t kind, Address address, Byte value) noexcept {
+	if (kind & PPU_KINDS) {
+		address &= 0x3FFF;
+	}
+	bool fired = false;
+	for (Entry &entry : entries_) {
+		if (!entry.enabled || !(entry.kinds & kind) || address < entry.first || address > entry.last) {
+			continue;
+		}
+		if (entry.condition && entry.condition->evaluate(cpu_, bus_, address, value) == 0) {
+			continue;
+		}
+		++entry.hits;
+		if (entry.hook) {
+			entry.hook(BreakpointHit{entry.id, kind, address, value});
+			continue;
+		}
+		if (!hit_) {
+			hit_ = BreakpointHit{entry.id, kind, address, value};
+		}
+		fired = true;
+	}
+	return fired;
+}
+
+} // namespace nes
@@ -2,17 +2,23 @@
 #include "apu/apu.hpp"
 #include "cartridge/cartridge.hpp"
 #include "cpu/cpu_6502.hpp"
+#include "core/trace_zones.hpp"
 #include "input/controller.hpp"
 #include "memory/ram.hpp"
 #include "ppu/ppu.hpp"
+#include "ppu/ppu_write_log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 
 namespace nes {
 
 SystemBus::SystemBus()
-	: ram_{nullptr}, ppu_{nullptr}, apu_{nullptr}, controllers_{nullptr}, cartridge_{nullptr}, cpu_{nullptr},
-	  audio_backend_{std::make_unique<AudioBackend>()} {
+	: ram_{nullptr}, ppu_{nullptr}, apu_{nullptr}, controllers_{nullptr}, cartridge_{nullptr}, cpu_{nullptr} {
+	breakpoints_.attach(nullptr, this);
 }
 
 void SystemBus::tick(CpuCycle cycles) {
@@ -21,8 +27,9 @@ void SystemBus::tick(CpuCycle cycles) {
 		ram_->tick(cycles);
 	}
 	if (ppu_) {
-		// PPU runs at 3× the CPU clock; convert CPU cycles to PPU dot units
-		ppu_->tick(cpu_cycles(cycles.count() * 3));
+		catch_up_ppu(); // Keep bulk ticks ordered after any owed dots
+		// PPU runs at 3× the CPU clock (3.2× on PAL); convert CPU cycles to PPU dot units
+		ppu_->tick(cpu_cycles(dots_for_cycles(static_cast<uint64_t>(cycles.count()))));
 	}
 	if (apu_) {
 		apu_->tick(cycles);
@@ -35,7 +42,9 @@ void SystemBus::tick(CpuCycle cycles) {
 	}
 
 	// Centralized IRQ line management
+	master_clock_ += static_cast<uint64_t>(cycles.count()) * EventScheduler::CLOCKS_PER_CPU_CYCLE;
 	update_irq_line();
+	reschedule_events();
 }
 
 // Combined IRQ level from all sources (mapper + APU frame + APU DMC),
@@ -58,10 +67,25 @@ void SystemBus::update_irq_line() {
 }
 
 void SystemBus::tick_single_cpu_cycle() {
+	if (slow_cycle_path_) [[unlikely]] {
+		if (cycle_profiling_) {
+			tick_single_cpu_cycle_profiled();
+		} else {
+			tick_single_cpu_cycle_fractional();
+		}
+		return;
+	}
+
 	// Per-cycle hot path: non-virtual stepping through cached raw pointers.
-	// Advance PPU by exactly 3 dots (1 CPU cycle = 3 PPU dots)
+	// Advance PPU by exactly 3 dots (1 CPU cycle = 3 PPU dots), or in
+	// catch-up mode just bank them until the next sync point
+	master_clock_ += EventScheduler::CLOCKS_PER_CPU_CYCLE;
 	if (ppu_raw_) {
-		ppu_raw_->tick_dots(3);
+		if (ppu_catch_up_) {
+			ppu_owed_dots_ += 3;
+		} else {
+			ppu_raw_->tick_dots(3);
+		}
 	}
 
 	// Advance APU by exactly 1 CPU cycle
@@ -69,17 +93,261 @@ void SystemBus::tick_single_cpu_cycle() {
 		apu_raw_->step_cpu_cycles(1);
 	}
 
-	// Advance cartridge (for mapper timing, e.g. MMC1 cycle tracking) —
-	// inline early-out unless the mapper opted into cycle notifications
-	if (cartridge_raw_) {
-		cartridge_raw_->notify_cpu_cycles(1);
+	// Catch-up flushes, IRQ line and DMC DMA only change at posted deadlines
+	if (master_clock_ >= scheduler_.next_event()) [[unlikely]] {
+		service_events();
+	}
+}
+
+bool SystemBus::can_tick_cpu_cycles(uint32_t cycles) const noexcept {
+	const uint64_t end = master_clock_ + static_cast<uint64_t>(cycles) * EventScheduler::CLOCKS_PER_CPU_CYCLE;
+	return !slow_cycle_path_ && ppu_raw_ && ppu_catch_up_ && !dmc_dma_pending_ && end < scheduler_.next_event();
+}
+
+bool SystemBus::try_tick_cpu_cycles(uint32_t cycles) {
+	if (!can_tick_cpu_cycles(cycles)) {
+		return false;
+	}
+	master_clock_ += static_cast<uint64_t>(cycles) * EventScheduler::CLOCKS_PER_CPU_CYCLE;
+	ppu_owed_dots_ += 3 * cycles;
+	if (apu_raw_) {
+		apu_raw_->step_cpu_cycles(static_cast<int>(cycles));
+	}
+	return true;
+}
+
+uint32_t SystemBus::cycles_before_next_event() const noexcept {
+	const uint64_t next = scheduler_.next_event();
+	if (next <= master_clock_) {
+		return 0;
+	}
+	return static_cast<uint32_t>(
+		std::min<uint64_t>((next - master_clock_ - 1) / EventScheduler::CLOCKS_PER_CPU_CYCLE,
+							 std::numeric_limits<uint32_t>::max()));
+}
+
+void SystemBus::service_events() {
+	if (scheduler_.is_due(ScheduledEvent::PpuSync, master_clock_)) {
+		if (ppu_catch_up_) {
+			flush_owed_ppu_dots(); // Posts the next sync point and MapperIrq
+		} else {
+			scheduler_.cancel(ScheduledEvent::PpuSync);
+		}
 	}
 
 	// Centralized IRQ line management: compute OR of all IRQ sources.
 	// The CPU IRQ line must be deasserted when no source is pending,
 	// otherwise the line stays latched high and causes infinite IRQ loops
 	// after the game acknowledges the interrupt (e.g., MMC3 $E000 write).
+	if (scheduler_.is_due(ScheduledEvent::MapperTimer, master_clock_)) {
+		sync_mapper_timer(); // Raises the counter's IRQ when it is due; posts the next one
+	}
+
 	update_irq_line();
+
+	if (scheduler_.is_due(ScheduledEvent::MapperIrq, master_clock_)) {
+		// A lockstep PPU can raise the MMC3 IRQ on any dot up to its next
+		// sync point; a catch-up PPU only inside a flush, which reposts this
+		uint64_t next = EventScheduler::NEVER;
+		if (ppu_raw_ && !ppu_catch_up_ && cartridge_raw_) {
+			next = master_clock_ + dots_to_clocks(ppu_raw_->dots_until_sync_point());
+		}
+		scheduler_.schedule(ScheduledEvent::MapperIrq, next);
+	}
+
+	if (scheduler_.is_due(ScheduledEvent::Apu, master_clock_)) {
+		uint64_t next = EventScheduler::NEVER;
+		dmc_dma_pending_ = false;
+		if (apu_raw_) {
+			dmc_dma_pending_ = apu_raw_->is_dmc_dma_pending();
+			const uint32_t cycles = apu_raw_->cycles_until_irq_or_dma();
+			if (cycles != APU::NO_APU_EVENT) {
+				next = master_clock_ + std::max<uint64_t>(cycles, 1) * EventScheduler::CLOCKS_PER_CPU_CYCLE;
+			}
+		}
+		scheduler_.schedule(ScheduledEvent::Apu, next);
+	}
+}
+
+void SystemBus::tick_single_cpu_cycle_fractional() {
+	// tick_single_cpu_cycle with the cycle's share of a fractional dot ratio
+	const uint32_t dots = dots_for_cycles(1);
+	master_clock_ += EventScheduler::CLOCKS_PER_CPU_CYCLE;
+	if (ppu_raw_) {
+		if (ppu_catch_up_) {
+			ppu_owed_dots_ += dots;
+		} else {
+			ppu_raw_->tick_dots(static_cast<int>(dots));
+		}
+	}
+	if (apu_raw_) {
+		apu_raw_->step_cpu_cycles(1);
+	}
+	if (master_clock_ >= scheduler_.next_event()) [[unlikely]] {
+		service_events();
+	}
+}
+
+void SystemBus::tick_single_cpu_cycle_profiled() {
+	// Same sequence as tick_single_cpu_cycle, bracketed by clock reads
+	using Clock = std::chrono::steady_clock;
+	auto elapsed_ns = [](Clock::time_point from, Clock::time_point to) {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+	};
+
+	const auto t0 = Clock::now();
+	const uint32_t dots = dots_for_cycles(1);
+	master_clock_ += EventScheduler::CLOCKS_PER_CPU_CYCLE;
+	if (ppu_raw_) {
+		if (ppu_catch_up_) {
+			ppu_owed_dots_ += dots;
+			if (master_clock_ >= scheduler_.deadline(ScheduledEvent::PpuSync)) {
+				flush_owed_ppu_dots();
+			}
+		} else {
+			ppu_raw_->tick_dots(static_cast<int>(dots));
+		}
+	}
+	const auto t1 = Clock::now();
+	if (apu_raw_) {
+		apu_raw_->step_cpu_cycles(1);
+	}
+	const auto t2 = Clock::now();
+	if (master_clock_ >= scheduler_.next_event()) {
+		service_events();
+	}
+	const auto t3 = Clock::now();
+
+	cycle_profile_.cycles++;
+	cycle_profile_.ppu_ns += elapsed_ns(t0, t1);
+	cycle_profile_.apu_ns += elapsed_ns(t1, t2);
+	cycle_profile_.cartridge_ns += elapsed_ns(t2, t3);
+	cycle_profile_.tick_ns += elapsed_ns(t0, t3);
+}
+
+uint32_t SystemBus::idle_cycles_available() const {
+	// The PPU supplies the frame's event schedule; without one there is no
+	// safe horizon
+	if (!ppu_raw_ || oam_dma_pending_ || is_dmc_dma_pending()) {
+		return 0;
+	}
+
+	if (ppu_catch_up_) {
+		flush_owed_ppu_dots();
+	}
+	const uint32_t dots = ppu_raw_->dots_until_sync_point();
+	// Stop short of the dot that would run the sync point itself
+	uint32_t cycles = cycles_within_dots(dots - 1);
+
+	if (apu_raw_) {
+		cycles = std::min(cycles, apu_raw_->cycles_until_irq_or_dma());
+	}
+	// The mapper counter's IRQ must land on its own cycle, not inside the skip
+	const uint64_t timer_deadline = scheduler_.deadline(ScheduledEvent::MapperTimer);
+	if (timer_deadline != EventScheduler::NEVER) {
+		const uint64_t timer_cycles =
+			timer_deadline > master_clock_ ? (timer_deadline - master_clock_) / EventScheduler::CLOCKS_PER_CPU_CYCLE : 0;
+		cycles = static_cast<uint32_t>(std::min<uint64_t>(cycles, timer_cycles > 0 ? timer_cycles - 1 : 0));
+	}
+	return cycles;
+}
+
+void SystemBus::advance_idle_cycles(uint32_t cycles) {
+	if (cycles == 0) {
+		return;
+	}
+	// Stays below the catch-up deadline by construction, so no flush is due
+	if (ppu_raw_) {
+		const uint32_t dots = dots_for_cycles(cycles);
+		if (ppu_catch_up_) {
+			ppu_owed_dots_ += dots;
+		} else {
+			ppu_raw_->tick_dots(static_cast<int>(dots));
+		}
+	}
+	if (apu_raw_) {
+		apu_raw_->step_cpu_cycles(static_cast<int>(cycles));
+	}
+	master_clock_ += static_cast<uint64_t>(cycles) * EventScheduler::CLOCKS_PER_CPU_CYCLE;
+	update_irq_line();
+	// The skip ended short of every deadline, but the APU and a lockstep
+	// PPU have moved on; let them post fresh ones
+	reschedule(ScheduledEvent::Apu);
+	reschedule(ScheduledEvent::MapperIrq);
+}
+
+void SystemBus::set_region(Region region) {
+	// Settle owed dots at the old ratio before the new one takes over
+	flush_owed_ppu_dots();
+	timing_ = &region_timing(region);
+	fractional_dots_ = timing_->dots_denominator() != 1;
+	slow_cycle_path_ = cycle_profiling_ || fractional_dots_;
+	if (ppu_raw_) {
+		ppu_raw_->set_region(*timing_);
+	}
+	if (apu_raw_) {
+		apu_raw_->set_region(*timing_);
+	}
+	reschedule_events();
+}
+
+void SystemBus::set_ppu_catch_up(bool enabled) {
+	// Settle any owed dots so switching modes never drops PPU time
+	flush_owed_ppu_dots();
+	ppu_catch_up_ = enabled;
+	reschedule_events();
+}
+
+void SystemBus::sync_ppu() const {
+	catch_up_ppu();
+	sync_mapper_timer(); // Save states read the counter too
+}
+
+void SystemBus::sync_mapper_timer() const {
+	if (!cartridge_raw_ || !cartridge_raw_->has_cpu_cycle_timer()) {
+		mapper_timer_clock_ = master_clock_;
+		scheduler_.cancel(ScheduledEvent::MapperTimer);
+		return;
+	}
+	if (cartridge_raw_->get_load_id() != mapper_timer_load_id_) {
+		// A freshly loaded mapper has run no cycles yet
+		mapper_timer_load_id_ = cartridge_raw_->get_load_id();
+		mapper_timer_clock_ = master_clock_;
+	}
+
+	uint64_t cycles = master_clock_ > mapper_timer_clock_
+						  ? (master_clock_ - mapper_timer_clock_) / EventScheduler::CLOCKS_PER_CPU_CYCLE
+						  : 0;
+	mapper_timer_clock_ += cycles * EventScheduler::CLOCKS_PER_CPU_CYCLE;
+	while (cycles > 0) {
+		const uint32_t span = static_cast<uint32_t>(std::min<uint64_t>(cycles, 0xFFFFFFFFu));
+		cartridge_raw_->run_cpu_cycle_timer(span);
+		cycles -= span;
+	}
+
+	const uint32_t until = cartridge_raw_->cpu_cycles_until_irq();
+	scheduler_.schedule(ScheduledEvent::MapperTimer,
+						until == Mapper::NO_CYCLE_IRQ
+							? EventScheduler::NEVER
+							: mapper_timer_clock_ + std::max<uint64_t>(until, 1) * EventScheduler::CLOCKS_PER_CPU_CYCLE);
+}
+
+void SystemBus::flush_owed_ppu_dots() const {
+	VIBENES_TRACE_ZONE("SystemBus::flush_owed_ppu_dots");
+	// Clear the debt before ticking: PPU-driven bus reads (legacy OAM DMA
+	// path) re-enter catch_up_ppu() and must find nothing owed
+	const uint32_t dots = ppu_owed_dots_;
+	ppu_owed_dots_ = 0;
+	if (!ppu_raw_) {
+		return;
+	}
+	if (dots > 0) {
+		ppu_raw_->tick_dots(static_cast<int>(dots));
+	}
+	scheduler_.schedule(ScheduledEvent::PpuSync,
+						master_clock_ + dots_to_clocks(ppu_raw_->dots_until_sync_point()));
+	// Any A12 edges in the dots just run may have changed the mapper IRQ
+	scheduler_.schedule(ScheduledEvent::MapperIrq, master_clock_);
 }
 
 void SystemBus::reset() {
@@ -103,11 +371,11 @@ void SystemBus::reset() {
 		cartridge_->reset();
 	}
 
-	// Clear test memory
-	test_high_memory_.fill(0x00);
-	test_high_memory_valid_.fill(false);
 	last_bus_value_ = 0xFF;
 	last_irq_line_ = -1; // Force IRQ line re-sync after reset
+	ppu_owed_dots_ = 0;	 // The PPU was reset too; owed time is meaningless
+	mapper_timer_clock_ = master_clock_; // And so was the mapper's counter
+	reschedule_events();
 }
 
 void SystemBus::power_on() {
@@ -128,11 +396,11 @@ void SystemBus::power_on() {
 		cartridge_->power_on();
 	}
 
-	// Clear test memory
-	test_high_memory_.fill(0x00);
-	test_high_memory_valid_.fill(false);
 	last_bus_value_ = 0xFF;
 	last_irq_line_ = -1; // Force IRQ line re-sync after power-on
+	ppu_owed_dots_ = 0;
+	mapper_timer_clock_ = master_clock_;
+	reschedule_events();
 }
 
 const char *SystemBus::get_name() const noexcept {
@@ -140,6 +408,30 @@ const char *SystemBus::get_name() const noexcept {
 }
 
 Byte SystemBus::read(Address address) const {
+	VIBENES_BUS_STAT(bus_stats_.count_read(address));
+	if (breakpoints_.is_watching()) [[unlikely]] {
+		return read_watched(address);
+	}
+	return decode_read(address);
+}
+
+Byte SystemBus::read_watched(Address address) const {
+	// PPUDATA reads are PPU reads at the VRAM address before the access
+	const bool ppu_data = (address & 0xE007) == 0x2007 && ppu_raw_;
+	Address vram_address = 0;
+	if (ppu_data) {
+		catch_up_ppu();
+		vram_address = ppu_raw_->get_vram_address();
+	}
+	const Byte value = decode_read(address);
+	breakpoints_.check(Breakpoints::CPU_READ, address, value);
+	if (ppu_data) {
+		breakpoints_.check(Breakpoints::PPU_READ, vram_address, value);
+	}
+	return value;
+}
+
+Byte SystemBus::decode_read(Address address) const {
 	// Jump-table dispatch on the top 4 address bits. The previous sequential
 	// range-check chain made the hottest region ($8000+ opcode fetches) pay
 	// for every earlier range test; a switch compiles to a single indexed jump.
@@ -156,7 +448,12 @@ Byte SystemBus::read(Address address) const {
 	case 0x3:
 		// PPU: $2000-$3FFF (includes register mirroring)
 		if (ppu_) {
+			catch_up_ppu();
 			last_bus_value_ = ppu_->read_register(address);
+			const Address reg = address & 0x0007;
+			if (ppu_log_ && (reg == 0x0002 || reg == 0x0004 || reg == 0x0007)) [[unlikely]] {
+				ppu_log_->record(PpuWriteLog::Kind::RegisterRead, ppu_raw_->get_dot_counter(), address, 0);
+			}
 		}
 		return last_bus_value_; // Open bus when PPU not connected
 
@@ -165,12 +462,16 @@ Byte SystemBus::read(Address address) const {
 		if (address <= 0x4015) {
 			if (apu_) {
 				last_bus_value_ = apu_->read(address);
+				reschedule(ScheduledEvent::Apu); // $4015 acknowledges the frame IRQ
 			}
 			return last_bus_value_; // Open bus
 		}
 		// Controllers: $4016 (controller 1), $4017 (controller 2 read)
 		if (address <= 0x4017) {
 			if (controllers_) {
+				if (controllers_->reads_ppu()) [[unlikely]] {
+					catch_up_ppu(); // A light gun looks at the beam's progress
+				}
 				last_bus_value_ = controllers_->read(address);
 			}
 			return last_bus_value_; // Open bus
@@ -178,34 +479,102 @@ Byte SystemBus::read(Address address) const {
 		if (address < 0x4020) {
 			return last_bus_value_; // $4018-$401F unmapped - open bus
 		}
-		[[fallthrough]];
+		return read_cartridge_space(address);
+
+	case 0x8:
+	case 0x9:
+	case 0xA:
+	case 0xB:
+	case 0xC:
+	case 0xD:
+	case 0xE:
+	case 0xF:
+		// PRG ROM: index the mapper's 8KB page table directly. Opcode fetches
+		// are the hottest access, and this skips Cartridge::cpu_read plus the
+		// virtual Mapper::cpu_read per byte.
+		if (cartridge_) {
+			if (const Mapper::PrgPageTable *pages = cartridge_->prg_page_table()) [[likely]] {
+				const Byte *page = (*pages)[(address >> 13) & 0x03];
+				if (CodeDataLogger *cdl = cartridge_->code_data_logger()) [[unlikely]] {
+					cdl->log_prg(page, address, CodeDataLogger::PRG_DATA);
+				}
+				VIBENES_BUS_STAT(++bus_stats_.prg_page_reads);
+				last_bus_value_ = page[address & 0x1FFF];
+				return last_bus_value_;
+			}
+		}
+		return read_cartridge_space(address);
 
 	default:
-		// Cartridge space: $4020-$FFFF (expansion, SRAM, PRG ROM)
-		// If a cartridge is loaded, always defer to mapper-provided memory first
-		if (cartridge_ && cartridge_->is_loaded()) {
-			last_bus_value_ = cartridge_->cpu_read(address);
-			return last_bus_value_;
-		}
+		return read_cartridge_space(address);
+	}
+}
 
-		// Otherwise fall back to high-memory mirrors for unit tests without a cartridge
-		if (address >= 0x8000) {
-			Address index = address - 0x8000;
-			if (test_high_memory_valid_[index]) {
-				last_bus_value_ = test_high_memory_[index];
-				return last_bus_value_;
+std::pair<uint16_t, uint16_t> SystemBus::get_ppu_position() const {
+	if (!ppu_raw_) {
+		return {0, 0};
+	}
+	catch_up_ppu();
+	return {ppu_raw_->get_current_scanline(), ppu_raw_->get_current_cycle()};
+}
+
+Byte SystemBus::fetch(Address address) const {
+	return read_as(address, CodeDataLogger::PRG_CODE);
+}
+
+const Byte *SystemBus::prg_fetch_page(Address address) const noexcept {
+	if (address < 0x8000 || !cartridge_raw_ || breakpoints_.is_watching()) {
+		return nullptr;
+	}
+	const Mapper::PrgPageTable *pages = cartridge_raw_->prg_page_table();
+	if (!pages || cartridge_raw_->code_data_logger()) {
+		return nullptr;
+	}
+	return (*pages)[(address >> 13) & 0x03];
+}
+
+Byte SystemBus::read_as(Address address, Byte cdl_flags) const {
+	if (address >= 0x8000 && cartridge_raw_) {
+		CodeDataLogger *cdl = cartridge_raw_->code_data_logger();
+		const Mapper::PrgPageTable *pages = cartridge_raw_->prg_page_table();
+		if (cdl && pages) [[unlikely]] {
+			const Byte *page = (*pages)[(address >> 13) & 0x03];
+			cdl->log_prg(page, address, cdl_flags);
+			VIBENES_BUS_STAT((bus_stats_.count_read(address), ++bus_stats_.prg_page_reads));
+			last_bus_value_ = page[address & 0x1FFF];
+			if (breakpoints_.is_watching()) {
+				breakpoints_.check(Breakpoints::CPU_READ, address, last_bus_value_);
 			}
+			return last_bus_value_;
 		}
+	}
+	return read(address);
+}
 
-		// If a cartridge object exists, allow it to supply open-bus semantics (0xFF when unloaded)
-		if (cartridge_) {
-			last_bus_value_ = cartridge_->cpu_read(address);
-			return last_bus_value_;
+Byte SystemBus::read_cartridge_space(Address address) const {
+	// Cartridge space: $4020-$FFFF (expansion, SRAM, PRG ROM)
+	// If a cartridge is loaded, always defer to mapper-provided memory first
+	if (cartridge_ && cartridge_->is_loaded()) {
+		if (address < 0x6000) {
+			// Expansion registers can report PPU-driven state (MMC5 scanline
+			// IRQ) or acknowledge an IRQ, and sound status (MMC5 $5015)
+			catch_up_ppu();
+			if (apu_raw_ && apu_raw_->has_expansion_audio()) {
+				apu_raw_->sync_channels();
+			}
 		}
+		last_bus_value_ = cartridge_->cpu_read(address);
+		return last_bus_value_;
+	}
 
-		// No cartridge data available and no mirror value—return open bus (last_bus_value_)
+	// If a cartridge object exists, allow it to supply open-bus semantics (0xFF when unloaded)
+	if (cartridge_) {
+		last_bus_value_ = cartridge_->cpu_read(address);
 		return last_bus_value_;
 	}
+
+	// No cartridge data available and no mirror value—return open bus (last_bus_value_)
+	return last_bus_value_;
 }
 
 Byte SystemBus::peek(Address address) const {
@@ -249,22 +618,49 @@ Byte SystemBus::peek(Address address) const {
 		}
 	}
 
-	// High memory: $8000-$FFFF (test memory for ROM vectors)
-	if (address >= 0x8000) {
-		Address index = address - 0x8000;
-		if (test_high_memory_valid_[index]) {
-			return test_high_memory_[index];
-		}
-		// Return open bus if no data written
-		return last_bus_value_;
-	}
-
 	// Unmapped region - open bus behavior
 	return last_bus_value_;
 }
 
+void SystemBus::peek_range(Address first, std::span<Byte> out) const {
+	std::size_t done = 0;
+	Address address = first;
+	while (done < out.size()) {
+		// Copy up to the end of the current 8KB block (never past $FFFF, so the
+		// next pass starts over at $0000)
+		const std::size_t block_end = (static_cast<std::size_t>(address) | 0x1FFF) + 1;
+		const std::size_t count = std::min(out.size() - done, block_end - address);
+		Byte *dest = out.data() + done;
+
+		const Mapper::PrgPageTable *pages = cartridge_raw_ ? cartridge_raw_->prg_page_table() : nullptr;
+		if (address < 0x2000 && ram_) {
+			// Work RAM mirrors every 2KB: copy in runs up to each mirror's end
+			const Byte *ram = ram_->get_memory().data();
+			for (std::size_t i = 0; i < count;) {
+				const std::size_t offset = (address + i) & (RAM_SIZE - 1);
+				const std::size_t run = std::min(count - i, RAM_SIZE - offset);
+				std::memcpy(dest + i, ram + offset, run);
+				i += run;
+			}
+		} else if (address >= 0x8000 && pages) {
+			std::memcpy(dest, (*pages)[(address >> 13) & 0x03] + (address & 0x1FFF), count);
+		} else {
+			for (std::size_t i = 0; i < count; ++i) {
+				dest[i] = peek(static_cast<Address>(address + i));
+			}
+		}
+
+		done += count;
+		address = static_cast<Address>(address + count);
+	}
+}
+
 void SystemBus::write(Address address, Byte value) {
+	VIBENES_BUS_STAT(bus_stats_.count_write(address));
 	last_bus_value_ = value; // Bus remembers last written value
+	if (breakpoints_.is_watching()) [[unlikely]] {
+		note_watched_write(address, value);
+	}
 
 	// Jump-table dispatch on the top 4 address bits (see read()).
 	switch (address >> 12) {
@@ -280,7 +676,11 @@ void SystemBus::write(Address address, Byte value) {
 	case 0x3:
 		// PPU: $2000-$3FFF (includes register mirroring)
 		if (ppu_) {
+			catch_up_ppu();
 			ppu_->write_register(address, value);
+			if (ppu_log_) [[unlikely]] {
+				ppu_log_->record(PpuWriteLog::Kind::RegisterWrite, ppu_raw_->get_dot_counter(), address, value);
+			}
 		}
 		return;
 
@@ -294,6 +694,7 @@ void SystemBus::write(Address address, Byte value) {
 		if (address <= 0x4015 || address == 0x4017) {
 			if (apu_) {
 				apu_->write(address, value);
+				reschedule(ScheduledEvent::Apu);
 			}
 			return;
 		}
@@ -314,24 +715,51 @@ void SystemBus::write(Address address, Byte value) {
 		// Cartridge space: $4020-$FFFF (expansion, SRAM, PRG ROM)
 		// Writes go to the active cartridge when a ROM is loaded (handles PRG RAM / mapper regs)
 		if (cartridge_ && cartridge_->is_loaded()) {
-			cartridge_->cpu_write(address, value);
+			// Mapper registers can change CHR banks, mirroring and IRQ state
+			// under the PPU; PRG-RAM ($6000-$7FFF) writes cannot
+			if (address < 0x6000 || address >= 0x8000) {
+				catch_up_ppu();
+			}
+			if (cartridge_raw_->has_cpu_cycle_timer()) {
+				sync_mapper_timer();
+				reschedule(ScheduledEvent::MapperTimer); // The write may move or acknowledge its IRQ
+			}
+			// Expansion sound registers sit in cartridge space too
+			const bool expansion_audio = apu_raw_ && apu_raw_->has_expansion_audio();
+			if (expansion_audio) {
+				apu_raw_->begin_expansion_write();
+			}
+			// Stamped so MMC1 can drop the second write of a read-modify-write
+			const uint64_t cycle = master_clock_ / EventScheduler::CLOCKS_PER_CPU_CYCLE;
+			cartridge_->cpu_write_at(address, value, cycle);
+			if (ppu_log_) [[unlikely]] {
+				// PRG-RAM writes leave the PPU behind, but it catches up under
+				// the new state, so its counter is still the right stamp
+				ppu_log_->record(PpuWriteLog::Kind::CartridgeWrite, ppu_raw_->get_dot_counter(), address, value, cycle);
+			}
+			if (expansion_audio) {
+				apu_raw_->end_expansion_write();
+			}
 			return;
 		}
 
-		// When no cartridge is loaded, retain the high-memory mirror for tests at $8000-$FFFF
-		if (address >= 0x8000) {
-			Address index = address - 0x8000;
-			test_high_memory_[index] = value;
-			test_high_memory_valid_[index] = true;
-		}
-
 		// Otherwise nothing is mapped—ignore write
 		return;
 	}
 }
 
+void SystemBus::note_watched_write(Address address, Byte value) {
+	breakpoints_.check(Breakpoints::CPU_WRITE, address, value);
+	// PPUDATA writes are PPU writes at the VRAM address before the access
+	if ((address & 0xE007) == 0x2007 && ppu_raw_) {
+		catch_up_ppu();
+		breakpoints_.check(Breakpoints::PPU_WRITE, ppu_raw_->get_vram_address(), value);
+	}
+}
+
 void SystemBus::connect_ram(std::shared_ptr<Ram> ram) {
 	ram_ = std::move(ram);
+	ram_memory_ = ram_ ? ram_->data() : nullptr;
 }
 
 void SystemBus::connect_ppu(std::shared_ptr<PPU> ppu) {
@@ -343,21 +771,18 @@ void SystemBus::connect_apu(std::shared_ptr<APU> apu) {
 	apu_ = std::move(apu);
 	apu_raw_ = apu_.get();
 	last_irq_line_ = -1; // New IRQ source — force line re-sync
+	reschedule_events();
+	if (cartridge_) {
+		cartridge_->connect_apu(apu_raw_); // Mixes the mapper's sound chip
+	}
 	// Connect CPU to APU for IRQ handling if both are available
 	if (cpu_ && apu_) {
 		apu_->connect_cpu(cpu_.get());
 	}
-	// Connect audio backend to APU
-	if (apu_ && audio_backend_) {
-		apu_->connect_audio_backend(audio_backend_.get());
-
-		// Configure APU sample rate from audio backend
-		int actual_sample_rate = audio_backend_->get_sample_rate();
-		std::cout << "SystemBus: Configuring APU for " << actual_sample_rate << " Hz output" << std::endl;
-		std::cout << "  APU input rate: " << CPU_CLOCK_NTSC << " Hz (CPU clock)" << std::endl;
-		std::cout << "  Sample rate conversion ratio: " << (static_cast<float>(CPU_CLOCK_NTSC) / actual_sample_rate)
-				  << ":1" << std::endl;
-		apu_->set_output_sample_rate(static_cast<float>(actual_sample_rate));
+	// Connect audio output to APU
+	if (apu_ && audio_output_) {
+		apu_->connect_audio_output(audio_output_.get());
+		configure_apu_sample_rate();
 	}
 	// Connect bus to APU for DMC memory access
 	if (apu_) {
@@ -373,12 +798,18 @@ void SystemBus::connect_cartridge(std::shared_ptr<Cartridge> cartridge) {
 	cartridge_ = std::move(cartridge);
 	cartridge_raw_ = cartridge_.get();
 	last_irq_line_ = -1; // New IRQ source — force line re-sync
+	reschedule_events();
+	if (cartridge_ && apu_raw_) {
+		cartridge_->connect_apu(apu_raw_);
+	}
 }
 
 void SystemBus::connect_cpu(std::shared_ptr<CPU6502> cpu) {
 	cpu_ = std::move(cpu);
 	cpu_raw_ = cpu_.get();
+	breakpoints_.attach(cpu_raw_, this);
 	last_irq_line_ = -1; // Force initial line sync to the new CPU
+	reschedule_events();
 	// Connect CPU to APU for IRQ handling if both are available
 	if (cpu_ && apu_) {
 		apu_->connect_cpu(cpu_.get());
@@ -446,12 +877,35 @@ void SystemBus::clear_oam_dma_pending() noexcept {
 
 void SystemBus::write_oam_direct(uint8_t offset, uint8_t value) {
 	if (ppu_) {
+		catch_up_ppu(); // Sprite evaluation reads OAM mid-frame
 		ppu_->write_oam_direct(offset, value);
+		if (ppu_log_) [[unlikely]] {
+			ppu_log_->record(PpuWriteLog::Kind::OamWrite, ppu_raw_->get_dot_counter(), offset, value);
+		}
 	}
 }
 
-bool SystemBus::is_dmc_dma_pending() const noexcept {
-	return apu_ && apu_->is_dmc_dma_pending();
+bool SystemBus::copy_page_to_oam(Byte page, uint32_t dots) {
+	const Address first = static_cast<Address>(page) << 8;
+	const Mapper::PrgPageTable *pages = cartridge_raw_ ? cartridge_raw_->prg_page_table() : nullptr;
+	const bool plain_source = (first < 0x2000 && ram_) || (first >= 0x8000 && pages && !cartridge_raw_->code_data_logger());
+	if (!ppu_raw_ || !plain_source || breakpoints_.is_watching()) {
+		return false;
+	}
+	catch_up_ppu();
+	if (!ppu_raw_->is_oam_idle_for(dots)) {
+		return false;
+	}
+
+	std::array<Byte, 256> data;
+	peek_range(first, data);
+	ppu_raw_->write_oam_page(data);
+	if (ppu_log_) [[unlikely]] {
+		ppu_log_->record_oam_page(ppu_raw_->get_dot_counter(), data);
+	}
+	VIBENES_BUS_STAT(for (std::size_t i = 0; i < data.size(); ++i) bus_stats_.count_read(first));
+	VIBENES_BUS_STAT(if (first >= 0x8000) bus_stats_.prg_page_reads += data.size());
+	return true;
 }
 
 void SystemBus::service_dmc_dma() {
@@ -460,34 +914,56 @@ void SystemBus::service_dmc_dma() {
 	}
 	// Read the sample byte from the address the APU requested
 	uint16_t addr = apu_->get_dmc_dma_address();
-	uint8_t data = read(addr);
+	uint8_t data = read_as(addr, CodeDataLogger::PRG_PCM);
 	apu_->complete_dmc_dma(data);
+	dmc_dma_pending_ = apu_->is_dmc_dma_pending();
+	reschedule(ScheduledEvent::Apu); // The last byte may end the sample
+}
+
+bool SystemBus::is_dma_get_cycle() const noexcept {
+	return apu_raw_ ? apu_raw_->next_cycle_is_get() : true;
 }
 
 // Audio control implementation
+void SystemBus::connect_audio_output(std::unique_ptr<AudioOutput> audio_output) {
+	if (apu_) {
+		// Detach before the old output is destroyed
+		apu_->connect_audio_output(nullptr);
+	}
+	audio_output_ = std::move(audio_output);
+	if (apu_ && audio_output_) {
+		apu_->connect_audio_output(audio_output_.get());
+		configure_apu_sample_rate();
+	}
+}
+
+void SystemBus::configure_apu_sample_rate() {
+	int actual_sample_rate = audio_output_->get_sample_rate();
+	std::cout << "SystemBus: Configuring APU for " << actual_sample_rate << " Hz output" << std::endl;
+	std::cout << "  APU input rate: " << CPU_CLOCK_NTSC << " Hz (CPU clock)" << std::endl;
+	std::cout << "  Sample rate conversion ratio: " << (static_cast<float>(CPU_CLOCK_NTSC) / actual_sample_rate)
+			  << ":1" << std::endl;
+	apu_->set_output_sample_rate(static_cast<float>(actual_sample_rate));
+}
+
 bool SystemBus::initialize_audio(int sample_rate, int buffer_size) {
-	if (!audio_backend_) {
+	if (!audio_output_) {
 		return false;
 	}
 
-	bool success = audio_backend_->initialize(sample_rate, buffer_size);
+	bool success = audio_output_->initialize(sample_rate, buffer_size);
 
-	// Update APU's sample rate converter with actual SDL sample rate
+	// Update APU's sample rate converter with the device's actual sample rate
 	if (success && apu_) {
-		int actual_sample_rate = audio_backend_->get_sample_rate();
-		std::cout << "SystemBus: Configuring APU for " << actual_sample_rate << " Hz output" << std::endl;
-		std::cout << "  APU input rate: " << CPU_CLOCK_NTSC << " Hz (CPU clock)" << std::endl;
-		std::cout << "  Sample rate conversion ratio: " << (static_cast<float>(CPU_CLOCK_NTSC) / actual_sample_rate)
-				  << ":1" << std::endl;
-		apu_->set_output_sample_rate(static_cast<float>(actual_sample_rate));
+		configure_apu_sample_rate();
 	}
 
 	return success;
 }
 
 void SystemBus::start_audio() {
-	if (audio_backend_) {
-		audio_backend_->start();
+	if (audio_output_) {
+		audio_output_->start();
 	}
 	if (apu_) {
 		apu_->enable_audio(true);
@@ -495,8 +971,8 @@ void SystemBus::start_audio() {
 }
 
 void SystemBus::stop_audio() {
-	if (audio_backend_) {
-		audio_backend_->stop();
+	if (audio_output_) {
+		audio_output_->stop();
 	}
 	if (apu_) {
 		apu_->enable_audio(false);
@@ -504,21 +980,60 @@ void SystemBus::stop_audio() {
 }
 
 void SystemBus::set_audio_volume(float volume) {
-	if (audio_backend_) {
-		audio_backend_->set_volume(volume);
+	if (audio_output_) {
+		audio_output_->set_volume(volume);
 	}
 }
 
 float SystemBus::get_audio_volume() const {
-	return audio_backend_ ? audio_backend_->get_volume() : 0.0f;
+	return audio_output_ ? audio_output_->get_volume() : 0.0f;
 }
 
 bool SystemBus::is_audio_playing() const {
-	return audio_backend_ ? audio_backend_->is_playing() : false;
+	return audio_output_ ? audio_output_->is_playing() : false;
+}
+
+void SystemBus::set_audio_gated(bool gated) {
+	if (apu_raw_) {
+		apu_raw_->set_output_gated(gated);
+	}
+}
+
+void SystemBus::set_audio_rate_control(bool enabled) {
+	if (apu_raw_) {
+		apu_raw_->set_rate_control(enabled);
+	}
+}
+
+void SystemBus::set_audio_recorder(AudioRecorder *recorder) {
+	if (apu_raw_) {
+		apu_raw_->set_recorder(recorder);
+	}
+}
+
+int SystemBus::get_audio_sample_rate() const {
+	return apu_raw_ ? static_cast<int>(apu_raw_->get_output_sample_rate()) : 44100;
+}
+
+const char *SystemBus::get_expansion_audio_name() const {
+	const ExpansionAudio *audio = apu_raw_ ? apu_raw_->get_expansion_audio() : nullptr;
+	return audio ? audio->get_name() : nullptr;
+}
+
+void SystemBus::set_expansion_audio_gain(float gain) {
+	if (apu_raw_) {
+		apu_raw_->set_expansion_gain(gain);
+	}
+}
+
+float SystemBus::get_expansion_audio_gain() const {
+	return apu_raw_ ? apu_raw_->get_expansion_gain() : 1.0f;
 }
 
 // Save state serialization
 void SystemBus::serialize_state(std::vector<uint8_t> &buffer) const {
+	// Owed PPU dots are not part of the format; SaveStateManager syncs the
+	// PPU before serializing anything
 	// Serialize RAM (2KB)
 	if (ram_) {
 		ram_->serialize_state(buffer);
@@ -544,6 +1059,9 @@ void SystemBus::deserialize_state(const std::vector<uint8_t> &buffer, size_t &of
 	}
 
 	last_irq_line_ = -1; // Restored state — force IRQ line re-sync
+	ppu_owed_dots_ = 0;	 // Restored PPU state is already current
+	mapper_timer_clock_ = master_clock_; // Saved mapper counters were synced too
+	reschedule_events();
 }
 
 } // namespace nes
@@ -0,0 +1,231 @@
+#include "core/checksum.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace nes {
+
+namespace {
+
+// Slicing-by-8: CRC32_TABLES[0] is the usual byte-at-a-time table and
+// CRC32_TABLES[k][b] is the CRC of byte b followed by k zero bytes, so eight
+// lookups advance the CRC over eight bytes at once
+constexpr std::array<std::array<std::uint32_t, 256>, 8> make_crc32_tables() {
+	std::array<std::array<std::uint32_t, 256>, 8> tables{};
+	for (std::uint32_t i = 0; i < 256; ++i) {
+		std::uint32_t crc = i;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0u);
+		}
+		tables[0][i] = crc;
+	}
+	for (std::size_t k = 1; k < tables.size(); ++k) {
+		for (std::size_t i = 0; i < 256; ++i) {
+			tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+		}
+	}
+	return tables;
+}
+
+constexpr auto CRC32_TABLES = make_crc32_tables();
+
+constexpr std::uint32_t rotl(std::uint32_t value, int bits) {
+	return (value << bits) | (value >> (32 - bits));
+}
+
+constexpr std::uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+constexpr std::uint64_t rotl64(std::uint64_t value, int bits) {
+	return (value << bits) | (value >> (64 - bits));
+}
+
+constexpr std::uint64_t xxh64_round(std::uint64_t acc, std::uint64_t input) {
+	return rotl64(acc + input * XXH_PRIME64_2, 31) * XXH_PRIME64_1;
+}
+
+constexpr std::uint64_t xxh64_merge(std::uint64_t hash, std::uint64_t lane) {
+	return (hash ^ xxh64_round(0, lane)) * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+template <typename T> T read_le(const std::uint8_t *data) {
+	T value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+} // namespace
+
+std::uint32_t crc32(const std::uint8_t *data, std::size_t length, std::uint32_t crc) {
+	crc = ~crc;
+#if defined(__ARM_FEATURE_CRC32)
+	// ARMv8 has the IEEE polynomial in hardware (x86's SSE4.2 crc32 is
+	// CRC-32C, a different checksum)
+	for (; length >= 8; data += 8, length -= 8) {
+		std::uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+		crc = __crc32d(crc, word);
+	}
+	for (; length != 0; ++data, --length) {
+		crc = __crc32b(crc, *data);
+	}
+#else
+	const auto &t = CRC32_TABLES;
+	for (; length >= 8; data += 8, length -= 8) {
+		const std::uint32_t lo = crc ^ (static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8) |
+										(static_cast<std::uint32_t>(data[2]) << 16) |
+										(static_cast<std::uint32_t>(data[3]) << 24));
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][data[4]] ^
+			  t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+	}
+	for (; length != 0; ++data, --length) {
+		crc = t[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+	}
+#endif
+	return ~crc;
+}
+
+std::uint64_t xxhash64(const void *input, std::size_t length, std::uint64_t seed) {
+	const auto *data = static_cast<const std::uint8_t *>(input);
+	const std::uint8_t *const end = data + length;
+	std::uint64_t hash;
+	if (length >= 32) {
+		std::uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+		std::uint64_t v2 = seed + XXH_PRIME64_2;
+		std::uint64_t v3 = seed;
+		std::uint64_t v4 = seed - XXH_PRIME64_1;
+		for (; end - data >= 32; data += 32) {
+			v1 = xxh64_round(v1, read_le<std::uint64_t>(data));
+			v2 = xxh64_round(v2, read_le<std::uint64_t>(data + 8));
+			v3 = xxh64_round(v3, read_le<std::uint64_t>(data + 16));
+			v4 = xxh64_round(v4, read_le<std::uint64_t>(data + 24));
+		}
+		hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+		hash = xxh64_merge(hash, v1);
+		hash = xxh64_merge(hash, v2);
+		hash = xxh64_merge(hash, v3);
+		hash = xxh64_merge(hash, v4);
+	} else {
+		hash = seed + XXH_PRIME64_5;
+	}
+	hash += length;
+
+	for (; end - data >= 8; data += 8) {
+		hash ^= xxh64_round(0, read_le<std::uint64_t>(data));
+		hash = rotl64(hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+	}
+	if (end - data >= 4) {
+		hash ^= read_le<std::uint32_t>(data) * XXH_PRIME64_1;
+		hash = rotl64(hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		data += 4;
+	}
+	for (; data != end; ++data) {
+		hash ^= *data * XXH_PRIME64_5;
+		hash = rotl64(hash, 11) * XXH_PRIME64_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= XXH_PRIME64_2;
+	hash ^= hash >> 29;
+	hash *= XXH_PRIME64_3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+void Sha1::update(const std::uint8_t *data, std::size_t length) {
+	length_ += length;
+	if (block_size_ != 0) {
+		const std::size_t take = std::min(length, block_.size() - block_size_);
+		std::memcpy(block_.data() + block_size_, data, take);
+		block_size_ += take;
+		data += take;
+		length -= take;
+		if (block_size_ < block_.size()) {
+			return;
+		}
+		process_block(block_.data());
+		block_size_ = 0;
+	}
+	for (; length >= block_.size(); data += block_.size(), length -= block_.size()) {
+		process_block(data);
+	}
+	std::memcpy(block_.data(), data, length);
+	block_size_ = length;
+}
+
+Sha1::Digest Sha1::finish() {
+	const std::uint64_t bits = length_ * 8;
+	static constexpr std::uint8_t PAD[64] = {0x80};
+	update(PAD, block_size_ < 56 ? 56 - block_size_ : 120 - block_size_);
+	std::uint8_t length_bytes[8];
+	for (int i = 0; i < 8; ++i) {
+		length_bytes[i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+	}
+	update(length_bytes, sizeof(length_bytes));
+
+	Digest digest;
+	for (std::size_t i = 0; i < digest.size(); ++i) {
+		digest[i] = static_cast<std::uint8_t>(state_[i / 4] >> (24 - 8 * (i % 4)));
+	}
+	*this = Sha1{};
+	return digest;
+}
+
+std::string Sha1::to_hex(const Digest &digest) {
+	static constexpr char HEX[] = "0123456789abcdef";
+	std::string hex;
+	hex.reserve(digest.size() * 2);
+	for (std::uint8_t byte : digest) {
+		hex += HEX[byte >> 4];
+		hex += HEX[byte & 0x0F];
+	}
+	return hex;
+}
+
+void Sha1::process_block(const std::uint8_t *block) {
+	std::uint32_t w[80];
+	for (int i = 0; i < 16; ++i) {
+		w[i] = (static_cast<std::uint32_t>(block[4 * i]) << 24) | (static_cast<std::uint32_t>(block[4 * i + 1]) << 16) |
+			   (static_cast<std::uint32_t>(block[4 * i + 2]) << 8) | block[4 * i + 3];
+	}
+	for (int i = 16; i < 80; ++i) {
+		w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+	}
+
+	std::uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3], e = state_[4];
+	for (int i = 0; i < 80; ++i) {
+		std::uint32_t f, k;
+		if (i < 20) {
+			f = (b & c) | (~b & d);
+			k = 0x5A827999;
+		} else if (i < 40) {
+			f = b ^ c ^ d;
+			k = 0x6ED9EBA1;
+		} else if (i < 60) {
+			f = (b & c) | (b & d) | (c & d);
+			k = 0x8F1BBCDC;
+		} else {
+			f = b ^ c ^ d;
+			k = 0xCA62C1D6;
+		}
+		const std::uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+		e = d;
+		d = c;
+		c = rotl(b, 30);
+		b = a;
+		a = temp;
+	}
+	state_[0] += a;
+	state_[1] += b;
+	state_[2] += c;
+	state_[3] += d;
+	state_[4] += e;
+}
+
+} // namespace nes
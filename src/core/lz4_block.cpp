@@ -0,0 +1,139 @@
+#include "core/lz4_block.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace nes {
+
+namespace {
+
+constexpr std::size_t MIN_MATCH = 4;
+constexpr std::size_t LAST_LITERALS = 5; // A block ends with at least this many literals
+constexpr std::size_t MATCH_LIMIT = 12;	 // and its last match starts at least this far from the end
+constexpr std::size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+
+std::uint32_t read32(const std::uint8_t *p) {
+	std::uint32_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+std::uint32_t hash(std::uint32_t sequence) {
+	return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Lengths past the token's 15 continue in bytes of 255 and a remainder
+void put_length(std::vector<std::uint8_t> &out, std::size_t length) {
+	for (; length >= 255; length -= 255) {
+		out.push_back(255);
+	}
+	out.push_back(static_cast<std::uint8_t>(length));
+}
+
+void put_sequence(std::vector<std::uint8_t> &out, const std::uint8_t *literals, std::size_t literal_length,
+				  std::size_t offset, std::size_t match_length) {
+	const bool has_match = match_length != 0;
+	const std::size_t match_code = has_match ? match_length - MIN_MATCH : 0;
+	out.push_back(static_cast<std::uint8_t>((std::min<std::size_t>(literal_length, 15) << 4) |
+											std::min<std::size_t>(match_code, 15)));
+	if (literal_length >= 15) {
+		put_length(out, literal_length - 15);
+	}
+	out.insert(out.end(), literals, literals + literal_length);
+	if (!has_match) {
+		return;
+	}
+	out.push_back(static_cast<std::uint8_t>(offset));
+	out.push_back(static_cast<std::uint8_t>(offset >> 8));
+	if (match_code >= 15) {
+		put_length(out, match_code - 15);
+	}
+}
+
+bool get_length(const std::uint8_t *block, std::size_t block_size, std::size_t &in, std::size_t &length) {
+	std::uint8_t byte;
+	do {
+		if (in >= block_size) {
+			return false;
+		}
+		byte = block[in++];
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+
+} // namespace
+
+void lz4_compress(const std::uint8_t *data, std::size_t size, std::vector<std::uint8_t> &out) {
+	// Positions + 1 of the last place each hashed 4-byte sequence was seen (0 = none)
+	std::array<std::uint32_t, 1u << HASH_BITS> table{};
+	std::size_t anchor = 0;
+	if (size > MATCH_LIMIT) {
+		const std::size_t match_end_limit = size - LAST_LITERALS;
+		for (std::size_t i = 0; i < size - MATCH_LIMIT;) {
+			const std::uint32_t sequence = read32(data + i);
+			std::uint32_t &slot = table[hash(sequence)];
+			const std::size_t candidate = slot;
+			slot = static_cast<std::uint32_t>(i + 1);
+			if (candidate == 0 || i - (candidate - 1) > MAX_OFFSET || read32(data + candidate - 1) != sequence) {
+				++i;
+				continue;
+			}
+
+			const std::size_t match = candidate - 1;
+			std::size_t length = MIN_MATCH;
+			while (i + length < match_end_limit && data[match + length] == data[i + length]) {
+				++length;
+			}
+			put_sequence(out, data + anchor, i - anchor, i - match, length);
+			i += length;
+			anchor = i;
+		}
+	}
+	put_sequence(out, data + anchor, size - anchor, 0, 0);
+}
+
+bool lz4_decompress(const std::uint8_t *block, std::size_t block_size, std::uint8_t *out, std::size_t out_size) {
+	std::size_t in = 0;
+	std::size_t position = 0;
+	while (in < block_size) {
+		const std::uint8_t token = block[in++];
+		std::size_t literal_length = token >> 4;
+		if (literal_length == 15 && !get_length(block, block_size, in, literal_length)) {
+			return false;
+		}
+		if (literal_length > block_size - in || literal_length > out_size - position) {
+			return false;
+		}
+		std::memcpy(out + position, block + in, literal_length);
+		in += literal_length;
+		position += literal_length;
+		if (in == block_size) {
+			break; // The last sequence has no match
+		}
+
+		if (block_size - in < 2) {
+			return false;
+		}
+		const std::size_t offset = block[in] | (static_cast<std::size_t>(block[in + 1]) << 8);
+		in += 2;
+		std::size_t match_length = token & 0x0F;
+		if (match_length == 15 && !get_length(block, block_size, in, match_length)) {
+			return false;
+		}
+		match_length += MIN_MATCH;
+		if (offset == 0 || offset > position || match_length > out_size - position) {
+			return false;
+		}
+		// Byte by byte: a match may overlap what it is copying (runs)
+		const std::uint8_t *source = out + position - offset;
+		for (std::size_t k = 0; k < match_length; ++k) {
+			out[position + k] = source[k];
+		}
+		position += match_length;
+	}
+	return position == out_size;
+}
+
+} // namespace nes
@@ -0,0 +1,477 @@
+#include "core/simd.hpp"
+#include <atomic>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VIBENES_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VIBENES_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang only emit an extension's instructions in functions marked
+// for it; MSVC accepts the intrinsics anywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define VIBENES_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VIBENES_TARGET(isa)
+#endif
+
+namespace nes {
+
+namespace {
+
+// =============================================================================
+// Scalar kernels
+// =============================================================================
+
+void palette_lookup_scalar(const std::uint16_t *indices, const std::uint32_t *lut, std::uint32_t *out,
+						   std::size_t count) noexcept {
+	for (std::size_t i = 0; i < count; ++i) {
+		out[i] = lut[indices[i] & 0x1FF];
+	}
+}
+
+std::uint64_t sprites_in_range_scalar(const std::uint8_t *y_positions, std::uint8_t line,
+									  std::uint8_t height) noexcept {
+	std::uint64_t hits = 0;
+	for (int n = 0; n < 64; ++n) {
+		const std::uint8_t y = y_positions[n];
+		const bool in_range = y <= line && static_cast<std::uint8_t>(line - y) < height;
+		hits |= static_cast<std::uint64_t>(in_range) << n;
+	}
+	return hits;
+}
+
+std::size_t multiplex_pixels_scalar(const std::uint8_t *bg, const std::uint8_t *sprite, std::uint8_t *out,
+									std::size_t count) noexcept {
+	std::size_t hit = count;
+	for (std::size_t i = 0; i < count; ++i) {
+		const std::uint8_t color = sprite[i] & 0x1F;
+		const bool front = color != 0 && (bg[i] == 0 || (sprite[i] & 0x20) == 0);
+		out[i] = front ? color : bg[i];
+		if (hit == count && color != 0 && bg[i] != 0 && (sprite[i] & 0x40) != 0) {
+			hit = i;
+		}
+	}
+	return hit;
+}
+
+float dot_product_scalar(const float *a, const float *b, std::size_t count) noexcept {
+	float sum = 0.0f;
+	for (std::size_t i = 0; i < count; ++i) {
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+#if defined(VIBENES_SIMD_X86)
+// =============================================================================
+// SSE2 kernels
+// =============================================================================
+
+VIBENES_TARGET("sse2")
+std::uint64_t sprites_in_range_sse2(const std::uint8_t *y_positions, std::uint8_t line,
+									std::uint8_t height) noexcept {
+	// 16 Y coordinates per compare: y <= line (saturating y - line == 0)
+	// and line - y < height (unsigned, via min)
+	const __m128i line_v = _mm_set1_epi8(static_cast<char>(line));
+	const __m128i limit_v = _mm_set1_epi8(static_cast<char>(height - 1));
+	const __m128i zero = _mm_setzero_si128();
+	std::uint64_t hits = 0;
+	for (int chunk = 0; chunk < 4; ++chunk) {
+		const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y_positions + chunk * 16));
+		const __m128i above = _mm_cmpeq_epi8(_mm_subs_epu8(y, line_v), zero);
+		const __m128i offset = _mm_sub_epi8(line_v, y);
+		const __m128i close = _mm_cmpeq_epi8(_mm_min_epu8(offset, limit_v), offset);
+		const auto bits = static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_and_si128(above, close)));
+		hits |= static_cast<std::uint64_t>(bits) << (chunk * 16);
+	}
+	return hits;
+}
+
+// The pixels a vector loop left over, from first on
+std::size_t multiplex_tail(const std::uint8_t *bg, const std::uint8_t *sprite, std::uint8_t *out, std::size_t first,
+						   std::size_t count, std::size_t hit) noexcept {
+	const std::size_t tail = multiplex_pixels_scalar(bg + first, sprite + first, out + first, count - first);
+	return hit == count && tail != count - first ? first + tail : hit;
+}
+
+VIBENES_TARGET("sse2")
+std::size_t multiplex_pixels_sse2(const std::uint8_t *bg, const std::uint8_t *sprite, std::uint8_t *out,
+								  std::size_t count) noexcept {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i color_mask = _mm_set1_epi8(0x1F);
+	const __m128i behind_bit = _mm_set1_epi8(0x20);
+	const __m128i sprite0_bit = _mm_set1_epi8(0x40);
+	std::size_t hit = count;
+	std::size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bg + i));
+		const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sprite + i));
+		const __m128i color = _mm_and_si128(s, color_mask);
+		const __m128i bg_clear = _mm_cmpeq_epi8(b, zero);
+		const __m128i sprite_clear = _mm_cmpeq_epi8(color, zero);
+		const __m128i behind = _mm_cmpeq_epi8(_mm_and_si128(s, behind_bit), behind_bit);
+		// The background shows through a transparent sprite, and over one behind it
+		const __m128i show_bg = _mm_or_si128(sprite_clear, _mm_andnot_si128(bg_clear, behind));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+						 _mm_or_si128(_mm_and_si128(show_bg, b), _mm_andnot_si128(show_bg, color)));
+		if (hit == count) {
+			const __m128i sprite0 = _mm_cmpeq_epi8(_mm_and_si128(s, sprite0_bit), sprite0_bit);
+			const auto bits = static_cast<std::uint32_t>(
+				_mm_movemask_epi8(_mm_andnot_si128(_mm_or_si128(bg_clear, sprite_clear), sprite0)));
+			if (bits != 0) {
+				hit = i + static_cast<std::size_t>(std::countr_zero(bits));
+			}
+		}
+	}
+	return multiplex_tail(bg, sprite, out, i, count, hit);
+}
+
+// Two 4-lane accumulators (taps 0-3 and 4-7 of each group of 8), summed
+// together, then across: dot_product_avx2 adds in exactly this order
+VIBENES_TARGET("sse2")
+float horizontal_sum_sse2(__m128 acc) noexcept {
+	const __m128 high = _mm_movehl_ps(acc, acc);
+	const __m128 pair = _mm_add_ps(acc, high);
+	return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+}
+
+VIBENES_TARGET("sse2")
+float dot_product_sse2(const float *a, const float *b, std::size_t count) noexcept {
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	for (std::size_t i = 0; i < count; i += 8) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+	}
+	return horizontal_sum_sse2(_mm_add_ps(acc0, acc1));
+}
+
+// =============================================================================
+// AVX2 kernels
+// =============================================================================
+
+VIBENES_TARGET("avx2")
+void palette_lookup_avx2(const std::uint16_t *indices, const std::uint32_t *lut, std::uint32_t *out,
+						 std::size_t count) noexcept {
+	// Widen 8 entries at a time and gather their colors
+	const auto *table = reinterpret_cast<const int *>(lut);
+	const __m256i mask = _mm256_set1_epi32(0x1FF);
+	std::size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i entries = _mm256_and_si256(
+			_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i))), mask);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_i32gather_epi32(table, entries, 4));
+	}
+	palette_lookup_scalar(indices + i, lut, out + i, count - i);
+}
+
+VIBENES_TARGET("avx2")
+std::uint64_t sprites_in_range_avx2(const std::uint8_t *y_positions, std::uint8_t line,
+									std::uint8_t height) noexcept {
+	const __m256i line_v = _mm256_set1_epi8(static_cast<char>(line));
+	const __m256i limit_v = _mm256_set1_epi8(static_cast<char>(height - 1));
+	const __m256i zero = _mm256_setzero_si256();
+	std::uint64_t hits = 0;
+	for (int chunk = 0; chunk < 2; ++chunk) {
+		const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y_positions + chunk * 32));
+		const __m256i above = _mm256_cmpeq_epi8(_mm256_subs_epu8(y, line_v), zero);
+		const __m256i offset = _mm256_sub_epi8(line_v, y);
+		const __m256i close = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, limit_v), offset);
+		const auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(above, close)));
+		hits |= static_cast<std::uint64_t>(bits) << (chunk * 32);
+	}
+	return hits;
+}
+
+VIBENES_TARGET("avx2")
+std::size_t multiplex_pixels_avx2(const std::uint8_t *bg, const std::uint8_t *sprite, std::uint8_t *out,
+								  std::size_t count) noexcept {
+	// multiplex_pixels_sse2, 32 pixels at a time
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i color_mask = _mm256_set1_epi8(0x1F);
+	const __m256i behind_bit = _mm256_set1_epi8(0x20);
+	const __m256i sprite0_bit = _mm256_set1_epi8(0x40);
+	std::size_t hit = count;
+	std::size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bg + i));
+		const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sprite + i));
+		const __m256i color = _mm256_and_si256(s, color_mask);
+		const __m256i bg_clear = _mm256_cmpeq_epi8(b, zero);
+		const __m256i sprite_clear = _mm256_cmpeq_epi8(color, zero);
+		const __m256i behind = _mm256_cmpeq_epi8(_mm256_and_si256(s, behind_bit), behind_bit);
+		const __m256i show_bg = _mm256_or_si256(sprite_clear, _mm256_andnot_si256(bg_clear, behind));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_blendv_epi8(color, b, show_bg));
+		if (hit == count) {
+			const __m256i sprite0 = _mm256_cmpeq_epi8(_mm256_and_si256(s, sprite0_bit), sprite0_bit);
+			const auto bits = static_cast<std::uint32_t>(
+				_mm256_movemask_epi8(_mm256_andnot_si256(_mm256_or_si256(bg_clear, sprite_clear), sprite0)));
+			if (bits != 0) {
+				hit = i + static_cast<std::size_t>(std::countr_zero(bits));
+			}
+		}
+	}
+	return multiplex_tail(bg, sprite, out, i, count, hit);
+}
+
+VIBENES_TARGET("avx2")
+float dot_product_avx2(const float *a, const float *b, std::size_t count) noexcept {
+	// Lanes 0-3 and 4-7 are dot_product_sse2's two accumulators
+	__m256 acc = _mm256_setzero_ps();
+	for (std::size_t i = 0; i < count; i += 8) {
+		acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+	}
+	return horizontal_sum_sse2(_mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+}
+
+// =============================================================================
+// AVX-512 kernels
+// =============================================================================
+
+VIBENES_TARGET("avx512f,avx512bw")
+void palette_lookup_avx512(const std::uint16_t *indices, const std::uint32_t *lut, std::uint32_t *out,
+						   std::size_t count) noexcept {
+	// The all-lanes masked forms: GCC's unmasked ones start from an
+	// "undefined" register and warn about it
+	const __m512i mask = _mm512_set1_epi32(0x1FF);
+	const __m512i zero = _mm512_setzero_si512();
+	std::size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m512i entries = _mm512_and_si512(
+			_mm512_maskz_cvtepu16_epi32(0xFFFF, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices + i))),
+			mask);
+		_mm512_storeu_si512(out + i, _mm512_mask_i32gather_epi32(zero, 0xFFFF, entries, lut, 4));
+	}
+	palette_lookup_scalar(indices + i, lut, out + i, count - i);
+}
+
+VIBENES_TARGET("avx512f,avx512bw")
+std::uint64_t sprites_in_range_avx512(const std::uint8_t *y_positions, std::uint8_t line,
+									  std::uint8_t height) noexcept {
+	// All 64 Y coordinates in one register, straight to a bit mask
+	const __m512i y = _mm512_loadu_si512(y_positions);
+	const __m512i line_v = _mm512_set1_epi8(static_cast<char>(line));
+	const __mmask64 above = _mm512_cmple_epu8_mask(y, line_v);
+	const __mmask64 close =
+		_mm512_cmplt_epu8_mask(_mm512_sub_epi8(line_v, y), _mm512_set1_epi8(static_cast<char>(height)));
+	return static_cast<std::uint64_t>(above & close);
+}
+
+VIBENES_TARGET("avx512f,avx512bw")
+std::size_t multiplex_pixels_avx512(const std::uint8_t *bg, const std::uint8_t *sprite, std::uint8_t *out,
+									std::size_t count) noexcept {
+	// 64 pixels a step, the conditions as bit masks
+	const __m512i color_mask = _mm512_set1_epi8(0x1F);
+	const __m512i behind_bit = _mm512_set1_epi8(0x20);
+	const __m512i sprite0_bit = _mm512_set1_epi8(0x40);
+	std::size_t hit = count;
+	std::size_t i = 0;
+	for (; i + 64 <= count; i += 64) {
+		const __m512i b = _mm512_loadu_si512(bg + i);
+		const __m512i s = _mm512_loadu_si512(sprite + i);
+		const __mmask64 bg_opaque = _mm512_test_epi8_mask(b, b);
+		const __mmask64 sprite_opaque = _mm512_test_epi8_mask(s, color_mask);
+		const __mmask64 behind = _mm512_test_epi8_mask(s, behind_bit);
+		const __mmask64 front = sprite_opaque & ~(behind & bg_opaque);
+		_mm512_storeu_si512(out + i, _mm512_mask_blend_epi8(front, b, _mm512_and_si512(s, color_mask)));
+		const __mmask64 hits = _mm512_test_epi8_mask(s, sprite0_bit) & sprite_opaque & bg_opaque;
+		if (hit == count && hits != 0) {
+			hit = i + static_cast<std::size_t>(std::countr_zero(static_cast<std::uint64_t>(hits)));
+		}
+	}
+	return multiplex_tail(bg, sprite, out, i, count, hit);
+}
+#endif // VIBENES_SIMD_X86
+
+#if defined(VIBENES_SIMD_NEON)
+// =============================================================================
+// NEON kernels
+// =============================================================================
+
+float dot_product_neon(const float *a, const float *b, std::size_t count) noexcept {
+	float32x4_t acc0 = vdupq_n_f32(0.0f);
+	float32x4_t acc1 = vdupq_n_f32(0.0f);
+	for (std::size_t i = 0; i < count; i += 8) {
+		acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+		acc1 = vaddq_f32(acc1, vmulq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+	}
+	return vaddvq_f32(vaddq_f32(acc0, acc1));
+}
+#endif // VIBENES_SIMD_NEON
+
+// =============================================================================
+// Detection and dispatch
+// =============================================================================
+
+constexpr SimdKernels SCALAR_KERNELS = {palette_lookup_scalar, sprites_in_range_scalar, multiplex_pixels_scalar,
+										 dot_product_scalar};
+#if defined(VIBENES_SIMD_X86)
+constexpr SimdKernels SSE2_KERNELS = {palette_lookup_scalar, sprites_in_range_sse2, multiplex_pixels_sse2,
+									  dot_product_sse2};
+constexpr SimdKernels AVX2_KERNELS = {palette_lookup_avx2, sprites_in_range_avx2, multiplex_pixels_avx2,
+									  dot_product_avx2};
+constexpr SimdKernels AVX512_KERNELS = {palette_lookup_avx512, sprites_in_range_avx512, multiplex_pixels_avx512,
+										dot_product_avx2};
+#endif
+#if defined(VIBENES_SIMD_NEON)
+constexpr SimdKernels NEON_KERNELS = {palette_lookup_scalar, sprites_in_range_scalar, multiplex_pixels_scalar,
+									  dot_product_neon};
+#endif
+
+const SimdKernels &kernels_for(SimdLevel level) noexcept {
+	switch (level) {
+#if defined(VIBENES_SIMD_X86)
+	case SimdLevel::SSE2:
+	case SimdLevel::SSE42: // Nothing here needs more than SSE2
+		return SSE2_KERNELS;
+	case SimdLevel::AVX2:
+		return AVX2_KERNELS;
+	case SimdLevel::AVX512:
+		return AVX512_KERNELS;
+#endif
+#if defined(VIBENES_SIMD_NEON)
+	case SimdLevel::NEON:
+		return NEON_KERNELS;
+#endif
+	default:
+		return SCALAR_KERNELS;
+	}
+}
+
+CpuFeatures detect_features() noexcept {
+	CpuFeatures features;
+#if defined(VIBENES_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+	// Includes the OS's XSAVE support for the AVX register states
+	__builtin_cpu_init();
+	features.sse2 = __builtin_cpu_supports("sse2");
+	features.sse42 = __builtin_cpu_supports("sse4.2");
+	features.avx2 = __builtin_cpu_supports("avx2");
+	features.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#elif defined(VIBENES_SIMD_X86)
+	int info[4] = {};
+	__cpuid(info, 0);
+	const int max_leaf = info[0];
+	__cpuid(info, 1);
+	features.sse2 = (info[3] & (1 << 26)) != 0;
+	features.sse42 = (info[2] & (1 << 20)) != 0;
+	const bool os_xsave = (info[2] & (1 << 27)) != 0;
+	const unsigned long long xcr0 = os_xsave ? _xgetbv(0) : 0;
+	const bool ymm_state = (xcr0 & 0x06) == 0x06;
+	const bool zmm_state = (xcr0 & 0xE6) == 0xE6;
+	if (max_leaf >= 7) {
+		__cpuidex(info, 7, 0);
+		features.avx2 = ymm_state && (info[1] & (1 << 5)) != 0;
+		features.avx512 = zmm_state && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+	}
+#elif defined(VIBENES_SIMD_NEON)
+	features.neon = true; // Part of the AArch64 baseline
+#endif
+	return features;
+}
+
+struct Dispatch {
+	Dispatch() noexcept : level(best_simd_level()), kernels(&kernels_for(best_simd_level())) {}
+	std::atomic<SimdLevel> level;
+	std::atomic<const SimdKernels *> kernels;
+};
+
+Dispatch &dispatch() noexcept {
+	static Dispatch state;
+	return state;
+}
+
+} // namespace
+
+const CpuFeatures &cpu_features() noexcept {
+	static const CpuFeatures features = detect_features();
+	return features;
+}
+
+bool is_simd_level_supported(SimdLevel level) noexcept {
+	const CpuFeatures &features = cpu_features();
+	switch (level) {
+	case SimdLevel::Scalar:
+		return true;
+	case SimdLevel::SSE2:
+		return features.sse2;
+	case SimdLevel::SSE42:
+		return features.sse42;
+	case SimdLevel::AVX2:
+		return features.avx2;
+	case SimdLevel::AVX512:
+		return features.avx512;
+	case SimdLevel::NEON:
+		return features.neon;
+	}
+	return false;
+}
+
+SimdLevel best_simd_level() noexcept {
+	for (SimdLevel level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE42, SimdLevel::SSE2, SimdLevel::NEON}) {
+		if (is_simd_level_supported(level)) {
+			return level;
+		}
+	}
+	return SimdLevel::Scalar;
+}
+
+SimdLevel simd_level() noexcept {
+	return dispatch().level.load(std::memory_order_relaxed);
+}
+
+bool set_simd_level(SimdLevel level) noexcept {
+	if (!is_simd_level_supported(level)) {
+		return false;
+	}
+	Dispatch &state = dispatch();
+	state.level.store(level, std::memory_order_relaxed);
+	state.kernels.store(&kernels_for(level), std::memory_order_release);
+	return true;
+}
+
+const SimdKernels &simd_kernels() noexcept {
+	return *dispatch().kernels.load(std::memory_order_acquire);
+}
+
+const char *simd_level_name(SimdLevel level) noexcept {
+	switch (level) {
+	case SimdLevel::Scalar:
+		return "scalar";
+	case SimdLevel::SSE2:
+		return "sse2";
+	case SimdLevel::SSE42:
+		return "sse4.2";
+	case SimdLevel::AVX2:
+		return "avx2";
+	case SimdLevel::AVX512:
+		return "avx512";
+	case SimdLevel::NEON:
+		return "neon";
+	}
+	return "unknown";
+}
+
+std::optional<SimdLevel> parse_simd_level(std::string_view name) noexcept {
+	if (name == "auto") {
+		return best_simd_level();
+	}
+	for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512,
+							SimdLevel::NEON}) {
+		if (name == simd_level_name(level)) {
+			return level;
+		}
+	}
+	if (name == "sse42") {
+		return SimdLevel::SSE42;
+	}
+	return std::nullopt;
+}
+
+} // namespace nes
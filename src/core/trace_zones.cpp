@@ -0,0 +1,153 @@
+#include "core/trace_zones.hpp"
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace nes {
+
+std::atomic<bool> TraceZones::recording_{false};
+std::atomic<std::size_t> TraceZones::events_{0};
+std::atomic<std::uint64_t> TraceZones::dropped_{0};
+
+namespace {
+
+struct Event {
+	const char *name;
+	std::int64_t begin_ns;
+	std::int64_t end_ns;
+};
+
+// One thread's events. The registry keeps it after the thread exits, so a
+// capture still shows threads that have since stopped.
+struct ThreadTrack {
+	std::mutex mutex;
+	std::vector<Event> events;
+	std::string name;
+	int tid = 0;
+};
+
+struct Registry {
+	std::mutex mutex;
+	std::vector<std::shared_ptr<ThreadTrack>> tracks;
+	std::int64_t epoch_ns = 0; // Capture start; timestamps are relative to it
+};
+
+Registry &registry() {
+	static Registry instance;
+	return instance;
+}
+
+ThreadTrack &this_thread_track() {
+	thread_local std::shared_ptr<ThreadTrack> track = [] {
+		auto created = std::make_shared<ThreadTrack>();
+		Registry &shared = registry();
+		std::lock_guard lock(shared.mutex);
+		created->tid = static_cast<int>(shared.tracks.size()) + 1;
+		shared.tracks.push_back(created);
+		return created;
+	}();
+	return *track;
+}
+
+// Names are literals in this tree, but keep the output valid JSON anyway
+void write_json_string(std::ostream &out, const char *text) {
+	out << '"';
+	for (const char *c = text; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			out << '\\' << *c;
+		} else if (static_cast<unsigned char>(*c) < 0x20) {
+			out << std::format("\\u{:04x}", static_cast<unsigned>(*c));
+		} else {
+			out << *c;
+		}
+	}
+	out << '"';
+}
+
+} // namespace
+
+std::int64_t TraceZones::now_ns() noexcept {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+void TraceZones::start() {
+	Registry &shared = registry();
+	std::lock_guard lock(shared.mutex);
+	recording_.store(false, std::memory_order_relaxed);
+	for (const auto &track : shared.tracks) {
+		std::lock_guard track_lock(track->mutex);
+		track->events.clear();
+	}
+	events_.store(0, std::memory_order_relaxed);
+	dropped_.store(0, std::memory_order_relaxed);
+	shared.epoch_ns = now_ns();
+	recording_.store(true, std::memory_order_release);
+}
+
+void TraceZones::stop() {
+	recording_.store(false, std::memory_order_release);
+}
+
+void TraceZones::set_thread_name(const char *name) {
+	ThreadTrack &track = this_thread_track();
+	std::lock_guard lock(track.mutex);
+	track.name = name;
+}
+
+void TraceZones::record(const char *name, std::int64_t begin_ns, std::int64_t end_ns) noexcept {
+	// A zone that began just before stop() still ends; it is kept
+	if (events_.fetch_add(1, std::memory_order_relaxed) >= MAX_EVENTS) {
+		events_.fetch_sub(1, std::memory_order_relaxed);
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	ThreadTrack &track = this_thread_track();
+	std::lock_guard lock(track.mutex);
+	track.events.push_back({name, begin_ns, end_ns});
+}
+
+bool TraceZones::write_json(std::ostream &out) {
+	Registry &shared = registry();
+	std::lock_guard lock(shared.mutex);
+	// Microseconds with nanosecond precision, as the format expects
+	auto us = [&shared](std::int64_t ns) { return static_cast<double>(ns - shared.epoch_ns) / 1000.0; };
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	auto separator = [&out, &first] {
+		out << (first ? "\n" : ",\n");
+		first = false;
+	};
+	for (const auto &track : shared.tracks) {
+		std::lock_guard track_lock(track->mutex);
+		if (!track->name.empty()) {
+			separator();
+			out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track->tid << ",\"args\":{\"name\":";
+			write_json_string(out, track->name.c_str());
+			out << "}}";
+		}
+		for (const Event &event : track->events) {
+			separator();
+			out << "{\"name\":";
+			write_json_string(out, event.name);
+			out << std::format(",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}", us(event.begin_ns),
+							   static_cast<double>(event.end_ns - event.begin_ns) / 1000.0, track->tid)
+				<< '}';
+		}
+	}
+	out << "\n]}\n";
+	return static_cast<bool>(out);
+}
+
+bool TraceZones::save(const std::filesystem::path &path) {
+	std::ofstream file(path, std::ios::trunc);
+	return file && write_json(file);
+}
+
+} // namespace nes
@@ -0,0 +1,108 @@
+#include "cpu/block_cache.hpp"
+#include "cpu/opcode_table.hpp"
+
+namespace nes {
+
+namespace {
+
+// Official opcodes that touch only registers, flags and zero page, and
+// conditional branches. The stack and interrupt disable flag stay with the
+// interpreter: pulling P or setting I changes when an interrupt is taken.
+constexpr bool qualifies(const OpcodeInfo &info) noexcept {
+	if (info.unofficial || (info.flow != InstructionFlow::Next && info.flow != InstructionFlow::Branch)) {
+		return false;
+	}
+	switch (info.mode) {
+	case AddressingMode::Implied:
+		return info.mnemonic != "PHA" && info.mnemonic != "PLA" && info.mnemonic != "PHP" && info.mnemonic != "PLP" &&
+			   info.mnemonic != "CLI" && info.mnemonic != "SEI";
+	case AddressingMode::Accumulator:
+	case AddressingMode::Immediate:
+	case AddressingMode::ZeroPage:
+	case AddressingMode::Relative:
+		return true;
+	default:
+		return false;
+	}
+}
+
+constexpr std::array<bool, 256> BLOCK_OPCODES = [] {
+	std::array<bool, 256> table{};
+	for (std::size_t opcode = 0; opcode < table.size(); ++opcode) {
+		table[opcode] = qualifies(OPCODE_INFO[opcode]);
+	}
+	return table;
+}();
+
+} // namespace
+
+bool CpuBlockCache::is_block_opcode(Byte opcode) noexcept {
+	return BLOCK_OPCODES[opcode];
+}
+
+void CpuBlockCache::clear() {
+	rom_ = nullptr;
+	rom_size_ = 0;
+	slots_.fill(Slot{});
+	blocks_.clear();
+	code_.clear();
+}
+
+const CpuBlockCache::Block *CpuBlockCache::lookup(std::span<const Byte> rom, std::size_t offset,
+												  std::span<const Byte> code) {
+	if (rom.data() != rom_ || rom.size() != rom_size_) {
+		clear();
+		rom_ = rom.data();
+		rom_size_ = rom.size();
+	}
+	Slot &slot = slots_[offset % SLOT_COUNT];
+	if (slot.offset != offset) {
+		slot = Slot{static_cast<std::uint32_t>(offset), 0, COLD};
+	}
+	if (slot.block >= 0) [[likely]] {
+		return &blocks_[static_cast<std::size_t>(slot.block)];
+	}
+	if (slot.block == REJECTED || ++slot.hits < HOT_THRESHOLD) {
+		return nullptr;
+	}
+	if (code_.size() + MAX_INSTRUCTIONS > MAX_CODE) {
+		// Blocks evicted from their slots pile up on games with a lot of code
+		clear();
+		rom_ = rom.data();
+		rom_size_ = rom.size();
+		slots_[offset % SLOT_COUNT] = Slot{static_cast<std::uint32_t>(offset), HOT_THRESHOLD, COLD};
+	}
+	const std::int32_t block = compile(code);
+	slots_[offset % SLOT_COUNT].block = block;
+	return block >= 0 ? &blocks_[static_cast<std::size_t>(block)] : nullptr;
+}
+
+std::int32_t CpuBlockCache::compile(std::span<const Byte> code) {
+	Block block;
+	block.first = static_cast<std::uint32_t>(code_.size());
+	std::size_t position = 0;
+	while (block.count < MAX_INSTRUCTIONS && position < code.size()) {
+		const Byte opcode = code[position];
+		const OpcodeInfo &info = OPCODE_INFO[opcode];
+		if (!BLOCK_OPCODES[opcode] || position + info.length > code.size()) {
+			break;
+		}
+		code_.push_back({opcode, info.length == 2 ? code[position + 1] : Byte{0}});
+		++block.count;
+		block.cycles = static_cast<std::uint16_t>(block.cycles + info.base_cycles);
+		position += info.length;
+		if (info.flow == InstructionFlow::Branch) {
+			block.ends_in_branch = true;
+			break;
+		}
+	}
+	if (block.count < 2) {
+		code_.resize(block.first);
+		return REJECTED;
+	}
+	block.length = static_cast<std::uint8_t>(position);
+	blocks_.push_back(block);
+	return static_cast<std::int32_t>(blocks_.size() - 1);
+}
+
+} // namespace nes
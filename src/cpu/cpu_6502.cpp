@@ -1,5 +1,9 @@
 #include "cpu/cpu_6502.hpp"
+#include "cartridge/cartridge.hpp"
 #include "core/bus.hpp"
+#include "cpu/opcode_table.hpp"
+#include "ppu/ppu.hpp"
+#include <algorithm>
 #include <format>
 #include <iostream>
 #include <stdexcept>
@@ -23,7 +27,11 @@ void CPU6502::tick(CpuCycle cycles) {
 	// Execute instructions while we have cycles.
 	// OAM DMA is handled inside execute_instruction() — no special case needed.
 	while (cycles_remaining_.count() > 0) {
+#ifdef VIBENES_CPU_BATCHED_CYCLES
+		cycles_remaining_ -= CpuCycle{execute_instruction()};
+#else
 		(void)execute_instruction();
+#endif
 	}
 }
 void CPU6502::reset() {
@@ -38,6 +46,12 @@ void CPU6502::reset() {
 	interrupt_state_.irq_pending = false;
 	interrupt_state_.nmi_pending = false;
 
+	// A reset follows every ROM load, which may reuse the old ROM's memory
+	if (block_cache_) {
+		block_cache_->clear();
+	}
+	block_head_ = false;
+
 	// Reset will be processed in next execute_instruction() call
 }
 
@@ -199,13 +213,56 @@ void CPU6502::handle_irq() {
 	program_counter_ = read_word(IRQ_VECTOR);
 }
 
+namespace {
+// The table is indexed by opcode, so the X-macro list must stay in order
+constexpr bool opcode_list_is_ordered() {
+	constexpr int opcodes[] = {
+#define X(op, handler) op,
+		VIBENES_CPU_OPCODES(X)
+#undef X
+	};
+	static_assert(std::size(opcodes) == 256);
+	for (int i = 0; i < 256; ++i) {
+		if (opcodes[i] != i) {
+			return false;
+		}
+	}
+	return true;
+}
+static_assert(opcode_list_is_ordered(), "VIBENES_CPU_OPCODES entries must be listed 0x00-0xFF in order");
+} // namespace
+
+// One handler per opcode; a single indirect call replaces the former
+// 256-way switch
+const std::array<CPU6502::OpcodeHandler, 256> CPU6502::OPCODE_TABLE = {
+#define X(op, handler) &CPU6502::handler,
+	VIBENES_CPU_OPCODES(X)
+#undef X
+};
+
 int CPU6502::execute_instruction() {
 	// Reset per-instruction cycle counter (fat consume_cycle tracks this)
+#ifdef VIBENES_CPU_BATCHED_CYCLES
+	instruction_start_clock_ = bus_->get_master_clock();
+#else
 	cycles_consumed_ = 0;
+#endif
+
+	// An idle loop armed by the previous instruction is only good for this one
+	const bool idle_loop_armed = idle_loop_armed_;
+	idle_loop_armed_ = false;
 
 	// OAM DMA takes priority — CPU is halted for the entire transfer
 	if (bus_->is_oam_dma_pending()) {
+#ifdef VIBENES_CPU_PROFILER
+		const int dma_cycles = execute_oam_dma();
+		if (profiler_) {
+			profiler_->record_stall_cycles(program_counter_, static_cast<std::uint64_t>(dma_cycles));
+		}
+		return dma_cycles;
+#else
 		return execute_oam_dma();
+#endif
 	}
 
 	// =========================================================================
@@ -226,7 +283,12 @@ int CPU6502::execute_instruction() {
 	if (interrupt_state_.reset_pending) {
 		handle_reset();
 		interrupt_state_.clear_interrupt(InterruptType::RESET);
-		return cycles_consumed_;
+#ifdef VIBENES_CPU_PROFILER
+		if (profiler_) {
+			profiler_->record_stall_cycles(program_counter_, static_cast<std::uint64_t>(instruction_cycles()));
+		}
+#endif
+		return instruction_cycles();
 	}
 
 	// NMI: edge-triggered, non-maskable — check penultimate-cycle latch
@@ -236,834 +298,566 @@ int CPU6502::execute_instruction() {
 		interrupt_state_.clear_interrupt(InterruptType::NMI);
 		prev_nmi_pending_ = false;
 		curr_nmi_pending_ = false;
+		idle_loop_interrupted_ = true;
+#ifdef VIBENES_CPU_PROFILER
+		const Byte nmi_sp = stack_pointer_;
+		handle_nmi();
+		if (profiler_) {
+			profiler_->record_interrupt(program_counter_, instruction_cycles(), nmi_sp);
+		}
+#else
 		handle_nmi();
-		return cycles_consumed_;
+#endif
+		return instruction_cycles();
 	}
 
 	// IRQ: level-triggered — check penultimate-cycle latch (includes I flag check)
 	if (prev_irq_signal_) {
 		prev_irq_signal_ = false;
 		curr_irq_signal_ = false;
+		idle_loop_interrupted_ = true;
+#ifdef VIBENES_CPU_PROFILER
+		const Byte irq_sp = stack_pointer_;
+		handle_irq();
+		if (profiler_) {
+			profiler_->record_interrupt(program_counter_, instruction_cycles(), irq_sp);
+		}
+#else
 		handle_irq();
+#endif
 		// NOTE: Do NOT clear irq_pending — IRQ is level-triggered.
 		// The IRQ line stays asserted until software clears the source
 		// (e.g., reading $4015 for APU frame IRQ).
-		return cycles_consumed_;
+		return instruction_cycles();
 	}
 
-	// Fetch opcode
-	Byte opcode = read_byte(program_counter_);
-	program_counter_++;
-
-	// Decode and execute
-	switch (opcode) {
-	// Load Accumulator - Immediate
-	case 0xA9:
-		LDA_immediate();
-		break;
-
-	// Load X Register - Immediate
-	case 0xA2:
-		LDX_immediate();
-		break;
-
-	// Load Y Register - Immediate
-	case 0xA0:
-		LDY_immediate();
-		break;
-
-	// Load Accumulator - Zero Page
-	case 0xA5:
-		LDA_zero_page();
-		break;
-
-	// Load X Register - Zero Page
-	case 0xA6:
-		LDX_zero_page();
-		break;
-
-	// Load Y Register - Zero Page
-	case 0xA4:
-		LDY_zero_page();
-		break;
-
-	// Store Accumulator - Zero Page
-	case 0x85:
-		STA_zero_page();
-		break;
-
-	// Store X Register - Zero Page
-	case 0x86:
-		STX_zero_page();
-		break;
-
-	// Store Y Register - Zero Page
-	case 0x84:
-		STY_zero_page();
-		break;
-
-	// Load Accumulator - Zero Page,X
-	case 0xB5:
-		LDA_zero_page_X();
-		break;
-
-	// Load Y Register - Zero Page,X
-	case 0xB4:
-		LDY_zero_page_X();
-		break;
-
-	// Store Accumulator - Zero Page,X
-	case 0x95:
-		STA_zero_page_X();
-		break;
-
-	// Store Y Register - Zero Page,X
-	case 0x94:
-		STY_zero_page_X();
-		break;
-
-	// Load X Register - Zero Page,Y
-	case 0xB6:
-		LDX_zero_page_Y();
-		break;
-
-	// Store X Register - Zero Page,Y
-	case 0x96:
-		STX_zero_page_Y();
-		break;
-
-	// Load Accumulator - Absolute
-	case 0xAD:
-		LDA_absolute();
-		break;
-
-	// Load X Register - Absolute
-	case 0xAE:
-		LDX_absolute();
-		break;
-
-	// Load Y Register - Absolute
-	case 0xAC:
-		LDY_absolute();
-		break;
-
-	// Store Accumulator - Absolute
-	case 0x8D:
-		STA_absolute();
-		break;
-
-	// Store X Register - Absolute
-	case 0x8E:
-		STX_absolute();
-		break;
-
-	// Store Y Register - Absolute
-	case 0x8C:
-		STY_absolute();
-		break;
-
-	// Load Accumulator - Absolute,X
-	case 0xBD:
-		LDA_absolute_X();
-		break;
-
-	// Load Y Register - Absolute,X
-	case 0xBC:
-		LDY_absolute_X();
-		break;
-
-	// Store Accumulator - Absolute,X
-	case 0x9D:
-		STA_absolute_X();
-		break;
-
-	// Load Accumulator - Absolute,Y
-	case 0xB9:
-		LDA_absolute_Y();
-		break;
-
-	// Load X Register - Absolute,Y
-	case 0xBE:
-		LDX_absolute_Y();
-		break;
-
-	// Store Accumulator - Absolute,Y
-	case 0x99:
-		STA_absolute_Y();
-		break;
-
-	// Load Accumulator - Indexed Indirect (zp,X)
-	case 0xA1:
-		LDA_indexed_indirect();
-		break;
-
-	// Store Accumulator - Indexed Indirect (zp,X)
-	case 0x81:
-		STA_indexed_indirect();
-		break;
-
-	// Load Accumulator - Indirect Indexed (zp),Y
-	case 0xB1:
-		LDA_indirect_indexed();
-		break;
-
-	// Store Accumulator - Indirect Indexed (zp),Y
-	case 0x91:
-		STA_indirect_indexed();
-		break;
-
-	// Transfer instructions
-	case 0xAA:
-		TAX();
-		break;
-	case 0xA8:
-		TAY();
-		break;
-	case 0x8A:
-		TXA();
-		break;
-	case 0x98:
-		TYA();
-		break;
-
-	// ADC - Add with Carry
-	case 0x69:
-		ADC_immediate();
-		break;
-	case 0x65:
-		ADC_zero_page();
-		break;
-	case 0x75:
-		ADC_zero_page_X();
-		break;
-	case 0x6D:
-		ADC_absolute();
-		break;
-	case 0x7D:
-		ADC_absolute_X();
-		break;
-	case 0x79:
-		ADC_absolute_Y();
-		break;
-	case 0x61:
-		ADC_indexed_indirect();
-		break;
-	case 0x71:
-		ADC_indirect_indexed();
-		break;
-
-	// SBC - Subtract with Carry
-	case 0xE9:
-	case 0xEB: // Undocumented duplicate of SBC immediate
-		SBC_immediate();
-		break;
-	case 0xE5:
-		SBC_zero_page();
-		break;
-	case 0xF5:
-		SBC_zero_page_X();
-		break;
-	case 0xED:
-		SBC_absolute();
-		break;
-	case 0xFD:
-		SBC_absolute_X();
-		break;
-	case 0xF9:
-		SBC_absolute_Y();
-		break;
-	case 0xE1:
-		SBC_indexed_indirect();
-		break;
-	case 0xF1:
-		SBC_indirect_indexed();
-		break;
-
-	// Compare Instructions - CMP (Compare with Accumulator)
-	case 0xC9: // CMP - Immediate
-		CMP_immediate();
-		break;
-	case 0xC5: // CMP - Zero Page
-		CMP_zero_page();
-		break;
-	case 0xD5: // CMP - Zero Page,X
-		CMP_zero_page_X();
-		break;
-	case 0xCD: // CMP - Absolute
-		CMP_absolute();
-		break;
-	case 0xDD: // CMP - Absolute,X
-		CMP_absolute_X();
-		break;
-	case 0xD9: // CMP - Absolute,Y
-		CMP_absolute_Y();
-		break;
-	case 0xC1: // CMP - (Indirect,X)
-		CMP_indexed_indirect();
-		break;
-	case 0xD1: // CMP - (Indirect),Y
-		CMP_indirect_indexed();
-		break;
-
-	// Compare Instructions - CPX (Compare with X Register)
-	case 0xE0: // CPX - Immediate
-		CPX_immediate();
-		break;
-	case 0xE4: // CPX - Zero Page
-		CPX_zero_page();
-		break;
-	case 0xEC: // CPX - Absolute
-		CPX_absolute();
-		break;
-
-	// Compare Instructions - CPY (Compare with Y Register)
-	case 0xC0: // CPY - Immediate
-		CPY_immediate();
-		break;
-	case 0xC4: // CPY - Zero Page
-		CPY_zero_page();
-		break;
-	case 0xCC: // CPY - Absolute
-		CPY_absolute();
-		break;
-
-	// Logical Instructions - AND (Bitwise AND with Accumulator)
-	case 0x29: // AND - Immediate
-		AND_immediate();
-		break;
-	case 0x25: // AND - Zero Page
-		AND_zero_page();
-		break;
-	case 0x35: // AND - Zero Page,X
-		AND_zero_page_X();
-		break;
-	case 0x2D: // AND - Absolute
-		AND_absolute();
-		break;
-	case 0x3D: // AND - Absolute,X
-		AND_absolute_X();
-		break;
-	case 0x39: // AND - Absolute,Y
-		AND_absolute_Y();
-		break;
-	case 0x21: // AND - (Indirect,X)
-		AND_indexed_indirect();
-		break;
-	case 0x31: // AND - (Indirect),Y
-		AND_indirect_indexed();
-		break;
-
-	// Logical Instructions - ORA (Bitwise OR with Accumulator)
-	case 0x09: // ORA - Immediate
-		ORA_immediate();
-		break;
-	case 0x05: // ORA - Zero Page
-		ORA_zero_page();
-		break;
-	case 0x15: // ORA - Zero Page,X
-		ORA_zero_page_X();
-		break;
-	case 0x0D: // ORA - Absolute
-		ORA_absolute();
-		break;
-	case 0x1D: // ORA - Absolute,X
-		ORA_absolute_X();
-		break;
-	case 0x19: // ORA - Absolute,Y
-		ORA_absolute_Y();
-		break;
-	case 0x01: // ORA - (Indirect,X)
-		ORA_indexed_indirect();
-		break;
-	case 0x11: // ORA - (Indirect),Y
-		ORA_indirect_indexed();
-		break;
-
-	// Logical Instructions - EOR (Bitwise Exclusive OR with Accumulator)
-	case 0x49: // EOR - Immediate
-		EOR_immediate();
-		break;
-	case 0x45: // EOR - Zero Page
-		EOR_zero_page();
-		break;
-	case 0x55: // EOR - Zero Page,X
-		EOR_zero_page_X();
-		break;
-	case 0x4D: // EOR - Absolute
-		EOR_absolute();
-		break;
-	case 0x5D: // EOR - Absolute,X
-		EOR_absolute_X();
-		break;
-	case 0x59: // EOR - Absolute,Y
-		EOR_absolute_Y();
-		break;
-	case 0x41: // EOR - (Indirect,X)
-		EOR_indexed_indirect();
-		break;
-	case 0x51: // EOR - (Indirect),Y
-		EOR_indirect_indexed();
-		break;
-
-	// Shift/Rotate Instructions - ASL (Arithmetic Shift Left)
-	case 0x0A: // ASL - Accumulator
-		ASL_accumulator();
-		break;
-	case 0x06: // ASL - Zero Page
-		ASL_zero_page();
-		break;
-	case 0x16: // ASL - Zero Page,X
-		ASL_zero_page_X();
-		break;
-	case 0x0E: // ASL - Absolute
-		ASL_absolute();
-		break;
-	case 0x1E: // ASL - Absolute,X
-		ASL_absolute_X();
-		break;
-
-	// Shift/Rotate Instructions - LSR (Logical Shift Right)
-	case 0x4A: // LSR - Accumulator
-		LSR_accumulator();
-		break;
-	case 0x46: // LSR - Zero Page
-		LSR_zero_page();
-		break;
-	case 0x56: // LSR - Zero Page,X
-		LSR_zero_page_X();
-		break;
-	case 0x4E: // LSR - Absolute
-		LSR_absolute();
-		break;
-	case 0x5E: // LSR - Absolute,X
-		LSR_absolute_X();
-		break;
-
-	// Shift/Rotate Instructions - ROL (Rotate Left)
-	case 0x2A: // ROL - Accumulator
-		ROL_accumulator();
-		break;
-	case 0x26: // ROL - Zero Page
-		ROL_zero_page();
-		break;
-	case 0x36: // ROL - Zero Page,X
-		ROL_zero_page_X();
-		break;
-	case 0x2E: // ROL - Absolute
-		ROL_absolute();
-		break;
-	case 0x3E: // ROL - Absolute,X
-		ROL_absolute_X();
-		break;
-
-	// Shift/Rotate Instructions - ROR (Rotate Right)
-	case 0x6A: // ROR - Accumulator
-		ROR_accumulator();
-		break;
-	case 0x66: // ROR - Zero Page
-		ROR_zero_page();
-		break;
-	case 0x76: // ROR - Zero Page,X
-		ROR_zero_page_X();
-		break;
-	case 0x6E: // ROR - Absolute
-		ROR_absolute();
-		break;
-	case 0x7E: // ROR - Absolute,X
-		ROR_absolute_X();
-		break;
-
-	// Increment/Decrement Instructions - Register Operations
-	case 0xE8: // INX - Increment X Register
-		INX();
-		break;
-	case 0xC8: // INY - Increment Y Register
-		INY();
-		break;
-	case 0xCA: // DEX - Decrement X Register
-		DEX();
-		break;
-	case 0x88: // DEY - Decrement Y Register
-		DEY();
-		break;
-
-	// Increment/Decrement Instructions - Memory Operations
-	case 0xE6: // INC Zero Page
-		INC_zero_page();
-		break;
-	case 0xF6: // INC Zero Page,X
-		INC_zero_page_X();
-		break;
-	case 0xEE: // INC Absolute
-		INC_absolute();
-		break;
-	case 0xFE: // INC Absolute,X
-		INC_absolute_X();
-		break;
-	case 0xC6: // DEC Zero Page
-		DEC_zero_page();
-		break;
-	case 0xD6: // DEC Zero Page,X
-		DEC_zero_page_X();
-		break;
-	case 0xCE: // DEC Absolute
-		DEC_absolute();
-		break;
-	case 0xDE: // DEC Absolute,X
-		DEC_absolute_X();
-		break;
-
-	// Branch Instructions
-	case 0x10: // BPL - Branch if Plus/Positive
-		BPL_relative();
-		break;
-	case 0x30: // BMI - Branch if Minus/Negative
-		BMI_relative();
-		break;
-	case 0x50: // BVC - Branch if Overflow Clear
-		BVC_relative();
-		break;
-	case 0x70: // BVS - Branch if Overflow Set
-		BVS_relative();
-		break;
-	case 0x90: // BCC - Branch if Carry Clear
-		BCC_relative();
-		break;
-	case 0xB0: // BCS - Branch if Carry Set
-		BCS_relative();
-		break;
-	case 0xD0: // BNE - Branch if Not Equal/Zero Clear
-		BNE_relative();
-		break;
-	case 0xF0: // BEQ - Branch if Equal/Zero Set
-		BEQ_relative();
-		break;
-
-	// Jump and Subroutine Instructions
-	case 0x4C: // JMP - Jump to absolute address
-		JMP_absolute();
-		break;
-	case 0x6C: // JMP - Jump to indirect address
-		JMP_indirect();
-		break;
-	case 0x20: // JSR - Jump to Subroutine
-		JSR();
-		break;
-	case 0x60: // RTS - Return from Subroutine
-		RTS();
-		break;
-	case 0x40: // RTI - Return from Interrupt
-		RTI();
-		break;
-
-	// Stack Operations
-	case 0x48: // PHA - Push Accumulator
-		PHA();
-		break;
-	case 0x68: // PLA - Pull Accumulator
-		PLA();
-		break;
-	case 0x08: // PHP - Push Processor Status
-		PHP();
-		break;
-	case 0x28: // PLP - Pull Processor Status
-		PLP();
-		break;
-
-	// Status Flag Instructions
-	case 0x18: // CLC - Clear Carry Flag
-		CLC();
-		break;
-	case 0x38: // SEC - Set Carry Flag
-		SEC();
-		break;
-	case 0x58: // CLI - Clear Interrupt Flag
-		CLI();
-		break;
-	case 0x78: // SEI - Set Interrupt Flag
-		SEI();
-		break;
-	case 0xB8: // CLV - Clear Overflow Flag
-		CLV();
-		break;
-	case 0xD8: // CLD - Clear Decimal Flag
-		CLD();
-		break;
-	case 0xF8: // SED - Set Decimal Flag
-		SED();
-		break;
-
-	// Transfer instructions (remaining)
-	case 0x9A: // TXS - Transfer X to Stack Pointer
-		TXS();
-		break;
-	case 0xBA: // TSX - Transfer Stack Pointer to X
-		TSX();
-		break;
-
-	// Bit test instructions
-	case 0x24: // BIT - Zero Page
-		BIT_zero_page();
-		break;
-	case 0x2C: // BIT - Absolute
-		BIT_absolute();
-		break;
-
-	// System instructions
-	case 0x00: // BRK - Break
-		BRK();
-		break;
-
-	// No Operation
-	case 0xEA:
-		NOP();
-		break;
-
-	// ===== UNDOCUMENTED/UNOFFICIAL OPCODES =====
-	// LAX - Load Accumulator and X Register
-	case 0xA7: // LAX zp
-		LAX_zero_page();
-		break;
-	case 0xB7: // LAX zp,Y
-		LAX_zero_page_Y();
-		break;
-	case 0xAF: // LAX abs
-		LAX_absolute();
-		break;
-	case 0xBF: // LAX abs,Y
-		LAX_absolute_Y();
-		break;
-	case 0xA3: // LAX (zp,X)
-		LAX_indexed_indirect();
-		break;
-	case 0xB3: // LAX (zp),Y
-		LAX_indirect_indexed();
-		break;
-
-	// SAX - Store Accumulator AND X Register
-	case 0x87: // SAX zp
-		SAX_zero_page();
-		break;
-	case 0x97: // SAX zp,Y
-		SAX_zero_page_Y();
-		break;
-	case 0x8F: // SAX abs
-		SAX_absolute();
-		break;
-	case 0x83: // SAX (zp,X)
-		SAX_indexed_indirect();
-		break;
+	// Back at the head of an idle loop: fast-forward whole iterations
+	if (idle_loop_armed && program_counter_ == idle_loop_head_ && skip_idle_loop()) {
+#ifdef VIBENES_CPU_PROFILER
+		if (profiler_) {
+			profiler_->record_idle_cycles(program_counter_, static_cast<std::uint64_t>(instruction_cycles()));
+		}
+#endif
+		return instruction_cycles();
+	}
 
-	// DCP - Decrement and Compare
-	case 0xC7: // DCP zp
-		DCP_zero_page();
-		break;
-	case 0xD7: // DCP zp,X
-		DCP_zero_page_X();
-		break;
-	case 0xCF: // DCP abs
-		DCP_absolute();
-		break;
-	case 0xDF: // DCP abs,X
-		DCP_absolute_X();
-		break;
-	case 0xDB: // DCP abs,Y
-		DCP_absolute_Y();
-		break;
-	case 0xC3: // DCP (zp,X)
-		DCP_indexed_indirect();
-		break;
-	case 0xD3: // DCP (zp),Y
-		DCP_indirect_indexed();
-		break;
+	// A jump or branch landed here: run the compiled block starting here, if
+	// there is one and it can run without stopping
+	const bool block_head = block_head_;
+	block_head_ = false;
+	if (block_head && run_block()) {
+		return instruction_cycles();
+	}
 
-	// ISC/ISB - Increment and Subtract with Carry
-	case 0xE7: // ISC zp
-		ISC_zero_page();
-		break;
-	case 0xF7: // ISC zp,X
-		ISC_zero_page_X();
-		break;
-	case 0xEF: // ISC abs
-		ISC_absolute();
-		break;
-	case 0xFF: // ISC abs,X
-		ISC_absolute_X();
-		break;
-	case 0xFB: // ISC abs,Y
-		ISC_absolute_Y();
-		break;
-	case 0xE3: // ISC (zp,X)
-		ISC_indexed_indirect();
-		break;
-	case 0xF3: // ISC (zp),Y
-		ISC_indirect_indexed();
-		break;
+#ifdef VIBENES_CPU_PROFILER
+	const Address profile_pc = program_counter_;
+	const Byte profile_sp = stack_pointer_;
+#endif
+#ifdef VIBENES_CPU_TRACE
+	if (tracer_) {
+		trace_instruction();
+	}
+#endif
 
-	// SLO - Shift Left and OR
-	case 0x07: // SLO zp
-		SLO_zero_page();
-		break;
-	case 0x17: // SLO zp,X
-		SLO_zero_page_X();
-		break;
-	case 0x0F: // SLO abs
-		SLO_absolute();
-		break;
-	case 0x1F: // SLO abs,X
-		SLO_absolute_X();
-		break;
-	case 0x1B: // SLO abs,Y
-		SLO_absolute_Y();
-		break;
-	case 0x03: // SLO (zp,X)
-		SLO_indexed_indirect();
-		break;
-	case 0x13: // SLO (zp),Y
-		SLO_indirect_indexed();
-		break;
+	// Fetch opcode
+	Byte opcode = fetch_opcode();
+	program_counter_++;
 
-	// RLA - Rotate Left and AND
-	case 0x27: // RLA zp
-		RLA_zero_page();
-		break;
-	case 0x37: // RLA zp,X
-		RLA_zero_page_X();
-		break;
-	case 0x2F: // RLA abs
-		RLA_absolute();
-		break;
-	case 0x3F: // RLA abs,X
-		RLA_absolute_X();
-		break;
-	case 0x3B: // RLA abs,Y
-		RLA_absolute_Y();
-		break;
-	case 0x23: // RLA (zp,X)
-		RLA_indexed_indirect();
-		break;
-	case 0x33: // RLA (zp),Y
-		RLA_indirect_indexed();
-		break;
+	// Decode and execute
+#ifdef VIBENES_CPU_COMPUTED_GOTO
+	// Jump straight to a per-opcode label; each label calls its handler
+	// directly, so handlers can be inlined exactly as with a switch
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic" // labels as values
+	static const void *const labels[256] = {
+#define X(op, handler) &&op_##op,
+		VIBENES_CPU_OPCODES(X)
+#undef X
+	};
+	goto *labels[opcode];
+#ifdef VIBENES_CPU_PROFILER
+#define VIBENES_CPU_HANDLER_DONE goto handler_done;
+#else
+#define VIBENES_CPU_HANDLER_DONE return instruction_cycles();
+#endif
+#define X(op, handler)                                                                                                 \
+	op_##op:                                                                                                           \
+	handler();                                                                                                         \
+	VIBENES_CPU_HANDLER_DONE
+	VIBENES_CPU_OPCODES(X)
+#undef X
+#undef VIBENES_CPU_HANDLER_DONE
+#pragma GCC diagnostic pop
+#ifdef VIBENES_CPU_PROFILER
+handler_done:
+#endif
+#else
+	(this->*OPCODE_TABLE[opcode])();
+#endif
+
+#ifdef VIBENES_CPU_PROFILER
+	if (profiler_) {
+		profiler_->record_instruction(profile_pc, opcode, instruction_cycles(), program_counter_, profile_sp,
+									  stack_pointer_);
+	}
+#endif
 
-	// SRE - Shift Right and EOR
-	case 0x47: // SRE zp
-		SRE_zero_page();
-		break;
-	case 0x57: // SRE zp,X
-		SRE_zero_page_X();
-		break;
-	case 0x4F: // SRE abs
-		SRE_absolute();
-		break;
-	case 0x5F: // SRE abs,X
-		SRE_absolute_X();
-		break;
-	case 0x5B: // SRE abs,Y
-		SRE_absolute_Y();
-		break;
-	case 0x43: // SRE (zp,X)
-		SRE_indexed_indirect();
-		break;
-	case 0x53: // SRE (zp),Y
-		SRE_indirect_indexed();
-		break;
+	// Return the number of cycles consumed by this instruction
+	return instruction_cycles();
+}
 
-	// RRA - Rotate Right and Add
-	case 0x67: // RRA zp
-		RRA_zero_page();
-		break;
-	case 0x77: // RRA zp,X
-		RRA_zero_page_X();
-		break;
-	case 0x6F: // RRA abs
-		RRA_absolute();
-		break;
-	case 0x7F: // RRA abs,X
-		RRA_absolute_X();
-		break;
-	case 0x7B: // RRA abs,Y
-		RRA_absolute_Y();
-		break;
-	case 0x63: // RRA (zp,X)
-		RRA_indexed_indirect();
-		break;
-	case 0x73: // RRA (zp),Y
-		RRA_indirect_indexed();
-		break;
+// =============================================================================
+// Idle-loop skipping
+// =============================================================================
+// Loops recognised here read nothing but RAM or PPUSTATUS and write nothing,
+// so every iteration leaves registers, flags and memory exactly as the one
+// before — until an NMI, IRQ or VBlank changes what the next read returns.
+// The bus knows how many cycles remain before any of those can happen; the
+// CPU replays whole iterations inside that window in one step. Only the time
+// between events is skipped: the final iteration before each event always
+// runs for real, so interrupt latency and the value seen are unchanged.
+
+void CPU6502::arm_idle_loop(Address head, std::uint32_t iteration_cycles, bool polls_status) noexcept {
+	idle_loop_armed_ = true;
+	idle_loop_head_ = head;
+	idle_loop_cycles_ = iteration_cycles;
+	idle_loop_polls_status_ = polls_status;
+}
+
+void CPU6502::detect_poll_loop(Address branch_address, Address target, std::uint32_t branch_cycles) {
+	if (target == branch_address) {
+		arm_idle_loop(target, branch_cycles);
+		return;
+	}
+	// The body's load must have run after any interrupt that could have
+	// changed what it reads; otherwise this pass decided on stale data
+	const bool interrupted = idle_loop_interrupted_;
+	idle_loop_interrupted_ = false;
+	if (interrupted || branch_address == idle_loop_rejected_) {
+		return;
+	}
 
-	// Undocumented NOPs
-	case 0x80: // NOP #value (unofficial)
-	case 0x82: // NOP #value (unofficial)
-	case 0x89: // NOP #value (unofficial)
-	case 0xC2: // NOP #value (unofficial)
-	case 0xE2: // NOP #value (unofficial)
-		NOP_immediate();
+	// Body: LDA/LDX/LDY/BIT zp|abs, optionally CMP/CPX/CPY/AND #imm, then
+	// this branch
+	const Byte load = bus_->peek(target);
+	bool zero_page;
+	switch (load) {
+	case 0xA5: // LDA zp
+	case 0xA6: // LDX zp
+	case 0xA4: // LDY zp
+	case 0x24: // BIT zp
+		zero_page = true;
+		break;
+	case 0xAD: // LDA abs
+	case 0xAE: // LDX abs
+	case 0xAC: // LDY abs
+	case 0x2C: // BIT abs
+		zero_page = false;
 		break;
+	default:
+		idle_loop_rejected_ = branch_address;
+		return;
+	}
 
-	case 0x04: // NOP zp (unofficial)
-	case 0x44: // NOP zp (unofficial)
-	case 0x64: // NOP zp (unofficial)
-		NOP_zero_page();
-		break;
+	const Address operand_address = static_cast<Address>(target + 1);
+	const Address address =
+		zero_page ? bus_->peek(operand_address)
+				  : static_cast<Address>(bus_->peek(operand_address) |
+										 (bus_->peek(static_cast<Address>(target + 2)) << 8));
+	Address next = static_cast<Address>(target + (zero_page ? 2 : 3));
+	std::uint32_t cycles = (zero_page ? 3 : 4) + branch_cycles;
+
+	bool has_compare = false;
+	if (next != branch_address) {
+		const Byte compare = bus_->peek(next);
+		const bool valid = compare == 0xC9 || compare == 0xE0 || compare == 0xC0 || // CMP/CPX/CPY #imm
+						   (compare == 0x29 && (load == 0xA5 || load == 0xAD));		  // AND #imm after LDA
+		if (!valid) {
+			idle_loop_rejected_ = branch_address;
+			return;
+		}
+		has_compare = true;
+		next = static_cast<Address>(next + 2);
+		cycles += 2;
+	}
 
-	case 0x14: // NOP zp,X (unofficial)
-	case 0x34: // NOP zp,X (unofficial)
-	case 0x54: // NOP zp,X (unofficial)
-	case 0x74: // NOP zp,X (unofficial)
-	case 0xD4: // NOP zp,X (unofficial)
-	case 0xF4: // NOP zp,X (unofficial)
-		NOP_zero_page_X();
-		break;
+	// RAM reads are pure. PPUSTATUS polling is safe while waiting for VBlank
+	// (BPL on bit 7, which only a sync point sets); other bits change
+	// mid-frame and have no matching event
+	const bool ram = address < 0x2000;
+	const bool ppu_status = (address & 0xE007) == 0x2002 && !has_compare && bus_->peek(branch_address) == 0x10;
+	if (next != branch_address || !(ram || ppu_status)) {
+		idle_loop_rejected_ = branch_address;
+		return;
+	}
+	arm_idle_loop(target, cycles, ppu_status);
+}
 
-	case 0x0C: // NOP abs (unofficial)
-		NOP_absolute();
-		break;
+bool CPU6502::skip_idle_loop() {
+	// Something already latched for the next boundary — let it through. Armed
+	// breakpoints must see every iteration's fetches and accesses.
+	if (bus_->breakpoints().is_armed() || interrupt_state_.nmi_pending || curr_nmi_pending_ || prev_nmi_pending_ ||
+		curr_irq_signal_ || prev_irq_signal_ || (irq_line_ && !status_.flags.interrupt_flag_)) {
+		return false;
+	}
 
-	case 0x1C: // NOP abs,X (unofficial)
-	case 0x3C: // NOP abs,X (unofficial)
-	case 0x5C: // NOP abs,X (unofficial)
-	case 0x7C: // NOP abs,X (unofficial)
-	case 0xDC: // NOP abs,X (unofficial)
-	case 0xFC: // NOP abs,X (unofficial)
-		NOP_absolute_X();
-		break;
+	const std::uint32_t iteration = idle_loop_cycles_;
+	const std::uint32_t available = bus_->idle_cycles_available();
+	if (available < 2 * iteration) {
+		return false;
+	}
+	// VBlank may have started since the last pass read PPUSTATUS; the next
+	// read then ends the loop (the bus is caught up by the query above)
+	if (idle_loop_polls_status_ && (bus_->peek(0x2002) & 0x80)) {
+		return false;
+	}
+	// Leave at least one iteration to run for real before the event
+	const std::uint32_t cycles = (available - iteration) / iteration * iteration;
 
-	// Single-byte NOPs (same as 0xEA but different opcodes)
-	case 0x1A: // NOP (unofficial)
-	case 0x3A: // NOP (unofficial)
-	case 0x5A: // NOP (unofficial)
-	case 0x7A: // NOP (unofficial)
-	case 0xDA: // NOP (unofficial)
-	case 0xFA: // NOP (unofficial)
-		NOP();
-		break;
+	bus_->advance_idle_cycles(cycles);
+#ifndef VIBENES_CPU_BATCHED_CYCLES
+	cycles_remaining_ -= CpuCycle{static_cast<std::int64_t>(cycles)};
+	cycles_consumed_ += static_cast<int>(cycles);
+#endif
+	idle_cycles_skipped_ += cycles;
+	return true;
+}
 
-	// Highly unstable opcodes - these crash the CPU
-	case 0x8B: // ANE/XAA - extremely unstable
-	case 0xAB: // LAX #value - sometimes works, sometimes doesn't
-	case 0x9F: // SHA/AHX abs,Y - unstable high byte
-	case 0x93: // SHA/AHX (zp),Y - unstable high byte
-	case 0x9E: // SHX abs,Y - unstable high byte
-	case 0x9C: // SHY abs,X - unstable high byte
-	case 0x9B: // TAS - transfers A&X to SP, unstable high byte in abs,Y
-	case 0xBB: // LAS - load A&X&SP from memory AND stack pointer
-		CRASH();
-		break;
+// =============================================================================
+// Block execution
+// =============================================================================
+// A block's instructions read and write nothing but their own fetches and
+// zero page, and cannot change the I flag, so nothing outside the CPU sees
+// them until the bus advances. When the bus confirms the whole block ends
+// short of the next scheduled event (where NMI, IRQ, DMC DMA, sprite 0 and
+// frame timing all live), the instructions run back to back on the
+// registers and the bus is ticked once by their total. Both interrupt
+// samples of the last cycle are then taken on lines that cannot have moved,
+// as consume_cycles() does in batched builds.
+
+void CPU6502::set_block_execution(bool enabled) {
+	if (!enabled) {
+		block_cache_.reset();
+	} else if (!block_cache_) {
+		block_cache_ = std::make_unique<CpuBlockCache>();
+	}
+	block_head_ = false;
+}
 
-	default:
-		std::cerr << std::format("Unknown opcode: 0x{:02X} at PC: 0x{:04X}\n", static_cast<int>(opcode),
-								 static_cast<int>(program_counter_ - 1));
-		// Every opcode 0x00-0xFF should be handled above; reaching here means a
-		// decoder or ROM bug. Flag it (queryable via is_halted()) so callers can
-		// detect it, then fall back to NOP timing so the emulator keeps running.
-		halted_ = true;
-		cycles_remaining_ -= CpuCycle{2};
-		break;
+bool CPU6502::run_block() {
+	if (!block_cache_ || breakpoint_count_ != 0 || bus_->breakpoints().is_armed() || interrupt_state_.nmi_pending ||
+		curr_nmi_pending_ || curr_irq_signal_ || (irq_line_ && !status_.flags.interrupt_flag_)) {
+		return false;
+	}
+#ifdef VIBENES_CPU_PROFILER
+	if (profiler_) {
+		return false;
+	}
+#endif
+#ifdef VIBENES_CPU_TRACE
+	if (tracer_) {
+		return false;
 	}
+#endif
 
-	// Return the number of cycles consumed by this instruction
-	return cycles_consumed_;
+	// Only PRG ROM: code in PRG-RAM can be rewritten under its block
+	const Byte *page = bus_->prg_fetch_page(program_counter_);
+	if (!page) {
+		return false;
+	}
+	const std::span<const Byte> rom = bus_->get_cartridge()->prg_rom_data();
+	const auto page_start = reinterpret_cast<std::uintptr_t>(page);
+	const auto rom_start = reinterpret_cast<std::uintptr_t>(rom.data());
+	const std::size_t in_page = program_counter_ & 0x1FFF;
+	if (page_start < rom_start || page_start - rom_start + 0x2000 > rom.size()) {
+		return false;
+	}
+	const CpuBlockCache::Block *block =
+		block_cache_->lookup(rom, page_start - rom_start + in_page, std::span<const Byte>(page + in_page, 0x2000 - in_page));
+	if (!block || !bus_->can_tick_cpu_cycles(block->cycles + (block->ends_in_branch ? 2u : 0u))) {
+		return false;
+	}
+
+	const CpuBlockCache::Instruction *code = block_cache_->code(*block);
+	Address pc = program_counter_;
+	int cycles = block->cycles;
+	for (std::uint8_t i = 0; i < block->count; ++i) {
+		const CpuBlockCache::Instruction instruction = code[i];
+		bus_->latch_fetch(pc, instruction.opcode);
+		const Byte operand = instruction.operand;
+		if (OPCODE_INFO[instruction.opcode].length == 2) {
+			bus_->latch_fetch(static_cast<Address>(pc + 1), operand);
+			pc = static_cast<Address>(pc + 2);
+		} else {
+			pc = static_cast<Address>(pc + 1);
+		}
+		Byte value;
+		bool taken = false;
+		switch (instruction.opcode) {
+		case 0xAA: // TAX
+			x_register_ = accumulator_;
+			update_zero_and_negative_flags(x_register_);
+			break;
+		case 0xA8: // TAY
+			y_register_ = accumulator_;
+			update_zero_and_negative_flags(y_register_);
+			break;
+		case 0x8A: // TXA
+			accumulator_ = x_register_;
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0x98: // TYA
+			accumulator_ = y_register_;
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0xBA: // TSX
+			x_register_ = stack_pointer_;
+			update_zero_and_negative_flags(x_register_);
+			break;
+		case 0x9A: // TXS
+			stack_pointer_ = x_register_;
+			break;
+		case 0xE8: // INX
+			update_zero_and_negative_flags(++x_register_);
+			break;
+		case 0xC8: // INY
+			update_zero_and_negative_flags(++y_register_);
+			break;
+		case 0xCA: // DEX
+			update_zero_and_negative_flags(--x_register_);
+			break;
+		case 0x88: // DEY
+			update_zero_and_negative_flags(--y_register_);
+			break;
+		case 0x18: // CLC
+			status_.flags.carry_flag_ = false;
+			break;
+		case 0x38: // SEC
+			status_.flags.carry_flag_ = true;
+			break;
+		case 0xB8: // CLV
+			status_.flags.overflow_flag_ = false;
+			break;
+		case 0xD8: // CLD
+			status_.flags.decimal_flag_ = false;
+			break;
+		case 0xF8: // SED
+			status_.flags.decimal_flag_ = true;
+			break;
+		case 0xEA: // NOP
+			break;
+		case 0x0A: // ASL A
+			status_.flags.carry_flag_ = (accumulator_ & 0x80) != 0;
+			accumulator_ = static_cast<Byte>(accumulator_ << 1);
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0x4A: // LSR A
+			status_.flags.carry_flag_ = (accumulator_ & 0x01) != 0;
+			accumulator_ = static_cast<Byte>(accumulator_ >> 1);
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0x2A: { // ROL A
+			const bool carry = (accumulator_ & 0x80) != 0;
+			accumulator_ = static_cast<Byte>((accumulator_ << 1) | (status_.flags.carry_flag_ ? 1 : 0));
+			status_.flags.carry_flag_ = carry;
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		}
+		case 0x6A: { // ROR A
+			const bool carry = (accumulator_ & 0x01) != 0;
+			accumulator_ = static_cast<Byte>((accumulator_ >> 1) | (status_.flags.carry_flag_ ? 0x80 : 0));
+			status_.flags.carry_flag_ = carry;
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		}
+		case 0xA9: // LDA #
+			accumulator_ = operand;
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0xA2: // LDX #
+			x_register_ = operand;
+			update_zero_and_negative_flags(x_register_);
+			break;
+		case 0xA0: // LDY #
+			y_register_ = operand;
+			update_zero_and_negative_flags(y_register_);
+			break;
+		case 0x69: // ADC #
+			perform_adc(operand);
+			break;
+		case 0xE9: // SBC #
+			perform_sbc(operand);
+			break;
+		case 0x29: // AND #
+			accumulator_ &= operand;
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0x09: // ORA #
+			accumulator_ |= operand;
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0x49: // EOR #
+			accumulator_ ^= operand;
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0xC9: // CMP #
+			perform_compare(accumulator_, operand);
+			break;
+		case 0xE0: // CPX #
+			perform_compare(x_register_, operand);
+			break;
+		case 0xC0: // CPY #
+			perform_compare(y_register_, operand);
+			break;
+		case 0xA5: // LDA zp
+			accumulator_ = bus_->read_low_ram(operand);
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0xA6: // LDX zp
+			x_register_ = bus_->read_low_ram(operand);
+			update_zero_and_negative_flags(x_register_);
+			break;
+		case 0xA4: // LDY zp
+			y_register_ = bus_->read_low_ram(operand);
+			update_zero_and_negative_flags(y_register_);
+			break;
+		case 0x65: // ADC zp
+			perform_adc(bus_->read_low_ram(operand));
+			break;
+		case 0xE5: // SBC zp
+			perform_sbc(bus_->read_low_ram(operand));
+			break;
+		case 0x25: // AND zp
+			accumulator_ &= bus_->read_low_ram(operand);
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0x05: // ORA zp
+			accumulator_ |= bus_->read_low_ram(operand);
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0x45: // EOR zp
+			accumulator_ ^= bus_->read_low_ram(operand);
+			update_zero_and_negative_flags(accumulator_);
+			break;
+		case 0xC5: // CMP zp
+			perform_compare(accumulator_, bus_->read_low_ram(operand));
+			break;
+		case 0xE4: // CPX zp
+			perform_compare(x_register_, bus_->read_low_ram(operand));
+			break;
+		case 0xC4: // CPY zp
+			perform_compare(y_register_, bus_->read_low_ram(operand));
+			break;
+		case 0x24: // BIT zp
+			value = bus_->read_low_ram(operand);
+			status_.flags.zero_flag_ = (accumulator_ & value) == 0;
+			status_.flags.negative_flag_ = (value & 0x80) != 0;
+			status_.flags.overflow_flag_ = (value & 0x40) != 0;
+			break;
+		case 0x85: // STA zp
+			bus_->write_low_ram(operand, accumulator_);
+			break;
+		case 0x86: // STX zp
+			bus_->write_low_ram(operand, x_register_);
+			break;
+		case 0x84: // STY zp
+			bus_->write_low_ram(operand, y_register_);
+			break;
+		// Read-modify-write: the dummy cycle rewrites the old value (or only
+		// waits), which nothing but the final write can observe here
+		case 0xE6: // INC zp
+			value = static_cast<Byte>(bus_->read_low_ram(operand) + 1);
+			bus_->write_low_ram(operand, value);
+			update_zero_and_negative_flags(value);
+			break;
+		case 0xC6: // DEC zp
+			value = static_cast<Byte>(bus_->read_low_ram(operand) - 1);
+			bus_->write_low_ram(operand, value);
+			update_zero_and_negative_flags(value);
+			break;
+		case 0x06: // ASL zp
+			value = bus_->read_low_ram(operand);
+			status_.flags.carry_flag_ = (value & 0x80) != 0;
+			value = static_cast<Byte>(value << 1);
+			bus_->write_low_ram(operand, value);
+			update_zero_and_negative_flags(value);
+			break;
+		case 0x46: // LSR zp
+			value = bus_->read_low_ram(operand);
+			status_.flags.carry_flag_ = (value & 0x01) != 0;
+			value = static_cast<Byte>(value >> 1);
+			bus_->write_low_ram(operand, value);
+			update_zero_and_negative_flags(value);
+			break;
+		case 0x26: { // ROL zp
+			value = bus_->read_low_ram(operand);
+			const bool carry = (value & 0x80) != 0;
+			value = static_cast<Byte>((value << 1) | (status_.flags.carry_flag_ ? 1 : 0));
+			status_.flags.carry_flag_ = carry;
+			bus_->write_low_ram(operand, value);
+			update_zero_and_negative_flags(value);
+			break;
+		}
+		case 0x66: { // ROR zp
+			value = bus_->read_low_ram(operand);
+			const bool carry = (value & 0x01) != 0;
+			value = static_cast<Byte>((value >> 1) | (status_.flags.carry_flag_ ? 0x80 : 0));
+			status_.flags.carry_flag_ = carry;
+			bus_->write_low_ram(operand, value);
+			update_zero_and_negative_flags(value);
+			break;
+		}
+		case 0x10: // BPL
+			taken = !status_.flags.negative_flag_;
+			break;
+		case 0x30: // BMI
+			taken = status_.flags.negative_flag_;
+			break;
+		case 0x50: // BVC
+			taken = !status_.flags.overflow_flag_;
+			break;
+		case 0x70: // BVS
+			taken = status_.flags.overflow_flag_;
+			break;
+		case 0x90: // BCC
+			taken = !status_.flags.carry_flag_;
+			break;
+		case 0xB0: // BCS
+			taken = status_.flags.carry_flag_;
+			break;
+		case 0xD0: // BNE
+			taken = !status_.flags.zero_flag_;
+			break;
+		case 0xF0: // BEQ
+			taken = status_.flags.zero_flag_;
+			break;
+		default:
+			break;
+		}
+		if (taken) {
+			// As branch(): the target is the next head, and a backward
+			// branch may close an idle loop
+			const Address branch_address = static_cast<Address>(pc - 2);
+			const Address target = static_cast<Address>(pc + static_cast<SignedByte>(operand));
+			const std::uint32_t branch_cycles = (pc & 0xFF00) != (target & 0xFF00) ? 4 : 3;
+			cycles += static_cast<int>(branch_cycles) - 2;
+			pc = target;
+			if (idle_loop_skipping_ && target <= branch_address) {
+				detect_poll_loop(branch_address, target, branch_cycles);
+			}
+		}
+	}
+	program_counter_ = pc;
+	// Whatever follows (the branch target, or code the block stopped short
+	// of) may start the next block
+	block_head_ = true;
+	// The fetches and zero-page accesses above left the bus latch where the
+	// last cycle leaves it
+	(void)try_advance_cycles(cycles);
+	sample_interrupt_lines();
+	sample_interrupt_lines();
+	block_instructions_ += block->count;
+	return true;
 }
 
 // Memory access methods
@@ -1072,11 +866,142 @@ Byte CPU6502::read_byte(Address address) {
 	return bus_->read(address);
 }
 
+std::uint64_t CPU6502::get_cycle_count() const noexcept {
+	return bus_->get_master_clock() / EventScheduler::CLOCKS_PER_CPU_CYCLE;
+}
+
+template <bool StopAtFrameEnd> CPU6502::RunResult CPU6502::run_loop(std::uint64_t budget) {
+	RunResult result;
+	const PPU *ppu = StopAtFrameEnd ? bus_->get_ppu() : nullptr;
+	const std::uint64_t start_frame = ppu ? ppu->get_frame_count() : 0;
+	Breakpoints &engine = bus_->breakpoints();
+	const bool check_breakpoints = breakpoint_count_ != 0 || engine.is_armed();
+	engine.take_hit(); // Left over from accesses outside a run
+
+	while (result.cycles < budget) {
+		if (check_breakpoints) [[unlikely]] {
+			if (result.cycles != 0 && breakpoint_count_ != 0 && breakpoints_[program_counter_]) {
+				result.stop = RunStop::Breakpoint;
+				result.hit = {0, Breakpoints::EXECUTE, program_counter_, bus_->peek(program_counter_)};
+				return result;
+			}
+			if (result.cycles != 0 && engine.watches(Breakpoints::EXECUTE, program_counter_) &&
+				engine.check(Breakpoints::EXECUTE, program_counter_, bus_->peek(program_counter_))) {
+				result.stop = RunStop::Breakpoint;
+				result.hit = *engine.take_hit();
+				return result;
+			}
+		}
+		const int consumed = execute_instruction();
+		if (consumed <= 0) {
+			result.stop = RunStop::Halted;
+			return result;
+		}
+		// PPU/APU already advanced per-cycle inside consume_cycle()
+		result.cycles += static_cast<std::uint64_t>(consumed);
+		if (check_breakpoints && engine.has_hit()) [[unlikely]] {
+			result.stop = RunStop::Watchpoint;
+			result.hit = *engine.take_hit();
+			return result;
+		}
+		if constexpr (StopAtFrameEnd) {
+			if (ppu && ppu->get_frame_count() != start_frame) {
+				result.stop = RunStop::FrameReady;
+				return result;
+			}
+		}
+	}
+	return result;
+}
+
+CPU6502::RunResult CPU6502::run_until(std::uint64_t target_cycle) {
+	const std::uint64_t now = get_cycle_count();
+	return run_loop<false>(target_cycle > now ? target_cycle - now : 0);
+}
+
+CPU6502::RunResult CPU6502::run_frame(std::uint64_t max_cycles) {
+	return run_loop<true>(max_cycles);
+}
+
+void CPU6502::set_breakpoint(Address address) {
+	if (breakpoints_.empty()) {
+		breakpoints_.assign(0x10000, 0);
+	}
+	if (!breakpoints_[address]) {
+		breakpoints_[address] = 1;
+		++breakpoint_count_;
+	}
+}
+
+void CPU6502::clear_breakpoint(Address address) {
+	if (has_breakpoint(address)) {
+		breakpoints_[address] = 0;
+		--breakpoint_count_;
+	}
+}
+
+void CPU6502::clear_breakpoints() {
+	breakpoints_.clear();
+	breakpoint_count_ = 0;
+}
+
+#ifdef VIBENES_CPU_TRACE
+void CPU6502::trace_instruction() {
+	TraceRecord record;
+	record.cycle = get_cycle_count();
+	record.pc = program_counter_;
+	const auto [scanline, dot] = bus_->get_ppu_position();
+	record.scanline = scanline;
+	record.dot = dot;
+	record.bytes[0] = bus_->peek(program_counter_);
+	record.length = OPCODE_INFO[record.bytes[0]].length;
+	for (std::uint8_t i = 1; i < record.length; ++i) {
+		record.bytes[i] = bus_->peek(static_cast<Address>(program_counter_ + i));
+	}
+	record.a = accumulator_;
+	record.x = x_register_;
+	record.y = y_register_;
+	record.p = status_.status_register_;
+	record.sp = stack_pointer_;
+	tracer_->record(record);
+}
+#endif
+
+Byte CPU6502::fetch_opcode() {
+	consume_cycle();
+	fetch_page_ = bus_->prg_fetch_page(program_counter_);
+	fetch_page_base_ = program_counter_ & 0xE000;
+	if (fetch_page_) [[likely]] {
+		return bus_->latch_fetch(program_counter_, fetch_page_[program_counter_ & 0x1FFF]);
+	}
+	return bus_->fetch(program_counter_);
+}
+
+Byte CPU6502::fetch_byte(Address address) {
+	consume_cycle();
+	// Operands in the opcode's page: no bank can have switched since, as an
+	// instruction only writes after its last operand fetch
+	if (fetch_page_ && (address & 0xE000) == fetch_page_base_) [[likely]] {
+		return bus_->latch_fetch(address, fetch_page_[address & 0x1FFF]);
+	}
+	return bus_->fetch(address);
+}
+
 void CPU6502::write_byte(Address address, Byte value) {
-	consume_cycle(); // Memory writes take 1 cycle
+	consume_write_cycle(); // Memory writes take 1 cycle
 	bus_->write(address, value);
 }
 
+inline Byte CPU6502::read_low_ram(Address address) {
+	consume_cycle();
+	return bus_->read_low_ram(address);
+}
+
+inline void CPU6502::write_low_ram(Address address, Byte value) {
+	consume_write_cycle();
+	bus_->write_low_ram(address, value);
+}
+
 Address CPU6502::read_word(Address address) {
 	// 6502 is little-endian
 	Byte low = read_byte(address);
@@ -1086,13 +1011,13 @@ Address CPU6502::read_word(Address address) {
 
 // Stack operations
 void CPU6502::push_byte(Byte value) {
-	write_byte(0x0100 + stack_pointer_, value);
+	write_low_ram(0x0100 + stack_pointer_, value);
 	stack_pointer_--;
 }
 
 Byte CPU6502::pull_byte() {
 	stack_pointer_++;
-	return read_byte(0x0100 + stack_pointer_);
+	return read_low_ram(0x0100 + stack_pointer_);
 }
 
 void CPU6502::push_word(Address value) {
@@ -1182,6 +1107,7 @@ int CPU6502::execute_oam_dma() {
 	// Acknowledge and clear the pending flag
 	Byte page = bus_->get_oam_dma_page();
 	bus_->clear_oam_dma_pending();
+	in_oam_dma_ = true; // DMC fetches overlap the transfer (stall_for_dmc_dma)
 
 	// Cycle 1: Dummy cycle for write-cycle alignment
 	consume_cycle();
@@ -1189,6 +1115,16 @@ int CPU6502::execute_oam_dma() {
 	// TODO: On real hardware, if the DMA starts on an odd CPU cycle there is
 	// an additional alignment dummy cycle (514 total instead of 513).
 
+	// A page that reads without side effects, copied while the PPU leaves OAM
+	// alone, needs only the transfer's timing: 512 cycles, plus 2 per DMC
+	// fetch, at up to 4 dots a cycle (PAL's 3.2 rounded up)
+	constexpr uint32_t TRANSFER_DOTS = (512 + 2 * 16) * 4;
+	if (bus_->copy_page_to_oam(page, TRANSFER_DOTS)) {
+		run_copied_oam_dma(static_cast<Address>((page << 8) | 0xFF));
+		in_oam_dma_ = false;
+		return instruction_cycles();
+	}
+
 	// 256 read+write pairs = 512 cycles
 	for (int i = 0; i < 256; i++) {
 		// Read cycle: fetch byte from CPU address space ($XX00 + i)
@@ -1200,8 +1136,32 @@ int CPU6502::execute_oam_dma() {
 		bus_->write_oam_direct(static_cast<uint8_t>(i), data);
 	}
 
+	in_oam_dma_ = false;
+
 	// Total: 1 dummy + 256×2 = 513 CPU cycles
-	return cycles_consumed_;
+	return instruction_cycles();
+}
+
+void CPU6502::run_copied_oam_dma(Address last_source) {
+	// Up to the last pair, whole runs between scheduled events go at once.
+	// Each event is taken on its own cycle through consume_cycle(), which
+	// also lets a DMC fetch it raised overlap the transfer there.
+	int remaining = 510;
+	while (remaining > 0) {
+		const int run = static_cast<int>(std::min<uint32_t>(static_cast<uint32_t>(remaining),
+															 bus_->cycles_before_next_event()));
+		if (run > 0 && try_advance_cycles(run)) {
+			remaining -= run;
+		} else {
+			consume_cycle();
+			--remaining;
+		}
+	}
+
+	// The last pair as the byte path runs it: the read leaves its value on
+	// the bus, and the two cycles give the interrupt lines their samples
+	(void)read_byte(last_source);
+	consume_cycle();
 }
 
 // Cycle management helpers
@@ -1214,35 +1174,56 @@ int CPU6502::execute_oam_dma() {
 // polling.  After an instruction ends, prev_*_signal_ holds the sample from
 // the penultimate cycle, and curr_*_signal_ from the last cycle.
 void CPU6502::consume_cycle() {
-	cycles_remaining_ -= CpuCycle{1};
-	cycles_consumed_++;
-	bus_->tick_single_cpu_cycle(); // advance PPU 3 dots, APU 1 cycle, check mapper IRQ
+	advance_cycle();
 
 	// =========================================================================
 	// DMC DMA cycle stealing
 	// =========================================================================
 	// When the APU's DMC channel needs a new sample byte, it signals a DMA
-	// request.  The CPU must stall while the DMA unit performs the read.
-	// On real hardware the stall is 1–4 cycles depending on write-cycle
-	// alignment.  We model this as ~4 cycles: 2 dummy/halt cycles, then the
-	// read cycle, then 1 alignment cycle.  Each stall cycle still advances
-	// PPU/APU so the rest of the system stays in sync.
-	if (bus_->is_dmc_dma_pending()) {
-		// Stall cycles: halt + alignment (the read itself is one more cycle)
-		// Total steal ≈ 4 CPU cycles.  We burn 3 dummy cycles, then the bus
-		// performs the actual read on the 4th.
-		for (int s = 0; s < 3; ++s) {
-			cycles_remaining_ -= CpuCycle{1};
-			cycles_consumed_++;
-			bus_->tick_single_cpu_cycle();
-		}
-		// Perform the DMA read (also consumes 1 CPU cycle for the bus read)
-		cycles_remaining_ -= CpuCycle{1};
-		cycles_consumed_++;
-		bus_->service_dmc_dma();
-		bus_->tick_single_cpu_cycle();
+	// request and the CPU stalls while the DMA unit performs the read. The
+	// unit can only halt the CPU on a read cycle, so write cycles
+	// (consume_write_cycle) leave the request for the next read.
+	if (bus_->is_dmc_dma_pending()) [[unlikely]] {
+		stall_for_dmc_dma();
+	}
+
+	sample_interrupt_lines();
+}
+
+void CPU6502::consume_write_cycle() {
+	advance_cycle();
+	sample_interrupt_lines();
+}
+
+inline void CPU6502::advance_cycle() {
+#ifndef VIBENES_CPU_BATCHED_CYCLES
+	cycles_remaining_ -= CpuCycle{1};
+	cycles_consumed_++;
+#endif
+	bus_->tick_single_cpu_cycle(); // advance PPU 3 dots, APU 1 cycle, check mapper IRQ
+}
+
+bool CPU6502::try_advance_cycles(int count) {
+	if (!bus_->try_tick_cpu_cycles(static_cast<std::uint32_t>(count))) {
+		return false;
 	}
+#ifndef VIBENES_CPU_BATCHED_CYCLES
+	cycles_remaining_ -= CpuCycle{count};
+	cycles_consumed_ += count;
+#endif
+	return true;
+}
+
+inline int CPU6502::instruction_cycles() const noexcept {
+#ifdef VIBENES_CPU_BATCHED_CYCLES
+	return static_cast<int>((bus_->get_master_clock() - instruction_start_clock_) /
+							EventScheduler::CLOCKS_PER_CPU_CYCLE);
+#else
+	return cycles_consumed_;
+#endif
+}
 
+inline void CPU6502::sample_interrupt_lines() noexcept {
 	// Penultimate-cycle polling: shift current sample into "previous".
 	// After the last consume_cycle of an instruction, prev_ holds the
 	// penultimate-cycle sample — exactly what real hardware uses to decide
@@ -1255,7 +1236,45 @@ void CPU6502::consume_cycle() {
 	curr_irq_signal_ = irq_line_ && !status_.flags.interrupt_flag_;
 }
 
+void CPU6502::stall_for_dmc_dma() {
+	// The DMA unit reads on APU "get" cycles only. On its own it halts the
+	// CPU (the halted read is repeated afterwards), spends a dummy cycle,
+	// then an alignment cycle if the next one is a "put" cycle: 3 or 4
+	// cycles, each still advancing PPU/APU. Inside an OAM DMA the transfer
+	// is already halted and aligned, so the DMC read takes one of its get
+	// slots and the transfer realigns on the next cycle: 2 cycles.
+	if (!in_oam_dma_) {
+		advance_cycle(); // Halt
+		advance_cycle(); // Dummy
+		if (!bus_->is_dma_get_cycle()) {
+			advance_cycle(); // Alignment
+		}
+	}
+	// The read itself
+#ifndef VIBENES_CPU_BATCHED_CYCLES
+	cycles_remaining_ -= CpuCycle{1};
+	cycles_consumed_++;
+#endif
+	bus_->service_dmc_dma();
+	bus_->tick_single_cpu_cycle();
+	if (in_oam_dma_) {
+		advance_cycle(); // Realignment
+	}
+}
+
 void CPU6502::consume_cycles(int count) {
+#ifdef VIBENES_CPU_BATCHED_CYCLES
+	// Nothing the interrupt lines or a DMC DMA depend on changes before the
+	// next scheduled event, so cycles that end short of it can be ticked at
+	// once; the last two samples then see the same lines
+	if (try_advance_cycles(count)) {
+		sample_interrupt_lines();
+		if (count > 1) {
+			sample_interrupt_lines();
+		}
+		return;
+	}
+#endif
 	for (int i = 0; i < count; ++i) {
 		consume_cycle();
 	}
@@ -1268,11 +1287,87 @@ bool CPU6502::crosses_page_boundary(Address base_address, Byte offset) const noe
 	return (base_address & 0xFF00) != ((base_address + offset) & 0xFF00);
 }
 
+// Addressing mode policies - only instantiated here, so every handler gets
+// its own inlined copy and the cycle rules live in exactly one place
+template <CPU6502::IndexRegister Reg>
+inline Byte CPU6502::index_register() const noexcept {
+	if constexpr (Reg == IndexRegister::X) {
+		return x_register_;
+	} else {
+		return y_register_;
+	}
+}
+
+template <bool IsWrite>
+inline Address CPU6502::index_address(Address base_address, Byte offset) {
+	// The 6502 adds the index to the low byte first and fixes the high byte
+	// on the following cycle. Reads skip that cycle when no carry was needed;
+	// stores and RMW cannot, since the bus access would hit the wrong page.
+	if (IsWrite || crosses_page_boundary(base_address, offset)) {
+		consume_cycle();
+	}
+	return static_cast<Address>(base_address + offset);
+}
+
+inline Address CPU6502::address_zero_page() {
+	// Cycle 2: Fetch zero page address
+	const Byte address = fetch_byte(program_counter_);
+	program_counter_++;
+	return address;
+}
+
+template <CPU6502::IndexRegister Reg>
+inline Address CPU6502::address_zero_page_indexed() {
+	// Cycle 2: Fetch zero page base address
+	const Byte base_address = fetch_byte(program_counter_);
+	program_counter_++;
+	// Cycle 3: Add index register (internal operation, wraps within zero page)
+	consume_cycle();
+	return static_cast<Byte>(base_address + index_register<Reg>());
+}
+
+inline Address CPU6502::address_absolute() {
+	// Cycles 2-3: Fetch low then high byte of address
+	const Byte low = fetch_byte(program_counter_);
+	program_counter_++;
+	const Byte high = fetch_byte(program_counter_);
+	program_counter_++;
+	return static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+}
+
+template <CPU6502::IndexRegister Reg, bool IsWrite>
+inline Address CPU6502::address_absolute_indexed() {
+	// Cycles 2-3: Fetch base address; cycle 4 (conditional for reads): fix high byte
+	const Address base_address = address_absolute();
+	return index_address<IsWrite>(base_address, index_register<Reg>());
+}
+
+inline Address CPU6502::address_indexed_indirect() {
+	// Cycles 2-3: Fetch zero page pointer and add X
+	const Address pointer = address_zero_page_indexed<IndexRegister::X>();
+	// Cycles 4-5: Fetch target address (pointer wraps within zero page)
+	const Byte low = read_low_ram(pointer);
+	const Byte high = read_low_ram(static_cast<Byte>(pointer + 1));
+	return static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+}
+
+template <bool IsWrite>
+inline Address CPU6502::address_indirect_indexed() {
+	// Cycle 2: Fetch zero page pointer
+	const Address pointer = address_zero_page();
+	// Cycles 3-4: Fetch base address (pointer wraps within zero page)
+	const Byte low = read_low_ram(pointer);
+	const Byte high = read_low_ram(static_cast<Byte>(pointer + 1));
+	const Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycle 5 (conditional for reads): fix high byte
+	return index_address<IsWrite>(base_address, y_register_);
+}
+
 // Instruction implementations
 void CPU6502::LDA_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch operand
-	accumulator_ = read_byte(program_counter_);
+	accumulator_ = fetch_byte(program_counter_);
 	program_counter_++;
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 2 cycles (1 for opcode fetch + 1 for operand fetch)
@@ -1281,7 +1376,7 @@ void CPU6502::LDA_immediate() {
 void CPU6502::LDX_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch operand
-	x_register_ = read_byte(program_counter_);
+	x_register_ = fetch_byte(program_counter_);
 	program_counter_++;
 	update_zero_and_negative_flags(x_register_);
 	// Total: 2 cycles
@@ -1290,7 +1385,7 @@ void CPU6502::LDX_immediate() {
 void CPU6502::LDY_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch operand
-	y_register_ = read_byte(program_counter_);
+	y_register_ = fetch_byte(program_counter_);
 	program_counter_++;
 	update_zero_and_negative_flags(y_register_);
 	// Total: 2 cycles
@@ -1299,11 +1394,9 @@ void CPU6502::LDY_immediate() {
 void CPU6502::LDX_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_address = read_byte(program_counter_);
-	program_counter_++;
-
+	const Address zero_page_address = address_zero_page();
 	// Cycle 3: Read from zero page address (0x00nn)
-	x_register_ = read_byte(static_cast<Address>(zero_page_address));
+	x_register_ = read_low_ram(zero_page_address);
 	update_zero_and_negative_flags(x_register_);
 	// Total: 3 cycles
 }
@@ -1311,59 +1404,37 @@ void CPU6502::LDX_zero_page() {
 void CPU6502::LDY_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_address = read_byte(program_counter_);
-	program_counter_++;
-
+	const Address zero_page_address = address_zero_page();
 	// Cycle 3: Read from zero page address (0x00nn)
-	y_register_ = read_byte(static_cast<Address>(zero_page_address));
+	y_register_ = read_low_ram(zero_page_address);
 	update_zero_and_negative_flags(y_register_);
 	// Total: 3 cycles
 }
 
 void CPU6502::LDY_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Add X register to base address (stays in zero page, wraps around)
-	consume_cycle();									 // Internal operation
-	Byte effective_address = base_address + x_register_; // 8-bit addition, wraps automatically
-
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read from effective zero page address
-	y_register_ = read_byte(static_cast<Address>(effective_address));
+	y_register_ = read_low_ram(effective_address);
 	update_zero_and_negative_flags(y_register_);
 	// Total: 4 cycles
 }
 
 void CPU6502::LDX_zero_page_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Add Y register to base address (stays in zero page, wraps around)
-	consume_cycle();									 // Internal operation
-	Byte effective_address = base_address + y_register_; // 8-bit addition, wraps automatically
-
+	// Cycles 2-3: Fetch zero page base address, add Y (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::Y>();
 	// Cycle 4: Read from effective zero page address
-	x_register_ = read_byte(static_cast<Address>(effective_address));
+	x_register_ = read_low_ram(effective_address);
 	update_zero_and_negative_flags(x_register_);
 	// Total: 4 cycles
 }
 
 void CPU6502::LDX_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 4: Read from absolute address (little-endian)
-	Address absolute_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address absolute_address = address_absolute();
 	x_register_ = read_byte(absolute_address);
 	update_zero_and_negative_flags(x_register_);
 	// Total: 4 cycles
@@ -1371,16 +1442,8 @@ void CPU6502::LDX_absolute() {
 
 void CPU6502::LDY_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 4: Read from absolute address (little-endian)
-	Address absolute_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address absolute_address = address_absolute();
 	y_register_ = read_byte(absolute_address);
 	update_zero_and_negative_flags(y_register_);
 	// Total: 4 cycles
@@ -1388,26 +1451,8 @@ void CPU6502::LDY_absolute() {
 
 void CPU6502::LDY_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Assemble base address (little-endian)
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-
-	// Calculate effective address
-	Address effective_address = base_address + x_register_;
-
-	// Cycle 4: Read from effective address
-	// Page boundary crossing adds 1 cycle (total becomes 5 cycles)
-	if (crosses_page_boundary(base_address, x_register_)) {
-		consume_cycle(); // Additional cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, false>();
 	y_register_ = read_byte(effective_address);
 	update_zero_and_negative_flags(y_register_);
 	// Total: 4 cycles (normal) or 5 cycles (page boundary crossed)
@@ -1415,26 +1460,8 @@ void CPU6502::LDY_absolute_X() {
 
 void CPU6502::LDX_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Assemble base address (little-endian)
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-
-	// Calculate effective address
-	Address effective_address = base_address + y_register_;
-
-	// Cycle 4: Read from effective address
-	// Page boundary crossing adds 1 cycle (total becomes 5 cycles)
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Additional cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, false>();
 	x_register_ = read_byte(effective_address);
 	update_zero_and_negative_flags(x_register_);
 	// Total: 4 cycles (normal) or 5 cycles (page boundary crossed)
@@ -1444,36 +1471,25 @@ void CPU6502::LDX_absolute_Y() {
 void CPU6502::STX_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_address = read_byte(program_counter_);
-	program_counter_++;
+	const Address zero_page_address = address_zero_page();
 	// Cycle 3: Write X register to zero page address
-	write_byte(zero_page_address, x_register_);
+	write_low_ram(zero_page_address, x_register_);
 	// Total: 3 cycles
 }
 
 void CPU6502::STX_zero_page_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add Y register to base address (internal operation)
-	consume_cycle();											  // Internal operation
-	Byte effective_address = (base_address + y_register_) & 0xFF; // Wrap within zero page
+	// Cycles 2-3: Fetch zero page base address, add Y (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::Y>();
 	// Cycle 4: Write X register to effective address
-	write_byte(effective_address, x_register_);
+	write_low_ram(effective_address, x_register_);
 	// Total: 4 cycles
 }
 
 void CPU6502::STX_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte address_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte address_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Write X register to absolute address
-	Address absolute_address = (static_cast<Address>(address_high) << 8) | address_low;
+	// Cycles 2-3: Fetch absolute address
+	const Address absolute_address = address_absolute();
 	write_byte(absolute_address, x_register_);
 	// Total: 4 cycles
 }
@@ -1482,62 +1498,33 @@ void CPU6502::STX_absolute() {
 void CPU6502::STY_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_address = read_byte(program_counter_);
-	program_counter_++;
+	const Address zero_page_address = address_zero_page();
 	// Cycle 3: Write Y register to zero page address
-	write_byte(zero_page_address, y_register_);
+	write_low_ram(zero_page_address, y_register_);
 	// Total: 3 cycles
 }
 
 void CPU6502::STY_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address (internal operation)
-	consume_cycle();											  // Internal operation
-	Byte effective_address = (base_address + x_register_) & 0xFF; // Wrap within zero page
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Write Y register to effective address
-	write_byte(effective_address, y_register_);
+	write_low_ram(effective_address, y_register_);
 	// Total: 4 cycles
 }
 
 void CPU6502::STY_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte address_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte address_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Write Y register to absolute address
-	Address absolute_address = (static_cast<Address>(address_high) << 8) | address_low;
+	// Cycles 2-3: Fetch absolute address
+	const Address absolute_address = address_absolute();
 	write_byte(absolute_address, y_register_);
 	// Total: 4 cycles
 }
 
 void CPU6502::LDA_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Assemble base address (little-endian)
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-
-	// Calculate effective address
-	Address effective_address = base_address + x_register_;
-
-	// Cycle 4: Read from effective address
-	// Page boundary crossing adds 1 cycle (total becomes 5 cycles)
-	if (crosses_page_boundary(base_address, x_register_)) {
-		consume_cycle(); // Additional cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, false>();
 	accumulator_ = read_byte(effective_address);
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 4 cycles (normal) or 5 cycles (page boundary crossed)
@@ -1545,50 +1532,16 @@ void CPU6502::LDA_absolute_X() {
 
 void CPU6502::STA_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Assemble base address (little-endian)
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-
-	// Calculate effective address
-	Address effective_address = base_address + x_register_;
-
-	// Cycle 4: Internal operation (address calculation)
-	// Cycle 5: Store to effective address
-	// STA always takes 5 cycles regardless of page boundary crossing
-	consume_cycle(); // Always consume extra cycle for STA absolute,X
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	write_byte(effective_address, accumulator_);
 	// Total: 5 cycles (always)
 }
 
 void CPU6502::LDA_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Assemble base address (little-endian)
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-
-	// Calculate effective address
-	Address effective_address = base_address + y_register_;
-
-	// Cycle 4: Read from effective address
-	// Page boundary crossing adds 1 cycle (total becomes 5 cycles)
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Additional cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, false>();
 	accumulator_ = read_byte(effective_address);
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 4 cycles (normal) or 5 cycles (page boundary crossed)
@@ -1596,24 +1549,8 @@ void CPU6502::LDA_absolute_Y() {
 
 void CPU6502::STA_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Assemble base address (little-endian)
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-
-	// Calculate effective address
-	Address effective_address = base_address + y_register_;
-
-	// Cycle 4: Internal operation (address calculation)
-	// Cycle 5: Store to effective address
-	// STA always takes 5 cycles regardless of page boundary crossing
-	consume_cycle(); // Always consume extra cycle for STA absolute,Y
+	// Cycles 2-4: Fetch base address, add Y
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, true>();
 	write_byte(effective_address, accumulator_);
 	// Total: 5 cycles (always)
 }
@@ -1621,11 +1558,9 @@ void CPU6502::STA_absolute_Y() {
 void CPU6502::LDA_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_address = read_byte(program_counter_);
-	program_counter_++;
-
+	const Address zero_page_address = address_zero_page();
 	// Cycle 3: Read from zero page address (0x00nn)
-	accumulator_ = read_byte(static_cast<Address>(zero_page_address));
+	accumulator_ = read_low_ram(zero_page_address);
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 3 cycles
 }
@@ -1633,57 +1568,35 @@ void CPU6502::LDA_zero_page() {
 void CPU6502::STA_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_address = read_byte(program_counter_);
-	program_counter_++;
-
+	const Address zero_page_address = address_zero_page();
 	// Cycle 3: Store accumulator to zero page address (0x00nn)
-	write_byte(static_cast<Address>(zero_page_address), accumulator_);
+	write_low_ram(zero_page_address, accumulator_);
 	// Total: 3 cycles
 }
 
 void CPU6502::LDA_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Add X register to base address (stays in zero page, wraps around)
-	consume_cycle();									 // Internal operation
-	Byte effective_address = base_address + x_register_; // 8-bit addition, wraps automatically
-
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read from effective zero page address
-	accumulator_ = read_byte(static_cast<Address>(effective_address));
+	accumulator_ = read_low_ram(effective_address);
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 4 cycles
 }
 
 void CPU6502::STA_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Add X register to base address (stays in zero page, wraps around)
-	consume_cycle();									 // Internal operation
-	Byte effective_address = base_address + x_register_; // 8-bit addition, wraps automatically
-
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Store accumulator to effective zero page address
-	write_byte(static_cast<Address>(effective_address), accumulator_);
+	write_low_ram(effective_address, accumulator_);
 	// Total: 4 cycles
 }
 
 void CPU6502::LDA_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 4: Read from absolute address (little-endian)
-	Address absolute_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address absolute_address = address_absolute();
 	accumulator_ = read_byte(absolute_address);
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 4 cycles
@@ -1691,16 +1604,8 @@ void CPU6502::LDA_absolute() {
 
 void CPU6502::STA_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 4: Store accumulator to absolute address (little-endian)
-	Address absolute_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address absolute_address = address_absolute();
 	write_byte(absolute_address, accumulator_);
 	// Total: 4 cycles
 }
@@ -1741,37 +1646,15 @@ void CPU6502::TYA() {
 	// Total: 2 cycles
 }
 
-// Branch Instructions - All use relative addressing mode
-void CPU6502::BPL_relative() {
-	// Branch if Plus/Positive (N = 0)
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch offset
-	SignedByte offset = static_cast<SignedByte>(read_byte(program_counter_));
-	program_counter_++;
-
-	if (!status_.flags.negative_flag_) {
-		// Branch taken
-		// Cycle 3: Internal operation (branch decision)
-		consume_cycle();
-		Address old_pc = program_counter_;
-		program_counter_ = static_cast<Address>(program_counter_ + offset);
-
-		// Check for page boundary crossing (cycle 4 if crossed)
-		if ((old_pc & 0xFF00) != (program_counter_ & 0xFF00)) {
-			consume_cycle(); // Extra cycle for page boundary crossing
-		}
-	}
-	// Total: 2 cycles (no branch), 3 cycles (branch same page), 4 cycles (branch different page)
-}
-
-void CPU6502::BMI_relative() {
-	// Branch if Minus/Negative (N = 1)
+// Branch Instructions - All use relative addressing mode
+void CPU6502::branch(bool condition) {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch offset
-	SignedByte offset = static_cast<SignedByte>(read_byte(program_counter_));
+	const Address branch_address = static_cast<Address>(program_counter_ - 1);
+	SignedByte offset = static_cast<SignedByte>(fetch_byte(program_counter_));
 	program_counter_++;
 
-	if (status_.flags.negative_flag_) {
+	if (condition) {
 		// Branch taken
 		// Cycle 3: Internal operation (branch decision)
 		consume_cycle();
@@ -1779,172 +1662,81 @@ void CPU6502::BMI_relative() {
 		program_counter_ = static_cast<Address>(program_counter_ + offset);
 
 		// Check for page boundary crossing (cycle 4 if crossed)
+		std::uint32_t branch_cycles = 3;
 		if ((old_pc & 0xFF00) != (program_counter_ & 0xFF00)) {
 			consume_cycle(); // Extra cycle for page boundary crossing
+			branch_cycles = 4;
+		}
+
+		if (idle_loop_skipping_ && program_counter_ <= branch_address) {
+			detect_poll_loop(branch_address, program_counter_, branch_cycles);
 		}
+		block_head_ = block_cache_ != nullptr;
 	}
 	// Total: 2 cycles (no branch), 3 cycles (branch same page), 4 cycles (branch different page)
 }
 
-void CPU6502::BVC_relative() {
-	// Branch if Overflow Clear (V = 0)
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch offset
-	SignedByte offset = static_cast<SignedByte>(read_byte(program_counter_));
-	program_counter_++;
+void CPU6502::BPL_relative() {
+	// Branch if Plus/Positive (N = 0)
+	branch(!status_.flags.negative_flag_);
+}
 
-	if (!status_.flags.overflow_flag_) {
-		// Branch taken
-		// Cycle 3: Internal operation (branch decision)
-		consume_cycle();
-		Address old_pc = program_counter_;
-		program_counter_ = static_cast<Address>(program_counter_ + offset);
+void CPU6502::BMI_relative() {
+	// Branch if Minus/Negative (N = 1)
+	branch(status_.flags.negative_flag_);
+}
 
-		// Check for page boundary crossing (cycle 4 if crossed)
-		if ((old_pc & 0xFF00) != (program_counter_ & 0xFF00)) {
-			consume_cycle(); // Extra cycle for page boundary crossing
-		}
-	}
-	// Total: 2 cycles (no branch), 3 cycles (branch same page), 4 cycles (branch different page)
+void CPU6502::BVC_relative() {
+	// Branch if Overflow Clear (V = 0)
+	branch(!status_.flags.overflow_flag_);
 }
 
 void CPU6502::BVS_relative() {
 	// Branch if Overflow Set (V = 1)
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch offset
-	SignedByte offset = static_cast<SignedByte>(read_byte(program_counter_));
-	program_counter_++;
-
-	if (status_.flags.overflow_flag_) {
-		// Branch taken
-		// Cycle 3: Internal operation (branch decision)
-		consume_cycle();
-		Address old_pc = program_counter_;
-		program_counter_ = static_cast<Address>(program_counter_ + offset);
-
-		// Check for page boundary crossing (cycle 4 if crossed)
-		if ((old_pc & 0xFF00) != (program_counter_ & 0xFF00)) {
-			consume_cycle(); // Extra cycle for page boundary crossing
-		}
-	}
-	// Total: 2 cycles (no branch), 3 cycles (branch same page), 4 cycles (branch different page)
+	branch(status_.flags.overflow_flag_);
 }
 
 void CPU6502::BCC_relative() {
 	// Branch if Carry Clear (C = 0)
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch offset
-	SignedByte offset = static_cast<SignedByte>(read_byte(program_counter_));
-	program_counter_++;
-
-	if (!status_.flags.carry_flag_) {
-		// Branch taken
-		// Cycle 3: Internal operation (branch decision)
-		consume_cycle();
-		Address old_pc = program_counter_;
-		program_counter_ = static_cast<Address>(program_counter_ + offset);
-
-		// Check for page boundary crossing (cycle 4 if crossed)
-		if ((old_pc & 0xFF00) != (program_counter_ & 0xFF00)) {
-			consume_cycle(); // Extra cycle for page boundary crossing
-		}
-	}
-	// Total: 2 cycles (no branch), 3 cycles (branch same page), 4 cycles (branch different page)
+	branch(!status_.flags.carry_flag_);
 }
 
 void CPU6502::BCS_relative() {
 	// Branch if Carry Set (C = 1)
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch offset
-	SignedByte offset = static_cast<SignedByte>(read_byte(program_counter_));
-	program_counter_++;
-
-	if (status_.flags.carry_flag_) {
-		// Branch taken
-		// Cycle 3: Internal operation (branch decision)
-		consume_cycle();
-		Address old_pc = program_counter_;
-		program_counter_ = static_cast<Address>(program_counter_ + offset);
-
-		// Check for page boundary crossing (cycle 4 if crossed)
-		if ((old_pc & 0xFF00) != (program_counter_ & 0xFF00)) {
-			consume_cycle(); // Extra cycle for page boundary crossing
-		}
-	}
-	// Total: 2 cycles (no branch), 3 cycles (branch same page), 4 cycles (branch different page)
+	branch(status_.flags.carry_flag_);
 }
 
 void CPU6502::BNE_relative() {
 	// Branch if Not Equal/Zero Clear (Z = 0)
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch offset
-	SignedByte offset = static_cast<SignedByte>(read_byte(program_counter_));
-	program_counter_++;
-
-	if (!status_.flags.zero_flag_) {
-		// Branch taken
-		// Cycle 3: Internal operation (branch decision)
-		consume_cycle();
-		Address old_pc = program_counter_;
-		program_counter_ = static_cast<Address>(program_counter_ + offset);
-
-		// Check for page boundary crossing (cycle 4 if crossed)
-		if ((old_pc & 0xFF00) != (program_counter_ & 0xFF00)) {
-			consume_cycle(); // Extra cycle for page boundary crossing
-		}
-	}
-	// Total: 2 cycles (no branch), 3 cycles (branch same page), 4 cycles (branch different page)
+	branch(!status_.flags.zero_flag_);
 }
 
 void CPU6502::BEQ_relative() {
 	// Branch if Equal/Zero Set (Z = 1)
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch offset
-	SignedByte offset = static_cast<SignedByte>(read_byte(program_counter_));
-	program_counter_++;
-
-	if (status_.flags.zero_flag_) {
-		// Branch taken
-		// Cycle 3: Internal operation (branch decision)
-		consume_cycle();
-		Address old_pc = program_counter_;
-		program_counter_ = static_cast<Address>(program_counter_ + offset);
-
-		// Check for page boundary crossing (cycle 4 if crossed)
-		if ((old_pc & 0xFF00) != (program_counter_ & 0xFF00)) {
-			consume_cycle(); // Extra cycle for page boundary crossing
-		}
-	}
-	// Total: 2 cycles (no branch), 3 cycles (branch same page), 4 cycles (branch different page)
+	branch(status_.flags.zero_flag_);
 }
 
 // Jump and Subroutine Instructions
 void CPU6502::JMP_absolute() {
 	// Jump to absolute address
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	// Don't increment PC here - we're jumping to the new address
-
-	// Set program counter to the new address
-	program_counter_ = (static_cast<Address>(high) << 8) | low;
+	// Cycles 2-3: Fetch absolute address and jump to it
+	const Address opcode_address = static_cast<Address>(program_counter_ - 1);
+	program_counter_ = address_absolute();
 	// Total: 3 cycles
+
+	// JMP to itself only ever ends through an interrupt
+	if (idle_loop_skipping_ && program_counter_ == opcode_address) {
+		arm_idle_loop(opcode_address, 3);
+	}
+	block_head_ = block_cache_ != nullptr;
 }
 
 void CPU6502::JMP_indirect() {
 	// Jump to address stored at given address (with 6502 page boundary bug)
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of indirect address
-	Byte indirect_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of indirect address
-	Byte indirect_high = read_byte(program_counter_);
-	program_counter_++;
-
-	Address indirect_address = (static_cast<Address>(indirect_high) << 8) | indirect_low;
+	// Cycles 2-3: Fetch indirect address
+	const Address indirect_address = address_absolute();
 
 	// Cycle 4: Read low byte of target address
 	Byte target_low = read_byte(indirect_address);
@@ -1971,7 +1763,7 @@ void CPU6502::JSR() {
 	// Jump to Subroutine
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch low byte of subroutine address
-	Byte low = read_byte(program_counter_);
+	Byte low = fetch_byte(program_counter_);
 	program_counter_++;
 
 	// Cycle 3: Internal operation (stack pointer operation)
@@ -1985,7 +1777,7 @@ void CPU6502::JSR() {
 	push_byte(static_cast<Byte>(return_address & 0xFF));
 
 	// Cycle 6: Fetch high byte of subroutine address
-	Byte high = read_byte(program_counter_);
+	Byte high = fetch_byte(program_counter_);
 
 	// Set program counter to the subroutine address
 	program_counter_ = (static_cast<Address>(high) << 8) | low;
@@ -1996,15 +1788,16 @@ void CPU6502::RTS() {
 	// Return from Subroutine
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Internal operation
-	consume_cycle();
+	// Cycle 3: Increment stack pointer
+	consume_cycles(2);
 
-	// Cycle 3: Pull low byte of return address from stack
+	// Cycle 4: Pull low byte of return address from stack
 	Byte low = pull_byte();
 
-	// Cycle 4: Pull high byte of return address from stack
+	// Cycle 5: Pull high byte of return address from stack
 	Byte high = pull_byte();
 
-	// Cycle 5: Internal operation (increment PC)
+	// Cycle 6: Internal operation (increment PC)
 	consume_cycle();
 
 	// Restore program counter and increment by 1 (RTS returns to instruction after JSR)
@@ -2017,18 +1810,19 @@ void CPU6502::RTI() {
 	// Return from Interrupt
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Internal operation
-	consume_cycle();
+	// Cycle 3: Increment stack pointer
+	consume_cycles(2);
 
-	// Cycle 3: Pull status register from stack
+	// Cycle 4: Pull status register from stack
 	status_.status_register_ = pull_byte();
 	// Clear break flag and set unused flag (as per 6502 behavior)
 	status_.flags.break_flag_ = false;
 	status_.flags.unused_flag_ = true;
 
-	// Cycle 4: Pull low byte of return address from stack
+	// Cycle 5: Pull low byte of return address from stack
 	Byte low = pull_byte();
 
-	// Cycle 5: Pull high byte of return address from stack
+	// Cycle 6: Pull high byte of return address from stack
 	Byte high = pull_byte();
 
 	// Restore program counter (RTI doesn't increment PC - returns to exact interrupt address)
@@ -2056,12 +1850,11 @@ void CPU6502::PLA() {
 	// Pull Accumulator - Load accumulator from stack
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Internal operation
-	consume_cycle();
 	// Cycle 3: Increment stack pointer
-	consume_cycle();
+	consume_cycles(2);
 	stack_pointer_++;
 	// Cycle 4: Read accumulator from stack
-	accumulator_ = read_byte(0x0100 + stack_pointer_);
+	accumulator_ = read_low_ram(0x0100 + stack_pointer_);
 
 	// Update flags based on pulled value
 	update_zero_flag(accumulator_);
@@ -2085,12 +1878,11 @@ void CPU6502::PLP() {
 	// Pull Processor Status - Load status register from stack
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Internal operation
-	consume_cycle();
 	// Cycle 3: Increment stack pointer
-	consume_cycle();
+	consume_cycles(2);
 	stack_pointer_++;
 	// Cycle 4: Read status register from stack
-	status_.status_register_ = read_byte(0x0100 + stack_pointer_);
+	status_.status_register_ = read_low_ram(0x0100 + stack_pointer_);
 	// Note: Bit 5 (unused flag) is always set, bit 4 (B flag) is ignored
 	status_.status_register_ |= 0x20u; // Ensure unused flag is set
 	status_.status_register_ &= 0xEFu; // Clear B flag (it doesn't exist in the actual register)
@@ -2184,14 +1976,10 @@ void CPU6502::TSX() {
 
 // Bit test instructions
 void CPU6502::BIT_zero_page() {
-	// BIT Zero Page - Test bits in memory with accumulator
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_address = read_byte(program_counter_);
-	program_counter_++;
-
+	const Address zero_page_address = address_zero_page();
 	// Cycle 3: Read from zero page address
-	Byte memory_value = read_byte(static_cast<Address>(zero_page_address));
+	Byte memory_value = read_low_ram(zero_page_address);
 
 	// Perform BIT operation:
 	// Z flag = (A AND M) == 0
@@ -2205,18 +1993,8 @@ void CPU6502::BIT_zero_page() {
 }
 
 void CPU6502::BIT_absolute() {
-	// BIT Absolute - Test bits in memory with accumulator
-	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	// Cycle 4: Read from absolute address
-	Address absolute_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address absolute_address = address_absolute();
 	Byte memory_value = read_byte(absolute_address);
 
 	// Perform BIT operation:
@@ -2262,18 +2040,8 @@ void CPU6502::BRK() {
 
 void CPU6502::LDA_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address (internal operation)
-	consume_cycle();											// Internal indexing operation
-	Byte indexed_address = (base_address + x_register_) & 0xFF; // Wrap within zero page
-	// Cycle 4: Fetch low byte of indirect address
-	Byte low = read_byte(indexed_address);
-	// Cycle 5: Fetch high byte of indirect address
-	Byte high = read_byte((indexed_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 6: Load accumulator from final address
-	Address final_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address final_address = address_indexed_indirect();
 	accumulator_ = read_byte(final_address);
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 6 cycles
@@ -2281,40 +2049,16 @@ void CPU6502::LDA_indexed_indirect() {
 
 void CPU6502::STA_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address (internal operation)
-	consume_cycle();											// Internal indexing operation
-	Byte indexed_address = (base_address + x_register_) & 0xFF; // Wrap within zero page
-	// Cycle 4: Fetch low byte of indirect address
-	Byte low = read_byte(indexed_address);
-	// Cycle 5: Fetch high byte of indirect address
-	Byte high = read_byte((indexed_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 6: Store accumulator to final address
-	Address final_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address final_address = address_indexed_indirect();
 	write_byte(final_address, accumulator_);
 	// Total: 6 cycles
 }
 
 void CPU6502::LDA_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zp_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(zp_address);
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte((zp_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 5: Add Y register to base address and load
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-4: Fetch zero page pointer, fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_indirect_indexed<false>();
 	accumulator_ = read_byte(final_address);
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 5-6 cycles (5 normally, 6 if page boundary crossed)
@@ -2322,17 +2066,8 @@ void CPU6502::LDA_indirect_indexed() {
 
 void CPU6502::STA_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zp_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(zp_address);
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte((zp_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 5: Add Y register to base address (internal operation)
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	consume_cycle(); // Internal operation for indexing
-	Address final_address = base_address + y_register_;
+	// Cycles 2-5: Fetch zero page pointer, fetch base address, add Y
+	const Address final_address = address_indirect_indexed<true>();
 	// Cycle 6: Store accumulator to final address
 	write_byte(final_address, accumulator_);
 	// Total: 6 cycles (store always takes extra cycle for indexing)
@@ -2342,7 +2077,7 @@ void CPU6502::STA_indirect_indexed() {
 void CPU6502::ADC_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch immediate value
-	Byte value = read_byte(program_counter_);
+	Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 
 	// Perform addition with carry
@@ -2353,10 +2088,9 @@ void CPU6502::ADC_immediate() {
 void CPU6502::ADC_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 
 	perform_adc(value);
 	// Total: 3 cycles
@@ -2364,14 +2098,10 @@ void CPU6502::ADC_zero_page() {
 
 void CPU6502::ADC_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register (with zero page wrap)
-	consume_cycle(); // Internal indexing operation
-	Byte final_address = (base_address + x_register_) & 0xFF;
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address final_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(final_address);
+	Byte value = read_low_ram(final_address);
 
 	perform_adc(value);
 	// Total: 4 cycles
@@ -2379,14 +2109,8 @@ void CPU6502::ADC_zero_page_X() {
 
 void CPU6502::ADC_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 
 	perform_adc(value);
@@ -2395,22 +2119,8 @@ void CPU6502::ADC_absolute() {
 
 void CPU6502::ADC_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
-
-	// Cycle 4: Read from effective address
-	// Page boundary crossing adds 1 cycle
-	if (crosses_page_boundary(base_address, x_register_)) {
-		consume_cycle(); // Additional cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, false>();
 	Byte value = read_byte(effective_address);
 	perform_adc(value);
 	// Total: 4 cycles (normal) or 5 cycles (page boundary crossed)
@@ -2418,22 +2128,8 @@ void CPU6502::ADC_absolute_X() {
 
 void CPU6502::ADC_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
-
-	// Cycle 4: Read from effective address
-	// Page boundary crossing adds 1 cycle
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Additional cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, false>();
 	Byte value = read_byte(effective_address);
 	perform_adc(value);
 	// Total: 4 cycles (normal) or 5 cycles (page boundary crossed)
@@ -2441,18 +2137,8 @@ void CPU6502::ADC_absolute_Y() {
 
 void CPU6502::ADC_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address (internal operation)
-	consume_cycle();											// Internal indexing operation
-	Byte indexed_address = (base_address + x_register_) & 0xFF; // Wrap within zero page
-	// Cycle 4: Fetch low byte of indirect address
-	Byte low = read_byte(indexed_address);
-	// Cycle 5: Fetch high byte of indirect address
-	Byte high = read_byte((indexed_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 6: Read value from final address
-	Address final_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address final_address = address_indexed_indirect();
 	Byte value = read_byte(final_address);
 
 	perform_adc(value);
@@ -2461,22 +2147,8 @@ void CPU6502::ADC_indexed_indirect() {
 
 void CPU6502::ADC_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zp_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(zp_address);
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte((zp_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 5: Add Y register to base address and read
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-4: Fetch zero page pointer, fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_indirect_indexed<false>();
 	Byte value = read_byte(final_address);
 	perform_adc(value);
 	// Total: 5-6 cycles (5 normally, 6 if page boundary crossed)
@@ -2486,7 +2158,7 @@ void CPU6502::ADC_indirect_indexed() {
 void CPU6502::SBC_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch immediate value
-	Byte value = read_byte(program_counter_);
+	Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 
 	// Perform subtraction with carry
@@ -2497,10 +2169,9 @@ void CPU6502::SBC_immediate() {
 void CPU6502::SBC_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 
 	perform_sbc(value);
 	// Total: 3 cycles
@@ -2508,14 +2179,10 @@ void CPU6502::SBC_zero_page() {
 
 void CPU6502::SBC_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register (with zero page wrap)
-	consume_cycle(); // Internal indexing operation
-	Byte final_address = (base_address + x_register_) & 0xFF;
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address final_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(final_address);
+	Byte value = read_low_ram(final_address);
 
 	perform_sbc(value);
 	// Total: 4 cycles
@@ -2523,14 +2190,8 @@ void CPU6502::SBC_zero_page_X() {
 
 void CPU6502::SBC_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 
 	perform_sbc(value);
@@ -2539,22 +2200,8 @@ void CPU6502::SBC_absolute() {
 
 void CPU6502::SBC_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
-
-	// Cycle 4: Read from effective address
-	// Page boundary crossing adds 1 cycle
-	if (crosses_page_boundary(base_address, x_register_)) {
-		consume_cycle(); // Additional cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, false>();
 	Byte value = read_byte(effective_address);
 	perform_sbc(value);
 	// Total: 4 cycles (normal) or 5 cycles (page boundary crossed)
@@ -2562,22 +2209,8 @@ void CPU6502::SBC_absolute_X() {
 
 void CPU6502::SBC_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
-
-	// Cycle 4: Read from effective address
-	// Page boundary crossing adds 1 cycle
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Additional cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, false>();
 	Byte value = read_byte(effective_address);
 	perform_sbc(value);
 	// Total: 4 cycles (normal) or 5 cycles (page boundary crossed)
@@ -2585,18 +2218,8 @@ void CPU6502::SBC_absolute_Y() {
 
 void CPU6502::SBC_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address (internal operation)
-	consume_cycle();											// Internal indexing operation
-	Byte indexed_address = (base_address + x_register_) & 0xFF; // Wrap within zero page
-	// Cycle 4: Fetch low byte of indirect address
-	Byte low = read_byte(indexed_address);
-	// Cycle 5: Fetch high byte of indirect address
-	Byte high = read_byte((indexed_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 6: Read value from final address
-	Address final_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address final_address = address_indexed_indirect();
 	Byte value = read_byte(final_address);
 
 	perform_sbc(value);
@@ -2605,22 +2228,8 @@ void CPU6502::SBC_indexed_indirect() {
 
 void CPU6502::SBC_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zp_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(zp_address);
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte((zp_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 5: Add Y register to base address and read
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-4: Fetch zero page pointer, fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_indirect_indexed<false>();
 	Byte value = read_byte(final_address);
 	perform_sbc(value);
 	// Total: 5-6 cycles (5 normally, 6 if page boundary crossed)
@@ -2630,7 +2239,7 @@ void CPU6502::SBC_indirect_indexed() {
 void CPU6502::CMP_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch operand
-	Byte value = read_byte(program_counter_);
+	Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 	perform_compare(accumulator_, value);
 	// Total: 2 cycles
@@ -2639,37 +2248,27 @@ void CPU6502::CMP_immediate() {
 void CPU6502::CMP_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	perform_compare(accumulator_, value);
 	// Total: 3 cycles
 }
 
 void CPU6502::CMP_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X to address (wraps within zero page)
-	address = static_cast<Byte>(address + x_register_);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from calculated address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	perform_compare(accumulator_, value);
 	// Total: 4 cycles
 }
 
 void CPU6502::CMP_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(high) << 8) | low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	perform_compare(accumulator_, value);
 	// Total: 4 cycles
@@ -2677,18 +2276,8 @@ void CPU6502::CMP_absolute() {
 
 void CPU6502::CMP_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to low byte and check for page crossing
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + x_register_;
-	if ((base_address & 0xFF00) != (final_address & 0xFF00)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	const Address final_address = address_absolute_indexed<IndexRegister::X, false>();
 	// Cycle 4-5: Read value from final address
 	Byte value = read_byte(final_address);
 	perform_compare(accumulator_, value);
@@ -2697,18 +2286,8 @@ void CPU6502::CMP_absolute_X() {
 
 void CPU6502::CMP_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y to low byte and check for page crossing
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + y_register_;
-	if ((base_address & 0xFF00) != (final_address & 0xFF00)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_absolute_indexed<IndexRegister::Y, false>();
 	// Cycle 4-5: Read value from final address
 	Byte value = read_byte(final_address);
 	perform_compare(accumulator_, value);
@@ -2717,17 +2296,9 @@ void CPU6502::CMP_absolute_Y() {
 
 void CPU6502::CMP_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zp_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X to zero page address (wraps within zero page)
-	zp_address = static_cast<Byte>(zp_address + x_register_);
-	// Cycle 4: Fetch low byte of indirect address
-	Byte low = read_byte(zp_address);
-	// Cycle 5: Fetch high byte of indirect address
-	Byte high = read_byte((zp_address + 1) & 0xFF); // Wrap within zero page
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address final_address = address_indexed_indirect();
 	// Cycle 6: Read value from final address
-	Word final_address = (static_cast<Word>(high) << 8) | low;
 	Byte value = read_byte(final_address);
 	perform_compare(accumulator_, value);
 	// Total: 6 cycles
@@ -2735,19 +2306,8 @@ void CPU6502::CMP_indexed_indirect() {
 
 void CPU6502::CMP_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zp_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(zp_address);
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte((zp_address + 1) & 0xFF); // Wrap within zero page
-	// Cycle 5: Add Y to base address and check for page crossing
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + y_register_;
-	if ((base_address & 0xFF00) != (final_address & 0xFF00)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
+	// Cycles 2-4: Fetch zero page pointer, fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_indirect_indexed<false>();
 	// Cycle 5-6: Read value from final address
 	Byte value = read_byte(final_address);
 	perform_compare(accumulator_, value);
@@ -2758,7 +2318,7 @@ void CPU6502::CMP_indirect_indexed() {
 void CPU6502::CPX_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch operand
-	Byte value = read_byte(program_counter_);
+	Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 	perform_compare(x_register_, value);
 	// Total: 2 cycles
@@ -2767,24 +2327,17 @@ void CPU6502::CPX_immediate() {
 void CPU6502::CPX_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	perform_compare(x_register_, value);
 	// Total: 3 cycles
 }
 
 void CPU6502::CPX_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(high) << 8) | low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	perform_compare(x_register_, value);
 	// Total: 4 cycles
@@ -2794,7 +2347,7 @@ void CPU6502::CPX_absolute() {
 void CPU6502::CPY_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch operand
-	Byte value = read_byte(program_counter_);
+	Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 	perform_compare(y_register_, value);
 	// Total: 2 cycles
@@ -2803,24 +2356,17 @@ void CPU6502::CPY_immediate() {
 void CPU6502::CPY_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	perform_compare(y_register_, value);
 	// Total: 3 cycles
 }
 
 void CPU6502::CPY_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(high) << 8) | low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	perform_compare(y_register_, value);
 	// Total: 4 cycles
@@ -2830,7 +2376,7 @@ void CPU6502::CPY_absolute() {
 void CPU6502::AND_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch immediate value
-	Byte value = read_byte(program_counter_);
+	Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -2840,10 +2386,9 @@ void CPU6502::AND_immediate() {
 void CPU6502::AND_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 3 cycles
@@ -2851,14 +2396,10 @@ void CPU6502::AND_zero_page() {
 
 void CPU6502::AND_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to address (wraps in zero page)
-	Byte address = static_cast<Byte>(base_address + x_register_);
-	consume_cycle();
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from zero page,X address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 4 cycles
@@ -2866,14 +2407,8 @@ void CPU6502::AND_zero_page_X() {
 
 void CPU6502::AND_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(high) << 8) | low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -2882,21 +2417,8 @@ void CPU6502::AND_absolute() {
 
 void CPU6502::AND_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X register to address and read value
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + x_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, x_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	const Address final_address = address_absolute_indexed<IndexRegister::X, false>();
 	Byte value = read_byte(final_address);
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -2905,21 +2427,8 @@ void CPU6502::AND_absolute_X() {
 
 void CPU6502::AND_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y register to address and read value
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_absolute_indexed<IndexRegister::Y, false>();
 	Byte value = read_byte(final_address);
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -2928,18 +2437,9 @@ void CPU6502::AND_absolute_Y() {
 
 void CPU6502::AND_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to zero page address
-	Byte indexed_addr = static_cast<Byte>(zero_page_addr + x_register_);
-	consume_cycle();
-	// Cycle 4: Read low byte of target address from indexed zero page
-	Byte target_low = read_byte(indexed_addr);
-	// Cycle 5: Read high byte of target address from indexed zero page + 1
-	Byte target_high = read_byte(static_cast<Byte>(indexed_addr + 1));
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	// Cycle 6: Read value from target address
-	Word target_address = (static_cast<Word>(target_high) << 8) | target_low;
 	Byte value = read_byte(target_address);
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -2948,22 +2448,9 @@ void CPU6502::AND_indexed_indirect() {
 
 void CPU6502::AND_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Read low byte of base address from zero page
-	Byte base_low = read_byte(zero_page_addr);
-	// Cycle 4: Read high byte of base address from zero page + 1
-	Byte base_high = read_byte(static_cast<Byte>(zero_page_addr + 1));
-	// Cycle 5: Add Y register to base address and read value
-	Word base_address = (static_cast<Word>(base_high) << 8) | base_low;
-	Word final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-4: Fetch zero page pointer, fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_indirect_indexed<false>();
+	// Cycle 5: Read value from final address
 	Byte value = read_byte(final_address);
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -2974,7 +2461,7 @@ void CPU6502::AND_indirect_indexed() {
 void CPU6502::ORA_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch immediate value
-	Byte value = read_byte(program_counter_);
+	Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -2984,10 +2471,9 @@ void CPU6502::ORA_immediate() {
 void CPU6502::ORA_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 3 cycles
@@ -2995,14 +2481,10 @@ void CPU6502::ORA_zero_page() {
 
 void CPU6502::ORA_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to address (wraps in zero page)
-	Byte address = static_cast<Byte>(base_address + x_register_);
-	consume_cycle();
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from zero page,X address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 4 cycles
@@ -3010,14 +2492,8 @@ void CPU6502::ORA_zero_page_X() {
 
 void CPU6502::ORA_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(high) << 8) | low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3026,21 +2502,8 @@ void CPU6502::ORA_absolute() {
 
 void CPU6502::ORA_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X register to address and read value
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + x_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, x_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	const Address final_address = address_absolute_indexed<IndexRegister::X, false>();
 	Byte value = read_byte(final_address);
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3049,21 +2512,8 @@ void CPU6502::ORA_absolute_X() {
 
 void CPU6502::ORA_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y register to address and read value
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_absolute_indexed<IndexRegister::Y, false>();
 	Byte value = read_byte(final_address);
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3072,18 +2522,9 @@ void CPU6502::ORA_absolute_Y() {
 
 void CPU6502::ORA_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to zero page address
-	Byte indexed_addr = static_cast<Byte>(zero_page_addr + x_register_);
-	consume_cycle();
-	// Cycle 4: Read low byte of target address from indexed zero page
-	Byte target_low = read_byte(indexed_addr);
-	// Cycle 5: Read high byte of target address from indexed zero page + 1
-	Byte target_high = read_byte(static_cast<Byte>(indexed_addr + 1));
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	// Cycle 6: Read value from target address
-	Word target_address = (static_cast<Word>(target_high) << 8) | target_low;
 	Byte value = read_byte(target_address);
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3092,22 +2533,9 @@ void CPU6502::ORA_indexed_indirect() {
 
 void CPU6502::ORA_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Read low byte of base address from zero page
-	Byte base_low = read_byte(zero_page_addr);
-	// Cycle 4: Read high byte of base address from zero page + 1
-	Byte base_high = read_byte(static_cast<Byte>(zero_page_addr + 1));
-	// Cycle 5: Add Y register to base address and read value
-	Word base_address = (static_cast<Word>(base_high) << 8) | base_low;
-	Word final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-4: Fetch zero page pointer, fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_indirect_indexed<false>();
+	// Cycle 5: Read value from final address
 	Byte value = read_byte(final_address);
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3118,7 +2546,7 @@ void CPU6502::ORA_indirect_indexed() {
 void CPU6502::EOR_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch immediate value
-	Byte value = read_byte(program_counter_);
+	Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3128,10 +2556,9 @@ void CPU6502::EOR_immediate() {
 void CPU6502::EOR_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 3 cycles
@@ -3139,14 +2566,10 @@ void CPU6502::EOR_zero_page() {
 
 void CPU6502::EOR_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to address (wraps in zero page)
-	Byte address = static_cast<Byte>(base_address + x_register_);
-	consume_cycle();
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from zero page,X address
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
 	// Total: 4 cycles
@@ -3154,14 +2577,8 @@ void CPU6502::EOR_zero_page_X() {
 
 void CPU6502::EOR_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(high) << 8) | low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3170,21 +2587,8 @@ void CPU6502::EOR_absolute() {
 
 void CPU6502::EOR_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X register to address and read value
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + x_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, x_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	const Address final_address = address_absolute_indexed<IndexRegister::X, false>();
 	Byte value = read_byte(final_address);
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3193,21 +2597,8 @@ void CPU6502::EOR_absolute_X() {
 
 void CPU6502::EOR_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y register to address and read value
-	Word base_address = (static_cast<Word>(high) << 8) | low;
-	Word final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_absolute_indexed<IndexRegister::Y, false>();
 	Byte value = read_byte(final_address);
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3216,18 +2607,9 @@ void CPU6502::EOR_absolute_Y() {
 
 void CPU6502::EOR_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to zero page address
-	Byte indexed_addr = static_cast<Byte>(zero_page_addr + x_register_);
-	consume_cycle();
-	// Cycle 4: Read low byte of target address from indexed zero page
-	Byte target_low = read_byte(indexed_addr);
-	// Cycle 5: Read high byte of target address from indexed zero page + 1
-	Byte target_high = read_byte(static_cast<Byte>(indexed_addr + 1));
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	// Cycle 6: Read value from target address
-	Word target_address = (static_cast<Word>(target_high) << 8) | target_low;
 	Byte value = read_byte(target_address);
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3236,22 +2618,9 @@ void CPU6502::EOR_indexed_indirect() {
 
 void CPU6502::EOR_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Read low byte of base address from zero page
-	Byte base_low = read_byte(zero_page_addr);
-	// Cycle 4: Read high byte of base address from zero page + 1
-	Byte base_high = read_byte(static_cast<Byte>(zero_page_addr + 1));
-	// Cycle 5: Add Y register to base address and read value
-	Word base_address = (static_cast<Word>(base_high) << 8) | base_low;
-	Word final_address = base_address + y_register_;
-
-	// Check for page boundary crossing
-	if (crosses_page_boundary(base_address, y_register_)) {
-		consume_cycle(); // Extra cycle for page boundary crossing
-	}
-
+	// Cycles 2-4: Fetch zero page pointer, fetch base address, add Y (+1 cycle on page cross)
+	const Address final_address = address_indirect_indexed<false>();
+	// Cycle 5: Read value from final address
 	Byte value = read_byte(final_address);
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -3277,12 +2646,11 @@ void CPU6502::ASL_accumulator() {
 void CPU6502::ASL_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
+	const Address zero_page_addr = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(zero_page_addr);
+	Byte value = read_low_ram(zero_page_addr);
 	// Cycle 4: Write original value back (during operation)
-	write_byte(zero_page_addr, value);
+	write_low_ram(zero_page_addr, value);
 	// Cycle 5: Write modified value
 
 	// Set carry flag to bit 7 before shifting
@@ -3291,23 +2659,19 @@ void CPU6502::ASL_zero_page() {
 	// Shift left (multiply by 2)
 	value = static_cast<Byte>(value << 1);
 
-	write_byte(zero_page_addr, value);
+	write_low_ram(zero_page_addr, value);
 	update_zero_and_negative_flags(value);
 	// Total: 5 cycles
 }
 
 void CPU6502::ASL_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to zero page address
-	consume_cycle();
-	Byte final_addr = static_cast<Byte>(zero_page_addr + x_register_);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address final_addr = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from final address
-	Byte value = read_byte(final_addr);
+	Byte value = read_low_ram(final_addr);
 	// Cycle 5: Write original value back (during operation)
-	write_byte(final_addr, value);
+	write_low_ram(final_addr, value);
 	// Cycle 6: Write modified value
 
 	// Set carry flag to bit 7 before shifting
@@ -3316,21 +2680,15 @@ void CPU6502::ASL_zero_page_X() {
 	// Shift left (multiply by 2)
 	value = static_cast<Byte>(value << 1);
 
-	write_byte(final_addr, value);
+	write_low_ram(final_addr, value);
 	update_zero_and_negative_flags(value);
 	// Total: 6 cycles
 }
 
 void CPU6502::ASL_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte addr_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte addr_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(addr_high) << 8) | addr_low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Write original value back (during operation)
 	write_byte(address, value);
@@ -3349,16 +2707,8 @@ void CPU6502::ASL_absolute() {
 
 void CPU6502::ASL_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte addr_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte addr_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X register to address
-	Word base_address = (static_cast<Word>(addr_high) << 8) | addr_low;
-	Word final_address = base_address + x_register_;
-	consume_cycle(); // Always takes extra cycle for indexing
+	// Cycles 2-4: Fetch base address, add X
+	const Address final_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from final address
 	Byte value = read_byte(final_address);
 	// Cycle 6: Write original value back (during operation)
@@ -3395,12 +2745,11 @@ void CPU6502::LSR_accumulator() {
 void CPU6502::LSR_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
+	const Address zero_page_addr = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(zero_page_addr);
+	Byte value = read_low_ram(zero_page_addr);
 	// Cycle 4: Write original value back (during operation)
-	write_byte(zero_page_addr, value);
+	write_low_ram(zero_page_addr, value);
 	// Cycle 5: Write modified value
 
 	// Set carry flag to bit 0 before shifting
@@ -3409,23 +2758,19 @@ void CPU6502::LSR_zero_page() {
 	// Shift right (divide by 2)
 	value = static_cast<Byte>(value >> 1);
 
-	write_byte(zero_page_addr, value);
+	write_low_ram(zero_page_addr, value);
 	update_zero_and_negative_flags(value);
 	// Total: 5 cycles
 }
 
 void CPU6502::LSR_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to zero page address
-	consume_cycle();
-	Byte final_addr = static_cast<Byte>(zero_page_addr + x_register_);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address final_addr = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from final address
-	Byte value = read_byte(final_addr);
+	Byte value = read_low_ram(final_addr);
 	// Cycle 5: Write original value back (during operation)
-	write_byte(final_addr, value);
+	write_low_ram(final_addr, value);
 	// Cycle 6: Write modified value
 
 	// Set carry flag to bit 0 before shifting
@@ -3434,21 +2779,15 @@ void CPU6502::LSR_zero_page_X() {
 	// Shift right (divide by 2)
 	value = static_cast<Byte>(value >> 1);
 
-	write_byte(final_addr, value);
+	write_low_ram(final_addr, value);
 	update_zero_and_negative_flags(value);
 	// Total: 6 cycles
 }
 
 void CPU6502::LSR_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte addr_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte addr_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(addr_high) << 8) | addr_low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Write original value back (during operation)
 	write_byte(address, value);
@@ -3467,16 +2806,8 @@ void CPU6502::LSR_absolute() {
 
 void CPU6502::LSR_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte addr_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte addr_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X register to address
-	Word base_address = (static_cast<Word>(addr_high) << 8) | addr_low;
-	Word final_address = base_address + x_register_;
-	consume_cycle(); // Always takes extra cycle for indexing
+	// Cycles 2-4: Fetch base address, add X
+	const Address final_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from final address
 	Byte value = read_byte(final_address);
 	// Cycle 6: Write original value back (during operation)
@@ -3516,12 +2847,11 @@ void CPU6502::ROL_accumulator() {
 void CPU6502::ROL_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
+	const Address zero_page_addr = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(zero_page_addr);
+	Byte value = read_low_ram(zero_page_addr);
 	// Cycle 4: Write original value back (during operation)
-	write_byte(zero_page_addr, value);
+	write_low_ram(zero_page_addr, value);
 	// Cycle 5: Write modified value
 
 	// Save bit 7 for carry flag
@@ -3533,23 +2863,19 @@ void CPU6502::ROL_zero_page() {
 	// Set new carry flag
 	status_.flags.carry_flag_ = new_carry;
 
-	write_byte(zero_page_addr, value);
+	write_low_ram(zero_page_addr, value);
 	update_zero_and_negative_flags(value);
 	// Total: 5 cycles
 }
 
 void CPU6502::ROL_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to zero page address
-	consume_cycle();
-	Byte final_addr = static_cast<Byte>(zero_page_addr + x_register_);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address final_addr = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from final address
-	Byte value = read_byte(final_addr);
+	Byte value = read_low_ram(final_addr);
 	// Cycle 5: Write original value back (during operation)
-	write_byte(final_addr, value);
+	write_low_ram(final_addr, value);
 	// Cycle 6: Write modified value
 
 	// Save bit 7 for carry flag
@@ -3561,21 +2887,15 @@ void CPU6502::ROL_zero_page_X() {
 	// Set new carry flag
 	status_.flags.carry_flag_ = new_carry;
 
-	write_byte(final_addr, value);
+	write_low_ram(final_addr, value);
 	update_zero_and_negative_flags(value);
 	// Total: 6 cycles
 }
 
 void CPU6502::ROL_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte addr_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte addr_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(addr_high) << 8) | addr_low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Write original value back (during operation)
 	write_byte(address, value);
@@ -3597,16 +2917,8 @@ void CPU6502::ROL_absolute() {
 
 void CPU6502::ROL_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte addr_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte addr_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X register to address
-	Word base_address = (static_cast<Word>(addr_high) << 8) | addr_low;
-	Word final_address = base_address + x_register_;
-	consume_cycle(); // Always takes extra cycle for indexing
+	// Cycles 2-4: Fetch base address, add X
+	const Address final_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from final address
 	Byte value = read_byte(final_address);
 	// Cycle 6: Write original value back (during operation)
@@ -3649,12 +2961,11 @@ void CPU6502::ROR_accumulator() {
 void CPU6502::ROR_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
+	const Address zero_page_addr = address_zero_page();
 	// Cycle 3: Read value from zero page address
-	Byte value = read_byte(zero_page_addr);
+	Byte value = read_low_ram(zero_page_addr);
 	// Cycle 4: Write original value back (during operation)
-	write_byte(zero_page_addr, value);
+	write_low_ram(zero_page_addr, value);
 	// Cycle 5: Write modified value
 
 	// Save bit 0 for carry flag
@@ -3666,23 +2977,19 @@ void CPU6502::ROR_zero_page() {
 	// Set new carry flag
 	status_.flags.carry_flag_ = new_carry;
 
-	write_byte(zero_page_addr, value);
+	write_low_ram(zero_page_addr, value);
 	update_zero_and_negative_flags(value);
 	// Total: 5 cycles
 }
 
 void CPU6502::ROR_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte zero_page_addr = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to zero page address
-	consume_cycle();
-	Byte final_addr = static_cast<Byte>(zero_page_addr + x_register_);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address final_addr = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from final address
-	Byte value = read_byte(final_addr);
+	Byte value = read_low_ram(final_addr);
 	// Cycle 5: Write original value back (during operation)
-	write_byte(final_addr, value);
+	write_low_ram(final_addr, value);
 	// Cycle 6: Write modified value
 
 	// Save bit 0 for carry flag
@@ -3694,21 +3001,15 @@ void CPU6502::ROR_zero_page_X() {
 	// Set new carry flag
 	status_.flags.carry_flag_ = new_carry;
 
-	write_byte(final_addr, value);
+	write_low_ram(final_addr, value);
 	update_zero_and_negative_flags(value);
 	// Total: 6 cycles
 }
 
 void CPU6502::ROR_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte addr_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte addr_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Word address = (static_cast<Word>(addr_high) << 8) | addr_low;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Write original value back (during operation)
 	write_byte(address, value);
@@ -3730,16 +3031,8 @@ void CPU6502::ROR_absolute() {
 
 void CPU6502::ROR_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte addr_low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte addr_high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X register to address
-	Word base_address = (static_cast<Word>(addr_high) << 8) | addr_low;
-	Word final_address = base_address + x_register_;
-	consume_cycle(); // Always takes extra cycle for indexing
+	// Cycles 2-4: Fetch base address, add X
+	const Address final_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from final address
 	Byte value = read_byte(final_address);
 	// Cycle 6: Write original value back (during operation)
@@ -3801,48 +3094,37 @@ void CPU6502::DEY() {
 void CPU6502::INC_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	// Cycle 4: Internal operation (increment)
 	consume_cycle();
 	value++;
 	// Cycle 5: Write incremented value back
-	write_byte(address, value);
+	write_low_ram(address, value);
 	update_zero_and_negative_flags(value);
 	// Total: 5 cycles
 }
 
 void CPU6502::INC_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register (with zero page wrap)
-	consume_cycle(); // Internal indexing operation
-	Byte final_address = (base_address + x_register_) & 0xFF;
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address final_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(final_address);
+	Byte value = read_low_ram(final_address);
 	// Cycle 5: Internal operation (increment)
 	consume_cycle();
 	value++;
 	// Cycle 6: Write incremented value back
-	write_byte(final_address, value);
+	write_low_ram(final_address, value);
 	update_zero_and_negative_flags(value);
 	// Total: 6 cycles
 }
 
 void CPU6502::INC_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Internal operation (increment)
 	consume_cycle();
@@ -3855,16 +3137,8 @@ void CPU6502::INC_absolute() {
 
 void CPU6502::INC_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (increment)
@@ -3879,48 +3153,37 @@ void CPU6502::INC_absolute_X() {
 void CPU6502::DEC_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(address);
+	Byte value = read_low_ram(address);
 	// Cycle 4: Internal operation (decrement)
 	consume_cycle();
 	value--;
 	// Cycle 5: Write decremented value back
-	write_byte(address, value);
+	write_low_ram(address, value);
 	update_zero_and_negative_flags(value);
 	// Total: 5 cycles
 }
 
 void CPU6502::DEC_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register (with zero page wrap)
-	consume_cycle(); // Internal indexing operation
-	Byte final_address = (base_address + x_register_) & 0xFF;
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address final_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(final_address);
+	Byte value = read_low_ram(final_address);
 	// Cycle 5: Internal operation (decrement)
 	consume_cycle();
 	value--;
 	// Cycle 6: Write decremented value back
-	write_byte(final_address, value);
+	write_low_ram(final_address, value);
 	update_zero_and_negative_flags(value);
 	// Total: 6 cycles
 }
 
 void CPU6502::DEC_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Internal operation (decrement)
 	consume_cycle();
@@ -3933,16 +3196,8 @@ void CPU6502::DEC_absolute() {
 
 void CPU6502::DEC_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (decrement)
@@ -3961,10 +3216,9 @@ void CPU6502::DEC_absolute_X() {
 void CPU6502::LAX_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(static_cast<Address>(address));
+	Byte value = read_low_ram(address);
 	// Load into both A and X registers
 	accumulator_ = value;
 	x_register_ = value;
@@ -3974,13 +3228,10 @@ void CPU6502::LAX_zero_page() {
 
 void CPU6502::LAX_zero_page_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add Y register to base address
-	Address effective_address = static_cast<Address>((base_address + y_register_) & 0xFF);
+	// Cycles 2-3: Fetch zero page base address, add Y (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::Y>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(effective_address);
+	Byte value = read_low_ram(effective_address);
 	// Load into both A and X registers
 	accumulator_ = value;
 	x_register_ = value;
@@ -3990,14 +3241,8 @@ void CPU6502::LAX_zero_page_Y() {
 
 void CPU6502::LAX_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Load into both A and X registers
 	accumulator_ = value;
@@ -4008,21 +3253,8 @@ void CPU6502::LAX_absolute() {
 
 void CPU6502::LAX_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Calculate effective address
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
-
-	// Cycle 4: Read from effective address (always, even if page crossed)
-	if (crosses_page_boundary(base_address, y_register_)) {
-		// Cycle 4: Read from wrong page first (dummy read)
-		consume_cycle();
-	}
+	// Cycles 2-3: Fetch base address, add Y (+1 cycle on page cross)
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, false>();
 	Byte value = read_byte(effective_address);
 	// Load into both A and X registers
 	accumulator_ = value;
@@ -4033,18 +3265,8 @@ void CPU6502::LAX_absolute_Y() {
 
 void CPU6502::LAX_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Byte pointer_address = (base_address + x_register_) & 0xFF;
-	// Cycle 4: Fetch low byte of target address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 5: Fetch high byte of target address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 6: Read value from target address
-	Address target_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	Byte value = read_byte(target_address);
 	// Load into both A and X registers
 	accumulator_ = value;
@@ -4055,22 +3277,8 @@ void CPU6502::LAX_indexed_indirect() {
 
 void CPU6502::LAX_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte pointer_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Calculate effective address
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
-
-	// Cycle 5: Read from effective address
-	if (crosses_page_boundary(base_address, y_register_)) {
-		// Cycle 5: Read from wrong page first (dummy read)
-		consume_cycle();
-	}
+	// Cycles 2-4: Fetch zero page pointer, fetch base address, add Y (+1 cycle on page cross)
+	const Address effective_address = address_indirect_indexed<false>();
 	Byte value = read_byte(effective_address);
 	// Load into both A and X registers
 	accumulator_ = value;
@@ -4083,38 +3291,28 @@ void CPU6502::LAX_indirect_indexed() {
 void CPU6502::SAX_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Store A AND X to zero page
 	Byte value = accumulator_ & x_register_;
-	write_byte(static_cast<Address>(address), value);
+	write_low_ram(address, value);
 	// Total: 3 cycles
 }
 
 void CPU6502::SAX_zero_page_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add Y register to base address
-	consume_cycle();
-	Address effective_address = static_cast<Address>((base_address + y_register_) & 0xFF);
+	// Cycles 2-3: Fetch zero page base address, add Y (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::Y>();
 	// Cycle 4: Store A AND X to effective address
 	Byte value = accumulator_ & x_register_;
-	write_byte(effective_address, value);
+	write_low_ram(effective_address, value);
 	// Total: 4 cycles
 }
 
 void CPU6502::SAX_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	// Cycle 4: Store A AND X to absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
 	Byte value = accumulator_ & x_register_;
 	write_byte(address, value);
 	// Total: 4 cycles
@@ -4122,18 +3320,9 @@ void CPU6502::SAX_absolute() {
 
 void CPU6502::SAX_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Byte pointer_address = (base_address + x_register_) & 0xFF;
-	// Cycle 4: Fetch low byte of target address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 5: Fetch high byte of target address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	// Cycle 6: Store A AND X to target address
-	Address target_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
 	Byte value = accumulator_ & x_register_;
 	write_byte(target_address, value);
 	// Total: 6 cycles
@@ -4143,15 +3332,14 @@ void CPU6502::SAX_indexed_indirect() {
 void CPU6502::DCP_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(static_cast<Address>(address));
+	Byte value = read_low_ram(address);
 	// Cycle 4: Internal operation (decrement)
 	consume_cycle();
 	value--;
 	// Cycle 5: Write decremented value back
-	write_byte(static_cast<Address>(address), value);
+	write_low_ram(address, value);
 	// Then perform compare with accumulator
 	perform_compare(accumulator_, value);
 	// Total: 5 cycles
@@ -4159,19 +3347,15 @@ void CPU6502::DCP_zero_page() {
 
 void CPU6502::DCP_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Address effective_address = static_cast<Address>((base_address + x_register_) & 0xFF);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(effective_address);
+	Byte value = read_low_ram(effective_address);
 	// Cycle 5: Internal operation (decrement)
 	consume_cycle();
 	value--;
 	// Cycle 6: Write decremented value back
-	write_byte(effective_address, value);
+	write_low_ram(effective_address, value);
 	// Then perform compare with accumulator
 	perform_compare(accumulator_, value);
 	// Total: 6 cycles
@@ -4179,14 +3363,8 @@ void CPU6502::DCP_zero_page_X() {
 
 void CPU6502::DCP_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Internal operation (decrement)
 	consume_cycle();
@@ -4200,16 +3378,8 @@ void CPU6502::DCP_absolute() {
 
 void CPU6502::DCP_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (decrement)
@@ -4224,16 +3394,8 @@ void CPU6502::DCP_absolute_X() {
 
 void CPU6502::DCP_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-4: Fetch base address, add Y
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (decrement)
@@ -4248,18 +3410,8 @@ void CPU6502::DCP_absolute_Y() {
 
 void CPU6502::DCP_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Byte pointer_address = (base_address + x_register_) & 0xFF;
-	// Cycle 4: Fetch low byte of target address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 5: Fetch high byte of target address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 6: Read value from target address
-	Address target_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	Byte value = read_byte(target_address);
 	// Cycle 7: Internal operation (decrement)
 	consume_cycle();
@@ -4273,17 +3425,8 @@ void CPU6502::DCP_indexed_indirect() {
 
 void CPU6502::DCP_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte pointer_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 5: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-5: Fetch zero page pointer, fetch base address, add Y
+	const Address effective_address = address_indirect_indexed<true>();
 	// Cycle 6: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 7: Internal operation (decrement)
@@ -4300,15 +3443,14 @@ void CPU6502::DCP_indirect_indexed() {
 void CPU6502::ISC_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(static_cast<Address>(address));
+	Byte value = read_low_ram(address);
 	// Cycle 4: Internal operation (increment)
 	consume_cycle();
 	value++;
 	// Cycle 5: Write incremented value back
-	write_byte(static_cast<Address>(address), value);
+	write_low_ram(address, value);
 	// Then perform SBC with the incremented value
 	perform_sbc(value);
 	// Total: 5 cycles
@@ -4316,19 +3458,15 @@ void CPU6502::ISC_zero_page() {
 
 void CPU6502::ISC_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Address effective_address = static_cast<Address>((base_address + x_register_) & 0xFF);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(effective_address);
+	Byte value = read_low_ram(effective_address);
 	// Cycle 5: Internal operation (increment)
 	consume_cycle();
 	value++;
 	// Cycle 6: Write incremented value back
-	write_byte(effective_address, value);
+	write_low_ram(effective_address, value);
 	// Then perform SBC with the incremented value
 	perform_sbc(value);
 	// Total: 6 cycles
@@ -4336,14 +3474,8 @@ void CPU6502::ISC_zero_page_X() {
 
 void CPU6502::ISC_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Internal operation (increment)
 	consume_cycle();
@@ -4357,16 +3489,8 @@ void CPU6502::ISC_absolute() {
 
 void CPU6502::ISC_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (increment)
@@ -4381,16 +3505,8 @@ void CPU6502::ISC_absolute_X() {
 
 void CPU6502::ISC_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-4: Fetch base address, add Y
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (increment)
@@ -4405,18 +3521,8 @@ void CPU6502::ISC_absolute_Y() {
 
 void CPU6502::ISC_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Byte pointer_address = (base_address + x_register_) & 0xFF;
-	// Cycle 4: Fetch low byte of target address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 5: Fetch high byte of target address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 6: Read value from target address
-	Address target_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	Byte value = read_byte(target_address);
 	// Cycle 7: Internal operation (increment)
 	consume_cycle();
@@ -4430,17 +3536,8 @@ void CPU6502::ISC_indexed_indirect() {
 
 void CPU6502::ISC_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte pointer_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 5: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-5: Fetch zero page pointer, fetch base address, add Y
+	const Address effective_address = address_indirect_indexed<true>();
 	// Cycle 6: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 7: Internal operation (increment)
@@ -4457,17 +3554,16 @@ void CPU6502::ISC_indirect_indexed() {
 void CPU6502::SLO_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(static_cast<Address>(address));
+	Byte value = read_low_ram(address);
 	// Cycle 4: Internal operation (shift left)
 	consume_cycle();
 	// Perform ASL operation
 	status_.flags.carry_flag_ = (value & 0x80) != 0;
 	value <<= 1;
 	// Cycle 5: Write shifted value back
-	write_byte(static_cast<Address>(address), value);
+	write_low_ram(address, value);
 	// Then perform ORA with the shifted value
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -4476,21 +3572,17 @@ void CPU6502::SLO_zero_page() {
 
 void CPU6502::SLO_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Address effective_address = static_cast<Address>((base_address + x_register_) & 0xFF);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(effective_address);
+	Byte value = read_low_ram(effective_address);
 	// Cycle 5: Internal operation (shift left)
 	consume_cycle();
 	// Perform ASL operation
 	status_.flags.carry_flag_ = (value & 0x80) != 0;
 	value <<= 1;
 	// Cycle 6: Write shifted value back
-	write_byte(effective_address, value);
+	write_low_ram(effective_address, value);
 	// Then perform ORA with the shifted value
 	accumulator_ |= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -4499,14 +3591,8 @@ void CPU6502::SLO_zero_page_X() {
 
 void CPU6502::SLO_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Internal operation (shift left)
 	consume_cycle();
@@ -4523,16 +3609,8 @@ void CPU6502::SLO_absolute() {
 
 void CPU6502::SLO_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (shift left)
@@ -4550,16 +3628,8 @@ void CPU6502::SLO_absolute_X() {
 
 void CPU6502::SLO_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-4: Fetch base address, add Y
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (shift left)
@@ -4577,18 +3647,8 @@ void CPU6502::SLO_absolute_Y() {
 
 void CPU6502::SLO_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Byte pointer_address = (base_address + x_register_) & 0xFF;
-	// Cycle 4: Fetch low byte of target address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 5: Fetch high byte of target address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 6: Read value from target address
-	Address target_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	Byte value = read_byte(target_address);
 	// Cycle 7: Internal operation (shift left)
 	consume_cycle();
@@ -4605,17 +3665,8 @@ void CPU6502::SLO_indexed_indirect() {
 
 void CPU6502::SLO_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte pointer_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 5: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-5: Fetch zero page pointer, fetch base address, add Y
+	const Address effective_address = address_indirect_indexed<true>();
 	// Cycle 6: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 7: Internal operation (shift left)
@@ -4635,10 +3686,9 @@ void CPU6502::SLO_indirect_indexed() {
 void CPU6502::RLA_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(static_cast<Address>(address));
+	Byte value = read_low_ram(address);
 	// Cycle 4: Internal operation (rotate left)
 	consume_cycle();
 	// Perform ROL operation
@@ -4646,7 +3696,7 @@ void CPU6502::RLA_zero_page() {
 	status_.flags.carry_flag_ = (value & 0x80) != 0;
 	value = (value << 1) | (old_carry ? 1 : 0);
 	// Cycle 5: Write rotated value back
-	write_byte(static_cast<Address>(address), value);
+	write_low_ram(address, value);
 	// Then perform AND with the rotated value
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -4655,14 +3705,10 @@ void CPU6502::RLA_zero_page() {
 
 void CPU6502::RLA_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Address effective_address = static_cast<Address>((base_address + x_register_) & 0xFF);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(effective_address);
+	Byte value = read_low_ram(effective_address);
 	// Cycle 5: Internal operation (rotate left)
 	consume_cycle();
 	// Perform ROL operation
@@ -4670,7 +3716,7 @@ void CPU6502::RLA_zero_page_X() {
 	status_.flags.carry_flag_ = (value & 0x80) != 0;
 	value = (value << 1) | (old_carry ? 1 : 0);
 	// Cycle 6: Write rotated value back
-	write_byte(effective_address, value);
+	write_low_ram(effective_address, value);
 	// Then perform AND with the rotated value
 	accumulator_ &= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -4679,14 +3725,8 @@ void CPU6502::RLA_zero_page_X() {
 
 void CPU6502::RLA_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Internal operation (rotate left)
 	consume_cycle();
@@ -4704,16 +3744,8 @@ void CPU6502::RLA_absolute() {
 
 void CPU6502::RLA_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (rotate left)
@@ -4732,16 +3764,8 @@ void CPU6502::RLA_absolute_X() {
 
 void CPU6502::RLA_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-4: Fetch base address, add Y
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (rotate left)
@@ -4760,18 +3784,8 @@ void CPU6502::RLA_absolute_Y() {
 
 void CPU6502::RLA_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Byte pointer_address = (base_address + x_register_) & 0xFF;
-	// Cycle 4: Fetch low byte of target address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 5: Fetch high byte of target address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 6: Read value from target address
-	Address target_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	Byte value = read_byte(target_address);
 	// Cycle 7: Internal operation (rotate left)
 	consume_cycle();
@@ -4789,17 +3803,8 @@ void CPU6502::RLA_indexed_indirect() {
 
 void CPU6502::RLA_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte pointer_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 5: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-5: Fetch zero page pointer, fetch base address, add Y
+	const Address effective_address = address_indirect_indexed<true>();
 	// Cycle 6: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 7: Internal operation (rotate left)
@@ -4823,17 +3828,16 @@ void CPU6502::RLA_indirect_indexed() {
 void CPU6502::SRE_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(static_cast<Address>(address));
+	Byte value = read_low_ram(address);
 	// Cycle 4: Internal operation (shift right)
 	consume_cycle();
 	// Perform LSR operation
 	status_.flags.carry_flag_ = (value & 0x01) != 0;
 	value >>= 1;
 	// Cycle 5: Write shifted value back
-	write_byte(static_cast<Address>(address), value);
+	write_low_ram(address, value);
 	// Then perform EOR with the shifted value
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -4842,21 +3846,17 @@ void CPU6502::SRE_zero_page() {
 
 void CPU6502::SRE_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Address effective_address = static_cast<Address>((base_address + x_register_) & 0xFF);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(effective_address);
+	Byte value = read_low_ram(effective_address);
 	// Cycle 5: Internal operation (shift right)
 	consume_cycle();
 	// Perform LSR operation
 	status_.flags.carry_flag_ = (value & 0x01) != 0;
 	value >>= 1;
 	// Cycle 6: Write shifted value back
-	write_byte(effective_address, value);
+	write_low_ram(effective_address, value);
 	// Then perform EOR with the shifted value
 	accumulator_ ^= value;
 	update_zero_and_negative_flags(accumulator_);
@@ -4865,14 +3865,8 @@ void CPU6502::SRE_zero_page_X() {
 
 void CPU6502::SRE_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Internal operation (shift right)
 	consume_cycle();
@@ -4889,16 +3883,8 @@ void CPU6502::SRE_absolute() {
 
 void CPU6502::SRE_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (shift right)
@@ -4916,16 +3902,8 @@ void CPU6502::SRE_absolute_X() {
 
 void CPU6502::SRE_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-4: Fetch base address, add Y
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (shift right)
@@ -4943,18 +3921,8 @@ void CPU6502::SRE_absolute_Y() {
 
 void CPU6502::SRE_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Byte pointer_address = (base_address + x_register_) & 0xFF;
-	// Cycle 4: Fetch low byte of target address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 5: Fetch high byte of target address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 6: Read value from target address
-	Address target_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	Byte value = read_byte(target_address);
 	// Cycle 7: Internal operation (shift right)
 	consume_cycle();
@@ -4971,17 +3939,8 @@ void CPU6502::SRE_indexed_indirect() {
 
 void CPU6502::SRE_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte pointer_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 5: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-5: Fetch zero page pointer, fetch base address, add Y
+	const Address effective_address = address_indirect_indexed<true>();
 	// Cycle 6: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 7: Internal operation (shift right)
@@ -5001,10 +3960,9 @@ void CPU6502::SRE_indirect_indexed() {
 void CPU6502::RRA_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	Byte address = read_byte(program_counter_);
-	program_counter_++;
+	const Address address = address_zero_page();
 	// Cycle 3: Read value from zero page
-	Byte value = read_byte(static_cast<Address>(address));
+	Byte value = read_low_ram(address);
 	// Cycle 4: Internal operation (rotate right)
 	consume_cycle();
 	// Perform ROR operation
@@ -5012,7 +3970,7 @@ void CPU6502::RRA_zero_page() {
 	status_.flags.carry_flag_ = (value & 0x01) != 0;
 	value = (value >> 1) | (old_carry ? 0x80 : 0);
 	// Cycle 5: Write rotated value back
-	write_byte(static_cast<Address>(address), value);
+	write_low_ram(address, value);
 	// Then perform ADC with the rotated value
 	perform_adc(value);
 	// Total: 5 cycles
@@ -5020,14 +3978,10 @@ void CPU6502::RRA_zero_page() {
 
 void CPU6502::RRA_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Address effective_address = static_cast<Address>((base_address + x_register_) & 0xFF);
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	const Address effective_address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Read value from effective address
-	Byte value = read_byte(effective_address);
+	Byte value = read_low_ram(effective_address);
 	// Cycle 5: Internal operation (rotate right)
 	consume_cycle();
 	// Perform ROR operation
@@ -5035,7 +3989,7 @@ void CPU6502::RRA_zero_page_X() {
 	status_.flags.carry_flag_ = (value & 0x01) != 0;
 	value = (value >> 1) | (old_carry ? 0x80 : 0);
 	// Cycle 6: Write rotated value back
-	write_byte(effective_address, value);
+	write_low_ram(effective_address, value);
 	// Then perform ADC with the rotated value
 	perform_adc(value);
 	// Total: 6 cycles
@@ -5043,14 +3997,8 @@ void CPU6502::RRA_zero_page_X() {
 
 void CPU6502::RRA_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Read value from absolute address
-	Address address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-3: Fetch absolute address
+	const Address address = address_absolute();
 	Byte value = read_byte(address);
 	// Cycle 5: Internal operation (rotate right)
 	consume_cycle();
@@ -5067,16 +4015,8 @@ void CPU6502::RRA_absolute() {
 
 void CPU6502::RRA_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add X to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + x_register_;
+	// Cycles 2-4: Fetch base address, add X
+	const Address effective_address = address_absolute_indexed<IndexRegister::X, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (rotate right)
@@ -5094,16 +4034,8 @@ void CPU6502::RRA_absolute_X() {
 
 void CPU6502::RRA_absolute_Y() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-4: Fetch base address, add Y
+	const Address effective_address = address_absolute_indexed<IndexRegister::Y, true>();
 	// Cycle 5: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 6: Internal operation (rotate right)
@@ -5121,18 +4053,8 @@ void CPU6502::RRA_absolute_Y() {
 
 void CPU6502::RRA_indexed_indirect() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	Byte base_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register to base address
-	consume_cycle();
-	Byte pointer_address = (base_address + x_register_) & 0xFF;
-	// Cycle 4: Fetch low byte of target address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 5: Fetch high byte of target address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 6: Read value from target address
-	Address target_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
+	// Cycles 2-5: Fetch zero page pointer, add X, fetch target address
+	const Address target_address = address_indexed_indirect();
 	Byte value = read_byte(target_address);
 	// Cycle 7: Internal operation (rotate right)
 	consume_cycle();
@@ -5149,17 +4071,8 @@ void CPU6502::RRA_indexed_indirect() {
 
 void CPU6502::RRA_indirect_indexed() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page address
-	Byte pointer_address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch low byte of base address
-	Byte low = read_byte(static_cast<Address>(pointer_address));
-	// Cycle 4: Fetch high byte of base address
-	Byte high = read_byte(static_cast<Address>((pointer_address + 1) & 0xFF));
-	// Cycle 5: Add Y to base address (internal operation)
-	consume_cycle(); // Always takes extra cycle for RMW operations
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	Address effective_address = base_address + y_register_;
+	// Cycles 2-5: Fetch zero page pointer, fetch base address, add Y
+	const Address effective_address = address_indirect_indexed<true>();
 	// Cycle 6: Read value from effective address
 	Byte value = read_byte(effective_address);
 	// Cycle 7: Internal operation (rotate right)
@@ -5179,7 +4092,7 @@ void CPU6502::RRA_indirect_indexed() {
 void CPU6502::NOP_immediate() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch immediate value (but ignore it)
-	[[maybe_unused]] Byte value = read_byte(program_counter_);
+	[[maybe_unused]] Byte value = fetch_byte(program_counter_);
 	program_counter_++;
 	// Total: 2 cycles
 }
@@ -5187,8 +4100,7 @@ void CPU6502::NOP_immediate() {
 void CPU6502::NOP_zero_page() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
 	// Cycle 2: Fetch zero page address
-	[[maybe_unused]] Byte address = read_byte(program_counter_);
-	program_counter_++;
+	[[maybe_unused]] const Address address = address_zero_page();
 	// Cycle 3: Read from zero page (dummy read)
 	consume_cycle();
 	// Total: 3 cycles
@@ -5196,11 +4108,8 @@ void CPU6502::NOP_zero_page() {
 
 void CPU6502::NOP_zero_page_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch zero page base address
-	[[maybe_unused]] Byte address = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Add X register (dummy operation)
-	consume_cycle();
+	// Cycles 2-3: Fetch zero page base address, add X (wraps within zero page)
+	[[maybe_unused]] const Address address = address_zero_page_indexed<IndexRegister::X>();
 	// Cycle 4: Dummy read
 	consume_cycle();
 	// Total: 4 cycles
@@ -5208,12 +4117,8 @@ void CPU6502::NOP_zero_page_X() {
 
 void CPU6502::NOP_absolute() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of address
-	[[maybe_unused]] Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of address
-	[[maybe_unused]] Byte high = read_byte(program_counter_);
-	program_counter_++;
+	// Cycles 2-3: Fetch absolute address
+	[[maybe_unused]] const Address address = address_absolute();
 	// Cycle 4: Dummy read
 	consume_cycle();
 	// Total: 4 cycles
@@ -5221,24 +4126,25 @@ void CPU6502::NOP_absolute() {
 
 void CPU6502::NOP_absolute_X() {
 	// Cycle 1: Fetch opcode (already consumed in execute_instruction)
-	// Cycle 2: Fetch low byte of base address
-	Byte low = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 3: Fetch high byte of base address
-	Byte high = read_byte(program_counter_);
-	program_counter_++;
-	// Cycle 4: Calculate effective address and read (may cross page boundary)
-	Address base_address = static_cast<Address>(low) | (static_cast<Address>(high) << 8);
-	if (crosses_page_boundary(base_address, x_register_)) {
-		// Cycle 4: Read from wrong page first (dummy read)
-		consume_cycle();
-	}
+	// Cycles 2-3: Fetch base address, add X (+1 cycle on page cross)
+	[[maybe_unused]] const Address address = address_absolute_indexed<IndexRegister::X, false>();
 	// Cycle 4/5: Read from correct address (dummy read)
 	consume_cycle();
 	// Total: 4 cycles (5 if page boundary crossed)
 }
 
 // Highly unstable opcodes - these will crash/halt the CPU
+void CPU6502::UNKNOWN() {
+	// Every opcode 0x00-0xFF should have a handler; reaching here means a
+	// decoder or ROM bug. Flag it (queryable via is_halted()) so callers can
+	// detect it, then fall back to NOP timing so the emulator keeps running.
+	const Address address = static_cast<Address>(program_counter_ - 1);
+	std::cerr << std::format("Unknown opcode: 0x{:02X} at PC: 0x{:04X}\n", static_cast<int>(bus_->peek(address)),
+							 static_cast<int>(address));
+	halted_ = true;
+	cycles_remaining_ -= CpuCycle{2};
+}
+
 void CPU6502::CRASH() {
 	// These opcodes cause the CPU to enter an undefined state
 	// In real hardware, this could cause the CPU to hang, crash, or behave unpredictably
@@ -5298,6 +4204,10 @@ void CPU6502::deserialize_state(const std::vector<uint8_t> &buffer, size_t &offs
 		throw std::runtime_error("save state: unexpected end of buffer (CPU)");
 	}
 
+	// An armed idle loop or block head belongs to the state being replaced
+	idle_loop_armed_ = false;
+	block_head_ = false;
+
 	// Deserialize all registers
 	accumulator_ = buffer[offset++];
 	x_register_ = buffer[offset++];
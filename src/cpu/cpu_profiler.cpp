@@ -0,0 +1,272 @@
+#include "cpu/cpu_profiler.hpp"
+#include "cartridge/cartridge.hpp"
+#include "cpu/opcode_table.hpp"
+#include <algorithm>
+#include <format>
+#include <ostream>
+#include <string>
+
+namespace nes {
+
+namespace {
+// Bounds the shadow stack if a program keeps calling without ever returning
+// to an outer S (e.g. it rebuilds its stack with TXS)
+constexpr std::size_t MAX_FRAMES = 256;
+
+double percent(uint64_t part, uint64_t total) {
+	return total ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+}
+
+std::string bank_label(int32_t bank) {
+	return bank == CpuProfiler::NO_BANK ? std::string("--") : std::format("{:02X}", bank);
+}
+} // namespace
+
+CpuProfiler::CpuProfiler(const Cartridge *cartridge) {
+	attach_cartridge(cartridge);
+}
+
+void CpuProfiler::attach_cartridge(const Cartridge *cartridge) {
+	page_table_ = cartridge ? cartridge->prg_page_table() : nullptr;
+	const std::span<const Byte> prg = cartridge ? cartridge->prg_rom_data() : std::span<const Byte>{};
+	if (!page_table_ || prg.empty()) {
+		page_table_ = nullptr;
+	}
+	prg_rom_ = page_table_ ? prg.data() : nullptr;
+	rom_size_ = page_table_ ? static_cast<uint32_t>(prg.size()) : 0;
+	reset();
+}
+
+void CpuProfiler::reset() {
+	counters_.assign(rom_size_ + 0x10000, Counters{});
+	key_pcs_.assign(rom_size_, 0);
+	total_cycles_ = 0;
+	total_instructions_ = 0;
+	stack_.clear();
+	root_self_cycles_ = 0;
+	routines_.clear();
+	edges_.clear();
+}
+
+CpuProfiler::Key CpuProfiler::key_for(Address pc) const noexcept {
+	if (page_table_ && pc >= 0x8000) {
+		const Byte *page = (*page_table_)[(pc >> 13) & 0x03];
+		if (page >= prg_rom_ && page < prg_rom_ + rom_size_) {
+			return static_cast<Key>(page - prg_rom_) + (pc & (PRG_BANK_SIZE - 1));
+		}
+	}
+	return rom_size_ + pc;
+}
+
+int32_t CpuProfiler::bank_of(Key key) const noexcept {
+	return key < rom_size_ ? static_cast<int32_t>(key / PRG_BANK_SIZE) : NO_BANK;
+}
+
+Address CpuProfiler::pc_of(Key key) const noexcept {
+	if (key == ROOT_KEY) {
+		return ROOT_PC;
+	}
+	return key < rom_size_ ? key_pcs_[key] : static_cast<Address>(key - rom_size_);
+}
+
+CpuProfiler::Routine CpuProfiler::describe(Key key) const noexcept {
+	Routine routine;
+	routine.bank = key == ROOT_KEY ? NO_BANK : bank_of(key);
+	routine.pc = pc_of(key);
+	return routine;
+}
+
+void CpuProfiler::add_cycles(Key key, uint64_t cycles) {
+	counters_[key].cycles += cycles;
+	total_cycles_ += cycles;
+	if (stack_.empty()) {
+		root_self_cycles_ += cycles;
+	} else {
+		stack_.back().self_cycles += cycles;
+	}
+}
+
+void CpuProfiler::push_frame(Key routine, Byte sp_at_call) {
+	if (stack_.size() >= MAX_FRAMES) {
+		stack_.erase(stack_.begin());
+	}
+	stack_.push_back(Frame{routine, sp_at_call, total_cycles_});
+}
+
+void CpuProfiler::unwind_to(Byte sp) {
+	// A frame is closed once S is back where it was before the call pushed
+	// its return address
+	while (!stack_.empty() && stack_.back().sp_at_call <= sp) {
+		const Frame frame = stack_.back();
+		stack_.pop_back();
+		const Key caller = stack_.empty() ? ROOT_KEY : stack_.back().routine;
+		const uint64_t inclusive = total_cycles_ - frame.entry_cycles;
+
+		RoutineTotals &totals = routines_[frame.routine];
+		++totals.calls;
+		totals.self_cycles += frame.self_cycles;
+		totals.inclusive_cycles += inclusive;
+
+		EdgeTotals &edge = edges_[{caller, frame.routine}];
+		++edge.calls;
+		edge.inclusive_cycles += inclusive;
+	}
+}
+
+void CpuProfiler::record_instruction(Address pc, Byte opcode, int cycles, Address next_pc, Byte sp_before,
+									 Byte sp_after) {
+	const Key key = key_for(pc);
+	if (key < rom_size_) {
+		key_pcs_[key] = pc;
+	}
+	++counters_[key].instructions;
+	++total_instructions_;
+	add_cycles(key, static_cast<uint64_t>(cycles));
+
+	const InstructionFlow flow = OPCODE_INFO[opcode].flow;
+	if (flow == InstructionFlow::Call || flow == InstructionFlow::Break) {
+		const Key callee = key_for(next_pc);
+		if (callee < rom_size_) {
+			key_pcs_[callee] = next_pc;
+		}
+		push_frame(callee, sp_before);
+	} else if (sp_after > sp_before) {
+		// RTS, RTI, PLA, TXS...: close every frame the stack has returned past
+		unwind_to(sp_after);
+	}
+}
+
+void CpuProfiler::record_interrupt(Address handler_pc, int cycles, Byte sp_before) {
+	const Key key = key_for(handler_pc);
+	if (key < rom_size_) {
+		key_pcs_[key] = handler_pc;
+	}
+	push_frame(key, sp_before);
+	// The entry sequence is charged to the handler's first instruction
+	add_cycles(key, static_cast<uint64_t>(cycles));
+}
+
+void CpuProfiler::record_idle_cycles(Address pc, uint64_t cycles) {
+	const Key key = key_for(pc);
+	counters_[key].idle_cycles += cycles;
+	add_cycles(key, cycles);
+}
+
+void CpuProfiler::record_stall_cycles(Address pc, uint64_t cycles) {
+	add_cycles(key_for(pc), cycles);
+}
+
+const CpuProfiler::Counters *CpuProfiler::counters_at(Address pc) const {
+	const Counters &counters = counters_[key_for(pc)];
+	return (counters.instructions || counters.cycles) ? &counters : nullptr;
+}
+
+std::vector<CpuProfiler::FlatEntry> CpuProfiler::flat_profile() const {
+	std::vector<FlatEntry> entries;
+	for (Key key = 0; key < counters_.size(); ++key) {
+		const Counters &counters = counters_[key];
+		if (counters.instructions || counters.cycles) {
+			entries.push_back(FlatEntry{bank_of(key), pc_of(key), counters});
+		}
+	}
+	std::stable_sort(entries.begin(), entries.end(), [](const FlatEntry &a, const FlatEntry &b) {
+		return a.counters.cycles > b.counters.cycles;
+	});
+	return entries;
+}
+
+std::vector<CpuProfiler::Routine> CpuProfiler::routines() const {
+	std::map<Key, RoutineTotals> totals = routines_;
+	// Open frames count as one (unfinished) call each
+	for (const Frame &frame : stack_) {
+		RoutineTotals &open = totals[frame.routine];
+		++open.calls;
+		open.self_cycles += frame.self_cycles;
+		open.inclusive_cycles += total_cycles_ - frame.entry_cycles;
+	}
+
+	std::vector<Routine> result;
+	Routine root = describe(ROOT_KEY);
+	root.self_cycles = root_self_cycles_;
+	root.inclusive_cycles = total_cycles_;
+	result.push_back(root);
+	for (const auto &[key, routine_totals] : totals) {
+		Routine routine = describe(key);
+		routine.calls = routine_totals.calls;
+		routine.self_cycles = routine_totals.self_cycles;
+		routine.inclusive_cycles = routine_totals.inclusive_cycles;
+		result.push_back(routine);
+	}
+	std::stable_sort(result.begin(), result.end(), [](const Routine &a, const Routine &b) {
+		return a.inclusive_cycles > b.inclusive_cycles;
+	});
+	return result;
+}
+
+std::vector<CpuProfiler::CallEdge> CpuProfiler::call_graph() const {
+	std::map<std::pair<Key, Key>, EdgeTotals> totals = edges_;
+	for (std::size_t i = 0; i < stack_.size(); ++i) {
+		const Key caller = i == 0 ? ROOT_KEY : stack_[i - 1].routine;
+		EdgeTotals &open = totals[{caller, stack_[i].routine}];
+		++open.calls;
+		open.inclusive_cycles += total_cycles_ - stack_[i].entry_cycles;
+	}
+
+	std::vector<CallEdge> result;
+	for (const auto &[keys, edge_totals] : totals) {
+		result.push_back(
+			CallEdge{describe(keys.first), describe(keys.second), edge_totals.calls, edge_totals.inclusive_cycles});
+	}
+	std::stable_sort(result.begin(), result.end(), [](const CallEdge &a, const CallEdge &b) {
+		return a.inclusive_cycles > b.inclusive_cycles;
+	});
+	return result;
+}
+
+void CpuProfiler::write_flat_profile(std::ostream &out, std::size_t limit) const {
+	const std::vector<FlatEntry> entries = flat_profile();
+	out << std::format("# {} instructions, {} cycles\n", total_instructions_, total_cycles_);
+	out << "# bank  pc     instructions        cycles  cycles%    idle cycles\n";
+	std::size_t count = 0;
+	for (const FlatEntry &entry : entries) {
+		if (limit && count++ == limit) {
+			break;
+		}
+		out << std::format("  {:>4}  ${:04X} {:>12} {:>13} {:>7.2f}% {:>14}\n", bank_label(entry.bank), entry.pc,
+						   entry.counters.instructions, entry.counters.cycles,
+						   percent(entry.counters.cycles, total_cycles_), entry.counters.idle_cycles);
+	}
+}
+
+void CpuProfiler::write_call_graph(std::ostream &out, std::size_t limit) const {
+	auto name = [](const Routine &routine) {
+		return routine.pc == ROOT_PC && routine.bank == NO_BANK ? std::string("<root>")
+																: std::format("{}:${:04X}", bank_label(routine.bank),
+																			  routine.pc);
+	};
+
+	out << std::format("# routines ({} cycles)\n", total_cycles_);
+	out << "# routine         calls   self cycles   self%  inclusive cycles   incl%\n";
+	std::size_t count = 0;
+	for (const Routine &routine : routines()) {
+		if (limit && count++ == limit) {
+			break;
+		}
+		out << std::format("  {:<10} {:>10} {:>13} {:>6.2f}% {:>17} {:>6.2f}%\n", name(routine), routine.calls,
+						   routine.self_cycles, percent(routine.self_cycles, total_cycles_),
+						   routine.inclusive_cycles, percent(routine.inclusive_cycles, total_cycles_));
+	}
+
+	out << "\n# calls (caller -> callee)\n";
+	out << "# caller      callee          calls  inclusive cycles   incl%\n";
+	count = 0;
+	for (const CallEdge &edge : call_graph()) {
+		if (limit && count++ == limit) {
+			break;
+		}
+		out << std::format("  {:<10} -> {:<10} {:>8} {:>17} {:>6.2f}%\n", name(edge.caller), name(edge.callee),
+						   edge.calls, edge.inclusive_cycles, percent(edge.inclusive_cycles, total_cycles_));
+	}
+}
+
+} // namespace nes
@@ -0,0 +1,127 @@
+#include "cpu/cpu_trace.hpp"
+#include "cpu/disassembler.hpp"
+#include <cstring>
+#include <format>
+#include <istream>
+#include <string_view>
+
+namespace nes {
+
+CpuTraceWriter::CpuTraceWriter(std::size_t records_per_buffer) : capacity_(records_per_buffer ? records_per_buffer : 1) {
+	buffers_[0].resize(capacity_);
+	buffers_[1].resize(capacity_);
+}
+
+CpuTraceWriter::~CpuTraceWriter() {
+	close();
+}
+
+bool CpuTraceWriter::open(const std::filesystem::path &path) {
+	close();
+	file_.open(path, std::ios::binary | std::ios::trunc);
+	if (!file_) {
+		return false;
+	}
+	const TraceFileHeader header;
+	file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	fill_ = 0;
+	fill_count_ = 0;
+	records_ = 0;
+	pending_ = false;
+	stop_ = false;
+	failed_ = !file_;
+	thread_ = std::thread([this] { writer_main(); });
+	return true;
+}
+
+bool CpuTraceWriter::close() {
+	if (!thread_.joinable()) {
+		return !failed_;
+	}
+	if (fill_count_ > 0) {
+		hand_off();
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	cv_.notify_all();
+	thread_.join();
+
+	file_.close();
+	failed_ = failed_ || !file_;
+	return !failed_;
+}
+
+void CpuTraceWriter::hand_off() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	// The other buffer is free once the writer has finished with it
+	cv_.wait(lock, [this] { return !pending_; });
+	pending_ = true;
+	pending_count_ = fill_count_;
+	fill_ ^= 1;
+	fill_count_ = 0;
+	lock.unlock();
+	cv_.notify_all();
+}
+
+void CpuTraceWriter::writer_main() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		cv_.wait(lock, [this] { return pending_ || stop_; });
+		if (pending_) {
+			const TraceRecord *records = buffers_[fill_ ^ 1].data();
+			const std::size_t count = pending_count_;
+			lock.unlock();
+			file_.write(reinterpret_cast<const char *>(records), static_cast<std::streamsize>(count * sizeof(TraceRecord)));
+			const bool ok = static_cast<bool>(file_);
+			lock.lock();
+			failed_ = failed_ || !ok;
+			pending_ = false;
+			cv_.notify_all();
+			continue;
+		}
+		return; // Stopped with nothing left to write
+	}
+}
+
+CpuTraceReader::CpuTraceReader(std::istream &input) : input_(input) {
+	TraceFileHeader header;
+	const TraceFileHeader expected;
+	input_.read(reinterpret_cast<char *>(&header), sizeof(header));
+	valid_ = input_.gcount() == sizeof(header) && std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0 &&
+			 header.version == expected.version && header.record_size == expected.record_size;
+}
+
+bool CpuTraceReader::read(TraceRecord &record) {
+	if (!valid_) {
+		return false;
+	}
+	input_.read(reinterpret_cast<char *>(&record), sizeof(record));
+	return input_.gcount() == sizeof(record);
+}
+
+std::string format_trace_line(const TraceRecord &record) {
+	const Instruction instruction = decode_instruction(record.pc, record.bytes[0], record.bytes[1], record.bytes[2]);
+
+	std::string line = std::format("{:04X}  ", record.pc);
+	for (std::uint8_t i = 0; i < 3; ++i) {
+		line += i < record.length ? std::format("{:02X} ", record.bytes[i]) : std::string("   ");
+	}
+	line += instruction.unofficial ? '*' : ' ';
+
+	// nestest's name for ISC
+	std::string text = instruction.mnemonic == "ISC" ? "ISB" : std::string(instruction.mnemonic);
+	const std::string operand = format_operand(instruction);
+	if (!operand.empty()) {
+		text += ' ';
+		text += operand;
+	}
+	line += std::format("{:<32}", text);
+	line += std::format("A:{:02X} X:{:02X} Y:{:02X} P:{:02X} SP:{:02X} PPU:{:3},{:3} CYC:{}", record.a, record.x,
+						record.y, record.p, record.sp, record.scanline, record.dot, record.cycle);
+	return line;
+}
+
+} // namespace nes
@@ -0,0 +1,87 @@
+#include "cpu/disassembler.hpp"
+#include <format>
+
+namespace nes {
+
+Address Instruction::address() const noexcept {
+	const Byte low = bytes[1];
+	switch (mode) {
+	case AddressingMode::ZeroPage:
+	case AddressingMode::ZeroPageX:
+	case AddressingMode::ZeroPageY:
+	case AddressingMode::IndexedIndirect:
+	case AddressingMode::IndirectIndexed:
+		return low;
+	case AddressingMode::Relative:
+		return static_cast<Address>(pc + 2 + static_cast<SignedByte>(low));
+	default:
+		return static_cast<Address>(low | (bytes[2] << 8));
+	}
+}
+
+std::uint8_t instruction_length(Byte opcode) noexcept {
+	return OPCODE_INFO[opcode].length;
+}
+
+Instruction decode_instruction(Address pc, Byte opcode, Byte operand1, Byte operand2) noexcept {
+	const OpcodeInfo &info = OPCODE_INFO[opcode];
+	Instruction instruction;
+	instruction.pc = pc;
+	instruction.length = info.length;
+	instruction.bytes = {opcode, instruction.length > 1 ? operand1 : Byte{0},
+						 instruction.length > 2 ? operand2 : Byte{0}};
+	instruction.mnemonic = info.mnemonic;
+	instruction.mode = info.mode;
+	instruction.flow = info.flow;
+	instruction.unofficial = info.unofficial;
+	return instruction;
+}
+
+std::string format_operand(const Instruction &instruction, std::string_view label) {
+	const Byte low = instruction.bytes[1];
+	const auto byte_or_label = [&] { return label.empty() ? std::format("${:02X}", low) : std::string(label); };
+	const auto word_or_label = [&] {
+		return label.empty() ? std::format("${:04X}", instruction.address()) : std::string(label);
+	};
+
+	switch (instruction.mode) {
+	case AddressingMode::Implied:
+		return {};
+	case AddressingMode::Accumulator:
+		return "A";
+	case AddressingMode::Immediate:
+		return std::format("#${:02X}", low);
+	case AddressingMode::ZeroPage:
+		return byte_or_label();
+	case AddressingMode::ZeroPageX:
+		return byte_or_label() + ",X";
+	case AddressingMode::ZeroPageY:
+		return byte_or_label() + ",Y";
+	case AddressingMode::Absolute:
+	case AddressingMode::Relative:
+		return word_or_label();
+	case AddressingMode::AbsoluteX:
+		return word_or_label() + ",X";
+	case AddressingMode::AbsoluteY:
+		return word_or_label() + ",Y";
+	case AddressingMode::Indirect:
+		return std::format("({})", word_or_label());
+	case AddressingMode::IndexedIndirect:
+		return std::format("({},X)", byte_or_label());
+	case AddressingMode::IndirectIndexed:
+		return std::format("({}),Y", byte_or_label());
+	}
+	return {};
+}
+
+std::string format_instruction(const Instruction &instruction, std::string_view label) {
+	std::string text(instruction.mnemonic);
+	const std::string operand = format_operand(instruction, label);
+	if (!operand.empty()) {
+		text += ' ';
+		text += operand;
+	}
+	return text;
+}
+
+} // namespace nes
@@ -0,0 +1,212 @@
+#include "cpu/disassembly_cache.hpp"
+#include "cartridge/cartridge.hpp"
+#include "core/bus.hpp"
+#include "cpu/opcode_table.hpp"
+#include <algorithm>
+#include <span>
+
+namespace nes {
+
+namespace {
+
+// Straight-line decoding stops after control leaves for good: JMP, RTS,
+// RTI, BRK and the opcodes that halt the CPU
+constexpr bool ends_straight_line(Byte opcode) noexcept {
+	switch (OPCODE_INFO[opcode].flow) {
+	case InstructionFlow::Jump:
+	case InstructionFlow::IndirectJump:
+	case InstructionFlow::Return:
+	case InstructionFlow::Break:
+	case InstructionFlow::Halt:
+		return true;
+	default:
+		return false;
+	}
+}
+
+constexpr int MAX_DECODE_STEPS = 64;
+constexpr int MAX_ALIGN_DISTANCE = 100;
+
+} // namespace
+
+std::uint8_t DisassemblyCache::instruction_size(Byte opcode) noexcept {
+	return OPCODE_INFO[opcode].length;
+}
+
+void DisassemblyCache::clear() {
+	flags_.clear();
+	logged_opcodes_.clear();
+	rom_size_ = 0;
+}
+
+void DisassemblyCache::bind(const SystemBus &bus) {
+	const Cartridge *cartridge = bus.get_cartridge();
+	page_table_ = cartridge ? cartridge->prg_page_table() : nullptr;
+	const std::span<const Byte> prg = cartridge ? cartridge->prg_rom_data() : std::span<const Byte>{};
+	if (prg.empty()) {
+		page_table_ = nullptr;
+	}
+	prg_rom_ = page_table_ ? prg.data() : nullptr;
+
+	const auto rom_size = static_cast<std::uint32_t>(page_table_ ? prg.size() : 0);
+	if (rom_size != rom_size_ || flags_.empty()) {
+		rom_size_ = rom_size;
+		flags_.assign(rom_size_ + 0x10000, 0);
+		logged_opcodes_.assign(0x10000, 0);
+	}
+}
+
+DisassemblyCache::Key DisassemblyCache::key_for(Address address) const noexcept {
+	if (page_table_ && address >= 0x8000) {
+		const Byte *page = (*page_table_)[(address >> 13) & 0x03];
+		if (page >= prg_rom_ && page < prg_rom_ + rom_size_) {
+			return static_cast<Key>(page - prg_rom_) + (address & 0x1FFF);
+		}
+	}
+	return rom_size_ + address;
+}
+
+std::uint8_t DisassemblyCache::flags_at(const SystemBus &bus, Address address) {
+	const Key key = key_for(address);
+	const std::uint8_t flags = flags_[key];
+	// Outside PRG ROM the bytes can change under the log: drop stale entries
+	if (flags && key >= rom_size_ && bus.peek(address) != logged_opcodes_[address]) {
+		flags_[key] = 0;
+		return 0;
+	}
+	return flags;
+}
+
+void DisassemblyCache::mark(const SystemBus &bus, Address address, std::uint8_t flag) {
+	(void)flags_at(bus, address);
+	const Key key = key_for(address);
+	flags_[key] |= flag;
+	if (key >= rom_size_) {
+		logged_opcodes_[address] = bus.peek(address);
+	}
+}
+
+void DisassemblyCache::unmark(Address address, std::uint8_t flag) {
+	flags_[key_for(address)] &= static_cast<std::uint8_t>(~flag);
+}
+
+void DisassemblyCache::log_executed(const SystemBus &bus, Address pc) {
+	bind(bus);
+	if (flags_at(bus, pc) & EXECUTED) {
+		return;
+	}
+	mark(bus, pc, EXECUTED);
+
+	// A decoded guess whose operand covers this PC was misaligned
+	for (Address distance = 1; distance <= 2; ++distance) {
+		const auto start = static_cast<Address>(pc - distance);
+		if (flags_at(bus, start) == DECODED && instruction_size(bus.peek(start)) > distance) {
+			unmark(start, DECODED);
+		}
+	}
+
+	Address address = pc;
+	for (int step = 0; step < MAX_DECODE_STEPS; ++step) {
+		const Byte opcode = bus.peek(address);
+		const std::uint8_t size = instruction_size(opcode);
+		for (std::uint8_t i = 1; i < size; ++i) {
+			const auto operand = static_cast<Address>(address + i);
+			if (flags_at(bus, operand) & EXECUTED) {
+				return; // Overlaps code that really ran: this stream is data
+			}
+			unmark(operand, DECODED);
+		}
+		if (ends_straight_line(opcode)) {
+			return;
+		}
+		address = static_cast<Address>(address + size);
+		if (flags_at(bus, address)) {
+			return; // Joined code that is already known
+		}
+		mark(bus, address, DECODED);
+	}
+}
+
+bool DisassemblyCache::heuristic_align(const SystemBus &bus, Address pc) {
+	// Find the longest run of instructions that lands exactly on pc, starting
+	// as far back as possible
+	std::vector<Address> sequence;
+	for (int start_offset = MAX_ALIGN_DISTANCE; start_offset >= 1; --start_offset) {
+		if (start_offset > pc) {
+			continue;
+		}
+		sequence.clear();
+		int address = pc - start_offset;
+		while (address < pc) {
+			sequence.push_back(static_cast<Address>(address));
+			address += instruction_size(bus.peek(static_cast<Address>(address)));
+		}
+		if (address == pc) {
+			for (const Address start : sequence) {
+				if (!flags_at(bus, start)) {
+					mark(bus, start, DECODED);
+				}
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<Address> DisassemblyCache::window(const SystemBus &bus, Address pc, int before, int after) {
+	bind(bus);
+	std::vector<Address> addresses;
+	addresses.reserve(static_cast<std::size_t>(before + after + 1));
+
+	// Walk back over known starts whose instruction ends where the next begins
+	Address current = pc;
+	bool aligned_here = false;
+	while (static_cast<int>(addresses.size()) < before) {
+		int found = -1;
+		for (Address size = 1; size <= 3; ++size) {
+			const auto start = static_cast<Address>(current - size);
+			const std::uint8_t flags = flags_at(bus, start);
+			if (!flags || instruction_size(bus.peek(start)) != size) {
+				continue;
+			}
+			if (flags & EXECUTED) {
+				found = start;
+				break;
+			}
+			if (found < 0) {
+				found = start;
+			}
+		}
+		if (found < 0) {
+			if (aligned_here || !heuristic_align(bus, current)) {
+				break;
+			}
+			aligned_here = true;
+			continue;
+		}
+		current = static_cast<Address>(found);
+		aligned_here = false;
+		addresses.push_back(current);
+	}
+	std::reverse(addresses.begin(), addresses.end());
+
+	addresses.push_back(pc);
+	current = pc;
+	for (int i = 0; i < after; ++i) {
+		current = static_cast<Address>(current + instruction_size(bus.peek(current)));
+		addresses.push_back(current);
+	}
+	return addresses;
+}
+
+bool DisassemblyCache::is_instruction_start(const SystemBus &bus, Address address) {
+	bind(bus);
+	return flags_at(bus, address) != 0;
+}
+
+bool DisassemblyCache::was_executed(const SystemBus &bus, Address address) {
+	bind(bus);
+	return (flags_at(bus, address) & EXECUTED) != 0;
+}
+
+} // namespace nes
@@ -0,0 +1,449 @@
+#include "cpu/static_disassembler.hpp"
+#include "cartridge/code_data_logger.hpp"
+#include <algorithm>
+#include <array>
+#include <format>
+#include <map>
+#include <utility>
+
+namespace nes {
+
+namespace {
+
+constexpr std::size_t BYTES_PER_DATA_LINE = 8;
+constexpr std::size_t LISTING_COLUMN = 32; // Where the address comments start
+
+struct RegisterName {
+	Address address;
+	std::string_view name;
+};
+
+constexpr std::array<RegisterName, 30> REGISTER_NAMES = {{
+	{0x2000, "PPUCTRL"},	{0x2001, "PPUMASK"},   {0x2002, "PPUSTATUS"}, {0x2003, "OAMADDR"},	 {0x2004, "OAMDATA"},
+	{0x2005, "PPUSCROLL"},	{0x2006, "PPUADDR"},   {0x2007, "PPUDATA"},	  {0x4000, "SQ1_VOL"},	 {0x4001, "SQ1_SWEEP"},
+	{0x4002, "SQ1_LO"},		{0x4003, "SQ1_HI"},	   {0x4004, "SQ2_VOL"},	  {0x4005, "SQ2_SWEEP"}, {0x4006, "SQ2_LO"},
+	{0x4007, "SQ2_HI"},		{0x4008, "TRI_LINEAR"}, {0x400A, "TRI_LO"},	  {0x400B, "TRI_HI"},	 {0x400C, "NOISE_VOL"},
+	{0x400E, "NOISE_LO"},	{0x400F, "NOISE_HI"},  {0x4010, "DMC_FREQ"},  {0x4011, "DMC_RAW"},	 {0x4012, "DMC_START"},
+	{0x4013, "DMC_LEN"},	{0x4014, "OAMDMA"},	   {0x4015, "SND_CHN"},	  {0x4016, "JOY1"},		 {0x4017, "JOY2"},
+}};
+
+// Vectors at the top of the $E000 window, in bank offsets
+struct VectorSlot {
+	std::uint16_t offset;
+	std::string_view name;
+};
+constexpr std::array<VectorSlot, 3> VECTORS = {{{0x1FFA, "nmi"}, {0x1FFC, "reset"}, {0x1FFE, "irq"}}};
+
+constexpr bool is_logged_data_only(Byte flags) noexcept {
+	return (flags & (CodeDataLogger::PRG_DATA | CodeDataLogger::PRG_PCM)) && !(flags & CodeDataLogger::PRG_CODE);
+}
+
+constexpr bool in_window(const StaticDisassembler::Bank &bank, Address address) noexcept {
+	return address >= bank.cpu_base &&
+		   static_cast<std::size_t>(address - bank.cpu_base) < StaticDisassembler::BANK_SIZE;
+}
+
+constexpr bool ends_flow(InstructionFlow flow) noexcept {
+	return flow == InstructionFlow::Jump || flow == InstructionFlow::IndirectJump ||
+		   flow == InstructionFlow::Return || flow == InstructionFlow::Break;
+}
+
+std::string json_string(std::string_view text) {
+	std::string out = "\"";
+	for (const char c : text) {
+		if (c == '"' || c == '\\') {
+			out += '\\';
+			out += c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			out += std::format("\\u{:04x}", static_cast<unsigned>(c));
+		} else {
+			out += c;
+		}
+	}
+	return out + '"';
+}
+
+// A listing line with its comment lined up after it
+void append_line(std::string &text, std::string_view line, std::string_view comment) {
+	text += line;
+	text.append(line.size() < LISTING_COLUMN ? LISTING_COLUMN - line.size() : 1, ' ');
+	text += comment;
+	text += '\n';
+}
+
+std::string_view kind_name(StaticDisassembler::SymbolKind kind) noexcept {
+	switch (kind) {
+	case StaticDisassembler::SymbolKind::Vector:
+		return "vector";
+	case StaticDisassembler::SymbolKind::Subroutine:
+		return "subroutine";
+	case StaticDisassembler::SymbolKind::Label:
+		return "label";
+	}
+	return "label";
+}
+
+} // namespace
+
+StaticDisassembler::StaticDisassembler(std::span<const Byte> prg, std::span<const Byte> cdl)
+	: prg_(prg.begin(), prg.end()), cdl_(cdl) {
+	prg_.resize((prg_.size() + BANK_SIZE - 1) / BANK_SIZE * BANK_SIZE, 0xFF);
+	banks_.resize(prg_.size() / BANK_SIZE);
+	place_banks();
+	for (BankState &bank : banks_) {
+		bank.marks.assign(BANK_SIZE, 0);
+		seed_bank(bank);
+	}
+}
+
+void StaticDisassembler::place_banks() {
+	const std::size_t count = banks_.size();
+	for (std::size_t index = 0; index < count; ++index) {
+		Bank &info = banks_[index].info;
+		info.prg_offset = static_cast<std::uint32_t>(index * BANK_SIZE);
+
+		// The window most logged bytes were seen through
+		std::array<std::size_t, 4> seen{};
+		for (std::uint32_t offset = info.prg_offset; offset < info.prg_offset + BANK_SIZE; ++offset) {
+			const Byte flags = cdl_at(offset);
+			if (flags & (CodeDataLogger::PRG_CODE | CodeDataLogger::PRG_DATA | CodeDataLogger::PRG_PCM)) {
+				++seen[(flags >> 2) & 0x03];
+			}
+		}
+		const auto most = std::max_element(seen.begin(), seen.end());
+		if (*most > 0) {
+			info.cpu_base = static_cast<Address>(0x8000 + (most - seen.begin()) * BANK_SIZE);
+			info.base_from_cdl = true;
+		} else if (count <= 4) {
+			info.cpu_base = static_cast<Address>(0x10000 - (count - index) * BANK_SIZE);
+		} else if (index + 2 >= count) {
+			info.cpu_base = index + 1 == count ? 0xE000 : 0xC000;
+		} else {
+			info.cpu_base = (index & 1) ? 0xA000 : 0x8000;
+		}
+		if (info.cpu_base == 0xE000) {
+			++vector_banks_;
+		}
+	}
+}
+
+void StaticDisassembler::seed_bank(BankState &bank) {
+	// Every run of logged code starts an instruction
+	bool in_code = false;
+	for (std::uint16_t offset = 0; offset < BANK_SIZE; ++offset) {
+		const bool code = cdl_at(bank.info.prg_offset + offset) & CodeDataLogger::PRG_CODE;
+		if (code && !in_code) {
+			bank.pending.push_back(offset);
+		}
+		in_code = code;
+	}
+
+	if (bank.info.cpu_base != 0xE000) {
+		return;
+	}
+	for (const VectorSlot &vector : VECTORS) {
+		const std::uint32_t at = bank.info.prg_offset + vector.offset;
+		const auto target = static_cast<Address>(prg_[at] | (prg_[at + 1] << 8));
+		if (target >= bank.info.cpu_base) {
+			bank.pending.push_back(static_cast<std::uint16_t>(target - bank.info.cpu_base));
+		} else {
+			bank.references.push_back({target, InstructionFlow::Jump}); // Elsewhere: link() takes it there
+		}
+	}
+}
+
+void StaticDisassembler::trace_bank(std::size_t index) {
+	BankState &bank = banks_[index];
+	std::vector<std::uint16_t> work;
+	work.swap(bank.pending);
+	std::reverse(work.begin(), work.end()); // Taken from the back, lowest first
+	std::vector<std::uint16_t> guesses; // Unlogged entry points, for after the logged code
+
+	const auto walk = [&](std::vector<std::uint16_t> &entries, bool logged_only) {
+		while (!entries.empty()) {
+			std::uint32_t offset = entries.back();
+			entries.pop_back();
+			while (offset < BANK_SIZE && !(bank.marks[offset] & START)) {
+				const Byte flags = cdl_at(bank.info.prg_offset + offset);
+				if (logged_only && !(flags & CodeDataLogger::PRG_CODE)) {
+					guesses.push_back(static_cast<std::uint16_t>(offset));
+					break;
+				}
+				const Instruction instruction = decode_at(bank, offset);
+				if (instruction.flow == InstructionFlow::Halt || offset + instruction.length > BANK_SIZE) {
+					break;
+				}
+				// Stop where this stream would overlap known code or logged data
+				bool clash = false;
+				for (std::uint32_t i = 0; i < instruction.length; ++i) {
+					clash = clash || (bank.marks[offset + i] & (START | OPERAND)) ||
+							is_logged_data_only(cdl_at(bank.info.prg_offset + offset + i));
+				}
+				if (clash) {
+					break;
+				}
+
+				bank.marks[offset] |= START;
+				for (std::uint32_t i = 1; i < instruction.length; ++i) {
+					bank.marks[offset + i] |= OPERAND;
+				}
+				bank.info.code_bytes += instruction.length;
+
+				if (instruction.flow == InstructionFlow::Branch || instruction.flow == InstructionFlow::Jump ||
+					instruction.flow == InstructionFlow::Call) {
+					const Address target = instruction.address();
+					bank.references.push_back({target, instruction.flow});
+					if (in_window(bank.info, target)) {
+						entries.push_back(static_cast<std::uint16_t>(target - bank.info.cpu_base));
+					}
+				}
+
+				offset += instruction.length;
+				if (ends_flow(instruction.flow)) {
+					// Logged code right after a jump is another routine
+					if (offset < BANK_SIZE && (cdl_at(bank.info.prg_offset + offset) & CodeDataLogger::PRG_CODE)) {
+						entries.push_back(static_cast<std::uint16_t>(offset));
+					}
+					break;
+				}
+			}
+		}
+	};
+
+	// Logged code first, so a guess from an untaken branch cannot claim
+	// bytes the CPU ran
+	walk(work, !cdl_.empty());
+	walk(guesses, false);
+}
+
+Instruction StaticDisassembler::decode_at(const BankState &bank, std::uint32_t offset) const noexcept {
+	const Byte *bytes = prg_.data() + bank.info.prg_offset;
+	return decode_instruction(static_cast<Address>(bank.info.cpu_base + offset), bytes[offset],
+							  offset + 1 < BANK_SIZE ? bytes[offset + 1] : Byte{0},
+							  offset + 2 < BANK_SIZE ? bytes[offset + 2] : Byte{0});
+}
+
+std::int64_t StaticDisassembler::resolve(std::size_t bank, Address address) const noexcept {
+	const Bank &own = banks_[bank].info;
+	if (in_window(own, address)) {
+		return own.prg_offset + (address - own.cpu_base);
+	}
+	if (address < 0x8000) {
+		return -1;
+	}
+	std::int64_t found = -1;
+	for (const BankState &other : banks_) {
+		if (in_window(other.info, address)) {
+			if (found >= 0) {
+				return -1; // Shared window: which bank is mapped depends on the game
+			}
+			found = other.info.prg_offset + (address - other.info.cpu_base);
+		}
+	}
+	return found;
+}
+
+std::vector<std::size_t> StaticDisassembler::link() {
+	std::vector<std::size_t> seeded;
+	for (std::size_t index = 0; index < banks_.size(); ++index) {
+		BankState &bank = banks_[index];
+		for (; bank.linked < bank.references.size(); ++bank.linked) {
+			const Address target = bank.references[bank.linked].target;
+			if (in_window(bank.info, target)) {
+				continue; // Traced with the bank
+			}
+			const std::int64_t offset = resolve(index, target);
+			if (offset < 0) {
+				continue;
+			}
+			const auto target_bank = static_cast<std::size_t>(offset) / BANK_SIZE;
+			const auto target_offset = static_cast<std::uint16_t>(offset % BANK_SIZE);
+			std::uint8_t &mark = banks_[target_bank].marks[target_offset];
+			if (!(mark & (START | SEEDED))) {
+				mark |= SEEDED;
+				banks_[target_bank].pending.push_back(target_offset);
+				seeded.push_back(target_bank);
+			}
+		}
+	}
+	std::sort(seeded.begin(), seeded.end());
+	seeded.erase(std::unique(seeded.begin(), seeded.end()), seeded.end());
+	return seeded;
+}
+
+void StaticDisassembler::resolve_symbols() {
+	std::map<std::uint32_t, Symbol> found; // By PRG offset, for PRG order
+	const auto add = [&](std::int64_t offset, SymbolKind kind) -> Symbol * {
+		if (offset < 0 || !is_instruction_start(static_cast<std::uint32_t>(offset))) {
+			return nullptr;
+		}
+		const auto [entry, created] = found.try_emplace(static_cast<std::uint32_t>(offset));
+		Symbol &symbol = entry->second;
+		if (created) {
+			symbol.kind = kind;
+			symbol.prg_offset = static_cast<std::uint32_t>(offset);
+			symbol.bank = symbol.prg_offset / BANK_SIZE;
+			symbol.address = static_cast<Address>(banks_[symbol.bank].info.cpu_base + symbol.prg_offset % BANK_SIZE);
+		}
+		symbol.kind = std::min(symbol.kind, kind); // A vector outranks a call, a call a jump
+		return &symbol;
+	};
+
+	for (std::size_t index = 0; index < banks_.size(); ++index) {
+		for (const Reference &reference : banks_[index].references) {
+			const SymbolKind kind =
+				reference.flow == InstructionFlow::Call ? SymbolKind::Subroutine : SymbolKind::Label;
+			if (Symbol *symbol = add(resolve(index, reference.target), kind)) {
+				++symbol->references;
+			}
+		}
+	}
+	for (std::size_t index = 0; index < banks_.size(); ++index) {
+		const Bank &info = banks_[index].info;
+		if (info.cpu_base != 0xE000) {
+			continue;
+		}
+		for (const VectorSlot &vector : VECTORS) {
+			const std::uint32_t at = info.prg_offset + vector.offset;
+			const auto target = static_cast<Address>(prg_[at] | (prg_[at + 1] << 8));
+			Symbol *symbol = add(resolve(index, target), SymbolKind::Vector);
+			if (symbol && symbol->name.empty()) {
+				symbol->name =
+					vector_banks_ > 1 ? std::format("{}_{:02X}", vector.name, index) : std::string(vector.name);
+			}
+		}
+	}
+
+	symbols_.clear();
+	symbol_index_.clear();
+	for (auto &[offset, symbol] : found) {
+		if (symbol.name.empty()) {
+			symbol.name = std::format("{}_{:02X}_{:04X}", symbol.kind == SymbolKind::Subroutine ? "sub" : "loc",
+									  symbol.bank, symbol.address);
+		}
+		symbol_index_[offset] = symbols_.size();
+		symbols_.push_back(std::move(symbol));
+	}
+}
+
+void StaticDisassembler::run() {
+	for (std::size_t index = 0; index < banks_.size(); ++index) {
+		trace_bank(index);
+	}
+	for (std::vector<std::size_t> seeded = link(); !seeded.empty(); seeded = link()) {
+		for (const std::size_t index : seeded) {
+			trace_bank(index);
+		}
+	}
+	resolve_symbols();
+}
+
+bool StaticDisassembler::is_instruction_start(std::uint32_t prg_offset) const noexcept {
+	const std::size_t bank = prg_offset / BANK_SIZE;
+	return bank < banks_.size() && (banks_[bank].marks[prg_offset % BANK_SIZE] & START);
+}
+
+const StaticDisassembler::Symbol *StaticDisassembler::symbol_at(std::uint32_t prg_offset) const noexcept {
+	const auto found = symbol_index_.find(prg_offset);
+	return found == symbol_index_.end() ? nullptr : &symbols_[found->second];
+}
+
+std::string_view StaticDisassembler::register_name(Address address) noexcept {
+	for (const RegisterName &entry : REGISTER_NAMES) {
+		if (entry.address == address) {
+			return entry.name;
+		}
+	}
+	return {};
+}
+
+std::string StaticDisassembler::operand_label(std::size_t bank, const Instruction &instruction) const {
+	if (!instruction.has_address()) {
+		return {};
+	}
+	const bool absolute = instruction.mode == AddressingMode::Absolute ||
+						  instruction.mode == AddressingMode::AbsoluteX || instruction.mode == AddressingMode::AbsoluteY;
+	if (absolute || instruction.mode == AddressingMode::Relative) {
+		const std::int64_t offset = resolve(bank, instruction.address());
+		if (const Symbol *symbol = offset >= 0 ? symbol_at(static_cast<std::uint32_t>(offset)) : nullptr) {
+			return symbol->name;
+		}
+	}
+	return absolute ? std::string(register_name(instruction.address())) : std::string();
+}
+
+std::string StaticDisassembler::listing_header() const {
+	std::string text = std::format("; PRG ROM: {} KB in {} banks of 8 KB, code traced from {}\n", prg_.size() / 1024,
+								   banks_.size(), cdl_.empty() ? "the vectors" : "the code/data log and the vectors");
+	text += ".setcpu \"6502X\" ; Unofficial opcodes\n\n";
+	for (const RegisterName &entry : REGISTER_NAMES) {
+		text += std::format("{:<11}= ${:04X}\n", entry.name, entry.address);
+	}
+	return text;
+}
+
+std::string StaticDisassembler::listing(std::size_t index) const {
+	const BankState &bank = banks_[index];
+	const Byte *bytes = prg_.data() + bank.info.prg_offset;
+	std::string text = std::format("\n; Bank {:02X}: PRG ${:06X}-${:06X} at ${:04X} ({})\n.org ${:04X}\n", index,
+								   bank.info.prg_offset, bank.info.prg_offset + BANK_SIZE - 1, bank.info.cpu_base,
+								   bank.info.base_from_cdl ? "window from the log" : "window guessed",
+								   bank.info.cpu_base);
+
+	std::uint32_t offset = 0;
+	while (offset < BANK_SIZE) {
+		const auto address = static_cast<Address>(bank.info.cpu_base + offset);
+		if (bank.marks[offset] & START) {
+			if (const Symbol *symbol = symbol_at(bank.info.prg_offset + offset)) {
+				text += std::format("\n{}:\n", symbol->name);
+			}
+			const Instruction instruction = decode_at(bank, offset);
+			const std::string line =
+				std::format("\t{}", format_instruction(instruction, operand_label(index, instruction)));
+			std::string comment = std::format("; ${:04X} ", address);
+			for (std::uint8_t i = 0; i < instruction.length; ++i) {
+				comment += std::format(" {:02X}", instruction.bytes[i]);
+			}
+			append_line(text, line, comment);
+			offset += instruction.length;
+			continue;
+		}
+
+		// Data up to the next instruction, a line at a time
+		std::string line = "\t.byte ";
+		const std::uint32_t start = offset;
+		do {
+			line += std::format("{}${:02X}", offset == start ? "" : ",", bytes[offset]);
+			++offset;
+		} while (offset < BANK_SIZE && !(bank.marks[offset] & START) && offset % BYTES_PER_DATA_LINE != 0);
+		append_line(text, line, std::format("; ${:04X}", address));
+	}
+	return text;
+}
+
+std::string StaticDisassembler::symbols_json(std::string_view rom_name) const {
+	std::string json = "{\n";
+	json += std::format("  \"rom\": {},\n", json_string(rom_name));
+	json += std::format("  \"prg_size\": {},\n", prg_.size());
+	json += std::format("  \"cdl\": {},\n", cdl_.empty() ? "false" : "true");
+	json += "  \"banks\": [";
+	for (std::size_t index = 0; index < banks_.size(); ++index) {
+		const Bank &info = banks_[index].info;
+		json += std::format("{}\n    {{\"bank\": {}, \"prg_offset\": {}, \"cpu_address\": {}, \"window_from_cdl\": {}, "
+							"\"code_bytes\": {}}}",
+							index ? "," : "", index, info.prg_offset, info.cpu_base,
+							info.base_from_cdl ? "true" : "false", info.code_bytes);
+	}
+	json += "\n  ],\n  \"symbols\": [";
+	for (std::size_t index = 0; index < symbols_.size(); ++index) {
+		const Symbol &symbol = symbols_[index];
+		json += std::format("{}\n    {{\"name\": {}, \"kind\": \"{}\", \"bank\": {}, \"cpu_address\": {}, "
+							"\"prg_offset\": {}, \"references\": {}}}",
+							index ? "," : "", json_string(symbol.name), kind_name(symbol.kind), symbol.bank,
+							symbol.address, symbol.prg_offset, symbol.references);
+	}
+	json += "\n  ]\n}\n";
+	return json;
+}
+
+} // namespace nes
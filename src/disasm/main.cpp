@@ -0,0 +1,263 @@
+// VibeNES_Disasm - static disassembly of whole ROMs, bank by bank.
+//
+// Usage: VibeNES_Disasm <rom.nes | directory>... [--output DIR] [--cdl FILE]
+//                       [--cdl-dir DIR] [--threads T]
+//
+// Every PRG bank of every ROM (directories are searched for .nes files) is
+// traced and listed with the same decoder the debugger's disassembler uses
+// (StaticDisassembler). A code/data log makes the result far better: give
+// one with --cdl for a single ROM, or put <name>.cdl next to each ROM or in
+// --cdl-dir. Without one, code is only found from the vectors.
+//
+// For each ROM, DIR/<name>.asm holds the labelled listing (ca65 syntax) and
+// DIR/<name>.json the bank layout and symbol map. DIR defaults to the
+// current directory.
+//
+// Banks are the unit of work: the banks of a group of ROMs are traced on T
+// worker threads (by default one per hardware thread), linked, listed and
+// written, then the next group is loaded, so memory stays bounded however
+// large the library is. One line per ROM is printed, then the totals.
+
+#include "cartridge/code_data_logger.hpp"
+#include "cartridge/rom_image.hpp"
+#include "cpu/static_disassembler.hpp"
+#include "system/batch_runner.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RomJob {
+	std::filesystem::path rom_path;
+	std::filesystem::path cdl_path; // Empty: none
+	std::shared_ptr<const nes::RomImage> image;
+	nes::CodeDataLogger cdl;
+	bool has_cdl = false;
+	std::unique_ptr<nes::StaticDisassembler> disassembler;
+	std::vector<std::string> listings; // Per bank
+	std::string error;
+};
+
+void print_usage(const char *program) {
+	std::cerr << "Usage: " << program
+			  << " <rom.nes | directory>... [--output DIR] [--cdl FILE] [--cdl-dir DIR] [--threads T]\n";
+}
+
+bool is_rom_file(const std::filesystem::path &path) {
+	std::string extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(),
+				   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return extension == ".nes";
+}
+
+void collect_roms(const std::filesystem::path &path, std::vector<std::filesystem::path> &roms) {
+	std::error_code error;
+	if (!std::filesystem::is_directory(path, error)) {
+		roms.push_back(path);
+		return;
+	}
+	std::vector<std::filesystem::path> found;
+	for (const auto &entry : std::filesystem::recursive_directory_iterator(path, error)) {
+		if (entry.is_regular_file(error) && is_rom_file(entry.path())) {
+			found.push_back(entry.path());
+		}
+	}
+	std::sort(found.begin(), found.end());
+	roms.insert(roms.end(), found.begin(), found.end());
+}
+
+std::filesystem::path find_cdl(const std::filesystem::path &rom, const std::string &cdl_dir) {
+	std::error_code error;
+	std::filesystem::path beside = rom;
+	beside.replace_extension(".cdl");
+	if (!cdl_dir.empty()) {
+		const std::filesystem::path in_dir = std::filesystem::path(cdl_dir) / beside.filename();
+		if (std::filesystem::exists(in_dir, error)) {
+			return in_dir;
+		}
+	}
+	return std::filesystem::exists(beside, error) ? beside : std::filesystem::path();
+}
+
+// Load the ROM and its log, ready to trace
+void prepare(RomJob &job) {
+	job.image = nes::RomImage::load(job.rom_path.string());
+	if (!job.image) {
+		job.error = "not an iNES ROM";
+		return;
+	}
+	if (job.image->prg_rom().empty()) {
+		job.error = "no PRG ROM";
+		return;
+	}
+	if (!job.cdl_path.empty()) {
+		job.cdl.attach(job.image->prg_rom(), job.image->chr_rom());
+		if (!job.cdl.load(job.cdl_path)) {
+			job.error = "code/data log " + job.cdl_path.string() + " does not match";
+			return;
+		}
+		job.has_cdl = true;
+	}
+	job.disassembler = std::make_unique<nes::StaticDisassembler>(
+		job.image->prg_rom(), job.has_cdl ? job.cdl.prg_log() : std::span<const nes::Byte>{});
+	job.listings.resize(job.disassembler->bank_count());
+}
+
+bool write_outputs(RomJob &job, const std::filesystem::path &output_dir) {
+	const std::string name = job.rom_path.stem().string();
+	std::ofstream assembly(output_dir / (name + ".asm"));
+	assembly << "; " << job.rom_path.filename().string() << "\n" << job.disassembler->listing_header();
+	for (const std::string &listing : job.listings) {
+		assembly << listing;
+	}
+	std::ofstream symbols(output_dir / (name + ".json"));
+	symbols << job.disassembler->symbols_json(job.rom_path.filename().string());
+	return static_cast<bool>(assembly) && static_cast<bool>(symbols);
+}
+
+// Trace, link, list and write one group of ROMs, banks spread over the pool
+void disassemble_group(std::vector<RomJob> &group, nes::BatchRunner &runner,
+					   const std::filesystem::path &output_dir) {
+	std::vector<nes::BatchRunner::Job> jobs;
+	for (RomJob &job : group) {
+		if (job.disassembler) {
+			for (std::size_t bank = 0; bank < job.disassembler->bank_count(); ++bank) {
+				jobs.push_back([&job, bank] { job.disassembler->trace_bank(bank); });
+			}
+		}
+	}
+	while (!jobs.empty()) {
+		runner.run(std::move(jobs));
+		jobs.clear();
+		// Entry points found in other banks (calls into the fixed bank)
+		for (RomJob &job : group) {
+			if (job.disassembler) {
+				for (const std::size_t bank : job.disassembler->link()) {
+					jobs.push_back([&job, bank] { job.disassembler->trace_bank(bank); });
+				}
+			}
+		}
+	}
+
+	for (RomJob &job : group) {
+		if (job.disassembler) {
+			job.disassembler->resolve_symbols();
+			for (std::size_t bank = 0; bank < job.disassembler->bank_count(); ++bank) {
+				jobs.push_back([&job, bank] { job.listings[bank] = job.disassembler->listing(bank); });
+			}
+		}
+	}
+	runner.run(std::move(jobs));
+	jobs.clear();
+
+	for (RomJob &job : group) {
+		if (job.disassembler) {
+			jobs.push_back([&job, &output_dir] {
+				if (!write_outputs(job, output_dir)) {
+					job.error = "cannot write to " + output_dir.string();
+				}
+			});
+		}
+	}
+	runner.run(std::move(jobs));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	std::vector<std::filesystem::path> roms;
+	std::string output_dir = ".";
+	std::string cdl_file;
+	std::string cdl_dir;
+	long threads = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--output" && i + 1 < argc) {
+			output_dir = argv[++i];
+		} else if (arg == "--cdl" && i + 1 < argc) {
+			cdl_file = argv[++i];
+		} else if (arg == "--cdl-dir" && i + 1 < argc) {
+			cdl_dir = argv[++i];
+		} else if (arg == "--threads" && i + 1 < argc) {
+			threads = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--help" || arg == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else if (!arg.starts_with("--")) {
+			collect_roms(arg, roms);
+		} else {
+			print_usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (roms.empty() || threads < 0 || (!cdl_file.empty() && roms.size() != 1)) {
+		print_usage(argv[0]);
+		return 2;
+	}
+	std::error_code error;
+	std::filesystem::create_directories(output_dir, error);
+
+	nes::BatchRunner runner(static_cast<unsigned>(threads));
+	// Enough ROMs in flight to keep every worker busy through the serial
+	// link steps, few enough that a big library is not held in memory
+	const std::size_t group_size = std::max<std::size_t>(runner.thread_count() * 4, 8);
+
+	int status = 0;
+	std::size_t banks = 0;
+	std::size_t symbols = 0;
+	std::size_t failures = 0;
+	const auto start = Clock::now();
+	for (std::size_t first = 0; first < roms.size(); first += group_size) {
+		std::vector<RomJob> group(std::min(group_size, roms.size() - first));
+		for (std::size_t i = 0; i < group.size(); ++i) {
+			group[i].rom_path = roms[first + i];
+			group[i].cdl_path = cdl_file.empty() ? find_cdl(group[i].rom_path, cdl_dir)
+													: std::filesystem::path(cdl_file);
+			prepare(group[i]);
+		}
+		disassemble_group(group, runner, output_dir);
+
+		for (const RomJob &job : group) {
+			std::cout << job.rom_path.string();
+			if (!job.error.empty()) {
+				std::cout << " failed: " << job.error << "\n";
+				status = 1;
+				++failures;
+				continue;
+			}
+			const nes::StaticDisassembler &disassembler = *job.disassembler;
+			std::size_t code_bytes = 0;
+			for (std::size_t bank = 0; bank < disassembler.bank_count(); ++bank) {
+				code_bytes += disassembler.bank(bank).code_bytes;
+			}
+			const std::size_t prg_size = disassembler.bank_count() * nes::StaticDisassembler::BANK_SIZE;
+			std::cout << " banks: " << disassembler.bank_count() << " code: " << (code_bytes * 100 / prg_size) << "%"
+					  << " symbols: " << disassembler.symbols().size() << (job.has_cdl ? " (cdl)" : "") << "\n";
+			banks += disassembler.bank_count();
+			symbols += disassembler.symbols().size();
+		}
+	}
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::cout << "roms: " << roms.size() << "\n";
+	std::cout << "failed: " << failures << "\n";
+	std::cout << "banks: " << banks << "\n";
+	std::cout << "symbols: " << symbols << "\n";
+	std::cout << "threads: " << runner.thread_count() << "\n";
+	std::cout << "seconds: " << seconds << "\n";
+	return status;
+}
@@ -1,6 +1,15 @@
 #include "gui/crt_filter.hpp"
+#include "core/checksum.hpp"
+#include "core/trace_zones.hpp"
+#include "ppu/ppu.hpp"
 #include <SDL3/SDL.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
 
 // ─── OpenGL extension constants (not in Windows gl.h which is GL 1.1) ───────
 #ifndef GL_FRAGMENT_SHADER
@@ -39,6 +48,57 @@
 #ifndef GL_FRAMEBUFFER_BINDING
 #define GL_FRAMEBUFFER_BINDING 0x8CA6
 #endif
+#ifndef GL_TEXTURE1
+#define GL_TEXTURE1 0x84C1
+#endif
+#ifndef GL_R16UI
+#define GL_R16UI 0x8234
+#endif
+#ifndef GL_RED_INTEGER
+#define GL_RED_INTEGER 0x8D94
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
 
 // ─── GL extension function pointer types (loaded at runtime via SDL) ────────
 // Shader
@@ -81,6 +141,24 @@ using PFN_glFramebufferTexture2D = void(APIENTRY *)(unsigned int, unsigned int,
 using PFN_glCheckFramebufferStatus = unsigned int(APIENTRY *)(unsigned int);
 // Misc
 using PFN_glActiveTexture = void(APIENTRY *)(unsigned int);
+// Frame upload streaming (optional: GL 3.0 mapping, GL 3.2 sync, GL 4.4 / ARB_buffer_storage)
+using PFN_glMapBufferRange = void *(APIENTRY *)(unsigned int, ptrdiff_t, ptrdiff_t, unsigned int);
+using PFN_glUnmapBuffer = unsigned char(APIENTRY *)(unsigned int);
+using PFN_glBufferStorage = void(APIENTRY *)(unsigned int, ptrdiff_t, const void *, unsigned int);
+using PFN_glFenceSync = void *(APIENTRY *)(unsigned int, unsigned int);
+using PFN_glClientWaitSync = unsigned int(APIENTRY *)(void *, unsigned int, uint64_t);
+using PFN_glDeleteSync = void(APIENTRY *)(void *);
+// Program binary cache (optional: GL 4.1 / ARB_get_program_binary)
+using PFN_glProgramParameteri = void(APIENTRY *)(unsigned int, unsigned int, int);
+using PFN_glGetProgramBinary = void(APIENTRY *)(unsigned int, int, int *, unsigned int *, void *);
+using PFN_glProgramBinary = void(APIENTRY *)(unsigned int, unsigned int, const void *, int);
+// GPU pass timing (optional: GL 3.3 / ARB_timer_query)
+using PFN_glGenQueries = void(APIENTRY *)(int, unsigned int *);
+using PFN_glDeleteQueries = void(APIENTRY *)(int, const unsigned int *);
+using PFN_glBeginQuery = void(APIENTRY *)(unsigned int, unsigned int);
+using PFN_glEndQuery = void(APIENTRY *)(unsigned int);
+using PFN_glGetQueryObjectiv = void(APIENTRY *)(unsigned int, unsigned int, int *);
+using PFN_glGetQueryObjectui64v = void(APIENTRY *)(unsigned int, unsigned int, uint64_t *);
 
 // ─── GL function pointer instances ──────────────────────────────────────────
 namespace {
@@ -120,6 +198,21 @@ CRT_GL_FUNC(glBindFramebuffer);
 CRT_GL_FUNC(glFramebufferTexture2D);
 CRT_GL_FUNC(glCheckFramebufferStatus);
 CRT_GL_FUNC(glActiveTexture);
+CRT_GL_FUNC(glMapBufferRange);
+CRT_GL_FUNC(glUnmapBuffer);
+CRT_GL_FUNC(glBufferStorage);
+CRT_GL_FUNC(glFenceSync);
+CRT_GL_FUNC(glClientWaitSync);
+CRT_GL_FUNC(glDeleteSync);
+CRT_GL_FUNC(glProgramParameteri);
+CRT_GL_FUNC(glGetProgramBinary);
+CRT_GL_FUNC(glProgramBinary);
+CRT_GL_FUNC(glGenQueries);
+CRT_GL_FUNC(glDeleteQueries);
+CRT_GL_FUNC(glBeginQuery);
+CRT_GL_FUNC(glEndQuery);
+CRT_GL_FUNC(glGetQueryObjectiv);
+CRT_GL_FUNC(glGetQueryObjectui64v);
 
 #undef CRT_GL_FUNC
 
@@ -209,6 +302,22 @@ void main() {
 }
 )glsl";
 
+// Index frame -> RGBA. Drawn into a 256x240 target, so each fragment is one
+// NES pixel; entries are exact integers and never filtered.
+const char *kPaletteFragmentShader = R"glsl(
+#version 130
+
+out vec4 fragColor;
+
+uniform usampler2D uIndices; // color in bits 0-5, emphasis in bits 6-8
+uniform sampler2D uPalette;  // 64x8: x = color, y = emphasis
+
+void main() {
+    uint entry = texelFetch(uIndices, ivec2(gl_FragCoord.xy), 0).r;
+    fragColor = texelFetch(uPalette, ivec2(int(entry & 63u), int((entry >> 6u) & 7u)), 0);
+}
+)glsl";
+
 // Fullscreen quad vertex data: position (x,y) + texcoord (u,v)
 // UV layout: GL bottom (NDC y=-1) -> V=0 -> first row of NES texture
 // This matches ImGui::Image convention where UV(0,0) = top-left of display
@@ -222,6 +331,108 @@ const float kQuadVerts[] = {
 };
 // clang-format on
 
+// Compile and link a vertex + fragment pair; 0 on failure (logged).
+// retrievable asks the driver to keep the binary for glGetProgramBinary.
+unsigned int build_program(const char *vertex_source, const char *fragment_source, bool retrievable) {
+	// Helper: compile a single shader stage
+	auto compile_shader = [](unsigned int type, const char *source) -> unsigned int {
+		unsigned int shader = glCreateShader_(type);
+		glShaderSource_(shader, 1, &source, nullptr);
+		glCompileShader_(shader);
+
+		int success = 0;
+		glGetShaderiv_(shader, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			char log[1024];
+			glGetShaderInfoLog_(shader, sizeof(log), nullptr, log);
+			fprintf(stderr, "CRT shader compile error: %s\n", log);
+			glDeleteShader_(shader);
+			return 0;
+		}
+		return shader;
+	};
+
+	unsigned int vs = compile_shader(GL_VERTEX_SHADER, vertex_source);
+	if (!vs)
+		return 0;
+
+	unsigned int fs = compile_shader(GL_FRAGMENT_SHADER, fragment_source);
+	if (!fs) {
+		glDeleteShader_(vs);
+		return 0;
+	}
+
+	unsigned int program = glCreateProgram_();
+	glAttachShader_(program, vs);
+	glAttachShader_(program, fs);
+
+	// Bind attribute locations before linking (GLSL 130 lacks layout qualifiers)
+	glBindAttribLocation_(program, 0, "aPos");
+	glBindAttribLocation_(program, 1, "aTexCoord");
+	if (retrievable) {
+		glProgramParameteri_(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	glLinkProgram_(program);
+
+	// Shaders can be deleted after linking
+	glDeleteShader_(vs);
+	glDeleteShader_(fs);
+
+	int success = 0;
+	glGetProgramiv_(program, GL_LINK_STATUS, &success);
+	if (!success) {
+		char log[1024];
+		glGetProgramInfoLog_(program, sizeof(log), nullptr, log);
+		fprintf(stderr, "CRT shader link error: %s\n", log);
+		glDeleteProgram_(program);
+		return 0;
+	}
+	return program;
+}
+
+// Program binary cache file: header, then the driver's binary. A binary is
+// only valid for the driver that produced it, so the key hashes the GL
+// renderer and version strings along with the shader sources.
+constexpr uint32_t PROGRAM_CACHE_MAGIC = 0x4250'4E56; // "VNPB"
+
+struct ProgramCacheHeader {
+	uint32_t magic;
+	uint32_t key;
+	uint32_t format; // glGetProgramBinary's binaryFormat
+	uint32_t length;
+};
+
+uint32_t program_cache_key(const char *vertex_source, const char *fragment_source) {
+	uint32_t key = 0;
+	for (const char *text : {reinterpret_cast<const char *>(glGetString(GL_RENDERER)),
+							 reinterpret_cast<const char *>(glGetString(GL_VERSION)), vertex_source,
+							 fragment_source}) {
+		if (text) {
+			key = nes::crc32(reinterpret_cast<const uint8_t *>(text), std::strlen(text), key);
+		}
+	}
+	return key;
+}
+
+// Bind the fullscreen quad and draw it. The VBO and vertex attributes are
+// re-specified every time rather than relying solely on the stored VAO
+// state: ImGui's GL backend rebinds the array buffer and vertex-attrib state
+// every frame, and in a CORE profile a stale/empty array-buffer binding makes
+// glDrawArrays dereference a client-side pointer (offset 0/8) and crash.
+void draw_quad(unsigned int vao, unsigned int vbo) {
+	glBindVertexArray_(vao);
+	glBindBuffer_(GL_ARRAY_BUFFER, vbo);
+	glVertexAttribPointer_(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
+	glEnableVertexAttribArray_(0);
+	glVertexAttribPointer_(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+						   reinterpret_cast<const void *>(2 * sizeof(float)));
+	glEnableVertexAttribArray_(1);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glBindBuffer_(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray_(0);
+}
+
 } // anonymous namespace
 
 namespace nes::gui {
@@ -232,6 +443,16 @@ CRTFilter::~CRTFilter() {
 	shutdown();
 }
 
+bool CRTFilter::ensure_initialized() {
+	if (!initialized_ && !initialize_failed_) {
+		initialize_failed_ = !initialize();
+		if (initialize_failed_) {
+			fprintf(stderr, "Warning: CRT filter initialization failed\n");
+		}
+	}
+	return initialized_;
+}
+
 bool CRTFilter::initialize() {
 	if (initialized_)
 		return true;
@@ -266,6 +487,24 @@ bool CRTFilter::initialize() {
 	glBindVertexArray_(0);
 	glBindBuffer_(GL_ARRAY_BUFFER, 0);
 
+	// Index frame and palette textures for resolve_indexed_frame()
+	glGenTextures(1, &index_texture_);
+	glBindTexture(GL_TEXTURE_2D, index_texture_);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, 256, 240, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+
+	glGenTextures(1, &palette_texture_);
+	glBindTexture(GL_TEXTURE_2D, palette_texture_);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 64, 8, 0, GL_RGBA, GL_UNSIGNED_BYTE, nes::PPU::rgba_palette().data());
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers_(1, &palette_fbo_);
+	create_upload_stream();
+	create_timer_queries();
+
 	initialized_ = true;
 	fprintf(stderr, "CRT filter: initialized successfully\n");
 	return true;
@@ -283,6 +522,24 @@ void CRTFilter::shutdown() {
 		glDeleteTextures(1, &output_texture_);
 		output_texture_ = 0;
 	}
+	if (palette_fbo_) {
+		glDeleteFramebuffers_(1, &palette_fbo_);
+		palette_fbo_ = 0;
+	}
+	destroy_upload_stream();
+	if (timer_supported_) {
+		glDeleteQueries_(static_cast<int>(TIMER_QUERIES), timer_queries_.data());
+		timer_queries_ = {};
+		timer_supported_ = false;
+	}
+	if (index_texture_) {
+		glDeleteTextures(1, &index_texture_);
+		index_texture_ = 0;
+	}
+	if (palette_texture_) {
+		glDeleteTextures(1, &palette_texture_);
+		palette_texture_ = 0;
+	}
 	if (vao_) {
 		glDeleteVertexArrays_(1, &vao_);
 		vao_ = 0;
@@ -295,20 +552,42 @@ void CRTFilter::shutdown() {
 		glDeleteProgram_(shader_program_);
 		shader_program_ = 0;
 	}
+	if (palette_program_) {
+		glDeleteProgram_(palette_program_);
+		palette_program_ = 0;
+	}
 
 	fbo_width_ = fbo_height_ = 0;
+	applied_ = AppliedPass{};
 	initialized_ = false;
 }
 
 GLuint CRTFilter::apply(GLuint input_texture, int output_width, int output_height) {
-	if (!enabled || !initialized_ || input_texture == 0 || output_width <= 0 || output_height <= 0) {
+	VIBENES_TRACE_ZONE("CRTFilter::apply");
+	if (!enabled || input_texture == 0 || output_width <= 0 || output_height <= 0 || !ensure_initialized()) {
 		return input_texture;
 	}
 
-	if (!ensure_framebuffer(output_width, output_height)) {
+	collect_gpu_times();
+	const int preset_index = select_quality(output_width, output_height);
+	const QualityPreset &preset = QUALITY_PRESETS[static_cast<std::size_t>(preset_index)];
+
+	// The target shrinks with the preset; the caller draws it at the output
+	// size either way, with bilinear filtering doing the upsampling
+	const float scale =
+		std::max(preset.resolution_scale, std::min(1.0f, 480.0f / static_cast<float>(output_height)));
+	const int width = std::max(1, static_cast<int>(std::lround(static_cast<float>(output_width) * scale)));
+	const int height = std::max(1, static_cast<int>(std::lround(static_cast<float>(output_height) * scale)));
+	if (!ensure_framebuffer(width, height)) {
 		return input_texture;
 	}
 
+	const AppliedPass pass = describe_pass(input_texture, output_width, output_height, preset_index);
+	if (pass == applied_) {
+		return output_texture_;
+	}
+	applied_ = pass;
+
 	// Save current GL state so we don't break ImGui's rendering
 	GLint prev_fbo = 0;
 	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prev_fbo);
@@ -317,9 +596,16 @@ GLuint CRTFilter::apply(GLuint input_texture, int output_width, int output_heigh
 	GLint prev_texture = 0;
 	glGetIntegerv(GL_TEXTURE_BINDING_2D, &prev_texture);
 
-	// Bind our FBO and set viewport to output dimensions
+	// Time the pass if a query is free (all in flight: the GPU is behind)
+	const std::size_t timer = timer_next_;
+	const bool timing = timer_supported_ && timer_presets_[timer] < 0;
+	if (timing) {
+		glBeginQuery_(GL_TIME_ELAPSED, timer_queries_[timer]);
+	}
+
+	// Bind our FBO and set viewport to the pass's target
 	glBindFramebuffer_(GL_FRAMEBUFFER, fbo_);
-	glViewport(0, 0, output_width, output_height);
+	glViewport(0, 0, width, height);
 
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
@@ -329,12 +615,12 @@ GLuint CRTFilter::apply(GLuint input_texture, int output_width, int output_heigh
 
 	glUniform1i_(loc_texture_, 0);
 	glUniform2f_(loc_input_res_, 256.0f, 240.0f);
-	glUniform2f_(loc_output_res_, static_cast<float>(output_width), static_cast<float>(output_height));
+	glUniform2f_(loc_output_res_, static_cast<float>(width), static_cast<float>(height));
 	glUniform1f_(loc_scanline_, scanline_intensity);
-	glUniform1f_(loc_curvature_, curvature);
+	glUniform1f_(loc_curvature_, preset.curvature ? curvature : 0.0f);
 	glUniform1f_(loc_vignette_, vignette_strength);
 	glUniform1f_(loc_brightness_, brightness);
-	glUniform1f_(loc_mask_, mask_intensity);
+	glUniform1f_(loc_mask_, preset.mask ? mask_intensity : 0.0f);
 
 	// Bind input texture with bilinear filtering for natural CRT softness
 	glActiveTexture_(GL_TEXTURE0);
@@ -342,23 +628,13 @@ GLuint CRTFilter::apply(GLuint input_texture, int output_width, int output_heigh
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-	// Draw fullscreen quad through CRT shader.
-	// Re-bind the VBO and re-specify the vertex attributes here rather than
-	// relying solely on the stored VAO state. ImGui's GL backend rebinds the
-	// array buffer and vertex-attrib state every frame, and in a CORE profile a
-	// stale/empty array-buffer binding makes glDrawArrays dereference a
-	// client-side pointer (offset 0/8) and crash. Re-specifying guarantees a
-	// valid buffer is bound for both attributes.
-	glBindVertexArray_(vao_);
-	glBindBuffer_(GL_ARRAY_BUFFER, vbo_);
-	glVertexAttribPointer_(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
-	glEnableVertexAttribArray_(0);
-	glVertexAttribPointer_(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
-						   reinterpret_cast<const void *>(2 * sizeof(float)));
-	glEnableVertexAttribArray_(1);
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-	glBindBuffer_(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray_(0);
+	// Draw fullscreen quad through CRT shader
+	draw_quad(vao_, vbo_);
+	if (timing) {
+		glEndQuery_(GL_TIME_ELAPSED);
+		timer_presets_[timer] = preset_index;
+		timer_next_ = (timer + 1) % TIMER_QUERIES;
+	}
 
 	// Restore input texture to nearest-neighbor filtering (ImGui/debug views expect it)
 	glBindTexture(GL_TEXTURE_2D, input_texture);
@@ -374,6 +650,265 @@ GLuint CRTFilter::apply(GLuint input_texture, int output_width, int output_heigh
 	return output_texture_;
 }
 
+CRTFilter::AppliedPass CRTFilter::describe_pass(GLuint input_texture, int output_width, int output_height,
+												int preset) const {
+	AppliedPass pass;
+	pass.valid = true;
+	pass.input_texture = input_texture;
+	pass.width = output_width;
+	pass.height = output_height;
+	pass.quality = preset;
+	pass.settings = {scanline_intensity, curvature, vignette_strength, brightness, mask_intensity};
+	return pass;
+}
+
+void CRTFilter::create_timer_queries() {
+	timer_presets_.fill(-1);
+	timer_next_ = 0;
+	timer_supported_ = glGenQueries_ && glDeleteQueries_ && glBeginQuery_ && glEndQuery_ && glGetQueryObjectiv_ &&
+					   glGetQueryObjectui64v_;
+	if (timer_supported_) {
+		glGenQueries_(static_cast<int>(TIMER_QUERIES), timer_queries_.data());
+	} else {
+		fprintf(stderr, "CRT filter: no GPU timer queries, Auto quality stays on Full\n");
+	}
+}
+
+void CRTFilter::collect_gpu_times() {
+	// Queries finish in the order they were issued: read from the oldest
+	// until one is still pending
+	for (std::size_t i = 0; i < TIMER_QUERIES && timer_supported_; ++i) {
+		const std::size_t slot = (timer_next_ + i) % TIMER_QUERIES;
+		if (timer_presets_[slot] < 0) {
+			continue;
+		}
+		int available = 0;
+		glGetQueryObjectiv_(timer_queries_[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			break;
+		}
+		uint64_t nanoseconds = 0;
+		glGetQueryObjectui64v_(timer_queries_[slot], GL_QUERY_RESULT, &nanoseconds);
+		record_gpu_time(timer_presets_[slot], static_cast<float>(nanoseconds) * 1e-6f);
+		timer_presets_[slot] = -1;
+	}
+}
+
+void CRTFilter::record_gpu_time(int preset, float ms) {
+	float &average = gpu_ms_[static_cast<std::size_t>(preset)];
+	average = average == 0.0f ? ms : average + (ms - average) * 0.1f;
+	if (quality != AUTO_QUALITY || preset != active_quality_) {
+		return; // Measured for the menu only, or timed before the last switch
+	}
+
+	// Step down after a run of passes over budget. Step up after a long run
+	// well under it, unless the preset above was already measured too slow
+	// at this size; that is retried only after a much longer run, in case
+	// the GPU has since been freed up.
+	constexpr int STEP_DOWN_PASSES = 8;
+	constexpr int STEP_UP_PASSES = 240;
+	constexpr int RETRY_PASSES = 2400;
+	if (average > gpu_budget_ms) {
+		under_budget_passes_ = 0;
+		if (++over_budget_passes_ >= STEP_DOWN_PASSES &&
+			active_quality_ + 1 < static_cast<int>(QUALITY_PRESETS.size())) {
+			++active_quality_;
+			over_budget_passes_ = 0;
+		}
+		return;
+	}
+	over_budget_passes_ = 0;
+	if (active_quality_ == 0 || average > gpu_budget_ms * 0.5f) {
+		under_budget_passes_ = 0;
+		return;
+	}
+	const float above = gpu_ms_[static_cast<std::size_t>(active_quality_ - 1)];
+	const int needed = above == 0.0f || above < gpu_budget_ms * 0.9f ? STEP_UP_PASSES : RETRY_PASSES;
+	if (++under_budget_passes_ >= needed) {
+		--active_quality_;
+		under_budget_passes_ = 0;
+	}
+}
+
+int CRTFilter::select_quality(int output_width, int output_height) {
+	// Times measured at another output size say nothing about this one
+	if (output_width != timed_width_ || output_height != timed_height_) {
+		timed_width_ = output_width;
+		timed_height_ = output_height;
+		gpu_ms_.fill(0.0f);
+		over_budget_passes_ = under_budget_passes_ = 0;
+	}
+	if (quality != AUTO_QUALITY) {
+		active_quality_ = std::clamp(quality, 0, static_cast<int>(QUALITY_PRESETS.size()) - 1);
+	} else if (!timer_supported_) {
+		active_quality_ = 0;
+	}
+	return active_quality_;
+}
+
+bool CRTFilter::resolve_indexed_frame(const uint16_t *indices, GLuint target_texture) {
+	if (!indices || target_texture == 0 || !ensure_initialized()) {
+		return false;
+	}
+
+	// Save current GL state so we don't break ImGui's rendering
+	GLint prev_fbo = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prev_fbo);
+	GLint prev_viewport[4];
+	glGetIntegerv(GL_VIEWPORT, prev_viewport);
+	GLint prev_texture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &prev_texture);
+
+	// 2 bytes per pixel instead of 4
+	upload_indices(indices);
+	invalidate();
+
+	glBindFramebuffer_(GL_FRAMEBUFFER, palette_fbo_);
+	glFramebufferTexture2D_(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target_texture, 0);
+	if (glCheckFramebufferStatus_(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		glBindFramebuffer_(GL_FRAMEBUFFER, static_cast<unsigned int>(prev_fbo));
+		glBindTexture(GL_TEXTURE_2D, static_cast<unsigned int>(prev_texture));
+		return false;
+	}
+	glViewport(0, 0, 256, 240);
+
+	glUseProgram_(palette_program_);
+	glUniform1i_(loc_indices_, 0);
+	glUniform1i_(loc_palette_, 1);
+	glActiveTexture_(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, palette_texture_);
+	glActiveTexture_(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, index_texture_);
+
+	draw_quad(vao_, vbo_);
+
+	// Detach so the target can be sampled (and re-attached next frame)
+	glFramebufferTexture2D_(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+
+	// Restore previous GL state
+	glActiveTexture_(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture_(GL_TEXTURE0);
+	glUseProgram_(0);
+	glBindFramebuffer_(GL_FRAMEBUFFER, static_cast<unsigned int>(prev_fbo));
+	glViewport(prev_viewport[0], prev_viewport[1], prev_viewport[2], prev_viewport[3]);
+	glBindTexture(GL_TEXTURE_2D, static_cast<unsigned int>(prev_texture));
+	return true;
+}
+
+void CRTFilter::create_upload_stream() {
+	upload_mode_ = UploadMode::Direct;
+	if (!glMapBufferRange_ || !glUnmapBuffer_) {
+		fprintf(stderr, "CRT filter: frame uploads are synchronous (no buffer mapping)\n");
+		return;
+	}
+
+	glGenBuffers_(1, &upload_pbo_);
+	glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, upload_pbo_);
+	if (glBufferStorage_ && glFenceSync_ && glClientWaitSync_ && glDeleteSync_) {
+		// One persistently mapped buffer, UPLOAD_SLOTS frames deep; a fence per
+		// slot keeps the CPU from overwriting a frame the GPU is still reading
+		const unsigned int flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage_(GL_PIXEL_UNPACK_BUFFER, UPLOAD_SLOTS * INDEX_FRAME_BYTES, nullptr, flags);
+		upload_map_ = glMapBufferRange_(GL_PIXEL_UNPACK_BUFFER, 0, UPLOAD_SLOTS * INDEX_FRAME_BYTES, flags);
+		if (upload_map_) {
+			upload_mode_ = UploadMode::Persistent;
+		} else {
+			// Immutable storage cannot be re-specified: start over with a new buffer
+			glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, 0);
+			glDeleteBuffers_(1, &upload_pbo_);
+			glGenBuffers_(1, &upload_pbo_);
+			glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, upload_pbo_);
+		}
+	}
+	if (upload_mode_ == UploadMode::Direct) {
+		// Orphan and remap every frame: the driver hands out fresh storage
+		// while the previous frame's transfer is still in flight
+		glBufferData_(GL_PIXEL_UNPACK_BUFFER, INDEX_FRAME_BYTES, nullptr, GL_STREAM_DRAW);
+		upload_mode_ = UploadMode::Orphaned;
+	}
+	glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, 0);
+	fprintf(stderr, "CRT filter: frame uploads stream through a %s pixel buffer\n",
+			upload_mode_ == UploadMode::Persistent ? "persistent-mapped" : "orphaned");
+}
+
+void CRTFilter::destroy_upload_stream() {
+	for (void *&fence : upload_fences_) {
+		if (fence) {
+			glDeleteSync_(fence);
+			fence = nullptr;
+		}
+	}
+	if (upload_pbo_) {
+		if (upload_map_) {
+			glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, upload_pbo_);
+			glUnmapBuffer_(GL_PIXEL_UNPACK_BUFFER);
+			glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, 0);
+			upload_map_ = nullptr;
+		}
+		glDeleteBuffers_(1, &upload_pbo_);
+		upload_pbo_ = 0;
+	}
+	upload_slot_ = 0;
+	upload_mode_ = UploadMode::Direct;
+}
+
+void CRTFilter::upload_indices(const uint16_t *indices) {
+	glBindTexture(GL_TEXTURE_2D, index_texture_);
+	if (upload_mode_ == UploadMode::Direct) {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 240, GL_RED_INTEGER, GL_UNSIGNED_SHORT, indices);
+		return;
+	}
+
+	glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, upload_pbo_);
+	std::size_t offset = 0;
+	if (upload_mode_ == UploadMode::Persistent) {
+		void *&fence = upload_fences_[upload_slot_];
+		if (fence) {
+			// Normally long signalled: the slot was last used UPLOAD_SLOTS frames ago
+			while (glClientWaitSync_(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+			}
+			glDeleteSync_(fence);
+			fence = nullptr;
+		}
+		offset = upload_slot_ * INDEX_FRAME_BYTES;
+		std::memcpy(static_cast<unsigned char *>(upload_map_) + offset, indices, INDEX_FRAME_BYTES);
+	} else {
+		glBufferData_(GL_PIXEL_UNPACK_BUFFER, INDEX_FRAME_BYTES, nullptr, GL_STREAM_DRAW);
+		void *mapped =
+			glMapBufferRange_(GL_PIXEL_UNPACK_BUFFER, 0, INDEX_FRAME_BYTES, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (!mapped) {
+			glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, 0);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 240, GL_RED_INTEGER, GL_UNSIGNED_SHORT, indices);
+			return;
+		}
+		std::memcpy(mapped, indices, INDEX_FRAME_BYTES);
+		glUnmapBuffer_(GL_PIXEL_UNPACK_BUFFER);
+	}
+
+	// With an unpack buffer bound the "pointer" is an offset into it, and the
+	// copy into the texture happens on the GPU's timeline
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 240, GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+					reinterpret_cast<const void *>(offset));
+	glBindBuffer_(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (upload_mode_ == UploadMode::Persistent) {
+		upload_fences_[upload_slot_] = glFenceSync_(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		upload_slot_ = (upload_slot_ + 1) % UPLOAD_SLOTS;
+	}
+}
+
+void CRTFilter::set_palette(const std::array<uint32_t, 512> &palette) {
+	if (!initialized_) {
+		return;
+	}
+	GLint prev_texture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &prev_texture);
+	glBindTexture(GL_TEXTURE_2D, palette_texture_);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 64, 8, GL_RGBA, GL_UNSIGNED_BYTE, palette.data());
+	glBindTexture(GL_TEXTURE_2D, static_cast<unsigned int>(prev_texture));
+}
+
 void CRTFilter::get_display_size(float base_width, float base_height, float scale, float &out_width,
 								 float &out_height) const {
 	float par = (enabled && aspect_correction) ? NTSC_PAR : 1.0f;
@@ -429,59 +964,41 @@ bool CRTFilter::load_gl_functions() {
 
 #undef LOAD_GL
 
+	// Upload streaming degrades gracefully: missing entry points only select
+	// a simpler path in create_upload_stream()
+	glMapBufferRange_ = reinterpret_cast<PFN_glMapBufferRange>(SDL_GL_GetProcAddress("glMapBufferRange"));
+	glUnmapBuffer_ = reinterpret_cast<PFN_glUnmapBuffer>(SDL_GL_GetProcAddress("glUnmapBuffer"));
+	glBufferStorage_ = reinterpret_cast<PFN_glBufferStorage>(SDL_GL_GetProcAddress("glBufferStorage"));
+	glFenceSync_ = reinterpret_cast<PFN_glFenceSync>(SDL_GL_GetProcAddress("glFenceSync"));
+	glClientWaitSync_ = reinterpret_cast<PFN_glClientWaitSync>(SDL_GL_GetProcAddress("glClientWaitSync"));
+	glDeleteSync_ = reinterpret_cast<PFN_glDeleteSync>(SDL_GL_GetProcAddress("glDeleteSync"));
+
+	// Without these the programs are compiled on every start
+	glProgramParameteri_ = reinterpret_cast<PFN_glProgramParameteri>(SDL_GL_GetProcAddress("glProgramParameteri"));
+	glGetProgramBinary_ = reinterpret_cast<PFN_glGetProgramBinary>(SDL_GL_GetProcAddress("glGetProgramBinary"));
+	glProgramBinary_ = reinterpret_cast<PFN_glProgramBinary>(SDL_GL_GetProcAddress("glProgramBinary"));
+	program_binary_supported_ = glProgramParameteri_ && glGetProgramBinary_ && glProgramBinary_;
+
+	// Without these Auto quality has nothing to go on and stays on Full
+	glGenQueries_ = reinterpret_cast<PFN_glGenQueries>(SDL_GL_GetProcAddress("glGenQueries"));
+	glDeleteQueries_ = reinterpret_cast<PFN_glDeleteQueries>(SDL_GL_GetProcAddress("glDeleteQueries"));
+	glBeginQuery_ = reinterpret_cast<PFN_glBeginQuery>(SDL_GL_GetProcAddress("glBeginQuery"));
+	glEndQuery_ = reinterpret_cast<PFN_glEndQuery>(SDL_GL_GetProcAddress("glEndQuery"));
+	glGetQueryObjectiv_ = reinterpret_cast<PFN_glGetQueryObjectiv>(SDL_GL_GetProcAddress("glGetQueryObjectiv"));
+	glGetQueryObjectui64v_ =
+		reinterpret_cast<PFN_glGetQueryObjectui64v>(SDL_GL_GetProcAddress("glGetQueryObjectui64v"));
+
 	gl_loaded_ = true;
 	return true;
 }
 
 bool CRTFilter::create_shader_program() {
-	// Helper: compile a single shader stage
-	auto compile_shader = [](unsigned int type, const char *source) -> unsigned int {
-		unsigned int shader = glCreateShader_(type);
-		glShaderSource_(shader, 1, &source, nullptr);
-		glCompileShader_(shader);
-
-		int success = 0;
-		glGetShaderiv_(shader, GL_COMPILE_STATUS, &success);
-		if (!success) {
-			char log[1024];
-			glGetShaderInfoLog_(shader, sizeof(log), nullptr, log);
-			fprintf(stderr, "CRT shader compile error: %s\n", log);
-			glDeleteShader_(shader);
-			return 0;
-		}
-		return shader;
-	};
-
-	unsigned int vs = compile_shader(GL_VERTEX_SHADER, kVertexShader);
-	if (!vs)
-		return false;
-
-	unsigned int fs = compile_shader(GL_FRAGMENT_SHADER, kFragmentShader);
-	if (!fs) {
-		glDeleteShader_(vs);
+	shader_program_ = load_or_build_program("crt", kVertexShader, kFragmentShader);
+	if (!shader_program_)
 		return false;
-	}
-
-	shader_program_ = glCreateProgram_();
-	glAttachShader_(shader_program_, vs);
-	glAttachShader_(shader_program_, fs);
-
-	// Bind attribute locations before linking (GLSL 130 lacks layout qualifiers)
-	glBindAttribLocation_(shader_program_, 0, "aPos");
-	glBindAttribLocation_(shader_program_, 1, "aTexCoord");
-
-	glLinkProgram_(shader_program_);
-
-	// Shaders can be deleted after linking
-	glDeleteShader_(vs);
-	glDeleteShader_(fs);
 
-	int success = 0;
-	glGetProgramiv_(shader_program_, GL_LINK_STATUS, &success);
-	if (!success) {
-		char log[1024];
-		glGetProgramInfoLog_(shader_program_, sizeof(log), nullptr, log);
-		fprintf(stderr, "CRT shader link error: %s\n", log);
+	palette_program_ = load_or_build_program("palette", kVertexShader, kPaletteFragmentShader);
+	if (!palette_program_) {
 		glDeleteProgram_(shader_program_);
 		shader_program_ = 0;
 		return false;
@@ -496,10 +1013,68 @@ bool CRTFilter::create_shader_program() {
 	loc_vignette_ = glGetUniformLocation_(shader_program_, "uVignette");
 	loc_brightness_ = glGetUniformLocation_(shader_program_, "uBrightness");
 	loc_mask_ = glGetUniformLocation_(shader_program_, "uMask");
+	loc_indices_ = glGetUniformLocation_(palette_program_, "uIndices");
+	loc_palette_ = glGetUniformLocation_(palette_program_, "uPalette");
 
 	return true;
 }
 
+unsigned int CRTFilter::load_or_build_program(std::string_view name, const char *vertex_source,
+											  const char *fragment_source) const {
+	const bool use_cache = program_binary_supported_ && !program_cache_directory_.empty();
+	if (!use_cache) {
+		return build_program(vertex_source, fragment_source, false);
+	}
+
+	const auto path = program_cache_directory_ / (std::string(name) + ".glprog");
+	const uint32_t key = program_cache_key(vertex_source, fragment_source);
+
+	// A cached binary the driver rejects (it may have been updated without
+	// changing its version string) falls through to compiling
+	if (std::ifstream file{path, std::ios::binary}) {
+		ProgramCacheHeader header{};
+		if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) && header.magic == PROGRAM_CACHE_MAGIC &&
+			header.key == key) {
+			std::vector<char> binary(header.length);
+			if (file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) {
+				const unsigned int program = glCreateProgram_();
+				glProgramBinary_(program, header.format, binary.data(), static_cast<int>(binary.size()));
+				int success = 0;
+				glGetProgramiv_(program, GL_LINK_STATUS, &success);
+				if (success) {
+					return program;
+				}
+				glDeleteProgram_(program);
+			}
+		}
+	}
+
+	const unsigned int program = build_program(vertex_source, fragment_source, true);
+	if (!program) {
+		return 0;
+	}
+
+	int length = 0;
+	glGetProgramiv_(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return program;
+	}
+	std::vector<char> binary(static_cast<size_t>(length));
+	ProgramCacheHeader header{PROGRAM_CACHE_MAGIC, key, 0, 0};
+	int written = 0;
+	glGetProgramBinary_(program, length, &written, &header.format, binary.data());
+	header.length = static_cast<uint32_t>(written);
+
+	// Best effort: a failed write only costs a compile next time
+	std::error_code ec;
+	std::filesystem::create_directories(program_cache_directory_, ec);
+	if (std::ofstream file{path, std::ios::binary | std::ios::trunc}) {
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(binary.data(), written);
+	}
+	return program;
+}
+
 bool CRTFilter::ensure_framebuffer(int width, int height) {
 	if (fbo_ && fbo_width_ == width && fbo_height_ == height) {
 		return true; // Already the right size
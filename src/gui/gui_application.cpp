@@ -1,16 +1,30 @@
 #include "gui/gui_application.hpp"
 #include "apu/apu.hpp"
+#include "audio/audio_backend.hpp"
 #include "cartridge/cartridge.hpp"
+#include "cartridge/rom_preloader.hpp"
 #include "core/bus.hpp"
+#include "core/trace_zones.hpp"
 #include "core/user_paths.hpp"
 #include "cpu/cpu_6502.hpp"
+#include "cpu/cpu_profiler.hpp"
 #include "gui/crt_filter.hpp"
 #include "gui/style/retro_theme.hpp"
 #include "input/controller.hpp"
 #include "input/gamepad_manager.hpp"
+#include "input/latched_input.hpp"
 #include "memory/ram.hpp"
+#include "ppu/ntsc_filter.hpp"
 #include "ppu/ppu.hpp"
 #include "system/battery_save.hpp"
+#include "system/emulation_thread.hpp"
+#include "system/frame_capture.hpp"
+#include "system/frame_dump.hpp"
+#include "system/frame_latency.hpp"
+#include "system/headless_system.hpp"
+#include "system/nes_system.hpp"
+#include "system/perf_counters.hpp"
+#include "system/rewind_buffer.hpp"
 #include "system/save_state.hpp"
 
 // Panel includes
@@ -33,23 +47,61 @@
 #endif
 #include <GL/gl.h>
 #include <SDL3/SDL.h>
+#include <chrono>
 #include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace nes::gui {
 
-GuiApplication::GuiApplication()
-	: window_(nullptr), gl_context_(nullptr), io_(nullptr), running_(false), fullscreen_mode_(false),
+namespace {
+// Emulated time per NTSC frame, for per-frame work done on the emulation thread
+constexpr double EMULATED_FRAME_SECONDS =
+	nes::EmulationThread::CPU_CYCLES_PER_FRAME / static_cast<double>(nes::CPU_CLOCK_NTSC);
+
+// Redraw period while nothing is being emulated but something on screen is
+// still animating (a status message counting down): the NES display shows
+// the same frame, so there is no point following a 120/144 Hz refresh
+constexpr auto IDLE_FRAME_PERIOD = std::chrono::milliseconds(33);
+
+// With nothing animating the loop sleeps until an event arrives, waking this
+// often to look for finished background saves
+constexpr Sint32 IDLE_WAKE_MS = 250;
+
+// ImGui needs a few frames after an event to settle hover and layout state
+constexpr int IDLE_SETTLE_FRAMES = 3;
+
+std::uint64_t ns_since(std::chrono::steady_clock::time_point start) {
+	return static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+} // namespace
+
+GuiApplication::GuiApplication(LaunchOptions options)
+	: window_(nullptr), gl_context_(nullptr), io_(nullptr), launch_options_(std::move(options)), running_(false),
+	  fullscreen_mode_(false),
 	  fullscreen_scale_(0.0f), fullscreen_offset_x_(0.0f), fullscreen_offset_y_(0.0f), fullscreen_display_w_(0.0f),
 	  fullscreen_display_h_(0.0f), crt_filter_(std::make_unique<CRTFilter>()), emulation_running_(false),
-	  emulation_paused_(true), emulation_speed_(1.0f), cycle_accumulator_(0.0), last_frame_counter_(0),
-	  frame_timer_initialized_(false), cpu_(nullptr), bus_(nullptr), cartridge_(nullptr), ppu_(nullptr),
-	  cpu_panel_(std::make_unique<CPUStatePanel>()), disassembler_panel_(std::make_unique<DisassemblerPanel>()),
-	  memory_panel_(std::make_unique<MemoryViewerPanel>()), rom_loader_panel_(std::make_unique<RomLoaderPanel>()),
-	  ppu_viewer_panel_(std::make_unique<PPUViewerPanel>()), timing_panel_(std::make_unique<TimingPanel>()),
-	  audio_panel_(std::make_unique<nes::AudioPanel>()), save_state_manager_(nullptr), save_state_status_message_(""),
-	  save_state_status_timer_(0.0f) {
+	  emulation_paused_(true), emulation_speed_(1.0f), fast_forward_(false), fast_forward_active_(false),
+	  fast_forward_muted_audio_(false), posted_buttons_{}, emulation_thread_running_(false),
+	  debug_view_active_(false), new_frame_(false), cpu_(nullptr), bus_(nullptr), cartridge_(nullptr), ppu_(nullptr),
+	  ppu_viewer_panel_(std::make_unique<PPUViewerPanel>()), audio_panel_(std::make_unique<nes::AudioPanel>()),
+	  save_state_manager_(nullptr), save_state_status_message_(""), save_state_status_timer_(0.0f) {
+	// The game-only layout shows just the NES display; the debugger panels
+	// (and the ROM browser's background library scan) are never built
+	if (launch_options_.debug_ui) {
+		cpu_panel_ = std::make_unique<CPUStatePanel>();
+		disassembler_panel_ = std::make_unique<DisassemblerPanel>();
+		memory_panel_ = std::make_unique<MemoryViewerPanel>();
+		rom_loader_panel_ = std::make_unique<RomLoaderPanel>();
+	}
 }
 
 GuiApplication::~GuiApplication() {
@@ -57,6 +109,16 @@ GuiApplication::~GuiApplication() {
 }
 
 bool GuiApplication::initialize() {
+	// On installed builds, import packaged roms/saves to user-writable locations once.
+	nes::migrate_packaged_data_to_user_dirs_once();
+
+	// Read the launch ROM and its save while the window, GL and the audio
+	// device come up; load_launch_rom() then only swaps the cartridge
+	rom_preloader_ = std::make_unique<nes::RomPreloader>();
+	if (!launch_options_.rom_path.empty()) {
+		rom_preloader_->prefetch(launch_options_.rom_path, battery_save_path(launch_options_.rom_path));
+	}
+
 	if (!initialize_sdl()) {
 		return false;
 	}
@@ -77,9 +139,14 @@ bool GuiApplication::initialize() {
 		return false;
 	}
 
-	// Initialize CRT display filter (needs GL context)
-	if (crt_filter_ && !crt_filter_->initialize()) {
-		std::cerr << "Warning: CRT filter initialization failed\n";
+	// The CRT filter builds its GL resources on the first frame it draws,
+	// loading the shader programs linked by an earlier run when it can
+	if (crt_filter_) {
+		crt_filter_->set_program_cache_directory(nes::get_shader_cache_directory());
+	}
+
+	if (launch_options_.fullscreen) {
+		toggle_fullscreen();
 	}
 
 	return true;
@@ -99,8 +166,15 @@ bool GuiApplication::initialize_sdl() {
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 
-	// Create window - Optimized for 1080p displays
-	window_ = SDL_CreateWindow("VibeNES - Cycle-Accurate NES Emulator", WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_OPENGL);
+	// Create window - Optimized for 1080p displays; the game-only layout
+	// opens at 3x the (aspect-corrected) NES picture and can be resized
+	if (launch_options_.debug_ui) {
+		window_ =
+			SDL_CreateWindow("VibeNES - Cycle-Accurate NES Emulator", WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_OPENGL);
+	} else {
+		window_ = SDL_CreateWindow("VibeNES", GAME_WINDOW_WIDTH, GAME_WINDOW_HEIGHT,
+								   SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+	}
 
 	if (!window_) {
 		std::cerr << "SDL_CreateWindow Error: " << SDL_GetError() << std::endl;
@@ -148,16 +222,31 @@ bool GuiApplication::initialize_imgui() {
 }
 
 void GuiApplication::initialize_emulation_components() {
-	// On installed builds, import packaged roms/saves to user-writable locations once.
-	nes::migrate_packaged_data_to_user_dirs_once();
 	if (rom_loader_panel_) {
 		rom_loader_panel_->reset_to_default_directory();
+		rom_loader_panel_->set_rom_preloader(rom_preloader_.get(), nes::get_battery_directory());
 	}
 
-	// Create components in dependency order
-	bus_ = std::make_shared<nes::SystemBus>();
-
-	// Initialize audio system
+	// The console owns and wires every component; keep shortcuts to the parts
+	// the GUI drives directly. The controller reads latched masks; the GUI
+	// polls the gamepads and hands them to the emulation thread (see
+	// update_emulation_thread)
+	input_latch_ = std::make_shared<nes::LatchedInputSource>();
+	system_ = std::make_unique<nes::NesSystem>(input_latch_);
+	bus_ = &system_->bus();
+	cpu_ = &system_->cpu();
+	ppu_ = &system_->ppu();
+	cartridge_ = &system_->cartridge();
+	controllers_ = &system_->controllers();
+	nes::APU *apu = &system_->apu();
+
+	// Run the PPU lazily; only CPU-visible sync points force it forward
+	bus_->set_ppu_catch_up(true);
+	// Band-limited step synthesis: cheaper per cycle and alias-free
+	apu->set_synthesis_mode(nes::APU::SynthesisMode::BandLimited);
+
+	// Initialize audio system (the core bus has no device until we attach one)
+	bus_->connect_audio_output(std::make_unique<nes::AudioBackend>());
 	if (bus_->initialize_audio()) {
 		// Audio will be started by the audio panel on first render to match checkbox state
 	} else {
@@ -172,34 +261,10 @@ void GuiApplication::initialize_emulation_components() {
 		std::cerr << "Warning: Gamepad system initialization failed\n";
 	}
 
-	// Create memory components
-	auto ram = std::make_shared<nes::Ram>();
-	auto apu = std::make_shared<nes::APU>();
-
-	// Create controller with gamepad manager
-	controllers_ = std::make_shared<nes::Controller>(gamepad_manager_);
-
-	// Create other core components
-	cartridge_ = std::make_shared<nes::Cartridge>();
-	ppu_ = std::make_shared<nes::PPU>();
-	cpu_ = std::make_shared<nes::CPU6502>(bus_.get()); // CPU needs bus reference
-
-	// Connect components to bus
-	bus_->connect_ram(ram);
-	bus_->connect_ppu(ppu_);
-	bus_->connect_apu(apu);
-	bus_->connect_controllers(controllers_);
-	bus_->connect_cartridge(cartridge_);
-	bus_->connect_cpu(cpu_); // Connect CPU to bus for APU IRQ handling
-
-	// Connect cartridge to PPU for CHR ROM access
-	ppu_->connect_cartridge(cartridge_);
-
-	// Connect CPU to PPU for NMI generation
-	ppu_->connect_cpu(cpu_.get());
-
-	// Connect PPU to bus for OAM DMA and CPU memory access
-	ppu_->connect_bus(bus_.get());
+#ifdef VIBENES_CPU_PROFILER
+	cpu_profiler_ = std::make_unique<nes::CpuProfiler>(cartridge_);
+	cpu_->set_profiler(cpu_profiler_.get());
+#endif
 
 	// Initialize system
 	bus_->power_on();
@@ -212,20 +277,23 @@ void GuiApplication::initialize_emulation_components() {
 	cpu_->trigger_reset();
 
 	// Create save state manager — use platform-appropriate save directory
-	save_state_manager_ =
-		std::make_unique<nes::SaveStateManager>(cpu_.get(), ppu_.get(), apu.get(), bus_.get(), cartridge_.get());
+	save_state_manager_ = std::make_unique<nes::SaveStateManager>(cpu_, ppu_, apu, bus_, cartridge_);
 	save_state_manager_->set_save_directory(nes::get_saves_directory());
+	file_writer_ = std::make_unique<nes::AsyncFileWriter>();
 
 	// Create battery-save manager (persistent PRG-RAM / .sav files) and arrange
 	// for the outgoing cartridge's save RAM to be flushed whenever the ROM is
 	// swapped or unloaded (the pre-swap hook fires while the old mapper is alive).
-	battery_save_manager_ = std::make_unique<nes::BatterySaveManager>(cartridge_.get());
+	battery_save_manager_ = std::make_unique<nes::BatterySaveManager>(cartridge_);
 	battery_save_manager_->set_directory(nes::get_battery_directory());
+	battery_save_manager_->set_file_writer(file_writer_.get());
+	battery_save_manager_->set_memory_mapped(launch_options_.mapped_saves);
 	if (cartridge_) {
 		cartridge_->set_pre_swap_hook([this]() {
 			if (battery_save_manager_) {
 				battery_save_manager_->flush(true);
 			}
+			save_code_data_log();
 		});
 	}
 
@@ -233,49 +301,108 @@ void GuiApplication::initialize_emulation_components() {
 	if (ppu_viewer_panel_ && crt_filter_) {
 		ppu_viewer_panel_->set_crt_filter(crt_filter_.get());
 	}
+
+	// Shadow system for the debug panels while the emulation thread is running
+	debug_view_ = std::make_unique<nes::HeadlessSystem>();
+	debug_view_state_ = std::make_unique<nes::SaveStateManager>(
+		&debug_view_->cpu(), &debug_view_->ppu(), &debug_view_->apu(), &debug_view_->bus(), &debug_view_->cartridge());
+
+	// Everything from here on touches the components only through the thread
+	emulation_thread_ = std::make_unique<nes::EmulationThread>(*cpu_, *ppu_, *bus_, input_latch_);
+	// Own manager so the thread never shares error strings with the menus' one
+	snapshot_state_manager_ = std::make_unique<nes::SaveStateManager>(cpu_, ppu_, apu, bus_, cartridge_);
+	emulation_thread_->set_snapshot_callback(
+		[this](std::vector<std::uint8_t> &out) { snapshot_state_manager_->serialize_state(out); });
+	emulation_thread_->set_state_callbacks(
+		[this](nes::StateSnapshot &snapshot) { snapshot_state_manager_->capture(snapshot); },
+		[this](const nes::StateSnapshot &snapshot) { snapshot_state_manager_->restore(snapshot); });
+	emulation_thread_->set_frame_callback([this]() {
+		// Persist battery-backed PRG-RAM periodically (only writes when dirty)
+		if (battery_save_manager_) {
+			battery_save_manager_->update(EMULATED_FRAME_SECONDS);
+		}
+		if (frame_recording_) {
+			frame_recording_->submit(ppu_->get_frame_buffer());
+		}
+		if constexpr (nes::ScanlineTimeline::ENABLED) {
+			scanline_timelines_.write_buffer() = ppu_->get_scanline_timeline().last_frame();
+			scanline_timelines_.publish();
+		}
+	});
+	perf_counters_ = std::make_unique<nes::PerfCounters>();
+	emulation_thread_->set_perf_counters(perf_counters_.get());
+	frame_latency_ = std::make_unique<nes::FrameLatency>();
+	emulation_thread_->set_speed(emulation_speed_);
+	late_input_.set_mode(launch_options_.late_input);
+	late_input_.set_lead(std::chrono::milliseconds(launch_options_.late_input_lead_ms));
+	apply_pacing();
+	emulation_thread_->start();
 }
 
 void GuiApplication::run() {
 	running_ = true;
-	last_frame_counter_ = SDL_GetPerformanceCounter();
-	frame_timer_initialized_ = true;
+	nes::TraceZones::set_thread_name("Main");
 
-	int frame_count = 0;
+	if (!launch_options_.rom_path.empty()) {
+		load_launch_rom();
+	}
 
+	// Emulation is paced by its own thread; this loop only follows the display
+	// refresh, so a slow UI frame delays presentation but never emulated time
 	while (running_) {
-		frame_count++;
-
-		uint64_t current_counter = SDL_GetPerformanceCounter();
-		double delta_seconds = 0.0;
-		if (frame_timer_initialized_) {
-			delta_seconds = static_cast<double>(current_counter - last_frame_counter_) /
-							static_cast<double>(SDL_GetPerformanceFrequency());
+		// Paused with a settled screen: block until there is input rather than
+		// redrawing the same frame. A timeout only polls for finished saves.
+		if (!is_emulation_active() && idle_redraw_frames_ == 0 && !is_ui_animating()) {
+			if (!SDL_WaitEventTimeout(nullptr, IDLE_WAKE_MS)) {
+				check_pending_save(); // Its status message redraws from the next pass
+				continue;
+			}
 		}
-		last_frame_counter_ = current_counter;
 
+		const auto loop_start = std::chrono::steady_clock::now();
+		if (is_late_input_active()) {
+			// Poll as late as this frame's emulation and drawing allow
+			VIBENES_TRACE_ZONE("Late input wait");
+			std::this_thread::sleep_until(late_input_.poll_time());
+		}
 		handle_events();
+		update_fast_forward_state();
+		update_emulation_thread();
+		check_pending_save();
 
-		// Emulation loop - run CPU and coordinate with PPU timing using real-time delta
-		if (emulation_running_ && !emulation_paused_ && cpu_ && ppu_) {
-			process_continuous_emulation(delta_seconds);
+		render_frame();
+		if (idle_redraw_frames_ > 0) {
+			--idle_redraw_frames_;
 		}
-
-		// Persist battery-backed PRG-RAM periodically (only writes when dirty).
-		if (battery_save_manager_) {
-			battery_save_manager_->update(delta_seconds);
+		if (perf_counters_) {
+			perf_counters_->collect(texture_upload_ns_, gui_ns_);
 		}
 
-		render_frame();
+		// Start the thread only after this frame's panels are done with the
+		// live components they may have read while it was idle
+		sync_emulation_run_state();
+
+		if (!is_emulation_active() && is_ui_animating()) {
+			const auto elapsed = std::chrono::steady_clock::now() - loop_start;
+			if (elapsed < IDLE_FRAME_PERIOD) {
+				SDL_Delay(static_cast<Uint32>(
+					std::chrono::duration_cast<std::chrono::milliseconds>(IDLE_FRAME_PERIOD - elapsed).count()));
+			}
+		}
 	}
 }
 
 void GuiApplication::handle_events() {
 	if (gamepad_manager_) {
 		gamepad_manager_->update();
+		input_polls_[next_input_poll_] = std::chrono::steady_clock::now();
+		next_input_poll_ = (next_input_poll_ + 1) % input_polls_.size();
 	}
 
 	SDL_Event event;
 	while (SDL_PollEvent(&event)) {
+		request_redraw();
+
 		// Check for window close events FIRST (before any other processing)
 		if (event.type == SDL_EVENT_QUIT) {
 			running_ = false;
@@ -287,6 +414,11 @@ void GuiApplication::handle_events() {
 			continue;
 		}
 
+		// Slot files may have changed while we were in the background
+		if (event.type == SDL_EVENT_WINDOW_FOCUS_GAINED && save_state_manager_) {
+			save_state_manager_->refresh_slot_cache();
+		}
+
 		// Let gamepad manager handle controller events
 		if (gamepad_manager_ && gamepad_manager_->handle_sdl_event(event)) {
 			continue; // Event was handled, skip to next
@@ -295,6 +427,17 @@ void GuiApplication::handle_events() {
 		// Let ImGui process the event
 		ImGui_ImplSDL3_ProcessEvent(&event);
 
+		// Fast-forward runs for as long as Tab is held
+		if (event.type == SDL_EVENT_KEY_UP && event.key.key == SDLK_TAB) {
+			fast_forward_ = false;
+			continue;
+		}
+		// ... and rewind for as long as Backspace is
+		if (event.type == SDL_EVENT_KEY_UP && event.key.key == SDLK_BACKSPACE) {
+			set_rewinding(false);
+			continue;
+		}
+
 		// Handle hotkeys
 		if (event.type == SDL_EVENT_KEY_DOWN) {
 			// Process hotkeys even if ImGui wants keyboard (for critical functions like fullscreen/exit)
@@ -327,6 +470,10 @@ void GuiApplication::handle_events() {
 				int slot = event.key.key - SDLK_F1 + 1;
 				load_state_from_slot(slot);
 			}
+			// Screenshot (F12)
+			else if (!shift_pressed && !ctrl_pressed && !alt_pressed && event.key.key == SDLK_F12) {
+				take_screenshot();
+			}
 			// Quick save (Ctrl+F5) - always process this
 			else if (ctrl_pressed && !shift_pressed && !alt_pressed && event.key.key == SDLK_F5) {
 				quick_save();
@@ -335,17 +482,34 @@ void GuiApplication::handle_events() {
 			else if (ctrl_pressed && !shift_pressed && !alt_pressed && event.key.key == SDLK_F8) {
 				quick_load();
 			}
+			// Fast-forward while held (Tab); ignore key repeat
+			else if (!shift_pressed && !ctrl_pressed && !alt_pressed && event.key.key == SDLK_TAB &&
+					 !event.key.repeat && !io_->WantTextInput) {
+				fast_forward_ = true;
+			}
+			// Rewind while held (Backspace)
+			else if (!shift_pressed && !ctrl_pressed && !alt_pressed && event.key.key == SDLK_BACKSPACE &&
+					 !event.key.repeat && !io_->WantTextInput) {
+				set_rewinding(true);
+			}
 		}
 	}
 }
 void GuiApplication::render_frame() {
+	VIBENES_TRACE_ZONE("GuiApplication::render_frame");
+	const auto gui_start = std::chrono::steady_clock::now();
+	texture_upload_ns_ = 0;
+
 	// Start the Dear ImGui frame
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplSDL3_NewFrame();
 	ImGui::NewFrame();
 
-	// Fullscreen mode: render only the NES display
-	if (fullscreen_mode_) {
+	// Fullscreen mode (and the game-only layout): render only the NES display
+	if (fullscreen_mode_ || is_game_only_layout()) {
+		if (!fullscreen_mode_) {
+			calculate_fullscreen_layout(); // Follows the window as it is resized
+		}
 		render_fullscreen_display();
 
 		// Render ImGui — this is where ImGui::Image() is actually drawn,
@@ -353,7 +517,8 @@ void GuiApplication::render_frame() {
 		ImGui::Render();
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
-		SDL_GL_SwapWindow(window_);
+		gui_ns_ = ns_since(gui_start) - texture_upload_ns_;
+		present_frame();
 		return;
 	}
 
@@ -391,7 +556,8 @@ void GuiApplication::render_frame() {
 				ImGui::Text("ROM LOADER");
 				ImGui::Separator();
 				if (rom_loader_panel_) {
-					rom_loader_panel_->render(cartridge_.get());
+					// Loading or unloading swaps the cartridge under the emulator
+					run_exclusive([this]() { rom_loader_panel_->render(cartridge_); });
 				}
 			}
 			ImGui::EndChild();
@@ -404,7 +570,7 @@ void GuiApplication::render_frame() {
 				ImGui::Separator();
 				if (cpu_panel_) {
 					cpu_panel_->render(
-						cpu_.get(), [this]() { step_emulation(); }, [this]() { reset_system(); },
+						view_cpu(), [this]() { step_emulation(); }, [this]() { reset_system(); },
 						[this]() { toggle_run_pause(); }, is_emulation_active(), can_run_emulation());
 				}
 			}
@@ -417,7 +583,7 @@ void GuiApplication::render_frame() {
 				ImGui::Text("DISASSEMBLER");
 				ImGui::Separator();
 				if (disassembler_panel_) {
-					disassembler_panel_->render(cpu_.get(), bus_.get());
+					disassembler_panel_->render(view_cpu(), view_bus());
 				}
 			}
 			ImGui::EndChild();
@@ -436,7 +602,15 @@ void GuiApplication::render_frame() {
 				ImGui::Text("NES DISPLAY");
 				ImGui::Separator();
 				if (ppu_viewer_panel_) {
-					ppu_viewer_panel_->render_main_display(ppu_.get());
+					const auto upload_start = std::chrono::steady_clock::now();
+					if (debug_view_active_) {
+						ppu_viewer_panel_->render_main_display(emulation_thread_->get_frame(), new_frame_,
+															   emulation_thread_->get_frame_indices());
+					} else {
+						ppu_viewer_panel_->render_main_display(ppu_);
+					}
+					texture_upload_ns_ += ns_since(upload_start);
+					upload_done_at_ = std::chrono::steady_clock::now();
 				}
 			}
 			ImGui::EndChild();
@@ -449,7 +623,7 @@ void GuiApplication::render_frame() {
 				ImGui::Text("RAM VIEWER");
 				ImGui::Separator();
 				if (memory_panel_) {
-					memory_panel_->render(bus_.get());
+					memory_panel_->render(view_bus());
 				}
 			}
 			ImGui::EndChild();
@@ -468,7 +642,7 @@ void GuiApplication::render_frame() {
 				ImGui::Text("PATTERN TABLES");
 				ImGui::Separator();
 				if (ppu_viewer_panel_) {
-					ppu_viewer_panel_->render_pattern_tables(ppu_.get(), cartridge_.get());
+					ppu_viewer_panel_->render_pattern_tables(view_ppu(), view_cartridge());
 				}
 			}
 			ImGui::EndChild();
@@ -487,7 +661,7 @@ void GuiApplication::render_frame() {
 					ImGui::Text("PPU PALETTES");
 					ImGui::Separator();
 					if (ppu_viewer_panel_) {
-						ppu_viewer_panel_->render_palette_viewer(ppu_.get());
+						ppu_viewer_panel_->render_palette_viewer(view_ppu());
 					}
 				}
 				ImGui::EndChild();
@@ -499,7 +673,7 @@ void GuiApplication::render_frame() {
 					ImGui::Text("PPU INFO");
 					ImGui::Separator();
 					if (ppu_viewer_panel_) {
-						ppu_viewer_panel_->render_registers_only(ppu_.get());
+						ppu_viewer_panel_->render_registers_only(view_ppu());
 					}
 				}
 				ImGui::EndChild();
@@ -514,7 +688,8 @@ void GuiApplication::render_frame() {
 				ImGui::Text("AUDIO CONTROL");
 				ImGui::Separator();
 				if (audio_panel_) {
-					audio_panel_->render(bus_.get());
+					// Starting/stopping audio toggles APU sample output
+					run_exclusive([this]() { audio_panel_->render(bus_); });
 				}
 			}
 			ImGui::EndChild();
@@ -528,6 +703,10 @@ void GuiApplication::render_frame() {
 
 	ImGui::PopStyleVar(3);
 
+	if (show_performance_) {
+		render_performance_window();
+	}
+
 	// Display save state status message as overlay
 	if (save_state_status_timer_ > 0.0f) {
 		ImGui::SetNextWindowPos(ImVec2(WINDOW_WIDTH / 2.0f, 60.0f), ImGuiCond_Always, ImVec2(0.5f, 0.0f));
@@ -543,8 +722,8 @@ void GuiApplication::render_frame() {
 		ImGui::End();
 		ImGui::PopStyleColor(2);
 
-		// Decrease timer (approximate frame time at 60fps)
-		save_state_status_timer_ -= 0.016f;
+		// Count down in real time; idle redraws run slower than 60 Hz
+		save_state_status_timer_ -= io_->DeltaTime;
 	}
 
 	// Rendering
@@ -554,7 +733,63 @@ void GuiApplication::render_frame() {
 	glClear(GL_COLOR_BUFFER_BIT);
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
-	SDL_GL_SwapWindow(window_);
+	// The swap waits for vsync, so it would only measure the display's pace
+	gui_ns_ = ns_since(gui_start) - texture_upload_ns_;
+	present_frame();
+}
+
+void GuiApplication::render_performance_window() {
+	ImGui::SetNextWindowSize(ImVec2(460.0f, 560.0f), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Performance", &show_performance_)) {
+		// Built the first time the window is opened
+		if (!timing_panel_) {
+			timing_panel_ = std::make_unique<TimingPanel>();
+		}
+		timing_panel_->render(view_cpu(), view_ppu(), perf_counters_.get(), view_bus(), frame_latency_.get());
+	}
+	ImGui::End();
+}
+
+void GuiApplication::render_crt_quality_menu() {
+	if (ImGui::MenuItem("Auto", nullptr, crt_filter_->quality == CRTFilter::AUTO_QUALITY,
+						crt_filter_->has_gpu_timer())) {
+		crt_filter_->quality = CRTFilter::AUTO_QUALITY;
+	}
+	ImGui::SetNextItemWidth(120.0f);
+	ImGui::SliderFloat("GPU budget", &crt_filter_->gpu_budget_ms, 0.5f, 8.0f, "%.1f ms");
+	ImGui::Separator();
+
+	// What each preset costs here: GPU time at the current output size,
+	// once it has been used there
+	if (ImGui::BeginTable("CrtQuality", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+		ImGui::TableSetupColumn("Preset");
+		ImGui::TableSetupColumn("Resolution");
+		ImGui::TableSetupColumn("Effects");
+		ImGui::TableSetupColumn("GPU");
+		ImGui::TableHeadersRow();
+		for (std::size_t i = 0; i < CRTFilter::QUALITY_PRESETS.size(); ++i) {
+			const CRTFilter::QualityPreset &preset = CRTFilter::QUALITY_PRESETS[i];
+			const int index = static_cast<int>(i);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			if (ImGui::Selectable(preset.name, crt_filter_->active_quality() == index,
+								  ImGuiSelectableFlags_SpanAllColumns)) {
+				crt_filter_->quality = index;
+			}
+			ImGui::TableNextColumn();
+			ImGui::Text("%d%%", static_cast<int>(preset.resolution_scale * 100.0f));
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(preset.mask ? "all" : preset.curvature ? "no mask" : "no mask, flat");
+			ImGui::TableNextColumn();
+			const float ms = crt_filter_->measured_gpu_ms(index);
+			if (ms > 0.0f) {
+				ImGui::Text("%.2f ms", ms);
+			} else {
+				ImGui::TextDisabled("-");
+			}
+		}
+		ImGui::EndTable();
+	}
 }
 
 void GuiApplication::render_main_menu_bar() {
@@ -582,14 +817,17 @@ void GuiApplication::render_main_menu_bar() {
 			}
 
 			if (ImGui::BeginMenu("Load State")) {
+				// Answered from the manager's slot cache; nothing here touches the disk
 				for (int i = 1; i <= 9; ++i) {
 					char label[64];
-					bool slot_exists = save_state_manager_ && save_state_manager_->slot_exists(i);
+					static const nes::SaveSlotInfo no_slot;
+					const nes::SaveSlotInfo &info =
+						save_state_manager_ ? save_state_manager_->get_slot_info(i) : no_slot;
+					const bool slot_exists = info.exists;
 
 					if (slot_exists) {
-						auto timestamp = save_state_manager_->get_slot_timestamp(i);
-						if (timestamp) {
-							auto time_t_val = std::chrono::system_clock::to_time_t(*timestamp);
+						if (info.timestamp) {
+							auto time_t_val = std::chrono::system_clock::to_time_t(*info.timestamp);
 							std::tm tm_val;
 							localtime_s(&tm_val, &time_t_val);
 							snprintf(label, sizeof(label), "Slot %d (Shift+F%d) - %02d:%02d:%02d", i, i, tm_val.tm_hour,
@@ -608,6 +846,9 @@ void GuiApplication::render_main_menu_bar() {
 					if (ImGui::MenuItem(label)) {
 						load_state_from_slot(i);
 					}
+					if (ImGui::IsItemHovered()) {
+						render_slot_thumbnail(i);
+					}
 
 					if (!slot_exists) {
 						ImGui::EndDisabled();
@@ -617,13 +858,16 @@ void GuiApplication::render_main_menu_bar() {
 
 				bool quick_save_exists =
 					save_state_manager_ &&
-					std::filesystem::exists(save_state_manager_->get_save_directory() / "quicksave.vns");
+					save_state_manager_->get_slot_info(nes::SaveStateManager::QUICK_SAVE_SLOT).exists;
 				if (!quick_save_exists) {
 					ImGui::BeginDisabled();
 				}
 				if (ImGui::MenuItem("Quick Load (F8)")) {
 					quick_load();
 				}
+				if (ImGui::IsItemHovered()) {
+					render_slot_thumbnail(nes::SaveStateManager::QUICK_SAVE_SLOT);
+				}
 				if (!quick_save_exists) {
 					ImGui::EndDisabled();
 				}
@@ -635,6 +879,14 @@ void GuiApplication::render_main_menu_bar() {
 				ImGui::EndDisabled();
 			}
 
+			ImGui::Separator();
+			if (ImGui::MenuItem("Screenshot", "F12", false, rom_loaded)) {
+				take_screenshot();
+			}
+			if (ImGui::MenuItem("Record Frames", nullptr, is_recording_frames(), rom_loaded)) {
+				toggle_frame_recording();
+			}
+
 			ImGui::Separator();
 			if (ImGui::MenuItem("Exit")) {
 				running_ = false;
@@ -656,6 +908,25 @@ void GuiApplication::render_main_menu_bar() {
 					if (fullscreen_mode_)
 						calculate_fullscreen_layout();
 				}
+				if (ImGui::BeginMenu("CRT Quality", crt_filter_->enabled)) {
+					render_crt_quality_menu();
+					ImGui::EndMenu();
+				}
+			}
+			if (ImGui::MenuItem("NTSC Filter", nullptr, ntsc_filter_ != nullptr)) {
+				// The worker threads only exist while the filter is on
+				if (ntsc_filter_) {
+					ntsc_filter_.reset();
+				} else {
+					ntsc_filter_ = std::make_unique<nes::NtscFilter>();
+				}
+				if (ppu_viewer_panel_) {
+					ppu_viewer_panel_->set_ntsc_filter(ntsc_filter_.get());
+				}
+			}
+			ImGui::Separator();
+			if (ImGui::MenuItem("Performance", nullptr, show_performance_)) {
+				show_performance_ = !show_performance_;
 			}
 			ImGui::EndMenu();
 		}
@@ -690,12 +961,105 @@ void GuiApplication::render_main_menu_bar() {
 				}
 			}
 
+			if (ImGui::MenuItem("Fast Forward", "Tab", fast_forward_)) {
+				fast_forward_ = !fast_forward_;
+			}
+
+			if (ImGui::MenuItem("Rewind", "Backspace", rewind_buffer_ != nullptr)) {
+				set_rewind_enabled(!rewind_buffer_);
+			}
+
+			if (ImGui::BeginMenu("Run-Ahead")) {
+				// Hides this many frames of the game's own input lag, at the cost of
+				// emulating (and snapshotting) that much more per frame
+				for (int frames = 0; frames <= nes::EmulationThread::MAX_RUN_AHEAD_FRAMES; ++frames) {
+					const std::string label =
+						frames == 0 ? std::string("Off") : std::to_string(frames) + (frames == 1 ? " frame" : " frames");
+					if (ImGui::MenuItem(label.c_str(), nullptr, run_ahead_frames_ == frames)) {
+						run_ahead_frames_ = frames;
+						if (emulation_thread_) {
+							emulation_thread_->set_run_ahead(frames);
+						}
+					}
+				}
+				ImGui::EndMenu();
+			}
+
+			// Emulate a frame whenever the audio device wants more rather than on
+			// the host clock: steadier sound at refresh rates far from 60 Hz, and
+			// no resampler stretching
+			if (ImGui::MenuItem("Pace From Audio", nullptr, audio_pacing_)) {
+				audio_pacing_ = !audio_pacing_;
+				if (audio_pacing_) {
+					late_input_.set_mode(nes::LateInputScheduler::Mode::Off);
+				}
+				apply_pacing();
+			}
+
+			// Emulate each frame right after a gamepad poll timed to finish
+			// just before the next swap, instead of polling at the top of the
+			// display frame: up to a refresh less input lag, at the price of
+			// following the display's refresh rate
+			if (ImGui::BeginMenu("Late Input Polling")) {
+				using Mode = nes::LateInputScheduler::Mode;
+				const auto mode_item = [this](const char *label, Mode mode) {
+					if (ImGui::MenuItem(label, nullptr, late_input_.mode() == mode)) {
+						late_input_.set_mode(mode);
+						if (mode != Mode::Off) {
+							audio_pacing_ = false;
+						}
+						apply_pacing();
+					}
+				};
+				mode_item("Off", Mode::Off);
+				mode_item("Adaptive", Mode::Adaptive);
+				mode_item("Fixed", Mode::Fixed);
+				int lead_ms = static_cast<int>(
+					std::chrono::duration_cast<std::chrono::milliseconds>(late_input_.lead()).count());
+				if (ImGui::SliderInt("Lead (ms)", &lead_ms, 0, 12)) {
+					late_input_.set_lead(std::chrono::milliseconds(lead_ms));
+				}
+				if (late_input_.mode() != Mode::Off) {
+					ImGui::TextDisabled("Refresh %.2f ms, frame cost %.2f ms",
+										std::chrono::duration<double, std::milli>(late_input_.refresh_period()).count(),
+										std::chrono::duration<double, std::milli>(late_input_.cost()).count());
+				}
+				ImGui::EndMenu();
+			}
+
+			// Starts as the ROM's NES 2.0 header asks; a change lasts until
+			// the next ROM load
+			if (controllers_ && ImGui::BeginMenu("Controllers")) {
+				InputSetup setup = controllers_->setup();
+				bool changed = ImGui::MenuItem("Four Score", nullptr, &setup.four_score);
+				ImGui::SeparatorText("Port 2");
+				const auto port_item = [&](const char *label, PortDevice device) {
+					if (ImGui::MenuItem(label, nullptr, !setup.four_score && setup.port2 == device)) {
+						setup.port2 = device;
+						setup.four_score = false;
+						changed = true;
+					}
+				};
+				port_item("Controller", PortDevice::StandardPad);
+				port_item("Zapper (mouse)", PortDevice::Zapper);
+				port_item("Arkanoid Paddle (mouse)", PortDevice::ArkanoidPaddle);
+				if (changed) {
+					run_exclusive([this, setup]() { controllers_->configure(setup); });
+				}
+				ImGui::EndMenu();
+			}
+
 			if (ImGui::MenuItem("Reset", "F8")) {
 				if (cpu_) {
 					reset_system(); // Use system-wide reset instead of just CPU reset
 				}
 			}
 
+			ImGui::Separator();
+			if (ImGui::MenuItem("Code/Data Logger", nullptr, cartridge_ && cartridge_->is_cdl_enabled())) {
+				set_code_data_logging(!cartridge_->is_cdl_enabled());
+			}
+
 			if (!rom_loaded) {
 				ImGui::EndDisabled();
 			}
@@ -718,12 +1082,33 @@ void GuiApplication::shutdown() {
 }
 
 void GuiApplication::cleanup() {
+	// Join the emulation thread first; nothing else may touch the components
+	// while it runs
+	if (emulation_thread_) {
+		emulation_thread_->stop();
+	}
+	if (audio_panel_ && bus_) {
+		audio_panel_->stop_recording(bus_);
+	}
+	if (frame_latency_ && !launch_options_.latency_report_path.empty()) {
+		std::ofstream report(launch_options_.latency_report_path);
+		frame_latency_->write_report(report);
+		if (!report) {
+			std::cerr << "Failed to write latency report: " << launch_options_.latency_report_path << std::endl;
+		}
+		frame_latency_.reset();
+	}
+
 	// Shut down CRT filter (GL resources) before destroying context
 	if (crt_filter_) {
 		crt_filter_->shutdown();
 	}
 
 	if (gl_context_) {
+		if (slot_thumbnail_texture_ != 0) {
+			glDeleteTextures(1, &slot_thumbnail_texture_);
+			slot_thumbnail_texture_ = 0;
+		}
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplSDL3_Shutdown();
 		ImGui::DestroyContext();
@@ -744,12 +1129,19 @@ void GuiApplication::cleanup() {
 	if (battery_save_manager_) {
 		battery_save_manager_->flush(true);
 	}
+	save_code_data_log();
 	battery_save_manager_.reset();
-	cpu_.reset();
-	bus_.reset();
-	ppu_.reset();
-	cartridge_.reset();
-	controllers_.reset();
+	file_writer_.reset(); // Waits for the last writes
+	emulation_thread_.reset();
+	snapshot_state_manager_.reset();
+	debug_view_state_.reset();
+	debug_view_.reset();
+	cpu_ = nullptr;
+	bus_ = nullptr;
+	ppu_ = nullptr;
+	cartridge_ = nullptr;
+	controllers_ = nullptr;
+	system_.reset();
 	gamepad_manager_.reset();
 
 	SDL_Quit();
@@ -759,14 +1151,16 @@ void GuiApplication::step_emulation() {
 	if (!bus_ || !cpu_ || !ppu_)
 		return;
 
-	static int step_count = 0;
-	step_count++;
+	run_exclusive([this]() {
+		// Execute exactly one CPU instruction. PPU/APU are advanced per-cycle
+		// inside consume_cycle() (fat consume_cycle model), so no separate
+		// bus_->tick() call is needed.
+		int cycles_consumed = cpu_->execute_instruction();
+		(void)cycles_consumed; // Used only for debugging/step display
 
-	// Execute exactly one CPU instruction and get the cycles it consumed.
-	// PPU/APU are advanced per-cycle inside consume_cycle() (fat consume_cycle
-	// model), so no separate bus_->tick() call is needed.
-	int cycles_consumed = cpu_->execute_instruction();
-	(void)cycles_consumed; // Used only for debugging/step display
+		// Debug panels read the PPU directly; settle catch-up dots
+		bus_->sync_ppu();
+	});
 }
 
 void GuiApplication::step_frame() {
@@ -775,16 +1169,12 @@ void GuiApplication::step_frame() {
 
 	// Run emulation for one full frame worth of cycles
 	// NES: 341 PPU dots/scanline × 262 scanlines = 89,342 PPU dots/frame
-	// 89,342 / 3 = 29,780.67 CPU cycles/frame (NTSC)
-	constexpr int CYCLES_PER_FRAME = 29781;
-	int executed = 0;
-	while (executed < CYCLES_PER_FRAME) {
-		int consumed = cpu_->execute_instruction();
-		if (consumed <= 0)
-			break;
-		// PPU/APU already advanced per-cycle inside consume_cycle()
-		executed += consumed;
-	}
+	// 89,342 / 3 = 29,780.67 CPU cycles/frame (NTSC; PAL and Dendy are longer)
+	const uint64_t cycles_per_frame = region_timing(bus_->get_region()).cpu_cycles_per_frame() + 1;
+	run_exclusive([this, cycles_per_frame]() {
+		(void)cpu_->run_until(cpu_->get_cycle_count() + cycles_per_frame);
+		bus_->sync_ppu();
+	});
 }
 
 void GuiApplication::start_emulation() {
@@ -792,15 +1182,20 @@ void GuiApplication::start_emulation() {
 		return;
 	}
 
+	// The run command itself is posted by sync_emulation_run_state() once the
+	// current GUI frame has finished with the live components
 	emulation_running_ = true;
 	emulation_paused_ = false;
-	cycle_accumulator_ = 0.0;
-	last_frame_counter_ = SDL_GetPerformanceCounter();
-	frame_timer_initialized_ = true;
 }
 
 void GuiApplication::pause_emulation() {
 	emulation_paused_ = true;
+	// Pausing takes effect right away; panels keep using the shadow until the
+	// thread reports idle
+	if (emulation_thread_ && emulation_thread_running_) {
+		emulation_thread_->pause();
+		emulation_thread_running_ = false;
+	}
 }
 
 void GuiApplication::toggle_run_pause() {
@@ -811,103 +1206,245 @@ void GuiApplication::toggle_run_pause() {
 	}
 }
 
-void GuiApplication::process_continuous_emulation(double delta_seconds) {
-	if (!can_run_emulation() || delta_seconds <= 0.0) {
+void GuiApplication::update_fast_forward_state() {
+	const bool active = fast_forward_ && is_emulation_active();
+	if (active == fast_forward_active_) {
 		return;
 	}
+	fast_forward_active_ = active;
 
-	const double cpu_cycles_per_second = static_cast<double>(CPU_CLOCK_NTSC);
-	cycle_accumulator_ += delta_seconds * cpu_cycles_per_second * static_cast<double>(emulation_speed_);
-	const auto target_cycles = static_cast<std::int64_t>(cycle_accumulator_);
-	if (target_cycles <= 0) {
-		return;
+	// The thread drops its frame deadline; the GUI keeps presenting at the
+	// display refresh and simply shows the newest frame each time
+	if (emulation_thread_) {
+		emulation_thread_->set_fast_forward(active);
 	}
 
-	// Safety check: Prevent infinite loops from excessive delta_seconds
-	const std::int64_t MAX_CYCLES_PER_FRAME = 100000; // ~56ms worth of CPU cycles (safe upper bound)
-	if (target_cycles > MAX_CYCLES_PER_FRAME) {
-		cycle_accumulator_ = static_cast<double>(MAX_CYCLES_PER_FRAME);
-		const auto capped_target = MAX_CYCLES_PER_FRAME;
-
-		std::int64_t executed_cycles = 0;
-		std::int64_t instruction_count = 0;
-		while (executed_cycles < capped_target) {
-			int consumed = cpu_->execute_instruction();
-			if (consumed <= 0) {
-				std::cerr << "[ERROR] CPU execute_instruction returned " << consumed << " cycles. Breaking loop."
-						  << std::endl;
-				break;
+	run_exclusive([this, active]() {
+		if (active) {
+			// Samples produced several times faster than real time would only overrun
+			// the device queue, so mute until normal speed resumes
+			fast_forward_muted_audio_ = bus_ && bus_->is_audio_playing();
+			if (fast_forward_muted_audio_) {
+				bus_->stop_audio();
 			}
-			// PPU/APU already advanced per-cycle inside consume_cycle()
-			executed_cycles += consumed;
-			instruction_count++;
-
-			// Safety timeout: prevent true infinite loops
-			if (instruction_count > 50000) {
-				std::cerr << "[CRITICAL] Executed 50000 instructions without reaching target. Possible infinite loop "
-							 "detected!"
-						  << std::endl;
-				pause_emulation();
-				break;
+		} else {
+			if (fast_forward_muted_audio_ && bus_) {
+				if (auto *audio_output = bus_->get_audio_output()) {
+					audio_output->clear_buffer();
+				}
+				bus_->start_audio();
 			}
+			fast_forward_muted_audio_ = false;
 		}
-		cycle_accumulator_ = 0.0;
+	});
+}
+
+void GuiApplication::set_rewind_enabled(bool enabled) {
+	if (enabled == (rewind_buffer_ != nullptr)) {
 		return;
 	}
+	set_rewinding(false);
+	// The thread pushes into the buffer every frame, so swap it only while parked
+	std::unique_ptr<nes::RewindBuffer> buffer = enabled ? std::make_unique<nes::RewindBuffer>() : nullptr;
+	run_exclusive([this, &buffer]() {
+		if (emulation_thread_) {
+			emulation_thread_->set_rewind_buffer(buffer.get());
+		}
+	});
+	rewind_buffer_ = std::move(buffer);
+}
 
-	cycle_accumulator_ -= static_cast<double>(target_cycles);
+void GuiApplication::set_rewinding(bool rewinding) {
+	rewinding = rewinding && rewind_buffer_ != nullptr;
+	if (rewinding == rewinding_) {
+		return;
+	}
+	rewinding_ = rewinding;
+	if (emulation_thread_) {
+		emulation_thread_->set_rewinding(rewinding);
+	}
+}
 
-	std::int64_t executed_cycles = 0;
-	std::int64_t instruction_count = 0;
+void GuiApplication::update_emulation_thread() {
+	if (!emulation_thread_) {
+		return;
+	}
 
-	// Debug: Periodic hang detection
-	auto loop_start_time = std::chrono::steady_clock::now();
+	// Forward controller state; the Controller only sees the latched copy
+	if (gamepad_manager_) {
+		for (int player = 0; player < static_cast<int>(posted_buttons_.size()); ++player) {
+			const nes::Byte buttons = gamepad_manager_->read_buttons(player);
+			if (buttons != posted_buttons_[player]) {
+				posted_buttons_[player] = buttons;
+				emulation_thread_->set_buttons(player, buttons);
+			}
+		}
+	}
 
-	while (executed_cycles < target_cycles) {
-		// Every 5000 instructions, check if we're taking too long
-		if (instruction_count > 0 && instruction_count % 5000 == 0) {
-			auto now = std::chrono::steady_clock::now();
-			auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - loop_start_time).count();
-			if (elapsed_ms > 500) { // More than 500ms stuck
-				std::cerr << "[HANG] Emulation loop stuck for " << elapsed_ms << "ms after " << instruction_count
-						  << " instructions (" << executed_cycles << "/" << target_cycles << " cycles). PC=0x"
-						  << std::hex << cpu_->get_program_counter() << std::dec << std::endl;
-				pause_emulation();
-				break;
+	// Late input: the frames owed since the last poll are emulated now, with
+	// the buttons just posted, and shown at the coming swap
+	late_input_polled_at_ = {};
+	if (is_late_input_active()) {
+		const auto now = std::chrono::steady_clock::now();
+		late_input_polled_at_ = now;
+		const double frame_seconds = 1.0 / region_timing(bus_->get_region()).frames_per_second() / emulation_speed_;
+		late_input_.set_frame_period(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(frame_seconds)));
+		const int due = late_input_.frames_due(now);
+		if (due > 0) {
+			const std::uint64_t target = emulation_thread_->get_frames_emulated() + static_cast<std::uint64_t>(due);
+			for (int frame = 0; frame < due; ++frame) {
+				emulation_thread_->request_frame();
 			}
+			// Never hold the UI longer than a refresh (or the idle period before one is measured)
+			const auto refresh = late_input_.refresh_period();
+			emulation_thread_->wait_for_frames(
+				target, now + (refresh > std::chrono::steady_clock::duration::zero() ? refresh : IDLE_FRAME_PERIOD));
 		}
+	}
 
-		int consumed = cpu_->execute_instruction();
-		if (consumed <= 0) {
-			std::cerr << "[ERROR] CPU execute_instruction returned " << consumed << " cycles. Breaking loop."
-					  << std::endl;
-			break;
+	// The thread pauses itself when a frame never completes (jammed CPU)
+	if (emulation_thread_->take_fault()) {
+		emulation_paused_ = true;
+		emulation_thread_running_ = false;
+		show_save_state_status("Emulation halted: frame never completed", false);
+	}
+	if (emulation_thread_->take_breakpoint_hit()) {
+		emulation_paused_ = true;
+		emulation_thread_running_ = false;
+		char message[64];
+		snprintf(message, sizeof(message), "Breakpoint hit at $%04X", cpu_->get_program_counter());
+		show_save_state_status(message, true);
+	}
+
+	new_frame_ = emulation_thread_->update_frame();
+
+	// Once the thread is idle the live components are safe to read directly;
+	// until then the panels inspect the shadow, at most a frame behind
+	debug_view_active_ = !emulation_thread_->is_idle();
+	if (debug_view_active_) {
+		if (emulation_thread_->update_snapshot() && debug_view_state_) {
+			debug_view_state_->deserialize_state(emulation_thread_->get_snapshot());
 		}
-		// PPU/APU already advanced per-cycle inside consume_cycle()
-		executed_cycles += consumed;
-		instruction_count++;
-
-		// Safety timeout: prevent true infinite loops (50000 instructions = ~250K cycles = ~140ms)
-		if (instruction_count > 50000) {
-			std::cerr << "[CRITICAL] Executed 50000 instructions (" << executed_cycles << "/" << target_cycles
-					  << " cycles) without reaching target. Possible infinite loop detected!" << std::endl;
-			std::cerr << "[DEBUG] Last PC: 0x" << std::hex << cpu_->get_program_counter() << std::dec << std::endl;
-			pause_emulation();
-			break;
+		emulation_thread_->request_snapshot();
+		scanline_timelines_.update();
+	}
+	if (ppu_viewer_panel_) {
+		ppu_viewer_panel_->set_scanline_timeline(debug_view_active_ ? &scanline_timelines_.read_buffer() : nullptr);
+	}
+}
+
+void GuiApplication::present_frame() {
+	const auto swap_start = std::chrono::steady_clock::now();
+	{
+		VIBENES_TRACE_ZONE("SDL_GL_SwapWindow");
+		SDL_GL_SwapWindow(window_);
+	}
+	// Everything between the late poll and the swap is what the next poll
+	// has to leave room for
+	late_input_.on_swap(std::chrono::steady_clock::now());
+	if (late_input_polled_at_ != std::chrono::steady_clock::time_point{}) {
+		late_input_.record_cost(swap_start - late_input_polled_at_);
+	}
+	// Only swaps that show a newly emulated frame count; repeats of the last
+	// one (paused, or a refresh rate above the frame rate) carry no latency
+	if (!frame_latency_ || !new_frame_ || !debug_view_active_) {
+		return;
+	}
+	nes::FrameLatency::Presentation presentation;
+	presentation.swap_done = std::chrono::steady_clock::now();
+	presentation.upload_done = upload_done_at_;
+	presentation.frame_completed = emulation_thread_->get_frame_completed_at();
+	presentation.input_poll = input_poll_before(emulation_thread_->get_frame_started_at());
+	frame_latency_->record(presentation);
+}
+
+std::chrono::steady_clock::time_point
+GuiApplication::input_poll_before(std::chrono::steady_clock::time_point time) const {
+	// The newest poll the thread could have applied before starting the frame
+	std::chrono::steady_clock::time_point latest{};
+	for (const auto poll : input_polls_) {
+		if (poll <= time && poll > latest) {
+			latest = poll;
 		}
 	}
+	return latest;
+}
+
+void GuiApplication::sync_emulation_run_state() {
+	if (!emulation_thread_) {
+		return;
+	}
+	const bool want_running = is_emulation_active() && can_run_emulation();
+	if (want_running == emulation_thread_running_) {
+		return;
+	}
+	emulation_thread_running_ = want_running;
+	if (want_running) {
+		emulation_thread_->run();
+	} else {
+		emulation_thread_->pause();
+	}
+}
 
-	cycle_accumulator_ += static_cast<double>(executed_cycles - target_cycles);
+void GuiApplication::run_exclusive(const std::function<void()> &fn) {
+	if (emulation_thread_) {
+		emulation_thread_->exclusive(fn);
+	} else {
+		fn();
+	}
 }
 
 bool GuiApplication::can_run_emulation() const {
 	return cpu_ && bus_ && ppu_ && cartridge_ && cartridge_->is_loaded();
 }
 
+void GuiApplication::apply_pacing() {
+	if (!emulation_thread_) {
+		return;
+	}
+	using Pacing = nes::EmulationThread::Pacing;
+	if (late_input_.mode() != nes::LateInputScheduler::Mode::Off) {
+		emulation_thread_->set_pacing(Pacing::Host);
+	} else {
+		emulation_thread_->set_pacing(audio_pacing_ ? Pacing::Audio : Pacing::Clock);
+	}
+}
+
+bool GuiApplication::is_late_input_active() const {
+	// Fast-forward runs uncapped on the thread; nothing to schedule
+	return late_input_.mode() != nes::LateInputScheduler::Mode::Off && emulation_thread_ &&
+		   emulation_thread_running_ && !fast_forward_active_;
+}
+
 bool GuiApplication::is_emulation_active() const {
 	return emulation_running_ && !emulation_paused_;
 }
 
+bool GuiApplication::is_ui_animating() const {
+	return save_state_status_timer_ > 0.0f || rewinding_ || fast_forward_;
+}
+
+void GuiApplication::request_redraw() {
+	idle_redraw_frames_ = IDLE_SETTLE_FRAMES;
+}
+
+nes::CPU6502 *GuiApplication::view_cpu() const {
+	return debug_view_active_ && debug_view_ ? &debug_view_->cpu() : cpu_;
+}
+
+nes::PPU *GuiApplication::view_ppu() const {
+	return debug_view_active_ && debug_view_ ? &debug_view_->ppu() : ppu_;
+}
+
+nes::SystemBus *GuiApplication::view_bus() const {
+	return debug_view_active_ && debug_view_ ? &debug_view_->bus() : bus_;
+}
+
+nes::Cartridge *GuiApplication::view_cartridge() const {
+	return debug_view_active_ && debug_view_ ? &debug_view_->cartridge() : cartridge_;
+}
+
 void GuiApplication::reset_system() {
 	if (!bus_) {
 		std::cerr << "Cannot reset system: SystemBus not initialized" << std::endl;
@@ -916,67 +1453,148 @@ void GuiApplication::reset_system() {
 
 	// Reset the entire NES system through the SystemBus
 	// This resets all connected components in the proper order
-	bus_->reset();
-
+	//
 	// A real NES keeps running after the reset button is pressed, so preserve
 	// the current run/pause state instead of forcing a pause. The game simply
 	// restarts from its reset vector and keeps going.
-	cycle_accumulator_ = 0.0;
+	run_exclusive([this]() { bus_->reset(); });
 }
 
 void GuiApplication::setup_callbacks() {
 	if (rom_loader_panel_ && cpu_) {
-		rom_loader_panel_->set_rom_loaded_callback([this]() {
-			// Reconnect cartridge to PPU to update mirroring mode from newly loaded ROM
-			ppu_->connect_cartridge(cartridge_);
-
-			// Reset the entire system (including PPU, mapper, etc.) when ROM is loaded
-			// This ensures all components start in a clean state
-			if (bus_) {
-				bus_->reset();
-			}
+		rom_loader_panel_->set_rom_loaded_callback(
+			[this](const nes::PreloadedRom *preloaded) { on_rom_loaded(preloaded); });
+	}
+}
 
-			// Restore battery-backed PRG-RAM (.sav) for the newly loaded ROM. Must
-			// happen AFTER the reset so the mapper's power-on PRG-RAM clear doesn't
-			// wipe the restored save.
-			if (battery_save_manager_) {
-				battery_save_manager_->load_for_current_rom();
-			}
-		});
+void GuiApplication::on_rom_loaded(const nes::PreloadedRom *preloaded) {
+	// Pick up the newly loaded ROM's mirroring mode and region, then reset the
+	// entire system (including PPU, mapper, etc.) so all components start in
+	// a clean state
+	if (system_) {
+		system_->refresh_cartridge();
+		system_->reset();
+	}
+
+	// Restore battery-backed PRG-RAM (.sav) for the newly loaded ROM. Must
+	// happen AFTER the reset so the mapper's power-on PRG-RAM clear doesn't
+	// wipe the restored save.
+	if (battery_save_manager_) {
+		if (preloaded && preloaded->save_read) {
+			battery_save_manager_->restore(preloaded->save);
+		} else {
+			battery_save_manager_->load_for_current_rom();
+		}
+	}
+
+	load_code_data_log();
+
+	if (disassembler_panel_) {
+		disassembler_panel_->reset_code_log();
+	}
+
+#ifdef VIBENES_CPU_PROFILER
+	// Start a fresh profile keyed to the new ROM's PRG banks
+	if (cpu_profiler_) {
+		cpu_profiler_->attach_cartridge(cartridge_);
+	}
+#endif
+
+	// Keep the debugger shadow on the same ROM so snapshots restore into it
+	if (debug_view_ && cartridge_->is_loaded()) {
+		debug_view_->load_rom_image(cartridge_->get_rom_image());
 	}
 }
 
+bool GuiApplication::load_launch_rom() {
+	if (!cartridge_) {
+		return false;
+	}
+	// Prefetched by initialize(): normally ready by now
+	const nes::PreloadedRom rom =
+		rom_preloader_->take(launch_options_.rom_path, battery_save_path(launch_options_.rom_path));
+	bool loaded = false;
+	run_exclusive([this, &rom, &loaded]() {
+		loaded = rom.image && cartridge_->load_rom_image(rom.image);
+		if (loaded) {
+			on_rom_loaded(&rom);
+			// The audio panel starts the device on its first render, which
+			// the fullscreen and game-only layouts never do
+			bus_->start_audio();
+		}
+	});
+	if (!loaded) {
+		std::cerr << "Failed to load ROM: " << launch_options_.rom_path << std::endl;
+		show_save_state_status("Failed to load " + launch_options_.rom_path, false);
+		return false;
+	}
+	if (ppu_viewer_panel_) {
+		ppu_viewer_panel_->refresh_pattern_tables();
+	}
+	start_emulation();
+	return true;
+}
+
+std::filesystem::path GuiApplication::battery_save_path(const std::string &rom_path) const {
+	return nes::BatterySaveManager::path_for_rom(nes::get_battery_directory(), rom_path, ".sav");
+}
+
+bool GuiApplication::is_game_only_layout() const {
+	return !launch_options_.debug_ui;
+}
+
 // =============================================================================
 // Save State Implementation
 // =============================================================================
 
-void GuiApplication::save_state_to_slot(int slot) {
-	if (!save_state_manager_ || !cartridge_ || !cartridge_->is_loaded()) {
-		show_save_state_status("No ROM loaded!", false);
+void GuiApplication::set_code_data_logging(bool enabled) {
+	if (!cartridge_) {
 		return;
 	}
-
-	// Pause emulation during save
-	bool was_running = emulation_running_ && !emulation_paused_;
-	if (was_running) {
-		pause_emulation();
+	if (!enabled) {
+		save_code_data_log();
 	}
+	// The emulation thread logs through the cartridge: switch between frames
+	run_exclusive([this, enabled]() {
+		cartridge_->set_cdl_enabled(enabled);
+		load_code_data_log();
+	});
+}
 
-	bool success = save_state_manager_->save_to_slot(slot);
+void GuiApplication::load_code_data_log() {
+	if (!cartridge_ || !cartridge_->is_cdl_enabled() || !battery_save_manager_) {
+		return;
+	}
+	const std::filesystem::path path = battery_save_manager_->companion_path(".cdl");
+	if (!path.empty() && std::filesystem::exists(path)) {
+		cartridge_->get_cdl().load(path);
+	}
+}
 
-	if (success) {
-		char message[64];
-		snprintf(message, sizeof(message), "Saved to slot %d", slot);
-		show_save_state_status(message, true);
-	} else {
-		const std::string &error = save_state_manager_->get_last_error();
-		show_save_state_status("Save failed: " + error, false);
+void GuiApplication::save_code_data_log() {
+	if (!cartridge_ || !cartridge_->is_cdl_enabled() || !battery_save_manager_) {
+		return;
 	}
+	const std::filesystem::path path = battery_save_manager_->companion_path(".cdl");
+	if (!path.empty()) {
+		cartridge_->get_cdl().save(path);
+	}
+}
 
-	// Resume if it was running
-	if (was_running) {
-		start_emulation();
+void GuiApplication::save_state_to_slot(int slot) {
+	if (!save_state_manager_ || !cartridge_ || !cartridge_->is_loaded()) {
+		show_save_state_status("No ROM loaded!", false);
+		return;
 	}
+
+	// Serialize with the emulation thread parked at an instruction boundary;
+	// the file is written after it resumes
+	run_exclusive([&]() { pending_save_ = save_state_manager_->save_to_slot_async(slot, *file_writer_); });
+
+	char message[64];
+	snprintf(message, sizeof(message), "Saved to slot %d", slot);
+	pending_save_message_ = message;
+	check_pending_save();
 }
 
 void GuiApplication::load_state_from_slot(int slot) {
@@ -985,6 +1603,7 @@ void GuiApplication::load_state_from_slot(int slot) {
 		return;
 	}
 
+	file_writer_->wait_idle(); // A save to this slot may still be on its way
 	if (!save_state_manager_->slot_exists(slot)) {
 		char message[64];
 		snprintf(message, sizeof(message), "Slot %d is empty", slot);
@@ -992,19 +1611,16 @@ void GuiApplication::load_state_from_slot(int slot) {
 		return;
 	}
 
-	// Pause emulation during load
-	bool was_running = emulation_running_ && !emulation_paused_;
-	if (was_running) {
-		pause_emulation();
-	}
-
-	bool success = save_state_manager_->load_from_slot(slot);
-
-	if (success) {
+	bool success = false;
+	run_exclusive([&]() {
+		success = save_state_manager_->load_from_slot(slot);
 		// Reset controller state after load to prevent stale strobe/shift register desync
-		if (controllers_) {
+		if (success && controllers_) {
 			controllers_->reset();
 		}
+	});
+
+	if (success) {
 		char message[64];
 		snprintf(message, sizeof(message), "Loaded from slot %d", slot);
 		show_save_state_status(message, true);
@@ -1012,11 +1628,6 @@ void GuiApplication::load_state_from_slot(int slot) {
 		const std::string &error = save_state_manager_->get_last_error();
 		show_save_state_status("Load failed: " + error, false);
 	}
-
-	// Resume if it was running
-	if (was_running) {
-		start_emulation();
-	}
 }
 
 void GuiApplication::quick_save() {
@@ -1025,52 +1636,147 @@ void GuiApplication::quick_save() {
 		return;
 	}
 
-	bool was_running = emulation_running_ && !emulation_paused_;
-	if (was_running) {
-		pause_emulation();
+	run_exclusive([&]() { pending_save_ = save_state_manager_->quick_save_async(*file_writer_); });
+	pending_save_message_ = "Quick save successful";
+	check_pending_save();
+}
+
+void GuiApplication::quick_load() {
+	if (!save_state_manager_ || !cartridge_ || !cartridge_->is_loaded()) {
+		show_save_state_status("No ROM loaded!", false);
+		return;
 	}
 
-	bool success = save_state_manager_->quick_save();
+	file_writer_->wait_idle();
+	bool success = false;
+	run_exclusive([&]() {
+		success = save_state_manager_->quick_load();
+		// Reset controller state after load to prevent stale strobe/shift register desync
+		if (success && controllers_) {
+			controllers_->reset();
+		}
+	});
 
 	if (success) {
-		show_save_state_status("Quick save successful", true);
+		show_save_state_status("Quick load successful", true);
 	} else {
 		const std::string &error = save_state_manager_->get_last_error();
-		show_save_state_status("Quick save failed: " + error, false);
+		show_save_state_status("Quick load failed: " + error, false);
 	}
+}
 
-	if (was_running) {
-		start_emulation();
+void GuiApplication::check_pending_save() {
+	if (pending_screenshot_.valid() &&
+		pending_screenshot_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		const nes::FileWriteResult result = pending_screenshot_.get();
+		show_save_state_status(result.ok ? "Saved " + pending_screenshot_name_ : "Screenshot failed: " + result.error,
+							   result.ok);
+	}
+	if (!pending_save_.valid() || pending_save_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		return;
+	}
+	const nes::FileWriteResult result = pending_save_.get();
+	if (result.ok) {
+		show_save_state_status(pending_save_message_, true);
+	} else {
+		// The slot cache already showed the save; put it back to what is on disk
+		save_state_manager_->refresh_slot_cache();
+		show_save_state_status("Save failed: " + result.error, false);
 	}
 }
 
-void GuiApplication::quick_load() {
-	if (!save_state_manager_ || !cartridge_ || !cartridge_->is_loaded()) {
-		show_save_state_status("No ROM loaded!", false);
+namespace {
+
+// Local time as YYYYMMDD_HHMMSS, for capture file names
+std::string capture_timestamp() {
+	const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	std::tm tm_val;
+	localtime_s(&tm_val, &now);
+	char stamp[32];
+	snprintf(stamp, sizeof(stamp), "%04d%02d%02d_%02d%02d%02d", tm_val.tm_year + 1900, tm_val.tm_mon + 1,
+			 tm_val.tm_mday, tm_val.tm_hour, tm_val.tm_min, tm_val.tm_sec);
+	return stamp;
+}
+
+} // namespace
+
+void GuiApplication::take_screenshot() {
+	if (!cartridge_ || !cartridge_->is_loaded() || pending_screenshot_.valid()) {
 		return;
 	}
-
-	bool was_running = emulation_running_ && !emulation_paused_;
-	if (was_running) {
-		pause_emulation();
+	// The frame on screen: the thread's latest while it runs, else the PPU's
+	const std::uint32_t *shown = debug_view_active_ ? emulation_thread_->get_frame() : ppu_->get_frame_buffer();
+	if (!shown) {
+		return;
 	}
+	std::vector<std::uint32_t> pixels(shown, shown + nes::FrameCapture::FRAME_WIDTH * nes::FrameCapture::FRAME_HEIGHT);
+	const std::filesystem::path path = nes::get_captures_directory() / ("screenshot_" + capture_timestamp() + ".png");
+	pending_screenshot_name_ = path.filename().string();
+	pending_screenshot_ = std::async(std::launch::async, [pixels = std::move(pixels), path]() {
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+		const std::vector<std::uint8_t> png = nes::encode_frame_png(pixels.data());
+		return nes::AsyncFileWriter::write_file(path, png);
+	});
+}
 
-	bool success = save_state_manager_->quick_load();
+bool GuiApplication::is_recording_frames() const {
+	return frame_recording_ != nullptr;
+}
 
-	if (success) {
-		// Reset controller state after load to prevent stale strobe/shift register desync
-		if (controllers_) {
-			controllers_->reset();
-		}
-		show_save_state_status("Quick load successful", true);
-	} else {
-		const std::string &error = save_state_manager_->get_last_error();
-		show_save_state_status("Quick load failed: " + error, false);
+void GuiApplication::toggle_frame_recording() {
+	if (frame_recording_) {
+		std::unique_ptr<nes::FrameCapture> recording;
+		run_exclusive([&]() { recording = std::move(frame_recording_); });
+		const bool ok = recording->close(); // Drains the queue off the emulation thread
+		show_save_state_status(std::format("Recorded {} frames ({} dropped)", recording->frames_written(),
+										   recording->dropped_frames()),
+							   ok);
+		return;
+	}
+	// A PNG per frame, encoded on all cores; a frame is dropped rather than
+	// stall emulation if the encoders ever fall a pool behind
+	auto recording = std::make_unique<nes::FrameCapture>();
+	nes::FrameCapture::Options options;
+	options.pool_frames = 16;
+	options.workers = 0;
+	const std::filesystem::path dir = nes::get_captures_directory() / ("frames_" + capture_timestamp());
+	if (!recording->open(dir, nes::FrameCapture::Format::PngSequence, options)) {
+		show_save_state_status("Cannot record to " + dir.string(), false);
+		return;
 	}
+	run_exclusive([&]() { frame_recording_ = std::move(recording); });
+	show_save_state_status("Recording frames to " + dir.filename().string(), true);
+}
 
-	if (was_running) {
-		start_emulation();
+void GuiApplication::render_slot_thumbnail(int slot) {
+	if (!save_state_manager_) {
+		return;
+	}
+	const nes::SaveSlotInfo &info = save_state_manager_->get_slot_info(slot);
+	if (info.thumbnail.empty()) {
+		return;
 	}
+
+	if (slot_thumbnail_texture_ == 0) {
+		glGenTextures(1, &slot_thumbnail_texture_);
+		glBindTexture(GL_TEXTURE_2D, slot_thumbnail_texture_);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, nes::SAVE_THUMBNAIL_WIDTH, nes::SAVE_THUMBNAIL_HEIGHT, 0, GL_RGBA,
+					 GL_UNSIGNED_BYTE, nullptr);
+	}
+	// 15 KB, and only while an item is hovered
+	glBindTexture(GL_TEXTURE_2D, slot_thumbnail_texture_);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, nes::SAVE_THUMBNAIL_WIDTH, nes::SAVE_THUMBNAIL_HEIGHT, GL_RGBA,
+					GL_UNSIGNED_BYTE, info.thumbnail.data());
+
+	ImGui::BeginTooltip();
+	ImGui::Image(static_cast<ImTextureID>(static_cast<intptr_t>(slot_thumbnail_texture_)),
+				 ImVec2(nes::SAVE_THUMBNAIL_WIDTH * 2.0f, nes::SAVE_THUMBNAIL_HEIGHT * 2.0f));
+	ImGui::EndTooltip();
 }
 
 void GuiApplication::show_save_state_status(const std::string &message, [[maybe_unused]] bool success) {
@@ -1092,10 +1798,17 @@ void GuiApplication::toggle_fullscreen() {
 }
 
 void GuiApplication::calculate_fullscreen_layout() {
-	// Get current display dimensions
-	SDL_DisplayID display_id = SDL_GetPrimaryDisplay();
-	const SDL_DisplayMode *display_mode = SDL_GetCurrentDisplayMode(display_id);
-	if (!display_mode) {
+	// Get current display dimensions (the window's, for the windowed game-only layout)
+	int screen_px_w = 0;
+	int screen_px_h = 0;
+	if (fullscreen_mode_ || !SDL_GetWindowSize(window_, &screen_px_w, &screen_px_h)) {
+		SDL_DisplayID display_id = SDL_GetPrimaryDisplay();
+		if (const SDL_DisplayMode *display_mode = SDL_GetCurrentDisplayMode(display_id)) {
+			screen_px_w = display_mode->w;
+			screen_px_h = display_mode->h;
+		}
+	}
+	if (screen_px_w <= 0 || screen_px_h <= 0) {
 		fullscreen_scale_ = 1.0f;
 		fullscreen_offset_x_ = 0.0f;
 		fullscreen_offset_y_ = 0.0f;
@@ -1104,8 +1817,8 @@ void GuiApplication::calculate_fullscreen_layout() {
 		return;
 	}
 
-	const float screen_w = static_cast<float>(display_mode->w);
-	const float screen_h = static_cast<float>(display_mode->h);
+	const float screen_w = static_cast<float>(screen_px_w);
+	const float screen_h = static_cast<float>(screen_px_h);
 
 	// NES display dimensions accounting for NTSC pixel aspect ratio.
 	// Height uses the (possibly cropped) active-image height so the visible
@@ -1137,7 +1850,15 @@ void GuiApplication::render_fullscreen_display() {
 	}
 
 	// Update the PPU display texture
-	ppu_viewer_panel_->update_display_texture_only(ppu_.get());
+	const auto upload_start = std::chrono::steady_clock::now();
+	if (debug_view_active_) {
+		ppu_viewer_panel_->update_display_texture_only(emulation_thread_->get_frame(), new_frame_,
+													   emulation_thread_->get_frame_indices());
+	} else {
+		ppu_viewer_panel_->update_display_texture_only(ppu_);
+	}
+	texture_upload_ns_ += ns_since(upload_start);
+	upload_done_at_ = std::chrono::steady_clock::now();
 
 	// Clear to black for letterboxing
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -1176,7 +1897,7 @@ void GuiApplication::render_fullscreen_display() {
 			bool use_linear;
 			if (crt_filter_ && crt_filter_->enabled) {
 				display_texture = crt_filter_->apply(texture_id, static_cast<int>(full_w), static_cast<int>(full_h));
-				use_linear = true; // CRT output is already at display resolution
+				use_linear = true; // Display resolution, or below it on a reduced quality preset
 			} else {
 				// Soft-pixels mode uses bilinear sampling; otherwise crisp nearest.
 				use_linear = crt_filter_ && crt_filter_->soft_pixels;
@@ -1199,6 +1920,23 @@ void GuiApplication::render_fullscreen_display() {
 
 			// Restore the default sampler for the rest of the UI.
 			draw_list->AddCallback(platform_io.DrawCallback_ResetRenderState, nullptr);
+
+			// The mouse aims a Zapper, or turns a paddle's knob, over the picture
+			if (controllers_ && !(controllers_->setup().port1 == PortDevice::StandardPad &&
+								  controllers_->setup().port2 == PortDevice::StandardPad)) {
+				const ImVec2 origin = ImGui::GetItemRectMin();
+				const ImVec2 mouse = ImGui::GetIO().MousePos;
+				const float u = (mouse.x - origin.x) / display_size.x;
+				const float v = uv0.y + (mouse.y - origin.y) / display_size.y * (uv1.y - uv0.y);
+				PointerState pointer;
+				pointer.fire = ImGui::IsMouseDown(ImGuiMouseButton_Left);
+				if (u >= 0.0f && u < 1.0f && v >= uv0.y && v < uv1.y) {
+					pointer.x = static_cast<std::int16_t>(u * 256.0f);
+					pointer.y = static_cast<std::int16_t>(v * 240.0f);
+				}
+				input_latch_->set_pointer(0, pointer);
+				input_latch_->set_pointer(1, pointer);
+			}
 		}
 	}
 	ImGui::End();
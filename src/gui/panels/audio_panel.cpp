@@ -1,5 +1,7 @@
 #include "gui/panels/audio_panel.hpp"
+#include "audio/audio_backend.hpp"
 #include "gui/style/retro_theme.hpp"
+#include <format>
 #include <imgui.h>
 
 namespace nes {
@@ -17,7 +19,27 @@ void AudioPanel::render(SystemBus *bus) {
 	}
 
 	render_controls(bus);
+	render_expansion(bus);
 	// Removed level meter and info sections - only show controls
+	render_latency(bus);
+	render_recording(bus);
+}
+
+void AudioPanel::stop_recording(SystemBus *bus) {
+	if (!recorder_) {
+		return;
+	}
+	bus->set_audio_recorder(nullptr);
+	const std::uint64_t samples = recorder_->samples_written(AudioRecorder::Track::Mix);
+	const std::uint64_t dropped = recorder_->dropped_samples();
+	if (!recorder_->close()) {
+		record_status_ = "Write failed";
+	} else if (dropped != 0) {
+		record_status_ = std::format("Saved ({} samples dropped)", dropped);
+	} else {
+		record_status_ = std::format("Saved {:.1f} s", static_cast<double>(samples) / bus->get_audio_sample_rate());
+	}
+	recorder_.reset();
 }
 
 void AudioPanel::render_controls(SystemBus *bus) {
@@ -69,6 +91,25 @@ void AudioPanel::render_controls(SystemBus *bus) {
 	}
 }
 
+void AudioPanel::render_expansion(SystemBus *bus) {
+	const char *chip = bus->get_expansion_audio_name();
+	if (!chip) {
+		return;
+	}
+	// Boards differ in how loud the chip sits against the 2A03 (and
+	// Famicoms by model), so let the listener set it
+	float gain = bus->get_expansion_audio_gain();
+	ImGui::Text("%s audio:", chip);
+	ImGui::SetNextItemWidth(ImGui::CalcItemWidth() * 0.8f);
+	if (ImGui::SliderFloat("##expansion_gain", &gain, 0.0f, 2.0f, "%.2fx")) {
+		bus->set_expansion_audio_gain(gain);
+	}
+	ImGui::SameLine();
+	if (ImGui::SmallButton("Reset##expansion_gain")) {
+		bus->set_expansion_audio_gain(1.0f);
+	}
+}
+
 void AudioPanel::render_level_meter(SystemBus *bus) {
 	(void)bus; // Reserved for future use to query actual audio levels
 	ImGui::Text("Audio Level");
@@ -116,4 +157,73 @@ void AudioPanel::render_info(SystemBus *bus) {
 	ImGui::Text("  Downsampling: ~40.58:1");
 }
 
+void AudioPanel::render_latency(SystemBus *bus) {
+	auto *backend = dynamic_cast<AudioBackend *>(bus->get_audio_output());
+	if (!backend) {
+		return;
+	}
+	LatencyController &latency = backend->latency();
+	const LatencyController::Stats stats = latency.stats();
+
+	ImGui::Separator();
+	bool adaptive = latency.is_adaptive();
+	if (ImGui::Checkbox("Adaptive latency", &adaptive)) {
+		latency.set_adaptive(adaptive);
+	}
+	ImGui::SameLine();
+	ImGui::Text("Target %.0f ms, queued %.0f ms", latency.to_ms(stats.target), latency.to_ms(stats.fill));
+	ImGui::Text("Callback %.2f ms (jitter %.2f ms, %zu frames)", stats.callback_interval_ms, stats.callback_jitter_ms,
+				stats.largest_pull);
+	if (stats.device_rate_hz > 0.0) {
+		ImGui::Text("Device %.1f Hz (%+.0f ppm)", stats.device_rate_hz, stats.drift_ppm);
+	} else {
+		ImGui::TextUnformatted("Device rate: measuring...");
+	}
+	ImGui::SameLine();
+	if (stats.underruns != 0) {
+		ImGui::TextColored(RetroTheme::NES_RED, "Underruns: %llu", static_cast<unsigned long long>(stats.underruns));
+	} else {
+		ImGui::TextUnformatted("Underruns: 0");
+	}
+}
+
+void AudioPanel::render_recording(SystemBus *bus) {
+	ImGui::Separator();
+	const bool recording = recorder_ != nullptr;
+
+	ImGui::BeginDisabled(recording);
+	ImGui::SetNextItemWidth(ImGui::CalcItemWidth() * 0.8f);
+	ImGui::InputText("##record_path", record_path_.data(), record_path_.size());
+	ImGui::SameLine();
+	ImGui::Checkbox("Stems", &record_stems_);
+	ImGui::EndDisabled();
+
+	if (!recording) {
+		if (ImGui::Button("Record")) {
+			recorder_ = std::make_unique<AudioRecorder>();
+			if (recorder_->open(record_path_.data(), bus->get_audio_sample_rate(), AudioRecorder::Format::Wav,
+								record_stems_)) {
+				bus->set_audio_recorder(recorder_.get());
+				record_status_.clear();
+			} else {
+				recorder_.reset();
+				record_status_ = "Could not create the file";
+			}
+		}
+	} else {
+		if (ImGui::Button("Stop")) {
+			stop_recording(bus);
+		} else {
+			ImGui::SameLine();
+			ImGui::TextColored(RetroTheme::NES_RED, "REC %.1f s",
+							   static_cast<double>(recorder_->samples_written(AudioRecorder::Track::Mix)) /
+								   bus->get_audio_sample_rate());
+		}
+	}
+	if (!record_status_.empty()) {
+		ImGui::SameLine();
+		ImGui::TextUnformatted(record_status_.c_str());
+	}
+}
+
 } // namespace nes
@@ -91,6 +91,8 @@ void MemoryViewerPanel::render(const nes::SystemBus *bus) {
 
 	render_controls();
 	ImGui::Separator();
+	was_sampled_ = sampled_;
+	sampled_.reset();
 	render_memory_grid(bus);
 }
 
@@ -175,6 +177,8 @@ void MemoryViewerPanel::render_memory_grid(const nes::SystemBus *bus) {
 			ImGuiListClipper clipper;
 			clipper.Begin(total_rows);
 			while (clipper.Step()) {
+				take_snapshot(bus, static_cast<uint32_t>(clipper.DisplayStart) * bytes_per_row,
+							  static_cast<uint32_t>(clipper.DisplayEnd - clipper.DisplayStart) * bytes_per_row);
 				for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
 					uint16_t row_address = static_cast<uint16_t>(row * bytes_per_row);
 
@@ -188,13 +192,14 @@ void MemoryViewerPanel::render_memory_grid(const nes::SystemBus *bus) {
 					for (uint16_t col = 0; col < bytes_per_row; ++col) {
 						ImGui::TableNextColumn();
 						uint16_t addr = static_cast<uint16_t>(row_address + col);
-						uint8_t value = bus->peek(addr); // Use peek to avoid side effects
-						ImGui::TextColored(RetroTheme::get_hex_color(), "%02X", value);
+						const ImVec4 color =
+							changed(addr) ? RetroTheme::get_changed_value_color() : RetroTheme::get_hex_color();
+						ImGui::TextColored(color, "%02X", current_[addr]);
 					}
 
 					// ASCII column
 					ImGui::TableNextColumn();
-					render_ascii_column(bus, row_address, bytes_per_row);
+					render_ascii_column(row_address, bytes_per_row);
 
 					// Address-space column
 					ImGui::TableNextColumn();
@@ -208,11 +213,32 @@ void MemoryViewerPanel::render_memory_grid(const nes::SystemBus *bus) {
 	ImGui::EndChild();
 }
 
-void MemoryViewerPanel::render_ascii_column(const nes::SystemBus *bus, uint16_t start_addr, uint16_t count) {
+void MemoryViewerPanel::take_snapshot(const nes::SystemBus *bus, uint32_t first, uint32_t count) {
+	// The last row can run past $FFFF (when bytes/row doesn't divide 64KB);
+	// its cells wrap to $0000 like the address column, as peek_range does
+	count = std::min<uint32_t>(count, 0x10000);
+	for (uint32_t i = 0; i < count; ++i) {
+		// The clipper can hand out a row twice per frame (its measuring step);
+		// keep the previous frame's value from the first visit
+		const uint16_t address = static_cast<uint16_t>(first + i);
+		if (!sampled_[address]) {
+			previous_[address] = current_[address];
+			sampled_[address] = true;
+		}
+	}
+	const uint16_t start = static_cast<uint16_t>(first);
+	const uint32_t head = std::min<uint32_t>(count, 0x10000u - start);
+	bus->peek_range(start, {current_.data() + start, head});
+	if (head < count) {
+		bus->peek_range(0x0000, {current_.data(), count - head});
+	}
+}
+
+void MemoryViewerPanel::render_ascii_column(uint16_t start_addr, uint16_t count) {
 	char ascii_str[32] = {0}; // Max 16 bytes per row + null terminator
 
 	for (uint16_t i = 0; i < count && i < 31; ++i) {
-		uint8_t value = bus->peek(static_cast<uint16_t>(start_addr + i)); // Use peek to avoid side effects
+		const uint8_t value = current_[static_cast<uint16_t>(start_addr + i)];
 		ascii_str[i] = (value >= 32 && value < 127) ? static_cast<char>(value) : '.';
 	}
 
@@ -3,6 +3,7 @@
 #include "gui/crt_filter.hpp"
 #include "gui/style/retro_theme.hpp"
 #include "ppu/nes_palette.hpp"
+#include "ppu/ntsc_filter.hpp"
 #include "ppu/ppu.hpp"
 #ifdef _WIN32
 #define NOMINMAX
@@ -16,19 +17,37 @@
 #define GL_CLAMP_TO_EDGE 0x812F
 #endif
 
+#include <algorithm>
+#include <bit>
+#include <bitset>
 #include <cstring>
+#include <utility>
 #include <imgui.h>
 
 namespace nes::gui {
 
+namespace {
+
+// Convert an NES palette index to an ImGui colour (kept GUI-side so the core
+// palette has no ImGui dependency)
+ImVec4 nes_color_to_imvec4(uint8_t nes_color_index) {
+	uint32_t rgb = NESPalette::get_rgb_color(nes_color_index);
+
+	float r = ((rgb >> 16) & 0xFF) / 255.0f;
+	float g = ((rgb >> 8) & 0xFF) / 255.0f;
+	float b = (rgb & 0xFF) / 255.0f;
+
+	return ImVec4(r, g, b, 1.0f);
+}
+
+} // namespace
+
 PPUViewerPanel::PPUViewerPanel()
 	: visible_(true), display_mode_(PPUDisplayMode::REAL_TIME), main_display_texture_(0), pattern_table_texture_(0),
 	  nametable_texture_(0), selected_pattern_table_(0), selected_nametable_(0), selected_palette_(0),
-	  display_scale_(2.0f), pattern_table_dirty_(true), textures_initialized_(false) {
-
-	// Allocate buffers for texture data
-	pattern_table_buffer_ = std::make_unique<uint32_t[]>(256 * 128); // 2 pattern tables side by side
-	nametable_buffer_ = std::make_unique<uint32_t[]>(512 * 480);	 // 4 nametables in 2x2 grid
+	  display_scale_(2.0f), pattern_table_dirty_(true) {
+	// Textures and their staging buffers are created by the view that first
+	// shows them (see ensure_*_texture), not up front
 }
 
 PPUViewerPanel::~PPUViewerPanel() {
@@ -39,11 +58,6 @@ void PPUViewerPanel::render(nes::PPU *ppu, nes::Cartridge *cartridge) {
 	if (!ppu)
 		return;
 
-	// Initialize textures on first render
-	if (!textures_initialized_) {
-		initialize_textures();
-	}
-
 	// Render the full tabbed interface (for floating window mode)
 	// Display mode controls at the top
 	render_display_controls();
@@ -101,6 +115,68 @@ void PPUViewerPanel::render_registers_only(nes::PPU *ppu) {
 	render_ppu_registers(ppu);
 	ImGui::Separator();
 	render_timing_info(ppu);
+	ImGui::Separator();
+	render_scanline_inspector(ppu);
+}
+
+const nes::ScanlineTimeline::Frame &PPUViewerPanel::timeline_of(const nes::PPU *ppu) const {
+	return scanline_timeline_ ? *scanline_timeline_ : ppu->get_scanline_timeline().last_frame();
+}
+
+uint16_t PPUViewerPanel::background_table_of(const nes::PPU *ppu) const {
+	// The table the last frame started drawing its background from, or the
+	// register as it stands when nothing was recorded
+	for (const nes::ScanlineState &line : timeline_of(ppu)) {
+		if ((line.flags & nes::ScanlineState::RECORDED) && line.rendering()) {
+			return (line.ctrl & 0x10) ? 0x1000 : 0x0000;
+		}
+	}
+	return (ppu->get_control_register() & 0x10) ? 0x1000 : 0x0000;
+}
+
+void PPUViewerPanel::render_scanline_inspector(const nes::PPU *ppu) {
+	if constexpr (!nes::ScanlineTimeline::ENABLED) {
+		ImGui::TextDisabled("Scanline timeline compiled out");
+		return;
+	}
+	ImGui::SliderInt("Line", &inspected_scanline_, 0, static_cast<int>(nes::ScanlineTimeline::MAX_SCANLINES) - 1);
+	const nes::ScanlineState &line = timeline_of(ppu)[static_cast<size_t>(inspected_scanline_)];
+	if (!(line.flags & nes::ScanlineState::RECORDED)) {
+		ImGui::TextDisabled("Not recorded");
+		return;
+	}
+	ImGui::Text("v: $%04X  t: $%04X  X: %d%s", line.v, line.t, line.fine_x,
+				(line.flags & nes::ScanlineState::WRITE_TOGGLE) ? "  w" : "");
+	ImGui::Text("CTRL: $%02X  MASK: $%02X", line.ctrl, line.mask);
+	ImGui::Text("CHR: %02X %02X %02X %02X %02X %02X %02X %02X", line.chr_banks[0], line.chr_banks[1],
+				line.chr_banks[2], line.chr_banks[3], line.chr_banks[4], line.chr_banks[5], line.chr_banks[6],
+				line.chr_banks[7]);
+}
+
+void PPUViewerPanel::draw_scroll_overlay(const nes::PPU *ppu, float left, float top, float scale) const {
+	// Each visible line's 256 pixels, as a 1-line strip on the nametable it
+	// came from; wraps around the 512-wide map like the scroll does
+	const int quarter_x = (selected_nametable_ & 1) * 256;
+	const int quarter_y = (selected_nametable_ >> 1) * 240;
+	const ImU32 color = IM_COL32(255, 64, 64, 96);
+	ImDrawList *draw_list = ImGui::GetWindowDrawList();
+	const nes::ScanlineTimeline::Frame &frame = timeline_of(ppu);
+	for (size_t scanline = 0; scanline < 240; scanline++) {
+		const nes::ScanlineState &line = frame[scanline];
+		const int y = line.map_y() - quarter_y;
+		if (!(line.flags & nes::ScanlineState::RECORDED) || !line.rendering() || y < 0 || y >= 240) {
+			continue;
+		}
+		const int start = line.map_x();
+		for (const auto &[from, to] : {std::pair{start, std::min(start + 256, 512)}, std::pair{0, start + 256 - 512}}) {
+			const int x0 = std::max(from, quarter_x) - quarter_x;
+			const int x1 = std::min(to, quarter_x + 256) - quarter_x;
+			if (x1 > x0) {
+				draw_list->AddRectFilled(ImVec2(left + x0 * scale, top + y * scale),
+										 ImVec2(left + x1 * scale, top + (y + 1) * scale), color);
+			}
+		}
+	}
 }
 void PPUViewerPanel::render_display_controls() {
 	ImGui::Text("Display Mode:");
@@ -125,20 +201,16 @@ void PPUViewerPanel::render_display_controls() {
 }
 
 void PPUViewerPanel::render_main_display(nes::PPU *ppu) {
-	// Check if we should update the display based on mode
-	bool should_update = false;
-	switch (display_mode_) {
-	case PPUDisplayMode::FRAME_COMPLETE:
-		should_update = ppu->is_frame_ready();
-		break;
-	case PPUDisplayMode::REAL_TIME:
-		should_update = true; // Always update
-		break;
-	case PPUDisplayMode::SCANLINE_STEP:
-		// Update if we're on a new scanline
-		should_update = true; // Simplified for now
-		break;
+	const bool changed = take_display_change(ppu);
+	render_main_display(ppu->get_frame_buffer(), changed, ppu->get_index_buffer());
+	// Clear the frame ready flag after we've processed the frame
+	if (display_mode_ == PPUDisplayMode::FRAME_COMPLETE && ppu->is_frame_ready()) {
+		ppu->clear_frame_ready();
 	}
+}
+
+void PPUViewerPanel::render_main_display(const uint32_t *frame_buffer, bool frame_ready, const uint16_t *indices) {
+	ensure_main_display_texture();
 
 	// Add mode switching buttons
 	if (ImGui::Button("Frame Complete Mode")) {
@@ -152,13 +224,7 @@ void PPUViewerPanel::render_main_display(nes::PPU *ppu) {
 	const char *mode_names[] = {"FRAME_COMPLETE", "REAL_TIME", "SCANLINE_STEP"};
 	ImGui::Text("Display mode: %s", mode_names[static_cast<int>(display_mode_)]);
 
-	if (should_update && ppu->get_frame_buffer()) {
-		update_main_display_texture(ppu->get_frame_buffer());
-		// Clear the frame ready flag after we've processed the frame
-		if (display_mode_ == PPUDisplayMode::FRAME_COMPLETE && ppu->is_frame_ready()) {
-			ppu->clear_frame_ready();
-		}
-	}
+	upload_main_display(frame_buffer, frame_ready, indices);
 
 	// Display the texture
 	if (main_display_texture_ != 0) {
@@ -191,7 +257,7 @@ void PPUViewerPanel::render_main_display(nes::PPU *ppu) {
 		if (crt_filter_ && crt_filter_->enabled) {
 			display_texture =
 				crt_filter_->apply(main_display_texture_, static_cast<int>(disp_w), static_cast<int>(disp_h));
-			use_linear = true; // CRT output is already at display resolution
+			use_linear = true; // Display resolution, or below it on a reduced quality preset
 		} else {
 			use_linear = crt_filter_ && crt_filter_->soft_pixels;
 		}
@@ -218,18 +284,11 @@ void PPUViewerPanel::render_main_display(nes::PPU *ppu) {
 		// Timing info removed - now in right panel
 	} else {
 		ImGui::Text("Main display texture not initialized (texture ID: %u)", main_display_texture_);
-		ImGui::Text("Textures initialized: %s", textures_initialized_ ? "YES" : "NO");
-		if (ImGui::Button("Force Initialize Textures")) {
-			initialize_textures();
-		}
 	}
 }
 
 void PPUViewerPanel::render_pattern_tables(nes::PPU *ppu, nes::Cartridge *cartridge) {
-	// Ensure textures are initialized before we try to use them
-	if (!textures_initialized_) {
-		initialize_textures();
-	}
+	ensure_pattern_table_texture();
 
 	ImGui::Text("Pattern Tables (CHR ROM/RAM)");
 
@@ -279,29 +338,25 @@ void PPUViewerPanel::render_pattern_tables(nes::PPU *ppu, nes::Cartridge *cartri
 			need_clear_when_no_cartridge = true;
 
 			const auto &rom_data = cartridge->get_rom_data();
+			const std::size_t chr_rom_size = cartridge->get_rom_image()->chr_rom().size();
 			ImGui::Text("ROM: %d CHR pages (%d bytes)", static_cast<int>(rom_data.chr_rom_pages),
-						static_cast<int>(rom_data.chr_rom.size()));
+						static_cast<int>(chr_rom_size));
 
 			if (rom_data.chr_rom_pages == 0) {
 				ImGui::Text("Using CHR RAM (no CHR ROM)");
 			}
 
 			// Detect ROM changes by checking CHR ROM size or cartridge pointer
-			bool rom_changed = (last_cartridge != cartridge) || (last_chr_size != rom_data.chr_rom.size());
-			(void)rom_changed;
-
-			// Always regenerate every frame so the visualization tracks the LIVE
-			// CHR data the PPU currently sees: mapper CHR-ROM bank switches
-			// (MMC1/MMC3/CNROM/etc.) and CHR-RAM writes both change what's mapped
-			// into $0000-$1FFF without changing the ROM size or cartridge pointer.
-			// read_chr_rom() routes through the mapper's current bank, so a per-
-			// frame redraw is a true "what's mapped right now" view rather than a
-			// static snapshot that only refreshed when toggling tables/palette.
-			generate_pattern_table_visualization(ppu, cartridge);
-			update_pattern_table_texture(); // Upload to OpenGL
-			pattern_table_dirty_ = false;
+			bool rom_changed = (last_cartridge != cartridge) || (last_chr_size != chr_rom_size);
+
+			// Redraw only the tiles whose CHR changed: CHR-RAM writes mark
+			// tiles and mapper bank switches (MMC1/MMC3/CNROM/etc.) mark their
+			// whole 1KB slot, so the view still tracks what's mapped right now.
+			// Switching table or palette, or a palette write while showing
+			// colors, redraws everything.
+			refresh_pattern_table(ppu, cartridge, rom_changed);
 			last_cartridge = cartridge;
-			last_chr_size = rom_data.chr_rom.size();
+			last_chr_size = chr_rom_size;
 			if (pattern_table_texture_ != 0) {
 				// Scale display to fit available space - single pattern table is square (1:1 ratio)
 				float max_width = content_width - 20.0f;		   // Leave some margin
@@ -367,13 +422,26 @@ void PPUViewerPanel::render_nametables(nes::PPU *ppu) {
 		ImGui::RadioButton(label, &selected_nametable_, i);
 	}
 
-	// Generate and display nametable visualization
-	generate_nametable_visualization(ppu);
+	if (!ppu) {
+		ImGui::Text("No PPU connected");
+		return;
+	}
+
+	// All four nametables live in one 512x480 texture; show the selected quarter
+	ensure_nametable_texture();
+	refresh_nametables(ppu);
 
 	if (nametable_texture_ != 0) {
 		ImVec2 display_size(256 * 1.5f, 240 * 1.5f);
-		ImGui::Image(static_cast<ImTextureID>(static_cast<intptr_t>(nametable_texture_)), display_size);
+		ImVec2 uv0((selected_nametable_ & 1) * 0.5f, (selected_nametable_ >> 1) * 0.5f);
+		ImVec2 uv1(uv0.x + 0.5f, uv0.y + 0.5f);
+		const ImVec2 origin = ImGui::GetCursorScreenPos();
+		ImGui::Image(static_cast<ImTextureID>(static_cast<intptr_t>(nametable_texture_)), display_size, uv0, uv1);
+		if (show_scroll_overlay_ && nes::ScanlineTimeline::ENABLED) {
+			draw_scroll_overlay(ppu, origin.x, origin.y, 1.5f);
+		}
 	}
+	ImGui::Checkbox("Scroll overlay", &show_scroll_overlay_);
 }
 
 void PPUViewerPanel::render_palette_viewer(nes::PPU *ppu) {
@@ -395,7 +463,7 @@ void PPUViewerPanel::render_palette_viewer(nes::PPU *ppu) {
 		for (int color = 0; color < 4; color++) {
 			uint8_t palette_index = static_cast<uint8_t>(palette * 4 + color);
 			uint8_t nes_color = palette_ram[palette_index];
-			ImVec4 color_vec = NESPalette::get_imgui_color(nes_color);
+			ImVec4 color_vec = nes_color_to_imvec4(nes_color);
 
 			char label[32];
 			snprintf(label, sizeof(label), "##bg%d_%d", palette, color);
@@ -422,7 +490,7 @@ void PPUViewerPanel::render_palette_viewer(nes::PPU *ppu) {
 			// Sprite palettes are at indices 16-31 (0x10-0x1F)
 			uint8_t palette_index = static_cast<uint8_t>(16 + palette * 4 + color);
 			uint8_t nes_color = palette_ram[palette_index];
-			ImVec4 color_vec = NESPalette::get_imgui_color(nes_color);
+			ImVec4 color_vec = nes_color_to_imvec4(nes_color);
 
 			char label[32];
 			snprintf(label, sizeof(label), "##sp%d_%d", palette, color);
@@ -442,7 +510,7 @@ void PPUViewerPanel::render_palette_viewer(nes::PPU *ppu) {
 	// Universal backdrop color
 	ImGui::Text("Universal Backdrop:");
 	uint8_t backdrop_color = palette_ram[0];
-	ImVec4 backdrop_vec = NESPalette::get_imgui_color(backdrop_color);
+	ImVec4 backdrop_vec = nes_color_to_imvec4(backdrop_color);
 	ImGui::ColorButton("##backdrop", backdrop_vec, ImGuiColorEditFlags_NoTooltip, ImVec2(32, 32));
 	if (ImGui::IsItemHovered()) {
 		ImGui::SetTooltip("Universal Backdrop Color\nNES Color: $%02X", backdrop_color);
@@ -539,61 +607,112 @@ void PPUViewerPanel::render_timing_info(nes::PPU * /*ppu*/) {
 	// Timing information removed - now displayed under NES Display
 }
 
-void PPUViewerPanel::initialize_textures() {
-	// Generate OpenGL textures
-	glGenTextures(1, &main_display_texture_);
-	glGenTextures(1, &pattern_table_texture_);
-	glGenTextures(1, &nametable_texture_);
-
-	// Check for OpenGL errors
-	GLenum error = glGetError();
-	if (error != GL_NO_ERROR) {
-		fprintf(stderr, "OpenGL error after texture generation: %u\n", error);
-	}
-
-	// Setup main display texture (256x240)
-	glBindTexture(GL_TEXTURE_2D, main_display_texture_);
+GLuint PPUViewerPanel::create_view_texture(int width, int height) {
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 240, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
-	error = glGetError();
+	GLenum error = glGetError();
 	if (error != GL_NO_ERROR) {
-		fprintf(stderr, "OpenGL error after main display texture setup: %u\n", error);
+		fprintf(stderr, "OpenGL error creating %dx%d texture: %u\n", width, height, error);
 	}
+	return texture;
+}
 
-	// Setup pattern table texture (256x128)
-	glBindTexture(GL_TEXTURE_2D, pattern_table_texture_);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 128, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+void PPUViewerPanel::ensure_main_display_texture() {
+	if (main_display_texture_ != 0) {
+		return;
+	}
+	main_display_texture_ = create_view_texture(256, 240); // Widened by the NTSC filter
+	main_display_width_ = 256;
+	display_stale_ = true;
+}
 
-	// Setup nametable texture (512x480)
-	glBindTexture(GL_TEXTURE_2D, nametable_texture_);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 512, 480, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+void PPUViewerPanel::ensure_pattern_table_texture() {
+	if (pattern_table_texture_ != 0) {
+		return;
+	}
+	pattern_table_buffer_ = std::make_unique<uint32_t[]>(256 * 128); // 2 pattern tables side by side
+	pattern_table_texture_ = create_view_texture(256, 128);
+	pattern_table_dirty_ = true;
+}
 
-	textures_initialized_ = true;
+void PPUViewerPanel::ensure_nametable_texture() {
+	if (nametable_texture_ != 0) {
+		return;
+	}
+	nametable_buffer_ = std::make_unique<uint32_t[]>(512 * 480); // 4 nametables in 2x2 grid
+	nametable_texture_ = create_view_texture(512, 480);
+	nametable_dirty_ = true;
 }
 
 void PPUViewerPanel::cleanup_textures() {
-	if (textures_initialized_) {
-		glDeleteTextures(1, &main_display_texture_);
-		glDeleteTextures(1, &pattern_table_texture_);
-		glDeleteTextures(1, &nametable_texture_);
-		textures_initialized_ = false;
+	for (GLuint *texture : {&main_display_texture_, &pattern_table_texture_, &nametable_texture_}) {
+		if (*texture != 0) {
+			glDeleteTextures(1, texture);
+			*texture = 0;
+		}
 	}
 }
 
-void PPUViewerPanel::update_main_display_texture(const uint32_t *frame_buffer) {
+bool PPUViewerPanel::take_display_change(const nes::PPU *ppu) {
+	// Frame Complete waits for the next finished frame. The other modes show
+	// the frame as it is drawn, which only changes while the beam moves.
+	const uint64_t generation = ppu->get_frame_generation();
+	const uint32_t beam = (static_cast<uint32_t>(ppu->get_current_scanline()) << 16) | ppu->get_current_cycle();
+	bool changed = generation != uploaded_generation_ || display_mode_ != uploaded_mode_;
+	if (display_mode_ != PPUDisplayMode::FRAME_COMPLETE) {
+		changed = changed || beam != uploaded_beam_;
+	}
+	uploaded_generation_ = generation;
+	uploaded_beam_ = beam;
+	uploaded_mode_ = display_mode_;
+	return changed;
+}
+
+void PPUViewerPanel::upload_main_display(const uint32_t *frame_buffer, bool frame_changed, const uint16_t *indices) {
+	if ((frame_changed || display_stale_) && frame_buffer) {
+		update_main_display_texture(frame_buffer, indices);
+		display_stale_ = false;
+	}
+	present_ntsc_frame(frame_buffer);
+}
+
+void PPUViewerPanel::main_display_written() {
+	if (crt_filter_) {
+		crt_filter_->invalidate();
+	}
+}
+
+void PPUViewerPanel::update_main_display_texture(const uint32_t *frame_buffer, const uint16_t *indices) {
 	if (main_display_texture_ == 0 || !frame_buffer)
 		return;
 
+	// NTSC filter: hand the frame to the workers, present_ntsc_frame() shows
+	// it when it's done. Until the first one is, show the unfiltered frames.
+	if (indices && ntsc_filter_) {
+		if (ntsc_filter_->submit(indices, ntsc_burst_phase_)) {
+			ntsc_burst_phase_ ^= 1; // Alternate the artifacts frame to frame
+		}
+		if (ntsc_frame_shown_) {
+			return;
+		}
+	}
+
+	// Upload 2-byte palette indices and let the GPU look up the colors;
+	// fall back to the RGBA frame when the filter's GL resources are missing
+	if (indices && crt_filter_ && crt_filter_->resolve_indexed_frame(indices, main_display_texture_)) {
+		return;
+	}
+
 	glBindTexture(GL_TEXTURE_2D, main_display_texture_);
 	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 240, GL_RGBA, GL_UNSIGNED_BYTE, frame_buffer);
+	main_display_written();
 
 	// Check for OpenGL errors
 	GLenum error = glGetError();
@@ -602,6 +721,44 @@ void PPUViewerPanel::update_main_display_texture(const uint32_t *frame_buffer) {
 	}
 }
 
+void PPUViewerPanel::present_ntsc_frame(const uint32_t *frame_buffer) {
+	if (main_display_texture_ == 0) {
+		return;
+	}
+	if (!ntsc_filter_) {
+		// Filter switched off: back to 256 wide with the plain frame
+		if (main_display_width_ != nes::NtscFilter::INPUT_WIDTH) {
+			resize_main_display_texture(nes::NtscFilter::INPUT_WIDTH);
+			ntsc_frame_shown_ = false;
+			if (frame_buffer) {
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 240, GL_RGBA, GL_UNSIGNED_BYTE, frame_buffer);
+				main_display_written();
+			}
+		}
+		return;
+	}
+
+	const uint32_t *filtered = ntsc_filter_->take_finished_frame();
+	if (!filtered) {
+		return;
+	}
+	if (main_display_width_ != nes::NtscFilter::OUTPUT_WIDTH) {
+		resize_main_display_texture(nes::NtscFilter::OUTPUT_WIDTH);
+	} else {
+		glBindTexture(GL_TEXTURE_2D, main_display_texture_);
+	}
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, nes::NtscFilter::OUTPUT_WIDTH, nes::NtscFilter::HEIGHT, GL_RGBA,
+					GL_UNSIGNED_BYTE, filtered);
+	main_display_written();
+	ntsc_frame_shown_ = true;
+}
+
+void PPUViewerPanel::resize_main_display_texture(int width) {
+	glBindTexture(GL_TEXTURE_2D, main_display_texture_);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, 240, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	main_display_width_ = width;
+}
+
 void PPUViewerPanel::update_pattern_table_texture() {
 	if (pattern_table_texture_ == 0 || !pattern_table_buffer_) {
 		return;
@@ -620,47 +777,10 @@ void PPUViewerPanel::generate_pattern_table_visualization(nes::PPU *ppu, nes::Ca
 
 	// Pattern table layout: 128x128 pixels (single pattern table)
 	// Display only the selected pattern table ($0000 or $1000)
-
-	uint16_t base_address =
-		static_cast<uint16_t>(selected_pattern_table_ * 0x1000); // $0000 or $1000 based on selection
-
 	// Each pattern table is 16x16 tiles, each tile is 8x8 pixels
 	for (int tile_y = 0; tile_y < 16; tile_y++) {
 		for (int tile_x = 0; tile_x < 16; tile_x++) {
-			uint8_t tile_index = static_cast<uint8_t>(tile_y * 16 + tile_x);
-			uint16_t tile_address = static_cast<uint16_t>(base_address + (tile_index * 16));
-
-			// Render 8x8 tile
-			for (int pixel_y = 0; pixel_y < 8; pixel_y++) {
-				// Read pattern data for this row
-				uint16_t plane0_addr = static_cast<uint16_t>(tile_address + pixel_y);
-				uint16_t plane1_addr = static_cast<uint16_t>(tile_address + pixel_y + 8);
-				uint8_t plane0 = ppu->read_chr_rom(plane0_addr);
-				uint8_t plane1 = ppu->read_chr_rom(plane1_addr);
-
-				for (int pixel_x = 0; pixel_x < 8; pixel_x++) {
-					// Extract 2-bit pixel value
-					uint8_t bit_pos = static_cast<uint8_t>(7 - pixel_x);
-					uint8_t pixel_value = ((plane0 >> bit_pos) & 1) | (((plane1 >> bit_pos) & 1) << 1);
-
-					// Calculate screen position (single pattern table, so no x_offset)
-					int screen_x = (tile_x * 8) + pixel_x;
-					int screen_y = (tile_y * 8) + pixel_y;
-					int buffer_index = screen_y * 256 + screen_x; // Still use 256-wide buffer
-
-					// Convert to color using selected palette
-					uint32_t color;
-					if (pixel_value == 0) {
-						// Transparent pixels show as dark gray
-						color = 0xFF404040;
-					} else {
-						// Use palette 0 + selected background palette for visualization
-						color = get_pattern_pixel_color(pixel_value, static_cast<uint8_t>(selected_palette_), ppu);
-					}
-
-					pattern_table_buffer_[buffer_index] = color;
-				}
-			}
+			draw_pattern_tile(ppu, tile_x, tile_y);
 		}
 	}
 
@@ -675,12 +795,38 @@ void PPUViewerPanel::generate_pattern_table_visualization(nes::PPU *ppu, nes::Ca
 	// Debug: Check if we generated any non-zero pixel data
 }
 
+void PPUViewerPanel::draw_pattern_tile(nes::PPU *ppu, int tile_x, int tile_y) {
+	const uint16_t tile_address = static_cast<uint16_t>(selected_pattern_table_ * 0x1000 + (tile_y * 16 + tile_x) * 16);
+
+	// Render 8x8 tile
+	for (int pixel_y = 0; pixel_y < 8; pixel_y++) {
+		// Read pattern data for this row
+		uint8_t plane0 = ppu->read_chr_rom(static_cast<uint16_t>(tile_address + pixel_y));
+		uint8_t plane1 = ppu->read_chr_rom(static_cast<uint16_t>(tile_address + pixel_y + 8));
+		uint32_t *row = &pattern_table_buffer_[(tile_y * 8 + pixel_y) * 256 + tile_x * 8]; // 256-wide buffer
+
+		for (int pixel_x = 0; pixel_x < 8; pixel_x++) {
+			// Extract 2-bit pixel value
+			uint8_t bit_pos = static_cast<uint8_t>(7 - pixel_x);
+			uint8_t pixel_value = ((plane0 >> bit_pos) & 1) | (((plane1 >> bit_pos) & 1) << 1);
+
+			// Transparent pixels show as dark gray, the rest use the selected palette
+			row[pixel_x] = pixel_value == 0
+							   ? 0xFF404040
+							   : get_pattern_pixel_color(pixel_value, static_cast<uint8_t>(selected_palette_), ppu);
+		}
+	}
+}
+
 void PPUViewerPanel::generate_nametable_visualization(nes::PPU *ppu) {
-	(void)ppu; // Suppress unused parameter warning
-	// This is a placeholder implementation
-	// Would need to read nametable data and convert to visual representation
-	// For now, just clear the buffer
-	std::memset(nametable_buffer_.get(), 0, 512 * 480 * sizeof(uint32_t));
+	// 2x2 grid of 256x240 nametables: $2000 $2400 / $2800 $2C00
+	for (int nametable = 0; nametable < 4; nametable++) {
+		for (int tile_y = 0; tile_y < 30; tile_y++) {
+			for (int tile_x = 0; tile_x < 32; tile_x++) {
+				draw_nametable_tile(ppu, nametable, tile_x, tile_y);
+			}
+		}
+	}
 
 	if (nametable_texture_ != 0) {
 		glBindTexture(GL_TEXTURE_2D, nametable_texture_);
@@ -688,6 +834,179 @@ void PPUViewerPanel::generate_nametable_visualization(nes::PPU *ppu) {
 	}
 }
 
+void PPUViewerPanel::draw_nametable_tile(nes::PPU *ppu, int nametable, int tile_x, int tile_y) {
+	const nes::PPUMemory &memory = ppu->get_memory();
+	const auto &vram = memory.get_vram();
+	const auto &palette_ram = memory.get_palette_ram();
+	const uint16_t base = static_cast<uint16_t>(0x2000 + nametable * 0x400);
+
+	const uint8_t tile = vram[memory.nametable_vram_offset(static_cast<uint16_t>(base + tile_y * 32 + tile_x))];
+	const uint8_t attribute =
+		vram[memory.nametable_vram_offset(static_cast<uint16_t>(base + 0x3C0 + (tile_y / 4) * 8 + tile_x / 4))];
+	// Each attribute byte holds four 2-bit palettes, one per 2x2-tile quadrant
+	const uint8_t palette = (attribute >> (((tile_y & 2) << 1) | (tile_x & 2))) & 0x03;
+	const uint16_t tile_address =
+		static_cast<uint16_t>(background_table_of(ppu) + tile * 16);
+
+	const int origin_x = (nametable & 1) * 256 + tile_x * 8;
+	const int origin_y = (nametable >> 1) * 240 + tile_y * 8;
+	for (int pixel_y = 0; pixel_y < 8; pixel_y++) {
+		uint8_t plane0 = ppu->read_chr_rom(static_cast<uint16_t>(tile_address + pixel_y));
+		uint8_t plane1 = ppu->read_chr_rom(static_cast<uint16_t>(tile_address + pixel_y + 8));
+		uint32_t *row = &nametable_buffer_[(origin_y + pixel_y) * 512 + origin_x];
+
+		for (int pixel_x = 0; pixel_x < 8; pixel_x++) {
+			uint8_t bit_pos = static_cast<uint8_t>(7 - pixel_x);
+			uint8_t pixel_value = ((plane0 >> bit_pos) & 1) | (((plane1 >> bit_pos) & 1) << 1);
+			// Transparent pixels show the universal background color
+			row[pixel_x] = nes::NESPalette::get_rgba_color(palette_ram[pixel_value ? palette * 4 + pixel_value : 0]);
+		}
+	}
+}
+
+void PPUViewerPanel::collect_dirty_regions(nes::PPU *ppu) {
+	if (ppu != tracked_ppu_) {
+		// Switched between the live system and the debug view
+		tracked_ppu_ = ppu;
+		pattern_table_dirty_ = true;
+		nametable_dirty_ = true;
+	}
+
+	nes::PPUMemory &memory = ppu->get_memory();
+	const nes::PPUMemory::PatternTileMask tiles = memory.take_dirty_pattern_tiles();
+	const nes::PPUMemory::VramByteMask vram = memory.take_dirty_vram();
+	for (size_t i = 0; i < tiles.size(); i++) {
+		pattern_view_tiles_[i] |= tiles[i];
+		nametable_view_tiles_[i] |= tiles[i];
+	}
+	for (size_t i = 0; i < vram.size(); i++) {
+		nametable_view_vram_[i] |= vram[i];
+	}
+}
+
+void PPUViewerPanel::refresh_pattern_table(nes::PPU *ppu, nes::Cartridge *cartridge, bool full_redraw) {
+	if (!ppu) {
+		generate_pattern_table_visualization(ppu, cartridge); // Clears the buffer
+		update_pattern_table_texture();
+		pattern_table_dirty_ = true;
+		return;
+	}
+	collect_dirty_regions(ppu);
+	const uint32_t palette_generation = ppu->get_memory().get_palette_generation();
+	full_redraw = full_redraw || pattern_table_dirty_ || selected_pattern_table_ != drawn_pattern_table_ ||
+				  selected_palette_ != drawn_palette_ ||
+				  (selected_palette_ != 0 && palette_generation != drawn_pattern_palette_generation_);
+
+	if (full_redraw) {
+		generate_pattern_table_visualization(ppu, cartridge);
+		update_pattern_table_texture(); // Upload to OpenGL
+		pattern_table_dirty_ = false;
+		drawn_pattern_table_ = selected_pattern_table_;
+		drawn_palette_ = selected_palette_;
+		drawn_pattern_palette_generation_ = palette_generation;
+	} else {
+		// Tiles 0-255 of the shown table are bits 0-255 of its four mask words
+		for (int word = 0; word < 4; word++) {
+			uint64_t bits = pattern_view_tiles_[selected_pattern_table_ * 4 + word];
+			while (bits != 0) {
+				const int tile = word * 64 + std::countr_zero(bits);
+				bits &= bits - 1;
+				draw_pattern_tile(ppu, tile % 16, tile / 16);
+				upload_texture_tile(pattern_table_texture_, pattern_table_buffer_.get(), 256, (tile % 16) * 8,
+									(tile / 16) * 8);
+			}
+		}
+	}
+	pattern_view_tiles_.fill(0);
+}
+
+void PPUViewerPanel::refresh_nametables(nes::PPU *ppu) {
+	collect_dirty_regions(ppu);
+	const nes::PPUMemory &memory = ppu->get_memory();
+	const uint32_t palette_generation = memory.get_palette_generation();
+	const uint16_t background_table = background_table_of(ppu);
+	std::array<uint16_t, 4> pages;
+	for (int i = 0; i < 4; i++) {
+		pages[i] = memory.nametable_vram_offset(static_cast<uint16_t>(0x2000 + i * 0x400));
+	}
+
+	// Palette writes, a PPUCTRL background table switch or a mirroring change
+	// touch every tile
+	if (nametable_dirty_ || palette_generation != drawn_nametable_palette_generation_ ||
+		background_table != drawn_background_table_ || pages != drawn_nametable_pages_) {
+		generate_nametable_visualization(ppu);
+		nametable_dirty_ = false;
+		drawn_nametable_palette_generation_ = palette_generation;
+		drawn_background_table_ = background_table;
+		drawn_nametable_pages_ = pages;
+		nametable_view_tiles_.fill(0);
+		nametable_view_vram_.fill(0);
+		return;
+	}
+
+	const auto vram_dirty = [this](uint16_t offset) {
+		return (nametable_view_vram_[offset >> 6] >> (offset & 63)) & 1;
+	};
+	const uint16_t tile_base = background_table >> 4; // First pattern tile of the background table
+	const auto &vram = memory.get_vram();
+	std::bitset<4 * 960> redraw;
+	for (int nametable = 0; nametable < 4; nametable++) {
+		const uint16_t page = pages[nametable];
+		for (uint16_t offset = 0; offset < 960; offset++) {
+			const uint16_t pattern = static_cast<uint16_t>(tile_base + vram[page + offset]);
+			if (vram_dirty(page + offset) || ((nametable_view_tiles_[pattern >> 6] >> (pattern & 63)) & 1)) {
+				redraw.set(nametable * 960 + offset);
+			}
+		}
+		// An attribute byte colors a 4x4-tile block
+		for (uint16_t block = 0; block < 64; block++) {
+			if (!vram_dirty(static_cast<uint16_t>(page + 0x3C0 + block))) {
+				continue;
+			}
+			for (int y = (block / 8) * 4; y < std::min((block / 8) * 4 + 4, 30); y++) {
+				for (int x = (block % 8) * 4; x < (block % 8) * 4 + 4; x++) {
+					redraw.set(nametable * 960 + y * 32 + x);
+				}
+			}
+		}
+	}
+	nametable_view_tiles_.fill(0);
+	nametable_view_vram_.fill(0);
+
+	// Past a quarter of the tiles one full upload beats many small ones
+	const bool upload_all = redraw.count() > redraw.size() / 4;
+	for (size_t i = 0; i < redraw.size(); i++) {
+		if (!redraw.test(i)) {
+			continue;
+		}
+		const int nametable = static_cast<int>(i / 960);
+		const int tile_x = static_cast<int>(i % 32);
+		const int tile_y = static_cast<int>((i % 960) / 32);
+		draw_nametable_tile(ppu, nametable, tile_x, tile_y);
+		if (!upload_all) {
+			upload_texture_tile(nametable_texture_, nametable_buffer_.get(), 512, (nametable & 1) * 256 + tile_x * 8,
+								(nametable >> 1) * 240 + tile_y * 8);
+		}
+	}
+	if (upload_all && nametable_texture_ != 0) {
+		glBindTexture(GL_TEXTURE_2D, nametable_texture_);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 512, 480, GL_RGBA, GL_UNSIGNED_BYTE, nametable_buffer_.get());
+	}
+}
+
+void PPUViewerPanel::upload_texture_tile(GLuint texture, const uint32_t *buffer, int buffer_width, int x, int y) {
+	if (texture == 0) {
+		return;
+	}
+	// Gather the 8x8 region so the upload needs no GL_UNPACK_ROW_LENGTH
+	uint32_t tile[64];
+	for (int row = 0; row < 8; row++) {
+		std::memcpy(&tile[row * 8], &buffer[(y + row) * buffer_width + x], 8 * sizeof(uint32_t));
+	}
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 8, 8, GL_RGBA, GL_UNSIGNED_BYTE, tile);
+}
+
 uint32_t PPUViewerPanel::get_pattern_pixel_color(uint8_t pixel_value, uint8_t palette_index, nes::PPU *ppu) {
 	if (pixel_value == 0) {
 		// Transparent pixels show as dark gray for visibility
@@ -751,36 +1070,26 @@ uint32_t PPUViewerPanel::get_pattern_pixel_color(uint8_t pixel_value, uint8_t pa
 }
 
 void PPUViewerPanel::update_display_texture_only(nes::PPU *ppu) {
-	if (!ppu || !ppu->get_frame_buffer()) {
+	if (!ppu) {
 		return;
 	}
-
-	// Initialize textures if needed
-	if (!textures_initialized_) {
-		initialize_textures();
+	const bool changed = take_display_change(ppu);
+	update_display_texture_only(ppu->get_frame_buffer(), changed, ppu->get_index_buffer());
+	// Clear the frame ready flag after processing
+	if (display_mode_ == PPUDisplayMode::FRAME_COMPLETE && ppu->is_frame_ready()) {
+		ppu->clear_frame_ready();
 	}
+}
 
-	// Check if we should update based on display mode
-	bool should_update = false;
-	switch (display_mode_) {
-	case PPUDisplayMode::FRAME_COMPLETE:
-		should_update = ppu->is_frame_ready();
-		break;
-	case PPUDisplayMode::REAL_TIME:
-		should_update = true;
-		break;
-	case PPUDisplayMode::SCANLINE_STEP:
-		should_update = true;
-		break;
+void PPUViewerPanel::update_display_texture_only(const uint32_t *frame_buffer, bool frame_ready,
+												 const uint16_t *indices) {
+	if (!frame_buffer) {
+		return;
 	}
 
-	if (should_update) {
-		update_main_display_texture(ppu->get_frame_buffer());
-		// Clear the frame ready flag after processing
-		if (display_mode_ == PPUDisplayMode::FRAME_COMPLETE && ppu->is_frame_ready()) {
-			ppu->clear_frame_ready();
-		}
-	}
+	ensure_main_display_texture();
+
+	upload_main_display(frame_buffer, frame_ready, indices);
 }
 
 } // namespace nes::gui
@@ -1,6 +1,9 @@
 #include "gui/panels/rom_loader_panel.hpp"
 #include "cartridge/cartridge.hpp"
+#include "cartridge/rom_preloader.hpp"
 #include "core/user_paths.hpp"
+#include "system/battery_save.hpp"
+#include <cstdio>
 #include <filesystem>
 #include <imgui.h>
 #include <iostream>
@@ -10,6 +13,9 @@ namespace nes::gui {
 
 RomLoaderPanel::RomLoaderPanel() {
 	find_default_rom_directory();
+	library_ = std::make_unique<nes::RomLibrary>(current_directory_, nes::get_rom_library_index_path());
+	library_->load_index();
+	library_->start_scan();
 }
 
 void RomLoaderPanel::render(nes::Cartridge *cartridge) {
@@ -17,8 +23,15 @@ void RomLoaderPanel::render(nes::Cartridge *cartridge) {
 		return;
 	}
 
+	// Library search section
+	if (ImGui::CollapsingHeader("Library", ImGuiTreeNodeFlags_DefaultOpen)) {
+		render_library(cartridge);
+	}
+
+	ImGui::Separator();
+
 	// File browser section
-	if (ImGui::CollapsingHeader("File Browser", ImGuiTreeNodeFlags_DefaultOpen)) {
+	if (ImGui::CollapsingHeader("File Browser")) {
 		render_file_browser(cartridge);
 	}
 
@@ -95,16 +108,12 @@ void RomLoaderPanel::render_file_browser(nes::Cartridge *cartridge) {
 						bool is_selected = (selected_file_ == entry.path().string());
 
 						if (ImGui::Selectable(filename.c_str(), is_selected)) {
-							selected_file_ = entry.path().string();
+							select(entry.path().string());
 						}
 
 						// Double-click to load
 						if (is_selected && ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0)) {
-							if (cartridge->load_rom(selected_file_)) {
-								if (rom_loaded_callback_) {
-									rom_loaded_callback_();
-								}
-							}
+							load_selected(cartridge);
 						}
 					}
 				}
@@ -118,6 +127,84 @@ void RomLoaderPanel::render_file_browser(nes::Cartridge *cartridge) {
 	// Selected file display
 	if (!selected_file_.empty()) {
 		ImGui::Text("Selected: %s", std::filesystem::path(selected_file_).filename().string().c_str());
+		if (header_file_ != selected_file_) {
+			header_file_ = selected_file_;
+			selected_header_valid_ = nes::RomLoader::read_header(selected_file_, selected_header_);
+		}
+		if (selected_header_valid_) {
+			ImGui::Text("%s, mapper %d, PRG %d KB, CHR %d KB", selected_header_.nes2_0 ? "NES 2.0" : "iNES",
+						static_cast<int>(selected_header_.mapper_id), selected_header_.prg_rom_pages * 16,
+						selected_header_.chr_rom_pages * 8);
+		} else {
+			ImGui::Text("Not an iNES ROM");
+		}
+	}
+}
+
+void RomLoaderPanel::render_library(nes::Cartridge *cartridge) {
+	ImGui::SetNextItemWidth(-120);
+	ImGui::InputTextWithHint("##library_search", "Search name or CRC32", library_query_, sizeof(library_query_));
+	ImGui::SameLine();
+	if (library_->is_scanning()) {
+		ImGui::BeginDisabled();
+		ImGui::Button("Scanning...");
+		ImGui::EndDisabled();
+	} else if (ImGui::Button("Rescan")) {
+		library_->start_scan();
+	}
+
+	if (results_query_ != library_query_ || results_generation_ != library_->get_generation()) {
+		results_query_ = library_query_;
+		results_generation_ = library_->get_generation();
+		library_results_ = library_->search(results_query_);
+	}
+	ImGui::Text("%d of %d ROMs", static_cast<int>(library_results_.size()), static_cast<int>(library_->size()));
+
+	if (ImGui::BeginTable("##library", 4,
+						  ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV,
+						  ImVec2(-1, 200))) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("Mapper", ImGuiTableColumnFlags_WidthFixed, 50);
+		ImGui::TableSetupColumn("PRG/CHR", ImGuiTableColumnFlags_WidthFixed, 70);
+		ImGui::TableSetupColumn("CRC32", ImGuiTableColumnFlags_WidthFixed, 70);
+		ImGui::TableHeadersRow();
+
+		// Only the visible rows are laid out, however big the library
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(library_results_.size()));
+		while (clipper.Step()) {
+			for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+				const nes::RomLibrary::Entry &entry = library_results_[static_cast<size_t>(row)];
+				const std::string path = library_->full_path(entry).string();
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::PushID(row);
+				if (ImGui::Selectable(entry.path.c_str(), selected_file_ == path,
+									  ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
+					select(path);
+					if (ImGui::IsMouseDoubleClicked(0)) {
+						load_selected(cartridge);
+					}
+				}
+				ImGui::PopID();
+				if (!entry.valid) {
+					ImGui::TableNextColumn();
+					ImGui::TextDisabled("not a ROM");
+					continue;
+				}
+				ImGui::TableNextColumn();
+				ImGui::Text("%d%s", static_cast<int>(entry.mapper_id), entry.battery_backed_ram ? " B" : "");
+				ImGui::TableNextColumn();
+				ImGui::Text("%d/%d KB", entry.prg_rom_pages * 16, entry.chr_rom_pages * 8);
+				ImGui::TableNextColumn();
+				ImGui::Text("%08X", entry.crc32);
+				if (ImGui::IsItemHovered()) {
+					ImGui::SetTooltip("SHA-1 %s", nes::Sha1::to_hex(entry.sha1).c_str());
+				}
+			}
+		}
+		ImGui::EndTable();
 	}
 }
 
@@ -158,7 +245,7 @@ void RomLoaderPanel::render_rom_info(nes::Cartridge *cartridge) {
 		ImGui::Text("Battery-backed RAM: Yes");
 	}
 	if (rom_data.trainer_present) {
-		ImGui::Text("Trainer: Yes (%d bytes)", static_cast<int>(rom_data.trainer.size()));
+		ImGui::Text("Trainer: Yes (%d bytes)", static_cast<int>(cartridge->get_rom_image()->trainer().size()));
 	}
 }
 
@@ -170,13 +257,7 @@ void RomLoaderPanel::render_load_button(nes::Cartridge *cartridge) {
 	}
 
 	if (ImGui::Button("Load ROM", ImVec2(100, 30))) {
-		if (cartridge->load_rom(selected_file_)) {
-			if (rom_loaded_callback_) {
-				rom_loaded_callback_();
-			}
-		} else {
-			std::cerr << "Failed to load ROM: " << selected_file_ << std::endl;
-		}
+		load_selected(cartridge);
 	}
 
 	if (!can_load) {
@@ -199,6 +280,40 @@ void RomLoaderPanel::render_load_button(nes::Cartridge *cartridge) {
 	}
 }
 
+void RomLoaderPanel::select(const std::string &path) {
+	if (path == selected_file_) {
+		return;
+	}
+	selected_file_ = path;
+	if (preloader_ && is_nes_file(path)) {
+		preloader_->prefetch(path, nes::BatterySaveManager::path_for_rom(save_directory_, path, ".sav"));
+	}
+}
+
+void RomLoaderPanel::load_selected(nes::Cartridge *cartridge) {
+	if (!preloader_) {
+		if (cartridge->load_rom(selected_file_)) {
+			if (rom_loaded_callback_) {
+				rom_loaded_callback_(nullptr);
+			}
+		} else {
+			std::cerr << "Failed to load ROM: " << selected_file_ << std::endl;
+		}
+		return;
+	}
+
+	// Normally read while the selection sat there; waits for the rest if not
+	const nes::PreloadedRom rom =
+		preloader_->take(selected_file_, nes::BatterySaveManager::path_for_rom(save_directory_, selected_file_, ".sav"));
+	if (rom.image && cartridge->load_rom_image(rom.image)) {
+		if (rom_loaded_callback_) {
+			rom_loaded_callback_(&rom);
+		}
+	} else {
+		std::cerr << "Failed to load ROM: " << selected_file_ << std::endl;
+	}
+}
+
 bool RomLoaderPanel::is_nes_file(const std::string &filename) const {
 	std::string ext = get_file_extension(filename);
 	return ext == ".nes" || ext == ".NES";
@@ -1,22 +1,56 @@
 #include "gui/panels/timing_panel.hpp"
 #include "core/bus.hpp"
+#include "core/trace_zones.hpp"
 #include "cpu/cpu_6502.hpp"
 #include "ppu/ppu.hpp"
-
+#include "system/emulation_thread.hpp"
+#include "system/frame_latency.hpp"
+#include "system/perf_counters.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
 #include <imgui.h>
 #include <iomanip>
 #include <sstream>
 
 namespace nes::gui {
 
-TimingPanel::TimingPanel()
-	: last_cpu_cycles_(0), last_ppu_cycles_(0), frame_count_(0), cpu_frequency_hz_(0.0f), ppu_frequency_hz_(0.0f),
-	  frame_rate_fps_(0.0f) {
+namespace {
+
+using Counter = nes::PerfCounters::Counter;
+
+// Graph colours, one per counter
+constexpr ImU32 COUNTER_COLORS[nes::PerfCounters::COUNTER_COUNT] = {
+	IM_COL32(230, 230, 230, 255), IM_COL32(255, 140, 60, 255), IM_COL32(90, 200, 255, 255),
+	IM_COL32(120, 230, 120, 255), IM_COL32(230, 110, 230, 255), IM_COL32(255, 220, 80, 255),
+	IM_COL32(255, 90, 90, 255),	  IM_COL32(160, 160, 255, 255)};
+
+float counter_value(void *data, int index) {
+	const auto *graph = static_cast<const std::pair<const nes::PerfCounters *, Counter> *>(data);
+	return graph->first->frame(static_cast<std::size_t>(index))[graph->second];
+}
+
+// The frame time histogram is drawn over its first 50 ms, 0.5 ms per bar
+constexpr int LATENCY_PLOT_BARS = 100;
+constexpr std::size_t LATENCY_BUCKETS_PER_BAR = 5;
+
+float latency_bar(void *data, int index) {
+	const auto *histogram = static_cast<const nes::LatencyHistogram *>(data);
+	std::uint32_t samples = 0;
+	for (std::size_t i = 0; i < LATENCY_BUCKETS_PER_BAR; ++i) {
+		samples += histogram->bucket(static_cast<std::size_t>(index) * LATENCY_BUCKETS_PER_BAR + i);
+	}
+	return static_cast<float>(samples);
 }
 
-void TimingPanel::render(nes::CPU6502 *cpu, nes::PPU *ppu, nes::SystemBus *bus) {
-	(void)bus; // Unused parameter - reserved for future bus timing analysis
+} // namespace
 
+TimingPanel::TimingPanel() = default;
+
+void TimingPanel::render(nes::CPU6502 *cpu, nes::PPU *ppu, nes::PerfCounters *counters, const nes::SystemBus *bus,
+						 nes::FrameLatency *latency) {
 	if (ImGui::BeginChild("TimingInfo", ImVec2(0, 0), true)) {
 		ImGui::Text("TIMING & SYNCHRONIZATION");
 		ImGui::Separator();
@@ -34,6 +68,32 @@ void TimingPanel::render(nes::CPU6502 *cpu, nes::PPU *ppu, nes::SystemBus *bus)
 		}
 
 		ImGui::Spacing();
+
+		if (ImGui::CollapsingHeader("Synchronization")) {
+			render_synchronization_info(ppu, counters);
+		}
+
+		ImGui::Spacing();
+
+		if (ImGui::CollapsingHeader("Performance", ImGuiTreeNodeFlags_DefaultOpen)) {
+			render_performance_metrics(counters);
+		}
+
+		ImGui::Spacing();
+
+		if (ImGui::CollapsingHeader("Frame Pacing & Latency")) {
+			render_latency(latency);
+		}
+#ifdef VIBENES_BUS_STATS
+
+		ImGui::Spacing();
+
+		if (ImGui::CollapsingHeader("Bus Traffic")) {
+			render_bus_traffic(bus, ppu);
+		}
+#else
+		static_cast<void>(bus);
+#endif
 	}
 	ImGui::EndChild();
 }
@@ -57,9 +117,7 @@ void TimingPanel::render_cpu_timing(nes::CPU6502 *cpu) {
 	ImGui::Separator();
 	ImGui::Text("Target Frequency: 1.789773 MHz");
 	ImGui::Text("Target Period: 558.73 ns");
-
-	// TODO: Add total cycle counter to CPU class
-	ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.0f, 1.0f), "Note: Total cycle counter needed in CPU");
+	ImGui::Text("Total Cycles: %s", format_cycles(cpu->get_cycle_count()).c_str());
 }
 
 void TimingPanel::render_ppu_timing(nes::PPU *ppu) {
@@ -106,19 +164,15 @@ void TimingPanel::render_ppu_timing(nes::PPU *ppu) {
 	}
 }
 
-void TimingPanel::render_synchronization_info(nes::CPU6502 *cpu, nes::PPU *ppu) {
-	if (!cpu || !ppu) {
-		ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "CPU or PPU not connected");
+void TimingPanel::render_synchronization_info(nes::PPU *ppu, const nes::PerfCounters *counters) {
+	if (!ppu) {
+		ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "PPU not connected");
 		return;
 	}
 
 	// Show synchronization status
 	ImGui::Text("CPU-PPU Ratio: 1:3 (CPU:PPU)");
 
-	// Calculate theoretical PPU cycles based on CPU
-	// This would need actual CPU cycle counter
-	ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.0f, 1.0f), "Sync analysis requires CPU cycle counter");
-
 	// Show frame timing
 	ImGui::Separator();
 	ImGui::Text("Frame Timing:");
@@ -126,6 +180,25 @@ void TimingPanel::render_synchronization_info(nes::CPU6502 *cpu, nes::PPU *ppu)
 	ImGui::Text("PPU cycles/frame: ~89,342");
 	ImGui::Text("Target FPS: 60.0988");
 
+	// Measured: the cycles each emulated frame actually ran
+	if (counters && counters->size() != 0) {
+		std::uint64_t cycles = 0;
+		std::uint64_t shortest = ~std::uint64_t{0};
+		std::uint64_t longest = 0;
+		for (std::size_t i = 0; i < counters->size(); ++i) {
+			const std::uint64_t frame = counters->frame(i).cpu_cycles;
+			cycles += frame;
+			shortest = std::min(shortest, frame);
+			longest = std::max(longest, frame);
+		}
+		const double mean = static_cast<double>(cycles) / static_cast<double>(counters->size());
+		ImGui::Text("Measured: %.1f cycles/frame (%llu - %llu)", mean, static_cast<unsigned long long>(shortest),
+					static_cast<unsigned long long>(longest));
+		if (std::abs(mean - nes::EmulationThread::CPU_CYCLES_PER_FRAME) > 1.0) {
+			ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.0f, 1.0f), "Off the NTSC frame (PAL, run-ahead or rewind?)");
+		}
+	}
+
 	// VBlank status
 	if (ppu->get_current_scanline() >= 241 && ppu->get_current_scanline() <= 260) {
 		ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "● VBlank Active");
@@ -134,18 +207,230 @@ void TimingPanel::render_synchronization_info(nes::CPU6502 *cpu, nes::PPU *ppu)
 	}
 }
 
-void TimingPanel::render_performance_metrics() {
+void TimingPanel::render_performance_metrics(nes::PerfCounters *counters) {
 	// Show real-time performance
-	ImGui::Text("Real-time Performance:");
-	ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
-	ImGui::Text("Frame Time: %.3f ms", 1000.0f / ImGui::GetIO().Framerate);
+	ImGui::Text("UI: %.1f FPS (%.3f ms)", ImGui::GetIO().Framerate, 1000.0f / ImGui::GetIO().Framerate);
+	if (!counters) {
+		return;
+	}
+
+	bool breakdown = counters->is_component_breakdown();
+	if (ImGui::Checkbox("Component breakdown", &breakdown)) {
+		counters->set_component_breakdown(breakdown);
+	}
+	ImGui::SameLine();
+	ImGui::TextDisabled("(slows emulation)");
+	ImGui::SameLine();
+	if (ImGui::SmallButton("Clear")) {
+		counters->reset();
+	}
+
+	if (counters->size() == 0) {
+		ImGui::TextUnformatted("No frames emulated yet");
+		return;
+	}
+
+	// One graph per counter, scaled to its own peak (at least 1 ms)
+	const float width = ImGui::GetContentRegionAvail().x;
+	for (std::size_t c = 0; c < nes::PerfCounters::COUNTER_COUNT; ++c) {
+		const auto counter = static_cast<Counter>(c);
+		if (nes::PerfCounters::is_component(counter) && !breakdown) {
+			continue;
+		}
+		const float peak = counters->peak(counter);
+		const std::string overlay =
+			std::format("{}: avg {:.2f} ms, peak {:.2f} ms", nes::PerfCounters::counter_name(counter),
+						counters->average(counter), peak);
+		std::pair<const nes::PerfCounters *, Counter> graph{counters, counter};
+		ImGui::PushID(static_cast<int>(c));
+		ImGui::PushStyleColor(ImGuiCol_PlotLines, COUNTER_COLORS[c]);
+		ImGui::PlotLines("##counter", counter_value, &graph, static_cast<int>(counters->size()), 0, overlay.c_str(),
+						 0.0f, std::max(peak, 1.0f), ImVec2(width, 42.0f));
+		ImGui::PopStyleColor();
+		ImGui::PopID();
+	}
+
+	// Time budget: what the emulated frame took against its real duration
+	const float emulation = counters->average(Counter::Emulation);
+	const float budget = static_cast<float>(1000.0 / 60.0988);
+	ImGui::Text("Emulation uses %.0f%% of the frame (%.1fx real time possible)", 100.0f * emulation / budget,
+				emulation > 0.0f ? budget / emulation : 0.0f);
+
+	render_export(*counters);
+#ifdef VIBENES_TRACE_ZONES
+	render_trace_capture();
+#endif
+}
+
+void TimingPanel::render_export(const nes::PerfCounters &counters) {
+	ImGui::Separator();
+	ImGui::SetNextItemWidth(ImGui::CalcItemWidth() * 0.8f);
+	ImGui::InputText("##csv_path", csv_path_.data(), csv_path_.size());
+	ImGui::SameLine();
+	if (ImGui::Button("Export CSV")) {
+		std::ofstream file(csv_path_.data());
+		counters.write_csv(file);
+		csv_status_ = file ? std::format("Wrote {} frames", counters.size()) : std::string("Write failed");
+	}
+	if (!csv_status_.empty()) {
+		ImGui::TextUnformatted(csv_status_.c_str());
+	}
+}
+
+void TimingPanel::render_latency(nes::FrameLatency *latency) {
+	if (!latency) {
+		return;
+	}
+	using Metric = nes::FrameLatency::Metric;
+	ImGui::Text("%llu frames presented", static_cast<unsigned long long>(latency->presentations()));
+	ImGui::SameLine();
+	if (ImGui::SmallButton("Clear##latency")) {
+		latency->reset();
+	}
+	if (latency->presentations() == 0) {
+		ImGui::TextUnformatted("No emulated frames presented yet");
+		return;
+	}
+
+	if (ImGui::BeginTable("LatencyTable", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp)) {
+		ImGui::TableSetupColumn("ms");
+		ImGui::TableSetupColumn("p50");
+		ImGui::TableSetupColumn("p95");
+		ImGui::TableSetupColumn("p99");
+		ImGui::TableSetupColumn("max");
+		ImGui::TableHeadersRow();
+		for (std::size_t m = 0; m < nes::FrameLatency::METRIC_COUNT; ++m) {
+			const auto metric = static_cast<Metric>(m);
+			const nes::LatencyHistogram &histogram = latency->histogram(metric);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(nes::FrameLatency::metric_name(metric));
+			for (const double value : {histogram.percentile(0.50), histogram.percentile(0.95),
+									   histogram.percentile(0.99), histogram.max()}) {
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f", value);
+			}
+		}
+		ImGui::EndTable();
+	}
+
+	// Frame time distribution: a single spike at the refresh period is smooth
+	// pacing; a second one at twice it is a repeated (or dropped) frame
+	const nes::LatencyHistogram &frame_time = latency->histogram(Metric::FrameTime);
+	ImGui::PlotHistogram("##frame_time", latency_bar, const_cast<nes::LatencyHistogram *>(&frame_time),
+						 LATENCY_PLOT_BARS, 0, "frame time, 0-50 ms", 0.0f, FLT_MAX,
+						 ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
+
+	ImGui::SetNextItemWidth(ImGui::CalcItemWidth() * 0.8f);
+	ImGui::InputText("##latency_path", latency_path_.data(), latency_path_.size());
+	ImGui::SameLine();
+	if (ImGui::Button("Save Report")) {
+		std::ofstream file(latency_path_.data());
+		latency->write_report(file);
+		latency_status_ = file ? std::format("Wrote {} frames", latency->presentations()) : std::string("Write failed");
+	}
+	if (!latency_status_.empty()) {
+		ImGui::TextUnformatted(latency_status_.c_str());
+	}
+}
+
+void TimingPanel::render_trace_capture() {
+	const bool recording = nes::TraceZones::is_recording();
+	ImGui::BeginDisabled(recording);
+	ImGui::SetNextItemWidth(ImGui::CalcItemWidth() * 0.8f);
+	ImGui::InputText("##trace_path", trace_path_.data(), trace_path_.size());
+	ImGui::EndDisabled();
+	ImGui::SameLine();
+	if (!recording) {
+		if (ImGui::Button("Capture Trace")) {
+			nes::TraceZones::start();
+			trace_status_ = "Capturing...";
+		}
+	} else if (ImGui::Button("Stop and Save")) {
+		nes::TraceZones::stop();
+		if (!nes::TraceZones::save(trace_path_.data())) {
+			trace_status_ = "Write failed";
+		} else if (nes::TraceZones::dropped_events() != 0) {
+			trace_status_ = std::format("Saved ({} zones dropped)", nes::TraceZones::dropped_events());
+		} else {
+			trace_status_ = std::format("Saved {} zones", nes::TraceZones::event_count());
+		}
+	}
+	if (!trace_status_.empty()) {
+		ImGui::TextUnformatted(trace_status_.c_str());
+	}
+}
+
+void TimingPanel::render_bus_traffic(const nes::SystemBus *bus, const nes::PPU *ppu) {
+	if (!bus || !ppu) {
+		ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "System not connected");
+		return;
+	}
+	const nes::BusStats &stats = bus->get_bus_stats();
+	const nes::PpuFetchStats &fetches = ppu->get_total_fetch_stats();
+	if (ImGui::SmallButton("Reset")) {
+		bus_baseline_ = stats;
+		fetch_baseline_ = fetches;
+		baseline_frame_ = ppu->get_frame_count();
+	}
+	// The emulator may have been reset or a state loaded since the baseline
+	const std::uint64_t frame = ppu->get_frame_count();
+	if (frame < baseline_frame_ || stats.total_reads() < bus_baseline_.total_reads()) {
+		bus_baseline_ = nes::BusStats{};
+		fetch_baseline_ = nes::PpuFetchStats{};
+		baseline_frame_ = 0;
+	}
+	const std::uint64_t frames = frame - baseline_frame_;
+	ImGui::SameLine();
+	ImGui::Text("Per frame, over %llu frames", static_cast<unsigned long long>(frames));
+	const auto per_frame = [frames](std::uint64_t count) {
+		return frames ? static_cast<double>(count) / static_cast<double>(frames) : 0.0;
+	};
+
+	if (ImGui::BeginTable("BusRegions", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+		ImGui::TableSetupColumn("CPU region");
+		ImGui::TableSetupColumn("Reads");
+		ImGui::TableSetupColumn("Writes");
+		ImGui::TableHeadersRow();
+		for (std::size_t i = 0; i < nes::BusStats::REGION_COUNT; ++i) {
+			const auto region = static_cast<nes::BusStats::Region>(i);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(nes::BusStats::region_name(region));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.0f", per_frame(stats.reads_in(region) - bus_baseline_.reads_in(region)));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.0f", per_frame(stats.writes_in(region) - bus_baseline_.writes_in(region)));
+		}
+		ImGui::EndTable();
+	}
+
+	// How much of the traffic each fast path took
+	const auto share = [](std::uint64_t part, std::uint64_t whole) {
+		return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+	};
+	const std::uint64_t ram_reads =
+		stats.reads_in(nes::BusStats::Region::Ram) - bus_baseline_.reads_in(nes::BusStats::Region::Ram);
+	const std::uint64_t ram_writes =
+		stats.writes_in(nes::BusStats::Region::Ram) - bus_baseline_.writes_in(nes::BusStats::Region::Ram);
+	const std::uint64_t rom_reads =
+		stats.reads_in(nes::BusStats::Region::PrgRom) - bus_baseline_.reads_in(nes::BusStats::Region::PrgRom);
+	ImGui::Text("Zero page/stack path: %.1f%% of RAM reads, %.1f%% of writes",
+				share(stats.low_ram_reads - bus_baseline_.low_ram_reads, ram_reads),
+				share(stats.low_ram_writes - bus_baseline_.low_ram_writes, ram_writes));
+	ImGui::Text("PRG page table: %.1f%% of PRG-ROM reads",
+				share(stats.prg_page_reads - bus_baseline_.prg_page_reads, rom_reads));
 
-	// Show ImGui metrics
 	ImGui::Separator();
-	ImGui::Text("Render Statistics:");
-	ImGui::Text("Draw Calls: %d", ImGui::GetIO().MetricsRenderVertices / 3); // Rough estimate
-	ImGui::Text("Vertices: %d", ImGui::GetIO().MetricsRenderVertices);
-	ImGui::Text("Windows: %d", ImGui::GetIO().MetricsRenderWindows);
+	const nes::PpuFetchStats &last = ppu->get_frame_fetch_stats();
+	const std::uint64_t pattern = fetches.pattern - fetch_baseline_.pattern;
+	const std::uint64_t cached = fetches.pattern_cached - fetch_baseline_.pattern_cached;
+	ImGui::Text("PPU last frame: %llu nametable, %llu pattern (+%llu cached), %llu palette",
+				static_cast<unsigned long long>(last.nametable), static_cast<unsigned long long>(last.pattern),
+				static_cast<unsigned long long>(last.pattern_cached), static_cast<unsigned long long>(last.palette));
+	ImGui::Text("CHR tile cache: %.1f%% of pattern bytes", share(cached, pattern + cached));
+	ImGui::Text("Palette table rebuilds: %.1f per frame",
+				per_frame(fetches.palette_rebuilds - fetch_baseline_.palette_rebuilds));
 }
 
 std::string TimingPanel::format_cycles(std::uint64_t cycles) const {
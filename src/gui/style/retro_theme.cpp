@@ -114,4 +114,8 @@ ImVec4 RetroTheme::get_value_color() {
 	return NES_GREEN;
 }
 
+ImVec4 RetroTheme::get_changed_value_color() {
+	return NES_RED;
+}
+
 } // namespace nes::gui
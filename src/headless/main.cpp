@@ -0,0 +1,529 @@
+// VibeNES_Headless - run a ROM with no window, audio device or gamepad.
+//
+// Usage: VibeNES_Headless <rom.nes> [--frames N] [--dump-frame out.ppm]
+//                         [--cpu-profile PREFIX] [--cdl FILE] [--trace FILE]
+//                         [--frame-skip N] [--movie FILE] [--record-movie FILE]
+//                         [--record-audio FILE [--audio-stems] [--audio-raw]]
+//                         [--trace-zones FILE] [--bus-stats]
+//                         [--capture-dir DIR] [--capture-video FILE] [--capture-pipe CMD]
+//                         [--simd LEVEL] [--shared-memory NAME]
+//                         [--stream PORT [--stream-sessions N] [--stream-threads N]]
+//
+// Prints the number of frames and CPU cycles executed plus an FNV-1a hash of
+// the final frame buffer, which is enough for scripted ROM regression runs.
+// --dump-frame writes PNG when the name ends in .png, PPM otherwise.
+// --cpu-profile (builds with VIBENES_CPU_PROFILER) writes the hot-PC profile
+// to PREFIX.flat.txt and the JSR/RTS call graph to PREFIX.callgraph.txt.
+// --cdl records a Code/Data Log, merged into FILE if it already exists, and
+// prints the PRG/CHR ROM coverage.
+// --trace (builds with VIBENES_CPU_TRACE) streams every executed instruction
+// to FILE in binary; convert it with VibeNES_TraceDump. Idle-loop skipping
+// is turned off so the trace is complete.
+// --frame-skip composes pixels on every Nth frame only (timing and flags are
+// unchanged); with --frames a multiple of N the final frame hash matches a
+// run without it.
+// --movie plays a .vnmovie's input (from its start state, for as many frames
+// as it holds unless --frames is given); --record-movie writes the run's
+// input to a new movie, e.g. to cut one down with --frames.
+// --record-audio writes the APU output as 32-bit float mono WAV (44.1 kHz),
+// or bare floats with --audio-raw; --audio-stems adds one file per channel
+// next to it (FILE.pulse1.wav, ...). Audio never affects the frame hash.
+// --trace-zones (builds with VIBENES_TRACE_ZONES) captures the run's
+// profiling zones to FILE as Chrome trace_event JSON (chrome://tracing,
+// Perfetto).
+// --bus-stats (builds with VIBENES_BUS_STATS) prints the run's CPU bus
+// accesses by region and the PPU's fetches per frame.
+// --capture-dir writes every frame to DIR/frame_NNNNNN.png, encoded on all
+// cores while emulation continues; --capture-video writes them as raw RGB24
+// video and --capture-pipe feeds that stream to CMD's stdin, e.g.
+// "ffmpeg -f rawvideo -pix_fmt rgb24 -s 256x240 -r 60.0988 -i - run.mp4".
+// --simd (or --simd=LEVEL) pins the vector kernels to scalar, sse2, sse4.2,
+// avx2, avx512 or neon instead of the best the CPU supports; the level used
+// is printed either way.
+// --shared-memory serves the ROM to a trainer in another process through
+// the shared region NAME (SharedMemoryEnv: the frame's palette indices,
+// work RAM and a step/control block) until it sends Quit, instead of
+// running --frames.
+// --stream serves the ROM to remote players on UDP PORT (StreamServer: tile
+// deltas of the frame's palette indices out, buttons in) until interrupted,
+// instead of running --frames: N sessions, each its own console on the
+// shared ROM image, run on --stream-threads worker threads (default 1).
+
+#include "apu/apu.hpp"
+#include "audio/audio_recorder.hpp"
+#include "cartridge/cartridge.hpp"
+#include "cartridge/rom_image.hpp"
+#include "core/bus_stats.hpp"
+#include "core/simd.hpp"
+#include "core/trace_zones.hpp"
+#include "input/input_movie.hpp"
+#include "input/latched_input.hpp"
+#include "system/frame_capture.hpp"
+#include "system/frame_dump.hpp"
+#include "system/headless_system.hpp"
+#include "system/save_state.hpp"
+#include "system/shared_env.hpp"
+#include "system/stream_server.hpp"
+#if defined(VIBENES_CPU_PROFILER) || defined(VIBENES_CPU_TRACE)
+#include "cpu/cpu_6502.hpp"
+#endif
+#ifdef VIBENES_CPU_PROFILER
+#include "cpu/cpu_profiler.hpp"
+#endif
+#ifdef VIBENES_CPU_TRACE
+#include "cpu/cpu_trace.hpp"
+#endif
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void print_usage(const char *program) {
+	std::cerr << "Usage: " << program << " <rom.nes> [--frames N] [--dump-frame out.ppm] [--cpu-profile PREFIX]"
+			  << " [--cdl FILE] [--trace FILE] [--frame-skip N] [--movie FILE] [--record-movie FILE]"
+			  << " [--record-audio FILE [--audio-stems] [--audio-raw]] [--trace-zones FILE]"
+			  << " [--bus-stats] [--capture-dir DIR] [--capture-video FILE] [--capture-pipe CMD] [--simd LEVEL]"
+			  << " [--shared-memory NAME] [--stream PORT [--stream-sessions N] [--stream-threads N]]\n";
+}
+
+// Serve sessions copies of the ROM on port until SIGINT or SIGTERM
+int serve_stream(const std::string &rom_path, long port, long sessions, long threads, long frame_skip) {
+	const std::shared_ptr<const nes::RomImage> rom = nes::RomImage::load(rom_path);
+	if (!rom) {
+		std::cerr << "Failed to load ROM: " << rom_path << "\n";
+		return 1;
+	}
+	std::vector<std::shared_ptr<nes::LatchedInputSource>> inputs;
+	std::vector<std::unique_ptr<nes::HeadlessSystem>> systems;
+	nes::StreamServer server;
+	for (long i = 0; i < sessions; ++i) {
+		inputs.push_back(std::make_shared<nes::LatchedInputSource>());
+		systems.push_back(std::make_unique<nes::HeadlessSystem>(inputs.back()));
+		if (!systems.back()->load_rom_image(rom)) {
+			std::cerr << "Failed to load ROM: " << rom_path << "\n";
+			return 1;
+		}
+		systems.back()->set_frame_skip(static_cast<uint32_t>(frame_skip));
+		server.add_session(*systems.back(), inputs.back());
+	}
+	if (!server.start(static_cast<uint16_t>(port), static_cast<unsigned>(threads))) {
+		std::cerr << "Cannot bind UDP port " << port << "\n";
+		return 1;
+	}
+	std::cout << "stream: port " << server.port() << " sessions " << sessions << " threads " << threads << std::endl;
+
+	std::signal(SIGINT, [](int) { stop_requested = 1; });
+	std::signal(SIGTERM, [](int) { stop_requested = 1; });
+	while (!stop_requested) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	server.stop();
+
+	const nes::StreamServer::Stats stats = server.stats();
+	std::cout << "frames_sent: " << stats.frames_sent << " keyframes " << stats.keyframes_sent << " dropped "
+			  << stats.frames_dropped << "\n";
+	std::cout << "bytes_sent: " << stats.bytes_sent << "\n";
+	if (stats.frames_sent) {
+		std::cout << "encode_us_per_frame: " << stats.encode_ns / stats.frames_sent / 1000.0 << "\n";
+	}
+	return 0;
+}
+
+void print_bus_stats(const nes::HeadlessSystem &system, uint64_t frames) {
+	const nes::BusStats &bus = system.get_bus_stats();
+	std::cout << "bus_reads: " << bus.total_reads() << "\n";
+	std::cout << "bus_writes: " << bus.total_writes() << "\n";
+	for (std::size_t i = 0; i < nes::BusStats::REGION_COUNT; ++i) {
+		const auto region = static_cast<nes::BusStats::Region>(i);
+		std::cout << "bus_region: " << nes::BusStats::region_name(region) << " reads " << bus.reads_in(region)
+				  << " writes " << bus.writes_in(region) << "\n";
+	}
+	std::cout << "bus_fast_paths: low_ram_reads " << bus.low_ram_reads << " low_ram_writes " << bus.low_ram_writes
+			  << " prg_page_reads " << bus.prg_page_reads << "\n";
+
+	const nes::PpuFetchStats &ppu = system.get_ppu_fetch_stats();
+	const auto per_frame = [frames](uint64_t count) { return frames ? count / frames : 0; };
+	std::cout << "ppu_fetches_per_frame: nametable " << per_frame(ppu.nametable) << " pattern "
+			  << per_frame(ppu.pattern) << " pattern_cached " << per_frame(ppu.pattern_cached) << " palette "
+			  << per_frame(ppu.palette) << " palette_rebuilds " << ppu.palette_rebuilds << "\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	std::string rom_path;
+	std::string dump_path;
+	std::string profile_prefix;
+	std::string cdl_path;
+	std::string trace_path;
+	std::string movie_path;
+	std::string record_path;
+	std::string audio_path;
+	std::string zones_path;
+	std::string capture_dir;
+	std::string capture_video;
+	std::string capture_pipe;
+	bool audio_stems = false;
+	bool audio_raw = false;
+	bool bus_stats = false;
+	long frames = 60;
+	bool frames_given = false;
+	long frame_skip = 1;
+	std::string simd;
+	std::string shared_memory;
+	long stream_port = -1;
+	long stream_sessions = 1;
+	long stream_threads = 1;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--frames" && i + 1 < argc) {
+			frames = std::strtol(argv[++i], nullptr, 10);
+			frames_given = true;
+		} else if (arg == "--dump-frame" && i + 1 < argc) {
+			dump_path = argv[++i];
+		} else if (arg == "--cpu-profile" && i + 1 < argc) {
+			profile_prefix = argv[++i];
+		} else if (arg == "--cdl" && i + 1 < argc) {
+			cdl_path = argv[++i];
+		} else if (arg == "--trace" && i + 1 < argc) {
+			trace_path = argv[++i];
+		} else if (arg == "--frame-skip" && i + 1 < argc) {
+			frame_skip = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--movie" && i + 1 < argc) {
+			movie_path = argv[++i];
+		} else if (arg == "--record-movie" && i + 1 < argc) {
+			record_path = argv[++i];
+		} else if (arg == "--record-audio" && i + 1 < argc) {
+			audio_path = argv[++i];
+		} else if (arg == "--trace-zones" && i + 1 < argc) {
+			zones_path = argv[++i];
+		} else if (arg == "--capture-dir" && i + 1 < argc) {
+			capture_dir = argv[++i];
+		} else if (arg == "--capture-video" && i + 1 < argc) {
+			capture_video = argv[++i];
+		} else if (arg == "--capture-pipe" && i + 1 < argc) {
+			capture_pipe = argv[++i];
+		} else if (arg == "--simd" && i + 1 < argc) {
+			simd = argv[++i];
+		} else if (arg.starts_with("--simd=")) {
+			simd = arg.substr(7);
+		} else if (arg == "--shared-memory" && i + 1 < argc) {
+			shared_memory = argv[++i];
+		} else if (arg == "--stream" && i + 1 < argc) {
+			stream_port = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--stream-sessions" && i + 1 < argc) {
+			stream_sessions = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--stream-threads" && i + 1 < argc) {
+			stream_threads = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--audio-stems") {
+			audio_stems = true;
+		} else if (arg == "--audio-raw") {
+			audio_raw = true;
+		} else if (arg == "--bus-stats") {
+			bus_stats = true;
+		} else if (arg == "--help" || arg == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else if (rom_path.empty() && !arg.starts_with("--")) {
+			rom_path = arg;
+		} else {
+			print_usage(argv[0]);
+			return 2;
+		}
+	}
+
+	const int capture_outputs = !capture_dir.empty() + !capture_video.empty() + !capture_pipe.empty();
+	if (rom_path.empty() || frames < 0 || frame_skip < 0 || capture_outputs > 1 ||
+		(!shared_memory.empty() && (!movie_path.empty() || !record_path.empty()))) {
+		print_usage(argv[0]);
+		return 2;
+	}
+	const bool streaming = stream_port >= 0;
+	if (streaming && (stream_port > 65535 || stream_sessions < 1 || stream_sessions > 65536 || stream_threads < 1 ||
+					  !shared_memory.empty() || !movie_path.empty() || !record_path.empty())) {
+		print_usage(argv[0]);
+		return 2;
+	}
+
+	if (!simd.empty()) {
+		const std::optional<nes::SimdLevel> level = nes::parse_simd_level(simd);
+		if (!level || !nes::set_simd_level(*level)) {
+			std::cerr << "SIMD level not available: " << simd << " (best: "
+					  << nes::simd_level_name(nes::best_simd_level()) << ")\n";
+			return 2;
+		}
+	}
+
+	if (streaming) {
+		return serve_stream(rom_path, stream_port, stream_sessions, stream_threads, frame_skip);
+	}
+
+	std::shared_ptr<nes::InputSource> input;
+	std::shared_ptr<nes::MoviePlayer> player;
+	std::shared_ptr<nes::MovieRecorder> recorder;
+	std::shared_ptr<nes::LatchedInputSource> trainer_input;
+	if (!shared_memory.empty()) {
+		trainer_input = std::make_shared<nes::LatchedInputSource>();
+		input = trainer_input;
+	}
+	if (!movie_path.empty()) {
+		player = std::make_shared<nes::MoviePlayer>();
+		if (!player->open(movie_path)) {
+			return 1;
+		}
+		input = player;
+	}
+	if (!record_path.empty()) {
+		recorder = std::make_shared<nes::MovieRecorder>(input);
+		input = recorder;
+	}
+
+	nes::HeadlessSystem system(input);
+	if (!system.load_rom(rom_path)) {
+		std::cerr << "Failed to load ROM: " << rom_path << "\n";
+		return 1;
+	}
+
+	if (player || recorder) {
+		nes::SaveStateManager states(&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge());
+		const uint32_t rom_crc32 = states.calculate_rom_crc32();
+		const std::vector<uint8_t> no_state;
+		const std::vector<uint8_t> &start_state = player ? player->get_start_state() : no_state;
+		if (player) {
+			if (player->get_header().rom_crc32 != rom_crc32) {
+				std::cerr << "Movie " << movie_path << " was recorded with a different ROM\n";
+				return 1;
+			}
+			if (!start_state.empty() && !states.deserialize_state(start_state)) {
+				std::cerr << "Movie start state does not load: " << states.get_last_error() << "\n";
+				return 1;
+			}
+			if (!frames_given && player->get_header().frame_count > 0) {
+				frames = static_cast<long>(player->get_header().frame_count);
+			}
+		}
+		if (recorder && !recorder->open(record_path, rom_crc32, start_state)) {
+			return 1;
+		}
+	}
+	system.set_frame_skip(static_cast<uint32_t>(frame_skip));
+
+	if (!shared_memory.empty()) {
+		nes::SharedMemoryEnv env(system, trainer_input);
+		if (!env.create(shared_memory)) {
+			std::cerr << "Cannot create shared memory region " << shared_memory << "\n";
+			return 1;
+		}
+		std::cout << "shared_memory: " << shared_memory << " bytes " << sizeof(nes::SharedEnvRegion) << std::endl;
+		env.serve();
+		std::cout << "frames: " << system.get_frame_count() << "\n";
+		return 0;
+	}
+
+#ifdef VIBENES_CPU_PROFILER
+	nes::CpuProfiler profiler(&system.cartridge());
+	if (!profile_prefix.empty()) {
+		system.cpu().set_profiler(&profiler);
+	}
+#else
+	if (!profile_prefix.empty()) {
+		std::cerr << "--cpu-profile needs a build configured with -DVIBENES_CPU_PROFILER=ON\n";
+		return 2;
+	}
+#endif
+
+#ifdef VIBENES_CPU_TRACE
+	nes::CpuTraceWriter tracer;
+	if (!trace_path.empty()) {
+		if (!tracer.open(trace_path)) {
+			std::cerr << "Failed to open trace file " << trace_path << "\n";
+			return 1;
+		}
+		system.cpu().set_idle_loop_skipping(false);
+		system.cpu().set_tracer(&tracer);
+	}
+#else
+	if (!trace_path.empty()) {
+		std::cerr << "--trace needs a build configured with -DVIBENES_CPU_TRACE=ON\n";
+		return 2;
+	}
+#endif
+
+	if (!cdl_path.empty()) {
+		system.cartridge().set_cdl_enabled(true);
+		if (std::filesystem::exists(cdl_path) && !system.cartridge().get_cdl().load(cdl_path)) {
+			return 1;
+		}
+	}
+
+	nes::AudioRecorder audio;
+	if (!audio_path.empty()) {
+		const auto format = audio_raw ? nes::AudioRecorder::Format::RawFloat : nes::AudioRecorder::Format::Wav;
+		const int sample_rate = static_cast<int>(system.apu().get_output_sample_rate());
+		if (!audio.open(audio_path, sample_rate, format, audio_stems)) {
+			std::cerr << "Failed to open audio file " << audio_path << "\n";
+			return 1;
+		}
+		system.apu().set_recorder(&audio);
+		system.apu().enable_audio(true);
+	}
+
+#ifndef VIBENES_TRACE_ZONES
+	if (!zones_path.empty()) {
+		std::cerr << "--trace-zones needs a build configured with -DVIBENES_TRACE_ZONES=ON\n";
+		return 2;
+	}
+#endif
+	if (bus_stats && !nes::BusStats::ENABLED) {
+		std::cerr << "--bus-stats needs a build configured with -DVIBENES_BUS_STATS=ON\n";
+		return 2;
+	}
+	// Every frame is kept: emulation waits if the encoder falls a pool behind
+	nes::FrameCapture capture;
+	nes::FrameCapture::Options capture_options;
+	capture_options.when_full = nes::FrameCapture::WhenFull::Wait;
+	capture_options.workers = 0;
+	if (!capture_dir.empty() && !capture.open(capture_dir, nes::FrameCapture::Format::PngSequence, capture_options)) {
+		return 1;
+	}
+	if (!capture_video.empty() &&
+		!capture.open(capture_video, nes::FrameCapture::Format::RawVideo, capture_options)) {
+		return 1;
+	}
+	if (!capture_pipe.empty() && !capture.open_pipe(capture_pipe, capture_options)) {
+		return 1;
+	}
+
+	system.reset_bus_stats();
+	const uint64_t stats_first_frame = system.get_frame_count();
+
+	if (!zones_path.empty()) {
+		nes::TraceZones::set_thread_name("Headless");
+		nes::TraceZones::start();
+	}
+
+	uint64_t total_cycles = 0;
+	for (long frame = 0; frame < frames; ++frame) {
+		if (player) {
+			player->next_frame();
+		}
+		if (recorder) {
+			recorder->next_frame();
+		}
+		const uint64_t cycles = system.run_frame();
+		if (cycles == 0) {
+			std::cerr << "CPU stalled at frame " << frame << "\n";
+			break;
+		}
+		total_cycles += cycles;
+		if (capture.is_open()) {
+			capture.submit(system.get_frame_buffer());
+		}
+	}
+
+	if (capture.is_open()) {
+		const bool written = capture.close();
+		std::cout << "captured_frames: " << capture.frames_written() << "\n";
+		if (!written) {
+			std::cerr << "Failed to write captured frames\n";
+			return 1;
+		}
+	}
+
+	if (!zones_path.empty()) {
+		nes::TraceZones::stop();
+		std::cout << "trace_zones: " << nes::TraceZones::event_count() << "\n";
+		if (!nes::TraceZones::save(zones_path)) {
+			std::cerr << "Failed to write trace zones to " << zones_path << "\n";
+			return 1;
+		}
+	}
+
+	if (audio.is_open()) {
+		system.apu().set_recorder(nullptr);
+		const bool written = audio.close();
+		std::cout << "audio_samples: " << audio.samples_written(nes::AudioRecorder::Track::Mix) << "\n";
+		if (audio.dropped_samples() != 0) {
+			std::cerr << "Audio writer fell behind; " << audio.dropped_samples() << " samples dropped\n";
+		}
+		if (!written) {
+			std::cerr << "Failed to write audio to " << audio_path << "\n";
+			return 1;
+		}
+	}
+
+	if (recorder && !recorder->close()) {
+		std::cerr << "Failed to write movie to " << record_path << "\n";
+		return 1;
+	}
+
+	const uint32_t *pixels = system.get_frame_buffer();
+	std::cout << "frames: " << system.get_frame_count() << "\n";
+	std::cout << "cpu_cycles: " << total_cycles << "\n";
+	std::cout << "simd: " << nes::simd_level_name(nes::simd_level()) << "\n";
+	std::cout << "frame_hash: " << std::hex << nes::hash_frame_buffer(pixels) << std::dec << "\n";
+
+	if (bus_stats) {
+		print_bus_stats(system, system.get_frame_count() - stats_first_frame);
+	}
+
+	const bool dump_png = std::filesystem::path(dump_path).extension() == ".png";
+	if (!dump_path.empty() &&
+		!(dump_png ? nes::write_frame_png(dump_path, pixels) : nes::write_frame_ppm(dump_path, pixels))) {
+		std::cerr << "Failed to write frame to " << dump_path << "\n";
+		return 1;
+	}
+
+#ifdef VIBENES_CPU_TRACE
+	if (!trace_path.empty()) {
+		system.cpu().set_tracer(nullptr);
+		const bool written = tracer.close();
+		std::cout << "trace_records: " << tracer.records_recorded() << "\n";
+		if (!written) {
+			std::cerr << "Failed to write trace to " << trace_path << "\n";
+			return 1;
+		}
+	}
+#endif
+
+	if (!cdl_path.empty()) {
+		const nes::CodeDataLogger &cdl = system.cartridge().get_cdl();
+		const nes::CodeDataLogger::Coverage coverage = cdl.coverage();
+		std::cout << "cdl_prg: " << coverage.prg_logged << "/" << coverage.prg_size << " (code " << coverage.prg_code
+				  << ", data " << coverage.prg_data << ", pcm " << coverage.prg_pcm << ")\n";
+		std::cout << "cdl_chr: " << coverage.chr_logged << "/" << coverage.chr_size << " (rendered "
+				  << coverage.chr_rendered << ", read " << coverage.chr_read << ")\n";
+		if (!cdl.save(cdl_path)) {
+			return 1;
+		}
+	}
+
+#ifdef VIBENES_CPU_PROFILER
+	if (!profile_prefix.empty()) {
+		system.cpu().set_profiler(nullptr);
+		std::ofstream flat(profile_prefix + ".flat.txt");
+		profiler.write_flat_profile(flat);
+		std::ofstream graph(profile_prefix + ".callgraph.txt");
+		profiler.write_call_graph(graph);
+		if (!flat || !graph) {
+			std::cerr << "Failed to write CPU profile to " << profile_prefix << ".*\n";
+			return 1;
+		}
+	}
+#endif
+	return 0;
+}
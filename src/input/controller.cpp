@@ -1,8 +1,33 @@
 #include "input/controller.hpp"
+#include "ppu/ppu.hpp"
 
 namespace nes {
 
-Controller::Controller(std::shared_ptr<GamepadManager> gamepad_manager) : gamepad_manager_(std::move(gamepad_manager)) {
+InputSetup input_setup_for_expansion_device(std::uint8_t device) noexcept {
+	InputSetup setup;
+	switch (device) {
+	case 0x02: // NES Four Score / Satellite
+		setup.four_score = true;
+		break;
+	case 0x08: // Zapper in $4017
+		setup.port2 = PortDevice::Zapper;
+		break;
+	case 0x09: // Two Zappers
+		setup.port1 = PortDevice::Zapper;
+		setup.port2 = PortDevice::Zapper;
+		break;
+	case 0x0F: // Arkanoid Vaus controller (NES), in $4017
+		setup.port2 = PortDevice::ArkanoidPaddle;
+		break;
+	default:
+		break;
+	}
+	return setup;
+}
+
+Controller::Controller(std::shared_ptr<InputSource> input_source)
+	: input_source_(std::move(input_source)),
+	  button_snapshot_(input_source_ ? input_source_->button_snapshot() : nullptr) {
 }
 
 void Controller::tick(CpuCycle cycles) {
@@ -11,13 +36,11 @@ void Controller::tick(CpuCycle cycles) {
 }
 
 void Controller::reset() {
+	// Devices stay plugged in across a reset; only the shift state clears
 	strobe_ = false;
-	shift_register_1_ = 0x00;
-	shift_register_2_ = 0x00;
-	shift_count_1_ = 0;
-	shift_count_2_ = 0;
-	button_states_1_ = 0x00;
-	button_states_2_ = 0x00;
+	shift_registers_.fill(0);
+	shift_counts_.fill(0);
+	button_states_.fill(0x00);
 }
 
 void Controller::power_on() {
@@ -29,39 +52,30 @@ const char *Controller::get_name() const noexcept {
 }
 
 Byte Controller::read(Address address) const noexcept {
-	if (address == 0x4016) {
-		// Controller 1
-		if (strobe_) {
-			// While strobe is high, continuously return button A state
-			return (read_gamepad_state(0) & 0x01) | 0x40;
-		} else {
-			// After 8 reads, real hardware returns 1 for all subsequent reads
-			if (shift_count_1_ >= 8) {
-				return 0x41; // All 1s + open bus bit 6
-			}
-			// Return current bit from shift register
-			Byte bit = (shift_register_1_ >> shift_count_1_) & 0x01;
-			shift_count_1_++;
-			return bit | 0x40; // Bit 6 is always 1 (open bus behavior)
-		}
-	} else if (address == 0x4017) {
-		// Controller 2
-		if (strobe_) {
-			// While strobe is high, continuously return button A state
-			return (read_gamepad_state(1) & 0x01) | 0x40;
-		} else {
-			// After 8 reads, real hardware returns 1 for all subsequent reads
-			if (shift_count_2_ >= 8) {
-				return 0x41; // All 1s + open bus bit 6
-			}
-			// Return current bit from shift register
-			Byte bit = (shift_register_2_ >> shift_count_2_) & 0x01;
-			shift_count_2_++;
-			return bit | 0x40; // Bit 6 is always 1 (open bus behavior)
+	if (address != 0x4016 && address != 0x4017) {
+		return 0x40; // Open bus
+	}
+	const int port = address & 0x01; // $4016 -> 0, $4017 -> 1
+
+	if (!pads_only_) [[unlikely]] {
+		const PortDevice device = port == 0 ? setup_.port1 : setup_.port2;
+		if (device != PortDevice::StandardPad) {
+			return read_device(port);
 		}
 	}
 
-	return 0x40; // Open bus
+	if (strobe_) {
+		// While strobe is high, continuously return button A state
+		return (read_gamepad_state(port) & 0x01) | 0x40;
+	}
+	// After the last bit, real hardware returns 1 for all subsequent reads
+	if (shift_counts_[port] >= shift_length_) {
+		return 0x41; // All 1s + open bus bit 6
+	}
+	// Return current bit from shift register
+	const Byte bit = (shift_registers_[port] >> shift_counts_[port]) & 0x01;
+	shift_counts_[port]++;
+	return bit | 0x40; // Bit 6 is always 1 (open bus behavior)
 }
 
 void Controller::write(Byte value) noexcept {
@@ -76,78 +90,138 @@ void Controller::write(Byte value) noexcept {
 
 	// Reset shift counters when strobe goes high
 	if (strobe_) {
-		shift_count_1_ = 0;
-		shift_count_2_ = 0;
+		shift_counts_.fill(0);
 	}
 }
 
 Byte Controller::get_button_states(int controller_index) const noexcept {
-	return controller_index == 0 ? button_states_1_ : button_states_2_;
+	if (controller_index < 0 || controller_index >= static_cast<int>(button_states_.size())) {
+		return 0x00;
+	}
+	return button_states_[static_cast<std::size_t>(controller_index)];
+}
+
+void Controller::configure(const InputSetup &setup) noexcept {
+	setup_ = setup;
+	if (setup_.four_score) {
+		// The multitap only takes pads
+		setup_.port1 = PortDevice::StandardPad;
+		setup_.port2 = PortDevice::StandardPad;
+	}
+	pads_only_ = setup_.port1 == PortDevice::StandardPad && setup_.port2 == PortDevice::StandardPad;
+	reads_ppu_ = setup_.port1 == PortDevice::Zapper || setup_.port2 == PortDevice::Zapper;
+	shift_length_ = setup_.four_score ? 24 : 8;
 }
 
 void Controller::latch_button_states() {
 	// Read current gamepad states and latch them
-	button_states_1_ = read_gamepad_state(0);
-	button_states_2_ = read_gamepad_state(1);
+	if (button_snapshot_) {
+		const std::uint32_t buttons = button_snapshot_->load(std::memory_order_acquire);
+		for (std::size_t player = 0; player < button_states_.size(); ++player) {
+			button_states_[player] = static_cast<Byte>(buttons >> (player * 8));
+		}
+	} else {
+		button_states_[0] = read_gamepad_state(0);
+		button_states_[1] = read_gamepad_state(1);
+		button_states_[2] = setup_.four_score ? read_gamepad_state(2) : 0x00;
+		button_states_[3] = setup_.four_score ? read_gamepad_state(3) : 0x00;
+	}
 
 	// Load shift registers with button states
-	shift_register_1_ = button_states_1_;
-	shift_register_2_ = button_states_2_;
+	if (setup_.four_score) {
+		// Port pad, then the multitap's second pad, then its signature
+		shift_registers_[0] = button_states_[0] | (button_states_[2] << 8) | (0x10u << 16);
+		shift_registers_[1] = button_states_[1] | (button_states_[3] << 8) | (0x20u << 16);
+	} else {
+		button_states_[2] = 0x00;
+		button_states_[3] = 0x00;
+		shift_registers_[0] = button_states_[0];
+		shift_registers_[1] = button_states_[1];
+	}
+
+	if (!pads_only_) [[unlikely]] {
+		for (int port = 0; port < 2; ++port) {
+			if ((port == 0 ? setup_.port1 : setup_.port2) == PortDevice::ArkanoidPaddle) {
+				// The knob position goes out inverted
+				const PointerState knob = input_source_ ? input_source_->read_pointer(port) : PointerState{};
+				shift_registers_[static_cast<std::size_t>(port)] = static_cast<Byte>(~knob.x);
+			}
+		}
+	}
 
 	// Reset shift counters
-	shift_count_1_ = 0;
-	shift_count_2_ = 0;
+	shift_counts_.fill(0);
 }
 
 Byte Controller::read_gamepad_state(int player_index) const noexcept {
-	if (!gamepad_manager_ || !gamepad_manager_->is_controller_connected(player_index)) {
-		return 0x00; // No buttons pressed if controller not connected
+	if (button_snapshot_) {
+		return static_cast<Byte>(button_snapshot_->load(std::memory_order_acquire) >> (player_index * 8));
 	}
-
-	Byte state = 0x00;
-
-	// Button mapping: Modern controller -> NES controller
-	// NES A button = Xbox A (SOUTH)
-	if (gamepad_manager_->is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_SOUTH)) {
-		state |= (1 << static_cast<uint8_t>(NESButton::A));
-	}
-
-	// NES B button = Xbox X (WEST)
-	if (gamepad_manager_->is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_WEST)) {
-		state |= (1 << static_cast<uint8_t>(NESButton::B));
+	if (!input_source_) {
+		return 0x00; // No input device attached
 	}
+	return input_source_->read_buttons(player_index);
+}
 
-	// Select
-	if (gamepad_manager_->is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_BACK)) {
-		state |= (1 << static_cast<uint8_t>(NESButton::SELECT));
-	}
+Byte Controller::read_device(int port) const noexcept {
+	const PortDevice device = port == 0 ? setup_.port1 : setup_.port2;
+	const PointerState pointer = input_source_ ? input_source_->read_pointer(port) : PointerState{};
 
-	// Start
-	if (gamepad_manager_->is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_START)) {
-		state |= (1 << static_cast<uint8_t>(NESButton::START));
+	switch (device) {
+	case PortDevice::Zapper: {
+		Byte value = 0x40;
+		if (pointer.fire) {
+			value |= 0x10; // Trigger pulled
+		}
+		if (!zapper_sees_light(pointer)) {
+			value |= 0x08;
+		}
+		return value;
 	}
-
-	// D-pad Up
-	if (gamepad_manager_->is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_DPAD_UP)) {
-		state |= (1 << static_cast<uint8_t>(NESButton::UP));
+	case PortDevice::ArkanoidPaddle: {
+		Byte value = pointer.fire ? 0x48 : 0x40;
+		std::uint32_t &shift = shift_registers_[static_cast<std::size_t>(port)];
+		Byte bit;
+		if (strobe_) {
+			// Strobe high keeps reloading: the current position's top bit
+			bit = static_cast<Byte>((~pointer.x >> 7) & 0x01);
+		} else {
+			bit = static_cast<Byte>((shift >> 7) & 0x01);
+			shift = (shift << 1) & 0xFF;
+		}
+		return static_cast<Byte>(value | (bit << 4));
 	}
-
-	// D-pad Down
-	if (gamepad_manager_->is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_DPAD_DOWN)) {
-		state |= (1 << static_cast<uint8_t>(NESButton::DOWN));
+	default:
+		return 0x40; // Nothing plugged in: open bus
 	}
+}
 
-	// D-pad Left
-	if (gamepad_manager_->is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_DPAD_LEFT)) {
-		state |= (1 << static_cast<uint8_t>(NESButton::LEFT));
+bool Controller::zapper_sees_light(const PointerState &aim) const noexcept {
+	constexpr int VISIBLE_LINES = 240;
+	if (!ppu_ || aim.x < 0 || aim.x > 255 || aim.y < 0 || aim.y >= VISIBLE_LINES) {
+		return false; // Pointed off screen
 	}
+	const int scanline = ppu_->get_current_scanline();
 
-	// D-pad Right
-	if (gamepad_manager_->is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_DPAD_RIGHT)) {
-		state |= (1 << static_cast<uint8_t>(NESButton::RIGHT));
+	// The sensor sees a small area, not one pixel
+	for (int y = aim.y - 1; y <= aim.y + 1; ++y) {
+		const int lines_since = scanline - y;
+		if (y < 0 || y >= VISIBLE_LINES || lines_since < 0 || lines_since >= ZAPPER_LIGHT_LINES) {
+			continue;
+		}
+		for (int x = aim.x - 1; x <= aim.x + 1; ++x) {
+			if (x < 0 || x > 255 || !ppu_->is_pixel_drawn(static_cast<uint8_t>(x), static_cast<uint8_t>(y))) {
+				continue;
+			}
+			// RGBA packs red in the low byte
+			const uint32_t rgba = ppu_->get_pixel_rgba(static_cast<uint8_t>(x), static_cast<uint8_t>(y));
+			const int luma = (77 * (rgba & 0xFF) + 150 * ((rgba >> 8) & 0xFF) + 29 * ((rgba >> 16) & 0xFF)) >> 8;
+			if (luma >= ZAPPER_LIGHT_LUMA) {
+				return true;
+			}
+		}
 	}
-
-	return state;
+	return false;
 }
 
 } // namespace nes
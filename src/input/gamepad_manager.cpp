@@ -97,6 +97,57 @@ bool GamepadManager::is_button_pressed(int player_index, SDL_GamepadButton butto
 	return SDL_GetGamepadButton(controllers_[player_index].gamepad, button);
 }
 
+Byte GamepadManager::read_buttons(int player_index) const {
+	if (!is_controller_connected(player_index)) {
+		return 0x00; // No buttons pressed if controller not connected
+	}
+
+	Byte state = 0x00;
+
+	// Button mapping: Modern controller -> NES controller
+	// NES A button = Xbox A (SOUTH)
+	if (is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_SOUTH)) {
+		state |= (1 << static_cast<uint8_t>(NESButton::A));
+	}
+
+	// NES B button = Xbox X (WEST)
+	if (is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_WEST)) {
+		state |= (1 << static_cast<uint8_t>(NESButton::B));
+	}
+
+	// Select
+	if (is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_BACK)) {
+		state |= (1 << static_cast<uint8_t>(NESButton::SELECT));
+	}
+
+	// Start
+	if (is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_START)) {
+		state |= (1 << static_cast<uint8_t>(NESButton::START));
+	}
+
+	// D-pad Up
+	if (is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_DPAD_UP)) {
+		state |= (1 << static_cast<uint8_t>(NESButton::UP));
+	}
+
+	// D-pad Down
+	if (is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_DPAD_DOWN)) {
+		state |= (1 << static_cast<uint8_t>(NESButton::DOWN));
+	}
+
+	// D-pad Left
+	if (is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_DPAD_LEFT)) {
+		state |= (1 << static_cast<uint8_t>(NESButton::LEFT));
+	}
+
+	// D-pad Right
+	if (is_button_pressed(player_index, SDL_GAMEPAD_BUTTON_DPAD_RIGHT)) {
+		state |= (1 << static_cast<uint8_t>(NESButton::RIGHT));
+	}
+
+	return state;
+}
+
 int GamepadManager::get_connected_count() const {
 	int count = 0;
 	for (const auto &info : controllers_) {
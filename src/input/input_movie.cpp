@@ -0,0 +1,171 @@
+#include "input/input_movie.hpp"
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+namespace nes {
+
+MovieRecorder::MovieRecorder(std::shared_ptr<InputSource> source) : source_(std::move(source)) {
+}
+
+MovieRecorder::~MovieRecorder() {
+	close();
+}
+
+bool MovieRecorder::open(const std::filesystem::path &path, std::uint32_t rom_crc32,
+						 const std::vector<std::uint8_t> &start_state) {
+	close();
+	file_.open(path, std::ios::binary | std::ios::trunc);
+	if (!file_) {
+		std::cerr << "Movie: cannot create " << path.string() << std::endl;
+		return false;
+	}
+	MovieHeader header;
+	header.rom_crc32 = rom_crc32;
+	header.start_state_size = static_cast<std::uint32_t>(start_state.size());
+	file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file_.write(reinterpret_cast<const char *>(start_state.data()), static_cast<std::streamsize>(start_state.size()));
+
+	current_ = {};
+	run_length_ = 0;
+	frames_ = 0;
+	return static_cast<bool>(file_);
+}
+
+bool MovieRecorder::close() {
+	if (!file_.is_open()) {
+		return true;
+	}
+	write_run();
+	// Go back for the frame count now that it is known
+	file_.seekp(offsetof(MovieHeader, frame_count));
+	file_.write(reinterpret_cast<const char *>(&frames_), sizeof(frames_));
+	const bool written = static_cast<bool>(file_);
+	file_.close();
+	return written && !file_.fail();
+}
+
+void MovieRecorder::next_frame() {
+	std::array<Byte, 2> buttons{};
+	if (source_) {
+		for (std::size_t player = 0; player < buttons.size(); ++player) {
+			buttons[player] = source_->read_buttons(static_cast<int>(player));
+		}
+	}
+	if (buttons != current_) {
+		write_run();
+		current_ = buttons;
+	}
+	++run_length_;
+	++frames_;
+}
+
+void MovieRecorder::write_run() {
+	if (run_length_ == 0 || !file_.is_open()) {
+		return;
+	}
+	char run[2 + 10] = {static_cast<char>(current_[0]), static_cast<char>(current_[1])};
+	std::size_t size = 2;
+	std::uint64_t length = run_length_;
+	while (length >= 0x80) {
+		run[size++] = static_cast<char>((length & 0x7F) | 0x80);
+		length >>= 7;
+	}
+	run[size++] = static_cast<char>(length);
+	file_.write(run, static_cast<std::streamsize>(size));
+	run_length_ = 0;
+}
+
+Byte MovieRecorder::read_buttons(int player_index) const {
+	if (player_index < 0 || player_index >= static_cast<int>(current_.size())) {
+		return 0x00;
+	}
+	return current_[static_cast<std::size_t>(player_index)];
+}
+
+bool MoviePlayer::open(const std::filesystem::path &path) {
+	file_.close();
+	file_.clear();
+	current_ = {};
+	run_remaining_ = 0;
+	frames_ = 0;
+	start_state_.clear();
+
+	file_.open(path, std::ios::binary);
+	if (!file_) {
+		std::cerr << "Movie: cannot open " << path.string() << std::endl;
+		return false;
+	}
+	MovieHeader header;
+	const MovieHeader expected;
+	file_.read(reinterpret_cast<char *>(&header), sizeof(header));
+	if (file_.gcount() != sizeof(header) || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+		header.version != expected.version) {
+		std::cerr << "Movie: " << path.string() << " is not a VibeNES movie" << std::endl;
+		file_.close();
+		return false;
+	}
+	// Checked against the file before anything is sized from it
+	std::error_code error;
+	const std::uintmax_t file_size = std::filesystem::file_size(path, error);
+	if (error || header.start_state_size > file_size - sizeof(header)) {
+		std::cerr << "Movie: " << path.string() << " is truncated" << std::endl;
+		file_.close();
+		return false;
+	}
+	start_state_.resize(header.start_state_size);
+	file_.read(reinterpret_cast<char *>(start_state_.data()), static_cast<std::streamsize>(start_state_.size()));
+	if (file_.gcount() != static_cast<std::streamsize>(start_state_.size())) {
+		std::cerr << "Movie: " << path.string() << " is truncated" << std::endl;
+		file_.close();
+		return false;
+	}
+	header_ = header;
+	return true;
+}
+
+bool MoviePlayer::next_frame() {
+	if (run_remaining_ == 0 && !read_run()) {
+		current_ = {};
+		return false;
+	}
+	--run_remaining_;
+	++frames_;
+	return true;
+}
+
+bool MoviePlayer::read_run() {
+	// Zero-length runs are never written, but would only be skipped
+	while (file_.is_open()) {
+		char masks[2];
+		if (!file_.read(masks, sizeof(masks))) {
+			return false;
+		}
+		std::uint64_t length = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			const int byte = file_.get();
+			if (byte == std::char_traits<char>::eof()) {
+				return false;
+			}
+			length |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				break;
+			}
+		}
+		if (length != 0) {
+			current_ = {static_cast<Byte>(masks[0]), static_cast<Byte>(masks[1])};
+			run_remaining_ = length;
+			return true;
+		}
+	}
+	return false;
+}
+
+Byte MoviePlayer::read_buttons(int player_index) const {
+	if (player_index < 0 || player_index >= static_cast<int>(current_.size())) {
+		return 0x00;
+	}
+	return current_[static_cast<std::size_t>(player_index)];
+}
+
+} // namespace nes
@@ -0,0 +1,74 @@
+#include "input/replay_input.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace nes {
+
+bool ReplayInputSource::load_from_file(const std::filesystem::path &path) {
+	std::ifstream file(path);
+	if (!file) {
+		std::cerr << "Replay: cannot open " << path.string() << std::endl;
+		return false;
+	}
+
+	std::vector<Event> events;
+	std::string line;
+	int line_number = 0;
+	while (std::getline(file, line)) {
+		line_number++;
+		if (auto comment = line.find('#'); comment != std::string::npos) {
+			line.erase(comment);
+		}
+
+		std::istringstream fields(line);
+		uint64_t frame = 0;
+		if (!(fields >> frame)) {
+			// Blank or comment-only line
+			if (line.find_first_not_of(" \t\r") == std::string::npos) {
+				continue;
+			}
+			std::cerr << "Replay: bad frame number on line " << line_number << std::endl;
+			return false;
+		}
+
+		Event event;
+		event.frame = frame;
+		unsigned int mask = 0;
+		for (std::size_t player = 0; player < event.buttons.size(); ++player) {
+			if (!(fields >> std::hex >> mask)) {
+				if (player == 0) {
+					std::cerr << "Replay: missing button mask on line " << line_number << std::endl;
+					return false;
+				}
+				break; // Player 2 mask is optional
+			}
+			event.buttons[player] = static_cast<Byte>(mask & 0xFF);
+		}
+		events.push_back(event);
+	}
+
+	std::stable_sort(events.begin(), events.end(),
+					 [](const Event &a, const Event &b) { return a.frame < b.frame; });
+	events_ = std::move(events);
+	set_frame(0);
+	return true;
+}
+
+void ReplayInputSource::set_frame(uint64_t frame) noexcept {
+	// Last event at or before this frame wins
+	auto it = std::upper_bound(events_.begin(), events_.end(), frame,
+							   [](uint64_t value, const Event &event) { return value < event.frame; });
+	current_ = (it == events_.begin()) ? std::array<Byte, 2>{} : std::prev(it)->buttons;
+}
+
+Byte ReplayInputSource::read_buttons(int player_index) const {
+	if (player_index < 0 || player_index >= static_cast<int>(current_.size())) {
+		return 0x00;
+	}
+	return current_[static_cast<std::size_t>(player_index)];
+}
+
+} // namespace nes
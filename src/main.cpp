@@ -7,8 +7,12 @@
 #include "memory/ram.hpp"
 #include "ppu/ppu.hpp"
 #include <SDL3/SDL_main.h>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <utility>
 
 #ifdef NES_GUI_ENABLED
 #include "cpu/cpu_6502.hpp"
@@ -17,15 +21,65 @@
 
 using namespace nes;
 
+#ifdef NES_GUI_ENABLED
+namespace {
+
+void print_usage(const char *program) {
+	std::cerr << "Usage: " << program << " [rom.nes] [--fullscreen] [--no-debug] [--latency-report out.csv]"
+			  << " [--late-input off|fixed|adaptive] [--late-input-lead MS] [--mapped-saves]\n";
+}
+
+} // namespace
+#endif
+
 int main(int argc, char *argv[]) {
-	// Suppress unused parameter warnings
-	(void)argc;
-	(void)argv;
 #ifdef NES_GUI_ENABLED
-	std::cout << "VibeNES GUI - Starting debugger interface...\n";
+	// VibeNES_GUI [rom.nes] [--fullscreen] [--no-debug] [--latency-report out.csv]
+	//             [--late-input off|fixed|adaptive] [--late-input-lead MS] [--mapped-saves]:
+	// a ROM given here is loaded and started at once; --no-debug shows only
+	// the game picture; the latency report is written on exit; --late-input
+	// starts with Emulation > Late Input Polling set; --mapped-saves makes
+	// battery RAM the memory-mapped .sav file rather than flushing it
+	nes::gui::LaunchOptions options;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--fullscreen") {
+			options.fullscreen = true;
+		} else if (arg == "--no-debug") {
+			options.debug_ui = false;
+		} else if (arg == "--latency-report" && i + 1 < argc) {
+			options.latency_report_path = argv[++i];
+		} else if (arg == "--late-input" && i + 1 < argc) {
+			const std::string mode = argv[++i];
+			if (mode == "off") {
+				options.late_input = nes::LateInputScheduler::Mode::Off;
+			} else if (mode == "fixed") {
+				options.late_input = nes::LateInputScheduler::Mode::Fixed;
+			} else if (mode == "adaptive") {
+				options.late_input = nes::LateInputScheduler::Mode::Adaptive;
+			} else {
+				print_usage(argv[0]);
+				return 1;
+			}
+		} else if (arg == "--late-input-lead" && i + 1 < argc) {
+			options.late_input_lead_ms = std::clamp(std::atoi(argv[++i]), 0, 12);
+		} else if (arg == "--mapped-saves") {
+			options.mapped_saves = true;
+		} else if (arg == "--help" || arg == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else if (options.rom_path.empty() && !arg.starts_with("--")) {
+			options.rom_path = arg;
+		} else {
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	std::cout << (options.debug_ui ? "VibeNES GUI - Starting debugger interface...\n" : "VibeNES GUI - Starting...\n");
 
 	// Create and run GUI - components are internally managed
-	nes::gui::GuiApplication gui_app;
+	nes::gui::GuiApplication gui_app(std::move(options));
 
 	if (!gui_app.initialize()) {
 		std::cerr << "Failed to initialize GUI application" << std::endl;
@@ -41,6 +95,9 @@ int main(int argc, char *argv[]) {
 
 	return 0;
 #else
+	// Suppress unused parameter warnings
+	(void)argc;
+	(void)argv;
 	std::cout << "VibeNES - Starting emulator...\n";
 	std::cout << "Testing core components:\n\n";
 
@@ -0,0 +1,528 @@
+// VibeNES_MicroBench - per-kernel timings for the emulator's hot paths.
+//
+// Usage: VibeNES_MicroBench [--filter TEXT] [--min-ms MS] [--runs R]
+//                           [--list] [--output result.json] [--simd LEVEL]
+//
+// Every kernel runs on synthetic data built here (no ROM file needed), so
+// the numbers are comparable between builds and machines. A kernel first
+// doubles its iteration count until one batch takes --min-ms (default 50),
+// then times R batches (default 5) of that size and reports the fastest as
+// ns per operation. Results are written as JSON, one entry per kernel, so an
+// optimization can be judged by the kernels it touches:
+//
+//   cpu_instructions_*       CPU6502::execute_instruction() over an opcode
+//                            mix (each instruction also ticks the bus, with
+//                            rendering off), interpreted
+//   cpu_cycles_zero_page_loop
+//                            A counter loop on zero page, run for CPU cycles
+//                            as HeadlessSystem runs it (block execution on);
+//                            _interpreted: the same with it off
+//   ppu_frame_*              PPU::tick_dots() for one whole frame
+//   ppu_frame_sprites_8_per_line
+//                            Same, with eight 8x16 sprites on each of lines
+//                            0-127; minus ppu_frame_rendering_on it is the
+//                            sprite evaluation and line rasterization cost
+//   apu_step_cpu_cycles      APU::step_cpu_cycles() with all five channels on
+//   src_input_sample         SampleRateConverter::input_sample()
+//   mapper004_cpu_read       Mapper004::cpu_read() across $6000-$FFFF
+//   controller_strobe_read   Controller strobe of $4016 and 8 reads of each
+//                            port, fed by a LatchedInputSource
+//   oam_dma_transfer         One $4014 OAM DMA from work RAM, run by
+//                            CPU6502::execute_instruction() (rendering off)
+//   save_state_serialize     SaveStateManager::serialize_state() into a
+//                            reused buffer
+//   snapshot_capture_ram     SaveStateManager::capture() into a reused
+//                            snapshot on MMC1 with 8KB PRG-RAM and CHR-RAM,
+//                            one PRG-RAM byte written between captures
+//   system_clone_into        NesSystem::clone_into() onto a reused target
+
+#include "apu/apu.hpp"
+#include "audio/sample_rate_converter.hpp"
+#include "cartridge/mappers/mapper_004.hpp"
+#include "cartridge/rom_loader.hpp"
+#include "core/bus.hpp"
+#include "core/simd.hpp"
+#include "cpu/cpu_6502.hpp"
+#include "input/controller.hpp"
+#include "input/latched_input.hpp"
+#include "ppu/ppu.hpp"
+#include "system/headless_system.hpp"
+#include "system/save_state.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps results alive so the optimizer cannot drop a kernel's work
+volatile std::uint64_t sink = 0;
+
+constexpr int DOTS_PER_FRAME = 341 * 262;
+
+struct Kernel {
+	std::string name;
+	std::string unit; // What one operation is
+	// Prepares state; returns the body, which runs `iterations` operations
+	std::function<std::function<void(std::uint64_t)>()> setup;
+};
+
+struct KernelResult {
+	std::string name;
+	std::string unit;
+	std::uint64_t iterations = 0;
+	double ns_per_op = 0.0;
+};
+
+void print_usage(const char *program) {
+	std::cerr << "Usage: " << program << " [--filter TEXT] [--min-ms MS] [--runs R] [--list] [--output result.json]"
+			  << " [--simd LEVEL]\n";
+}
+
+// NROM cart: code at $8000, every vector pointing at it, an RTS at $FFF0 to
+// call, and CHR with some non-zero patterns so rendering has pixels to mux
+nes::RomData build_rom(const std::vector<nes::Byte> &code) {
+	nes::RomData rom{};
+	rom.mapper_id = 0;
+	rom.prg_rom_pages = 2;
+	rom.chr_rom_pages = 1;
+	rom.valid = true;
+	rom.prg_rom.assign(32768, 0xEA);
+	rom.chr_rom.resize(8192);
+	for (std::size_t i = 0; i < rom.chr_rom.size(); ++i) {
+		rom.chr_rom[i] = static_cast<nes::Byte>((i * 53) & 0xFF);
+	}
+	std::memcpy(rom.prg_rom.data(), code.data(), std::min(code.size(), rom.prg_rom.size() - 6));
+	rom.prg_rom[0x7FF0] = 0x60;
+	for (std::size_t vector = 0x7FFA; vector < 0x8000; vector += 2) {
+		rom.prg_rom[vector] = 0x00;
+		rom.prg_rom[vector + 1] = 0x80;
+	}
+	return rom;
+}
+
+std::unique_ptr<nes::HeadlessSystem> make_system(const std::vector<nes::Byte> &code) {
+	auto system = std::make_unique<nes::HeadlessSystem>();
+	if (!system->load_rom_data(build_rom(code))) {
+		std::cerr << "Failed to load the synthetic ROM\n";
+		std::exit(1);
+	}
+	return system;
+}
+
+// A short setup, then `block` repeated to fill the bank and a JMP back to it
+std::vector<nes::Byte> opcode_mix(const std::vector<nes::Byte> &setup, const std::vector<nes::Byte> &block) {
+	std::vector<nes::Byte> code = setup;
+	const std::size_t loop = 0x8000 + code.size();
+	while (code.size() + block.size() + 3 < 0x7000) {
+		code.insert(code.end(), block.begin(), block.end());
+	}
+	code.push_back(0x4C); // JMP loop
+	code.push_back(static_cast<nes::Byte>(loop & 0xFF));
+	code.push_back(static_cast<nes::Byte>(loop >> 8));
+	return code;
+}
+
+std::function<void(std::uint64_t)> cpu_kernel(const std::vector<nes::Byte> &code) {
+	std::shared_ptr<nes::HeadlessSystem> system = make_system(code);
+	// One execute_instruction() per instruction
+	system->cpu().set_block_execution(false);
+	return [system](std::uint64_t iterations) {
+		nes::CPU6502 &cpu = system->cpu();
+		std::uint64_t cycles = 0;
+		for (std::uint64_t i = 0; i < iterations; ++i) {
+			cycles += static_cast<std::uint64_t>(cpu.execute_instruction());
+		}
+		sink = sink + cycles;
+	};
+}
+
+// Iterations are CPU cycles, however many instructions each call runs
+std::function<void(std::uint64_t)> cpu_cycle_kernel(const std::vector<nes::Byte> &code, bool blocks) {
+	std::shared_ptr<nes::HeadlessSystem> system = make_system(code);
+	system->cpu().set_block_execution(blocks);
+	return [system](std::uint64_t iterations) {
+		nes::CPU6502 &cpu = system->cpu();
+		std::uint64_t cycles = 0;
+		while (cycles < iterations) {
+			cycles += static_cast<std::uint64_t>(cpu.execute_instruction());
+		}
+		sink = sink + cycles;
+	};
+}
+
+// The CPU parks in JMP $8000; the PPU is driven directly
+std::function<void(std::uint64_t)> ppu_kernel(std::uint8_t mask, bool sprites) {
+	std::shared_ptr<nes::HeadlessSystem> system = make_system({0x4C, 0x00, 0x80});
+	nes::PPU &ppu = system->ppu();
+	ppu.write_register(0x2000, sprites ? 0x20 : 0x00); // 8x16 sprites
+	ppu.write_register(0x2001, mask);
+	for (int i = 0; i < 64; ++i) {
+		// Eight to a 16-line band: lines 0-127 each have eight in range
+		const std::uint8_t y = sprites ? static_cast<std::uint8_t>((i / 8) * 16) : 0xEF;
+		ppu.write_oam_direct(static_cast<std::uint8_t>(i * 4 + 0), y);
+		ppu.write_oam_direct(static_cast<std::uint8_t>(i * 4 + 1), static_cast<std::uint8_t>(i * 2));
+		ppu.write_oam_direct(static_cast<std::uint8_t>(i * 4 + 2), static_cast<std::uint8_t>(i & 3));
+		ppu.write_oam_direct(static_cast<std::uint8_t>(i * 4 + 3), static_cast<std::uint8_t>((i % 8) * 30));
+	}
+	return [system](std::uint64_t iterations) {
+		nes::PPU &ppu = system->ppu();
+		for (std::uint64_t i = 0; i < iterations; ++i) {
+			ppu.tick_dots(DOTS_PER_FRAME);
+		}
+		sink = sink + ppu.get_frame_buffer()[128 * 256 + 128];
+	};
+}
+
+std::vector<Kernel> kernels() {
+	std::vector<Kernel> list;
+
+	// Zero page pointer $00 -> $0300 for the (zp),Y loads
+	const std::vector<nes::Byte> pointer_setup = {0xA9, 0x00, 0x85, 0x00, 0xA9, 0x03, 0x85, 0x01, 0xA0, 0x00};
+	list.push_back({"cpu_instructions_alu", "instruction", [] {
+						return cpu_kernel(opcode_mix({}, {
+															 0xA9, 0x35, // LDA #$35
+															 0x69, 0x17, // ADC #$17
+															 0xAA,		 // TAX
+															 0xE8,		 // INX
+															 0x49, 0xFF, // EOR #$FF
+															 0x0A,		 // ASL A
+															 0x29, 0x7F, // AND #$7F
+															 0x18,		 // CLC
+															 0xC9, 0x40, // CMP #$40
+															 0xA8,		 // TAY
+														 }));
+					}});
+	list.push_back({"cpu_instructions_memory", "instruction", [pointer_setup] {
+						return cpu_kernel(opcode_mix(pointer_setup, {
+																		0xA5, 0x10,		  // LDA $10
+																		0x8D, 0x00, 0x02, // STA $0200
+																		0xB1, 0x00,		  // LDA ($00),Y
+																		0x9D, 0x00, 0x04, // STA $0400,X
+																		0xE6, 0x11,		  // INC $11
+																		0xBD, 0x80, 0x02, // LDA $0280,X
+																		0xC8,			  // INY
+																		0x91, 0x00,		  // STA ($00),Y
+																	}));
+					}});
+	list.push_back({"cpu_instructions_branch", "instruction", [] {
+						return cpu_kernel(opcode_mix({}, {
+															 0xA2, 0x04,		 // LDX #4
+															 0xCA,				 // DEX
+															 0xD0, 0xFD,		 // BNE -3
+															 0x20, 0xF0, 0xFF,	 // JSR $FFF0 (RTS)
+															 0xF0, 0x00,		 // BEQ +0
+														 }));
+					}});
+	const std::vector<nes::Byte> zero_page_loop = {
+		0xA2, 0x10,		  // $8000 LDX #$10
+		0xA5, 0x10,		  // $8002 LDA $10
+		0x18,			  // CLC
+		0x69, 0x03,		  // ADC #$03
+		0x85, 0x10,		  // STA $10
+		0xA5, 0x11,		  // LDA $11
+		0x69, 0x00,		  // ADC #$00
+		0x85, 0x11,		  // STA $11
+		0xE6, 0x12,		  // INC $12
+		0xA5, 0x12,		  // LDA $12
+		0x29, 0x0F,		  // AND #$0F
+		0xA8,			  // TAY
+		0xCA,			  // DEX
+		0xD0, 0xE9,		  // BNE $8002
+		0x4C, 0x00, 0x80, // JMP $8000
+	};
+	list.push_back({"cpu_cycles_zero_page_loop", "cpu_cycle",
+					[zero_page_loop] { return cpu_cycle_kernel(zero_page_loop, true); }});
+	list.push_back({"cpu_cycles_zero_page_loop_interpreted", "cpu_cycle",
+					[zero_page_loop] { return cpu_cycle_kernel(zero_page_loop, false); }});
+	list.push_back({"ppu_frame_rendering_off", "frame", [] { return ppu_kernel(0x00, false); }});
+	list.push_back({"ppu_frame_rendering_on", "frame", [] { return ppu_kernel(0x1E, false); }});
+	list.push_back({"ppu_frame_sprites_8_per_line", "frame", [] { return ppu_kernel(0x1E, true); }});
+
+	list.push_back({"apu_step_cpu_cycles", "cpu_cycle", [] {
+						std::shared_ptr<nes::HeadlessSystem> system = make_system({0x4C, 0x00, 0x80});
+						nes::APU &apu = system->apu();
+						static constexpr std::uint8_t WRITES[][2] = {
+							{0x15, 0x1F},										   // All channels on
+							{0x00, 0xBF}, {0x02, 0xFD}, {0x03, 0x00},			   // Pulse 1
+							{0x04, 0x7F}, {0x05, 0x8A}, {0x06, 0x80}, {0x07, 0x01}, // Pulse 2, sweeping
+							{0x08, 0xFF}, {0x0A, 0x40}, {0x0B, 0x00},			   // Triangle
+							{0x0C, 0x3F}, {0x0E, 0x04}, {0x0F, 0x00},			   // Noise
+							{0x10, 0x4F}, {0x12, 0x00}, {0x13, 0xFF},			   // DMC, looping
+							{0x15, 0x1F},
+						};
+						for (const auto &write : WRITES) {
+							apu.write(static_cast<std::uint16_t>(0x4000 | write[0]), write[1]);
+						}
+						return std::function<void(std::uint64_t)>([system](std::uint64_t iterations) {
+							nes::APU &apu = system->apu();
+							for (std::uint64_t done = 0; done < iterations;) {
+								const int step = static_cast<int>(std::min<std::uint64_t>(iterations - done, 29781));
+								apu.step_cpu_cycles(step);
+								done += static_cast<std::uint64_t>(step);
+							}
+							sink = sink + apu.read(0x4015);
+						});
+					}});
+
+	list.push_back({"src_input_sample", "sample", [] {
+						auto converter = std::make_shared<nes::SampleRateConverter>();
+						return std::function<void(std::uint64_t)>([converter](std::uint64_t iterations) {
+							float phase = 0.0f;
+							float total = 0.0f;
+							for (std::uint64_t i = 0; i < iterations; ++i) {
+								phase = phase < 1.0f ? phase + 0.0025f : -1.0f;
+								converter->input_sample(phase);
+								if (converter->has_output()) {
+									total += converter->get_output();
+								}
+							}
+							sink = sink + static_cast<std::uint64_t>(total != 0.0f);
+						});
+					}});
+
+	list.push_back({"mapper004_cpu_read", "read", [] {
+						struct Banks {
+							std::vector<nes::Byte> prg = std::vector<nes::Byte>(128 * 1024);
+							std::vector<nes::Byte> chr = std::vector<nes::Byte>(128 * 1024);
+							std::unique_ptr<nes::Mapper004> mapper;
+						};
+						auto banks = std::make_shared<Banks>();
+						for (std::size_t i = 0; i < banks->prg.size(); ++i) {
+							banks->prg[i] = static_cast<nes::Byte>(i * 7);
+						}
+						banks->mapper = std::make_unique<nes::Mapper004>(banks->prg, banks->chr,
+																		 nes::Mapper::Mirroring::Vertical);
+						banks->mapper->cpu_write(0xA001, 0x80); // PRG RAM on
+						for (std::uint8_t reg = 0; reg < 8; ++reg) {
+							banks->mapper->cpu_write(0x8000, reg);
+							banks->mapper->cpu_write(0x8001, static_cast<nes::Byte>(reg * 3 + 1));
+						}
+						return std::function<void(std::uint64_t)>([banks](std::uint64_t iterations) {
+							const nes::Mapper004 &mapper = *banks->mapper;
+							std::uint64_t total = 0;
+							std::uint16_t address = 0x6000;
+							for (std::uint64_t i = 0; i < iterations; ++i) {
+								total += mapper.cpu_read(address);
+								address = static_cast<std::uint16_t>(address + 0x0101);
+								address = static_cast<std::uint16_t>(address < 0x6000 ? address + 0x6000 : address);
+							}
+							sink = sink + total;
+						});
+					}});
+
+	list.push_back({"controller_strobe_read", "strobe", [] {
+						auto input = std::make_shared<nes::LatchedInputSource>();
+						auto controller = std::make_shared<nes::Controller>(input);
+						return std::function<void(std::uint64_t)>([input, controller](std::uint64_t iterations) {
+							std::uint64_t total = 0;
+							for (std::uint64_t i = 0; i < iterations; ++i) {
+								input->set_all(static_cast<nes::Byte>(i), static_cast<nes::Byte>(i >> 8));
+								controller->write(0x01);
+								controller->write(0x00);
+								for (int bit = 0; bit < 8; ++bit) {
+									total += controller->read(0x4016) + controller->read(0x4017);
+								}
+							}
+							sink = sink + total;
+						});
+					}});
+
+	list.push_back({"oam_dma_transfer", "transfer", [] {
+						std::shared_ptr<nes::HeadlessSystem> system = make_system({0x4C, 0x00, 0x80});
+						return std::function<void(std::uint64_t)>([system](std::uint64_t iterations) {
+							std::uint64_t cycles = 0;
+							for (std::uint64_t i = 0; i < iterations; ++i) {
+								system->bus().write(0x4014, 0x02);
+								cycles += static_cast<std::uint64_t>(system->cpu().execute_instruction());
+							}
+							sink = sink + cycles;
+						});
+					}});
+
+	list.push_back({"save_state_serialize", "state", [] {
+						std::shared_ptr<nes::HeadlessSystem> system = make_system({0x4C, 0x00, 0x80});
+						system->run_frame();
+						auto manager = std::make_shared<nes::SaveStateManager>(&system->cpu(), &system->ppu(),
+																			   &system->apu(), &system->bus(),
+																			   &system->cartridge());
+						auto buffer = std::make_shared<std::vector<std::uint8_t>>();
+						return std::function<void(std::uint64_t)>([system, manager, buffer](std::uint64_t iterations) {
+							for (std::uint64_t i = 0; i < iterations; ++i) {
+								manager->serialize_state(*buffer);
+							}
+							sink = sink + buffer->size();
+						});
+					}});
+
+	list.push_back({"snapshot_capture_ram", "capture", [] {
+						nes::RomData rom = build_rom({0x4C, 0x00, 0x80});
+						rom.mapper_id = 1;
+						rom.chr_rom_pages = 0;
+						rom.chr_rom.clear();
+						auto system = std::make_shared<nes::HeadlessSystem>();
+						if (!system->load_rom_data(rom)) {
+							std::cerr << "Failed to load the synthetic ROM\n";
+							std::exit(1);
+						}
+						system->run_frame();
+						auto manager = std::make_shared<nes::SaveStateManager>(&system->cpu(), &system->ppu(),
+																			   &system->apu(), &system->bus(),
+																			   &system->cartridge());
+						auto snapshot = std::make_shared<nes::StateSnapshot>();
+						manager->capture(*snapshot);
+						return std::function<void(std::uint64_t)>([system, manager, snapshot](std::uint64_t iterations) {
+							for (std::uint64_t i = 0; i < iterations; ++i) {
+								system->bus().write(static_cast<nes::Address>(0x6000 + (i & 0x1FFF)),
+													static_cast<nes::Byte>(i));
+								manager->capture(*snapshot);
+							}
+							sink = sink + snapshot->size();
+						});
+					}});
+
+	list.push_back({"system_clone_into", "clone", [] {
+						std::shared_ptr<nes::HeadlessSystem> system = make_system({0x4C, 0x00, 0x80});
+						std::shared_ptr<nes::HeadlessSystem> target = make_system({0x4C, 0x00, 0x80});
+						system->run_frame();
+						system->clone_into(*target); // Loads the shared ROM image once
+						return std::function<void(std::uint64_t)>([system, target](std::uint64_t iterations) {
+							for (std::uint64_t i = 0; i < iterations; ++i) {
+								system->clone_into(*target);
+							}
+							sink = sink + target->get_frame_count();
+						});
+					}});
+	return list;
+}
+
+double time_batch(const std::function<void(std::uint64_t)> &body, std::uint64_t iterations) {
+	const auto start = Clock::now();
+	body(iterations);
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+KernelResult run_kernel(const Kernel &kernel, double min_seconds, long runs) {
+	const std::function<void(std::uint64_t)> body = kernel.setup();
+	std::uint64_t iterations = 1;
+	while (time_batch(body, iterations) < min_seconds && iterations < (1ull << 40)) {
+		iterations *= 2;
+	}
+	double best = time_batch(body, iterations);
+	for (long run = 1; run < runs; ++run) {
+		best = std::min(best, time_batch(body, iterations));
+	}
+	return {kernel.name, kernel.unit, iterations, best * 1e9 / static_cast<double>(iterations)};
+}
+
+std::string to_json(const std::vector<KernelResult> &results, double min_ms, long runs) {
+	std::ostringstream json;
+	json << std::fixed << std::setprecision(3);
+	json << "{\n";
+	json << "  \"simd\": \"" << nes::simd_level_name(nes::simd_level()) << "\",\n";
+	json << "  \"min_ms\": " << min_ms << ",\n";
+	json << "  \"runs\": " << runs << ",\n";
+	json << "  \"kernels\": [";
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const KernelResult &r = results[i];
+		const double per_second = r.ns_per_op > 0.0 ? 1e9 / r.ns_per_op : 0.0;
+		json << (i ? "," : "") << "\n    {\"name\": \"" << r.name << "\", \"unit\": \"" << r.unit
+			 << "\", \"iterations\": " << r.iterations << ", \"ns_per_op\": " << r.ns_per_op
+			 << ", \"ops_per_second\": " << per_second << "}";
+	}
+	json << "\n  ]\n}\n";
+	return json.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	std::string filter;
+	std::string output_path;
+	double min_ms = 50.0;
+	long runs = 5;
+	std::string simd;
+	bool list_only = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--filter" && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (arg == "--min-ms" && i + 1 < argc) {
+			min_ms = std::strtod(argv[++i], nullptr);
+		} else if (arg == "--runs" && i + 1 < argc) {
+			runs = std::strtol(argv[++i], nullptr, 10);
+		} else if (arg == "--output" && i + 1 < argc) {
+			output_path = argv[++i];
+		} else if (arg == "--simd" && i + 1 < argc) {
+			simd = argv[++i];
+		} else if (arg.starts_with("--simd=")) {
+			simd = arg.substr(7);
+		} else if (arg == "--list") {
+			list_only = true;
+		} else if (arg == "--help" || arg == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else {
+			print_usage(argv[0]);
+			return 2;
+		}
+	}
+	if (min_ms <= 0.0 || runs <= 0) {
+		print_usage(argv[0]);
+		return 2;
+	}
+
+	if (!simd.empty()) {
+		const std::optional<nes::SimdLevel> level = nes::parse_simd_level(simd);
+		if (!level || !nes::set_simd_level(*level)) {
+			std::cerr << "SIMD level not available: " << simd << " (best: "
+					  << nes::simd_level_name(nes::best_simd_level()) << ")\n";
+			return 2;
+		}
+	}
+
+	std::vector<KernelResult> results;
+	for (const Kernel &kernel : kernels()) {
+		if (!filter.empty() && kernel.name.find(filter) == std::string::npos) {
+			continue;
+		}
+		if (list_only) {
+			std::cout << kernel.name << " (" << kernel.unit << ")\n";
+			continue;
+		}
+		results.push_back(run_kernel(kernel, min_ms / 1000.0, runs));
+		std::cerr << std::left << std::setw(32) << kernel.name << std::right << std::fixed << std::setprecision(2)
+				  << std::setw(14) << results.back().ns_per_op << " ns/" << kernel.unit << "\n";
+	}
+	if (list_only) {
+		return 0;
+	}
+	if (results.empty()) {
+		std::cerr << "No kernel matches " << filter << "\n";
+		return 2;
+	}
+
+	const std::string json = to_json(results, min_ms, runs);
+	std::cout << json;
+	if (!output_path.empty()) {
+		std::ofstream out(output_path);
+		if (!out || !(out << json)) {
+			std::cerr << "Failed to write " << output_path << "\n";
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -1,5 +1,4 @@
 #include "ppu/nes_palette.hpp"
-#include <imgui.h>
 
 namespace nes {
 
@@ -20,14 +19,4 @@ uint32_t NESPalette::get_rgba_color(uint8_t nes_color_index) {
 	return (a << 24) | (b << 16) | (g << 8) | r; // ABGR format for OpenGL
 }
 
-ImVec4 NESPalette::get_imgui_color(uint8_t nes_color_index) {
-	uint32_t rgb = get_rgb_color(nes_color_index);
-
-	float r = ((rgb >> 16) & 0xFF) / 255.0f;
-	float g = ((rgb >> 8) & 0xFF) / 255.0f;
-	float b = (rgb & 0xFF) / 255.0f;
-
-	return ImVec4(r, g, b, 1.0f);
-}
-
 } // namespace nes
@@ -0,0 +1,211 @@
+#include "ppu/ntsc_filter.hpp"
+#include "core/simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace nes {
+
+namespace {
+
+// 2C02 composite levels (volts) for luma 0-3: the low and high half of the
+// chroma square wave, and the black/white points they are normalized to
+constexpr float SIGNAL_LOW[4] = {0.350f, 0.518f, 0.962f, 1.550f};
+constexpr float SIGNAL_HIGH[4] = {1.094f, 1.506f, 1.962f, 1.962f};
+constexpr float SIGNAL_BLACK = 0.518f;
+constexpr float SIGNAL_WHITE = 1.962f;
+constexpr float EMPHASIS_ATTENUATION = 0.746f;
+// Decoder phase tweak (in samples) that lines hues up with the TV
+constexpr float HUE_OFFSET = 3.9f;
+constexpr float PI = 3.14159265358979f;
+
+} // namespace
+
+NtscFilter::NtscFilter(unsigned workers) : frames_(std::make_unique<TripleBuffer<OutputFrame>>()) {
+	build_kernels();
+
+	if (workers == 0) {
+		const unsigned cores = std::thread::hardware_concurrency();
+		workers = std::clamp(cores > 2 ? cores - 2 : 1u, 1u, 4u);
+	}
+	workers_.reserve(workers);
+	for (unsigned i = 0; i < workers; ++i) {
+		workers_.emplace_back([this, i, workers] { worker_main(i, workers); });
+	}
+}
+
+NtscFilter::~NtscFilter() {
+	stop_.store(true, std::memory_order_relaxed);
+	generation_.fetch_add(1, std::memory_order_release);
+	generation_.notify_all();
+	for (std::thread &worker : workers_) {
+		worker.join();
+	}
+}
+
+void NtscFilter::build_kernels() {
+	kernels_.assign(static_cast<size_t>(PHASES) * ENTRIES * TAPS, Tap{});
+	const float scale = static_cast<float>(255 << FRACTION_BITS);
+
+	for (int phase = 0; phase < PHASES; ++phase) {
+		for (int entry = 0; entry < ENTRIES; ++entry) {
+			const int color = entry & 0x0F;
+			const int emphasis = entry >> 6;
+			// $xE/$xF are black; $x0 has no chroma, $xD and up no high half
+			const int level = color > 13 ? 1 : (entry >> 4) & 0x03;
+			const float low = color == 0 ? SIGNAL_HIGH[level] : SIGNAL_LOW[level];
+			const float high = color > 12 ? low : SIGNAL_HIGH[level];
+
+			// The pixel's 8 samples, starting at subcarrier phase phase * 4
+			float signal[8];
+			for (int s = 0; s < 8; ++s) {
+				const int sample_phase = (phase * 4 + s) % 12;
+				const auto in_color_phase = [sample_phase](int hue) { return (hue + sample_phase) % 12 < 6; };
+				float volts = in_color_phase(color) ? high : low;
+				if (((emphasis & 1) && in_color_phase(0xC)) || ((emphasis & 2) && in_color_phase(0x4)) ||
+					((emphasis & 4) && in_color_phase(0x8))) {
+					volts *= EMPHASIS_ATTENUATION;
+				}
+				signal[s] = (volts - SIGNAL_BLACK) / (SIGNAL_WHITE - SIGNAL_BLACK);
+			}
+
+			// Output pixel j is centered on sample 4j + 2; luma averages the 12
+			// samples around it, I and Q the 24 around it
+			Tap *taps = &kernels_[(static_cast<size_t>(phase) * ENTRIES + entry) * TAPS];
+			for (int tap = 0; tap < TAPS; ++tap) {
+				const int center = 4 * (tap + TAP_OFFSET) + 2;
+				float y = 0.0f;
+				float i = 0.0f;
+				float q = 0.0f;
+				for (int s = 0; s < 8; ++s) {
+					const int distance = s - center;
+					if (distance >= -6 && distance < 6) {
+						y += signal[s] / 12.0f;
+					}
+					if (distance >= -12 && distance < 12) {
+						const float angle = PI * (static_cast<float>(phase * 4 + s) + HUE_OFFSET) / 6.0f;
+						i += signal[s] * std::cos(angle) / 24.0f;
+						q += signal[s] * std::sin(angle) / 24.0f;
+					}
+				}
+				taps[tap].r = static_cast<int32_t>(std::lround((y + 0.946882f * i + 0.623557f * q) * scale));
+				taps[tap].g = static_cast<int32_t>(std::lround((y - 0.274788f * i - 0.635691f * q) * scale));
+				taps[tap].b = static_cast<int32_t>(std::lround((y - 1.108545f * i + 1.709007f * q) * scale));
+				taps[tap].pad = 0;
+			}
+		}
+	}
+}
+
+void NtscFilter::filter_rows(const uint16_t *indices, unsigned burst_phase, int first_row, int row_count,
+							 uint32_t *output) const {
+	// Accumulator slot k holds output pixel k + TAP_OFFSET, so input pixel x
+	// adds its taps to slots 2x .. 2x + 7. The fourth lane starts at opaque
+	// alpha; the others at the rounding bias.
+	constexpr int SLOTS = OUTPUT_WIDTH + TAPS;
+	constexpr int32_t ROUND = 1 << (FRACTION_BITS - 1);
+	constexpr int32_t ALPHA = 255 << FRACTION_BITS;
+
+	for (int row = first_row; row < first_row + row_count; ++row) {
+		const uint16_t *in = indices + row * INPUT_WIDTH;
+		uint32_t *out = output + row * OUTPUT_WIDTH;
+		// The subcarrier advances 4 samples per line and 8 per pixel
+		int phase = static_cast<int>((burst_phase + static_cast<unsigned>(row)) % PHASES);
+
+#if defined(__SSE2__)
+		if (simd_level() != SimdLevel::Scalar) {
+			alignas(16) __m128i acc[SLOTS];
+			const __m128i bias = _mm_setr_epi32(ROUND, ROUND, ROUND, ALPHA);
+			for (__m128i &slot : acc) {
+				slot = bias;
+			}
+			for (int x = 0; x < INPUT_WIDTH; ++x) {
+				const auto *taps = reinterpret_cast<const __m128i *>(kernel(phase, in[x]));
+				__m128i *slots = &acc[2 * x];
+				for (int tap = 0; tap < TAPS; ++tap) {
+					slots[tap] = _mm_add_epi32(slots[tap], _mm_load_si128(taps + tap));
+				}
+				phase = phase + 2 >= PHASES ? phase + 2 - PHASES : phase + 2;
+			}
+			// Two pixels per store, saturated to 0-255 by the packs
+			for (int j = 0; j < OUTPUT_WIDTH; j += 2) {
+				const __m128i left = _mm_srai_epi32(acc[j - TAP_OFFSET], FRACTION_BITS);
+				const __m128i right = _mm_srai_epi32(acc[j + 1 - TAP_OFFSET], FRACTION_BITS);
+				const __m128i words = _mm_packs_epi32(left, right);
+				_mm_storel_epi64(reinterpret_cast<__m128i *>(out + j), _mm_packus_epi16(words, words));
+			}
+			continue;
+		}
+#endif
+		int32_t acc[SLOTS][4];
+		for (auto &slot : acc) {
+			slot[0] = slot[1] = slot[2] = ROUND;
+			slot[3] = ALPHA;
+		}
+		for (int x = 0; x < INPUT_WIDTH; ++x) {
+			const Tap *taps = kernel(phase, in[x]);
+			for (int tap = 0; tap < TAPS; ++tap) {
+				int32_t *slot = acc[2 * x + tap];
+				slot[0] += taps[tap].r;
+				slot[1] += taps[tap].g;
+				slot[2] += taps[tap].b;
+			}
+			phase = phase + 2 >= PHASES ? phase + 2 - PHASES : phase + 2;
+		}
+		for (int j = 0; j < OUTPUT_WIDTH; ++j) {
+			const int32_t *slot = acc[j - TAP_OFFSET];
+			uint32_t pixel = 0;
+			for (int lane = 0; lane < 4; ++lane) {
+				const int32_t value = std::clamp(slot[lane] >> FRACTION_BITS, 0, 255);
+				pixel |= static_cast<uint32_t>(value) << (lane * 8);
+			}
+			out[j] = pixel; // ABGR, R in the low byte
+		}
+	}
+}
+
+void NtscFilter::filter_frame(const uint16_t *indices, unsigned burst_phase, uint32_t *output) const {
+	filter_rows(indices, burst_phase, 0, HEIGHT, output);
+}
+
+bool NtscFilter::submit(const uint16_t *indices, unsigned burst_phase) {
+	if (busy_.load(std::memory_order_acquire)) {
+		return false;
+	}
+	std::memcpy(input_.data(), indices, sizeof(input_));
+	input_phase_ = burst_phase % PHASES;
+	strips_remaining_.store(static_cast<unsigned>(workers_.size()), std::memory_order_relaxed);
+	busy_.store(true, std::memory_order_relaxed);
+	generation_.fetch_add(1, std::memory_order_release);
+	generation_.notify_all();
+	return true;
+}
+
+const uint32_t *NtscFilter::take_finished_frame() {
+	return frames_->update() ? frames_->read_buffer().data() : nullptr;
+}
+
+void NtscFilter::worker_main(unsigned index, unsigned count) {
+	const int first_row = static_cast<int>(index * HEIGHT / count);
+	const int row_count = static_cast<int>((index + 1) * HEIGHT / count) - first_row;
+
+	uint32_t seen = 0;
+	while (true) {
+		generation_.wait(seen, std::memory_order_acquire);
+		seen = generation_.load(std::memory_order_acquire);
+		if (stop_.load(std::memory_order_relaxed)) {
+			return;
+		}
+		filter_rows(input_.data(), input_phase_, first_row, row_count, frames_->write_buffer().data());
+		// The last strip in hands the frame to the reader
+		if (strips_remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			frames_->publish();
+			busy_.store(false, std::memory_order_release);
+		}
+	}
+}
+
+} // namespace nes
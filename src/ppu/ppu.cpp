@@ -2,34 +2,39 @@
 #include "cartridge/cartridge.hpp"
 #include "cartridge/mappers/mapper.hpp"
 #include "core/bus.hpp"
+#include "core/simd.hpp"
+#include "core/trace_zones.hpp"
 #include "cpu/cpu_6502.hpp"
 #include "ppu/nes_palette.hpp"
 #include <algorithm>
 #include <bit>
+#include <cstdint>
 #include <cstring>
 #include <stdexcept>
+#include <tuple>
 
 namespace nes {
 
 PPU::PPU()
-	: current_cycle_(0), current_scanline_(0), frame_counter_(0), frame_ready_(false), control_register_(0),
-	  mask_register_(0), status_register_(0), oam_address_(0), vram_address_(0), temp_vram_address_(0),
-	  fine_x_scroll_(0), write_toggle_(false), read_buffer_(0), vram_wrap_read_pending_(false),
-	  vram_wrap_target_address_(0), vram_wrap_latched_value_(0),
-	  // Initialize OAM-related members
-	  oam_dma_active_(false), oam_dma_address_(0), oam_dma_cycle_(0), oam_dma_subcycle_(0), oam_dma_pending_(false),
-	  oam_dma_data_latch_(0),
-	  // Initialize hardware timing state
-	  odd_frame_(false), nmi_delay_(0), suppress_vbl_(false), rendering_disabled_mid_scanline_(false),
-	  // Initialize bus state
-	  ppu_data_bus_(0), io_db_(0), vram_address_corruption_pending_(false),
-	  // Initialize sprite state
-	  sprite_count_current_scanline_(0), sprite_count_next_scanline_(0), sprite_0_on_scanline_(false),
-	  sprite_0_on_next_scanline_(false), sprite_0_hit_detected_(false), sprite_0_hit_delay_(0),
+	: // Hot per-dot state
+	  current_cycle_(0), current_scanline_(0), vram_address_(0), temp_vram_address_(0), control_register_(0),
+	  mask_register_(0), status_register_(0), fine_x_scroll_(0), sprite_0_hit_delay_(0), nmi_delay_(0),
+	  odd_frame_(false), suppress_vbl_(false), vram_address_corruption_pending_(false),
 	  sprite_eval_state_(SpriteEvalState::ReadY), sprite_eval_n_(0), sprite_eval_m_(0), sprite_eval_buffer_(0),
-	  secondary_oam_index_(0), sprite_overflow_detected_(false),
-	  // Initialize connections
-	  bus_(nullptr), cpu_(nullptr), cartridge_(nullptr) { // Initialize background shift registers
+	  secondary_oam_index_(0), sprite_overflow_detected_(false), cartridge_(nullptr),
+	  // Sprite state
+	  sprite_count_current_scanline_(0), sprite_count_next_scanline_(0), sprite_0_on_scanline_(false),
+	  sprite_0_on_next_scanline_(false), sprite_0_hit_detected_(false), frame_ready_(false), frame_counter_(0),
+	  // Frame buffers, registers and OAM DMA
+	  frame_buffers_(std::make_unique<FrameBuffers>()), oam_address_(0), write_toggle_(false), read_buffer_(0),
+	  vram_wrap_read_pending_(false), vram_wrap_target_address_(0), vram_wrap_latched_value_(0),
+	  oam_dma_active_(false), oam_dma_address_(0), oam_dma_cycle_(0), oam_dma_subcycle_(0), oam_dma_pending_(false),
+	  oam_dma_data_latch_(0), rendering_disabled_mid_scanline_(false), ppu_data_bus_(0), io_db_(0),
+	  // Connections
+	  bus_(nullptr), cpu_(nullptr) {
+	index_buffer_ = frame_buffers_->indices.data();
+	frame_buffer_ = frame_buffers_->pixels.data();
+	// Initialize background shift registers
 	bg_shift_registers_ = {};
 	tile_fetch_state_ = {};
 
@@ -61,6 +66,9 @@ void PPU::power_on() {
 	current_scanline_ = 0;
 	frame_counter_ = 0;
 	frame_ready_ = false;
+	++frame_generation_;
+	update_compose_frame();
+	scanline_timeline_.clear();
 
 	// Registers power-on to 0
 	control_register_ = 0;
@@ -105,6 +113,8 @@ void PPU::power_on() {
 	last_a12_state_ = false; // Initialize A12 tracking for MMC3
 	ppu_dot_counter_ = 0;
 	a12_last_high_dot_ = 0;
+	a12_predicting_ = false;
+	update_a12_prediction();
 
 	// Initialize sprite evaluation state
 	sprite_eval_state_ = SpriteEvalState::ReadY;
@@ -155,6 +165,8 @@ void PPU::reset() {
 	last_a12_state_ = false; // Reset A12 tracking for MMC3
 	ppu_dot_counter_ = 0;
 	a12_last_high_dot_ = 0;
+	a12_predicting_ = false;
+	update_a12_prediction();
 
 	// Memory state is preserved
 	memory_.reset();
@@ -163,6 +175,8 @@ void PPU::reset() {
 	current_scanline_ = 0;
 	current_cycle_ = 0;
 	frame_ready_ = false;
+	++frame_generation_;
+	scanline_timeline_.clear();
 
 	// Derived caches
 	cached_phase_ = get_current_phase();
@@ -185,31 +199,137 @@ void PPU::tick(CpuCycle cycles) {
 	}
 
 	for (std::int64_t i = 0; i < ppu_dot_count; ++i) {
-		tick_internal();
+		tick_dot();
 	}
 }
 
 void PPU::tick_single_dot() {
 	// Advance PPU by exactly 1 dot - useful for precise testing
-	tick_internal();
+	tick_dot();
+}
+
+void PPU::tick_dot() {
+	if (accuracy_ == Accuracy::Fast) {
+		tick_internal<Accuracy::Fast>();
+	} else {
+		tick_internal<Accuracy::Strict>();
+	}
 }
 
 void PPU::tick_dots(int dots) {
-	// Non-virtual hot path used by the bus (3 dots per CPU cycle)
-	for (int i = 0; i < dots; ++i) {
-		tick_internal();
+	// Non-virtual hot path used by the bus (3 dots per CPU cycle, or a whole
+	// catch-up batch); the profile is picked here rather than per dot
+	if (accuracy_ == Accuracy::Fast) {
+		run_dots<Accuracy::Fast>(dots);
+	} else {
+		run_dots<Accuracy::Strict>(dots);
+	}
+}
+
+template <Accuracy Profile> void PPU::run_dots(int dots) {
+	// Nothing outside the PPU can run inside one call, so a call that spans
+	// dots 1-256 of a visible scanline may render it in one go
+	while (dots > 0) {
+		if constexpr (Profile == Accuracy::Fast) {
+			// With the quirks moved to the line end, nothing happens on the
+			// post-render and VBlank lines but the VBlank set at (241,1), so
+			// the rest of such a line up to its last dot is one step
+			if (cached_phase_ == ScanlinePhase::POST_RENDER ||
+				(cached_phase_ == ScanlinePhase::VBLANK &&
+				 (current_scanline_ != vblank_start_scanline_ || current_cycle_ > PPUTiming::VBLANK_SET_CYCLE))) {
+				const int idle = std::min(dots, PPUTiming::CYCLES_PER_SCANLINE - 1 - current_cycle_);
+				if (idle > 0) {
+					current_cycle_ = static_cast<uint16_t>(current_cycle_ + idle);
+					ppu_dot_counter_ += static_cast<uint32_t>(idle);
+					suppress_vbl_ = false; // What handle_vblank_timing() does past the set dot
+					dots -= idle;
+					continue;
+				}
+			}
+		}
+		if (dots >= PPUTiming::VISIBLE_PIXELS && current_cycle_ == 1 && can_batch_visible_scanline()) {
+			render_visible_scanline_batched();
+			dots -= PPUTiming::VISIBLE_PIXELS;
+		} else {
+			tick_internal<Profile>();
+			--dots;
+		}
+	}
+}
+
+void PPU::set_accuracy(Accuracy accuracy) noexcept {
+	if (accuracy == Accuracy::Fast && sprite_0_hit_delay_ > 0) {
+		sprite_0_hit_delay_ = 0;
+		status_register_ |= PPUConstants::PPUSTATUS_SPRITE0_MASK;
+	}
+	accuracy_ = accuracy;
+}
+
+uint32_t PPU::dots_until_sync_point() const noexcept {
+	const uint32_t DOTS_PER_FRAME = static_cast<uint32_t>(PPUTiming::CYCLES_PER_SCANLINE) * scanlines_per_frame_;
+	// Dot index of the tick that sets VBlank (runs at 241,0 and lands on 241,1)
+	const uint32_t VBLANK_TICK = static_cast<uint32_t>(vblank_start_scanline_) * PPUTiming::CYCLES_PER_SCANLINE;
+	// Dot index of the tick that wraps to the next frame (261,340)
+	const uint32_t FRAME_WRAP_TICK =
+		static_cast<uint32_t>(pre_render_scanline_) * PPUTiming::CYCLES_PER_SCANLINE + PPUTiming::HBLANK_END;
+
+	const uint32_t position = static_cast<uint32_t>(current_scanline_) * PPUTiming::CYCLES_PER_SCANLINE +
+							  current_cycle_;
+
+	// Ticks needed to execute the tick at `target`. Paths that cross the
+	// odd-frame skip at (261,339) may be one dot shorter, so they are counted
+	// one low — running early is harmless, running late is not.
+	auto ticks_to = [position, DOTS_PER_FRAME](uint32_t target) -> uint32_t {
+		if (position <= target) {
+			return target - position + 1;
+		}
+		return DOTS_PER_FRAME - position + target;
+	};
+
+	uint32_t dots = std::min(ticks_to(VBLANK_TICK), ticks_to(FRAME_WRAP_TICK) - 1);
+	if (position == FRAME_WRAP_TICK) {
+		dots = 1;
+	}
+
+	// MMC3-style IRQs: filtered A12 edges are at least A12_FILTER_THRESHOLD
+	// dots apart, and only rendering fetches produce them between CPU accesses.
+	// Predicted edges are known to the dot.
+	if (cartridge_ && is_rendering_enabled()) {
+		const uint32_t edges = cartridge_->a12_edges_until_irq();
+		if (edges != Mapper::NO_A12_IRQ) {
+			const uint64_t irq_dots = a12_predicting_ ? dots_until_predicted_a12_irq(edges)
+													  : static_cast<uint64_t>(edges - 1) * A12_FILTER_THRESHOLD + 1;
+			dots = static_cast<uint32_t>(std::min<uint64_t>(dots, irq_dots));
+		}
+	}
+
+	// Scanline-counting mappers raise their IRQ at the start of a line
+	if (cartridge_ && cartridge_->scanline_irq_armed()) {
+		const uint32_t line_dots = static_cast<uint32_t>(PPUTiming::CYCLES_PER_SCANLINE - 1 - current_cycle_);
+		dots = std::min(dots, line_dots);
 	}
+
+	return std::max<uint32_t>(dots, 1);
 }
 
-void PPU::tick_internal() {
+void PPU::notify_fetch_phase(bool sprites) {
+	if (cartridge_ && cartridge_->wants_ppu_notifications()) [[unlikely]] {
+		cartridge_->ppu_fetch_phase(sprites, (control_register_ & PPUConstants::PPUCTRL_SPRITE_SIZE_MASK) != 0);
+	}
+}
+
+template <Accuracy Profile> void PPU::tick_internal() {
 	// NOTE: OAM DMA is now driven by the CPU (execute_oam_dma) with per-cycle
 	// interleaving via consume_cycle(). PPU continues normal rendering here.
-
-	// Handle delayed sprite 0 hit latching
-	if (sprite_0_hit_delay_ > 0) {
-		--sprite_0_hit_delay_;
-		if (sprite_0_hit_delay_ == 0) {
-			status_register_ |= PPUConstants::PPUSTATUS_SPRITE0_MASK;
+	constexpr bool STRICT = Profile == Accuracy::Strict;
+
+	// Handle delayed sprite 0 hit latching (Fast latches on the hit dot)
+	if constexpr (STRICT) {
+		if (sprite_0_hit_delay_ > 0) {
+			--sprite_0_hit_delay_;
+			if (sprite_0_hit_delay_ == 0) {
+				status_register_ |= PPUConstants::PPUSTATUS_SPRITE0_MASK;
+			}
 		}
 	}
 
@@ -233,25 +353,50 @@ void PPU::tick_internal() {
 		break;
 	}
 
+	// Predicted A12 windows open on fixed dots of rendering lines
+	if (current_cycle_ == a12_window_dots_[0] || current_cycle_ == a12_window_dots_[1]) [[unlikely]] {
+		if (cached_phase_ == ScanlinePhase::VISIBLE || cached_phase_ == ScanlinePhase::PRE_RENDER) {
+			enter_a12_window(ppu_dot_counter_, current_cycle_ == a12_window_dots_[0] ? 0 : 1);
+		}
+	}
+
+	// The odd frame skip and VBlank timing only act on VBlank and pre-render
+	// lines; Fast looks for them there alone
+	const bool timing_line = STRICT || cached_phase_ >= ScanlinePhase::VBLANK;
+
 	// Handle odd frame skip before advancing cycle
-	handle_odd_frame_skip();
+	if (timing_line) {
+		handle_odd_frame_skip();
+	}
 
-	// Handle VRAM address corruption
-	handle_vram_address_corruption();
+	// Handle VRAM address corruption (Fast: at the end of the scanline)
+	if constexpr (STRICT) {
+		handle_vram_address_corruption();
+	}
 
 	// Advance cycle counter
 	current_cycle_++;
 	ppu_dot_counter_++; // Monotonic counter for A12 low-time filter
 
 	// Handle VBlank timing AFTER cycle increment for correct timing
-	handle_vblank_timing();
+	if (timing_line) {
+		handle_vblank_timing();
+	}
 
 	// Check for end of scanline
 	if (current_cycle_ >= PPUTiming::CYCLES_PER_SCANLINE) {
+		if constexpr (!STRICT) {
+			// A delay left by a state load or the batched path
+			if (sprite_0_hit_delay_ > 0) {
+				sprite_0_hit_delay_ = 0;
+				status_register_ |= PPUConstants::PPUSTATUS_SPRITE0_MASK;
+			}
+			handle_vram_address_corruption();
+		}
 		// CRITICAL: Swap sprite buffers at END of scanline, BEFORE incrementing to next scanline
 		// Sprites prepared during cycles 257-320 of THIS scanline are now ready for NEXT scanline
 		// This ensures the correct sprite data is active when rendering begins at cycle 1
-		if (current_scanline_ < PPUTiming::VISIBLE_SCANLINES || current_scanline_ == PPUTiming::PRE_RENDER_SCANLINE) {
+		if (current_scanline_ < PPUTiming::VISIBLE_SCANLINES || current_scanline_ == pre_render_scanline_) {
 			sprite_count_current_scanline_ = sprite_count_next_scanline_;
 			sprite_0_on_scanline_ = sprite_0_on_next_scanline_;
 			scanline_sprites_current_ = scanline_sprites_next_;
@@ -259,17 +404,35 @@ void PPU::tick_internal() {
 			// single buffer lookup instead of an 8-sprite scan.
 			rasterize_sprite_line_buffer();
 		}
+		if (current_scanline_ < PPUTiming::VISIBLE_SCANLINES && compose_frame_) {
+			resolve_scanline(current_scanline_);
+		}
 
 		current_cycle_ = 0;
 		current_scanline_++;
 		// Check for end of frame
-		if (current_scanline_ >= PPUTiming::TOTAL_SCANLINES) {
+		if (current_scanline_ >= scanlines_per_frame_) {
 			current_scanline_ = 0;
 			frame_counter_++;
 			frame_ready_ = true;
+			++frame_generation_;
+			update_compose_frame();
+			VIBENES_BUS_STAT((total_fetches_ += frame_fetches_, last_frame_fetches_ = frame_fetches_,
+							  frame_fetches_ = PpuFetchStats{}));
 
 			// Toggle odd frame flag
 			odd_frame_ = !odd_frame_;
+#ifndef VIBENES_NO_SCANLINE_TIMELINE
+			scanline_timeline_.end_frame();
+#endif
+		}
+#ifndef VIBENES_NO_SCANLINE_TIMELINE
+		record_scanline_state();
+#endif
+
+		// Scanline-counting mappers (MMC5) follow the frame from here
+		if (cartridge_ && cartridge_->wants_ppu_notifications()) [[unlikely]] {
+			cartridge_->ppu_scanline_start(current_scanline_, is_rendering_enabled());
 		}
 
 		// Scanline changed — refresh the cached phase
@@ -450,13 +613,14 @@ void PPU::process_visible_scanline() {
 			if (current_cycle_ == 256) {
 				increment_fine_y();
 			}
-		} else {
+		} else if (compose_frame_) {
 			// Rendering disabled: output backdrop color
 			// On real NES hardware, when both BG and sprites are disabled via PPUMASK,
 			// the PPU outputs a color based on the current VRAM address:
 			//   - If vram_address_ is in palette range ($3F00-$3F1F), output that palette entry
 			//   - Otherwise, output the universal backdrop color ($3F00)
 			// The VRAM address is NOT auto-incremented (no fine_y/coarse_x changes).
+			// (Skipped frames write nothing.)
 			uint8_t pixel_x = static_cast<uint8_t>(current_cycle_ - 1);
 			uint8_t backdrop_index = 0; // Universal backdrop ($3F00)
 			if ((vram_address_ & 0x3F00) == 0x3F00) {
@@ -466,9 +630,9 @@ void PPU::process_visible_scanline() {
 			if (palette_lut_dirty_) {
 				rebuild_palette_lut();
 			}
-			uint32_t color = palette_rgba_lut_[backdrop_index];
+			VIBENES_BUS_STAT(++frame_fetches_.palette);
 			size_t pixel_index = current_scanline_ * 256 + pixel_x;
-			frame_buffer_[pixel_index] = color;
+			index_buffer_[pixel_index] = palette_index_lut_[backdrop_index];
 		}
 	}
 
@@ -477,6 +641,7 @@ void PPU::process_visible_scanline() {
 
 		// At cycle 257: Copy horizontal scroll and prepare sprite metadata
 		if (current_cycle_ == 257) {
+			notify_fetch_phase(true);
 			copy_horizontal_scroll();
 
 			// Prepare sprite metadata from secondary OAM (positions, tile IDs)
@@ -499,6 +664,7 @@ void PPU::process_visible_scanline() {
 		// appearing as artifacts (single pixel vertical lines) at the start of next scanline
 		if (current_cycle_ == 320) {
 			clear_shift_registers();
+			notify_fetch_phase(false);
 		}
 
 		// Continue background tile fetching for next scanline (cycles 320-337)
@@ -533,9 +699,198 @@ void PPU::process_visible_scanline() {
 				uint16_t nt_addr = get_current_nametable_address();
 				track_a12_line(nt_addr); // Track A12 for MMC3
 				memory_.read_vram(nt_addr);
+				VIBENES_BUS_STAT(++frame_fetches_.nametable);
+			}
+		}
+	}
+}
+
+bool PPU::can_batch_visible_scanline() const {
+	if (!scanline_batching_ || cached_phase_ != ScanlinePhase::VISIBLE || !is_rendering_enabled() ||
+		vram_address_corruption_pending_) {
+		return false;
+	}
+
+	// BG pattern fetches from $1000 raise A12 at dot 5 (and every 8 dots after).
+	// Only that first edge can pass the MMC3 low-time filter — the later ones
+	// follow just 6 low dots — so if it would clock the counter, the mapper has
+	// to see it on the exact dot: stay on the dot path.
+	if (control_register_ & PPUConstants::PPUCTRL_BG_PATTERN_MASK) {
+		const uint32_t first_edge_dot = ppu_dot_counter_ + 4;
+		if (first_edge_dot - a12_last_high_dot_ >= A12_FILTER_THRESHOLD) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PPU::render_visible_scanline_batched() {
+	VIBENES_TRACE_ZONE("PPU::render_visible_scanline_batched");
+	// Equivalent to tick_internal() for dots 1-256 of a visible scanline with
+	// rendering enabled. The background is decoded straight from nametable,
+	// attribute and pattern data into a pixel stream, then mixed with the
+	// sprite line buffer and tested for sprite-0 hit 256 pixels at a time
+	// (SimdKernels::multiplex_pixels).
+	const uint16_t pattern_base = (control_register_ & PPUConstants::PPUCTRL_BG_PATTERN_MASK) ? 0x1000 : 0x0000;
+	const uint8_t fine_y = get_fine_y_scroll();
+	const uint32_t first_dot = ppu_dot_counter_;
+
+	// Stream pixel i is what the shift registers show at bit 15 after i shifts:
+	// indices 0-15 are the two tiles prefetched during the previous HBLANK,
+	// then each tile fetched on this line lands 8 pixels further on. Pixel x
+	// reads stream[x + fine_x].
+	std::array<uint8_t, 16 + 31 * 8> stream{};
+	for (int i = 0; i < 16; ++i) {
+		const int bit = 15 - i;
+		const uint8_t value = static_cast<uint8_t>((((bg_shift_registers_.pattern_high_shift >> bit) & 1) << 1) |
+												   ((bg_shift_registers_.pattern_low_shift >> bit) & 1));
+		const uint8_t palette = static_cast<uint8_t>((((bg_shift_registers_.attribute_high_shift >> bit) & 1) << 1) |
+													 ((bg_shift_registers_.attribute_low_shift >> bit) & 1));
+		stream[i] = value ? static_cast<uint8_t>(palette * 4 + value) : 0;
+	}
+
+	// Pattern rows come pre-decoded from the mapper's CHR cache when a
+	// cartridge is present (same bytes ppu_read would return)
+	const ChrTileCache *chr_cache =
+		(cartridge_ && cartridge_->is_loaded()) ? cartridge_->chr_tile_cache() : nullptr;
+
+	// 32 tile fetches (dots 1-255); coarse X increments after each one
+	uint8_t tile_id = 0;
+	uint8_t attribute = 0;
+	uint8_t pattern_low = 0;
+	uint8_t pattern_high = 0;
+	uint8_t previous_low = 0;
+	uint8_t previous_high = 0;
+	uint8_t previous_attribute = 0;
+	for (int tile = 0; tile < 32; ++tile) {
+		previous_low = pattern_low;
+		previous_high = pattern_high;
+		previous_attribute = attribute;
+
+		tile_id = memory_.read_vram(get_current_nametable_address());
+		const uint8_t attr_byte = memory_.read_vram(get_current_attribute_address());
+		VIBENES_BUS_STAT(frame_fetches_.nametable += 2);
+		const uint8_t sub_x = (vram_address_ & 0x02) >> 1;
+		const uint8_t sub_y = ((vram_address_ >> 5) & 0x02) >> 1;
+		attribute = (attr_byte >> ((sub_y * 2 + sub_x) * 2)) & 0x03;
+		const uint16_t pattern_addr = static_cast<uint16_t>(pattern_base + tile_id * 16 + fine_y);
+
+		// The last two tiles end up in the shift registers and fetch latches,
+		// which hold raw bitplanes; the last one is only loaded at dot 256,
+		// after the final pixel
+		if (tile >= 30 || !chr_cache) {
+			pattern_low = read_chr_rom(pattern_addr);
+			pattern_high = read_chr_rom(pattern_addr + 8);
+			VIBENES_BUS_STAT(frame_fetches_.pattern += 2);
+		} else {
+			// No ppu_read() for cached rows: log the fetch for the CDL here
+			cartridge_->log_chr_rendered(pattern_addr);
+			cartridge_->log_chr_rendered(pattern_addr + 8);
+			VIBENES_BUS_STAT(frame_fetches_.pattern_cached += 2);
+		}
+		if (tile < 31) {
+			const ChrTileCache::Row row = chr_cache ? chr_cache->row(pattern_addr)
+													: ChrTileCache::decode_row(pattern_low, pattern_high);
+			// Opaque pixels get the palette select in bits 2-3, per byte
+			const ChrTileCache::Row opaque = (row | (row >> 1)) & 0x0101010101010101ull;
+			const ChrTileCache::Row pixels = row | (opaque * static_cast<ChrTileCache::Row>(attribute << 2));
+			uint8_t *out = &stream[16 + tile * 8];
+			for (int px = 0; px < 8; ++px) {
+				out[px] = static_cast<uint8_t>(pixels >> (px * 8));
 			}
 		}
+		increment_coarse_x();
+	}
+
+	// The whole sprite evaluation window (dots 65-256) at once: the CPU cannot
+	// touch OAM or PPUCTRL inside this call, and the pixel loop below only
+	// reads the current line's sprites
+	evaluate_sprites_batched();
+
+	// The multiplexer over the whole line. The layers go in as the per-dot
+	// path would see them: nothing from a disabled layer, the left 8 pixels
+	// clipped per PPUMASK. On a skipped frame only a possible sprite-0 hit
+	// needs the sprite layer.
+	const uint8_t fine_x = fine_x_scroll_ & 0x07;
+	uint8_t *background = stream.data() + fine_x;
+	if (!is_background_enabled()) {
+		std::fill_n(background, PPUTiming::VISIBLE_PIXELS, uint8_t{0});
+	} else if (!(mask_register_ & PPUConstants::PPUMASK_SHOW_BG_LEFT_MASK)) {
+		std::fill_n(background, 8, uint8_t{0});
+	}
+	const bool sprite0_pending = sprite_0_on_scanline_ && !sprite_0_hit_detected_;
+	std::array<uint8_t, 256> sprites{};
+	if (is_sprites_enabled() && (compose_frame_ || sprite0_pending)) {
+		sprites = sprite_line_buffer_;
+		if (!(mask_register_ & PPUConstants::PPUMASK_SHOW_SPRITES_LEFT_MASK)) {
+			std::fill_n(sprites.begin(), 8, uint8_t{0});
+		}
+		// The hit comparison is off at x=0 and on the last dot
+		sprites[0] &= static_cast<uint8_t>(~SPRITE_LINE_SPRITE0_BIT);
+		sprites[255] &= static_cast<uint8_t>(~SPRITE_LINE_SPRITE0_BIT);
+	}
+	static_assert(SPRITE_LINE_PALETTE_MASK == 0x1F && SPRITE_LINE_PRIORITY_BIT == 0x20 &&
+				  SPRITE_LINE_SPRITE0_BIT == 0x40); // The layout multiplex_pixels() takes
+	std::array<uint8_t, 256> shown;
+	const std::size_t hit_x = simd_kernels().multiplex_pixels(background, sprites.data(), shown.data(), shown.size());
+
+	// The status flag goes up two dots after the hit (see sprite_0_hit_delay_);
+	// nothing can look at it before the batch ends, only whether it is up
+	if (sprite_0_hit_delay_ > 0) {
+		sprite_0_hit_delay_ = 0;
+		status_register_ |= PPUConstants::PPUSTATUS_SPRITE0_MASK;
+	}
+	if (hit_x < shown.size() && !sprite_0_hit_detected_) {
+		sprite_0_hit_detected_ = true;
+		const std::size_t dots_after = PPUTiming::VISIBLE_PIXELS - (hit_x + 1);
+		if (dots_after >= 2 || accuracy_ == Accuracy::Fast) {
+			status_register_ |= PPUConstants::PPUSTATUS_SPRITE0_MASK;
+		} else {
+			sprite_0_hit_delay_ = static_cast<uint8_t>(2 - dots_after);
+		}
+	}
+
+	if (compose_frame_) {
+		if (palette_lut_dirty_) {
+			rebuild_palette_lut();
+		}
+		VIBENES_BUS_STAT(frame_fetches_.palette += PPUTiming::VISIBLE_PIXELS);
+		uint16_t *row = index_buffer_ + static_cast<size_t>(current_scanline_) * 256;
+		for (std::size_t x = 0; x < shown.size(); ++x) {
+			row[x] = palette_index_lut_[shown[x]];
+		}
 	}
+
+	// Leave fetch/shift state exactly as dot 256 of the dot path would
+	tile_fetch_state_.fetch_cycle = 0;
+	tile_fetch_state_.current_tile_id = tile_id;
+	tile_fetch_state_.current_attribute = attribute;
+	tile_fetch_state_.current_pattern_low = pattern_low;
+	tile_fetch_state_.current_pattern_high = pattern_high;
+	bg_shift_registers_.next_tile_id = tile_id;
+	bg_shift_registers_.next_tile_attribute = attribute;
+	bg_shift_registers_.next_tile_pattern_low = pattern_low;
+	bg_shift_registers_.next_tile_pattern_high = pattern_high;
+	bg_shift_registers_.pattern_low_shift = static_cast<uint16_t>((previous_low << 8) | pattern_low);
+	bg_shift_registers_.pattern_high_shift = static_cast<uint16_t>((previous_high << 8) | pattern_high);
+	bg_shift_registers_.attribute_low_shift =
+		static_cast<uint16_t>(((previous_attribute & 1) ? 0xFF00 : 0) | ((attribute & 1) ? 0x00FF : 0));
+	bg_shift_registers_.attribute_high_shift =
+		static_cast<uint16_t>(((previous_attribute & 2) ? 0xFF00 : 0) | ((attribute & 2) ? 0x00FF : 0));
+	increment_fine_y();
+
+	// A12 saw only NT/AT (low) and BG pattern fetches; the last one was dot 255
+	if (a12_pattern_ == A12Pattern::BackgroundHigh) {
+		enter_a12_window(first_dot + 4, 0);
+	} else if (pattern_base != 0) {
+		last_a12_state_ = true;
+		a12_last_high_dot_ = first_dot + 254;
+	} else {
+		last_a12_state_ = false;
+	}
+
+	current_cycle_ = PPUTiming::VISIBLE_PIXELS + 1;
+	ppu_dot_counter_ = first_dot + PPUTiming::VISIBLE_PIXELS;
 }
 
 void PPU::process_post_render_scanline() {
@@ -572,6 +927,7 @@ void PPU::process_pre_render_scanline() {
 
 		// Copy horizontal scroll and prepare sprite metadata
 		if (current_cycle_ == 257) {
+			notify_fetch_phase(true);
 			copy_horizontal_scroll();
 
 			// Prepare sprite metadata for scanline 0 (pattern fetches happen per-cycle)
@@ -611,6 +967,7 @@ void PPU::process_pre_render_scanline() {
 		// CRITICAL: Clear shift registers to prevent garbage artifacts
 		if (current_cycle_ == 320) {
 			clear_shift_registers();
+			notify_fetch_phase(false);
 			// Bug #14 frame 0 hack removed — the PPU should honour whatever
 			// scroll/VRAM state software has configured, even on the very
 			// first frame.  The previous workaround zeroed fine_x/fine_y
@@ -717,6 +1074,7 @@ void PPU::write_ppuctrl(uint8_t value) {
 	// Update temporary VRAM address nametable bits
 	temp_vram_address_ = (temp_vram_address_ & ~0x0C00) | ((static_cast<uint16_t>(value) & 0x03) << 10);
 
+	update_a12_prediction();
 	check_nmi();
 }
 
@@ -732,6 +1090,7 @@ void PPU::write_ppumask(uint8_t value) {
 		rendering_disabled_mid_scanline_ = true;
 	}
 	was_rendering_enabled_ = now_enabled;
+	update_a12_prediction();
 
 	// Grayscale (bit 0) and emphasis (bits 5-7) feed the palette LUT
 	palette_lut_dirty_ = true;
@@ -814,16 +1173,18 @@ uint8_t PPU::read_ppu_memory(uint16_t address) {
 		// Pattern tables - read from cartridge CHR ROM/RAM
 		uint8_t value = 0;
 		if (cartridge_ && cartridge_->is_loaded()) {
-			value = cartridge_->ppu_read(address);
+			value = cartridge_->ppu_read(address, CodeDataLogger::CHR_READ);
 		} else {
 			// Fallback to internal CHR RAM for tests
 			value = memory_.read_pattern_table(address);
 		}
+		VIBENES_BUS_STAT(++frame_fetches_.pattern);
 		update_io_bus(value);
 		return value;
 	} else if (address < PPUMemoryMap::NAMETABLE_MIRROR_END + 1) {
 		// Nametables and mirrors
 		uint8_t value = memory_.read_vram(address);
+		VIBENES_BUS_STAT(++frame_fetches_.nametable);
 		update_io_bus(value);
 		return value;
 	} else {
@@ -832,6 +1193,7 @@ uint8_t PPU::read_ppu_memory(uint16_t address) {
 		uint16_t read_addr = address;
 		handle_palette_mirroring(read_addr);
 		uint8_t value = memory_.read_palette(read_addr & 0x1F);
+		VIBENES_BUS_STAT(++frame_fetches_.palette);
 		update_io_bus(value);
 		return value;
 	}
@@ -846,6 +1208,7 @@ void PPU::write_ppu_memory(uint16_t address, uint8_t value) {
 		// Pattern tables - writes go to cartridge CHR RAM (if present)
 		if (cartridge_ && cartridge_->is_loaded()) {
 			cartridge_->ppu_write(address, value);
+			memory_.mark_pattern_dirty(address);
 		} else {
 			// Fallback to internal CHR RAM for tests
 			memory_.write_pattern_table(address, value);
@@ -888,7 +1251,7 @@ ScanlinePhase PPU::get_current_phase() const {
 		return ScanlinePhase::VISIBLE;
 	} else if (current_scanline_ == PPUTiming::POST_RENDER_SCANLINE) {
 		return ScanlinePhase::POST_RENDER;
-	} else if (current_scanline_ <= PPUTiming::VBLANK_END_SCANLINE) {
+	} else if (current_scanline_ < pre_render_scanline_) {
 		return ScanlinePhase::VBLANK;
 	} else {
 		return ScanlinePhase::PRE_RENDER;
@@ -934,6 +1297,11 @@ void PPU::render_pixel() {
 		return;
 	}
 
+	// Skipped frame: nothing to compose unless sprite 0 could still hit
+	if (!compose_frame_ && (!sprite_0_on_scanline_ || sprite_0_hit_detected_)) {
+		return;
+	}
+
 	uint8_t pixel_x = static_cast<uint8_t>(current_cycle_ - 1);
 
 	uint8_t bg_pixel = 0;
@@ -951,14 +1319,93 @@ void PPU::render_pixel() {
 
 	if (sprite0_candidate && !sprite_0_hit_detected_ && check_sprite_0_hit(bg_pixel, sprite_pixel, pixel_x)) {
 		sprite_0_hit_detected_ = true;
-		sprite_0_hit_delay_ = 2;
+		if (accuracy_ == Accuracy::Fast) {
+			status_register_ |= PPUConstants::PPUSTATUS_SPRITE0_MASK;
+		} else {
+			sprite_0_hit_delay_ = 2;
+		}
 	}
 
-	render_combined_pixel(bg_pixel, sprite_pixel, sprite_priority, pixel_x, static_cast<uint8_t>(current_scanline_));
+	if (compose_frame_) {
+		render_combined_pixel(bg_pixel, sprite_pixel, sprite_priority, pixel_x,
+							  static_cast<uint8_t>(current_scanline_));
+	}
 }
 
 void PPU::clear_frame_buffer() {
-	frame_buffer_.fill(0xFF000000); // Clear to black
+	// NES black, no emphasis
+	std::fill_n(index_buffer_, frame_buffers_->indices.size(), uint16_t{0x0F});
+	frame_buffers_->pixels.fill(0xFF000000); // Clear to black
+}
+
+void PPU::set_index_buffer(uint16_t *buffer) {
+	uint16_t *target = buffer ? buffer : frame_buffers_->indices.data();
+	if (target != index_buffer_) {
+		std::copy_n(index_buffer_, frame_buffers_->indices.size(), target);
+		index_buffer_ = target;
+	}
+}
+
+void PPU::set_frame_skip(uint32_t interval) noexcept {
+	frame_skip_ = interval;
+	update_compose_frame();
+}
+
+const uint32_t *PPU::get_frame_buffer() const {
+	// Rows before the current one were converted as they finished
+	if (current_scanline_ < PPUTiming::VISIBLE_SCANLINES && compose_frame_) {
+		resolve_scanline(current_scanline_);
+	}
+	return frame_buffer_;
+}
+
+bool PPU::is_pixel_drawn(uint8_t x, uint8_t y) const noexcept {
+	if (!compose_frame_ || y >= PPUTiming::VISIBLE_SCANLINES) {
+		return false;
+	}
+	if (current_scanline_ >= PPUTiming::VISIBLE_SCANLINES) {
+		return true; // Post-render, vblank and pre-render: the frame is complete
+	}
+	// Dot 1 outputs pixel 0
+	return y < current_scanline_ || (y == current_scanline_ && x + 1 < current_cycle_);
+}
+
+void PPU::record_scanline_state() noexcept {
+	ScanlineState state;
+	state.v = vram_address_;
+	state.t = temp_vram_address_;
+	state.fine_x = fine_x_scroll_;
+	state.ctrl = control_register_;
+	state.mask = mask_register_;
+	state.flags = ScanlineState::RECORDED | (write_toggle_ ? ScanlineState::WRITE_TOGGLE : 0);
+	if (const ChrTileCache *cache = cartridge_ ? cartridge_->chr_tile_cache() : nullptr) {
+		const Byte *chr = cache->chr_memory().data();
+		for (std::size_t slot = 0; slot < ChrTileCache::SLOT_COUNT; ++slot) {
+			const Byte *source = cache->slot_source(slot);
+			state.chr_banks[slot] = source && chr ? static_cast<uint8_t>((source - chr) / ChrTileCache::PAGE_SIZE) : 0;
+		}
+	}
+	scanline_timeline_.record(current_scanline_, state);
+}
+
+const std::array<uint32_t, 512> &PPU::rgba_palette() {
+	// Every index buffer entry (64 colors x 8 emphasis combinations) to RGBA
+	static const std::array<uint32_t, 512> lut = [] {
+		std::array<uint32_t, 512> colors{};
+		for (uint16_t entry = 0; entry < colors.size(); ++entry) {
+			colors[entry] = apply_color_emphasis(NESPalette::get_rgba_color(static_cast<uint8_t>(entry & 0x3F)),
+												 static_cast<uint8_t>(entry >> 6));
+		}
+		return colors;
+	}();
+	return lut;
+}
+
+void PPU::resolve_scanline(uint16_t scanline) const {
+	const std::array<uint32_t, 512> &rgba_lut = rgba_palette();
+	const uint16_t *indices = index_buffer_ + scanline * 256;
+	uint32_t *pixels = frame_buffer_ + scanline * 256;
+	simd_kernels().palette_lookup(indices, rgba_lut.data(), pixels, 256);
 }
 
 void PPU::check_nmi() {
@@ -1016,10 +1463,12 @@ void PPU::render_background_pixel() {
 
 	// Convert to color and store in frame buffer
 	size_t pixel_index = pixel_y * 256 + pixel_x;
-	frame_buffer_[pixel_index] = get_palette_color(palette_index);
+	index_buffer_[pixel_index] = get_palette_entry(palette_index);
+	VIBENES_BUS_STAT(++frame_fetches_.palette);
 }
 
 uint8_t PPU::fetch_nametable_byte(uint16_t nametable_addr) {
+	VIBENES_BUS_STAT(++frame_fetches_.nametable);
 	return memory_.read_vram(nametable_addr);
 }
 
@@ -1036,6 +1485,7 @@ uint8_t PPU::fetch_attribute_byte(uint16_t nametable_addr) {
 	uint16_t attr_addr = nametable_base + 0x3C0 + (attr_y * 8) + attr_x;
 
 	uint8_t attribute_byte = memory_.read_vram(attr_addr);
+	VIBENES_BUS_STAT(++frame_fetches_.nametable);
 
 	// Extract 2-bit palette for this 2x2 tile group within the 4x4 area
 	uint8_t sub_x = (tile_x % 4) / 2;
@@ -1060,6 +1510,7 @@ uint16_t PPU::fetch_pattern_data(uint8_t tile_index, uint8_t fine_y, bool backgr
 		low_byte = cartridge_->ppu_read(pattern_addr);
 		// Read high bit plane
 		high_byte = cartridge_->ppu_read(pattern_addr + 8);
+		VIBENES_BUS_STAT(frame_fetches_.pattern += 2);
 	}
 
 	return (static_cast<uint16_t>(high_byte) << 8) | low_byte;
@@ -1084,7 +1535,7 @@ uint8_t PPU::get_background_palette_index(uint16_t pattern_data, uint8_t attribu
 	return (attribute * 4) + pixel_value;
 }
 
-uint32_t PPU::get_palette_color(uint8_t palette_index) {
+uint16_t PPU::get_palette_entry(uint8_t palette_index) {
 	// Apply grayscale mode BEFORE reading palette
 	// When PPUMASK bit 0 is set, force palette index to grayscale entries
 	if (mask_register_ & 0x01) {
@@ -1094,18 +1545,19 @@ uint32_t PPU::get_palette_color(uint8_t palette_index) {
 	}
 
 	// Read from palette memory
-	uint8_t color_index = memory_.read_palette(palette_index);
+	uint8_t color_index = memory_.read_palette(palette_index) & 0x3F;
 
-	// Use the accurate NES color palette
-	return NESPalette::get_rgba_color(color_index);
+	// Emphasis (PPUMASK bits 5-7) rides along in bits 6-8 for resolve_scanline
+	return static_cast<uint16_t>(color_index | (((mask_register_ >> 5) & 0x07) << 6));
 }
 
 void PPU::rebuild_palette_lut() {
-	// Fold palette RAM + grayscale + emphasis into one RGBA per palette index.
-	// Uses the exact per-pixel path (get_palette_color + apply_color_emphasis)
-	// so results are bit-identical to the unbatched computation.
+	// Fold palette RAM + grayscale + emphasis into one entry per palette index.
+	// Uses the exact per-pixel path (get_palette_entry) so results are
+	// bit-identical to the unbatched computation.
+	VIBENES_BUS_STAT(++frame_fetches_.palette_rebuilds);
 	for (uint8_t i = 0; i < 32; ++i) {
-		palette_rgba_lut_[i] = apply_color_emphasis(get_palette_color(i));
+		palette_index_lut_[i] = get_palette_entry(i);
 	}
 	palette_lut_dirty_ = false;
 }
@@ -1169,13 +1621,15 @@ void PPU::rasterize_sprite_line_buffer() {
 		const bool flip_horizontal = sprite.sprite_data.attributes.flip_horizontal;
 		const int x_start = sprite.sprite_data.x_position;
 
+		// Decode the fetched bitplanes (not the CHR cache: the bytes were
+		// latched during HBLANK and the bank may have changed since)
+		const ChrTileCache::Row row =
+			flip_horizontal ? ChrTileCache::decode_row_flipped(sprite.pattern_data_low, sprite.pattern_data_high)
+							: ChrTileCache::decode_row(sprite.pattern_data_low, sprite.pattern_data_high);
+
 		// Sprites are clipped at the right screen edge (no wraparound)
 		for (int px = 0; px < 8 && (x_start + px) < 256; ++px) {
-			const uint8_t sprite_x = static_cast<uint8_t>(flip_horizontal ? (7 - px) : px);
-			const uint8_t bit_shift = static_cast<uint8_t>(7 - sprite_x);
-			const uint8_t low_bit = (sprite.pattern_data_low >> bit_shift) & 0x01;
-			const uint8_t high_bit = (sprite.pattern_data_high >> bit_shift) & 0x01;
-			const uint8_t pixel_value = static_cast<uint8_t>((high_bit << 1) | low_bit);
+			const uint8_t pixel_value = ChrTileCache::pixel(row, px);
 
 			if (pixel_value == 0) {
 				continue; // Transparent pixel — lower-priority sprite shows through
@@ -1197,6 +1651,7 @@ uint8_t PPU::fetch_sprite_pattern_data_raw(uint8_t tile_index, uint8_t fine_y, b
 	// Read from cartridge CHR ROM/RAM with support for dynamic banking
 	// This allows mappers to switch CHR banks during sprite evaluation
 	if (cartridge_) {
+		VIBENES_BUS_STAT(++frame_fetches_.pattern);
 		return cartridge_->ppu_read(pattern_addr);
 	}
 
@@ -1215,6 +1670,10 @@ void PPU::track_a12_line(uint16_t address) {
 	//   Nametables      ($2000-$2FFF): A12 = 0
 	//   NT mirrors      ($3000-$3FFF): A12 = 1
 
+	if (a12_predicting_) {
+		return; // enter_a12_window() covers this fetch
+	}
+
 	bool current_a12 = (address & 0x1000) != 0;
 
 	if (current_a12) {
@@ -1236,6 +1695,140 @@ void PPU::track_a12_line(uint16_t address) {
 	last_a12_state_ = current_a12;
 }
 
+void PPU::set_region(const RegionTiming &timing) noexcept {
+	region_ = timing.region;
+	vblank_start_scanline_ = timing.vblank_start_scanline;
+	pre_render_scanline_ = timing.pre_render_scanline();
+	scanlines_per_frame_ = timing.scanlines_per_frame;
+	odd_frame_skip_cycle_ = timing.odd_frame_skip ? PPUTiming::ODD_FRAME_SKIP_CYCLE : UINT16_MAX;
+	if (current_scanline_ >= scanlines_per_frame_) {
+		current_scanline_ = 0;
+		current_cycle_ = 0;
+	}
+	cached_phase_ = get_current_phase();
+}
+
+void PPU::set_a12_prediction(bool enabled) noexcept {
+	a12_prediction_ = enabled;
+	update_a12_prediction();
+}
+
+void PPU::update_a12_prediction() {
+	A12Pattern pattern = A12Pattern::None;
+	if (a12_prediction_ && is_rendering_enabled() && !(control_register_ & PPUConstants::PPUCTRL_SPRITE_SIZE_MASK)) {
+		const bool bg_high = (control_register_ & PPUConstants::PPUCTRL_BG_PATTERN_MASK) != 0;
+		const bool sprites_high = (control_register_ & PPUConstants::PPUCTRL_SPRITE_PATTERN_MASK) != 0;
+		if (bg_high != sprites_high) {
+			pattern = sprites_high ? A12Pattern::SpritesHigh : A12Pattern::BackgroundHigh;
+		}
+	}
+	if (pattern == a12_pattern_) {
+		return;
+	}
+
+	// Hand the filter back to edge tracking as it stands now; a new pattern
+	// takes over at its next window start, where the tracker has just seen
+	// the same edge
+	if (a12_predicting_) {
+		std::tie(last_a12_state_, a12_last_high_dot_) = a12_filter_state();
+		a12_predicting_ = false;
+	}
+	a12_pattern_ = pattern;
+	switch (pattern) {
+	case A12Pattern::None:
+		a12_window_dots_ = {NO_A12_WINDOW, NO_A12_WINDOW};
+		break;
+	case A12Pattern::SpritesHigh:
+		a12_window_dots_ = {a12_window(pattern, 0).start, NO_A12_WINDOW};
+		break;
+	case A12Pattern::BackgroundHigh:
+		a12_window_dots_ = {a12_window(pattern, 0).start, a12_window(pattern, 1).start};
+		break;
+	}
+}
+
+PPU::A12Window PPU::a12_window(A12Pattern pattern, uint8_t index) noexcept {
+	if (pattern == A12Pattern::SpritesHigh) {
+		return {261, 58}; // Sprite pattern fetches, 261-319
+	}
+	// Background pattern fetches, 5-255 and the next line's first two tiles at 325-335
+	return index == 0 ? A12Window{5, 250} : A12Window{325, 10};
+}
+
+void PPU::enter_a12_window(uint32_t dot, uint8_t index) {
+	// The window's first fetch is the rising edge the tracker would see (until
+	// prediction takes over, track_a12_line() has just handled it)
+	if (a12_predicting_ && dot - a12_last_high_dot_ >= A12_FILTER_THRESHOLD && cartridge_ &&
+		cartridge_->is_loaded()) {
+		cartridge_->ppu_a12_toggle();
+	}
+	a12_predicting_ = true;
+	a12_window_index_ = index;
+	a12_window_pre_render_ = cached_phase_ == ScanlinePhase::PRE_RENDER;
+	a12_last_high_dot_ = dot + a12_window(a12_pattern_, index).span;
+	last_a12_state_ = false;
+}
+
+std::pair<bool, uint32_t> PPU::a12_filter_state() const noexcept {
+	if (!a12_predicting_) {
+		return {last_a12_state_, a12_last_high_dot_};
+	}
+	// Replay the last window up to the last dot run: high fetch pairs at
+	// offsets 0/2, 8/10, ... then low until the next window
+	const uint32_t span = a12_window(a12_pattern_, a12_window_index_).span;
+	const uint32_t start = a12_last_high_dot_ - span;
+	const uint32_t elapsed = ppu_dot_counter_ - 1 - start;
+	if (elapsed < span) {
+		const uint32_t high = (elapsed & ~7u) + ((elapsed & 7u) >= 2 ? 2 : 0);
+		return {elapsed - high <= 1, start + high};
+	}
+	// The pre-render line has no dot 337/339 fetches, so its last window
+	// leaves A12 high until line 0's first nametable fetch
+	const bool held = a12_window_pre_render_ && a12_window_index_ == 1 && !(current_scanline_ == 0 && current_cycle_ > 1);
+	return {elapsed - span <= 1 || held, a12_last_high_dot_};
+}
+
+uint32_t PPU::dots_until_predicted_a12_irq(uint32_t edges) const noexcept {
+	constexpr uint32_t LINE = PPUTiming::CYCLES_PER_SCANLINE;
+	constexpr uint32_t VISIBLE = PPUTiming::VISIBLE_SCANLINES;
+	const uint32_t PRE_RENDER = pre_render_scanline_;
+	const uint32_t DOTS_PER_FRAME = LINE * scanlines_per_frame_;
+
+	// Clocks in frame order: one per visible line, then the pre-render
+	// line's - with the background at $1000 its dot 5 fetch follows the
+	// VBlank gap, so that line clocks twice
+	const bool bg_high = a12_pattern_ == A12Pattern::BackgroundHigh;
+	const uint32_t dot = a12_window(a12_pattern_, bg_high ? 1 : 0).start;
+	const uint32_t early_dot = a12_window(a12_pattern_, 0).start;
+	const uint32_t per_frame = VISIBLE + (bg_high ? 2 : 1);
+	auto clock_position = [&](uint32_t ordinal) -> uint32_t {
+		if (ordinal < VISIBLE) {
+			return ordinal * LINE + dot;
+		}
+		if (bg_high && ordinal == VISIBLE) {
+			return PRE_RENDER * LINE + early_dot;
+		}
+		return PRE_RENDER * LINE + dot;
+	};
+
+	// Clocks whose dot has already run this frame
+	uint32_t done = VISIBLE;
+	if (current_scanline_ < VISIBLE) {
+		done = current_scanline_ + (current_cycle_ > dot ? 1 : 0);
+	} else if (current_scanline_ == PRE_RENDER) {
+		done += (bg_high && current_cycle_ > early_dot ? 1 : 0) + (current_cycle_ > dot ? 1 : 0);
+	}
+
+	// Ticks to execute the IRQ's clock, one low per frame wrap crossed for
+	// the odd-frame skip
+	const uint32_t target = done + edges - 1;
+	const uint32_t frames = target / per_frame;
+	const uint32_t position = static_cast<uint32_t>(current_scanline_) * LINE + current_cycle_;
+	const uint64_t ticks =
+		static_cast<uint64_t>(frames) * (DOTS_PER_FRAME - 1) + clock_position(target % per_frame) - position + 1;
+	return static_cast<uint32_t>(std::min<uint64_t>(ticks, UINT32_MAX));
+}
+
 bool PPU::check_sprite_0_hit(uint8_t bg_pixel, uint8_t sprite_pixel, uint8_t x_pos) {
 	// Sprite 0 hit conditions:
 	// 1. Both background and sprite pixel must be non-transparent
@@ -1289,11 +1882,11 @@ void PPU::render_combined_pixel(uint8_t bg_pixel, uint8_t sprite_pixel, bool spr
 	if (palette_lut_dirty_) {
 		rebuild_palette_lut();
 	}
-	uint32_t color = palette_rgba_lut_[final_pixel & 0x1F];
+	VIBENES_BUS_STAT(++frame_fetches_.palette);
 
-	// Render to frame buffer
+	// Render to the index buffer; RGBA conversion happens per scanline
 	size_t pixel_index = y_pos * 256 + x_pos;
-	frame_buffer_[pixel_index] = color;
+	index_buffer_[pixel_index] = palette_index_lut_[final_pixel & 0x1F];
 }
 
 // =============================================================================
@@ -1418,6 +2011,22 @@ void PPU::write_oam_direct(uint8_t offset, uint8_t value) {
 	oam_memory_[addr] = value;
 }
 
+void PPU::write_oam_page(std::span<const uint8_t, 256> data) noexcept {
+	const std::size_t split = oam_memory_.size() - oam_address_;
+	std::memcpy(oam_memory_.data() + oam_address_, data.data(), split);
+	std::memcpy(oam_memory_.data(), data.data() + split, oam_address_);
+}
+
+bool PPU::is_oam_idle_for(uint32_t dots) const noexcept {
+	if (!is_rendering_enabled()) {
+		return true;
+	}
+	const uint32_t position = static_cast<uint32_t>(current_scanline_) * PPUTiming::CYCLES_PER_SCANLINE + current_cycle_;
+	const uint32_t idle_start = static_cast<uint32_t>(PPUTiming::POST_RENDER_SCANLINE) * PPUTiming::CYCLES_PER_SCANLINE;
+	const uint32_t idle_end = static_cast<uint32_t>(pre_render_scanline_) * PPUTiming::CYCLES_PER_SCANLINE;
+	return position >= idle_start && position + dots <= idle_end;
+}
+
 void PPU::perform_oam_dma_cycle() {
 	if (!oam_dma_pending_ && !oam_dma_active_) {
 		return;
@@ -1518,7 +2127,7 @@ void PPU::perform_sprite_evaluation_cycle() {
 
 		// Calculate next scanline with wrap from pre-render (261) to scanline 0
 		int16_t next_scanline;
-		if (current_scanline_ == PPUTiming::PRE_RENDER_SCANLINE) {
+		if (current_scanline_ == pre_render_scanline_) {
 			next_scanline = 0;
 		} else {
 			next_scanline = static_cast<int16_t>(current_scanline_ + 1);
@@ -1595,7 +2204,7 @@ void PPU::perform_sprite_evaluation_cycle() {
 			uint8_t sprite_height = (control_register_ & PPUConstants::PPUCTRL_SPRITE_SIZE_MASK) ? 16 : 8;
 
 			int16_t next_scanline;
-			if (current_scanline_ == PPUTiming::PRE_RENDER_SCANLINE) {
+			if (current_scanline_ == pre_render_scanline_) {
 				next_scanline = 0;
 			} else {
 				next_scanline = static_cast<int16_t>(current_scanline_ + 1);
@@ -1638,6 +2247,65 @@ void PPU::perform_sprite_evaluation_cycle() {
 	}
 }
 
+void PPU::evaluate_sprites_batched() {
+	// Same secondary OAM, overflow flag, sprite-0 flag and final state machine
+	// registers as calling perform_sprite_evaluation_cycle() for dots 65-256.
+	// The state machine always finishes inside the window (at most 152 of
+	// its 192 dots), so only the order of OAM reads matters, not their timing.
+	// Only used for visible scanlines (the next line is current + 1).
+	clear_secondary_oam();
+	secondary_oam_index_ = 0;
+	const uint8_t sprite_height = (control_register_ & PPUConstants::PPUCTRL_SPRITE_SIZE_MASK) ? 16 : 8;
+	const auto line = static_cast<uint8_t>(current_scanline_);
+	// A sprite at Y covers lines Y+1 .. Y+height; for next line L+1 that is
+	// Y <= L && L - Y < height
+	const auto in_range = [&](uint8_t y) {
+		return y <= line && static_cast<uint8_t>(line - y) < sprite_height;
+	};
+
+	alignas(16) std::array<uint8_t, 64> y_positions;
+	for (int n = 0; n < 64; ++n) {
+		y_positions[n] = oam_memory_[n * 4];
+	}
+	uint64_t candidates = simd_kernels().sprites_in_range(y_positions.data(), line, sprite_height);
+
+	// Copy the first eight hits in OAM order
+	uint8_t n = 64;
+	uint8_t last_copied = 0;
+	while (candidates != 0 && sprite_count_next_scanline_ < 8) {
+		const uint8_t sprite = static_cast<uint8_t>(std::countr_zero(candidates));
+		candidates &= candidates - 1;
+		std::memcpy(&secondary_oam_[secondary_oam_index_], &oam_memory_[sprite * 4], 4);
+		secondary_oam_index_ = static_cast<uint8_t>(secondary_oam_index_ + 4);
+		secondary_oam_source_[sprite_count_next_scanline_] = sprite;
+		sprite_0_on_next_scanline_ = sprite_0_on_next_scanline_ || sprite == 0;
+		++sprite_count_next_scanline_;
+		last_copied = sprite;
+		n = static_cast<uint8_t>(sprite + 1);
+	}
+
+	uint8_t m = sprite_count_next_scanline_ > 0 ? 3 : 0;
+	if (sprite_count_next_scanline_ == 8 && n < 64) {
+		// Overflow search with the hardware bug: n and m both advance, so
+		// later "Y" reads come from tile, attribute and X bytes
+		m = 0;
+		for (; n < 64; ++n) {
+			if (in_range(oam_memory_[n * 4 + m])) {
+				sprite_overflow_detected_ = true;
+				status_register_ |= PPUConstants::PPUSTATUS_OVERFLOW_MASK;
+			}
+			m = (m + 1) & 3;
+		}
+		sprite_eval_buffer_ = oam_memory_[last_copied * 4];
+	} else {
+		// The last Y read was sprite 63's
+		sprite_eval_buffer_ = oam_memory_[63 * 4];
+	}
+	sprite_eval_n_ = 64;
+	sprite_eval_m_ = m;
+	sprite_eval_state_ = SpriteEvalState::Done;
+}
+
 void PPU::prepare_scanline_sprites() {
 	// Phase 1 of sprite preparation: Read secondary OAM and compute sprite
 	// metadata (positions, tile indices, row calculations).  Pattern table
@@ -1705,7 +2373,7 @@ void PPU::perform_sprite_fetch_cycle() {
 
 			// Calculate row within sprite
 			int16_t next_scanline;
-			if (current_scanline_ == PPUTiming::PRE_RENDER_SCANLINE) {
+			if (current_scanline_ == pre_render_scanline_) {
 				next_scanline = 0;
 			} else {
 				next_scanline = static_cast<int16_t>(current_scanline_ + 1);
@@ -1743,6 +2411,7 @@ void PPU::perform_sprite_fetch_cycle() {
 			// Read but discard (needed for A12 tracking, not data)
 			if (cartridge_ && cartridge_->is_loaded()) {
 				cartridge_->ppu_read(pattern_addr);
+				VIBENES_BUS_STAT(++frame_fetches_.pattern);
 			}
 		}
 		break;
@@ -1755,7 +2424,7 @@ void PPU::perform_sprite_fetch_cycle() {
 			uint8_t sprite_height = (control_register_ & PPUConstants::PPUCTRL_SPRITE_SIZE_MASK) ? 16 : 8;
 
 			int16_t next_scanline;
-			if (current_scanline_ == PPUTiming::PRE_RENDER_SCANLINE) {
+			if (current_scanline_ == pre_render_scanline_) {
 				next_scanline = 0;
 			} else {
 				next_scanline = static_cast<int16_t>(current_scanline_ + 1);
@@ -1791,6 +2460,7 @@ void PPU::perform_sprite_fetch_cycle() {
 			track_a12_line(pattern_addr);
 			if (cartridge_ && cartridge_->is_loaded()) {
 				cartridge_->ppu_read(pattern_addr);
+				VIBENES_BUS_STAT(++frame_fetches_.pattern);
 			}
 		}
 		break;
@@ -1808,7 +2478,7 @@ void PPU::perform_sprite_fetch_cycle() {
 void PPU::handle_odd_frame_skip() {
 	// On odd frames during pre-render scanline, cycle 339 is skipped
 	// This only happens if rendering is enabled
-	if (current_scanline_ == PPUTiming::PRE_RENDER_SCANLINE && current_cycle_ == PPUTiming::ODD_FRAME_SKIP_CYCLE &&
+	if (current_scanline_ == pre_render_scanline_ && current_cycle_ == odd_frame_skip_cycle_ &&
 		odd_frame_ && is_rendering_enabled()) {
 
 		// Skip cycle 339, advance directly to cycle 340
@@ -1818,7 +2488,7 @@ void PPU::handle_odd_frame_skip() {
 
 void PPU::handle_vblank_timing() {
 	// Handle precise VBlank flag timing and NMI generation
-	if (current_scanline_ == PPUTiming::VBLANK_START_SCANLINE) {
+	if (current_scanline_ == vblank_start_scanline_) {
 		// Set VBlank exactly at cycle 1 (241,1)
 		if (current_cycle_ == PPUTiming::VBLANK_SET_CYCLE) {
 			if (!suppress_vbl_) {
@@ -1842,7 +2512,7 @@ void PPU::handle_vblank_timing() {
 
 	// Pre-render scanline (261): clear VBlank, sprite 0 hit, and sprite overflow at dot 1.
 	// Real hardware clears all three flags here, not during VBlank.
-	if (current_scanline_ == PPUTiming::PRE_RENDER_SCANLINE) {
+	if (current_scanline_ == pre_render_scanline_) {
 		if (current_cycle_ == PPUTiming::VBLANK_CLEAR_CYCLE) {
 			clear_vblank_flag();
 			status_register_ &= ~(PPUConstants::PPUSTATUS_SPRITE0_MASK | PPUConstants::PPUSTATUS_OVERFLOW_MASK);
@@ -1961,10 +2631,9 @@ uint8_t PPU::multiplex_background_sprite_pixels(uint8_t bg_pixel, uint8_t sprite
 	}
 }
 
-uint32_t PPU::apply_color_emphasis(uint32_t color) {
-	// Apply color emphasis based on PPUMASK bits 5-7
-	// Bit 5 = Emphasize Red, Bit 6 = Emphasize Green, Bit 7 = Emphasize Blue
-	uint8_t emphasis = (mask_register_ >> 5) & 0x07;
+uint32_t PPU::apply_color_emphasis(uint32_t color, uint8_t emphasis) {
+	// Apply color emphasis from PPUMASK bits 5-7 (passed as bits 0-2)
+	// Bit 0 = Emphasize Red, Bit 1 = Emphasize Green, Bit 2 = Emphasize Blue
 
 	if (emphasis == 0) {
 		return color; // No emphasis
@@ -2186,6 +2855,7 @@ void PPU::perform_tile_fetch_cycle() {
 		// Track A12 for MMC3 — nametable addresses have A12=0
 		track_a12_line(nt_addr);
 		tile_fetch_state_.current_tile_id = memory_.read_vram(nt_addr);
+		VIBENES_BUS_STAT(++frame_fetches_.nametable);
 	} break;
 
 	case 3: // Fetch attribute byte
@@ -2194,6 +2864,7 @@ void PPU::perform_tile_fetch_cycle() {
 		// Track A12 for MMC3 — attribute addresses have A12=0
 		track_a12_line(attr_addr);
 		uint8_t attr_byte = memory_.read_vram(attr_addr);
+		VIBENES_BUS_STAT(++frame_fetches_.nametable);
 
 		// Extract 2-bit palette for current tile position
 		uint8_t coarse_x = vram_address_ & 0x1F;
@@ -2220,6 +2891,7 @@ void PPU::perform_tile_fetch_cycle() {
 		// Support for mid-frame CHR bank switching
 		// Each CHR read goes through the cartridge (if loaded) or fallback CHR RAM
 		tile_fetch_state_.current_pattern_low = read_chr_rom(pattern_addr);
+		VIBENES_BUS_STAT(++frame_fetches_.pattern);
 	} break;
 
 	case 7: // Fetch pattern table high byte and store tile data
@@ -2234,6 +2906,7 @@ void PPU::perform_tile_fetch_cycle() {
 
 		// Support for mid-frame CHR bank switching
 		tile_fetch_state_.current_pattern_high = read_chr_rom(pattern_addr);
+		VIBENES_BUS_STAT(++frame_fetches_.pattern);
 
 		// Store the fetched data into the "next" latches
 		// Shift registers will be loaded at cycle end (0, 8, 16, etc.)
@@ -2348,16 +3021,17 @@ void PPU::serialize_state(std::vector<uint8_t> &buffer) const {
 	buffer.push_back(secondary_oam_index_);
 	buffer.push_back(sprite_overflow_detected_ ? 1 : 0);
 
-	// MMC3 A12 line tracking (added v2)
-	buffer.push_back(last_a12_state_ ? 1 : 0);
+	// MMC3 A12 line tracking (added v2), as edge tracking would have it
+	const auto [a12_state, a12_last_high_dot] = a12_filter_state();
+	buffer.push_back(a12_state ? 1 : 0);
 	buffer.push_back(static_cast<uint8_t>(ppu_dot_counter_ & 0xFF));
 	buffer.push_back(static_cast<uint8_t>((ppu_dot_counter_ >> 8) & 0xFF));
 	buffer.push_back(static_cast<uint8_t>((ppu_dot_counter_ >> 16) & 0xFF));
 	buffer.push_back(static_cast<uint8_t>((ppu_dot_counter_ >> 24) & 0xFF));
-	buffer.push_back(static_cast<uint8_t>(a12_last_high_dot_ & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((a12_last_high_dot_ >> 8) & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((a12_last_high_dot_ >> 16) & 0xFF));
-	buffer.push_back(static_cast<uint8_t>((a12_last_high_dot_ >> 24) & 0xFF));
+	buffer.push_back(static_cast<uint8_t>(a12_last_high_dot & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((a12_last_high_dot >> 8) & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((a12_last_high_dot >> 16) & 0xFF));
+	buffer.push_back(static_cast<uint8_t>((a12_last_high_dot >> 24) & 0xFF));
 
 	// Rendering state (added v2)
 	buffer.push_back(was_rendering_enabled_ ? 1 : 0);
@@ -2405,8 +3079,10 @@ void PPU::deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset)
 	for (int i = 0; i < 8; ++i) {
 		frame_counter_ |= static_cast<uint64_t>(buffer[offset++]) << (i * 8);
 	}
+	update_compose_frame();
 
 	frame_ready_ = buffer[offset++] != 0;
+	++frame_generation_;
 
 	// PPU registers
 	control_register_ = buffer[offset++];
@@ -2532,10 +3208,15 @@ void PPU::deserialize_state(const std::vector<uint8_t> &buffer, size_t &offset)
 	// PPU Memory (VRAM, palette RAM)
 	memory_.deserialize_state(buffer, offset);
 
-	// Rebuild derived caches from the restored state (not serialized)
+	// Rebuild derived caches from the restored state (not serialized).
+	// The A12 filter state was saved as tracked; prediction resumes at the
+	// next window start.
 	cached_phase_ = get_current_phase();
 	palette_lut_dirty_ = true;
 	rasterize_sprite_line_buffer();
+	a12_predicting_ = false;
+	a12_pattern_ = A12Pattern::None;
+	update_a12_prediction();
 }
 
 } // namespace nes
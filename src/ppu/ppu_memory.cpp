@@ -1,5 +1,6 @@
 #include "ppu/ppu_memory.hpp"
 #include "cartridge/cartridge.hpp"
+#include "cartridge/chr_tile_cache.hpp"
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -7,6 +8,7 @@
 namespace nes {
 
 PPUMemory::PPUMemory() : vertical_mirroring_(false), cartridge_(nullptr) {
+	update_fallback_nametables();
 	power_on();
 }
 
@@ -18,6 +20,7 @@ void PPUMemory::power_on() {
 	for (size_t i = 0; i < chr_ram_fallback_.size(); ++i) {
 		chr_ram_fallback_[i] = static_cast<uint8_t>(i & 0xFF);
 	}
+	mark_all_dirty();
 	// NOTE: vertical_mirroring_ is NOT reset here - it's set by the cartridge
 	// and should persist through power cycles
 }
@@ -28,23 +31,19 @@ void PPUMemory::reset() {
 }
 
 uint8_t PPUMemory::read_vram(uint16_t address) {
-	// Map the address through nametable mirroring
-	uint16_t mapped_address = map_nametable_address(address);
-
-	if (mapped_address < vram_.size()) {
-		return vram_[mapped_address];
-	}
-
-	// Invalid address, return 0
-	return 0;
+	// Bits 10-11 pick the nametable ($3000-$3EFF wraps onto $2000-$2EFF)
+	return nametable_pages()[(address >> 10) & 0x03][address & 0x03FF];
 }
 
 void PPUMemory::write_vram(uint16_t address, uint8_t value) {
-	// Map the address through nametable mirroring
-	uint16_t mapped_address = map_nametable_address(address);
-
-	if (mapped_address < vram_.size()) {
-		vram_[mapped_address] = value;
+	uint8_t *page = nametable_pages()[(address >> 10) & 0x03];
+	page[address & 0x03FF] = value;
+
+	// Viewers track CIRAM only
+	const auto ciram_offset = reinterpret_cast<uintptr_t>(page) - reinterpret_cast<uintptr_t>(vram_.data());
+	if (ciram_offset < vram_.size()) {
+		const size_t mapped_address = ciram_offset + (address & 0x03FF);
+		dirty_vram_[mapped_address >> 6].fetch_or(1ull << (mapped_address & 63), std::memory_order_relaxed);
 	}
 }
 
@@ -66,6 +65,7 @@ void PPUMemory::write_palette(uint8_t index, uint8_t value) {
 	if (mapped_index < palette_ram_.size()) {
 		// NES palette RAM is only 6 bits - mask out the upper 2 bits
 		palette_ram_[mapped_index] = value & 0x3F;
+		palette_generation_.fetch_add(1, std::memory_order_relaxed);
 	}
 }
 
@@ -76,82 +76,80 @@ uint8_t PPUMemory::read_pattern_table(uint16_t address) const {
 
 void PPUMemory::write_pattern_table(uint16_t address, uint8_t value) {
 	chr_ram_fallback_[address & 0x1FFF] = value;
+	mark_pattern_dirty(address);
 }
 
-void PPUMemory::set_mirroring_mode(bool vertical_mirroring) {
-	vertical_mirroring_ = vertical_mirroring;
+void PPUMemory::mark_pattern_dirty(uint16_t address) {
+	const uint16_t tile = (address & 0x1FFF) >> 4;
+	dirty_pattern_tiles_[tile >> 6].fetch_or(1ull << (tile & 63), std::memory_order_relaxed);
 }
 
-void PPUMemory::connect_cartridge(std::shared_ptr<Cartridge> cartridge) {
-	cartridge_ = cartridge;
+void PPUMemory::mark_all_dirty() {
+	for (auto &word : dirty_pattern_tiles_) {
+		word.store(~0ull, std::memory_order_relaxed);
+	}
+	for (auto &word : dirty_vram_) {
+		word.store(~0ull, std::memory_order_relaxed);
+	}
+	palette_generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+PPUMemory::PatternTileMask PPUMemory::take_dirty_pattern_tiles() {
+	// A bank switch changes every tile of the 1KB slot (64 tiles) without a write
+	if (const ChrTileCache *cache = cartridge_ ? cartridge_->chr_tile_cache() : nullptr) {
+		for (size_t slot = 0; slot < last_chr_slots_.size(); ++slot) {
+			if (cache->slot_source(slot) != last_chr_slots_[slot]) {
+				last_chr_slots_[slot] = cache->slot_source(slot);
+				dirty_pattern_tiles_[slot].store(~0ull, std::memory_order_relaxed);
+			}
+		}
+	}
+	PatternTileMask dirty;
+	for (size_t i = 0; i < dirty.size(); ++i) {
+		dirty[i] = dirty_pattern_tiles_[i].exchange(0, std::memory_order_relaxed);
+	}
+	return dirty;
 }
 
-bool PPUMemory::get_vertical_mirroring() const {
-	// If cartridge is connected, get mirroring from it (supports dynamic mirroring)
-	if (cartridge_) {
-		auto mirroring = cartridge_->get_mirroring();
-		return (mirroring == Mapper::Mirroring::Vertical);
+PPUMemory::VramByteMask PPUMemory::take_dirty_vram() {
+	VramByteMask dirty;
+	for (size_t i = 0; i < dirty.size(); ++i) {
+		dirty[i] = dirty_vram_[i].exchange(0, std::memory_order_relaxed);
 	}
-	// Fallback to static mirroring mode (for tests without cartridge)
-	return vertical_mirroring_;
+	return dirty;
 }
 
-uint16_t PPUMemory::map_nametable_address(uint16_t address) {
-	// Handle $3000-$3EFF mirror of $2000-$2EFF first
-	if (address >= 0x3000 && address <= 0x3EFF) {
-		address = 0x2000 + (address - 0x3000);
-	}
+void PPUMemory::set_mirroring_mode(bool vertical_mirroring) {
+	vertical_mirroring_ = vertical_mirroring;
+	update_fallback_nametables();
+}
 
-	// Remove the base nametable address to get offset within the 4-nametable space
-	uint16_t offset = address - PPUMemoryMap::NAMETABLE_0_START;
-	// Which logical nametable (0-3) and offset within it
-	uint16_t nt_index = (offset >> 10) & 0x03; // 0-3
-	uint16_t nt_offset = offset & 0x03FF;	   // 0-$3FF within nametable
-
-	// Get current mirroring mode from cartridge (supports dynamic mirroring)
-	// MMC1 can switch between all 4 modes at runtime (single-screen low/high,
-	// vertical, horizontal).  Previous code only handled vertical/horizontal,
-	// causing wrong nametable data for games like Crystalis that use
-	// single-screen mirroring during cave/indoor transitions.
-	Mapper::Mirroring mirroring = Mapper::Mirroring::Horizontal; // default fallback
+void PPUMemory::connect_cartridge(std::shared_ptr<Cartridge> cartridge) {
+	cartridge_ = cartridge;
 	if (cartridge_) {
-		mirroring = cartridge_->get_mirroring();
-	} else {
-		// Fallback for tests without cartridge
-		mirroring = vertical_mirroring_ ? Mapper::Mirroring::Vertical : Mapper::Mirroring::Horizontal;
+		cartridge_->attach_ciram(vram_.data());
 	}
+	mark_all_dirty();
+}
 
-	// Map logical nametable index (0-3) to physical VRAM page (0 or 1)
-	// NES has only 2KB VRAM → 2 physical nametable pages of 1KB each
-	uint16_t physical_page = 0;
-	switch (mirroring) {
-	case Mapper::Mirroring::Horizontal:
-		// NT0,NT1 → page 0; NT2,NT3 → page 1
-		physical_page = (nt_index >= 2) ? 1 : 0;
-		break;
-	case Mapper::Mirroring::Vertical:
-		// NT0,NT2 → page 0; NT1,NT3 → page 1
-		physical_page = (nt_index & 1);
-		break;
-	case Mapper::Mirroring::SingleScreenLow:
-		// All nametables → page 0
-		physical_page = 0;
-		break;
-	case Mapper::Mirroring::SingleScreenHigh:
-		// All nametables → page 1
-		physical_page = 1;
-		break;
-	case Mapper::Mirroring::FourScreen:
-		// Four-screen: use full 4KB (not typical NES, needs extra RAM on cart)
-		// Clamp to 2KB for safety; true four-screen carts provide their own RAM
-		physical_page = nt_index & 1;
-		break;
-	}
+const Mapper::NametablePageTable &PPUMemory::nametable_pages() const {
+	const Mapper::NametablePageTable *pages = cartridge_ ? cartridge_->nametable_pages() : nullptr;
+	return pages ? *pages : fallback_nametables_;
+}
 
-	uint16_t mapped = (physical_page * 0x0400) + nt_offset;
+void PPUMemory::update_fallback_nametables() {
+	uint8_t *const low = vram_.data();
+	uint8_t *const high = vram_.data() + 0x400;
+	fallback_nametables_ = vertical_mirroring_ ? Mapper::NametablePageTable{low, high, low, high}
+											   : Mapper::NametablePageTable{low, low, high, high};
+}
 
-	// Ensure we stay within VRAM bounds
-	return mapped % vram_.size();
+uint16_t PPUMemory::nametable_vram_offset(uint16_t address) const {
+	const uint16_t nametable = (address >> 10) & 0x03;
+	const auto ciram_offset = reinterpret_cast<uintptr_t>(nametable_pages()[nametable]) -
+							  reinterpret_cast<uintptr_t>(vram_.data());
+	const uint16_t page = ciram_offset < vram_.size() ? static_cast<uint16_t>(ciram_offset) : (nametable & 1) * 0x400;
+	return static_cast<uint16_t>(page + (address & 0x03FF));
 }
 
 uint8_t PPUMemory::map_palette_address(uint8_t address) {
@@ -199,6 +197,8 @@ void PPUMemory::deserialize_state(const std::vector<uint8_t> &buffer, size_t &of
 
 	// Deserialize mirroring mode
 	vertical_mirroring_ = buffer[offset++] != 0;
+	update_fallback_nametables();
+	mark_all_dirty();
 }
 
 } // namespace nes
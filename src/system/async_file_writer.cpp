@@ -0,0 +1,273 @@
+#include "system/async_file_writer.hpp"
+#include <algorithm>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace nes {
+
+namespace {
+
+#if defined(_WIN32)
+
+bool write_durably(const std::filesystem::path &path, std::span<const std::uint8_t> data, std::string &error) {
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		error = "cannot create " + path.string();
+		return false;
+	}
+	bool ok = true;
+	for (std::size_t offset = 0; ok && offset < data.size();) {
+		const DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(data.size() - offset, 1u << 30));
+		DWORD written = 0;
+		ok = WriteFile(file, data.data() + offset, chunk, &written, nullptr) && written != 0;
+		offset += written;
+	}
+	ok = ok && FlushFileBuffers(file);
+	CloseHandle(file);
+	if (!ok) {
+		error = "write failed for " + path.string();
+	}
+	return ok;
+}
+
+void sync_directory(const std::filesystem::path &) {
+	// NTFS journals the rename itself
+}
+
+bool patch_durably(const std::filesystem::path &path, std::span<const std::uint8_t> data,
+				   std::span<const FileRange> ranges, std::string &error) {
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		error = "cannot open " + path.string();
+		return false;
+	}
+	bool ok = true;
+	for (const FileRange &range : ranges) {
+		LARGE_INTEGER position;
+		position.QuadPart = static_cast<LONGLONG>(range.offset);
+		ok = ok && SetFilePointerEx(file, position, nullptr, FILE_BEGIN);
+		for (std::size_t offset = 0; ok && offset < range.size;) {
+			const DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(range.size - offset, 1u << 30));
+			DWORD written = 0;
+			ok = WriteFile(file, data.data() + range.offset + offset, chunk, &written, nullptr) && written != 0;
+			offset += written;
+		}
+	}
+	ok = ok && FlushFileBuffers(file);
+	CloseHandle(file);
+	if (!ok) {
+		error = "write failed for " + path.string();
+	}
+	return ok;
+}
+
+#else
+
+bool write_durably(const std::filesystem::path &path, std::span<const std::uint8_t> data, std::string &error) {
+	const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		error = "cannot create " + path.string() + ": " + std::strerror(errno);
+		return false;
+	}
+	bool ok = true;
+	for (std::size_t offset = 0; ok && offset < data.size();) {
+		const ssize_t written = ::write(fd, data.data() + offset, data.size() - offset);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		ok = written > 0;
+		offset += ok ? static_cast<std::size_t>(written) : 0;
+	}
+	ok = ok && ::fsync(fd) == 0;
+	if (!ok) {
+		error = "write failed for " + path.string() + ": " + std::strerror(errno);
+	}
+	::close(fd);
+	return ok;
+}
+
+bool patch_durably(const std::filesystem::path &path, std::span<const std::uint8_t> data,
+				   std::span<const FileRange> ranges, std::string &error) {
+	const int fd = ::open(path.c_str(), O_WRONLY);
+	if (fd < 0) {
+		error = "cannot open " + path.string() + ": " + std::strerror(errno);
+		return false;
+	}
+	bool ok = true;
+	for (const FileRange &range : ranges) {
+		for (std::size_t offset = 0; ok && offset < range.size;) {
+			const std::size_t at = range.offset + offset;
+			const ssize_t written = ::pwrite(fd, data.data() + at, range.size - offset, static_cast<off_t>(at));
+			if (written < 0 && errno == EINTR) {
+				continue;
+			}
+			ok = written > 0;
+			offset += ok ? static_cast<std::size_t>(written) : 0;
+		}
+	}
+	ok = ok && ::fsync(fd) == 0;
+	if (!ok) {
+		error = "write failed for " + path.string() + ": " + std::strerror(errno);
+	}
+	::close(fd);
+	return ok;
+}
+
+// Make the rename itself durable, not just the file's contents
+void sync_directory(const std::filesystem::path &dir) {
+	const int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		::fsync(fd);
+		::close(fd);
+	}
+}
+
+#endif
+
+} // namespace
+
+AsyncFileWriter::AsyncFileWriter() : worker_([this] { run(); }) {
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+	{
+		std::lock_guard lock(mutex_);
+		stopping_ = true;
+	}
+	work_ready_.notify_one();
+	worker_.join();
+}
+
+std::future<FileWriteResult> AsyncFileWriter::write(std::filesystem::path path, std::vector<std::uint8_t> data) {
+	return queue(Job{std::move(path), std::move(data), {}, false, {}});
+}
+
+std::future<FileWriteResult> AsyncFileWriter::patch(std::filesystem::path path, std::vector<std::uint8_t> data,
+													std::vector<FileRange> ranges) {
+	return queue(Job{std::move(path), std::move(data), {}, true, std::move(ranges)});
+}
+
+std::future<FileWriteResult> AsyncFileWriter::queue(Job job) {
+	std::promise<FileWriteResult> promise;
+	std::future<FileWriteResult> future = promise.get_future();
+	{
+		std::lock_guard lock(mutex_);
+		const auto waiting =
+			std::find_if(queue_.begin(), queue_.end(), [&](const Job &queued) { return queued.path == job.path; });
+		if (waiting != queue_.end()) {
+			// The new bytes are the whole file: a patch only narrows what is
+			// written, and only if both are patches
+			waiting->data = std::move(job.data);
+			waiting->patch = waiting->patch && job.patch;
+			if (waiting->patch) {
+				waiting->ranges.insert(waiting->ranges.end(), job.ranges.begin(), job.ranges.end());
+			} else {
+				waiting->ranges.clear();
+			}
+			waiting->promises.push_back(std::move(promise));
+			return future;
+		}
+		job.promises.push_back(std::move(promise));
+		queue_.push_back(std::move(job));
+	}
+	work_ready_.notify_one();
+	return future;
+}
+
+void AsyncFileWriter::wait_idle() {
+	std::unique_lock lock(mutex_);
+	idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+bool AsyncFileWriter::is_idle() const {
+	std::lock_guard lock(mutex_);
+	return queue_.empty() && !busy_;
+}
+
+void AsyncFileWriter::run() {
+	std::unique_lock lock(mutex_);
+	while (true) {
+		work_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+		if (queue_.empty()) {
+			return; // Stopping, with everything written
+		}
+		Job job = std::move(queue_.front());
+		queue_.pop_front();
+		busy_ = true;
+		lock.unlock();
+
+		const FileWriteResult result =
+			job.patch ? patch_file(job.path, job.data, job.ranges) : write_file(job.path, job.data);
+		for (std::promise<FileWriteResult> &promise : job.promises) {
+			promise.set_value(result);
+		}
+
+		lock.lock();
+		busy_ = false;
+		if (queue_.empty()) {
+			idle_.notify_all();
+		}
+	}
+}
+
+FileWriteResult AsyncFileWriter::write_file(const std::filesystem::path &path, std::span<const std::uint8_t> data) {
+	FileWriteResult result;
+	std::error_code ec;
+	if (path.has_parent_path()) {
+		std::filesystem::create_directories(path.parent_path(), ec);
+		if (ec) {
+			result.error = "cannot create directory " + path.parent_path().string() + ": " + ec.message();
+			return result;
+		}
+	}
+
+	std::filesystem::path temp = path;
+	temp += ".tmp";
+	if (!write_durably(temp, data, result.error)) {
+		std::filesystem::remove(temp, ec);
+		return result;
+	}
+
+	std::filesystem::rename(temp, path, ec);
+	if (ec) {
+		// rename can fail across some filesystems; fall back to copy + remove
+		ec.clear();
+		std::filesystem::copy_file(temp, path, std::filesystem::copy_options::overwrite_existing, ec);
+		std::error_code remove_ec;
+		std::filesystem::remove(temp, remove_ec);
+		if (ec) {
+			result.error = "cannot replace " + path.string() + ": " + ec.message();
+			return result;
+		}
+	}
+	sync_directory(path.parent_path());
+	result.ok = true;
+	return result;
+}
+
+FileWriteResult AsyncFileWriter::patch_file(const std::filesystem::path &path, std::span<const std::uint8_t> data,
+											std::span<const FileRange> ranges) {
+	std::error_code ec;
+	if (std::filesystem::file_size(path, ec) != data.size() || ec) {
+		return write_file(path, data); // First save, or the RAM size changed
+	}
+	for (const FileRange &range : ranges) {
+		if (range.offset > data.size() || range.size > data.size() - range.offset) {
+			return {false, "patch range outside " + path.string()};
+		}
+	}
+	FileWriteResult result;
+	result.ok = patch_durably(path, data, ranges, result.error);
+	return result;
+}
+
+} // namespace nes
@@ -0,0 +1,86 @@
+#include "system/batch_runner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace nes {
+
+BatchRunner::BatchRunner(unsigned threads) : threads_(threads) {
+	if (threads_ == 0) {
+		threads_ = std::max(1u, std::thread::hardware_concurrency());
+	}
+}
+
+bool BatchRunner::pop_front(WorkQueue &queue, Job &job) {
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty()) {
+		return false;
+	}
+	job = std::move(queue.jobs.front());
+	queue.jobs.pop_front();
+	return true;
+}
+
+bool BatchRunner::pop_back(WorkQueue &queue, Job &job) {
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty()) {
+		return false;
+	}
+	job = std::move(queue.jobs.back());
+	queue.jobs.pop_back();
+	return true;
+}
+
+std::uint64_t BatchRunner::work(std::vector<std::unique_ptr<WorkQueue>> &queues, std::size_t self) {
+	std::uint64_t steals = 0;
+	Job job;
+	while (true) {
+		if (pop_front(*queues[self], job)) {
+			job();
+			continue;
+		}
+		// Own queue is dry: steal from the next worker that still has some.
+		// Jobs never add jobs, so once every queue is empty this worker is done
+		bool stolen = false;
+		for (std::size_t i = 1; i < queues.size() && !stolen; ++i) {
+			stolen = pop_back(*queues[(self + i) % queues.size()], job);
+		}
+		if (!stolen) {
+			return steals;
+		}
+		++steals;
+		job();
+	}
+}
+
+void BatchRunner::run(std::vector<Job> jobs) {
+	steals_ = 0;
+	const std::size_t workers = std::min<std::size_t>(threads_, jobs.size());
+	if (workers == 0) {
+		return;
+	}
+
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+	queues.reserve(workers);
+	for (std::size_t i = 0; i < workers; ++i) {
+		queues.push_back(std::make_unique<WorkQueue>());
+	}
+	for (std::size_t i = 0; i < jobs.size(); ++i) {
+		queues[i % workers]->jobs.push_back(std::move(jobs[i]));
+	}
+
+	// The calling thread is worker 0
+	std::atomic<std::uint64_t> steals{0};
+	std::vector<std::thread> threads;
+	threads.reserve(workers - 1);
+	for (std::size_t i = 1; i < workers; ++i) {
+		threads.emplace_back([&queues, &steals, i] { steals += work(queues, i); });
+	}
+	steals += work(queues, 0);
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	steals_ = steals.load();
+}
+
+} // namespace nes
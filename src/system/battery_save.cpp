@@ -1,8 +1,9 @@
 #include "system/battery_save.hpp"
 #include "cartridge/cartridge.hpp"
 #include "core/types.hpp"
-#include "core/user_paths.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <vector>
@@ -10,7 +11,13 @@
 namespace nes {
 
 BatterySaveManager::BatterySaveManager(Cartridge *cartridge) : cartridge_(cartridge) {
-	directory_ = get_battery_directory();
+	// Relative default keeps the core free of SDL path helpers; the GUI points
+	// this at the per-user battery directory via set_directory().
+	directory_ = std::filesystem::path("saves") / "battery";
+}
+
+BatterySaveManager::~BatterySaveManager() {
+	unmap();
 }
 
 void BatterySaveManager::set_directory(std::filesystem::path dir) {
@@ -18,28 +25,40 @@ void BatterySaveManager::set_directory(std::filesystem::path dir) {
 }
 
 std::filesystem::path BatterySaveManager::file_path_for_current_rom() const {
+	return companion_path(".sav");
+}
+
+std::filesystem::path BatterySaveManager::companion_path(const std::string &extension) const {
 	if (!cartridge_ || !cartridge_->is_loaded()) {
 		return {};
 	}
+	return path_for_rom(directory_, cartridge_->get_rom_filename(), extension);
+}
 
+std::filesystem::path BatterySaveManager::path_for_rom(const std::filesystem::path &directory,
+														const std::string &rom_filename, const std::string &extension) {
 	// Use only the ROM's leaf name (stem) so .sav paths are stable across
 	// machines and match the save-state slot naming convention.
-	std::filesystem::path rom_path(cartridge_->get_rom_filename());
-	std::string stem = rom_path.stem().string();
+	std::string stem = std::filesystem::path(rom_filename).stem().string();
 	if (stem.empty()) {
 		stem = "default";
 	}
-	return directory_ / (stem + ".sav");
+	return directory / (stem + extension);
 }
 
 void BatterySaveManager::load_for_current_rom() {
-	seconds_since_flush_ = 0.0;
+	seconds_dirty_ = 0.0;
+	restored_path_ = file_path_for_current_rom();
 
-	if (!cartridge_ || !cartridge_->is_loaded() || !cartridge_->has_battery_ram()) {
+	if (!cartridge_ || !cartridge_->is_loaded() || !cartridge_->has_battery_ram() || map_current_rom()) {
 		return;
 	}
 
-	const auto path = file_path_for_current_rom();
+	// The outgoing cartridge's last flush may still be on the writer
+	if (writer_) {
+		writer_->wait_idle();
+	}
+	const auto &path = restored_path_;
 	if (path.empty() || !std::filesystem::exists(path)) {
 		return; // No prior save — start with the mapper's fresh PRG-RAM.
 	}
@@ -62,80 +81,152 @@ void BatterySaveManager::load_for_current_rom() {
 		return;
 	}
 
-	cartridge_->load_battery_ram(data);
-	cartridge_->clear_battery_ram_dirty();
+	apply(std::move(data));
 }
 
-bool BatterySaveManager::flush(bool force) {
-	if (!cartridge_ || !cartridge_->is_loaded() || !cartridge_->has_battery_ram()) {
-		return false;
+void BatterySaveManager::restore(const std::optional<std::vector<Byte>> &data) {
+	const auto path = file_path_for_current_rom();
+	if (!path.empty() && path == restored_path_) {
+		load_for_current_rom(); // Reloaded: data may predate the swap's flush
+		return;
 	}
-	if (!force && !cartridge_->is_battery_ram_dirty()) {
-		return false;
+	seconds_dirty_ = 0.0;
+	restored_path_ = path;
+	if (map_current_rom()) {
+		return;
 	}
+	apply(data);
+}
 
-	const auto data = cartridge_->get_battery_ram();
-	if (data.empty()) {
-		return false;
+void BatterySaveManager::apply(const std::optional<std::vector<Byte>> &data) {
+	if (!data || !cartridge_ || !cartridge_->is_loaded() || !cartridge_->has_battery_ram()) {
+		return;
 	}
+	cartridge_->load_battery_ram(*data);
+	cartridge_->clear_battery_ram_dirty();
+}
 
+bool BatterySaveManager::map_current_rom() {
+	unmap();
+	if (!memory_mapped_ || !cartridge_ || !cartridge_->is_loaded() || !cartridge_->has_battery_ram()) {
+		return false;
+	}
 	const auto path = file_path_for_current_rom();
 	if (path.empty()) {
 		return false;
 	}
-
-	std::error_code ec;
-	std::filesystem::create_directories(path.parent_path(), ec);
-	if (ec) {
-		std::cerr << "Battery save: cannot create directory " << path.parent_path().string() << ": " << ec.message()
-				  << std::endl;
+	std::error_code error;
+	std::filesystem::create_directories(path.parent_path(), error);
+	const auto ram = cartridge_->get_battery_ram();
+	if (!mapped_file_.open(path, ram.size())) {
+		std::cerr << "Battery save: cannot map " << path.string() << ", saving by writes" << std::endl;
 		return false;
 	}
+	// Bytes the file did not have yet start as the RAM they stand for
+	const std::size_t known = mapped_file_.original_size();
+	std::copy(ram.begin() + static_cast<std::ptrdiff_t>(known), ram.end(), mapped_file_.bytes().begin() + known);
+	if (!cartridge_->map_battery_ram(mapped_file_.bytes())) {
+		mapped_file_.close();
+		if (known == 0) {
+			std::filesystem::remove(path, error); // Created for nothing
+		}
+		return false;
+	}
+	seconds_dirty_ = 0.0;
+	return true;
+}
+
+void BatterySaveManager::unmap() {
+	if (!mapped_file_.is_open()) {
+		return;
+	}
+	if (cartridge_) {
+		cartridge_->map_battery_ram({});
+	}
+	if (!mapped_file_.sync()) {
+		std::cerr << "Battery save: failed to sync the mapped save file" << std::endl;
+	}
+	mapped_file_.close();
+}
 
-	// Write to a temp file then rename so a crash mid-write can't corrupt an
-	// existing good save.
-	const auto tmp_path = path.string() + ".tmp";
-	{
-		std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
-		if (!file.is_open()) {
-			std::cerr << "Battery save: cannot write " << tmp_path << std::endl;
+bool BatterySaveManager::flush(bool force) {
+	if (mapped_file_.is_open()) {
+		if (!force) {
 			return false;
 		}
-		file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
-		if (!file) {
-			std::cerr << "Battery save: write failed for " << tmp_path << std::endl;
+		unmap();
+		return true;
+	}
+	if (!cartridge_ || !cartridge_->is_loaded() || !cartridge_->has_battery_ram()) {
+		return false;
+	}
+	// Unforced, only the pages written since the last flush go to disk
+	std::vector<FileRange> ranges;
+	if (!force) {
+		for (const Mapper::RamRange &range : cartridge_->battery_ram_dirty_ranges()) {
+			ranges.push_back({range.offset, range.size});
+		}
+		if (ranges.empty()) {
 			return false;
 		}
 	}
 
-	std::filesystem::rename(tmp_path, path, ec);
-	if (ec) {
-		// rename can fail across some filesystems; fall back to copy + remove.
-		ec.clear();
-		std::filesystem::copy_file(tmp_path, path, std::filesystem::copy_options::overwrite_existing, ec);
-		std::error_code remove_ec;
-		std::filesystem::remove(tmp_path, remove_ec);
-		if (ec) {
-			std::cerr << "Battery save: failed to finalize " << path.string() << ": " << ec.message() << std::endl;
+	const auto data = cartridge_->get_battery_ram();
+	if (data.empty()) {
+		return false;
+	}
+
+	const auto path = file_path_for_current_rom();
+	if (path.empty()) {
+		return false;
+	}
+
+	// Copied out now; the file may be written later, on the writer's thread
+	if (writer_) {
+		std::vector<Byte> copy(data.begin(), data.end());
+		pending_write_ = force ? writer_->write(path, std::move(copy)) : writer_->patch(path, std::move(copy), ranges);
+	} else {
+		const FileWriteResult result =
+			force ? AsyncFileWriter::write_file(path, data) : AsyncFileWriter::patch_file(path, data, ranges);
+		if (!result.ok) {
+			std::cerr << "Battery save: " << result.error << std::endl;
 			return false;
 		}
 	}
 
 	cartridge_->clear_battery_ram_dirty();
-	seconds_since_flush_ = 0.0;
+	seconds_dirty_ = 0.0;
 	return true;
 }
 
 void BatterySaveManager::update(double delta_seconds) {
-	// Periodic crash-safety flush: mirror the cartridge SRAM to the .sav at most
-	// every kFlushIntervalSeconds, and only when it actually changed. The save's
-	// authoritative persistence still happens via flush() on reset/unload/exit.
-	if (delta_seconds > 0.0) {
-		seconds_since_flush_ += delta_seconds;
-	}
-	if (seconds_since_flush_ >= kFlushIntervalSeconds) {
-		seconds_since_flush_ = 0.0;
-		flush(false);
+	// Crash-safety flush: once the game has left save RAM alone for
+	// kQuietSeconds, so a save that writes a few bytes a frame for a while
+	// lands as one write, or after kFlushIntervalSeconds of changes if it
+	// never stops. The save's authoritative persistence still happens via
+	// flush() on reset/unload/exit.
+	const double delta = delta_seconds > 0.0 ? delta_seconds : 0.0;
+	if (pending_write_.valid() && pending_write_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		const FileWriteResult result = pending_write_.get();
+		if (!result.ok) {
+			std::cerr << "Battery save: " << result.error << std::endl;
+			retry_ = true;
+		}
+	}
+	if (!cartridge_ || !cartridge_->has_battery_ram() || mapped_file_.is_open()) {
+		return;
+	}
+
+	quiet_seconds_ = cartridge_->battery_ram_written_since(activity_mark_) ? 0.0 : quiet_seconds_ + delta;
+	if (!retry_ && !cartridge_->is_battery_ram_dirty()) {
+		seconds_dirty_ = 0.0;
+		return;
+	}
+	seconds_dirty_ += delta;
+	if (quiet_seconds_ >= kQuietSeconds || seconds_dirty_ >= kFlushIntervalSeconds) {
+		// A failed write may have left the file anything: rewrite it whole
+		flush(retry_);
+		retry_ = false;
 	}
 }
 
@@ -0,0 +1,500 @@
+#include "system/emulation_thread.hpp"
+#include "core/bus.hpp"
+#include "core/trace_zones.hpp"
+#include "cpu/cpu_6502.hpp"
+#include "input/latched_input.hpp"
+#include "ppu/ppu.hpp"
+#include "system/perf_counters.hpp"
+#include "system/rewind_buffer.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace nes {
+
+namespace {
+constexpr double FRAME_SECONDS = EmulationThread::CPU_CYCLES_PER_FRAME / static_cast<double>(CPU_CLOCK_NTSC);
+// After a stall longer than this (debugger handshake, host hiccup) restart the
+// schedule from now instead of racing through the backlog
+constexpr int MAX_LAG_FRAMES = 3;
+
+// One frame of the loaded ROM's region; NTSC's odd-frame skip makes its
+// frames half a dot short on average
+double frame_seconds(const SystemBus &bus) {
+	const RegionTiming &timing = region_timing(bus.get_region());
+	return timing.odd_frame_skip ? FRAME_SECONDS : 1.0 / timing.frames_per_second();
+}
+} // namespace
+
+EmulationThread::EmulationThread(CPU6502 &cpu, PPU &ppu, SystemBus &bus, std::shared_ptr<LatchedInputSource> input)
+	: cpu_(cpu), ppu_(ppu), bus_(bus), input_(std::move(input)) {
+}
+
+EmulationThread::~EmulationThread() {
+	stop();
+}
+
+void EmulationThread::set_snapshot_callback(std::function<void(std::vector<std::uint8_t> &)> callback) {
+	snapshot_callback_ = std::move(callback);
+}
+
+void EmulationThread::set_state_callbacks(std::function<void(StateSnapshot &)> capture,
+										   std::function<void(const StateSnapshot &)> restore) {
+	state_capture_ = std::move(capture);
+	state_restore_ = std::move(restore);
+}
+
+void EmulationThread::set_frame_callback(std::function<void()> callback) {
+	frame_callback_ = std::move(callback);
+}
+
+void EmulationThread::start() {
+	if (thread_.joinable()) {
+		return;
+	}
+	quit_.store(false, std::memory_order_release);
+	thread_ = std::thread([this] { thread_main(); });
+}
+
+void EmulationThread::stop() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		quit_.store(true, std::memory_order_release);
+	}
+	cv_.notify_all();
+	thread_.join();
+
+	// Drop commands nobody will apply and leave the thread state as a fresh start
+	std::array<Command, 16> discard;
+	while (commands_.pop(discard) != 0) {
+	}
+	paused_ = true;
+	idle_ = false;
+}
+
+void EmulationThread::run() {
+	post({Command::Type::Run});
+}
+
+void EmulationThread::pause() {
+	post({Command::Type::Pause});
+}
+
+void EmulationThread::set_speed(float multiplier) {
+	post({Command::Type::SetSpeed, 0, 0, multiplier});
+}
+
+void EmulationThread::set_fast_forward(bool enabled) {
+	post({Command::Type::SetFastForward, 0, 0, enabled ? 1.0f : 0.0f});
+}
+
+void EmulationThread::set_buttons(int player_index, Byte buttons) {
+	post({Command::Type::SetButtons, static_cast<std::uint8_t>(player_index), buttons});
+}
+
+void EmulationThread::set_run_ahead(int frames) {
+	post({Command::Type::SetRunAhead, 0, 0, static_cast<float>(frames)});
+}
+
+void EmulationThread::set_rewinding(bool enabled) {
+	post({Command::Type::SetRewinding, 0, 0, enabled ? 1.0f : 0.0f});
+}
+
+void EmulationThread::set_pacing(Pacing pacing) {
+	post({Command::Type::SetPacing, 0, 0, static_cast<float>(pacing)});
+}
+
+void EmulationThread::request_frame() {
+	post({Command::Type::RequestFrame});
+}
+
+bool EmulationThread::wait_for_frames(std::uint64_t count, Clock::time_point deadline) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	return cv_.wait_until(lock, deadline, [&] { return frames_emulated_.load(std::memory_order_acquire) >= count; });
+}
+
+void EmulationThread::post(const Command &command) {
+	// The queue only fills if the thread stops draining it for ~256 posts;
+	// dropping then is preferable to blocking the front end
+	if (commands_.push(std::span<const Command>(&command, 1)) == 0) {
+		std::cerr << "EmulationThread: command queue full, dropping command" << std::endl;
+		return;
+	}
+	// Taking the lock orders the push against the sleeper's predicate check, so
+	// the wakeup cannot be lost
+	{ std::lock_guard<std::mutex> lock(mutex_); }
+	cv_.notify_all();
+}
+
+void EmulationThread::exclusive(const std::function<void()> &fn) {
+	if (!thread_.joinable() || std::this_thread::get_id() == thread_.get_id()) {
+		fn();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		exclusive_pending_.fetch_add(1, std::memory_order_acq_rel);
+		cv_.notify_all();
+		cv_.wait(lock, [this] { return parked_; });
+	}
+
+	// Release the thread even if fn throws
+	struct Release {
+		EmulationThread &self;
+		~Release() {
+			{
+				std::lock_guard<std::mutex> lock(self.mutex_);
+				self.exclusive_pending_.fetch_sub(1, std::memory_order_acq_rel);
+			}
+			self.cv_.notify_all();
+		}
+	} release{*this};
+	fn();
+}
+
+bool EmulationThread::is_idle() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return idle_ && commands_.size() == 0 && exclusive_pending_.load(std::memory_order_acquire) == 0;
+}
+
+bool EmulationThread::wake_pending() const {
+	return commands_.size() != 0 || exclusive_pending_.load(std::memory_order_acquire) != 0 ||
+		   quit_.load(std::memory_order_acquire);
+}
+
+void EmulationThread::drain_commands() {
+	std::array<Command, 16> batch;
+	std::size_t count;
+	while ((count = commands_.pop(batch)) != 0) {
+		for (std::size_t i = 0; i < count; ++i) {
+			const Command &command = batch[i];
+			switch (command.type) {
+			case Command::Type::Run:
+				paused_ = false;
+				break;
+			case Command::Type::Pause:
+				paused_ = true;
+				frame_requests_ = 0;
+				break;
+			case Command::Type::SetSpeed:
+				speed_ = std::clamp(command.value, 0.05f, 16.0f);
+				break;
+			case Command::Type::SetFastForward:
+				fast_forward_ = command.value != 0.0f;
+				break;
+			case Command::Type::SetButtons:
+				if (input_) {
+					input_->set_buttons(command.player, command.buttons);
+				}
+				break;
+			case Command::Type::SetRunAhead:
+				run_ahead_ = std::clamp(static_cast<int>(command.value), 0, MAX_RUN_AHEAD_FRAMES);
+				break;
+			case Command::Type::SetRewinding:
+				rewinding_ = command.value != 0.0f;
+				break;
+			case Command::Type::SetPacing:
+				pacing_ = static_cast<Pacing>(static_cast<int>(command.value));
+				frame_requests_ = 0;
+				// Only the audio device keeps the resampler at its nominal ratio
+				bus_.set_audio_rate_control(pacing_ != Pacing::Audio);
+				break;
+			case Command::Type::RequestFrame:
+				frame_requests_ = std::min(frame_requests_ + 1, MAX_LAG_FRAMES);
+				break;
+			}
+		}
+	}
+}
+
+void EmulationThread::park() {
+	// Whoever runs while we're parked sees fully caught-up components
+	bus_.sync_ppu();
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	parked_ = true;
+	cv_.notify_all();
+	cv_.wait(lock, [this] { return exclusive_pending_.load(std::memory_order_acquire) == 0; });
+	parked_ = false;
+}
+
+void EmulationThread::sleep_until(Clock::time_point deadline) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (!quit_.load(std::memory_order_acquire) && Clock::now() < deadline) {
+		if (wake_pending()) {
+			lock.unlock();
+			drain_commands();
+			if (exclusive_pending_.load(std::memory_order_acquire) != 0) {
+				park();
+			}
+			if (paused_ || fast_forward_) {
+				return;
+			}
+			lock.lock();
+			continue;
+		}
+		cv_.wait_until(lock, deadline);
+	}
+}
+
+void EmulationThread::thread_main() {
+	TraceZones::set_thread_name("Emulation");
+	auto next_frame = Clock::now();
+
+	while (!quit_.load(std::memory_order_acquire)) {
+		drain_commands();
+		if (exclusive_pending_.load(std::memory_order_acquire) != 0) {
+			park();
+			continue;
+		}
+
+		if (paused_) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			idle_ = true;
+			cv_.wait(lock, [this] { return wake_pending(); });
+			idle_ = false;
+			next_frame = Clock::now();
+			continue;
+		}
+
+		if (pacing_ == Pacing::Host && !fast_forward_) {
+			if (frame_requests_ == 0) {
+				std::unique_lock<std::mutex> lock(mutex_);
+				cv_.wait(lock, [this] { return wake_pending(); });
+				continue;
+			}
+			--frame_requests_;
+		}
+
+		const auto frame_start = Clock::now();
+		frame_started_at_ = frame_start;
+		const std::uint64_t frame_start_cycles = cpu_.get_cycle_count();
+		if (perf_counters_) {
+			const bool breakdown = perf_counters_->is_component_breakdown();
+			if (bus_.is_cycle_profiling() != breakdown) {
+				bus_.set_cycle_profiling(breakdown);
+			}
+			bus_.reset_cycle_profile();
+		}
+
+		if (rewinding_ && rewind_buffer_ && state_restore_) {
+			rewind_step();
+		} else {
+			const FrameResult frame = run_frame();
+			if (frame == FrameResult::Breakpoint) {
+				paused_ = true;
+				breakpoint_hit_.store(true, std::memory_order_release);
+				continue;
+			}
+			if (frame == FrameResult::Fault) {
+				std::cerr << "EmulationThread: frame did not complete, pausing. PC=0x" << std::hex
+						  << cpu_.get_program_counter() << std::dec << std::endl;
+				paused_ = true;
+				fault_.store(true, std::memory_order_release);
+				continue;
+			}
+			const bool ran_ahead = run_ahead_ > 0 && !fast_forward_ && state_capture_ && state_restore_;
+			if (ran_ahead) {
+				run_ahead();
+			} else {
+				publish_pixels();
+			}
+			if (rewind_buffer_ && state_capture_) {
+				// Running ahead already captured the real state
+				if (!ran_ahead) {
+					state_capture_(rewind_state_);
+				}
+				rewind_buffer_->push(ran_ahead ? run_ahead_state_ : rewind_state_);
+			}
+			finish_frame();
+		}
+		if (perf_counters_) {
+			report_frame(frame_start, frame_start_cycles);
+		}
+
+		if (fast_forward_ || pacing_ == Pacing::Host) {
+			next_frame = Clock::now();
+			continue;
+		}
+
+		const auto period =
+			std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(frame_seconds(bus_) / speed_));
+		if (audio_paced()) {
+			wait_for_audio_demand(period);
+			next_frame = Clock::now();
+			continue;
+		}
+		next_frame += period;
+		const auto now = Clock::now();
+		if (now - next_frame > period * MAX_LAG_FRAMES) {
+			next_frame = now;
+		}
+		sleep_until(next_frame);
+	}
+}
+
+bool EmulationThread::audio_paced() const {
+	if (pacing_ != Pacing::Audio || speed_ != 1.0f || rewinding_) {
+		return false;
+	}
+	const AudioOutput *output = bus_.get_audio_output();
+	return output && output->is_playing() && output->get_sample_rate() > 0;
+}
+
+void EmulationThread::wait_for_audio_demand(Clock::duration period) {
+	// Sleep for as long as the queued samples above the target take to
+	// play out, then look again. A device that stops pulling gets a frame
+	// per MAX_LAG_FRAMES periods, so video keeps moving while it recovers.
+	const AudioOutput &output = *bus_.get_audio_output();
+	const auto give_up = Clock::now() + period * MAX_LAG_FRAMES;
+	while (!quit_.load(std::memory_order_acquire) && Clock::now() < give_up) {
+		const std::size_t fill = output.get_buffer_size();
+		const std::size_t target = output.get_target_buffer_size();
+		if (fill < target) {
+			return;
+		}
+		const auto drain = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(static_cast<double>(fill - target + 1) / output.get_sample_rate()));
+		sleep_until(std::min(Clock::now() + std::max(drain, Clock::duration(std::chrono::milliseconds(1))), give_up));
+		// A command may have paused, fast-forwarded or switched pacing
+		if (paused_ || fast_forward_ || !audio_paced() || exclusive_pending_.load(std::memory_order_acquire) != 0) {
+			return;
+		}
+	}
+}
+
+EmulationThread::FrameResult EmulationThread::run_frame(bool speculative) {
+	VIBENES_TRACE_ZONE("EmulationThread::run_frame");
+	std::uint64_t executed = 0;
+
+	while (true) {
+		if (exclusive_pending_.load(std::memory_order_relaxed) != 0) {
+			if (speculative) {
+				return FrameResult::Interrupted;
+			}
+			park();
+			continue;
+		}
+		const std::uint64_t budget = std::min(EXCLUSIVE_POLL_CYCLES, MAX_FRAME_CYCLES - executed);
+		CPU6502::RunResult result;
+		{
+			VIBENES_TRACE_ZONE("CPU6502::run_frame slice");
+			result = cpu_.run_frame(budget);
+		}
+		executed += result.cycles;
+		switch (result.stop) {
+		case CPU6502::RunStop::FrameReady:
+			bus_.sync_ppu();
+			return FrameResult::Completed;
+		case CPU6502::RunStop::Breakpoint:
+		case CPU6502::RunStop::Watchpoint:
+			bus_.sync_ppu();
+			return FrameResult::Breakpoint;
+		case CPU6502::RunStop::Halted:
+			bus_.sync_ppu();
+			return FrameResult::Fault;
+		case CPU6502::RunStop::Target:
+			if (executed >= MAX_FRAME_CYCLES) {
+				bus_.sync_ppu();
+				return FrameResult::Fault;
+			}
+			break;
+		}
+	}
+}
+
+void EmulationThread::run_ahead() {
+	VIBENES_TRACE_ZONE("EmulationThread::run_ahead");
+	state_capture_(run_ahead_state_);
+	bus_.set_audio_gated(true);
+
+	// A breakpoint or fault ahead is left for the real timeline to reach, and
+	// exclusive() callers must only ever see real state: in all those cases
+	// the frame is not shown and the previous one stays up
+	bool completed = true;
+	for (int i = 0; i < run_ahead_ && completed; ++i) {
+		completed = run_frame(true) == FrameResult::Completed;
+	}
+	if (completed) {
+		publish_pixels();
+	}
+
+	state_restore_(run_ahead_state_);
+	bus_.set_audio_gated(false);
+}
+
+void EmulationThread::rewind_step() {
+	VIBENES_TRACE_ZONE("EmulationThread::rewind_step");
+	if (!rewind_buffer_->pop(rewind_state_)) {
+		return; // Back at the oldest frame kept: hold it
+	}
+	state_restore_(rewind_state_);
+
+	// Emulating the frame after the snapshot is what draws it; the state is
+	// put back afterwards so the next step (or resuming) starts from the
+	// snapshot itself
+	bus_.set_audio_gated(true);
+	const FrameResult frame = run_frame(true);
+	if (frame == FrameResult::Completed) {
+		publish_pixels();
+	} else if (frame == FrameResult::Interrupted) {
+		rewind_buffer_->push(rewind_state_); // Not shown yet: step to it again
+	}
+	state_restore_(rewind_state_);
+	bus_.set_audio_gated(false);
+}
+
+void EmulationThread::publish_pixels() {
+	VIBENES_TRACE_ZONE("EmulationThread::publish_pixels");
+	const std::uint32_t *pixels = ppu_.get_frame_buffer();
+	if (pixels) {
+		Frame &frame = frames_.write_buffer();
+		std::copy_n(pixels, frame.pixels.size(), frame.pixels.begin());
+		std::copy_n(ppu_.get_index_buffer(), frame.indices.size(), frame.indices.begin());
+		frame.started_at = frame_started_at_;
+		frame.completed_at = Clock::now();
+		frames_.publish();
+	}
+}
+
+void EmulationThread::report_frame(Clock::time_point start, std::uint64_t start_cycles) {
+	PerfCounters::FrameReport report;
+	report.emulation_ns =
+		static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+	// A rewind restores an older state, so its cycle count can go backwards
+	const std::uint64_t cycles = cpu_.get_cycle_count();
+	report.cpu_cycles = cycles > start_cycles ? cycles - start_cycles : 0;
+	if (const AudioOutput *output = bus_.get_audio_output(); output && output->get_sample_rate() > 0) {
+		report.audio_queue_ms = static_cast<double>(output->get_buffer_size()) * 1000.0 / output->get_sample_rate();
+	}
+	if (bus_.is_cycle_profiling()) {
+		const CycleProfile &profile = bus_.get_cycle_profile();
+		report.components = true;
+		report.ppu_ns = profile.ppu_ns;
+		report.apu_ns = profile.apu_ns;
+		report.mapper_ns = profile.cartridge_ns;
+	}
+	perf_counters_->record_frame(report);
+}
+
+void EmulationThread::finish_frame() {
+	if (snapshot_callback_ && snapshot_requested_.exchange(false, std::memory_order_acq_rel)) {
+		snapshot_callback_(snapshots_.write_buffer());
+		snapshots_.publish();
+	}
+
+	{
+		// Under the lock, so a wait_for_frames() sleeper cannot miss it
+		std::lock_guard<std::mutex> lock(mutex_);
+		frames_emulated_.fetch_add(1, std::memory_order_release);
+	}
+	cv_.notify_all();
+	if (frame_callback_) {
+		frame_callback_();
+	}
+}
+
+} // namespace nes
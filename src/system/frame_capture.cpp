@@ -0,0 +1,176 @@
+#include "system/frame_capture.hpp"
+#include "system/frame_dump.hpp"
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <iostream>
+
+#ifdef _WIN32
+#define VIBENES_POPEN _popen
+#define VIBENES_PCLOSE _pclose
+#define VIBENES_PIPE_MODE "wb"
+#else
+#define VIBENES_POPEN popen
+#define VIBENES_PCLOSE pclose
+#define VIBENES_PIPE_MODE "w"
+#endif
+
+namespace nes {
+
+FrameCapture::~FrameCapture() {
+	close();
+}
+
+std::filesystem::path FrameCapture::sequence_path(const std::filesystem::path &dir, std::uint64_t frame) {
+	return dir / std::format("frame_{:06}.png", frame);
+}
+
+bool FrameCapture::open(const std::filesystem::path &path, Format format, const Options &options) {
+	close();
+	format_ = format;
+	if (format == Format::PngSequence) {
+		std::error_code ec;
+		std::filesystem::create_directories(path, ec);
+		if (ec) {
+			std::cerr << "FrameCapture: cannot create " << path << ": " << ec.message() << "\n";
+			return false;
+		}
+		directory_ = path;
+		unsigned workers = options.workers != 0 ? options.workers : std::thread::hardware_concurrency();
+		return start(options, std::max(workers, 1u));
+	}
+	file_.open(path, std::ios::binary | std::ios::trunc);
+	if (!file_) {
+		std::cerr << "FrameCapture: cannot create " << path << "\n";
+		return false;
+	}
+	return start(options, 1);
+}
+
+bool FrameCapture::open_pipe(const std::string &command, const Options &options) {
+	close();
+	format_ = Format::RawVideo;
+	pipe_ = VIBENES_POPEN(command.c_str(), VIBENES_PIPE_MODE);
+	if (!pipe_) {
+		std::cerr << "FrameCapture: cannot start " << command << "\n";
+		return false;
+	}
+	return start(options, 1);
+}
+
+bool FrameCapture::start(const Options &options, unsigned workers) {
+	when_full_ = options.when_full;
+	const std::size_t pool_frames = std::max<std::size_t>(options.pool_frames, 1);
+	pool_.clear();
+	free_buffers_.clear();
+	for (std::size_t i = 0; i < pool_frames; ++i) {
+		pool_.push_back(std::make_unique<Pixels>());
+		free_buffers_.push_back(i);
+	}
+	queue_.clear();
+	stopping_ = false;
+	failed_ = false;
+	submitted_ = 0;
+	written_.store(0, std::memory_order_relaxed);
+	dropped_.store(0, std::memory_order_relaxed);
+	for (unsigned i = 0; i < workers; ++i) {
+		workers_.emplace_back([this] { run(); });
+	}
+	return true;
+}
+
+bool FrameCapture::close() {
+	if (workers_.empty()) {
+		return true;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	work_ready_.notify_all();
+	for (std::thread &worker : workers_) {
+		worker.join();
+	}
+	workers_.clear();
+
+	bool ok = !failed_;
+	if (file_.is_open()) {
+		file_.close();
+		ok = ok && !file_.fail();
+	}
+	if (pipe_) {
+		ok = VIBENES_PCLOSE(pipe_) == 0 && ok;
+		pipe_ = nullptr;
+	}
+	pool_.clear();
+	return ok;
+}
+
+bool FrameCapture::submit(const std::uint32_t *pixels) {
+	if (workers_.empty()) {
+		return false;
+	}
+	std::size_t buffer = 0;
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (free_buffers_.empty()) {
+			if (when_full_ == WhenFull::Drop) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			buffer_free_.wait(lock, [this] { return !free_buffers_.empty(); });
+		}
+		buffer = free_buffers_.back();
+		free_buffers_.pop_back();
+	}
+	// The buffer is ours until queued; copy outside the lock
+	std::memcpy(pool_[buffer]->data(), pixels, sizeof(Pixels));
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		queue_.push_back(Job{submitted_++, buffer});
+	}
+	work_ready_.notify_one();
+	return true;
+}
+
+void FrameCapture::run() {
+	std::vector<std::uint8_t> scratch;
+	for (;;) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			work_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+			if (queue_.empty()) {
+				return; // Stopping, and everything queued is written
+			}
+			job = queue_.front();
+			queue_.pop_front();
+		}
+		const bool ok = encode(job, scratch);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			free_buffers_.push_back(job.buffer);
+			failed_ = failed_ || !ok;
+		}
+		buffer_free_.notify_one();
+		if (ok) {
+			written_.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+bool FrameCapture::encode(const Job &job, std::vector<std::uint8_t> &scratch) {
+	const std::uint32_t *pixels = pool_[job.buffer]->data();
+	if (format_ == Format::PngSequence) {
+		return write_frame_png(sequence_path(directory_, job.frame).string(), pixels);
+	}
+	scratch.resize(static_cast<std::size_t>(FRAME_WIDTH) * FRAME_HEIGHT * 3);
+	pack_frame_rgb(pixels, scratch.data());
+	if (pipe_) {
+		return std::fwrite(scratch.data(), 1, scratch.size(), pipe_) == scratch.size();
+	}
+	file_.write(reinterpret_cast<const char *>(scratch.data()), static_cast<std::streamsize>(scratch.size()));
+	return static_cast<bool>(file_);
+}
+
+} // namespace nes
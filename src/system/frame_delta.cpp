@@ -0,0 +1,178 @@
+#include "system/frame_delta.hpp"
+#include "core/lz4_block.hpp"
+#include <bit>
+#include <cstring>
+
+namespace nes {
+
+namespace {
+
+using Encoder = FrameDeltaEncoder;
+
+void put_u32(std::uint8_t *out, std::uint32_t value) {
+	std::memcpy(out, &value, sizeof(value));
+}
+
+std::uint32_t get_u32(const std::uint8_t *in) {
+	std::uint32_t value;
+	std::memcpy(&value, in, sizeof(value));
+	return value;
+}
+
+template <typename Pixel> Pixel *tile_origin(Pixel *frame, int tile) {
+	return frame + static_cast<std::size_t>(tile / Encoder::TILES_X) * Encoder::TILE_SIZE * Encoder::WIDTH +
+		   static_cast<std::size_t>(tile % Encoder::TILES_X) * Encoder::TILE_SIZE;
+}
+
+} // namespace
+
+bool FrameDeltaEncoder::encode(std::uint32_t number, const std::uint16_t *frame, std::uint32_t acked,
+							   std::vector<std::uint8_t> &out) {
+	const Held *base = nullptr;
+	if (acked != NO_FRAME) {
+		for (const Held &held : history_) {
+			if (held.number == acked) {
+				base = &held;
+				break;
+			}
+		}
+	}
+
+	// Tiles that differ from the base, compared a scanline (one row of 32 tiles) at a time
+	raw_.resize(MAX_RAW_BYTES);
+	std::uint8_t *bitmap = raw_.data();
+	std::memset(bitmap, 0, BITMAP_BYTES);
+	if (base) {
+		const std::uint16_t *old_pixels = base->pixels.data();
+		for (int y = 0; y < HEIGHT; ++y) {
+			const std::size_t row = static_cast<std::size_t>(y) * WIDTH;
+			const int tile_row = (y / TILE_SIZE) * TILES_X;
+			for (int tx = 0; tx < TILES_X; ++tx) {
+				const std::size_t at = row + static_cast<std::size_t>(tx) * TILE_SIZE;
+				if (std::memcmp(frame + at, old_pixels + at, TILE_SIZE * sizeof(std::uint16_t)) != 0) {
+					const int tile = tile_row + tx;
+					bitmap[tile / 8] |= static_cast<std::uint8_t>(1u << (tile % 8));
+				}
+			}
+		}
+	} else {
+		std::memset(bitmap, 0xFF, BITMAP_BYTES);
+	}
+
+	std::size_t sent = 0;
+	for (std::size_t i = 0; i < BITMAP_BYTES; ++i) {
+		sent += static_cast<std::size_t>(std::popcount(bitmap[i]));
+	}
+	std::uint8_t *low = raw_.data() + BITMAP_BYTES;
+	std::uint8_t *high = low + sent * TILE_SIZE * TILE_SIZE;
+	for (int tile = 0; tile < TILE_COUNT; ++tile) {
+		if (!(bitmap[tile / 8] & (1u << (tile % 8)))) {
+			continue;
+		}
+		const std::uint16_t *pixels = tile_origin(frame, tile);
+		for (int y = 0; y < TILE_SIZE; ++y, pixels += WIDTH) {
+			std::uint8_t bit8 = 0;
+			for (int x = 0; x < TILE_SIZE; ++x) {
+				*low++ = static_cast<std::uint8_t>(pixels[x]);
+				bit8 = static_cast<std::uint8_t>((bit8 << 1) | ((pixels[x] >> 8) & 1));
+			}
+			*high++ = bit8;
+		}
+	}
+	const std::size_t raw_size = BITMAP_BYTES + sent * TILE_BYTES;
+
+	out.resize(HEADER_BYTES);
+	put_u32(out.data(), base ? acked : NO_FRAME);
+	put_u32(out.data() + 4, static_cast<std::uint32_t>(raw_size));
+	out.reserve(HEADER_BYTES + lz4_compress_bound(raw_size));
+	lz4_compress(raw_.data(), raw_size, out);
+
+	Held &slot = history_[next_];
+	next_ = (next_ + 1) % HISTORY;
+	slot.number = number;
+	slot.pixels.assign(frame, frame + PIXELS);
+	return base == nullptr;
+}
+
+void FrameDeltaEncoder::reset() noexcept {
+	for (Held &held : history_) {
+		held.number = NO_FRAME;
+	}
+}
+
+bool FrameDeltaDecoder::decode(std::uint32_t number, const std::uint8_t *data, std::size_t size) {
+	if (number == Encoder::NO_FRAME || (latest_ != Encoder::NO_FRAME && number <= latest_) ||
+		size < Encoder::HEADER_BYTES) {
+		return false;
+	}
+	const std::uint32_t base_number = get_u32(data);
+	const std::uint32_t raw_size = get_u32(data + 4);
+	if (raw_size < Encoder::BITMAP_BYTES || raw_size > Encoder::MAX_RAW_BYTES) {
+		return false;
+	}
+	raw_.resize(raw_size);
+	if (!lz4_decompress(data + Encoder::HEADER_BYTES, size - Encoder::HEADER_BYTES, raw_.data(), raw_size)) {
+		return false;
+	}
+	const std::uint8_t *bitmap = raw_.data();
+	std::size_t sent = 0;
+	for (std::size_t i = 0; i < Encoder::BITMAP_BYTES; ++i) {
+		sent += static_cast<std::size_t>(std::popcount(bitmap[i]));
+	}
+	if (raw_size != Encoder::BITMAP_BYTES + sent * Encoder::TILE_BYTES) {
+		return false;
+	}
+
+	const Held *base = nullptr;
+	if (base_number == Encoder::NO_FRAME) {
+		if (sent != static_cast<std::size_t>(Encoder::TILE_COUNT)) {
+			return false;
+		}
+	} else {
+		for (const Held &held : history_) {
+			if (held.number == base_number) {
+				base = &held;
+				break;
+			}
+		}
+		if (!base) {
+			return false;
+		}
+	}
+
+	Held &slot = history_[next_];
+	if (base && base != &slot) {
+		slot.pixels = base->pixels;
+	} else {
+		slot.pixels.resize(Encoder::PIXELS);
+	}
+	const std::uint8_t *low = bitmap + Encoder::BITMAP_BYTES;
+	const std::uint8_t *high = low + sent * Encoder::TILE_SIZE * Encoder::TILE_SIZE;
+	for (int tile = 0; tile < Encoder::TILE_COUNT; ++tile) {
+		if (!(bitmap[tile / 8] & (1u << (tile % 8)))) {
+			continue;
+		}
+		std::uint16_t *pixels = tile_origin(slot.pixels.data(), tile);
+		for (int y = 0; y < Encoder::TILE_SIZE; ++y, pixels += Encoder::WIDTH) {
+			const std::uint8_t bit8 = *high++;
+			for (int x = 0; x < Encoder::TILE_SIZE; ++x) {
+				pixels[x] = static_cast<std::uint16_t>(*low++ | (((bit8 >> (7 - x)) & 1) << 8));
+			}
+		}
+	}
+
+	slot.number = number;
+	latest_slot_ = next_;
+	next_ = (next_ + 1) % Encoder::HISTORY;
+	latest_ = number;
+	return true;
+}
+
+void FrameDeltaDecoder::reset() noexcept {
+	for (Held &held : history_) {
+		held.number = FrameDeltaEncoder::NO_FRAME;
+	}
+	latest_ = FrameDeltaEncoder::NO_FRAME;
+}
+
+} // namespace nes
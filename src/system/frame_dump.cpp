@@ -0,0 +1,330 @@
+#include "system/frame_dump.hpp"
+#include "core/checksum.hpp"
+#include "ppu/ppu.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+namespace nes {
+
+namespace {
+
+constexpr int FRAME_WIDTH = 256;
+constexpr int FRAME_HEIGHT = 240;
+
+// ---------------------------------------------------------------------------
+// Deflate (RFC 1951) with the fixed Huffman codes, inside a zlib stream
+// ---------------------------------------------------------------------------
+
+class BitWriter {
+  public:
+	explicit BitWriter(std::vector<std::uint8_t> &out) : out_(out) {
+	}
+
+	// LSB first, as deflate packs everything but Huffman codes
+	void put(std::uint32_t value, int bits) {
+		bit_buffer_ |= static_cast<std::uint64_t>(value) << bit_count_;
+		bit_count_ += bits;
+		while (bit_count_ >= 8) {
+			out_.push_back(static_cast<std::uint8_t>(bit_buffer_));
+			bit_buffer_ >>= 8;
+			bit_count_ -= 8;
+		}
+	}
+	// Huffman codes go MSB first
+	void put_code(std::uint32_t code, int bits) {
+		std::uint32_t reversed = 0;
+		for (int i = 0; i < bits; ++i) {
+			reversed = (reversed << 1) | ((code >> i) & 1);
+		}
+		put(reversed, bits);
+	}
+	void flush() {
+		if (bit_count_ > 0) {
+			out_.push_back(static_cast<std::uint8_t>(bit_buffer_));
+		}
+		bit_buffer_ = 0;
+		bit_count_ = 0;
+	}
+
+  private:
+	std::vector<std::uint8_t> &out_;
+	std::uint64_t bit_buffer_ = 0;
+	int bit_count_ = 0;
+};
+
+constexpr std::array<std::uint16_t, 29> LENGTH_BASE = {3,  4,  5,  6,  7,  8,  9,  10, 11,	13,	 15,  17,  19,	23, 27,
+													   31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<std::uint8_t, 29> LENGTH_EXTRA = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+													   2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<std::uint16_t, 30> DISTANCE_BASE = {1,	   2,	 3,	   4,	 5,	   7,	  9,	 13,	17,	   25,
+														 33,   49,	 65,   97,	 129,  193,	  257,	 385,	513,   769,
+														 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<std::uint8_t, 30> DISTANCE_EXTRA = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+														 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+void put_literal_length(BitWriter &bits, int symbol) {
+	if (symbol < 144) {
+		bits.put_code(0x30 + symbol, 8);
+	} else if (symbol < 256) {
+		bits.put_code(0x190 + (symbol - 144), 9);
+	} else if (symbol < 280) {
+		bits.put_code(symbol - 256, 7);
+	} else {
+		bits.put_code(0xC0 + (symbol - 280), 8);
+	}
+}
+
+void put_match(BitWriter &bits, int length, int distance) {
+	const auto length_code = static_cast<std::size_t>(
+		std::upper_bound(LENGTH_BASE.begin(), LENGTH_BASE.end(), length) - LENGTH_BASE.begin() - 1);
+	put_literal_length(bits, 257 + static_cast<int>(length_code));
+	bits.put(static_cast<std::uint32_t>(length - LENGTH_BASE[length_code]), LENGTH_EXTRA[length_code]);
+
+	const auto distance_code = static_cast<std::size_t>(
+		std::upper_bound(DISTANCE_BASE.begin(), DISTANCE_BASE.end(), distance) - DISTANCE_BASE.begin() - 1);
+	bits.put_code(static_cast<std::uint32_t>(distance_code), 5);
+	bits.put(static_cast<std::uint32_t>(distance - DISTANCE_BASE[distance_code]), DISTANCE_EXTRA[distance_code]);
+}
+
+std::uint32_t adler32(const std::vector<std::uint8_t> &data) {
+	std::uint32_t a = 1;
+	std::uint32_t b = 0;
+	for (const std::uint8_t byte : data) {
+		a = (a + byte) % 65521;
+		b = (b + a) % 65521;
+	}
+	return (b << 16) | a;
+}
+
+void put_u32_be(std::vector<std::uint8_t> &out, std::uint32_t value) {
+	out.push_back(static_cast<std::uint8_t>(value >> 24));
+	out.push_back(static_cast<std::uint8_t>(value >> 16));
+	out.push_back(static_cast<std::uint8_t>(value >> 8));
+	out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// One fixed-code block; greedy matching over 3-byte hash chains
+std::vector<std::uint8_t> zlib_compress(const std::vector<std::uint8_t> &data) {
+	constexpr int WINDOW = 32768;
+	constexpr int MIN_MATCH = 3;
+	constexpr int MAX_MATCH = 258;
+	constexpr int MAX_CHAIN = 32;
+	constexpr int HASH_BITS = 15;
+
+	std::vector<std::uint8_t> out = {0x78, 0x01};
+	out.reserve(data.size() / 4);
+	BitWriter bits(out);
+	bits.put(1, 1); // BFINAL
+	bits.put(1, 2); // BTYPE = fixed Huffman
+
+	const int size = static_cast<int>(data.size());
+	auto head = std::make_unique<int[]>(std::size_t{1} << HASH_BITS);
+	std::fill_n(head.get(), std::size_t{1} << HASH_BITS, -1);
+	auto prev = std::make_unique<int[]>(data.size());
+	auto hash_at = [&data](int i) {
+		const std::uint32_t key = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16);
+		return (key * 2654435761u) >> (32 - HASH_BITS);
+	};
+	auto insert = [&](int i) {
+		if (i + MIN_MATCH <= size) {
+			const std::uint32_t h = hash_at(i);
+			prev[i] = head[h];
+			head[h] = i;
+		}
+	};
+
+	int i = 0;
+	while (i < size) {
+		int best_length = 0;
+		int best_distance = 0;
+		if (i + MIN_MATCH <= size) {
+			const int limit = std::min(MAX_MATCH, size - i);
+			int candidate = head[hash_at(i)];
+			for (int chain = 0; candidate >= 0 && i - candidate <= WINDOW && chain < MAX_CHAIN; ++chain) {
+				int length = 0;
+				while (length < limit && data[candidate + length] == data[i + length]) {
+					++length;
+				}
+				if (length > best_length) {
+					best_length = length;
+					best_distance = i - candidate;
+					if (length == limit) {
+						break;
+					}
+				}
+				candidate = prev[candidate];
+			}
+		}
+		if (best_length >= MIN_MATCH) {
+			put_match(bits, best_length, best_distance);
+			for (int k = 0; k < best_length; ++k) {
+				insert(i + k);
+			}
+			i += best_length;
+		} else {
+			put_literal_length(bits, data[i]);
+			insert(i);
+			++i;
+		}
+	}
+	put_literal_length(bits, 256); // End of block
+	bits.flush();
+	put_u32_be(out, adler32(data));
+	return out;
+}
+
+void put_png_chunk(std::vector<std::uint8_t> &png, const char (&type)[5], const std::vector<std::uint8_t> &data) {
+	put_u32_be(png, static_cast<std::uint32_t>(data.size()));
+	const std::size_t type_at = png.size();
+	png.insert(png.end(), type, type + 4);
+	png.insert(png.end(), data.begin(), data.end());
+	put_u32_be(png, crc32(png.data() + type_at, png.size() - type_at));
+}
+
+} // namespace
+
+std::uint64_t hash_frame_buffer(const std::uint32_t *pixels) {
+	std::uint64_t hash = 0xCBF29CE484222325ULL;
+	for (int i = 0; i < FRAME_WIDTH * FRAME_HEIGHT; ++i) {
+		hash ^= pixels[i];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+bool write_frame_ppm(const std::string &path, const std::uint32_t *pixels) {
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	file << "P6\n" << FRAME_WIDTH << ' ' << FRAME_HEIGHT << "\n255\n";
+	for (int i = 0; i < FRAME_WIDTH * FRAME_HEIGHT; ++i) {
+		const std::uint32_t p = pixels[i];
+		const char rgb[3] = {static_cast<char>(p & 0xFF), static_cast<char>((p >> 8) & 0xFF),
+							 static_cast<char>((p >> 16) & 0xFF)};
+		file.write(rgb, 3);
+	}
+	return static_cast<bool>(file);
+}
+
+FrameHashes hash_frame_indices(const std::uint16_t *indices) {
+	FrameHashes hashes;
+	hashes.exact = xxhash64(indices, sizeof(std::uint16_t) * FRAME_WIDTH * FRAME_HEIGHT);
+
+	// Luma (Rec. 601 weights) of every index buffer entry
+	static const std::array<std::uint16_t, 512> LUMA = [] {
+		std::array<std::uint16_t, 512> luma{};
+		const std::array<std::uint32_t, 512> &rgba = PPU::rgba_palette();
+		for (std::size_t i = 0; i < luma.size(); ++i) {
+			const std::uint32_t r = rgba[i] & 0xFF;
+			const std::uint32_t g = (rgba[i] >> 8) & 0xFF;
+			const std::uint32_t b = (rgba[i] >> 16) & 0xFF;
+			luma[i] = static_cast<std::uint16_t>((77 * r + 150 * g + 29 * b) >> 8);
+		}
+		return luma;
+	}();
+
+	// 8x8 blocks of 32x30 pixels
+	constexpr int BLOCK_W = FRAME_WIDTH / 8;
+	constexpr int BLOCK_H = FRAME_HEIGHT / 8;
+	std::array<std::uint32_t, 64> blocks{};
+	for (int y = 0; y < FRAME_HEIGHT; ++y) {
+		const std::uint16_t *row = indices + static_cast<std::size_t>(y) * FRAME_WIDTH;
+		std::uint32_t *block_row = &blocks[static_cast<std::size_t>(y / BLOCK_H) * 8];
+		for (int x = 0; x < FRAME_WIDTH; ++x) {
+			block_row[x / BLOCK_W] += LUMA[row[x] & 0x1FF];
+		}
+	}
+	std::uint64_t total = 0;
+	for (const std::uint32_t block : blocks) {
+		total += block;
+	}
+	for (std::size_t i = 0; i < blocks.size(); ++i) {
+		if (static_cast<std::uint64_t>(blocks[i]) * blocks.size() > total) {
+			hashes.perceptual |= std::uint64_t{1} << i;
+		}
+	}
+	return hashes;
+}
+
+int perceptual_distance(std::uint64_t a, std::uint64_t b) {
+	return std::popcount(a ^ b);
+}
+
+bool write_frame_hash_trace(const std::string &path, const std::vector<FrameHashes> &frames) {
+	std::ofstream file(path);
+	for (const FrameHashes &frame : frames) {
+		file << std::format("{:016x} {:016x}\n", frame.exact, frame.perceptual);
+	}
+	return static_cast<bool>(file);
+}
+
+bool read_frame_hash_trace(const std::string &path, std::vector<FrameHashes> &frames) {
+	std::ifstream file(path);
+	if (!file) {
+		return false;
+	}
+	frames.clear();
+	for (std::string line; std::getline(file, line);) {
+		if (line.empty()) {
+			continue;
+		}
+		std::istringstream fields(line);
+		FrameHashes frame;
+		if (!(fields >> std::hex >> frame.exact >> frame.perceptual)) {
+			return false;
+		}
+		frames.push_back(frame);
+	}
+	return true;
+}
+
+void pack_frame_rgb(const std::uint32_t *pixels, std::uint8_t *rgb) {
+	for (int i = 0; i < FRAME_WIDTH * FRAME_HEIGHT; ++i) {
+		const std::uint32_t p = pixels[i];
+		rgb[i * 3 + 0] = static_cast<std::uint8_t>(p);
+		rgb[i * 3 + 1] = static_cast<std::uint8_t>(p >> 8);
+		rgb[i * 3 + 2] = static_cast<std::uint8_t>(p >> 16);
+	}
+}
+
+std::vector<std::uint8_t> encode_frame_png(const std::uint32_t *pixels) {
+	// Scanlines with the Sub filter: flat runs become zeros, which the
+	// matcher folds into long back-references
+	constexpr int ROW_BYTES = FRAME_WIDTH * 3;
+	std::vector<std::uint8_t> rgb(static_cast<std::size_t>(ROW_BYTES) * FRAME_HEIGHT);
+	pack_frame_rgb(pixels, rgb.data());
+	std::vector<std::uint8_t> filtered;
+	filtered.reserve(static_cast<std::size_t>(ROW_BYTES + 1) * FRAME_HEIGHT);
+	for (int y = 0; y < FRAME_HEIGHT; ++y) {
+		const std::uint8_t *row = rgb.data() + static_cast<std::size_t>(y) * ROW_BYTES;
+		filtered.push_back(1); // Sub
+		for (int x = 0; x < ROW_BYTES; ++x) {
+			filtered.push_back(static_cast<std::uint8_t>(row[x] - (x >= 3 ? row[x - 3] : 0)));
+		}
+	}
+
+	std::vector<std::uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	std::vector<std::uint8_t> header;
+	put_u32_be(header, FRAME_WIDTH);
+	put_u32_be(header, FRAME_HEIGHT);
+	header.insert(header.end(), {8, 2, 0, 0, 0}); // 8-bit RGB, deflate, adaptive filters, no interlace
+	put_png_chunk(png, "IHDR", header);
+	put_png_chunk(png, "IDAT", zlib_compress(filtered));
+	put_png_chunk(png, "IEND", {});
+	return png;
+}
+
+bool write_frame_png(const std::string &path, const std::uint32_t *pixels) {
+	const std::vector<std::uint8_t> png = encode_frame_png(pixels);
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+	return static_cast<bool>(file);
+}
+
+} // namespace nes
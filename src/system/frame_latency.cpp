@@ -0,0 +1,103 @@
+#include "system/frame_latency.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace nes {
+
+namespace {
+
+constexpr const char *METRIC_NAMES[FrameLatency::METRIC_COUNT] = {"frame_time", "input_latency",
+																  "emulation_latency", "swap_wait"};
+
+double ms_between(FrameLatency::Clock::time_point from, FrameLatency::Clock::time_point to) {
+	return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+void LatencyHistogram::record(double ms) noexcept {
+	ms = std::max(ms, 0.0);
+	const auto index = static_cast<std::size_t>(ms / BUCKET_MS);
+	++buckets_[std::min(index, BUCKETS - 1)];
+	++count_;
+	sum_ms_ += ms;
+	max_ms_ = std::max(max_ms_, ms);
+}
+
+void LatencyHistogram::reset() noexcept {
+	buckets_.fill(0);
+	count_ = 0;
+	sum_ms_ = 0.0;
+	max_ms_ = 0.0;
+}
+
+double LatencyHistogram::mean() const noexcept {
+	return count_ != 0 ? sum_ms_ / static_cast<double>(count_) : 0.0;
+}
+
+double LatencyHistogram::percentile(double fraction) const noexcept {
+	if (count_ == 0) {
+		return 0.0;
+	}
+	const auto rank = static_cast<std::uint64_t>(
+		std::max(1.0, std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count_))));
+	std::uint64_t seen = 0;
+	for (std::size_t i = 0; i < BUCKETS; ++i) {
+		seen += buckets_[i];
+		if (seen >= rank) {
+			// The bucket's upper edge, but never past the longest sample (the
+			// last bucket also holds everything beyond MAX_MS)
+			return i + 1 == BUCKETS ? max_ms_ : std::min(static_cast<double>(i + 1) * BUCKET_MS, max_ms_);
+		}
+	}
+	return max_ms_;
+}
+
+const char *FrameLatency::metric_name(Metric metric) noexcept {
+	return METRIC_NAMES[static_cast<std::size_t>(metric)];
+}
+
+void FrameLatency::record(const Presentation &presentation) noexcept {
+	const Clock::time_point none{};
+	if (presentation.swap_done == none) {
+		return;
+	}
+	auto add = [this](Metric metric, Clock::time_point from, Clock::time_point to) {
+		histograms_[static_cast<std::size_t>(metric)].record(ms_between(from, to));
+	};
+	if (last_swap_ != none) {
+		add(Metric::FrameTime, last_swap_, presentation.swap_done);
+	}
+	if (presentation.input_poll != none) {
+		add(Metric::InputLatency, presentation.input_poll, presentation.swap_done);
+	}
+	if (presentation.frame_completed != none) {
+		add(Metric::EmulationLatency, presentation.frame_completed, presentation.swap_done);
+	}
+	if (presentation.upload_done != none) {
+		add(Metric::SwapWait, presentation.upload_done, presentation.swap_done);
+	}
+	last_swap_ = presentation.swap_done;
+	++presentations_;
+}
+
+void FrameLatency::reset() noexcept {
+	for (LatencyHistogram &histogram : histograms_) {
+		histogram.reset();
+	}
+	last_swap_ = {};
+	presentations_ = 0;
+}
+
+void FrameLatency::write_report(std::ostream &out) const {
+	out << "metric,count,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+	for (std::size_t m = 0; m < METRIC_COUNT; ++m) {
+		const LatencyHistogram &h = histograms_[m];
+		out << METRIC_NAMES[m] << ',' << h.count()
+			<< std::format(",{:.2f},{:.2f},{:.2f},{:.2f},{:.2f}\n", h.mean(), h.percentile(0.50), h.percentile(0.95),
+						   h.percentile(0.99), h.max());
+	}
+}
+
+} // namespace nes
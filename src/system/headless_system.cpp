@@ -0,0 +1,158 @@
+#include "system/headless_system.hpp"
+#include "core/trace_zones.hpp"
+#include "system/nes_system.hpp"
+#include "system/render_pipeline.hpp"
+
+namespace nes {
+
+HeadlessSystem::HeadlessSystem(std::shared_ptr<InputSource> input_source)
+	: HeadlessSystem(std::make_unique<NesSystem>(std::move(input_source))) {
+	system_->bus().power_on();
+}
+
+HeadlessSystem::HeadlessSystem(std::unique_ptr<NesSystem> system) : system_(std::move(system)) {
+	apply_run_policy();
+}
+
+HeadlessSystem::~HeadlessSystem() = default;
+
+void HeadlessSystem::apply_run_policy() {
+	system_->bus().set_ppu_catch_up(true);
+	// Emulated APU state is the same in both modes; band-limited just skips
+	// clocking the pulse/triangle/noise timers every cycle
+	system_->apu().set_synthesis_mode(APU::SynthesisMode::BandLimited);
+	// Polling loops are fast-forwarded to the next event; cycle-identical, but
+	// one execute_instruction() can then cover thousands of cycles
+	system_->cpu().set_idle_loop_skipping(true);
+	// Hot zero-page code runs as compiled blocks between events, also
+	// cycle-identical
+	system_->cpu().set_block_execution(true);
+}
+
+bool HeadlessSystem::load_rom(const std::string &filepath) {
+	return system_->load_rom(filepath);
+}
+
+bool HeadlessSystem::load_rom_data(const RomData &rom_data) {
+	return system_->load_rom_data(rom_data);
+}
+
+bool HeadlessSystem::load_rom_image(std::shared_ptr<const RomImage> image) {
+	return system_->load_rom_image(std::move(image));
+}
+
+void HeadlessSystem::reset() {
+	system_->reset();
+}
+
+std::unique_ptr<HeadlessSystem> HeadlessSystem::clone(std::shared_ptr<InputSource> input_source) {
+	std::unique_ptr<NesSystem> copy = system_->clone(std::move(input_source));
+	if (!copy) {
+		return nullptr;
+	}
+	return std::unique_ptr<HeadlessSystem>(new HeadlessSystem(std::move(copy)));
+}
+
+bool HeadlessSystem::clone_into(HeadlessSystem &target) {
+	return system_->clone_into(*target.system_);
+}
+
+std::uint64_t HeadlessSystem::run_frame() {
+	VIBENES_TRACE_ZONE("HeadlessSystem::run_frame");
+	// Upper bound of a few frames' worth of cycles guards against a PPU that
+	// never completes a frame (e.g. a jammed CPU returning zero cycles)
+	constexpr std::uint64_t MAX_CYCLES = 29781 * 4; // Still > 3 PAL frames
+	if (pipeline_) {
+		pipeline_->begin_run();
+	}
+	const std::uint64_t executed = system_->cpu().run_frame(MAX_CYCLES).cycles;
+	system_->bus().sync_ppu();
+	if (pipeline_) {
+		pipeline_->end_run();
+	}
+	return executed;
+}
+
+std::uint64_t HeadlessSystem::run_cycles(std::uint64_t cycles) {
+	if (pipeline_) {
+		pipeline_->begin_run();
+	}
+	const std::uint64_t executed = system_->cpu().run_until(system_->cpu().get_cycle_count() + cycles).cycles;
+	system_->bus().sync_ppu();
+	if (pipeline_) {
+		pipeline_->end_run();
+	}
+	return executed;
+}
+
+void HeadlessSystem::set_frame_skip(uint32_t interval) {
+	system_->ppu().set_frame_skip(interval);
+}
+
+void HeadlessSystem::set_accuracy(Accuracy accuracy) {
+	system_->ppu().set_accuracy(accuracy);
+}
+
+void HeadlessSystem::set_pipelined_rendering(bool enabled) {
+	if (!enabled) {
+		pipeline_.reset();
+	} else if (!pipeline_) {
+		pipeline_ = std::make_unique<RenderPipeline>(*system_);
+	}
+}
+
+void HeadlessSystem::sync_rendering() {
+	if (pipeline_) {
+		pipeline_->sync();
+	}
+}
+
+const uint32_t *HeadlessSystem::get_frame_buffer() const {
+	if (pipeline_) {
+		return pipeline_->frame_buffer();
+	}
+	return system_->ppu().get_frame_buffer();
+}
+
+uint64_t HeadlessSystem::get_frame_count() const {
+	return system_->ppu().get_frame_count();
+}
+
+const BusStats &HeadlessSystem::get_bus_stats() const {
+	return system_->bus().get_bus_stats();
+}
+
+const PpuFetchStats &HeadlessSystem::get_ppu_fetch_stats() const {
+	return system_->ppu().get_total_fetch_stats();
+}
+
+void HeadlessSystem::reset_bus_stats() {
+	system_->bus().reset_bus_stats();
+	system_->ppu().reset_fetch_stats();
+}
+
+SystemBus &HeadlessSystem::bus() noexcept {
+	return system_->bus();
+}
+
+CPU6502 &HeadlessSystem::cpu() noexcept {
+	return system_->cpu();
+}
+
+PPU &HeadlessSystem::ppu() noexcept {
+	return system_->ppu();
+}
+
+APU &HeadlessSystem::apu() noexcept {
+	return system_->apu();
+}
+
+Cartridge &HeadlessSystem::cartridge() noexcept {
+	return system_->cartridge();
+}
+
+Ram &HeadlessSystem::ram() noexcept {
+	return system_->ram();
+}
+
+} // namespace nes
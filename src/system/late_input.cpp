@@ -0,0 +1,75 @@
+#include "system/late_input.hpp"
+#include <algorithm>
+
+namespace nes {
+
+void LateInputScheduler::set_mode(Mode mode) noexcept {
+	if (mode != mode_) {
+		mode_ = mode;
+		reset();
+	}
+}
+
+void LateInputScheduler::on_swap(Clock::time_point time) noexcept {
+	if (last_swap_ != Clock::time_point{}) {
+		const Clock::duration interval = time - last_swap_;
+		if (refresh_period_ == Clock::duration::zero()) {
+			refresh_period_ = interval;
+		} else if (interval > refresh_period_ / 2 && interval < refresh_period_ * 3 / 2) {
+			// Slow average: vsync intervals jitter by the scheduler's wakeup latency
+			refresh_period_ += (interval - refresh_period_) / 16;
+		}
+	}
+	last_swap_ = time;
+}
+
+void LateInputScheduler::record_cost(Clock::duration cost) noexcept {
+	costs_[next_cost_] = std::max(cost, Clock::duration::zero());
+	next_cost_ = (next_cost_ + 1) % costs_.size();
+}
+
+LateInputScheduler::Clock::duration LateInputScheduler::cost() const noexcept {
+	return *std::max_element(costs_.begin(), costs_.end());
+}
+
+LateInputScheduler::Clock::time_point LateInputScheduler::poll_time() const noexcept {
+	if (mode_ == Mode::Off || refresh_period_ == Clock::duration::zero()) {
+		return last_swap_;
+	}
+	const Clock::duration lead = mode_ == Mode::Adaptive ? cost() + lead_ : lead_;
+	const Clock::duration wait = std::clamp(refresh_period_ - lead, Clock::duration::zero(), refresh_period_);
+	return last_swap_ + wait;
+}
+
+int LateInputScheduler::frames_due(Clock::time_point time) noexcept {
+	if (frame_period_ <= Clock::duration::zero()) {
+		return 0;
+	}
+	if (last_poll_ == Clock::time_point{}) {
+		// The first poll owes one frame, so something shows right away
+		owed_ = frame_period_;
+	} else if (time > last_poll_) {
+		owed_ += time - last_poll_;
+	}
+	last_poll_ = time;
+
+	// Rounded, so a poll woken a little early or late still gets its frame;
+	// the difference stays owed (or ahead) for the next poll
+	const auto due = static_cast<int>(
+		std::clamp<Clock::rep>((owed_ + frame_period_ / 2) / frame_period_, 0, MAX_FRAMES_PER_POLL));
+	owed_ -= frame_period_ * due;
+	// A backlog (a stall, a debugger break) is not caught up on
+	owed_ = std::min(owed_, frame_period_);
+	return due;
+}
+
+void LateInputScheduler::reset() noexcept {
+	last_swap_ = {};
+	refresh_period_ = {};
+	costs_.fill({});
+	next_cost_ = 0;
+	last_poll_ = {};
+	owed_ = {};
+}
+
+} // namespace nes
@@ -0,0 +1,119 @@
+#include "system/mapped_file.hpp"
+#include <algorithm>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nes {
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const std::filesystem::path &path, std::size_t size) {
+	close();
+	if (size == 0) {
+		return false;
+	}
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+							  FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER existing{};
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &existing)) {
+		// A mapping larger than the file extends it
+		const auto length = static_cast<unsigned long long>(size);
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(length >> 32),
+									 static_cast<DWORD>(length & 0xFFFFFFFFull), nullptr);
+	}
+	void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+	if (mapping) {
+		CloseHandle(mapping); // The view keeps it alive
+	}
+	if (!view) {
+		CloseHandle(file);
+		return false;
+	}
+	view_ = static_cast<Byte *>(view);
+	size_ = size;
+	original_size_ = std::min(static_cast<std::size_t>(existing.QuadPart), size);
+	file_ = file;
+	return true;
+}
+
+void MappedFile::close() noexcept {
+	if (view_) {
+		UnmapViewOfFile(view_);
+		view_ = nullptr;
+	}
+	if (file_) {
+		CloseHandle(static_cast<HANDLE>(file_));
+		file_ = nullptr;
+	}
+	size_ = 0;
+	original_size_ = 0;
+}
+
+bool MappedFile::sync() noexcept {
+	if (!view_) {
+		return false;
+	}
+	return FlushViewOfFile(view_, size_) && FlushFileBuffers(static_cast<HANDLE>(file_));
+}
+
+#else
+
+bool MappedFile::open(const std::filesystem::path &path, std::size_t size) {
+	close();
+	if (size == 0) {
+		return false;
+	}
+	const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info {};
+	void *view = MAP_FAILED;
+	if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+		(static_cast<std::size_t>(info.st_size) >= size || ::ftruncate(fd, static_cast<off_t>(size)) == 0)) {
+		view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	// The mapping keeps the file alive on its own
+	::close(fd);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+	view_ = static_cast<Byte *>(view);
+	size_ = size;
+	original_size_ = std::min(static_cast<std::size_t>(info.st_size), size);
+	return true;
+}
+
+void MappedFile::close() noexcept {
+	if (view_) {
+		::munmap(view_, size_);
+		view_ = nullptr;
+	}
+	size_ = 0;
+	original_size_ = 0;
+}
+
+bool MappedFile::sync() noexcept {
+	return view_ && ::msync(view_, size_, MS_SYNC) == 0;
+}
+
+#endif
+
+} // namespace nes
@@ -0,0 +1,125 @@
+#include "system/nes_system.hpp"
+#include "cartridge/rom_image.hpp"
+#include <utility>
+#include <vector>
+
+namespace nes {
+
+namespace {
+
+// A handle the connect_* calls can hold that never deletes its target; the
+// target is a sibling member with the same lifetime as the holder
+template <typename T>
+std::shared_ptr<T> borrow(T &component) {
+	return std::shared_ptr<T>(std::shared_ptr<T>(), &component);
+}
+
+} // namespace
+
+NesSystem::NesSystem(std::shared_ptr<InputSource> input_source)
+	: controllers_(std::move(input_source)), cpu_(&bus_) {
+	bus_.connect_ram(borrow(ram_));
+	bus_.connect_ppu(borrow(ppu_));
+	bus_.connect_apu(borrow(apu_));
+	bus_.connect_controllers(borrow(controllers_));
+	bus_.connect_cartridge(borrow(cartridge_));
+	bus_.connect_cpu(borrow(cpu_));
+
+	ppu_.connect_cartridge(borrow(cartridge_));
+	ppu_.connect_cpu(&cpu_);
+	ppu_.connect_bus(&bus_);
+	controllers_.connect_ppu(&ppu_);
+}
+
+bool NesSystem::load_rom(const std::string &filepath) {
+	return cartridge_.load_rom(filepath) && on_cartridge_loaded();
+}
+
+bool NesSystem::load_rom_data(const RomData &rom_data) {
+	return cartridge_.load_from_rom_data(rom_data) && on_cartridge_loaded();
+}
+
+bool NesSystem::load_rom_image(std::shared_ptr<const RomImage> image) {
+	return cartridge_.load_rom_image(std::move(image)) && on_cartridge_loaded();
+}
+
+bool NesSystem::on_cartridge_loaded() {
+	refresh_cartridge();
+	reset();
+	return true;
+}
+
+void NesSystem::refresh_cartridge() {
+	// Reconnect so the PPU picks up the new cartridge's mirroring mode
+	ppu_.connect_cartridge(borrow(cartridge_));
+	bus_.set_region(cartridge_.get_region());
+	controllers_.configure(input_setup_for_expansion_device(cartridge_.get_rom_data().expansion_device));
+}
+
+void NesSystem::reset() {
+	bus_.reset();
+}
+
+std::unique_ptr<NesSystem> NesSystem::clone(std::shared_ptr<InputSource> input_source) {
+	auto copy = std::make_unique<NesSystem>(std::move(input_source));
+	copy->bus_.power_on();
+	if (!clone_into(*copy)) {
+		return nullptr;
+	}
+	return copy;
+}
+
+bool NesSystem::clone_into(NesSystem &target) {
+	const std::shared_ptr<const RomImage> &image = cartridge_.get_rom_image();
+	if (!image) {
+		return false;
+	}
+	if (&target == this) {
+		return true;
+	}
+	if (target.cartridge_.get_rom_image() != image && !target.load_rom_image(image)) {
+		return false;
+	}
+
+	// The components' snapshot serializers, in save-state order, without the
+	// header, ROM CRC check and compression a save state adds: with the same
+	// ROM image on both sides the layout is known to match. RAM, VRAM, OAM
+	// and palette go across as block copies; cartridge RAM directly, only the
+	// pages either side wrote since the last copy between the two.
+	bus_.sync_ppu();
+	apu_.sync_channels();
+	clone_state_.clear();
+	cpu_.serialize_state(clone_state_);
+	ppu_.serialize_state(clone_state_);
+	apu_.serialize_state(clone_state_);
+	bus_.serialize_state(clone_state_);
+	cartridge_.serialize_registers(clone_state_);
+
+	std::size_t offset = 0;
+	target.ppu_.set_accuracy(ppu_.get_accuracy()); // First: going Fast latches a pending sprite-0 hit
+	target.bus_.set_master_clock(bus_.get_master_clock());
+	target.cpu_.deserialize_state(clone_state_, offset);
+	target.ppu_.deserialize_state(clone_state_, offset);
+	target.apu_.deserialize_state(clone_state_, offset);
+	target.bus_.deserialize_state(clone_state_, offset);
+	target.cartridge_.copy_ram_from(cartridge_);
+	target.cartridge_.deserialize_registers(clone_state_, offset);
+	target.controllers_.configure(controllers_.setup());
+	return true;
+}
+
+void NesSystem::serialize_machine(std::vector<std::uint8_t> &buffer) {
+	bus_.sync_ppu();
+	apu_.sync_channels();
+	const std::uint64_t clock = bus_.get_master_clock();
+	for (int shift = 0; shift < 64; shift += 8) {
+		buffer.push_back(static_cast<std::uint8_t>(clock >> shift));
+	}
+	cpu_.serialize_state(buffer);
+	ppu_.serialize_state(buffer);
+	apu_.serialize_state(buffer);
+	bus_.serialize_state(buffer);
+	cartridge_.serialize_state(buffer);
+}
+
+} // namespace nes
@@ -0,0 +1,106 @@
+#include "system/perf_counters.hpp"
+#include <algorithm>
+#include <format>
+#include <span>
+
+namespace nes {
+
+namespace {
+
+constexpr const char *COUNTER_NAMES[PerfCounters::COUNTER_COUNT] = {
+	"emulation", "cpu", "ppu", "apu", "mapper", "audio_queue", "texture_upload", "gui"};
+
+constexpr float to_ms(std::uint64_t ns) {
+	return static_cast<float>(static_cast<double>(ns) / 1e6);
+}
+
+} // namespace
+
+const char *PerfCounters::counter_name(Counter counter) noexcept {
+	return COUNTER_NAMES[static_cast<std::size_t>(counter)];
+}
+
+void PerfCounters::record_frame(const FrameReport &report) noexcept {
+	reports_.push(std::span<const FrameReport>(&report, 1));
+}
+
+void PerfCounters::collect(std::uint64_t texture_upload_ns, std::uint64_t gui_ns) noexcept {
+	std::array<FrameReport, 16> reports;
+	while (const std::size_t count = reports_.pop(reports)) {
+		for (std::size_t i = 0; i < count; ++i) {
+			const FrameReport &report = reports[i];
+			Frame &frame = history_[next_];
+			frame.index = frames_collected_++;
+			frame.cpu_cycles = report.cpu_cycles;
+			frame.components = report.components;
+			frame.ms.fill(0.0f);
+			auto set = [&frame](Counter counter, float value) { frame.ms[static_cast<std::size_t>(counter)] = value; };
+			set(Counter::Emulation, to_ms(report.emulation_ns));
+			if (report.components) {
+				// Time inside the bus's tick is the components'; the rest is
+				// the CPU core's (its clock reads count against it)
+				const std::uint64_t components = report.ppu_ns + report.apu_ns + report.mapper_ns;
+				set(Counter::Cpu, to_ms(report.emulation_ns - std::min(components, report.emulation_ns)));
+				set(Counter::Ppu, to_ms(report.ppu_ns));
+				set(Counter::Apu, to_ms(report.apu_ns));
+				set(Counter::Mapper, to_ms(report.mapper_ns));
+			}
+			set(Counter::AudioQueue, static_cast<float>(report.audio_queue_ms));
+			set(Counter::TextureUpload, to_ms(texture_upload_ns));
+			set(Counter::Gui, to_ms(gui_ns));
+			next_ = (next_ + 1) % HISTORY;
+			count_ = std::min(count_ + 1, HISTORY);
+		}
+	}
+}
+
+void PerfCounters::reset() noexcept {
+	std::array<FrameReport, 16> reports;
+	while (reports_.pop(reports) != 0) {
+	}
+	next_ = 0;
+	count_ = 0;
+	frames_collected_ = 0;
+}
+
+float PerfCounters::average(Counter counter) const noexcept {
+	double sum = 0.0;
+	std::size_t measured = 0;
+	for (std::size_t i = 0; i < count_; ++i) {
+		const Frame &row = frame(i);
+		if (row.components || !is_component(counter)) {
+			sum += row[counter];
+			++measured;
+		}
+	}
+	return measured != 0 ? static_cast<float>(sum / static_cast<double>(measured)) : 0.0f;
+}
+
+float PerfCounters::peak(Counter counter) const noexcept {
+	float highest = 0.0f;
+	for (std::size_t i = 0; i < count_; ++i) {
+		highest = std::max(highest, frame(i)[counter]);
+	}
+	return highest;
+}
+
+void PerfCounters::write_csv(std::ostream &out) const {
+	out << "frame,cpu_cycles";
+	for (const char *name : COUNTER_NAMES) {
+		out << ',' << name << "_ms";
+	}
+	out << '\n';
+	for (std::size_t i = 0; i < count_; ++i) {
+		const Frame &row = frame(i);
+		out << row.index << ',' << row.cpu_cycles;
+		for (std::size_t c = 0; c < COUNTER_COUNT; ++c) {
+			out << ',';
+			if (row.components || !is_component(static_cast<Counter>(c))) {
+				out << std::format("{:.4f}", row.ms[c]);
+			}
+		}
+		out << '\n';
+	}
+}
+
+} // namespace nes
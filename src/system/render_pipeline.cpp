@@ -0,0 +1,188 @@
+#include "system/render_pipeline.hpp"
+#include "cartridge/cartridge.hpp"
+#include "core/bus.hpp"
+#include "ppu/ppu.hpp"
+#include "system/nes_system.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace nes {
+
+RenderPipeline::RenderPipeline(NesSystem &system)
+	: system_(system), copy_(std::make_unique<NesSystem>()), shown_(PIXELS, 0), shown_rgba_(PIXELS, 0),
+	  drawn_(PIXELS, 0) {
+	copy_->bus().power_on();
+	system_.ppu().set_compose_suppressed(true);
+	system_.bus().set_ppu_log(&jobs_[logging_].log);
+	worker_ = std::thread([this] { work(); });
+}
+
+RenderPipeline::~RenderPipeline() {
+	{
+		std::unique_lock lock(mutex_);
+		wait_idle(lock);
+		quit_ = true;
+	}
+	wake_.notify_one();
+	worker_.join();
+	system_.bus().set_ppu_log(nullptr);
+	system_.ppu().set_compose_suppressed(false);
+}
+
+void RenderPipeline::begin_run() {
+	const PPU &ppu = system_.ppu();
+	bool moved = !seeded_ || ppu.get_frame_generation() != generation_ || ppu.get_dot_counter() != dot_;
+	{
+		std::unique_lock lock(mutex_);
+		moved = moved || diverged_;
+		if (moved) {
+			wait_idle(lock);
+		}
+	}
+	if (moved) {
+		reseed();
+	}
+}
+
+void RenderPipeline::reseed() {
+	// The worker is idle, so the copy is ours until the next job
+	jobs_[logging_].log.clear();
+	diverged_ = false;
+	seeded_ = system_.clone_into(*copy_);
+	if (!seeded_) {
+		return; // No ROM: nothing to draw
+	}
+	// The frame in progress was partly drawn before the copy existed
+	publish_from_ = copy_->ppu().get_frame_count() + 2;
+	++stats_.reseeds;
+}
+
+void RenderPipeline::end_run() {
+	const PPU &ppu = system_.ppu();
+	const std::uint64_t generation = ppu.get_frame_generation();
+	std::unique_lock lock(mutex_);
+	wait_idle(lock);
+	take_drawn();
+	if (!seeded_) {
+		jobs_[logging_].log.clear();
+		return;
+	}
+
+	Job &job = jobs_[logging_];
+	job.end_dot = ppu.get_dot_counter();
+	job.frame_count = ppu.get_frame_count();
+	job.frame_skip = ppu.get_frame_skip();
+	job.check = ScanlineTimeline::ENABLED && generation != generation_;
+	if (job.check) {
+		job.expected = ppu.get_scanline_timeline().last_frame();
+	}
+	generation_ = generation;
+	dot_ = job.end_dot;
+
+	logging_ ^= 1;
+	jobs_[logging_].log.clear();
+	system_.bus().set_ppu_log(&jobs_[logging_].log);
+	pending_ = &job;
+	busy_ = true;
+	lock.unlock();
+	wake_.notify_one();
+}
+
+void RenderPipeline::sync() {
+	std::unique_lock lock(mutex_);
+	wait_idle(lock);
+	take_drawn();
+}
+
+const std::uint32_t *RenderPipeline::frame_buffer() {
+	const std::array<std::uint32_t, 512> &palette = PPU::rgba_palette();
+	std::transform(shown_.begin(), shown_.end(), shown_rgba_.begin(),
+				   [&palette](std::uint16_t entry) { return palette[entry & 0x1FF]; });
+	return shown_rgba_.data();
+}
+
+void RenderPipeline::wait_idle(std::unique_lock<std::mutex> &lock) {
+	idle_.wait(lock, [this] { return !busy_; });
+}
+
+void RenderPipeline::take_drawn() {
+	if (drawn_new_) {
+		shown_.swap(drawn_);
+		shown_frame_ = drawn_frame_;
+		drawn_new_ = false;
+	}
+}
+
+void RenderPipeline::work() {
+	std::unique_lock lock(mutex_);
+	while (true) {
+		wake_.wait(lock, [this] { return pending_ != nullptr || quit_; });
+		if (quit_) {
+			return;
+		}
+		const Job &job = *pending_;
+		pending_ = nullptr;
+		lock.unlock();
+
+		replay(job);
+
+		const PPU &ppu = copy_->ppu();
+		bool diverged = ppu.get_dot_counter() != job.end_dot || ppu.get_frame_count() != job.frame_count;
+		const bool whole = ppu.get_frame_count() >= publish_from_;
+		if (!diverged && whole && job.check) {
+			const ScanlineTimeline::Frame &drawn = ppu.get_scanline_timeline().last_frame();
+			diverged = std::memcmp(drawn.data(), job.expected.data(), sizeof(drawn)) != 0;
+		}
+
+		lock.lock();
+		++stats_.runs;
+		stats_.entries += job.log.entries().size();
+		if (diverged) {
+			diverged_ = true;
+			++stats_.divergences;
+		} else if (whole) {
+			std::memcpy(drawn_.data(), ppu.get_index_buffer(), PIXELS * sizeof(std::uint16_t));
+			drawn_frame_ = job.frame_count;
+			drawn_new_ = true;
+		}
+		busy_ = false;
+		idle_.notify_all();
+	}
+}
+
+void RenderPipeline::replay(const Job &job) {
+	PPU &ppu = copy_->ppu();
+	Cartridge &cartridge = copy_->cartridge();
+	ppu.set_frame_skip(job.frame_skip);
+	const auto advance_to = [&ppu](std::uint32_t dot) {
+		// Wrapping difference; a stamp behind the copy is a divergence, which
+		// the dot counter check after the run reports
+		const std::uint32_t dots = dot - ppu.get_dot_counter();
+		if (dots < 0x80000000u) {
+			ppu.tick_dots(static_cast<int>(dots));
+		}
+	};
+	for (const PpuWriteLog::Entry &entry : job.log.entries()) {
+		advance_to(entry.dot);
+		switch (entry.kind) {
+		case PpuWriteLog::Kind::RegisterRead:
+			static_cast<void>(ppu.read_register(entry.address));
+			break;
+		case PpuWriteLog::Kind::RegisterWrite:
+			ppu.write_register(entry.address, entry.value);
+			break;
+		case PpuWriteLog::Kind::OamWrite:
+			ppu.write_oam_direct(static_cast<std::uint8_t>(entry.address), entry.value);
+			break;
+		case PpuWriteLog::Kind::OamPage:
+			ppu.write_oam_page(job.log.page(entry.address));
+			break;
+		case PpuWriteLog::Kind::CartridgeWrite:
+			cartridge.cpu_write_at(entry.address, entry.value, entry.cycle);
+			break;
+		}
+	}
+	advance_to(job.end_dot);
+}
+
+} // namespace nes
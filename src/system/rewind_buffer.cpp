@@ -0,0 +1,227 @@
+#include "system/rewind_buffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace nes {
+
+namespace {
+
+// Zero runs shorter than this cost more as a token than inside a literal
+constexpr size_t MIN_ZERO_RUN = 4;
+
+void put_count(std::vector<uint8_t> &out, size_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+size_t get_count(const uint8_t *&in, const uint8_t *end) {
+	size_t value = 0;
+	for (int shift = 0; in < end && shift < 64; shift += 7) {
+		const uint8_t byte = *in++;
+		value |= static_cast<size_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			break;
+		}
+	}
+	return value;
+}
+
+} // namespace
+
+RewindBuffer::RewindBuffer(size_t memory_budget, unsigned keyframe_interval)
+	: budget_(memory_budget), keyframe_interval_(std::max(keyframe_interval, 1u)) {
+}
+
+void RewindBuffer::clear() {
+	entries_.clear();
+	head_ = 0;
+	used_ = 0;
+	deltas_since_keyframe_ = 0;
+}
+
+void RewindBuffer::push(const StateSnapshot &snapshot) {
+	if (!snapshot.valid_ || snapshot.empty()) {
+		return;
+	}
+	if (snapshot.size() != state_size_ || snapshot.load_id_ != load_id_ || snapshot.offsets_ != offsets_) {
+		clear();
+		state_size_ = snapshot.size();
+		offsets_ = snapshot.offsets_;
+		load_id_ = snapshot.load_id_;
+		keyframe_.resize(state_size_);
+		// A literal run costs at most a few count bytes over its length
+		scratch_.reserve(state_size_ + state_size_ / 4 + 16);
+		arena_.resize(budget_);
+	}
+
+	if (!entries_.empty() && deltas_since_keyframe_ + 1 < keyframe_interval_) {
+		encode(snapshot.data(), keyframe_.data());
+		if (store(false)) {
+			++deltas_since_keyframe_;
+			return;
+		}
+		// Making room dropped the keyframe this delta was against
+	}
+
+	encode(snapshot.data(), nullptr);
+	if (!store(true)) {
+		clear(); // One frame does not even fit the budget
+		return;
+	}
+	std::copy(snapshot.bytes_.begin(), snapshot.bytes_.end(), keyframe_.begin());
+	deltas_since_keyframe_ = 0;
+}
+
+bool RewindBuffer::pop(StateSnapshot &snapshot) {
+	if (entries_.empty()) {
+		return false;
+	}
+	const Entry entry = entries_.back();
+	snapshot.bytes_.resize(state_size_);
+	decode(entry, snapshot.bytes_.data(), entry.keyframe ? nullptr : keyframe_.data());
+	snapshot.offsets_ = offsets_;
+	snapshot.load_id_ = load_id_;
+	snapshot.valid_ = true;
+	snapshot.ram_mark_ = {}; // Its cartridge RAM was just rewritten
+
+	entries_.pop_back();
+	used_ -= entry.size;
+	head_ = entries_.empty() ? 0 : entry.offset;
+	if (!entry.keyframe) {
+		--deltas_since_keyframe_;
+		return true;
+	}
+
+	// Deltas pushed from here on go against the previous keyframe again
+	deltas_since_keyframe_ = 0;
+	for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+		if (it->keyframe) {
+			decode(*it, keyframe_.data(), nullptr);
+			break;
+		}
+		++deltas_since_keyframe_;
+	}
+	return true;
+}
+
+void RewindBuffer::encode(const uint8_t *state, const uint8_t *reference) {
+	const size_t size = state_size_;
+	const auto byte_at = [state, reference](size_t i) -> uint8_t {
+		return reference ? static_cast<uint8_t>(state[i] ^ reference[i]) : state[i];
+	};
+	// Length of the run of zero output bytes starting at i, a word at a time
+	const auto zero_run = [&](size_t i) {
+		size_t j = i;
+		while (j + 8 <= size) {
+			uint64_t value = 0;
+			uint64_t against = 0;
+			std::memcpy(&value, state + j, 8);
+			if (reference) {
+				std::memcpy(&against, reference + j, 8);
+			}
+			if (value != against) {
+				break;
+			}
+			j += 8;
+		}
+		while (j < size && byte_at(j) == 0) {
+			++j;
+		}
+		return j - i;
+	};
+
+	scratch_.clear();
+	size_t i = 0;
+	while (i < size) {
+		const size_t zeros = zero_run(i);
+		i += zeros;
+		size_t literal = 0;
+		while (i + literal < size && (byte_at(i + literal) != 0 || zero_run(i + literal) < MIN_ZERO_RUN)) {
+			++literal;
+		}
+		put_count(scratch_, zeros);
+		put_count(scratch_, literal);
+		for (size_t k = 0; k < literal; ++k) {
+			scratch_.push_back(byte_at(i + k));
+		}
+		i += literal;
+	}
+}
+
+void RewindBuffer::decode(const Entry &entry, uint8_t *out, const uint8_t *reference) const {
+	const uint8_t *in = arena_.data() + entry.offset;
+	const uint8_t *const end = in + entry.size;
+	size_t position = 0;
+	while (position < state_size_ && in < end) {
+		const size_t zeros = std::min(get_count(in, end), state_size_ - position);
+		if (reference) {
+			std::memcpy(out + position, reference + position, zeros);
+		} else {
+			std::memset(out + position, 0, zeros);
+		}
+		position += zeros;
+
+		const size_t literal =
+			std::min({get_count(in, end), state_size_ - position, static_cast<size_t>(end - in)});
+		for (size_t k = 0; k < literal; ++k) {
+			out[position + k] = reference ? static_cast<uint8_t>(in[k] ^ reference[position + k]) : in[k];
+		}
+		in += literal;
+		position += literal;
+	}
+}
+
+bool RewindBuffer::store(bool keyframe) {
+	const size_t size = scratch_.size();
+	size_t offset = 0;
+	if (!make_room(size, offset) || (!keyframe && entries_.empty())) {
+		return false;
+	}
+	std::memcpy(arena_.data() + offset, scratch_.data(), size);
+	entries_.push_back({offset, size, keyframe});
+	head_ = offset + size;
+	used_ += size;
+	return true;
+}
+
+bool RewindBuffer::make_room(size_t size, size_t &offset) {
+	if (size > arena_.size()) {
+		return false;
+	}
+	while (!entries_.empty()) {
+		const size_t tail = entries_.front().offset;
+		if (tail >= head_) {
+			// Wrapped: the space left is between the newest entry and the oldest
+			if (head_ + size <= tail) {
+				offset = head_;
+				return true;
+			}
+		} else if (head_ + size <= arena_.size()) {
+			offset = head_;
+			return true;
+		} else if (size <= tail) {
+			offset = 0;
+			return true;
+		}
+		evict_oldest();
+	}
+	offset = 0;
+	return true;
+}
+
+void RewindBuffer::evict_oldest() {
+	// A keyframe goes with the deltas that were taken against it
+	do {
+		used_ -= entries_.front().size;
+		entries_.pop_front();
+	} while (!entries_.empty() && !entries_.front().keyframe);
+	if (entries_.empty()) {
+		head_ = 0;
+		deltas_since_keyframe_ = 0;
+	}
+}
+
+} // namespace nes
@@ -0,0 +1,96 @@
+#include "system/rollback_session.hpp"
+#include "core/bus.hpp"
+#include "input/latched_input.hpp"
+#include "ppu/ppu.hpp"
+#include "system/headless_system.hpp"
+#include <algorithm>
+
+namespace nes {
+
+RollbackSession::RollbackSession(HeadlessSystem &system, std::shared_ptr<LatchedInputSource> input, int local_player)
+	: system_(system), states_(&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge()),
+	  input_(std::move(input)), local_player_(local_player == 0 ? 0 : 1) {
+	const size_t size = states_.snapshot_size();
+	for (StateSnapshot &snapshot : snapshots_) {
+		snapshot.reserve(size);
+	}
+}
+
+RollbackSession::FrameInput &RollbackSession::slot(std::uint64_t frame) {
+	FrameInput &input = inputs_[frame % INPUT_WINDOW];
+	if (input.frame != frame) {
+		input = FrameInput{};
+		input.frame = frame;
+	}
+	return input;
+}
+
+bool RollbackSession::add_remote_input(std::uint64_t frame, Byte buttons) {
+	// The peer never gets further ahead than its own rollback limit
+	if (frame < confirmed_ || frame > frame_ + MAX_ROLLBACK_FRAMES) {
+		return false;
+	}
+	FrameInput &input = slot(frame);
+	if (input.confirmed) {
+		return true; // Resent
+	}
+	input.remote = buttons;
+	input.confirmed = true;
+	if (frame < frame_ && input.remote_used != buttons) {
+		rollback_to_ = std::min(rollback_to_, frame);
+	}
+
+	while (true) {
+		const FrameInput &next = inputs_[confirmed_ % INPUT_WINDOW];
+		if (next.frame != confirmed_ || !next.confirmed) {
+			break;
+		}
+		last_confirmed_remote_ = next.remote;
+		++confirmed_;
+	}
+	return true;
+}
+
+bool RollbackSession::advance_frame(Byte local_buttons) {
+	if (!can_advance()) {
+		return false;
+	}
+	if (rollback_to_ != NO_FRAME) {
+		roll_back();
+	}
+	slot(frame_).local = local_buttons;
+	run_frame(frame_);
+	++frame_;
+	return true;
+}
+
+void RollbackSession::run_frame(std::uint64_t frame) {
+	FrameInput &input = slot(frame);
+	// Unconfirmed remote input is predicted to be held from the last confirmed frame
+	input.remote_used = input.confirmed ? input.remote : last_confirmed_remote_;
+	states_.capture(snapshots_[frame % snapshots_.size()]);
+	input_->set_buttons(local_player_, input.local);
+	input_->set_buttons(1 - local_player_, input.remote_used);
+	system_.run_frame();
+}
+
+void RollbackSession::roll_back() {
+	const std::uint64_t from = rollback_to_;
+	rollback_to_ = NO_FRAME;
+
+	// Gate before restoring so the audio path stays where it is; the frames
+	// being re-run have been heard already
+	system_.bus().set_audio_gated(true);
+	states_.restore(snapshots_[from % snapshots_.size()]);
+	system_.ppu().set_compose_suppressed(true);
+	for (std::uint64_t frame = from; frame < frame_; ++frame) {
+		run_frame(frame);
+	}
+	system_.ppu().set_compose_suppressed(false);
+	system_.bus().set_audio_gated(false);
+
+	++rollbacks_;
+	resimulated_frames_ += frame_ - from;
+}
+
+} // namespace nes
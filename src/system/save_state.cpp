@@ -2,8 +2,11 @@
 #include "apu/apu.hpp"
 #include "cartridge/cartridge.hpp"
 #include "core/bus.hpp"
+#include "core/lz4_block.hpp"
 #include "cpu/cpu_6502.hpp"
 #include "ppu/ppu.hpp"
+#include <algorithm>
+#include <bit>
 #include <cctype>
 #include <chrono>
 #include <cstring>
@@ -12,46 +15,59 @@
 
 namespace nes {
 
-// CRC32 table for checksum calculation
-static const uint32_t crc32_table[256] = {
-	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3, 0x0EDB8832,
-	0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
-	0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7, 0x136C9856, 0x646BA8C0, 0xFD62F97A,
-	0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
-	0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3,
-	0x45DF5C75, 0xDCD60DCF, 0xABD13D59, 0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
-	0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB,
-	0xB6662D3D, 0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-	0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01, 0x6B6B51F4,
-	0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
-	0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65, 0x4DB26158, 0x3AB551CE, 0xA3BC0074,
-	0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
-	0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525,
-	0x206F85B3, 0xB966D409, 0xCE61E49F, 0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
-	0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615,
-	0x73DC1683, 0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-	0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7, 0xFED41B76,
-	0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
-	0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B, 0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6,
-	0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
-	0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7,
-	0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D, 0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
-	0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7,
-	0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-	0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45, 0xA00AE278,
-	0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
-	0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9, 0xBDBDF21C, 0xCABAC28A, 0x53B39330,
-	0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
-	0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D};
-
-static uint32_t calculate_crc32(const uint8_t *data, size_t length) {
-	uint32_t crc = 0xFFFFFFFF;
-	for (size_t i = 0; i < length; ++i) {
-		crc = crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
-	}
-	return crc ^ 0xFFFFFFFF;
+namespace {
+
+constexpr std::array<char[5], StateSnapshot::SECTION_COUNT> CHUNK_TAGS = {"CPU ", "PPU ", "APU ", "BUS ", "CART"};
+constexpr std::array<const char *, StateSnapshot::SECTION_COUNT> SECTION_NAMES = {"CPU", "PPU", "APU", "bus",
+																				  "cartridge"};
+
+constexpr char THUMBNAIL_TAG[5] = "THMB";
+constexpr size_t THUMBNAIL_PIXELS = static_cast<size_t>(SAVE_THUMBNAIL_WIDTH) * SAVE_THUMBNAIL_HEIGHT;
+constexpr size_t THUMBNAIL_BYTES = THUMBNAIL_PIXELS * sizeof(uint32_t);
+constexpr int THUMBNAIL_SCALE = 4;
+static_assert(SAVE_THUMBNAIL_WIDTH * THUMBNAIL_SCALE == 256 && SAVE_THUMBNAIL_HEIGHT * THUMBNAIL_SCALE == 240);
+
+// Timestamp and thumbnail from the start of a state file; exists is set
+// whenever there is a valid header
+SaveSlotInfo parse_slot_info(const uint8_t *data, size_t size) {
+	SaveSlotInfo info;
+	SaveStateHeader header;
+	if (size < sizeof(header)) {
+		return info;
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (!header.is_valid()) {
+		return info;
+	}
+	info.exists = true;
+	info.timestamp = std::chrono::system_clock::from_time_t(static_cast<std::time_t>(header.timestamp));
+
+	SaveStateChunk chunk;
+	if (header.version < 3 || size - sizeof(header) < sizeof(chunk)) {
+		return info;
+	}
+	std::memcpy(&chunk, data + sizeof(header), sizeof(chunk));
+	const uint8_t *stored = data + sizeof(header) + sizeof(chunk);
+	if (std::memcmp(chunk.tag, THUMBNAIL_TAG, sizeof(chunk.tag)) != 0 || chunk.size != THUMBNAIL_BYTES ||
+		chunk.stored_size > size - sizeof(header) - sizeof(chunk)) {
+		return info;
+	}
+	info.thumbnail.resize(THUMBNAIL_PIXELS);
+	auto *pixels = reinterpret_cast<uint8_t *>(info.thumbnail.data());
+	if (chunk.flags & SAVE_CHUNK_LZ4) {
+		if (!lz4_decompress(stored, chunk.stored_size, pixels, THUMBNAIL_BYTES)) {
+			info.thumbnail.clear();
+		}
+	} else if (chunk.stored_size == THUMBNAIL_BYTES) {
+		std::memcpy(pixels, stored, THUMBNAIL_BYTES);
+	} else {
+		info.thumbnail.clear();
+	}
+	return info;
 }
 
+} // namespace
+
 // SaveStateHeader implementation
 SaveStateHeader::SaveStateHeader() : version(SAVE_STATE_VERSION), crc32(0), timestamp(0), data_size(0) {
 	std::memcpy(magic, SAVE_STATE_MAGIC, 8);
@@ -71,6 +87,7 @@ SaveStateManager::SaveStateManager(CPU6502 *cpu, PPU *ppu, APU *apu, SystemBus *
 
 void SaveStateManager::set_save_directory(const std::filesystem::path &dir) {
 	save_directory_ = dir;
+	slot_cache_valid_ = false;
 }
 
 std::filesystem::path SaveStateManager::get_save_directory() const {
@@ -81,7 +98,11 @@ std::filesystem::path SaveStateManager::get_slot_path(int slot) const {
 	if (slot < 1 || slot > 9) {
 		return {};
 	}
+	ensure_slot_cache();
+	return slot_cache_[slot].path;
+}
 
+std::filesystem::path SaveStateManager::resolve_slot_path(int slot) const {
 	// Create filename based on ROM name and slot number
 	std::string rom_name = "default";
 	if (cartridge_ && cartridge_->is_loaded()) {
@@ -115,29 +136,80 @@ std::filesystem::path SaveStateManager::get_slot_path(int slot) const {
 }
 
 bool SaveStateManager::slot_exists(int slot) const {
-	auto path = get_slot_path(slot);
-	return !path.empty() && std::filesystem::exists(path);
+	return slot >= 1 && slot <= 9 && get_slot_info(slot).exists;
 }
 
 std::optional<std::chrono::system_clock::time_point> SaveStateManager::get_slot_timestamp(int slot) const {
-	if (!slot_exists(slot)) {
+	if (slot < 1 || slot > 9) {
 		return std::nullopt;
 	}
+	return get_slot_info(slot).timestamp;
+}
 
-	auto path = get_slot_path(slot);
+const SaveSlotInfo &SaveStateManager::get_slot_info(int slot) const {
+	static const SaveSlotInfo no_slot;
+	if (slot < QUICK_SAVE_SLOT || slot > 9) {
+		return no_slot;
+	}
+	ensure_slot_cache();
+	return slot_cache_[slot].info;
+}
+
+void SaveStateManager::refresh_slot_cache() {
+	slot_cache_valid_ = false;
+	ensure_slot_cache();
+}
+
+void SaveStateManager::ensure_slot_cache() const {
+	const uint32_t load_id = current_load_id();
+	if (slot_cache_valid_ && slot_cache_load_id_ == load_id) {
+		return;
+	}
+	for (int slot = QUICK_SAVE_SLOT; slot <= 9; ++slot) {
+		CachedSlot &cached = slot_cache_[slot];
+		cached.path = slot == QUICK_SAVE_SLOT ? get_quick_save_path() : resolve_slot_path(slot);
+		cached.info = read_slot_info(cached.path);
+	}
+	slot_cache_valid_ = true;
+	slot_cache_load_id_ = load_id;
+}
+
+void SaveStateManager::update_slot_cache(const std::filesystem::path &path, const std::vector<uint8_t> *data) {
+	if (!slot_cache_valid_ || slot_cache_load_id_ != current_load_id()) {
+		return; // Read from disk on next use anyway
+	}
+	for (CachedSlot &cached : slot_cache_) {
+		if (cached.path == path) {
+			cached.info = data ? parse_slot_info(data->data(), data->size()) : SaveSlotInfo{};
+		}
+	}
+}
+
+SaveSlotInfo SaveStateManager::read_slot_info(const std::filesystem::path &path) {
 	std::ifstream file(path, std::ios::binary);
 	if (!file) {
-		return std::nullopt;
+		return {};
 	}
 
-	SaveStateHeader header;
-	file.read(reinterpret_cast<char *>(&header), sizeof(header));
-
-	if (!header.is_valid()) {
-		return std::nullopt;
+	// The header and the first chunk's, then the thumbnail if that is one
+	std::vector<uint8_t> data(sizeof(SaveStateHeader) + sizeof(SaveStateChunk));
+	file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+	data.resize(static_cast<size_t>(file.gcount()));
+	if (data.size() == sizeof(SaveStateHeader) + sizeof(SaveStateChunk)) {
+		SaveStateChunk chunk;
+		std::memcpy(&chunk, data.data() + sizeof(SaveStateHeader), sizeof(chunk));
+		if (std::memcmp(chunk.tag, THUMBNAIL_TAG, sizeof(chunk.tag)) == 0 &&
+			chunk.stored_size <= lz4_compress_bound(THUMBNAIL_BYTES)) {
+			const size_t start = data.size();
+			data.resize(start + chunk.stored_size);
+			file.read(reinterpret_cast<char *>(data.data() + start), chunk.stored_size);
+			data.resize(start + static_cast<size_t>(file.gcount()));
+		}
 	}
 
-	return std::chrono::system_clock::from_time_t(static_cast<std::time_t>(header.timestamp));
+	SaveSlotInfo info = parse_slot_info(data.data(), data.size());
+	info.exists = true; // Even if unreadable: the slot is taken
+	return info;
 }
 
 uint32_t SaveStateManager::calculate_rom_crc32() const {
@@ -145,9 +217,12 @@ uint32_t SaveStateManager::calculate_rom_crc32() const {
 		return 0;
 	}
 
-	// Calculate CRC32 of PRG ROM data
-	const auto &prg_rom = cartridge_->get_prg_rom();
-	return calculate_crc32(prg_rom.data(), prg_rom.size());
+	// Computed by the ROM image when it loaded
+	return cartridge_->get_prg_rom_crc32();
+}
+
+uint32_t SaveStateManager::current_load_id() const {
+	return cartridge_ ? cartridge_->get_load_id() : 0;
 }
 
 // Serialization helper methods
@@ -237,47 +312,153 @@ void SaveStateManager::read_bytes(const std::vector<uint8_t> &buffer, size_t &of
 
 std::vector<uint8_t> SaveStateManager::serialize_state() {
 	std::vector<uint8_t> buffer;
+	serialize_state(buffer);
+	return buffer;
+}
 
-	// Reserve space for header (will write at end)
+void SaveStateManager::serialize_state(std::vector<uint8_t> &buffer) {
+	serialize_file(buffer, false);
+}
+
+void SaveStateManager::serialize_file(std::vector<uint8_t> &buffer, bool with_thumbnail) {
+	std::array<uint32_t, StateSnapshot::SECTION_COUNT + 1> offsets{};
+	raw_state_.clear();
+	serialize_components(raw_state_, offsets.data());
+
+	// Room for every chunk at its worst, so compressing never reallocates
+	size_t capacity = sizeof(SaveStateHeader);
+	if (with_thumbnail) {
+		capacity += sizeof(SaveStateChunk) + lz4_compress_bound(THUMBNAIL_BYTES);
+	}
+	for (size_t i = 0; i < StateSnapshot::SECTION_COUNT; ++i) {
+		capacity += sizeof(SaveStateChunk) + lz4_compress_bound(offsets[i + 1] - offsets[i]);
+	}
+	buffer.clear();
+	buffer.reserve(capacity);
 	buffer.resize(sizeof(SaveStateHeader));
+	if (with_thumbnail && ppu_) {
+		append_thumbnail(buffer);
+	}
+
+	for (size_t i = 0; i < StateSnapshot::SECTION_COUNT; ++i) {
+		const uint8_t *section = raw_state_.data() + offsets[i];
+		const size_t size = offsets[i + 1] - offsets[i];
+		SaveStateChunk chunk{};
+		std::memcpy(chunk.tag, CHUNK_TAGS[i], sizeof(chunk.tag));
+		chunk.size = static_cast<uint32_t>(size);
+
+		const size_t chunk_offset = buffer.size();
+		buffer.resize(chunk_offset + sizeof(SaveStateChunk));
+		if (compress_) {
+			lz4_compress(section, size, buffer);
+		}
+		if (!compress_ || buffer.size() - chunk_offset - sizeof(SaveStateChunk) >= size) {
+			// Stored as is when compressing does not pay
+			buffer.resize(chunk_offset + sizeof(SaveStateChunk));
+			buffer.insert(buffer.end(), section, section + size);
+		} else {
+			chunk.flags = SAVE_CHUNK_LZ4;
+		}
+		chunk.stored_size = static_cast<uint32_t>(buffer.size() - chunk_offset - sizeof(SaveStateChunk));
+		std::memcpy(buffer.data() + chunk_offset, &chunk, sizeof(chunk));
+	}
+
+	// Create and write header at the beginning
+	SaveStateHeader header;
+	header.crc32 = calculate_rom_crc32();
+	header.timestamp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	header.data_size = static_cast<uint32_t>(buffer.size() - sizeof(SaveStateHeader));
+
+	std::memcpy(buffer.data(), &header, sizeof(SaveStateHeader));
+}
+
+void SaveStateManager::append_thumbnail(std::vector<uint8_t> &buffer) {
+	// Each thumbnail pixel averages a 4x4 block of the frame, per channel
+	const uint32_t *frame = ppu_->get_frame_buffer();
+	std::array<uint32_t, THUMBNAIL_PIXELS> thumbnail;
+	for (int ty = 0; ty < SAVE_THUMBNAIL_HEIGHT; ++ty) {
+		for (int tx = 0; tx < SAVE_THUMBNAIL_WIDTH; ++tx) {
+			uint32_t sums[4] = {};
+			for (int y = 0; y < THUMBNAIL_SCALE; ++y) {
+				const uint32_t *row = frame + (ty * THUMBNAIL_SCALE + y) * 256 + tx * THUMBNAIL_SCALE;
+				for (int x = 0; x < THUMBNAIL_SCALE; ++x) {
+					for (int c = 0; c < 4; ++c) {
+						sums[c] += (row[x] >> (c * 8)) & 0xFF;
+					}
+				}
+			}
+			uint32_t pixel = 0;
+			for (int c = 0; c < 4; ++c) {
+				pixel |= (sums[c] / (THUMBNAIL_SCALE * THUMBNAIL_SCALE)) << (c * 8);
+			}
+			thumbnail[ty * SAVE_THUMBNAIL_WIDTH + tx] = pixel;
+		}
+	}
+
+	SaveStateChunk chunk{};
+	std::memcpy(chunk.tag, THUMBNAIL_TAG, sizeof(chunk.tag));
+	chunk.flags = SAVE_CHUNK_LZ4;
+	chunk.size = static_cast<uint32_t>(THUMBNAIL_BYTES);
+	const size_t chunk_offset = buffer.size();
+	buffer.resize(chunk_offset + sizeof(SaveStateChunk));
+	lz4_compress(reinterpret_cast<const uint8_t *>(thumbnail.data()), THUMBNAIL_BYTES, buffer);
+	chunk.stored_size = static_cast<uint32_t>(buffer.size() - chunk_offset - sizeof(SaveStateChunk));
+	std::memcpy(buffer.data() + chunk_offset, &chunk, sizeof(chunk));
+}
+
+void SaveStateManager::serialize_components(std::vector<uint8_t> &buffer, uint32_t *offsets, bool cartridge_ram) {
+	const auto begin_section = [&](StateSnapshot::Section section) {
+		if (offsets) {
+			offsets[static_cast<size_t>(section)] = static_cast<uint32_t>(buffer.size());
+		}
+	};
+
+	// Under catch-up sync the PPU may be behind the CPU; settle it first
+	if (bus_) {
+		bus_->sync_ppu();
+	}
 
 	// Serialize CPU state
+	begin_section(StateSnapshot::Section::Cpu);
 	if (cpu_) {
 		cpu_->serialize_state(buffer);
 	}
 
 	// Serialize PPU state
+	begin_section(StateSnapshot::Section::Ppu);
 	if (ppu_) {
 		ppu_->serialize_state(buffer);
 	}
 
-	// Serialize APU state
+	// Serialize APU state (band-limited synthesis advances channels lazily)
+	begin_section(StateSnapshot::Section::Apu);
 	if (apu_) {
+		apu_->sync_channels();
 		apu_->serialize_state(buffer);
 	}
 
 	// Serialize memory state (Work RAM, PRG RAM, CHR RAM)
+	begin_section(StateSnapshot::Section::Bus);
 	if (bus_) {
 		bus_->serialize_state(buffer);
 	}
 
 	// Serialize cartridge/mapper state
+	begin_section(StateSnapshot::Section::Cartridge);
 	if (cartridge_) {
-		cartridge_->serialize_state(buffer);
+		if (cartridge_ram) {
+			cartridge_->serialize_state(buffer);
+		} else {
+			cartridge_->serialize_registers(buffer);
+		}
 	}
 
-	// Create and write header at the beginning
-	SaveStateHeader header;
-	header.crc32 = calculate_rom_crc32();
-	header.timestamp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	header.data_size = static_cast<uint32_t>(buffer.size() - sizeof(SaveStateHeader));
-
-	std::memcpy(buffer.data(), &header, sizeof(SaveStateHeader));
-
-	return buffer;
+	if (offsets) {
+		offsets[StateSnapshot::SECTION_COUNT] = static_cast<uint32_t>(buffer.size());
+	}
 }
 
-bool SaveStateManager::deserialize_state(const std::vector<uint8_t> &data) {
+bool SaveStateManager::deserialize_state(const std::vector<uint8_t> &data, uint32_t sections) {
 	if (data.size() < sizeof(SaveStateHeader)) {
 		last_error_ = "Invalid save state: file too small";
 		return false;
@@ -299,65 +480,208 @@ bool SaveStateManager::deserialize_state(const std::vector<uint8_t> &data) {
 		return false;
 	}
 
-	// Deserialize component states
-	size_t offset = sizeof(SaveStateHeader);
+	if (header.version >= 3) {
+		return deserialize_chunks(data, sections);
+	}
 
+	// Version 2: the components back to back, so all or nothing
+	if ((sections & ALL_SECTIONS) != ALL_SECTIONS) {
+		last_error_ = "Save state predates sections and can only be loaded whole";
+		return false;
+	}
 	try {
-		if (cpu_) {
-			cpu_->deserialize_state(data, offset);
-		}
+		deserialize_components(data, sizeof(SaveStateHeader));
+	} catch (const std::exception &e) {
+		last_error_ = std::string("Deserialization error: ") + e.what();
+		return false;
+	}
 
-		if (ppu_) {
-			ppu_->deserialize_state(data, offset);
-		}
+	return true;
+}
 
-		if (apu_) {
-			apu_->deserialize_state(data, offset);
+bool SaveStateManager::deserialize_chunks(const std::vector<uint8_t> &data, uint32_t sections) {
+	// Decode every wanted chunk before touching any component, so a damaged
+	// file leaves the running state alone
+	uint32_t found = 0;
+	size_t offset = sizeof(SaveStateHeader);
+	while (data.size() - offset >= sizeof(SaveStateChunk)) {
+		SaveStateChunk chunk;
+		std::memcpy(&chunk, data.data() + offset, sizeof(chunk));
+		offset += sizeof(chunk);
+		if (chunk.stored_size > data.size() - offset) {
+			last_error_ = "Invalid save state: truncated section";
+			return false;
+		}
+		const uint8_t *stored = data.data() + offset;
+		offset += chunk.stored_size;
+
+		const auto tag = std::find_if(CHUNK_TAGS.begin(), CHUNK_TAGS.end(), [&](const char(&known)[5]) {
+			return std::memcmp(chunk.tag, known, sizeof(chunk.tag)) == 0;
+		});
+		const auto index = static_cast<size_t>(tag - CHUNK_TAGS.begin());
+		if (tag == CHUNK_TAGS.end() || (sections & (1u << index)) == 0) {
+			continue; // From a newer build, or not asked for
 		}
 
-		if (bus_) {
-			bus_->deserialize_state(data, offset);
+		const bool lz4 = (chunk.flags & SAVE_CHUNK_LZ4) != 0;
+		if (!save_chunk_size_plausible(chunk.size, chunk.stored_size, lz4)) {
+			last_error_ = "Invalid save state: section size mismatch";
+			return false;
+		}
+		std::vector<uint8_t> &section = loaded_sections_[index];
+		if (lz4) {
+			section.resize(chunk.size);
+			if (!lz4_decompress(stored, chunk.stored_size, section.data(), section.size())) {
+				last_error_ = std::string("Invalid save state: corrupt ") + SECTION_NAMES[index] + " section";
+				return false;
+			}
+		} else {
+			section.assign(stored, stored + chunk.size);
 		}
+		found |= 1u << index;
+	}
 
-		if (cartridge_) {
-			cartridge_->deserialize_state(data, offset);
+	const uint32_t missing = sections & ALL_SECTIONS & ~found;
+	if (missing != 0) {
+		const auto index = static_cast<size_t>(std::countr_zero(missing));
+		last_error_ = std::string("Save state has no ") + SECTION_NAMES[index] + " section";
+		return false;
+	}
+
+	try {
+		for (size_t i = 0; i < StateSnapshot::SECTION_COUNT; ++i) {
+			if (found & (1u << i)) {
+				size_t section_offset = 0;
+				deserialize_section(static_cast<StateSnapshot::Section>(i), loaded_sections_[i], section_offset);
+			}
 		}
 	} catch (const std::exception &e) {
 		last_error_ = std::string("Deserialization error: ") + e.what();
 		return false;
 	}
-
 	return true;
 }
 
-bool SaveStateManager::save_to_file(const std::filesystem::path &path) {
-	// Ensure save directory exists
-	std::filesystem::create_directories(path.parent_path());
+void SaveStateManager::deserialize_components(const std::vector<uint8_t> &buffer, size_t offset) {
+	for (size_t i = 0; i < StateSnapshot::SECTION_COUNT; ++i) {
+		deserialize_section(static_cast<StateSnapshot::Section>(i), buffer, offset);
+	}
+}
+
+void SaveStateManager::deserialize_section(StateSnapshot::Section section, const std::vector<uint8_t> &buffer,
+										   size_t &offset) {
+	switch (section) {
+	case StateSnapshot::Section::Cpu:
+		if (cpu_) {
+			cpu_->deserialize_state(buffer, offset);
+		}
+		break;
+	case StateSnapshot::Section::Ppu:
+		if (ppu_) {
+			ppu_->deserialize_state(buffer, offset);
+		}
+		break;
+	case StateSnapshot::Section::Apu:
+		if (apu_) {
+			apu_->deserialize_state(buffer, offset);
+		}
+		break;
+	case StateSnapshot::Section::Bus:
+		if (bus_) {
+			bus_->deserialize_state(buffer, offset);
+		}
+		break;
+	case StateSnapshot::Section::Cartridge:
+		if (cartridge_) {
+			cartridge_->deserialize_state(buffer, offset);
+		}
+		break;
+	}
+}
 
-	// Serialize state
-	auto data = serialize_state();
+void SaveStateManager::capture(StateSnapshot &snapshot) {
+	const uint32_t load_id = current_load_id();
+	snapshot_head_.clear();
+	serialize_components(snapshot_head_, snapshot.offsets_.data(), false);
 
-	// Write to file
-	std::ofstream file(path, std::ios::binary);
-	if (!file) {
-		last_error_ = "Failed to open file for writing: " + path.string();
-		return false;
+	// The cartridge RAM goes in front of the mapper registers, as in a save
+	// file, but only its pages written since this snapshot last synced
+	const size_t ram_size = cartridge_ ? cartridge_->tracked_ram_size() : 0;
+	const size_t ram_at = snapshot.offsets_[static_cast<size_t>(StateSnapshot::Section::Cartridge)];
+	if (snapshot.bytes_.size() != snapshot_head_.size() + ram_size) {
+		snapshot.ram_mark_ = {};
+		snapshot.bytes_.resize(snapshot_head_.size() + ram_size);
+	}
+	std::memcpy(snapshot.bytes_.data(), snapshot_head_.data(), ram_at);
+	if (cartridge_) {
+		cartridge_->save_ram_pages(snapshot.bytes_.data() + ram_at, snapshot.ram_mark_);
 	}
+	std::memcpy(snapshot.bytes_.data() + ram_at + ram_size, snapshot_head_.data() + ram_at,
+				snapshot_head_.size() - ram_at);
+	snapshot.offsets_[StateSnapshot::SECTION_COUNT] += static_cast<uint32_t>(ram_size);
+	snapshot.load_id_ = load_id;
+	snapshot.valid_ = true;
 
-	file.write(reinterpret_cast<const char *>(data.data()), data.size());
+	snapshot_size_ = snapshot.bytes_.size();
+	snapshot_size_load_id_ = load_id;
+}
 
-	if (!file) {
-		last_error_ = "Failed to write save state file: " + path.string();
+bool SaveStateManager::restore(const StateSnapshot &snapshot) {
+	if (!snapshot.valid_ || snapshot.load_id_ != current_load_id()) {
+		last_error_ = "Snapshot is empty or for a different ROM";
 		return false;
 	}
+	try {
+		size_t offset = 0;
+		for (size_t i = 0; i < static_cast<size_t>(StateSnapshot::Section::Cartridge); ++i) {
+			deserialize_section(static_cast<StateSnapshot::Section>(i), snapshot.bytes_, offset);
+		}
+		if (cartridge_) {
+			cartridge_->load_ram_pages(snapshot.bytes_.data() + offset, snapshot.ram_mark_);
+			offset += cartridge_->tracked_ram_size();
+			cartridge_->deserialize_registers(snapshot.bytes_, offset);
+		}
+	} catch (const std::exception &e) {
+		last_error_ = std::string("Snapshot restore error: ") + e.what();
+		return false;
+	}
+	return true;
+}
 
+size_t SaveStateManager::snapshot_size() {
+	if (snapshot_size_ == 0 || snapshot_size_load_id_ != current_load_id()) {
+		StateSnapshot probe;
+		capture(probe);
+	}
+	return snapshot_size_;
+}
+
+bool SaveStateManager::save_to_file(const std::filesystem::path &path) {
+	std::vector<uint8_t> data;
+	serialize_file(data, true);
+	const FileWriteResult result = AsyncFileWriter::write_file(path, data);
+	if (!result.ok) {
+		last_error_ = "Failed to write save state file: " + result.error;
+		return false;
+	}
+	update_slot_cache(path, &data);
 	return true;
 }
 
+std::future<FileWriteResult> SaveStateManager::save_to_file_async(const std::filesystem::path &path,
+																  AsyncFileWriter &writer) {
+	std::vector<uint8_t> data;
+	serialize_file(data, true);
+	// Shown as saved straight away; refresh_slot_cache() if the write fails
+	update_slot_cache(path, &data);
+	return writer.write(path, std::move(data));
+}
+
 bool SaveStateManager::load_from_file(const std::filesystem::path &path) {
 	// Check if file exists
 	if (!std::filesystem::exists(path)) {
 		last_error_ = "Save state file not found: " + path.string();
+		update_slot_cache(path, nullptr);
 		return false;
 	}
 
@@ -380,6 +704,9 @@ bool SaveStateManager::load_from_file(const std::filesystem::path &path) {
 		return false;
 	}
 
+	// Whatever it holds is what the slot menu should show
+	update_slot_cache(path, &data);
+
 	// Deserialize
 	return deserialize_state(data);
 }
@@ -399,6 +726,16 @@ bool SaveStateManager::save_to_slot(int slot) {
 	return save_to_file(path);
 }
 
+std::future<FileWriteResult> SaveStateManager::save_to_slot_async(int slot, AsyncFileWriter &writer) {
+	if (slot < 1 || slot > 9) {
+		last_error_ = "Invalid slot number (must be 1-9)";
+		std::promise<FileWriteResult> failed;
+		failed.set_value({false, last_error_});
+		return failed.get_future();
+	}
+	return save_to_file_async(get_slot_path(slot), writer);
+}
+
 bool SaveStateManager::load_from_slot(int slot) {
 	if (slot < 1 || slot > 9) {
 		last_error_ = "Invalid slot number (must be 1-9)";
@@ -415,13 +752,19 @@ bool SaveStateManager::load_from_slot(int slot) {
 }
 
 bool SaveStateManager::quick_save() {
-	auto path = save_directory_ / "quicksave.vns";
-	return save_to_file(path);
+	return save_to_file(get_quick_save_path());
+}
+
+std::future<FileWriteResult> SaveStateManager::quick_save_async(AsyncFileWriter &writer) {
+	return save_to_file_async(get_quick_save_path(), writer);
 }
 
 bool SaveStateManager::quick_load() {
-	auto path = save_directory_ / "quicksave.vns";
-	return load_from_file(path);
+	return load_from_file(get_quick_save_path());
+}
+
+std::filesystem::path SaveStateManager::get_quick_save_path() const {
+	return save_directory_ / "quicksave.vns";
 }
 
 } // namespace nes
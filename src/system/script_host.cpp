@@ -0,0 +1,115 @@
+#include "system/script_host.hpp"
+#include "core/breakpoints.hpp"
+#include "core/bus.hpp"
+#include "input/latched_input.hpp"
+#include "system/headless_system.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace nes {
+
+ScriptHost::ScriptHost(HeadlessSystem &system, std::shared_ptr<LatchedInputSource> input)
+	: system_(system), input_(std::move(input)) {
+}
+
+ScriptHost::~ScriptHost() {
+	clear();
+}
+
+std::uint64_t ScriptHost::run_frame() {
+	const std::uint64_t frame = system_.get_frame_count();
+	const std::uint64_t executed = system_.run_frame();
+	if (system_.get_frame_count() == frame) {
+		return executed;
+	}
+	// Index loop: a hook may register further frame hooks (run from the next
+	// frame on) or remove itself
+	for (std::size_t i = 0; i < frame_hooks_.size(); ++i) {
+		const int id = frame_hooks_[i].id;
+		FrameHook hook = frame_hooks_[i].hook;
+		hook(*this);
+		if (i < frame_hooks_.size() && frame_hooks_[i].id != id) {
+			--i; // This hook removed itself; the next one moved into its slot
+		}
+	}
+	return executed;
+}
+
+int ScriptHost::on_frame(FrameHook hook) {
+	if (!hook) {
+		return 0;
+	}
+	const int id = next_frame_id_--;
+	frame_hooks_.push_back({id, std::move(hook)});
+	return id;
+}
+
+int ScriptHost::on_write(Address first, Address last, MemoryHook hook, std::string_view condition,
+						 std::string *error) {
+	return add_memory_hook(Breakpoints::CPU_WRITE, first, last, std::move(hook), condition, error);
+}
+
+int ScriptHost::on_read(Address first, Address last, MemoryHook hook, std::string_view condition,
+						std::string *error) {
+	return add_memory_hook(Breakpoints::CPU_READ, first, last, std::move(hook), condition, error);
+}
+
+int ScriptHost::add_memory_hook(std::uint8_t kind, Address first, Address last, MemoryHook hook,
+								std::string_view condition, std::string *error) {
+	if (!hook) {
+		return 0;
+	}
+	const int id = system_.bus().breakpoints().add_hook(
+		kind, first, last,
+		[hook = std::move(hook)](const BreakpointHit &hit) { hook(hit.address, hit.value); }, condition, error);
+	if (id != 0) {
+		memory_hooks_.push_back(id);
+	}
+	return id;
+}
+
+bool ScriptHost::remove(int id) {
+	if (id < 0) {
+		const auto it =
+			std::find_if(frame_hooks_.begin(), frame_hooks_.end(), [id](const FrameEntry &e) { return e.id == id; });
+		if (it == frame_hooks_.end()) {
+			return false;
+		}
+		frame_hooks_.erase(it);
+		return true;
+	}
+	const auto it = std::find(memory_hooks_.begin(), memory_hooks_.end(), id);
+	if (it == memory_hooks_.end()) {
+		return false;
+	}
+	memory_hooks_.erase(it);
+	return system_.bus().breakpoints().remove(id);
+}
+
+void ScriptHost::clear() {
+	frame_hooks_.clear();
+	for (const int id : memory_hooks_) {
+		system_.bus().breakpoints().remove(id);
+	}
+	memory_hooks_.clear();
+}
+
+Byte ScriptHost::peek(Address address) const {
+	return system_.bus().peek(address);
+}
+
+void ScriptHost::read_memory(Address first, std::span<Byte> out) const {
+	system_.bus().peek_range(first, out);
+}
+
+void ScriptHost::set_buttons(int player_index, Byte buttons) {
+	if (input_) {
+		input_->set_buttons(player_index, buttons);
+	}
+}
+
+std::uint64_t ScriptHost::get_frame_count() const {
+	return system_.get_frame_count();
+}
+
+} // namespace nes
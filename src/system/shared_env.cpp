@@ -0,0 +1,390 @@
+#include "system/shared_env.hpp"
+#include "input/latched_input.hpp"
+#include "memory/ram.hpp"
+#include "ppu/ppu.hpp"
+#include "system/headless_system.hpp"
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+#endif
+
+namespace nes {
+
+/**
+ * SharedMemory - One named shared region and the means to wake its waiters
+ */
+class SharedMemory {
+  public:
+	~SharedMemory() {
+		close();
+	}
+
+	bool create(const std::string &name, std::size_t size);
+	bool open(const std::string &name, std::size_t size);
+	void close() noexcept;
+
+	[[nodiscard]] void *data() const noexcept {
+		return view_;
+	}
+
+	// Block while word still holds expected, for up to timeout (spurious
+	// returns allowed: callers re-check)
+	void wait(const std::atomic<std::uint32_t> &word, std::uint32_t expected, std::chrono::milliseconds timeout);
+	void wake(std::atomic<std::uint32_t> &word);
+
+  private:
+	void *view_ = nullptr;
+	std::size_t size_ = 0;
+	bool owner_ = false;
+	std::string name_;
+#if defined(_WIN32)
+	HANDLE mapping_ = nullptr;
+	HANDLE request_event_ = nullptr; // Woken for SharedEnvRegion::request
+	HANDLE done_event_ = nullptr;	 // ... and done
+	HANDLE event_for(const std::atomic<std::uint32_t> &word) const;
+	bool open_events(bool create);
+#endif
+};
+
+#if defined(_WIN32)
+
+namespace {
+
+std::wstring wide(const std::string &text) {
+	return std::wstring(text.begin(), text.end());
+}
+
+} // namespace
+
+bool SharedMemory::create(const std::string &name, std::size_t size) {
+	close();
+	const std::wstring object = L"Local\\" + wide(name);
+	mapping_ = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+								  static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32),
+								  static_cast<DWORD>(size & 0xFFFFFFFFu), object.c_str());
+	if (!mapping_) {
+		return false;
+	}
+	view_ = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	size_ = size;
+	owner_ = true;
+	name_ = name;
+	if (!view_ || !open_events(true)) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool SharedMemory::open(const std::string &name, std::size_t size) {
+	close();
+	const std::wstring object = L"Local\\" + wide(name);
+	mapping_ = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, object.c_str());
+	if (!mapping_) {
+		return false;
+	}
+	view_ = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	size_ = size;
+	name_ = name;
+	if (!view_ || !open_events(false)) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool SharedMemory::open_events(bool create) {
+	const std::wstring request = L"Local\\" + wide(name_) + L".request";
+	const std::wstring done = L"Local\\" + wide(name_) + L".done";
+	if (create) {
+		request_event_ = CreateEventW(nullptr, FALSE, FALSE, request.c_str());
+		done_event_ = CreateEventW(nullptr, FALSE, FALSE, done.c_str());
+	} else {
+		request_event_ = OpenEventW(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, request.c_str());
+		done_event_ = OpenEventW(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, done.c_str());
+	}
+	return request_event_ && done_event_;
+}
+
+void SharedMemory::close() noexcept {
+	for (HANDLE *handle : {&request_event_, &done_event_, &mapping_}) {
+		if (*handle) {
+			CloseHandle(*handle);
+			*handle = nullptr;
+		}
+	}
+	if (view_) {
+		UnmapViewOfFile(view_);
+		view_ = nullptr;
+	}
+	owner_ = false; // The mapping goes with its last handle
+}
+
+HANDLE SharedMemory::event_for(const std::atomic<std::uint32_t> &word) const {
+	const auto *region = static_cast<const SharedEnvRegion *>(view_);
+	return &word == &region->request ? request_event_ : done_event_;
+}
+
+void SharedMemory::wait(const std::atomic<std::uint32_t> &word, std::uint32_t expected,
+						std::chrono::milliseconds timeout) {
+	if (word.load(std::memory_order_acquire) == expected) {
+		WaitForSingleObject(event_for(word), static_cast<DWORD>(timeout.count()));
+	}
+}
+
+void SharedMemory::wake(std::atomic<std::uint32_t> &word) {
+	SetEvent(event_for(word));
+}
+
+#else
+
+bool SharedMemory::create(const std::string &name, std::size_t size) {
+	close();
+	const std::string object = "/" + name;
+	::shm_unlink(object.c_str()); // Left over from a run that did not exit cleanly
+	const int fd = ::shm_open(object.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		return false;
+	}
+	void *view = MAP_FAILED;
+	if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+		view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	::close(fd);
+	if (view == MAP_FAILED) {
+		::shm_unlink(object.c_str());
+		return false;
+	}
+	view_ = view;
+	size_ = size;
+	owner_ = true;
+	name_ = name;
+	return true;
+}
+
+bool SharedMemory::open(const std::string &name, std::size_t size) {
+	close();
+	const int fd = ::shm_open(("/" + name).c_str(), O_RDWR, 0);
+	if (fd < 0) {
+		return false;
+	}
+	void *view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+	view_ = view;
+	size_ = size;
+	name_ = name;
+	return true;
+}
+
+void SharedMemory::close() noexcept {
+	if (view_) {
+		::munmap(view_, size_);
+		view_ = nullptr;
+	}
+	if (owner_) {
+		::shm_unlink(("/" + name_).c_str());
+		owner_ = false;
+	}
+}
+
+#if defined(__linux__)
+
+void SharedMemory::wait(const std::atomic<std::uint32_t> &word, std::uint32_t expected,
+						std::chrono::milliseconds timeout) {
+	const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+	timespec relative{};
+	relative.tv_sec = static_cast<time_t>(seconds.count());
+	relative.tv_nsec = static_cast<long>(std::chrono::nanoseconds(timeout - seconds).count());
+	::syscall(SYS_futex, reinterpret_cast<const std::uint32_t *>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+}
+
+void SharedMemory::wake(std::atomic<std::uint32_t> &word) {
+	::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+void SharedMemory::wait(const std::atomic<std::uint32_t> &word, std::uint32_t expected,
+						std::chrono::milliseconds timeout) {
+	// No cross-process wait on this platform: poll
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (word.load(std::memory_order_acquire) == expected && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}
+}
+
+void SharedMemory::wake(std::atomic<std::uint32_t> &) {
+}
+
+#endif
+#endif
+
+// --- SharedMemoryEnv ---
+
+SharedMemoryEnv::SharedMemoryEnv(HeadlessSystem &system, std::shared_ptr<LatchedInputSource> input)
+	: system_(system), input_(std::move(input)) {
+}
+
+SharedMemoryEnv::~SharedMemoryEnv() {
+	if (region_) {
+		system_.ppu().set_index_buffer(nullptr);
+	}
+}
+
+bool SharedMemoryEnv::create(const std::string &name) {
+	if (region_) {
+		system_.ppu().set_index_buffer(nullptr);
+		region_ = nullptr;
+	}
+	memory_ = std::make_unique<SharedMemory>();
+	if (!memory_->create(name, sizeof(SharedEnvRegion))) {
+		memory_.reset();
+		return false;
+	}
+	region_ = new (memory_->data()) SharedEnvRegion{};
+	std::memcpy(region_->magic, SharedEnvRegion::MAGIC, sizeof(region_->magic));
+	region_->version = SharedEnvRegion::VERSION;
+	region_->size = sizeof(SharedEnvRegion);
+	served_ = 0;
+	system_.ppu().set_index_buffer(region_->frame);
+	publish(0, true);
+	return true;
+}
+
+SharedMemoryEnv::Served SharedMemoryEnv::serve_one(std::chrono::milliseconds timeout) {
+	if (!region_) {
+		return Served::Quit;
+	}
+	std::uint32_t request = region_->request.load(std::memory_order_acquire);
+	if (request == served_) {
+		memory_->wait(region_->request, served_, timeout);
+		request = region_->request.load(std::memory_order_acquire);
+		if (request == served_) {
+			return Served::Idle;
+		}
+	}
+
+	const auto command = static_cast<SharedEnvCommand>(region_->command);
+	std::uint64_t cycles = 0;
+	bool ok = true;
+	switch (command) {
+	case SharedEnvCommand::Step:
+		for (int player = 0; player < LatchedInputSource::PLAYERS; ++player) {
+			input_->set_buttons(player, region_->buttons[player]);
+		}
+		for (std::uint32_t frame = 0; frame < region_->frames; ++frame) {
+			cycles += system_.run_frame();
+		}
+		break;
+	case SharedEnvCommand::Reset:
+		system_.reset();
+		break;
+	case SharedEnvCommand::Quit:
+		break;
+	default:
+		ok = false;
+		break;
+	}
+	publish(cycles, ok);
+	served_ = request;
+	region_->done.store(request, std::memory_order_release);
+	memory_->wake(region_->done);
+	return command == SharedEnvCommand::Quit ? Served::Quit : Served::Command;
+}
+
+void SharedMemoryEnv::serve() {
+	while (serve_one(std::chrono::milliseconds(250)) != Served::Quit) {
+	}
+}
+
+void SharedMemoryEnv::publish(std::uint64_t cpu_cycles, bool ok) {
+	std::memcpy(region_->ram, system_.ram().data(), RAM_SIZE);
+	region_->frame_count = system_.get_frame_count();
+	region_->cpu_cycles = cpu_cycles;
+	region_->status = ok ? 0 : 1;
+}
+
+// --- SharedMemoryEnvClient ---
+
+SharedMemoryEnvClient::SharedMemoryEnvClient() = default;
+SharedMemoryEnvClient::~SharedMemoryEnvClient() = default;
+
+bool SharedMemoryEnvClient::open(const std::string &name) {
+	memory_ = std::make_unique<SharedMemory>();
+	region_ = nullptr;
+	if (!memory_->open(name, sizeof(SharedEnvRegion))) {
+		memory_.reset();
+		return false;
+	}
+	auto *region = static_cast<SharedEnvRegion *>(memory_->data());
+	if (std::memcmp(region->magic, SharedEnvRegion::MAGIC, sizeof(region->magic)) != 0 ||
+		region->version != SharedEnvRegion::VERSION || region->size != sizeof(SharedEnvRegion)) {
+		memory_.reset();
+		return false;
+	}
+	region_ = region;
+	return true;
+}
+
+bool SharedMemoryEnvClient::step(std::uint32_t frames, const std::array<std::uint8_t, 4> &buttons,
+								 std::chrono::milliseconds timeout) {
+	if (!region_) {
+		return false;
+	}
+	region_->frames = frames;
+	std::memcpy(region_->buttons, buttons.data(), buttons.size());
+	return wait_done(send(SharedEnvCommand::Step), timeout);
+}
+
+bool SharedMemoryEnvClient::reset(std::chrono::milliseconds timeout) {
+	return region_ && wait_done(send(SharedEnvCommand::Reset), timeout);
+}
+
+void SharedMemoryEnvClient::quit() {
+	if (region_) {
+		send(SharedEnvCommand::Quit);
+	}
+}
+
+std::uint32_t SharedMemoryEnvClient::send(SharedEnvCommand command) {
+	region_->command = static_cast<std::uint32_t>(command);
+	const std::uint32_t request = region_->request.fetch_add(1, std::memory_order_acq_rel) + 1;
+	memory_->wake(region_->request);
+	return request;
+}
+
+bool SharedMemoryEnvClient::wait_done(std::uint32_t request, std::chrono::milliseconds timeout) {
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (true) {
+		const std::uint32_t done = region_->done.load(std::memory_order_acquire);
+		if (done == request) {
+			return region_->status == 0;
+		}
+		const auto left =
+			std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		if (left.count() <= 0) {
+			return false;
+		}
+		memory_->wait(region_->done, done, left);
+	}
+}
+
+} // namespace nes
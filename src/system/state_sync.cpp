@@ -0,0 +1,527 @@
+#include "system/state_sync.hpp"
+#include "core/lz4_block.hpp"
+#include "system/async_file_writer.hpp"
+#include "system/save_state.hpp"
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+namespace nes {
+
+namespace {
+
+// Objects: [magic][generation][sequence][header size][header]
+//          [section count] then per section [tag][size][stored size][LZ4]
+// The manifest: [magic][generation][sequence][base bytes][delta bytes]
+constexpr char BASE_MAGIC[4] = {'V', 'N', 'S', 'B'};
+constexpr char DELTA_MAGIC[4] = {'V', 'N', 'S', 'D'};
+constexpr char MANIFEST_MAGIC[4] = {'V', 'N', 'S', 'M'};
+constexpr std::size_t MANIFEST_SIZE = 20;
+
+void put_u32(std::vector<std::uint8_t> &out, std::uint32_t value) {
+	const std::size_t at = out.size();
+	out.resize(at + sizeof(value));
+	std::memcpy(out.data() + at, &value, sizeof(value));
+}
+
+bool get_u32(const std::vector<std::uint8_t> &in, std::size_t &offset, std::uint32_t &value) {
+	if (in.size() - offset < sizeof(value)) {
+		return false;
+	}
+	std::memcpy(&value, in.data() + offset, sizeof(value));
+	offset += sizeof(value);
+	return true;
+}
+
+std::string manifest_key(const std::string &key) {
+	return key + "/manifest";
+}
+
+std::string base_key(const std::string &key, std::uint32_t generation) {
+	return std::format("{}/base-{}", key, generation);
+}
+
+std::string delta_key(const std::string &key, std::uint32_t generation, std::uint32_t sequence) {
+	return std::format("{}/delta-{}-{}", key, generation, sequence);
+}
+
+std::string cache_key(const std::string &key) {
+	return key + "/latest";
+}
+
+} // namespace
+
+// --- DirectoryStateStore ---
+
+bool DirectoryStateStore::put(const std::string &key, std::span<const std::uint8_t> bytes) {
+	const FileWriteResult result = AsyncFileWriter::write_file(root_ / key, bytes);
+	if (!result.ok) {
+		std::cerr << "State store: " << result.error << std::endl;
+	}
+	return result.ok;
+}
+
+std::optional<std::vector<std::uint8_t>> DirectoryStateStore::get(const std::string &key) {
+	std::ifstream file(root_ / key, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return std::nullopt;
+	}
+	std::vector<std::uint8_t> bytes(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+		return std::nullopt;
+	}
+	return bytes;
+}
+
+bool DirectoryStateStore::remove(const std::string &key) {
+	std::error_code error;
+	return std::filesystem::remove(root_ / key, error);
+}
+
+// --- StateSync ---
+
+StateSync::StateSync(StateStore &remote, StateStore *cache)
+	: remote_(remote), cache_(cache), worker_([this] { run(); }) {
+}
+
+StateSync::~StateSync() {
+	{
+		std::lock_guard lock(mutex_);
+		stopping_ = true;
+	}
+	work_ready_.notify_one();
+	worker_.join();
+}
+
+std::string StateSync::key_for(const std::string &player, std::uint32_t rom_crc32) {
+	return std::format("{}/{:08X}", player, rom_crc32);
+}
+
+std::future<bool> StateSync::upload(std::string key, std::vector<std::uint8_t> state) {
+	std::promise<bool> promise;
+	std::future<bool> future = promise.get_future();
+	{
+		std::lock_guard lock(mutex_);
+		const auto waiting = std::find_if(queue_.begin(), queue_.end(),
+										  [&](const Job &queued) { return !queued.fetch && queued.key == key; });
+		if (waiting != queue_.end()) {
+			waiting->state = std::move(state); // Only the newest state matters
+			waiting->uploaded.push_back(std::move(promise));
+			return future;
+		}
+		Job job;
+		job.key = std::move(key);
+		job.state = std::move(state);
+		job.uploaded.push_back(std::move(promise));
+		queue_.push_back(std::move(job));
+	}
+	work_ready_.notify_one();
+	return future;
+}
+
+void StateSync::prefetch(const std::string &key) {
+	{
+		std::lock_guard lock(mutex_);
+		if (prefetched_.contains(key)) {
+			return;
+		}
+		Job job;
+		job.key = key;
+		job.fetch = true;
+		prefetched_[key] = job.fetched.get_future().share();
+		queue_.push_back(std::move(job));
+	}
+	work_ready_.notify_one();
+}
+
+std::optional<std::vector<std::uint8_t>> StateSync::take(const std::string &key) {
+	prefetch(key);
+	std::shared_future<FetchResult> result;
+	{
+		std::lock_guard lock(mutex_);
+		result = std::move(prefetched_[key]);
+		prefetched_.erase(key);
+	}
+	return result.get();
+}
+
+void StateSync::wait_idle() {
+	std::unique_lock lock(mutex_);
+	idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+StateSync::Stats StateSync::stats() const {
+	std::lock_guard lock(mutex_);
+	return stats_;
+}
+
+void StateSync::run() {
+	std::unique_lock lock(mutex_);
+	while (true) {
+		work_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+		if (queue_.empty()) {
+			return; // Stopping, with everything done
+		}
+		Job job = std::move(queue_.front());
+		queue_.pop_front();
+		busy_ = true;
+		lock.unlock();
+
+		if (job.fetch) {
+			job.fetched.set_value(fetch(job.key));
+		} else {
+			const bool sent = send(job.key, job.state);
+			for (std::promise<bool> &promise : job.uploaded) {
+				promise.set_value(sent);
+			}
+		}
+
+		lock.lock();
+		busy_ = false;
+		if (queue_.empty()) {
+			idle_.notify_all();
+		}
+	}
+}
+
+bool StateSync::send(const std::string &key, const std::vector<std::uint8_t> &state) {
+	Track next;
+	if (!split_state(state, next)) {
+		std::cerr << "State sync: " << key << ": not a sectioned save state" << std::endl;
+		return false;
+	}
+	const std::optional<Manifest> manifest = read_manifest(key);
+	const auto found = tracks_.find(key);
+	const Track *previous = found != tracks_.end() ? &found->second : nullptr;
+	// Deltas only against the state the store has now: another cabinet may
+	// have moved it on since this one last synced
+	const bool in_sync = previous && manifest && manifest->generation == previous->generation &&
+						 manifest->sequence == previous->sequence;
+
+	std::vector<std::string> stale;
+	if (in_sync && same_layout(*previous, next) && previous->sequence < max_deltas_ &&
+		previous->delta_bytes < previous->base_bytes) {
+		next.generation = previous->generation;
+		next.sequence = previous->sequence + 1;
+		const std::vector<std::uint8_t> delta = encode(next, previous);
+		next.base_bytes = previous->base_bytes;
+		next.delta_bytes = previous->delta_bytes + static_cast<std::uint32_t>(delta.size());
+		if (!put_remote(delta_key(key, next.generation, next.sequence), delta)) {
+			return false;
+		}
+	} else {
+		next.generation = std::max(manifest ? manifest->generation : 0, previous ? previous->generation : 0) + 1;
+		const std::vector<std::uint8_t> base = encode(next, nullptr);
+		next.base_bytes = static_cast<std::uint32_t>(base.size());
+		if (!put_remote(base_key(key, next.generation), base)) {
+			return false;
+		}
+		if (manifest) {
+			stale.push_back(base_key(key, manifest->generation));
+			for (std::uint32_t sequence = 1; sequence <= manifest->sequence; ++sequence) {
+				stale.push_back(delta_key(key, manifest->generation, sequence));
+			}
+		}
+	}
+
+	std::vector<std::uint8_t> record(MANIFEST_MAGIC, MANIFEST_MAGIC + sizeof(MANIFEST_MAGIC));
+	put_u32(record, next.generation);
+	put_u32(record, next.sequence);
+	put_u32(record, next.base_bytes);
+	put_u32(record, next.delta_bytes);
+	if (!put_remote(manifest_key(key), record)) {
+		return false;
+	}
+	{
+		std::lock_guard lock(mutex_);
+		++(next.sequence == 0 ? stats_.bases_sent : stats_.deltas_sent);
+	}
+	for (const std::string &object : stale) {
+		remote_.remove(object); // Best effort: nothing refers to them any more
+	}
+	if (cache_) {
+		cache_->put(cache_key(key), encode(next, nullptr));
+	}
+	tracks_[key] = std::move(next);
+	return true;
+}
+
+StateSync::FetchResult StateSync::fetch(const std::string &key) {
+	const std::optional<Manifest> manifest = read_manifest(key);
+	if (!manifest) {
+		tracks_.erase(key);
+		return std::nullopt;
+	}
+	const auto usable = [&](const Track &track) {
+		return !track.sections.empty() && track.generation == manifest->generation &&
+			   track.sequence <= manifest->sequence;
+	};
+
+	// Start from the newest state this cabinet has of the current base:
+	// synced this session, or cached by an earlier one
+	Track track;
+	if (const auto found = tracks_.find(key); found != tracks_.end()) {
+		track = found->second;
+	}
+	if (!usable(track) && cache_) {
+		const std::optional<std::vector<std::uint8_t>> cached = cache_->get(cache_key(key));
+		if (!cached || !decode(*cached, track)) {
+			track = {};
+		}
+	}
+	bool downloaded = false;
+	if (!usable(track)) {
+		track = {};
+		const std::optional<std::vector<std::uint8_t>> base = get_remote(base_key(key, manifest->generation));
+		if (!base || !decode(*base, track) || track.generation != manifest->generation) {
+			std::cerr << "State sync: " << key << ": cannot read base " << manifest->generation << std::endl;
+			return std::nullopt;
+		}
+		downloaded = true;
+	}
+	while (track.sequence < manifest->sequence) {
+		const std::optional<std::vector<std::uint8_t>> delta =
+			get_remote(delta_key(key, track.generation, track.sequence + 1));
+		if (!delta || !decode(*delta, track)) {
+			std::cerr << "State sync: " << key << ": cannot read delta " << track.sequence + 1 << std::endl;
+			return std::nullopt;
+		}
+		downloaded = true;
+	}
+	track.base_bytes = manifest->base_bytes;
+	track.delta_bytes = manifest->delta_bytes;
+	if (cache_ && downloaded) {
+		cache_->put(cache_key(key), encode(track, nullptr));
+	}
+	std::vector<std::uint8_t> state = join_state(track);
+	tracks_[key] = std::move(track);
+	return state;
+}
+
+std::optional<std::vector<std::uint8_t>> StateSync::get_remote(const std::string &key) {
+	std::optional<std::vector<std::uint8_t>> bytes = remote_.get(key);
+	if (bytes) {
+		std::lock_guard lock(mutex_);
+		stats_.bytes_received += bytes->size();
+	}
+	return bytes;
+}
+
+bool StateSync::put_remote(const std::string &key, const std::vector<std::uint8_t> &bytes) {
+	if (!remote_.put(key, bytes)) {
+		return false;
+	}
+	std::lock_guard lock(mutex_);
+	stats_.bytes_sent += bytes.size();
+	return true;
+}
+
+std::optional<StateSync::Manifest> StateSync::read_manifest(const std::string &key) {
+	const std::optional<std::vector<std::uint8_t>> bytes = get_remote(manifest_key(key));
+	if (!bytes || bytes->size() != MANIFEST_SIZE || std::memcmp(bytes->data(), MANIFEST_MAGIC, 4) != 0) {
+		return std::nullopt;
+	}
+	Manifest manifest;
+	std::size_t offset = sizeof(MANIFEST_MAGIC);
+	get_u32(*bytes, offset, manifest.generation);
+	get_u32(*bytes, offset, manifest.sequence);
+	get_u32(*bytes, offset, manifest.base_bytes);
+	get_u32(*bytes, offset, manifest.delta_bytes);
+	return manifest;
+}
+
+bool StateSync::split_state(const std::vector<std::uint8_t> &state, Track &track) {
+	if (state.size() < sizeof(SaveStateHeader)) {
+		return false;
+	}
+	SaveStateHeader header;
+	std::memcpy(&header, state.data(), sizeof(header));
+	if (!header.is_valid() || header.version < 3) {
+		return false; // Version 2 states are one blob, with nothing to diff
+	}
+	track.header.assign(state.begin(), state.begin() + sizeof(SaveStateHeader));
+	track.sections.clear();
+	std::size_t offset = sizeof(SaveStateHeader);
+	while (state.size() - offset >= sizeof(SaveStateChunk)) {
+		SaveStateChunk chunk;
+		std::memcpy(&chunk, state.data() + offset, sizeof(chunk));
+		offset += sizeof(chunk);
+		const bool lz4 = (chunk.flags & SAVE_CHUNK_LZ4) != 0;
+		if (chunk.stored_size > state.size() - offset ||
+			!save_chunk_size_plausible(chunk.size, chunk.stored_size, lz4)) {
+			return false;
+		}
+		Section &section = track.sections.emplace_back();
+		std::memcpy(section.tag, chunk.tag, sizeof(section.tag));
+		const std::uint8_t *stored = state.data() + offset;
+		if (lz4) {
+			section.bytes.resize(chunk.size);
+			if (!lz4_decompress(stored, chunk.stored_size, section.bytes.data(), section.bytes.size())) {
+				return false;
+			}
+		} else {
+			section.bytes.assign(stored, stored + chunk.size);
+		}
+		offset += chunk.stored_size;
+	}
+	return offset == state.size();
+}
+
+std::vector<std::uint8_t> StateSync::join_state(const Track &track) {
+	std::size_t size = track.header.size();
+	for (const Section &section : track.sections) {
+		size += sizeof(SaveStateChunk) + section.bytes.size();
+	}
+	std::vector<std::uint8_t> state;
+	state.reserve(size);
+	state.insert(state.end(), track.header.begin(), track.header.end());
+	for (const Section &section : track.sections) {
+		SaveStateChunk chunk{};
+		std::memcpy(chunk.tag, section.tag, sizeof(chunk.tag));
+		chunk.size = static_cast<std::uint32_t>(section.bytes.size());
+		chunk.stored_size = chunk.size;
+		const auto *raw = reinterpret_cast<const std::uint8_t *>(&chunk);
+		state.insert(state.end(), raw, raw + sizeof(chunk));
+		state.insert(state.end(), section.bytes.begin(), section.bytes.end());
+	}
+	SaveStateHeader header;
+	std::memcpy(&header, state.data(), sizeof(header));
+	header.data_size = static_cast<std::uint32_t>(state.size() - sizeof(header));
+	std::memcpy(state.data(), &header, sizeof(header));
+	return state;
+}
+
+std::vector<std::uint8_t> StateSync::encode(const Track &track, const Track *previous) {
+	const char *magic = previous ? DELTA_MAGIC : BASE_MAGIC;
+	std::vector<std::uint8_t> object(magic, magic + 4);
+	put_u32(object, track.generation);
+	put_u32(object, track.sequence);
+	put_u32(object, static_cast<std::uint32_t>(track.header.size()));
+	object.insert(object.end(), track.header.begin(), track.header.end());
+	const std::size_t count_offset = object.size();
+	put_u32(object, 0);
+
+	std::uint32_t count = 0;
+	std::vector<std::uint8_t> diff;
+	for (std::size_t i = 0; i < track.sections.size(); ++i) {
+		const std::vector<std::uint8_t> &bytes = track.sections[i].bytes;
+		const std::uint8_t *source = bytes.data();
+		if (previous) {
+			const std::vector<std::uint8_t> &before = previous->sections[i].bytes;
+			if (before == bytes) {
+				continue;
+			}
+			diff.resize(bytes.size());
+			std::transform(bytes.begin(), bytes.end(), before.begin(), diff.begin(),
+						   [](std::uint8_t now, std::uint8_t then) { return static_cast<std::uint8_t>(now ^ then); });
+			source = diff.data();
+		}
+		object.insert(object.end(), track.sections[i].tag, track.sections[i].tag + 4);
+		put_u32(object, static_cast<std::uint32_t>(bytes.size()));
+		const std::size_t stored_offset = object.size();
+		put_u32(object, 0);
+		lz4_compress(source, bytes.size(), object);
+		const auto stored = static_cast<std::uint32_t>(object.size() - stored_offset - sizeof(std::uint32_t));
+		std::memcpy(object.data() + stored_offset, &stored, sizeof(stored));
+		++count;
+	}
+	std::memcpy(object.data() + count_offset, &count, sizeof(count));
+	return object;
+}
+
+bool StateSync::decode(const std::vector<std::uint8_t> &object, Track &track) {
+	if (object.size() < 4) {
+		return false;
+	}
+	const bool delta = std::memcmp(object.data(), DELTA_MAGIC, 4) == 0;
+	if (!delta && std::memcmp(object.data(), BASE_MAGIC, 4) != 0) {
+		return false;
+	}
+	std::size_t offset = 4;
+	std::uint32_t generation = 0;
+	std::uint32_t sequence = 0;
+	std::uint32_t header_size = 0;
+	if (!get_u32(object, offset, generation) || !get_u32(object, offset, sequence) ||
+		!get_u32(object, offset, header_size) || object.size() - offset < header_size) {
+		return false;
+	}
+	if (delta && (generation != track.generation || sequence != track.sequence + 1)) {
+		return false; // Not the next step from this state
+	}
+	// join_state() reads a whole header back out of it
+	if (header_size != sizeof(SaveStateHeader)) {
+		return false;
+	}
+	SaveStateHeader header;
+	std::memcpy(&header, object.data() + offset, sizeof(header));
+	if (!header.is_valid() || header.version < 3) {
+		return false;
+	}
+	// Decoded into a copy, so a damaged object leaves track as it was
+	Track next = delta ? track : Track{};
+	next.generation = generation;
+	next.sequence = sequence;
+	next.header.assign(object.begin() + static_cast<std::ptrdiff_t>(offset),
+					   object.begin() + static_cast<std::ptrdiff_t>(offset + header_size));
+	offset += header_size;
+
+	std::uint32_t count = 0;
+	if (!get_u32(object, offset, count)) {
+		return false;
+	}
+	std::vector<std::uint8_t> diff;
+	for (std::uint32_t i = 0; i < count; ++i) {
+		char tag[4];
+		std::uint32_t size = 0;
+		std::uint32_t stored = 0;
+		if (object.size() - offset < sizeof(tag)) {
+			return false;
+		}
+		std::memcpy(tag, object.data() + offset, sizeof(tag));
+		offset += sizeof(tag);
+		if (!get_u32(object, offset, size) || !get_u32(object, offset, stored) || object.size() - offset < stored ||
+			!save_chunk_size_plausible(size, stored, true)) {
+			return false; // Checked before anything is sized from it
+		}
+		const std::uint8_t *block = object.data() + offset;
+		offset += stored;
+		if (!delta) {
+			Section &section = next.sections.emplace_back();
+			std::memcpy(section.tag, tag, sizeof(tag));
+			section.bytes.resize(size);
+			if (!lz4_decompress(block, stored, section.bytes.data(), size)) {
+				return false;
+			}
+			continue;
+		}
+		const auto section = std::find_if(next.sections.begin(), next.sections.end(),
+										  [&](const Section &known) { return std::memcmp(known.tag, tag, 4) == 0; });
+		if (section == next.sections.end() || section->bytes.size() != size) {
+			return false;
+		}
+		diff.resize(size);
+		if (!lz4_decompress(block, stored, diff.data(), size)) {
+			return false;
+		}
+		for (std::size_t j = 0; j < size; ++j) {
+			section->bytes[j] ^= diff[j];
+		}
+	}
+	if (offset != object.size()) {
+		return false;
+	}
+	track = std::move(next);
+	return true;
+}
+
+bool StateSync::same_layout(const Track &a, const Track &b) {
+	return std::equal(a.sections.begin(), a.sections.end(), b.sections.begin(), b.sections.end(),
+					  [](const Section &x, const Section &y) {
+						  return std::memcmp(x.tag, y.tag, sizeof(x.tag)) == 0 && x.bytes.size() == y.bytes.size();
+					  });
+}
+
+} // namespace nes
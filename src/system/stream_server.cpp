@@ -0,0 +1,572 @@
+#include "system/stream_server.hpp"
+#include "core/bus.hpp"
+#include "core/region.hpp"
+#include "input/latched_input.hpp"
+#include "ppu/ppu.hpp"
+#include "system/headless_system.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <random>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using IoSize = int;
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using IoSize = std::size_t;
+#endif
+
+namespace nes {
+
+// An IPv4 address and port, as the socket calls take them
+struct StreamAddress {
+	sockaddr_in address{};
+
+	[[nodiscard]] bool operator==(const StreamAddress &other) const noexcept {
+		return address.sin_addr.s_addr == other.address.sin_addr.s_addr && address.sin_port == other.address.sin_port;
+	}
+};
+
+/**
+ * UdpSocket - One non-blocking IPv4 datagram socket
+ */
+class UdpSocket {
+  public:
+	~UdpSocket() {
+		close();
+	}
+
+	/// Bind to every local address on port (0 = any free port)
+	bool open(std::uint16_t port);
+	void close() noexcept;
+	[[nodiscard]] std::uint16_t local_port() const;
+
+	// Wait up to timeout for a datagram (spurious returns allowed)
+	void wait_readable(std::chrono::microseconds timeout) const;
+	// Read one datagram; -1 if none is waiting
+	long receive(std::uint8_t *data, std::size_t size, StreamAddress &from) const;
+	bool send(const std::uint8_t *data, std::size_t size, const StreamAddress &to) const;
+
+  private:
+#if defined(_WIN32)
+	SOCKET handle_ = INVALID_SOCKET;
+#else
+	int handle_ = -1;
+#endif
+};
+
+bool UdpSocket::open(std::uint16_t port) {
+	close();
+#if defined(_WIN32)
+	static const bool started = [] {
+		WSADATA data;
+		return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+	}();
+	if (!started) {
+		return false;
+	}
+	handle_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (handle_ == INVALID_SOCKET) {
+		return false;
+	}
+	u_long non_blocking = 1;
+	ioctlsocket(handle_, FIONBIO, &non_blocking);
+#else
+	handle_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (handle_ < 0) {
+		return false;
+	}
+	::fcntl(handle_, F_SETFL, ::fcntl(handle_, F_GETFL, 0) | O_NONBLOCK);
+#endif
+	// Room for a few keyframes' pieces when several sessions send at once
+	const int buffer_bytes = 1 << 20;
+	::setsockopt(handle_, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char *>(&buffer_bytes), sizeof(buffer_bytes));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+	if (::bind(handle_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void UdpSocket::close() noexcept {
+#if defined(_WIN32)
+	if (handle_ != INVALID_SOCKET) {
+		::closesocket(handle_);
+		handle_ = INVALID_SOCKET;
+	}
+#else
+	if (handle_ >= 0) {
+		::close(handle_);
+		handle_ = -1;
+	}
+#endif
+}
+
+std::uint16_t UdpSocket::local_port() const {
+	sockaddr_in address{};
+	socklen_t length = sizeof(address);
+	if (::getsockname(handle_, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+		return 0;
+	}
+	return ntohs(address.sin_port);
+}
+
+void UdpSocket::wait_readable(std::chrono::microseconds timeout) const {
+	fd_set readable;
+	FD_ZERO(&readable);
+	FD_SET(handle_, &readable);
+	timeval wait{};
+	wait.tv_sec = static_cast<long>(timeout.count() / 1000000);
+	wait.tv_usec = static_cast<long>(timeout.count() % 1000000);
+	::select(static_cast<int>(handle_ + 1), &readable, nullptr, nullptr, &wait);
+}
+
+long UdpSocket::receive(std::uint8_t *data, std::size_t size, StreamAddress &from) const {
+	socklen_t length = sizeof(from.address);
+	const auto received = ::recvfrom(handle_, reinterpret_cast<char *>(data), static_cast<IoSize>(size), 0,
+									 reinterpret_cast<sockaddr *>(&from.address), &length);
+	return received < 0 ? -1 : static_cast<long>(received);
+}
+
+bool UdpSocket::send(const std::uint8_t *data, std::size_t size, const StreamAddress &to) const {
+	const auto sent = ::sendto(handle_, reinterpret_cast<const char *>(data), static_cast<IoSize>(size), 0,
+							   reinterpret_cast<const sockaddr *>(&to.address), sizeof(to.address));
+	return sent >= 0 && static_cast<std::size_t>(sent) == size;
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Longest a worker waits for input before it looks at its sessions again
+constexpr auto MAX_WAIT = std::chrono::milliseconds(50);
+// How often StreamClient::connect() repeats its Hello
+constexpr auto HELLO_INTERVAL = std::chrono::milliseconds(100);
+
+void put_u16(std::uint8_t *out, std::uint16_t value) {
+	std::memcpy(out, &value, sizeof(value));
+}
+void put_u32(std::uint8_t *out, std::uint32_t value) {
+	std::memcpy(out, &value, sizeof(value));
+}
+std::uint16_t get_u16(const std::uint8_t *in) {
+	std::uint16_t value;
+	std::memcpy(&value, in, sizeof(value));
+	return value;
+}
+std::uint32_t get_u32(const std::uint8_t *in) {
+	std::uint32_t value;
+	std::memcpy(&value, in, sizeof(value));
+	return value;
+}
+
+// splitmix64's finalizer
+std::uint64_t mix64(std::uint64_t value) {
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+} // namespace
+
+struct StreamServer::Session {
+	std::uint16_t number = 0;
+	HeadlessSystem *system = nullptr;
+	std::shared_ptr<LatchedInputSource> input;
+	Clock::duration period{};
+
+	// The player, updated by whichever worker reads their input
+	std::mutex mutex;
+	bool has_player = false;
+	bool new_player = false; // The encoder has to forget the last player's frames
+	StreamAddress player;
+	std::uint32_t sequence = 0;
+	std::uint32_t acked = FrameDeltaEncoder::NO_FRAME;
+	Clock::time_point heard;
+
+	// The serving worker's
+	FrameDeltaEncoder encoder;
+	std::uint32_t next_frame = 0;
+	Clock::time_point deadline;
+};
+
+struct StreamServer::Worker {
+	std::vector<Session *> sessions;
+	std::vector<std::uint8_t> body;
+	std::array<std::uint8_t, StreamPacket::FRAME_HEADER + StreamPacket::MAX_PIECE> datagram{};
+};
+
+StreamServer::StreamServer() = default;
+
+StreamServer::~StreamServer() {
+	stop();
+}
+
+int StreamServer::add_session(HeadlessSystem &system, std::shared_ptr<LatchedInputSource> input) {
+	auto session = std::make_unique<Session>();
+	session->number = static_cast<std::uint16_t>(sessions_.size());
+	session->system = &system;
+	session->input = std::move(input);
+	session->period = std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<double>(1.0 / region_timing(system.bus().get_region()).frames_per_second()));
+	sessions_.push_back(std::move(session));
+	return static_cast<int>(sessions_.size()) - 1;
+}
+
+bool StreamServer::start(std::uint16_t port, unsigned threads) {
+	stop();
+	socket_ = std::make_unique<UdpSocket>();
+	if (!socket_->open(port)) {
+		socket_.reset();
+		return false;
+	}
+	port_ = socket_->local_port();
+	std::random_device entropy;
+	secret_ = (static_cast<std::uint64_t>(entropy()) << 32) ^ entropy();
+	for (const auto &session : sessions_) {
+		session->has_player = false; // Their tokens were the old secret's
+	}
+	threads = std::max(threads, 1u);
+	running_.store(true, std::memory_order_release);
+	for (unsigned worker = 0; worker < threads; ++worker) {
+		workers_.emplace_back([this, worker, threads] { run(worker, threads); });
+	}
+	return true;
+}
+
+void StreamServer::stop() {
+	running_.store(false, std::memory_order_release);
+	for (std::thread &worker : workers_) {
+		worker.join();
+	}
+	workers_.clear();
+	socket_.reset();
+}
+
+StreamServer::Stats StreamServer::stats() const noexcept {
+	Stats stats;
+	stats.frames_sent = frames_sent_.load(std::memory_order_relaxed);
+	stats.keyframes_sent = keyframes_sent_.load(std::memory_order_relaxed);
+	stats.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+	stats.inputs_received = inputs_received_.load(std::memory_order_relaxed);
+	stats.frames_dropped = frames_dropped_.load(std::memory_order_relaxed);
+	stats.encode_ns = encode_ns_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void StreamServer::run(unsigned worker_index, unsigned threads) {
+	Worker worker;
+	for (std::size_t i = worker_index; i < sessions_.size(); i += threads) {
+		worker.sessions.push_back(sessions_[i].get());
+		sessions_[i]->deadline = Clock::now();
+	}
+	std::array<std::uint8_t, 2048> input{};
+
+	while (running_.load(std::memory_order_acquire)) {
+		// Read input until a session is due
+		Clock::time_point due = Clock::now() + MAX_WAIT;
+		for (const Session *session : worker.sessions) {
+			due = std::min(due, session->deadline);
+		}
+		for (;;) {
+			StreamAddress from;
+			long size;
+			while ((size = socket_->receive(input.data(), input.size(), from)) >= 0) {
+				receive_datagram(input.data(), static_cast<std::size_t>(size), from);
+			}
+			const Clock::time_point now = Clock::now();
+			if (now >= due || !running_.load(std::memory_order_acquire)) {
+				break;
+			}
+			socket_->wait_readable(std::chrono::duration_cast<std::chrono::microseconds>(due - now));
+		}
+
+		const Clock::time_point now = Clock::now();
+		for (Session *session : worker.sessions) {
+			if (session->deadline > now) {
+				continue;
+			}
+			bool playing;
+			{
+				std::lock_guard lock(session->mutex);
+				if (session->has_player && now - session->heard > CLIENT_TIMEOUT) {
+					session->has_player = false;
+				}
+				playing = session->has_player;
+			}
+			if (!playing) {
+				session->deadline = now + session->period;
+				continue;
+			}
+			serve_frame(*session, worker);
+			session->deadline += session->period;
+			if (too_far_behind(session->deadline, now, session->period)) {
+				frames_dropped_.fetch_add(static_cast<std::uint64_t>((now - session->deadline) / session->period),
+										  std::memory_order_relaxed);
+				session->deadline = now + session->period;
+			}
+		}
+	}
+}
+
+void StreamServer::receive_datagram(const std::uint8_t *data, std::size_t size, const StreamAddress &from) {
+	if (size < 8) {
+		return;
+	}
+	const std::uint16_t number = get_u16(data + 4);
+	if (number >= sessions_.size()) {
+		return;
+	}
+	if (size == StreamPacket::HELLO_SIZE && std::memcmp(data, StreamPacket::HELLO_MAGIC, 4) == 0) {
+		receive_hello(*sessions_[number], from);
+	} else if (size == StreamPacket::INPUT_SIZE && std::memcmp(data, StreamPacket::INPUT_MAGIC, 4) == 0) {
+		receive_input(*sessions_[number], data, from);
+	}
+}
+
+std::uint32_t StreamServer::token_for(const StreamAddress &player, std::uint16_t session) const noexcept {
+	const std::uint64_t where = (static_cast<std::uint64_t>(player.address.sin_addr.s_addr) << 32) |
+								(static_cast<std::uint64_t>(player.address.sin_port) << 16) | session;
+	return static_cast<std::uint32_t>(mix64(mix64(where ^ secret_) + secret_));
+}
+
+void StreamServer::receive_hello(Session &session, const StreamAddress &from) {
+	{
+		std::lock_guard lock(session.mutex);
+		if (session.has_player && !(session.player == from) && Clock::now() - session.heard <= CLIENT_TIMEOUT) {
+			return; // Taken: the live player keeps the session
+		}
+	}
+	// No larger than the Hello, so a forged source address gains nothing
+	std::array<std::uint8_t, StreamPacket::WELCOME_SIZE> welcome{};
+	std::memcpy(welcome.data(), StreamPacket::WELCOME_MAGIC, 4);
+	put_u16(welcome.data() + 4, session.number);
+	put_u32(welcome.data() + 8, token_for(from, session.number));
+	socket_->send(welcome.data(), welcome.size(), from);
+}
+
+void StreamServer::receive_input(Session &session, const std::uint8_t *data, const StreamAddress &from) {
+	if (get_u32(data + 8) != token_for(from, session.number)) {
+		return; // Never welcomed at this address
+	}
+	const std::uint32_t sequence = get_u32(data + 12);
+	const Clock::time_point now = Clock::now();
+	inputs_received_.fetch_add(1, std::memory_order_relaxed);
+
+	std::lock_guard lock(session.mutex);
+	if (session.has_player && session.player == from) {
+		if (sequence <= session.sequence) {
+			return; // Overtaken by a newer datagram
+		}
+	} else if (session.has_player && now - session.heard <= CLIENT_TIMEOUT) {
+		return; // Another player's session
+	} else {
+		session.has_player = true;
+		session.new_player = true;
+		session.player = from;
+	}
+	session.sequence = sequence;
+	session.acked = get_u32(data + 16);
+	session.heard = now;
+	// Single writer: the session's mutex is held
+	for (int player = 0; player < LatchedInputSource::PLAYERS; ++player) {
+		session.input->set_buttons(player, data[20 + player]);
+	}
+}
+
+void StreamServer::serve_frame(Session &session, Worker &worker) {
+	std::uint32_t acked;
+	StreamAddress player;
+	{
+		std::lock_guard lock(session.mutex);
+		if (session.new_player) {
+			session.encoder.reset();
+			session.new_player = false;
+		}
+		acked = session.acked;
+		player = session.player;
+	}
+
+	session.system->run_frame();
+	const std::uint32_t number = session.next_frame++;
+	const Clock::time_point start = Clock::now();
+	const bool keyframe = session.encoder.encode(number, session.system->ppu().get_index_buffer(), acked, worker.body);
+	encode_ns_.fetch_add(
+		static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()),
+		std::memory_order_relaxed);
+
+	const std::size_t pieces = (worker.body.size() + StreamPacket::MAX_PIECE - 1) / StreamPacket::MAX_PIECE;
+	std::uint8_t *datagram = worker.datagram.data();
+	std::memcpy(datagram, StreamPacket::FRAME_MAGIC, 4);
+	put_u16(datagram + 4, session.number);
+	datagram[7] = static_cast<std::uint8_t>(pieces);
+	put_u32(datagram + 8, number);
+	std::size_t sent = 0;
+	for (std::size_t piece = 0; piece < pieces; ++piece) {
+		const std::size_t offset = piece * StreamPacket::MAX_PIECE;
+		const std::size_t size = std::min(StreamPacket::MAX_PIECE, worker.body.size() - offset);
+		datagram[6] = static_cast<std::uint8_t>(piece);
+		std::memcpy(datagram + StreamPacket::FRAME_HEADER, worker.body.data() + offset, size);
+		if (socket_->send(datagram, StreamPacket::FRAME_HEADER + size, player)) {
+			sent += StreamPacket::FRAME_HEADER + size;
+		}
+	}
+
+	frames_sent_.fetch_add(1, std::memory_order_relaxed);
+	keyframes_sent_.fetch_add(keyframe ? 1 : 0, std::memory_order_relaxed);
+	bytes_sent_.fetch_add(sent, std::memory_order_relaxed);
+}
+
+StreamClient::StreamClient() = default;
+StreamClient::~StreamClient() = default;
+
+bool StreamClient::connect(const std::string &host, std::uint16_t port, std::uint16_t session,
+						   std::chrono::milliseconds timeout) {
+	socket_ = std::make_unique<UdpSocket>();
+	if (!socket_->open(0)) {
+		socket_.reset();
+		return false;
+	}
+	addrinfo hints{};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+	addrinfo *found = nullptr;
+	if (::getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || !found) {
+		socket_.reset();
+		return false;
+	}
+	server_ = std::make_unique<StreamAddress>();
+	std::memcpy(&server_->address, found->ai_addr, sizeof(server_->address));
+	server_->address.sin_port = htons(port);
+	::freeaddrinfo(found);
+
+	session_ = session;
+	sequence_ = 0;
+	decoder_.reset();
+	assembling_ = FrameDeltaEncoder::NO_FRAME;
+
+	std::array<std::uint8_t, StreamPacket::HELLO_SIZE> hello{};
+	std::memcpy(hello.data(), StreamPacket::HELLO_MAGIC, 4);
+	put_u16(hello.data() + 4, session);
+	std::array<std::uint8_t, StreamPacket::WELCOME_SIZE> welcome{};
+	const Clock::time_point until = Clock::now() + timeout;
+	for (;;) {
+		socket_->send(hello.data(), hello.size(), *server_);
+		const Clock::time_point retry = std::min(until, Clock::now() + HELLO_INTERVAL);
+		for (Clock::time_point now = Clock::now(); now < retry; now = Clock::now()) {
+			socket_->wait_readable(std::chrono::duration_cast<std::chrono::microseconds>(retry - now));
+			StreamAddress from;
+			long size;
+			while ((size = socket_->receive(welcome.data(), welcome.size(), from)) >= 0) {
+				if (from == *server_ && static_cast<std::size_t>(size) == welcome.size() &&
+					std::memcmp(welcome.data(), StreamPacket::WELCOME_MAGIC, 4) == 0 &&
+					get_u16(welcome.data() + 4) == session) {
+					token_ = get_u32(welcome.data() + 8);
+					return true;
+				}
+			}
+		}
+		if (Clock::now() >= until) {
+			socket_.reset();
+			return false;
+		}
+	}
+}
+
+bool StreamClient::send_input(const std::array<std::uint8_t, 4> &buttons) {
+	if (!socket_) {
+		return false;
+	}
+	std::array<std::uint8_t, StreamPacket::INPUT_SIZE> datagram{};
+	std::memcpy(datagram.data(), StreamPacket::INPUT_MAGIC, 4);
+	put_u16(datagram.data() + 4, session_);
+	put_u32(datagram.data() + 8, token_);
+	put_u32(datagram.data() + 12, ++sequence_);
+	put_u32(datagram.data() + 16, decoder_.latest());
+	std::copy(buttons.begin(), buttons.end(), datagram.begin() + 20);
+	return socket_->send(datagram.data(), datagram.size(), *server_);
+}
+
+bool StreamClient::receive(std::chrono::milliseconds timeout) {
+	if (!socket_) {
+		return false;
+	}
+	const Clock::time_point until = Clock::now() + timeout;
+	std::array<std::uint8_t, StreamPacket::FRAME_HEADER + StreamPacket::MAX_PIECE> datagram{};
+	bool decoded = false;
+	for (;;) {
+		StreamAddress from;
+		long size;
+		while ((size = socket_->receive(datagram.data(), datagram.size(), from)) >= 0) {
+			if (from == *server_ && add_piece(datagram.data(), static_cast<std::size_t>(size))) {
+				if (decoder_.decode(assembling_, body_.data(), body_size_)) {
+					decoded = true;
+				} else {
+					++frames_failed_;
+				}
+				assembling_ = FrameDeltaEncoder::NO_FRAME;
+			}
+		}
+		const Clock::time_point now = Clock::now();
+		if (decoded || now >= until) {
+			return decoded;
+		}
+		socket_->wait_readable(std::chrono::duration_cast<std::chrono::microseconds>(until - now));
+	}
+}
+
+bool StreamClient::add_piece(const std::uint8_t *data, std::size_t size) {
+	if (size <= StreamPacket::FRAME_HEADER || std::memcmp(data, StreamPacket::FRAME_MAGIC, 4) != 0 ||
+		get_u16(data + 4) != session_) {
+		return false;
+	}
+	const unsigned piece = data[6];
+	const unsigned pieces = data[7];
+	const std::uint32_t number = get_u32(data + 8);
+	const std::size_t payload = size - StreamPacket::FRAME_HEADER;
+	if (piece >= pieces || (piece + 1 < pieces && payload != StreamPacket::MAX_PIECE)) {
+		return false;
+	}
+	const std::uint32_t latest = decoder_.latest();
+	if (latest != FrameDeltaEncoder::NO_FRAME && number <= latest) {
+		return false; // Overtaken by a newer frame
+	}
+
+	if (number != assembling_) {
+		if (assembling_ != FrameDeltaEncoder::NO_FRAME && number < assembling_) {
+			return false;
+		}
+		// A newer frame: whatever is left of the one in progress is lost
+		assembling_ = number;
+		pieces_ = pieces;
+		pieces_seen_ = 0;
+		body_size_ = 0;
+		body_.resize(pieces * StreamPacket::MAX_PIECE);
+		have_piece_.fill(false);
+	}
+	if (pieces != pieces_ || have_piece_[piece]) {
+		return false;
+	}
+	have_piece_[piece] = true;
+	std::memcpy(body_.data() + piece * StreamPacket::MAX_PIECE, data + StreamPacket::FRAME_HEADER, payload);
+	if (piece + 1 == pieces) {
+		body_size_ = piece * StreamPacket::MAX_PIECE + payload;
+	}
+	return ++pieces_seen_ == pieces_;
+}
+
+} // namespace nes
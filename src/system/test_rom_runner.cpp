@@ -0,0 +1,206 @@
+#include "system/test_rom_runner.hpp"
+#include "core/bus.hpp"
+#include "system/batch_runner.hpp"
+#include "system/frame_dump.hpp"
+#include "system/headless_system.hpp"
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <fstream>
+#include <ios>
+
+namespace nes {
+
+namespace {
+
+constexpr Address STATUS_ADDRESS = 0x6000;
+constexpr Address MESSAGE_ADDRESS = 0x6004;
+constexpr Byte STATUS_RUNNING = 0x80;
+constexpr Byte STATUS_RESET_REQUEST = 0x81;
+constexpr std::size_t MAX_MESSAGE = 1024;
+// Frames between a reset request and pressing reset (the protocol asks for
+// at least 100 ms)
+constexpr int RESET_DELAY_FRAMES = 10;
+
+bool has_signature(const SystemBus &bus) {
+	return bus.peek(0x6001) == 0xDE && bus.peek(0x6002) == 0xB0 && bus.peek(0x6003) == 0x61;
+}
+
+std::string read_message(const SystemBus &bus) {
+	std::string message;
+	for (std::size_t i = 0; i < MAX_MESSAGE; ++i) {
+		const Byte c = bus.peek(static_cast<Address>(MESSAGE_ADDRESS + i));
+		if (c == 0) {
+			break;
+		}
+		message += static_cast<char>(c);
+	}
+	while (!message.empty() && std::isspace(static_cast<unsigned char>(message.back()))) {
+		message.pop_back();
+	}
+	return message;
+}
+
+} // namespace
+
+TestRomRunner::Result TestRomRunner::run(HeadlessSystem &system, const Expectation &expected,
+										 const Options &options) {
+	Result result;
+	SystemBus &bus = system.bus();
+	const std::uint64_t limit = std::max(expected.frames, options.timeout_frames);
+	int reset_countdown = -1;
+	bool reset_pressed = false; // For the current request; cleared once the ROM moves on
+	bool decided = false;
+
+	while (!decided && result.frames < limit) {
+		if (system.run_frame() == 0) {
+			result.verdict = Verdict::Failed;
+			result.message = "CPU stalled";
+			decided = true;
+			break;
+		}
+		++result.frames;
+
+		if (has_signature(bus)) {
+			result.used_protocol = true;
+			const Byte status = bus.peek(STATUS_ADDRESS);
+			if (status == STATUS_RESET_REQUEST) {
+				if (!reset_pressed && reset_countdown < 0) {
+					reset_countdown = RESET_DELAY_FRAMES;
+				} else if (!reset_pressed && --reset_countdown == 0) {
+					system.reset();
+					++result.resets;
+					reset_countdown = -1;
+					reset_pressed = true;
+				}
+			} else {
+				reset_countdown = -1;
+				reset_pressed = false;
+				if (status < STATUS_RUNNING) {
+					result.status = status;
+					result.message = read_message(bus);
+					result.verdict = status == 0 ? Verdict::Passed : Verdict::Failed;
+					decided = true;
+				}
+			}
+		} else if (!result.used_protocol && expected.frames == 0 && result.frames >= options.signature_frames) {
+			result.message = "no $6000 signature and no screen hash";
+			decided = true;
+		}
+
+		if (!decided && !result.used_protocol && expected.frames != 0 && result.frames == expected.frames) {
+			const std::uint64_t hash = hash_frame_buffer(system.get_frame_buffer());
+			result.verdict = hash == expected.frame_hash ? Verdict::Passed : Verdict::Failed;
+			if (result.verdict == Verdict::Failed) {
+				result.message = std::format("frame_hash {:x}, expected {:x}", hash, expected.frame_hash);
+			}
+			decided = true;
+		}
+	}
+
+	if (!decided) {
+		result.verdict = Verdict::TimedOut;
+		result.message = result.used_protocol ? read_message(bus) : "no result";
+	}
+	result.frame_hash = hash_frame_buffer(system.get_frame_buffer());
+	return result;
+}
+
+TestRomRunner::Result TestRomRunner::run(const std::filesystem::path &rom_path, const Options &options) {
+	Expectation expected;
+	if (options.record_frames != 0) {
+		expected.frames = options.record_frames;
+	} else {
+		read_expectation(rom_path, expected);
+	}
+
+	HeadlessSystem system;
+	Result result;
+	if (!system.load_rom(rom_path.string())) {
+		result.verdict = Verdict::LoadError;
+		result.message = "cannot load ROM";
+	} else {
+		result = run(system, expected, options);
+	}
+	result.rom = rom_path.string();
+	return result;
+}
+
+std::vector<TestRomRunner::Result> TestRomRunner::run_suite(const std::vector<std::filesystem::path> &roms,
+															const Options &options) {
+	std::vector<Result> results(roms.size());
+	std::vector<BatchRunner::Job> jobs;
+	jobs.reserve(roms.size());
+	for (std::size_t i = 0; i < roms.size(); ++i) {
+		jobs.emplace_back([&results, &roms, &options, i] { results[i] = run(roms[i], options); });
+	}
+	BatchRunner runner(options.threads);
+	runner.run(std::move(jobs));
+	return results;
+}
+
+std::vector<std::filesystem::path> TestRomRunner::find_roms(const std::vector<std::filesystem::path> &paths) {
+	const auto is_rom = [](const std::filesystem::path &path) {
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(),
+					   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return extension == ".nes";
+	};
+
+	std::vector<std::filesystem::path> roms;
+	for (const std::filesystem::path &path : paths) {
+		std::error_code ec;
+		if (!std::filesystem::is_directory(path, ec)) {
+			roms.push_back(path);
+			continue;
+		}
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(path, ec)) {
+			if (entry.is_regular_file(ec) && is_rom(entry.path())) {
+				roms.push_back(entry.path());
+			}
+		}
+	}
+	std::sort(roms.begin(), roms.end());
+	roms.erase(std::unique(roms.begin(), roms.end()), roms.end());
+	return roms;
+}
+
+std::filesystem::path TestRomRunner::sidecar_path(const std::filesystem::path &rom_path) {
+	std::filesystem::path path = rom_path;
+	path += ".hash";
+	return path;
+}
+
+bool TestRomRunner::read_expectation(const std::filesystem::path &rom_path, Expectation &expected) {
+	std::ifstream file(sidecar_path(rom_path));
+	Expectation parsed;
+	if (!(file >> std::dec >> parsed.frames >> std::hex >> parsed.frame_hash) || parsed.frames == 0) {
+		return false;
+	}
+	expected = parsed;
+	return true;
+}
+
+bool TestRomRunner::write_expectation(const std::filesystem::path &rom_path, const Expectation &expected) {
+	std::ofstream file(sidecar_path(rom_path), std::ios::trunc);
+	file << expected.frames << " " << std::hex << expected.frame_hash << "\n";
+	return static_cast<bool>(file);
+}
+
+const char *TestRomRunner::verdict_name(Verdict verdict) noexcept {
+	switch (verdict) {
+	case Verdict::Passed:
+		return "passed";
+	case Verdict::Failed:
+		return "FAILED";
+	case Verdict::TimedOut:
+		return "TIMED OUT";
+	case Verdict::NoVerdict:
+		return "skipped";
+	case Verdict::LoadError:
+		return "LOAD ERROR";
+	}
+	return "?";
+}
+
+} // namespace nes
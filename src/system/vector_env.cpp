@@ -0,0 +1,216 @@
+#include "system/vector_env.hpp"
+#include "cartridge/rom_image.hpp"
+#include "core/checksum.hpp"
+#include "cpu/cpu_6502.hpp"
+#include "input/latched_input.hpp"
+#include "memory/ram.hpp"
+#include "ppu/ppu.hpp"
+#include "system/headless_system.hpp"
+#include "system/nes_system.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace nes {
+
+struct VectorEnv::Machine {
+	std::shared_ptr<LatchedInputSource> input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system{input};
+	std::vector<std::size_t> members;
+	std::vector<std::uint8_t> state; // serialize_machine() after the last step
+	std::uint64_t digest = 0;
+};
+
+VectorEnv::VectorEnv(std::size_t instances)
+	: machine_of_(instances, 0), program_counter_(instances), accumulator_(instances), x_register_(instances),
+	  y_register_(instances), stack_pointer_(instances), status_register_(instances), frame_count_(instances),
+	  ram_(instances * RAM_SIZE) {
+}
+
+VectorEnv::~VectorEnv() = default;
+
+bool VectorEnv::load(std::shared_ptr<const RomImage> image) {
+	machines_.clear();
+	image_ = nullptr;
+	auto first = std::make_unique<Machine>();
+	first->system.set_frame_skip(frame_skip_);
+	if (!image || !first->system.load_rom_image(image)) {
+		active_.clear();
+		free_.clear();
+		return false;
+	}
+	image_ = std::move(image);
+	machines_.push_back(std::move(first));
+	gather();
+	return true;
+}
+
+void VectorEnv::reset() {
+	if (image_) {
+		machines_[0]->system.load_rom_image(image_);
+		gather();
+	}
+}
+
+void VectorEnv::gather() {
+	Machine &first = *machines_[0];
+	first.members.clear();
+	for (std::size_t instance = 0; instance < size(); ++instance) {
+		machine_of_[instance] = 0;
+		first.members.push_back(instance);
+	}
+	free_.clear();
+	for (std::size_t index = machines_.size(); index-- > 1;) {
+		machines_[index]->members.clear();
+		free_.push_back(index);
+	}
+	active_.assign(1, 0);
+	publish();
+}
+
+void VectorEnv::set_frame_skip(std::uint32_t interval) {
+	frame_skip_ = interval;
+	for (const auto &machine : machines_) {
+		machine->system.set_frame_skip(interval);
+	}
+}
+
+const std::uint16_t *VectorEnv::frame(std::size_t instance) const {
+	return machines_[machine_of_[instance]]->system.ppu().get_index_buffer();
+}
+
+HeadlessSystem &VectorEnv::machine(std::size_t instance) {
+	return machines_[machine_of_[instance]]->system;
+}
+
+bool VectorEnv::step(std::span<const Byte> buttons, unsigned frames) {
+	if (!image_ || buttons.empty() || buttons.size() != size()) {
+		return false;
+	}
+	split(buttons);
+	for (const std::size_t index : active_) {
+		Machine &machine = *machines_[index];
+		for (unsigned frame = 0; frame < frames; ++frame) {
+			machine.system.run_frame();
+		}
+		stats_.machine_frames += frames;
+		stats_.instance_frames += static_cast<std::uint64_t>(frames) * machine.members.size();
+	}
+	if (merging_ && active_.size() > 1) {
+		merge();
+	}
+	publish();
+	return true;
+}
+
+std::size_t VectorEnv::acquire_machine() {
+	if (!free_.empty()) {
+		const std::size_t index = free_.back();
+		free_.pop_back();
+		return index;
+	}
+	machines_.push_back(std::make_unique<Machine>());
+	machines_.back()->system.set_frame_skip(frame_skip_);
+	return machines_.size() - 1;
+}
+
+void VectorEnv::split(std::span<const Byte> buttons) {
+	constexpr std::size_t NONE = ~std::size_t{0};
+	std::array<std::size_t, 256> machine_for{};
+	const std::size_t groups = active_.size();
+	for (std::size_t group = 0; group < groups; ++group) {
+		const std::size_t index = active_[group];
+		Machine &source = *machines_[index];
+		machine_for.fill(NONE);
+		machine_for[buttons[source.members.front()]] = index;
+
+		// Members given other buttons move to machines cloned from this one
+		// before it runs; the source keeps the first member's buttons
+		std::size_t kept = 0;
+		for (const std::size_t instance : source.members) {
+			std::size_t &target = machine_for[buttons[instance]];
+			if (target == NONE) {
+				target = acquire_machine();
+				Machine &copy = *machines_[target];
+				source.system.clone_into(copy.system);
+				copy.input->set_buttons(0, buttons[instance]);
+				active_.push_back(target);
+				++stats_.splits;
+			}
+			if (target == index) {
+				source.members[kept++] = instance;
+			} else {
+				machines_[target]->members.push_back(instance);
+				machine_of_[instance] = target;
+			}
+		}
+		source.members.resize(kept);
+		source.input->set_buttons(0, buttons[source.members.front()]);
+	}
+	std::sort(active_.begin(), active_.end());
+}
+
+void VectorEnv::merge() {
+	for (const std::size_t index : active_) {
+		Machine &machine = *machines_[index];
+		machine.state.clear();
+		machine.system.system().serialize_machine(machine.state);
+		machine.digest = xxhash64(machine.state.data(), machine.state.size());
+	}
+	std::vector<std::size_t> order = active_;
+	std::stable_sort(order.begin(), order.end(),
+					 [this](std::size_t a, std::size_t b) { return machines_[a]->digest < machines_[b]->digest; });
+
+	// Within a run of equal digests, fold each machine into the first earlier
+	// one whose state matches byte for byte
+	std::vector<std::size_t> keepers;
+	for (std::size_t begin = 0; begin < order.size();) {
+		std::size_t end = begin + 1;
+		while (end < order.size() && machines_[order[end]]->digest == machines_[order[begin]]->digest) {
+			++end;
+		}
+		keepers.clear();
+		for (std::size_t i = begin; i < end; ++i) {
+			Machine &machine = *machines_[order[i]];
+			const auto keeper = std::find_if(keepers.begin(), keepers.end(), [&](std::size_t index) {
+				return machines_[index]->state == machine.state;
+			});
+			if (keeper == keepers.end()) {
+				keepers.push_back(order[i]);
+				continue;
+			}
+			Machine &target = *machines_[*keeper];
+			for (const std::size_t instance : machine.members) {
+				machine_of_[instance] = *keeper;
+				target.members.push_back(instance);
+			}
+			machine.members.clear();
+			free_.push_back(order[i]);
+			++stats_.merges;
+		}
+		begin = end;
+	}
+	std::erase_if(active_, [this](std::size_t index) { return machines_[index]->members.empty(); });
+}
+
+void VectorEnv::publish() {
+	for (const std::size_t index : active_) {
+		Machine &machine = *machines_[index];
+		const CPU6502 &cpu = machine.system.cpu();
+		const Byte *ram = machine.system.ram().get_memory().data();
+		const std::uint64_t frames = machine.system.get_frame_count();
+		for (const std::size_t instance : machine.members) {
+			program_counter_[instance] = cpu.get_program_counter();
+			accumulator_[instance] = cpu.get_accumulator();
+			x_register_[instance] = cpu.get_x_register();
+			y_register_[instance] = cpu.get_y_register();
+			stack_pointer_[instance] = cpu.get_stack_pointer();
+			status_register_[instance] = cpu.get_status_register();
+			frame_count_[instance] = frames;
+			std::memcpy(ram_.data() + instance * RAM_SIZE, ram, RAM_SIZE);
+		}
+	}
+}
+
+} // namespace nes
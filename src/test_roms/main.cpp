@@ -0,0 +1,132 @@
+// VibeNES_TestRoms - run an accuracy test-ROM suite headlessly, in parallel.
+//
+// Usage: VibeNES_TestRoms <dir|rom.nes>... [--threads T] [--timeout-frames N]
+//                         [--record-hashes FRAMES]
+//
+// Every .nes under the given directories runs on its own HeadlessSystem,
+// spread over a work-stealing pool. A ROM passes when it reports 0 through
+// the blargg/kevtris $6000 protocol (reset requests are answered), or, for
+// ROMs that only draw their result, when the frame hash after the number of
+// frames in its game.nes.hash sidecar matches (see TestRomRunner). ROMs with
+// neither are listed as skipped.
+//
+// --record-hashes runs every ROM that does not speak the protocol for FRAMES
+// frames and writes its sidecar from the result: check the screens once
+// (e.g. VibeNES_Headless --frames FRAMES --dump-frame), then keep them.
+//
+// Exit status: 0 when nothing failed, timed out or failed to load, 1
+// otherwise, 2 for usage errors.
+
+#include "system/test_rom_runner.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void print_usage(const char *program) {
+	std::cerr << "Usage: " << program
+			  << " <dir|rom.nes>... [--threads T] [--timeout-frames N] [--record-hashes FRAMES]\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	std::vector<std::filesystem::path> paths;
+	nes::TestRomRunner::Options options;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--threads" && i + 1 < argc) {
+			options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+		} else if (arg == "--timeout-frames" && i + 1 < argc) {
+			options.timeout_frames = std::strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--record-hashes" && i + 1 < argc) {
+			options.record_frames = std::strtoull(argv[++i], nullptr, 10);
+			if (options.record_frames == 0) {
+				print_usage(argv[0]);
+				return 2;
+			}
+		} else if (arg == "--help" || arg == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else if (!arg.starts_with("--")) {
+			paths.emplace_back(arg);
+		} else {
+			print_usage(argv[0]);
+			return 2;
+		}
+	}
+	if (paths.empty() || options.timeout_frames == 0) {
+		print_usage(argv[0]);
+		return 2;
+	}
+
+	const std::vector<std::filesystem::path> roms = nes::TestRomRunner::find_roms(paths);
+	if (roms.empty()) {
+		std::cout << "No test ROMs found\n";
+		return 0;
+	}
+
+	const auto start = Clock::now();
+	const std::vector<nes::TestRomRunner::Result> results = nes::TestRomRunner::run_suite(roms, options);
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::size_t passed = 0;
+	std::size_t failed = 0;
+	std::size_t skipped = 0;
+	std::size_t recorded = 0;
+	for (const nes::TestRomRunner::Result &result : results) {
+		using Verdict = nes::TestRomRunner::Verdict;
+		if (options.record_frames != 0 && !result.used_protocol && result.verdict != Verdict::LoadError &&
+			result.message != "CPU stalled") {
+			if (!nes::TestRomRunner::write_expectation(result.rom, {result.frames, result.frame_hash})) {
+				std::cerr << "Cannot write " << nes::TestRomRunner::sidecar_path(result.rom).string() << "\n";
+				return 1;
+			}
+			std::cout << "recorded  " << result.rom << " (" << result.frames << " frames, frame_hash " << std::hex
+					  << result.frame_hash << std::dec << ")\n";
+			++recorded;
+			continue;
+		}
+
+		std::cout << std::left << std::setw(10) << nes::TestRomRunner::verdict_name(result.verdict) << std::right
+				  << result.rom << " (" << result.frames << " frames";
+		if (result.resets != 0) {
+			std::cout << ", " << result.resets << " resets";
+		}
+		if (result.status > 0) {
+			std::cout << ", status " << result.status;
+		}
+		std::cout << ")";
+		if (!result.message.empty() && result.verdict != Verdict::Passed) {
+			std::cout << ": " << result.message;
+		}
+		std::cout << "\n";
+
+		switch (result.verdict) {
+		case Verdict::Passed:
+			++passed;
+			break;
+		case Verdict::NoVerdict:
+			++skipped;
+			break;
+		default:
+			++failed;
+			break;
+		}
+	}
+
+	std::cout << "passed: " << passed << " failed: " << failed << " skipped: " << skipped;
+	if (recorded != 0) {
+		std::cout << " recorded: " << recorded;
+	}
+	std::cout << " seconds: " << std::fixed << std::setprecision(2) << seconds << "\n";
+	return failed == 0 ? 0 : 1;
+}
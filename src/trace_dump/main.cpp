@@ -0,0 +1,73 @@
+// VibeNES_TraceDump - convert a binary CPU trace to nestest-style text.
+//
+// Usage: VibeNES_TraceDump <trace.vntrace> [--output trace.log] [--limit N]
+//
+// Traces come from VibeNES_Headless --trace (builds configured with
+// -DVIBENES_CPU_TRACE=ON). One line per instruction, in the nestest.log
+// column layout, so the output diffs directly against reference logs.
+
+#include "cpu/cpu_trace.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void print_usage(const char *program) {
+	std::cerr << "Usage: " << program << " <trace.vntrace> [--output trace.log] [--limit N]\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	std::string trace_path;
+	std::string output_path;
+	uint64_t limit = UINT64_MAX;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--output" && i + 1 < argc) {
+			output_path = argv[++i];
+		} else if (arg == "--limit" && i + 1 < argc) {
+			limit = std::strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--help" || arg == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else if (trace_path.empty() && !arg.starts_with("--")) {
+			trace_path = arg;
+		} else {
+			print_usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (trace_path.empty()) {
+		print_usage(argv[0]);
+		return 2;
+	}
+
+	std::ifstream input(trace_path, std::ios::binary);
+	nes::CpuTraceReader reader(input);
+	if (!reader.valid()) {
+		std::cerr << "Not a VibeNES trace: " << trace_path << "\n";
+		return 1;
+	}
+
+	std::ofstream file;
+	if (!output_path.empty()) {
+		file.open(output_path);
+		if (!file) {
+			std::cerr << "Failed to open " << output_path << "\n";
+			return 1;
+		}
+	}
+	std::ostream &output = output_path.empty() ? std::cout : file;
+
+	nes::TraceRecord record;
+	for (uint64_t count = 0; count < limit && reader.read(record); ++count) {
+		output << nes::format_trace_line(record) << '\n';
+	}
+	return output ? 0 : 1;
+}
@@ -7,8 +7,15 @@
 #include "../../include/core/types.hpp"
 #include "../../include/cpu/cpu_6502.hpp"
 #include "../../include/memory/ram.hpp"
+#include <algorithm>
 #include <catch2/catch_all.hpp>
 #include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <vector>
 
 using namespace nes;
 
@@ -376,10 +383,23 @@ TEST_CASE("APU Audio Mixing", "[apu][mixing]") {
 		apu->write(0x4011, 0x7F); // Direct load max output
 
 		float sample = apu->get_audio_sample();
-		// TND formula with only DMC: 159.79 / ((1 / (dmc/22638)) + 100)
+		// TND table with only DMC: 163.67 / ((24329 / dmc) + 100)
 		// Should produce a non-trivial contribution
 		REQUIRE(sample > 0.0f);
 	}
+
+	SECTION("TND table tracks the three-input formula") {
+		// Every DMC level over the idle triangle (which holds 15): the single
+		// table stays within 5% (0.013 full scale at worst) of
+		// 159.79 / ((1 / (triangle / 8227 + dmc / 22638)) + 100)
+		apu->write(0x4015, 0x10);
+		for (int level = 0; level < 128; ++level) {
+			apu->write(0x4011, static_cast<uint8_t>(level));
+			const float sum = 15.0f / 8227.0f + static_cast<float>(level) / 22638.0f;
+			const float exact = 159.79f / (1.0f / sum + 100.0f);
+			REQUIRE(std::abs(apu->get_audio_sample() - exact) < std::min(exact * 0.05f, 0.013f));
+		}
+	}
 }
 
 // =============================================================================
@@ -622,6 +642,45 @@ TEST_CASE("APU DMC DMA Interface", "[apu][dmc][dma]") {
 	}
 }
 
+TEST_CASE("APU DMC Fetch Prediction", "[apu][dmc][dma]") {
+	const auto mode = GENERATE(APU::SynthesisMode::PerCycle, APU::SynthesisMode::BandLimited);
+	auto apu = make_apu();
+	apu->set_synthesis_mode(mode);
+	apu->write(0x4017, 0x40); // No frame IRQ, so only the DMC bounds the count
+	tick_apu(*apu, 8);		  // Let the $4017 write settle
+	apu->write(0x4010, 0x4E); // Loop, rate 14
+	apu->write(0x4012, 0x00);
+	apu->write(0x4013, 0x01);
+	apu->write(0x4015, 0x10);
+
+	// Every fetch request must land exactly one cycle after the predicted
+	// count runs out, including the wrapped bit counter of the first byte
+	int fetches = 0;
+	for (int cycle = 0; cycle < 200000; ++cycle) {
+		if (apu->is_dmc_dma_pending()) {
+			REQUIRE(apu->cycles_until_irq_or_dma() == 0);
+			apu->complete_dmc_dma(static_cast<uint8_t>(cycle));
+			++fetches;
+			continue;
+		}
+		const uint32_t predicted = apu->cycles_until_irq_or_dma();
+		REQUIRE(predicted != APU::NO_APU_EVENT);
+		tick_apu(*apu, static_cast<int>(predicted));
+		REQUIRE_FALSE(apu->is_dmc_dma_pending());
+		tick_apu(*apu, 1);
+		REQUIRE(apu->is_dmc_dma_pending());
+		cycle += static_cast<int>(predicted);
+	}
+	REQUIRE(fetches > 100);
+
+	// A stopped sample never fetches
+	if (apu->is_dmc_dma_pending()) {
+		apu->complete_dmc_dma(0);
+	}
+	apu->write(0x4015, 0x00);
+	REQUIRE(apu->cycles_until_irq_or_dma() == APU::NO_APU_EVENT);
+}
+
 // =============================================================================
 // Register Write Edge Cases
 // =============================================================================
@@ -702,6 +761,25 @@ TEST_CASE("APU Frame Counter Timing", "[apu][frame-counter][timing]") {
 		REQUIRE_FALSE(apu->is_frame_irq_pending());
 	}
 
+	SECTION("PAL frame sequence is longer") {
+		auto cycles_to_irq = [](const RegionTiming &timing) {
+			auto region_apu = make_apu();
+			region_apu->set_region(timing);
+			region_apu->write(0x4017, 0x00);
+			int cycles = 0;
+			while (!region_apu->is_frame_irq_pending() && cycles < 100000) {
+				region_apu->tick(CpuCycle(1));
+				cycles++;
+			}
+			return cycles;
+		};
+		const int ntsc = cycles_to_irq(NTSC_TIMING);
+		const int pal = cycles_to_irq(PAL_TIMING);
+		REQUIRE(cycles_to_irq(DENDY_TIMING) == ntsc);
+		// Two CPU cycles per frame counter clock: 2 * (33252 - 29828)
+		REQUIRE(pal - ntsc == 6848);
+	}
+
 	SECTION("Acknowledge DMC IRQ clears flag") {
 		// Just verify the acknowledge mechanism works
 		apu->acknowledge_dmc_irq();
@@ -757,3 +835,422 @@ TEST_CASE("APU Lookup Tables", "[apu][tables]") {
 		REQUIRE((status & 0x08) == 0x08);
 	}
 }
+
+// =============================================================================
+// Band-Limited Synthesis
+// =============================================================================
+
+namespace {
+
+// Records everything the APU queues; buffer fill stays at the rate-control
+// target so the resampling ratio is left alone
+class CaptureAudioOutput final : public AudioOutput {
+  public:
+	bool initialize(int, int) override {
+		return true;
+	}
+	void start() override {
+	}
+	void stop() override {
+	}
+	void queue_sample(float sample) override {
+		samples.push_back(sample);
+	}
+	void queue_samples(std::span<const float> block) override {
+		samples.insert(samples.end(), block.begin(), block.end());
+		++blocks;
+	}
+	void queue_sample_stereo(float left, float) override {
+		samples.push_back(left);
+	}
+	void set_volume(float) override {
+	}
+	float get_volume() const override {
+		return 1.0f;
+	}
+	bool is_playing() const override {
+		return true;
+	}
+	std::size_t get_buffer_size() const override {
+		++fill_queries;
+		return 3072;
+	}
+	int get_sample_rate() const override {
+		return 44100;
+	}
+	void clear_buffer() override {
+	}
+
+	std::vector<float> samples;
+	int blocks = 0;
+	mutable int fill_queries = 0;
+};
+
+// A short tune touching every channel, sweeps, envelopes and both frame counter modes
+void play_tune(APU &apu) {
+	apu.write(0x4015, 0x0F);
+	apu.write(0x4000, 0x9F); // Pulse 1: 50% duty, constant volume 15
+	apu.write(0x4002, 0xFD);
+	apu.write(0x4003, 0x08);
+	apu.write(0x4004, 0x44); // Pulse 2: envelope decay
+	apu.write(0x4005, 0x9A); // sweep enabled
+	apu.write(0x4006, 0x80);
+	apu.write(0x4007, 0x19);
+	apu.write(0x4008, 0x7F); // Triangle
+	apu.write(0x400A, 0x42);
+	apu.write(0x400B, 0x18);
+	apu.write(0x400C, 0x36); // Noise
+	apu.write(0x400E, 0x03);
+	apu.write(0x400F, 0x20);
+	tick_apu(apu, 20011);
+
+	apu.write(0x4002, 0x7C);  // Pitch change mid-note
+	apu.write(0x400E, 0x84);  // Short-mode noise
+	apu.write(0x4017, 0x80);  // 5-step mode, immediate clock
+	tick_apu(apu, 33339);
+	apu.write(0x4015, 0x05);  // Drop pulse 2 and noise
+	apu.write(0x4011, 0x30);  // DMC DAC step
+	tick_apu(apu, 29781 * 2);
+}
+
+} // namespace
+
+TEST_CASE("APU Band-Limited Synthesis", "[apu][synthesis]") {
+	SECTION("Emulated state matches per-cycle synthesis") {
+		for (bool with_audio : {false, true}) {
+			CaptureAudioOutput per_cycle_out;
+			CaptureAudioOutput band_limited_out;
+			auto per_cycle = make_apu();
+			auto band_limited = make_apu();
+			band_limited->set_synthesis_mode(APU::SynthesisMode::BandLimited);
+			if (with_audio) {
+				per_cycle->connect_audio_output(&per_cycle_out);
+				per_cycle->enable_audio(true);
+				band_limited->connect_audio_output(&band_limited_out);
+				band_limited->enable_audio(true);
+			}
+
+			play_tune(*per_cycle);
+			play_tune(*band_limited);
+
+			std::vector<uint8_t> expected;
+			std::vector<uint8_t> actual;
+			per_cycle->serialize_state(expected);
+			band_limited->sync_channels();
+			band_limited->serialize_state(actual);
+			REQUIRE(actual == expected);
+		}
+	}
+
+	SECTION("Produces audio at the output rate") {
+		CaptureAudioOutput out;
+		auto apu = make_apu();
+		apu->set_synthesis_mode(APU::SynthesisMode::BandLimited);
+		apu->connect_audio_output(&out);
+		apu->enable_audio(true);
+
+		play_tune(*apu);
+
+		// 113,131 cycles at 44.1kHz, less the unfinished last frame and batch
+		const double expected = 113131.0 * 44100.0 / static_cast<double>(CPU_CLOCK_NTSC);
+		REQUIRE(static_cast<double>(out.samples.size()) > expected - 1000.0);
+		REQUIRE(static_cast<double>(out.samples.size()) <= expected);
+
+		double energy = 0.0;
+		for (float sample : out.samples) {
+			REQUIRE(std::isfinite(sample));
+			energy += static_cast<double>(sample) * sample;
+		}
+		REQUIRE(energy / static_cast<double>(out.samples.size()) > 1e-4);
+	}
+
+	SECTION("Pulse tone comes out at its pitch") {
+		CaptureAudioOutput out;
+		auto apu = make_apu();
+		apu->set_synthesis_mode(APU::SynthesisMode::BandLimited);
+		apu->connect_audio_output(&out);
+		apu->enable_audio(true);
+
+		// Period 253: 1789773 / (16 * 254) = 440.4 Hz
+		apu->write(0x4015, 0x01);
+		apu->write(0x4000, 0xBF); // 50% duty, halt length, constant volume 15
+		apu->write(0x4002, 0xFD);
+		apu->write(0x4003, 0x00);
+		tick_apu(*apu, 29781 * 60);
+
+		// Skip the filters' settling, then count rising zero crossings
+		const std::size_t start = out.samples.size() / 4;
+		int crossings = 0;
+		for (std::size_t i = start + 1; i < out.samples.size(); ++i) {
+			crossings += (out.samples[i - 1] < 0.0f && out.samples[i] >= 0.0f) ? 1 : 0;
+		}
+		const double seconds = static_cast<double>(out.samples.size() - start - 1) / 44100.0;
+		REQUIRE(std::abs(crossings / seconds - 440.4) < 5.0);
+	}
+
+	SECTION("Switching modes keeps channels in sync") {
+		auto reference = make_apu();
+		auto switched = make_apu();
+		switched->set_synthesis_mode(APU::SynthesisMode::BandLimited);
+		reference->write(0x4015, 0x01);
+		switched->write(0x4015, 0x01);
+		reference->write(0x4003, 0x08);
+		switched->write(0x4003, 0x08);
+		tick_apu(*reference, 1234);
+		tick_apu(*switched, 1234);
+
+		switched->set_synthesis_mode(APU::SynthesisMode::PerCycle);
+		tick_apu(*reference, 100);
+		tick_apu(*switched, 100);
+
+		std::vector<uint8_t> expected;
+		std::vector<uint8_t> actual;
+		reference->serialize_state(expected);
+		switched->serialize_state(actual);
+		REQUIRE(actual == expected);
+	}
+}
+
+TEST_CASE("APU Silent Channel Parking", "[apu][synthesis]") {
+	// Per-cycle mode stops clocking channels that can't be heard and
+	// fast-forwards them later; band-limited mode computes the same state
+	// its own way, so the two must agree everywhere along a tune that keeps
+	// channels idle for long stretches
+	const bool with_audio = GENERATE(false, true);
+	CaptureAudioOutput per_cycle_out;
+	CaptureAudioOutput band_limited_out;
+	auto per_cycle = make_apu();
+	auto band_limited = make_apu();
+	band_limited->set_synthesis_mode(APU::SynthesisMode::BandLimited);
+	if (with_audio) {
+		per_cycle->connect_audio_output(&per_cycle_out);
+		per_cycle->enable_audio(true);
+		band_limited->connect_audio_output(&band_limited_out);
+		band_limited->enable_audio(true);
+	}
+
+	auto write = [&](uint16_t address, uint8_t value) {
+		per_cycle->write(address, value);
+		band_limited->write(address, value);
+	};
+	auto run = [&](int cycles) {
+		for (int done = 0; done < cycles; done += 997) {
+			const int step = std::min(997, cycles - done);
+			tick_apu(*per_cycle, step);
+			tick_apu(*band_limited, step);
+			std::vector<uint8_t> expected;
+			std::vector<uint8_t> actual;
+			band_limited->sync_channels();
+			band_limited->serialize_state(expected);
+			per_cycle->serialize_state(actual);
+			REQUIRE(actual == expected);
+		}
+	};
+
+	write(0x4015, 0x0F);
+	write(0x4000, 0x30); // Pulse 1: constant volume 0 (silent), sweep moving the period
+	write(0x4001, 0x91);
+	write(0x4002, 0x40);
+	write(0x4003, 0x02);
+	write(0x4004, 0x1F); // Pulse 2: a short note that runs out
+	write(0x4006, 0xA0);
+	write(0x4007, 0xF9);
+	write(0x4008, 0x05); // Triangle: linear counter expires quickly
+	write(0x400A, 0x31);
+	write(0x400B, 0x08);
+	write(0x400C, 0x1F); // Noise: short note
+	write(0x400E, 0x82);
+	write(0x400F, 0xF8);
+	run(40000);
+
+	write(0x4015, 0x00); // Everything off for a while
+	run(120011);
+	write(0x4015, 0x0D); // Back on: pulse 1 audible, triangle and noise reloaded
+	write(0x4000, 0xBF);
+	write(0x4003, 0x00);
+	write(0x400B, 0x10);
+	write(0x400F, 0x10);
+	run(30013);
+	write(0x4017, 0x80); // 5-step mode clocks everything at once
+	run(50021);
+}
+
+TEST_CASE("APU Per-Cycle Output Filter", "[apu][synthesis]") {
+	// Per-cycle mode runs only the 14 kHz anti-alias stage at the CPU rate
+	// and the rest of the chain at the output rate; pitch and level must
+	// still match the band-limited path, whose chain runs wholly at 44.1 kHz
+	const auto resampler = GENERATE(APU::Resampler::BoxAverage, APU::Resampler::WindowedSinc);
+	auto play_tone = [resampler](APU::SynthesisMode mode) {
+		CaptureAudioOutput out;
+		auto apu = make_apu();
+		apu->set_synthesis_mode(mode);
+		apu->set_resampler(resampler);
+		apu->connect_audio_output(&out);
+		apu->enable_audio(true);
+		apu->write(0x4015, 0x01);
+		apu->write(0x4000, 0xBF); // 50% duty, halt length, constant volume 15
+		apu->write(0x4002, 0xFD); // 440.4 Hz
+		apu->write(0x4003, 0x00);
+		tick_apu(*apu, 29781 * 60);
+		return out.samples;
+	};
+	const std::vector<float> per_cycle = play_tone(APU::SynthesisMode::PerCycle);
+	const std::vector<float> band_limited = play_tone(APU::SynthesisMode::BandLimited);
+
+	auto measure = [](const std::vector<float> &samples, double &frequency, double &rms) {
+		const std::size_t start = samples.size() / 4; // Skip the filters' settling
+		int crossings = 0;
+		double energy = 0.0;
+		for (std::size_t i = start + 1; i < samples.size(); ++i) {
+			REQUIRE(std::isfinite(samples[i]));
+			crossings += (samples[i - 1] < 0.0f && samples[i] >= 0.0f) ? 1 : 0;
+			energy += static_cast<double>(samples[i]) * samples[i];
+		}
+		const double count = static_cast<double>(samples.size() - start - 1);
+		frequency = crossings / (count / 44100.0);
+		rms = std::sqrt(energy / count);
+	};
+	double per_cycle_frequency = 0.0, per_cycle_rms = 0.0;
+	double band_limited_frequency = 0.0, band_limited_rms = 0.0;
+	measure(per_cycle, per_cycle_frequency, per_cycle_rms);
+	measure(band_limited, band_limited_frequency, band_limited_rms);
+
+	REQUIRE(std::abs(per_cycle_frequency - 440.4) < 5.0);
+	REQUIRE(per_cycle_rms > 1e-2);
+	REQUIRE(std::abs(per_cycle_rms - band_limited_rms) < band_limited_rms * 0.05);
+}
+
+TEST_CASE("APU Output Frame Handoff", "[apu][synthesis]") {
+	// One queue_samples() call and one buffer fill query per output frame
+	const auto mode = GENERATE(APU::SynthesisMode::PerCycle, APU::SynthesisMode::BandLimited);
+	CaptureAudioOutput out;
+	auto apu = make_apu();
+	apu->set_synthesis_mode(mode);
+	apu->connect_audio_output(&out);
+	apu->enable_audio(true);
+	apu->write(0x4015, 0x01);
+	apu->write(0x4000, 0xBF);
+	apu->write(0x4002, 0xFD);
+	apu->write(0x4003, 0x00);
+
+	tick_apu(*apu, 29781 * 10 + 100);
+	REQUIRE(out.blocks == 10);
+	REQUIRE(out.fill_queries == 10);
+	const double per_frame = static_cast<double>(out.samples.size()) / 10.0;
+	REQUIRE(std::abs(per_frame - 29781.0 * 44100.0 / static_cast<double>(CPU_CLOCK_NTSC)) < 1.0);
+}
+
+TEST_CASE("APU Recorder", "[apu][synthesis]") {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "vibenes_test_apu_recording.f32";
+	auto read_track = [&path](AudioRecorder::Track track) {
+		std::ifstream file(AudioRecorder::track_path(path, track), std::ios::binary);
+		const std::vector<char> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+		std::vector<float> samples(bytes.size() / sizeof(float));
+		std::memcpy(samples.data(), bytes.data(), samples.size() * sizeof(float));
+		return samples;
+	};
+	auto play = [](APU &apu) {
+		apu.write(0x4015, 0x09);
+		apu.write(0x4000, 0xBF); // Pulse 1: 440.4 Hz, constant volume 15
+		apu.write(0x4002, 0xFD);
+		apu.write(0x4003, 0x00);
+		apu.write(0x400C, 0x3F); // Noise: constant volume 15
+		apu.write(0x400E, 0x05);
+		apu.write(0x400F, 0x00);
+		tick_apu(apu, 29781 * 20 + 100);
+	};
+	auto rms = [](const std::vector<float> &samples) {
+		double energy = 0.0;
+		for (float sample : samples) {
+			energy += static_cast<double>(sample) * sample;
+		}
+		return std::sqrt(energy / static_cast<double>(samples.size()));
+	};
+
+	SECTION("The mix track is what the device gets") {
+		const auto mode = GENERATE(APU::SynthesisMode::PerCycle, APU::SynthesisMode::BandLimited);
+		CaptureAudioOutput out;
+		AudioRecorder recorder;
+		REQUIRE(recorder.open(path, 44100, AudioRecorder::Format::RawFloat));
+		auto apu = make_apu();
+		apu->set_synthesis_mode(mode);
+		apu->connect_audio_output(&out);
+		apu->set_recorder(&recorder);
+		apu->enable_audio(true);
+		play(*apu);
+		apu->set_recorder(nullptr);
+		REQUIRE(recorder.close());
+
+		REQUIRE(out.samples.size() > 29781ull * 19 * 44100 / CPU_CLOCK_NTSC);
+		REQUIRE(read_track(AudioRecorder::Track::Mix) == out.samples);
+	}
+
+	SECTION("Stems without an output device") {
+		AudioRecorder recorder;
+		REQUIRE(recorder.open(path, 44100, AudioRecorder::Format::RawFloat, true));
+		auto apu = make_apu();
+		apu->set_synthesis_mode(APU::SynthesisMode::BandLimited);
+		apu->set_recorder(&recorder);
+		apu->enable_audio(true);
+		play(*apu);
+		apu->set_recorder(nullptr);
+		REQUIRE(recorder.close());
+
+		const std::vector<float> mix = read_track(AudioRecorder::Track::Mix);
+		REQUIRE(mix.size() > 29781ull * 19 * 44100 / CPU_CLOCK_NTSC);
+		for (std::size_t track = 1; track < AudioRecorder::TRACK_COUNT; ++track) {
+			REQUIRE(read_track(static_cast<AudioRecorder::Track>(track)).size() == mix.size());
+		}
+		// The playing channels have signal in their own stems only
+		REQUIRE(rms(read_track(AudioRecorder::Track::Pulse1)) > 1e-2);
+		REQUIRE(rms(read_track(AudioRecorder::Track::Noise)) > 1e-2);
+		// Silent ones stay at zero (the idle triangle holds its sequencer level, a DC step, so it is skipped)
+		REQUIRE(rms(read_track(AudioRecorder::Track::Pulse2)) == 0.0);
+		REQUIRE(rms(read_track(AudioRecorder::Track::Dmc)) == 0.0);
+	}
+
+	for (std::size_t track = 0; track < AudioRecorder::TRACK_COUNT; ++track) {
+		std::filesystem::remove(AudioRecorder::track_path(path, static_cast<AudioRecorder::Track>(track)));
+	}
+}
+
+TEST_CASE("APU Output Gating", "[apu][synthesis]") {
+	const auto mode = GENERATE(APU::SynthesisMode::PerCycle, APU::SynthesisMode::BandLimited);
+
+	CaptureAudioOutput reference_out;
+	auto reference = make_apu();
+	reference->set_synthesis_mode(mode);
+	reference->connect_audio_output(&reference_out);
+	reference->enable_audio(true);
+	play_tune(*reference);
+	tick_apu(*reference, 29781 * 2);
+
+	// Same tune, but a detour that changes every channel is run gated and
+	// then undone by restoring the state saved before it (run-ahead)
+	CaptureAudioOutput out;
+	auto apu = make_apu();
+	apu->set_synthesis_mode(mode);
+	apu->connect_audio_output(&out);
+	apu->enable_audio(true);
+	play_tune(*apu);
+
+	apu->sync_channels();
+	std::vector<uint8_t> state;
+	apu->serialize_state(state);
+	apu->set_output_gated(true);
+	const std::size_t queued = out.samples.size();
+	apu->write(0x4015, 0x0F);
+	apu->write(0x4000, 0xBF);
+	apu->write(0x4003, 0x00);
+	apu->write(0x400C, 0x3F);
+	apu->write(0x400F, 0x00);
+	tick_apu(*apu, 29781);
+	REQUIRE(out.samples.size() == queued);
+	size_t offset = 0;
+	apu->deserialize_state(state, offset);
+	apu->set_output_gated(false);
+	tick_apu(*apu, 29781 * 2);
+
+	REQUIRE(out.samples.size() == reference_out.samples.size());
+	REQUIRE(out.samples == reference_out.samples);
+}
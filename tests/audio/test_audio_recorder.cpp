@@ -0,0 +1,137 @@
+// VibeNES - NES Emulator
+// Audio Recorder Tests
+// Tests for streaming float WAV and raw audio files from the background writer
+
+#include "../../include/audio/audio_recorder.hpp"
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+std::vector<char> read_file(const std::filesystem::path &path) {
+	std::ifstream file(path, std::ios::binary);
+	return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+std::uint32_t read_u32(const std::vector<char> &bytes, std::size_t offset) {
+	std::uint32_t value = 0;
+	for (int i = 3; i >= 0; --i) {
+		value = (value << 8) | static_cast<std::uint8_t>(bytes[offset + static_cast<std::size_t>(i)]);
+	}
+	return value;
+}
+
+std::uint16_t read_u16(const std::vector<char> &bytes, std::size_t offset) {
+	return static_cast<std::uint16_t>(static_cast<std::uint8_t>(bytes[offset]) |
+									  (static_cast<std::uint8_t>(bytes[offset + 1]) << 8));
+}
+
+std::vector<float> ramp(std::size_t count) {
+	std::vector<float> samples(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		samples[i] = static_cast<float>(i) / static_cast<float>(count) - 0.5f;
+	}
+	return samples;
+}
+
+} // namespace
+
+TEST_CASE("Audio Recorder - Track paths", "[audio][recorder]") {
+	REQUIRE(AudioRecorder::track_path("out/song.wav", AudioRecorder::Track::Mix) == "out/song.wav");
+	REQUIRE(AudioRecorder::track_path("out/song.wav", AudioRecorder::Track::Pulse1) == "out/song.pulse1.wav");
+	REQUIRE(AudioRecorder::track_path("song.f32", AudioRecorder::Track::Dmc) == "song.dmc.f32");
+	REQUIRE(AudioRecorder::track_path("song", AudioRecorder::Track::Triangle) == "song.triangle");
+}
+
+TEST_CASE("Audio Recorder - WAV", "[audio][recorder]") {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "vibenes_test_recorder.wav";
+	const std::vector<float> samples = ramp(100000);
+
+	AudioRecorder recorder;
+	REQUIRE(recorder.open(path, 48000));
+	REQUIRE(recorder.is_open());
+	REQUIRE_FALSE(recorder.open(path, 48000));
+	for (std::size_t i = 0; i < samples.size(); i += 735) {
+		const std::size_t count = std::min<std::size_t>(735, samples.size() - i);
+		recorder.write(AudioRecorder::Track::Mix, std::span(samples).subspan(i, count));
+	}
+	// Tracks that aren't recorded are ignored
+	recorder.write(AudioRecorder::Track::Noise, samples);
+	REQUIRE(recorder.close());
+	REQUIRE_FALSE(recorder.is_open());
+	REQUIRE(recorder.samples_written(AudioRecorder::Track::Mix) == samples.size());
+	REQUIRE(recorder.samples_written(AudioRecorder::Track::Noise) == 0);
+	REQUIRE(recorder.dropped_samples() == 0);
+	REQUIRE_FALSE(std::filesystem::exists(AudioRecorder::track_path(path, AudioRecorder::Track::Noise)));
+
+	const std::vector<char> bytes = read_file(path);
+	constexpr std::size_t HEADER = 58;
+	REQUIRE(bytes.size() == HEADER + samples.size() * sizeof(float));
+	REQUIRE(std::string(bytes.data(), 4) == "RIFF");
+	REQUIRE(read_u32(bytes, 4) == bytes.size() - 8);
+	REQUIRE(std::string(bytes.data() + 8, 8) == "WAVEfmt ");
+	REQUIRE(read_u16(bytes, 20) == 3); // IEEE float
+	REQUIRE(read_u16(bytes, 22) == 1); // Mono
+	REQUIRE(read_u32(bytes, 24) == 48000);
+	REQUIRE(read_u16(bytes, 34) == 32);
+	REQUIRE(std::string(bytes.data() + 38, 4) == "fact");
+	REQUIRE(read_u32(bytes, 46) == samples.size());
+	REQUIRE(std::string(bytes.data() + 50, 4) == "data");
+	REQUIRE(read_u32(bytes, 54) == samples.size() * sizeof(float));
+
+	std::vector<float> decoded(samples.size());
+	std::memcpy(decoded.data(), bytes.data() + HEADER, decoded.size() * sizeof(float));
+	REQUIRE(decoded == samples);
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Audio Recorder - Raw stems", "[audio][recorder]") {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "vibenes_test_recorder.f32";
+	AudioRecorder recorder;
+	REQUIRE(recorder.open(path, 44100, AudioRecorder::Format::RawFloat, true));
+	REQUIRE(recorder.records_stems());
+	for (std::size_t track = 0; track < AudioRecorder::TRACK_COUNT; ++track) {
+		recorder.write(static_cast<AudioRecorder::Track>(track), ramp(1000 + track));
+	}
+	REQUIRE(recorder.close());
+
+	for (std::size_t track = 0; track < AudioRecorder::TRACK_COUNT; ++track) {
+		const std::filesystem::path file = AudioRecorder::track_path(path, static_cast<AudioRecorder::Track>(track));
+		const std::vector<char> bytes = read_file(file);
+		REQUIRE(bytes.size() == (1000 + track) * sizeof(float));
+		std::vector<float> decoded(1000 + track);
+		std::memcpy(decoded.data(), bytes.data(), bytes.size());
+		REQUIRE(decoded == ramp(1000 + track));
+		std::filesystem::remove(file);
+	}
+}
+
+TEST_CASE("Audio Recorder - Overflow drops instead of blocking", "[audio][recorder]") {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "vibenes_test_recorder_overflow.f32";
+	AudioRecorder recorder;
+	REQUIRE(recorder.open(path, 44100, AudioRecorder::Format::RawFloat));
+	// Far more than a ring in one go: whatever doesn't fit is counted
+	const std::vector<float> burst = ramp(1 << 20);
+	recorder.write(AudioRecorder::Track::Mix, burst);
+	REQUIRE(recorder.close());
+	REQUIRE(recorder.dropped_samples() > 0);
+	REQUIRE(recorder.samples_written(AudioRecorder::Track::Mix) + recorder.dropped_samples() == burst.size());
+	REQUIRE(std::filesystem::file_size(path) == recorder.samples_written(AudioRecorder::Track::Mix) * sizeof(float));
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Audio Recorder - Open failure", "[audio][recorder]") {
+	AudioRecorder recorder;
+	REQUIRE_FALSE(recorder.open(std::filesystem::temp_directory_path() / "vibenes_missing_dir" / "x.wav", 44100));
+	REQUIRE_FALSE(recorder.is_open());
+	REQUIRE(recorder.close());
+}
@@ -0,0 +1,72 @@
+// VibeNES - NES Emulator
+// Blip Buffer Tests
+// Tests for band-limited step synthesis used by the APU's block synthesis mode
+
+#include "../../include/audio/blip_buffer.hpp"
+#include <catch2/catch_all.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace nes;
+
+static std::vector<float> read_all(BlipBuffer &blip) {
+	std::vector<float> out(blip.samples_available());
+	out.resize(blip.read_samples(out));
+	return out;
+}
+
+TEST_CASE("Blip Buffer - Frames", "[audio][blip]") {
+	BlipBuffer blip(1789773.0, 44100.0, 29781);
+
+	SECTION("A frame yields clocks * rate samples") {
+		blip.end_frame(29781);
+		// 29781 * 44100 / 1789773 = 733.8
+		REQUIRE(blip.samples_available() == 733);
+		REQUIRE(read_all(blip).size() == 733);
+
+		// The fractional sample carries into the next frame
+		blip.end_frame(29781);
+		REQUIRE(blip.samples_available() == 734);
+	}
+
+	SECTION("Silence stays silent") {
+		blip.end_frame(29781);
+		for (float sample : read_all(blip)) {
+			REQUIRE(sample == 0.0f);
+		}
+	}
+
+	SECTION("A step settles at its amplitude") {
+		blip.add_delta(10000, 0.5f);
+		blip.end_frame(29781);
+		const auto out = read_all(blip);
+		const auto step_index = static_cast<std::size_t>(10000.0 * 44100.0 / 1789773.0);
+
+		REQUIRE(std::abs(out[step_index - BlipBuffer::HALF_WIDTH]) < 1e-4f);
+		REQUIRE(std::abs(out.back() - 0.5f) < 1e-4f);
+		// Band-limited: the edge spreads over a few samples instead of jumping
+		float max_step = 0.0f;
+		for (std::size_t i = 1; i < out.size(); ++i) {
+			max_step = std::max(max_step, out[i] - out[i - 1]);
+		}
+		REQUIRE(max_step < 0.5f);
+	}
+
+	SECTION("Edges beyond a read carry into the next one") {
+		blip.add_delta(29780, 1.0f);
+		blip.end_frame(29781);
+		read_all(blip);
+		blip.end_frame(29781);
+		REQUIRE(std::abs(read_all(blip).back() - 1.0f) < 1e-4f);
+	}
+
+	SECTION("Clear drops pending deltas and level") {
+		blip.add_delta(100, 1.0f);
+		blip.end_frame(29781);
+		blip.clear();
+		REQUIRE(blip.samples_available() == 0);
+		blip.end_frame(29781);
+		REQUIRE(read_all(blip).back() == 0.0f);
+	}
+}
@@ -0,0 +1,124 @@
+// VibeNES - NES Emulator
+// Latency Controller Tests
+// Tests for device cadence and drift measurement and the adaptive buffer target
+
+#include "../../include/audio/latency_controller.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <cstdint>
+
+using namespace nes;
+
+namespace {
+
+constexpr double NS = 1e9;
+
+// The APU's producer (one handoff per video frame, proportional rate
+// control on the fill after it) against a device pulling fixed blocks
+struct Simulation {
+	LatencyController controller;
+	double device_rate = 44100.0;
+	std::size_t pull = 512;
+	double fill = 3072.0;
+	double produced = 0.0;
+	double ratio = 1.0;
+
+	std::uint64_t underruns_between(double from_s, double to_s) {
+		const double frame_ns = NS / 60.0988;
+		const double pull_ns = static_cast<double>(pull) * NS / device_rate;
+		double next_frame = from_s * NS;
+		double next_pull = from_s * NS;
+		const std::uint64_t before = controller.stats().underruns;
+		while (std::min(next_frame, next_pull) < to_s * NS) {
+			if (next_frame <= next_pull) {
+				const double next = produced + 44100.0 / 60.0988 / ratio;
+				fill += std::floor(next) - std::floor(produced);
+				produced = next;
+				const auto target = static_cast<double>(controller.target());
+				ratio = std::clamp(1.0 + (fill - target) / target * 0.003, 0.995, 1.005);
+				next_frame += frame_ns;
+			} else {
+				controller.on_pull(static_cast<std::uint64_t>(next_pull), pull, static_cast<std::size_t>(fill));
+				fill = std::max(0.0, fill - static_cast<double>(pull));
+				next_pull += pull_ns;
+			}
+		}
+		return controller.stats().underruns - before;
+	}
+};
+
+} // namespace
+
+TEST_CASE("Latency Controller - Measurement", "[audio][latency]") {
+	Simulation sim;
+	sim.device_rate = 44100.0 * (1.0 + 150e-6);
+	REQUIRE(sim.controller.stats().device_rate_hz == 0.0);
+	REQUIRE(sim.underruns_between(0.0, 60.0) == 0);
+
+	const LatencyController::Stats stats = sim.controller.stats();
+	REQUIRE(std::abs(stats.callback_interval_ms - 512.0 * 1000.0 / sim.device_rate) < 0.01);
+	REQUIRE(stats.callback_jitter_ms < 0.01);
+	REQUIRE(stats.largest_pull == 512);
+	REQUIRE(std::abs(stats.drift_ppm - 150.0) < 10.0);
+
+	// Not adaptive: the tuned default stays
+	REQUIRE_FALSE(sim.controller.is_adaptive());
+	REQUIRE(stats.target == LatencyController::DEFAULT_TARGET);
+	REQUIRE(std::abs(sim.controller.to_ms(stats.target) - 69.7) < 0.1);
+}
+
+TEST_CASE("Latency Controller - Adaptation", "[audio][latency]") {
+	const std::size_t pull = GENERATE(256, 512, 1024);
+	Simulation sim;
+	sim.pull = pull;
+	sim.controller.set_adaptive(true);
+
+	SECTION("Shrinks toward the smallest target that stays underrun-free") {
+		REQUIRE(sim.underruns_between(0.0, 600.0) == 0);
+		const std::size_t settled = sim.controller.target();
+		// Never under two pulls, and about a video frame's handoff plus a pull
+		// and the margin above that (~21 ms with 256-frame pulls)
+		REQUIRE(settled >= pull * 2);
+		REQUIRE(settled < 735 + pull * 2);
+		REQUIRE(sim.underruns_between(600.0, 900.0) == 0);
+		REQUIRE(sim.controller.target() == settled);
+	}
+
+	SECTION("An underrun raises the target and holds it") {
+		sim.underruns_between(0.0, 120.0);
+		const std::size_t settled = sim.controller.target();
+		sim.fill = 0.0;
+		REQUIRE(sim.underruns_between(120.0, 122.5) > 0);
+		const std::size_t raised = sim.controller.target();
+		REQUIRE(raised >= settled + settled / 2);
+		sim.underruns_between(122.5, 122.5 + LatencyController::WINDOW_SECONDS * LatencyController::HOLD_WINDOWS);
+		REQUIRE(sim.controller.target() == raised);
+	}
+
+	SECTION("Turning adaptation off restores the default") {
+		sim.underruns_between(0.0, 30.0);
+		REQUIRE(sim.controller.target() < LatencyController::DEFAULT_TARGET);
+		sim.controller.set_adaptive(false);
+		REQUIRE(sim.controller.target() == LatencyController::DEFAULT_TARGET);
+	}
+}
+
+TEST_CASE("Latency Controller - Reset", "[audio][latency]") {
+	LatencyController controller;
+	controller.set_adaptive(true);
+	for (std::uint64_t i = 0; i < 1000; ++i) {
+		controller.on_pull(i * 11'600'000, 512, i % 2 ? 100 : 3000);
+	}
+	REQUIRE(controller.stats().underruns == 500);
+	REQUIRE(controller.target() > LatencyController::DEFAULT_TARGET);
+	REQUIRE(controller.target() <= LatencyController::MAX_TARGET);
+
+	controller.reset();
+	REQUIRE(controller.target() == LatencyController::DEFAULT_TARGET);
+	controller.on_pull(20'000'000'000, 512, 3000);
+	const LatencyController::Stats stats = controller.stats();
+	REQUIRE(stats.underruns == 0);
+	REQUIRE(stats.callback_interval_ms == 0.0);
+	REQUIRE(stats.fill == 3000);
+}
@@ -0,0 +1,119 @@
+// VibeNES - NES Emulator
+// Sinc Resampler Tests
+// Tests for the polyphase windowed-sinc downsampler and the block resampling API
+
+#include "../../include/audio/sample_rate_converter.hpp"
+#include "../../include/audio/sinc_resampler.hpp"
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+constexpr double CPU_RATE = 1789773.0;
+constexpr double PI = 3.14159265358979323846;
+
+std::vector<float> tone(double frequency, std::size_t count, double amplitude = 1.0) {
+	std::vector<float> samples(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		samples[i] = static_cast<float>(amplitude * std::sin(2.0 * PI * frequency * static_cast<double>(i) / CPU_RATE));
+	}
+	return samples;
+}
+
+template <typename Converter>
+std::vector<float> resample(Converter &converter, const std::vector<float> &input, std::size_t block = 256) {
+	std::vector<float> output;
+	std::vector<float> chunk(block + 1);
+	for (std::size_t i = 0; i < input.size(); i += block) {
+		const std::size_t n = std::min(block, input.size() - i);
+		const std::size_t written = converter.process({input.data() + i, n}, chunk);
+		output.insert(output.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(written));
+	}
+	return output;
+}
+
+// RMS over the second half (past the kernel's settling)
+double settled_rms(const std::vector<float> &samples) {
+	double energy = 0.0;
+	const std::size_t start = samples.size() / 2;
+	for (std::size_t i = start; i < samples.size(); ++i) {
+		energy += static_cast<double>(samples[i]) * samples[i];
+	}
+	return std::sqrt(energy / static_cast<double>(samples.size() - start));
+}
+
+} // namespace
+
+TEST_CASE("Sinc Resampler - Rates", "[audio][resampler]") {
+	const double output_rate = GENERATE(44100.0, 48000.0, 96000.0);
+	SincResampler resampler(static_cast<float>(CPU_RATE), static_cast<float>(output_rate));
+	REQUIRE(std::abs(resampler.get_ratio() - CPU_RATE / output_rate) < 1e-3);
+	REQUIRE(resampler.get_decimation() == static_cast<int>(CPU_RATE / output_rate / 4.0));
+
+	// One second of input yields one second of output
+	const std::vector<float> input(static_cast<std::size_t>(CPU_RATE), 0.5f);
+	const std::vector<float> output = resample(resampler, input);
+	REQUIRE(std::abs(static_cast<double>(output.size()) - output_rate) <= 2.0);
+
+	// DC passes at unit gain once the kernel has filled
+	for (std::size_t i = SincResampler::TAPS; i < output.size(); ++i) {
+		REQUIRE(std::abs(output[i] - 0.5f) < 1e-4f);
+	}
+}
+
+TEST_CASE("Sinc Resampler - Alias rejection", "[audio][resampler]") {
+	constexpr std::size_t count = 1789773 / 4;
+
+	SECTION("In-band tones pass") {
+		SincResampler resampler;
+		const double rms = settled_rms(resample(resampler, tone(1000.0, count)));
+		REQUIRE(std::abs(rms - std::sqrt(0.5)) < 0.01);
+	}
+
+	SECTION("Tones above Nyquist are rejected far better than by the box average") {
+		// 30 kHz would fold to 14.1 kHz at 44.1 kHz
+		const std::vector<float> input = tone(30000.0, count);
+		SincResampler sinc;
+		SampleRateConverter box;
+		const double sinc_rms = settled_rms(resample(sinc, input));
+		const double box_rms = settled_rms(resample(box, input));
+		REQUIRE(sinc_rms < 1e-3);
+		REQUIRE(box_rms > 0.1);
+	}
+}
+
+TEST_CASE("Sinc Resampler - Blocks", "[audio][resampler]") {
+	const std::vector<float> input = tone(440.0, 100000, 0.8);
+
+	SECTION("Output does not depend on how the input is split") {
+		SincResampler whole;
+		SincResampler pieces;
+		const std::vector<float> expected = resample(whole, input, 4096);
+		const std::vector<float> actual = resample(pieces, input, 37);
+		REQUIRE(actual == expected);
+	}
+
+	SECTION("Reset restarts cleanly") {
+		SincResampler resampler;
+		const std::vector<float> first = resample(resampler, input);
+		resampler.reset();
+		REQUIRE(resample(resampler, input) == first);
+	}
+
+	SECTION("The box average's block API matches per-sample input") {
+		SampleRateConverter block;
+		SampleRateConverter single;
+		const std::vector<float> expected = resample(block, input, 100);
+		std::vector<float> actual;
+		for (float sample : input) {
+			single.input_sample(sample);
+			if (single.has_output()) {
+				actual.push_back(single.get_output());
+			}
+		}
+		REQUIRE(actual == expected);
+	}
+}
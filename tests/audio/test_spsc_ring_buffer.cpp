@@ -0,0 +1,99 @@
+// VibeNES - NES Emulator
+// SPSC Ring Buffer Tests
+// Tests for the wait-free audio sample ring shared by the emulation and audio threads
+
+#include "../../include/audio/spsc_ring_buffer.hpp"
+#include <catch2/catch_all.hpp>
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace nes;
+
+TEST_CASE("SPSC Ring Buffer - Single Thread", "[audio][ring]") {
+	SpscRingBuffer<int, 8> ring;
+
+	SECTION("Push then pop preserves order") {
+		const std::array<int, 5> in{1, 2, 3, 4, 5};
+		REQUIRE(ring.push(in) == 5);
+		REQUIRE(ring.size() == 5);
+		REQUIRE(ring.write_available() == 3);
+
+		std::array<int, 5> out{};
+		REQUIRE(ring.pop(out) == 5);
+		REQUIRE(out == in);
+		REQUIRE(ring.size() == 0);
+	}
+
+	SECTION("Push stops at capacity") {
+		const std::array<int, 10> in{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+		REQUIRE(ring.push(in) == 8);
+		REQUIRE(ring.write_available() == 0);
+		REQUIRE(ring.push(in) == 0);
+	}
+
+	SECTION("Pop returns only what is queued") {
+		const std::array<int, 2> in{7, 9};
+		ring.push(in);
+		std::array<int, 4> out{};
+		REQUIRE(ring.pop(out) == 2);
+		REQUIRE(out[0] == 7);
+		REQUIRE(out[1] == 9);
+	}
+
+	SECTION("Wraps around the end of storage") {
+		std::array<int, 6> scratch{};
+		const std::array<int, 6> first{0, 1, 2, 3, 4, 5};
+		ring.push(first);
+		ring.pop(scratch);
+
+		// Indices now sit at 6, so this block straddles the wrap point
+		const std::array<int, 6> second{10, 11, 12, 13, 14, 15};
+		REQUIRE(ring.push(second) == 6);
+		std::array<int, 6> out{};
+		REQUIRE(ring.pop(out) == 6);
+		REQUIRE(out == second);
+	}
+
+	SECTION("Reset drops queued items") {
+		const std::array<int, 4> in{1, 2, 3, 4};
+		ring.push(in);
+		ring.reset();
+		REQUIRE(ring.size() == 0);
+		REQUIRE(ring.write_available() == 8);
+	}
+}
+
+TEST_CASE("SPSC Ring Buffer - Concurrent", "[audio][ring]") {
+	SpscRingBuffer<std::uint32_t, 256> ring;
+	constexpr std::uint32_t TOTAL = 200000;
+
+	std::thread producer([&ring] {
+		std::uint32_t next = 0;
+		std::array<std::uint32_t, 37> block{};
+		while (next < TOTAL) {
+			std::size_t count = 0;
+			for (; count < block.size() && next + count < TOTAL; ++count) {
+				block[count] = next + static_cast<std::uint32_t>(count);
+			}
+			next += static_cast<std::uint32_t>(ring.push(std::span<const std::uint32_t>(block.data(), count)));
+		}
+	});
+
+	std::vector<std::uint32_t> received;
+	received.reserve(TOTAL);
+	std::array<std::uint32_t, 53> out{};
+	while (received.size() < TOTAL) {
+		const std::size_t count = ring.pop(out);
+		received.insert(received.end(), out.begin(), out.begin() + static_cast<std::ptrdiff_t>(count));
+	}
+	producer.join();
+
+	bool in_order = true;
+	for (std::uint32_t i = 0; i < TOTAL; ++i) {
+		in_order = in_order && received[i] == i;
+	}
+	REQUIRE(in_order);
+	REQUIRE(ring.size() == 0);
+}
@@ -0,0 +1,131 @@
+// VibeNES - NES Emulator
+// CHR Tile Cache Tests
+// The decoded cache must always agree with what Mapper::ppu_read returns
+
+#include "../../include/cartridge/chr_tile_cache.hpp"
+#include "../../include/cartridge/mappers/mapper_000.hpp"
+#include "../../include/cartridge/mappers/mapper_002.hpp"
+#include "../../include/cartridge/mappers/mapper_003.hpp"
+#include "../../include/cartridge/mappers/mapper_004.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace nes;
+
+static std::vector<uint8_t> make_chr(size_t size, uint32_t seed) {
+	std::vector<uint8_t> chr(size);
+	for (auto &byte : chr) {
+		seed = seed * 1664525u + 1013904223u;
+		byte = static_cast<uint8_t>(seed >> 24);
+	}
+	return chr;
+}
+
+// Every row of the cache matches a fresh decode of the mapper's CHR bytes
+static bool cache_matches_mapper(const Mapper &mapper) {
+	const ChrTileCache &cache = mapper.chr_tile_cache();
+	for (Address address = 0x0000; address < 0x2000; ++address) {
+		if (address & 0x08) {
+			continue; // High-plane addresses share the row of their low plane
+		}
+		const Byte low = mapper.ppu_read(address);
+		const Byte high = mapper.ppu_read(static_cast<Address>(address + 8));
+		if (cache.row(address) != ChrTileCache::decode_row(low, high) ||
+			cache.row_flipped(address) != ChrTileCache::decode_row_flipped(low, high)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("CHR Tile Cache - Row decoding", "[cartridge][chr-cache]") {
+	// Low plane 0b10000001, high plane 0b11000000 -> pixels 3,2,0,0,0,0,0,1
+	const ChrTileCache::Row row = ChrTileCache::decode_row(0x81, 0xC0);
+	REQUIRE(ChrTileCache::pixel(row, 0) == 3);
+	REQUIRE(ChrTileCache::pixel(row, 1) == 2);
+	for (int x = 2; x < 7; ++x) {
+		REQUIRE(ChrTileCache::pixel(row, x) == 0);
+	}
+	REQUIRE(ChrTileCache::pixel(row, 7) == 1);
+
+	const ChrTileCache::Row flipped = ChrTileCache::decode_row_flipped(0x81, 0xC0);
+	for (int x = 0; x < 8; ++x) {
+		REQUIRE(ChrTileCache::pixel(flipped, x) == ChrTileCache::pixel(row, 7 - x));
+	}
+}
+
+TEST_CASE("CHR Tile Cache - Follows mapper banking", "[cartridge][chr-cache]") {
+	// Mappers read ROM in place, so it has to outlive them
+	const std::vector<uint8_t> prg(32768, 0xEA);
+
+	SECTION("NROM CHR ROM") {
+		const auto chr = make_chr(8192, 1);
+		Mapper000 mapper(prg, chr, Mapper::Mirroring::Horizontal);
+		REQUIRE(cache_matches_mapper(mapper));
+	}
+
+	SECTION("CNROM 8KB bank switches") {
+		const auto prg_ff = std::vector<uint8_t>(32768, 0xFF); // No bus conflicts
+		const auto chr = make_chr(4 * 8192, 2);
+		Mapper003 mapper(prg_ff, chr, Mapper::Mirroring::Vertical);
+		for (uint8_t bank : {1, 3, 0, 2, 1}) {
+			mapper.cpu_write(0x8000, bank);
+			REQUIRE(cache_matches_mapper(mapper));
+		}
+	}
+
+	SECTION("MMC3 1KB/2KB banks and CHR mode swap") {
+		const std::vector<uint8_t> prg_64k(65536, 0xEA);
+		const auto chr = make_chr(64 * 1024, 3);
+		Mapper004 mapper(prg_64k, chr, Mapper::Mirroring::Vertical);
+		REQUIRE(cache_matches_mapper(mapper));
+
+		for (uint8_t mode : {0x00, 0x80}) {
+			for (uint8_t reg = 0; reg < 6; ++reg) {
+				mapper.cpu_write(0x8000, static_cast<uint8_t>(mode | reg));
+				mapper.cpu_write(0x8001, static_cast<uint8_t>(reg * 9 + 5));
+			}
+			REQUIRE(cache_matches_mapper(mapper));
+		}
+	}
+
+	SECTION("Unmapped slots decode as open bus") {
+		// 4KB of CHR leaves the upper slots pointing at the open-bus page
+		const auto chr = make_chr(4096, 4);
+		Mapper000 mapper(prg, chr, Mapper::Mirroring::Horizontal);
+		REQUIRE(mapper.ppu_read(0x1000) == 0xFF);
+		REQUIRE(cache_matches_mapper(mapper));
+	}
+}
+
+TEST_CASE("CHR Tile Cache - CHR RAM invalidation", "[cartridge][chr-cache]") {
+	auto prg = std::vector<uint8_t>(65536, 0xFF);
+	Mapper002 mapper(prg, {}, Mapper::Mirroring::Horizontal);
+
+	SECTION("Writes to either plane update the decoded row") {
+		mapper.ppu_write(0x0010, 0xF0); // Tile 1, row 0, low plane
+		mapper.ppu_write(0x0018, 0x0F); // Tile 1, row 0, high plane
+		const ChrTileCache::Row row = mapper.chr_tile_cache().row(0x0010);
+		REQUIRE(ChrTileCache::pixel(row, 0) == 1);
+		REQUIRE(ChrTileCache::pixel(row, 7) == 2);
+
+		for (Address address = 0x1000; address < 0x1400; ++address) {
+			mapper.ppu_write(address, static_cast<uint8_t>(address * 13));
+		}
+		REQUIRE(cache_matches_mapper(mapper));
+	}
+
+	SECTION("Save state restore re-decodes CHR RAM") {
+		mapper.ppu_write(0x0123, 0x5A);
+		std::vector<uint8_t> buffer;
+		mapper.serialize_state(buffer);
+
+		Mapper002 restored(prg, {}, Mapper::Mirroring::Horizontal);
+		REQUIRE(restored.chr_tile_cache().row(0x0123) == 0);
+		size_t offset = 0;
+		restored.deserialize_state(buffer, offset);
+		REQUIRE(cache_matches_mapper(restored));
+		REQUIRE(restored.chr_tile_cache().row(0x0123) == mapper.chr_tile_cache().row(0x0123));
+	}
+}
@@ -0,0 +1,163 @@
+// VibeNES - NES Emulator
+// Code/Data Logger Tests
+// PRG/CHR ROM access flags recorded by the bus and PPU, and the .cdl file
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/code_data_logger.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <vector>
+
+using namespace nes;
+
+// NROM cart running `code` from $8000, CHR filled with $55
+static RomData build_nrom(const std::vector<Byte> &code) {
+	return test::make_nrom(code, {}, std::vector<Byte>(8192, 0x55));
+}
+
+TEST_CASE("Code Data Logger - Flag Recording", "[cartridge][cdl]") {
+	std::vector<Byte> prg(0x8000);
+	std::vector<Byte> chr(0x2000);
+	CodeDataLogger cdl;
+	cdl.attach(prg, chr);
+	REQUIRE(cdl.prg_log().size() == 0x8000);
+	REQUIRE(cdl.chr_log().size() == 0x2000);
+
+	SECTION("PRG bytes keep every access kind plus the CPU window") {
+		cdl.log_prg(&prg[0x2000], 0xC010, CodeDataLogger::PRG_CODE);
+		cdl.log_prg(&prg[0x2000], 0xC010, CodeDataLogger::PRG_DATA);
+		cdl.log_prg(&prg[0x6000], 0xE004, CodeDataLogger::PRG_PCM);
+		REQUIRE(cdl.prg_log()[0x2010] == (CodeDataLogger::PRG_CODE | CodeDataLogger::PRG_DATA | 0x08));
+		REQUIRE(cdl.prg_log()[0x6004] == (CodeDataLogger::PRG_PCM | 0x0C));
+
+		const CodeDataLogger::Coverage coverage = cdl.coverage();
+		REQUIRE(coverage.prg_logged == 2);
+		REQUIRE(coverage.prg_code == 1);
+		REQUIRE(coverage.prg_data == 1);
+		REQUIRE(coverage.prg_pcm == 1);
+	}
+
+	SECTION("CHR bytes resolve through the 1KB slot") {
+		cdl.log_chr(&chr[0x1C00], 0x0405, CodeDataLogger::CHR_RENDERED);
+		cdl.log_chr(&chr[0x1C00], 0x0405, CodeDataLogger::CHR_READ);
+		REQUIRE(cdl.chr_log()[0x1C05] == (CodeDataLogger::CHR_RENDERED | CodeDataLogger::CHR_READ));
+		REQUIRE(cdl.coverage().chr_logged == 1);
+	}
+
+	SECTION("Pages outside the attached ROM are ignored") {
+		std::vector<Byte> ram(0x2000);
+		cdl.log_prg(ram.data(), 0x8000, CodeDataLogger::PRG_CODE);
+		cdl.log_chr(nullptr, 0x0000, CodeDataLogger::CHR_RENDERED);
+		REQUIRE(cdl.coverage().prg_logged == 0);
+		REQUIRE(cdl.coverage().chr_logged == 0);
+	}
+}
+
+TEST_CASE("Code Data Logger - File Round Trip", "[cartridge][cdl]") {
+	std::vector<Byte> prg(0x4000);
+	std::vector<Byte> chr(0x2000);
+	CodeDataLogger cdl;
+	cdl.attach(prg, chr);
+	cdl.log_prg(prg.data(), 0x8001, CodeDataLogger::PRG_CODE);
+	cdl.log_chr(chr.data(), 0x0002, CodeDataLogger::CHR_READ);
+
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "vibenes_test_cdl.cdl";
+	REQUIRE(cdl.save(path));
+	REQUIRE(std::filesystem::file_size(path) == 0x4000 + 0x2000);
+
+	// Loading merges into what this session already logged
+	CodeDataLogger merged;
+	merged.attach(prg, chr);
+	merged.log_prg(prg.data(), 0x8003, CodeDataLogger::PRG_DATA);
+	REQUIRE(merged.load(path));
+	REQUIRE(merged.prg_log()[0x0001] == CodeDataLogger::PRG_CODE);
+	REQUIRE(merged.prg_log()[0x0003] == CodeDataLogger::PRG_DATA);
+	REQUIRE(merged.chr_log()[0x0002] == CodeDataLogger::CHR_READ);
+
+	// A log recorded for a different ROM size is refused
+	CodeDataLogger other;
+	other.attach(prg, {});
+	REQUIRE_FALSE(other.load(path));
+	REQUIRE(other.coverage().prg_logged == 0);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Code Data Logger - Emulated Accesses", "[cartridge][cdl]") {
+	const std::vector<Byte> code = {
+		0xAD, 0x00, 0x90, // 8000: LDA $9000
+		0xA9, 0x00,		  // 8003: LDA #$00
+		0x8D, 0x06, 0x20, // 8005: STA $2006
+		0x8D, 0x06, 0x20, // 8008: STA $2006
+		0xAD, 0x07, 0x20, // 800B: LDA $2007 (CHR $0000)
+		0xAD, 0x07, 0x20, // 800E: LDA $2007 (CHR $0001)
+		0xA9, 0x0F,		  // 8011: LDA #$0F
+		0x8D, 0x10, 0x40, // 8013: STA $4010 (fastest DMC rate)
+		0xA9, 0x00,		  // 8016: LDA #$00
+		0x8D, 0x12, 0x40, // 8018: STA $4012 (sample at $C000)
+		0xA9, 0x01,		  // 801B: LDA #$01
+		0x8D, 0x13, 0x40, // 801D: STA $4013 (17 bytes)
+		0xA9, 0x10,		  // 8020: LDA #$10
+		0x8D, 0x15, 0x40, // 8022: STA $4015 (start DMC)
+		0xA9, 0x08,		  // 8025: LDA #$08
+		0x8D, 0x01, 0x20, // 8027: STA $2001 (background on)
+		0x4C, 0x2A, 0x80, // 802A: JMP $802A
+	};
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_nrom(code)));
+	Cartridge &cartridge = system.cartridge();
+
+	SECTION("Nothing is logged while the logger is off") {
+		REQUIRE(cartridge.code_data_logger() == nullptr);
+		system.run_frame();
+		REQUIRE(cartridge.get_cdl().coverage().prg_logged == 0);
+	}
+
+	SECTION("Code, data, PCM and CHR accesses are told apart") {
+		cartridge.set_cdl_enabled(true);
+		system.reset();
+		system.run_frame();
+		system.run_frame();
+		const std::span<const Byte> prg = cartridge.get_cdl().prg_log();
+		const std::span<const Byte> chr = cartridge.get_cdl().chr_log();
+		REQUIRE(prg.size() == 32768);
+		REQUIRE(chr.size() == 8192);
+
+		REQUIRE(prg[0x0000] == CodeDataLogger::PRG_CODE); // Opcode
+		REQUIRE(prg[0x0002] == CodeDataLogger::PRG_CODE); // Operand
+		REQUIRE(prg[0x002A] == CodeDataLogger::PRG_CODE);
+		REQUIRE(prg[0x0030] == 0); // Never reached
+		REQUIRE(prg[0x1000] == CodeDataLogger::PRG_DATA);
+		REQUIRE(prg[0x7FFC] == (CodeDataLogger::PRG_DATA | 0x0C)); // Reset vector, $E000 window
+		REQUIRE(prg[0x4000] == (CodeDataLogger::PRG_PCM | 0x08));  // Sample, $C000 window
+		REQUIRE(prg[0x4010] == (CodeDataLogger::PRG_PCM | 0x08));
+
+		REQUIRE((chr[0x0000] & CodeDataLogger::CHR_READ) != 0);
+		REQUIRE((chr[0x0001] & CodeDataLogger::CHR_READ) != 0);
+		// Tile 0 is fetched for the background (through the tile cache)
+		for (std::size_t i = 0; i < 16; ++i) {
+			REQUIRE((chr[i] & CodeDataLogger::CHR_RENDERED) != 0);
+		}
+		REQUIRE(chr[0x0010] == 0);
+	}
+
+	SECTION("Disabling keeps the log, reloading the ROM starts a new one") {
+		cartridge.set_cdl_enabled(true);
+		system.reset();
+		system.run_frame();
+		cartridge.set_cdl_enabled(false);
+		REQUIRE(cartridge.code_data_logger() == nullptr);
+		const std::size_t logged = cartridge.get_cdl().coverage().prg_logged;
+		REQUIRE(logged > 0);
+		system.run_frame();
+		REQUIRE(cartridge.get_cdl().coverage().prg_logged == logged);
+
+		cartridge.set_cdl_enabled(true);
+		REQUIRE(system.load_rom_data(build_nrom(code)));
+		REQUIRE(cartridge.code_data_logger() != nullptr);
+		REQUIRE(cartridge.get_cdl().coverage().prg_logged == 0);
+	}
+}
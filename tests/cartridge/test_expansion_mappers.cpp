@@ -0,0 +1,666 @@
+// VibeNES - NES Emulator
+// Expansion Mapper Tests
+// Tests for Mappers 5 (MMC5), 21-25 (VRC2/VRC4), 24/26 (VRC6), 69 (FME-7), 85 (VRC7)
+// and their sound chips
+
+#include "../../include/apu/apu.hpp"
+#include "../../include/apu/mmc5_audio.hpp"
+#include "../../include/apu/sunsoft_5b_audio.hpp"
+#include "../../include/apu/vrc6_audio.hpp"
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/mappers/mapper_005.hpp"
+#include "../../include/cartridge/mappers/mapper_021.hpp"
+#include "../../include/cartridge/mappers/mapper_024.hpp"
+#include "../../include/cartridge/mappers/mapper_069.hpp"
+#include "../../include/cartridge/mappers/mapper_085.hpp"
+#include "../../include/cartridge/mappers/vrc_irq.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/core/types.hpp"
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// Every 8KB PRG bank (and 1KB CHR bank) starts with its bank number
+std::vector<uint8_t> make_banked(size_t size, size_t bank_size) {
+	std::vector<uint8_t> rom(size, 0x00);
+	for (size_t bank = 0; bank < size / bank_size; ++bank) {
+		rom[bank * bank_size] = static_cast<uint8_t>(bank);
+	}
+	return rom;
+}
+
+// Cycles until the counter's next IRQ, found by running it one cycle at a time
+uint32_t count_cycles_to_overflow(VrcIrqCounter counter) {
+	for (uint32_t cycles = 1; cycles < 100000; ++cycles) {
+		if (counter.run(1)) {
+			return cycles;
+		}
+	}
+	return 0;
+}
+
+} // namespace
+
+// =============================================================================
+// VRC IRQ counter
+// =============================================================================
+
+TEST_CASE("VRC IRQ counter - Deadline matches per-cycle stepping", "[mapper][vrc][irq]") {
+	for (const Byte control : {Byte{0x02}, Byte{0x06}}) { // Scanline mode, cycle mode
+		for (const Byte latch : {Byte{0x00}, Byte{0x80}, Byte{0xF0}, Byte{0xFF}}) {
+			VrcIrqCounter counter;
+			counter.latch = latch;
+			counter.write_control(control);
+			// Start part way through a prescaler period too
+			counter.run(7);
+
+			const uint32_t until = counter.cycles_until_overflow();
+			REQUIRE(until == count_cycles_to_overflow(counter));
+
+			// One span lands on the same state as per-cycle stepping
+			VrcIrqCounter stepped = counter;
+			VrcIrqCounter spanned = counter;
+			for (int i = 0; i < 5000; ++i) {
+				stepped.run(1);
+			}
+			spanned.run(5000);
+			REQUIRE(spanned.counter == stepped.counter);
+			REQUIRE(spanned.prescaler == stepped.prescaler);
+		}
+	}
+}
+
+TEST_CASE("VRC IRQ counter - Disabled counter never fires", "[mapper][vrc][irq]") {
+	VrcIrqCounter counter;
+	counter.write_control(0x00);
+	REQUIRE(counter.cycles_until_overflow() == Mapper::NO_CYCLE_IRQ);
+	REQUIRE_FALSE(counter.run(100000));
+}
+
+// =============================================================================
+// Mapper 21 (VRC4)
+// =============================================================================
+
+TEST_CASE("Mapper 21 (VRC4) - PRG and CHR banking", "[mapper][mapper21]") {
+	auto prg = make_banked(16 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper021 mapper(21, prg, chr, Mapper::Mirroring::Vertical);
+
+	SECTION("Fixed and switchable PRG banks") {
+		mapper.cpu_write(0x8000, 5);
+		mapper.cpu_write(0xA000, 7);
+		REQUIRE(mapper.cpu_read(0x8000) == 5);
+		REQUIRE(mapper.cpu_read(0xA000) == 7);
+		REQUIRE(mapper.cpu_read(0xC000) == 14);
+		REQUIRE(mapper.cpu_read(0xE000) == 15);
+	}
+
+	SECTION("Swap mode moves the $8000 bank to $C000") {
+		mapper.cpu_write(0x8000, 5);
+		mapper.cpu_write(0x9004, 0x02); // $9002 on VRC4a wiring (A2)
+		REQUIRE(mapper.cpu_read(0x8000) == 14);
+		REQUIRE(mapper.cpu_read(0xC000) == 5);
+	}
+
+	SECTION("CHR banks are written a nibble at a time") {
+		mapper.cpu_write(0xC000, 0x09); // Bank 2 low nibble
+		mapper.cpu_write(0xC002, 0x02); // Bank 2 high bits (A1 on VRC4a)
+		REQUIRE(mapper.ppu_read(0x0800) == 0x29);
+	}
+
+	SECTION("Mirroring") {
+		mapper.cpu_write(0x9000, 0x01);
+		REQUIRE(mapper.get_mirroring() == Mapper::Mirroring::Horizontal);
+		mapper.cpu_write(0x9000, 0x03);
+		REQUIRE(mapper.get_mirroring() == Mapper::Mirroring::SingleScreenHigh);
+	}
+}
+
+TEST_CASE("Mapper 21 (VRC4) - Wirings decode to the same registers", "[mapper][mapper21]") {
+	auto prg = make_banked(16 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+
+	// (mapper, address of the bank 0 high-bits register ($B001))
+	const std::vector<std::pair<uint16_t, Address>> wirings = {
+		{21, 0xB002}, {21, 0xB040}, {23, 0xB001}, {23, 0xB004}, {25, 0xB002}, {25, 0xB008}};
+	for (const auto &[id, address] : wirings) {
+		Mapper021 mapper(id, prg, chr, Mapper::Mirroring::Vertical);
+		mapper.cpu_write(0xB000, 0x01);
+		mapper.cpu_write(address, 0x01);
+		REQUIRE(mapper.ppu_read(0x0000) == 0x11);
+	}
+}
+
+TEST_CASE("Mapper 21 (VRC4) - IRQ runs from the cycle timer", "[mapper][mapper21][irq]") {
+	auto prg = make_banked(16 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper021 mapper(21, prg, chr, Mapper::Mirroring::Vertical);
+	REQUIRE(mapper.has_cpu_cycle_timer());
+
+	mapper.cpu_write(0xF000, 0x0C); // Latch $FC
+	mapper.cpu_write(0xF002, 0x0F);
+	mapper.cpu_write(0xF004, 0x07); // Control: enable, cycle mode, re-enable on ack
+	REQUIRE(mapper.cpu_cycles_until_irq() == 4);
+
+	mapper.run_cpu_cycle_timer(3);
+	REQUIRE_FALSE(mapper.is_irq_pending());
+	mapper.run_cpu_cycle_timer(1);
+	REQUIRE(mapper.is_irq_pending());
+
+	mapper.cpu_write(0xF006, 0x00); // Acknowledge
+	REQUIRE_FALSE(mapper.is_irq_pending());
+	REQUIRE(mapper.cpu_cycles_until_irq() == 4);
+}
+
+TEST_CASE("Mapper 22 (VRC2a) - Has no IRQ and halves CHR banks", "[mapper][mapper21]") {
+	auto prg = make_banked(16 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper021 mapper(22, prg, chr, Mapper::Mirroring::Vertical);
+	REQUIRE_FALSE(mapper.has_cpu_cycle_timer());
+
+	mapper.cpu_write(0xB000, 0x06);
+	REQUIRE(mapper.ppu_read(0x0000) == 0x03);
+}
+
+TEST_CASE("Mapper 21 (VRC4) - Serialization", "[mapper][mapper21][serialization]") {
+	auto prg = make_banked(16 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper021 mapper(21, prg, chr, Mapper::Mirroring::Vertical);
+	mapper.cpu_write(0x8000, 3);
+	mapper.cpu_write(0xD000, 0x05);
+	mapper.cpu_write(0x6123, 0x42);
+	mapper.cpu_write(0xF000, 0x00);
+	mapper.cpu_write(0xF004, 0x06);
+	mapper.run_cpu_cycle_timer(100);
+
+	std::vector<uint8_t> state;
+	mapper.serialize_state(state);
+
+	Mapper021 restored(21, prg, chr, Mapper::Mirroring::Vertical);
+	size_t offset = 0;
+	restored.deserialize_state(state, offset);
+	REQUIRE(offset == state.size());
+	REQUIRE(restored.cpu_read(0x8000) == 3);
+	REQUIRE(restored.ppu_read(0x1000) == 0x05);
+	REQUIRE(restored.cpu_read(0x6123) == 0x42);
+	REQUIRE(restored.cpu_cycles_until_irq() == mapper.cpu_cycles_until_irq());
+
+	std::vector<uint8_t> truncated(state.begin(), state.end() - 3);
+	Mapper021 partial(21, prg, chr, Mapper::Mirroring::Vertical);
+	offset = 0;
+	REQUIRE_THROWS(partial.deserialize_state(truncated, offset));
+}
+
+// =============================================================================
+// Mapper 24 (VRC6)
+// =============================================================================
+
+TEST_CASE("Mapper 24 (VRC6) - Banking", "[mapper][mapper24]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper024 mapper(24, prg, chr, Mapper::Mirroring::Vertical);
+
+	mapper.cpu_write(0x8000, 3);  // 16KB: 8KB banks 6 and 7
+	mapper.cpu_write(0xC000, 10); // 8KB
+	REQUIRE(mapper.cpu_read(0x8000) == 6);
+	REQUIRE(mapper.cpu_read(0xA000) == 7);
+	REQUIRE(mapper.cpu_read(0xC000) == 10);
+	REQUIRE(mapper.cpu_read(0xE000) == 31);
+
+	mapper.cpu_write(0xE003, 0x21);
+	REQUIRE(mapper.ppu_read(0x1C00) == 0x21);
+
+	mapper.cpu_write(0xB003, 0x84); // Horizontal, PRG-RAM on
+	REQUIRE(mapper.get_mirroring() == Mapper::Mirroring::Horizontal);
+	mapper.cpu_write(0x6000, 0x5A);
+	REQUIRE(mapper.cpu_read(0x6000) == 0x5A);
+}
+
+TEST_CASE("Mapper 26 (VRC6b) - Swapped register lines", "[mapper][mapper24]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper024 mapper(26, prg, chr, Mapper::Mirroring::Vertical);
+
+	mapper.cpu_write(0xD001, 0x12); // $D002 on mapper 24: CHR bank 2
+	REQUIRE(mapper.ppu_read(0x0800) == 0x12);
+}
+
+TEST_CASE("Mapper 24 (VRC6) - Sound chip and IRQ", "[mapper][mapper24][audio]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper024 mapper(24, prg, chr, Mapper::Mirroring::Vertical);
+	auto audio = mapper.expansion_audio();
+	REQUIRE(audio != nullptr);
+	REQUIRE(audio->output() == 0.0f);
+
+	// Pulse 1 in constant mode at full volume
+	mapper.cpu_write(0x9000, 0x8F);
+	mapper.cpu_write(0x9002, 0x80);
+	REQUIRE(audio->output() > 0.0f);
+
+	mapper.cpu_write(0xF000, 0xFE);
+	mapper.cpu_write(0xF001, 0x06);
+	REQUIRE(mapper.cpu_cycles_until_irq() == 2);
+	mapper.run_cpu_cycle_timer(2);
+	REQUIRE(mapper.is_irq_pending());
+	mapper.cpu_write(0xF002, 0x00);
+	REQUIRE_FALSE(mapper.is_irq_pending());
+}
+
+// =============================================================================
+// Mapper 69 (FME-7)
+// =============================================================================
+
+TEST_CASE("Mapper 69 (FME-7) - Banking", "[mapper][mapper69]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper069 mapper(prg, chr, Mapper::Mirroring::Vertical);
+
+	mapper.cpu_write(0x8000, 0x09);
+	mapper.cpu_write(0xA000, 12);
+	REQUIRE(mapper.cpu_read(0x8000) == 12);
+	REQUIRE(mapper.cpu_read(0xE000) == 31);
+
+	mapper.cpu_write(0x8000, 0x05);
+	mapper.cpu_write(0xA000, 0x33);
+	REQUIRE(mapper.ppu_read(0x1400) == 0x33);
+
+	SECTION("$6000 maps ROM or RAM") {
+		mapper.cpu_write(0x8000, 0x08);
+		mapper.cpu_write(0xA000, 0x04);
+		REQUIRE(mapper.cpu_read(0x6000) == 4);
+		mapper.cpu_write(0xA000, 0xC0);
+		mapper.cpu_write(0x6000, 0x77);
+		REQUIRE(mapper.cpu_read(0x6000) == 0x77);
+	}
+}
+
+TEST_CASE("Mapper 69 (FME-7) - IRQ fires as the counter wraps", "[mapper][mapper69][irq]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper069 mapper(prg, chr, Mapper::Mirroring::Vertical);
+
+	mapper.cpu_write(0x8000, 0x0E);
+	mapper.cpu_write(0xA000, 0x10);
+	mapper.cpu_write(0x8000, 0x0F);
+	mapper.cpu_write(0xA000, 0x00);
+	REQUIRE(mapper.cpu_cycles_until_irq() == Mapper::NO_CYCLE_IRQ);
+
+	mapper.cpu_write(0x8000, 0x0D);
+	mapper.cpu_write(0xA000, 0x81);
+	REQUIRE(mapper.cpu_cycles_until_irq() == 0x11);
+	mapper.run_cpu_cycle_timer(0x10);
+	REQUIRE_FALSE(mapper.is_irq_pending());
+	mapper.run_cpu_cycle_timer(1);
+	REQUIRE(mapper.is_irq_pending());
+
+	// Writing the control register acknowledges
+	mapper.cpu_write(0xA000, 0x81);
+	REQUIRE_FALSE(mapper.is_irq_pending());
+	REQUIRE(mapper.cpu_cycles_until_irq() == 0x10000);
+}
+
+TEST_CASE("Mapper 69 (FME-7) - Sunsoft 5B tone", "[mapper][mapper69][audio]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper069 mapper(prg, chr, Mapper::Mirroring::Vertical);
+	auto audio = mapper.expansion_audio();
+	REQUIRE(audio != nullptr);
+
+	const auto poke = [&](Byte reg, Byte value) {
+		mapper.cpu_write(0xC000, reg);
+		mapper.cpu_write(0xE000, value);
+	};
+	poke(0, 0x10); // Channel A period 16 -> toggles every 256 cycles
+	poke(7, 0x3E); // Tone A only
+	poke(8, 0x0F);
+
+	REQUIRE(audio->cycles_until_step() <= 256);
+	const float before = audio->output();
+	audio->run(audio->cycles_until_step());
+	REQUIRE(audio->output() != before);
+	audio->run(256);
+	REQUIRE(audio->output() == before);
+}
+
+// =============================================================================
+// Mapper 85 (VRC7)
+// =============================================================================
+
+TEST_CASE("Mapper 85 (VRC7) - Banking and IRQ", "[mapper][mapper85]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper085 mapper(prg, chr, Mapper::Mirroring::Vertical);
+
+	mapper.cpu_write(0x8000, 4);
+	mapper.cpu_write(0x8010, 5);
+	mapper.cpu_write(0x9000, 6);
+	REQUIRE(mapper.cpu_read(0x8000) == 4);
+	REQUIRE(mapper.cpu_read(0xA000) == 5);
+	REQUIRE(mapper.cpu_read(0xC000) == 6);
+	REQUIRE(mapper.cpu_read(0xE000) == 31);
+
+	mapper.cpu_write(0x8008, 7); // VRC7b wiring (A3)
+	REQUIRE(mapper.cpu_read(0xA000) == 7);
+
+	mapper.cpu_write(0x9010, 0x20); // FM register select: no effect on banking
+	REQUIRE(mapper.cpu_read(0xC000) == 6);
+
+	mapper.cpu_write(0xD010, 0x2A);
+	REQUIRE(mapper.ppu_read(0x1C00) == 0x2A);
+
+	mapper.cpu_write(0xE010, 0xF0);
+	mapper.cpu_write(0xF000, 0x06);
+	REQUIRE(mapper.cpu_cycles_until_irq() == 16);
+}
+
+// =============================================================================
+// Mapper 5 (MMC5)
+// =============================================================================
+
+TEST_CASE("Mapper 5 (MMC5) - PRG modes", "[mapper][mapper5]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper005 mapper(prg, chr);
+
+	SECTION("Mode 3 starts with the last bank at $E000") {
+		REQUIRE(mapper.cpu_read(0xE000) == 31);
+	}
+
+	SECTION("Mode 0: one 32KB window") {
+		mapper.cpu_write(0x5100, 0x00);
+		mapper.cpu_write(0x5117, 0x85);
+		REQUIRE(mapper.cpu_read(0x8000) == 4);
+		REQUIRE(mapper.cpu_read(0xE000) == 7);
+	}
+
+	SECTION("Mode 2: 16KB + 8KB + 8KB") {
+		mapper.cpu_write(0x5100, 0x02);
+		mapper.cpu_write(0x5115, 0x8B);
+		mapper.cpu_write(0x5116, 0x83);
+		mapper.cpu_write(0x5117, 0x89);
+		REQUIRE(mapper.cpu_read(0x8000) == 10);
+		REQUIRE(mapper.cpu_read(0xA000) == 11);
+		REQUIRE(mapper.cpu_read(0xC000) == 3);
+		REQUIRE(mapper.cpu_read(0xE000) == 9);
+	}
+
+	SECTION("RAM banks need both protect registers") {
+		mapper.cpu_write(0x5114, 0x01); // RAM bank 1 at $8000
+		mapper.cpu_write(0x8000, 0x99);
+		REQUIRE(mapper.cpu_read(0x8000) == 0x00);
+		mapper.cpu_write(0x5102, 0x02);
+		mapper.cpu_write(0x5103, 0x01);
+		mapper.cpu_write(0x8000, 0x99);
+		REQUIRE(mapper.cpu_read(0x8000) == 0x99);
+
+		mapper.cpu_write(0x5113, 0x01); // Same RAM bank at $6000
+		REQUIRE(mapper.cpu_read(0x6000) == 0x99);
+	}
+}
+
+TEST_CASE("Mapper 5 (MMC5) - CHR sets with 8x16 sprites", "[mapper][mapper5]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper005 mapper(prg, chr);
+	mapper.cpu_write(0x5101, 0x03); // 1KB banks
+	mapper.cpu_write(0x5120, 0x10); // Set A, slot 0
+	mapper.cpu_write(0x5128, 0x20); // Set B, slot 0 (written last)
+
+	REQUIRE(mapper.ppu_read(0x0000) == 0x20);
+
+	mapper.ppu_scanline_start(0, true);
+	mapper.ppu_fetch_phase(true, true);
+	REQUIRE(mapper.ppu_read(0x0000) == 0x10); // Sprites from set A
+	REQUIRE(mapper.chr_tile_cache().slot_source(0) == chr.data() + 0x10 * 0x400);
+	mapper.ppu_fetch_phase(false, true);
+	REQUIRE(mapper.ppu_read(0x0000) == 0x20); // Background from set B
+
+	mapper.ppu_fetch_phase(true, false);
+	REQUIRE(mapper.ppu_read(0x0000) == 0x20); // 8x8 sprites: last-written set
+}
+
+TEST_CASE("Mapper 5 (MMC5) - Scanline IRQ and status", "[mapper][mapper5][irq]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper005 mapper(prg, chr);
+	mapper.cpu_write(0x5203, 100);
+	mapper.cpu_write(0x5204, 0x80);
+	REQUIRE(mapper.scanline_irq_armed());
+
+	for (int scanline = 0; scanline < 100; ++scanline) {
+		mapper.ppu_scanline_start(scanline, true);
+		REQUIRE_FALSE(mapper.is_irq_pending());
+	}
+	REQUIRE(mapper.cpu_read(0x5204) == 0x40); // In frame
+
+	mapper.ppu_scanline_start(100, true);
+	REQUIRE(mapper.is_irq_pending());
+	REQUIRE(mapper.cpu_read(0x5204) == 0xC0);
+	REQUIRE_FALSE(mapper.is_irq_pending()); // The read acknowledged it
+
+	mapper.ppu_scanline_start(240, true);
+	REQUIRE(mapper.cpu_read(0x5204) == 0x00);
+}
+
+TEST_CASE("Mapper 5 (MMC5) - Multiplier and ExRAM", "[mapper][mapper5]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper005 mapper(prg, chr);
+
+	mapper.cpu_write(0x5205, 200);
+	mapper.cpu_write(0x5206, 150);
+	REQUIRE(mapper.cpu_read(0x5205) == ((200 * 150) & 0xFF));
+	REQUIRE(mapper.cpu_read(0x5206) == ((200 * 150) >> 8));
+
+	mapper.cpu_write(0x5104, 0x02); // ExRAM as CPU RAM
+	mapper.cpu_write(0x5C10, 0xAB);
+	REQUIRE(mapper.cpu_read(0x5C10) == 0xAB);
+}
+
+TEST_CASE("Mapper 5 (MMC5) - Nametable mapping", "[mapper][mapper5]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper005 mapper(prg, chr);
+	std::vector<Byte> ciram(0x800, 0x00);
+	mapper.attach_ciram(ciram.data());
+
+	mapper.cpu_write(0x5106, 0x3C);
+	mapper.cpu_write(0x5107, 0x02);
+	mapper.cpu_write(0x5105, 0xE4); // CIRAM 0, CIRAM 1, ExRAM, fill
+	const auto &pages = mapper.nametable_pages();
+	REQUIRE(pages[0] == ciram.data());
+	REQUIRE(pages[1] == ciram.data() + 0x400);
+	REQUIRE(pages[3][0x000] == 0x3C);
+	REQUIRE(pages[3][0x3C0] == 0xAA);
+
+	mapper.cpu_write(0x5C00, 0x77);
+	REQUIRE(pages[2][0] == 0x77);
+}
+
+TEST_CASE("Mapper 5 (MMC5) - Serialization", "[mapper][mapper5][serialization]") {
+	auto prg = make_banked(32 * 0x2000, 0x2000);
+	auto chr = make_banked(64 * 0x400, 0x400);
+	Mapper005 mapper(prg, chr);
+	mapper.cpu_write(0x5100, 0x01);
+	mapper.cpu_write(0x5115, 0x86);
+	mapper.cpu_write(0x5127, 0x05);
+	mapper.cpu_write(0x5203, 0x40);
+	mapper.cpu_write(0x5015, 0x01);
+	mapper.cpu_write(0x5003, 0x08);
+
+	std::vector<uint8_t> state;
+	mapper.serialize_state(state);
+
+	Mapper005 restored(prg, chr);
+	size_t offset = 0;
+	restored.deserialize_state(state, offset);
+	REQUIRE(offset == state.size());
+	REQUIRE(restored.cpu_read(0x8000) == 6);
+	REQUIRE(restored.ppu_read(0x0000) == 0x28);
+	REQUIRE(restored.cpu_read(0x5015) == 0x01);
+
+	std::vector<uint8_t> again;
+	restored.serialize_state(again);
+	REQUIRE(again == state);
+}
+
+// =============================================================================
+// Sound chips
+// =============================================================================
+
+TEST_CASE("Expansion audio - Spans match single-cycle stepping", "[audio][expansion]") {
+	Vrc6Audio stepped;
+	stepped.write(0x9000, 0x3F);
+	stepped.write(0x9001, 0x40);
+	stepped.write(0x9002, 0x80);
+	stepped.write(0xB000, 0x0A);
+	stepped.write(0xB001, 0x30);
+	stepped.write(0xB002, 0x80);
+	Vrc6Audio spanned = stepped;
+
+	for (int i = 0; i < 5000; ++i) {
+		stepped.run(1);
+	}
+	uint32_t left = 5000;
+	while (left > 0) {
+		const uint32_t span = std::min(left, spanned.cycles_until_step());
+		spanned.run(span);
+		left -= span;
+	}
+	REQUIRE(spanned.output() == stepped.output());
+
+	std::vector<uint8_t> a;
+	std::vector<uint8_t> b;
+	stepped.serialize_state(a);
+	spanned.serialize_state(b);
+	REQUIRE(a == b);
+}
+
+TEST_CASE("Expansion audio - MMC5 length counters", "[audio][expansion]") {
+	Mmc5Audio audio;
+	audio.write(0x5015, 0x01);
+	audio.write(0x5000, 0x1F); // Constant volume 15, counter running
+	audio.write(0x5002, 0x80);
+	audio.write(0x5003, 0x18); // Length index 3: 2 frame clocks
+	REQUIRE(audio.read_status() == 0x01);
+	audio.run(7457 * 2);
+	REQUIRE(audio.read_status() == 0x00);
+}
+
+TEST_CASE("Expansion audio - APU mixes the chip", "[audio][expansion][apu]") {
+	APU apu;
+	apu.power_on();
+	const float silent = apu.get_audio_sample();
+
+	auto chip = std::make_shared<Vrc6Audio>();
+	chip->write(0x9000, 0x8F);
+	chip->write(0x9002, 0x80);
+	apu.set_expansion_audio(chip);
+	REQUIRE(apu.has_expansion_audio());
+	REQUIRE(std::abs(apu.get_audio_sample() - (silent + chip->output())) < 1e-6f);
+
+	apu.set_expansion_audio(nullptr);
+	REQUIRE(apu.get_audio_sample() == silent);
+}
+
+TEST_CASE("Expansion audio - Per-cycle mode runs the chip only when it steps", "[audio][expansion][apu]") {
+	APU apu;
+	apu.power_on();
+	const float silent = apu.get_audio_sample();
+
+	// The APU's chip against a twin run a cycle at a time by hand
+	auto chip = std::make_shared<Vrc6Audio>();
+	Vrc6Audio reference;
+	auto write = [&](uint16_t address, uint8_t value) {
+		apu.begin_expansion_write();
+		chip->write(address, value);
+		apu.end_expansion_write();
+		reference.write(address, value);
+	};
+	apu.set_expansion_audio(chip);
+	write(0x9000, 0x3A);
+	write(0x9001, 0x40);
+	write(0x9002, 0x80);
+	write(0xB000, 0x0C);
+	write(0xB001, 0x21);
+	write(0xB002, 0x80);
+
+	for (int cycle = 0; cycle < 20000; ++cycle) {
+		if (cycle == 7000) {
+			write(0x9001, 0x13); // New period mid-stream
+		}
+		apu.step_cpu_cycles(1);
+		reference.run(1);
+		REQUIRE(apu.get_audio_sample() == silent + reference.output());
+	}
+}
+
+TEST_CASE("Expansion audio - Gain scales the chip in the mix", "[audio][expansion][apu]") {
+	APU apu;
+	apu.power_on();
+	const float silent = apu.get_audio_sample();
+	REQUIRE(apu.get_expansion_gain() == 1.0f);
+	apu.set_expansion_gain(0.5f); // No chip: ignored
+
+	auto chip = std::make_shared<Vrc6Audio>();
+	chip->write(0x9000, 0x8F);
+	chip->write(0x9002, 0x80);
+	apu.set_expansion_audio(chip);
+	const float full = apu.get_audio_sample() - silent;
+	REQUIRE(full > 0.0f);
+
+	apu.set_expansion_gain(0.5f);
+	REQUIRE(chip->gain() == 0.5f);
+	REQUIRE(std::abs(apu.get_audio_sample() - (silent + full * 0.5f)) < 1e-6f);
+	apu.set_expansion_gain(0.0f);
+	REQUIRE(apu.get_audio_sample() == silent);
+}
+
+// =============================================================================
+// Bus integration
+// =============================================================================
+
+TEST_CASE("Expansion mappers - Bus raises the cycle IRQ on its deadline", "[mapper][bus][irq]") {
+	SystemBus bus;
+	auto cartridge = std::make_shared<Cartridge>();
+	bus.connect_cartridge(cartridge);
+
+	RomData rom{};
+	rom.mapper_id = 21;
+	rom.prg_rom_pages = 8;
+	rom.chr_rom_pages = 8;
+	rom.valid = true;
+	rom.prg_rom = make_banked(8 * 0x4000, 0x2000);
+	rom.chr_rom = make_banked(8 * 0x2000, 0x400);
+	REQUIRE(cartridge->load_from_rom_data(rom));
+	bus.reschedule_events();
+
+	bus.write(0xF000, 0x00);
+	bus.write(0xF002, 0x0F); // Latch $F0: 16 cycles per IRQ
+	bus.write(0xF004, 0x07);
+
+	for (int cycle = 1; cycle < 16; ++cycle) {
+		bus.tick_single_cpu_cycle();
+		REQUIRE_FALSE(cartridge->is_irq_pending());
+	}
+	bus.tick_single_cpu_cycle();
+	REQUIRE(cartridge->is_irq_pending());
+
+	// Acknowledge; the counter reloaded on overflow, so the next IRQ is one full period later
+	bus.write(0xF006, 0x00);
+	REQUIRE_FALSE(cartridge->is_irq_pending());
+	for (int cycle = 1; cycle < 16; ++cycle) {
+		bus.tick_single_cpu_cycle();
+	}
+	REQUIRE_FALSE(cartridge->is_irq_pending());
+	bus.tick_single_cpu_cycle();
+	REQUIRE(cartridge->is_irq_pending());
+}
@@ -180,20 +180,11 @@ TEST_CASE("Mapper 1 (MMC1) - Serial Write Protocol", "[mapper][mapper1]") {
 		// After 5 writes, the accumulated value is written to the target register
 		// Value 2 = 0b00010 → write bits: 0, 1, 0, 0, 0
 
-		// Need to tick between writes to avoid consecutive-write filter
-		mapper.notify_cpu_cycle();		// Cycle 1
+		// Untimed writes skip the consecutive-write filter
 		mapper.cpu_write(0xE000, 0x00); // bit 0 = 0
-		mapper.notify_cpu_cycle();		// Cycle 2 (dummy)
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x01); // bit 1 = 1
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x00); // bit 2 = 0
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x00); // bit 3 = 0
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x00); // bit 4 = 0 (5th write triggers load)
 
 		// PRG bank register now = 2
@@ -203,33 +194,18 @@ TEST_CASE("Mapper 1 (MMC1) - Serial Write Protocol", "[mapper][mapper1]") {
 
 	SECTION("Bit 7 reset clears shift register") {
 		// Start a write sequence
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x01);
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x01);
 
 		// Reset with bit 7
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x80);
 
 		// Shift register is reset — need fresh 5 writes
 		// Write bank 3 (0b00011)
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x01);
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x01);
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x00);
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x00);
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
 		mapper.cpu_write(0xE000, 0x00);
 
 		REQUIRE(mapper.cpu_read(0x8000) == 3);
@@ -241,34 +217,34 @@ TEST_CASE("Mapper 1 (MMC1) - Consecutive Write Filter", "[mapper][mapper1]") {
 	auto chr = make_rom(32768);
 	Mapper001 mapper(prg, chr, Mapper::Mirroring::Vertical);
 
-	SECTION("Back-to-back writes on same cycle are ignored") {
-		// First write
-		mapper.notify_cpu_cycle();
-		mapper.cpu_write(0xE000, 0x01);
+	SECTION("Write on the next cycle is ignored") {
+		// RMW pattern: old value on cycle 10, new value on cycle 11
+		mapper.cpu_write_at(0xE000, 0x01, 10);
+		mapper.cpu_write_at(0xE000, 0x01, 11); // Ignored
 
-		// Second write on SAME cycle (no notify_cpu_cycle between) — should be ignored
-		mapper.cpu_write(0xE000, 0x00);
+		mapper.cpu_write_at(0xE000, 0x00, 13);
+		mapper.cpu_write_at(0xE000, 0x00, 15);
+		mapper.cpu_write_at(0xE000, 0x00, 17);
+		mapper.cpu_write_at(0xE000, 0x00, 19); // 5th accepted write loads bank 1
 
-		// Only the first write should have taken effect
-		// We need to complete the 5-write sequence to verify
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
-		mapper.cpu_write(0xE000, 0x00);
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
-		mapper.cpu_write(0xE000, 0x00);
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
-		mapper.cpu_write(0xE000, 0x00);
-		mapper.notify_cpu_cycle();
-		mapper.notify_cpu_cycle();
-		mapper.cpu_write(0xE000, 0x00); // 5th write (if filter worked, this is #4 of good writes + bit7 confusion)
+		// Had the cycle-11 write shifted in, the bank would be 3
+		REQUIRE(mapper.cpu_read(0x8000) == 1);
+	}
+
+	SECTION("Writes a cycle apart are kept") {
+		for (uint64_t cycle : {100u, 102u, 104u, 106u, 110u}) {
+			mapper.cpu_write_at(0xE000, 0x01, cycle);
+		}
+		REQUIRE(mapper.cpu_read(0x8000) == 7); // $1F loaded; bank 15 of 8 wraps to 7
+	}
 
-		// The point is: if the filter works, only one bit was shifted from that first
-		// write cycle, not two. Exact bank depends on implementation details.
-		// Just verifying it doesn't crash and produces a consistent result.
-		auto val = mapper.cpu_read(0x8000);
-		(void)val; // Just ensure no crash
+	SECTION("Reset forgets the last write") {
+		mapper.cpu_write_at(0xE000, 0x80, 50);
+		mapper.reset();
+		for (uint64_t cycle = 51; cycle < 60; cycle += 2) {
+			mapper.cpu_write_at(0xE000, cycle == 51 ? 0x01 : 0x00, cycle);
+		}
+		REQUIRE(mapper.cpu_read(0x8000) == 1);
 	}
 }
 
@@ -295,6 +271,50 @@ TEST_CASE("Mapper 1 (MMC1) - PRG RAM", "[mapper][mapper1]") {
 	}
 }
 
+TEST_CASE("Mapper 1 (MMC1) - Battery RAM dirty pages", "[mapper][mapper1][battery]") {
+	auto prg = make_prg_with_bank_ids(8);
+	auto chr = make_rom(32768);
+	Mapper001 mapper(prg, chr, Mapper::Mirroring::Vertical, true, false, true);
+	REQUIRE(mapper.has_battery_ram());
+	REQUIRE_FALSE(mapper.is_battery_ram_dirty());
+
+	// Pages 0, 1 and 4: the first two merge into one range
+	mapper.cpu_write(0x6000, 0x11);
+	mapper.cpu_write(0x6150, 0x22);
+	mapper.cpu_write(0x64FF, 0x33);
+	REQUIRE(mapper.is_battery_ram_dirty());
+	const auto ranges = mapper.battery_ram_dirty_ranges();
+	REQUIRE(ranges.size() == 2);
+	REQUIRE(ranges[0].offset == 0);
+	REQUIRE(ranges[0].size == 512);
+	REQUIRE(ranges[1].offset == 1024);
+	REQUIRE(ranges[1].size == 256);
+
+	mapper.clear_battery_ram_dirty();
+	REQUIRE_FALSE(mapper.is_battery_ram_dirty());
+	REQUIRE(mapper.battery_ram_dirty_ranges().empty());
+
+	// Activity marks see rewrites of a page that is already dirty
+	Mapper::RamPageMark mark;
+	REQUIRE(mapper.battery_ram_written_since(mark)); // Never taken
+	REQUIRE_FALSE(mapper.battery_ram_written_since(mark));
+	mapper.cpu_write(0x6000, 0x44);
+	REQUIRE(mapper.battery_ram_written_since(mark));
+	mapper.cpu_write(0x6000, 0x55);
+	REQUIRE(mapper.battery_ram_written_since(mark));
+	REQUIRE_FALSE(mapper.battery_ram_written_since(mark));
+	REQUIRE(mapper.battery_ram_dirty_ranges().size() == 1);
+
+	// Loading the .sav leaves nothing to write back
+	mapper.load_battery_ram(std::vector<Byte>(8192, 0x99));
+	REQUIRE_FALSE(mapper.is_battery_ram_dirty());
+
+	// Without the battery flag there is nothing to persist
+	Mapper001 plain(prg, chr, Mapper::Mirroring::Vertical, true);
+	plain.cpu_write(0x6000, 0x11);
+	REQUIRE_FALSE(plain.is_battery_ram_dirty());
+}
+
 TEST_CASE("Mapper 1 (MMC1) - Mirroring Control", "[mapper][mapper1]") {
 	auto prg = make_prg_with_bank_ids(8);
 	auto chr = make_rom(32768);
@@ -325,7 +345,9 @@ TEST_CASE("Mapper 1 (MMC1) - Serialization", "[mapper][mapper1][serialization]")
 		REQUIRE(buffer.size() > 0);
 
 		// Create new mapper and restore
-		Mapper001 mapper2(make_prg_with_bank_ids(8), make_rom(32768), Mapper::Mirroring::Vertical, true);
+		const auto prg2 = make_prg_with_bank_ids(8);
+		const auto chr2 = make_rom(32768);
+		Mapper001 mapper2(prg2, chr2, Mapper::Mirroring::Vertical, true);
 		size_t offset = 0;
 		mapper2.deserialize_state(buffer, offset);
 
@@ -424,7 +446,8 @@ TEST_CASE("Mapper 2 (UxROM) - Serialization", "[mapper][mapper2][serialization]"
 		mapper.serialize_state(buffer);
 		REQUIRE(buffer.size() > 0);
 
-		Mapper002 mapper2(make_prg_with_bank_ids(8), make_rom(8192), Mapper::Mirroring::Vertical);
+		const auto prg2 = make_prg_with_bank_ids(8);
+		Mapper002 mapper2(prg2, make_rom(8192), Mapper::Mirroring::Vertical);
 		size_t offset = 0;
 		mapper2.deserialize_state(buffer, offset);
 
@@ -514,7 +537,9 @@ TEST_CASE("Mapper 3 (CNROM) - Serialization", "[mapper][mapper3][serialization]"
 	std::vector<uint8_t> buffer;
 	mapper.serialize_state(buffer);
 
-	Mapper003 mapper2(make_rom(32768, 0xFF), make_chr_with_bank_ids(4), Mapper::Mirroring::Horizontal);
+	const auto prg2 = make_rom(32768, 0xFF);
+	const auto chr2 = make_chr_with_bank_ids(4);
+	Mapper003 mapper2(prg2, chr2, Mapper::Mirroring::Horizontal);
 	size_t offset = 0;
 	mapper2.deserialize_state(buffer, offset);
 
@@ -642,7 +667,9 @@ TEST_CASE("Mapper 4 (MMC3) - Serialization", "[mapper][mapper4][serialization]")
 		mapper.serialize_state(buffer);
 		REQUIRE(buffer.size() > 0);
 
-		Mapper004 mapper2(make_rom(262144), make_rom(262144), Mapper::Mirroring::Vertical, true);
+		const auto prg2 = make_rom(262144);
+		const auto chr2 = make_rom(262144);
+		Mapper004 mapper2(prg2, chr2, Mapper::Mirroring::Vertical, true);
 		size_t offset = 0;
 		mapper2.deserialize_state(buffer, offset);
 
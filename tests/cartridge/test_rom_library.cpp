@@ -0,0 +1,198 @@
+// VibeNES - NES Emulator
+// ROM Library Tests
+// Directory scans, incremental rescans, the on-disk index and search
+
+#include "../../include/cartridge/rom_library.hpp"
+#include "../../include/core/checksum.hpp"
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// iNES file with one 16KB PRG page filled with fill and one 8KB CHR page
+std::vector<std::uint8_t> build_rom(std::uint8_t fill, std::uint8_t mapper = 0, std::uint8_t flags6 = 0x00) {
+	std::vector<std::uint8_t> data = {'N', 'E', 'S', 0x1A, 1, 1, static_cast<std::uint8_t>(flags6 | (mapper << 4)),
+									  static_cast<std::uint8_t>(mapper & 0xF0)};
+	data.resize(16, 0x00);
+	data.resize(16 + 16384, fill);
+	data.resize(16 + 16384 + 8192, static_cast<std::uint8_t>(fill ^ 0xFF));
+	return data;
+}
+
+void write_file(const std::filesystem::path &path, const std::vector<std::uint8_t> &data) {
+	std::filesystem::create_directories(path.parent_path());
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+struct TempLibrary {
+	std::filesystem::path root;
+	std::filesystem::path index;
+
+	explicit TempLibrary(const char *name)
+		: root(std::filesystem::temp_directory_path() / name), index(root.string() + ".vnidx") {
+		std::filesystem::remove_all(root);
+		std::filesystem::remove(index);
+		write_file(root / "Super Game.nes", build_rom(0x11, 1, 0x02));
+		write_file(root / "sub" / "Other Game.NES", build_rom(0x22, 4, 0x01));
+		write_file(root / "readme.txt", {'h', 'i'});
+		write_file(root / "broken.nes", {'N', 'E', 'S', 0x1A, 2});
+	}
+	~TempLibrary() {
+		std::filesystem::remove_all(root);
+		std::filesystem::remove(index);
+	}
+};
+
+} // namespace
+
+TEST_CASE("RomLibrary - Scan reads headers and hashes", "[cartridge][rom-library]") {
+	TempLibrary temp("vibenes_library_scan");
+	RomLibrary library(temp.root, temp.index);
+
+	const RomLibrary::ScanStats stats = library.scan();
+	REQUIRE(stats.files == 3);
+	REQUIRE(stats.hashed == 3);
+	REQUIRE(stats.removed == 0);
+
+	const auto entries = library.entries();
+	REQUIRE(entries.size() == 3);
+	REQUIRE(entries[0].path == "Super Game.nes");
+	REQUIRE(entries[1].path == "broken.nes");
+	REQUIRE(entries[2].path == "sub/Other Game.NES");
+
+	REQUIRE(entries[0].valid);
+	REQUIRE(entries[0].mapper_id == 1);
+	REQUIRE(entries[0].battery_backed_ram);
+	REQUIRE_FALSE(entries[0].vertical_mirroring);
+	REQUIRE(entries[0].prg_rom_pages == 1);
+	REQUIRE(entries[0].chr_rom_pages == 1);
+	REQUIRE(entries[2].mapper_id == 4);
+	REQUIRE(entries[2].vertical_mirroring);
+	REQUIRE_FALSE(entries[1].valid);
+
+	// Hashes cover PRG+CHR only, not the header
+	const std::vector<std::uint8_t> rom = build_rom(0x11, 1, 0x02);
+	Sha1 sha1;
+	sha1.update(rom.data() + 16, rom.size() - 16);
+	REQUIRE(entries[0].crc32 == crc32(rom.data() + 16, rom.size() - 16));
+	REQUIRE(entries[0].sha1 == sha1.finish());
+	REQUIRE(entries[0].size == rom.size());
+}
+
+TEST_CASE("RomLibrary - Rescans only hash what changed", "[cartridge][rom-library]") {
+	TempLibrary temp("vibenes_library_rescan");
+	RomLibrary library(temp.root, temp.index);
+	library.scan();
+	const std::uint64_t generation = library.get_generation();
+
+	SECTION("Nothing changed") {
+		const RomLibrary::ScanStats stats = library.scan();
+		REQUIRE(stats.files == 3);
+		REQUIRE(stats.hashed == 0);
+		REQUIRE(library.get_generation() == generation);
+	}
+
+	SECTION("A file is rewritten, one added, one deleted") {
+		const auto path = temp.root / "Super Game.nes";
+		const auto mtime = std::filesystem::last_write_time(path);
+		write_file(path, build_rom(0x33, 2));
+		std::filesystem::last_write_time(path, mtime + std::chrono::hours(1));
+		write_file(temp.root / "New Game.nes", build_rom(0x44));
+		std::filesystem::remove(temp.root / "broken.nes");
+
+		const RomLibrary::ScanStats stats = library.scan();
+		REQUIRE(stats.files == 3);
+		REQUIRE(stats.hashed == 2);
+		REQUIRE(stats.removed == 1);
+		REQUIRE(library.get_generation() != generation);
+
+		const auto entries = library.search("game");
+		REQUIRE(entries.size() == 3);
+		REQUIRE(entries[0].path == "New Game.nes");
+		REQUIRE(entries[1].path == "Super Game.nes");
+		REQUIRE(entries[1].mapper_id == 2);
+	}
+
+	SECTION("Background scan") {
+		write_file(temp.root / "New Game.nes", build_rom(0x44));
+		library.start_scan();
+		library.wait_for_scan();
+		REQUIRE_FALSE(library.is_scanning());
+		REQUIRE(library.get_last_scan_stats().hashed == 1);
+		REQUIRE(library.size() == 4);
+	}
+
+	SECTION("A missing root keeps the index") {
+		std::filesystem::remove_all(temp.root);
+		REQUIRE(library.scan().files == 0);
+		REQUIRE(library.size() == 3);
+	}
+}
+
+TEST_CASE("RomLibrary - Index round trip", "[cartridge][rom-library]") {
+	TempLibrary temp("vibenes_library_index");
+	std::vector<RomLibrary::Entry> scanned;
+	{
+		RomLibrary library(temp.root, temp.index);
+		REQUIRE_FALSE(library.load_index());
+		library.scan(); // Saves the index, since it hashed files
+		scanned = library.entries();
+	}
+	REQUIRE(std::filesystem::exists(temp.index));
+
+	RomLibrary library(temp.root, temp.index);
+	REQUIRE(library.load_index());
+	const auto loaded = library.entries();
+	REQUIRE(loaded.size() == scanned.size());
+	for (std::size_t i = 0; i < loaded.size(); ++i) {
+		REQUIRE(loaded[i].path == scanned[i].path);
+		REQUIRE(loaded[i].size == scanned[i].size);
+		REQUIRE(loaded[i].mtime == scanned[i].mtime);
+		REQUIRE(loaded[i].valid == scanned[i].valid);
+		REQUIRE(loaded[i].mapper_id == scanned[i].mapper_id);
+		REQUIRE(loaded[i].vertical_mirroring == scanned[i].vertical_mirroring);
+		REQUIRE(loaded[i].battery_backed_ram == scanned[i].battery_backed_ram);
+		REQUIRE(loaded[i].crc32 == scanned[i].crc32);
+		REQUIRE(loaded[i].sha1 == scanned[i].sha1);
+	}
+
+	// Everything on disk matches the loaded index, so nothing is reopened
+	REQUIRE(library.scan().hashed == 0);
+
+	// A damaged index is refused and leaves the entries alone
+	{
+		std::ofstream file(temp.index, std::ios::binary | std::ios::trunc);
+		file << "VNROMIDX";
+	}
+	REQUIRE_FALSE(library.load_index());
+	REQUIRE(library.size() == loaded.size());
+}
+
+TEST_CASE("RomLibrary - Search", "[cartridge][rom-library]") {
+	TempLibrary temp("vibenes_library_search");
+	RomLibrary library(temp.root, temp.index);
+	library.scan();
+
+	REQUIRE(library.search("").size() == 3);
+	REQUIRE(library.search("SUPER").size() == 1);
+	REQUIRE(library.search("sub/").size() == 1);
+	REQUIRE(library.search("game", 1).size() == 1);
+	REQUIRE(library.search("zelda").empty());
+
+	// By CRC-32, as 8 hex digits in either case
+	const auto other = library.search("other");
+	REQUIRE(other.size() == 1);
+	char crc[9];
+	std::snprintf(crc, sizeof(crc), "%08X", other[0].crc32);
+	const auto by_crc = library.search(crc);
+	REQUIRE(by_crc.size() == 1);
+	REQUIRE(by_crc[0].path == other[0].path);
+}
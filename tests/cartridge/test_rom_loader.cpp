@@ -3,10 +3,16 @@
 // Tests for iNES header parsing, validation, and cartridge creation
 
 #include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_image.hpp"
 #include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/cartridge/rom_preloader.hpp"
+#include "../../include/core/checksum.hpp"
 #include "../../include/core/types.hpp"
 #include <catch2/catch_all.hpp>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
 #include <vector>
 
 using namespace nes;
@@ -53,6 +59,13 @@ static std::vector<uint8_t> build_ines_rom(uint8_t prg_pages, uint8_t chr_pages,
 	return data;
 }
 
+static std::filesystem::path write_rom_file(const char *name, const std::vector<uint8_t> &data) {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+	return path;
+}
+
 // =============================================================================
 // iNES Header Validation
 // =============================================================================
@@ -186,6 +199,71 @@ TEST_CASE("Cartridge Construction from ROM Data", "[cartridge]") {
 	}
 }
 
+TEST_CASE("Cartridge - NES 2.0 RAM sizing", "[cartridge][rom-loader]") {
+	auto make_rom = [](std::uint16_t mapper_id, std::uint32_t prg_ram, std::uint32_t prg_nvram) {
+		RomData rom{};
+		rom.mapper_id = mapper_id;
+		rom.prg_rom_pages = 8;
+		rom.chr_rom_pages = 0;
+		rom.valid = true;
+		rom.nes2_0 = true;
+		rom.battery_backed_ram = prg_nvram > 0;
+		rom.prg_ram_size = prg_ram;
+		rom.prg_nvram_size = prg_nvram;
+		rom.chr_ram_size = 8192;
+		rom.prg_rom.assign(8 * 16384, 0x00);
+		return rom;
+	};
+	Cartridge cartridge;
+
+	SECTION("iNES 1 carts keep the board's usual 8KB") {
+		auto rom = make_rom(1, 0, 0);
+		rom.nes2_0 = false;
+		rom.battery_backed_ram = true;
+		REQUIRE(cartridge.load_from_rom_data(rom));
+		REQUIRE(cartridge.get_battery_ram().size() == 8192);
+	}
+
+	SECTION("No PRG-RAM leaves $6000-$7FFF open") {
+		REQUIRE(cartridge.load_from_rom_data(make_rom(4, 0, 0)));
+		cartridge.cpu_write(0x6000, 0x42);
+		REQUIRE(cartridge.cpu_read(0x6000) == 0xFF);
+	}
+
+	SECTION("Small PRG-RAM mirrors across the window") {
+		REQUIRE(cartridge.load_from_rom_data(make_rom(4, 0, 1024))); // MMC6-sized, battery-backed
+		REQUIRE(cartridge.get_battery_ram().size() == 1024);
+		cartridge.cpu_write(0x6005, 0x42);
+		REQUIRE(cartridge.cpu_read(0x6405) == 0x42);
+		REQUIRE(cartridge.cpu_read(0x7C05) == 0x42);
+	}
+
+	SECTION("SXROM banks 32KB of PRG-RAM through CHR bank 0") {
+		REQUIRE(cartridge.load_from_rom_data(make_rom(1, 0, 32768)));
+		REQUIRE(cartridge.get_battery_ram().size() == 32768);
+		auto write_chr_bank_0 = [&](Byte value) {
+			for (int bit = 0; bit < 5; ++bit) {
+				cartridge.cpu_write(0xA000, static_cast<Byte>((value >> bit) & 0x01));
+			}
+		};
+		for (Byte bank = 0; bank < 4; ++bank) {
+			write_chr_bank_0(static_cast<Byte>(bank << 2));
+			cartridge.cpu_write(0x6000, static_cast<Byte>(0xA0 + bank));
+		}
+		const auto ram = cartridge.get_battery_ram();
+		for (std::size_t bank = 0; bank < 4; ++bank) {
+			REQUIRE(ram[bank * 8192] == 0xA0 + bank);
+		}
+		write_chr_bank_0(0x04);
+		REQUIRE(cartridge.cpu_read(0x6000) == 0xA1);
+	}
+
+	SECTION("MMC5 sizes its banked PRG-RAM to the header") {
+		REQUIRE(cartridge.load_from_rom_data(make_rom(5, 8192, 8192)));
+		REQUIRE(cartridge.get_battery_ram().size() == 16384);
+	}
+}
+
 // =============================================================================
 // Edge Cases
 // =============================================================================
@@ -218,3 +296,248 @@ TEST_CASE("ROM Loader - Edge Cases", "[cartridge][rom-loader][edge-cases]") {
 		REQUIRE(tiny.size() < 16);
 	}
 }
+
+// =============================================================================
+// Shared ROM Images
+// =============================================================================
+
+TEST_CASE("ROM Image - One image shared by many cartridges", "[cartridge][rom-image]") {
+	const auto rom = build_ines_rom(2, 1, 0x04, 0x00, true); // NROM with a trainer
+	const auto path = write_rom_file("vibenes_test_rom_image.nes", rom);
+	std::shared_ptr<const RomImage> image = RomImage::load(path.string());
+	REQUIRE(image);
+	REQUIRE(image->header().prg_rom_pages == 2);
+	REQUIRE(image->header().prg_rom.empty()); // Bytes live in the image only
+	REQUIRE(image->trainer().size() == 512);
+	REQUIRE(image->prg_rom().size() == 32768);
+	REQUIRE(image->chr_rom().size() == 8192);
+	REQUIRE(image->prg_rom()[1] == 0x01);
+	REQUIRE(image->chr_rom()[0] == 0x80);
+
+	// Both cartridges read the same bytes in place
+	Cartridge a;
+	Cartridge b;
+	REQUIRE(a.load_rom_image(image));
+	REQUIRE(b.load_rom_image(image));
+	REQUIRE(a.prg_rom_data().data() == image->prg_rom().data());
+	REQUIRE(b.prg_rom_data().data() == image->prg_rom().data());
+	REQUIRE(a.get_rom_image() == image);
+	REQUIRE(a.get_rom_data().filename == path.string());
+
+	// PRG ROM's CRC is taken once, by the image
+	REQUIRE(image->prg_crc32() == crc32(image->prg_rom().data(), image->prg_rom().size()));
+	REQUIRE(a.get_prg_rom_crc32() == image->prg_crc32());
+	REQUIRE(RomImage::from_rom_data(RomLoader::load_rom(path.string()))->prg_crc32() == image->prg_crc32());
+
+	// The cartridges keep it alive, and it goes with the last of them
+	std::weak_ptr<const RomImage> weak = image;
+	image.reset();
+	REQUIRE(a.cpu_read(0x8001) == 0x01);
+	REQUIRE(b.ppu_read(0x0000) == 0x80);
+	a.unload_rom();
+	REQUIRE_FALSE(weak.expired());
+	REQUIRE(b.load_from_rom_data(RomLoader::load_rom(path.string())));
+	REQUIRE(weak.expired());
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("ROM Image - CHR RAM is per cartridge", "[cartridge][rom-image]") {
+	const auto path = write_rom_file("vibenes_test_rom_image_chr_ram.nes", build_ines_rom(2, 0, 0x20)); // UxROM
+	const auto image = RomImage::load(path.string());
+	std::filesystem::remove(path);
+	REQUIRE(image);
+	REQUIRE(image->chr_rom().empty());
+
+	Cartridge a;
+	Cartridge b;
+	REQUIRE(a.load_rom_image(image));
+	REQUIRE(b.load_rom_image(image));
+	a.ppu_write(0x0010, 0x5A);
+	REQUIRE(a.ppu_read(0x0010) == 0x5A);
+	REQUIRE(b.ppu_read(0x0010) == 0x00);
+}
+
+TEST_CASE("ROM Image - Rejects what is not a complete ROM", "[cartridge][rom-image]") {
+	REQUIRE_FALSE(RomImage::load((std::filesystem::temp_directory_path() / "vibenes_test_missing.nes").string()));
+
+	auto truncated = build_ines_rom(2, 1);
+	truncated.resize(truncated.size() - 1);
+	const auto path = write_rom_file("vibenes_test_rom_image_truncated.nes", truncated);
+	REQUIRE_FALSE(RomImage::load(path.string()));
+	REQUIRE_FALSE(RomLoader::load_rom(path.string()).valid);
+	std::filesystem::remove(path);
+
+	RomData invalid{};
+	invalid.valid = false;
+	REQUIRE_FALSE(RomImage::from_rom_data(invalid));
+}
+
+// =============================================================================
+// ROM Preloading
+// =============================================================================
+
+TEST_CASE("ROM Preloader - Hands over a prefetched ROM and its save", "[cartridge][rom-preloader]") {
+	const auto path = write_rom_file("vibenes_test_preload.nes", build_ines_rom(2, 1, 0x12)); // MMC1, battery
+	const auto save_path = write_rom_file("vibenes_test_preload.sav", {0x11, 0x22, 0x33});
+	RomPreloader preloader;
+
+	preloader.prefetch(path.string(), save_path);
+	REQUIRE(preloader.is_pending());
+	const PreloadedRom rom = preloader.take(path.string(), save_path);
+	REQUIRE_FALSE(preloader.is_pending());
+	REQUIRE(rom.path == path.string());
+	REQUIRE(rom.image);
+	REQUIRE(rom.image->prg_crc32() == crc32(rom.image->prg_rom().data(), rom.image->prg_rom().size()));
+	REQUIRE_FALSE(rom.resident);
+	REQUIRE(rom.save_read);
+	REQUIRE(rom.save == std::vector<Byte>{0x11, 0x22, 0x33});
+
+	Cartridge cartridge;
+	REQUIRE(cartridge.load_rom_image(rom.image));
+	REQUIRE(cartridge.cpu_read(0x8001) == 0x01);
+
+	// Not prefetched: loaded by take() itself. No save file is not an error
+	std::filesystem::remove(save_path);
+	const PreloadedRom again = preloader.take(path.string(), save_path);
+	REQUIRE(again.image);
+	REQUIRE(again.save_read);
+	REQUIRE_FALSE(again.save);
+	REQUIRE_FALSE(preloader.take(path.string()).save_read);
+
+	// A prefetch of another file is dropped for the one asked for
+	preloader.prefetch((std::filesystem::temp_directory_path() / "vibenes_test_preload_other.nes").string());
+	REQUIRE(preloader.take(path.string()).image);
+	REQUIRE_FALSE(preloader.is_pending());
+
+	std::filesystem::remove(path);
+	REQUIRE_FALSE(preloader.take((std::filesystem::temp_directory_path() / "vibenes_test_missing.nes").string()).image);
+}
+
+TEST_CASE("ROM Preloader - Keeps the last ROMs resident", "[cartridge][rom-preloader]") {
+	const auto first = write_rom_file("vibenes_test_resident_1.nes", build_ines_rom(1, 1));
+	const auto second = write_rom_file("vibenes_test_resident_2.nes", build_ines_rom(2, 1));
+	const auto third = write_rom_file("vibenes_test_resident_3.nes", build_ines_rom(2, 0));
+	RomPreloader preloader;
+
+	const PreloadedRom loaded = preloader.take(first.string());
+	preloader.prefetch(first.string());
+	const PreloadedRom relaunched = preloader.take(first.string());
+	REQUIRE(relaunched.resident);
+	REQUIRE(relaunched.image == loaded.image);
+
+	// A changed file is read again
+	write_rom_file("vibenes_test_resident_1.nes", build_ines_rom(2, 1));
+	const PreloadedRom changed = preloader.take(first.string());
+	REQUIRE_FALSE(changed.resident);
+	REQUIRE(changed.image->prg_rom().size() == 32768);
+
+	// Only the most recent ones stay
+	REQUIRE(preloader.resident_count() == 1);
+	(void)preloader.take(second.string());
+	(void)preloader.take(third.string());
+	REQUIRE(preloader.resident_count() == RomPreloader::DEFAULT_RESIDENT_LIMIT);
+	REQUIRE_FALSE(preloader.take(first.string()).resident);
+	REQUIRE(preloader.take(third.string()).resident);
+
+	preloader.set_resident_limit(0);
+	REQUIRE(preloader.resident_count() == 0);
+	(void)preloader.take(second.string());
+	REQUIRE_FALSE(preloader.take(second.string()).resident);
+
+	std::filesystem::remove(first);
+	std::filesystem::remove(second);
+	std::filesystem::remove(third);
+}
+
+// =============================================================================
+// In-place Header Parsing (iNES / NES 2.0)
+// =============================================================================
+
+TEST_CASE("ROM Loader - Parses images in place", "[cartridge][rom-loader]") {
+	RomData header{};
+	RomLoader::Layout layout;
+
+	SECTION("iNES sections follow the header and trainer") {
+		const auto rom = build_ines_rom(2, 1, 0x14 | 0x01, 0x00, true); // Mapper 1, trainer, vertical
+		REQUIRE(RomLoader::parse_image(rom, "test.nes", header, layout));
+		REQUIRE_FALSE(header.nes2_0);
+		REQUIRE(header.mapper_id == 1);
+		REQUIRE(header.vertical_mirroring);
+		REQUIRE(header.prg_rom.empty());
+		REQUIRE(layout.trainer_size == 512);
+		REQUIRE(layout.prg_offset == 16 + 512);
+		REQUIRE(layout.prg_size == 32768);
+		REQUIRE(layout.chr_offset == 16 + 512 + 32768);
+		REQUIRE(layout.chr_size == 8192);
+	}
+
+	SECTION("NES 2.0 extends the mapper number and page counts") {
+		auto rom = build_ines_rom(2, 1, 0x40, 0x08); // Mapper 4, NES 2.0 identifier
+		rom[8] = 0x30; // Submapper 3, mapper bits 8-11 = 0
+		rom[15] = 0x08; // Zapper
+		REQUIRE(RomLoader::parse_image(rom, "test.nes", header, layout));
+		REQUIRE(header.nes2_0);
+		REQUIRE(header.mapper_id == 4);
+		REQUIRE(header.submapper == 3);
+		REQUIRE(header.expansion_device == 0x08);
+
+		rom[8] = 0x01; // Mapper 260
+		rom[9] = 0x10; // CHR pages 0x101: more data than the file holds
+		REQUIRE_FALSE(RomLoader::parse_image(rom, "test.nes", header, layout));
+		REQUIRE(header.mapper_id == 0x104);
+		REQUIRE(header.chr_rom_pages == 0x101);
+
+		rom[9] = 0x0F; // Exponent-multiplier PRG size
+		REQUIRE_FALSE(RomLoader::parse_image(rom, "test.nes", header, layout));
+	}
+
+	SECTION("NES 2.0 RAM sizes, timing and console type") {
+		auto rom = build_ines_rom(2, 0, 0x12, 0x09); // Mapper 1, battery, Vs. System, NES 2.0
+		rom[10] = 0x97; // 8KB volatile + 32KB battery-backed PRG-RAM
+		rom[11] = 0x09; // 32KB CHR-RAM
+		rom[12] = 0x03; // Dendy
+		REQUIRE(RomLoader::parse_image(rom, "test.nes", header, layout));
+		REQUIRE(header.prg_ram_size == 8192);
+		REQUIRE(header.prg_nvram_size == 32768);
+		REQUIRE(header.chr_ram_size == 32768);
+		REQUIRE(header.chr_nvram_size == 0);
+		REQUIRE(header.timing == TimingRegion::Dendy);
+		REQUIRE(header.console_type == ConsoleType::VsSystem);
+
+		// iNES 1 leaves RAM sizes unset and says nothing about timing
+		rom[7] = 0x00;
+		REQUIRE(RomLoader::parse_image(rom, "test.nes", header, layout));
+		REQUIRE(header.prg_ram_size == 0);
+		REQUIRE(header.chr_ram_size == 0);
+		REQUIRE(header.timing == TimingRegion::Ntsc);
+		REQUIRE(header.console_type == ConsoleType::Nes);
+	}
+
+	SECTION("Junk in bytes 7-15 of an old iNES header is ignored") {
+		auto rom = build_ines_rom(2, 1, 0x20, 0x00);
+		const char junk[] = "DiskDude!";
+		std::copy(junk, junk + 9, rom.begin() + 7);
+		REQUIRE(RomLoader::parse_image(rom, "test.nes", header, layout));
+		REQUIRE(header.mapper_id == 2);
+	}
+
+	SECTION("Short or foreign images are rejected") {
+		const std::vector<uint8_t> tiny = {0x4E, 0x45, 0x53};
+		REQUIRE_FALSE(RomLoader::parse_image(tiny, "tiny.nes", header, layout));
+		auto rom = build_ines_rom(1, 1);
+		rom[3] = 0x00;
+		REQUIRE_FALSE(RomLoader::parse_image(rom, "bad.nes", header, layout));
+	}
+}
+
+TEST_CASE("ROM Loader - Reads just the header of a file", "[cartridge][rom-loader]") {
+	const auto path = write_rom_file("vibenes_test_rom_header.nes", build_ines_rom(4, 2, 0x30));
+	RomData header{};
+	REQUIRE(RomLoader::read_header(path.string(), header));
+	REQUIRE(header.mapper_id == 3);
+	REQUIRE(header.prg_rom_pages == 4);
+	REQUIRE(header.chr_rom_pages == 2);
+	REQUIRE(RomLoader::is_valid_nes_file(path.string()));
+	std::filesystem::remove(path);
+	REQUIRE_FALSE(RomLoader::read_header(path.string(), header));
+}
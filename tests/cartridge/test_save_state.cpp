@@ -2,11 +2,21 @@
 // Save State Tests
 // Tests for save state header validation, serialization roundtrips, and CRC verification
 
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/bus.hpp"
 #include "../../include/core/types.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/rewind_buffer.hpp"
 #include "../../include/system/save_state.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <algorithm>
+#include <array>
 #include <catch2/catch_all.hpp>
 #include <cstdint>
 #include <cstring>
+#include <filesystem>
 #include <vector>
 
 using namespace nes;
@@ -53,8 +63,8 @@ TEST_CASE("SaveState Constants", "[save-state]") {
 		REQUIRE(std::string(SAVE_STATE_MAGIC, 7) == "VIBENES");
 	}
 
-	SECTION("Version is 2") {
-		REQUIRE(SAVE_STATE_VERSION == 2);
+	SECTION("Version is 3") {
+		REQUIRE(SAVE_STATE_VERSION == 3);
 	}
 }
 
@@ -116,3 +126,442 @@ TEST_CASE("SaveState Slot Paths", "[save-state][slots]") {
 		}
 	}
 }
+
+// =============================================================================
+// In-Memory Snapshots
+// =============================================================================
+
+namespace {
+
+// MMC1 with PRG RAM: counts frames into RAM, PRG RAM and the backdrop color
+RomData make_counter_rom() {
+	const std::array<uint8_t, 41> program = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xE6, 0x10,		  //       INC $10
+		0xA5, 0x10,		  //       LDA $10
+		0x8D, 0x00, 0x60, //       STA $6000
+		0xA9, 0x3F,		  //       LDA #$3F
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA5, 0x10,		  //       LDA $10
+		0x29, 0x3F,		  //       AND #$3F
+		0x8D, 0x07, 0x20, //       STA $2007
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0x8D, 0x06, 0x20, //       STA $2006
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	// In the last bank, which MMC1 fixes at $C000; CHR RAM
+	RomData rom = test::make_nrom(program, {.reset = 0xC000}, {});
+	rom.mapper_id = 1;
+	return rom;
+}
+
+struct SnapshotSystem {
+	HeadlessSystem system;
+	SaveStateManager states{&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge()};
+
+	SnapshotSystem() {
+		REQUIRE(system.load_rom_data(make_counter_rom()));
+	}
+	void run_frames(int frames) {
+		for (int i = 0; i < frames; ++i) {
+			system.run_frame();
+		}
+	}
+	// Save-state bytes without the header (its timestamp differs)
+	std::vector<uint8_t> state() {
+		std::vector<uint8_t> bytes = states.serialize_state();
+		bytes.erase(bytes.begin(), bytes.begin() + sizeof(SaveStateHeader));
+		return bytes;
+	}
+};
+
+} // namespace
+
+TEST_CASE("SaveState Snapshots", "[save-state][snapshot]") {
+	SnapshotSystem nes;
+	nes.run_frames(5);
+
+	SECTION("Restoring goes back exactly") {
+		StateSnapshot snapshot;
+		nes.states.capture(snapshot);
+		nes.run_frames(7);
+		const std::vector<uint8_t> expected = nes.state();
+		REQUIRE(nes.states.restore(snapshot));
+		nes.run_frames(7);
+		REQUIRE(nes.state() == expected);
+	}
+
+	SECTION("Sections tile the snapshot at fixed offsets") {
+		StateSnapshot snapshot;
+		nes.states.capture(snapshot);
+		REQUIRE(snapshot.size() == nes.states.snapshot_size());
+		REQUIRE(snapshot.section_offset(StateSnapshot::Section::Cpu) == 0);
+		size_t end = 0;
+		for (size_t i = 0; i < StateSnapshot::SECTION_COUNT; ++i) {
+			const auto section = static_cast<StateSnapshot::Section>(i);
+			REQUIRE(snapshot.section_offset(section) == end);
+			end += snapshot.section_size(section);
+		}
+		REQUIRE(end == snapshot.size());
+		// Same state as a save state carries
+		const std::vector<uint8_t> save = nes.states.serialize_state();
+		nes.run_frames(3);
+		REQUIRE(nes.states.deserialize_state(save));
+		StateSnapshot loaded;
+		nes.states.capture(loaded);
+		REQUIRE(std::equal(loaded.data(), loaded.data() + loaded.size(), snapshot.data(),
+						   snapshot.data() + snapshot.size()));
+	}
+
+	SECTION("Captures reuse the buffer") {
+		StateSnapshot snapshot;
+		snapshot.reserve(nes.states.snapshot_size());
+		nes.states.capture(snapshot);
+		const uint8_t *storage = snapshot.data();
+		const size_t ppu_offset = snapshot.section_offset(StateSnapshot::Section::Ppu);
+		for (int i = 0; i < 10; ++i) {
+			nes.run_frames(1);
+			nes.states.capture(snapshot);
+			REQUIRE(snapshot.data() == storage);
+			REQUIRE(snapshot.section_offset(StateSnapshot::Section::Ppu) == ppu_offset);
+		}
+
+		std::vector<uint8_t> buffer;
+		nes.states.serialize_state(buffer);
+		const uint8_t *file_storage = buffer.data();
+		nes.run_frames(1);
+		nes.states.serialize_state(buffer);
+		REQUIRE(buffer.data() == file_storage);
+		REQUIRE(nes.states.deserialize_state(buffer));
+	}
+
+	SECTION("Captures into used snapshots copy only written RAM pages, and stay exact") {
+		// A ring of snapshots recaptured every third frame, with writes to a
+		// different PRG-RAM and CHR-RAM page each frame
+		std::array<StateSnapshot, 3> ring;
+		std::array<std::vector<uint8_t>, 3> expected;
+		for (int frame = 0; frame < 12; ++frame) {
+			const auto value = static_cast<uint8_t>(0x40 + frame);
+			nes.system.bus().write(static_cast<uint16_t>(0x6001 + 0x100 * (frame * 5 % 32)), value);
+			nes.system.cartridge().ppu_write(static_cast<uint16_t>(0x100 * (frame * 3 % 32)), value);
+			nes.run_frames(1);
+			const size_t slot = static_cast<size_t>(frame) % ring.size();
+			nes.states.capture(ring[slot]);
+			expected[slot] = nes.state();
+		}
+		for (const size_t slot : {1, 0, 2, 0}) {
+			REQUIRE(nes.states.restore(ring[slot]));
+			REQUIRE(nes.state() == expected[slot]);
+			nes.system.bus().write(0x7F00, 0xAA); // Diverge before the next one
+			nes.run_frames(1);
+		}
+
+		StateSnapshot fresh;
+		nes.states.capture(fresh);
+		nes.states.capture(ring[1]);
+		REQUIRE(std::equal(ring[1].data(), ring[1].data() + ring[1].size(), fresh.data(), fresh.data() + fresh.size()));
+	}
+
+	SECTION("Snapshots of another ROM or none are rejected") {
+		StateSnapshot empty;
+		REQUIRE_FALSE(nes.states.restore(empty));
+
+		StateSnapshot snapshot;
+		nes.states.capture(snapshot);
+		REQUIRE(nes.system.load_rom_data(make_counter_rom())); // Same ROM, new session
+		REQUIRE_FALSE(nes.states.restore(snapshot));
+	}
+}
+
+TEST_CASE("SaveState Sectioned File Format", "[save-state][sections]") {
+	SnapshotSystem nes;
+	nes.run_frames(5);
+	StateSnapshot snapshot;
+	nes.states.capture(snapshot);
+	const std::vector<uint8_t> expected = nes.state();
+
+	SECTION("One chunk per component, compressed") {
+		const std::vector<uint8_t> save = nes.states.serialize_state();
+		SaveStateHeader header;
+		std::memcpy(&header, save.data(), sizeof(header));
+		REQUIRE(header.data_size == save.size() - sizeof(header));
+
+		const char *tags[] = {"CPU ", "PPU ", "APU ", "BUS ", "CART"};
+		size_t offset = sizeof(header);
+		for (size_t i = 0; i < StateSnapshot::SECTION_COUNT; ++i) {
+			SaveStateChunk chunk;
+			std::memcpy(&chunk, save.data() + offset, sizeof(chunk));
+			REQUIRE(std::memcmp(chunk.tag, tags[i], 4) == 0);
+			REQUIRE(chunk.size == snapshot.section_size(static_cast<StateSnapshot::Section>(i)));
+			REQUIRE(chunk.stored_size <= chunk.size);
+			offset += sizeof(chunk) + chunk.stored_size;
+		}
+		REQUIRE(offset == save.size());
+		// Mostly zeroed RAM: far smaller than the raw state
+		REQUIRE(save.size() < snapshot.size() / 2);
+
+		// Uncompressed states load the same
+		nes.states.set_compression(false);
+		const std::vector<uint8_t> raw = nes.states.serialize_state();
+		REQUIRE(raw.size() == sizeof(header) + StateSnapshot::SECTION_COUNT * sizeof(SaveStateChunk) + snapshot.size());
+		nes.states.set_compression(true);
+		nes.run_frames(2);
+		REQUIRE(nes.states.deserialize_state(raw));
+		REQUIRE(nes.state() == expected);
+	}
+
+	SECTION("Version 2 states still load") {
+		SaveStateHeader header;
+		header.version = 2;
+		header.crc32 = nes.states.calculate_rom_crc32();
+		header.data_size = static_cast<uint32_t>(snapshot.size());
+		std::vector<uint8_t> old(sizeof(header));
+		std::memcpy(old.data(), &header, sizeof(header));
+		old.insert(old.end(), snapshot.data(), snapshot.data() + snapshot.size());
+
+		nes.run_frames(3);
+		REQUIRE(nes.states.deserialize_state(old));
+		REQUIRE(nes.state() == expected);
+		REQUIRE_FALSE(nes.states.deserialize_state(old, SaveStateManager::section_bit(StateSnapshot::Section::Bus)));
+	}
+
+	SECTION("Restoring some sections leaves the rest alone") {
+		const std::vector<uint8_t> save = nes.states.serialize_state();
+		nes.run_frames(3);
+		StateSnapshot later;
+		nes.states.capture(later);
+
+		REQUIRE(nes.states.deserialize_state(save, SaveStateManager::section_bit(StateSnapshot::Section::Bus)));
+		StateSnapshot mixed;
+		nes.states.capture(mixed);
+		for (size_t i = 0; i < StateSnapshot::SECTION_COUNT; ++i) {
+			const auto section = static_cast<StateSnapshot::Section>(i);
+			const StateSnapshot &source = section == StateSnapshot::Section::Bus ? snapshot : later;
+			REQUIRE(std::equal(mixed.data() + mixed.section_offset(section),
+							   mixed.data() + mixed.section_offset(section) + mixed.section_size(section),
+							   source.data() + source.section_offset(section)));
+		}
+	}
+
+	SECTION("Unknown chunks are skipped, damaged ones refused") {
+		std::vector<uint8_t> save = nes.states.serialize_state();
+		SaveStateChunk extra{};
+		std::memcpy(extra.tag, "NEW!", 4);
+		extra.size = extra.stored_size = 3;
+		const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&extra);
+		save.insert(save.begin() + sizeof(SaveStateHeader), bytes, bytes + sizeof(extra));
+		save.insert(save.begin() + sizeof(SaveStateHeader) + sizeof(extra), {1, 2, 3});
+		nes.run_frames(3);
+		REQUIRE(nes.states.deserialize_state(save));
+		REQUIRE(nes.state() == expected);
+
+		nes.run_frames(3);
+		const std::vector<uint8_t> before = nes.state();
+		std::vector<uint8_t> damaged = nes.states.serialize_state();
+		damaged.resize(damaged.size() - 10);
+		REQUIRE_FALSE(nes.states.deserialize_state(damaged));
+		REQUIRE(nes.state() == before);
+	}
+
+	SECTION("Chunk sizes no block could decode to are refused before allocating") {
+		const std::vector<uint8_t> save = nes.states.serialize_state();
+		nes.run_frames(3);
+		const std::vector<uint8_t> before = nes.state();
+
+		// The header and one chunk
+		const auto with_chunk = [&](uint32_t size, uint32_t stored_size, uint32_t flags) {
+			std::vector<uint8_t> file(save.begin(), save.begin() + sizeof(SaveStateHeader));
+			SaveStateChunk chunk{};
+			std::memcpy(chunk.tag, "CPU ", 4);
+			chunk.flags = flags;
+			chunk.size = size;
+			chunk.stored_size = stored_size;
+			file.resize(file.size() + sizeof(chunk) + stored_size);
+			std::memcpy(file.data() + sizeof(SaveStateHeader), &chunk, sizeof(chunk));
+			return file;
+		};
+		REQUIRE_FALSE(nes.states.deserialize_state(with_chunk(0xFFFFFFFFu, 0, SAVE_CHUNK_LZ4)));
+		REQUIRE_FALSE(nes.states.deserialize_state(with_chunk(1u << 20, 8, SAVE_CHUNK_LZ4)));
+		REQUIRE_FALSE(nes.states.deserialize_state(with_chunk(SAVE_CHUNK_MAX_SIZE + 1, 1u << 20, SAVE_CHUNK_LZ4)));
+		REQUIRE_FALSE(nes.states.deserialize_state(with_chunk(0xFFFFFFFFu, 8, 0)));
+
+		// A chunk header cut short
+		std::vector<uint8_t> truncated = with_chunk(16, 16, 0);
+		truncated.resize(sizeof(SaveStateHeader) + sizeof(SaveStateChunk) / 2);
+		REQUIRE_FALSE(nes.states.deserialize_state(truncated));
+		REQUIRE(nes.state() == before);
+
+		REQUIRE_FALSE(save_chunk_size_plausible(1000, 3, true));
+		REQUIRE(save_chunk_size_plausible(1000, 4, true));
+		REQUIRE(save_chunk_size_plausible(1000, 1000, false));
+		REQUIRE_FALSE(save_chunk_size_plausible(1000, 999, false));
+	}
+}
+
+TEST_CASE("SaveState Asynchronous Saves", "[save-state][async]") {
+	SnapshotSystem nes;
+	const auto dir = std::filesystem::temp_directory_path() / "vibenes_async_save";
+	std::filesystem::remove_all(dir);
+	nes.states.set_save_directory(dir);
+	nes.run_frames(5);
+	const std::vector<uint8_t> expected = nes.state();
+
+	AsyncFileWriter writer;
+	auto saved = nes.states.save_to_slot_async(3, writer);
+	nes.run_frames(5); // Emulation goes on while the file is written
+	REQUIRE(saved.get().ok);
+	REQUIRE(nes.states.slot_exists(3));
+	REQUIRE(nes.states.load_from_slot(3));
+	REQUIRE(nes.state() == expected);
+
+	REQUIRE(nes.states.quick_save_async(writer).get().ok);
+	REQUIRE(nes.states.quick_load());
+
+	const FileWriteResult bad_slot = nes.states.save_to_slot_async(10, writer).get();
+	REQUIRE_FALSE(bad_slot.ok);
+	REQUIRE(bad_slot.error == nes.states.get_last_error());
+	std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("SaveState Slot Thumbnails and Cache", "[save-state][slots]") {
+	SnapshotSystem nes;
+	const auto dir = std::filesystem::temp_directory_path() / "vibenes_slot_cache";
+	std::filesystem::remove_all(dir);
+	nes.states.set_save_directory(dir);
+	REQUIRE_FALSE(nes.states.slot_exists(2));
+	REQUIRE_FALSE(nes.states.get_slot_info(SaveStateManager::QUICK_SAVE_SLOT).exists);
+
+	nes.run_frames(5);
+	// The thumbnail's first pixel: the top-left 4x4 block averaged per channel
+	const uint32_t *frame = nes.system.ppu().get_frame_buffer();
+	uint32_t corner = 0;
+	for (int c = 0; c < 32; c += 8) {
+		uint32_t sum = 0;
+		for (int i = 0; i < 16; ++i) {
+			sum += (frame[(i / 4) * 256 + i % 4] >> c) & 0xFF;
+		}
+		corner |= (sum / 16) << c;
+	}
+	const std::vector<uint8_t> expected = nes.state();
+	REQUIRE(nes.states.save_to_slot(2));
+
+	SECTION("Saves carry a thumbnail of the frame") {
+		const SaveSlotInfo &info = nes.states.get_slot_info(2);
+		REQUIRE(info.exists);
+		REQUIRE(info.timestamp.has_value());
+		REQUIRE(info.thumbnail.size() == SAVE_THUMBNAIL_WIDTH * SAVE_THUMBNAIL_HEIGHT);
+		REQUIRE(info.thumbnail[0] == corner);
+
+		const SaveSlotInfo on_disk = SaveStateManager::read_slot_info(nes.states.get_slot_path(2));
+		REQUIRE(on_disk.exists);
+		REQUIRE(on_disk.timestamp == info.timestamp);
+		REQUIRE(on_disk.thumbnail == info.thumbnail);
+
+		// The thumbnail chunk is skipped on load
+		nes.run_frames(3);
+		REQUIRE(nes.states.load_from_slot(2));
+		REQUIRE(nes.state() == expected);
+	}
+
+	SECTION("The cache answers without the disk until refreshed") {
+		std::filesystem::remove(nes.states.get_slot_path(2));
+		REQUIRE(nes.states.slot_exists(2));
+		nes.states.refresh_slot_cache();
+		REQUIRE_FALSE(nes.states.slot_exists(2));
+		REQUIRE_FALSE(nes.states.get_slot_timestamp(2).has_value());
+
+		REQUIRE(nes.states.quick_save());
+		REQUIRE(nes.states.get_slot_info(SaveStateManager::QUICK_SAVE_SLOT).exists);
+		REQUIRE(nes.states.get_slot_info(SaveStateManager::QUICK_SAVE_SLOT).thumbnail[0] == corner);
+	}
+
+	SECTION("Snapshots and in-memory states have no thumbnail") {
+		const std::vector<uint8_t> state = nes.states.serialize_state();
+		REQUIRE(std::memcmp(state.data() + sizeof(SaveStateHeader), "CPU ", 4) == 0);
+	}
+	std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("SaveState Rewind Buffer", "[save-state][rewind]") {
+	SnapshotSystem nes;
+	StateSnapshot snapshot;
+	// Bytes of every frame pushed, oldest first
+	std::vector<std::vector<uint8_t>> history;
+	const auto push_frames = [&](RewindBuffer &buffer, int frames) {
+		for (int i = 0; i < frames; ++i) {
+			nes.run_frames(1);
+			nes.states.capture(snapshot);
+			buffer.push(snapshot);
+			history.emplace_back(snapshot.data(), snapshot.data() + snapshot.size());
+		}
+	};
+	// Pop everything, checking it against the newest frames of history
+	const auto pop_all = [&](RewindBuffer &buffer) {
+		size_t popped = 0;
+		bool exact = true;
+		while (buffer.pop(snapshot)) {
+			const std::vector<uint8_t> &expected = history[history.size() - 1 - popped];
+			exact = exact && std::equal(expected.begin(), expected.end(), snapshot.data(),
+										snapshot.data() + snapshot.size());
+			++popped;
+		}
+		REQUIRE(exact);
+		return popped;
+	};
+
+	SECTION("Frames come back newest first, across keyframes") {
+		RewindBuffer buffer(RewindBuffer::DEFAULT_BUDGET, 8);
+		push_frames(buffer, 30);
+		REQUIRE(buffer.frame_count() == 30);
+		REQUIRE(pop_all(buffer) == 30);
+		REQUIRE(buffer.empty());
+		REQUIRE(buffer.memory_used() == 0);
+	}
+
+	SECTION("Popped frames restore and history continues from them") {
+		RewindBuffer buffer(RewindBuffer::DEFAULT_BUDGET, 8);
+		push_frames(buffer, 20);
+		for (int i = 0; i < 13; ++i) {
+			REQUIRE(buffer.pop(snapshot));
+			history.pop_back();
+		}
+		REQUIRE(nes.states.restore(snapshot));
+		push_frames(buffer, 10);
+		REQUIRE(buffer.frame_count() == 17);
+		REQUIRE(pop_all(buffer) == 17);
+	}
+
+	SECTION("Held within the budget, dropping the oldest frames") {
+		// Room for about three keyframes and their deltas
+		RewindBuffer sizing(RewindBuffer::DEFAULT_BUDGET, 10);
+		push_frames(sizing, 10);
+		const size_t budget = sizing.memory_used() * 3 + sizing.memory_used() / 2;
+		RewindBuffer buffer(budget, 10);
+		push_frames(buffer, 200);
+		REQUIRE(buffer.memory_used() <= budget);
+		const size_t kept = buffer.frame_count();
+		REQUIRE(kept >= 20);
+		REQUIRE(kept <= 40);
+		REQUIRE(pop_all(buffer) == kept);
+	}
+
+	SECTION("Deltas are a fraction of the state") {
+		RewindBuffer buffer;
+		push_frames(buffer, 60);
+		REQUIRE(buffer.memory_used() * 20 < history.front().size() * 60);
+	}
+
+	SECTION("A new ROM session starts the history over") {
+		RewindBuffer buffer;
+		push_frames(buffer, 5);
+		REQUIRE(nes.system.load_rom_data(make_counter_rom()));
+		history.clear();
+		push_frames(buffer, 3);
+		REQUIRE(buffer.frame_count() == 3);
+		REQUIRE(pop_all(buffer) == 3);
+	}
+}
@@ -0,0 +1,46 @@
+// VibeNES - NES Emulator
+// Accuracy Database Tests
+// Per-ROM accuracy profiles read from the database file format
+
+#include "../../include/core/accuracy.hpp"
+#include <catch2/catch_all.hpp>
+
+using namespace nes;
+
+TEST_CASE("Accuracy Database - Parsing and lookup", "[core][accuracy]") {
+	AccuracyDatabase database;
+
+	SECTION("Unlisted games run Strict") {
+		REQUIRE(database.lookup(0x12345678u) == Accuracy::Strict);
+	}
+
+	SECTION("Entries, comments and blank lines") {
+		REQUIRE(database.parse("# PRG CRC-32   profile\n"
+							   "3337ec46 fast   # mapper 0 platformer\n"
+							   "\n"
+							   "  A0B0C0D0\tstrict\r\n"
+							   "1 fast"));
+		REQUIRE(database.size() == 3);
+		REQUIRE(database.lookup(0x3337EC46u) == Accuracy::Fast);
+		REQUIRE(database.lookup(0xA0B0C0D0u) == Accuracy::Strict);
+		REQUIRE(database.lookup(0x00000001u) == Accuracy::Fast);
+	}
+
+	SECTION("A malformed line rejects the whole text") {
+		REQUIRE_FALSE(database.parse("3337ec46 fast\nzz12 fast\n"));
+		REQUIRE_FALSE(database.parse("3337ec46 quick\n"));
+		REQUIRE_FALSE(database.parse("3337ec46\n"));
+		REQUIRE(database.size() == 0);
+	}
+
+	SECTION("Later entries replace earlier ones") {
+		database.set(0xCAFEF00Du, Accuracy::Fast);
+		REQUIRE(database.parse("cafef00d strict\n"));
+		REQUIRE(database.lookup(0xCAFEF00Du) == Accuracy::Strict);
+	}
+
+	SECTION("A missing file loads nothing") {
+		REQUIRE_FALSE(database.load("/nonexistent/accuracy.txt"));
+		REQUIRE(database.size() == 0);
+	}
+}
@@ -0,0 +1,148 @@
+// VibeNES - NES Emulator
+// Async File Writer Tests
+// Background writes, in-place patches, per-path coalescing, failures and draining
+
+#include "../../include/system/async_file_writer.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+std::vector<std::uint8_t> read_file(const std::filesystem::path &path) {
+	std::ifstream file(path, std::ios::binary);
+	return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+struct TempDir {
+	std::filesystem::path path;
+	explicit TempDir(const char *name) : path(std::filesystem::temp_directory_path() / name) {
+		std::filesystem::remove_all(path);
+	}
+	~TempDir() {
+		std::filesystem::remove_all(path);
+	}
+};
+
+} // namespace
+
+TEST_CASE("AsyncFileWriter - Writes land and futures report them", "[core][file-writer]") {
+	TempDir dir("vibenes_file_writer");
+	const auto path = dir.path / "nested" / "state.vns";
+	const std::vector<std::uint8_t> data = {1, 2, 3, 4, 5};
+
+	AsyncFileWriter writer;
+	const FileWriteResult written = writer.write(path, data).get();
+	REQUIRE(written.ok);
+	REQUIRE(written.error.empty());
+	REQUIRE(read_file(path) == data);
+	REQUIRE_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+	// Replaced whole, never appended to
+	REQUIRE(writer.write(path, {9}).get().ok);
+	REQUIRE(read_file(path) == std::vector<std::uint8_t>{9});
+}
+
+TEST_CASE("AsyncFileWriter - The last of a burst of writes wins", "[core][file-writer]") {
+	TempDir dir("vibenes_file_writer_burst");
+	const auto a = dir.path / "a.sav";
+	const auto b = dir.path / "b.sav";
+
+	AsyncFileWriter writer;
+	std::vector<std::future<FileWriteResult>> results;
+	for (std::uint8_t i = 0; i < 50; ++i) {
+		results.push_back(writer.write(a, std::vector<std::uint8_t>(100, i)));
+		results.push_back(writer.write(b, {i}));
+	}
+	writer.wait_idle();
+	REQUIRE(writer.is_idle());
+	for (auto &result : results) {
+		REQUIRE(result.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+		REQUIRE(result.get().ok);
+	}
+	REQUIRE(read_file(a) == std::vector<std::uint8_t>(100, 49));
+	REQUIRE(read_file(b) == std::vector<std::uint8_t>{49});
+}
+
+TEST_CASE("AsyncFileWriter - Patches rewrite only their ranges", "[core][file-writer]") {
+	TempDir dir("vibenes_file_writer_patch");
+	const auto path = dir.path / "game.sav";
+	std::vector<std::uint8_t> data(1024, 0x11);
+	const std::vector<FileRange> ranges = {{256, 256}};
+
+	// No file yet: written whole
+	REQUIRE(AsyncFileWriter::patch_file(path, data, ranges).ok);
+	REQUIRE(read_file(path) == data);
+
+	// Bytes outside the ranges are left as the file has them
+	std::fill(data.begin(), data.end(), 0x22);
+	REQUIRE(AsyncFileWriter::patch_file(path, data, ranges).ok);
+	std::vector<std::uint8_t> expected(1024, 0x11);
+	std::fill_n(expected.begin() + 256, 256, 0x22);
+	REQUIRE(read_file(path) == expected);
+	REQUIRE_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+	// Another size: rewritten whole
+	REQUIRE(AsyncFileWriter::patch_file(path, std::vector<std::uint8_t>(512, 0x33), ranges).ok);
+	REQUIRE(read_file(path) == std::vector<std::uint8_t>(512, 0x33));
+	REQUIRE_FALSE(AsyncFileWriter::patch_file(path, std::vector<std::uint8_t>(512), std::vector<FileRange>{{500, 20}}).ok);
+}
+
+TEST_CASE("AsyncFileWriter - Queued patches to one file merge", "[core][file-writer]") {
+	TempDir dir("vibenes_file_writer_patch_burst");
+	const auto path = dir.path / "game.sav";
+	REQUIRE(AsyncFileWriter::write_file(path, std::vector<std::uint8_t>(64, 0x00)).ok);
+
+	AsyncFileWriter writer;
+	std::vector<std::future<FileWriteResult>> results;
+	std::vector<std::uint8_t> ram(64, 0x00);
+	for (std::uint8_t i = 0; i < 8; ++i) {
+		// Each write changes one byte; a merged patch must still carry all of them
+		ram[i * 8] = static_cast<std::uint8_t>(i + 1);
+		results.push_back(writer.patch(path, ram, {{static_cast<std::size_t>(i * 8), 1}}));
+	}
+	writer.wait_idle();
+	for (auto &result : results) {
+		REQUIRE(result.get().ok);
+	}
+	REQUIRE(read_file(path) == ram);
+
+	// A whole-file write joining a patch makes it whole
+	(void)writer.patch(path, std::vector<std::uint8_t>(64, 0xAA), {{0, 1}});
+	REQUIRE(writer.write(path, std::vector<std::uint8_t>(64, 0xBB)).get().ok);
+	REQUIRE(read_file(path) == std::vector<std::uint8_t>(64, 0xBB));
+}
+
+TEST_CASE("AsyncFileWriter - Failures come back through the future", "[core][file-writer]") {
+	TempDir dir("vibenes_file_writer_fail");
+	std::filesystem::create_directories(dir.path);
+	const auto blocker = dir.path / "not_a_directory";
+	REQUIRE(AsyncFileWriter::write_file(blocker, std::vector<std::uint8_t>{1}).ok);
+
+	AsyncFileWriter writer;
+	const FileWriteResult result = writer.write(blocker / "state.vns", {1, 2}).get();
+	REQUIRE_FALSE(result.ok);
+	REQUIRE_FALSE(result.error.empty());
+}
+
+TEST_CASE("AsyncFileWriter - Destruction finishes queued writes", "[core][file-writer]") {
+	TempDir dir("vibenes_file_writer_drain");
+	{
+		AsyncFileWriter writer;
+		for (int i = 0; i < 20; ++i) {
+			(void)writer.write(dir.path / ("file" + std::to_string(i)), std::vector<std::uint8_t>(4096, 0xAB));
+		}
+	}
+	for (int i = 0; i < 20; ++i) {
+		REQUIRE(read_file(dir.path / ("file" + std::to_string(i))).size() == 4096);
+	}
+}
@@ -0,0 +1,143 @@
+// VibeNES - NES Emulator
+// Batch Runner Tests
+// Work-stealing job pool, and independent HeadlessSystems running on it in
+// parallel exactly as they run one after another
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/memory/ram.hpp"
+#include "../../include/system/batch_runner.hpp"
+#include "../../include/system/frame_dump.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace nes;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Folds controller 1 into $12 every frame and shows it as the backdrop color
+RomData make_input_fold_rom() {
+	const std::array<uint8_t, 50> program = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xA9, 0x01,		  //       LDA #$01
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA2, 0x08,		  //       LDX #$08
+		0xAD, 0x16, 0x40, // $8011 LDA $4016
+		0x4A,			  //       LSR A
+		0x26, 0x10,		  //       ROL $10
+		0xCA,			  //       DEX
+		0xD0, 0xF7,		  //       BNE $8011
+		0xA5, 0x10,		  //       LDA $10
+		0x65, 0x12,		  //       ADC $12
+		0x85, 0x12,		  //       STA $12
+		0xA9, 0x3F,		  //       LDA #$3F
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA5, 0x12,		  //       LDA $12
+		0x8D, 0x07, 0x20, //       STA $2007
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+struct RunOutput {
+	bool loaded = false;
+	std::uint64_t frame_hash = 0;
+	std::array<Byte, 2048> ram{};
+};
+
+// 90 frames of a button pattern that depends on the job. Runs on pool
+// threads, so nothing in here may use Catch2 assertions
+void run_instance(const RomData &rom, std::size_t job, RunOutput &output) {
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system(input);
+	output.loaded = system.load_rom_data(rom);
+	for (std::size_t frame = 0; frame < 90; ++frame) {
+		input->set_buttons(0, static_cast<Byte>((frame / (job + 1)) * 0x29 + job));
+		system.run_frame();
+	}
+	output.frame_hash = hash_frame_buffer(system.get_frame_buffer());
+	std::copy(system.ram().get_memory().begin(), system.ram().get_memory().end(), output.ram.begin());
+}
+
+} // namespace
+
+TEST_CASE("Batch Runner - Runs Every Job Once", "[core][batch]") {
+	constexpr std::size_t JOBS = 1000;
+	std::vector<std::atomic<int>> runs(JOBS);
+	std::vector<BatchRunner::Job> jobs;
+	for (std::size_t i = 0; i < JOBS; ++i) {
+		jobs.push_back([&runs, i] { ++runs[i]; });
+	}
+
+	BatchRunner runner(4);
+	REQUIRE(runner.thread_count() == 4);
+	runner.run(std::move(jobs));
+	REQUIRE(std::all_of(runs.begin(), runs.end(), [](const std::atomic<int> &count) { return count == 1; }));
+
+	// Nothing to do, and more threads than jobs
+	runner.run({});
+	std::atomic<int> single{0};
+	runner.run({[&single] { ++single; }});
+	REQUIRE(single == 1);
+	REQUIRE(BatchRunner().thread_count() >= 1);
+}
+
+TEST_CASE("Batch Runner - Idle Workers Steal", "[core][batch]") {
+	// Jobs are dealt round-robin, so worker 0 gets both slow ones; the
+	// others run out of work and must take the second
+	std::atomic<int> done{0};
+	std::vector<BatchRunner::Job> jobs;
+	for (int i = 0; i < 8; ++i) {
+		jobs.push_back([&done, i] {
+			if (i % 4 == 0) {
+				std::this_thread::sleep_for(50ms);
+			}
+			++done;
+		});
+	}
+	BatchRunner runner(4);
+	runner.run(std::move(jobs));
+	REQUIRE(done == 8);
+	REQUIRE(runner.get_steal_count() >= 1);
+}
+
+TEST_CASE("Batch Runner - Parallel Systems Match Serial Runs", "[core][batch]") {
+	const RomData rom = make_input_fold_rom();
+	constexpr std::size_t JOBS = 12;
+
+	std::vector<RunOutput> serial(JOBS);
+	for (std::size_t job = 0; job < JOBS; ++job) {
+		run_instance(rom, job, serial[job]);
+	}
+
+	std::vector<RunOutput> parallel(JOBS);
+	std::vector<BatchRunner::Job> jobs;
+	for (std::size_t job = 0; job < JOBS; ++job) {
+		jobs.push_back([&rom, &parallel, job] { run_instance(rom, job, parallel[job]); });
+	}
+	BatchRunner(4).run(std::move(jobs));
+
+	for (std::size_t job = 0; job < JOBS; ++job) {
+		INFO("job " << job);
+		REQUIRE(parallel[job].loaded);
+		REQUIRE(parallel[job].frame_hash == serial[job].frame_hash);
+		REQUIRE(parallel[job].ram == serial[job].ram);
+	}
+	// The jobs' inputs differ, and so must their results
+	REQUIRE(serial[0].ram != serial[1].ram);
+}
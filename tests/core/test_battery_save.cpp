@@ -0,0 +1,183 @@
+// VibeNES - NES Emulator
+// Battery Save Tests
+// Debounced flushes and in-place .sav patches from the mapper's dirty pages
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_preloader.hpp"
+#include "../../include/system/async_file_writer.hpp"
+#include "../../include/system/battery_save.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// Battery-backed MMC1 with 8KB of PRG RAM
+RomData make_battery_rom() {
+	RomData rom = test::make_nrom({}, {}, {});
+	rom.mapper_id = 1;
+	rom.battery_backed_ram = true;
+	rom.filename = "battery_test.nes";
+	return rom;
+}
+
+std::vector<std::uint8_t> read_file(const std::filesystem::path &path) {
+	std::ifstream file(path, std::ios::binary);
+	return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+struct BatteryFixture {
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "vibenes_battery_save";
+	Cartridge cartridge;
+	BatterySaveManager saves{&cartridge};
+	std::filesystem::path sav = directory / "battery_test.sav";
+
+	BatteryFixture() {
+		std::filesystem::remove_all(directory);
+		saves.set_directory(directory);
+		REQUIRE(cartridge.load_from_rom_data(make_battery_rom()));
+		REQUIRE(cartridge.has_battery_ram());
+		saves.load_for_current_rom();
+	}
+	~BatteryFixture() {
+		std::filesystem::remove_all(directory);
+	}
+};
+
+} // namespace
+
+TEST_CASE("Battery Save - Flushes once the game stops writing", "[battery]") {
+	BatteryFixture fixture;
+
+	// Nothing written, nothing saved
+	fixture.saves.update(10.0);
+	REQUIRE_FALSE(std::filesystem::exists(fixture.sav));
+
+	fixture.cartridge.cpu_write(0x6000, 0x42);
+	fixture.saves.update(0.5);
+	fixture.saves.update(0.4);
+	REQUIRE_FALSE(std::filesystem::exists(fixture.sav));
+	fixture.saves.update(0.7);
+	const auto saved = read_file(fixture.sav);
+	REQUIRE(saved.size() == 8192);
+	REQUIRE(saved[0] == 0x42);
+
+	// A game writing every frame is saved every few seconds, not every frame
+	// and not never
+	int frames = 0;
+	for (; frames < 600; ++frames) {
+		fixture.cartridge.cpu_write(0x6100, static_cast<Byte>(frames));
+		fixture.saves.update(0.1);
+		if (read_file(fixture.sav)[0x100] != 0x00) {
+			break;
+		}
+	}
+	REQUIRE(frames >= 40);
+	REQUIRE(frames < 60);
+}
+
+TEST_CASE("Battery Save - Writes only the changed pages in place", "[battery]") {
+	BatteryFixture fixture;
+	fixture.cartridge.cpu_write(0x6000, 0x01);
+	REQUIRE(fixture.saves.flush());
+	REQUIRE_FALSE(fixture.saves.flush()); // Nothing new
+
+	// Mark a byte in the file the game has not touched since: a patch
+	// leaves it, a whole rewrite would not
+	{
+		std::fstream file(fixture.sav, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(0x1000);
+		file.put(static_cast<char>(0x7E));
+	}
+	fixture.cartridge.cpu_write(0x6000, 0x02);
+	fixture.cartridge.cpu_write(0x7FFF, 0x03);
+	REQUIRE(fixture.saves.flush());
+	auto saved = read_file(fixture.sav);
+	REQUIRE(saved[0x0000] == 0x02);
+	REQUIRE(saved[0x1FFF] == 0x03);
+	REQUIRE(saved[0x1000] == 0x7E);
+
+	// Forced (swap, exit): the file is made to match the RAM whole
+	REQUIRE(fixture.saves.flush(true));
+	saved = read_file(fixture.sav);
+	REQUIRE(saved[0x1000] == 0x00);
+	REQUIRE(saved[0x0000] == 0x02);
+}
+
+TEST_CASE("Battery Save - Memory-mapped save RAM is the file", "[battery]") {
+	BatteryFixture fixture;
+	std::filesystem::create_directories(fixture.directory);
+	{
+		std::ofstream file(fixture.sav, std::ios::binary);
+		file.put(static_cast<char>(0x5A)); // A short save from elsewhere
+	}
+	fixture.saves.set_memory_mapped(true);
+	fixture.saves.load_for_current_rom();
+	REQUIRE(fixture.saves.is_mapped());
+	REQUIRE(fixture.cartridge.cpu_read(0x6000) == 0x5A);
+	REQUIRE(read_file(fixture.sav).size() == 8192);
+
+	// A write is in the file at once, with no flush and nothing to flush
+	fixture.cartridge.cpu_write(0x6001, 0x42);
+	fixture.cartridge.cpu_write(0x7FFF, 0x43);
+	auto saved = read_file(fixture.sav);
+	REQUIRE(saved[0x0001] == 0x42);
+	REQUIRE(saved[0x1FFF] == 0x43);
+	REQUIRE_FALSE(fixture.saves.flush());
+
+	// Forced (swap, exit): unmapped, the RAM kept by the mapper
+	REQUIRE(fixture.saves.flush(true));
+	REQUIRE_FALSE(fixture.saves.is_mapped());
+	fixture.cartridge.cpu_write(0x6002, 0x44);
+	REQUIRE(fixture.cartridge.cpu_read(0x6001) == 0x42);
+	saved = read_file(fixture.sav);
+	REQUIRE(saved[0x0002] == 0x00);
+	REQUIRE(saved[0x0001] == 0x42);
+}
+
+TEST_CASE("Battery Save - Reloading the running ROM keeps its RAM", "[battery]") {
+	BatteryFixture fixture;
+	AsyncFileWriter writer;
+	fixture.saves.set_file_writer(&writer);
+	fixture.cartridge.set_pre_swap_hook([&fixture]() { fixture.saves.flush(true); });
+
+	// The same battery-backed MMC1 ROM as a file, for the preloader
+	const std::filesystem::path rom_directory = std::filesystem::temp_directory_path() / "vibenes_battery_rom";
+	std::filesystem::create_directories(rom_directory);
+	const std::string rom_path = (rom_directory / "battery_test.nes").string();
+	{
+		std::vector<char> image(16 + 32768 + 8192, 0x00);
+		const char header[8] = {'N', 'E', 'S', 0x1A, 2, 1, 0x12, 0x00}; // Mapper 1, battery
+		std::copy(std::begin(header), std::end(header), image.begin());
+		std::ofstream(rom_path, std::ios::binary).write(image.data(), static_cast<std::streamsize>(image.size()));
+	}
+
+	// $11 on disk, $22 written since
+	fixture.cartridge.cpu_write(0x6000, 0x11);
+	REQUIRE(fixture.saves.flush());
+	writer.wait_idle();
+	fixture.cartridge.cpu_write(0x6000, 0x22);
+
+	// Read with the ROM, before the swap flushes the RAM
+	RomPreloader preloader;
+	const auto save_path = BatterySaveManager::path_for_rom(fixture.directory, rom_path, ".sav");
+	preloader.prefetch(rom_path, save_path);
+	const PreloadedRom rom = preloader.take(rom_path, save_path);
+	REQUIRE(rom.save);
+	REQUIRE((*rom.save)[0] == 0x11);
+
+	REQUIRE(fixture.cartridge.load_rom_image(rom.image));
+	fixture.saves.restore(rom.save);
+	REQUIRE(fixture.cartridge.cpu_read(0x6000) == 0x22);
+	REQUIRE(fixture.saves.flush(true));
+	writer.wait_idle();
+	REQUIRE(read_file(fixture.sav)[0] == 0x22);
+	std::filesystem::remove_all(rom_directory);
+}
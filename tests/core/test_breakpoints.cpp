@@ -0,0 +1,171 @@
+// VibeNES - NES Emulator
+// Breakpoint Tests
+// Condition expressions, CPU/PPU watchpoints and run loop hit reasons
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/breakpoints.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <string>
+
+using namespace nes;
+
+// NROM cart that counts X up, stores it to RAM and through PPUDATA to $2100
+static RomData build_watch_rom() {
+	const Byte code[] = {
+		0xE8,			  // 8000: INX
+		0x8E, 0x00, 0x03, // 8001: STX $0300
+		0xE6, 0x10,		  // 8004: INC $10
+		0xA9, 0x21,		  // 8006: LDA #$21
+		0x8D, 0x06, 0x20, // 8008: STA $2006
+		0xA9, 0x00,		  // 800B: LDA #$00
+		0x8D, 0x06, 0x20, // 800D: STA $2006
+		0x8E, 0x07, 0x20, // 8010: STX $2007
+		0x4C, 0x00, 0x80, // 8013: JMP $8000
+	};
+	return test::make_nrom(code);
+}
+
+static std::int32_t eval(std::string_view text) {
+	const auto condition = BreakCondition::compile(text);
+	REQUIRE(condition.has_value());
+	return condition->evaluate(nullptr, nullptr, 0x1234, 0x56);
+}
+
+TEST_CASE("Breakpoint Conditions - Expressions", "[breakpoints][condition]") {
+	REQUIRE(eval("1 + 2 * 3 == 7") == 1);
+	REQUIRE(eval("($10 | %0001) == 0x11") == 1);
+	REQUIRE(eval("$10 | %0001 == 0x11") == 0x10); // == binds tighter, as in C
+	REQUIRE(eval("addr == $1234 && value >= 86") == 1);
+	REQUIRE(eval("!(value & 1) || 0") == 1);
+	REQUIRE(eval("~0 == -1") == 1);
+	REQUIRE(eval("1 << 4 >> 2") == 4);
+	REQUIRE(eval("2 - 3 < 0") == 1);
+	REQUIRE(eval("ADDR - Addr") == 0);
+
+	std::string error;
+	REQUIRE_FALSE(BreakCondition::compile("a ==", &error));
+	REQUIRE_FALSE(error.empty());
+	REQUIRE_FALSE(BreakCondition::compile("foo == 1", &error));
+	REQUIRE(error.find("foo") != std::string::npos);
+	REQUIRE_FALSE(BreakCondition::compile("(1 + 2", &error));
+	REQUIRE_FALSE(BreakCondition::compile("1 2", &error));
+	REQUIRE_FALSE(BreakCondition::compile("$", &error));
+	REQUIRE_FALSE(BreakCondition::compile("99999999999", &error));
+}
+
+TEST_CASE("Breakpoints - Entries and pages", "[breakpoints]") {
+	Breakpoints breakpoints;
+	REQUIRE_FALSE(breakpoints.is_armed());
+	REQUIRE_FALSE(breakpoints.is_watching());
+
+	std::string error;
+	REQUIRE(breakpoints.add(Breakpoints::CPU_READ | Breakpoints::PPU_READ, 0, 0, {}, &error) == 0);
+	REQUIRE(breakpoints.add(Breakpoints::CPU_READ, 0x200, 0x100, {}, &error) == 0);
+	REQUIRE(breakpoints.add(Breakpoints::PPU_WRITE, 0x3F00, 0x4000, {}, &error) == 0);
+	REQUIRE(breakpoints.add(Breakpoints::CPU_WRITE, 0x300, 0x300, "value ==", &error) == 0);
+	REQUIRE(breakpoints.entries().empty());
+
+	const int exec = breakpoints.add(Breakpoints::EXECUTE, 0x8000, 0x8000);
+	REQUIRE(exec > 0);
+	REQUIRE(breakpoints.is_armed());
+	REQUIRE_FALSE(breakpoints.is_watching()); // Execute only: the bus stays on its fast path
+
+	const int write = breakpoints.add(Breakpoints::CPU_WRITE, 0x0300, 0x04FF, "value > 2");
+	REQUIRE(write > exec);
+	REQUIRE(breakpoints.is_watching());
+	REQUIRE(breakpoints.watches(Breakpoints::CPU_WRITE, 0x0455));
+	REQUIRE_FALSE(breakpoints.watches(Breakpoints::CPU_READ, 0x0455));
+	REQUIRE_FALSE(breakpoints.watches(Breakpoints::CPU_WRITE, 0x0500));
+
+	REQUIRE_FALSE(breakpoints.check(Breakpoints::CPU_WRITE, 0x0300, 2)); // Condition false
+	REQUIRE_FALSE(breakpoints.check(Breakpoints::CPU_WRITE, 0x0500, 9)); // Off the range
+	REQUIRE(breakpoints.check(Breakpoints::CPU_WRITE, 0x04FF, 3));
+	REQUIRE(breakpoints.check(Breakpoints::CPU_WRITE, 0x0300, 4));
+	const auto hit = breakpoints.take_hit();
+	REQUIRE(hit.has_value());
+	REQUIRE(hit->id == write); // The first hit is kept
+	REQUIRE(hit->address == 0x04FF);
+	REQUIRE(hit->value == 3);
+	REQUIRE_FALSE(breakpoints.has_hit());
+	REQUIRE(breakpoints.entries()[1].hits == 2);
+
+	REQUIRE(breakpoints.set_enabled(write, false));
+	REQUIRE_FALSE(breakpoints.is_watching());
+	REQUIRE_FALSE(breakpoints.check(Breakpoints::CPU_WRITE, 0x0300, 9));
+	REQUIRE(breakpoints.remove(exec));
+	REQUIRE_FALSE(breakpoints.remove(exec));
+	REQUIRE_FALSE(breakpoints.is_armed());
+	breakpoints.clear();
+	REQUIRE(breakpoints.entries().empty());
+}
+
+TEST_CASE("Breakpoints - Run loop stops", "[breakpoints][cpu][run]") {
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_watch_rom()));
+	CPU6502 &cpu = system.cpu();
+	Breakpoints &breakpoints = system.bus().breakpoints();
+
+	SECTION("Write watchpoint with a condition") {
+		const int id = breakpoints.add(Breakpoints::CPU_WRITE, 0x0300, 0x0300, "value == 3");
+		const CPU6502::RunResult result = cpu.run_until(cpu.get_cycle_count() + 100000);
+		REQUIRE(result.stop == CPU6502::RunStop::Watchpoint);
+		REQUIRE(result.hit.id == id);
+		REQUIRE(result.hit.kind == Breakpoints::CPU_WRITE);
+		REQUIRE(result.hit.address == 0x0300);
+		REQUIRE(result.hit.value == 3);
+		REQUIRE(cpu.get_x_register() == 3);
+		REQUIRE(cpu.get_program_counter() == 0x8004); // Right after the STX
+	}
+
+	SECTION("Zero page reads and writes") {
+		const int id = breakpoints.add(Breakpoints::CPU_READ | Breakpoints::CPU_WRITE, 0x0010, 0x0010);
+		CPU6502::RunResult result = cpu.run_until(cpu.get_cycle_count() + 100000);
+		REQUIRE(result.stop == CPU6502::RunStop::Watchpoint);
+		REQUIRE(result.hit.id == id);
+		REQUIRE(result.hit.kind == Breakpoints::CPU_READ); // INC reads first
+		REQUIRE(cpu.get_program_counter() == 0x8006);
+		REQUIRE(breakpoints.entries()[0].hits == 2); // The read and the write back
+	}
+
+	SECTION("PPU writes through PPUDATA") {
+		breakpoints.add(Breakpoints::PPU_WRITE, 0x2100, 0x21FF, "value == 2");
+		const CPU6502::RunResult result = cpu.run_until(cpu.get_cycle_count() + 100000);
+		REQUIRE(result.stop == CPU6502::RunStop::Watchpoint);
+		REQUIRE(result.hit.kind == Breakpoints::PPU_WRITE);
+		REQUIRE(result.hit.address == 0x2100);
+		REQUIRE(result.hit.value == 2);
+	}
+
+	SECTION("Conditional execute breakpoint") {
+		const int id = breakpoints.add(Breakpoints::EXECUTE, 0x8013, 0x8013, "x == 4 && [$0300] == 4");
+		CPU6502::RunResult result = cpu.run_until(cpu.get_cycle_count() + 100000);
+		REQUIRE(result.stop == CPU6502::RunStop::Breakpoint);
+		REQUIRE(result.hit.id == id);
+		REQUIRE(result.hit.value == 0x4C); // The opcode
+		REQUIRE(cpu.get_program_counter() == 0x8013);
+		REQUIRE(cpu.get_x_register() == 4);
+
+		// Resuming runs on; the condition never holds again before X wraps
+		result = cpu.run_until(cpu.get_cycle_count() + 1000);
+		REQUIRE(result.stop == CPU6502::RunStop::Target);
+	}
+
+	SECTION("Plain CPU breakpoints report id 0") {
+		cpu.set_breakpoint(0x8006);
+		const CPU6502::RunResult result = cpu.run_until(cpu.get_cycle_count() + 100000);
+		REQUIRE(result.stop == CPU6502::RunStop::Breakpoint);
+		REQUIRE(result.hit.id == 0);
+		REQUIRE(result.hit.address == 0x8006);
+	}
+
+	SECTION("Disabled entries never stop a run") {
+		const int id = breakpoints.add(Breakpoints::CPU_WRITE, 0x0000, 0xFFFF);
+		breakpoints.set_enabled(id, false);
+		REQUIRE(cpu.run_until(cpu.get_cycle_count() + 10000).stop == CPU6502::RunStop::Target);
+	}
+}
@@ -2,14 +2,39 @@
 // System Bus Tests
 // Tests for central memory and I/O interconnect
 
+#include "../../include/cartridge/cartridge.hpp"
 #include "../../include/core/bus.hpp"
 #include "../../include/core/types.hpp"
 #include "../../include/memory/ram.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
 #include <catch2/catch_all.hpp>
+#include <array>
 #include <string>
+#include <vector>
 
 using namespace nes;
 
+namespace {
+
+// MMC3 with 8 distinct 8KB PRG banks (every byte encodes bank + offset)
+RomData make_mmc3_rom() {
+	RomData rom{};
+	rom.mapper_id = 4;
+	rom.prg_rom_pages = 4;
+	rom.chr_rom_pages = 1;
+	rom.valid = true;
+	rom.prg_rom.resize(65536);
+	for (size_t i = 0; i < rom.prg_rom.size(); ++i) {
+		rom.prg_rom[i] = static_cast<Byte>((i >> 13) * 31 + (i & 0xFF));
+	}
+	rom.chr_rom.resize(8192, 0x00);
+	return rom;
+}
+
+} // namespace
+
 TEST_CASE("Bus Construction", "[bus][core]") {
 	SystemBus bus;
 
@@ -132,6 +157,16 @@ TEST_CASE("Bus Open Bus Behavior", "[bus][open-bus]") {
 		REQUIRE(bus.read(0x8000) == 0x42);
 	}
 
+	SECTION("Cartridge space keeps nothing without a cartridge") {
+		bus.write(0x8000, 0x5A);
+		bus.write(0x0100, 0x11);
+		[[maybe_unused]] auto bus_value = bus.read(0x0100); // Moves the latch off 0x5A
+		(void)bus_value;
+
+		REQUIRE(bus.read(0x8000) == 0x11);
+		REQUIRE(bus.peek(0x8000) != 0x5A);
+	}
+
 	SECTION("Fresh bus has predictable initial state") {
 		SystemBus fresh_bus;
 		// Before any operations, should return initial value (0xFF)
@@ -139,6 +174,38 @@ TEST_CASE("Bus Open Bus Behavior", "[bus][open-bus]") {
 	}
 }
 
+TEST_CASE("Bus Low RAM Fast Path", "[bus][memory][open-bus]") {
+	SystemBus bus;
+	auto ram = std::make_shared<Ram>();
+	bus.connect_ram(ram);
+
+	SECTION("Shares storage with the decoded path") {
+		bus.write(0x0042, 0x11);
+		bus.write_low_ram(0x01FD, 0x22);
+		REQUIRE(bus.read_low_ram(0x0042) == 0x11);
+		REQUIRE(bus.read(0x01FD) == 0x22);
+		REQUIRE(bus.read(0x09FD) == 0x22); // Mirror of $01FD
+	}
+
+	SECTION("Updates the open bus latch like read()/write()") {
+		bus.write_low_ram(0x0010, 0x5A);
+		REQUIRE(bus.read(0x4000) == 0x5A);
+
+		bus.write(0x0020, 0xA5);
+		REQUIRE(bus.read_low_ram(0x0020) == 0xA5);
+		bus.write(0x2000, 0x00); // Writes always latch, even unmapped
+		REQUIRE(bus.read_low_ram(0x0020) == 0xA5);
+		REQUIRE(bus.read(0x4000) == 0xA5);
+	}
+
+	SECTION("Without RAM behaves as open bus") {
+		SystemBus bare_bus;
+		bare_bus.write_low_ram(0x0000, 0x33);
+		REQUIRE(bare_bus.read_low_ram(0x0000) == 0x33);
+		REQUIRE(bare_bus.read(0x0000) == 0x33);
+	}
+}
+
 TEST_CASE("Bus Component Interface", "[bus][component]") {
 	SystemBus bus;
 	auto ram = std::make_shared<Ram>();
@@ -252,3 +319,185 @@ TEST_CASE("Bus Performance", "[bus][performance]") {
 		}
 	}
 }
+
+TEST_CASE("Bus PRG Page Table Reads", "[bus][cartridge]") {
+	SystemBus bus;
+	auto cartridge = std::make_shared<Cartridge>();
+	bus.connect_cartridge(cartridge);
+
+	REQUIRE(cartridge->load_from_rom_data(make_mmc3_rom()));
+	REQUIRE(cartridge->prg_page_table() != nullptr);
+
+	auto require_bus_matches_mapper = [&] {
+		for (uint32_t address = 0x8000; address <= 0xFFFF; address += 7) {
+			REQUIRE(bus.read(static_cast<Address>(address)) == cartridge->cpu_read(static_cast<Address>(address)));
+		}
+		REQUIRE(bus.read(0xFFFF) == cartridge->cpu_read(0xFFFF));
+	};
+
+	SECTION("Table follows bank register writes") {
+		require_bus_matches_mapper();
+		bus.write(0x8000, 0x06); // R6: $8000 bank
+		bus.write(0x8001, 0x05);
+		bus.write(0x8000, 0x07); // R7: $A000 bank
+		bus.write(0x8001, 0x03);
+		require_bus_matches_mapper();
+		bus.write(0x8000, 0x46); // PRG mode 1 swaps $8000/$C000
+		require_bus_matches_mapper();
+	}
+
+	SECTION("Unloading drops the table") {
+		cartridge->unload_rom();
+		REQUIRE(cartridge->prg_page_table() == nullptr);
+		REQUIRE(bus.read(0x8000) == 0xFF); // Falls back to Cartridge::cpu_read open bus
+	}
+}
+
+TEST_CASE("Bus Peek Range", "[bus][memory][cartridge]") {
+	SystemBus bus;
+	auto cartridge = std::make_shared<Cartridge>();
+	bus.connect_cartridge(cartridge);
+
+	REQUIRE(cartridge->load_from_rom_data(make_mmc3_rom()));
+	bus.write(0x8000, 0x06); // R6: $8000 bank 5
+	bus.write(0x8001, 0x05);
+	for (Address address = 0; address < 0x0800; ++address) {
+		bus.write(address, static_cast<Byte>(address * 7));
+	}
+
+	// Full 64KB starting mid RAM mirror, wrapping past $FFFF back to $0000
+	std::vector<Byte> snapshot(0x10000);
+	bus.peek_range(0x17F0, snapshot);
+	for (uint32_t i = 0; i < snapshot.size(); ++i) {
+		const Address address = static_cast<Address>(0x17F0 + i);
+		REQUIRE(snapshot[i] == bus.peek(address));
+	}
+
+	std::array<Byte, 3> tail{};
+	bus.peek_range(0xFFFE, tail);
+	REQUIRE(tail[0] == bus.peek(0xFFFE));
+	REQUIRE(tail[1] == bus.peek(0xFFFF));
+	REQUIRE(tail[2] == bus.peek(0x0000));
+}
+
+TEST_CASE("Bus MMC1 Write Cycle Stamps", "[bus][cartridge][mapper1]") {
+	SystemBus bus;
+	auto cartridge = std::make_shared<Cartridge>();
+	bus.connect_cartridge(cartridge);
+
+	// MMC1 with 8 16KB PRG banks; the first byte of each bank is its number
+	RomData rom{};
+	rom.mapper_id = 1;
+	rom.prg_rom_pages = 8;
+	rom.chr_rom_pages = 1;
+	rom.valid = true;
+	rom.prg_rom.resize(8 * 16384, 0x00);
+	for (size_t bank = 0; bank < 8; ++bank) {
+		rom.prg_rom[bank * 16384] = static_cast<Byte>(bank);
+	}
+	rom.chr_rom.resize(8192, 0x00);
+	REQUIRE(cartridge->load_from_rom_data(rom));
+
+	// The stamps come from the bus clock, whichever way the CPU advances it
+	const int path = GENERATE(0, 1, 2);
+	auto tick = [&bus, path]() {
+		if (path == 1 && bus.try_tick_cpu_cycles(1)) {
+			return;
+		}
+		if (path == 2 && bus.idle_cycles_available() > 0) {
+			bus.advance_idle_cycles(1);
+			return;
+		}
+		bus.tick_single_cpu_cycle();
+	};
+
+	// Serial write of bank 1, with an extra write on the cycle after the
+	// first, as the second write of a read-modify-write would land
+	bus.write(0xE000, 0x01);
+	tick();
+	bus.write(0xE000, 0x01); // Ignored
+	for (int bit = 0; bit < 4; ++bit) {
+		tick();
+		tick();
+		bus.write(0xE000, 0x00);
+	}
+	// Had the second write shifted in, the bank would be 3
+	REQUIRE(bus.read(0x8000) == 1);
+}
+
+TEST_CASE("Bus Region Dot Ratio", "[bus][ppu][region]") {
+	SystemBus bus;
+	auto ppu = std::make_shared<PPU>();
+	bus.connect_ppu(ppu);
+	ppu->connect_bus(&bus);
+	ppu->power_on();
+
+	auto dots_run = [&bus]() {
+		const auto [scanline, dot] = bus.get_ppu_position();
+		return static_cast<uint32_t>(scanline) * 341u + dot;
+	};
+
+	const bool catch_up = GENERATE(false, true);
+	bus.set_ppu_catch_up(catch_up);
+
+	SECTION("PAL runs 16 dots every 5 CPU cycles") {
+		bus.set_region(Region::Pal);
+		REQUIRE(bus.get_region() == Region::Pal);
+		const uint32_t expected[5] = {3, 6, 9, 12, 16};
+		for (uint32_t cycle = 0; cycle < 5; ++cycle) {
+			bus.tick_single_cpu_cycle();
+			REQUIRE(dots_run() == expected[cycle]);
+		}
+		for (int cycle = 0; cycle < 5 * 99; ++cycle) {
+			bus.tick_single_cpu_cycle();
+		}
+		REQUIRE(dots_run() == 1600u);
+		bus.tick(CpuCycle(5));
+		REQUIRE(dots_run() == 1616u);
+	}
+
+	SECTION("Dendy keeps 3 dots per CPU cycle") {
+		bus.set_region(Region::Dendy);
+		for (int cycle = 0; cycle < 500; ++cycle) {
+			bus.tick_single_cpu_cycle();
+		}
+		REQUIRE(dots_run() == 1500u);
+	}
+
+	SECTION("Idle skips stay on the PAL dot pattern") {
+		bus.set_region(Region::Pal);
+		bus.tick_single_cpu_cycle();
+		bus.tick_single_cpu_cycle();
+		const uint32_t cycles = bus.idle_cycles_available();
+		REQUIRE(cycles > 0);
+		bus.advance_idle_cycles(cycles);
+		REQUIRE(dots_run() == static_cast<uint32_t>((cycles + 2) * 16 / 5));
+	}
+}
+
+TEST_CASE("Bus Region From ROM Header", "[bus][region]") {
+	RomData rom = test::make_nrom({}, {.irq = 0x8000}); // A NOP sled
+
+	SECTION("PAL ROMs run 312-line frames") {
+		rom.timing = TimingRegion::Pal;
+		HeadlessSystem system;
+		REQUIRE(system.load_rom_data(rom));
+		REQUIRE(system.bus().get_region() == Region::Pal);
+		system.run_frame();
+		const uint64_t cycles = system.run_frame();
+		// 341 * 312 dots at 3.2 per CPU cycle, to within an instruction
+		REQUIRE(cycles >= 33247);
+		REQUIRE(cycles <= 33247 + 2);
+	}
+
+	SECTION("Multi-region ROMs run as NTSC") {
+		rom.timing = TimingRegion::MultiRegion;
+		HeadlessSystem system;
+		REQUIRE(system.load_rom_data(rom));
+		REQUIRE(system.bus().get_region() == Region::Ntsc);
+		system.run_frame();
+		const uint64_t cycles = system.run_frame();
+		REQUIRE(cycles >= 29780);
+		REQUIRE(cycles <= 29781 + 2);
+	}
+}
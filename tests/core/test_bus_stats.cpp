@@ -0,0 +1,132 @@
+// VibeNES - NES Emulator
+// Bus Stats Tests
+// CPU bus traffic by region and PPU fetch counts (VIBENES_BUS_STATS builds)
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/core/bus_stats.hpp"
+#include "../../include/memory/ram.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+using namespace nes;
+
+namespace {
+
+using BusRegion = BusStats::Region;
+
+std::shared_ptr<Cartridge> make_nrom_cartridge() {
+	RomData rom = test::make_nrom({}, {}, std::vector<Byte>(8192, 0x5A));
+	rom.vertical_mirroring = true;
+	auto cartridge = std::make_shared<Cartridge>();
+	cartridge->load_from_rom_data(rom);
+	return cartridge;
+}
+
+} // namespace
+
+TEST_CASE("Bus Stats - Regions", "[core][bus-stats]") {
+	REQUIRE(BusStats::region_of(0x0000, false) == BusRegion::Ram);
+	REQUIRE(BusStats::region_of(0x1FFF, true) == BusRegion::Ram);
+	REQUIRE(BusStats::region_of(0x2000, false) == BusRegion::PpuRegisters);
+	REQUIRE(BusStats::region_of(0x3FFF, false) == BusRegion::PpuRegisters);
+	REQUIRE(BusStats::region_of(0x4014, true) == BusRegion::Apu);
+	REQUIRE(BusStats::region_of(0x4015, false) == BusRegion::Apu);
+	REQUIRE(BusStats::region_of(0x4016, true) == BusRegion::Controllers);
+	// $4017 reads controller 2; writes go to the APU frame counter
+	REQUIRE(BusStats::region_of(0x4017, false) == BusRegion::Controllers);
+	REQUIRE(BusStats::region_of(0x4017, true) == BusRegion::Apu);
+	REQUIRE(BusStats::region_of(0x4018, false) == BusRegion::Expansion);
+	REQUIRE(BusStats::region_of(0x5FFF, true) == BusRegion::Expansion);
+	REQUIRE(BusStats::region_of(0x6000, false) == BusRegion::PrgRam);
+	REQUIRE(BusStats::region_of(0x8000, false) == BusRegion::PrgRom);
+	REQUIRE(BusStats::region_of(0xFFFF, true) == BusRegion::PrgRom);
+}
+
+TEST_CASE("Bus Stats - CPU traffic", "[core][bus-stats]") {
+	SystemBus bus;
+	bus.connect_ram(std::make_shared<Ram>());
+	bus.connect_cartridge(make_nrom_cartridge());
+	bus.power_on();
+	bus.reset_bus_stats();
+
+	bus.write(0x0300, 0x12);
+	static_cast<void>(bus.read(0x0300));
+	static_cast<void>(bus.read_low_ram(0x0010));
+	bus.write_low_ram(0x01FF, 0x34);
+	bus.write(0x6000, 0x56);
+	static_cast<void>(bus.read(0x6000));
+	static_cast<void>(bus.read(0x8000));
+	static_cast<void>(bus.fetch(0xFFFC));
+	static_cast<void>(bus.read(0x4016));
+	bus.write(0x4017, 0x40);
+
+	const BusStats &stats = bus.get_bus_stats();
+	if constexpr (BusStats::ENABLED) {
+		REQUIRE(stats.reads_in(BusRegion::Ram) == 2);
+		REQUIRE(stats.writes_in(BusRegion::Ram) == 2);
+		REQUIRE(stats.low_ram_reads == 1);
+		REQUIRE(stats.low_ram_writes == 1);
+		REQUIRE(stats.reads_in(BusRegion::PrgRam) == 1);
+		REQUIRE(stats.writes_in(BusRegion::PrgRam) == 1);
+		REQUIRE(stats.reads_in(BusRegion::PrgRom) == 2);
+		REQUIRE(stats.prg_page_reads == 2);
+		REQUIRE(stats.reads_in(BusRegion::Controllers) == 1);
+		REQUIRE(stats.writes_in(BusRegion::Apu) == 1);
+		REQUIRE(stats.total_reads() == 6);
+		REQUIRE(stats.total_writes() == 4);
+	} else {
+		REQUIRE(stats.total_reads() == 0); // Compiled out
+		REQUIRE(stats.total_writes() == 0);
+	}
+
+	// Peeks are not traffic
+	bus.reset_bus_stats();
+	static_cast<void>(bus.peek(0x8000));
+	REQUIRE(bus.get_bus_stats().total_reads() == 0);
+}
+
+TEST_CASE("Bus Stats - PPU fetches per frame", "[core][bus-stats][ppu]") {
+	// Both render paths make the same fetches; the batched one takes the
+	// background pattern rows of 30 tiles a line from the CHR cache instead
+	auto run = [](bool batching) {
+		auto cartridge = make_nrom_cartridge();
+		auto ppu = std::make_unique<PPU>();
+		ppu->connect_cartridge(cartridge);
+		ppu->power_on();
+		ppu->set_scanline_batching(batching);
+		ppu->write_register(0x2001, 0x1E); // Background and sprites, no left clip
+		while (ppu->get_frame_count() < 3) {
+			ppu->tick_dots(341);
+		}
+		return std::pair{ppu->get_frame_fetch_stats(), ppu->get_total_fetch_stats()};
+	};
+	const auto [dots, dots_total] = run(false);
+	const auto [batched, batched_total] = run(true);
+
+	if constexpr (BusStats::ENABLED) {
+		// 240 visible lines and the pre-render line fetch 34 background tiles
+		// and 8 sprites' pattern bytes each
+		constexpr uint64_t RENDERED_LINES = 241;
+		REQUIRE(dots.pattern == RENDERED_LINES * (34 * 2 + 8 * 2));
+		REQUIRE(dots.pattern_cached == 0);
+		REQUIRE(batched.pattern_cached == 240 * 30 * 2);
+		REQUIRE(batched.pattern + batched.pattern_cached == dots.pattern);
+		REQUIRE(dots.nametable > RENDERED_LINES * 34 * 2);
+		REQUIRE(batched.nametable == dots.nametable);
+		REQUIRE(dots.palette == 256 * 240);
+		REQUIRE(batched.palette == dots.palette);
+		REQUIRE(dots_total.nametable == 3 * dots.nametable);
+		REQUIRE(batched_total.pattern == 3 * batched.pattern);
+	} else {
+		REQUIRE(dots.nametable == 0); // Compiled out
+		REQUIRE(dots.pattern == 0);
+		REQUIRE(batched.pattern_cached == 0);
+		REQUIRE(dots_total.palette == 0);
+	}
+}
@@ -0,0 +1,104 @@
+// VibeNES - NES Emulator
+// Checksum Tests
+// CRC-32 and SHA-1 against their published test vectors
+
+#include "../../include/core/checksum.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+const std::uint8_t *bytes(const std::string &text) {
+	return reinterpret_cast<const std::uint8_t *>(text.data());
+}
+
+// Bit-at-a-time CRC-32, the definition the fast paths must agree with
+std::uint32_t reference_crc32(const std::uint8_t *data, std::size_t length) {
+	std::uint32_t crc = 0xFFFFFFFF;
+	for (std::size_t i = 0; i < length; ++i) {
+		crc ^= data[i];
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0u);
+		}
+	}
+	return ~crc;
+}
+
+} // namespace
+
+TEST_CASE("CRC-32 - Check value and chaining", "[core][checksum]") {
+	const std::string check = "123456789";
+	REQUIRE(crc32(bytes(check), check.size()) == 0xCBF43926);
+	REQUIRE(crc32(nullptr, 0) == 0);
+
+	// Hashing in pieces gives the same CRC as hashing in one go
+	const std::uint32_t first = crc32(bytes(check), 4);
+	REQUIRE(crc32(bytes(check) + 4, check.size() - 4, first) == 0xCBF43926);
+}
+
+TEST_CASE("CRC-32 - Every length and alignment matches the definition", "[core][checksum]") {
+	std::vector<std::uint8_t> data(600);
+	std::uint32_t seed = 12345;
+	for (auto &byte : data) {
+		seed = seed * 1103515245 + 12345;
+		byte = static_cast<std::uint8_t>(seed >> 16);
+	}
+
+	for (std::size_t offset = 0; offset < 8; ++offset) {
+		for (std::size_t length = 0; length + offset <= data.size(); length += 1 + length / 8) {
+			INFO("offset " << offset << " length " << length);
+			REQUIRE(crc32(data.data() + offset, length) == reference_crc32(data.data() + offset, length));
+		}
+	}
+}
+
+TEST_CASE("SHA-1 - FIPS 180 vectors", "[core][checksum]") {
+	Sha1 sha1;
+
+	SECTION("Empty input") {
+		REQUIRE(Sha1::to_hex(sha1.finish()) == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+	}
+
+	SECTION("One block") {
+		const std::string abc = "abc";
+		sha1.update(bytes(abc), abc.size());
+		REQUIRE(Sha1::to_hex(sha1.finish()) == "a9993e364706816aba3e25717850c26c9cd0d89d");
+	}
+
+	SECTION("Padding spills into a second block") {
+		const std::string text = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+		sha1.update(bytes(text), text.size());
+		REQUIRE(Sha1::to_hex(sha1.finish()) == "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+	}
+
+	SECTION("A million bytes fed in uneven pieces") {
+		const std::vector<std::uint8_t> a(1000, 'a');
+		for (int i = 0; i < 1000; ++i) {
+			sha1.update(a.data(), 1 + (i % 7));
+			sha1.update(a.data(), 1000 - 1 - (i % 7));
+		}
+		REQUIRE(Sha1::to_hex(sha1.finish()) == "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+	}
+
+	SECTION("finish() starts over") {
+		const std::string abc = "abc";
+		sha1.update(bytes(abc), abc.size());
+		(void)sha1.finish();
+		sha1.update(bytes(abc), abc.size());
+		REQUIRE(Sha1::to_hex(sha1.finish()) == "a9993e364706816aba3e25717850c26c9cd0d89d");
+	}
+}
+
+TEST_CASE("XXH64 - Reference vectors", "[core][checksum]") {
+	REQUIRE(xxhash64(nullptr, 0) == 0xEF46DB3751D8E999ULL);
+	const std::string abc = "abc";
+	REQUIRE(xxhash64(abc.data(), abc.size()) == 0x44BC2CF5AD770999ULL);
+	// Long enough for the four-lane stripes plus every tail size
+	const std::string text = "Nobody inspects the spammish repetition";
+	REQUIRE(xxhash64(text.data(), text.size()) == 0xFBCEA83C8A378BF1ULL);
+	REQUIRE(xxhash64(text.data(), text.size(), 1) != xxhash64(text.data(), text.size()));
+}
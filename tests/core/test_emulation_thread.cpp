@@ -0,0 +1,539 @@
+// VibeNES - NES Emulator
+// Emulation Thread Tests
+// TripleBuffer handoff and the threaded emulation loop: commands, pacing,
+// exclusive access, frame and snapshot publishing
+
+#include "../../include/apu/apu.hpp"
+#include "../../include/audio/audio_output.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/emulation_thread.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/perf_counters.hpp"
+#include "../../include/system/rewind_buffer.hpp"
+#include "../../include/system/save_state.hpp"
+#include "../../include/system/triple_buffer.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+
+using namespace nes;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Strobes controller 1, copies its first bit (A) to $0000 and loops forever
+RomData make_input_echo_rom() {
+	const std::array<uint8_t, 18> program = {
+		0xA9, 0x01,		  // $8000 LDA #$01
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xAD, 0x16, 0x40, //       LDA $4016
+		0x85, 0x00,		  //       STA $00
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+// Counts frames in $10 and shows the count as the backdrop color (rendering off)
+RomData make_backdrop_counter_rom() {
+	const std::array<uint8_t, 39> program = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xE6, 0x10,		  //       INC $10
+		0xA9, 0x3F,		  //       LDA #$3F
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA5, 0x10,		  //       LDA $10
+		0x29, 0x3F,		  //       AND #$3F
+		0x8D, 0x07, 0x20, //       STA $2007
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0x8D, 0x06, 0x20, //       STA $2006
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+template <typename Predicate>
+bool wait_for(Predicate predicate, std::chrono::milliseconds timeout = 5000ms) {
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (!predicate()) {
+		if (std::chrono::steady_clock::now() > deadline) {
+			return false;
+		}
+		std::this_thread::sleep_for(1ms);
+	}
+	return true;
+}
+
+// Claims 44.1 kHz but plays out samples at `drain_rate`, like a device
+// whose clock runs slow (or a display pacing that never matches it)
+class DrainingAudioOutput final : public AudioOutput {
+  public:
+	explicit DrainingAudioOutput(double drain_rate) : drain_rate_(drain_rate) {
+	}
+	bool initialize(int, int) override {
+		return true;
+	}
+	void start() override {
+		playing_ = true;
+	}
+	void stop() override {
+		playing_ = false;
+	}
+	void queue_sample(float) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		fill_ += 1.0;
+	}
+	void queue_samples(std::span<const float> samples) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		drain();
+		fill_ += static_cast<double>(samples.size());
+	}
+	void queue_sample_stereo(float, float) override {
+		queue_sample(0.0f);
+	}
+	void set_volume(float) override {
+	}
+	float get_volume() const override {
+		return 1.0f;
+	}
+	bool is_playing() const override {
+		return playing_;
+	}
+	std::size_t get_buffer_size() const override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		drain();
+		return static_cast<std::size_t>(fill_);
+	}
+	int get_sample_rate() const override {
+		return 44100;
+	}
+	void clear_buffer() override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		fill_ = 0.0;
+	}
+
+  private:
+	double drain_rate_;
+	std::atomic<bool> playing_{false};
+	mutable std::mutex mutex_;
+	mutable double fill_ = 0.0;
+	mutable std::chrono::steady_clock::time_point last_ = std::chrono::steady_clock::now();
+
+	void drain() const {
+		const auto now = std::chrono::steady_clock::now();
+		fill_ = std::max(0.0, fill_ - std::chrono::duration<double>(now - last_).count() * drain_rate_);
+		last_ = now;
+	}
+};
+
+struct ThreadedSystem {
+	std::shared_ptr<LatchedInputSource> input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system{input};
+	SaveStateManager states{&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge()};
+	EmulationThread thread{system.cpu(), system.ppu(), system.bus(), input};
+
+	explicit ThreadedSystem(const RomData &rom = make_input_echo_rom()) {
+		REQUIRE(system.load_rom_data(rom));
+		thread.set_snapshot_callback([this](std::vector<uint8_t> &out) { states.serialize_state(out); });
+		thread.set_state_callbacks([this](StateSnapshot &snapshot) { states.capture(snapshot); },
+								   [this](const StateSnapshot &snapshot) { states.restore(snapshot); });
+		thread.start();
+	}
+};
+
+} // namespace
+
+TEST_CASE("Triple Buffer - Handoff", "[core][threading]") {
+	TripleBuffer<int> buffer;
+
+	SECTION("Nothing to read before the first publish") {
+		REQUIRE_FALSE(buffer.update());
+	}
+
+	SECTION("Reader sees the newest publication exactly once") {
+		buffer.write_buffer() = 1;
+		buffer.publish();
+		buffer.write_buffer() = 2;
+		buffer.publish();
+
+		REQUIRE(buffer.update());
+		REQUIRE(buffer.read_buffer() == 2);
+		REQUIRE_FALSE(buffer.update());
+		REQUIRE(buffer.read_buffer() == 2);
+
+		buffer.write_buffer() = 3;
+		buffer.publish();
+		REQUIRE(buffer.update());
+		REQUIRE(buffer.read_buffer() == 3);
+	}
+
+	SECTION("Concurrent writer never tears or reorders values") {
+		TripleBuffer<std::array<uint32_t, 256>> frames;
+		constexpr uint32_t COUNT = 20000;
+
+		std::thread writer([&] {
+			for (uint32_t i = 1; i <= COUNT; ++i) {
+				frames.write_buffer().fill(i);
+				frames.publish();
+			}
+		});
+
+		uint32_t last = 0;
+		bool consistent = true;
+		while (last != COUNT) {
+			if (!frames.update()) {
+				continue;
+			}
+			const auto &frame = frames.read_buffer();
+			const uint32_t value = frame[0];
+			for (uint32_t v : frame) {
+				consistent = consistent && (v == value);
+			}
+			consistent = consistent && (value > last);
+			last = value;
+		}
+		writer.join();
+		REQUIRE(consistent);
+	}
+}
+
+TEST_CASE("Emulation Thread - Control", "[core][threading]") {
+	ThreadedSystem nes;
+
+	SECTION("Starts paused and idle") {
+		REQUIRE(wait_for([&] { return nes.thread.is_idle(); }));
+		std::this_thread::sleep_for(30ms);
+		REQUIRE(nes.thread.get_frames_emulated() == 0);
+	}
+
+	SECTION("Runs at NTSC frame rate and pauses on request") {
+		nes.thread.run();
+		REQUIRE_FALSE(nes.thread.is_idle());
+		std::this_thread::sleep_for(500ms);
+		nes.thread.pause();
+		REQUIRE(wait_for([&] { return nes.thread.is_idle(); }));
+
+		// ~30 frames in 500 ms; wide bounds for loaded CI hosts
+		const uint64_t frames = nes.thread.get_frames_emulated();
+		REQUIRE(frames >= 5);
+		REQUIRE(frames <= 40);
+
+		std::this_thread::sleep_for(30ms);
+		REQUIRE(nes.thread.get_frames_emulated() == frames);
+	}
+
+	SECTION("Fast-forward runs uncapped") {
+		// At the slowest speed 30 paced frames would take ten seconds
+		nes.thread.set_speed(0.05f);
+		nes.thread.set_fast_forward(true);
+		nes.thread.run();
+		const auto start = std::chrono::steady_clock::now();
+		REQUIRE(wait_for([&] { return nes.thread.get_frames_emulated() >= 30; }, 10000ms));
+		REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+	}
+
+	SECTION("Exclusive access parks emulation") {
+		nes.thread.run();
+		REQUIRE(wait_for([&] { return nes.thread.get_frames_emulated() >= 2; }));
+
+		uint64_t frames_before = 0;
+		uint64_t frames_after = 0;
+		uint32_t dot_before = 0;
+		uint32_t dot_after = 0;
+		// Scanline/dot position; moves with every instruction while emulating
+		auto ppu_dot = [&] {
+			return static_cast<uint32_t>(nes.system.ppu().get_current_scanline()) * 341u +
+				   nes.system.ppu().get_current_cycle();
+		};
+		nes.thread.exclusive([&] {
+			frames_before = nes.thread.get_frames_emulated();
+			dot_before = ppu_dot();
+			std::this_thread::sleep_for(50ms);
+			frames_after = nes.thread.get_frames_emulated();
+			dot_after = ppu_dot();
+		});
+		REQUIRE(frames_before == frames_after);
+		REQUIRE(dot_before == dot_after);
+
+		// And resumes afterwards
+		REQUIRE(wait_for([&] { return nes.thread.get_frames_emulated() > frames_after; }));
+	}
+
+	SECTION("Stops itself at a breakpoint") {
+		nes.thread.exclusive([&] { nes.system.cpu().set_breakpoint(0x800A); }); // LDA $4016
+		nes.thread.run();
+		REQUIRE(wait_for([&] { return nes.thread.take_breakpoint_hit(); }));
+		REQUIRE(wait_for([&] { return nes.thread.is_idle(); }));
+		REQUIRE(nes.system.cpu().get_program_counter() == 0x800A);
+		REQUIRE_FALSE(nes.thread.take_fault());
+
+		// Running again steps past it and stops on the next loop iteration
+		const uint64_t cycles = nes.system.cpu().get_cycle_count();
+		nes.thread.run();
+		REQUIRE(wait_for([&] { return nes.thread.take_breakpoint_hit(); }));
+		REQUIRE(wait_for([&] { return nes.thread.is_idle(); }));
+		REQUIRE(nes.system.cpu().get_program_counter() == 0x800A);
+		REQUIRE(nes.system.cpu().get_cycle_count() > cycles);
+	}
+
+	SECTION("Button commands reach the controller") {
+		nes.thread.run();
+		nes.thread.set_buttons(0, 1u << static_cast<int>(NESButton::A));
+
+		auto read_a = [&] {
+			uint8_t value = 0;
+			nes.thread.exclusive([&] { value = nes.system.bus().read(0x0000) & 0x01; });
+			return value;
+		};
+		REQUIRE(wait_for([&] { return read_a() == 1; }));
+
+		nes.thread.set_buttons(0, 0);
+		REQUIRE(wait_for([&] { return read_a() == 0; }));
+	}
+
+	nes.thread.stop();
+}
+
+TEST_CASE("Emulation Thread - Publishing", "[core][threading]") {
+	ThreadedSystem nes;
+
+	SECTION("Completed frames reach the reader") {
+		REQUIRE_FALSE(nes.thread.update_frame());
+		nes.thread.run();
+		REQUIRE(wait_for([&] { return nes.thread.update_frame(); }));
+		REQUIRE(nes.thread.get_frame() != nullptr);
+		REQUIRE(nes.thread.get_frame_indices() != nullptr);
+	}
+
+	SECTION("Snapshots are produced on request and restore elsewhere") {
+		nes.thread.run();
+		REQUIRE_FALSE(nes.thread.update_snapshot());
+		nes.thread.request_snapshot();
+		REQUIRE(wait_for([&] { return nes.thread.update_snapshot(); }));
+		REQUIRE_FALSE(nes.thread.get_snapshot().empty());
+
+		// A debugger shadow with the same ROM can adopt the snapshot
+		HeadlessSystem shadow;
+		REQUIRE(shadow.load_rom_data(make_input_echo_rom()));
+		SaveStateManager shadow_states(&shadow.cpu(), &shadow.ppu(), &shadow.apu(), &shadow.bus(),
+									   &shadow.cartridge());
+		REQUIRE(shadow_states.deserialize_state(nes.thread.get_snapshot()));
+		REQUIRE(shadow.get_frame_count() > 0);
+
+		// No request, no new snapshot
+		std::this_thread::sleep_for(50ms);
+		REQUIRE_FALSE(nes.thread.update_snapshot());
+	}
+
+	nes.thread.stop();
+}
+
+TEST_CASE("Emulation Thread - Perf Counters", "[core][threading]") {
+	ThreadedSystem nes;
+	PerfCounters counters;
+	nes.thread.exclusive([&] { nes.thread.set_perf_counters(&counters); });
+
+	nes.thread.run();
+	REQUIRE(wait_for([&] {
+		counters.collect(0, 0);
+		return counters.size() >= 10;
+	}));
+	// Whole frames of emulation, each taking measurable time
+	for (std::size_t i = 0; i < counters.size(); ++i) {
+		const PerfCounters::Frame &frame = counters.frame(i);
+		REQUIRE(std::abs(static_cast<double>(frame.cpu_cycles) - EmulationThread::CPU_CYCLES_PER_FRAME) < 10.0);
+		REQUIRE(frame[PerfCounters::Counter::Emulation] > 0.0f);
+		REQUIRE_FALSE(frame.components);
+	}
+
+	// The breakdown switches the bus's profiling on from the next frame
+	counters.set_component_breakdown(true);
+	REQUIRE(wait_for([&] {
+		counters.collect(0, 0);
+		return counters.frame(counters.size() - 1).components;
+	}));
+	const PerfCounters::Frame &profiled = counters.frame(counters.size() - 1);
+	REQUIRE(profiled[PerfCounters::Counter::Ppu] > 0.0f);
+	REQUIRE(profiled[PerfCounters::Counter::Ppu] + profiled[PerfCounters::Counter::Apu] +
+				profiled[PerfCounters::Counter::Mapper] + profiled[PerfCounters::Counter::Cpu] <=
+			profiled[PerfCounters::Counter::Emulation] + 1e-3f);
+
+	nes.thread.stop();
+	REQUIRE(nes.system.bus().is_cycle_profiling());
+}
+
+TEST_CASE("Emulation Thread - Run-Ahead", "[core][threading]") {
+	ThreadedSystem nes(make_backdrop_counter_rom());
+	nes.thread.set_run_ahead(2);
+	nes.thread.run();
+	REQUIRE(wait_for([&] { return nes.thread.get_frames_emulated() >= 10; }));
+	nes.thread.pause();
+	REQUIRE(wait_for([&] { return nes.thread.is_idle(); }));
+	REQUIRE(nes.thread.update_frame());
+	const uint64_t frames = nes.thread.get_frames_emulated();
+
+	HeadlessSystem reference;
+	REQUIRE(reference.load_rom_data(make_backdrop_counter_rom()));
+	SaveStateManager reference_states(&reference.cpu(), &reference.ppu(), &reference.apu(), &reference.bus(),
+									  &reference.cartridge());
+	for (uint64_t i = 0; i < frames; ++i) {
+		reference.run_frame();
+	}
+
+	// The real timeline is exactly where it would be without run-ahead
+	const std::vector<uint8_t> expected = reference_states.serialize_state();
+	const std::vector<uint8_t> actual = nes.states.serialize_state();
+	REQUIRE(actual.size() == expected.size());
+	REQUIRE(std::equal(actual.begin() + sizeof(SaveStateHeader), actual.end(),
+					   expected.begin() + sizeof(SaveStateHeader)));
+
+	// ...while the reader was shown the frame two ahead of it
+	constexpr std::size_t PIXELS = EmulationThread::FRAME_WIDTH * EmulationThread::FRAME_HEIGHT;
+	const uint16_t *shown = nes.thread.get_frame_indices();
+	REQUIRE_FALSE(std::equal(shown, shown + PIXELS, reference.ppu().get_index_buffer()));
+	reference.run_frame();
+	reference.run_frame();
+	REQUIRE(std::equal(shown, shown + PIXELS, reference.ppu().get_index_buffer()));
+	REQUIRE(std::equal(nes.thread.get_frame(), nes.thread.get_frame() + PIXELS, reference.get_frame_buffer()));
+
+	nes.thread.stop();
+}
+
+TEST_CASE("Emulation Thread - Rewind", "[core][threading]") {
+	ThreadedSystem nes(make_backdrop_counter_rom());
+	RewindBuffer history(RewindBuffer::DEFAULT_BUDGET, 16);
+	nes.thread.exclusive([&] { nes.thread.set_rewind_buffer(&history); });
+	nes.thread.run();
+	REQUIRE(wait_for([&] { return nes.thread.get_frames_emulated() >= 90; }));
+	nes.thread.pause();
+	REQUIRE(wait_for([&] { return nes.thread.is_idle(); }));
+	const uint64_t frames = nes.thread.get_frames_emulated();
+	REQUIRE(history.frame_count() == frames);
+
+	// Step back a stretch while the thread runs
+	nes.thread.set_rewinding(true);
+	nes.thread.run();
+	const auto stored = [&] {
+		size_t count = 0;
+		nes.thread.exclusive([&] { count = history.frame_count(); });
+		return count;
+	};
+	REQUIRE(wait_for([&] { return stored() + 20 <= frames; }));
+	// A step exclusive() interrupted is retried; let a few run undisturbed
+	std::this_thread::sleep_for(100ms);
+	nes.thread.pause();
+	REQUIRE(wait_for([&] { return nes.thread.is_idle(); }));
+	REQUIRE(nes.thread.get_frames_emulated() == frames);
+	const size_t kept = history.frame_count();
+	REQUIRE(kept > 0);
+
+	// The state is the newest frame popped (frame kept + 1), and the reader
+	// was shown the frame after it
+	HeadlessSystem reference;
+	REQUIRE(reference.load_rom_data(make_backdrop_counter_rom()));
+	SaveStateManager reference_states(&reference.cpu(), &reference.ppu(), &reference.apu(), &reference.bus(),
+									  &reference.cartridge());
+	for (size_t i = 0; i < kept + 1; ++i) {
+		reference.run_frame();
+	}
+	const std::vector<uint8_t> expected = reference_states.serialize_state();
+	const std::vector<uint8_t> actual = nes.states.serialize_state();
+	REQUIRE(actual.size() == expected.size());
+	REQUIRE(std::equal(actual.begin() + sizeof(SaveStateHeader), actual.end(),
+					   expected.begin() + sizeof(SaveStateHeader)));
+
+	REQUIRE(nes.thread.update_frame());
+	reference.run_frame();
+	constexpr std::size_t PIXELS = EmulationThread::FRAME_WIDTH * EmulationThread::FRAME_HEIGHT;
+	REQUIRE(std::equal(nes.thread.get_frame_indices(), nes.thread.get_frame_indices() + PIXELS,
+					   reference.ppu().get_index_buffer()));
+
+	nes.thread.stop();
+}
+
+TEST_CASE("Emulation Thread - Audio Pacing", "[core][threading][audio]") {
+	ThreadedSystem nes;
+	// A quarter of the samples a 60 Hz clock would produce, so ~15 frames/s
+	nes.thread.exclusive([&] {
+		nes.system.bus().connect_audio_output(std::make_unique<DrainingAudioOutput>(44100.0 / 4.0));
+		nes.system.bus().start_audio();
+	});
+
+	auto frames_per_second = [&] {
+		const uint64_t start = nes.thread.get_frames_emulated();
+		std::this_thread::sleep_for(1000ms);
+		return nes.thread.get_frames_emulated() - start;
+	};
+
+	nes.thread.set_pacing(EmulationThread::Pacing::Audio);
+	nes.thread.run();
+	// The first few frames fill the buffer up to its target
+	REQUIRE(wait_for([&] { return nes.thread.get_frames_emulated() >= 6; }));
+	const uint64_t paced = frames_per_second();
+	REQUIRE(paced >= 8);
+	REQUIRE(paced <= 22);
+
+	// No stretching while the device paces emulation
+	bool rate_control = true;
+	nes.thread.exclusive([&] { rate_control = nes.system.apu().is_rate_control_enabled(); });
+	REQUIRE_FALSE(rate_control);
+
+	// Back on the clock: full speed, with rate control restored
+	nes.thread.set_pacing(EmulationThread::Pacing::Clock);
+	const uint64_t clocked = frames_per_second();
+	REQUIRE(clocked >= 40);
+	nes.thread.exclusive([&] { rate_control = nes.system.apu().is_rate_control_enabled(); });
+	REQUIRE(rate_control);
+
+	nes.thread.stop();
+	nes.system.bus().connect_audio_output(nullptr);
+}
+
+TEST_CASE("Emulation Thread - Host Pacing", "[core][threading]") {
+	ThreadedSystem nes;
+	nes.thread.set_pacing(EmulationThread::Pacing::Host);
+	nes.thread.run();
+
+	// Nothing runs until the front end asks
+	std::this_thread::sleep_for(100ms);
+	REQUIRE(nes.thread.get_frames_emulated() == 0);
+	REQUIRE_FALSE(nes.thread.wait_for_frames(1, std::chrono::steady_clock::now() + 50ms));
+
+	// Input posted before the request is what the frame sees
+	nes.input->set_buttons(0, 0x00);
+	nes.thread.set_buttons(0, 0x01);
+	nes.thread.request_frame();
+	REQUIRE(nes.thread.wait_for_frames(1, std::chrono::steady_clock::now() + 5s));
+	Byte echoed = 0;
+	nes.thread.exclusive([&] { echoed = nes.system.bus().peek(0x0000); });
+	REQUIRE((echoed & 0x01) == 0x01);
+
+	// One frame per request
+	for (int i = 0; i < 3; ++i) {
+		nes.thread.request_frame();
+	}
+	REQUIRE(nes.thread.wait_for_frames(4, std::chrono::steady_clock::now() + 5s));
+	std::this_thread::sleep_for(50ms);
+	REQUIRE(nes.thread.get_frames_emulated() == 4);
+
+	// Fast-forward does not wait for requests
+	nes.thread.set_fast_forward(true);
+	REQUIRE(wait_for([&] { return nes.thread.get_frames_emulated() >= 20; }));
+	nes.thread.set_fast_forward(false);
+
+	nes.thread.stop();
+}
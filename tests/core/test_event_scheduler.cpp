@@ -0,0 +1,131 @@
+// VibeNES - NES Emulator
+// Event Scheduler Tests
+// Deadline table on the master-clock timeline, and bus IRQ/DMA delivery driven
+// by it matching a bus that re-polls every source on every cycle
+
+#include "../../include/apu/apu.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/core/event_scheduler.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/memory/ram.hpp"
+#include <catch2/catch_all.hpp>
+#include <memory>
+
+using namespace nes;
+
+TEST_CASE("Event Scheduler - Deadlines", "[core][scheduler]") {
+	EventScheduler scheduler;
+	scheduler.schedule_all(EventScheduler::NEVER);
+
+	SECTION("Nothing scheduled") {
+		REQUIRE(scheduler.next_event() == EventScheduler::NEVER);
+	}
+
+	SECTION("Earliest deadline leads") {
+		scheduler.schedule(ScheduledEvent::Apu, 500);
+		scheduler.schedule(ScheduledEvent::PpuSync, 200);
+		scheduler.schedule(ScheduledEvent::MapperIrq, 300);
+		REQUIRE(scheduler.next_event() == 200);
+		REQUIRE(scheduler.is_due(ScheduledEvent::PpuSync, 200));
+		REQUIRE_FALSE(scheduler.is_due(ScheduledEvent::MapperIrq, 200));
+	}
+
+	SECTION("Moving or cancelling the leader promotes the next one") {
+		scheduler.schedule(ScheduledEvent::Apu, 500);
+		scheduler.schedule(ScheduledEvent::PpuSync, 200);
+		scheduler.schedule(ScheduledEvent::PpuSync, 800);
+		REQUIRE(scheduler.next_event() == 500);
+		scheduler.cancel(ScheduledEvent::Apu);
+		REQUIRE(scheduler.next_event() == 800);
+		scheduler.cancel(ScheduledEvent::PpuSync);
+		REQUIRE(scheduler.next_event() == EventScheduler::NEVER);
+	}
+
+	SECTION("Moving a trailing deadline keeps the leader") {
+		scheduler.schedule(ScheduledEvent::Apu, 100);
+		scheduler.schedule(ScheduledEvent::MapperIrq, 300);
+		scheduler.schedule(ScheduledEvent::MapperIrq, 900);
+		REQUIRE(scheduler.next_event() == 100);
+	}
+
+	SECTION("Clock ratios") {
+		REQUIRE(EventScheduler::CLOCKS_PER_CPU_CYCLE == 12);
+		REQUIRE(EventScheduler::CLOCKS_PER_PPU_DOT == 4);
+	}
+}
+
+namespace {
+
+// Bus + RAM + APU + CPU, with a sample in RAM for the DMC to fetch
+struct ApuRig {
+	std::shared_ptr<SystemBus> bus = std::make_shared<SystemBus>();
+	std::shared_ptr<Ram> ram = std::make_shared<Ram>();
+	std::shared_ptr<APU> apu = std::make_shared<APU>();
+	std::shared_ptr<CPU6502> cpu = std::make_shared<CPU6502>(bus.get());
+
+	ApuRig() {
+		bus->connect_ram(ram);
+		bus->connect_apu(apu);
+		bus->connect_cpu(cpu);
+		bus->power_on();
+	}
+
+	// One CPU cycle, servicing DMC DMA the way CPU6502::consume_cycle() does.
+	// Returns whether a DMA fetch happened.
+	bool cycle(bool poll_every_cycle) {
+		if (poll_every_cycle) {
+			bus->reschedule_events();
+		}
+		bus->tick_single_cpu_cycle();
+		if (!bus->is_dmc_dma_pending()) {
+			return false;
+		}
+		bus->service_dmc_dma();
+		return true;
+	}
+};
+
+} // namespace
+
+TEST_CASE("Event Scheduler - Bus Delivery Matches Polling", "[core][scheduler][bus]") {
+	ApuRig scheduled;
+	ApuRig polled;
+
+	auto write_both = [&](Address address, Byte value) {
+		scheduled.bus->write(address, value);
+		polled.bus->write(address, value);
+	};
+
+	// Frame IRQ on (4-step mode); DMC plays a short looping-off sample from
+	// $C000 with its IRQ enabled (reads land in open bus, which is fine)
+	write_both(0x4017, 0x00);
+	write_both(0x4010, 0x8F);
+	write_both(0x4012, 0x00);
+	write_both(0x4013, 0x01);
+	write_both(0x4015, 0x10);
+
+	REQUIRE(scheduled.bus->get_master_clock() == polled.bus->get_master_clock());
+
+	bool saw_irq = false;
+	bool saw_dma = false;
+	for (int cycle = 0; cycle < 3 * 29830; ++cycle) {
+		const bool scheduled_dma = scheduled.cycle(false);
+		const bool polled_dma = polled.cycle(true);
+
+		INFO("cycle " << cycle);
+		REQUIRE(scheduled.cpu->get_pending_interrupt() == polled.cpu->get_pending_interrupt());
+		REQUIRE(scheduled_dma == polled_dma);
+		saw_irq = saw_irq || polled.cpu->get_pending_interrupt() == InterruptType::IRQ;
+		saw_dma = saw_dma || polled_dma;
+
+		// Acknowledge now and then so the line also has to fall
+		if (cycle % 10000 == 5000) {
+			(void)scheduled.bus->read(0x4015);
+			(void)polled.bus->read(0x4015);
+			write_both(0x4015, 0x10); // Clears the DMC IRQ and restarts the sample
+		}
+	}
+	REQUIRE(saw_irq);
+	REQUIRE(saw_dma);
+	REQUIRE(scheduled.bus->get_master_clock() == 3 * 29830 * EventScheduler::CLOCKS_PER_CPU_CYCLE);
+}
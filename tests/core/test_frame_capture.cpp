@@ -0,0 +1,295 @@
+// VibeNES - NES Emulator
+// Frame Capture Tests
+// PNG encoding (decoded back here), the pooled PNG-sequence / raw-video writers
+// and the per-frame hashes behind golden traces
+
+#include "../../include/core/checksum.hpp"
+#include "../../include/system/frame_capture.hpp"
+#include "../../include/system/frame_dump.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+constexpr int WIDTH = FrameCapture::FRAME_WIDTH;
+constexpr int HEIGHT = FrameCapture::FRAME_HEIGHT;
+
+// A frame with flat areas, a gradient and some noise, like a game screen
+std::vector<std::uint32_t> test_frame(std::uint32_t seed) {
+	std::vector<std::uint32_t> pixels(WIDTH * HEIGHT);
+	std::uint32_t noise = seed * 2654435761u + 1;
+	for (int y = 0; y < HEIGHT; ++y) {
+		for (int x = 0; x < WIDTH; ++x) {
+			std::uint32_t color = 0xFF000000u | (y < 120 ? 0x00FC7C5Cu : static_cast<std::uint32_t>(x) << 8);
+			if (y >= 200) {
+				noise = noise * 1664525u + 1013904223u;
+				color = 0xFF000000u | (noise >> 8);
+			}
+			pixels[static_cast<std::size_t>(y) * WIDTH + x] = color;
+		}
+	}
+	return pixels;
+}
+
+std::uint32_t read_u32_be(const std::uint8_t *p) {
+	return (static_cast<std::uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+// Just enough inflate for what encode_frame_png emits: fixed-code blocks
+class FixedInflater {
+  public:
+	explicit FixedInflater(const std::vector<std::uint8_t> &data) : data_(data) {
+	}
+
+	bool inflate(std::vector<std::uint8_t> &out) {
+		for (bool final_block = false; !final_block;) {
+			final_block = bits(1) != 0;
+			if (bits(2) != 1) {
+				return false;
+			}
+			for (;;) {
+				const int symbol = literal_length();
+				if (symbol < 0 || symbol > 285) {
+					return false;
+				}
+				if (symbol < 256) {
+					out.push_back(static_cast<std::uint8_t>(symbol));
+					continue;
+				}
+				if (symbol == 256) {
+					break;
+				}
+				static constexpr int LENGTH_BASE[] = {3,  4,  5,  6,  7,  8,  9,  10,  11,	13,	 15,  17,  19,	23, 27,
+													  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+				static constexpr int LENGTH_EXTRA[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+													   2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+				static constexpr int DISTANCE_BASE[] = {1,	  2,	3,	  4,	5,	  7,	9,	   13,	  17,	 25,
+														33,	  49,	65,	  97,	129,  193,	257,   385,	  513,	 769,
+														1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+				static constexpr int DISTANCE_EXTRA[] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+														 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+				const int length = LENGTH_BASE[symbol - 257] + bits(LENGTH_EXTRA[symbol - 257]);
+				const int distance_code = code(5);
+				if (distance_code >= 30) {
+					return false;
+				}
+				const int distance = DISTANCE_BASE[distance_code] + bits(DISTANCE_EXTRA[distance_code]);
+				if (distance > static_cast<int>(out.size())) {
+					return false;
+				}
+				for (int i = 0; i < length; ++i) {
+					out.push_back(out[out.size() - distance]);
+				}
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] std::size_t byte_position() const {
+		return (bit_position_ + 7) / 8;
+	}
+
+  private:
+	const std::vector<std::uint8_t> &data_;
+	std::size_t bit_position_ = 0;
+
+	int bit() {
+		const std::size_t byte = bit_position_ / 8;
+		const int value = byte < data_.size() ? (data_[byte] >> (bit_position_ % 8)) & 1 : 0;
+		++bit_position_;
+		return value;
+	}
+	int bits(int count) {
+		int value = 0;
+		for (int i = 0; i < count; ++i) {
+			value |= bit() << i;
+		}
+		return value;
+	}
+	int code(int count) {
+		int value = 0;
+		for (int i = 0; i < count; ++i) {
+			value = (value << 1) | bit();
+		}
+		return value;
+	}
+	int literal_length() {
+		int value = code(7);
+		if (value <= 0x17) {
+			return 256 + value;
+		}
+		value = (value << 1) | bit();
+		if (value >= 0x30 && value <= 0xBF) {
+			return value - 0x30;
+		}
+		if (value >= 0xC0 && value <= 0xC7) {
+			return 280 + (value - 0xC0);
+		}
+		value = (value << 1) | bit();
+		return value >= 0x190 && value <= 0x1FF ? 144 + (value - 0x190) : -1;
+	}
+};
+
+// Decode a PNG written by encode_frame_png back to ABGR pixels
+bool decode_png(const std::vector<std::uint8_t> &png, std::vector<std::uint32_t> &pixels) {
+	static constexpr std::uint8_t SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	if (png.size() < 8 || !std::equal(std::begin(SIGNATURE), std::end(SIGNATURE), png.begin())) {
+		return false;
+	}
+	std::vector<std::uint8_t> zlib;
+	for (std::size_t at = 8; at + 12 <= png.size();) {
+		const std::uint32_t length = read_u32_be(&png[at]);
+		const std::string type(png.begin() + at + 4, png.begin() + at + 8);
+		if (read_u32_be(&png[at + 8 + length]) != crc32(&png[at + 4], length + 4)) {
+			return false;
+		}
+		if (type == "IHDR" && (read_u32_be(&png[at + 8]) != WIDTH || read_u32_be(&png[at + 12]) != HEIGHT ||
+							   png[at + 16] != 8 || png[at + 17] != 2)) {
+			return false;
+		}
+		if (type == "IDAT") {
+			zlib.insert(zlib.end(), png.begin() + at + 8, png.begin() + at + 8 + length);
+		}
+		at += 12 + length;
+	}
+	if (zlib.size() < 6 || zlib[0] != 0x78) {
+		return false;
+	}
+	const std::vector<std::uint8_t> deflate(zlib.begin() + 2, zlib.end());
+	FixedInflater inflater(deflate);
+	std::vector<std::uint8_t> raw;
+	if (!inflater.inflate(raw) || raw.size() != static_cast<std::size_t>(WIDTH * 3 + 1) * HEIGHT) {
+		return false;
+	}
+
+	pixels.assign(WIDTH * HEIGHT, 0);
+	std::vector<std::uint8_t> row(WIDTH * 3);
+	for (int y = 0; y < HEIGHT; ++y) {
+		const std::uint8_t *line = &raw[static_cast<std::size_t>(y) * (WIDTH * 3 + 1)];
+		if (line[0] != 1) {
+			return false;
+		}
+		for (int x = 0; x < WIDTH * 3; ++x) {
+			row[x] = static_cast<std::uint8_t>(line[1 + x] + (x >= 3 ? row[x - 3] : 0));
+		}
+		for (int x = 0; x < WIDTH; ++x) {
+			pixels[static_cast<std::size_t>(y) * WIDTH + x] =
+				0xFF000000u | row[x * 3] | (row[x * 3 + 1] << 8) | (row[x * 3 + 2] << 16);
+		}
+	}
+	return true;
+}
+
+std::vector<std::uint8_t> read_file(const std::filesystem::path &path) {
+	std::ifstream file(path, std::ios::binary);
+	return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+TEST_CASE("Frame Capture - PNG round trip", "[core][capture]") {
+	const std::vector<std::uint32_t> frame = test_frame(1);
+	const std::vector<std::uint8_t> png = encode_frame_png(frame.data());
+
+	std::vector<std::uint32_t> decoded;
+	REQUIRE(decode_png(png, decoded));
+	REQUIRE(decoded == frame);
+	// Flat areas compress: far below the 180 KB of raw RGB
+	REQUIRE(png.size() < 60'000);
+}
+
+TEST_CASE("Frame Capture - PNG sequence", "[core][capture]") {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "vibenes_test_capture_png";
+	std::filesystem::remove_all(dir);
+
+	FrameCapture capture;
+	FrameCapture::Options options;
+	options.when_full = FrameCapture::WhenFull::Wait;
+	options.pool_frames = 2;
+	options.workers = 3;
+	REQUIRE(capture.open(dir, FrameCapture::Format::PngSequence, options));
+	for (std::uint32_t i = 0; i < 6; ++i) {
+		REQUIRE(capture.submit(test_frame(i).data()));
+	}
+	REQUIRE(capture.close());
+	REQUIRE(capture.frames_written() == 6);
+	REQUIRE(capture.dropped_frames() == 0);
+
+	// Numbered in submit order whichever worker wrote them
+	for (std::uint32_t i = 0; i < 6; ++i) {
+		std::vector<std::uint32_t> decoded;
+		REQUIRE(decode_png(read_file(FrameCapture::sequence_path(dir, i)), decoded));
+		REQUIRE(decoded == test_frame(i));
+	}
+	std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Frame Capture - Raw video stream", "[core][capture]") {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "vibenes_test_capture.rgb";
+
+	FrameCapture capture;
+	FrameCapture::Options options;
+	options.when_full = FrameCapture::WhenFull::Wait;
+	options.pool_frames = 1;
+	REQUIRE(capture.open(path, FrameCapture::Format::RawVideo, options));
+	const std::vector<std::uint32_t> first = test_frame(7);
+	const std::vector<std::uint32_t> second = test_frame(8);
+	REQUIRE(capture.submit(first.data()));
+	REQUIRE(capture.submit(second.data()));
+	REQUIRE(capture.close());
+
+	const std::vector<std::uint8_t> video = read_file(path);
+	constexpr std::size_t FRAME_BYTES = static_cast<std::size_t>(WIDTH) * HEIGHT * 3;
+	REQUIRE(video.size() == 2 * FRAME_BYTES);
+	std::vector<std::uint8_t> expected(FRAME_BYTES);
+	pack_frame_rgb(second.data(), expected.data());
+	REQUIRE(std::equal(expected.begin(), expected.end(), video.begin() + FRAME_BYTES));
+	REQUIRE(video[0] == (first[0] & 0xFF));
+
+	REQUIRE_FALSE(capture.submit(first.data())); // Closed
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Frame Capture - Frame hashes", "[core][capture]") {
+	std::vector<std::uint16_t> indices(WIDTH * HEIGHT);
+	for (int y = 0; y < HEIGHT; ++y) {
+		for (int x = 0; x < WIDTH; ++x) {
+			indices[static_cast<std::size_t>(y) * WIDTH + x] = static_cast<std::uint16_t>(x < 128 ? 0x30 : 0x0F);
+		}
+	}
+	const FrameHashes hashes = hash_frame_indices(indices.data());
+	REQUIRE(hash_frame_indices(indices.data()) == hashes);
+
+	// One pixel: a different picture, but it looks the same
+	std::vector<std::uint16_t> touched = indices;
+	touched[1000] = 0x16;
+	const FrameHashes touched_hashes = hash_frame_indices(touched.data());
+	REQUIRE(touched_hashes.exact != hashes.exact);
+	REQUIRE(perceptual_distance(touched_hashes.perceptual, hashes.perceptual) <= 2);
+
+	// Swapping the halves moves every cell
+	std::vector<std::uint16_t> mirrored(indices.rbegin(), indices.rend());
+	REQUIRE(perceptual_distance(hash_frame_indices(mirrored.data()).perceptual, hashes.perceptual) >= 32);
+
+	// Emphasis bits change the colour, so the exact hash
+	std::vector<std::uint16_t> emphasized = indices;
+	for (std::uint16_t &index : emphasized) {
+		index |= 0x40;
+	}
+	REQUIRE(hash_frame_indices(emphasized.data()).exact != hashes.exact);
+
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "vibenes_test.hashes";
+	const std::vector<FrameHashes> trace = {hashes, touched_hashes, FrameHashes{}};
+	REQUIRE(write_frame_hash_trace(path.string(), trace));
+	std::vector<FrameHashes> loaded;
+	REQUIRE(read_frame_hash_trace(path.string(), loaded));
+	REQUIRE(loaded == trace);
+	std::filesystem::remove(path);
+	REQUIRE_FALSE(read_frame_hash_trace(path.string(), loaded));
+}
@@ -0,0 +1,159 @@
+// VibeNES - NES Emulator
+// Frame Delta Tests
+// Tile-delta encoding of index frames: round trips, delta sizes and bases
+
+#include "../../include/system/frame_delta.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+constexpr std::uint32_t NO_FRAME = FrameDeltaEncoder::NO_FRAME;
+
+// Background-like frame: 8x8 tiles from a small set, emphasis on some rows
+std::vector<std::uint16_t> make_frame(std::uint32_t seed) {
+	std::vector<std::uint16_t> frame(FrameDeltaEncoder::PIXELS);
+	for (int y = 0; y < FrameDeltaEncoder::HEIGHT; ++y) {
+		for (int x = 0; x < FrameDeltaEncoder::WIDTH; ++x) {
+			const std::uint32_t tile = ((x / 8) * 7 + (y / 8) * 3 + seed) % 5;
+			std::uint16_t color = static_cast<std::uint16_t>((tile * 9 + (x % 8) * (y % 8)) & 0x3F);
+			if (y >= 200) {
+				color |= 0x1C0; // Emphasis, bit 8 included
+			}
+			frame[static_cast<std::size_t>(y) * FrameDeltaEncoder::WIDTH + x] = color;
+		}
+	}
+	return frame;
+}
+
+std::uint32_t base_of(const std::vector<std::uint8_t> &encoded) {
+	std::uint32_t base;
+	std::memcpy(&base, encoded.data(), sizeof(base));
+	return base;
+}
+
+std::uint32_t raw_size_of(const std::vector<std::uint8_t> &encoded) {
+	std::uint32_t size;
+	std::memcpy(&size, encoded.data() + 4, sizeof(size));
+	return size;
+}
+
+bool same_frame(const std::uint16_t *decoded, const std::vector<std::uint16_t> &frame) {
+	return decoded && std::memcmp(decoded, frame.data(), frame.size() * sizeof(std::uint16_t)) == 0;
+}
+
+} // namespace
+
+TEST_CASE("Frame Delta - Round trips", "[core][frame_delta]") {
+	FrameDeltaEncoder encoder;
+	FrameDeltaDecoder decoder;
+	std::vector<std::uint8_t> encoded;
+	REQUIRE(decoder.frame() == nullptr);
+
+	SECTION("The first frame is a keyframe with every tile") {
+		const auto frame = make_frame(1);
+		REQUIRE(encoder.encode(0, frame.data(), NO_FRAME, encoded));
+		REQUIRE(base_of(encoded) == NO_FRAME);
+		REQUIRE(raw_size_of(encoded) == FrameDeltaEncoder::MAX_RAW_BYTES);
+		REQUIRE(encoded.size() < FrameDeltaEncoder::MAX_RAW_BYTES / 4);
+
+		REQUIRE(decoder.decode(0, encoded.data(), encoded.size()));
+		REQUIRE(decoder.latest() == 0);
+		REQUIRE(same_frame(decoder.frame(), frame));
+	}
+
+	SECTION("An unchanged frame sends no tiles") {
+		const auto frame = make_frame(1);
+		encoder.encode(0, frame.data(), NO_FRAME, encoded);
+		REQUIRE(decoder.decode(0, encoded.data(), encoded.size()));
+
+		REQUIRE_FALSE(encoder.encode(1, frame.data(), 0, encoded));
+		REQUIRE(base_of(encoded) == 0);
+		REQUIRE(raw_size_of(encoded) == FrameDeltaEncoder::BITMAP_BYTES);
+		REQUIRE(encoded.size() < 32);
+		REQUIRE(decoder.decode(1, encoded.data(), encoded.size()));
+		REQUIRE(same_frame(decoder.frame(), frame));
+	}
+
+	SECTION("Only the tiles that changed are sent") {
+		auto frame = make_frame(1);
+		encoder.encode(0, frame.data(), NO_FRAME, encoded);
+		REQUIRE(decoder.decode(0, encoded.data(), encoded.size()));
+
+		// One pixel in one tile and one emphasis bit in another
+		frame[100 * 256 + 37] ^= 0x15;
+		frame[220 * 256 + 200] &= 0xFF;
+		REQUIRE_FALSE(encoder.encode(1, frame.data(), 0, encoded));
+		REQUIRE(raw_size_of(encoded) == FrameDeltaEncoder::BITMAP_BYTES + 2 * FrameDeltaEncoder::TILE_BYTES);
+		REQUIRE(decoder.decode(1, encoded.data(), encoded.size()));
+		REQUIRE(same_frame(decoder.frame(), frame));
+	}
+}
+
+TEST_CASE("Frame Delta - Bases", "[core][frame_delta]") {
+	FrameDeltaEncoder encoder;
+	FrameDeltaDecoder decoder;
+	std::vector<std::uint8_t> encoded;
+
+	SECTION("A lost frame is skipped: the next delta is against the acknowledged one") {
+		const auto first = make_frame(1);
+		encoder.encode(0, first.data(), NO_FRAME, encoded);
+		REQUIRE(decoder.decode(0, encoded.data(), encoded.size()));
+
+		const auto lost = make_frame(2);
+		encoder.encode(1, lost.data(), 0, encoded); // Never arrives
+
+		const auto third = make_frame(3);
+		REQUIRE_FALSE(encoder.encode(2, third.data(), decoder.latest(), encoded));
+		REQUIRE(base_of(encoded) == 0);
+		REQUIRE(decoder.decode(2, encoded.data(), encoded.size()));
+		REQUIRE(same_frame(decoder.frame(), third));
+	}
+
+	SECTION("An acknowledgement older than the history gets a keyframe") {
+		const auto frame = make_frame(1);
+		for (std::uint32_t number = 0; number <= FrameDeltaEncoder::HISTORY; ++number) {
+			encoder.encode(number, frame.data(), NO_FRAME, encoded);
+		}
+		REQUIRE(encoder.encode(FrameDeltaEncoder::HISTORY + 1, frame.data(), 0, encoded));
+		// Frames 2 to HISTORY + 1 are still held
+		REQUIRE(encoder.encode(FrameDeltaEncoder::HISTORY + 2, frame.data(), 1, encoded));
+		REQUIRE_FALSE(encoder.encode(FrameDeltaEncoder::HISTORY + 3, frame.data(), 4, encoded));
+	}
+
+	SECTION("reset() forgets every base") {
+		const auto frame = make_frame(1);
+		encoder.encode(0, frame.data(), NO_FRAME, encoded);
+		encoder.reset();
+		REQUIRE(encoder.encode(1, frame.data(), 0, encoded));
+	}
+
+	SECTION("The decoder refuses what it cannot apply") {
+		const auto frame = make_frame(1);
+		encoder.encode(0, frame.data(), NO_FRAME, encoded);
+		const std::vector<std::uint8_t> keyframe = encoded;
+		encoder.encode(1, frame.data(), 0, encoded);
+
+		// A delta before its base
+		REQUIRE_FALSE(decoder.decode(1, encoded.data(), encoded.size()));
+		REQUIRE(decoder.latest() == NO_FRAME);
+
+		REQUIRE(decoder.decode(0, keyframe.data(), keyframe.size()));
+		// Not newer than the latest
+		REQUIRE_FALSE(decoder.decode(0, keyframe.data(), keyframe.size()));
+
+		// Truncated, or a keyframe without every tile
+		REQUIRE_FALSE(decoder.decode(1, encoded.data(), encoded.size() - 1));
+		std::vector<std::uint8_t> no_base = encoded;
+		std::memcpy(no_base.data(), &NO_FRAME, sizeof(NO_FRAME));
+		REQUIRE_FALSE(decoder.decode(1, no_base.data(), no_base.size()));
+
+		REQUIRE(decoder.latest() == 0);
+		REQUIRE(decoder.decode(1, encoded.data(), encoded.size()));
+		REQUIRE(same_frame(decoder.frame(), frame));
+	}
+}
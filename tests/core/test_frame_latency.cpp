@@ -0,0 +1,107 @@
+// VibeNES - NES Emulator
+// Frame Latency Tests
+// Histogram percentiles and the per-presentation intervals behind the latency report
+
+#include "../../include/system/frame_latency.hpp"
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+using namespace nes;
+
+namespace {
+
+using Metric = FrameLatency::Metric;
+using namespace std::chrono_literals;
+
+bool near(double value, double expected) {
+	return std::abs(value - expected) < 1e-6;
+}
+
+FrameLatency::Presentation presentation(FrameLatency::Clock::time_point swap) {
+	FrameLatency::Presentation frame;
+	frame.input_poll = swap - 30ms;
+	frame.frame_completed = swap - 12ms;
+	frame.upload_done = swap - 5ms;
+	frame.swap_done = swap;
+	return frame;
+}
+
+} // namespace
+
+TEST_CASE("Latency Histogram - Percentiles", "[core][latency]") {
+	LatencyHistogram histogram;
+	REQUIRE(histogram.count() == 0);
+	REQUIRE(histogram.percentile(0.5) == 0.0);
+	REQUIRE(histogram.mean() == 0.0);
+
+	// 90 samples at ~16.6 ms, 9 at ~33.3 ms and one 100 ms hitch
+	for (int i = 0; i < 90; ++i) {
+		histogram.record(16.65);
+	}
+	for (int i = 0; i < 9; ++i) {
+		histogram.record(33.35);
+	}
+	histogram.record(100.0);
+
+	REQUIRE(histogram.count() == 100);
+	REQUIRE(near(histogram.percentile(0.50), 16.7));
+	REQUIRE(near(histogram.percentile(0.95), 33.4));
+	REQUIRE(near(histogram.percentile(0.99), 33.4));
+	REQUIRE(near(histogram.percentile(1.00), 100.0));
+	REQUIRE(near(histogram.max(), 100.0));
+	REQUIRE(near(histogram.mean(), (90 * 16.65 + 9 * 33.35 + 100.0) / 100.0));
+
+	SECTION("Samples past the last bucket report the longest seen") {
+		histogram.record(900.0);
+		REQUIRE(histogram.bucket(LatencyHistogram::BUCKETS - 1) == 1);
+		REQUIRE(near(histogram.percentile(1.0), 900.0));
+	}
+
+	histogram.reset();
+	REQUIRE(histogram.count() == 0);
+	REQUIRE(histogram.max() == 0.0);
+}
+
+TEST_CASE("Frame Latency - Presentation intervals", "[core][latency]") {
+	FrameLatency latency;
+	const auto start = FrameLatency::Clock::now();
+
+	latency.record(presentation(start));
+	latency.record(presentation(start + 16ms));
+	latency.record(presentation(start + 40ms));
+
+	REQUIRE(latency.presentations() == 3);
+	// The first presentation has no previous swap to measure from
+	REQUIRE(latency.histogram(Metric::FrameTime).count() == 2);
+	REQUIRE(near(latency.histogram(Metric::FrameTime).max(), 24.0));
+	REQUIRE(near(latency.histogram(Metric::InputLatency).percentile(0.5), 30.0));
+	REQUIRE(near(latency.histogram(Metric::EmulationLatency).percentile(0.5), 12.0));
+	REQUIRE(near(latency.histogram(Metric::SwapWait).percentile(0.5), 5.0));
+
+	SECTION("Steps that were not stamped are left out") {
+		FrameLatency::Presentation partial;
+		partial.swap_done = start + 56ms;
+		latency.record(partial);
+		REQUIRE(latency.presentations() == 4);
+		REQUIRE(latency.histogram(Metric::FrameTime).count() == 3);
+		REQUIRE(latency.histogram(Metric::InputLatency).count() == 3);
+	}
+
+	SECTION("Report has one row per metric") {
+		std::ostringstream out;
+		latency.write_report(out);
+		const std::string report = out.str();
+		REQUIRE(report.starts_with("metric,count,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n"));
+		REQUIRE(report.find("frame_time,2,") != std::string::npos);
+		REQUIRE(report.find("input_latency,3,30.00,30.00,30.00,30.00,30.00") != std::string::npos);
+		REQUIRE(report.find("swap_wait,3,") != std::string::npos);
+	}
+
+	latency.reset();
+	REQUIRE(latency.presentations() == 0);
+	latency.record(presentation(start + 100ms));
+	REQUIRE(latency.histogram(Metric::FrameTime).count() == 0);
+}
@@ -0,0 +1,142 @@
+// VibeNES - NES Emulator
+// Late Input Scheduler Tests
+// Refresh measurement, the poll deadline in each mode, and frames owed per poll
+
+#include "../../include/system/late_input.hpp"
+#include <catch2/catch_all.hpp>
+#include <chrono>
+
+using namespace nes;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Mode = LateInputScheduler::Mode;
+using Clock = LateInputScheduler::Clock;
+
+// Swaps at a steady 60 Hz from `start`; returns the last one
+Clock::time_point swap_60hz(LateInputScheduler &scheduler, Clock::time_point start, int swaps) {
+	Clock::time_point swap = start;
+	for (int i = 0; i < swaps; ++i) {
+		swap = start + 16667us * i;
+		scheduler.on_swap(swap);
+	}
+	return swap;
+}
+
+} // namespace
+
+TEST_CASE("Late Input - Refresh period", "[core][late_input]") {
+	LateInputScheduler scheduler;
+	const Clock::time_point start = Clock::now();
+	REQUIRE(scheduler.refresh_period() == Clock::duration::zero());
+
+	Clock::time_point last = swap_60hz(scheduler, start, 30);
+	REQUIRE(scheduler.refresh_period() > 16500us);
+	REQUIRE(scheduler.refresh_period() < 16800us);
+
+	// A missed vsync (two periods) and a doubled swap leave it alone
+	scheduler.on_swap(last + 33333us);
+	scheduler.on_swap(last + 33400us);
+	REQUIRE(scheduler.refresh_period() > 16500us);
+	REQUIRE(scheduler.refresh_period() < 16800us);
+}
+
+TEST_CASE("Late Input - Poll deadline", "[core][late_input]") {
+	LateInputScheduler scheduler;
+	const Clock::time_point start = Clock::now();
+
+	SECTION("Off polls right after the swap") {
+		const Clock::time_point last = swap_60hz(scheduler, start, 10);
+		REQUIRE(scheduler.poll_time() == last);
+	}
+
+	SECTION("Nothing measured yet: right after the swap") {
+		scheduler.set_mode(Mode::Fixed);
+		scheduler.on_swap(start);
+		REQUIRE(scheduler.poll_time() == start);
+	}
+
+	SECTION("Fixed polls the lead before the next swap") {
+		scheduler.set_mode(Mode::Fixed);
+		scheduler.set_lead(4ms);
+		const Clock::time_point last = swap_60hz(scheduler, start, 10);
+		REQUIRE(scheduler.poll_time() == last + scheduler.refresh_period() - 4ms);
+	}
+
+	SECTION("Adaptive leaves room for the slowest recent frame") {
+		scheduler.set_mode(Mode::Adaptive);
+		scheduler.set_lead(1ms);
+		const Clock::time_point last = swap_60hz(scheduler, start, 10);
+		scheduler.record_cost(3ms);
+		scheduler.record_cost(6ms);
+		scheduler.record_cost(2ms);
+		REQUIRE(scheduler.cost() == 6ms);
+		REQUIRE(scheduler.poll_time() == last + scheduler.refresh_period() - 7ms);
+
+		// Slower than a refresh: poll at once
+		scheduler.record_cost(40ms);
+		REQUIRE(scheduler.poll_time() == last);
+
+		// The spike ages out of the window
+		for (std::size_t i = 0; i < LateInputScheduler::COST_WINDOW; ++i) {
+			scheduler.record_cost(3ms);
+		}
+		REQUIRE(scheduler.poll_time() == last + scheduler.refresh_period() - 4ms);
+	}
+
+	SECTION("Changing mode starts measuring again") {
+		scheduler.set_mode(Mode::Fixed);
+		swap_60hz(scheduler, start, 10);
+		scheduler.set_mode(Mode::Adaptive);
+		REQUIRE(scheduler.refresh_period() == Clock::duration::zero());
+	}
+}
+
+TEST_CASE("Late Input - Frames owed per poll", "[core][late_input]") {
+	LateInputScheduler scheduler;
+	const Clock::time_point start = Clock::now();
+	REQUIRE(scheduler.frames_due(start) == 0); // No frame period set
+
+	scheduler.set_frame_period(16639us); // NTSC
+	REQUIRE(scheduler.frames_due(start) == 1);
+
+	SECTION("A 60 Hz display gets a frame per refresh, and the odd second one") {
+		// 10 s of 60 Hz refreshes owe 601 NTSC frames
+		int frames = 0;
+		for (int poll = 1; poll <= 600; ++poll) {
+			const int due = scheduler.frames_due(start + 16667us * poll);
+			REQUIRE(due >= 1);
+			frames += due;
+		}
+		REQUIRE(frames >= 600);
+		REQUIRE(frames <= 602);
+	}
+
+	SECTION("Polls jittering around the refresh still get one frame each") {
+		for (int poll = 1; poll <= 120; ++poll) {
+			const auto jitter = poll % 2 ? 900us : -900us;
+			REQUIRE(scheduler.frames_due(start + 16639us * poll + jitter) == 1);
+		}
+	}
+
+	SECTION("A 144 Hz display skips polls") {
+		int frames = 0;
+		int empty = 0;
+		for (int poll = 1; poll <= 144; ++poll) {
+			const int due = scheduler.frames_due(start + 6944us * poll);
+			REQUIRE(due <= 1);
+			frames += due;
+			empty += due == 0;
+		}
+		REQUIRE(frames >= 59);
+		REQUIRE(frames <= 61);
+		REQUIRE(empty > 0);
+	}
+
+	SECTION("A stall is not caught up on") {
+		REQUIRE(scheduler.frames_due(start + 1s) == LateInputScheduler::MAX_FRAMES_PER_POLL);
+		REQUIRE(scheduler.frames_due(start + 1s + 16639us) <= 2);
+		REQUIRE(scheduler.frames_due(start + 1s + 2 * 16639us) == 1);
+	}
+}
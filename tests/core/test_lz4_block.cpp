@@ -0,0 +1,85 @@
+// VibeNES - NES Emulator
+// LZ4 Block Tests
+// Round trips, a hand-assembled block and rejection of malformed input
+
+#include "../../include/core/lz4_block.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+std::vector<std::uint8_t> round_trip(const std::vector<std::uint8_t> &data) {
+	std::vector<std::uint8_t> block;
+	lz4_compress(data.data(), data.size(), block);
+	REQUIRE(block.size() <= lz4_compress_bound(data.size()));
+	std::vector<std::uint8_t> out(data.size());
+	REQUIRE(lz4_decompress(block.data(), block.size(), out.data(), out.size()));
+	return out;
+}
+
+} // namespace
+
+TEST_CASE("LZ4 Block - Round trips", "[core][lz4]") {
+	SECTION("Empty and tiny inputs are all literals") {
+		for (std::size_t size = 0; size < 20; ++size) {
+			const std::vector<std::uint8_t> data(size, 0x42);
+			REQUIRE(round_trip(data) == data);
+		}
+	}
+
+	SECTION("Zeroed RAM shrinks to almost nothing") {
+		const std::vector<std::uint8_t> data(8192, 0x00);
+		std::vector<std::uint8_t> block;
+		lz4_compress(data.data(), data.size(), block);
+		REQUIRE(block.size() < 64);
+		REQUIRE(round_trip(data) == data);
+	}
+
+	SECTION("Mixed data with long literals and far matches") {
+		std::vector<std::uint8_t> data(100000);
+		std::uint32_t seed = 1;
+		for (std::size_t i = 0; i < data.size(); ++i) {
+			seed = seed * 1103515245 + 12345;
+			// Noise, then stretches repeating what came 300 or 40000 bytes before
+			const std::size_t phase = (i / 1000) % 3;
+			data[i] = phase == 0 || i < 40000 ? static_cast<std::uint8_t>(seed >> 16)
+											  : data[i - (phase == 1 ? 300 : 40000)];
+		}
+		REQUIRE(round_trip(data) == data);
+	}
+}
+
+TEST_CASE("LZ4 Block - Reads blocks from other encoders", "[core][lz4]") {
+	// "abcabcabcabcabcab" as 3 literals plus an overlapping match of 9, then 5 literals
+	const std::vector<std::uint8_t> block = {0x35, 'a', 'b', 'c', 0x03, 0x00, 0x50, 'a', 'b', 'c', 'a', 'b'};
+	const std::string expected = "abcabcabcabcabcab";
+	std::vector<std::uint8_t> out(expected.size());
+	REQUIRE(lz4_decompress(block.data(), block.size(), out.data(), out.size()));
+	REQUIRE(std::string(out.begin(), out.end()) == expected);
+}
+
+TEST_CASE("LZ4 Block - Malformed blocks are refused", "[core][lz4]") {
+	const std::vector<std::uint8_t> data(1000, 0x11);
+	std::vector<std::uint8_t> block;
+	lz4_compress(data.data(), data.size(), block);
+	std::vector<std::uint8_t> out(data.size());
+
+	// Wrong output size either way
+	REQUIRE_FALSE(lz4_decompress(block.data(), block.size(), out.data(), out.size() - 1));
+	std::vector<std::uint8_t> bigger(data.size() + 1);
+	REQUIRE_FALSE(lz4_decompress(block.data(), block.size(), bigger.data(), bigger.size()));
+
+	// Truncated anywhere
+	for (std::size_t size = 0; size < block.size(); ++size) {
+		REQUIRE_FALSE(lz4_decompress(block.data(), size, out.data(), out.size()));
+	}
+
+	// A match reaching back before the start
+	const std::vector<std::uint8_t> bad_offset = {0x10, 'a', 0x05, 0x00, 0x00};
+	std::vector<std::uint8_t> small(5);
+	REQUIRE_FALSE(lz4_decompress(bad_offset.data(), bad_offset.size(), small.data(), small.size()));
+}
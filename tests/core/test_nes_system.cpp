@@ -0,0 +1,193 @@
+// VibeNES - NES Emulator
+// NesSystem Tests
+// The single-owner console: wiring, and clones that continue where the original left off
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/system/frame_dump.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/nes_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <memory>
+
+using namespace nes;
+
+namespace {
+
+// Adds controller 1 into $12 every frame and shows it as the backdrop color
+RomData make_input_sum_rom() {
+	const std::array<uint8_t, 50> program = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xA9, 0x01,		  //       LDA #$01
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA2, 0x08,		  //       LDX #$08
+		0xAD, 0x16, 0x40, // $8011 LDA $4016
+		0x4A,			  //       LSR A
+		0x26, 0x10,		  //       ROL $10
+		0xCA,			  //       DEX
+		0xD0, 0xF7,		  //       BNE $8011
+		0xA5, 0x10,		  //       LDA $10
+		0x65, 0x12,		  //       ADC $12
+		0x85, 0x12,		  //       STA $12
+		0xA9, 0x3F,		  //       LDA #$3F
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA5, 0x12,		  //       LDA $12
+		0x8D, 0x07, 0x20, //       STA $2007
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+void run_frames(HeadlessSystem &system, LatchedInputSource &input, int frames, Byte buttons) {
+	for (int frame = 0; frame < frames; ++frame) {
+		input.set_buttons(0, static_cast<Byte>(buttons + frame));
+		system.run_frame();
+	}
+}
+
+} // namespace
+
+TEST_CASE("NesSystem - Components are wired to each other", "[core][nes_system]") {
+	NesSystem system;
+	system.bus().power_on();
+	REQUIRE(system.load_rom_data(make_input_sum_rom()));
+
+	// The bus reaches the cartridge and RAM members
+	REQUIRE(system.bus().peek(0x8000) == 0x2C);
+	REQUIRE(system.bus().peek(0xFFFD) == 0x80);
+	system.bus().write(0x0012, 0x5A);
+	REQUIRE(system.ram().get_memory()[0x12] == 0x5A);
+
+	// And the CPU runs the program until the PPU raises vblank
+	system.bus().set_ppu_catch_up(true);
+	system.cpu().run_frame(29781 * 2);
+	system.bus().sync_ppu();
+	REQUIRE(system.ppu().get_frame_count() >= 1);
+	REQUIRE(system.cpu().get_program_counter() >= 0x8000);
+}
+
+TEST_CASE("NesSystem - Clones continue identically and independently", "[core][nes_system]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem original(input);
+
+	SECTION("Nothing to clone without a ROM") {
+		REQUIRE(original.clone() == nullptr);
+	}
+
+	SECTION("Same inputs, same frames; the original is untouched by the clone") {
+		REQUIRE(original.load_rom_data(make_input_sum_rom()));
+		run_frames(original, *input, 20, 0x11);
+
+		auto clone_input = std::make_shared<LatchedInputSource>();
+		std::unique_ptr<HeadlessSystem> clone = original.clone(clone_input);
+		REQUIRE(clone != nullptr);
+		REQUIRE(clone->cartridge().get_rom_image() == original.cartridge().get_rom_image());
+		REQUIRE(clone->cpu().get_program_counter() == original.cpu().get_program_counter());
+
+		run_frames(original, *input, 30, 0x40);
+		run_frames(*clone, *clone_input, 30, 0x40);
+		REQUIRE(hash_frame_buffer(clone->get_frame_buffer()) == hash_frame_buffer(original.get_frame_buffer()));
+		REQUIRE(clone->ram().get_memory() == original.ram().get_memory());
+
+		// Different buttons from here on move only the clone
+		const Byte sum = original.ram().get_memory()[0x12];
+		run_frames(*clone, *clone_input, 5, 0x03);
+		REQUIRE(original.ram().get_memory()[0x12] == sum);
+		REQUIRE(clone->ram().get_memory()[0x12] != sum);
+	}
+}
+
+TEST_CASE("NesSystem - clone_into reuses its target", "[core][nes_system]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem original(input);
+	REQUIRE(original.load_rom_data(make_input_sum_rom()));
+	run_frames(original, *input, 10, 0x21);
+
+	auto target_input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem target(target_input);
+
+	SECTION("Nothing to copy without a ROM") {
+		REQUIRE_FALSE(target.clone_into(original));
+	}
+
+	SECTION("The first copy loads the shared ROM image, later ones only state") {
+		REQUIRE(original.clone_into(target));
+		REQUIRE(target.cartridge().get_rom_image() == original.cartridge().get_rom_image());
+		const std::uint32_t load_id = target.cartridge().get_load_id();
+
+		// Rollouts from the same position: diverge, then rewind by copying again
+		for (int rollout = 0; rollout < 3; ++rollout) {
+			REQUIRE(original.clone_into(target));
+			REQUIRE(target.cartridge().get_load_id() == load_id);
+			REQUIRE(target.ram().get_memory() == original.ram().get_memory());
+			REQUIRE(target.cpu().get_cycle_count() == original.cpu().get_cycle_count());
+			run_frames(target, *target_input, 4, static_cast<Byte>(0x10 * (rollout + 1)));
+			REQUIRE(target.ram().get_memory()[0x12] != original.ram().get_memory()[0x12]);
+		}
+
+		// Copying back and running both the same way stays in lockstep
+		REQUIRE(original.clone_into(target));
+		run_frames(original, *input, 6, 0x07);
+		run_frames(target, *target_input, 6, 0x07);
+		REQUIRE(hash_frame_buffer(target.get_frame_buffer()) == hash_frame_buffer(original.get_frame_buffer()));
+		REQUIRE(target.ram().get_memory() == original.ram().get_memory());
+	}
+}
+
+TEST_CASE("NesSystem - clone_into keeps cartridge RAM in step", "[core][nes_system]") {
+	// The same program on MMC1 with 8KB PRG-RAM and CHR-RAM
+	RomData rom = make_input_sum_rom();
+	rom.mapper_id = 1;
+	rom.chr_rom_pages = 0;
+	rom.chr_rom.clear();
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem original(input);
+	REQUIRE(original.load_rom_data(rom));
+	HeadlessSystem target;
+
+	const auto same_ram = [&] {
+		for (Address address = 0x6000; address < 0x8000; ++address) {
+			if (target.bus().peek(address) != original.bus().peek(address)) {
+				return false;
+			}
+		}
+		for (Address address = 0x0000; address < 0x2000; ++address) {
+			if (target.cartridge().ppu_read(address) != original.cartridge().ppu_read(address)) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	original.bus().write(0x6123, 0x11);
+	original.cartridge().ppu_write(0x0040, 0x22);
+	REQUIRE(original.clone_into(target));
+	REQUIRE(same_ram());
+
+	// Pages written on either side since the last copy are brought back in line
+	original.bus().write(0x7E00, 0x33);
+	original.cartridge().ppu_write(0x1FFF, 0x44);
+	target.bus().write(0x6123, 0x55);
+	target.bus().write(0x6800, 0x66);
+	target.cartridge().ppu_write(0x0900, 0x77);
+	REQUIRE(original.clone_into(target));
+	REQUIRE(same_ram());
+	REQUIRE(target.bus().peek(0x6123) == 0x11);
+	REQUIRE(target.bus().peek(0x7E00) == 0x33);
+
+	// And both keep running the same way
+	auto target_input = std::make_shared<LatchedInputSource>();
+	std::unique_ptr<HeadlessSystem> clone = original.clone(target_input);
+	run_frames(original, *input, 5, 0x09);
+	run_frames(*clone, *target_input, 5, 0x09);
+	REQUIRE(hash_frame_buffer(clone->get_frame_buffer()) == hash_frame_buffer(original.get_frame_buffer()));
+}
@@ -0,0 +1,126 @@
+// VibeNES - NES Emulator
+// Perf Counters Tests
+// Per-frame timing history: collection, the component breakdown, wrap-around and CSV export
+
+#include "../../include/system/perf_counters.hpp"
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+using Counter = PerfCounters::Counter;
+
+PerfCounters::FrameReport report(std::uint64_t emulation_ns, bool components = false) {
+	PerfCounters::FrameReport frame;
+	frame.emulation_ns = emulation_ns;
+	frame.cpu_cycles = 29781;
+	frame.audio_queue_ms = 40.0;
+	frame.components = components;
+	if (components) {
+		frame.ppu_ns = emulation_ns / 2;
+		frame.apu_ns = emulation_ns / 4;
+		frame.mapper_ns = emulation_ns / 8;
+	}
+	return frame;
+}
+
+std::vector<std::string> lines(const std::string &text) {
+	std::vector<std::string> out;
+	std::istringstream stream(text);
+	for (std::string line; std::getline(stream, line);) {
+		out.push_back(line);
+	}
+	return out;
+}
+
+} // namespace
+
+TEST_CASE("Perf Counters - Collection", "[core][perf]") {
+	PerfCounters counters;
+	REQUIRE(counters.size() == 0);
+	REQUIRE(counters.average(Counter::Emulation) == 0.0f);
+
+	counters.record_frame(report(2'000'000));
+	counters.record_frame(report(4'000'000, true));
+	counters.collect(500'000, 3'000'000);
+	REQUIRE(counters.size() == 2);
+
+	SECTION("Rows carry the frame and the presentation that collected it") {
+		const PerfCounters::Frame &plain = counters.frame(0);
+		REQUIRE(plain.index == 0);
+		REQUIRE(plain.cpu_cycles == 29781);
+		REQUIRE_FALSE(plain.components);
+		REQUIRE(plain[Counter::Emulation] == 2.0f);
+		REQUIRE(plain[Counter::Ppu] == 0.0f);
+		REQUIRE(plain[Counter::AudioQueue] == 40.0f);
+		REQUIRE(plain[Counter::TextureUpload] == 0.5f);
+		REQUIRE(plain[Counter::Gui] == 3.0f);
+	}
+
+	SECTION("The CPU gets what the components leave") {
+		const PerfCounters::Frame &profiled = counters.frame(1);
+		REQUIRE(profiled.index == 1);
+		REQUIRE(profiled.components);
+		REQUIRE(profiled[Counter::Ppu] == 2.0f);
+		REQUIRE(profiled[Counter::Apu] == 1.0f);
+		REQUIRE(profiled[Counter::Mapper] == 0.5f);
+		REQUIRE(profiled[Counter::Cpu] == 0.5f);
+	}
+
+	SECTION("Component averages skip frames measured without them") {
+		REQUIRE(counters.average(Counter::Emulation) == 3.0f);
+		REQUIRE(counters.average(Counter::Ppu) == 2.0f);
+		REQUIRE(counters.peak(Counter::Emulation) == 4.0f);
+	}
+
+	SECTION("Reset clears the history and anything queued") {
+		counters.record_frame(report(1'000'000));
+		counters.reset();
+		counters.collect(0, 0);
+		REQUIRE(counters.size() == 0);
+		counters.record_frame(report(1'000'000));
+		counters.collect(0, 0);
+		REQUIRE(counters.frame(0).index == 0);
+	}
+}
+
+TEST_CASE("Perf Counters - History wraps", "[core][perf]") {
+	PerfCounters counters;
+	const std::size_t total = PerfCounters::HISTORY + 37;
+	for (std::size_t i = 0; i < total; ++i) {
+		counters.record_frame(report((i + 1) * 1000));
+		if (i % 100 == 99) {
+			counters.collect(0, 0); // Before the report queue fills
+		}
+	}
+	counters.collect(0, 0);
+	REQUIRE(counters.size() == PerfCounters::HISTORY);
+	// Oldest first, contiguous, ending at the newest
+	REQUIRE(counters.frame(PerfCounters::HISTORY - 1).index == total - 1);
+	for (std::size_t i = 1; i < counters.size(); ++i) {
+		REQUIRE(counters.frame(i).index == counters.frame(i - 1).index + 1);
+		REQUIRE(counters.frame(i)[Counter::Emulation] > counters.frame(i - 1)[Counter::Emulation]);
+	}
+}
+
+TEST_CASE("Perf Counters - CSV export", "[core][perf]") {
+	PerfCounters counters;
+	counters.record_frame(report(2'000'000));
+	counters.record_frame(report(4'000'000, true));
+	counters.collect(250'000, 1'000'000);
+
+	std::ostringstream csv;
+	counters.write_csv(csv);
+	const std::vector<std::string> rows = lines(csv.str());
+	REQUIRE(rows.size() == 3);
+	REQUIRE(rows[0] == "frame,cpu_cycles,emulation_ms,cpu_ms,ppu_ms,apu_ms,mapper_ms,audio_queue_ms,"
+					   "texture_upload_ms,gui_ms");
+	// Unmeasured breakdown columns stay empty rather than reading as zero
+	REQUIRE(rows[1] == "0,29781,2.0000,,,,,40.0000,0.2500,1.0000");
+	REQUIRE(rows[2] == "1,29781,4.0000,0.5000,2.0000,1.0000,0.5000,40.0000,0.2500,1.0000");
+}
@@ -0,0 +1,118 @@
+// VibeNES - NES Emulator
+// PPU Catch-up Synchronization Tests
+// Lazy (catch-up) PPU sync must be indistinguishable from 3-dots-per-cycle lockstep
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using namespace nes;
+
+// MMC3 test cart: enables NMI + rendering (sprites from $1000 so A12 clocks
+// the scanline counter), arms an 8-line IRQ, then spins. The NMI handler
+// reads $2002 and rewrites scroll; the IRQ handler acknowledges and re-arms.
+static RomData build_catch_up_rom() {
+	const std::vector<Byte> code = {
+		0x78,			  // E000: SEI
+		0xA2, 0xFF,		  // E001: LDX #$FF
+		0x9A,			  // E003: TXS
+		0xA9, 0x88,		  // E004: LDA #$88 (NMI on, sprites at $1000)
+		0x8D, 0x00, 0x20, // E006: STA $2000
+		0xA9, 0x1E,		  // E009: LDA #$1E (BG + sprites, no clipping)
+		0x8D, 0x01, 0x20, // E00B: STA $2001
+		0xA9, 0x08,		  // E00E: LDA #$08
+		0x8D, 0x00, 0xC0, // E010: STA $C000 (IRQ latch)
+		0x8D, 0x01, 0xC0, // E013: STA $C001 (reload)
+		0x8D, 0x01, 0xE0, // E016: STA $E001 (IRQ enable)
+		0x58,			  // E019: CLI
+		0xE6, 0x00,		  // E01A: INC $00
+		0x4C, 0x1A, 0xE0, // E01C: JMP $E01A
+		0xE6, 0x01,		  // E01F: NMI: INC $01
+		0xAD, 0x02, 0x20, // E021: LDA $2002
+		0xA5, 0x01,		  // E024: LDA $01
+		0x8D, 0x05, 0x20, // E026: STA $2005
+		0x8D, 0x05, 0x20, // E029: STA $2005
+		0x40,			  // E02C: RTI
+		0xE6, 0x02,		  // E02D: IRQ: INC $02
+		0x8D, 0x00, 0xE0, // E02F: STA $E000 (acknowledge)
+		0x8D, 0x01, 0xE0, // E032: STA $E001 (re-enable)
+		0x40,			  // E035: RTI
+	};
+	std::vector<Byte> chr(8192);
+	for (std::size_t i = 0; i < chr.size(); ++i) {
+		chr[i] = static_cast<Byte>((i * 37) & 0xFF);
+	}
+	RomData rom = test::make_nrom(code, {.nmi = 0xE01F, .reset = 0xE000, .irq = 0xE02D}, std::move(chr));
+	rom.mapper_id = 4; // 32KB: $E000-$FFFF is the fixed last 8KB bank
+	return rom;
+}
+
+TEST_CASE("PPU Catch-up Matches Lockstep", "[ppu][bus][catch-up]") {
+	HeadlessSystem lazy;
+	HeadlessSystem lockstep;
+	lockstep.bus().set_ppu_catch_up(false);
+
+	REQUIRE(lazy.bus().is_ppu_catch_up());
+	REQUIRE(lazy.load_rom_data(build_catch_up_rom()));
+	REQUIRE(lockstep.load_rom_data(build_catch_up_rom()));
+
+	SECTION("Frame-by-frame state is identical") {
+		for (int frame = 0; frame < 6; ++frame) {
+			const auto lazy_cycles = lazy.run_frame();
+			const auto lockstep_cycles = lockstep.run_frame();
+			REQUIRE(lazy_cycles == lockstep_cycles);
+			REQUIRE(lazy.ppu().get_current_scanline() == lockstep.ppu().get_current_scanline());
+			REQUIRE(lazy.ppu().get_current_cycle() == lockstep.ppu().get_current_cycle());
+			REQUIRE(lazy.cpu().get_program_counter() == lockstep.cpu().get_program_counter());
+		}
+
+		REQUIRE(lazy.get_frame_count() == lockstep.get_frame_count());
+		REQUIRE(std::memcmp(lazy.get_frame_buffer(), lockstep.get_frame_buffer(), 256 * 240 * sizeof(uint32_t)) == 0);
+
+		for (Address addr = 0x0000; addr <= 0x0002; ++addr) {
+			REQUIRE(lazy.bus().peek(addr) == lockstep.bus().peek(addr));
+		}
+		// Both interrupt paths were exercised
+		REQUIRE(lazy.bus().peek(0x0001) > 0);
+		REQUIRE(lazy.bus().peek(0x0002) > 0);
+	}
+
+	SECTION("Odd cycle budgets stay in sync") {
+		// Stop at arbitrary points mid-scanline; run_cycles syncs on return
+		for (std::uint64_t budget : {1u, 7u, 113u, 2273u, 29781u, 5000u}) {
+			REQUIRE(lazy.run_cycles(budget) == lockstep.run_cycles(budget));
+			REQUIRE(lazy.ppu().get_current_scanline() == lockstep.ppu().get_current_scanline());
+			REQUIRE(lazy.ppu().get_current_cycle() == lockstep.ppu().get_current_cycle());
+			REQUIRE(lazy.ppu().get_status_register() == lockstep.ppu().get_status_register());
+		}
+	}
+}
+
+TEST_CASE("PPU Catch-up Deadlines", "[ppu][catch-up]") {
+	PPU ppu;
+	ppu.power_on();
+
+	SECTION("Deadline never overshoots the VBlank tick") {
+		// From power-on (0,0) the VBlank-setting tick is 241*341 dots away
+		const uint32_t dots = ppu.dots_until_sync_point();
+		REQUIRE(dots >= 1);
+		REQUIRE(dots <= 241u * 341u + 1u);
+		ppu.tick_dots(static_cast<int>(dots));
+		REQUIRE(ppu.get_current_scanline() <= 241);
+	}
+
+	SECTION("Deadline is always at least one dot") {
+		for (int i = 0; i < 89342 * 2; i += 97) {
+			REQUIRE(ppu.dots_until_sync_point() >= 1);
+			ppu.tick_dots(97);
+		}
+	}
+}
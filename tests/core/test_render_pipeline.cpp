@@ -0,0 +1,188 @@
+// VibeNES - NES Emulator
+// Render Pipeline Tests
+// Frames drawn on a second thread from the bus's log against the PPU's own
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/render_pipeline.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// CNROM with noise for CHR. Every frame the NMI handler moves sprite 0, runs
+// OAM DMA, reads $2007, switches the CHR bank and resets the scroll; the main
+// loop waits for sprite-0 hit and scrolls the rest of the screen by $10.
+RomData make_split_rom() {
+	const std::uint8_t reset[] = {
+		0x78,			  // $8000 SEI
+		0xA2, 0xFF,		  //       LDX #$FF
+		0x9A,			  //       TXS
+		0x2C, 0x02, 0x20, // vb1   BIT $2002
+		0x10, 0xFB,		  //       BPL vb1
+		0x2C, 0x02, 0x20, // vb2   BIT $2002
+		0x10, 0xFB,		  //       BPL vb2
+		0xA9, 0x20,		  //       LDA #$20
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA0, 0x04,		  //       LDY #$04
+		0xA2, 0x00,		  //       LDX #$00
+		0x8E, 0x07, 0x20, // nt    STX $2007
+		0xE8,			  //       INX
+		0xD0, 0xFA,		  //       BNE nt
+		0x88,			  //       DEY
+		0xD0, 0xF7,		  //       BNE nt
+		0xA9, 0x3F,		  //       LDA #$3F
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA2, 0x00,		  //       LDX #$00
+		0x8A,			  // pal   TXA
+		0x8D, 0x07, 0x20, //       STA $2007
+		0xE8,			  //       INX
+		0xE0, 0x20,		  //       CPX #$20
+		0xD0, 0xF7,		  //       BNE pal
+		0xA2, 0x00,		  //       LDX #$00
+		0x8A,			  // spr   TXA
+		0x9D, 0x00, 0x02, //       STA $0200,X
+		0xE8,			  //       INX
+		0xD0, 0xF9,		  //       BNE spr
+		0xA9, 0x64,		  //       LDA #$64
+		0x8D, 0x00, 0x02, //       STA $0200 (sprite 0 on line 100)
+		0xA9, 0x80,		  //       LDA #$80
+		0x8D, 0x00, 0x20, //       STA $2000
+		0xA9, 0x1E,		  //       LDA #$1E
+		0x8D, 0x01, 0x20, //       STA $2001
+		0x2C, 0x02, 0x20, // loop  BIT $2002
+		0x70, 0xFB,		  //       BVS loop
+		0x2C, 0x02, 0x20, // hit   BIT $2002
+		0x50, 0xFB,		  //       BVC hit
+		0xA5, 0x10,		  //       LDA $10
+		0x8D, 0x05, 0x20, //       STA $2005
+		0x8D, 0x05, 0x20, //       STA $2005
+		0x4C, 0x52, 0x80, //       JMP loop
+	};
+	const std::uint8_t nmi[] = {
+		0x48,			  // $8100 PHA
+		0x8A,			  //       TXA
+		0x48,			  //       PHA
+		0xE6, 0x10,		  //       INC $10
+		0xEE, 0x03, 0x02, //       INC $0203
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x03, 0x20, //       STA $2003
+		0xA9, 0x02,		  //       LDA #$02
+		0x8D, 0x14, 0x40, //       STA $4014
+		0xA9, 0x20,		  //       LDA #$20
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xAD, 0x07, 0x20, //       LDA $2007
+		0xA5, 0x10,		  //       LDA $10
+		0x29, 0x01,		  //       AND #$01
+		0xAA,			  //       TAX
+		0xBD, 0xF0, 0xFF, //       LDA $FFF0,X
+		0x9D, 0xF0, 0xFF, //       STA $FFF0,X (CHR bank, no bus conflict)
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x05, 0x20, //       STA $2005
+		0x8D, 0x05, 0x20, //       STA $2005
+		0xA9, 0x80,		  //       LDA #$80
+		0x8D, 0x00, 0x20, //       STA $2000
+		0x68,			  //       PLA
+		0xAA,			  //       TAX
+		0x68,			  //       PLA
+		0x40,			  //       RTI
+	};
+	std::vector<std::uint8_t> chr(16384);
+	std::uint32_t seed = 0x2C02;
+	for (std::uint8_t &byte : chr) {
+		seed = seed * 1103515245u + 12345u;
+		byte = static_cast<std::uint8_t>(seed >> 16);
+	}
+	RomData rom = test::make_nrom(reset, {.nmi = 0x8100}, std::move(chr));
+	rom.mapper_id = 3;
+	std::copy(std::begin(nmi), std::end(nmi), rom.prg_rom.begin() + 0x100);
+	rom.prg_rom[0x7FF0] = 0x00; // CHR bank numbers
+	rom.prg_rom[0x7FF1] = 0x01;
+	return rom;
+}
+
+bool same_frame(HeadlessSystem &a, HeadlessSystem &b) {
+	return std::memcmp(a.get_frame_buffer(), b.get_frame_buffer(), 256 * 240 * sizeof(std::uint32_t)) == 0;
+}
+
+} // namespace
+
+TEST_CASE("Render Pipeline - Pipelined frames match the PPU drawing them itself", "[core][render_pipeline]") {
+	const RomData rom = make_split_rom();
+	HeadlessSystem direct;
+	HeadlessSystem pipelined;
+	REQUIRE(direct.load_rom_data(rom));
+	REQUIRE(pipelined.load_rom_data(rom));
+	pipelined.set_pipelined_rendering(true);
+	REQUIRE(pipelined.is_pipelined_rendering());
+
+	std::vector<std::uint32_t> previous(256 * 240);
+	int changes = 0;
+	for (int frame = 0; frame < 20; ++frame) {
+		direct.run_frame();
+		pipelined.run_frame();
+		// One run behind until synced
+		const RenderPipeline &pipeline = *pipelined.render_pipeline();
+		if (frame > 2) {
+			REQUIRE(pipeline.frame_count() + 1 == pipelined.get_frame_count());
+		}
+		pipelined.sync_rendering();
+		REQUIRE(pipelined.cpu().get_cycle_count() == direct.cpu().get_cycle_count());
+		if (frame < 2) {
+			continue; // The first frame drawn whole comes after seeding
+		}
+		REQUIRE(pipeline.frame_count() == pipelined.get_frame_count());
+		REQUIRE(same_frame(direct, pipelined));
+		changes += std::memcmp(previous.data(), direct.get_frame_buffer(), previous.size() * 4) != 0 ? 1 : 0;
+		std::memcpy(previous.data(), direct.get_frame_buffer(), previous.size() * 4);
+	}
+	REQUIRE(changes >= 10); // Scroll, sprites and banks really moved
+
+	const RenderPipeline::Stats &stats = pipelined.render_pipeline()->stats();
+	REQUIRE(stats.reseeds == 1);
+	REQUIRE(stats.divergences == 0);
+	REQUIRE(stats.entries > 0);
+}
+
+TEST_CASE("Render Pipeline - A reset reseeds the worker's copy", "[core][render_pipeline]") {
+	const RomData rom = make_split_rom();
+	HeadlessSystem direct;
+	HeadlessSystem pipelined;
+	REQUIRE(direct.load_rom_data(rom));
+	REQUIRE(pipelined.load_rom_data(rom));
+	pipelined.set_pipelined_rendering(true);
+	for (int frame = 0; frame < 5; ++frame) {
+		direct.run_frame();
+		pipelined.run_frame();
+	}
+	direct.reset();
+	pipelined.reset();
+	for (int frame = 0; frame < 6; ++frame) {
+		direct.run_frame();
+		pipelined.run_frame();
+	}
+	pipelined.sync_rendering();
+	REQUIRE(same_frame(direct, pipelined));
+	REQUIRE(pipelined.render_pipeline()->stats().reseeds == 2);
+	REQUIRE(pipelined.render_pipeline()->stats().divergences == 0);
+
+	// Turned off, the PPU draws its own frames again
+	pipelined.set_pipelined_rendering(false);
+	direct.run_frame();
+	pipelined.run_frame();
+	direct.run_frame();
+	pipelined.run_frame();
+	REQUIRE(same_frame(direct, pipelined));
+}
@@ -0,0 +1,181 @@
+// VibeNES - NES Emulator
+// Rollback Session Tests
+// Two peers over a simulated laggy link: predictions, rollbacks and
+// re-simulation must leave both exactly where a local two-player run is
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/rollback_session.hpp"
+#include "../../include/system/save_state.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// Reads both pads every frame and folds them into RAM and the backdrop
+// color, so state and picture depend on every frame's input
+RomData make_two_player_rom() {
+	const std::array<uint8_t, 58> program = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xA9, 0x01,		  //       LDA #$01
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA2, 0x08,		  //       LDX #$08
+		0xAD, 0x16, 0x40, // $8011 LDA $4016
+		0x4A,			  //       LSR A
+		0x26, 0x10,		  //       ROL $10
+		0xAD, 0x17, 0x40, //       LDA $4017
+		0x4A,			  //       LSR A
+		0x26, 0x11,		  //       ROL $11
+		0xCA,			  //       DEX
+		0xD0, 0xF1,		  //       BNE $8011
+		0xA5, 0x10,		  //       LDA $10
+		0x65, 0x11,		  //       ADC $11
+		0x65, 0x12,		  //       ADC $12
+		0x85, 0x12,		  //       STA $12
+		0xA9, 0x3F,		  //       LDA #$3F
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA5, 0x12,		  //       LDA $12
+		0x8D, 0x07, 0x20, //       STA $2007
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+constexpr std::uint64_t FRAMES = 240;
+// The last frames press nothing, so frames past the end predict correctly
+constexpr std::uint64_t QUIET_FRAMES = 20;
+
+Byte scripted_buttons(int player, std::uint64_t frame) {
+	if (frame >= FRAMES - QUIET_FRAMES) {
+		return 0;
+	}
+	return player == 0 ? static_cast<Byte>((frame / 5) * 0x35) : static_cast<Byte>((frame / 11) * 0x1B);
+}
+
+struct Peer {
+	std::shared_ptr<LatchedInputSource> input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system{input};
+	std::unique_ptr<RollbackSession> session;
+
+	explicit Peer(int player) {
+		REQUIRE(system.load_rom_data(make_two_player_rom()));
+		session = std::make_unique<RollbackSession>(system, input, player);
+	}
+};
+
+struct Packet {
+	std::uint64_t deliver_at;
+	std::uint64_t frame;
+	Byte buttons;
+};
+
+std::vector<uint8_t> state_of(HeadlessSystem &system) {
+	SaveStateManager states(&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge());
+	std::vector<uint8_t> bytes = states.serialize_state();
+	bytes.erase(bytes.begin(), bytes.begin() + sizeof(SaveStateHeader));
+	return bytes;
+}
+
+} // namespace
+
+TEST_CASE("Rollback Session - Peers Match A Local Run", "[core][rollback]") {
+	std::array<Peer, 2> peers{Peer(0), Peer(1)};
+	std::array<std::deque<Packet>, 2> inbox; // Packets on their way to each peer
+	std::uint64_t tick = 0;
+
+	// Jittery latency of 2-6 ticks, so packets also arrive out of order
+	while (peers[0].session->get_frame() <= FRAMES || peers[1].session->get_frame() <= FRAMES) {
+		for (int p = 0; p < 2; ++p) {
+			Peer &peer = peers[p];
+			std::erase_if(inbox[p], [&](const Packet &packet) {
+				if (packet.deliver_at > tick) {
+					return false;
+				}
+				peer.session->add_remote_input(packet.frame, packet.buttons);
+				return true;
+			});
+			const std::uint64_t frame = peer.session->get_frame();
+			if (frame <= FRAMES && peer.session->can_advance()) {
+				const Byte buttons = scripted_buttons(p, frame);
+				REQUIRE(peer.session->advance_frame(buttons));
+				inbox[1 - p].push_back({tick + 2 + (frame * 7 + p) % 5, frame, buttons});
+			}
+		}
+		++tick;
+		REQUIRE(tick < FRAMES * 4);
+	}
+
+	for (Peer &peer : peers) {
+		REQUIRE(peer.session->get_rollback_count() > 0);
+		REQUIRE(peer.session->get_resimulated_frames() <=
+				peer.session->get_rollback_count() * RollbackSession::MAX_ROLLBACK_FRAMES);
+	}
+
+	// Both ran FRAMES + 1 frames; every input that mattered was confirmed
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem reference(input);
+	REQUIRE(reference.load_rom_data(make_two_player_rom()));
+	for (std::uint64_t frame = 0; frame <= FRAMES; ++frame) {
+		input->set_buttons(0, scripted_buttons(0, frame));
+		input->set_buttons(1, scripted_buttons(1, frame));
+		reference.run_frame();
+	}
+	const std::vector<uint8_t> expected = state_of(reference);
+	constexpr std::size_t PIXELS = 256 * 240;
+	for (Peer &peer : peers) {
+		REQUIRE(state_of(peer.system) == expected);
+		REQUIRE(std::equal(reference.get_frame_buffer(), reference.get_frame_buffer() + PIXELS,
+						   peer.system.get_frame_buffer()));
+	}
+}
+
+TEST_CASE("Rollback Session - Late Input Rolls Back", "[core][rollback]") {
+	Peer peer(0);
+	RollbackSession &session = *peer.session;
+	// The remote player is predicted to hold nothing...
+	for (int frame = 0; frame < 5; ++frame) {
+		REQUIRE(session.advance_frame(0x01));
+	}
+	REQUIRE(session.get_confirmed_frame() == 0);
+
+	// ...a matching input changes nothing, a contradicting one re-runs from it
+	REQUIRE(session.add_remote_input(0, 0x00));
+	REQUIRE(session.add_remote_input(1, 0x80));
+	REQUIRE(session.get_confirmed_frame() == 2);
+	REQUIRE(session.advance_frame(0x01));
+	REQUIRE(session.get_rollback_count() == 1);
+	REQUIRE(session.get_resimulated_frames() == 4);
+
+	// Already confirmed or impossibly far ahead
+	REQUIRE_FALSE(session.add_remote_input(0, 0x00));
+	REQUIRE_FALSE(session.add_remote_input(session.get_frame() + RollbackSession::MAX_ROLLBACK_FRAMES + 1, 0x00));
+}
+
+TEST_CASE("Rollback Session - Stalls Ahead Of A Silent Peer", "[core][rollback]") {
+	Peer peer(1);
+	RollbackSession &session = *peer.session;
+	for (int frame = 0; frame < RollbackSession::MAX_ROLLBACK_FRAMES; ++frame) {
+		REQUIRE(session.advance_frame(0x00));
+	}
+	REQUIRE_FALSE(session.can_advance());
+	REQUIRE_FALSE(session.advance_frame(0x00));
+	REQUIRE(session.get_frame() == RollbackSession::MAX_ROLLBACK_FRAMES);
+
+	REQUIRE(session.add_remote_input(0, 0x00));
+	REQUIRE(session.can_advance());
+	REQUIRE(session.advance_frame(0x00));
+}
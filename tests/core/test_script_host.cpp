@@ -0,0 +1,122 @@
+// VibeNES - NES Emulator
+// Script Host Tests
+// Frame and memory hooks, bulk reads and input injection
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/script_host.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace nes;
+
+// NROM cart that reads controller 1 into $0300 forever and copies each
+// complete read to $0301 (A ends up in bit 7)
+static RomData build_input_rom() {
+	const Byte code[] = {
+		0xA9, 0x01,		  // 8000: LDA #$01
+		0x8D, 0x16, 0x40, // 8002: STA $4016
+		0xA9, 0x00,		  // 8005: LDA #$00
+		0x8D, 0x16, 0x40, // 8007: STA $4016
+		0xA2, 0x08,		  // 800A: LDX #$08
+		0xAD, 0x16, 0x40, // 800C: LDA $4016
+		0x4A,			  // 800F: LSR A
+		0x2E, 0x00, 0x03, // 8010: ROL $0300
+		0xCA,			  // 8013: DEX
+		0xD0, 0xF6,		  // 8014: BNE $800C
+		0xAD, 0x00, 0x03, // 8016: LDA $0300
+		0x8D, 0x01, 0x03, // 8019: STA $0301
+		0x4C, 0x00, 0x80, // 801C: JMP $8000
+	};
+	return test::make_nrom(code);
+}
+
+TEST_CASE("Script Host - Frame hooks and input", "[script][system]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system(input);
+	REQUIRE(system.load_rom_data(build_input_rom()));
+	ScriptHost host(system, input);
+
+	// A bot that presses A on every other frame and records what the game saw
+	std::vector<Byte> seen;
+	host.on_frame([&](ScriptHost &script) {
+		std::array<Byte, 1> ram{};
+		script.read_memory(0x0301, ram);
+		seen.push_back(ram[0]);
+		script.set_buttons(0, script.get_frame_count() % 2 ? 0x01 : 0x00);
+	});
+
+	for (int i = 0; i < 6; ++i) {
+		REQUIRE(host.run_frame() > 0);
+	}
+	REQUIRE(seen.size() == 6);
+	for (std::size_t i = 1; i < seen.size(); ++i) {
+		REQUIRE(seen[i] == (seen[i - 1] == 0x80 ? 0x00 : 0x80)); // Alternates with the injected presses
+	}
+
+	SECTION("Removed hooks stop running") {
+		host.clear();
+		host.run_frame();
+		REQUIRE(seen.size() == 6);
+	}
+
+	SECTION("Hooks can remove themselves") {
+		int id = 0;
+		int calls = 0;
+		id = host.on_frame([&](ScriptHost &script) {
+			++calls;
+			script.remove(id);
+		});
+		host.run_frame();
+		host.run_frame();
+		REQUIRE(calls == 1);
+		REQUIRE(seen.size() == 8); // The first hook kept running
+	}
+}
+
+TEST_CASE("Script Host - Memory hooks", "[script][system][breakpoints]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system(input);
+	REQUIRE(system.load_rom_data(build_input_rom()));
+	input->set_buttons(0, 0x01);
+
+	int writes = 0;
+	int presses = 0;
+	int reads = 0;
+	{
+		ScriptHost host(system, input);
+		REQUIRE(host.on_write(0x0301, 0x0301, [&](Address address, Byte) {
+			REQUIRE(address == 0x0301);
+			++writes;
+		}) > 0);
+		REQUIRE(host.on_write(0x0301, 0x0301, [&](Address, Byte value) { presses += value == 0x80; }, "value == $80") >
+				0);
+		REQUIRE(host.on_read(0x4016, 0x4016, [&](Address, Byte) { ++reads; }) > 0);
+
+		std::string error;
+		REQUIRE(host.on_write(0x0300, 0x0300, [](Address, Byte) {}, "value ==", &error) == 0);
+		REQUIRE_FALSE(error.empty());
+
+		REQUIRE(host.run_frame() > 0);
+		REQUIRE(writes > 0);
+		REQUIRE(presses > 0);
+		REQUIRE(presses == writes); // A was held all frame
+		REQUIRE(reads >= 8 * writes); // Eight controller reads per copy, plus a partial loop
+		REQUIRE(reads < 8 * (writes + 1));
+		REQUIRE(system.bus().breakpoints().is_watching());
+	}
+
+	// Hooks never stop runs, and the host unregisters them when it goes away
+	REQUIRE(system.bus().breakpoints().entries().empty());
+	REQUIRE_FALSE(system.bus().breakpoints().is_armed());
+	Breakpoints &breakpoints = system.bus().breakpoints();
+	REQUIRE(breakpoints.add_hook(Breakpoints::EXECUTE, 0x8000, 0x8000, [](const BreakpointHit &) {}) == 0);
+	REQUIRE(breakpoints.add_hook(Breakpoints::CPU_WRITE, 0x0300, 0x0300, {}) == 0);
+}
@@ -0,0 +1,135 @@
+// VibeNES - NES Emulator
+// Shared Memory Env Tests
+// A trainer stepping the emulator through a shared-memory region
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/shared_env.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace nes;
+
+namespace {
+
+// Stores the controller 1 byte read each frame at $10 and counts frames at $11
+RomData make_input_rom() {
+	const std::uint8_t program[] = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xE6, 0x11,		  //       INC $11
+		0xA9, 0x01,		  //       LDA #$01
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA2, 0x08,		  //       LDX #$08
+		0xAD, 0x16, 0x40, // loop  LDA $4016
+		0x4A,			  //       LSR A
+		0x26, 0x10,		  //       ROL $10
+		0xCA,			  //       DEX
+		0xD0, 0xF7,		  //       BNE loop
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+std::string unique_name() {
+#if defined(_WIN32)
+	return "vibenes_test_env_" + std::to_string(_getpid());
+#else
+	return "vibenes_test_env_" + std::to_string(getpid());
+#endif
+}
+
+// Serves env on a thread until Quit; a failed REQUIRE still stops it
+class Server {
+  public:
+	Server(SharedMemoryEnv &env, std::string name) : name_(std::move(name)), thread_([&env] { env.serve(); }) {
+	}
+	~Server() {
+		stop();
+	}
+	void stop() {
+		if (thread_.joinable()) {
+			SharedMemoryEnvClient client;
+			if (client.open(name_)) {
+				client.quit();
+			}
+			thread_.join();
+		}
+	}
+
+  private:
+	std::string name_;
+	std::thread thread_;
+};
+
+} // namespace
+
+TEST_CASE("Shared Env - A trainer steps, resets and stops the emulator", "[core][shared_env]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system(input);
+	REQUIRE(system.load_rom_data(make_input_rom()));
+	const std::string name = unique_name();
+
+	SharedMemoryEnv env(system, input);
+	REQUIRE(env.create(name));
+	// The PPU renders straight into the region
+	REQUIRE(system.ppu().get_index_buffer() == env.region()->frame);
+
+	Server server(env, name);
+
+	SharedMemoryEnvClient client;
+	REQUIRE(client.open(name));
+	const SharedEnvRegion &region = client.region();
+	REQUIRE(std::memcmp(region.magic, SharedEnvRegion::MAGIC, sizeof(region.magic)) == 0);
+	REQUIRE(region.size == sizeof(SharedEnvRegion));
+
+	REQUIRE(client.step(5, {0x81, 0, 0, 0}));
+	REQUIRE(region.frame_count == system.get_frame_count());
+	REQUIRE(region.frame_count >= 5);
+	REQUIRE(region.cpu_cycles > 0);
+	REQUIRE(region.status == 0);
+	REQUIRE(region.ram[0x10] == 0x81);
+	const std::uint8_t frames_seen = region.ram[0x11];
+	REQUIRE(frames_seen >= 4);
+
+	REQUIRE(client.step(2, {0x18, 0, 0, 0}));
+	REQUIRE(region.ram[0x10] == 0x18);
+	REQUIRE(static_cast<std::uint8_t>(region.ram[0x11] - frames_seen) == 2);
+
+	REQUIRE(client.reset());
+	REQUIRE(region.status == 0);
+
+	server.stop();
+}
+
+TEST_CASE("Shared Env - A step with nobody serving times out", "[core][shared_env]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system(input);
+	REQUIRE(system.load_rom_data(make_input_rom()));
+	const std::string name = unique_name() + "_idle";
+
+	SharedMemoryEnv env(system, input);
+	REQUIRE(env.create(name));
+	SharedMemoryEnvClient client;
+	REQUIRE(client.open(name));
+	REQUIRE_FALSE(client.step(1, {0, 0, 0, 0}, std::chrono::milliseconds(20)));
+
+	// The emulator picks the command up once it serves again
+	REQUIRE(env.serve_one(std::chrono::milliseconds(100)) == SharedMemoryEnv::Served::Command);
+	REQUIRE(env.serve_one(std::chrono::milliseconds(1)) == SharedMemoryEnv::Served::Idle);
+}
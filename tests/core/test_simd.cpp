@@ -0,0 +1,180 @@
+// VibeNES - NES Emulator
+// SIMD Dispatch Tests
+// Every level the CPU supports computes what the scalar kernels compute
+
+#include "../../include/core/simd.hpp"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+constexpr std::array<SimdLevel, 6> ALL_LEVELS = {SimdLevel::Scalar, SimdLevel::SSE2,   SimdLevel::SSE42,
+												 SimdLevel::AVX2,	SimdLevel::AVX512, SimdLevel::NEON};
+
+// Pins a level for one test and puts the previous one back afterwards
+class LevelScope {
+  public:
+	explicit LevelScope(SimdLevel level) : previous_(simd_level()) {
+		REQUIRE(set_simd_level(level));
+	}
+	~LevelScope() {
+		set_simd_level(previous_);
+	}
+	LevelScope(const LevelScope &) = delete;
+	LevelScope &operator=(const LevelScope &) = delete;
+
+  private:
+	SimdLevel previous_;
+};
+
+} // namespace
+
+TEST_CASE("SIMD - Level selection", "[core][simd]") {
+	REQUIRE(is_simd_level_supported(SimdLevel::Scalar));
+	REQUIRE(is_simd_level_supported(best_simd_level()));
+	REQUIRE(parse_simd_level("auto") == best_simd_level());
+	REQUIRE(parse_simd_level("sse42") == SimdLevel::SSE42);
+	REQUIRE_FALSE(parse_simd_level("mmx").has_value());
+	for (SimdLevel level : ALL_LEVELS) {
+		REQUIRE(parse_simd_level(simd_level_name(level)) == level);
+	}
+
+	const SimdLevel before = simd_level();
+	for (SimdLevel level : ALL_LEVELS) {
+		if (!is_simd_level_supported(level)) {
+			REQUIRE_FALSE(set_simd_level(level));
+			REQUIRE(simd_level() == before);
+		}
+	}
+}
+
+TEST_CASE("SIMD - Kernels match the scalar results", "[core][simd]") {
+	std::mt19937 rng(0x5EED);
+
+	std::vector<std::uint32_t> lut(512);
+	for (std::uint32_t &color : lut) {
+		color = rng();
+	}
+	// 256 pixels as the PPU resolves them, plus odd counts for the tails
+	std::vector<std::uint16_t> indices(256 + 13);
+	for (std::uint16_t &index : indices) {
+		index = static_cast<std::uint16_t>(rng()); // High bits must be masked off
+	}
+	std::array<std::uint8_t, 64> y_positions{};
+	for (std::uint8_t &y : y_positions) {
+		y = static_cast<std::uint8_t>(rng());
+	}
+	y_positions[0] = 0;
+	y_positions[63] = 0xFF;
+	std::vector<float> window(32);
+	std::vector<float> taps(32);
+	for (std::size_t i = 0; i < window.size(); ++i) {
+		window[i] = static_cast<float>(rng() % 2001) / 1000.0f - 1.0f;
+		taps[i] = static_cast<float>(rng() % 2001) / 1000.0f - 1.0f;
+	}
+
+	SimdKernels scalar{};
+	{
+		LevelScope scope(SimdLevel::Scalar);
+		scalar = simd_kernels();
+	}
+	std::vector<std::uint32_t> expected(indices.size());
+	scalar.palette_lookup(indices.data(), lut.data(), expected.data(), indices.size());
+	const float scalar_dot = scalar.dot_product(window.data(), taps.data(), window.size());
+
+	std::optional<float> vector_dot;
+	for (SimdLevel level : ALL_LEVELS) {
+		if (!is_simd_level_supported(level)) {
+			continue;
+		}
+		INFO("level " << simd_level_name(level));
+		LevelScope scope(level);
+		const SimdKernels &kernels = simd_kernels();
+
+		for (std::size_t count : {std::size_t{256}, indices.size(), std::size_t{7}}) {
+			std::vector<std::uint32_t> out(count);
+			kernels.palette_lookup(indices.data(), lut.data(), out.data(), count);
+			REQUIRE(std::equal(out.begin(), out.end(), expected.begin()));
+		}
+
+		for (std::uint8_t height : {std::uint8_t{8}, std::uint8_t{16}}) {
+			for (int line = 0; line < 256; ++line) {
+				const auto l = static_cast<std::uint8_t>(line);
+				REQUIRE(kernels.sprites_in_range(y_positions.data(), l, height) ==
+						scalar.sprites_in_range(y_positions.data(), l, height));
+			}
+		}
+
+		// The vector levels add the same lanes in the same order
+		const float dot = kernels.dot_product(window.data(), taps.data(), window.size());
+		REQUIRE(std::abs(dot - scalar_dot) < 1e-4f);
+		if (level != SimdLevel::Scalar) {
+			if (vector_dot) {
+				REQUIRE(dot == *vector_dot);
+			}
+			vector_dot = dot;
+		}
+	}
+}
+
+TEST_CASE("SIMD - Pixel multiplexer", "[core][simd]") {
+	SimdKernels scalar{};
+	{
+		LevelScope scope(SimdLevel::Scalar);
+		scalar = simd_kernels();
+	}
+	// Front sprite, sprite behind opaque and transparent background, no
+	// sprite, then sprite 0 over background
+	const std::array<std::uint8_t, 5> bg = {0x05, 0x06, 0x00, 0x07, 0x09};
+	const std::array<std::uint8_t, 5> sprite = {0x11, 0x32, 0x33, 0x00, 0x55};
+	std::array<std::uint8_t, 5> out{};
+	REQUIRE(scalar.multiplex_pixels(bg.data(), sprite.data(), out.data(), out.size()) == 4);
+	REQUIRE(out == std::array<std::uint8_t, 5>{0x11, 0x06, 0x13, 0x07, 0x15});
+
+	// Random lines with sprite 0 colliding at a chosen x (or nowhere), for
+	// every vector width's loop and tail
+	std::mt19937 rng(0x2C02);
+	const std::size_t length = 256 + 13;
+	for (std::size_t collision : {std::size_t{0}, std::size_t{15}, std::size_t{16}, std::size_t{63}, std::size_t{200},
+								  std::size_t{260}, length}) {
+		std::vector<std::uint8_t> layer_bg(length);
+		std::vector<std::uint8_t> layer_sprite(length);
+		for (std::size_t i = 0; i < length; ++i) {
+			layer_bg[i] = (rng() % 3 == 0) ? 0 : static_cast<std::uint8_t>(rng() % 16);
+			layer_sprite[i] = (rng() % 2 == 0) ? 0 : static_cast<std::uint8_t>(0x11 + rng() % 15 + (rng() & 0x20));
+			// Sprite 0 only where the background is transparent, before the collision
+			if (i < collision && layer_bg[i] == 0 && layer_sprite[i] != 0) {
+				layer_sprite[i] |= 0x40;
+			}
+		}
+		if (collision < length) {
+			layer_bg[collision] = 0x03;
+			layer_sprite[collision] = 0x51;
+		}
+		std::vector<std::uint8_t> expected(length);
+		REQUIRE(scalar.multiplex_pixels(layer_bg.data(), layer_sprite.data(), expected.data(), length) == collision);
+
+		for (SimdLevel level : ALL_LEVELS) {
+			if (!is_simd_level_supported(level)) {
+				continue;
+			}
+			INFO("level " << simd_level_name(level) << ", collision " << collision);
+			LevelScope scope(level);
+			for (std::size_t count : {std::size_t{256}, length, std::size_t{7}}) {
+				std::vector<std::uint8_t> pixels(count);
+				const std::size_t hit =
+					simd_kernels().multiplex_pixels(layer_bg.data(), layer_sprite.data(), pixels.data(), count);
+				REQUIRE(hit == std::min(collision, count));
+				REQUIRE(std::equal(pixels.begin(), pixels.end(), expected.begin()));
+			}
+		}
+	}
+}
@@ -0,0 +1,242 @@
+// VibeNES - NES Emulator
+// State Sync Tests
+// Save states streamed between cabinets as a base and per-section deltas
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/save_state.hpp"
+#include "../../include/system/state_sync.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// The remote store: a map, counting what is read from it
+class MemoryStore final : public StateStore {
+  public:
+	bool put(const std::string &key, std::span<const std::uint8_t> bytes) override {
+		objects[key].assign(bytes.begin(), bytes.end());
+		return true;
+	}
+	std::optional<std::vector<std::uint8_t>> get(const std::string &key) override {
+		const auto found = objects.find(key);
+		if (found == objects.end()) {
+			return std::nullopt;
+		}
+		bytes_read += found->second.size();
+		return found->second;
+	}
+	bool remove(const std::string &key) override {
+		return objects.erase(key) != 0;
+	}
+
+	std::map<std::string, std::vector<std::uint8_t>> objects;
+	std::size_t bytes_read = 0;
+};
+
+// Counts a frame counter in RAM, so every frame changes the bus section
+RomData make_counter_rom() {
+	const std::uint8_t program[] = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xE6, 0x10,		  //       INC $10
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+struct Cabinet {
+	HeadlessSystem system;
+	SaveStateManager states{&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge()};
+
+	Cabinet() {
+		REQUIRE(system.load_rom_data(make_counter_rom()));
+	}
+	std::vector<std::uint8_t> state() {
+		return states.serialize_state();
+	}
+	// Everything but the header (whose timestamp differs)
+	std::vector<std::uint8_t> sections() {
+		SaveStateManager raw(&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge());
+		std::vector<std::uint8_t> bytes = raw.serialize_state();
+		bytes.erase(bytes.begin(), bytes.begin() + sizeof(SaveStateHeader));
+		return bytes;
+	}
+	void run(int frames) {
+		for (int i = 0; i < frames; ++i) {
+			system.run_frame();
+		}
+	}
+};
+
+} // namespace
+
+TEST_CASE("State Sync - Uploads a base, then deltas", "[core][state_sync]") {
+	MemoryStore remote;
+	StateSync sync(remote);
+	Cabinet cabinet;
+	const std::string key = StateSync::key_for("player1", cabinet.states.calculate_rom_crc32());
+
+	cabinet.run(10);
+	REQUIRE(sync.upload(key, cabinet.state()).get());
+	const std::uint64_t base_sent = sync.stats().bytes_sent;
+	REQUIRE(sync.stats().bases_sent == 1);
+
+	cabinet.run(1);
+	REQUIRE(sync.upload(key, cabinet.state()).get());
+	REQUIRE(sync.stats().deltas_sent == 1);
+	REQUIRE(sync.stats().bytes_sent - base_sent < base_sent / 4);
+	REQUIRE(remote.objects.contains(key + "/delta-1-1"));
+
+	// A cap on deltas starts a new generation and drops the old objects
+	sync.set_max_deltas(1);
+	cabinet.run(1);
+	REQUIRE(sync.upload(key, cabinet.state()).get());
+	REQUIRE(sync.stats().bases_sent == 2);
+	REQUIRE(remote.objects.contains(key + "/base-2"));
+	REQUIRE_FALSE(remote.objects.contains(key + "/base-1"));
+	REQUIRE_FALSE(remote.objects.contains(key + "/delta-1-1"));
+}
+
+TEST_CASE("State Sync - Another cabinet resumes the latest state", "[core][state_sync]") {
+	MemoryStore remote;
+	Cabinet first;
+	Cabinet second;
+	const std::string key = StateSync::key_for("player1", first.states.calculate_rom_crc32());
+	{
+		StateSync sync(remote);
+		first.run(10);
+		REQUIRE(sync.upload(key, first.state()).get());
+		for (int i = 0; i < 3; ++i) {
+			first.run(7);
+			REQUIRE(sync.upload(key, first.state()).get());
+		}
+	}
+
+	StateSync sync(remote);
+	REQUIRE_FALSE(sync.take("nobody/00000000"));
+	sync.prefetch(key);
+	const auto state = sync.take(key);
+	REQUIRE(state);
+	REQUIRE(second.states.deserialize_state(*state));
+	REQUIRE(second.sections() == first.sections());
+
+	// And carries on from there with deltas
+	second.run(5);
+	REQUIRE(sync.upload(key, second.state()).get());
+	REQUIRE(sync.stats().deltas_sent == 1);
+	REQUIRE(sync.stats().bases_sent == 0);
+}
+
+TEST_CASE("State Sync - A cached base downloads only the new deltas", "[core][state_sync]") {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "vibenes_state_sync";
+	std::filesystem::remove_all(directory);
+	MemoryStore remote;
+	Cabinet player;
+	const std::string key = StateSync::key_for("player1", player.states.calculate_rom_crc32());
+	StateSync uploader(remote);
+	player.run(10);
+	REQUIRE(uploader.upload(key, player.state()).get());
+
+	DirectoryStateStore cache(directory);
+	{
+		StateSync earlier_session(remote, &cache);
+		REQUIRE(earlier_session.take(key));
+	}
+	player.run(3);
+	REQUIRE(uploader.upload(key, player.state()).get());
+	const std::size_t base_size = remote.objects[key + "/base-1"].size();
+
+	remote.bytes_read = 0;
+	StateSync sync(remote, &cache);
+	Cabinet resumed;
+	const auto state = sync.take(key);
+	REQUIRE(state);
+	REQUIRE(remote.bytes_read < base_size / 4);
+	REQUIRE(resumed.states.deserialize_state(*state));
+	REQUIRE(resumed.sections() == player.sections());
+	std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("State Sync - Section sizes no block could decode to are refused", "[core][state_sync]") {
+	MemoryStore remote;
+	Cabinet player;
+	const std::string key = StateSync::key_for("player1", player.states.calculate_rom_crc32());
+	player.run(10);
+
+	SECTION("In a remote base") {
+		StateSync uploader(remote);
+		REQUIRE(uploader.upload(key, player.state()).get());
+		// [magic][generation][sequence][header size][header][count][tag] then the first size
+		std::vector<std::uint8_t> &base = remote.objects[key + "/base-1"];
+		const std::size_t size_at = 16 + sizeof(SaveStateHeader) + 8;
+		REQUIRE(base.size() > size_at + 4);
+		const std::uint32_t huge = 0xFFFFFFFF;
+		std::memcpy(base.data() + size_at, &huge, sizeof(huge));
+
+		StateSync sync(remote);
+		REQUIRE_FALSE(sync.take(key));
+	}
+
+	SECTION("In a state being uploaded") {
+		std::vector<std::uint8_t> state = player.state();
+		SaveStateChunk chunk;
+		std::memcpy(&chunk, state.data() + sizeof(SaveStateHeader), sizeof(chunk));
+		chunk.size = 0xFFFFFFFF;
+		std::memcpy(state.data() + sizeof(SaveStateHeader), &chunk, sizeof(chunk));
+
+		StateSync sync(remote);
+		REQUIRE_FALSE(sync.upload(key, state).get());
+		REQUIRE(remote.objects.empty());
+	}
+}
+
+TEST_CASE("State Sync - Objects without a whole version 3 header are refused", "[core][state_sync]") {
+	MemoryStore remote;
+	Cabinet player;
+	const std::string key = StateSync::key_for("player1", player.states.calculate_rom_crc32());
+	player.run(10);
+	{
+		StateSync uploader(remote);
+		REQUIRE(uploader.upload(key, player.state()).get());
+		player.run(3);
+		REQUIRE(uploader.upload(key, player.state()).get());
+	}
+	REQUIRE(remote.objects.contains(key + "/delta-1-1"));
+
+	// [magic][generation][sequence][header size][header][count]
+	const auto object = [](const char *magic, std::uint32_t sequence, std::span<const std::uint8_t> header) {
+		const std::uint32_t words[3] = {1, sequence, static_cast<std::uint32_t>(header.size())};
+		std::vector<std::uint8_t> bytes(4 + sizeof(words) + header.size() + 4, 0x00);
+		std::memcpy(bytes.data(), magic, 4);
+		std::memcpy(bytes.data() + 4, words, sizeof(words));
+		std::memcpy(bytes.data() + 4 + sizeof(words), header.data(), header.size());
+		return bytes;
+	};
+	const std::uint8_t short_header[4] = {'V', 'I', 'B', 'E'};
+	SaveStateHeader version_2;
+	version_2.version = 2;
+	const auto *version_2_bytes = reinterpret_cast<const std::uint8_t *>(&version_2);
+
+	SECTION("A base with a short header") {
+		remote.objects[key + "/base-1"] = object("VNSB", 0, short_header);
+	}
+	SECTION("A base with a version 2 header") {
+		remote.objects[key + "/base-1"] = object("VNSB", 0, {version_2_bytes, sizeof(version_2)});
+	}
+	SECTION("A delta with a short header") {
+		remote.objects[key + "/delta-1-1"] = object("VNSD", 1, short_header);
+	}
+
+	StateSync sync(remote);
+	REQUIRE_FALSE(sync.take(key));
+}
@@ -0,0 +1,216 @@
+// VibeNES - NES Emulator
+// Stream Server Tests
+// Players on the loopback interface sending input and decoding the frames
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/memory/ram.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/stream_server.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+using namespace nes;
+
+namespace {
+
+// Stores the controller 1 byte read each frame at $10, counts frames at $11
+// and shows the count as the backdrop color
+RomData make_input_rom() {
+	const std::uint8_t program[] = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xE6, 0x11,		  //       INC $11
+		0xA9, 0x3F,		  //       LDA #$3F
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA5, 0x11,		  //       LDA $11
+		0x29, 0x3F,		  //       AND #$3F
+		0x8D, 0x07, 0x20, //       STA $2007
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x01,		  //       LDA #$01
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA2, 0x08,		  //       LDX #$08
+		0xAD, 0x16, 0x40, // loop  LDA $4016
+		0x4A,			  //       LSR A
+		0x26, 0x10,		  //       ROL $10
+		0xCA,			  //       DEX
+		0xD0, 0xF7,		  //       BNE loop
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+struct StreamedSystem {
+	StreamedSystem() : input(std::make_shared<LatchedInputSource>()), system(input) {
+		REQUIRE(system.load_rom_data(make_input_rom()));
+	}
+	std::shared_ptr<LatchedInputSource> input;
+	HeadlessSystem system;
+};
+
+// Controller input that holds up the frame it is read in once stall is set,
+// as a descheduled worker would be
+class StallingInput final : public InputSource {
+  public:
+	[[nodiscard]] Byte read_buttons(int) const override {
+		if (stall.exchange(false)) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(300));
+		}
+		return 0;
+	}
+	mutable std::atomic<bool> stall{false};
+};
+
+// Play until the client has decoded frames frames, holding buttons
+void play(StreamClient &client, std::uint8_t buttons, int frames) {
+	int decoded = 0;
+	const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (decoded < frames && std::chrono::steady_clock::now() < give_up) {
+		REQUIRE(client.send_input({buttons, 0, 0, 0}));
+		if (client.receive(std::chrono::milliseconds(20))) {
+			++decoded;
+		}
+	}
+	REQUIRE(decoded == frames);
+}
+
+} // namespace
+
+TEST_CASE("Stream Server - A player sends input and decodes every frame", "[core][stream]") {
+	StreamedSystem session;
+	StreamServer server;
+	REQUIRE(server.add_session(session.system, session.input) == 0);
+	REQUIRE(server.start(0));
+	REQUIRE(server.is_running());
+	REQUIRE(server.port() != 0);
+
+	StreamClient client;
+	REQUIRE(client.connect("127.0.0.1", server.port(), 0));
+	REQUIRE(client.frame() == nullptr);
+
+	play(client, 0x81, 20);
+	server.stop();
+	REQUIRE(session.system.ram().read(0x10) == 0x81);
+	REQUIRE(session.system.ram().read(0x11) >= 20);
+
+	// Take whatever is still on its way: the last frame sent is the system's
+	while (client.receive(std::chrono::milliseconds(50))) {
+	}
+	const StreamServer::Stats stats = server.stats();
+	REQUIRE(stats.frames_sent >= 20);
+	REQUIRE(stats.keyframes_sent >= 1);
+	REQUIRE(stats.keyframes_sent < stats.frames_sent);
+	REQUIRE(stats.inputs_received > 0);
+	REQUIRE(client.frames_failed() == 0);
+	REQUIRE(client.frame_number() == stats.frames_sent - 1);
+	REQUIRE(std::memcmp(client.frame(), session.system.ppu().get_index_buffer(), 256 * 240 * sizeof(std::uint16_t)) ==
+			0);
+}
+
+TEST_CASE("Stream Server - Sessions on one worker keep their own players", "[core][stream]") {
+	StreamedSystem first;
+	StreamedSystem second;
+	StreamServer server;
+	server.add_session(first.system, first.input);
+	REQUIRE(server.add_session(second.system, second.input) == 1);
+	REQUIRE(server.start(0, 1));
+
+	StreamClient first_client;
+	StreamClient second_client;
+	REQUIRE(first_client.connect("127.0.0.1", server.port(), 0));
+	REQUIRE(second_client.connect("localhost", server.port(), 1));
+	for (int round = 0; round < 5; ++round) {
+		play(first_client, 0x18, 2);
+		play(second_client, 0x42, 2);
+	}
+	server.stop();
+
+	REQUIRE(first.system.ram().read(0x10) == 0x18);
+	REQUIRE(second.system.ram().read(0x10) == 0x42);
+	REQUIRE(first_client.frames_failed() == 0);
+	REQUIRE(second_client.frames_failed() == 0);
+}
+
+TEST_CASE("Stream Server - Only a welcomed address is served", "[core][stream]") {
+	StreamedSystem session;
+	StreamServer server;
+	server.add_session(session.system, session.input);
+	REQUIRE(server.start(0));
+	const std::uint16_t port = server.port();
+
+	StreamClient player;
+	REQUIRE(player.connect("127.0.0.1", port, 0));
+	play(player, 0x81, 2);
+
+	SECTION("A live player keeps the session") {
+		StreamClient other;
+		REQUIRE_FALSE(other.connect("127.0.0.1", port, 0, std::chrono::milliseconds(300)));
+		play(player, 0x18, 2);
+		server.stop();
+		REQUIRE(session.system.ram().read(0x10) == 0x18);
+	}
+
+	SECTION("A silent player's session is taken over once it times out") {
+		StreamClient other;
+		REQUIRE(other.connect("127.0.0.1", port, 0, StreamServer::CLIENT_TIMEOUT + std::chrono::seconds(2)));
+		play(other, 0x42, 2);
+		server.stop();
+		REQUIRE(session.system.ram().read(0x10) == 0x42);
+	}
+
+	SECTION("Input without the token is ignored") {
+		// A restarted server draws a new secret, so the old token no longer matches
+		server.stop();
+		while (player.receive(std::chrono::milliseconds(50))) {
+		}
+		REQUIRE(server.start(port));
+		const std::uint64_t received = server.stats().inputs_received;
+		for (int i = 0; i < 5; ++i) {
+			REQUIRE(player.send_input({0x24, 0, 0, 0}));
+			REQUIRE_FALSE(player.receive(std::chrono::milliseconds(20)));
+		}
+		server.stop();
+		REQUIRE(server.stats().inputs_received == received);
+		REQUIRE(session.system.ram().read(0x10) == 0x81);
+	}
+}
+
+TEST_CASE("Stream Server - A stalled session drops frames instead of catching up", "[core][stream]") {
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point now = Clock::now();
+	const Clock::duration period = std::chrono::milliseconds(16);
+	REQUIRE_FALSE(StreamServer::too_far_behind(now - StreamServer::MAX_FRAMES_BEHIND * period, now, period));
+	REQUIRE(StreamServer::too_far_behind(now - (StreamServer::MAX_FRAMES_BEHIND + 1) * period, now, period));
+	REQUIRE_FALSE(StreamServer::too_far_behind(now + period, now, period));
+
+	auto stalling = std::make_shared<StallingInput>();
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system(stalling);
+	REQUIRE(system.load_rom_data(make_input_rom()));
+	StreamServer server;
+	server.add_session(system, input);
+	REQUIRE(server.start(0));
+	StreamClient client;
+	REQUIRE(client.connect("127.0.0.1", server.port(), 0));
+	play(client, 0, 5);
+
+	// 300 ms is about 18 frames: the session skips them rather than run them back to back
+	stalling->stall = true;
+	play(client, 0, 5);
+	server.stop();
+	REQUIRE(server.stats().frames_dropped >= 10);
+	REQUIRE(client.frames_failed() == 0);
+}
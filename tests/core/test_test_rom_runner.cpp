@@ -0,0 +1,176 @@
+// VibeNES - NES Emulator
+// Test ROM Runner Tests
+// $6000 result protocol (with reset requests), screen-hash sidecars and suites
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/test_rom_runner.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// MMC1 cart (PRG RAM at $6000) with code at $C000 and every vector there
+RomData build_rom(const std::vector<Byte> &code) {
+	RomData rom = test::make_nrom(code, {.nmi = 0xC000, .reset = 0xC000, .irq = 0xC000});
+	rom.mapper_id = 1;
+	return rom;
+}
+
+// Write the signature and message, then `status`, then spin
+std::vector<Byte> report(Byte status) {
+	return {
+		0xA9, 0x80, 0x8D, 0x00, 0x60, // LDA #$80, STA $6000 (running)
+		0xA9, 0xDE, 0x8D, 0x01, 0x60, // Signature DE B0 61
+		0xA9, 0xB0, 0x8D, 0x02, 0x60, //
+		0xA9, 0x61, 0x8D, 0x03, 0x60, //
+		0xA9, 'o',	0x8D, 0x04, 0x60, // "ok\n"
+		0xA9, 'k',	0x8D, 0x05, 0x60, //
+		0xA9, '\n', 0x8D, 0x06, 0x60, //
+		0xA9, 0x00, 0x8D, 0x07, 0x60, //
+		0xA9, status, 0x8D, 0x00, 0x60, // Result
+		0x4C, 0x2D, 0xC0,			  // C02D: JMP $C02D
+	};
+}
+
+bool run_rom(const std::vector<Byte> &code, const TestRomRunner::Expectation &expected,
+			 TestRomRunner::Result &result, const TestRomRunner::Options &options = {}) {
+	HeadlessSystem system;
+	if (!system.load_rom_data(build_rom(code))) {
+		return false;
+	}
+	result = TestRomRunner::run(system, expected, options);
+	return true;
+}
+
+void write_rom_file(const std::filesystem::path &path, const std::vector<Byte> &code) {
+	const RomData rom = build_rom(code);
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	const char header[16] = {'N', 'E', 'S', 0x1A, 2, 1, 0x10, 0};
+	file.write(header, sizeof(header));
+	file.write(reinterpret_cast<const char *>(rom.prg_rom.data()), static_cast<std::streamsize>(rom.prg_rom.size()));
+	file.write(reinterpret_cast<const char *>(rom.chr_rom.data()), static_cast<std::streamsize>(rom.chr_rom.size()));
+}
+
+} // namespace
+
+TEST_CASE("Test ROM Runner - $6000 protocol", "[core][test_roms]") {
+	TestRomRunner::Result result;
+
+	SECTION("Status 0 passes with the message") {
+		REQUIRE(run_rom(report(0x00), {}, result));
+		REQUIRE(result.verdict == TestRomRunner::Verdict::Passed);
+		REQUIRE(result.used_protocol);
+		REQUIRE(result.status == 0);
+		REQUIRE(result.message == "ok");
+		REQUIRE(result.frames == 1);
+	}
+
+	SECTION("Any other final status fails") {
+		REQUIRE(run_rom(report(0x03), {}, result));
+		REQUIRE(result.verdict == TestRomRunner::Verdict::Failed);
+		REQUIRE(result.status == 3);
+	}
+
+	SECTION("Still running at the timeout") {
+		TestRomRunner::Options options;
+		options.timeout_frames = 30;
+		REQUIRE(run_rom(report(0x80), {}, result, options));
+		REQUIRE(result.verdict == TestRomRunner::Verdict::TimedOut);
+		REQUIRE(result.frames == 30);
+		REQUIRE(result.message == "ok");
+	}
+
+	SECTION("No signature and no screen hash") {
+		TestRomRunner::Options options;
+		options.signature_frames = 5;
+		REQUIRE(run_rom({0x4C, 0x00, 0xC0}, {}, result, options));
+		REQUIRE(result.verdict == TestRomRunner::Verdict::NoVerdict);
+		REQUIRE(result.frames == 5);
+	}
+}
+
+TEST_CASE("Test ROM Runner - Reset requests", "[core][test_roms]") {
+	// First boot: mark $6010 and ask for a reset; after it: report success
+	std::vector<Byte> code = {
+		0xAD, 0x10, 0x60, // C000: LDA $6010
+		0xC9, 0xA5,		  // C003: CMP #$A5
+		0xF0, 0x1C,		  // C005: BEQ $C023
+		0xA9, 0xA5,		  // C007: LDA #$A5
+		0x8D, 0x10, 0x60, // C009: STA $6010
+		0xA9, 0xDE,		  // C00C: Signature
+		0x8D, 0x01, 0x60, //
+		0xA9, 0xB0,		  //
+		0x8D, 0x02, 0x60, //
+		0xA9, 0x61,		  //
+		0x8D, 0x03, 0x60, //
+		0xA9, 0x81,		  // C01B: LDA #$81 (press reset)
+		0x8D, 0x00, 0x60, // C01D: STA $6000
+		0x4C, 0x20, 0xC0, // C020: JMP $C020
+	};
+	const std::vector<Byte> second_boot = {
+		0xA9, 0x00,		  // C023: LDA #$00
+		0x8D, 0x04, 0x60, // C025: STA $6004 (empty message)
+		0x8D, 0x00, 0x60, // C028: STA $6000 (passed)
+		0x4C, 0x2B, 0xC0, // C02B: JMP $C02B
+	};
+	code.insert(code.end(), second_boot.begin(), second_boot.end());
+
+	TestRomRunner::Result result;
+	REQUIRE(run_rom(code, {}, result));
+	REQUIRE(result.verdict == TestRomRunner::Verdict::Passed);
+	REQUIRE(result.resets == 1);
+	REQUIRE(result.frames > 10); // Waited before pressing reset
+}
+
+TEST_CASE("Test ROM Runner - Screen hash sidecar and suite", "[core][test_roms]") {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "vibenes_test_roms";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir / "nested");
+	const std::filesystem::path drawn = dir / "drawn.nes";
+	const std::filesystem::path reported = dir / "nested" / "reported.NES";
+	write_rom_file(drawn, {0x4C, 0x00, 0xC0});
+	write_rom_file(reported, report(0x00));
+	std::ofstream(dir / "notes.txt") << "not a ROM\n";
+
+	const std::vector<std::filesystem::path> roms = TestRomRunner::find_roms({dir});
+	REQUIRE(roms == std::vector<std::filesystem::path>{drawn, reported});
+
+	// Record the drawn ROM's screen, as --record-hashes does
+	TestRomRunner::Options options;
+	options.record_frames = 12;
+	const TestRomRunner::Result recording = TestRomRunner::run(drawn, options);
+	REQUIRE_FALSE(recording.used_protocol);
+	REQUIRE(recording.frames == 12);
+	REQUIRE(TestRomRunner::write_expectation(drawn, {recording.frames, recording.frame_hash}));
+
+	TestRomRunner::Expectation expected;
+	REQUIRE(TestRomRunner::read_expectation(drawn, expected));
+	REQUIRE(expected.frames == 12);
+	REQUIRE(expected.frame_hash == recording.frame_hash);
+
+	options = {};
+	options.threads = 2;
+	std::vector<TestRomRunner::Result> results = TestRomRunner::run_suite(roms, options);
+	REQUIRE(results.size() == 2);
+	REQUIRE(results[0].rom == drawn.string());
+	REQUIRE(results[0].verdict == TestRomRunner::Verdict::Passed);
+	REQUIRE(results[0].frames == 12);
+	REQUIRE(results[1].verdict == TestRomRunner::Verdict::Passed);
+	REQUIRE(results[1].used_protocol);
+
+	// A different screen fails
+	REQUIRE(TestRomRunner::write_expectation(drawn, {12, recording.frame_hash ^ 1}));
+	results = TestRomRunner::run_suite({drawn, dir / "missing.nes"}, options);
+	REQUIRE(results[0].verdict == TestRomRunner::Verdict::Failed);
+	REQUIRE(results[1].verdict == TestRomRunner::Verdict::LoadError);
+
+	std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,87 @@
+// VibeNES - NES Emulator
+// Trace Zones Tests
+// Chrome trace_event capture: per-thread tracks, capture boundaries and the JSON output
+
+#include "../../include/core/trace_zones.hpp"
+#include <catch2/catch_all.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace nes;
+
+namespace {
+
+std::size_t occurrences(const std::string &text, const std::string &needle) {
+	std::size_t count = 0;
+	for (std::size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+		++count;
+	}
+	return count;
+}
+
+std::string capture_json() {
+	std::ostringstream out;
+	REQUIRE(TraceZones::write_json(out));
+	return out.str();
+}
+
+} // namespace
+
+TEST_CASE("Trace Zones - Capture", "[core][trace]") {
+	{
+		const TraceZone before("test.before"); // No capture running: not recorded
+	}
+	TraceZones::start();
+	REQUIRE(TraceZones::is_recording());
+	{
+		const TraceZone outer("test.outer");
+		const TraceZone inner("test.inner");
+	}
+	std::thread worker([] {
+		TraceZones::set_thread_name("Test \"Worker\"");
+		const TraceZone zone("test.worker");
+	});
+	worker.join();
+	TraceZones::stop();
+	{
+		const TraceZone after("test.after");
+	}
+
+	REQUIRE(TraceZones::event_count() == 3);
+	REQUIRE(TraceZones::dropped_events() == 0);
+	const std::string json = capture_json();
+	REQUIRE(json.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+	REQUIRE(json.ends_with("]}\n"));
+	REQUIRE(occurrences(json, "\"ph\":\"X\"") == 3);
+	REQUIRE(occurrences(json, "test.outer") == 1);
+	REQUIRE(occurrences(json, "test.inner") == 1);
+	REQUIRE(occurrences(json, "test.worker") == 1);
+	REQUIRE(occurrences(json, "test.before") == 0);
+	REQUIRE(occurrences(json, "test.after") == 0);
+	// The worker got its own named track, its quotes escaped
+	REQUIRE(occurrences(json, "\"ph\":\"M\"") >= 1);
+	REQUIRE(occurrences(json, "\"Test \\\"Worker\\\"\"") == 1);
+	// Only the metadata events nest an object
+	REQUIRE(occurrences(json, "}}") == occurrences(json, "\"ph\":\"M\""));
+
+	SECTION("A new capture starts empty") {
+		TraceZones::start();
+		TraceZones::stop();
+		REQUIRE(TraceZones::event_count() == 0);
+		REQUIRE(occurrences(capture_json(), "\"ph\":\"X\"") == 0);
+	}
+}
+
+TEST_CASE("Trace Zones - Macro", "[core][trace]") {
+	TraceZones::start();
+	{
+		VIBENES_TRACE_ZONE("test.macro");
+	}
+	TraceZones::stop();
+#ifdef VIBENES_TRACE_ZONES
+	REQUIRE(TraceZones::event_count() == 1);
+#else
+	REQUIRE(TraceZones::event_count() == 0); // Compiled out
+#endif
+}
@@ -0,0 +1,122 @@
+// VibeNES - NES Emulator
+// Vector Env Tests
+// Copies of one game stepped in lockstep, sharing machines while they agree
+
+#include "../../include/cartridge/rom_image.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/nes_system.hpp"
+#include "../../include/system/vector_env.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// A menu: counts frames at $11 and keeps only the A button of each frame's
+// read ($10), so instances differing in any other button agree again
+RomData make_menu_rom() {
+	const std::uint8_t program[] = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xE6, 0x11,		  //       INC $11
+		0xA9, 0x01,		  //       LDA #$01
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xAD, 0x16, 0x40, //       LDA $4016 (A)
+		0x29, 0x01,		  //       AND #$01
+		0x85, 0x10,		  //       STA $10
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+// The same game on its own machine, for comparison
+struct Scalar {
+	std::shared_ptr<LatchedInputSource> input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system{input};
+
+	explicit Scalar(const std::shared_ptr<const RomImage> &image) {
+		REQUIRE(system.load_rom_image(image));
+	}
+	void step(Byte buttons, unsigned frames) {
+		input->set_buttons(0, buttons);
+		for (unsigned i = 0; i < frames; ++i) {
+			system.run_frame();
+		}
+	}
+	std::vector<std::uint8_t> state() {
+		std::vector<std::uint8_t> bytes;
+		system.system().serialize_machine(bytes);
+		return bytes;
+	}
+};
+
+} // namespace
+
+TEST_CASE("Vector Env - Instances given the same buttons share one machine", "[core][vector_env]") {
+	VectorEnv env(16);
+	REQUIRE(env.load(RomImage::from_rom_data(make_menu_rom())));
+	const std::vector<Byte> buttons(env.size(), 0x01);
+	for (int i = 0; i < 10; ++i) {
+		REQUIRE(env.step(buttons));
+	}
+	REQUIRE(env.group_count() == 1);
+	REQUIRE(env.stats().machine_frames == 10);
+	REQUIRE(env.stats().instance_frames == 160);
+	for (std::size_t i = 0; i < env.size(); ++i) {
+		REQUIRE(env.ram(i)[0x10] == 1);
+		REQUIRE(env.frame_count()[i] == env.frame_count()[0]);
+	}
+	REQUIRE_FALSE(env.step(std::vector<Byte>(3, 0)));
+}
+
+TEST_CASE("Vector Env - Groups split on input and merge when the game ignores it", "[core][vector_env]") {
+	const auto image = RomImage::from_rom_data(make_menu_rom());
+	VectorEnv env(6);
+	REQUIRE(env.load(image));
+	std::vector<std::unique_ptr<Scalar>> reference;
+	for (std::size_t i = 0; i < env.size(); ++i) {
+		reference.push_back(std::make_unique<Scalar>(image));
+	}
+
+	// Only bit 0 (A) matters: two outcomes out of six button sets
+	const std::vector<Byte> buttons = {0x01, 0x81, 0x00, 0x41, 0x80, 0x10};
+	REQUIRE(env.step(buttons, 3));
+	REQUIRE(env.stats().splits == 5);
+	REQUIRE(env.group_count() == 2);
+	REQUIRE(env.stats().machine_frames == 18);
+
+	REQUIRE(env.step(std::vector<Byte>(env.size(), 0x00), 2));
+	REQUIRE(env.group_count() == 1);
+
+	for (std::size_t i = 0; i < env.size(); ++i) {
+		reference[i]->step(buttons[i], 3);
+		reference[i]->step(0x00, 2);
+		REQUIRE(env.machine(i).system().cpu().get_program_counter() == env.program_counter()[i]);
+		std::vector<std::uint8_t> state;
+		env.machine(i).system().serialize_machine(state);
+		REQUIRE(state == reference[i]->state());
+		REQUIRE(env.frame_count()[i] == reference[i]->system.get_frame_count());
+	}
+}
+
+TEST_CASE("Vector Env - Without merging every button set keeps its machine", "[core][vector_env]") {
+	VectorEnv env(4);
+	env.set_merging(false);
+	REQUIRE(env.load(RomImage::from_rom_data(make_menu_rom())));
+	REQUIRE(env.step(std::vector<Byte>{0x00, 0x02, 0x04, 0x02}));
+	REQUIRE(env.group_count() == 3);
+	REQUIRE(env.step(std::vector<Byte>(4, 0x00)));
+	REQUIRE(env.group_count() == 3);
+	REQUIRE(env.ram(0)[0x11] == env.ram(3)[0x11]);
+
+	env.reset();
+	REQUIRE(env.group_count() == 1);
+}
@@ -2,6 +2,7 @@
 #include "../../include/cpu/cpu_6502.hpp"
 #include "../../include/cpu/interrupts.hpp"
 #include "../../include/memory/ram.hpp"
+#include "../fixtures/prg_ram_cartridge.hpp"
 #include <catch2/catch_all.hpp>
 #include <memory>
 
@@ -104,6 +105,7 @@ TEST_CASE("CPU interrupt triggering", "[cpu][interrupts]") {
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -148,6 +150,7 @@ TEST_CASE("NMI interrupt handling", "[cpu][interrupts]") {
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -212,6 +215,7 @@ TEST_CASE("IRQ interrupt handling", "[cpu][interrupts]") {
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -313,6 +317,7 @@ TEST_CASE("Reset interrupt handling", "[cpu][interrupts]") {
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -377,6 +382,7 @@ TEST_CASE("Interrupt priority and precedence", "[cpu][interrupts]") {
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -480,6 +486,7 @@ TEST_CASE("BRK instruction vs IRQ handling", "[cpu][interrupts]") {
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -532,6 +539,7 @@ TEST_CASE("CLI does not allow immediate IRQ (penultimate-cycle polling)", "[cpu]
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -571,6 +579,7 @@ TEST_CASE("SEI allows one more IRQ through (penultimate-cycle polling)", "[cpu][
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -598,6 +607,7 @@ TEST_CASE("IRQ not re-entered after handler sets I flag", "[cpu][interrupts][tim
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge());
 	setup_interrupt_vectors(*bus);
 
 	CPU6502 cpu(bus.get());
@@ -0,0 +1,157 @@
+// VibeNES - NES Emulator
+// Block Execution Tests
+// Compiled blocks must be indistinguishable from interpreting them
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/cpu/block_cache.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/nes_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// Two hot loops covering every block opcode on zero page the NMI handler
+// also writes, under NMIs every frame and APU frame IRQs
+RomData build_block_rom() {
+	const std::vector<Byte> code = {
+		0x78,			  // E000: SEI
+		0xA2, 0xFF,		  // E001: LDX #$FF
+		0x9A,			  // E003: TXS
+		0xA9, 0x80,		  // E004: LDA #$80 (NMI on)
+		0x8D, 0x00, 0x20, // E006: STA $2000
+		0xA9, 0x00,		  // E009: LDA #$00 (frame IRQ on)
+		0x8D, 0x17, 0x40, // E00B: STA $4017
+		0x58,			  // E00E: CLI
+		0xA2, 0x18,		  // E00F: LDX #$18
+		0xA5, 0x30,		  // E011: LDA $30
+		0x18,			  // E013: CLC
+		0x69, 0x37,		  // E014: ADC #$37
+		0x85, 0x30,		  // E016: STA $30
+		0x45, 0x31,		  // E018: EOR $31
+		0x2A,			  // E01A: ROL A
+		0x85, 0x31,		  // E01B: STA $31
+		0x38,			  // E01D: SEC
+		0xE5, 0x32,		  // E01E: SBC $32
+		0x6A,			  // E020: ROR A
+		0x29, 0xF3,		  // E021: AND #$F3
+		0x05, 0x33,		  // E023: ORA $33
+		0xA8,			  // E025: TAY
+		0xC8,			  // E026: INY
+		0x84, 0x33,		  // E027: STY $33
+		0x24, 0x30,		  // E029: BIT $30
+		0x65, 0x33,		  // E02B: ADC $33
+		0xE9, 0x11,		  // E02D: SBC #$11
+		0x49, 0x5A,		  // E02F: EOR #$5A
+		0x09, 0x01,		  // E031: ORA #$01
+		0x25, 0x31,		  // E033: AND $31
+		0xC5, 0x32,		  // E035: CMP $32
+		0xCA,			  // E037: DEX
+		0xD0, 0xD7,		  // E038: BNE $E011
+		0xA5, 0x31,		  // E03A: LDA $31
+		0x85, 0x34,		  // E03C: STA $34
+		0x85, 0x35,		  // E03E: STA $35
+		0x05, 0x30,		  // E040: ORA $30
+		0x85, 0x37,		  // E042: STA $37
+		0xA2, 0x10,		  // E044: LDX #$10
+		0x06, 0x34,		  // E046: ASL $34
+		0x46, 0x35,		  // E048: LSR $35
+		0x26, 0x36,		  // E04A: ROL $36
+		0x66, 0x37,		  // E04C: ROR $37
+		0xE6, 0x38,		  // E04E: INC $38
+		0xC6, 0x39,		  // E050: DEC $39
+		0xB8,			  // E052: CLV
+		0xC9, 0x40,		  // E053: CMP #$40
+		0xC4, 0x31,		  // E055: CPY $31
+		0x8A,			  // E057: TXA
+		0x98,			  // E058: TYA
+		0x4A,			  // E059: LSR A
+		0x0A,			  // E05A: ASL A
+		0xE0, 0x08,		  // E05B: CPX #$08
+		0xC0, 0x80,		  // E05D: CPY #$80
+		0xA4, 0x38,		  // E05F: LDY $38
+		0x88,			  // E061: DEY
+		0x86, 0x3A,		  // E062: STX $3A
+		0xBA,			  // E064: TSX
+		0x9A,			  // E065: TXS
+		0xA6, 0x3A,		  // E066: LDX $3A
+		0xE4, 0x3A,		  // E068: CPX $3A
+		0xF8,			  // E06A: SED
+		0xD8,			  // E06B: CLD
+		0xEA,			  // E06C: NOP
+		0xA0, 0x07,		  // E06D: LDY #$07
+		0xCA,			  // E06F: DEX
+		0x10, 0xD4,		  // E070: BPL $E046
+		0xE6, 0x3B,		  // E072: INC $3B
+		0x4C, 0x0F, 0xE0, // E074: JMP $E00F
+		0xE6, 0x30,		  // E077: NMI: INC $30
+		0x40,			  // E079: RTI
+		0x48,			  // E07A: IRQ: PHA
+		0xAD, 0x15, 0x40, // E07B: LDA $4015 (acknowledge)
+		0xE6, 0x3C,		  // E07E: INC $3C
+		0x68,			  // E080: PLA
+		0x40,			  // E081: RTI
+	};
+	return test::make_nrom(code, {.nmi = 0xE077, .reset = 0xE000, .irq = 0xE07A});
+}
+
+std::vector<std::uint8_t> machine_state(HeadlessSystem &system) {
+	std::vector<std::uint8_t> state;
+	system.system().serialize_machine(state);
+	return state;
+}
+
+} // namespace
+
+TEST_CASE("Block Execution - Matches interpreting every instruction", "[cpu][block]") {
+	HeadlessSystem blocks;
+	HeadlessSystem stepping;
+	blocks.cpu().set_block_execution(true);
+	stepping.cpu().set_block_execution(false);
+	REQUIRE(blocks.load_rom_data(build_block_rom()));
+	REQUIRE(stepping.load_rom_data(build_block_rom()));
+
+	for (int frame = 0; frame < 60; ++frame) {
+		INFO("frame " << frame);
+		REQUIRE(blocks.run_frame() == stepping.run_frame());
+		REQUIRE(blocks.cpu().get_cycle_count() == stepping.cpu().get_cycle_count());
+		REQUIRE(machine_state(blocks) == machine_state(stepping));
+	}
+
+	// Both loops ran as blocks, with NMIs and frame IRQs taken between them
+	REQUIRE(blocks.cpu().get_block_instructions() > 0);
+	REQUIRE(stepping.cpu().get_block_instructions() == 0);
+	REQUIRE(blocks.bus().peek(0x003B) > 0);
+	REQUIRE(blocks.bus().peek(0x003C) > 0);
+}
+
+TEST_CASE("Block Execution - Breakpoints inside a block still stop the run", "[cpu][block]") {
+	HeadlessSystem system;
+	system.cpu().set_block_execution(true);
+	REQUIRE(system.load_rom_data(build_block_rom()));
+	system.run_frame();
+	system.run_frame();
+	REQUIRE(system.cpu().get_block_instructions() > 0);
+
+	system.cpu().set_breakpoint(0xE02B);
+	const CPU6502::RunResult result = system.cpu().run_frame(1000000);
+	REQUIRE(result.stop == CPU6502::RunStop::Breakpoint);
+	REQUIRE(system.cpu().get_program_counter() == 0xE02B);
+}
+
+TEST_CASE("Block Execution - Blocks cover registers, flags and zero page only", "[cpu][block]") {
+	REQUIRE(CpuBlockCache::is_block_opcode(0xA5));	    // LDA zp
+	REQUIRE(CpuBlockCache::is_block_opcode(0xE6));	    // INC zp
+	REQUIRE(CpuBlockCache::is_block_opcode(0xD0));	    // BNE
+	REQUIRE_FALSE(CpuBlockCache::is_block_opcode(0xAD)); // LDA abs: may reach a register
+	REQUIRE_FALSE(CpuBlockCache::is_block_opcode(0x58)); // CLI
+	REQUIRE_FALSE(CpuBlockCache::is_block_opcode(0x48)); // PHA
+	REQUIRE_FALSE(CpuBlockCache::is_block_opcode(0x4C)); // JMP
+	REQUIRE_FALSE(CpuBlockCache::is_block_opcode(0x04)); // Unofficial NOP zp
+}
@@ -4,7 +4,9 @@
 
 #include "../../include/core/bus.hpp"
 #include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/cpu/opcode_table.hpp"
 #include "../../include/memory/ram.hpp"
+#include "../fixtures/prg_ram_cartridge.hpp"
 #include <catch2/catch_all.hpp>
 #include <memory>
 
@@ -41,6 +43,7 @@ TEST_CASE("CPU Reset", "[cpu][reset]") {
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge()); // Vectors are written through the bus
 
 	CPU6502 cpu(bus.get());
 
@@ -4251,6 +4254,7 @@ TEST_CASE("CPU BRK Instruction", "[cpu][instructions][brk][interrupt][opcodes]")
 	auto bus = std::make_unique<SystemBus>();
 	auto ram = std::make_shared<Ram>();
 	bus->connect_ram(ram);
+	bus->connect_cartridge(test::make_prg_ram_cartridge()); // Vectors are written through the bus
 	CPU6502 cpu(bus.get());
 
 	SECTION("BRK (0x00) - Basic operation") {
@@ -4318,3 +4322,104 @@ TEST_CASE("CPU BRK Instruction", "[cpu][instructions][brk][interrupt][opcodes]")
 		REQUIRE((pushed_status & 0x80) != 0); // Negative set
 	}
 }
+
+TEST_CASE("CPU Indexed Addressing Cycle Counts", "[cpu][instructions][addressing][timing]") {
+	auto bus = std::make_unique<SystemBus>();
+	auto ram = std::make_shared<Ram>();
+	bus->connect_ram(ram);
+	CPU6502 cpu(bus.get());
+
+	// Place a 2-3 byte instruction at $0300 and return the cycles it took
+	auto run = [&](Byte opcode, Byte operand_low, Byte operand_high = 0x00) {
+		cpu.set_program_counter(0x0300);
+		bus->write(0x0300, opcode);
+		bus->write(0x0301, operand_low);
+		bus->write(0x0302, operand_high);
+		return cpu.execute_instruction();
+	};
+
+	SECTION("Zero page,X/Y always spend the indexing cycle") {
+		cpu.set_x_register(0x10);
+		cpu.set_y_register(0x10);
+		REQUIRE(run(0xB5, 0x80) == 4); // LDA $80,X
+		REQUIRE(run(0xD5, 0x80) == 4); // CMP $80,X
+		REQUIRE(run(0xB7, 0x80) == 4); // LAX $80,Y
+		REQUIRE(run(0x97, 0x80) == 4); // SAX $80,Y
+	}
+
+	SECTION("(zp,X) always spends the indexing cycle") {
+		cpu.set_x_register(0x04);
+		bus->write(0x0084, 0x00);
+		bus->write(0x0085, 0x02);
+		REQUIRE(run(0xA1, 0x80) == 6); // LDA ($80,X)
+		REQUIRE(run(0xC1, 0x80) == 6); // CMP ($80,X)
+		REQUIRE(run(0x81, 0x80) == 6); // STA ($80,X)
+	}
+
+	SECTION("Indexed reads take the extra cycle only on a page cross") {
+		cpu.set_x_register(0x01);
+		cpu.set_y_register(0x01);
+		REQUIRE(run(0xDD, 0x00, 0x02) == 4); // CMP $0200,X
+		REQUIRE(run(0xDD, 0xFF, 0x02) == 5); // CMP $02FF,X
+		REQUIRE(run(0xB9, 0xFF, 0x02) == 5); // LDA $02FF,Y
+
+		bus->write(0x0080, 0xFF);
+		bus->write(0x0081, 0x02);
+		REQUIRE(run(0xD1, 0x80) == 6); // CMP ($80),Y crossing into $0300
+		bus->write(0x0080, 0x00);
+		REQUIRE(run(0xD1, 0x80) == 5); // CMP ($80),Y within $0200
+	}
+
+	SECTION("Indexed stores and read-modify-writes always take it") {
+		cpu.set_x_register(0x01);
+		cpu.set_y_register(0x01);
+		REQUIRE(run(0x9D, 0x00, 0x02) == 5); // STA $0200,X
+		REQUIRE(run(0x99, 0x00, 0x02) == 5); // STA $0200,Y
+		REQUIRE(run(0xFE, 0x00, 0x02) == 7); // INC $0200,X
+
+		bus->write(0x0080, 0x00);
+		bus->write(0x0081, 0x02);
+		REQUIRE(run(0x91, 0x80) == 6); // STA ($80),Y
+	}
+}
+
+TEST_CASE("CPU Opcode Cycles and Lengths Match the Opcode Table", "[cpu][instructions][timing][opcodes]") {
+	// Operands at $0010 (zero page, absolute, pointers), X = Y = 0, and each
+	// branch's flag set so it is not taken
+	for (int opcode = 0; opcode < 256; ++opcode) {
+		const OpcodeInfo &info = OPCODE_INFO[static_cast<std::size_t>(opcode)];
+		if (info.base_cycles == 0) {
+			continue;
+		}
+		auto bus = std::make_unique<SystemBus>();
+		bus->connect_ram(std::make_shared<Ram>());
+		CPU6502 cpu(bus.get());
+		bus->write(0x0200, static_cast<Byte>(opcode));
+		bus->write(0x0201, 0x10);
+		bus->write(0x0202, 0x00);
+		cpu.set_program_counter(0x0200);
+		cpu.set_stack_pointer(0xF0);
+		if ((opcode & 0x1F) == 0x10) {
+			const bool taken_when = (opcode & 0x20) != 0;
+			switch (opcode >> 6) {
+			case 0:
+				cpu.set_negative_flag(!taken_when);
+				break;
+			case 1:
+				cpu.set_overflow_flag(!taken_when);
+				break;
+			case 2:
+				cpu.set_carry_flag(!taken_when);
+				break;
+			default:
+				cpu.set_zero_flag(!taken_when);
+				break;
+			}
+		}
+		INFO("opcode $" << std::hex << opcode);
+		REQUIRE(cpu.execute_instruction() == info.base_cycles);
+		if (info.flow == InstructionFlow::Next || info.flow == InstructionFlow::Branch) {
+			REQUIRE(cpu.get_program_counter() == 0x0200 + info.length);
+		}
+	}
+}
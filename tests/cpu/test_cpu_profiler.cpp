@@ -0,0 +1,214 @@
+// VibeNES - NES Emulator
+// CPU Profiler Tests
+// Per-PC counters keyed by PRG bank, and the JSR/RTS shadow call stack
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/cpu/cpu_profiler.hpp"
+#include "../../include/system/headless_system.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+using namespace nes;
+
+// NROM cart with `pages` 16KB PRG pages, code at the start of the last page
+static RomData build_profile_rom(std::uint8_t pages, const std::vector<Byte> &code = {}) {
+	RomData rom{};
+	rom.mapper_id = 0;
+	rom.prg_rom_pages = pages;
+	rom.chr_rom_pages = 1;
+	rom.valid = true;
+	rom.prg_rom.assign(pages * 16384u, 0xEA);
+	rom.chr_rom.resize(8192);
+	const std::size_t base = rom.prg_rom.size() - 0x4000;
+	std::memcpy(&rom.prg_rom[base], code.data(), code.size());
+	// Reset to $C000, NMI/IRQ to an RTI at $C0F0
+	rom.prg_rom[base + 0xF0] = 0x40;
+	rom.prg_rom[base + 0x3FFA] = 0xF0;
+	rom.prg_rom[base + 0x3FFB] = 0xC0;
+	rom.prg_rom[base + 0x3FFC] = 0x00;
+	rom.prg_rom[base + 0x3FFD] = 0xC0;
+	rom.prg_rom[base + 0x3FFE] = 0xF0;
+	rom.prg_rom[base + 0x3FFF] = 0xC0;
+	return rom;
+}
+
+TEST_CASE("CPU Profiler - Flat Profile", "[cpu][profiler]") {
+	SECTION("No cartridge: keyed by CPU address") {
+		CpuProfiler profiler;
+		profiler.record_instruction(0x0300, 0xEA, 2, 0x0301, 0xFF, 0xFF);
+		profiler.record_instruction(0x0301, 0xEA, 2, 0x0302, 0xFF, 0xFF);
+		profiler.record_instruction(0x0300, 0xEA, 2, 0x0301, 0xFF, 0xFF);
+		profiler.record_idle_cycles(0x0302, 100);
+
+		REQUIRE(profiler.get_total_instructions() == 3);
+		REQUIRE(profiler.get_total_cycles() == 106);
+		REQUIRE(profiler.counters_at(0x0300)->instructions == 2);
+		REQUIRE(profiler.counters_at(0x0302)->idle_cycles == 100);
+		REQUIRE(profiler.counters_at(0x0303) == nullptr);
+
+		const auto flat = profiler.flat_profile();
+		REQUIRE(flat.size() == 3);
+		REQUIRE(flat[0].pc == 0x0302); // Hottest first
+		REQUIRE(flat[0].bank == CpuProfiler::NO_BANK);
+		REQUIRE(flat[1].pc == 0x0300);
+		REQUIRE(flat[1].counters.cycles == 4);
+	}
+
+	SECTION("PRG ROM: keyed by ROM offset, attributed to its 8KB bank") {
+		Cartridge cartridge;
+		REQUIRE(cartridge.load_from_rom_data(build_profile_rom(2)));
+		CpuProfiler profiler(&cartridge);
+
+		profiler.record_instruction(0xE123, 0xEA, 2, 0xE124, 0xFF, 0xFF);
+		profiler.record_instruction(0x0200, 0xEA, 2, 0x0201, 0xFF, 0xFF);
+
+		const auto flat = profiler.flat_profile();
+		REQUIRE(flat.size() == 2);
+		REQUIRE(flat[0].bank == 3);
+		REQUIRE(flat[0].pc == 0xE123);
+		REQUIRE(flat[1].bank == CpuProfiler::NO_BANK);
+		REQUIRE(flat[1].pc == 0x0200);
+	}
+
+	SECTION("Mirrored PRG: one ROM location under two addresses") {
+		Cartridge cartridge;
+		REQUIRE(cartridge.load_from_rom_data(build_profile_rom(1)));
+		CpuProfiler profiler(&cartridge);
+
+		profiler.record_instruction(0x8010, 0xEA, 2, 0x8011, 0xFF, 0xFF);
+		profiler.record_instruction(0xC010, 0xEA, 2, 0xC011, 0xFF, 0xFF);
+
+		REQUIRE(profiler.counters_at(0x8010) == profiler.counters_at(0xC010));
+		REQUIRE(profiler.counters_at(0x8010)->instructions == 2);
+		REQUIRE(profiler.flat_profile().size() == 1);
+	}
+
+	SECTION("Reports") {
+		CpuProfiler profiler;
+		profiler.record_instruction(0x0300, 0xEA, 2, 0x0301, 0xFF, 0xFF);
+		std::ostringstream flat;
+		profiler.write_flat_profile(flat);
+		REQUIRE(flat.str().find("$0300") != std::string::npos);
+		REQUIRE(flat.str().find("100.00%") != std::string::npos);
+	}
+}
+
+TEST_CASE("CPU Profiler - Call Graph", "[cpu][profiler]") {
+	CpuProfiler profiler;
+
+	// Root: JSR $0400 (sub A), which JSRs $0500 (sub B) twice
+	profiler.record_instruction(0x0300, 0x20, 6, 0x0400, 0xFF, 0xFD);
+	profiler.record_instruction(0x0400, 0x20, 6, 0x0500, 0xFD, 0xFB);
+	profiler.record_instruction(0x0500, 0xEA, 2, 0x0501, 0xFB, 0xFB);
+	profiler.record_instruction(0x0501, 0x60, 6, 0x0403, 0xFB, 0xFD);
+	profiler.record_instruction(0x0403, 0x20, 6, 0x0500, 0xFD, 0xFB);
+	profiler.record_instruction(0x0500, 0xEA, 2, 0x0501, 0xFB, 0xFB);
+	profiler.record_instruction(0x0501, 0x60, 6, 0x0406, 0xFB, 0xFD);
+	profiler.record_instruction(0x0406, 0x60, 6, 0x0303, 0xFD, 0xFF);
+	profiler.record_instruction(0x0303, 0xEA, 2, 0x0304, 0xFF, 0xFF);
+
+	const auto routines = profiler.routines();
+	auto find_routine = [&](Address pc) {
+		for (const auto &routine : routines) {
+			if (routine.pc == pc) {
+				return routine;
+			}
+		}
+		FAIL("routine not found");
+		return CpuProfiler::Routine{};
+	};
+
+	const auto root = find_routine(CpuProfiler::ROOT_PC);
+	REQUIRE(root.inclusive_cycles == 42);
+	REQUIRE(root.self_cycles == 8);
+
+	const auto sub_a = find_routine(0x0400);
+	REQUIRE(sub_a.calls == 1);
+	REQUIRE(sub_a.inclusive_cycles == 34);
+	REQUIRE(sub_a.self_cycles == 18);
+
+	const auto sub_b = find_routine(0x0500);
+	REQUIRE(sub_b.calls == 2);
+	REQUIRE(sub_b.inclusive_cycles == 16);
+	REQUIRE(sub_b.self_cycles == 16);
+
+	const auto edges = profiler.call_graph();
+	REQUIRE(edges.size() == 2);
+	REQUIRE(edges[0].caller.pc == CpuProfiler::ROOT_PC);
+	REQUIRE(edges[0].callee.pc == 0x0400);
+	REQUIRE(edges[1].caller.pc == 0x0400);
+	REQUIRE(edges[1].callee.pc == 0x0500);
+	REQUIRE(edges[1].calls == 2);
+
+	SECTION("Interrupts open a frame that RTI closes") {
+		profiler.record_interrupt(0x0600, 7, 0xFF);
+		profiler.record_instruction(0x0600, 0x40, 6, 0x0304, 0xFC, 0xFF);
+		const auto graph = profiler.call_graph();
+		const bool found = std::any_of(graph.begin(), graph.end(), [](const CpuProfiler::CallEdge &edge) {
+			return edge.callee.pc == 0x0600 && edge.calls == 1 && edge.inclusive_cycles == 13;
+		});
+		REQUIRE(found);
+	}
+
+	SECTION("Discarded return address closes the frame at the next outer return") {
+		profiler.record_instruction(0x0304, 0x20, 6, 0x0700, 0xFF, 0xFD);
+		profiler.record_instruction(0x0700, 0x20, 6, 0x0800, 0xFD, 0xFB);
+		profiler.record_instruction(0x0800, 0x68, 4, 0x0801, 0xFB, 0xFC); // PLA
+		profiler.record_instruction(0x0801, 0x68, 4, 0x0802, 0xFC, 0xFD); // PLA: frame $0800 closed
+		profiler.record_instruction(0x0802, 0x60, 6, 0x0307, 0xFD, 0xFF); // RTS to root: $0700 closed
+		const auto graph = profiler.call_graph();
+		const bool closed = std::any_of(graph.begin(), graph.end(), [](const CpuProfiler::CallEdge &edge) {
+			return edge.caller.pc == 0x0700 && edge.callee.pc == 0x0800 && edge.inclusive_cycles == 8;
+		});
+		REQUIRE(closed);
+		REQUIRE(graph.size() == 4);
+		REQUIRE(profiler.routines().size() == 5); // Nothing left open
+	}
+
+	SECTION("Reports name the root") {
+		std::ostringstream graph;
+		profiler.write_call_graph(graph);
+		REQUIRE(graph.str().find("<root>") != std::string::npos);
+		REQUIRE(graph.str().find("--:$0500") != std::string::npos);
+	}
+}
+
+#ifdef VIBENES_CPU_PROFILER
+TEST_CASE("CPU Profiler - Attached To The CPU", "[cpu][profiler]") {
+	const std::vector<Byte> code = {
+		0x20, 0x10, 0xC0, // C000: JSR $C010
+		0x4C, 0x00, 0xC0, // C003: JMP $C000
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0xE8, // C010: INX
+		0x60, // C011: RTS
+	};
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_profile_rom(2, code)));
+	CpuProfiler profiler(&system.cartridge());
+	system.cpu().set_profiler(&profiler);
+
+	std::uint64_t cycles = 0;
+	for (int frame = 0; frame < 3; ++frame) {
+		cycles += system.run_frame();
+	}
+	system.cpu().set_profiler(nullptr);
+
+	// Every cycle the CPU ran lands somewhere in the profile
+	REQUIRE(profiler.get_total_cycles() == cycles);
+	const auto *inx = profiler.counters_at(0xC010);
+	REQUIRE(inx != nullptr);
+	REQUIRE(inx->instructions > 0);
+	REQUIRE(inx->cycles == inx->instructions * 2);
+
+	const auto graph = profiler.call_graph();
+	REQUIRE_FALSE(graph.empty());
+	REQUIRE(graph.front().caller.pc == CpuProfiler::ROOT_PC);
+	REQUIRE(graph.front().callee.pc == 0xC010);
+	REQUIRE(graph.front().callee.bank == 2); // $C000-$DFFF of a 32KB NROM
+}
+#endif
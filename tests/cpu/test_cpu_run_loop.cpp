@@ -0,0 +1,109 @@
+// VibeNES - NES Emulator
+// CPU Run Loop Tests
+// run_until/run_frame stop conditions: cycle target, frame end, breakpoints
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+
+using namespace nes;
+
+// NROM cart looping INX; JMP $8000 forever
+static RomData build_loop_rom() {
+	const Byte code[] = {
+		0xE8,			  // 8000: INX
+		0x4C, 0x00, 0x80, // 8001: JMP $8000
+	};
+	return test::make_nrom(code);
+}
+
+TEST_CASE("CPU Run Loop - Cycle Target", "[cpu][run]") {
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_loop_rom()));
+	CPU6502 &cpu = system.cpu();
+	cpu.set_idle_loop_skipping(false);
+
+	const std::uint64_t start = cpu.get_cycle_count();
+	const CPU6502::RunResult result = cpu.run_until(start + 1000);
+	REQUIRE(result.stop == CPU6502::RunStop::Target);
+	REQUIRE(result.cycles >= 1000);
+	REQUIRE(result.cycles < 1000 + 7); // At most the rest of one instruction
+	REQUIRE(cpu.get_cycle_count() - start == result.cycles);
+
+	// A target already passed runs nothing
+	REQUIRE(cpu.run_until(start).cycles == 0);
+}
+
+TEST_CASE("CPU Run Loop - Frame End", "[cpu][run]") {
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_loop_rom()));
+	CPU6502 &cpu = system.cpu();
+	const std::uint64_t frame = system.ppu().get_frame_count();
+
+	const CPU6502::RunResult result = cpu.run_frame(29781 * 4);
+	REQUIRE(result.stop == CPU6502::RunStop::FrameReady);
+	REQUIRE(system.ppu().get_frame_count() == frame + 1);
+
+	// A full frame next time round
+	const CPU6502::RunResult next = cpu.run_frame(29781 * 4);
+	REQUIRE(next.stop == CPU6502::RunStop::FrameReady);
+	REQUIRE(next.cycles >= 29780);
+	REQUIRE(next.cycles <= 29781 + 7);
+
+	// Running out of budget first
+	REQUIRE(cpu.run_frame(100).stop == CPU6502::RunStop::Target);
+}
+
+TEST_CASE("CPU Run Loop - Breakpoints", "[cpu][run]") {
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_loop_rom()));
+	CPU6502 &cpu = system.cpu();
+	cpu.set_idle_loop_skipping(false);
+
+	cpu.set_breakpoint(0x8001);
+	REQUIRE(cpu.has_breakpoint(0x8001));
+	REQUIRE_FALSE(cpu.has_breakpoint(0x8000));
+
+	CPU6502::RunResult result = cpu.run_until(cpu.get_cycle_count() + 10000);
+	REQUIRE(result.stop == CPU6502::RunStop::Breakpoint);
+	REQUIRE(cpu.get_program_counter() == 0x8001);
+
+	// Resuming executes the instruction at the breakpoint, then stops on the
+	// next pass: JMP (3) + INX (2)
+	result = cpu.run_until(cpu.get_cycle_count() + 10000);
+	REQUIRE(result.stop == CPU6502::RunStop::Breakpoint);
+	REQUIRE(result.cycles == 5);
+
+	// Frames stop at breakpoints too
+	REQUIRE(cpu.run_frame(29781 * 4).stop == CPU6502::RunStop::Breakpoint);
+
+	cpu.clear_breakpoint(0x8001);
+	REQUIRE_FALSE(cpu.has_breakpoint(0x8001));
+	REQUIRE(cpu.run_until(cpu.get_cycle_count() + 1000).stop == CPU6502::RunStop::Target);
+
+	cpu.set_breakpoint(0x8000);
+	cpu.clear_breakpoints();
+	REQUIRE_FALSE(cpu.has_breakpoint(0x8000));
+}
+
+TEST_CASE("CPU Run Loop - Fetches across an 8 KB PRG page", "[cpu][run]") {
+	const Byte code[] = {
+		0xA9, 0x5A,		  // 9FFF: LDA #$5A (operand in the next page)
+		0xAD, 0x18, 0x40, // A001: LDA $4018 (open bus: last byte fetched)
+		0x4C, 0x04, 0xA0, // A004: JMP $A004
+	};
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(test::make_nrom(code, {.reset = 0x9FFF})));
+	CPU6502 &cpu = system.cpu();
+	while (cpu.get_program_counter() != 0x9FFF) {
+		(void)cpu.execute_instruction();
+	}
+
+	(void)cpu.execute_instruction();
+	REQUIRE(cpu.get_accumulator() == 0x5A);
+	(void)cpu.execute_instruction();
+	REQUIRE(cpu.get_accumulator() == 0x40);
+}
@@ -0,0 +1,157 @@
+// VibeNES - NES Emulator
+// CPU Trace Tests
+// Binary trace records streamed through the double-buffered writer, read
+// back and formatted like nestest.log
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/cpu/cpu_trace.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace nes;
+
+static std::filesystem::path temp_trace_path(const char *name) {
+	return std::filesystem::temp_directory_path() / name;
+}
+
+TEST_CASE("CPU Trace - Writer Round Trip", "[cpu][trace]") {
+	const std::filesystem::path path = temp_trace_path("vibenes_test_trace.vntrace");
+	// Tiny buffers so the writer thread swaps buffers many times
+	CpuTraceWriter writer(7);
+	REQUIRE(writer.open(path));
+	for (std::uint32_t i = 0; i < 1000; ++i) {
+		TraceRecord record;
+		record.cycle = i * 3;
+		record.pc = static_cast<std::uint16_t>(0x8000 + i);
+		record.a = static_cast<std::uint8_t>(i);
+		writer.record(record);
+	}
+	REQUIRE(writer.records_recorded() == 1000);
+	REQUIRE(writer.close());
+	REQUIRE_FALSE(writer.is_open());
+	REQUIRE(std::filesystem::file_size(path) == sizeof(TraceFileHeader) + 1000 * sizeof(TraceRecord));
+
+	std::ifstream input(path, std::ios::binary);
+	CpuTraceReader reader(input);
+	REQUIRE(reader.valid());
+	TraceRecord record;
+	std::uint32_t count = 0;
+	bool in_order = true;
+	while (reader.read(record)) {
+		in_order = in_order && record.pc == 0x8000 + count && record.cycle == count * 3 &&
+				   record.a == static_cast<std::uint8_t>(count);
+		++count;
+	}
+	REQUIRE(count == 1000);
+	REQUIRE(in_order);
+
+	input.close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("CPU Trace - Reader Rejects Other Files", "[cpu][trace]") {
+	std::istringstream input("not a trace file at all");
+	CpuTraceReader reader(input);
+	REQUIRE_FALSE(reader.valid());
+	TraceRecord record;
+	REQUIRE_FALSE(reader.read(record));
+}
+
+TEST_CASE("CPU Trace - nestest Line Format", "[cpu][trace]") {
+	TraceRecord record;
+	record.cycle = 7;
+	record.pc = 0xC000;
+	record.scanline = 0;
+	record.dot = 21;
+	record.p = 0x24;
+	record.sp = 0xFD;
+
+	SECTION("Official opcode") {
+		const Byte bytes[] = {0x4C, 0xF5, 0xC5}; // JMP $C5F5
+		std::memcpy(record.bytes, bytes, 3);
+		record.length = 3;
+		REQUIRE(format_trace_line(record) ==
+				"C000  4C F5 C5  JMP $C5F5                       A:00 X:00 Y:00 P:24 SP:FD PPU:  0, 21 CYC:7");
+	}
+
+	SECTION("Unofficial opcodes are starred") {
+		record.bytes[0] = 0x04; // NOP $A9
+		record.bytes[1] = 0xA9;
+		record.length = 2;
+		REQUIRE(format_trace_line(record) ==
+				"C000  04 A9    *NOP $A9                         A:00 X:00 Y:00 P:24 SP:FD PPU:  0, 21 CYC:7");
+	}
+
+	SECTION("Relative branches show their target") {
+		record.bytes[0] = 0xD0; // BNE -4
+		record.bytes[1] = 0xFC;
+		record.length = 2;
+		REQUIRE(format_trace_line(record).starts_with("C000  D0 FC     BNE $BFFE "));
+	}
+
+	SECTION("Indexed and indirect modes") {
+		record.bytes[0] = 0xB1; // LDA ($33),Y
+		record.bytes[1] = 0x33;
+		record.length = 2;
+		REQUIRE(format_trace_line(record).starts_with("C000  B1 33     LDA ($33),Y "));
+		record.bytes[0] = 0x0A; // ASL A
+		record.length = 1;
+		REQUIRE(format_trace_line(record).starts_with("C000  0A        ASL A "));
+	}
+}
+
+#ifdef VIBENES_CPU_TRACE
+TEST_CASE("CPU Trace - Attached To The CPU", "[cpu][trace]") {
+	const Byte code[] = {
+		0xA2, 0x05,		  // 8000: LDX #$05
+		0xE8,			  // 8002: INX
+		0x4C, 0x02, 0x80, // 8003: JMP $8002
+	};
+
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(test::make_nrom(code)));
+	const std::filesystem::path path = temp_trace_path("vibenes_test_cpu.vntrace");
+	CpuTraceWriter writer;
+	REQUIRE(writer.open(path));
+	system.cpu().set_idle_loop_skipping(false);
+	system.cpu().set_tracer(&writer);
+	const std::uint64_t cycles = system.run_frame();
+	system.cpu().set_tracer(nullptr);
+	REQUIRE(writer.close());
+
+	std::ifstream input(path, std::ios::binary);
+	CpuTraceReader reader(input);
+	REQUIRE(reader.valid());
+	std::vector<TraceRecord> records;
+	TraceRecord record;
+	while (reader.read(record)) {
+		records.push_back(record);
+	}
+	REQUIRE(records.size() == writer.records_recorded());
+	REQUIRE(records.size() > 3);
+
+	// Registers are captured before each instruction runs
+	REQUIRE(records[0].pc == 0x8000);
+	REQUIRE(records[0].length == 2);
+	REQUIRE(records[1].pc == 0x8002);
+	REQUIRE(records[1].x == 0x05);
+	REQUIRE(records[2].pc == 0x8003);
+	REQUIRE(records[2].x == 0x06);
+	REQUIRE(records[2].bytes[1] == 0x02);
+	REQUIRE(records[2].bytes[2] == 0x80);
+	REQUIRE(records[2].cycle - records[1].cycle == 2);
+	// Three PPU dots per CPU cycle
+	REQUIRE((records[2].scanline * 341 + records[2].dot) - (records[1].scanline * 341 + records[1].dot) == 6);
+	REQUIRE(records.back().cycle - records[0].cycle < cycles);
+
+	input.close();
+	std::filesystem::remove(path);
+}
+#endif
@@ -0,0 +1,232 @@
+// VibeNES - NES Emulator
+// Disassembler Tests
+// The shared instruction decoder, and whole-ROM static disassembly guided by
+// the vectors and a code/data log
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/code_data_logger.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/cpu/disassembler.hpp"
+#include "../../include/cpu/static_disassembler.hpp"
+#include "../../include/system/headless_system.hpp"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <string>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+// NROM-256. Reset runs a subroutine, then a status wait, then spins; NMI and
+// IRQ share an RTI. $8014 is only reached through JMP ($0300).
+std::vector<Byte> make_prg() {
+	std::vector<Byte> prg(32768, 0xFF);
+	const std::array<Byte, 26> program = {
+		0x78,			  // $8000 SEI
+		0x20, 0x10, 0x80, // $8001 JSR $8010
+		0xAD, 0x02, 0x20, // $8004 LDA $2002
+		0x10, 0xFB,		  // $8007 BPL $8004
+		0x4C, 0x09, 0x80, // $8009 JMP $8009
+		0x01, 0x02, 0x03, 0x04, // $800C data
+		0xA2, 0x00,		  // $8010 LDX #$00
+		0x60,			  // $8012 RTS
+		0x40,			  // $8013 RTI
+		0xA9, 0x01,		  // $8014 LDA #$01
+		0x8D, 0x00, 0x20, // $8016 STA $2000
+		0x60,			  // $8019 RTS
+	};
+	std::copy(program.begin(), program.end(), prg.begin());
+	prg[0x7FFA] = 0x13; // NMI -> $8013
+	prg[0x7FFB] = 0x80;
+	prg[0x7FFC] = 0x00; // Reset -> $8000
+	prg[0x7FFD] = 0x80;
+	prg[0x7FFE] = 0x13; // IRQ -> $8013
+	prg[0x7FFF] = 0x80;
+	return prg;
+}
+
+const StaticDisassembler::Symbol *find_symbol(const StaticDisassembler &disassembler, const std::string &name) {
+	for (const StaticDisassembler::Symbol &symbol : disassembler.symbols()) {
+		if (symbol.name == name) {
+			return &symbol;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace
+
+TEST_CASE("Disassembler - Decode and format", "[cpu][disassembler]") {
+	const Instruction lda = decode_instruction(0xC000, 0xAD, 0x02, 0x20);
+	REQUIRE(lda.length == 3);
+	REQUIRE(lda.mnemonic == "LDA");
+	REQUIRE(lda.mode == AddressingMode::Absolute);
+	REQUIRE(lda.address() == 0x2002);
+	REQUIRE(format_instruction(lda) == "LDA $2002");
+	REQUIRE(format_instruction(lda, "PPUSTATUS") == "LDA PPUSTATUS");
+
+	REQUIRE(format_instruction(decode_instruction(0xC000, 0xB1, 0x33)) == "LDA ($33),Y");
+	REQUIRE(format_instruction(decode_instruction(0xC000, 0xA1, 0x80)) == "LDA ($80,X)");
+	REQUIRE(format_instruction(decode_instruction(0xC000, 0xB6, 0x10)) == "LDX $10,Y");
+	REQUIRE(format_instruction(decode_instruction(0xC000, 0x0A)) == "ASL A");
+	REQUIRE(format_instruction(decode_instruction(0xC000, 0xA9, 0x7F)) == "LDA #$7F");
+	REQUIRE(format_instruction(decode_instruction(0xC000, 0x6C, 0x00, 0x03)) == "JMP ($0300)");
+	REQUIRE(format_instruction(decode_instruction(0xC000, 0x20, 0x10, 0x80), "init") == "JSR init");
+
+	// Operand bytes past the instruction are dropped
+	const Instruction rts = decode_instruction(0xC000, 0x60, 0x12, 0x34);
+	REQUIRE(rts.length == 1);
+	REQUIRE(rts.bytes == std::array<Byte, 3>{0x60, 0x00, 0x00});
+}
+
+TEST_CASE("Disassembler - Control flow and unofficial opcodes", "[cpu][disassembler]") {
+	const Instruction bne = decode_instruction(0xC000, 0xD0, 0xFC);
+	REQUIRE(bne.flow == InstructionFlow::Branch);
+	REQUIRE(bne.address() == 0xBFFE);
+	REQUIRE(format_instruction(bne) == "BNE $BFFE");
+
+	REQUIRE(decode_instruction(0, 0x20).flow == InstructionFlow::Call);
+	REQUIRE(decode_instruction(0, 0x4C).flow == InstructionFlow::Jump);
+	REQUIRE(decode_instruction(0, 0x6C).flow == InstructionFlow::IndirectJump);
+	REQUIRE(decode_instruction(0, 0x60).flow == InstructionFlow::Return);
+	REQUIRE(decode_instruction(0, 0x40).flow == InstructionFlow::Return);
+	REQUIRE(decode_instruction(0, 0x00).flow == InstructionFlow::Break);
+	REQUIRE(decode_instruction(0, 0xEA).flow == InstructionFlow::Next);
+
+	const Instruction jam = decode_instruction(0, 0x02);
+	REQUIRE(jam.flow == InstructionFlow::Halt);
+	REQUIRE(jam.mnemonic == "???");
+
+	REQUIRE_FALSE(decode_instruction(0, 0xEA).unofficial);
+	REQUIRE(decode_instruction(0, 0x1A).unofficial); // NOP
+	REQUIRE(decode_instruction(0, 0xEB).unofficial); // SBC #imm
+	REQUIRE(decode_instruction(0, 0xA7).mnemonic == "LAX");
+	REQUIRE(decode_instruction(0, 0xA7).unofficial);
+
+	REQUIRE(instruction_length(0x0C) == 3);
+	REQUIRE(instruction_length(0x80) == 2);
+	REQUIRE(instruction_length(0x00) == 1);
+}
+
+TEST_CASE("Static Disassembler - Traces from the vectors", "[cpu][disassembler]") {
+	const std::vector<Byte> prg = make_prg();
+	StaticDisassembler disassembler(prg);
+	disassembler.run();
+
+	REQUIRE(disassembler.bank_count() == 4);
+	REQUIRE(disassembler.bank(0).cpu_base == 0x8000);
+	REQUIRE(disassembler.bank(3).cpu_base == 0xE000);
+	REQUIRE_FALSE(disassembler.bank(0).base_from_cdl);
+
+	for (const std::uint32_t start : {0x0000u, 0x0001u, 0x0004u, 0x0007u, 0x0009u, 0x0010u, 0x0012u, 0x0013u}) {
+		REQUIRE(disassembler.is_instruction_start(start));
+	}
+	REQUIRE_FALSE(disassembler.is_instruction_start(0x000C)); // Data after the JMP
+	REQUIRE_FALSE(disassembler.is_instruction_start(0x0014)); // Only reached indirectly
+	REQUIRE(disassembler.bank(0).code_bytes == 16);
+
+	const StaticDisassembler::Symbol *reset = find_symbol(disassembler, "reset");
+	REQUIRE(reset);
+	REQUIRE(reset->kind == StaticDisassembler::SymbolKind::Vector);
+	REQUIRE(reset->address == 0x8000);
+	const StaticDisassembler::Symbol *nmi = find_symbol(disassembler, "nmi"); // IRQ shares it
+	REQUIRE(nmi);
+	REQUIRE(nmi->address == 0x8013);
+	const StaticDisassembler::Symbol *init = find_symbol(disassembler, "sub_00_8010");
+	REQUIRE(init);
+	REQUIRE(init->kind == StaticDisassembler::SymbolKind::Subroutine);
+	REQUIRE(init->references == 1);
+	REQUIRE(find_symbol(disassembler, "loc_00_8004"));
+
+	const std::string listing = disassembler.listing(0);
+	REQUIRE(listing.find(".org $8000") != std::string::npos);
+	REQUIRE(listing.find("\nreset:\n\tSEI") != std::string::npos);
+	REQUIRE(listing.find("\tJSR sub_00_8010") != std::string::npos);
+	REQUIRE(listing.find("\tLDA PPUSTATUS") != std::string::npos);
+	REQUIRE(listing.find("\tBPL loc_00_8004") != std::string::npos);
+	REQUIRE(listing.find("\tJMP loc_00_8009") != std::string::npos);
+	REQUIRE(listing.find("\t.byte $01,$02,$03,$04") != std::string::npos);
+	REQUIRE(disassembler.listing_header().find("PPUSTATUS  = $2002") != std::string::npos);
+
+	const std::string json = disassembler.symbols_json("test \"rom\".nes");
+	REQUIRE(json.find("\"rom\": \"test \\\"rom\\\".nes\"") != std::string::npos);
+	REQUIRE(json.find("{\"name\": \"sub_00_8010\", \"kind\": \"subroutine\", \"bank\": 0, \"cpu_address\": 32784, "
+					  "\"prg_offset\": 16, \"references\": 1}") != std::string::npos);
+}
+
+TEST_CASE("Static Disassembler - Code/data log", "[cpu][disassembler]") {
+	const std::vector<Byte> prg = make_prg();
+	std::vector<Byte> cdl(prg.size(), 0);
+
+	SECTION("Logged code is traced even without a static path to it") {
+		std::fill(cdl.begin() + 0x14, cdl.begin() + 0x1A, CodeDataLogger::PRG_CODE);
+		StaticDisassembler disassembler(prg, cdl);
+		disassembler.run();
+		REQUIRE(disassembler.bank(0).base_from_cdl);
+		REQUIRE(disassembler.is_instruction_start(0x0014));
+		REQUIRE(disassembler.is_instruction_start(0x0016));
+		REQUIRE(disassembler.listing(0).find("\tSTA PPUCTRL") != std::string::npos);
+	}
+
+	SECTION("Logged data is never decoded") {
+		cdl[0x0010] = CodeDataLogger::PRG_DATA; // The subroutine, read as a table
+		StaticDisassembler disassembler(prg, cdl);
+		disassembler.run();
+		REQUIRE(disassembler.is_instruction_start(0x0001));
+		REQUIRE_FALSE(disassembler.is_instruction_start(0x0010));
+		REQUIRE_FALSE(find_symbol(disassembler, "sub_00_8010"));
+		REQUIRE(disassembler.listing(0).find("\tJSR $8010") != std::string::npos);
+	}
+
+	SECTION("Banks sit at the window the log saw them in") {
+		// Bank 1 logged at $C000 (window 2)
+		std::fill(cdl.begin() + 0x2000, cdl.begin() + 0x2010, static_cast<Byte>(CodeDataLogger::PRG_DATA | 0x08));
+		StaticDisassembler disassembler(prg, cdl);
+		REQUIRE(disassembler.bank(1).cpu_base == 0xC000);
+		REQUIRE(disassembler.bank(1).base_from_cdl);
+		REQUIRE(disassembler.bank(0).cpu_base == 0x8000); // Unlogged: guessed
+		REQUIRE_FALSE(disassembler.bank(0).base_from_cdl);
+	}
+}
+
+TEST_CASE("Static Disassembler - Log recorded by a run", "[cpu][disassembler]") {
+	RomData rom{};
+	rom.mapper_id = 0;
+	rom.prg_rom_pages = 2;
+	rom.chr_rom_pages = 1;
+	rom.valid = true;
+	rom.prg_rom = make_prg();
+	rom.chr_rom.assign(8192, 0x00);
+	// Reset jumps through a pointer to $8014, then on into the usual code
+	const std::array<Byte, 14> indirect = {
+		0xA9, 0x14,		  // $8020 LDA #$14
+		0x8D, 0x00, 0x03, //       STA $0300
+		0xA9, 0x80,		  //       LDA #$80
+		0x8D, 0x01, 0x03, //       STA $0301
+		0x6C, 0x00, 0x03, //       JMP ($0300)
+		0x00,
+	};
+	std::copy(indirect.begin(), indirect.end(), rom.prg_rom.begin() + 0x20);
+	rom.prg_rom[0x19] = 0x4C; // $8019: JMP $8000 instead of RTS
+	rom.prg_rom[0x1A] = 0x00;
+	rom.prg_rom[0x1B] = 0x80;
+	rom.prg_rom[0x7FFC] = 0x20; // Reset -> $8020
+
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(rom));
+	system.cartridge().set_cdl_enabled(true);
+	system.run_frame();
+
+	StaticDisassembler without_log(rom.prg_rom);
+	without_log.run();
+	REQUIRE_FALSE(without_log.is_instruction_start(0x0014));
+
+	StaticDisassembler with_log(rom.prg_rom, system.cartridge().get_cdl().prg_log());
+	with_log.run();
+	REQUIRE(with_log.is_instruction_start(0x0014));
+	REQUIRE(with_log.is_instruction_start(0x0001));
+	REQUIRE(find_symbol(with_log, "reset"));
+	REQUIRE(find_symbol(with_log, "loc_00_8000")); // The JMP back
+}
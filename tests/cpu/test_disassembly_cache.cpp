@@ -0,0 +1,132 @@
+// VibeNES - NES Emulator
+// Disassembly Cache Tests
+// Code log of executed instruction starts, kept per PRG bank and dropped when
+// RAM code is rewritten
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/cpu/disassembly_cache.hpp"
+#include "../../include/system/headless_system.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <vector>
+
+using namespace nes;
+
+// UxROM cart (four 16KB banks, NOPs everywhere). `fixed_code` goes at $C000
+// in the fixed last bank, `bank_code[n]` at $8000 in switchable bank n, and a
+// bank number table at $FF00 lets bank switches dodge bus conflicts.
+static RomData build_banked_rom(const std::vector<Byte> &fixed_code, const std::vector<std::vector<Byte>> &bank_code) {
+	RomData rom{};
+	rom.mapper_id = 2;
+	rom.prg_rom_pages = 4;
+	rom.chr_rom_pages = 0;
+	rom.valid = true;
+	rom.prg_rom.assign(4 * 16384, 0xEA);
+	for (std::size_t bank = 0; bank < bank_code.size(); ++bank) {
+		std::memcpy(&rom.prg_rom[bank * 16384], bank_code[bank].data(), bank_code[bank].size());
+	}
+	const std::size_t fixed = 3 * 16384;
+	std::memcpy(&rom.prg_rom[fixed], fixed_code.data(), fixed_code.size());
+	for (Byte bank = 0; bank < 4; ++bank) {
+		rom.prg_rom[fixed + 0x3F00 + bank] = bank;
+	}
+	rom.prg_rom[fixed + 0x3FFC] = 0x00;
+	rom.prg_rom[fixed + 0x3FFD] = 0xC0;
+	return rom;
+}
+
+TEST_CASE("Disassembly Cache - Logged Code", "[cpu][disassembly]") {
+	const std::vector<Byte> code = {
+		0xA9, 0x01,		  // C000: LDA #$01
+		0x8D, 0x00, 0x02, // C002: STA $0200
+		0xA2, 0x05,		  // C005: LDX #$05
+		0xE8,			  // C007: INX
+		0x4C, 0x07, 0xC0, // C008: JMP $C007
+		0xA9, 0xA9,		  // C00B: data
+	};
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_banked_rom(code, {})));
+	const SystemBus &bus = system.bus();
+	DisassemblyCache cache;
+
+	cache.log_executed(bus, 0xC000);
+
+	SECTION("Straight-line code after an executed PC is decoded once") {
+		REQUIRE(cache.was_executed(bus, 0xC000));
+		REQUIRE(cache.is_instruction_start(bus, 0xC002));
+		REQUIRE(cache.is_instruction_start(bus, 0xC005));
+		REQUIRE(cache.is_instruction_start(bus, 0xC008));
+		REQUIRE_FALSE(cache.was_executed(bus, 0xC002));
+		REQUIRE_FALSE(cache.is_instruction_start(bus, 0xC001)); // Operand
+		REQUIRE_FALSE(cache.is_instruction_start(bus, 0xC00B)); // Past the JMP
+	}
+
+	SECTION("Window walks back over logged starts") {
+		const std::vector<Address> expected = {0xC000, 0xC002, 0xC005, 0xC007, 0xC008, 0xC00B};
+		REQUIRE(cache.window(bus, 0xC007, 3, 2) == expected);
+	}
+
+	SECTION("Unlogged code before the PC is aligned once and remembered") {
+		const std::vector<Address> window = cache.window(bus, 0xC000, 4, 0);
+		REQUIRE(window.size() == 5);
+		REQUIRE(window.back() == 0xC000);
+		REQUIRE(cache.is_instruction_start(bus, 0xBFFF)); // NOP before $C000
+	}
+
+	SECTION("Clearing forgets everything") {
+		cache.clear();
+		REQUIRE_FALSE(cache.was_executed(bus, 0xC000));
+		REQUIRE_FALSE(cache.is_instruction_start(bus, 0xC002));
+	}
+}
+
+TEST_CASE("Disassembly Cache - Per Bank Entries", "[cpu][disassembly]") {
+	const std::vector<std::vector<Byte>> banks = {
+		{0xA9, 0x01, 0xE8}, // Bank 0: $8000 LDA #$01, $8002 INX
+		{0xE8, 0xE8, 0xE8}, // Bank 1: $8000 INX x3
+	};
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_banked_rom({}, banks)));
+	SystemBus &bus = system.bus();
+	DisassemblyCache cache;
+
+	bus.write(0xFF00, 0x00);
+	cache.log_executed(bus, 0x8000);
+	REQUIRE(cache.is_instruction_start(bus, 0x8002));
+	REQUIRE_FALSE(cache.is_instruction_start(bus, 0x8001));
+
+	// Same CPU addresses, other bank: nothing logged there yet
+	bus.write(0xFF01, 0x01);
+	REQUIRE_FALSE(cache.was_executed(bus, 0x8000));
+	REQUIRE_FALSE(cache.is_instruction_start(bus, 0x8002));
+	cache.log_executed(bus, 0x8001);
+	REQUIRE(cache.is_instruction_start(bus, 0x8002));
+
+	// Bank 0's log survived the switch
+	bus.write(0xFF00, 0x00);
+	REQUIRE(cache.was_executed(bus, 0x8000));
+	REQUIRE_FALSE(cache.was_executed(bus, 0x8001));
+}
+
+TEST_CASE("Disassembly Cache - Rewritten RAM Code", "[cpu][disassembly]") {
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(build_banked_rom({}, {})));
+	SystemBus &bus = system.bus();
+	DisassemblyCache cache;
+
+	bus.write(0x0300, 0xA9); // LDA #$E8
+	bus.write(0x0301, 0xE8);
+	bus.write(0x0302, 0x60); // RTS
+	cache.log_executed(bus, 0x0300);
+	REQUIRE(cache.is_instruction_start(bus, 0x0302));
+	REQUIRE_FALSE(cache.is_instruction_start(bus, 0x0301));
+
+	// Self-modifying code: $0300 becomes INX, so $0301 now starts an instruction
+	bus.write(0x0300, 0xE8);
+	REQUIRE_FALSE(cache.was_executed(bus, 0x0300));
+	cache.log_executed(bus, 0x0300);
+	REQUIRE(cache.is_instruction_start(bus, 0x0301));
+	const std::vector<Address> expected = {0x0300, 0x0301, 0x0302};
+	REQUIRE(cache.window(bus, 0x0301, 1, 1) == expected);
+}
@@ -0,0 +1,104 @@
+// VibeNES - NES Emulator
+// DMC DMA Stall Tests
+// CPU cycles stolen by DMC sample fetches: get/put alignment and OAM DMA overlap
+
+#include "../../include/apu/apu.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/memory/ram.hpp"
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <set>
+
+using namespace nes;
+
+namespace {
+
+// CPU running NOPs in RAM while the DMC loops a sample at its fastest rate
+// (a fetch every 432 cycles). `offset` delays the sample's start by that
+// many cycles, which flips the get/put phase of every fetch.
+struct DmcRig {
+	std::shared_ptr<SystemBus> bus = std::make_shared<SystemBus>();
+	std::shared_ptr<Ram> ram = std::make_shared<Ram>();
+	std::shared_ptr<APU> apu = std::make_shared<APU>();
+	std::shared_ptr<CPU6502> cpu = std::make_shared<CPU6502>(bus.get());
+
+	explicit DmcRig(int offset = 0) {
+		bus->connect_ram(ram);
+		bus->connect_apu(apu);
+		bus->connect_cpu(cpu);
+		bus->power_on();
+		for (Address address = 0; address < LOOP_JUMP; ++address) {
+			bus->write(address, 0xEA); // NOP: two read cycles
+		}
+		bus->write(LOOP_JUMP, 0x4C); // JMP $0000: three read cycles
+		bus->write(LOOP_JUMP + 1, 0x00);
+		bus->write(LOOP_JUMP + 2, 0x00);
+		cpu->set_program_counter(0x0000);
+
+		bus->write(0x4017, 0x40); // No frame IRQ
+		bus->write(0x4010, 0x4F); // Loop, rate 15
+		bus->write(0x4012, 0x00);
+		bus->write(0x4013, 0x01);
+		for (int i = 0; i < offset; ++i) {
+			bus->tick_single_cpu_cycle();
+		}
+		bus->write(0x4015, 0x10);
+	}
+
+	// Cycles the next instruction stole for DMA beyond its own
+	int run_instruction() {
+		const int own = cpu->get_program_counter() == LOOP_JUMP ? 3 : 2;
+		return cpu->execute_instruction() - own;
+	}
+
+	static constexpr Address LOOP_JUMP = 0x07FD;
+};
+
+} // namespace
+
+TEST_CASE("DMC DMA Stall - Get/put alignment", "[cpu][dmc][dma]") {
+	// Halt, dummy, an alignment cycle only when the read would land on a
+	// put cycle, then the read. The fetch period is even and the program
+	// only reads, so each phase keeps one stall length throughout.
+	auto stalls = [](int offset) {
+		DmcRig rig(offset);
+		rig.run_instruction(); // The first fetch follows the $4015 write
+		std::set<int> seen;
+		int fetches = 0;
+		for (int i = 0; i < 30000; ++i) {
+			if (const int stolen = rig.run_instruction()) {
+				seen.insert(stolen);
+				++fetches;
+			}
+		}
+		REQUIRE(fetches > 80);
+		return seen;
+	};
+	const std::set<int> even = stalls(0);
+	const std::set<int> odd = stalls(1);
+	REQUIRE(even.size() == 1);
+	REQUIRE(odd.size() == 1);
+	std::set<int> both = even;
+	both.insert(odd.begin(), odd.end());
+	REQUIRE(both == std::set<int>{3, 4});
+}
+
+TEST_CASE("DMC DMA Stall - Overlapping OAM DMA", "[cpu][dmc][dma][oam]") {
+	DmcRig rig;
+
+	// Transfers back to back, each overlapping a fetch every 432 cycles
+	std::set<int> extra;
+	for (int i = 0; i < 16; ++i) {
+		rig.bus->write(0x4014, 0x02);
+		const int cycles = rig.cpu->execute_instruction();
+		REQUIRE(cycles >= 513);
+		extra.insert(cycles - 513);
+	}
+	// A fetch inside the transfer takes one of its read slots and one cycle
+	// to realign: 2 cycles, not the 3-4 of a standalone stall
+	REQUIRE(extra.count(2) == 1);
+	for (int cycles : extra) {
+		REQUIRE(cycles % 2 == 0);
+	}
+}
@@ -0,0 +1,125 @@
+// VibeNES - NES Emulator
+// Idle Loop Skipping Tests
+// Fast-forwarding polling loops must be indistinguishable from running them
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/core/bus.hpp"
+#include "../../include/cpu/cpu_6502.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using namespace nes;
+
+// NROM cart with code at $E000 and NMI/RESET/IRQ vectors into it
+static RomData build_idle_rom(const std::vector<Byte> &code, Address nmi, Address irq) {
+	std::vector<Byte> chr(8192);
+	for (std::size_t i = 0; i < chr.size(); ++i) {
+		chr[i] = static_cast<Byte>((i * 53) & 0xFF);
+	}
+	return test::make_nrom(code, {.nmi = nmi, .reset = 0xE000, .irq = irq}, std::move(chr));
+}
+
+// Waits for VBlank on PPUSTATUS, enables NMI, rendering and the APU frame
+// IRQ, then polls a RAM flag the NMI sets for 30 frames before parking in
+// JMP *. All three loop shapes the CPU recognises get exercised, with both
+// NMIs and APU IRQs ending them.
+static RomData build_polling_rom() {
+	const std::vector<Byte> code = {
+		0x78,			  // E000: SEI
+		0xA2, 0xFF,		  // E001: LDX #$FF
+		0x9A,			  // E003: TXS
+		0xA9, 0x00,		  // E004: LDA #$00
+		0x85, 0x10,		  // E006: STA $10
+		0x85, 0x11,		  // E008: STA $11
+		0x85, 0x13,		  // E00A: STA $13
+		0x2C, 0x02, 0x20, // E00C: BIT $2002
+		0x10, 0xFB,		  // E00F: BPL $E00C
+		0xA9, 0x80,		  // E011: LDA #$80 (NMI on)
+		0x8D, 0x00, 0x20, // E013: STA $2000
+		0xA9, 0x1E,		  // E016: LDA #$1E (BG + sprites)
+		0x8D, 0x01, 0x20, // E018: STA $2001
+		0xA9, 0x00,		  // E01B: LDA #$00 (4-step, frame IRQ on)
+		0x8D, 0x17, 0x40, // E01D: STA $4017
+		0x58,			  // E020: CLI
+		0xA5, 0x10,		  // E021: LDA $10
+		0xF0, 0xFC,		  // E023: BEQ $E021
+		0xA9, 0x00,		  // E025: LDA #$00
+		0x85, 0x10,		  // E027: STA $10
+		0xE6, 0x11,		  // E029: INC $11
+		0xA5, 0x11,		  // E02B: LDA $11
+		0xC9, 0x1E,		  // E02D: CMP #30
+		0xD0, 0xF0,		  // E02F: BNE $E021
+		0x4C, 0x31, 0xE0, // E031: JMP $E031
+		0xE6, 0x10,		  // E034: NMI: INC $10
+		0xAD, 0x02, 0x20, // E036: LDA $2002
+		0x40,			  // E039: RTI
+		0xAD, 0x15, 0x40, // E03A: IRQ: LDA $4015 (acknowledge)
+		0xE6, 0x13,		  // E03D: INC $13
+		0x40,			  // E03F: RTI
+	};
+	return build_idle_rom(code, 0xE034, 0xE03A);
+}
+
+TEST_CASE("Idle Loop Skipping Matches Full Execution", "[cpu][idle-loop]") {
+	HeadlessSystem skipping;
+	HeadlessSystem stepping;
+	stepping.cpu().set_idle_loop_skipping(false);
+
+	REQUIRE(skipping.cpu().is_idle_loop_skipping());
+	REQUIRE(skipping.load_rom_data(build_polling_rom()));
+	REQUIRE(stepping.load_rom_data(build_polling_rom()));
+
+	constexpr int FRAME_PIXELS = 256 * 240;
+	for (int frame = 0; frame < 60; ++frame) {
+		INFO("frame " << frame);
+		REQUIRE(skipping.run_frame() == stepping.run_frame());
+		REQUIRE(skipping.get_frame_count() == stepping.get_frame_count());
+		REQUIRE(skipping.cpu().get_program_counter() == stepping.cpu().get_program_counter());
+		REQUIRE(skipping.cpu().get_accumulator() == stepping.cpu().get_accumulator());
+		REQUIRE(skipping.cpu().get_status_register() == stepping.cpu().get_status_register());
+		REQUIRE(std::memcmp(skipping.get_frame_buffer(), stepping.get_frame_buffer(),
+							FRAME_PIXELS * sizeof(uint32_t)) == 0);
+	}
+
+	for (Address address = 0x0000; address < 0x0800; ++address) {
+		INFO("address " << address);
+		REQUIRE(skipping.bus().peek(address) == stepping.bus().peek(address));
+	}
+
+	// Reached the JMP * stage, took NMIs and APU IRQs, and actually skipped
+	REQUIRE(skipping.bus().peek(0x0011) == 30);
+	REQUIRE(skipping.bus().peek(0x0013) > 0);
+	REQUIRE(skipping.cpu().get_idle_cycles_skipped() > 0);
+	REQUIRE(stepping.cpu().get_idle_cycles_skipped() == 0);
+}
+
+TEST_CASE("Idle Loop Skipping Ignores Loops With Side Effects", "[cpu][idle-loop]") {
+	HeadlessSystem system;
+
+	SECTION("Loop that writes memory") {
+		const std::vector<Byte> code = {
+			0xE6, 0x00,		  // E000: INC $00
+			0x4C, 0x00, 0xE0, // E002: JMP $E000
+		};
+		REQUIRE(system.load_rom_data(build_idle_rom(code, 0xE000, 0xE000)));
+		system.run_frame();
+		REQUIRE(system.cpu().get_idle_cycles_skipped() == 0);
+	}
+
+	SECTION("Loop polling a register with read side effects") {
+		const std::vector<Byte> code = {
+			0xAD, 0x15, 0x40, // E000: LDA $4015
+			0xD0, 0xFB,		  // E003: BNE $E000
+			0xF0, 0xF9,		  // E005: BEQ $E000
+		};
+		REQUIRE(system.load_rom_data(build_idle_rom(code, 0xE000, 0xE000)));
+		system.run_frame();
+		REQUIRE(system.cpu().get_idle_cycles_skipped() == 0);
+	}
+}
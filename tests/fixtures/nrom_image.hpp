@@ -0,0 +1,50 @@
+// VibeNES - NES Emulator
+// NROM Image
+// The 32KB NROM cart tests build around their own 6502 programs
+
+#pragma once
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace nes::test {
+
+/// Where the CPU vectors point; $EAEA (the NOP sled's own bytes) when unset
+struct NromVectors {
+	Address nmi = 0xEAEA;
+	Address reset = 0x8000;
+	Address irq = 0xEAEA;
+};
+
+/**
+ * make_nrom - 32KB of NOPs with program copied in at the reset vector
+ *
+ * chr is the CHR ROM, its size giving the page count: one page of zeros by
+ * default, empty for CHR RAM. Tests of other boards set mapper_id and the
+ * like on the result.
+ */
+inline RomData make_nrom(std::span<const Byte> program, const NromVectors &vectors = {},
+						 std::vector<Byte> chr = std::vector<Byte>(8192, 0x00)) {
+	RomData rom{};
+	rom.mapper_id = 0;
+	rom.prg_rom_pages = 2;
+	rom.chr_rom_pages = static_cast<std::uint16_t>(chr.size() / 8192);
+	rom.valid = true;
+	rom.prg_rom.assign(32768, 0xEA);
+	std::copy(program.begin(), program.end(), rom.prg_rom.begin() + (vectors.reset - 0x8000));
+	const auto put_vector = [&rom](std::size_t at, Address target) {
+		rom.prg_rom[at] = static_cast<Byte>(target & 0xFF);
+		rom.prg_rom[at + 1] = static_cast<Byte>(target >> 8);
+	};
+	put_vector(0x7FFA, vectors.nmi);
+	put_vector(0x7FFC, vectors.reset);
+	put_vector(0x7FFE, vectors.irq);
+	rom.chr_rom = std::move(chr);
+	return rom;
+}
+
+} // namespace nes::test
@@ -0,0 +1,56 @@
+// VibeNES - NES Emulator
+// PRG RAM Cartridge
+// A cartridge with plain RAM at $8000-$FFFF, for tests that write their
+// vectors and code there through the bus
+
+#pragma once
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/mappers/mapper.hpp"
+#include <array>
+#include <memory>
+
+namespace nes::test {
+
+class PrgRamMapper final : public Mapper {
+  public:
+	Byte cpu_read(Address address) const override {
+		return address >= 0x8000 ? prg_[address - 0x8000] : Byte{0xFF};
+	}
+	void cpu_write(Address address, Byte value) override {
+		if (address >= 0x8000) {
+			prg_[address - 0x8000] = value;
+		}
+	}
+	Byte ppu_read(Address) const override {
+		return 0;
+	}
+	void ppu_write(Address, Byte) override {
+	}
+	std::uint8_t get_mapper_id() const noexcept override {
+		return 0xFF;
+	}
+	const char *get_name() const noexcept override {
+		return "Test PRG RAM";
+	}
+	void reset() override {
+	}
+	Mirroring get_mirroring() const noexcept override {
+		return Mirroring::Horizontal;
+	}
+	void serialize_registers(std::vector<uint8_t> &) const override {
+	}
+	void deserialize_registers(const std::vector<uint8_t> &, size_t &) override {
+	}
+
+  private:
+	std::array<Byte, 0x8000> prg_{};
+};
+
+inline std::shared_ptr<Cartridge> make_prg_ram_cartridge() {
+	auto cartridge = std::make_shared<Cartridge>();
+	cartridge->load_mapper(std::make_unique<PrgRamMapper>());
+	return cartridge;
+}
+
+} // namespace nes::test
@@ -0,0 +1,212 @@
+// VibeNES - NES Emulator
+// Controller Tests
+// Strobe, serial reads, latching from a snapshot or a plain input source, and
+// the Four Score, Zapper and Arkanoid paddle
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/input/controller.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/nes_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <memory>
+
+using namespace nes;
+
+namespace {
+
+// Answers through read_buttons() only, like the movie and replay sources
+class CallCountingSource final : public InputSource {
+  public:
+	[[nodiscard]] Byte read_buttons(int player_index) const override {
+		++calls;
+		return player_index == 0 ? 0xA5 : 0x3C;
+	}
+	mutable int calls = 0;
+};
+
+Byte shift_out(const Controller &controller, Address port) {
+	Byte value = 0;
+	for (int bit = 0; bit < 8; ++bit) {
+		value |= static_cast<Byte>((controller.read(port) & 0x01) << bit);
+	}
+	return value;
+}
+
+void strobe(Controller &controller) {
+	controller.write(0x01);
+	controller.write(0x00);
+}
+
+// A white screen, and a Zapper in port 2 (NES 2.0 expansion device 8)
+RomData make_white_screen_rom() {
+	const std::array<uint8_t, 29> program = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xA9, 0x3F,		  //       LDA #$3F
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x06, 0x20, //       STA $2006
+		0xA9, 0x30,		  //       LDA #$30 (white)
+		0x8D, 0x07, 0x20, //       STA $2007
+		0xA9, 0x0A,		  //       LDA #$0A
+		0x8D, 0x01, 0x20, //       STA $2001 (background on)
+		0xE8,			  // $8019 INX (busy, so no idle-loop skip)
+		0x4C, 0x19, 0x80, //       JMP $8019
+	};
+	RomData rom = test::make_nrom(program);
+	rom.nes2_0 = true;
+	rom.expansion_device = 0x08;
+	return rom;
+}
+
+} // namespace
+
+TEST_CASE("Controller - Latches the published snapshot", "[input][controller]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	REQUIRE(input->button_snapshot() != nullptr);
+	Controller controller(input);
+	controller.power_on();
+
+	input->set_all(0x81, 0x42);
+	strobe(controller);
+	REQUIRE(controller.get_button_states(0) == 0x81);
+	REQUIRE(controller.get_button_states(1) == 0x42);
+
+	// Changes after the strobe wait for the next one
+	input->set_buttons(0, 0x10);
+	REQUIRE(shift_out(controller, 0x4016) == 0x81);
+	REQUIRE(shift_out(controller, 0x4017) == 0x42);
+	REQUIRE(controller.read(0x4016) == 0x41); // Past the eighth bit
+
+	strobe(controller);
+	REQUIRE(shift_out(controller, 0x4016) == 0x10);
+	REQUIRE(shift_out(controller, 0x4017) == 0x42); // set_buttons() kept player 2
+
+	// Strobe held high reports A live
+	controller.write(0x01);
+	input->set_buttons(1, 0x01);
+	REQUIRE(controller.read(0x4017) == 0x41);
+	input->set_buttons(1, 0x00);
+	REQUIRE(controller.read(0x4017) == 0x40);
+}
+
+TEST_CASE("Controller - Sources without a snapshot are asked directly", "[input][controller]") {
+	auto input = std::make_shared<CallCountingSource>();
+	REQUIRE(input->button_snapshot() == nullptr);
+	Controller controller(input);
+	controller.power_on();
+
+	strobe(controller);
+	REQUIRE(input->calls == 2);
+	REQUIRE(shift_out(controller, 0x4016) == 0xA5);
+	REQUIRE(shift_out(controller, 0x4017) == 0x3C);
+
+	Controller unplugged(nullptr);
+	strobe(unplugged);
+	REQUIRE(shift_out(unplugged, 0x4016) == 0x00);
+}
+
+TEST_CASE("Controller - Four Score", "[input][controller]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	Controller controller(input);
+	controller.power_on();
+	controller.configure({PortDevice::Zapper, PortDevice::None, true}); // The multitap only takes pads
+
+	input->set_buttons(0, 0x01);
+	input->set_buttons(1, 0x02);
+	input->set_buttons(2, 0x03);
+	input->set_buttons(3, 0x04);
+	strobe(controller);
+	REQUIRE(controller.get_button_states(2) == 0x03);
+	REQUIRE(controller.get_button_states(3) == 0x04);
+
+	// Own pad, the second pad on the port, then the port's signature
+	REQUIRE(shift_out(controller, 0x4016) == 0x01);
+	REQUIRE(shift_out(controller, 0x4016) == 0x03);
+	REQUIRE(shift_out(controller, 0x4016) == 0x10);
+	REQUIRE(shift_out(controller, 0x4017) == 0x02);
+	REQUIRE(shift_out(controller, 0x4017) == 0x04);
+	REQUIRE(shift_out(controller, 0x4017) == 0x20);
+	REQUIRE(controller.read(0x4016) == 0x41);
+
+	// Unplugged, players 3 and 4 are neither latched nor shifted out
+	controller.configure({});
+	strobe(controller);
+	REQUIRE(controller.get_button_states(2) == 0x00);
+	REQUIRE(shift_out(controller, 0x4016) == 0x01);
+	REQUIRE(shift_out(controller, 0x4016) == 0xFF);
+}
+
+TEST_CASE("Controller - Arkanoid paddle", "[input][controller]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	Controller controller(input);
+	controller.power_on();
+	controller.configure(input_setup_for_expansion_device(0x0F));
+	REQUIRE(controller.setup().port2 == PortDevice::ArkanoidPaddle);
+	REQUIRE_FALSE(controller.reads_ppu());
+
+	input->set_pointer(1, {0xA5, -1, false});
+	strobe(controller);
+	input->set_pointer(1, {0x00, -1, true}); // Moves after the latch wait for the next one
+
+	// Position on D4, inverted, most significant bit first; the button on D3
+	Byte position = 0;
+	for (int bit = 0; bit < 8; ++bit) {
+		const Byte value = controller.read(0x4017);
+		REQUIRE((value & 0x08) != 0);
+		position = static_cast<Byte>((position << 1) | ((value >> 4) & 0x01));
+	}
+	REQUIRE(static_cast<Byte>(~position) == 0xA5);
+
+	// Port 1 still has a pad
+	input->set_buttons(0, 0x81);
+	strobe(controller);
+	REQUIRE(shift_out(controller, 0x4016) == 0x81);
+}
+
+TEST_CASE("Controller - Devices from the NES 2.0 header", "[input][controller]") {
+	REQUIRE_FALSE(input_setup_for_expansion_device(0x00).four_score);
+	REQUIRE(input_setup_for_expansion_device(0x01).port2 == PortDevice::StandardPad);
+	REQUIRE(input_setup_for_expansion_device(0x02).four_score);
+	REQUIRE(input_setup_for_expansion_device(0x08).port1 == PortDevice::StandardPad);
+	REQUIRE(input_setup_for_expansion_device(0x08).port2 == PortDevice::Zapper);
+	REQUIRE(input_setup_for_expansion_device(0x09).port1 == PortDevice::Zapper);
+	REQUIRE(input_setup_for_expansion_device(0x03).port1 == PortDevice::StandardPad); // Famicom adapter: not emulated
+
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system(input);
+	REQUIRE(system.load_rom_data(make_white_screen_rom()));
+	REQUIRE(system.system().controllers().setup().port2 == PortDevice::Zapper);
+	REQUIRE(system.system().controllers().reads_ppu());
+}
+
+TEST_CASE("Controller - Zapper sees the beam", "[input][controller]") {
+	auto input = std::make_shared<LatchedInputSource>();
+	HeadlessSystem system(input);
+	REQUIRE(system.load_rom_data(make_white_screen_rom()));
+	for (int frame = 0; frame < 3; ++frame) {
+		system.run_frame();
+	}
+	while (system.ppu().get_current_scanline() < 120 || system.ppu().get_current_scanline() > 122) {
+		system.run_cycles(1);
+	}
+
+	const auto zapper = [&](int x, int y, bool fire = false) {
+		input->set_pointer(1, {static_cast<std::int16_t>(x), static_cast<std::int16_t>(y), fire});
+		return system.bus().read(0x4017);
+	};
+	REQUIRE((zapper(128, 110) & 0x08) == 0); // Drawn 10 lines ago: light
+	REQUIRE((zapper(128, 150) & 0x08) != 0); // Not drawn yet
+	REQUIRE((zapper(128, 60) & 0x08) != 0);	 // Drawn too long ago
+	REQUIRE((zapper(-1, -1) & 0x08) != 0);	 // Off screen
+	REQUIRE((zapper(128, 110, true) & 0x10) != 0);
+	REQUIRE((zapper(128, 110) & 0x10) == 0);
+
+	// A pad in port 1 is unaffected
+	REQUIRE((system.bus().read(0x4016) & 0x18) == 0);
+}
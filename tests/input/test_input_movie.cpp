@@ -0,0 +1,211 @@
+// VibeNES - NES Emulator
+// Input Movie Tests
+// .vnmovie recording and playback: run-length input, header checks and
+// bit-exact replays from power-on or a start state
+
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/input/input_movie.hpp"
+#include "../../include/input/latched_input.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../../include/system/save_state.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+std::filesystem::path temp_movie_path(const char *name) {
+	return std::filesystem::temp_directory_path() / name;
+}
+
+// Reads the pads every frame and folds them into RAM, so the state depends
+// on the exact input of every frame
+RomData make_input_sum_rom() {
+	const std::array<uint8_t, 41> program = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0xA9, 0x01,		  //       LDA #$01
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA9, 0x00,		  //       LDA #$00
+		0x8D, 0x16, 0x40, //       STA $4016
+		0xA2, 0x08,		  //       LDX #$08
+		0xAD, 0x16, 0x40, // $8011 LDA $4016
+		0x4A,			  //       LSR A
+		0x26, 0x10,		  //       ROL $10
+		0xAD, 0x17, 0x40, //       LDA $4017
+		0x4A,			  //       LSR A
+		0x26, 0x11,		  //       ROL $11
+		0xCA,			  //       DEX
+		0xD0, 0xF1,		  //       BNE $8011
+		0xA5, 0x10,		  //       LDA $10
+		0x65, 0x12,		  //       ADC $12
+		0x85, 0x12,		  //       STA $12
+		0x4C, 0x00, 0x80, //       JMP $8000
+	};
+	return test::make_nrom(program);
+}
+
+// Button masks that change every few frames
+std::array<Byte, 2> scripted_buttons(int frame) {
+	return {static_cast<Byte>((frame / 7) * 0x25), static_cast<Byte>((frame / 3) & 0x0F)};
+}
+
+struct MovieSystem {
+	std::shared_ptr<InputSource> input;
+	HeadlessSystem system;
+	SaveStateManager states{&system.cpu(), &system.ppu(), &system.apu(), &system.bus(), &system.cartridge()};
+
+	explicit MovieSystem(std::shared_ptr<InputSource> source) : input(source), system(std::move(source)) {
+		REQUIRE(system.load_rom_data(make_input_sum_rom()));
+	}
+	// Save-state bytes without the header (its timestamp differs)
+	std::vector<uint8_t> state() {
+		std::vector<uint8_t> bytes = states.serialize_state();
+		bytes.erase(bytes.begin(), bytes.begin() + sizeof(SaveStateHeader));
+		return bytes;
+	}
+};
+
+} // namespace
+
+TEST_CASE("Input Movie - Record And Play Back", "[input][movie]") {
+	const std::filesystem::path path = temp_movie_path("vibenes_test_movie.vnmovie");
+	auto pads = std::make_shared<LatchedInputSource>();
+	MovieRecorder recorder(pads);
+	REQUIRE(recorder.open(path, 0x12345678));
+	for (int frame = 0; frame < 500; ++frame) {
+		const std::array<Byte, 2> buttons = scripted_buttons(frame);
+		pads->set_buttons(0, buttons[0]);
+		pads->set_buttons(1, buttons[1]);
+		recorder.next_frame();
+		REQUIRE(recorder.read_buttons(0) == buttons[0]);
+	}
+	REQUIRE(recorder.get_frames_recorded() == 500);
+	REQUIRE(recorder.close());
+
+	// Runs, not frames: three bytes per change of input (about 215 here)
+	REQUIRE(std::filesystem::file_size(path) < sizeof(MovieHeader) + 250 * 3);
+
+	MoviePlayer player;
+	REQUIRE(player.open(path));
+	REQUIRE(player.get_header().rom_crc32 == 0x12345678);
+	REQUIRE(player.get_header().frame_count == 500);
+	REQUIRE(player.get_start_state().empty());
+	bool exact = true;
+	for (int frame = 0; frame < 500; ++frame) {
+		REQUIRE(player.next_frame());
+		exact = exact && player.read_buttons(0) == scripted_buttons(frame)[0] &&
+				player.read_buttons(1) == scripted_buttons(frame)[1];
+	}
+	REQUIRE(exact);
+	// Released once it runs out
+	REQUIRE_FALSE(player.next_frame());
+	REQUIRE(player.read_buttons(0) == 0x00);
+	REQUIRE(player.get_frames_played() == 500);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Input Movie - Long Holds", "[input][movie]") {
+	const std::filesystem::path path = temp_movie_path("vibenes_test_movie_hold.vnmovie");
+	auto pads = std::make_shared<LatchedInputSource>();
+	pads->set_buttons(0, 0x81);
+	{
+		MovieRecorder recorder(pads);
+		REQUIRE(recorder.open(path, 0));
+		for (int frame = 0; frame < 100000; ++frame) {
+			recorder.next_frame();
+		}
+	} // Closed by the destructor
+	REQUIRE(std::filesystem::file_size(path) == sizeof(MovieHeader) + 2 + 3);
+
+	MoviePlayer player;
+	REQUIRE(player.open(path));
+	REQUIRE(player.get_header().frame_count == 100000);
+	int frames = 0;
+	while (player.next_frame() && player.read_buttons(0) == 0x81) {
+		++frames;
+	}
+	REQUIRE(frames == 100000);
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Input Movie - Rejects Other Files", "[input][movie]") {
+	const std::filesystem::path path = temp_movie_path("vibenes_test_not_a_movie.vnmovie");
+	std::ofstream(path, std::ios::binary) << "VNTRACE\0 definitely not a movie file";
+	MoviePlayer player;
+	REQUIRE_FALSE(player.open(path));
+	REQUIRE_FALSE(player.open(temp_movie_path("vibenes_test_missing.vnmovie")));
+	REQUIRE_FALSE(player.next_frame());
+
+	// A start state larger than the rest of the file
+	MovieHeader header;
+	header.start_state_size = 0xFFFFFFFF;
+	std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char *>(&header), sizeof(header)) << "input";
+	REQUIRE_FALSE(player.open(path));
+	REQUIRE(player.get_start_state().empty());
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Input Movie - Bit-Exact Replay", "[input][movie]") {
+	const std::filesystem::path path = temp_movie_path("vibenes_test_movie_replay.vnmovie");
+	const bool from_state = GENERATE(false, true);
+
+	// Record a live run
+	auto pads = std::make_shared<LatchedInputSource>();
+	auto recorder = std::make_shared<MovieRecorder>(pads);
+	MovieSystem live(recorder);
+	std::vector<uint8_t> start_state;
+	if (from_state) {
+		pads->set_buttons(0, 0x11);
+		for (int frame = 0; frame < 30; ++frame) {
+			live.system.run_frame();
+		}
+		start_state = live.states.serialize_state();
+	}
+	REQUIRE(recorder->open(path, live.states.calculate_rom_crc32(), start_state));
+	for (int frame = 0; frame < 240; ++frame) {
+		const std::array<Byte, 2> buttons = scripted_buttons(frame);
+		pads->set_buttons(0, buttons[0]);
+		pads->set_buttons(1, buttons[1]);
+		recorder->next_frame();
+		live.system.run_frame();
+	}
+	REQUIRE(recorder->close());
+	const std::vector<uint8_t> expected = live.state();
+
+	// ...and replay it on a fresh system
+	auto player = std::make_shared<MoviePlayer>();
+	REQUIRE(player->open(path));
+	MovieSystem replay(player);
+	REQUIRE(player->get_header().rom_crc32 == replay.states.calculate_rom_crc32());
+	REQUIRE(player->get_start_state().empty() == !from_state);
+	if (from_state) {
+		REQUIRE(replay.states.deserialize_state(player->get_start_state()));
+	}
+	while (player->next_frame()) {
+		replay.system.run_frame();
+	}
+	REQUIRE(player->get_frames_played() == 240);
+	REQUIRE(replay.state() == expected);
+
+	// The input does show in the state
+	MovieSystem idle(nullptr);
+	if (from_state) {
+		REQUIRE(idle.states.deserialize_state(start_state));
+	}
+	for (int frame = 0; frame < 240; ++frame) {
+		idle.system.run_frame();
+	}
+	REQUIRE(idle.state() != expected);
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,68 @@
+// VibeNES - NES Emulator
+// Replay Input Tests
+// Tests for ReplayInputSource file parsing and frame-locked playback
+
+#include "../../include/input/replay_input.hpp"
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace nes;
+
+static std::filesystem::path write_replay(const std::string &name, const std::string &contents) {
+	auto path = std::filesystem::temp_directory_path() / name;
+	std::ofstream(path) << contents;
+	return path;
+}
+
+TEST_CASE("Replay Input - Playback", "[input][replay]") {
+	ReplayInputSource replay;
+
+	SECTION("Masks hold until the next event") {
+		auto path = write_replay("vibenes_replay_hold.txt", "# frame p1 p2\n"
+															"0 00\n"
+															"10 08 01   # Start, P2 A\n"
+															"\n"
+															"12 00\n");
+		REQUIRE(replay.load_from_file(path));
+		REQUIRE(replay.get_event_count() == 3);
+
+		replay.set_frame(9);
+		REQUIRE(replay.read_buttons(0) == 0x00);
+		replay.set_frame(10);
+		REQUIRE(replay.read_buttons(0) == 0x08);
+		REQUIRE(replay.read_buttons(1) == 0x01);
+		replay.set_frame(11);
+		REQUIRE(replay.read_buttons(0) == 0x08);
+		replay.set_frame(12);
+		REQUIRE(replay.read_buttons(0) == 0x00);
+		REQUIRE(replay.read_buttons(1) == 0x00);
+
+		// Seeking backwards replays the earlier state
+		replay.set_frame(10);
+		REQUIRE(replay.read_buttons(0) == 0x08);
+		std::filesystem::remove(path);
+	}
+
+	SECTION("Frames before the first event read as released") {
+		auto path = write_replay("vibenes_replay_late.txt", "5 FF\n");
+		REQUIRE(replay.load_from_file(path));
+		replay.set_frame(0);
+		REQUIRE(replay.read_buttons(0) == 0x00);
+		replay.set_frame(5);
+		REQUIRE(replay.read_buttons(0) == 0xFF);
+		REQUIRE(replay.read_buttons(2) == 0x00); // Out of range player
+		std::filesystem::remove(path);
+	}
+
+	SECTION("Malformed lines are rejected") {
+		auto path = write_replay("vibenes_replay_bad.txt", "0 00\nstart 08\n");
+		REQUIRE_FALSE(replay.load_from_file(path));
+		std::filesystem::remove(path);
+	}
+
+	SECTION("Missing file is rejected") {
+		REQUIRE_FALSE(replay.load_from_file("/nonexistent/vibenes_replay.txt"));
+	}
+}
@@ -0,0 +1,230 @@
+// VibeNES - NES Emulator
+// MMC3 A12 prediction tests
+// Predicted A12 clocks must hit the MMC3 on exactly the dots edge tracking
+// does, and the catch-up deadline must land on the IRQ dot itself.
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+constexpr int DOTS_PER_FRAME = 341 * 262;
+
+std::shared_ptr<Cartridge> make_mmc3_cartridge() {
+	std::vector<Byte> chr(8192);
+	for (std::size_t i = 0; i < chr.size(); ++i) {
+		chr[i] = static_cast<uint8_t>((i * 37) & 0xFF);
+	}
+	RomData rom = test::make_nrom({}, {}, std::move(chr));
+	rom.mapper_id = 4;
+	rom.vertical_mirroring = true;
+
+	auto cartridge = std::make_shared<Cartridge>();
+	cartridge->load_from_rom_data(rom);
+	return cartridge;
+}
+
+void arm_irq(Cartridge &cartridge, uint8_t latch) {
+	cartridge.cpu_write(0xC000, latch);
+	cartridge.cpu_write(0xC001, 0x00);
+	cartridge.cpu_write(0xE001, 0x00);
+}
+
+// Sprites spread down the screen so some lines fetch real patterns
+void setup_scene(PPU &ppu, uint8_t ctrl) {
+	for (int sprite = 0; sprite < 64; ++sprite) {
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 0), static_cast<uint8_t>(sprite * 3));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 1), static_cast<uint8_t>(sprite * 11));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 2), 0x00);
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 3), static_cast<uint8_t>(sprite * 37));
+	}
+	ppu.write_register(0x2000, ctrl);
+	ppu.write_register(0x2001, 0x1E);
+}
+
+struct PredictionPair {
+	PredictionPair()
+		: cart_predicted(make_mmc3_cartridge()), cart_tracked(make_mmc3_cartridge()),
+		  predicted_ppu(std::make_unique<PPU>()), tracked_ppu(std::make_unique<PPU>()), predicted(*predicted_ppu),
+		  tracked(*tracked_ppu) {
+		predicted.connect_cartridge(cart_predicted);
+		tracked.connect_cartridge(cart_tracked);
+		predicted.power_on();
+		tracked.power_on();
+		tracked.set_a12_prediction(false);
+	}
+
+	void write_register(uint16_t address, uint8_t value) {
+		predicted.write_register(address, value);
+		tracked.write_register(address, value);
+	}
+
+	// Step both a dot at a time; the MMC3 IRQ must rise on the same dot.
+	// Each IRQ is acknowledged and re-enabled, as a handler would.
+	int run_dots(int dots) {
+		int irqs = 0;
+		for (int dot = 0; dot < dots; ++dot) {
+			predicted.tick_single_dot();
+			tracked.tick_single_dot();
+			REQUIRE(cart_predicted->is_irq_pending() == cart_tracked->is_irq_pending());
+			if (cart_predicted->is_irq_pending()) {
+				++irqs;
+				for (auto *cart : {cart_predicted.get(), cart_tracked.get()}) {
+					cart->cpu_write(0xE000, 0x00);
+					cart->cpu_write(0xE001, 0x00);
+				}
+			}
+		}
+		return irqs;
+	}
+
+	void require_identical() const {
+		std::vector<uint8_t> state_predicted;
+		std::vector<uint8_t> state_tracked;
+		predicted.serialize_state(state_predicted);
+		tracked.serialize_state(state_tracked);
+		REQUIRE(state_predicted == state_tracked);
+
+		std::vector<uint8_t> mapper_predicted;
+		std::vector<uint8_t> mapper_tracked;
+		cart_predicted->serialize_state(mapper_predicted);
+		cart_tracked->serialize_state(mapper_tracked);
+		REQUIRE(mapper_predicted == mapper_tracked);
+	}
+
+	std::shared_ptr<Cartridge> cart_predicted;
+	std::shared_ptr<Cartridge> cart_tracked;
+	std::unique_ptr<PPU> predicted_ppu;
+	std::unique_ptr<PPU> tracked_ppu;
+	PPU &predicted;
+	PPU &tracked;
+};
+
+} // namespace
+
+TEST_CASE("A12 Prediction - Matches edge tracking", "[ppu][a12-prediction][mmc3]") {
+	// Sprites at $1000, background at $1000, and two setups that always track
+	auto ctrl = GENERATE(as<uint8_t>{}, 0x08, 0x10, 0x18, 0x28);
+	const bool predictable = ctrl == 0x08 || ctrl == 0x10;
+
+	PredictionPair pair;
+	arm_irq(*pair.cart_predicted, 7);
+	arm_irq(*pair.cart_tracked, 7);
+	setup_scene(pair.predicted, ctrl);
+	setup_scene(pair.tracked, ctrl);
+	REQUIRE_FALSE(pair.tracked.is_predicting_a12());
+
+	const int irqs = pair.run_dots(DOTS_PER_FRAME * 2);
+	REQUIRE(pair.predicted.is_predicting_a12() == predictable);
+	if (predictable) {
+		REQUIRE(irqs > 0);
+	}
+	pair.require_identical();
+}
+
+TEST_CASE("A12 Prediction - Mid-frame setup changes", "[ppu][a12-prediction][mmc3]") {
+	PredictionPair pair;
+	arm_irq(*pair.cart_predicted, 3);
+	arm_irq(*pair.cart_tracked, 3);
+	setup_scene(pair.predicted, 0x08);
+	setup_scene(pair.tracked, 0x08);
+	pair.run_dots(DOTS_PER_FRAME);
+	REQUIRE(pair.predicted.is_predicting_a12());
+
+	SECTION("Pattern tables swap inside a window") {
+		pair.run_dots(341 * 20 + 290); // Inside the sprite fetches
+		pair.require_identical();
+		pair.write_register(0x2000, 0x10);
+		REQUIRE_FALSE(pair.predicted.is_predicting_a12());
+		pair.require_identical();
+		pair.run_dots(341 * 30 + 3);
+		REQUIRE(pair.predicted.is_predicting_a12());
+		pair.write_register(0x2000, 0x08); // Background window in progress
+		pair.run_dots(DOTS_PER_FRAME);
+		pair.require_identical();
+	}
+
+	SECTION("Rendering toggles and 8x16 sprites") {
+		pair.run_dots(341 * 50 + 100);
+		pair.write_register(0x2001, 0x00);
+		pair.run_dots(341 * 3 + 17);
+		pair.write_register(0x2001, 0x1E);
+		pair.run_dots(341 * 10);
+		pair.write_register(0x2000, 0x28);
+		REQUIRE_FALSE(pair.predicted.is_predicting_a12());
+		pair.run_dots(341 * 10 + 200);
+		pair.write_register(0x2000, 0x10);
+		pair.run_dots(DOTS_PER_FRAME);
+		REQUIRE(pair.predicted.is_predicting_a12());
+		pair.require_identical();
+	}
+
+	SECTION("Save state restored mid-window") {
+		pair.run_dots(341 * 100 + 300);
+		std::vector<uint8_t> state;
+		pair.predicted.serialize_state(state);
+		size_t offset = 0;
+		pair.predicted.deserialize_state(state, offset);
+		REQUIRE_FALSE(pair.predicted.is_predicting_a12());
+		pair.run_dots(DOTS_PER_FRAME);
+		REQUIRE(pair.predicted.is_predicting_a12());
+		pair.require_identical();
+	}
+}
+
+TEST_CASE("A12 Prediction - Deadline is the IRQ dot", "[ppu][a12-prediction][catch-up]") {
+	auto ctrl = GENERATE(as<uint8_t>{}, 0x08, 0x10);
+	auto latch = GENERATE(as<uint8_t>{}, 0, 1, 20, 200);
+
+	auto cartridge = make_mmc3_cartridge();
+	PPU ppu;
+	ppu.connect_cartridge(cartridge);
+	ppu.power_on();
+	setup_scene(ppu, ctrl);
+	ppu.tick_dots(DOTS_PER_FRAME + 341 * 30 + 123); // Predicting by now
+	REQUIRE(ppu.is_predicting_a12());
+	arm_irq(*cartridge, latch);
+
+	// Walk sync points until the IRQ; it must rise on the last dot of one
+	bool fired = false;
+	for (int step = 0; step < 20 && !fired; ++step) {
+		const uint32_t dots = ppu.dots_until_sync_point();
+		if (dots > 1) {
+			ppu.tick_dots(static_cast<int>(dots - 1));
+			REQUIRE_FALSE(cartridge->is_irq_pending());
+		}
+		ppu.tick_dots(1);
+		fired = cartridge->is_irq_pending();
+	}
+	REQUIRE(fired);
+	const int expected_cycle = ctrl == 0x08 ? 262 : 326; // Counter clocked while running dot 261 / 325
+	if (ppu.get_current_scanline() != 261 || ctrl == 0x08) {
+		REQUIRE(ppu.get_current_cycle() == expected_cycle);
+	}
+}
+
+TEST_CASE("A12 Prediction - Deadline looks past the filter bound", "[ppu][a12-prediction][catch-up]") {
+	auto cartridge = make_mmc3_cartridge();
+	PPU ppu;
+	ppu.connect_cartridge(cartridge);
+	ppu.power_on();
+	setup_scene(ppu, 0x08);
+	ppu.tick_dots(DOTS_PER_FRAME + 341 * 10);
+	arm_irq(*cartridge, 20);
+
+	// 21 clocks away (reload, then 20), one per line: far more than the
+	// 21 * 15 dots the unpredicted filter bound allows
+	REQUIRE(ppu.dots_until_sync_point() > 20u * 341u);
+
+	ppu.set_a12_prediction(false);
+	REQUIRE_FALSE(ppu.is_predicting_a12());
+	REQUIRE(ppu.dots_until_sync_point() <= 20u * 15u + 1u);
+}
@@ -0,0 +1,161 @@
+// VibeNES - NES Emulator
+// Accuracy Profile Tests
+// Fast must draw the same frames and keep the same frame timing as Strict,
+// differing only in the dot the sprite-0 hit flag goes up on.
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+constexpr int DOTS_PER_FRAME = 341 * 262;
+
+std::shared_ptr<Cartridge> make_cartridge() {
+	std::vector<Byte> chr(8192);
+	uint32_t seed = 0x2468ACEu;
+	for (auto &byte : chr) {
+		seed = seed * 1103515245u + 12345u;
+		byte = static_cast<uint8_t>(seed >> 16);
+	}
+	RomData rom = test::make_nrom({}, {}, std::move(chr));
+	rom.vertical_mirroring = true;
+
+	auto cartridge = std::make_shared<Cartridge>();
+	cartridge->load_from_rom_data(rom);
+	return cartridge;
+}
+
+// Varied nametables and palettes, sprite 0 over opaque background, rendering on
+void setup_scene(PPU &ppu) {
+	ppu.write_register(0x2001, 0x00);
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2006, 0x20);
+	ppu.write_register(0x2006, 0x00);
+	for (int i = 0; i < 0x800; ++i) {
+		ppu.write_register(0x2007, static_cast<uint8_t>((i * 7) ^ (i >> 3)));
+	}
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2006, 0x3F);
+	ppu.write_register(0x2006, 0x00);
+	for (int i = 0; i < 32; ++i) {
+		ppu.write_register(0x2007, static_cast<uint8_t>((i * 5 + 1) & 0x3F));
+	}
+	for (int sprite = 0; sprite < 64; ++sprite) {
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 0), static_cast<uint8_t>(20 + sprite * 3));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 1), static_cast<uint8_t>(sprite * 11));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 2), static_cast<uint8_t>(sprite & 0xE3));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 3), static_cast<uint8_t>(40 + sprite * 37));
+	}
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2005, 3);
+	ppu.write_register(0x2005, 0);
+	ppu.write_register(0x2000, 0x00);
+	ppu.write_register(0x2001, 0x1E);
+}
+
+struct PpuPair {
+	PpuPair() : cart_strict(make_cartridge()), cart_fast(make_cartridge()) {
+		strict = std::make_unique<PPU>();
+		fast = std::make_unique<PPU>();
+		strict->connect_cartridge(cart_strict);
+		fast->connect_cartridge(cart_fast);
+		strict->power_on();
+		fast->power_on();
+		fast->set_accuracy(Accuracy::Fast);
+		setup_scene(*strict);
+		setup_scene(*fast);
+	}
+
+	void require_identical() const {
+		REQUIRE(strict->get_current_scanline() == fast->get_current_scanline());
+		REQUIRE(strict->get_current_cycle() == fast->get_current_cycle());
+		REQUIRE(strict->get_dot_counter() == fast->get_dot_counter());
+		REQUIRE(strict->get_status_register() == fast->get_status_register());
+		REQUIRE(std::memcmp(strict->get_frame_buffer(), fast->get_frame_buffer(), 256 * 240 * sizeof(uint32_t)) ==
+				0);
+
+		std::vector<uint8_t> state_strict;
+		std::vector<uint8_t> state_fast;
+		strict->serialize_state(state_strict);
+		fast->serialize_state(state_fast);
+		REQUIRE(state_strict == state_fast);
+	}
+
+	// Dot counter when the sprite-0 hit flag was first seen, one dot at a time
+	static uint32_t sprite_0_flag_dot(PPU &ppu) {
+		for (int dot = 0; dot < 2 * DOTS_PER_FRAME; ++dot) {
+			ppu.tick_dots(1);
+			if (ppu.get_status_register() & PPUConstants::PPUSTATUS_SPRITE0_MASK) {
+				return ppu.get_dot_counter();
+			}
+		}
+		return 0;
+	}
+
+	std::shared_ptr<Cartridge> cart_strict;
+	std::shared_ptr<Cartridge> cart_fast;
+	std::unique_ptr<PPU> strict;
+	std::unique_ptr<PPU> fast;
+};
+
+} // namespace
+
+TEST_CASE("Accuracy Profiles - Fast matches Strict at frame boundaries", "[ppu][accuracy]") {
+	PpuPair pair;
+	REQUIRE(pair.strict->get_accuracy() == Accuracy::Strict);
+	REQUIRE(pair.fast->get_accuracy() == Accuracy::Fast);
+
+	SECTION("Whole frames in one call (batched scanlines)") {
+		for (int frame = 0; frame < 4; ++frame) {
+			pair.strict->tick_dots(DOTS_PER_FRAME);
+			pair.fast->tick_dots(DOTS_PER_FRAME);
+			pair.require_identical();
+		}
+	}
+
+	SECTION("Three dots per call (dot path), odd frames included") {
+		pair.strict->set_scanline_batching(false);
+		pair.fast->set_scanline_batching(false);
+		for (int frame = 0; frame < 3; ++frame) {
+			for (int dot = 0; dot < DOTS_PER_FRAME; dot += 3) {
+				pair.strict->tick_dots(3);
+				pair.fast->tick_dots(3);
+			}
+			pair.require_identical();
+		}
+	}
+}
+
+TEST_CASE("Accuracy Profiles - Sprite 0 hit flag", "[ppu][accuracy][sprite0]") {
+	PpuPair pair;
+	pair.strict->set_scanline_batching(false);
+	pair.fast->set_scanline_batching(false);
+
+	SECTION("Strict raises it two dots after the hit, Fast on the hit dot") {
+		const uint32_t strict_dot = PpuPair::sprite_0_flag_dot(*pair.strict);
+		const uint32_t fast_dot = PpuPair::sprite_0_flag_dot(*pair.fast);
+		REQUIRE(strict_dot != 0);
+		REQUIRE(fast_dot + 2 == strict_dot);
+	}
+
+	SECTION("Switching to Fast latches a hit still counting down") {
+		const uint32_t hit_dot = PpuPair::sprite_0_flag_dot(*pair.fast);
+		REQUIRE(hit_dot != 0);
+
+		PPU &ppu = *pair.strict;
+		while (ppu.get_dot_counter() < hit_dot) {
+			ppu.tick_dots(1);
+		}
+		REQUIRE((ppu.get_status_register() & PPUConstants::PPUSTATUS_SPRITE0_MASK) == 0);
+		ppu.set_accuracy(Accuracy::Fast);
+		REQUIRE((ppu.get_status_register() & PPUConstants::PPUSTATUS_SPRITE0_MASK) != 0);
+	}
+}
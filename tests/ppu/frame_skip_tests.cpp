@@ -0,0 +1,139 @@
+// VibeNES - NES Emulator
+// Frame Skip Tests
+// Skipped frames compose no pixels but must leave timing, flags and mapper
+// state exactly as a fully rendered frame does
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+constexpr int DOTS_PER_FRAME = 341 * 262;
+
+// MMC3 cart with noisy CHR and the IRQ counter armed
+std::shared_ptr<Cartridge> make_mmc3_cartridge() {
+	std::vector<Byte> chr(8192);
+	uint32_t seed = 0x2468ACEu;
+	for (auto &byte : chr) {
+		seed = seed * 1103515245u + 12345u;
+		byte = static_cast<uint8_t>(seed >> 16);
+	}
+	RomData rom = test::make_nrom({}, {}, std::move(chr));
+	rom.mapper_id = 4;
+	rom.vertical_mirroring = true;
+
+	auto cartridge = std::make_shared<Cartridge>();
+	cartridge->load_from_rom_data(rom);
+	cartridge->cpu_write(0xC000, 0x07); // IRQ latch
+	cartridge->cpu_write(0xC001, 0x00); // Reload
+	cartridge->cpu_write(0xE001, 0x00); // Enable
+	return cartridge;
+}
+
+// Varied nametables and palettes, a crowded sprite line (overflow) and
+// sprite 0 over opaque background (hit), then rendering on
+void setup_scene(PPU &ppu) {
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2006, 0x20);
+	ppu.write_register(0x2006, 0x00);
+	for (int i = 0; i < 0x800; ++i) {
+		ppu.write_register(0x2007, static_cast<uint8_t>((i * 13) ^ (i >> 2)));
+	}
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2006, 0x3F);
+	ppu.write_register(0x2006, 0x00);
+	for (int i = 0; i < 32; ++i) {
+		ppu.write_register(0x2007, static_cast<uint8_t>((i * 7 + 3) & 0x3F));
+	}
+	for (int sprite = 0; sprite < 64; ++sprite) {
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 0), static_cast<uint8_t>(sprite < 12 ? 60 : 100 + sprite));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 1), static_cast<uint8_t>(sprite * 5 + 1));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 2), static_cast<uint8_t>(sprite & 0x23));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 3), static_cast<uint8_t>(40 + sprite * 3));
+	}
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2005, 5);
+	ppu.write_register(0x2005, 0);
+	ppu.write_register(0x2000, 0x08); // Sprites at $1000: A12 edges in HBLANK
+	ppu.write_register(0x2001, 0x1E);
+}
+
+std::vector<uint8_t> ppu_state(const PPU &ppu) {
+	std::vector<uint8_t> state;
+	ppu.serialize_state(state);
+	return state;
+}
+
+std::vector<uint8_t> mapper_state(const Cartridge &cartridge) {
+	std::vector<uint8_t> state;
+	cartridge.serialize_state(state);
+	return state;
+}
+
+} // namespace
+
+TEST_CASE("Frame Skip - Skipped frames keep timing and flags", "[ppu][frame-skip]") {
+	const bool batching = GENERATE(true, false);
+
+	auto cart_full = make_mmc3_cartridge();
+	auto cart_skip = make_mmc3_cartridge();
+	auto full = std::make_unique<PPU>();
+	auto skip = std::make_unique<PPU>();
+	full->connect_cartridge(cart_full);
+	skip->connect_cartridge(cart_skip);
+	full->power_on();
+	skip->power_on();
+	full->set_scanline_batching(batching);
+	skip->set_scanline_batching(batching);
+	skip->set_frame_skip(3);
+	setup_scene(*full);
+	setup_scene(*skip);
+
+	// Finish the frame the scene was written in, then start clean
+	for (PPU *ppu : {full.get(), skip.get()}) {
+		ppu->tick_dots(DOTS_PER_FRAME - 341 * ppu->get_current_scanline() - ppu->get_current_cycle());
+	}
+	REQUIRE_FALSE(skip->is_composing_frame()); // Frame count 1: next composed frame is the third
+
+	for (int frame = 1; frame <= 6; ++frame) {
+		// Scroll every frame so that no two frames look alike
+		for (PPU *ppu : {full.get(), skip.get()}) {
+			ppu->read_register(0x2002);
+			ppu->write_register(0x2005, static_cast<uint8_t>(frame * 8 + 5));
+			ppu->write_register(0x2005, 0);
+		}
+		bool sprite0_seen_full = false;
+		bool sprite0_seen_skip = false;
+		for (int line = 0; line < 261; ++line) {
+			full->tick_dots(341);
+			skip->tick_dots(341);
+			sprite0_seen_full = sprite0_seen_full || (full->get_status_register() & 0x40);
+			sprite0_seen_skip = sprite0_seen_skip || (skip->get_status_register() & 0x40);
+			REQUIRE(full->get_status_register() == skip->get_status_register());
+		}
+		// The pre-render line is a dot short on odd frames: stop right at the wrap
+		const uint64_t count = full->get_frame_count();
+		while (full->get_frame_count() == count) {
+			full->tick_dots(1);
+			skip->tick_dots(1);
+		}
+		REQUIRE(sprite0_seen_full);
+		REQUIRE(sprite0_seen_skip);
+		REQUIRE(ppu_state(*full) == ppu_state(*skip));
+		REQUIRE(mapper_state(*cart_full) == mapper_state(*cart_skip));
+		REQUIRE(cart_full->is_irq_pending() == cart_skip->is_irq_pending());
+
+		const bool frames_match =
+			std::memcmp(full->get_frame_buffer(), skip->get_frame_buffer(), 256 * 240 * sizeof(uint32_t)) == 0;
+		// Frame counts 3 and 6 complete a composed frame
+		REQUIRE(frames_match == (skip->get_frame_count() % 3 == 0));
+	}
+}
@@ -8,8 +8,12 @@
 #include "../../include/cpu/cpu_6502.hpp"
 #include "../../include/memory/ram.hpp"
 #include "../../include/ppu/ppu.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <array>
 #include <catch2/catch_all.hpp>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 using namespace nes;
 
@@ -449,3 +453,136 @@ TEST_CASE_METHOD(MemoryMappingTestFixture, "Memory Access During Rendering", "[p
 		REQUIRE(data == 0xFF);
 	}
 }
+
+TEST_CASE_METHOD(MemoryMappingTestFixture, "Viewer Dirty Tracking", "[ppu][memory][dirty]") {
+	PPUMemory &memory = ppu->get_memory();
+	const auto bit_set = [](const auto &mask, uint16_t index) {
+		return ((mask[index >> 6] >> (index & 63)) & 1) != 0;
+	};
+	const auto none_set = [](const auto &mask) {
+		for (const uint64_t word : mask) {
+			if (word != 0) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// Power-on leaves everything dirty; a take clears it
+	REQUIRE(bit_set(memory.take_dirty_pattern_tiles(), 511));
+	REQUIRE(bit_set(memory.take_dirty_vram(), 2047));
+	REQUIRE(none_set(memory.take_dirty_pattern_tiles()));
+	REQUIRE(none_set(memory.take_dirty_vram()));
+
+	SECTION("Writes mark the tile or byte they land in") {
+		write_vram(0x1013, 0xAA); // Tile 257, second plane
+		write_vram(0x2C45, 0x01);
+		const auto tiles = memory.take_dirty_pattern_tiles();
+		const auto vram = memory.take_dirty_vram();
+		REQUIRE(bit_set(tiles, 257));
+		REQUIRE_FALSE(bit_set(tiles, 256));
+		REQUIRE(bit_set(vram, memory.nametable_vram_offset(0x2C45)));
+		REQUIRE_FALSE(bit_set(vram, memory.nametable_vram_offset(0x2C46)));
+		REQUIRE(none_set(memory.take_dirty_vram()));
+	}
+
+	SECTION("Nametable mirrors mark the physical byte") {
+		write_vram(0x3005, 0x01);
+		REQUIRE(bit_set(memory.take_dirty_vram(), memory.nametable_vram_offset(0x2005)));
+	}
+
+	SECTION("Palette writes bump the generation") {
+		const uint32_t generation = memory.get_palette_generation();
+		write_vram(0x3F01, 0x16);
+		REQUIRE(memory.get_palette_generation() != generation);
+		REQUIRE(none_set(memory.take_dirty_vram()));
+	}
+}
+
+namespace {
+
+RomData make_mirroring_rom(std::uint8_t mapper_id, bool four_screen) {
+	RomData rom = test::make_nrom({});
+	rom.mapper_id = mapper_id;
+	rom.four_screen_vram = four_screen;
+	return rom;
+}
+
+// Which of the four nametables alias the first one's byte
+std::array<bool, 4> aliases_of_nametable_0(PPUMemory &memory, std::uint8_t marker) {
+	memory.write_vram(0x2000, marker);
+	std::array<bool, 4> aliased{};
+	for (std::uint16_t nt = 0; nt < 4; ++nt) {
+		aliased[nt] = memory.read_vram(static_cast<std::uint16_t>(0x2000 + nt * 0x400)) == marker;
+	}
+	return aliased;
+}
+
+} // namespace
+
+TEST_CASE("Nametable Page Mapping", "[ppu][memory][mirroring]") {
+	PPUMemory memory;
+	auto cartridge = std::make_shared<Cartridge>();
+	memory.connect_cartridge(cartridge);
+
+	SECTION("MMC1 switches between all four modes at runtime") {
+		REQUIRE(cartridge->load_from_rom_data(make_mirroring_rom(1, false)));
+		const auto set_control = [&](std::uint8_t value) {
+			for (int bit = 0; bit < 5; ++bit) {
+				cartridge->cpu_write(0x8000, static_cast<Byte>((value >> bit) & 1));
+			}
+		};
+		memory.write_vram(0x2400, 0x00);
+		memory.write_vram(0x2800, 0x00);
+		memory.write_vram(0x2C00, 0x00);
+
+		set_control(0x00); // One-screen, lower page
+		REQUIRE(aliases_of_nametable_0(memory, 1) == std::array<bool, 4>{true, true, true, true});
+		set_control(0x01); // One-screen, upper page
+		REQUIRE(aliases_of_nametable_0(memory, 2) == std::array<bool, 4>{true, true, true, true});
+		set_control(0x00); // The lower page kept its byte
+		REQUIRE(memory.read_vram(0x2C00) == 1);
+		set_control(0x02); // Vertical
+		REQUIRE(aliases_of_nametable_0(memory, 3) == std::array<bool, 4>{true, false, true, false});
+		set_control(0x03); // Horizontal
+		REQUIRE(aliases_of_nametable_0(memory, 4) == std::array<bool, 4>{true, true, false, false});
+	}
+
+	SECTION("MMC3 $A000 selects vertical or horizontal") {
+		REQUIRE(cartridge->load_from_rom_data(make_mirroring_rom(4, false)));
+		memory.write_vram(0x2400, 0x00);
+		memory.write_vram(0x2800, 0x00);
+		cartridge->cpu_write(0xA000, 0x00);
+		REQUIRE(aliases_of_nametable_0(memory, 1) == std::array<bool, 4>{true, false, true, false});
+		cartridge->cpu_write(0xA000, 0x01);
+		REQUIRE(aliases_of_nametable_0(memory, 2) == std::array<bool, 4>{true, true, false, false});
+	}
+
+	SECTION("Four-screen boards give every nametable its own page") {
+		REQUIRE(cartridge->load_from_rom_data(make_mirroring_rom(4, true)));
+		cartridge->cpu_write(0xA000, 0x01); // Ignored
+		for (std::uint16_t nt = 0; nt < 4; ++nt) {
+			memory.write_vram(static_cast<std::uint16_t>(0x2000 + nt * 0x400 + 5), static_cast<std::uint8_t>(0x10 + nt));
+		}
+		for (std::uint16_t nt = 0; nt < 4; ++nt) {
+			REQUIRE(memory.read_vram(static_cast<std::uint16_t>(0x3000 + nt * 0x400 + 5)) == 0x10 + nt);
+		}
+
+		// The board's VRAM travels with the cartridge state
+		std::vector<uint8_t> state;
+		cartridge->serialize_state(state);
+		memory.write_vram(0x2805, 0x00);
+		size_t offset = 0;
+		cartridge->deserialize_state(state, offset);
+		REQUIRE(offset == state.size());
+		REQUIRE(memory.read_vram(0x2805) == 0x12);
+	}
+
+	SECTION("A new ROM maps onto the same CIRAM") {
+		REQUIRE(cartridge->load_from_rom_data(make_mirroring_rom(0, false)));
+		memory.write_vram(0x2000, 0x5A);
+		REQUIRE(cartridge->load_from_rom_data(make_mirroring_rom(0, true)));
+		REQUIRE(memory.read_vram(0x2000) == 0x5A);
+		REQUIRE(memory.get_vram()[0] == 0x5A);
+	}
+}
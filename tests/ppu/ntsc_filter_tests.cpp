@@ -0,0 +1,117 @@
+// VibeNES - NES Emulator
+// NTSC Filter Tests
+// Composite encode/decode of flat color fields, and the worker pool
+// producing the same frames as the synchronous filter
+
+#include "../../include/ppu/ntsc_filter.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+struct Rgb {
+	int r, g, b;
+};
+
+// Middle pixel of a frame filled with one index entry, away from the edges
+Rgb flat_field(const NtscFilter &filter, uint16_t entry) {
+	std::vector<uint16_t> indices(NtscFilter::INPUT_WIDTH * NtscFilter::HEIGHT, entry);
+	std::vector<uint32_t> output(NtscFilter::OUTPUT_WIDTH * NtscFilter::HEIGHT);
+	filter.filter_frame(indices.data(), 0, output.data());
+	// Average a subcarrier period's worth of pixels: single pixels carry
+	// the dot crawl
+	Rgb sum{0, 0, 0};
+	for (int x = 0; x < 6; ++x) {
+		const uint32_t pixel = output[120 * NtscFilter::OUTPUT_WIDTH + 256 + x];
+		REQUIRE((pixel >> 24) == 0xFF);
+		sum.r += static_cast<int>(pixel & 0xFF);
+		sum.g += static_cast<int>((pixel >> 8) & 0xFF);
+		sum.b += static_cast<int>((pixel >> 16) & 0xFF);
+	}
+	return {sum.r / 6, sum.g / 6, sum.b / 6};
+}
+
+} // namespace
+
+TEST_CASE("NTSC Filter - Flat fields", "[ppu][ntsc]") {
+	const NtscFilter filter(1);
+
+	SECTION("Grays carry no chroma and order by level") {
+		const Rgb black = flat_field(filter, 0x0F);
+		REQUIRE(black.r + black.g + black.b < 15);
+		int previous = -1;
+		for (const uint16_t entry : {0x00, 0x10, 0x20}) {
+			const Rgb gray = flat_field(filter, entry);
+			REQUIRE(std::abs(gray.r - gray.g) <= 3);
+			REQUIRE(std::abs(gray.g - gray.b) <= 3);
+			REQUIRE(gray.g > previous);
+			previous = gray.g;
+		}
+		REQUIRE(flat_field(filter, 0x30).g >= 250);
+	}
+
+	SECTION("Hues land on the right channels") {
+		const Rgb red = flat_field(filter, 0x16);
+		REQUIRE(red.r > red.g);
+		REQUIRE(red.r > red.b);
+		const Rgb green = flat_field(filter, 0x1A);
+		REQUIRE(green.g > green.r);
+		REQUIRE(green.g > green.b);
+		const Rgb blue = flat_field(filter, 0x12);
+		REQUIRE(blue.b > blue.r);
+		REQUIRE(blue.b > blue.g);
+	}
+
+	SECTION("Emphasis attenuates the other channels") {
+		const Rgb white = flat_field(filter, 0x20);
+		const Rgb red_emphasis = flat_field(filter, 0x20 | (1 << 6));
+		REQUIRE(red_emphasis.g < white.g);
+		REQUIRE(red_emphasis.b < white.b);
+		REQUIRE(red_emphasis.r > red_emphasis.b);
+	}
+}
+
+TEST_CASE("NTSC Filter - Worker pool matches the synchronous filter", "[ppu][ntsc]") {
+	const unsigned workers = GENERATE(1u, 3u);
+	auto filter = std::make_unique<NtscFilter>(workers);
+	REQUIRE(filter->worker_count() == workers);
+	REQUIRE(filter->take_finished_frame() == nullptr);
+
+	std::vector<uint16_t> indices(NtscFilter::INPUT_WIDTH * NtscFilter::HEIGHT);
+	uint32_t seed = 0xC0FFEEu;
+	for (uint16_t &entry : indices) {
+		seed = seed * 1103515245u + 12345u;
+		entry = static_cast<uint16_t>((seed >> 16) & 0x1FF);
+	}
+
+	for (unsigned phase = 0; phase < 3; ++phase) {
+		std::vector<uint32_t> expected(NtscFilter::OUTPUT_WIDTH * NtscFilter::HEIGHT);
+		filter->filter_frame(indices.data(), phase, expected.data());
+
+		// Neither call blocks: spin until the pool takes the frame and finishes it
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (!filter->submit(indices.data(), phase) && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::yield();
+		}
+		const uint32_t *filtered = nullptr;
+		while (!filtered && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::yield();
+			filtered = filter->take_finished_frame();
+		}
+		REQUIRE(filtered != nullptr);
+		REQUIRE(std::equal(expected.begin(), expected.end(), filtered));
+		REQUIRE(filter->take_finished_frame() == nullptr); // Each frame is handed out once
+
+		// Frames differ by phase (dot crawl)
+		for (uint16_t &entry : indices) {
+			entry = static_cast<uint16_t>((entry + 1) & 0x1FF);
+		}
+	}
+}
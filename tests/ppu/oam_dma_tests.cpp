@@ -4,6 +4,8 @@
 #include "cpu/cpu_6502.hpp"
 #include "memory/ram.hpp"
 #include "ppu/ppu.hpp"
+#include "system/nes_system.hpp"
+#include "../fixtures/prg_ram_cartridge.hpp"
 #include <catch2/catch_all.hpp>
 #include <memory>
 
@@ -14,7 +16,7 @@ class OAMDMATestFixture {
 	OAMDMATestFixture() {
 		bus = std::make_unique<SystemBus>();
 		ram = std::make_shared<Ram>();
-		cartridge = std::make_shared<Cartridge>();
+		cartridge = test::make_prg_ram_cartridge(); // Programs are written to $8000+
 		apu = std::make_shared<APU>();
 
 		// Connect components to bus
@@ -428,3 +430,61 @@ TEST_CASE_METHOD(OAMDMATestFixture, "DMA Hardware Accuracy", "[ppu][oam_dma][har
 		}
 	}
 }
+
+TEST_CASE("OAM DMA Page Copy Matches the Byte Transfer", "[ppu][oam_dma][timing]") {
+	// Two catch-up machines doing DMAs from RAM all through rendered frames,
+	// then with rendering off, with a fast DMC loop overlapping them. A read
+	// hook on the source page keeps the second one on the byte-by-byte path.
+	NesSystem fast;
+	NesSystem bytewise;
+	int hooked_reads = 0;
+	for (NesSystem *system : {&fast, &bytewise}) {
+		SystemBus &bus = system->bus();
+		bus.power_on();
+		bus.set_ppu_catch_up(true);
+		for (Address address = 0x0000; address < 0x01FD; ++address) {
+			bus.write(address, 0xEA); // NOPs between the transfers
+		}
+		bus.write(0x01FD, 0x4C); // JMP $0000
+		bus.write(0x01FE, 0x00);
+		bus.write(0x01FF, 0x00);
+		for (Address address = 0x0200; address < 0x0300; ++address) {
+			bus.write(address, static_cast<Byte>(address * 7));
+		}
+		bus.write(0x2001, 0x18);
+		bus.write(0x2003, 0x20);
+		bus.write(0x4017, 0x40);
+		bus.write(0x4010, 0x4F);
+		bus.write(0x4013, 0x01);
+		bus.write(0x4015, 0x10);
+		system->cpu().set_program_counter(0x0000);
+	}
+	bytewise.bus().breakpoints().add_hook(Breakpoints::CPU_READ, 0x0200, 0x02FF,
+										  [&](const BreakpointHit &) { ++hooked_reads; });
+
+	for (int transfer = 0; transfer < 300; ++transfer) {
+		for (NesSystem *system : {&fast, &bytewise}) {
+			if (transfer == 200) {
+				system->bus().write(0x2001, 0x00);
+			}
+			system->bus().write(0x0200 + (transfer & 0xFF), static_cast<Byte>(transfer));
+			system->bus().write(0x4014, 0x02);
+		}
+		const int cycles = fast.cpu().execute_instruction();
+		REQUIRE(cycles == bytewise.cpu().execute_instruction());
+		REQUIRE(fast.bus().get_master_clock() == bytewise.bus().get_master_clock());
+
+		// Then a stretch of NOPs that moves the next transfer along the frame
+		for (int i = 0; i < 37 * (transfer % 11); ++i) {
+			REQUIRE(fast.cpu().execute_instruction() == bytewise.cpu().execute_instruction());
+		}
+		fast.bus().sync_ppu();
+		bytewise.bus().sync_ppu();
+		for (int address = 0; address < 256; ++address) {
+			REQUIRE(fast.ppu().read_oam(static_cast<uint8_t>(address)) ==
+					bytewise.ppu().read_oam(static_cast<uint8_t>(address)));
+		}
+		REQUIRE(fast.ppu().peek_register(0x2002) == bytewise.ppu().peek_register(0x2002));
+	}
+	REQUIRE(hooked_reads == 300 * 256);
+}
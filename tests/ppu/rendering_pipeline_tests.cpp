@@ -310,6 +310,56 @@ TEST_CASE_METHOD(RenderingPipelineTestFixture, "Background prefetch maintains le
 	REQUIRE(frame[0] != expected_background_color);
 }
 
+TEST_CASE_METHOD(RenderingPipelineTestFixture, "Index buffer carries emphasis into the RGBA frame",
+				 "[ppu][render][emphasis]") {
+	disable_all_rendering();
+	write_vram(0x2000, 0x01);
+	write_vram(0x23C0, 0x00);
+	write_palette(0x3F00, 0x0F);
+	write_palette(0x3F01, 0x30);
+	write_palette(0x3F02, 0x30);
+	write_palette(0x3F03, 0x30);
+
+	// Background on, left column shown, red emphasis
+	write_ppu_register(0x2001, 0x2A);
+	ppu->clear_frame_ready();
+	advance_ppu_cycles(PPUTiming::CYCLES_PER_SCANLINE * PPUTiming::TOTAL_SCANLINES);
+	ppu->clear_frame_ready();
+	advance_ppu_cycles(PPUTiming::CYCLES_PER_SCANLINE * PPUTiming::TOTAL_SCANLINES);
+	REQUIRE(ppu->is_frame_ready());
+
+	const uint16_t *indices = ppu->get_index_buffer();
+	REQUIRE(indices[0] == (0x30 | (0x01 << 6)));
+
+	// Emphasis only ever darkens: converted white loses brightness, keeps alpha
+	const uint32_t white = nes::NESPalette::get_rgba_color(0x30);
+	const uint32_t *frame = ppu->get_frame_buffer();
+	REQUIRE(frame[0] != white);
+	REQUIRE((frame[0] >> 24) == 0xFF);
+	for (int shift = 0; shift < 24; shift += 8) {
+		REQUIRE(((frame[0] >> shift) & 0xFF) <= ((white >> shift) & 0xFF));
+	}
+}
+
+TEST_CASE_METHOD(RenderingPipelineTestFixture, "Frame generation advances once per completed frame",
+				 "[ppu][render][frame_generation]") {
+	const uint64_t start = ppu->get_frame_generation();
+
+	// Mid-frame progress and clearing frame_ready leave it alone
+	advance_ppu_cycles(PPUTiming::CYCLES_PER_SCANLINE * 10);
+	ppu->clear_frame_ready();
+	REQUIRE(ppu->get_frame_generation() == start);
+
+	advance_ppu_cycles(PPUTiming::CYCLES_PER_SCANLINE * (PPUTiming::TOTAL_SCANLINES - 10));
+	REQUIRE(ppu->get_frame_generation() == start + 1);
+	advance_ppu_cycles(PPUTiming::CYCLES_PER_SCANLINE * PPUTiming::TOTAL_SCANLINES);
+	REQUIRE(ppu->get_frame_generation() == start + 2);
+
+	// A reset replaces the frame, so readers must see a change
+	ppu->reset();
+	REQUIRE(ppu->get_frame_generation() > start + 2);
+}
+
 TEST_CASE_METHOD(RenderingPipelineTestFixture, "Sprite Evaluation", "[ppu][pipeline][sprites]") {
 	SECTION("Should evaluate sprites during cycles 65-256") {
 		enable_sprite_rendering();
@@ -0,0 +1,218 @@
+// VibeNES - NES Emulator
+// Scanline-batched background rendering tests
+// The batched path must leave the PPU and mapper in exactly the state the
+// per-dot path does, so whole frames are rendered both ways and compared.
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace nes;
+
+namespace {
+
+constexpr int DOTS_PER_FRAME = 341 * 262;
+
+std::shared_ptr<Cartridge> make_cartridge(uint8_t mapper_id) {
+	std::vector<Byte> chr(8192);
+	uint32_t seed = 0x1234567u;
+	for (auto &byte : chr) {
+		seed = seed * 1103515245u + 12345u;
+		byte = static_cast<uint8_t>(seed >> 16);
+	}
+	RomData rom = test::make_nrom({}, {}, std::move(chr));
+	rom.mapper_id = mapper_id;
+	rom.vertical_mirroring = true;
+
+	auto cartridge = std::make_shared<Cartridge>();
+	cartridge->load_from_rom_data(rom);
+	return cartridge;
+}
+
+// Fill nametables, attributes, palettes and OAM with varied data while
+// rendering is off, then set scroll (including fine X) and enable rendering.
+void setup_scene(PPU &ppu, uint8_t ctrl, uint8_t mask, uint8_t scroll_x, uint8_t scroll_y) {
+	ppu.write_register(0x2001, 0x00);
+	ppu.write_register(0x2000, 0x00);
+
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2006, 0x20);
+	ppu.write_register(0x2006, 0x00);
+	for (int i = 0; i < 0x800; ++i) {
+		ppu.write_register(0x2007, static_cast<uint8_t>((i * 7) ^ (i >> 3)));
+	}
+
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2006, 0x3F);
+	ppu.write_register(0x2006, 0x00);
+	for (int i = 0; i < 32; ++i) {
+		ppu.write_register(0x2007, static_cast<uint8_t>((i * 5 + 1) & 0x3F));
+	}
+
+	// Sprite 0 sits over opaque background so the hit latch is exercised
+	for (int sprite = 0; sprite < 64; ++sprite) {
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 0), static_cast<uint8_t>(20 + sprite * 3));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 1), static_cast<uint8_t>(sprite * 11));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 2), static_cast<uint8_t>(sprite & 0xE3));
+		ppu.write_oam(static_cast<uint8_t>(sprite * 4 + 3), static_cast<uint8_t>(sprite * 37));
+	}
+
+	ppu.read_register(0x2002);
+	ppu.write_register(0x2005, scroll_x);
+	ppu.write_register(0x2005, scroll_y);
+	ppu.write_register(0x2000, ctrl);
+	ppu.write_register(0x2001, mask);
+}
+
+struct PpuPair {
+	explicit PpuPair(uint8_t mapper_id)
+		: cart_batched(make_cartridge(mapper_id)), cart_dots(make_cartridge(mapper_id)),
+		  batched_ppu(std::make_unique<PPU>()), dots_ppu(std::make_unique<PPU>()), batched(*batched_ppu),
+		  dots(*dots_ppu) {
+		batched.connect_cartridge(cart_batched);
+		dots.connect_cartridge(cart_dots);
+		batched.power_on();
+		dots.power_on();
+		dots.set_scanline_batching(false);
+	}
+
+	void require_identical() const {
+		REQUIRE(batched.get_current_scanline() == dots.get_current_scanline());
+		REQUIRE(batched.get_current_cycle() == dots.get_current_cycle());
+		REQUIRE(batched.get_status_register() == dots.get_status_register());
+		REQUIRE(std::memcmp(batched.get_frame_buffer(), dots.get_frame_buffer(), 256 * 240 * sizeof(uint32_t)) == 0);
+
+		std::vector<uint8_t> state_batched;
+		std::vector<uint8_t> state_dots;
+		batched.serialize_state(state_batched);
+		dots.serialize_state(state_dots);
+		REQUIRE(state_batched == state_dots);
+
+		std::vector<uint8_t> mapper_batched;
+		std::vector<uint8_t> mapper_dots;
+		cart_batched->serialize_state(mapper_batched);
+		cart_dots->serialize_state(mapper_dots);
+		REQUIRE(mapper_batched == mapper_dots);
+		REQUIRE(cart_batched->is_irq_pending() == cart_dots->is_irq_pending());
+	}
+
+	std::shared_ptr<Cartridge> cart_batched;
+	std::shared_ptr<Cartridge> cart_dots;
+	std::unique_ptr<PPU> batched_ppu;
+	std::unique_ptr<PPU> dots_ppu;
+	PPU &batched;
+	PPU &dots;
+};
+
+} // namespace
+
+TEST_CASE("Scanline Batching - Matches dot path", "[ppu][scanline-batching]") {
+	struct Scene {
+		uint8_t ctrl;
+		uint8_t mask;
+		uint8_t scroll_x;
+		uint8_t scroll_y;
+	};
+	auto scene = GENERATE(Scene{0x00, 0x1E, 0, 0},	  // BG $0000, no clipping
+						  Scene{0x10, 0x18, 3, 17},	  // BG $1000, left-edge clipping, fine X
+						  Scene{0x09, 0x1E, 131, 5},  // Sprites $1000, nametable 1, coarse X wrap
+						  Scene{0x30, 0x0A, 255, 239}, // BG only, 8x16 sprites, scroll at edges
+						  Scene{0x00, 0x14, 7, 0});	  // Sprites only (BG fetches still run)
+
+	PpuPair pair(0);
+	REQUIRE(pair.batched.is_scanline_batching());
+	setup_scene(pair.batched, scene.ctrl, scene.mask, scene.scroll_x, scene.scroll_y);
+	setup_scene(pair.dots, scene.ctrl, scene.mask, scene.scroll_x, scene.scroll_y);
+
+	SECTION("Whole frames in one call") {
+		for (int frame = 0; frame < 3; ++frame) {
+			pair.batched.tick_dots(DOTS_PER_FRAME);
+			pair.dots.tick_dots(DOTS_PER_FRAME);
+			pair.require_identical();
+		}
+	}
+
+	SECTION("Uneven batch sizes split scanlines") {
+		// Chunks that rarely start on dot 1, forcing frequent fallbacks
+		const int chunks[] = {3, 255, 256, 257, 340, 341, 1000, 7};
+		int total = 0;
+		for (int i = 0; total < DOTS_PER_FRAME * 2; ++i) {
+			const int chunk = chunks[i % 8];
+			pair.batched.tick_dots(chunk);
+			pair.dots.tick_dots(chunk);
+			total += chunk;
+		}
+		pair.require_identical();
+	}
+
+	SECTION("Mid-frame register writes between batches") {
+		pair.batched.tick_dots(341 * 40 + 100);
+		pair.dots.tick_dots(341 * 40 + 100);
+		for (PPU *ppu : {&pair.batched, &pair.dots}) {
+			ppu->write_register(0x2005, 0x44);
+			ppu->write_register(0x2005, 0x10);
+			ppu->write_register(0x2001, 0x0E);
+		}
+		pair.batched.tick_dots(DOTS_PER_FRAME);
+		pair.dots.tick_dots(DOTS_PER_FRAME);
+		pair.require_identical();
+	}
+}
+
+TEST_CASE("Scanline Batching - MMC3 A12 counting", "[ppu][scanline-batching][mmc3]") {
+	// BG at $1000 and sprites at $0000 puts the A12 edges inside dots 1-256
+	auto ctrl = GENERATE(as<uint8_t>{}, 0x08, 0x10);
+
+	PpuPair pair(4);
+	for (auto &cart : {pair.cart_batched, pair.cart_dots}) {
+		cart->cpu_write(0xC000, 0x05); // IRQ latch
+		cart->cpu_write(0xC001, 0x00); // Reload
+		cart->cpu_write(0xE001, 0x00); // Enable
+	}
+	setup_scene(pair.batched, ctrl, 0x1E, 9, 0);
+	setup_scene(pair.dots, ctrl, 0x1E, 9, 0);
+
+	for (int frame = 0; frame < 2; ++frame) {
+		pair.batched.tick_dots(DOTS_PER_FRAME);
+		pair.dots.tick_dots(DOTS_PER_FRAME);
+		pair.require_identical();
+	}
+	REQUIRE(pair.cart_batched->is_irq_pending());
+}
+
+TEST_CASE("Scanline Batching - Crowded sprite lines", "[ppu][scanline-batching][sprites]") {
+	// More than eight sprites per line: the batched evaluator must reproduce
+	// secondary OAM, the overflow search (with its n/m increment bug reading
+	// tile/attribute/X bytes as Y) and the final state machine registers
+	auto ctrl = GENERATE(as<uint8_t>{}, 0x00, 0x20);
+
+	PpuPair pair(0);
+	setup_scene(pair.batched, ctrl, 0x1E, 0, 0);
+	setup_scene(pair.dots, ctrl, 0x1E, 0, 0);
+	for (PPU *ppu : {&pair.batched, &pair.dots}) {
+		for (int sprite = 0; sprite < 64; ++sprite) {
+			ppu->write_oam(static_cast<uint8_t>(sprite * 4 + 0), static_cast<uint8_t>(40 + (sprite % 13) * 3));
+			ppu->write_oam(static_cast<uint8_t>(sprite * 4 + 1), static_cast<uint8_t>(44 + sprite));
+			ppu->write_oam(static_cast<uint8_t>(sprite * 4 + 3), static_cast<uint8_t>(sprite * 4));
+		}
+		ppu->write_oam(252, 0xEF); // Sprite 63 on the last visible line
+	}
+
+	for (int frame = 0; frame < 2; ++frame) {
+		pair.batched.tick_dots(DOTS_PER_FRAME);
+		pair.dots.tick_dots(DOTS_PER_FRAME);
+		pair.require_identical();
+	}
+	REQUIRE((pair.batched.get_status_register() & PPUConstants::PPUSTATUS_OVERFLOW_MASK) == 0); // Cleared at pre-render
+
+	// Compare straight after a crowded line's evaluation as well
+	pair.batched.tick_dots(341 * 60 + 300);
+	pair.dots.tick_dots(341 * 60 + 300);
+	pair.require_identical();
+	REQUIRE((pair.batched.get_status_register() & PPUConstants::PPUSTATUS_OVERFLOW_MASK) != 0);
+}
@@ -0,0 +1,110 @@
+// VibeNES - NES Emulator
+// Scanline Timeline Tests
+// The per-line scroll, register and CHR bank record the PPU viewer draws from
+
+#include "../../include/cartridge/cartridge.hpp"
+#include "../../include/cartridge/rom_loader.hpp"
+#include "../../include/ppu/ppu.hpp"
+#include "../../include/system/headless_system.hpp"
+#include "../fixtures/nrom_image.hpp"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <memory>
+
+using namespace nes;
+
+namespace {
+
+// Scrolled to (35, 16) with the background from $1000, then busy forever
+RomData make_scrolled_rom() {
+	const std::array<uint8_t, 34> program = {
+		0x2C, 0x02, 0x20, // $8000 BIT $2002
+		0x10, 0xFB,		  //       BPL $8000
+		0x2C, 0x02, 0x20, // $8005 BIT $2002
+		0x10, 0xFB,		  //       BPL $8005
+		0xA9, 0x10,		  //       LDA #$10
+		0x8D, 0x00, 0x20, //       STA $2000
+		0xA9, 0x23,		  //       LDA #$23
+		0x8D, 0x05, 0x20, //       STA $2005
+		0xA9, 0x10,		  //       LDA #$10
+		0x8D, 0x05, 0x20, //       STA $2005
+		0xA9, 0x0A,		  //       LDA #$0A
+		0x8D, 0x01, 0x20, //       STA $2001
+		0xE8,			  // $801E INX
+		0x4C, 0x1E, 0x80, //       JMP $801E
+	};
+	return test::make_nrom(program);
+}
+
+} // namespace
+
+TEST_CASE("Scanline Timeline - Frames flip on end_frame", "[ppu][scanline_timeline]") {
+	ScanlineTimeline timeline;
+	ScanlineState state;
+	state.v = 0x1234;
+	state.flags = ScanlineState::RECORDED;
+	timeline.record(10, state);
+	timeline.record(ScanlineTimeline::MAX_SCANLINES, state); // Ignored
+	REQUIRE(timeline.current_frame()[10].v == 0x1234);
+	REQUIRE_FALSE(timeline.last_frame()[10].flags & ScanlineState::RECORDED);
+
+	timeline.end_frame();
+	REQUIRE(timeline.last_frame()[10].v == 0x1234);
+	REQUIRE_FALSE(timeline.current_frame()[10].flags & ScanlineState::RECORDED);
+
+	timeline.clear();
+	REQUIRE_FALSE(timeline.last_frame()[10].flags & ScanlineState::RECORDED);
+}
+
+TEST_CASE("Scanline Timeline - Records scroll and registers per line", "[ppu][scanline_timeline]") {
+	HeadlessSystem system;
+	REQUIRE(system.load_rom_data(make_scrolled_rom()));
+	for (int frame = 0; frame < 4; ++frame) {
+		system.run_frame();
+	}
+
+	const ScanlineTimeline::Frame &frame = system.ppu().get_scanline_timeline().last_frame();
+	if constexpr (!ScanlineTimeline::ENABLED) {
+		REQUIRE_FALSE(frame[0].flags & ScanlineState::RECORDED); // Compiled out
+		return;
+	}
+	for (int scanline = 0; scanline < 262; ++scanline) {
+		REQUIRE(frame[static_cast<std::size_t>(scanline)].flags & ScanlineState::RECORDED);
+	}
+	REQUIRE_FALSE(frame[262].flags & ScanlineState::RECORDED); // NTSC stops at 261
+
+	for (std::size_t scanline : {0u, 100u, 200u}) {
+		const ScanlineState &line = frame[scanline];
+		REQUIRE(line.ctrl == 0x10);
+		REQUIRE(line.mask == 0x0A);
+		REQUIRE(line.fine_x == 3);
+		REQUIRE(line.map_x() == 0x23);
+		REQUIRE(line.map_y() == static_cast<int>(16 + scanline));
+		REQUIRE(line.chr_banks == std::array<std::uint8_t, 8>{0, 1, 2, 3, 4, 5, 6, 7});
+	}
+}
+
+TEST_CASE("Scanline Timeline - CHR banks follow the mapper", "[ppu][scanline_timeline]") {
+	RomData rom = test::make_nrom({}, {}, std::vector<Byte>(32768, 0x00)); // 32 1KB CHR pages
+	rom.mapper_id = 4;
+	auto cartridge = std::make_shared<Cartridge>();
+	REQUIRE(cartridge->load_from_rom_data(rom));
+
+	PPU ppu;
+	ppu.connect_cartridge(cartridge);
+	ppu.power_on();
+	ppu.tick_dots(341 * 100);
+	cartridge->cpu_write(0x8000, 0x02); // R2: 1KB at $1000
+	cartridge->cpu_write(0x8001, 0x15);
+	ppu.tick_dots(341 * 100);
+
+	const ScanlineTimeline::Frame &frame = ppu.get_scanline_timeline().current_frame();
+	if constexpr (!ScanlineTimeline::ENABLED) {
+		REQUIRE_FALSE(frame[150].flags & ScanlineState::RECORDED); // Compiled out
+		return;
+	}
+	REQUIRE(frame[50].chr_banks[4] != 0x15);
+	REQUIRE(frame[150].chr_banks[4] == 0x15);
+}
@@ -431,3 +431,56 @@ TEST_CASE_METHOD(TimingTestFixture, "Interrupt Timing", "[ppu][timing][interrupt
 		// NMI should not trigger
 	}
 }
+
+TEST_CASE_METHOD(TimingTestFixture, "Region Timing", "[ppu][timing][region]") {
+	auto frame_dots = [this]() {
+		int dots = 0;
+		const uint64_t start_frame = ppu->get_frame_count();
+		while (ppu->get_frame_count() == start_frame) {
+			ppu->tick_single_dot();
+			dots++;
+		}
+		return dots;
+	};
+
+	SECTION("PAL frames are 312 lines with no odd-frame skip") {
+		bus->set_region(Region::Pal);
+		REQUIRE(ppu->get_region() == Region::Pal);
+		write_ppu_register(0x2001, 0x18);
+		advance_full_frame();
+		REQUIRE(frame_dots() == 341 * 312);
+		REQUIRE(frame_dots() == 341 * 312);
+	}
+
+	SECTION("PAL VBlank runs from line 241 to the pre-render line 311") {
+		bus->set_region(Region::Pal);
+		advance_full_frame();
+		advance_to_scanline(241);
+		advance_to_cycle(2);
+		REQUIRE((ppu->get_status_register() & 0x80) != 0);
+		advance_to_scanline(311);
+		advance_to_cycle(2);
+		REQUIRE((ppu->get_status_register() & 0x80) == 0);
+	}
+
+	SECTION("Dendy sets VBlank on line 291") {
+		bus->set_region(Region::Dendy);
+		advance_full_frame();
+		advance_to_scanline(241);
+		advance_to_cycle(2);
+		REQUIRE((ppu->get_status_register() & 0x80) == 0);
+		advance_to_scanline(291);
+		advance_to_cycle(2);
+		REQUIRE((ppu->get_status_register() & 0x80) != 0);
+		advance_full_frame();
+		REQUIRE(frame_dots() == 341 * 312);
+	}
+
+	SECTION("Switching back to NTSC restores the 262-line frame") {
+		bus->set_region(Region::Pal);
+		bus->set_region(Region::Ntsc);
+		advance_full_frame();
+		const int dots = frame_dots();
+		REQUIRE((dots == 89341 || dots == 89342));
+	}
+}